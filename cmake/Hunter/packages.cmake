@@ -16,6 +16,7 @@
 
 hunter_add_package(abseil)
 hunter_add_package(asio-grpc)
+hunter_add_package(benchmark)
 hunter_add_package(Catch)
 hunter_add_package(ethash)
 hunter_add_package(gRPC)
@@ -24,3 +25,4 @@ hunter_add_package(intx)
 hunter_add_package(nlohmann_json)
 hunter_add_package(Protobuf)
 hunter_add_package(jwt-cpp)
+hunter_add_package(ZLIB)
@@ -0,0 +1,64 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include <iostream>
+#include <string>
+
+#include <grpcpp/grpcpp.h>
+
+#include <silkrpc/bench/http_load.hpp>
+#include <silkrpc/bench/in_process_load.hpp>
+#include <silkrpc/bench/workload.hpp>
+#include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/concurrency/worker_pool.hpp>
+
+int bench_http(const silkrpc::bench::Workload& workload, const silkrpc::bench::HttpLoadSettings& settings) {
+    const auto result = silkrpc::bench::run_http_load(workload, settings);
+    auto report = result.stats.report(result.elapsed);
+    report["mode"] = "http";
+    report["concurrency"] = settings.concurrency;
+    report["pipelining"] = settings.pipelining;
+    report["reuse_connections"] = settings.reuse_connections;
+    report["replay_timing"] = settings.preserve_timing;
+    std::cout << report.dump(4) << "\n";
+    return 0;
+}
+
+int bench_in_process(const silkrpc::bench::Workload& workload, const silkrpc::bench::InProcessLoadSettings& settings,
+    const std::string& target, uint32_t num_contexts, uint32_t num_workers) {
+    // Create the same execution contexts as the daemon, using insecure channels to target
+    silkrpc::ContextPool context_pool{num_contexts, [&]() {
+        return grpc::CreateChannel(target, grpc::InsecureChannelCredentials());
+    }};
+    silkrpc::WorkerPool worker_pool{num_workers};
+    context_pool.start();
+
+    const auto result = silkrpc::bench::run_in_process_load(workload, settings, context_pool, worker_pool);
+
+    context_pool.stop();
+    worker_pool.stop();
+    context_pool.join();
+    worker_pool.join();
+
+    auto report = result.stats.report(result.elapsed);
+    report["mode"] = "in_process";
+    report["concurrency"] = settings.concurrency;
+    report["contexts"] = num_contexts;
+    report["workers"] = num_workers;
+    std::cout << report.dump(4) << "\n";
+    return 0;
+}
@@ -0,0 +1,54 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include <csignal>
+#include <iostream>
+#include <string>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/signal_set.hpp>
+
+#include <silkrpc/bench/fake_backend.hpp>
+#include <silkrpc/bench/kv_dataset.hpp>
+
+int fake_backend(const std::string& dataset_file, const silkrpc::bench::FakeBackendSettings& settings) {
+    const bool recording{!settings.upstream.empty()};
+    silkrpc::bench::KvDataset dataset;
+    if (!recording) {
+        dataset = silkrpc::bench::KvDataset::load(dataset_file);
+    }
+
+    silkrpc::bench::FakeBackend backend{dataset, settings};
+    backend.start();
+    std::cout << (recording ? "Recording from " + settings.upstream : "Serving " + dataset_file) << " on port " << backend.port()
+              << " (" << dataset.num_pairs() << " pairs, " << dataset.num_replies() << " replies)\n" << std::flush;
+
+    boost::asio::io_context io_context;
+    boost::asio::signal_set signals{io_context, SIGINT, SIGTERM};
+    signals.async_wait([&](const boost::system::error_code& /*error*/, int /*signal_number*/) {
+        backend.shutdown();
+    });
+    io_context.run();
+    backend.wait();
+
+    if (recording) {
+        dataset.save(dataset_file);
+        std::cout << "Recorded " << dataset_file << " (" << dataset.num_tables() << " tables, " << dataset.num_pairs() << " pairs, "
+                  << dataset.num_replies() << " replies)\n";
+    }
+    return 0;
+}
@@ -0,0 +1,65 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include <silkrpc/bench/kv_load.hpp>
+#include <silkrpc/concurrency/context_pool.hpp>
+
+int kv_bench(const silkrpc::bench::KvLoadSettings& settings, const std::string& target, const std::string& model,
+    uint32_t num_contexts, uint32_t num_kv_channels, uint32_t key_samples, silkrpc::bench::KeyDistribution key_distribution) {
+    // Each channel has its own connection as in the daemon, so that the streams are spread over distinct connections
+    const auto create_channel = [&]() {
+        grpc::ChannelArguments channel_args;
+        channel_args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+        return grpc::CreateCustomChannel(target, grpc::InsecureChannelCredentials(), channel_args);
+    };
+    const auto keys = silkrpc::bench::KeySet::sample(create_channel(), settings.table, key_samples, key_distribution);
+
+    silkrpc::bench::BenchResult result;
+    uint32_t num_channels{num_kv_channels};
+    if (model == "coroutines") {
+        // Create the same execution contexts as the daemon, each one having its own channels
+        silkrpc::ContextPool context_pool{num_contexts, create_channel, silkrpc::WaitMode::blocking, nullptr, nullptr, num_kv_channels};
+        context_pool.start();
+        result = silkrpc::bench::run_kv_load_coroutines(keys, settings, context_pool);
+        context_pool.stop();
+        context_pool.join();
+        num_channels *= num_contexts;
+    } else {
+        std::vector<std::shared_ptr<grpc::Channel>> channels;
+        for (uint32_t i{0}; i < num_kv_channels; ++i) {
+            channels.push_back(create_channel());
+        }
+        result = silkrpc::bench::run_kv_load_sync(keys, settings, channels);
+    }
+
+    auto report = result.stats.report(result.elapsed);
+    report["model"] = model;
+    report["table"] = settings.table;
+    report["keys"] = keys.size();
+    report["streams"] = settings.streams;
+    report["channels"] = num_channels;
+    report["walk_length"] = settings.walk_length;
+    report["ops_per_tx"] = settings.ops_per_tx;
+    std::cout << report.dump(4) << "\n";
+    return 0;
+}
@@ -31,17 +31,69 @@
 #include <silkrpc/common/log.hpp>
 #include <silkrpc/daemon.hpp>
 
-ABSL_FLAG(std::string, chaindata, silkrpc::kEmptyChainData, "chain data path as string");
+ABSL_FLAG(std::string, chaindata, silkrpc::kEmptyChainData, "chain data path as string, read directly instead of using the remote KV interface when set");
 ABSL_FLAG(std::string, http_port, silkrpc::kDefaultHttpPort, "Ethereum JSON RPC API local end-point as string <address>:<port>");
+ABSL_FLAG(uint32_t, http_compression_level, silkrpc::kDefaultHttpCompressionLevel, "HTTP reply compression level in [1, 9] for clients accepting gzip or deflate (0 disables compression)");
+ABSL_FLAG(uint32_t, http_compression_min_size, silkrpc::kDefaultHttpCompressionMinSize, "min size in bytes of HTTP replies to be compressed");
+ABSL_FLAG(uint32_t, http_idle_timeout, silkrpc::kDefaultHttpIdleTimeout, "max time in milliseconds a keep-alive HTTP connection waits for the next request, 0 waits forever");
+ABSL_FLAG(uint32_t, http_read_timeout, silkrpc::kDefaultHttpReadTimeout, "max time in milliseconds to receive a whole HTTP request once started, 0 waits forever");
+ABSL_FLAG(uint32_t, http_max_requests_per_connection, 0, "max number of HTTP requests served on each connection before closing it, 0 means no limit");
+ABSL_FLAG(uint32_t, http_max_connections, 0, "max number of HTTP connections, closing the least recently idle ones to make room, 0 means no limit");
+ABSL_FLAG(std::string, http_unix_socket, "", "Ethereum JSON RPC API local Unix domain socket path (empty disables it)");
+ABSL_FLAG(std::string, log_index, "", "log index path as string, built from the new blocks and consulted by eth_getLogs (empty disables the log index)");
+ABSL_FLAG(std::string, snapshots_dir, "", "Erigon snapshots path as string, whose segment files are memory-mapped to read the frozen blocks locally (empty disables the local snapshot reading)");
+ABSL_FLAG(std::string, trace_store, "", "trace store path as string, filled with the traces of the replayed blocks and consulted by the trace API (empty disables the trace store)");
+ABSL_FLAG(std::string, timestamp_index, "", "timestamp index file as string, filled with the block timestamps and consulted by erigon_getBlockByTimestamp (empty disables the timestamp index)");
+ABSL_FLAG(bool, compact_block_cache, false, "flag indicating if the cached blocks are kept RLP-encoded and decoded on access, holding more blocks in the same memory");
+ABSL_FLAG(uint32_t, cache_compression_threshold, 0, "min size in bytes of the cached blocks and contract code kept LZ4-compressed, implying compact_block_cache (0 disables, requires LZ4 support)");
+ABSL_FLAG(std::string, disk_cache, "", "disk cache path as string, holding the blocks and receipts read so far as secondary tier of the memory caches across restarts (empty disables the disk cache)");
+ABSL_FLAG(uint32_t, disk_cache_size, silkrpc::kDefaultDiskCacheSize, "max size in MiB of the disk cache, deleting its oldest segments beyond");
+ABSL_FLAG(bool, prefetch_head_block, false, "flag indicating if the header, body, senders and receipts of each new block are loaded into the caches on arrival");
+ABSL_FLAG(std::string, state_cache_storage_addresses, "", "contracts as comma-separated list of hex addresses whose storage is cached, the storage changes of the others being skipped (empty caches all)");
+ABSL_FLAG(uint32_t, state_cache_auto_storage_addresses, 0, "max number of contracts whose storage is cached once read often, in addition to state_cache_storage_addresses (0 disables)");
+ABSL_FLAG(uint32_t, call_result_cache_size, 0, "max number of eth_call results at latest block cached until some new block changes the state they have read (0 disables)");
+ABSL_FLAG(uint32_t, state_cache_max_absent_keys, 0, "max number of keys found absent whose absence is cached, so that probing empty accounts and storage skips the database (0 disables)");
+ABSL_FLAG(silkrpc::ethdb::kv::EvictionPolicyType, state_cache_eviction_policy, silkrpc::ethdb::kv::EvictionPolicyType::lru, "state cache eviction policy as lru or w_tinylfu (admission by access frequency, resistant to scans)");
+ABSL_FLAG(uint32_t, protocol_check_timeout, 0, "max time in milliseconds to wait for the core services at startup (0 waits forever)");
+ABSL_FLAG(std::string, peers, "", "replicas as comma-separated list like rpc1:8545,rpc2:8545 serving the requests by block hash or address on a consistent-hash ring (empty disables peer mode)");
+ABSL_FLAG(std::string, peer_self, "", "end-point of this replica among the peers as string <address>:<port>");
+ABSL_FLAG(std::string, reload_file, "", "file of name=value settings (api_spec, block_cache_size, state_cache_max_keys, state_cache_max_code_size, max_workers) applied on SIGHUP (empty disables reloading)");
+ABSL_FLAG(std::string, state_cache_warm_up_file, "", "file persisting the hot state cache keys on shutdown to prefetch them at startup (empty disables warm up)");
+ABSL_FLAG(std::string, ws_port, "", "Ethereum JSON RPC API over WebSocket local end-point as string <address>:<port> (empty disables WebSocket)");
 ABSL_FLAG(std::string, engine_port, silkrpc::kDefaultEnginePort, "Engine JSON RPC API local end-point as string <address>:<port>");
-ABSL_FLAG(std::string, target, silkrpc::kDefaultTarget, "Erigon Core gRPC service location as string <address>:<port>");
+ABSL_FLAG(std::string, target, silkrpc::kDefaultTarget, "Erigon Core gRPC service location as string <address>:<port>, or comma-separated list whose first is the primary");
 ABSL_FLAG(std::string, api_spec, silkrpc::kDefaultEth1ApiSpec, "JSON RPC API namespaces as comma-separated list of strings");
+ABSL_FLAG(std::string, admission_limits, "", "max concurrent requests by method or namespace as comma-separated list like debug=8,eth_getLogs=16 (empty disables admission control)");
+ABSL_FLAG(uint32_t, admission_queue_budget, silkrpc::kDefaultAdmissionQueueBudget.count(), "max time in milliseconds a request over its limit waits before being rejected");
+ABSL_FLAG(std::string, request_timeouts, "", "default request timeouts in milliseconds by method, namespace or default as comma-separated list like default=10000,debug=60000 (empty disables them)");
+ABSL_FLAG(std::string, trace_file, "", "file where the spans of the sampled requests are written in the Chrome trace event format (empty disables tracing)");
+ABSL_FLAG(uint32_t, trace_sample_interval, silkrpc::kDefaultTraceSampleInterval, "number of requests every which one is traced when tracing is enabled");
+ABSL_FLAG(std::string, record_file, "", "file where the bodies of the sampled requests are appended in binary format for replay (empty disables recording)");
+ABSL_FLAG(uint32_t, record_sample_interval, silkrpc::kDefaultRecordSampleInterval, "number of requests every which one is recorded when recording is enabled");
+ABSL_FLAG(bool, record_replies, false, "flag indicating if the reply sizes and latencies are recorded along with the requests");
+ABSL_FLAG(bool, request_costs, false, "flag indicating if the thread CPU time and the bytes allocated by the requests are accounted by method in the metrics");
+ABSL_FLAG(uint32_t, slow_request_threshold, 0, "latency in milliseconds beyond which the requests are logged with their phases and costs (0 disables)");
+ABSL_FLAG(uint32_t, rate_limit, 0, "tokens per second granted to each client (by JWT subject or remote address), each request taking 1, 10 or 100 by method cost (0 disables rate limiting)");
+ABSL_FLAG(uint32_t, rate_limit_burst, 0, "max tokens each client can accumulate when idle (0 means the rate limit)");
+ABSL_FLAG(bool, profile_endpoint, false, "flag indicating if the sampling profiler is served on GET /debug/profile?seconds=N as folded stacks");
 ABSL_FLAG(uint32_t, num_contexts, std::thread::hardware_concurrency() / 3, "number of running I/O contexts as 32-bit integer");
 ABSL_FLAG(uint32_t, num_workers, 16, "number of worker threads as 32-bit integer");
+ABSL_FLAG(uint32_t, max_workers, 0, "max number of worker threads the short calls can grow to under load (up to num_workers means fixed)");
+ABSL_FLAG(uint32_t, num_long_running_workers, silkrpc::kDefaultNumLongRunningWorkers, "number of worker threads dedicated to debug and trace requests (0 shares the other workers)");
 ABSL_FLAG(uint32_t, timeout, silkrpc::kDefaultTimeout.count(), "gRPC call timeout as 32-bit integer");
 ABSL_FLAG(silkrpc::LogLevel, log_verbosity, silkrpc::LogLevel::Critical, "logging verbosity level");
 ABSL_FLAG(silkrpc::WaitMode, wait_mode, silkrpc::WaitMode::blocking, "scheduler wait mode");
+ABSL_FLAG(uint32_t, wait_latency_budget, silkrpc::kDefaultWaitLatencyBudget.count(), "max time in microseconds the adaptive wait mode sleeps while idle (0 never sleeps)");
 ABSL_FLAG(std::string, jwt_secret_file, silkrpc::kDefaultJwtFilename, "Token file to ensure safe connection between CL and EL");
+ABSL_FLAG(uint32_t, max_pipelined_requests, silkrpc::kDefaultMaxPipelinedRequests, "max number of pipelined HTTP requests executed concurrently per connection (1 disables pipelining)");
+ABSL_FLAG(uint32_t, num_kv_channels, silkrpc::kDefaultNumKvChannels, "number of gRPC channels (i.e. connections) per I/O context for the remote KV transactions");
+ABSL_FLAG(uint32_t, grpc_stream_window_size, silkrpc::kDefaultGrpcStreamWindowSize, "gRPC HTTP/2 flow-control window in bytes per stream (0 uses the window estimated by gRPC)");
+ABSL_FLAG(uint32_t, grpc_keepalive_time, silkrpc::kDefaultGrpcKeepAliveTime, "gRPC keepalive ping interval in milliseconds (0 disables keepalive)");
+ABSL_FLAG(std::string, grpc_compression, "", "gRPC message compression as gzip or deflate for the calls carrying bulk data, e.g. KV transactions and state changes (empty disables compression)");
+ABSL_FLAG(std::string, context_cpus, "", "CPU list like 0-3,8 to pin the I/O context threads to (empty disables pinning)");
+ABSL_FLAG(std::string, worker_cpus, "", "CPU list like 0-3,8 to pin the worker threads to (empty disables pinning)");
+ABSL_FLAG(int32_t, numa_node, -1, "NUMA node whose CPUs the threads are pinned to when no CPU list is given (-1 disables it)");
+ABSL_FLAG(uint32_t, max_batch_concurrency, silkrpc::kDefaultMaxBatchConcurrency, "max number of JSON RPC batch elements executed concurrently per request (1 disables concurrency)");
 
 //! Assemble the application version using the Cable build information
 std::string get_version_from_build_info() {
@@ -78,6 +130,9 @@ std::string get_library_versions() {
     library_versions.append(grpc::Version());
     library_versions.append(" Boost Asio: ");
     library_versions.append(std::to_string(BOOST_ASIO_VERSION));
+    if constexpr (silkrpc::kIoUringBackend) {
+        library_versions.append(" (io_uring)");
+    }
     return library_versions;
 }
 
@@ -102,7 +157,59 @@ silkrpc::DaemonSettings parse_args(int argc, char* argv[]) {
         absl::GetFlag(FLAGS_num_workers),
         absl::GetFlag(FLAGS_log_verbosity),
         absl::GetFlag(FLAGS_wait_mode),
-        absl::GetFlag(FLAGS_jwt_secret_file)
+        absl::GetFlag(FLAGS_jwt_secret_file),
+        absl::GetFlag(FLAGS_max_pipelined_requests),
+        absl::GetFlag(FLAGS_max_batch_concurrency),
+        absl::GetFlag(FLAGS_http_compression_level),
+        absl::GetFlag(FLAGS_http_compression_min_size),
+        absl::GetFlag(FLAGS_ws_port),
+        absl::GetFlag(FLAGS_http_unix_socket),
+        absl::GetFlag(FLAGS_state_cache_warm_up_file),
+        absl::GetFlag(FLAGS_log_index),
+        absl::GetFlag(FLAGS_num_kv_channels),
+        absl::GetFlag(FLAGS_grpc_stream_window_size),
+        absl::GetFlag(FLAGS_grpc_keepalive_time),
+        absl::GetFlag(FLAGS_num_long_running_workers),
+        absl::GetFlag(FLAGS_context_cpus),
+        absl::GetFlag(FLAGS_worker_cpus),
+        absl::GetFlag(FLAGS_numa_node),
+        absl::GetFlag(FLAGS_wait_latency_budget),
+        absl::GetFlag(FLAGS_admission_limits),
+        absl::GetFlag(FLAGS_admission_queue_budget),
+        absl::GetFlag(FLAGS_request_timeouts),
+        absl::GetFlag(FLAGS_trace_file),
+        absl::GetFlag(FLAGS_trace_sample_interval),
+        absl::GetFlag(FLAGS_record_file),
+        absl::GetFlag(FLAGS_record_sample_interval),
+        absl::GetFlag(FLAGS_record_replies),
+        absl::GetFlag(FLAGS_trace_store),
+        absl::GetFlag(FLAGS_timestamp_index),
+        absl::GetFlag(FLAGS_prefetch_head_block),
+        absl::GetFlag(FLAGS_state_cache_eviction_policy),
+        absl::GetFlag(FLAGS_reload_file),
+        absl::GetFlag(FLAGS_protocol_check_timeout),
+        absl::GetFlag(FLAGS_peers),
+        absl::GetFlag(FLAGS_peer_self),
+        absl::GetFlag(FLAGS_compact_block_cache),
+        absl::GetFlag(FLAGS_http_idle_timeout),
+        absl::GetFlag(FLAGS_http_read_timeout),
+        absl::GetFlag(FLAGS_http_max_requests_per_connection),
+        absl::GetFlag(FLAGS_http_max_connections),
+        absl::GetFlag(FLAGS_snapshots_dir),
+        absl::GetFlag(FLAGS_state_cache_storage_addresses),
+        absl::GetFlag(FLAGS_state_cache_auto_storage_addresses),
+        absl::GetFlag(FLAGS_state_cache_max_absent_keys),
+        absl::GetFlag(FLAGS_call_result_cache_size),
+        absl::GetFlag(FLAGS_max_workers),
+        absl::GetFlag(FLAGS_profile_endpoint),
+        absl::GetFlag(FLAGS_request_costs),
+        absl::GetFlag(FLAGS_slow_request_threshold),
+        absl::GetFlag(FLAGS_rate_limit),
+        absl::GetFlag(FLAGS_rate_limit_burst),
+        absl::GetFlag(FLAGS_cache_compression_threshold),
+        absl::GetFlag(FLAGS_disk_cache),
+        absl::GetFlag(FLAGS_disk_cache_size),
+        absl::GetFlag(FLAGS_grpc_compression)
     };
 
     return rpc_daemon_settings;
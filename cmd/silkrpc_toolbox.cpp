@@ -14,8 +14,12 @@
    limitations under the License.
 */
 
+#include <chrono>
+#include <exception>
+#include <filesystem>
 #include <iostream>
 #include <string>
+#include <thread>
 
 #include <absl/flags/flag.h>
 #include <absl/flags/parse.h>
@@ -23,8 +27,21 @@
 #include <silkworm/common/util.hpp>
 
 #include <silkrpc/common/constants.hpp>
+#include <silkrpc/bench/fake_backend.hpp>
+#include <silkrpc/bench/http_load.hpp>
+#include <silkrpc/bench/in_process_load.hpp>
+#include <silkrpc/bench/kv_load.hpp>
+#include <silkrpc/bench/workload.hpp>
 #include <silkrpc/common/log.hpp>
 
+int bench_http(const silkrpc::bench::Workload& workload, const silkrpc::bench::HttpLoadSettings& settings);
+int bench_in_process(const silkrpc::bench::Workload& workload, const silkrpc::bench::InProcessLoadSettings& settings,
+    const std::string& target, uint32_t num_contexts, uint32_t num_workers);
+
+int fake_backend(const std::string& dataset_file, const silkrpc::bench::FakeBackendSettings& settings);
+int kv_bench(const silkrpc::bench::KvLoadSettings& settings, const std::string& target, const std::string& model,
+    uint32_t num_contexts, uint32_t num_kv_channels, uint32_t key_samples, silkrpc::bench::KeyDistribution key_distribution);
+
 int ethbackend_async(const std::string& target);
 int ethbackend_coroutines(const std::string& target);
 int ethbackend(const std::string& target);
@@ -42,6 +59,31 @@ ABSL_FLAG(std::string, tool, "", "gRPC remote interface tool name as string");
 ABSL_FLAG(std::string, target, silkrpc::kDefaultTarget, "Erigon location as string <address>:<port>");
 ABSL_FLAG(std::string, table, "", "database table name as string");
 ABSL_FLAG(uint32_t, timeout, silkrpc::kDefaultTimeout.count(), "gRPC call timeout as integer");
+ABSL_FLAG(std::string, workload, "", "bench workload file as daemon recording or JSON RPC requests or Vegeta targets, one per line");
+ABSL_FLAG(std::string, mix, "", "bench method mix as comma-separated list like eth_call=70,eth_blockNumber=30");
+ABSL_FLAG(std::string, bench_mode, "http", "bench mode as string: http (daemon over HTTP) or in_process (RPC API handlers)");
+ABSL_FLAG(std::string, http_target, silkrpc::kDefaultHttpPort, "bench daemon HTTP location as string <address>:<port>");
+ABSL_FLAG(uint32_t, concurrency, 1, "bench concurrent clients as 32-bit integer");
+ABSL_FLAG(uint32_t, pipelining, 1, "bench requests pipelined by each client on its connection as 32-bit integer");
+ABSL_FLAG(bool, reuse_connections, true, "bench flag indicating if the connections are kept open across the requests");
+ABSL_FLAG(uint64_t, requests, 10'000, "bench total requests as 64-bit integer");
+ABSL_FLAG(uint32_t, threads, 1, "bench HTTP client threads as 32-bit integer");
+ABSL_FLAG(bool, replay_timing, false, "bench http flag indicating if the requests are sent at their recorded time");
+ABSL_FLAG(std::string, api_spec, silkrpc::kDefaultEth1ApiSpec, "bench in_process API specification as comma-separated list");
+ABSL_FLAG(uint32_t, num_contexts, 1, "bench in_process running I/O contexts as 32-bit integer");
+ABSL_FLAG(uint32_t, num_workers, std::thread::hardware_concurrency(), "bench in_process worker threads as 32-bit integer");
+ABSL_FLAG(std::string, dataset, "", "fake_backend dataset file recorded from Erigon");
+ABSL_FLAG(std::string, listen, silkrpc::kDefaultTarget, "fake_backend listening location as string <address>:<port>");
+ABSL_FLAG(uint32_t, latency, 0, "fake_backend latency injected before each reply in microseconds as 32-bit integer");
+ABSL_FLAG(uint32_t, latency_jitter, 0, "fake_backend max random latency added to the injected one in microseconds as 32-bit integer");
+ABSL_FLAG(std::string, kv_model, "coroutines", "kv_bench programming model as string: coroutines (as the daemon) or sync (blocking gRPC)");
+ABSL_FLAG(std::string, op_mix, "seek=1", "kv_bench op mix as comma-separated list like seek=40,seek_exact=30,next=20,seek_both=10");
+ABSL_FLAG(uint32_t, num_kv_channels, silkrpc::kDefaultNumKvChannels, "kv_bench channels (for each context in coroutines model) as 32-bit integer");
+ABSL_FLAG(uint32_t, walk_length, 10, "kv_bench nexts after the seek of each next walk as 32-bit integer");
+ABSL_FLAG(uint32_t, ops_per_tx, 100, "kv_bench ops run in each Tx stream before renewing it as 32-bit integer (0 means never)");
+ABSL_FLAG(uint32_t, key_samples, 10'000, "kv_bench keys sampled from the table as 32-bit integer");
+ABSL_FLAG(std::string, key_distribution, "uniform", "kv_bench distribution of the sampled keys as string: uniform or zipf");
+ABSL_FLAG(bool, record, false, "fake_backend flag indicating if the dataset is recorded forwarding the calls to Erigon at target");
 
 int ethbackend_async(int argc, char* argv[]) {
     auto target{absl::GetFlag(FLAGS_target)};
@@ -235,11 +277,195 @@ int kv_seek(int argc, char* argv[]) {
     return kv_seek(target, table_name, key_bytes.value());
 }
 
+int bench(int argc, char* argv[]) {
+    auto workload_file{absl::GetFlag(FLAGS_workload)};
+    auto mix{absl::GetFlag(FLAGS_mix)};
+    if (workload_file.empty() && mix.empty()) {
+        std::cerr << "Parameters workload and mix are both empty\n";
+        std::cerr << "Use --workload flag to specify the captured requests and/or --mix flag to specify the method mix\n";
+        return -1;
+    }
+
+    auto concurrency{absl::GetFlag(FLAGS_concurrency)};
+    if (concurrency == 0) {
+        std::cerr << "Parameter concurrency is invalid: [" << concurrency << "]\n";
+        std::cerr << "Use --concurrency flag to specify the number of concurrent clients\n";
+        return -1;
+    }
+
+    silkrpc::bench::Workload workload;
+    try {
+        if (workload_file.empty()) {
+            workload = silkrpc::bench::Workload::synthetic(silkrpc::bench::Workload::parse_mix(mix));
+        } else {
+            workload = silkrpc::bench::Workload::load(std::filesystem::path{workload_file});
+            if (!mix.empty()) {
+                workload = workload.with_mix(silkrpc::bench::Workload::parse_mix(mix));
+            }
+        }
+        if (workload.empty()) {
+            std::cerr << "Workload is empty: [" << workload_file << "]\n";
+            return -1;
+        }
+
+        auto bench_mode{absl::GetFlag(FLAGS_bench_mode)};
+        if (bench_mode == "http") {
+            auto http_target{absl::GetFlag(FLAGS_http_target)};
+            if (http_target.empty() || http_target.find(":") == std::string::npos) {
+                std::cerr << "Parameter http_target is invalid: [" << http_target << "]\n";
+                std::cerr << "Use --http_target flag to specify the location of Silkrpc running instance\n";
+                return -1;
+            }
+            auto pipelining{absl::GetFlag(FLAGS_pipelining)};
+            if (pipelining == 0) {
+                std::cerr << "Parameter pipelining is invalid: [" << pipelining << "]\n";
+                std::cerr << "Use --pipelining flag to specify the number of requests pipelined on each connection\n";
+                return -1;
+            }
+            auto threads{absl::GetFlag(FLAGS_threads)};
+            if (threads == 0) {
+                std::cerr << "Parameter threads is invalid: [" << threads << "]\n";
+                std::cerr << "Use --threads flag to specify the number of HTTP client threads\n";
+                return -1;
+            }
+            const silkrpc::bench::HttpLoadSettings settings{
+                http_target,
+                concurrency,
+                pipelining,
+                absl::GetFlag(FLAGS_reuse_connections),
+                absl::GetFlag(FLAGS_requests),
+                threads,
+                absl::GetFlag(FLAGS_replay_timing),
+            };
+            return bench_http(workload, settings);
+        }
+        if (bench_mode == "in_process") {
+            auto target{absl::GetFlag(FLAGS_target)};
+            if (target.empty() || target.find(":") == std::string::npos) {
+                std::cerr << "Parameter target is invalid: [" << target << "]\n";
+                std::cerr << "Use --target flag to specify the location of Erigon running instance\n";
+                return -1;
+            }
+            auto num_contexts{absl::GetFlag(FLAGS_num_contexts)};
+            auto num_workers{absl::GetFlag(FLAGS_num_workers)};
+            if (num_contexts == 0 || num_workers == 0) {
+                std::cerr << "Parameters num_contexts and num_workers are invalid: [" << num_contexts << ", " << num_workers << "]\n";
+                std::cerr << "Use --num_contexts and --num_workers flags to specify the number of I/O contexts and worker threads\n";
+                return -1;
+            }
+            const silkrpc::bench::InProcessLoadSettings settings{
+                absl::GetFlag(FLAGS_api_spec),
+                concurrency,
+                absl::GetFlag(FLAGS_requests),
+            };
+            return bench_in_process(workload, settings, target, num_contexts, num_workers);
+        }
+        std::cerr << "Parameter bench_mode is invalid: [" << bench_mode << "]\n";
+        std::cerr << "Use --bench_mode flag to specify either http or in_process\n";
+        return -1;
+    } catch (const std::exception& e) {
+        std::cerr << "Bench failed: " << e.what() << "\n";
+        return -1;
+    }
+}
+
+int fake_backend(int argc, char* argv[]) {
+    auto dataset_file{absl::GetFlag(FLAGS_dataset)};
+    if (dataset_file.empty()) {
+        std::cerr << "Parameter dataset is invalid: [" << dataset_file << "]\n";
+        std::cerr << "Use --dataset flag to specify the dataset file to serve or record\n";
+        return -1;
+    }
+
+    auto listen{absl::GetFlag(FLAGS_listen)};
+    if (listen.empty() || listen.find(":") == std::string::npos) {
+        std::cerr << "Parameter listen is invalid: [" << listen << "]\n";
+        std::cerr << "Use --listen flag to specify the location Silkrpc connects to\n";
+        return -1;
+    }
+
+    std::string upstream;
+    if (absl::GetFlag(FLAGS_record)) {
+        upstream = absl::GetFlag(FLAGS_target);
+        if (upstream.empty() || upstream.find(":") == std::string::npos || upstream == listen) {
+            std::cerr << "Parameter target is invalid: [" << upstream << "]\n";
+            std::cerr << "Use --target flag to specify the location of Erigon running instance to record from\n";
+            return -1;
+        }
+    }
+
+    const silkrpc::bench::FakeBackendSettings settings{
+        listen,
+        std::chrono::microseconds{absl::GetFlag(FLAGS_latency)},
+        std::chrono::microseconds{absl::GetFlag(FLAGS_latency_jitter)},
+        upstream,
+    };
+    try {
+        return fake_backend(dataset_file, settings);
+    } catch (const std::exception& e) {
+        std::cerr << "Fake backend failed: " << e.what() << "\n";
+        return -1;
+    }
+}
+
+int kv_bench(int argc, char* argv[]) {
+    auto target{absl::GetFlag(FLAGS_target)};
+    if (target.empty() || target.find(":") == std::string::npos) {
+        std::cerr << "Parameter target is invalid: [" << target << "]\n";
+        std::cerr << "Use --target flag to specify the location of Erigon running instance\n";
+        return -1;
+    }
+
+    auto table_name{absl::GetFlag(FLAGS_table)};
+    if (table_name.empty()) {
+        std::cerr << "Parameter table is invalid: [" << table_name << "]\n";
+        std::cerr << "Use --table flag to specify the name of Erigon database table\n";
+        return -1;
+    }
+
+    auto model{absl::GetFlag(FLAGS_kv_model)};
+    if (model != "coroutines" && model != "sync") {
+        std::cerr << "Parameter kv_model is invalid: [" << model << "]\n";
+        std::cerr << "Use --kv_model flag to specify either coroutines or sync\n";
+        return -1;
+    }
+
+    auto concurrency{absl::GetFlag(FLAGS_concurrency)};
+    auto num_contexts{absl::GetFlag(FLAGS_num_contexts)};
+    auto num_kv_channels{absl::GetFlag(FLAGS_num_kv_channels)};
+    if (concurrency == 0 || num_contexts == 0 || num_kv_channels == 0) {
+        std::cerr << "Parameters concurrency, num_contexts and num_kv_channels are invalid: [" << concurrency << ", " << num_contexts
+                  << ", " << num_kv_channels << "]\n";
+        std::cerr << "Use --concurrency, --num_contexts and --num_kv_channels flags to specify the number of Tx streams, "
+                     "I/O contexts and channels\n";
+        return -1;
+    }
+
+    try {
+        const silkrpc::bench::KvLoadSettings settings{
+            table_name,
+            silkrpc::bench::parse_op_mix(absl::GetFlag(FLAGS_op_mix)),
+            concurrency,
+            absl::GetFlag(FLAGS_requests),
+            absl::GetFlag(FLAGS_walk_length),
+            absl::GetFlag(FLAGS_ops_per_tx),
+        };
+        const auto key_distribution = silkrpc::bench::parse_key_distribution(absl::GetFlag(FLAGS_key_distribution));
+        return kv_bench(settings, target, model, num_contexts, num_kv_channels, absl::GetFlag(FLAGS_key_samples), key_distribution);
+    } catch (const std::exception& e) {
+        std::cerr << "KV bench failed: " << e.what() << "\n";
+        return -1;
+    }
+}
+
 int main(int argc, char* argv[]) {
     absl::SetProgramUsageMessage("Execute specified Silkrpc tool:\n"
+        "\tbench\t\t\t\tsend the JSON RPC workload to Silkrpc and report throughput and latency percentiles as JSON\n"
         "\tethbackend\t\t\tquery the Erigon/Silkworm ETHBACKEND remote interface\n"
         "\tethbackend_async\t\tquery the Erigon/Silkworm ETHBACKEND remote interface\n"
         "\tethbackend_coroutines\t\tquery the Erigon/Silkworm ETHBACKEND remote interface\n"
+        "\tfake_backend\t\t\tserve Silkrpc from the dataset recorded from Erigon (or record it) for hermetic benchmarks\n"
+        "\tkv_bench\t\t\tsend the cursor op mix over concurrent Tx streams to Erigon and report throughput and latency percentiles as JSON\n"
         "\tkv_seek\t\t\t\tquery using SEEK the Erigon/Silkworm Key-Value (KV) remote interface to database\n"
         "\tkv_seek_async\t\t\tquery using SEEK the Erigon/Silkworm Key-Value (KV) remote interface to database\n"
         "\tkv_seek_async_callback\t\tquery using SEEK the Erigon/Silkworm Key-Value (KV) remote interface to database\n"
@@ -256,6 +482,9 @@ int main(int argc, char* argv[]) {
     SILKRPC_LOG_VERBOSITY(absl::GetFlag(FLAGS_log_verbosity));
 
     const std::string tool{positional_args[1]};
+    if (tool == "bench") {
+        return bench(argc, argv);
+    }
     if (tool == "ethbackend_async") {
         return ethbackend_async(argc, argv);
     }
@@ -265,6 +494,12 @@ int main(int argc, char* argv[]) {
     if (tool == "ethbackend") {
         return ethbackend(argc, argv);
     }
+    if (tool == "fake_backend") {
+        return fake_backend(argc, argv);
+    }
+    if (tool == "kv_bench") {
+        return kv_bench(argc, argv);
+    }
     if (tool == "kv_seek_async_callback") {
         return kv_seek_async_callback(argc, argv);
     }
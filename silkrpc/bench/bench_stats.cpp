@@ -0,0 +1,88 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "bench_stats.hpp"
+
+#include <algorithm>
+
+namespace silkrpc::bench {
+
+//! Return the latency in seconds at the given percentile of the sorted samples, using the nearest-rank method
+static double percentile(const std::vector<int64_t>& sorted_latencies, double pct) {
+    if (sorted_latencies.empty()) {
+        return 0;
+    }
+    auto rank = static_cast<std::size_t>(pct / 100 * static_cast<double>(sorted_latencies.size()) + 0.5);
+    rank = std::clamp<std::size_t>(rank, 1, sorted_latencies.size());
+    return static_cast<double>(sorted_latencies[rank - 1]) / 1e9;
+}
+
+void BenchStats::record(const std::string& method, std::chrono::nanoseconds latency, bool ok) {
+    overall_.latencies.push_back(latency.count());
+    auto& method_samples = by_method_[method];
+    method_samples.latencies.push_back(latency.count());
+    if (!ok) {
+        ++overall_.errors;
+        ++method_samples.errors;
+    }
+}
+
+void BenchStats::merge(const BenchStats& other) {
+    overall_.merge(other.overall_);
+    for (const auto& [method, samples] : other.by_method_) {
+        by_method_[method].merge(samples);
+    }
+}
+
+nlohmann::json BenchStats::report(std::chrono::nanoseconds elapsed) const {
+    auto json = overall_.report(elapsed);
+    json["elapsed"] = static_cast<double>(elapsed.count()) / 1e9;
+    json["methods"] = nlohmann::json::object();
+    for (const auto& [method, samples] : by_method_) {
+        json["methods"][method] = samples.report(elapsed);
+    }
+    return json;
+}
+
+void BenchStats::Samples::merge(const Samples& other) {
+    latencies.insert(latencies.end(), other.latencies.begin(), other.latencies.end());
+    errors += other.errors;
+}
+
+nlohmann::json BenchStats::Samples::report(std::chrono::nanoseconds elapsed) const {
+    auto sorted_latencies = latencies;
+    std::sort(sorted_latencies.begin(), sorted_latencies.end());
+    const auto elapsed_seconds = static_cast<double>(elapsed.count()) / 1e9;
+    return nlohmann::json{
+        {"requests", sorted_latencies.size()},
+        {"errors", errors},
+        {"throughput", elapsed_seconds > 0 ? static_cast<double>(sorted_latencies.size()) / elapsed_seconds : 0.0},
+        {"latency", {
+            {"p50", percentile(sorted_latencies, 50)},
+            {"p90", percentile(sorted_latencies, 90)},
+            {"p99", percentile(sorted_latencies, 99)},
+            {"p99.9", percentile(sorted_latencies, 99.9)},
+            {"max", sorted_latencies.empty() ? 0.0 : static_cast<double>(sorted_latencies.back()) / 1e9},
+        }},
+    };
+}
+
+bool has_error(std::string_view reply_content) {
+    return reply_content.find("\"error\":") != std::string_view::npos;
+}
+
+} // namespace silkrpc::bench
@@ -0,0 +1,70 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_BENCH_BENCH_STATS_HPP_
+#define SILKRPC_BENCH_BENCH_STATS_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace silkrpc::bench {
+
+//! The outcome of the requests sent by one load generator client, merged into the overall one at the end
+class BenchStats {
+public:
+    void record(const std::string& method, std::chrono::nanoseconds latency, bool ok);
+
+    void merge(const BenchStats& other);
+
+    uint64_t num_requests() const noexcept { return overall_.latencies.size(); }
+    uint64_t num_errors() const noexcept { return overall_.errors; }
+
+    //! Return the report with throughput and latency percentiles, overall and by method
+    nlohmann::json report(std::chrono::nanoseconds elapsed) const;
+
+private:
+    struct Samples {
+        std::vector<int64_t> latencies;
+        uint64_t errors{0};
+
+        void merge(const Samples& other);
+        nlohmann::json report(std::chrono::nanoseconds elapsed) const;
+    };
+
+    Samples overall_;
+    std::map<std::string, Samples> by_method_;
+};
+
+//! The outcome of one load generator run
+struct BenchResult {
+    BenchStats stats;
+    std::chrono::nanoseconds elapsed{0};
+};
+
+//! Return true if the JSON RPC reply content (also batch) has some error, looked up just as text not to spend the
+//! client CPU on parsing the replies
+bool has_error(std::string_view reply_content);
+
+} // namespace silkrpc::bench
+
+#endif // SILKRPC_BENCH_BENCH_STATS_HPP_
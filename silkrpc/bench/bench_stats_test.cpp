@@ -0,0 +1,76 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "bench_stats.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc::bench {
+
+using namespace std::chrono_literals; // NOLINT(build/namespaces)
+
+TEST_CASE("BenchStats::report", "[silkrpc][bench][bench_stats]") {
+    SECTION("no requests") {
+        BenchStats stats;
+        const auto report = stats.report(1s);
+        CHECK(report["requests"] == 0);
+        CHECK(report["throughput"] == 0.0);
+        CHECK(report["latency"]["p99"] == 0.0);
+        CHECK(report["methods"].empty());
+    }
+
+    SECTION("throughput and percentiles") {
+        BenchStats stats;
+        for (int i{1}; i <= 100; ++i) {
+            stats.record(i % 2 == 0 ? "eth_call" : "eth_blockNumber", std::chrono::milliseconds{i}, i != 100);
+        }
+        const auto report = stats.report(2s);
+        CHECK(report["requests"] == 100);
+        CHECK(report["errors"] == 1);
+        CHECK(report["elapsed"] == 2.0);
+        CHECK(report["throughput"] == 50.0);
+        CHECK(report["latency"]["p50"] == Approx(0.050));
+        CHECK(report["latency"]["p90"] == Approx(0.090));
+        CHECK(report["latency"]["p99"] == Approx(0.099));
+        CHECK(report["latency"]["max"] == Approx(0.100));
+        CHECK(report["methods"]["eth_call"]["requests"] == 50);
+        CHECK(report["methods"]["eth_call"]["errors"] == 1);
+        CHECK(report["methods"]["eth_blockNumber"]["errors"] == 0);
+        CHECK(report["methods"]["eth_blockNumber"]["latency"]["max"] == Approx(0.099));
+    }
+
+    SECTION("merged stats") {
+        BenchStats stats1, stats2;
+        stats1.record("eth_call", 1ms, true);
+        stats2.record("eth_call", 3ms, false);
+        stats2.record("eth_chainId", 2ms, true);
+        stats1.merge(stats2);
+        CHECK(stats1.num_requests() == 3);
+        CHECK(stats1.num_errors() == 1);
+        const auto report = stats1.report(1s);
+        CHECK(report["methods"]["eth_call"]["requests"] == 2);
+        CHECK(report["latency"]["p50"] == Approx(0.002));
+    }
+}
+
+TEST_CASE("has_error", "[silkrpc][bench][bench_stats]") {
+    CHECK(!has_error(R"({"jsonrpc":"2.0","id":1,"result":"0x1"})"));
+    CHECK(has_error(R"({"jsonrpc":"2.0","id":1,"error":{"code":-32000,"message":"x"}})"));
+    CHECK(has_error(R"([{"jsonrpc":"2.0","id":1,"result":"0x1"},{"jsonrpc":"2.0","id":2,"error":{"code":1}}])"));
+}
+
+} // namespace silkrpc::bench
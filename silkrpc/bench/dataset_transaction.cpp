@@ -0,0 +1,66 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "dataset_transaction.hpp"
+
+namespace silkrpc::bench {
+
+static KeyValue key_value_of(const KvDataset::Pair* pair) {
+    return pair != nullptr ? KeyValue{pair->first, pair->second} : KeyValue{};
+}
+
+boost::asio::awaitable<void> DatasetCursor::open_cursor(const std::string& table_name, bool /*is_dup_sorted*/) {
+    cursor_.emplace(dataset_.cursor(table_name));
+    co_return;
+}
+
+boost::asio::awaitable<KeyValue> DatasetCursor::seek(silkworm::ByteView key) {
+    co_return key_value_of(cursor_->seek(key));
+}
+
+boost::asio::awaitable<KeyValue> DatasetCursor::seek_exact(silkworm::ByteView key) {
+    co_return key_value_of(cursor_->seek_exact(key));
+}
+
+boost::asio::awaitable<KeyValue> DatasetCursor::next() {
+    co_return key_value_of(cursor_->next());
+}
+
+boost::asio::awaitable<silkworm::Bytes> DatasetCursor::seek_both(silkworm::ByteView key, silkworm::ByteView value) {
+    const auto* pair = cursor_->seek_both(key, value);
+    co_return pair != nullptr ? pair->second : silkworm::Bytes{};
+}
+
+boost::asio::awaitable<KeyValue> DatasetCursor::seek_both_exact(silkworm::ByteView key, silkworm::ByteView value) {
+    co_return key_value_of(cursor_->seek_both_exact(key, value));
+}
+
+boost::asio::awaitable<KeyValue> DatasetCursor::next_dup() {
+    co_return key_value_of(cursor_->next_dup());
+}
+
+boost::asio::awaitable<std::shared_ptr<ethdb::Cursor>> DatasetTransaction::cursor(const std::string& table) {
+    co_return co_await cursor_dup_sort(table);
+}
+
+boost::asio::awaitable<std::shared_ptr<ethdb::CursorDupSort>> DatasetTransaction::cursor_dup_sort(const std::string& table) {
+    auto cursor = std::make_shared<DatasetCursor>(dataset_, next_cursor_id_++);
+    co_await cursor->open_cursor(table, /*is_dup_sorted=*/true);
+    co_return cursor;
+}
+
+} // namespace silkrpc::bench
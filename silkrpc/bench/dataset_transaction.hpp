@@ -0,0 +1,91 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_BENCH_DATASET_TRANSACTION_HPP_
+#define SILKRPC_BENCH_DATASET_TRANSACTION_HPP_
+
+#include <silkrpc/config.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <boost/asio/awaitable.hpp>
+
+#include <silkrpc/bench/kv_dataset.hpp>
+#include <silkrpc/common/util.hpp>
+#include <silkrpc/ethdb/cursor.hpp>
+#include <silkrpc/ethdb/transaction.hpp>
+
+namespace silkrpc::bench {
+
+//! The cursor over one table of the recorded dataset, completing each operation right away w/o any I/O
+class DatasetCursor : public ethdb::CursorDupSort {
+public:
+    DatasetCursor(const KvDataset& dataset, uint32_t cursor_id) : dataset_{dataset}, cursor_id_{cursor_id} {}
+
+    uint32_t cursor_id() const override { return cursor_id_; }
+
+    boost::asio::awaitable<void> open_cursor(const std::string& table_name, bool is_dup_sorted) override;
+
+    boost::asio::awaitable<KeyValue> seek(silkworm::ByteView key) override;
+
+    boost::asio::awaitable<KeyValue> seek_exact(silkworm::ByteView key) override;
+
+    boost::asio::awaitable<KeyValue> next() override;
+
+    boost::asio::awaitable<void> close_cursor() override { co_return; }
+
+    boost::asio::awaitable<silkworm::Bytes> seek_both(silkworm::ByteView key, silkworm::ByteView value) override;
+
+    boost::asio::awaitable<KeyValue> seek_both_exact(silkworm::ByteView key, silkworm::ByteView value) override;
+
+    boost::asio::awaitable<KeyValue> next_dup() override;
+
+private:
+    const KvDataset& dataset_;
+    uint32_t cursor_id_;
+    //! The cursor over the table, set when opened
+    std::optional<KvDataset::Cursor> cursor_;
+};
+
+//! The transaction reading the recorded dataset in memory, so that the code reading the database (e.g. the executors
+//! through ethdb::TransactionDatabase) can be measured apart from the remote KV interface and the network
+class DatasetTransaction : public ethdb::Transaction {
+public:
+    explicit DatasetTransaction(const KvDataset& dataset, uint64_t tx_id = 1) : dataset_{dataset}, tx_id_{tx_id} {}
+
+    uint64_t tx_id() const override { return tx_id_; }
+
+    boost::asio::awaitable<void> open() override { co_return; }
+
+    boost::asio::awaitable<std::shared_ptr<ethdb::Cursor>> cursor(const std::string& table) override;
+
+    boost::asio::awaitable<std::shared_ptr<ethdb::CursorDupSort>> cursor_dup_sort(const std::string& table) override;
+
+    boost::asio::awaitable<void> close() override { co_return; }
+
+private:
+    const KvDataset& dataset_;
+    uint64_t tx_id_;
+    uint32_t next_cursor_id_{1};
+};
+
+} // namespace silkrpc::bench
+
+#endif // SILKRPC_BENCH_DATASET_TRANSACTION_HPP_
@@ -0,0 +1,76 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "dataset_transaction.hpp"
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/use_future.hpp>
+#include <catch2/catch.hpp>
+#include <silkworm/common/util.hpp>
+
+#include <silkrpc/ethdb/transaction_database.hpp>
+
+namespace silkrpc::bench {
+
+template <typename T>
+static T spawn_and_wait(boost::asio::io_context& io_context, boost::asio::awaitable<T> awaitable) {
+    auto result = boost::asio::co_spawn(io_context, std::move(awaitable), boost::asio::use_future);
+    io_context.run();
+    io_context.restart();
+    return result.get();
+}
+
+TEST_CASE("DatasetTransaction", "[silkrpc][bench][dataset_transaction]") {
+    KvDataset dataset;
+    dataset.add("PlainState", *silkworm::from_hex("01"), *silkworm::from_hex("aa"));
+    dataset.add("PlainState", *silkworm::from_hex("02"), *silkworm::from_hex("bb01"));
+    dataset.add("PlainState", *silkworm::from_hex("02"), *silkworm::from_hex("bb02"));
+    DatasetTransaction tx{dataset};
+    ethdb::TransactionDatabase database{tx};
+    boost::asio::io_context io_context;
+
+    SECTION("get") {
+        const auto kv = spawn_and_wait(io_context, database.get("PlainState", *silkworm::from_hex("00")));
+        CHECK(kv.key == *silkworm::from_hex("01"));
+        CHECK(kv.value == *silkworm::from_hex("aa"));
+    }
+
+    SECTION("get_one") {
+        CHECK(spawn_and_wait(io_context, database.get_one("PlainState", *silkworm::from_hex("01"))) == *silkworm::from_hex("aa"));
+        CHECK(spawn_and_wait(io_context, database.get_one("PlainState", *silkworm::from_hex("03"))).empty());
+        CHECK(spawn_and_wait(io_context, database.get_one("Code", *silkworm::from_hex("01"))).empty());
+    }
+
+    SECTION("get_both_range") {
+        const auto value = spawn_and_wait(io_context, database.get_both_range("PlainState", *silkworm::from_hex("02"), *silkworm::from_hex("bb02")));
+        REQUIRE(value);
+        CHECK(*value == *silkworm::from_hex("bb02"));
+    }
+
+    SECTION("cursor ids") {
+        const auto cursor1 = spawn_and_wait(io_context, tx.cursor("PlainState"));
+        const auto cursor2 = spawn_and_wait(io_context, tx.cursor_dup_sort("PlainState"));
+        CHECK(cursor1->cursor_id() != cursor2->cursor_id());
+        const auto kv = spawn_and_wait(io_context, cursor2->seek_both_exact(*silkworm::from_hex("02"), *silkworm::from_hex("bb01")));
+        CHECK(kv.value == *silkworm::from_hex("bb01"));
+        CHECK(spawn_and_wait(io_context, cursor2->next_dup()).value == *silkworm::from_hex("bb02"));
+        CHECK(spawn_and_wait(io_context, cursor2->next_dup()).key.empty());
+    }
+}
+
+} // namespace silkrpc::bench
@@ -0,0 +1,404 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "fake_backend.hpp"
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <silkworm/common/util.hpp>
+
+#include <silkrpc/interfaces/remote/ethbackend.grpc.pb.h>
+#include <silkrpc/interfaces/remote/kv.grpc.pb.h>
+#include <silkrpc/interfaces/txpool/mining.grpc.pb.h>
+#include <silkrpc/interfaces/txpool/txpool.grpc.pb.h>
+#include <silkrpc/interfaces/types/types.pb.h>
+#include <silkrpc/protocol/version.hpp>
+
+namespace silkrpc::bench {
+
+namespace {
+
+//! The transaction id sent at the start of the Tx streams when not recorded
+constexpr uint64_t kDefaultTxId{1};
+
+//! The interval between the checks of the StateChanges stream cancellation
+constexpr std::chrono::milliseconds kCancelPollInterval{100};
+
+//! The seed of the jitter sequence, the same at each run
+constexpr uint32_t kJitterSeed{42};
+
+//! The latency injected before each reply, the jitter being drawn by each serving thread from the same sequence
+class InjectedLatency {
+public:
+    InjectedLatency(std::chrono::microseconds latency, std::chrono::microseconds jitter) : latency_{latency}, jitter_{jitter} {}
+
+    void wait() const {
+        auto delay{latency_};
+        if (jitter_.count() > 0) {
+            thread_local std::minstd_rand generator{kJitterSeed};
+            delay += std::chrono::microseconds{std::uniform_int_distribution<int64_t>{0, jitter_.count()}(generator)};
+        }
+        if (delay.count() > 0) {
+            std::this_thread::sleep_for(delay);
+        }
+    }
+
+private:
+    std::chrono::microseconds latency_;
+    std::chrono::microseconds jitter_;
+};
+
+void set_version(types::VersionReply* reply, const ProtocolVersion& version) {
+    reply->set_major(version.major);
+    reply->set_minor(version.minor);
+    reply->set_patch(version.patch);
+}
+
+//! Serve the unary call from the dataset or, having the upstream stub, forward it recording the reply
+template <typename Stub, typename Request, typename Reply, typename Call>
+grpc::Status serve_call(KvDataset& dataset, const InjectedLatency& latency, Stub* upstream, const char* method,
+                        const Request& request, Reply* reply, Call call) {
+    if (upstream != nullptr) {
+        grpc::ClientContext context;
+        const auto status = call(*upstream, &context, request, reply);
+        if (status.ok()) {
+            dataset.add_reply(method, request.SerializeAsString(), reply->SerializeAsString());
+        }
+        return status;
+    }
+    const auto* recorded = dataset.find_reply(method, request.SerializeAsString());
+    latency.wait();
+    if (recorded == nullptr || !reply->ParseFromString(*recorded)) {
+        return grpc::Status{grpc::StatusCode::NOT_FOUND, std::string{method} + " call not recorded"};
+    }
+    return grpc::Status::OK;
+}
+
+class KvService final : public remote::KV::Service {
+public:
+    KvService(KvDataset& dataset, const InjectedLatency& latency, const std::shared_ptr<grpc::Channel>& upstream)
+    : dataset_{dataset}, latency_{latency}, upstream_{upstream ? remote::KV::NewStub(upstream) : nullptr} {}
+
+    grpc::Status Version(grpc::ServerContext* /*context*/, const google::protobuf::Empty* /*request*/, types::VersionReply* reply) override {
+        set_version(reply, KV_SERVICE_API_VERSION);
+        return grpc::Status::OK;
+    }
+
+    grpc::Status Tx(grpc::ServerContext* /*context*/, grpc::ServerReaderWriter<remote::Pair, remote::Cursor>* stream) override {
+        return upstream_ ? record_tx(stream) : serve_tx(stream);
+    }
+
+    grpc::Status StateChanges(grpc::ServerContext* context, const remote::StateChangeRequest* request,
+                              grpc::ServerWriter<remote::StateChangeBatch>* writer) override {
+        if (upstream_) {
+            return record_state_changes(context, request, writer);
+        }
+        const auto* recorded = dataset_.find_reply(FakeBackend::kStateChangesMethod, request->SerializeAsString());
+        remote::StateChangeBatch batch;
+        if (recorded != nullptr && batch.ParseFromString(*recorded) && !writer->Write(batch)) {
+            return grpc::Status::OK;
+        }
+        // No other batch ever comes, because the recorded chain does not move
+        while (!context->IsCancelled()) {
+            std::this_thread::sleep_for(kCancelPollInterval);
+        }
+        return grpc::Status::OK;
+    }
+
+private:
+    grpc::Status serve_tx(grpc::ServerReaderWriter<remote::Pair, remote::Cursor>* stream) {
+        remote::Pair reply;
+        const auto* recorded = dataset_.find_reply(FakeBackend::kTxMethod, "");
+        if (recorded == nullptr || !reply.ParseFromString(*recorded)) {
+            reply.set_txid(kDefaultTxId);
+        }
+        latency_.wait();
+        if (!stream->Write(reply)) {
+            return grpc::Status::OK;
+        }
+        // The cursor ids are assigned in sequence as Erigon does, so that silkrpc can predict them
+        std::map<uint32_t, KvDataset::Cursor> cursors;
+        uint32_t next_cursor_id{1};
+        remote::Cursor request;
+        while (stream->Read(&request)) {
+            reply.Clear();
+            if (request.op() == remote::Op::OPEN || request.op() == remote::Op::OPEN_DUP_SORT) {
+                cursors.emplace(next_cursor_id, dataset_.cursor(request.bucketname()));
+                reply.set_cursorid(next_cursor_id++);
+            } else if (request.op() == remote::Op::CLOSE) {
+                cursors.erase(request.cursor());
+            } else {
+                const auto it = cursors.find(request.cursor());
+                if (it == cursors.end()) {
+                    return grpc::Status{grpc::StatusCode::INVALID_ARGUMENT, "unknown cursor " + std::to_string(request.cursor())};
+                }
+                const KvDataset::Pair* pair{nullptr};
+                if (!apply(it->second, request, pair)) {
+                    return grpc::Status{grpc::StatusCode::UNIMPLEMENTED, "unsupported cursor op " + remote::Op_Name(request.op())};
+                }
+                if (pair != nullptr) {
+                    reply.set_k(pair->first.data(), pair->first.size());
+                    reply.set_v(pair->second.data(), pair->second.size());
+                }
+            }
+            latency_.wait();
+            if (!stream->Write(reply)) {
+                break;
+            }
+        }
+        return grpc::Status::OK;
+    }
+
+    static bool apply(KvDataset::Cursor& cursor, const remote::Cursor& request, const KvDataset::Pair*& pair) {
+        const auto key{silkworm::byte_view_of_string(request.k())};
+        const auto value{silkworm::byte_view_of_string(request.v())};
+        switch (request.op()) {
+            case remote::Op::FIRST: pair = cursor.first(); return true;
+            case remote::Op::FIRST_DUP: pair = cursor.first_dup(); return true;
+            case remote::Op::SEEK: pair = cursor.seek(key); return true;
+            case remote::Op::SEEK_BOTH: pair = cursor.seek_both(key, value); return true;
+            case remote::Op::CURRENT: pair = cursor.current(); return true;
+            case remote::Op::LAST: pair = cursor.last(); return true;
+            case remote::Op::LAST_DUP: pair = cursor.last_dup(); return true;
+            case remote::Op::NEXT: pair = cursor.next(); return true;
+            case remote::Op::NEXT_DUP: pair = cursor.next_dup(); return true;
+            case remote::Op::NEXT_NO_DUP: pair = cursor.next_no_dup(); return true;
+            case remote::Op::PREV: pair = cursor.prev(); return true;
+            case remote::Op::PREV_DUP: pair = cursor.prev_dup(); return true;
+            case remote::Op::PREV_NO_DUP: pair = cursor.prev_no_dup(); return true;
+            case remote::Op::SEEK_EXACT: pair = cursor.seek_exact(key); return true;
+            case remote::Op::SEEK_BOTH_EXACT: pair = cursor.seek_both_exact(key, value); return true;
+            default: return false;
+        }
+    }
+
+    grpc::Status record_tx(grpc::ServerReaderWriter<remote::Pair, remote::Cursor>* stream) {
+        grpc::ClientContext upstream_context;
+        auto upstream_stream = upstream_->Tx(&upstream_context);
+        remote::Pair reply;
+        if (!upstream_stream->Read(&reply)) {
+            return upstream_stream->Finish();
+        }
+        dataset_.add_reply(FakeBackend::kTxMethod, "", reply.SerializeAsString());
+        if (!stream->Write(reply)) {
+            upstream_context.TryCancel();
+            return upstream_stream->Finish();
+        }
+        // The requests are forwarded one at a time, so that each reply is matched to its request
+        std::map<uint32_t, std::string> tables;
+        remote::Cursor request;
+        while (stream->Read(&request)) {
+            if (!upstream_stream->Write(request) || !upstream_stream->Read(&reply)) {
+                return upstream_stream->Finish();
+            }
+            record_reply(tables, request, reply);
+            if (!stream->Write(reply)) {
+                break;
+            }
+        }
+        upstream_stream->WritesDone();
+        return upstream_stream->Finish();
+    }
+
+    void record_reply(std::map<uint32_t, std::string>& tables, const remote::Cursor& request, const remote::Pair& reply) {
+        if (request.op() == remote::Op::OPEN || request.op() == remote::Op::OPEN_DUP_SORT) {
+            tables[reply.cursorid()] = request.bucketname();
+            return;
+        }
+        if (request.op() == remote::Op::CLOSE) {
+            tables.erase(request.cursor());
+            return;
+        }
+        const auto it = tables.find(request.cursor());
+        if (it == tables.end()) {
+            return;
+        }
+        if (!reply.k().empty()) {
+            dataset_.add(it->second, silkworm::byte_view_of_string(reply.k()), silkworm::byte_view_of_string(reply.v()));
+        } else if (!reply.v().empty() && !request.k().empty()) {
+            // Some dup-sorted operations reply just the value of the requested key
+            dataset_.add(it->second, silkworm::byte_view_of_string(request.k()), silkworm::byte_view_of_string(reply.v()));
+        }
+    }
+
+    grpc::Status record_state_changes(grpc::ServerContext* context, const remote::StateChangeRequest* request,
+                                      grpc::ServerWriter<remote::StateChangeBatch>* writer) {
+        grpc::ClientContext upstream_context;
+        auto upstream_reader = upstream_->StateChanges(&upstream_context, *request);
+        // Just the latest batch is kept, being the one consistent with the latest Tx recorded
+        remote::StateChangeBatch batch;
+        while (!context->IsCancelled() && upstream_reader->Read(&batch)) {
+            dataset_.add_reply(FakeBackend::kStateChangesMethod, request->SerializeAsString(), batch.SerializeAsString());
+            if (!writer->Write(batch)) {
+                break;
+            }
+        }
+        upstream_context.TryCancel();
+        upstream_reader->Finish();
+        return grpc::Status::OK;
+    }
+
+    KvDataset& dataset_;
+    InjectedLatency latency_;
+    std::unique_ptr<remote::KV::Stub> upstream_;
+};
+
+class EthBackendService final : public remote::ETHBACKEND::Service {
+public:
+    using Stub = remote::ETHBACKEND::Stub;
+
+    EthBackendService(KvDataset& dataset, const InjectedLatency& latency, const std::shared_ptr<grpc::Channel>& upstream)
+    : dataset_{dataset}, latency_{latency}, upstream_{upstream ? remote::ETHBACKEND::NewStub(upstream) : nullptr} {}
+
+    grpc::Status Version(grpc::ServerContext* /*context*/, const google::protobuf::Empty* /*request*/, types::VersionReply* reply) override {
+        set_version(reply, ETHBACKEND_SERVICE_API_VERSION);
+        return grpc::Status::OK;
+    }
+
+    grpc::Status Etherbase(grpc::ServerContext* /*context*/, const remote::EtherbaseRequest* request, remote::EtherbaseReply* reply) override {
+        return serve("/remote.ETHBACKEND/Etherbase", *request, reply, [](auto& stub, auto* context, const auto& req, auto* rep) {
+            return stub.Etherbase(context, req, rep);
+        });
+    }
+
+    grpc::Status NetVersion(grpc::ServerContext* /*context*/, const remote::NetVersionRequest* request, remote::NetVersionReply* reply) override {
+        return serve("/remote.ETHBACKEND/NetVersion", *request, reply, [](auto& stub, auto* context, const auto& req, auto* rep) {
+            return stub.NetVersion(context, req, rep);
+        });
+    }
+
+    grpc::Status NetPeerCount(grpc::ServerContext* /*context*/, const remote::NetPeerCountRequest* request, remote::NetPeerCountReply* reply) override {
+        return serve("/remote.ETHBACKEND/NetPeerCount", *request, reply, [](auto& stub, auto* context, const auto& req, auto* rep) {
+            return stub.NetPeerCount(context, req, rep);
+        });
+    }
+
+    grpc::Status ProtocolVersion(grpc::ServerContext* /*context*/, const remote::ProtocolVersionRequest* request,
+                                 remote::ProtocolVersionReply* reply) override {
+        return serve("/remote.ETHBACKEND/ProtocolVersion", *request, reply, [](auto& stub, auto* context, const auto& req, auto* rep) {
+            return stub.ProtocolVersion(context, req, rep);
+        });
+    }
+
+    grpc::Status ClientVersion(grpc::ServerContext* /*context*/, const remote::ClientVersionRequest* request,
+                               remote::ClientVersionReply* reply) override {
+        return serve("/remote.ETHBACKEND/ClientVersion", *request, reply, [](auto& stub, auto* context, const auto& req, auto* rep) {
+            return stub.ClientVersion(context, req, rep);
+        });
+    }
+
+    grpc::Status Block(grpc::ServerContext* /*context*/, const remote::BlockRequest* request, remote::BlockReply* reply) override {
+        return serve("/remote.ETHBACKEND/Block", *request, reply, [](auto& stub, auto* context, const auto& req, auto* rep) {
+            return stub.Block(context, req, rep);
+        });
+    }
+
+    grpc::Status TxnLookup(grpc::ServerContext* /*context*/, const remote::TxnLookupRequest* request, remote::TxnLookupReply* reply) override {
+        return serve("/remote.ETHBACKEND/TxnLookup", *request, reply, [](auto& stub, auto* context, const auto& req, auto* rep) {
+            return stub.TxnLookup(context, req, rep);
+        });
+    }
+
+    grpc::Status NodeInfo(grpc::ServerContext* /*context*/, const remote::NodesInfoRequest* request, remote::NodesInfoReply* reply) override {
+        return serve("/remote.ETHBACKEND/NodeInfo", *request, reply, [](auto& stub, auto* context, const auto& req, auto* rep) {
+            return stub.NodeInfo(context, req, rep);
+        });
+    }
+
+    grpc::Status Peers(grpc::ServerContext* /*context*/, const google::protobuf::Empty* request, remote::PeersReply* reply) override {
+        return serve("/remote.ETHBACKEND/Peers", *request, reply, [](auto& stub, auto* context, const auto& req, auto* rep) {
+            return stub.Peers(context, req, rep);
+        });
+    }
+
+private:
+    template <typename Request, typename Reply, typename Call>
+    grpc::Status serve(const char* method, const Request& request, Reply* reply, Call call) {
+        return serve_call(dataset_, latency_, upstream_.get(), method, request, reply, call);
+    }
+
+    KvDataset& dataset_;
+    InjectedLatency latency_;
+    std::unique_ptr<Stub> upstream_;
+};
+
+class MiningService final : public ::txpool::Mining::Service {
+public:
+    grpc::Status Version(grpc::ServerContext* /*context*/, const google::protobuf::Empty* /*request*/, types::VersionReply* reply) override {
+        set_version(reply, MINING_SERVICE_API_VERSION);
+        return grpc::Status::OK;
+    }
+};
+
+class TxpoolService final : public ::txpool::Txpool::Service {
+public:
+    grpc::Status Version(grpc::ServerContext* /*context*/, const google::protobuf::Empty* /*request*/, types::VersionReply* reply) override {
+        set_version(reply, TXPOOL_SERVICE_API_VERSION);
+        return grpc::Status::OK;
+    }
+};
+
+} // namespace
+
+FakeBackend::FakeBackend(KvDataset& dataset, const FakeBackendSettings& settings) : dataset_{dataset}, settings_{settings} {}
+
+FakeBackend::~FakeBackend() {
+    shutdown();
+    wait();
+}
+
+void FakeBackend::start() {
+    std::shared_ptr<grpc::Channel> upstream;
+    if (!settings_.upstream.empty()) {
+        upstream = grpc::CreateChannel(settings_.upstream, grpc::InsecureChannelCredentials());
+    }
+    const InjectedLatency latency{settings_.latency, settings_.latency_jitter};
+    services_.push_back(std::make_unique<KvService>(dataset_, latency, upstream));
+    services_.push_back(std::make_unique<EthBackendService>(dataset_, latency, upstream));
+    services_.push_back(std::make_unique<MiningService>());
+    services_.push_back(std::make_unique<TxpoolService>());
+
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort(settings_.address, grpc::InsecureServerCredentials(), &port_);
+    for (const auto& service : services_) {
+        builder.RegisterService(service.get());
+    }
+    server_ = builder.BuildAndStart();
+    if (!server_ || port_ == 0) {
+        throw std::runtime_error{"cannot listen on " + settings_.address};
+    }
+}
+
+void FakeBackend::shutdown() {
+    if (server_) {
+        // The deadline being already expired, the pending streams are cancelled right away
+        server_->Shutdown(std::chrono::system_clock::now());
+    }
+}
+
+void FakeBackend::wait() {
+    if (server_) {
+        server_->Wait();
+    }
+}
+
+} // namespace silkrpc::bench
@@ -0,0 +1,82 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_BENCH_FAKE_BACKEND_HPP_
+#define SILKRPC_BENCH_FAKE_BACKEND_HPP_
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include <silkrpc/bench/kv_dataset.hpp>
+
+namespace silkrpc::bench {
+
+struct FakeBackendSettings {
+    //! The listening address as <address>:<port>, port 0 picking an unused one (see FakeBackend::port)
+    std::string address;
+    //! The latency injected before each reply, i.e. each cursor operation and each backend call
+    std::chrono::microseconds latency{0};
+    //! The max random latency added to the injected one, drawn from the same sequence at each run
+    std::chrono::microseconds latency_jitter{0};
+    //! The location of the Erigon instance the calls are forwarded to when recording the dataset, empty when serving it
+    std::string upstream;
+};
+
+//! The gRPC server standing in for Erigon in the hermetic benchmarks: it serves the remote KV interface (Tx and
+//! StateChanges) and the ETHBACKEND interface from the recorded dataset, replying also to the version checks of the
+//! Mining and Txpool interfaces. Pointed at some upstream Erigon, it forwards the calls to it recording the dataset
+//! instead, so that running the workload once against the recording backend is enough to replay it w/o Erigon.
+//! The calls not recorded fail with NOT_FOUND status, the StateChanges stream sending the recorded batch (if any).
+class FakeBackend {
+public:
+    //! The Tx and StateChanges streams are recorded under these names, as the backend calls by their full method name
+    static constexpr const char* kTxMethod{"/remote.KV/Tx"};
+    static constexpr const char* kStateChangesMethod{"/remote.KV/StateChanges"};
+
+    FakeBackend(KvDataset& dataset, const FakeBackendSettings& settings);
+    ~FakeBackend();
+
+    FakeBackend(const FakeBackend&) = delete;
+    FakeBackend& operator=(const FakeBackend&) = delete;
+
+    //! Start serving, throwing std::runtime_error if the listening address cannot be bound
+    void start();
+
+    //! Stop serving, cancelling the pending calls
+    void shutdown();
+
+    //! Wait until shutdown
+    void wait();
+
+    //! The listening port, known after start
+    int port() const { return port_; }
+
+private:
+    KvDataset& dataset_;
+    FakeBackendSettings settings_;
+    std::vector<std::unique_ptr<grpc::Service>> services_;
+    std::unique_ptr<grpc::Server> server_;
+    int port_{0};
+};
+
+} // namespace silkrpc::bench
+
+#endif // SILKRPC_BENCH_FAKE_BACKEND_HPP_
@@ -0,0 +1,173 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "fake_backend.hpp"
+
+#include <string>
+
+#include <catch2/catch.hpp>
+#include <grpcpp/grpcpp.h>
+#include <silkworm/common/util.hpp>
+
+#include <silkrpc/interfaces/remote/ethbackend.grpc.pb.h>
+#include <silkrpc/interfaces/remote/kv.grpc.pb.h>
+#include <silkrpc/protocol/version.hpp>
+
+namespace silkrpc::bench {
+
+static std::string string_of(silkworm::ByteView bytes) {
+    return std::string{reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+}
+
+static std::shared_ptr<grpc::Channel> channel_to(const FakeBackend& backend) {
+    return grpc::CreateChannel("localhost:" + std::to_string(backend.port()), grpc::InsecureChannelCredentials());
+}
+
+TEST_CASE("FakeBackend passes the protocol checks", "[silkrpc][bench][fake_backend]") {
+    KvDataset dataset;
+    FakeBackend backend{dataset, {"localhost:0"}};
+    backend.start();
+    const auto channel = channel_to(backend);
+    CHECK(wait_for_kv_protocol_check(channel).compatible);
+    CHECK(wait_for_ethbackend_protocol_check(channel).compatible);
+    CHECK(wait_for_mining_protocol_check(channel).compatible);
+    CHECK(wait_for_txpool_protocol_check(channel).compatible);
+}
+
+TEST_CASE("FakeBackend serves the Tx stream from the dataset", "[silkrpc][bench][fake_backend]") {
+    KvDataset dataset;
+    dataset.add("PlainState", *silkworm::from_hex("01"), *silkworm::from_hex("aa"));
+    dataset.add("PlainState", *silkworm::from_hex("03"), *silkworm::from_hex("bb"));
+    remote::Pair tx_pair;
+    tx_pair.set_txid(123);
+    dataset.add_reply(FakeBackend::kTxMethod, "", tx_pair.SerializeAsString());
+    FakeBackend backend{dataset, {"localhost:0"}};
+    backend.start();
+    const auto stub = remote::KV::NewStub(channel_to(backend));
+
+    grpc::ClientContext context;
+    auto stream = stub->Tx(&context);
+    remote::Pair reply;
+    REQUIRE(stream->Read(&reply));
+    CHECK(reply.txid() == 123);
+
+    remote::Cursor request;
+    request.set_op(remote::Op::OPEN);
+    request.set_bucketname("PlainState");
+    REQUIRE(stream->Write(request));
+    REQUIRE(stream->Read(&reply));
+    const auto cursor_id = reply.cursorid();
+    CHECK(cursor_id == 1);
+
+    request.Clear();
+    request.set_op(remote::Op::SEEK);
+    request.set_cursor(cursor_id);
+    request.set_k(string_of(*silkworm::from_hex("02")));
+    REQUIRE(stream->Write(request));
+    REQUIRE(stream->Read(&reply));
+    CHECK(reply.k() == string_of(*silkworm::from_hex("03")));
+    CHECK(reply.v() == string_of(*silkworm::from_hex("bb")));
+
+    request.set_op(remote::Op::NEXT);
+    REQUIRE(stream->Write(request));
+    REQUIRE(stream->Read(&reply));
+    CHECK(reply.k().empty());
+    CHECK(reply.v().empty());
+
+    request.Clear();
+    request.set_op(remote::Op::CLOSE);
+    request.set_cursor(cursor_id);
+    REQUIRE(stream->Write(request));
+    REQUIRE(stream->Read(&reply));
+    stream->WritesDone();
+    CHECK(stream->Finish().ok());
+}
+
+TEST_CASE("FakeBackend serves the ETHBACKEND calls from the dataset", "[silkrpc][bench][fake_backend]") {
+    KvDataset dataset;
+    remote::NetVersionReply net_version;
+    net_version.set_id(5);
+    dataset.add_reply("/remote.ETHBACKEND/NetVersion", remote::NetVersionRequest{}.SerializeAsString(), net_version.SerializeAsString());
+    FakeBackend backend{dataset, {"localhost:0"}};
+    backend.start();
+    const auto stub = remote::ETHBACKEND::NewStub(channel_to(backend));
+
+    SECTION("recorded call") {
+        grpc::ClientContext context;
+        remote::NetVersionReply reply;
+        CHECK(stub->NetVersion(&context, remote::NetVersionRequest{}, &reply).ok());
+        CHECK(reply.id() == 5);
+    }
+
+    SECTION("call not recorded") {
+        grpc::ClientContext context;
+        remote::NetPeerCountReply reply;
+        CHECK(stub->NetPeerCount(&context, remote::NetPeerCountRequest{}, &reply).error_code() == grpc::StatusCode::NOT_FOUND);
+    }
+}
+
+TEST_CASE("FakeBackend records the calls forwarded upstream", "[silkrpc][bench][fake_backend]") {
+    KvDataset upstream_dataset;
+    upstream_dataset.add("Code", *silkworm::from_hex("0a"), *silkworm::from_hex("6001"));
+    remote::NetVersionReply net_version;
+    net_version.set_id(5);
+    upstream_dataset.add_reply("/remote.ETHBACKEND/NetVersion", remote::NetVersionRequest{}.SerializeAsString(),
+                               net_version.SerializeAsString());
+    FakeBackend upstream{upstream_dataset, {"localhost:0"}};
+    upstream.start();
+
+    KvDataset dataset;
+    FakeBackend backend{dataset, {"localhost:0", {}, {}, "localhost:" + std::to_string(upstream.port())}};
+    backend.start();
+    const auto channel = channel_to(backend);
+
+    {
+        grpc::ClientContext context;
+        remote::NetVersionReply reply;
+        CHECK(remote::ETHBACKEND::NewStub(channel)->NetVersion(&context, remote::NetVersionRequest{}, &reply).ok());
+        CHECK(reply.id() == 5);
+    }
+    {
+        grpc::ClientContext context;
+        auto stream = remote::KV::NewStub(channel)->Tx(&context);
+        remote::Pair reply;
+        REQUIRE(stream->Read(&reply));
+        remote::Cursor request;
+        request.set_op(remote::Op::OPEN);
+        request.set_bucketname("Code");
+        REQUIRE(stream->Write(request));
+        REQUIRE(stream->Read(&reply));
+        request.Clear();
+        request.set_op(remote::Op::SEEK_EXACT);
+        request.set_cursor(reply.cursorid());
+        request.set_k(string_of(*silkworm::from_hex("0a")));
+        REQUIRE(stream->Write(request));
+        REQUIRE(stream->Read(&reply));
+        CHECK(reply.v() == string_of(*silkworm::from_hex("6001")));
+        stream->WritesDone();
+        CHECK(stream->Finish().ok());
+    }
+
+    CHECK(dataset.num_pairs() == 1);
+    CHECK(dataset.find_reply("/remote.ETHBACKEND/NetVersion", remote::NetVersionRequest{}.SerializeAsString()) != nullptr);
+    CHECK(dataset.find_reply(FakeBackend::kTxMethod, "") != nullptr);
+    auto cursor = dataset.cursor("Code");
+    REQUIRE(cursor.first() != nullptr);
+    CHECK(cursor.first()->second == *silkworm::from_hex("6001"));
+}
+
+} // namespace silkrpc::bench
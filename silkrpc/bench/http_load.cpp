@@ -0,0 +1,161 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "http_load.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/use_future.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/system/system_error.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::bench {
+
+namespace http = boost::beast::http;
+
+using Clock = std::chrono::steady_clock;
+
+static boost::asio::awaitable<BenchStats> run_client(const Workload& workload, const HttpLoadSettings& settings,
+    const boost::asio::ip::tcp::resolver::results_type& endpoints, std::atomic_uint64_t& next_index, Clock::time_point replay_start) {
+    BenchStats stats;
+    boost::beast::tcp_stream stream{co_await boost::asio::this_coro::executor};
+    boost::beast::flat_buffer buffer;
+    bool connected{false};
+    std::vector<Clock::time_point> start_times;
+    boost::asio::steady_timer send_timer{stream.get_executor()};
+    while (true) {
+        const auto first_index = next_index.fetch_add(settings.pipelining);
+        if (first_index >= settings.num_requests) {
+            break;
+        }
+        const auto num_pipelined = std::min<uint64_t>(settings.pipelining, settings.num_requests - first_index);
+        start_times.clear();
+        std::size_t num_replies{0};
+        try {
+            if (!connected) {
+                co_await stream.async_connect(endpoints, boost::asio::use_awaitable);
+                buffer.clear();
+                connected = true;
+            }
+            for (uint64_t i{0}; i < num_pipelined; ++i) {
+                const auto& request = workload.at(first_index + i);
+                http::request<http::string_body> http_request{http::verb::post, "/", 11};
+                http_request.set(http::field::host, settings.target);
+                http_request.set(http::field::content_type, "application/json");
+                http_request.keep_alive(settings.reuse_connections);
+                http_request.body() = request.content;
+                http_request.prepare_payload();
+                if (settings.preserve_timing) {
+                    send_timer.expires_at(replay_start + workload.send_offset(first_index + i));
+                    co_await send_timer.async_wait(boost::asio::use_awaitable);
+                }
+                start_times.push_back(Clock::now());
+                co_await http::async_write(stream, http_request, boost::asio::use_awaitable);
+            }
+            bool need_eof{false};
+            for (; num_replies < num_pipelined; ++num_replies) {
+                http::response<http::string_body> http_response;
+                co_await http::async_read(stream, buffer, http_response, boost::asio::use_awaitable);
+                const auto ok = http_response.result() == http::status::ok && !has_error(http_response.body());
+                stats.record(workload.at(first_index + num_replies).method, Clock::now() - start_times[num_replies], ok);
+                need_eof = need_eof || http_response.need_eof();
+            }
+            if (!settings.reuse_connections || need_eof) {
+                boost::system::error_code ec;
+                stream.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+                stream.close();
+                connected = false;
+            }
+        } catch (const boost::system::system_error& se) {
+            SILKRPC_DEBUG << "bench client error: " << se.what() << "\n";
+            // The requests still waiting for their replies are failed, the next round reconnects
+            for (; num_replies < num_pipelined; ++num_replies) {
+                const auto latency = num_replies < start_times.size() ? Clock::now() - start_times[num_replies] : Clock::duration{0};
+                stats.record(workload.at(first_index + num_replies).method, latency, /*ok=*/false);
+            }
+            stream.close();
+            connected = false;
+        }
+    }
+    if (connected) {
+        boost::system::error_code ec;
+        stream.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+        stream.close();
+    }
+    co_return stats;
+}
+
+BenchResult run_http_load(const Workload& workload, const HttpLoadSettings& settings) {
+    if (workload.empty()) {
+        throw std::invalid_argument{"empty workload"};
+    }
+    if (settings.concurrency == 0 || settings.pipelining == 0 || settings.num_threads == 0) {
+        throw std::invalid_argument{"concurrency, pipelining and threads must be positive"};
+    }
+    const auto separator = settings.target.rfind(':');
+    if (separator == std::string::npos) {
+        throw std::invalid_argument{"invalid target " + settings.target};
+    }
+
+    boost::asio::io_context io_context{static_cast<int>(settings.num_threads)};
+    boost::asio::ip::tcp::resolver resolver{io_context};
+    const auto endpoints = resolver.resolve(settings.target.substr(0, separator), settings.target.substr(separator + 1));
+
+    std::atomic_uint64_t next_index{0};
+    std::vector<std::future<BenchStats>> client_results;
+    client_results.reserve(settings.concurrency);
+    const auto start_time = Clock::now();
+    for (uint32_t i{0}; i < settings.concurrency; ++i) {
+        client_results.push_back(boost::asio::co_spawn(io_context, run_client(workload, settings, endpoints, next_index, start_time),
+            boost::asio::use_future));
+    }
+    std::vector<std::thread> threads;
+    for (uint32_t i{1}; i < settings.num_threads; ++i) {
+        threads.emplace_back([&]() { io_context.run(); });
+    }
+    io_context.run();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    BenchResult result;
+    result.elapsed = Clock::now() - start_time;
+    for (auto& client_result : client_results) {
+        result.stats.merge(client_result.get());
+    }
+    return result;
+}
+
+} // namespace silkrpc::bench
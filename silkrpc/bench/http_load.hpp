@@ -0,0 +1,50 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_BENCH_HTTP_LOAD_HPP_
+#define SILKRPC_BENCH_HTTP_LOAD_HPP_
+
+#include <cstdint>
+#include <string>
+
+#include <silkrpc/bench/bench_stats.hpp>
+#include <silkrpc/bench/workload.hpp>
+
+namespace silkrpc::bench {
+
+struct HttpLoadSettings {
+    //! The daemon HTTP location as <address>:<port>
+    std::string target;
+    //! The number of clients sending the requests at the same time, each one on its own connection
+    uint32_t concurrency{1};
+    //! The number of requests written by each client before reading their replies
+    uint32_t pipelining{1};
+    //! Keep the connections open across the requests, otherwise each client reconnects for each (pipelined) round
+    bool reuse_connections{true};
+    uint64_t num_requests{1000};
+    uint32_t num_threads{1};
+    //! Send each request at its captured time since the replay start instead of as soon as possible
+    bool preserve_timing{false};
+};
+
+//! Send the workload requests to the daemon over HTTP, each reply being an error if its status is not OK or its content
+//! has some JSON RPC error
+BenchResult run_http_load(const Workload& workload, const HttpLoadSettings& settings);
+
+} // namespace silkrpc::bench
+
+#endif // SILKRPC_BENCH_HTTP_LOAD_HPP_
@@ -0,0 +1,160 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "http_load.hpp"
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+#include <catch2/catch.hpp>
+#include <nlohmann/json.hpp>
+
+namespace silkrpc::bench {
+
+namespace http = boost::beast::http;
+using boost::asio::ip::tcp;
+
+//! Minimal JSON RPC server replying to eth_blockNumber with a result and to any other method with an error
+class FakeServer {
+public:
+    FakeServer() : acceptor_{io_context_, tcp::endpoint{boost::asio::ip::make_address("127.0.0.1"), 0}} {
+        boost::asio::co_spawn(io_context_, accept(), boost::asio::detached);
+        thread_ = std::thread{[&]() { io_context_.run(); }};
+    }
+    ~FakeServer() {
+        io_context_.stop();
+        thread_.join();
+    }
+
+    std::string target() const { return "127.0.0.1:" + std::to_string(acceptor_.local_endpoint().port()); }
+    int connections() const { return connections_; }
+
+private:
+    boost::asio::awaitable<void> accept() {
+        while (true) {
+            auto socket = co_await acceptor_.async_accept(boost::asio::use_awaitable);
+            ++connections_;
+            boost::asio::co_spawn(io_context_, serve(std::move(socket)), boost::asio::detached);
+        }
+    }
+
+    static boost::asio::awaitable<void> serve(tcp::socket socket) {
+        boost::beast::flat_buffer buffer;
+        while (true) {
+            http::request<http::string_body> request;
+            boost::system::error_code ec;
+            co_await http::async_read(socket, buffer, request, boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+            if (ec) {
+                co_return;
+            }
+            const auto request_json = nlohmann::json::parse(request.body());
+            nlohmann::json reply_json{{"jsonrpc", "2.0"}, {"id", request_json["id"]}};
+            if (request_json["method"] == "eth_blockNumber") {
+                reply_json["result"] = "0x1";
+            } else {
+                reply_json["error"] = {{"code", -32601}, {"message", "method not found"}};
+            }
+            http::response<http::string_body> response{http::status::ok, request.version()};
+            response.keep_alive(request.keep_alive());
+            response.body() = reply_json.dump();
+            response.prepare_payload();
+            co_await http::async_write(socket, response, boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+            if (ec || !request.keep_alive()) {
+                co_return;
+            }
+        }
+    }
+
+    boost::asio::io_context io_context_;
+    tcp::acceptor acceptor_;
+    std::atomic_int connections_{0};
+    std::thread thread_;
+};
+
+TEST_CASE("run_http_load", "[silkrpc][bench][http_load]") {
+    FakeServer server;
+    const auto workload = Workload::synthetic(Workload::parse_mix("eth_blockNumber=3,eth_unknown=1"));
+
+    SECTION("concurrent clients reusing connections") {
+        const auto result = run_http_load(workload, HttpLoadSettings{server.target(), 4, 1, true, 200, 2});
+        CHECK(result.stats.num_requests() == 200);
+        const auto report = result.stats.report(result.elapsed);
+        CHECK(report["methods"]["eth_blockNumber"]["errors"] == 0);
+        CHECK(report["methods"]["eth_unknown"]["errors"] == report["methods"]["eth_unknown"]["requests"]);
+        CHECK(result.stats.num_errors() == report["methods"]["eth_unknown"]["requests"]);
+        CHECK(server.connections() == 4);
+    }
+
+    SECTION("pipelined requests") {
+        const auto result = run_http_load(workload, HttpLoadSettings{server.target(), 2, 8, true, 101, 1});
+        CHECK(result.stats.num_requests() == 101);
+        CHECK(server.connections() == 2);
+    }
+
+    SECTION("new connection for each round") {
+        const auto result = run_http_load(workload, HttpLoadSettings{server.target(), 2, 5, false, 50, 1});
+        CHECK(result.stats.num_requests() == 50);
+        CHECK(server.connections() == 10);
+    }
+
+    SECTION("requests sent at their recorded time") {
+        // The synthetic requests have no recorded time, so they are all sent at the replay start
+        HttpLoadSettings settings{server.target(), 2, 1, true, 20, 1};
+        settings.preserve_timing = true;
+        const auto result = run_http_load(workload, settings);
+        CHECK(result.stats.num_requests() == 20);
+    }
+}
+
+TEST_CASE("run_http_load errors", "[silkrpc][bench][http_load]") {
+    const auto workload = Workload::synthetic(Workload::parse_mix("eth_blockNumber=1"));
+
+    SECTION("invalid settings") {
+        CHECK_THROWS_AS(run_http_load(workload, HttpLoadSettings{"127.0.0.1:1", 0}), std::invalid_argument);
+        CHECK_THROWS_AS(run_http_load(workload, HttpLoadSettings{"127.0.0.1", 1}), std::invalid_argument);
+        CHECK_THROWS_AS(run_http_load(Workload{}, HttpLoadSettings{"127.0.0.1:1", 1}), std::invalid_argument);
+    }
+
+    SECTION("unreachable daemon") {
+        tcp::endpoint closed_endpoint;
+        {
+            boost::asio::io_context io_context;
+            tcp::acceptor acceptor{io_context, tcp::endpoint{boost::asio::ip::make_address("127.0.0.1"), 0}};
+            closed_endpoint = acceptor.local_endpoint();
+        }
+        const auto target = "127.0.0.1:" + std::to_string(closed_endpoint.port());
+        const auto result = run_http_load(workload, HttpLoadSettings{target, 2, 1, true, 10, 1});
+        CHECK(result.stats.num_requests() == 10);
+        CHECK(result.stats.num_errors() == 10);
+    }
+}
+
+} // namespace silkrpc::bench
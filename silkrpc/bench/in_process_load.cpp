@@ -0,0 +1,103 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "in_process_load.hpp"
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/use_future.hpp>
+
+#include <silkrpc/commands/rpc_api.hpp>
+#include <silkrpc/commands/rpc_api_table.hpp>
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::bench {
+
+using Clock = std::chrono::steady_clock;
+
+static boost::asio::awaitable<bool> call_handler(const commands::RpcApiTable& rpc_api_table, commands::RpcApi& rpc_api,
+    const BenchRequest& request) {
+    const auto json_handler = rpc_api_table.find_json_handler(request.method);
+    if (json_handler) {
+        nlohmann::json reply_json;
+        co_await (rpc_api.*json_handler.value())(request.json, reply_json);
+        co_return !reply_json.contains("error");
+    }
+    const auto text_handler = rpc_api_table.find_text_handler(request.method);
+    if (text_handler) {
+        std::string reply_content;
+        co_await (rpc_api.*text_handler.value())(request.json, reply_content);
+        co_return !has_error(reply_content);
+    }
+    co_return false;
+}
+
+static boost::asio::awaitable<BenchStats> run_client(const Workload& workload, const InProcessLoadSettings& settings,
+    const commands::RpcApiTable& rpc_api_table, Context& context, WorkerPool& workers, std::atomic_uint64_t& next_index) {
+    BenchStats stats;
+    commands::RpcApi rpc_api{context, workers};
+    while (true) {
+        const auto index = next_index.fetch_add(1);
+        if (index >= settings.num_requests) {
+            break;
+        }
+        const auto& request = workload.at(index);
+        const auto start_time = Clock::now();
+        bool ok{false};
+        try {
+            ok = co_await call_handler(rpc_api_table, rpc_api, request);
+        } catch (const std::exception& e) {
+            SILKRPC_DEBUG << "bench handler error: " << e.what() << "\n";
+        }
+        stats.record(request.method, Clock::now() - start_time, ok);
+    }
+    co_return stats;
+}
+
+BenchResult run_in_process_load(const Workload& workload, const InProcessLoadSettings& settings, ContextPool& context_pool,
+    WorkerPool& workers) {
+    if (workload.empty()) {
+        throw std::invalid_argument{"empty workload"};
+    }
+    if (settings.concurrency == 0) {
+        throw std::invalid_argument{"concurrency must be positive"};
+    }
+
+    const commands::RpcApiTable rpc_api_table{settings.api_spec};
+    std::atomic_uint64_t next_index{0};
+    std::vector<std::future<BenchStats>> client_results;
+    client_results.reserve(settings.concurrency);
+    const auto start_time = Clock::now();
+    for (uint32_t i{0}; i < settings.concurrency; ++i) {
+        auto& context = context_pool.next_context();
+        client_results.push_back(boost::asio::co_spawn(*context.io_context(),
+            run_client(workload, settings, rpc_api_table, context, workers, next_index), boost::asio::use_future));
+    }
+
+    BenchResult result;
+    for (auto& client_result : client_results) {
+        result.stats.merge(client_result.get());
+    }
+    result.elapsed = Clock::now() - start_time;
+    return result;
+}
+
+} // namespace silkrpc::bench
@@ -0,0 +1,46 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_BENCH_IN_PROCESS_LOAD_HPP_
+#define SILKRPC_BENCH_IN_PROCESS_LOAD_HPP_
+
+#include <cstdint>
+#include <string>
+
+#include <silkrpc/bench/bench_stats.hpp>
+#include <silkrpc/bench/workload.hpp>
+#include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/concurrency/worker_pool.hpp>
+
+namespace silkrpc::bench {
+
+struct InProcessLoadSettings {
+    std::string api_spec;
+    //! The number of clients calling the handlers at the same time, spread in round-robin order over the contexts
+    uint32_t concurrency{1};
+    uint64_t num_requests{1000};
+};
+
+//! Call the RPC API handlers for the workload requests directly on the running contexts, so that the server CPU is
+//! measured without the HTTP parsing, the JSON serialization of the replies and the network, each reply being an error
+//! if it has some JSON RPC error or the method has no JSON or text handler (stream handlers are not called)
+BenchResult run_in_process_load(const Workload& workload, const InProcessLoadSettings& settings, ContextPool& context_pool,
+    WorkerPool& workers);
+
+} // namespace silkrpc::bench
+
+#endif // SILKRPC_BENCH_IN_PROCESS_LOAD_HPP_
@@ -0,0 +1,269 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "kv_dataset.hpp"
+
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include <boost/endian/conversion.hpp>
+
+namespace silkrpc::bench {
+
+template <typename T>
+static void write_integer(std::ostream& output, T value) {
+    boost::endian::native_to_little_inplace(value);
+    output.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+static bool read_integer(std::istream& input, T& value) {
+    if (!input.read(reinterpret_cast<char*>(&value), sizeof(value))) {
+        return false;
+    }
+    boost::endian::little_to_native_inplace(value);
+    return true;
+}
+
+template <typename String>
+static void write_field(std::ostream& output, const String& field) {
+    write_integer(output, static_cast<uint32_t>(field.size()));
+    output.write(reinterpret_cast<const char*>(field.data()), static_cast<std::streamsize>(field.size()));
+}
+
+template <typename String>
+static bool read_field(std::istream& input, String& field) {
+    uint32_t size{0};
+    if (!read_integer(input, size)) {
+        return false;
+    }
+    field.resize(size);
+    return static_cast<bool>(input.read(reinterpret_cast<char*>(field.data()), size));
+}
+
+const KvDataset::Table KvDataset::kEmptyTable;
+
+KvDataset::Cursor::Cursor(const Table* table) : table_{table}, position_{table->end()} {}
+
+const KvDataset::Pair* KvDataset::Cursor::at(Table::const_iterator position) {
+    position_ = position;
+    return position_ != table_->end() ? &*position_ : nullptr;
+}
+
+const KvDataset::Pair* KvDataset::Cursor::first() {
+    return at(table_->begin());
+}
+
+const KvDataset::Pair* KvDataset::Cursor::last() {
+    return table_->empty() ? nullptr : at(std::prev(table_->end()));
+}
+
+const KvDataset::Pair* KvDataset::Cursor::current() {
+    return position_ != table_->end() ? &*position_ : nullptr;
+}
+
+const KvDataset::Pair* KvDataset::Cursor::seek(silkworm::ByteView key) {
+    return at(table_->lower_bound(Pair{silkworm::Bytes{key}, {}}));
+}
+
+const KvDataset::Pair* KvDataset::Cursor::seek_exact(silkworm::ByteView key) {
+    const auto position = table_->lower_bound(Pair{silkworm::Bytes{key}, {}});
+    return at(position != table_->end() && position->first == key ? position : table_->end());
+}
+
+const KvDataset::Pair* KvDataset::Cursor::seek_both(silkworm::ByteView key, silkworm::ByteView value) {
+    const auto position = table_->lower_bound(Pair{silkworm::Bytes{key}, silkworm::Bytes{value}});
+    return at(position != table_->end() && position->first == key ? position : table_->end());
+}
+
+const KvDataset::Pair* KvDataset::Cursor::seek_both_exact(silkworm::ByteView key, silkworm::ByteView value) {
+    return at(table_->find(Pair{silkworm::Bytes{key}, silkworm::Bytes{value}}));
+}
+
+const KvDataset::Pair* KvDataset::Cursor::next() {
+    if (position_ == table_->end()) {
+        return nullptr;
+    }
+    return at(std::next(position_));
+}
+
+const KvDataset::Pair* KvDataset::Cursor::prev() {
+    // Moving back from past the end (e.g. after seeking beyond the last key) positions on the last pair
+    if (position_ == table_->begin()) {
+        return at(table_->end());
+    }
+    return at(std::prev(position_));
+}
+
+const KvDataset::Pair* KvDataset::Cursor::first_dup() {
+    if (position_ == table_->end()) {
+        return nullptr;
+    }
+    return at(table_->lower_bound(Pair{position_->first, {}}));
+}
+
+const KvDataset::Pair* KvDataset::Cursor::last_dup() {
+    if (position_ == table_->end()) {
+        return nullptr;
+    }
+    auto position = position_;
+    while (std::next(position) != table_->end() && std::next(position)->first == position_->first) {
+        ++position;
+    }
+    return at(position);
+}
+
+const KvDataset::Pair* KvDataset::Cursor::next_dup() {
+    if (position_ == table_->end()) {
+        return nullptr;
+    }
+    const auto next = std::next(position_);
+    return next != table_->end() && next->first == position_->first ? at(next) : nullptr;
+}
+
+const KvDataset::Pair* KvDataset::Cursor::prev_dup() {
+    if (position_ == table_->end() || position_ == table_->begin()) {
+        return nullptr;
+    }
+    const auto prev = std::prev(position_);
+    return prev->first == position_->first ? at(prev) : nullptr;
+}
+
+const KvDataset::Pair* KvDataset::Cursor::next_no_dup() {
+    if (position_ == table_->end()) {
+        return nullptr;
+    }
+    auto position = position_;
+    while (position != table_->end() && position->first == position_->first) {
+        ++position;
+    }
+    return at(position);
+}
+
+const KvDataset::Pair* KvDataset::Cursor::prev_no_dup() {
+    if (position_ == table_->end()) {
+        return last();
+    }
+    auto position = position_;
+    while (position != table_->begin() && std::prev(position)->first == position_->first) {
+        --position;
+    }
+    // The previous key is positioned on its last duplicate, as MDBX does
+    return position == table_->begin() ? at(table_->end()) : at(std::prev(position));
+}
+
+KvDataset& KvDataset::operator=(KvDataset&& other) noexcept {
+    tables_ = std::move(other.tables_);
+    replies_ = std::move(other.replies_);
+    return *this;
+}
+
+KvDataset KvDataset::load(const std::filesystem::path& file_path) {
+    std::ifstream file{file_path, std::ios::in | std::ios::binary};
+    if (!file) {
+        throw std::runtime_error{"cannot open dataset file " + file_path.string()};
+    }
+    std::string magic(KvDatasetFormat::kMagic.size(), '\0');
+    uint32_t version{0};
+    if (!file.read(magic.data(), magic.size()) || magic != KvDatasetFormat::kMagic || !read_integer(file, version) ||
+        version != KvDatasetFormat::kVersion) {
+        throw std::runtime_error{"invalid dataset file " + file_path.string()};
+    }
+    KvDataset dataset;
+    uint8_t kind{0};
+    while (read_integer(file, kind)) {
+        std::string name;
+        if (kind == KvDatasetFormat::kPairRecord) {
+            Pair pair;
+            if (!read_field(file, name) || !read_field(file, pair.first) || !read_field(file, pair.second)) {
+                throw std::runtime_error{"truncated record in dataset file " + file_path.string()};
+            }
+            dataset.tables_[name].insert(std::move(pair));
+        } else if (kind == KvDatasetFormat::kReplyRecord) {
+            std::string request, reply;
+            if (!read_field(file, name) || !read_field(file, request) || !read_field(file, reply)) {
+                throw std::runtime_error{"truncated record in dataset file " + file_path.string()};
+            }
+            dataset.replies_[{std::move(name), std::move(request)}] = std::move(reply);
+        } else {
+            throw std::runtime_error{"invalid record kind " + std::to_string(kind) + " in dataset file " + file_path.string()};
+        }
+    }
+    return dataset;
+}
+
+void KvDataset::save(const std::filesystem::path& file_path) const {
+    std::ofstream file{file_path, std::ios::out | std::ios::trunc | std::ios::binary};
+    if (!file) {
+        throw std::runtime_error{"cannot open dataset file " + file_path.string()};
+    }
+    std::scoped_lock lock{mutex_};
+    file.write(KvDatasetFormat::kMagic.data(), KvDatasetFormat::kMagic.size());
+    write_integer(file, KvDatasetFormat::kVersion);
+    for (const auto& [table, pairs] : tables_) {
+        for (const auto& [key, value] : pairs) {
+            write_integer(file, KvDatasetFormat::kPairRecord);
+            write_field(file, table);
+            write_field(file, key);
+            write_field(file, value);
+        }
+    }
+    for (const auto& [call, reply] : replies_) {
+        write_integer(file, KvDatasetFormat::kReplyRecord);
+        write_field(file, call.first);
+        write_field(file, call.second);
+        write_field(file, reply);
+    }
+    if (!file.flush()) {
+        throw std::runtime_error{"cannot write dataset file " + file_path.string()};
+    }
+}
+
+void KvDataset::add(const std::string& table, silkworm::ByteView key, silkworm::ByteView value) {
+    std::scoped_lock lock{mutex_};
+    auto it = tables_.find(table);
+    if (it == tables_.end()) {
+        it = tables_.emplace(table, Table{}).first;
+    }
+    it->second.emplace(key, value);
+}
+
+void KvDataset::add_reply(const std::string& method, std::string request, std::string reply) {
+    std::scoped_lock lock{mutex_};
+    replies_[{method, std::move(request)}] = std::move(reply);
+}
+
+KvDataset::Cursor KvDataset::cursor(const std::string& table) const {
+    const auto it = tables_.find(table);
+    return Cursor{it != tables_.end() ? &it->second : &kEmptyTable};
+}
+
+const std::string* KvDataset::find_reply(const std::string& method, const std::string& request) const {
+    const auto it = replies_.find({method, request});
+    return it != replies_.end() ? &it->second : nullptr;
+}
+
+std::size_t KvDataset::num_pairs() const {
+    std::size_t num_pairs{0};
+    for (const auto& [_, pairs] : tables_) {
+        num_pairs += pairs.size();
+    }
+    return num_pairs;
+}
+
+} // namespace silkrpc::bench
@@ -0,0 +1,119 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_BENCH_KV_DATASET_HPP_
+#define SILKRPC_BENCH_KV_DATASET_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <silkworm/common/base.hpp>
+
+namespace silkrpc::bench {
+
+//! The layout of the dataset file: the magic and the version, followed by the records each made of kind byte and the
+//! length-prefixed name, key and value (table, key and value of the pairs, method, request and reply of the calls)
+struct KvDatasetFormat {
+    static constexpr std::string_view kMagic{"SRPCKVDS"};
+    static constexpr uint32_t kVersion{1};
+    static constexpr uint8_t kPairRecord{1};
+    static constexpr uint8_t kReplyRecord{2};
+};
+
+//! Recorded snapshot of the table pairs read by a workload and of the replies to the backend calls, for the fake backend
+//! serving silkrpc w/o any Erigon (see FakeBackend). The pairs read by replaying the same cursor operations are exactly
+//! the recorded ones, because the subset of the real pairs sorted in the same order has the same neighbours among them.
+//! The recording adds are thread-safe, while the lookups must not run concurrently with them.
+class KvDataset {
+public:
+    using Pair = std::pair<silkworm::Bytes, silkworm::Bytes>;
+    //! The pairs of one table sorted by key and then by value, as in dup-sorted tables (just one value per key otherwise)
+    using Table = std::set<Pair>;
+
+    //! The cursor over one table walking the recorded pairs as MDBX cursors do, each operation returning the pair at the
+    //! new position or nullptr if none (leaving unchanged the position on missing duplicates)
+    class Cursor {
+    public:
+        explicit Cursor(const Table* table);
+
+        const Pair* first();
+        const Pair* last();
+        const Pair* current();
+        const Pair* seek(silkworm::ByteView key);
+        const Pair* seek_exact(silkworm::ByteView key);
+        const Pair* seek_both(silkworm::ByteView key, silkworm::ByteView value);
+        const Pair* seek_both_exact(silkworm::ByteView key, silkworm::ByteView value);
+        const Pair* next();
+        const Pair* prev();
+        const Pair* first_dup();
+        const Pair* last_dup();
+        const Pair* next_dup();
+        const Pair* prev_dup();
+        const Pair* next_no_dup();
+        const Pair* prev_no_dup();
+
+    private:
+        const Pair* at(Table::const_iterator position);
+
+        const Table* table_;
+        Table::const_iterator position_;
+    };
+
+    KvDataset() = default;
+    KvDataset(KvDataset&& other) noexcept : tables_{std::move(other.tables_)}, replies_{std::move(other.replies_)} {}
+    KvDataset& operator=(KvDataset&& other) noexcept;
+
+    //! Load the dataset file, throwing std::runtime_error if it cannot be read or is not a valid one
+    static KvDataset load(const std::filesystem::path& file_path);
+
+    //! Save the dataset file, throwing std::runtime_error if it cannot be written
+    void save(const std::filesystem::path& file_path) const;
+
+    //! Add the pair read from the table
+    void add(const std::string& table, silkworm::ByteView key, silkworm::ByteView value);
+
+    //! Add the serialized reply to the serialized request of the method, replacing any previous one
+    void add_reply(const std::string& method, std::string request, std::string reply);
+
+    //! Return the cursor over the table, empty if no pair of the table has been recorded
+    Cursor cursor(const std::string& table) const;
+
+    //! Return the serialized reply to the serialized request of the method, if recorded
+    const std::string* find_reply(const std::string& method, const std::string& request) const;
+
+    std::size_t num_tables() const { return tables_.size(); }
+    std::size_t num_pairs() const;
+    std::size_t num_replies() const { return replies_.size(); }
+
+private:
+    static const Table kEmptyTable;
+
+    std::map<std::string, Table, std::less<>> tables_;
+    std::map<std::pair<std::string, std::string>, std::string> replies_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace silkrpc::bench
+
+#endif // SILKRPC_BENCH_KV_DATASET_HPP_
@@ -0,0 +1,172 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "kv_dataset.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+#include <silkworm/common/util.hpp>
+
+namespace silkrpc::bench {
+
+static KvDataset make_dataset() {
+    KvDataset dataset;
+    dataset.add("PlainState", *silkworm::from_hex("01"), *silkworm::from_hex("aa"));
+    dataset.add("PlainState", *silkworm::from_hex("03"), *silkworm::from_hex("bb01"));
+    dataset.add("PlainState", *silkworm::from_hex("03"), *silkworm::from_hex("bb02"));
+    dataset.add("PlainState", *silkworm::from_hex("05"), *silkworm::from_hex("cc"));
+    return dataset;
+}
+
+TEST_CASE("KvDataset::Cursor", "[silkrpc][bench][kv_dataset]") {
+    const auto dataset = make_dataset();
+
+    SECTION("seek and walk forward") {
+        auto cursor = dataset.cursor("PlainState");
+        const auto* pair = cursor.seek(*silkworm::from_hex("02"));
+        REQUIRE(pair != nullptr);
+        CHECK(pair->first == *silkworm::from_hex("03"));
+        CHECK(pair->second == *silkworm::from_hex("bb01"));
+        pair = cursor.next();
+        REQUIRE(pair != nullptr);
+        CHECK(pair->second == *silkworm::from_hex("bb02"));
+        pair = cursor.next();
+        REQUIRE(pair != nullptr);
+        CHECK(pair->first == *silkworm::from_hex("05"));
+        CHECK(cursor.next() == nullptr);
+        CHECK(cursor.next() == nullptr);
+    }
+
+    SECTION("seek beyond the last key and walk backward") {
+        auto cursor = dataset.cursor("PlainState");
+        CHECK(cursor.seek(*silkworm::from_hex("06")) == nullptr);
+        const auto* pair = cursor.prev();
+        REQUIRE(pair != nullptr);
+        CHECK(pair->first == *silkworm::from_hex("05"));
+        pair = cursor.prev_no_dup();
+        REQUIRE(pair != nullptr);
+        CHECK(pair->second == *silkworm::from_hex("bb02"));
+        pair = cursor.prev_no_dup();
+        REQUIRE(pair != nullptr);
+        CHECK(pair->first == *silkworm::from_hex("01"));
+        CHECK(cursor.prev() == nullptr);
+    }
+
+    SECTION("seek exact") {
+        auto cursor = dataset.cursor("PlainState");
+        CHECK(cursor.seek_exact(*silkworm::from_hex("02")) == nullptr);
+        const auto* pair = cursor.seek_exact(*silkworm::from_hex("05"));
+        REQUIRE(pair != nullptr);
+        CHECK(pair->second == *silkworm::from_hex("cc"));
+    }
+
+    SECTION("duplicates") {
+        auto cursor = dataset.cursor("PlainState");
+        const auto* pair = cursor.seek_both(*silkworm::from_hex("03"), *silkworm::from_hex("bb"));
+        REQUIRE(pair != nullptr);
+        CHECK(pair->second == *silkworm::from_hex("bb01"));
+        pair = cursor.next_dup();
+        REQUIRE(pair != nullptr);
+        CHECK(pair->second == *silkworm::from_hex("bb02"));
+        CHECK(cursor.next_dup() == nullptr);
+        CHECK(cursor.current() == pair);
+        pair = cursor.first_dup();
+        REQUIRE(pair != nullptr);
+        CHECK(pair->second == *silkworm::from_hex("bb01"));
+        CHECK(cursor.prev_dup() == nullptr);
+        pair = cursor.last_dup();
+        REQUIRE(pair != nullptr);
+        CHECK(pair->second == *silkworm::from_hex("bb02"));
+        pair = cursor.next_no_dup();
+        REQUIRE(pair != nullptr);
+        CHECK(pair->first == *silkworm::from_hex("05"));
+        CHECK(cursor.seek_both(*silkworm::from_hex("03"), *silkworm::from_hex("bc")) == nullptr);
+        CHECK(cursor.seek_both_exact(*silkworm::from_hex("03"), *silkworm::from_hex("bb")) == nullptr);
+        CHECK(cursor.seek_both_exact(*silkworm::from_hex("03"), *silkworm::from_hex("bb02")) != nullptr);
+    }
+
+    SECTION("first and last") {
+        auto cursor = dataset.cursor("PlainState");
+        REQUIRE(cursor.first() != nullptr);
+        CHECK(cursor.first()->first == *silkworm::from_hex("01"));
+        REQUIRE(cursor.last() != nullptr);
+        CHECK(cursor.last()->first == *silkworm::from_hex("05"));
+    }
+
+    SECTION("table not recorded") {
+        auto cursor = dataset.cursor("Code");
+        CHECK(cursor.first() == nullptr);
+        CHECK(cursor.last() == nullptr);
+        CHECK(cursor.seek(*silkworm::from_hex("01")) == nullptr);
+        CHECK(cursor.next() == nullptr);
+        CHECK(cursor.prev() == nullptr);
+    }
+}
+
+TEST_CASE("KvDataset::find_reply", "[silkrpc][bench][kv_dataset]") {
+    KvDataset dataset;
+    dataset.add_reply("/remote.ETHBACKEND/NetVersion", "", "reply1");
+    dataset.add_reply("/remote.ETHBACKEND/Block", "request1", "reply2");
+    dataset.add_reply("/remote.ETHBACKEND/Block", "request1", "reply3");
+    CHECK(dataset.num_replies() == 2);
+    REQUIRE(dataset.find_reply("/remote.ETHBACKEND/NetVersion", "") != nullptr);
+    CHECK(*dataset.find_reply("/remote.ETHBACKEND/NetVersion", "") == "reply1");
+    REQUIRE(dataset.find_reply("/remote.ETHBACKEND/Block", "request1") != nullptr);
+    CHECK(*dataset.find_reply("/remote.ETHBACKEND/Block", "request1") == "reply3");
+    CHECK(dataset.find_reply("/remote.ETHBACKEND/Block", "request2") == nullptr);
+}
+
+TEST_CASE("KvDataset::save and load", "[silkrpc][bench][kv_dataset]") {
+    const auto dataset_path = std::filesystem::temp_directory_path() / "silkrpc_kv_dataset.bin";
+
+    SECTION("round trip") {
+        auto dataset = make_dataset();
+        dataset.add_reply("/remote.ETHBACKEND/Block", "request", std::string{"re\0ply", 6});
+        dataset.save(dataset_path);
+        const auto loaded = KvDataset::load(dataset_path);
+        CHECK(loaded.num_tables() == 1);
+        CHECK(loaded.num_pairs() == 4);
+        REQUIRE(loaded.find_reply("/remote.ETHBACKEND/Block", "request") != nullptr);
+        CHECK(*loaded.find_reply("/remote.ETHBACKEND/Block", "request") == std::string{"re\0ply", 6});
+        auto cursor = loaded.cursor("PlainState");
+        REQUIRE(cursor.last() != nullptr);
+        CHECK(cursor.last()->second == *silkworm::from_hex("cc"));
+    }
+
+    SECTION("invalid file") {
+        std::ofstream{dataset_path} << "not a dataset";
+        CHECK_THROWS_AS(KvDataset::load(dataset_path), std::runtime_error);
+    }
+
+    SECTION("truncated file") {
+        make_dataset().save(dataset_path);
+        std::filesystem::resize_file(dataset_path, std::filesystem::file_size(dataset_path) - 1);
+        CHECK_THROWS_AS(KvDataset::load(dataset_path), std::runtime_error);
+    }
+
+    SECTION("missing file") {
+        std::filesystem::remove(dataset_path);
+        CHECK_THROWS_AS(KvDataset::load(dataset_path), std::runtime_error);
+    }
+
+    std::filesystem::remove(dataset_path);
+}
+
+} // namespace silkrpc::bench
@@ -0,0 +1,428 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "kv_load.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/use_future.hpp>
+#include <boost/endian/conversion.hpp>
+#include <silkworm/common/util.hpp>
+
+#include <silkrpc/bench/workload.hpp>
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/ethdb/cursor.hpp>
+#include <silkrpc/ethdb/transaction.hpp>
+#include <silkrpc/interfaces/remote/kv.grpc.pb.h>
+
+namespace silkrpc::bench {
+
+using Clock = std::chrono::steady_clock;
+
+//! The seeds of the sequences drawn when sampling the keys and by the clients, the same at each run
+constexpr uint32_t kSampleSeed{42};
+constexpr uint32_t kLoadSeed{1234};
+
+//! The random prefixes sought for each key to sample, before walking the table from the first key
+constexpr uint32_t kSampleAttemptsPerKey{4};
+
+std::string op_name(KvOp op) {
+    switch (op) {
+        case KvOp::seek: return "seek";
+        case KvOp::seek_exact: return "seek_exact";
+        case KvOp::next_walk: return "next";
+        case KvOp::seek_both: return "seek_both";
+    }
+    return "unknown";
+}
+
+KvOpMix parse_op_mix(const std::string& mix_spec) {
+    KvOpMix op_mix;
+    for (const auto& [name, weight] : Workload::parse_mix(mix_spec)) {
+        if (name == "seek") {
+            op_mix.emplace_back(KvOp::seek, weight);
+        } else if (name == "seek_exact") {
+            op_mix.emplace_back(KvOp::seek_exact, weight);
+        } else if (name == "next") {
+            op_mix.emplace_back(KvOp::next_walk, weight);
+        } else if (name == "seek_both") {
+            op_mix.emplace_back(KvOp::seek_both, weight);
+        } else {
+            throw std::invalid_argument{"invalid op in mix: " + name};
+        }
+    }
+    return op_mix;
+}
+
+KeyDistribution parse_key_distribution(const std::string& name) {
+    if (name == "uniform") {
+        return KeyDistribution::uniform;
+    }
+    if (name == "zipf") {
+        return KeyDistribution::zipf;
+    }
+    throw std::invalid_argument{"invalid key distribution: " + name};
+}
+
+static bool has_seek_both(const KvOpMix& op_mix) {
+    return std::any_of(op_mix.begin(), op_mix.end(), [](const auto& op_weight) { return op_weight.first == KvOp::seek_both; });
+}
+
+//! The picker of the operations according to their weight in the mix
+class OpPicker {
+public:
+    explicit OpPicker(const KvOpMix& op_mix) {
+        uint64_t cumulative_weight{0};
+        for (const auto& [op, weight] : op_mix) {
+            cumulative_weight += weight;
+            ops_.emplace_back(cumulative_weight, op);
+        }
+        if (ops_.empty()) {
+            throw std::invalid_argument{"empty op mix"};
+        }
+    }
+
+    KvOp pick(std::minstd_rand& generator) const {
+        const auto value = std::uniform_int_distribution<uint64_t>{0, ops_.back().first - 1}(generator);
+        return std::upper_bound(ops_.begin(), ops_.end(), value, [](uint64_t v, const auto& op) { return v < op.first; })->second;
+    }
+
+private:
+    std::vector<std::pair<uint64_t, KvOp>> ops_;
+};
+
+//! The Tx stream driven by the blocking gRPC API
+class SyncTx {
+public:
+    explicit SyncTx(remote::KV::Stub& stub) : stream_{stub.Tx(&context_)} {
+        remote::Pair tx_pair;
+        if (!stream_->Read(&tx_pair)) {
+            finish();
+            throw std::runtime_error{"cannot begin Tx: " + status_.error_message()};
+        }
+    }
+
+    ~SyncTx() {
+        if (!finished_) {
+            context_.TryCancel();
+            finish();
+        }
+    }
+
+    SyncTx(const SyncTx&) = delete;
+    SyncTx& operator=(const SyncTx&) = delete;
+
+    uint32_t open(const std::string& table, bool dup_sorted) {
+        remote::Pair reply;
+        if (!call(dup_sorted ? remote::Op::OPEN_DUP_SORT : remote::Op::OPEN, 0, table, {}, {}, reply)) {
+            throw std::runtime_error{"cannot open cursor on " + table};
+        }
+        return reply.cursorid();
+    }
+
+    bool call(remote::Op op, uint32_t cursor_id, silkworm::ByteView key, silkworm::ByteView value, remote::Pair& reply) {
+        return call(op, cursor_id, {}, key, value, reply);
+    }
+
+    void close() {
+        stream_->WritesDone();
+        finish();
+    }
+
+private:
+    bool call(remote::Op op, uint32_t cursor_id, const std::string& table, silkworm::ByteView key, silkworm::ByteView value,
+              remote::Pair& reply) {
+        remote::Cursor request;
+        request.set_op(op);
+        request.set_cursor(cursor_id);
+        request.set_bucketname(table);
+        request.set_k(key.data(), key.size());
+        request.set_v(value.data(), value.size());
+        return stream_->Write(request) && stream_->Read(&reply);
+    }
+
+    void finish() {
+        status_ = stream_->Finish();
+        finished_ = true;
+    }
+
+    grpc::ClientContext context_;
+    std::unique_ptr<grpc::ClientReaderWriter<remote::Cursor, remote::Pair>> stream_;
+    grpc::Status status_;
+    bool finished_{false};
+};
+
+KeySet::KeySet(std::vector<KeyValue> pairs, KeyDistribution distribution) : pairs_{std::move(pairs)} {
+    if (pairs_.empty()) {
+        throw std::invalid_argument{"empty key set"};
+    }
+    if (distribution == KeyDistribution::zipf) {
+        // The hot keys are spread over the key space rather than being the lowest ones
+        std::minstd_rand generator{kSampleSeed};
+        std::shuffle(pairs_.begin(), pairs_.end(), generator);
+        cumulative_weights_.reserve(pairs_.size());
+        double cumulative_weight{0};
+        for (std::size_t i{0}; i < pairs_.size(); ++i) {
+            cumulative_weight += 1.0 / static_cast<double>(i + 1);
+            cumulative_weights_.push_back(cumulative_weight);
+        }
+    }
+}
+
+KeySet KeySet::sample(const std::shared_ptr<grpc::Channel>& channel, const std::string& table, uint32_t num_samples,
+    KeyDistribution distribution) {
+    const auto stub = remote::KV::NewStub(channel);
+    SyncTx tx{*stub};
+    const auto cursor_id = tx.open(table, /*dup_sorted=*/false);
+
+    std::minstd_rand generator{kSampleSeed};
+    std::set<silkworm::Bytes> sampled_keys;
+    std::vector<KeyValue> pairs;
+    const auto add_pair = [&](const remote::Pair& reply) {
+        silkworm::Bytes key{silkworm::byte_view_of_string(reply.k())};
+        if (!key.empty() && sampled_keys.insert(key).second) {
+            pairs.push_back({std::move(key), silkworm::Bytes{silkworm::byte_view_of_string(reply.v())}});
+        }
+    };
+    remote::Pair reply;
+    for (uint64_t attempt{0}; attempt < uint64_t{num_samples} * kSampleAttemptsPerKey && pairs.size() < num_samples; ++attempt) {
+        const auto prefix = boost::endian::native_to_big(std::uniform_int_distribution<uint32_t>{}(generator));
+        const silkworm::ByteView prefix_view{reinterpret_cast<const uint8_t*>(&prefix), sizeof(prefix)};
+        if (!tx.call(remote::Op::SEEK, cursor_id, prefix_view, {}, reply)) {
+            throw std::runtime_error{"cannot seek in " + table};
+        }
+        add_pair(reply);
+    }
+    // The keys packed at the start of the key space (e.g. block numbers) are hardly ever found by random prefixes
+    if (pairs.size() < num_samples) {
+        auto op{remote::Op::FIRST};
+        while (pairs.size() < num_samples && tx.call(op, cursor_id, {}, {}, reply) && !reply.k().empty()) {
+            add_pair(reply);
+            op = remote::Op::NEXT;
+        }
+    }
+    tx.close();
+    if (pairs.empty()) {
+        throw std::runtime_error{"no key found in " + table};
+    }
+    return KeySet{std::move(pairs), distribution};
+}
+
+const KeyValue& KeySet::pick(std::minstd_rand& generator) const {
+    if (cumulative_weights_.empty()) {
+        return pairs_[std::uniform_int_distribution<std::size_t>{0, pairs_.size() - 1}(generator)];
+    }
+    const auto value = std::uniform_real_distribution<double>{0, cumulative_weights_.back()}(generator);
+    const auto it = std::upper_bound(cumulative_weights_.begin(), cumulative_weights_.end(), value);
+    return pairs_[std::min<std::size_t>(it - cumulative_weights_.begin(), pairs_.size() - 1)];
+}
+
+static boost::asio::awaitable<void> run_op(ethdb::Cursor& cursor, ethdb::CursorDupSort* dup_cursor, KvOp op,
+    const KeyValue& pair, uint32_t walk_length) {
+    switch (op) {
+        case KvOp::seek:
+            co_await cursor.seek(pair.key);
+            break;
+        case KvOp::seek_exact:
+            co_await cursor.seek_exact(pair.key);
+            break;
+        case KvOp::next_walk: {
+            auto kv = co_await cursor.seek(pair.key);
+            for (uint32_t i{0}; i < walk_length && !kv.key.empty(); ++i) {
+                kv = co_await cursor.next();
+            }
+            break;
+        }
+        case KvOp::seek_both:
+            co_await dup_cursor->seek_both(pair.key, pair.value);
+            break;
+    }
+}
+
+static boost::asio::awaitable<BenchStats> run_coroutine_client(const KeySet& keys, const KvLoadSettings& settings,
+    const OpPicker& op_picker, Context& context, std::atomic_uint64_t& next_op, uint32_t client_index) {
+    BenchStats stats;
+    std::minstd_rand generator{kLoadSeed + client_index};
+    const bool dup_sorted{has_seek_both(settings.op_mix)};
+    std::unique_ptr<ethdb::Transaction> tx;
+    std::shared_ptr<ethdb::Cursor> cursor;
+    std::shared_ptr<ethdb::CursorDupSort> dup_cursor;
+    uint32_t tx_ops{0};
+    while (next_op.fetch_add(1) < settings.num_ops) {
+        const auto op = op_picker.pick(generator);
+        const auto& pair = keys.pick(generator);
+        // The Tx begin is accounted to the first operation run in it, while the Tx close is not accounted at all
+        const auto start_time = Clock::now();
+        bool ok{false};
+        try {
+            if (!tx) {
+                tx = co_await context.database()->begin();
+                if (dup_sorted) {
+                    dup_cursor = co_await tx->cursor_dup_sort(settings.table);
+                    cursor = dup_cursor;
+                } else {
+                    cursor = co_await tx->cursor(settings.table);
+                }
+            }
+            co_await run_op(*cursor, dup_cursor.get(), op, pair, settings.walk_length);
+            ok = true;
+        } catch (const std::exception& e) {
+            SILKRPC_DEBUG << "kv bench op error: " << e.what() << "\n";
+        }
+        stats.record(op_name(op), Clock::now() - start_time, ok);
+        if (tx && (!ok || (settings.ops_per_tx > 0 && ++tx_ops == settings.ops_per_tx))) {
+            try {
+                co_await tx->close();
+            } catch (const std::exception& e) {
+                SILKRPC_DEBUG << "kv bench close error: " << e.what() << "\n";
+            }
+            tx.reset();
+            cursor.reset();
+            dup_cursor.reset();
+            tx_ops = 0;
+        }
+    }
+    if (tx) {
+        co_await tx->close();
+    }
+    co_return stats;
+}
+
+BenchResult run_kv_load_coroutines(const KeySet& keys, const KvLoadSettings& settings, ContextPool& context_pool) {
+    if (settings.streams == 0) {
+        throw std::invalid_argument{"streams must be positive"};
+    }
+    const OpPicker op_picker{settings.op_mix};
+    std::atomic_uint64_t next_op{0};
+    std::vector<std::future<BenchStats>> client_results;
+    client_results.reserve(settings.streams);
+    const auto start_time = Clock::now();
+    for (uint32_t i{0}; i < settings.streams; ++i) {
+        auto& context = context_pool.next_context();
+        client_results.push_back(boost::asio::co_spawn(*context.io_context(),
+            run_coroutine_client(keys, settings, op_picker, context, next_op, i), boost::asio::use_future));
+    }
+
+    BenchResult result;
+    for (auto& client_result : client_results) {
+        result.stats.merge(client_result.get());
+    }
+    result.elapsed = Clock::now() - start_time;
+    return result;
+}
+
+static bool run_op(SyncTx& tx, uint32_t cursor_id, KvOp op, const KeyValue& pair, uint32_t walk_length) {
+    remote::Pair reply;
+    switch (op) {
+        case KvOp::seek:
+            return tx.call(remote::Op::SEEK, cursor_id, pair.key, {}, reply);
+        case KvOp::seek_exact:
+            return tx.call(remote::Op::SEEK_EXACT, cursor_id, pair.key, {}, reply);
+        case KvOp::next_walk:
+            if (!tx.call(remote::Op::SEEK, cursor_id, pair.key, {}, reply)) {
+                return false;
+            }
+            for (uint32_t i{0}; i < walk_length && !reply.k().empty(); ++i) {
+                if (!tx.call(remote::Op::NEXT, cursor_id, {}, {}, reply)) {
+                    return false;
+                }
+            }
+            return true;
+        case KvOp::seek_both:
+            return tx.call(remote::Op::SEEK_BOTH, cursor_id, pair.key, pair.value, reply);
+    }
+    return false;
+}
+
+static BenchStats run_sync_client(const KeySet& keys, const KvLoadSettings& settings, const OpPicker& op_picker,
+    const std::shared_ptr<grpc::Channel>& channel, std::atomic_uint64_t& next_op, uint32_t client_index) {
+    BenchStats stats;
+    std::minstd_rand generator{kLoadSeed + client_index};
+    const bool dup_sorted{has_seek_both(settings.op_mix)};
+    const auto stub = remote::KV::NewStub(channel);
+    std::unique_ptr<SyncTx> tx;
+    uint32_t cursor_id{0};
+    uint32_t tx_ops{0};
+    while (next_op.fetch_add(1) < settings.num_ops) {
+        const auto op = op_picker.pick(generator);
+        const auto& pair = keys.pick(generator);
+        // The Tx begin is accounted to the first operation run in it, while the Tx close is not accounted at all
+        const auto start_time = Clock::now();
+        bool ok{false};
+        try {
+            if (!tx) {
+                tx = std::make_unique<SyncTx>(*stub);
+                cursor_id = tx->open(settings.table, dup_sorted);
+            }
+            ok = run_op(*tx, cursor_id, op, pair, settings.walk_length);
+        } catch (const std::exception& e) {
+            SILKRPC_DEBUG << "kv bench op error: " << e.what() << "\n";
+        }
+        stats.record(op_name(op), Clock::now() - start_time, ok);
+        if (!ok) {
+            tx.reset();
+            tx_ops = 0;
+        } else if (settings.ops_per_tx > 0 && ++tx_ops == settings.ops_per_tx) {
+            tx->close();
+            tx.reset();
+            tx_ops = 0;
+        }
+    }
+    if (tx) {
+        tx->close();
+    }
+    return stats;
+}
+
+BenchResult run_kv_load_sync(const KeySet& keys, const KvLoadSettings& settings,
+    const std::vector<std::shared_ptr<grpc::Channel>>& channels) {
+    if (settings.streams == 0) {
+        throw std::invalid_argument{"streams must be positive"};
+    }
+    if (channels.empty()) {
+        throw std::invalid_argument{"no channel"};
+    }
+    const OpPicker op_picker{settings.op_mix};
+    std::atomic_uint64_t next_op{0};
+    std::vector<BenchStats> client_stats(settings.streams);
+    std::vector<std::thread> clients;
+    clients.reserve(settings.streams);
+    const auto start_time = Clock::now();
+    for (uint32_t i{0}; i < settings.streams; ++i) {
+        clients.emplace_back([&, i]() {
+            client_stats[i] = run_sync_client(keys, settings, op_picker, channels[i % channels.size()], next_op, i);
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+
+    BenchResult result;
+    result.elapsed = Clock::now() - start_time;
+    for (const auto& stats : client_stats) {
+        result.stats.merge(stats);
+    }
+    return result;
+}
+
+} // namespace silkrpc::bench
@@ -0,0 +1,104 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_BENCH_KV_LOAD_HPP_
+#define SILKRPC_BENCH_KV_LOAD_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include <silkrpc/bench/bench_stats.hpp>
+#include <silkrpc/common/util.hpp>
+#include <silkrpc/concurrency/context_pool.hpp>
+
+namespace silkrpc::bench {
+
+//! The cursor operations of the KV load, each one timed as a whole (the walk being the seek followed by the nexts)
+enum class KvOp {
+    seek,
+    seek_exact,
+    next_walk,
+    seek_both,
+};
+
+std::string op_name(KvOp op);
+
+//! The weight of each cursor operation in the mix
+using KvOpMix = std::vector<std::pair<KvOp, uint32_t>>;
+
+//! Parse the op mix specified as comma-separated list like seek=40,seek_exact=30,next=20,seek_both=10
+KvOpMix parse_op_mix(const std::string& mix_spec);
+
+//! The distribution of the keys picked among the sampled ones
+enum class KeyDistribution {
+    uniform,
+    //! Zipf distribution with exponent 1, so that a few hot keys get most of the operations
+    zipf,
+};
+
+KeyDistribution parse_key_distribution(const std::string& name);
+
+//! The pairs sampled from the table, picked according to the distribution by each client from its own seeded sequence
+//! so that the runs are repeatable
+class KeySet {
+public:
+    KeySet(std::vector<KeyValue> pairs, KeyDistribution distribution);
+
+    //! Sample the pairs from the table seeking random key prefixes (and walking from the first key if short of them)
+    static KeySet sample(const std::shared_ptr<grpc::Channel>& channel, const std::string& table, uint32_t num_samples,
+        KeyDistribution distribution);
+
+    std::size_t size() const noexcept { return pairs_.size(); }
+
+    const KeyValue& pick(std::minstd_rand& generator) const;
+
+private:
+    std::vector<KeyValue> pairs_;
+    //! The cumulative weights of the pairs for the Zipf distribution, empty for the uniform one
+    std::vector<double> cumulative_weights_;
+};
+
+struct KvLoadSettings {
+    std::string table;
+    KvOpMix op_mix{{KvOp::seek, 1}};
+    //! The number of concurrent Tx streams, each one running its operations in sequence
+    uint32_t streams{1};
+    uint64_t num_ops{10000};
+    //! The number of nexts after the seek of each walk
+    uint32_t walk_length{10};
+    //! The number of operations run in each Tx stream before closing it and opening a new one, 0 meaning never
+    uint32_t ops_per_tx{100};
+};
+
+//! Run the cursor operations on the silkrpc remote database of the running contexts, i.e. the coroutine model used
+//! by the daemon, the streams being spread in round-robin order over the contexts and then over their channels
+BenchResult run_kv_load_coroutines(const KeySet& keys, const KvLoadSettings& settings, ContextPool& context_pool);
+
+//! Run the cursor operations using the blocking gRPC API, one thread for each stream and the streams spread in
+//! round-robin order over the channels, to be compared against the coroutine model
+BenchResult run_kv_load_sync(const KeySet& keys, const KvLoadSettings& settings,
+    const std::vector<std::shared_ptr<grpc::Channel>>& channels);
+
+} // namespace silkrpc::bench
+
+#endif // SILKRPC_BENCH_KV_LOAD_HPP_
@@ -0,0 +1,167 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "kv_load.hpp"
+
+#include <map>
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+#include <silkworm/common/util.hpp>
+
+#include <silkrpc/bench/fake_backend.hpp>
+
+namespace silkrpc::bench {
+
+static KeySet make_key_set(std::size_t num_keys, KeyDistribution distribution) {
+    std::vector<KeyValue> pairs;
+    for (std::size_t i{0}; i < num_keys; ++i) {
+        pairs.push_back({silkworm::Bytes(1, static_cast<uint8_t>(i)), silkworm::Bytes(1, static_cast<uint8_t>(i))});
+    }
+    return KeySet{std::move(pairs), distribution};
+}
+
+static KvDataset make_dataset(std::size_t num_keys) {
+    KvDataset dataset;
+    for (std::size_t i{0}; i < num_keys; ++i) {
+        const silkworm::Bytes key(4, static_cast<uint8_t>(i * 256 / num_keys));
+        dataset.add("PlainState", key, *silkworm::from_hex("aa"));
+        dataset.add("PlainState", key, *silkworm::from_hex("bb"));
+    }
+    return dataset;
+}
+
+TEST_CASE("parse_op_mix", "[silkrpc][bench][kv_load]") {
+    SECTION("valid mix") {
+        const auto op_mix = parse_op_mix("seek=40,seek_exact=30,next=20,seek_both=10");
+        CHECK(op_mix == KvOpMix{{KvOp::seek, 40}, {KvOp::seek_exact, 30}, {KvOp::next_walk, 20}, {KvOp::seek_both, 10}});
+        CHECK(op_name(KvOp::next_walk) == "next");
+    }
+
+    SECTION("invalid mix") {
+        CHECK_THROWS_AS(parse_op_mix(""), std::invalid_argument);
+        CHECK_THROWS_AS(parse_op_mix("prev=1"), std::invalid_argument);
+        CHECK_THROWS_AS(parse_op_mix("seek=0"), std::invalid_argument);
+    }
+}
+
+TEST_CASE("parse_key_distribution", "[silkrpc][bench][kv_load]") {
+    CHECK(parse_key_distribution("uniform") == KeyDistribution::uniform);
+    CHECK(parse_key_distribution("zipf") == KeyDistribution::zipf);
+    CHECK_THROWS_AS(parse_key_distribution("normal"), std::invalid_argument);
+}
+
+TEST_CASE("KeySet::pick", "[silkrpc][bench][kv_load]") {
+    SECTION("empty key set") {
+        CHECK_THROWS_AS(KeySet({}, KeyDistribution::uniform), std::invalid_argument);
+    }
+
+    SECTION("uniform distribution") {
+        const auto keys = make_key_set(10, KeyDistribution::uniform);
+        std::minstd_rand generator{1};
+        std::map<silkworm::Bytes, int> counts;
+        for (int i{0}; i < 10'000; ++i) {
+            ++counts[keys.pick(generator).key];
+        }
+        CHECK(counts.size() == 10);
+        for (const auto& [_, count] : counts) {
+            CHECK(count > 800);
+            CHECK(count < 1200);
+        }
+    }
+
+    SECTION("zipf distribution") {
+        const auto keys = make_key_set(100, KeyDistribution::zipf);
+        std::minstd_rand generator{1};
+        std::map<silkworm::Bytes, int> counts;
+        for (int i{0}; i < 10'000; ++i) {
+            ++counts[keys.pick(generator).key];
+        }
+        int max_count{0};
+        for (const auto& [_, count] : counts) {
+            max_count = std::max(max_count, count);
+        }
+        // The hottest key gets about 1 / H(100) ~ 19% of the picks
+        CHECK(max_count > 1500);
+        CHECK(max_count < 2300);
+    }
+
+    SECTION("same sequence for the same seed") {
+        const auto keys = make_key_set(100, KeyDistribution::zipf);
+        std::minstd_rand generator1{7}, generator2{7};
+        for (int i{0}; i < 100; ++i) {
+            CHECK(keys.pick(generator1).key == keys.pick(generator2).key);
+        }
+    }
+}
+
+TEST_CASE("KeySet::sample", "[silkrpc][bench][kv_load]") {
+    auto dataset = make_dataset(16);
+    FakeBackend backend{dataset, {"localhost:0"}};
+    backend.start();
+    const auto channel = grpc::CreateChannel("localhost:" + std::to_string(backend.port()), grpc::InsecureChannelCredentials());
+
+    SECTION("fewer keys than samples") {
+        const auto keys = KeySet::sample(channel, "PlainState", 100, KeyDistribution::uniform);
+        CHECK(keys.size() == 16);
+    }
+
+    SECTION("more keys than samples") {
+        const auto keys = KeySet::sample(channel, "PlainState", 8, KeyDistribution::uniform);
+        CHECK(keys.size() == 8);
+    }
+
+    SECTION("empty table") {
+        CHECK_THROWS_AS(KeySet::sample(channel, "Code", 8, KeyDistribution::uniform), std::runtime_error);
+    }
+}
+
+TEST_CASE("run_kv_load", "[silkrpc][bench][kv_load]") {
+    auto dataset = make_dataset(16);
+    FakeBackend backend{dataset, {"localhost:0"}};
+    backend.start();
+    const auto target = "localhost:" + std::to_string(backend.port());
+    const auto keys = make_key_set(16, KeyDistribution::uniform);
+    KvLoadSettings settings{"PlainState", parse_op_mix("seek=1,seek_exact=1,next=1,seek_both=1"), /*streams=*/4, /*num_ops=*/200,
+                            /*walk_length=*/3, /*ops_per_tx=*/10};
+
+    SECTION("sync model") {
+        const std::vector channels{grpc::CreateChannel(target, grpc::InsecureChannelCredentials()),
+                                   grpc::CreateChannel(target, grpc::InsecureChannelCredentials())};
+        const auto result = run_kv_load_sync(keys, settings, channels);
+        CHECK(result.stats.num_requests() == 200);
+        CHECK(result.stats.num_errors() == 0);
+        CHECK(result.stats.report(result.elapsed)["methods"].size() == 4);
+    }
+
+    SECTION("coroutines model") {
+        ContextPool context_pool{2, [&]() { return grpc::CreateChannel(target, grpc::InsecureChannelCredentials()); }};
+        context_pool.start();
+        const auto result = run_kv_load_coroutines(keys, settings, context_pool);
+        context_pool.stop();
+        context_pool.join();
+        CHECK(result.stats.num_requests() == 200);
+        CHECK(result.stats.num_errors() == 0);
+    }
+
+    SECTION("no stream") {
+        settings.streams = 0;
+        CHECK_THROWS_AS(run_kv_load_sync(keys, settings, {}), std::invalid_argument);
+    }
+}
+
+} // namespace silkrpc::bench
@@ -0,0 +1,172 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "workload.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#include <absl/strings/escaping.h>
+#include <absl/strings/numbers.h>
+#include <absl/strings/str_split.h>
+
+#include <silkrpc/common/request_recorder.hpp>
+
+namespace silkrpc::bench {
+
+//! Return the well-mixed 64-bit value of the input (the finalizer of SplitMix64), so that consecutive indexes pick
+//! unrelated requests
+static uint64_t mix_bits(uint64_t x) {
+    x += 0x9e3779b97f4a7c15;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+}
+
+//! The pseudo-method of the batch requests, which are accounted all together
+static const std::string kBatchMethod{"batch"};
+
+static BenchRequest make_request(std::string content) {
+    auto json = nlohmann::json::parse(content);
+    if (json.is_array() && !json.empty()) {
+        return BenchRequest{kBatchMethod, std::move(content), std::move(json)};
+    }
+    if (!json.is_object() || !json.contains("method") || !json["method"].is_string()) {
+        throw std::invalid_argument{"invalid JSON RPC request: " + content};
+    }
+    auto method = json["method"].get<std::string>();
+    return BenchRequest{std::move(method), std::move(content), std::move(json)};
+}
+
+Workload::MethodMix Workload::parse_mix(const std::string& mix_spec) {
+    MethodMix mix;
+    for (const auto item : absl::StrSplit(mix_spec, ',', absl::SkipWhitespace())) {
+        const std::vector<std::string> name_and_weight = absl::StrSplit(item, '=');
+        uint32_t weight{0};
+        if (name_and_weight.size() != 2 || name_and_weight[0].empty() || !absl::SimpleAtoi(name_and_weight[1], &weight) || weight == 0) {
+            throw std::invalid_argument{"invalid method mix item: " + std::string{item}};
+        }
+        mix.emplace_back(name_and_weight[0], weight);
+    }
+    if (mix.empty()) {
+        throw std::invalid_argument{"empty method mix"};
+    }
+    return mix;
+}
+
+Workload Workload::load(std::istream& input) {
+    Workload workload;
+    std::string line;
+    while (std::getline(input, line)) {
+        if (std::all_of(line.begin(), line.end(), [](unsigned char c) { return std::isspace(c); })) {
+            continue;
+        }
+        const auto line_json = nlohmann::json::parse(line);
+        if (line_json.contains("body") && line_json["body"].is_string()) {
+            std::string content;
+            if (!absl::Base64Unescape(line_json["body"].get<std::string>(), &content)) {
+                throw std::invalid_argument{"invalid base64 body in target: " + line};
+            }
+            workload.requests_.push_back(make_request(std::move(content)));
+        } else {
+            workload.requests_.push_back(make_request(std::move(line)));
+        }
+    }
+    return workload;
+}
+
+Workload Workload::load(const std::filesystem::path& file_path) {
+    std::ifstream file{file_path, std::ios::binary};
+    if (!file) {
+        throw std::invalid_argument{"cannot open workload file " + file_path.string()};
+    }
+    std::string magic(RecordingFormat::kMagic.size(), '\0');
+    file.read(magic.data(), static_cast<std::streamsize>(magic.size()));
+    if (file.gcount() == static_cast<std::streamsize>(magic.size()) && magic == RecordingFormat::kMagic) {
+        file.close();
+        return load_recording(file_path);
+    }
+    file.clear();
+    file.seekg(0);
+    return load(file);
+}
+
+Workload Workload::load_recording(const std::filesystem::path& file_path) {
+    Workload workload;
+    RecordingReader reader{file_path};
+    while (auto recorded_request = reader.next()) {
+        auto request = make_request(std::move(recorded_request->content));
+        request.offset = recorded_request->offset;
+        workload.requests_.push_back(std::move(request));
+    }
+    // The records are written per thread, so they are just roughly ordered by arrival time
+    std::stable_sort(workload.requests_.begin(), workload.requests_.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.offset < rhs.offset;
+    });
+    return workload;
+}
+
+Workload Workload::synthetic(const MethodMix& mix) {
+    Workload workload;
+    for (const auto& [method, weight] : mix) {
+        const nlohmann::json request_json{{"jsonrpc", "2.0"}, {"id", 1}, {"method", method}, {"params", nlohmann::json::array()}};
+        workload.requests_.push_back(make_request(request_json.dump()));
+    }
+    return workload.with_mix(mix);
+}
+
+Workload Workload::with_mix(const MethodMix& mix) const {
+    Workload workload;
+    workload.requests_ = requests_;
+    uint64_t cumulative_weight{0};
+    for (const auto& [method, weight] : mix) {
+        MethodGroup group;
+        for (std::size_t i{0}; i < requests_.size(); ++i) {
+            if (requests_[i].method == method) {
+                group.indexes.push_back(i);
+            }
+        }
+        if (group.indexes.empty()) {
+            throw std::invalid_argument{"no request in workload for method " + method};
+        }
+        cumulative_weight += weight;
+        group.cumulative_weight = cumulative_weight;
+        workload.groups_.push_back(std::move(group));
+    }
+    return workload;
+}
+
+const BenchRequest& Workload::at(uint64_t index) const {
+    if (groups_.empty()) {
+        return requests_[index % requests_.size()];
+    }
+    const auto bits = mix_bits(index);
+    const auto weight = bits % groups_.back().cumulative_weight;
+    const auto group_it = std::upper_bound(groups_.begin(), groups_.end(), weight, [](uint64_t w, const MethodGroup& group) {
+        return w < group.cumulative_weight;
+    });
+    const auto& indexes = group_it->indexes;
+    return requests_[indexes[mix_bits(bits) % indexes.size()]];
+}
+
+std::chrono::nanoseconds Workload::send_offset(uint64_t index) const {
+    const auto round = static_cast<int64_t>(index / requests_.size());
+    return requests_[index % requests_.size()].offset + round * requests_.back().offset;
+}
+
+} // namespace silkrpc::bench
@@ -0,0 +1,89 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_BENCH_WORKLOAD_HPP_
+#define SILKRPC_BENCH_WORKLOAD_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace silkrpc::bench {
+
+//! One JSON RPC request of the workload, kept both as the text sent over HTTP and as the JSON handled in-process
+struct BenchRequest {
+    std::string method;
+    std::string content;
+    nlohmann::json json;
+    //! The time the request was received since the capture start, zero if the capture has no timing
+    std::chrono::nanoseconds offset{0};
+};
+
+//! The requests sent by the load generator, either replayed in order as captured or picked according to a method mix
+class Workload {
+public:
+    //! The weight of each method in the mix
+    using MethodMix = std::vector<std::pair<std::string, uint32_t>>;
+
+    //! Parse the method mix specified as comma-separated list like eth_call=70,eth_blockNumber=30
+    static MethodMix parse_mix(const std::string& mix_spec);
+
+    //! Load the captured requests, one per line either as JSON RPC request or as Vegeta target having base64 body
+    static Workload load(std::istream& input);
+
+    //! Load the captured requests from the file, either a daemon recording (see RequestRecorder) or a text capture
+    static Workload load(const std::filesystem::path& file_path);
+
+    //! Make the synthetic workload calling the methods in the mix without parameters
+    static Workload synthetic(const MethodMix& mix);
+
+    //! Return the workload picking the requests of each method with its weight in the mix, the others being dropped
+    Workload with_mix(const MethodMix& mix) const;
+
+    std::size_t size() const noexcept { return requests_.size(); }
+    bool empty() const noexcept { return requests_.empty(); }
+
+    //! Return the request to be sent as the index-th one, the same for the same index and never changing, so that the
+    //! concurrent clients can share the workload without any synchronization
+    const BenchRequest& at(uint64_t index) const;
+
+    //! Return the time the index-th request must be sent since the replay start to preserve the captured timing, the
+    //! workload being replayed again after the last request when more requests than captured are sent
+    std::chrono::nanoseconds send_offset(uint64_t index) const;
+
+private:
+    static Workload load_recording(const std::filesystem::path& file_path);
+
+    struct MethodGroup {
+        uint64_t cumulative_weight{0};
+        std::vector<std::size_t> indexes;
+    };
+
+    std::vector<BenchRequest> requests_;
+    //! The request groups by method in mix order, empty if the requests are replayed in order
+    std::vector<MethodGroup> groups_;
+};
+
+} // namespace silkrpc::bench
+
+#endif // SILKRPC_BENCH_WORKLOAD_HPP_
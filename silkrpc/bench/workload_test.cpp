@@ -0,0 +1,156 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "workload.hpp"
+
+#include <filesystem>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+
+#include <silkrpc/common/request_recorder.hpp>
+
+namespace silkrpc::bench {
+
+TEST_CASE("Workload::parse_mix", "[silkrpc][bench][workload]") {
+    SECTION("valid mix") {
+        const auto mix = Workload::parse_mix("eth_call=70,eth_blockNumber=30");
+        CHECK(mix == Workload::MethodMix{{"eth_call", 70}, {"eth_blockNumber", 30}});
+    }
+
+    SECTION("invalid mix") {
+        CHECK_THROWS_AS(Workload::parse_mix(""), std::invalid_argument);
+        CHECK_THROWS_AS(Workload::parse_mix("eth_call"), std::invalid_argument);
+        CHECK_THROWS_AS(Workload::parse_mix("eth_call=x"), std::invalid_argument);
+        CHECK_THROWS_AS(Workload::parse_mix("eth_call=0"), std::invalid_argument);
+        CHECK_THROWS_AS(Workload::parse_mix("=1"), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Workload::load", "[silkrpc][bench][workload]") {
+    SECTION("JSON RPC requests replayed in order") {
+        std::istringstream input{
+            "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"eth_blockNumber\",\"params\":[]}\n"
+            "\n"
+            "{\"jsonrpc\":\"2.0\",\"id\":2,\"method\":\"eth_chainId\",\"params\":[]}\n"
+        };
+        const auto workload = Workload::load(input);
+        CHECK(workload.size() == 2);
+        CHECK(workload.at(0).method == "eth_blockNumber");
+        CHECK(workload.at(1).method == "eth_chainId");
+        CHECK(workload.at(2).method == "eth_blockNumber");
+        CHECK(workload.at(1).json["id"] == 2);
+    }
+
+    SECTION("Vegeta targets") {
+        // body is {"jsonrpc":"2.0","id":1,"method":"eth_blockNumber","params":[]}
+        std::istringstream input{
+            "{\"method\":\"POST\",\"url\":\"http://localhost:8545\",\"body\":"
+            "\"eyJqc29ucnBjIjoiMi4wIiwiaWQiOjEsIm1ldGhvZCI6ImV0aF9ibG9ja051bWJlciIsInBhcmFtcyI6W119\","
+            "\"header\":{\"Content-Type\":[\"application/json\"]}}\n"
+        };
+        const auto workload = Workload::load(input);
+        CHECK(workload.size() == 1);
+        CHECK(workload.at(0).method == "eth_blockNumber");
+        CHECK(workload.at(0).content == R"({"jsonrpc":"2.0","id":1,"method":"eth_blockNumber","params":[]})");
+    }
+
+    SECTION("invalid requests") {
+        std::istringstream no_method{"{\"jsonrpc\":\"2.0\",\"id\":1}\n"};
+        CHECK_THROWS_AS(Workload::load(no_method), std::invalid_argument);
+        std::istringstream invalid_body{"{\"body\":\"!!!\"}\n"};
+        CHECK_THROWS_AS(Workload::load(invalid_body), std::invalid_argument);
+        std::istringstream invalid_json{"{\n"};
+        CHECK_THROWS(Workload::load(invalid_json));
+    }
+
+    SECTION("batch requests") {
+        std::istringstream input{"[{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"eth_blockNumber\",\"params\":[]}]\n"};
+        const auto workload = Workload::load(input);
+        CHECK(workload.size() == 1);
+        CHECK(workload.at(0).method == "batch");
+    }
+
+    SECTION("missing file") {
+        CHECK_THROWS_AS(Workload::load(std::filesystem::path{"/nonexistent/workload.json"}), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Workload::load recording", "[silkrpc][bench][workload]") {
+    const auto recording_path = std::filesystem::temp_directory_path() / "silkrpc_workload_recording.bin";
+    {
+        RequestRecorder recorder{recording_path, 1, /*with_replies=*/false};
+        const auto origin = RequestRecorder::Clock::now();
+        recorder.record(origin + std::chrono::milliseconds{30}, R"({"jsonrpc":"2.0","id":2,"method":"eth_chainId","params":[]})", 0, {});
+        recorder.record(origin + std::chrono::milliseconds{10}, R"({"jsonrpc":"2.0","id":1,"method":"eth_blockNumber","params":[]})", 0, {});
+    }
+
+    const auto workload = Workload::load(recording_path);
+    std::filesystem::remove(recording_path);
+    REQUIRE(workload.size() == 2);
+    CHECK(workload.at(0).method == "eth_blockNumber");
+    CHECK(workload.at(1).method == "eth_chainId");
+
+    SECTION("send offsets preserve the recorded timing") {
+        const auto first_offset = workload.send_offset(0);
+        const auto last_offset = workload.send_offset(1);
+        CHECK(last_offset - first_offset >= std::chrono::milliseconds{20});
+        CHECK(workload.send_offset(2) == first_offset + last_offset);
+        CHECK(workload.send_offset(3) == 2 * last_offset);
+    }
+}
+
+TEST_CASE("Workload mix", "[silkrpc][bench][workload]") {
+    SECTION("synthetic requests picked according to weights") {
+        const auto workload = Workload::synthetic(Workload::parse_mix("eth_call=3,eth_blockNumber=1"));
+        std::map<std::string, int> counts;
+        for (uint64_t i{0}; i < 40'000; ++i) {
+            ++counts[workload.at(i).method];
+        }
+        CHECK(counts.size() == 2);
+        CHECK(counts["eth_call"] > 29'000);
+        CHECK(counts["eth_call"] < 31'000);
+        CHECK(workload.at(0).json["params"].is_array());
+    }
+
+    SECTION("same request for same index") {
+        const auto workload = Workload::synthetic(Workload::parse_mix("eth_call=1,eth_blockNumber=1"));
+        for (uint64_t i{0}; i < 100; ++i) {
+            CHECK(&workload.at(i) == &workload.at(i));
+        }
+    }
+
+    SECTION("captured requests reweighted") {
+        std::istringstream input{
+            "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"eth_blockNumber\",\"params\":[]}\n"
+            "{\"jsonrpc\":\"2.0\",\"id\":2,\"method\":\"eth_getBalance\",\"params\":[\"0x0\",\"latest\"]}\n"
+            "{\"jsonrpc\":\"2.0\",\"id\":3,\"method\":\"eth_getBalance\",\"params\":[\"0x1\",\"latest\"]}\n"
+        };
+        const auto workload = Workload::load(input).with_mix(Workload::parse_mix("eth_getBalance=1"));
+        std::map<int, int> counts;
+        for (uint64_t i{0}; i < 1'000; ++i) {
+            CHECK(workload.at(i).method == "eth_getBalance");
+            ++counts[workload.at(i).json["id"].get<int>()];
+        }
+        CHECK(counts.size() == 2);
+        CHECK_THROWS_AS(workload.with_mix(Workload::parse_mix("eth_call=1")), std::invalid_argument);
+    }
+}
+
+} // namespace silkrpc::bench
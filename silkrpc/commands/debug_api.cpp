@@ -16,9 +16,13 @@
 
 #include "debug_api.hpp"
 
-#include <set>
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <ostream>
 #include <sstream>
 #include <vector>
@@ -26,6 +30,9 @@
 #include <chrono>
 #include <ctime>
 
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/this_coro.hpp>
 #include <evmc/evmc.hpp>
 #include <silkworm/common/util.hpp>
 #include <silkworm/core/silkworm/common/endian.hpp>
@@ -36,6 +43,7 @@
 #include <silkrpc/common/constants.hpp>
 #include <silkrpc/common/log.hpp>
 #include <silkrpc/common/util.hpp>
+#include <silkrpc/concurrency/parallel_for.hpp>
 #include <silkrpc/core/cached_chain.hpp>
 #include <silkrpc/core/account_dumper.hpp>
 #include <silkrpc/core/account_walker.hpp>
@@ -46,9 +54,11 @@
 #include <silkrpc/core/state_reader.hpp>
 #include <silkrpc/core/storage_walker.hpp>
 #include <silkrpc/ethdb/kv/cached_database.hpp>
+#include <silkrpc/ethdb/memoized_database.hpp>
 #include <silkrpc/ethdb/tables.hpp>
 #include <silkrpc/ethdb/transaction_database.hpp>
 #include <silkrpc/json/types.hpp>
+#include <silkrpc/json/writer.hpp>
 #include <silkrpc/types/block.hpp>
 #include <silkrpc/types/call.hpp>
 #include <silkrpc/types/dump_account.hpp>
@@ -57,8 +67,8 @@ namespace silkrpc::commands {
 
 // https://github.com/ethereum/retesteth/wiki/RPC-Methods#debug_accountrange
 boost::asio::awaitable<void> DebugRpcApi::handle_debug_account_range(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
-    if (params.size() != 5) {
+    const auto& params = request["params"];
+    if (params.size() != 5 && params.size() != 6) {
         auto error_msg = "invalid debug_accountRange params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
         reply = make_json_error(request["id"], 100, error_msg);
@@ -69,6 +79,8 @@ boost::asio::awaitable<void> DebugRpcApi::handle_debug_account_range(const nlohm
     auto max_result = params[2].get<int16_t>();
     const auto exclude_code = params[3].get<bool>();
     const auto exclude_storage = params[4].get<bool>();
+    // The optional continuation token of the previous page, empty for the first one, asks for the token of the next page
+    const auto continuation = params.size() == 6 ? std::make_optional(params[5].get<std::string>()) : std::nullopt;
 
     silkworm::Bytes start_key(start_key_array.data(), start_key_array.size());
     const auto start_address = silkworm::to_evmc_address(start_key);
@@ -84,17 +96,19 @@ boost::asio::awaitable<void> DebugRpcApi::handle_debug_account_range(const nlohm
         << " exclude_storage: " << exclude_storage
         << "\n";
 
-    auto tx = co_await database_->begin();
+    auto session = co_await open_account_range_session(continuation, start_address, exclude_code, exclude_storage);
 
+    bool succeeded{false};
     try {
         auto start = std::chrono::system_clock::now();
-        AccountDumper dumper{*tx};
-        DumpAccounts dump_accounts = co_await dumper.dump_accounts(*context_.block_cache(), block_number_or_hash, start_address, max_result, exclude_code, exclude_storage);
+        AccountDumper dumper{*session->transaction, database_.get()};
+        DumpAccounts dump_accounts = co_await dumper.dump_accounts(*context_.block_cache(), block_number_or_hash, *session, max_result);
         auto end = std::chrono::system_clock::now();
         std::chrono::duration<double> elapsed_seconds = end - start;
         SILKRPC_DEBUG << "dump_accounts: elapsed " << elapsed_seconds.count() << " sec\n";
 
         reply = make_json_content(request["id"], dump_accounts);
+        succeeded = true;
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
         reply = make_json_error(request["id"], 100, e.what());
@@ -103,13 +117,153 @@ boost::asio::awaitable<void> DebugRpcApi::handle_debug_account_range(const nlohm
         reply = make_json_error(request["id"], 100, "unexpected exception");
     }
 
-    co_await tx->close(); // RAII not (yet) available with coroutines
+    const auto next_token = co_await release_account_range_session(std::move(session), continuation && succeeded);
+    if (next_token) {
+        reply["result"]["continuation"] = *next_token;
+    }
     co_return;
 }
 
+// https://github.com/ethereum/retesteth/wiki/RPC-Methods#debug_accountrange
+boost::asio::awaitable<void> DebugRpcApi::handle_debug_account_range_stream(const nlohmann::json& request, json::Stream& stream) {
+    const auto& params = request["params"];
+    if (params.size() != 5 && params.size() != 6) {
+        auto error_msg = "invalid debug_accountRange params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        co_await stream.write_json(make_json_error(request["id"], 100, error_msg));
+        co_return;
+    }
+    const auto block_number_or_hash = params[0].get<BlockNumberOrHash>();
+    const auto start_key_array = params[1].get<std::vector<std::uint8_t>>();
+    auto max_result = params[2].get<int16_t>();
+    const auto exclude_code = params[3].get<bool>();
+    const auto exclude_storage = params[4].get<bool>();
+    const auto continuation = params.size() == 6 ? std::make_optional(params[5].get<std::string>()) : std::nullopt;
+    const auto request_id = request["id"].get<uint32_t>();
+
+    silkworm::Bytes start_key(start_key_array.data(), start_key_array.size());
+    const auto start_address = silkworm::to_evmc_address(start_key);
+
+    if (max_result > kAccountRangeMaxResults || max_result <= 0) {
+        max_result = kAccountRangeMaxResults;
+    }
+
+    SILKRPC_INFO << "block_number_or_hash: " << block_number_or_hash
+        << " start_address: 0x" << silkworm::to_hex(start_address)
+        << " max_result: " << max_result
+        << " exclude_code: " << exclude_code
+        << " exclude_storage: " << exclude_storage
+        << "\n";
+
+    auto session = co_await open_account_range_session(continuation, start_address, exclude_code, exclude_storage);
+
+    // The accounts are written window after window in the same order as the sorted JSON keys of the non-streamed reply,
+    // i.e. accounts then continuation, next and root, so once the result has been started any error can just follow it
+    bool result_started{false};
+    std::size_t num_accounts{0};
+    DumpAccounts last_window;
+    std::optional<std::string> error_msg;
+    std::exception_ptr eptr;
+    try {
+        AccountDumper dumper{*session->transaction, database_.get()};
+        co_await dumper.dump_accounts(*context_.block_cache(), block_number_or_hash, *session, max_result,
+            [&](DumpAccounts& window) -> boost::asio::awaitable<void> {
+                if (!result_started) {
+                    co_await stream.write("{\"id\":" + std::to_string(request_id) + ",\"jsonrpc\":\"2.0\",\"result\":{\"accounts\":{");
+                    result_started = true;
+                }
+                for (const auto& [address, account] : window.accounts) {
+                    if (num_accounts++ > 0) {
+                        co_await stream.write(",");
+                    }
+                    co_await stream.write("\"0x" + silkworm::to_hex(address) + "\":");
+                    co_await stream.write_json(account);
+                }
+                last_window.root = window.root;
+                last_window.next = window.next;
+            });
+        SILKRPC_DEBUG << "num_accounts: " << num_accounts << " bytes_written: " << stream.bytes_written() << "\n";
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
+        error_msg = e.what();
+        eptr = std::current_exception();
+    } catch (...) {
+        SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
+        error_msg = "unexpected exception";
+        eptr = std::current_exception();
+    }
+
+    const auto next_token = co_await release_account_range_session(std::move(session), continuation && !error_msg && !stream.failed());
+
+    if (stream.failed()) {
+        std::rethrow_exception(eptr);
+    }
+    if (!result_started) {
+        co_await stream.write_json(make_json_error(request_id, 100, error_msg.value_or("unexpected exception")));
+        co_return;
+    }
+    if (error_msg) {
+        co_await stream.write("}},\"error\":");
+        co_await stream.write_json(nlohmann::json{{"code", 100}, {"message", *error_msg}});
+        co_await stream.write("}");
+        co_return;
+    }
+    const auto encoded_next = base64_encode(last_window.next.bytes, silkworm::kAddressLength, false);
+    if (next_token) {
+        co_await stream.write("},\"continuation\":");
+        co_await stream.write_json(*next_token);
+        co_await stream.write(",\"next\":");
+    } else {
+        co_await stream.write("},\"next\":");
+    }
+    co_await stream.write_json(encoded_next);
+    co_await stream.write(",\"root\":");
+    co_await stream.write_json(last_window.root);
+    co_await stream.write("}}");
+}
+
+boost::asio::awaitable<AccountRangeSessionPtr> DebugRpcApi::open_account_range_session(const std::optional<std::string>& token,
+    const evmc::address& start_address, bool exclude_code, bool exclude_storage) {
+    const auto& sessions = context_.account_range_sessions();
+    if (token && !token->empty() && sessions) {
+        auto session = sessions->take(*token);
+        if (session && session->continues(start_address, exclude_code, exclude_storage)) {
+            SILKRPC_DEBUG << "debug_accountRange continuing session: " << *token << "\n";
+            co_return session;
+        }
+        // Unknown (e.g. expired or parked in another context) or not continued tokens just start a new walk
+        SILKRPC_DEBUG << "debug_accountRange cannot continue session: " << *token << "\n";
+        if (session) {
+            std::vector<AccountRangeSessionPtr> discarded;
+            discarded.push_back(std::move(session));
+            co_await AccountRangeSessions::close(discarded);
+        }
+    }
+    auto session = std::make_unique<AccountRangeSession>();
+    session->transaction = co_await database_->begin();
+    session->next = start_address;
+    session->exclude_code = exclude_code;
+    session->exclude_storage = exclude_storage;
+    co_return session;
+}
+
+boost::asio::awaitable<std::optional<std::string>> DebugRpcApi::release_account_range_session(AccountRangeSessionPtr session, bool continuable) {
+    const auto& sessions = context_.account_range_sessions();
+    std::vector<AccountRangeSessionPtr> closed;
+    std::optional<std::string> token;
+    if (continuable && sessions && session->walker && !session->walker->done()) {
+        token = sessions->park(std::move(session), closed);
+        boost::asio::co_spawn(co_await boost::asio::this_coro::executor, AccountRangeSessions::sweep(sessions), boost::asio::detached);
+    } else {
+        closed.push_back(std::move(session));
+    }
+    co_await AccountRangeSessions::close(closed);
+    co_return token;
+}
+
 // https://github.com/ethereum/retesteth/wiki/RPC-Methods#debug_getmodifiedaccountsbynumber
 boost::asio::awaitable<void> DebugRpcApi::handle_debug_get_modified_accounts_by_number(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() == 0 || params.size() > 2) {
         auto error_msg = "invalid debug_getModifiedAccountsByNumber params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -127,11 +281,11 @@ boost::asio::awaitable<void> DebugRpcApi::handle_debug_get_modified_accounts_by_
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         const auto start_block_number = co_await core::get_block_number(start_block_id, tx_database);
         const auto end_block_number = co_await core::get_block_number(end_block_id, tx_database);
 
-        const auto addresses = co_await get_modified_accounts(tx_database, start_block_number, end_block_number);
+        const auto addresses = co_await get_modified_accounts(tx_database, start_block_number, end_block_number, database_.get());
         reply = make_json_content(request["id"], addresses);
     } catch (const std::invalid_argument& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
@@ -150,7 +304,7 @@ boost::asio::awaitable<void> DebugRpcApi::handle_debug_get_modified_accounts_by_
 
 // https://github.com/ethereum/retesteth/wiki/RPC-Methods#debug_getmodifiedaccountsbyhash
 boost::asio::awaitable<void> DebugRpcApi::handle_debug_get_modified_accounts_by_hash(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() == 0 || params.size() > 2) {
         auto error_msg = "invalid debug_getModifiedAccountsByHash params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -168,11 +322,11 @@ boost::asio::awaitable<void> DebugRpcApi::handle_debug_get_modified_accounts_by_
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto start_block_number = co_await core::rawdb::read_header_number(tx_database, start_hash);
         const auto end_block_number = co_await core::rawdb::read_header_number(tx_database, end_hash);
-        auto addresses = co_await get_modified_accounts(tx_database, start_block_number, end_block_number);
+        auto addresses = co_await get_modified_accounts(tx_database, start_block_number, end_block_number, database_.get());
         reply = make_json_content(request["id"], addresses);
     } catch (const std::invalid_argument& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
@@ -189,9 +343,118 @@ boost::asio::awaitable<void> DebugRpcApi::handle_debug_get_modified_accounts_by_
     co_return;
 }
 
+static boost::asio::awaitable<void> write_modified_accounts(json::Stream& stream, uint32_t request_id, const std::vector<evmc::address>& addresses) {
+    co_await stream.open_object();
+    co_await stream.write_field("id", request_id);
+    co_await stream.write_field("jsonrpc", "2.0");
+    co_await stream.write_field("result");
+    co_await stream.open_array();
+    for (const auto& address : addresses) {
+        co_await stream.write_entry(address);
+    }
+    co_await stream.close_array();
+    co_await stream.close_object();
+}
+
+// https://github.com/ethereum/retesteth/wiki/RPC-Methods#debug_getmodifiedaccountsbynumber
+boost::asio::awaitable<void> DebugRpcApi::handle_debug_get_modified_accounts_by_number_stream(const nlohmann::json& request, json::Stream& stream) {
+    const auto& params = request["params"];
+    if (params.size() == 0 || params.size() > 2) {
+        auto error_msg = "invalid debug_getModifiedAccountsByNumber params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        co_await stream.write_json(make_json_error(request["id"], 100, error_msg));
+        co_return;
+    }
+
+    auto start_block_id = params[0].get<std::string>();
+    auto end_block_id = start_block_id;
+    if (params.size() == 2) {
+       end_block_id = params[1].get<std::string>();
+    }
+    SILKRPC_DEBUG << "start_block_id: " << start_block_id << " end_block_id: " << end_block_id << "\n";
+    const auto request_id = request["id"].get<uint32_t>();
+
+    auto tx = co_await database_->begin();
+
+    std::vector<evmc::address> addresses;
+    std::optional<nlohmann::json> error;
+    try {
+        ethdb::MemoizedDatabase tx_database{*tx};
+        const auto start_block_number = co_await core::get_block_number(start_block_id, tx_database);
+        const auto end_block_number = co_await core::get_block_number(end_block_id, tx_database);
+
+        addresses = co_await get_modified_accounts(tx_database, start_block_number, end_block_number, database_.get());
+    } catch (const std::invalid_argument& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
+        error = make_json_error(request_id, -32000, e.what());
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
+        error = make_json_error(request_id, 100, e.what());
+    } catch (...) {
+        SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
+        error = make_json_error(request_id, 100, "unexpected exception");
+    }
+
+    co_await tx->close(); // RAII not (yet) available with coroutines
+
+    if (error) {
+        co_await stream.write_json(*error);
+        co_return;
+    }
+    co_await write_modified_accounts(stream, request_id, addresses);
+}
+
+// https://github.com/ethereum/retesteth/wiki/RPC-Methods#debug_getmodifiedaccountsbyhash
+boost::asio::awaitable<void> DebugRpcApi::handle_debug_get_modified_accounts_by_hash_stream(const nlohmann::json& request, json::Stream& stream) {
+    const auto& params = request["params"];
+    if (params.size() == 0 || params.size() > 2) {
+        auto error_msg = "invalid debug_getModifiedAccountsByHash params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        co_await stream.write_json(make_json_error(request["id"], 100, error_msg));
+        co_return;
+    }
+
+    auto start_hash = params[0].get<evmc::bytes32>();
+    auto end_hash = start_hash;
+    if (params.size() == 2) {
+       end_hash = params[1].get<evmc::bytes32>();
+    }
+    SILKRPC_DEBUG << "start_hash: " << start_hash << " end_hash: " << end_hash << "\n";
+    const auto request_id = request["id"].get<uint32_t>();
+
+    auto tx = co_await database_->begin();
+
+    std::vector<evmc::address> addresses;
+    std::optional<nlohmann::json> error;
+    try {
+        ethdb::MemoizedDatabase tx_database{*tx};
+        const auto start_block_number = co_await core::rawdb::read_header_number(tx_database, start_hash);
+        const auto end_block_number = co_await core::rawdb::read_header_number(tx_database, end_hash);
+
+        addresses = co_await get_modified_accounts(tx_database, start_block_number, end_block_number, database_.get());
+    } catch (const std::invalid_argument& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
+        error = make_json_error(request_id, -32000, e.what());
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
+        error = make_json_error(request_id, 100, e.what());
+    } catch (...) {
+        SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
+        error = make_json_error(request_id, 100, "unexpected exception");
+    }
+
+    co_await tx->close(); // RAII not (yet) available with coroutines
+
+    if (error) {
+        co_await stream.write_json(*error);
+        co_return;
+    }
+    co_await write_modified_accounts(stream, request_id, addresses);
+}
+
 // https://github.com/ethereum/retesteth/wiki/RPC-Methods#debug_storagerangeat
 boost::asio::awaitable<void> DebugRpcApi::handle_debug_storage_range_at(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() == 0 || params.size() > 5) {
         auto error_msg = "invalid debug_storageRangeAt params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -215,7 +478,7 @@ boost::asio::awaitable<void> DebugRpcApi::handle_debug_storage_range_at(const nl
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_with_hash = co_await core::rawdb::read_block_by_hash(tx_database, block_hash);
         auto block_number = block_with_hash.block.header.number - 1;
@@ -266,7 +529,7 @@ boost::asio::awaitable<void> DebugRpcApi::handle_debug_storage_range_at(const nl
 
 // https://github.com/ethereum/retesteth/wiki/RPC-Methods#debug_tracetransaction
 boost::asio::awaitable<void> DebugRpcApi::handle_debug_trace_transaction(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() < 1) {
         auto error_msg = "invalid debug_traceTransaction params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -285,14 +548,14 @@ boost::asio::awaitable<void> DebugRpcApi::handle_debug_trace_transaction(const n
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         const auto tx_with_block = co_await core::read_transaction_by_hash(*context_.block_cache(), tx_database, transaction_hash);
         if (!tx_with_block) {
             std::ostringstream oss;
             oss << "transaction 0x" << transaction_hash << " not found";
             reply = make_json_error(request["id"], -32000, oss.str());
         } else {
-            debug::DebugExecutor executor{*context_.io_context(), tx_database, workers_, config};
+            debug::DebugExecutor executor{*context_.io_context(), tx_database, workers_, config, context_.state_checkpoint_cache().get()};
             const auto result = co_await executor.execute(tx_with_block->block_with_hash.block, tx_with_block->transaction);
 
             if (result.pre_check_error) {
@@ -316,7 +579,7 @@ boost::asio::awaitable<void> DebugRpcApi::handle_debug_trace_transaction(const n
 
 // https://github.com/ethereum/retesteth/wiki/RPC-Methods#debug_tracecall
 boost::asio::awaitable<void> DebugRpcApi::handle_debug_trace_call(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() < 2) {
         auto error_msg = "invalid debug_traceCall params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -335,14 +598,14 @@ boost::asio::awaitable<void> DebugRpcApi::handle_debug_trace_call(const nlohmann
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         ethdb::kv::CachedDatabase cached_database{block_number_or_hash, *tx, *context_.state_cache()};
 
         const auto block_with_hash = co_await core::read_block_by_number_or_hash(*context_.block_cache(), tx_database, block_number_or_hash);
-        const bool is_latest_block = co_await core::is_latest_block_number(block_with_hash.block.header.number, tx_database);
+        const bool is_latest_block = co_await core::is_latest_block_number(block_with_hash->block.header.number, tx_database);
         core::rawdb::DatabaseReader& db_reader = is_latest_block ? (core::rawdb::DatabaseReader&)cached_database : (core::rawdb::DatabaseReader&)tx_database;
         debug::DebugExecutor executor{*context_.io_context(), db_reader, workers_, config};
-        const auto result = co_await executor.execute(block_with_hash.block, call);
+        const auto result = co_await executor.execute(block_with_hash->block, call);
 
         if (result.pre_check_error) {
             reply = make_json_error(request["id"], -32000, result.pre_check_error.value());
@@ -366,7 +629,7 @@ boost::asio::awaitable<void> DebugRpcApi::handle_debug_trace_call(const nlohmann
 
 // https://github.com/ethereum/retesteth/wiki/RPC-Methods#debug_traceblockbynumber
 boost::asio::awaitable<void> DebugRpcApi::handle_debug_trace_block_by_number(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() < 1) {
         auto error_msg = "invalid debug_traceBlockByNumber params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -385,12 +648,12 @@ boost::asio::awaitable<void> DebugRpcApi::handle_debug_trace_block_by_number(con
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_with_hash = co_await core::read_block_by_number(*context_.block_cache(), tx_database, block_number);
 
         debug::DebugExecutor executor{*context_.io_context(), tx_database, workers_, config};
-        const auto debug_traces = co_await executor.execute(block_with_hash.block);
+        const auto debug_traces = co_await executor.execute(block_with_hash->block, database_.get());
 
         reply = make_json_content(request["id"], debug_traces);
     } catch (const std::exception& e) {
@@ -410,7 +673,7 @@ boost::asio::awaitable<void> DebugRpcApi::handle_debug_trace_block_by_number(con
 
 // https://github.com/ethereum/retesteth/wiki/RPC-Methods#debug_traceblockbyhash
 boost::asio::awaitable<void> DebugRpcApi::handle_debug_trace_block_by_hash(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() < 1) {
         auto error_msg = "invalid debug_traceBlockByHash params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -429,12 +692,12 @@ boost::asio::awaitable<void> DebugRpcApi::handle_debug_trace_block_by_hash(const
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_with_hash = co_await core::read_block_by_hash(*context_.block_cache(), tx_database, block_hash);
 
         debug::DebugExecutor executor{*context_.io_context(), tx_database, workers_, config};
-        const auto debug_traces = co_await executor.execute(block_with_hash.block);
+        const auto debug_traces = co_await executor.execute(block_with_hash->block, database_.get());
 
         reply = make_json_content(request["id"], debug_traces);
     } catch (const std::exception& e) {
@@ -452,32 +715,324 @@ boost::asio::awaitable<void> DebugRpcApi::handle_debug_trace_block_by_hash(const
     co_return;
 }
 
-boost::asio::awaitable<std::set<evmc::address>> get_modified_accounts(ethdb::TransactionDatabase& tx_database, uint64_t start_block_number, uint64_t end_block_number) {
+//! Terminate the streamed trace reply: the error replaces the whole reply if nothing has been written yet, otherwise it follows the result
+static boost::asio::awaitable<void> close_trace_stream(json::Stream& stream, debug::DebugStreamWriter& writer, uint32_t request_id,
+        std::string_view result_suffix, int32_t error_code, const std::optional<std::string>& error_msg, std::exception_ptr eptr) {
+    if (stream.failed()) {
+        std::rethrow_exception(eptr);
+    }
+    if (error_msg && !writer.started()) {
+        co_await stream.write_json(make_json_error(request_id, error_code, *error_msg));
+        co_return;
+    }
+    std::string suffix{result_suffix};
+    if (error_msg) {
+        suffix += ",\"error\":" + nlohmann::json{{"code", error_code}, {"message", *error_msg}}.dump();
+    }
+    co_await writer.close(suffix + "}");
+}
+
+static std::string make_result_prefix(uint32_t request_id) {
+    return "{\"id\":" + std::to_string(request_id) + ",\"jsonrpc\":\"2.0\",\"result\":";
+}
+
+// https://github.com/ethereum/retesteth/wiki/RPC-Methods#debug_tracetransaction
+boost::asio::awaitable<void> DebugRpcApi::handle_debug_trace_transaction_stream(const nlohmann::json& request, json::Stream& stream) {
+    const auto& params = request["params"];
+    if (params.size() < 1) {
+        auto error_msg = "invalid debug_traceTransaction params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        co_await stream.write_json(make_json_error(request["id"], 100, error_msg));
+        co_return;
+    }
+    auto transaction_hash = params[0].get<evmc::bytes32>();
+
+    debug::DebugConfig config;
+    if (params.size() > 1) {
+        config = params[1].get<debug::DebugConfig>();
+    }
+
+    SILKRPC_DEBUG << "transaction_hash: " << transaction_hash << " config: {" << config << "}\n";
+    const auto request_id = request["id"].get<uint32_t>();
+
+    auto tx = co_await database_->begin();
+
+    // The struct logs are written while tracing, so once the output has been started any error can just follow it
+    debug::DebugStreamWriter writer{*context_.io_context(), stream, config, make_result_prefix(request_id), &workers_};
+    int32_t error_code{100};
+    std::optional<std::string> error_msg;
+    std::exception_ptr eptr;
+    try {
+        ethdb::MemoizedDatabase tx_database{*tx};
+        const auto tx_with_block = co_await core::read_transaction_by_hash(*context_.block_cache(), tx_database, transaction_hash);
+        if (!tx_with_block) {
+            std::ostringstream oss;
+            oss << "transaction 0x" << transaction_hash << " not found";
+            error_code = -32000;
+            error_msg = oss.str();
+        } else {
+            debug::DebugExecutor executor{*context_.io_context(), tx_database, workers_, config, context_.state_checkpoint_cache().get()};
+            const auto result = co_await executor.execute(tx_with_block->block_with_hash.block, tx_with_block->transaction, writer);
+
+            if (result.pre_check_error) {
+                error_code = -32000;
+                error_msg = result.pre_check_error.value();
+            }
+        }
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
+        error_msg = e.what();
+        eptr = std::current_exception();
+    } catch (...) {
+        SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
+        error_msg = "unexpected exception";
+        eptr = std::current_exception();
+    }
+
+    co_await tx->close(); // RAII not (yet) available with coroutines
+
+    co_await close_trace_stream(stream, writer, request_id, "", error_code, error_msg, eptr);
+}
+
+// https://github.com/ethereum/retesteth/wiki/RPC-Methods#debug_tracecall
+boost::asio::awaitable<void> DebugRpcApi::handle_debug_trace_call_stream(const nlohmann::json& request, json::Stream& stream) {
+    const auto& params = request["params"];
+    if (params.size() < 2) {
+        auto error_msg = "invalid debug_traceCall params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        co_await stream.write_json(make_json_error(request["id"], 100, error_msg));
+        co_return;
+    }
+    const auto call = params[0].get<Call>();
+    const auto block_number_or_hash = params[1].get<BlockNumberOrHash>();
+    debug::DebugConfig config;
+    if (params.size() > 2) {
+        config = params[2].get<debug::DebugConfig>();
+    }
+
+    SILKRPC_DEBUG << "call: " << call << " block_number_or_hash: " << block_number_or_hash << " config: {" << config << "}\n";
+    const auto request_id = request["id"].get<uint32_t>();
+
+    auto tx = co_await database_->begin();
+
+    debug::DebugStreamWriter writer{*context_.io_context(), stream, config, make_result_prefix(request_id), &workers_};
+    int32_t error_code{-32000};
+    std::optional<std::string> error_msg;
+    std::exception_ptr eptr;
+    try {
+        ethdb::MemoizedDatabase tx_database{*tx};
+        ethdb::kv::CachedDatabase cached_database{block_number_or_hash, *tx, *context_.state_cache()};
+
+        const auto block_with_hash = co_await core::read_block_by_number_or_hash(*context_.block_cache(), tx_database, block_number_or_hash);
+        const bool is_latest_block = co_await core::is_latest_block_number(block_with_hash->block.header.number, tx_database);
+        core::rawdb::DatabaseReader& db_reader = is_latest_block ? (core::rawdb::DatabaseReader&)cached_database : (core::rawdb::DatabaseReader&)tx_database;
+        debug::DebugExecutor executor{*context_.io_context(), db_reader, workers_, config};
+        const auto result = co_await executor.execute(block_with_hash->block, call, writer);
+
+        if (result.pre_check_error) {
+            error_msg = result.pre_check_error.value();
+        }
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
+
+        std::ostringstream oss;
+        oss << "block " << block_number_or_hash.number() << "(" << block_number_or_hash.hash() << ") not found";
+        error_msg = oss.str();
+        eptr = std::current_exception();
+    } catch (...) {
+        SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
+        error_code = 100;
+        error_msg = "unexpected exception";
+        eptr = std::current_exception();
+    }
+
+    co_await tx->close(); // RAII not (yet) available with coroutines
+
+    co_await close_trace_stream(stream, writer, request_id, "", error_code, error_msg, eptr);
+}
+
+// https://github.com/ethereum/retesteth/wiki/RPC-Methods#debug_traceblockbynumber
+boost::asio::awaitable<void> DebugRpcApi::handle_debug_trace_block_by_number_stream(const nlohmann::json& request, json::Stream& stream) {
+    const auto& params = request["params"];
+    if (params.size() < 1) {
+        auto error_msg = "invalid debug_traceBlockByNumber params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        co_await stream.write_json(make_json_error(request["id"], 100, error_msg));
+        co_return;
+    }
+    const auto block_number = params[0].get<std::uint64_t>();
+
+    debug::DebugConfig config;
+    if (params.size() > 1) {
+        config = params[1].get<debug::DebugConfig>();
+    }
+
+    SILKRPC_DEBUG << "block_number: " << block_number << " config: {" << config << "}\n";
+    const auto request_id = request["id"].get<uint32_t>();
+
+    auto tx = co_await database_->begin();
+
+    debug::DebugStreamWriter writer{*context_.io_context(), stream, config, make_result_prefix(request_id) + "[", &workers_};
+    int32_t error_code{-32000};
+    std::optional<std::string> error_msg;
+    std::exception_ptr eptr;
+    try {
+        ethdb::MemoizedDatabase tx_database{*tx};
+
+        const auto block_with_hash = co_await core::read_block_by_number(*context_.block_cache(), tx_database, block_number);
+
+        debug::DebugExecutor executor{*context_.io_context(), tx_database, workers_, config};
+        co_await executor.execute(block_with_hash->block, writer, database_.get());
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
+
+        std::ostringstream oss;
+        oss << "block_number " << block_number << " not found";
+        error_msg = oss.str();
+        eptr = std::current_exception();
+    } catch (...) {
+        SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
+        error_code = 100;
+        error_msg = "unexpected exception";
+        eptr = std::current_exception();
+    }
+
+    co_await tx->close(); // RAII not (yet) available with coroutines
+
+    co_await close_trace_stream(stream, writer, request_id, "]", error_code, error_msg, eptr);
+}
+
+// https://github.com/ethereum/retesteth/wiki/RPC-Methods#debug_traceblockbyhash
+boost::asio::awaitable<void> DebugRpcApi::handle_debug_trace_block_by_hash_stream(const nlohmann::json& request, json::Stream& stream) {
+    const auto& params = request["params"];
+    if (params.size() < 1) {
+        auto error_msg = "invalid debug_traceBlockByHash params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        co_await stream.write_json(make_json_error(request["id"], 100, error_msg));
+        co_return;
+    }
+    const auto block_hash = params[0].get<evmc::bytes32>();
+
+    debug::DebugConfig config;
+    if (params.size() > 1) {
+        config = params[1].get<debug::DebugConfig>();
+    }
+
+    SILKRPC_DEBUG << "block_hash: " << block_hash << " config: {" << config << "}\n";
+    const auto request_id = request["id"].get<uint32_t>();
+
+    auto tx = co_await database_->begin();
+
+    debug::DebugStreamWriter writer{*context_.io_context(), stream, config, make_result_prefix(request_id) + "[", &workers_};
+    int32_t error_code{-32000};
+    std::optional<std::string> error_msg;
+    std::exception_ptr eptr;
+    try {
+        ethdb::MemoizedDatabase tx_database{*tx};
+
+        const auto block_with_hash = co_await core::read_block_by_hash(*context_.block_cache(), tx_database, block_hash);
+
+        debug::DebugExecutor executor{*context_.io_context(), tx_database, workers_, config};
+        co_await executor.execute(block_with_hash->block, writer, database_.get());
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
+
+        std::ostringstream oss;
+        oss << "block_hash " << block_hash << " not found";
+        error_msg = oss.str();
+        eptr = std::current_exception();
+    } catch (...) {
+        SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
+        error_code = 100;
+        error_msg = "unexpected exception";
+        eptr = std::current_exception();
+    }
+
+    co_await tx->close(); // RAII not (yet) available with coroutines
+
+    co_await close_trace_stream(stream, writer, request_id, "]", error_code, error_msg, eptr);
+}
+
+// Walk the account changes in the block range, appending the changed addresses in ascending order without duplicates
+static boost::asio::awaitable<void> walk_modified_accounts(const core::rawdb::DatabaseReader& tx_database, uint64_t start_block_number,
+    uint64_t end_block_number, std::vector<evmc::address>& addresses) {
+    core::rawdb::Walker walker = [&](const silkworm::Bytes& key, const silkworm::Bytes& value) {
+        const auto block_number = silkworm::endian::load_big_u64(key.data());
+        if (block_number > end_block_number) {
+            return false;
+        }
+        addresses.push_back(silkworm::to_evmc_address(silkworm::ByteView{value}.substr(0, silkworm::kAddressLength)));
+
+        SILKRPC_TRACE << "Walker: processing block " << block_number << " address 0x" << silkworm::to_hex(addresses.back()) << "\n";
+        return true;
+    };
+
+    const auto key = silkworm::db::block_key(start_block_number);
+    SILKRPC_TRACE << "Ready to walk starting from key: " << silkworm::to_hex(key) << "\n";
+
+    const auto first_added = addresses.size();
+    co_await tx_database.walk(db::table::kPlainAccountChangeSet, key, 0, walker);
+
+    std::sort(addresses.begin() + first_added, addresses.end());
+    addresses.erase(std::unique(addresses.begin() + first_added, addresses.end()), addresses.end());
+}
+
+boost::asio::awaitable<std::vector<evmc::address>> get_modified_accounts(const core::rawdb::DatabaseReader& tx_database, uint64_t start_block_number,
+    uint64_t end_block_number, ethdb::Database* database, uint64_t blocks_per_chunk) {
     const auto latest_block_number = co_await core::get_block_number(core::kLatestBlockId, tx_database);
 
     SILKRPC_DEBUG << "latest: " << latest_block_number << " start: " << start_block_number << " end: " << end_block_number << "\n";
 
-    std::set<evmc::address> addresses;
+    std::vector<evmc::address> addresses;
     if (start_block_number > latest_block_number) {
         std::stringstream msg;
         msg << "start block (" << start_block_number << ") is later than the latest block (" << latest_block_number << ")";
         throw std::invalid_argument(msg.str());
     } else if (start_block_number <= end_block_number) {
-        core::rawdb::Walker walker = [&](const silkworm::Bytes& key, const silkworm::Bytes& value) {
-            auto block_number = std::stol(silkworm::to_hex(key), 0, 16);
-            if (block_number <= end_block_number) {
-                auto address = silkworm::to_evmc_address(value.substr(0, silkworm::kAddressLength));
+        // The chunks split the range up to the latest block, the last one extending to the end block (if later)
+        const auto num_blocks = std::min(end_block_number, latest_block_number) - start_block_number + 1;
+        if (database == nullptr || blocks_per_chunk == 0 || num_blocks <= blocks_per_chunk) {
+            co_await walk_modified_accounts(tx_database, start_block_number, end_block_number, addresses);
+            co_return addresses;
+        }
 
-                SILKRPC_TRACE << "Walker: processing block " << block_number << " address 0x" << silkworm::to_hex(address) << "\n";
-                addresses.insert(address);
+        // Walk the chunks concurrently, each one within its own transaction, then merge their sorted addresses
+        const auto num_chunks = (num_blocks + blocks_per_chunk - 1) / blocks_per_chunk;
+        std::vector<std::vector<evmc::address>> chunk_addresses(num_chunks);
+        const auto executor = co_await boost::asio::this_coro::executor;
+        co_await parallel_for(executor, num_chunks, kModifiedAccountsMaxConcurrentChunks, [&](std::size_t chunk) -> boost::asio::awaitable<void> {
+            const auto chunk_start = start_block_number + chunk * blocks_per_chunk;
+            const auto chunk_end = chunk + 1 == num_chunks ? end_block_number : chunk_start + blocks_per_chunk - 1;
+            auto chunk_tx = co_await database->begin();
+            std::exception_ptr chunk_exception;
+            try {
+                ethdb::TransactionDatabase chunk_database{*chunk_tx};
+                co_await walk_modified_accounts(chunk_database, chunk_start, chunk_end, chunk_addresses[chunk]);
+            } catch (...) {
+                chunk_exception = std::current_exception();
             }
-            return block_number <= end_block_number;
-        };
-
-        const auto key = silkworm::db::block_key(start_block_number);
-        SILKRPC_TRACE << "Ready to walk starting from key: " << silkworm::to_hex(key) << "\n";
-
-        co_await tx_database.walk(db::table::kPlainAccountChangeSet, key, 0, walker);
+            co_await chunk_tx->close(); // RAII not (yet) available with coroutines
+            if (chunk_exception) {
+                std::rethrow_exception(chunk_exception);
+            }
+        });
+
+        // Merge the sorted chunks pairwise, so that each address is moved just O(log(num_chunks)) times
+        while (chunk_addresses.size() > 1) {
+            std::vector<std::vector<evmc::address>> merged_addresses((chunk_addresses.size() + 1) / 2);
+            for (std::size_t i{0}; i < merged_addresses.size(); ++i) {
+                auto& left = chunk_addresses[2 * i];
+                if (2 * i + 1 == chunk_addresses.size()) {
+                    merged_addresses[i] = std::move(left);
+                    continue;
+                }
+                const auto& right = chunk_addresses[2 * i + 1];
+                merged_addresses[i].reserve(left.size() + right.size());
+                std::set_union(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(merged_addresses[i]));
+            }
+            chunk_addresses = std::move(merged_addresses);
+        }
+        addresses = std::move(chunk_addresses.front());
     }
 
     co_return addresses;
@@ -17,8 +17,11 @@
 #ifndef SILKRPC_COMMANDS_DEBUG_API_HPP_
 #define SILKRPC_COMMANDS_DEBUG_API_HPP_
 
+#include <cstdint>
 #include <memory>
-#include <set>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include <silkrpc/config.hpp> // NOLINT(build/include_order)
 
@@ -27,11 +30,14 @@
 #include <boost/asio/thread_pool.hpp>
 #include <nlohmann/json.hpp>
 
+#include <silkrpc/common/constants.hpp>
 #include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/core/account_range_sessions.hpp>
 #include <silkrpc/core/rawdb/accessors.hpp>
 #include <silkrpc/json/types.hpp>
 #include <silkrpc/ethdb/database.hpp>
 #include <silkrpc/ethdb/transaction_database.hpp>
+#include <silkrpc/json/stream.hpp>
 
 namespace silkrpc::http { class RequestHandler; }
 
@@ -52,13 +58,28 @@ protected:
     boost::asio::awaitable<void> handle_debug_account_range(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_debug_get_modified_accounts_by_number(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_debug_get_modified_accounts_by_hash(const nlohmann::json& request, nlohmann::json& reply);
+    boost::asio::awaitable<void> handle_debug_get_modified_accounts_by_number_stream(const nlohmann::json& request, json::Stream& stream);
+    boost::asio::awaitable<void> handle_debug_get_modified_accounts_by_hash_stream(const nlohmann::json& request, json::Stream& stream);
     boost::asio::awaitable<void> handle_debug_storage_range_at(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_debug_trace_transaction(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_debug_trace_call(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_debug_trace_block_by_number(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_debug_trace_block_by_hash(const nlohmann::json& request, nlohmann::json& reply);
 
+    boost::asio::awaitable<void> handle_debug_account_range_stream(const nlohmann::json& request, json::Stream& stream);
+    boost::asio::awaitable<void> handle_debug_trace_transaction_stream(const nlohmann::json& request, json::Stream& stream);
+    boost::asio::awaitable<void> handle_debug_trace_call_stream(const nlohmann::json& request, json::Stream& stream);
+    boost::asio::awaitable<void> handle_debug_trace_block_by_number_stream(const nlohmann::json& request, json::Stream& stream);
+    boost::asio::awaitable<void> handle_debug_trace_block_by_hash_stream(const nlohmann::json& request, json::Stream& stream);
+
 private:
+    //! Open the session of the debug_accountRange page, continuing the one parked with the token if the page continues it
+    boost::asio::awaitable<AccountRangeSessionPtr> open_account_range_session(const std::optional<std::string>& token,
+        const evmc::address& start_address, bool exclude_code, bool exclude_storage);
+
+    //! Park the session until its next page returning its token if continuable and not done, otherwise close it
+    boost::asio::awaitable<std::optional<std::string>> release_account_range_session(AccountRangeSessionPtr session, bool continuable);
+
     Context& context_;
     std::unique_ptr<ethdb::Database>& database_;
     std::unique_ptr<txpool::TransactionPool>& tx_pool_;
@@ -67,7 +88,10 @@ private:
     friend class silkrpc::http::RequestHandler;
 };
 
-boost::asio::awaitable<std::set<evmc::address>> get_modified_accounts(ethdb::TransactionDatabase& tx_database, uint64_t start_block_number, uint64_t end_block_number);
+//! Return the accounts changed in the block range in ascending order. If the database is specified, wide ranges are split in chunks
+//! of blocks walked concurrently each one within its own transaction, otherwise the range is walked within the given transaction
+boost::asio::awaitable<std::vector<evmc::address>> get_modified_accounts(const core::rawdb::DatabaseReader& tx_database, uint64_t start_block_number,
+    uint64_t end_block_number, ethdb::Database* database = nullptr, uint64_t blocks_per_chunk = kModifiedAccountsBlocksPerChunk);
 
 } // namespace silkrpc::commands
 
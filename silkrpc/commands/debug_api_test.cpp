@@ -16,6 +16,7 @@
 
 #include "debug_api.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 #include <string>
 
@@ -202,7 +203,8 @@ TEST_CASE("DebugRpcApi") {
     ChannelFactory create_channel = []() {
         return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials());
     };
-    Context context{create_channel, std::make_shared<BlockCache>(), std::make_shared<ethdb::kv::CoherentStateCache>()};
+    Context context{create_channel, std::make_shared<BlockCache>(), std::make_shared<ReceiptCache>(), std::make_shared<ethdb::kv::CoherentStateCache>(),
+        std::make_shared<AccessHistory>()};
     boost::asio::thread_pool workers{1};
 
     SECTION("CTOR") {
@@ -406,6 +408,29 @@ TEST_CASE("get_modified_accounts") {
         ])"_json);
     }
 
+    SECTION("end >> start, concurrent chunks") {
+        auto serial_result = boost::asio::co_spawn(pool, get_modified_accounts(tx_database, 0x52a010, 0x52a058), boost::asio::use_future);
+        const auto serial_accounts = serial_result.get();
+
+        auto result = boost::asio::co_spawn(pool, get_modified_accounts(tx_database, 0x52a010, 0x52a058, &database, 8), boost::asio::use_future);
+        const auto accounts = result.get();
+
+        CHECK(accounts.size() == 70);
+        CHECK(accounts == serial_accounts);
+        CHECK(std::is_sorted(accounts.begin(), accounts.end()));
+    }
+
+    SECTION("end > last block, concurrent chunks") {
+        auto serial_result = boost::asio::co_spawn(pool, get_modified_accounts(tx_database, 0x52a010, 0x52a070), boost::asio::use_future);
+        const auto serial_accounts = serial_result.get();
+
+        auto result = boost::asio::co_spawn(pool, get_modified_accounts(tx_database, 0x52a010, 0x52a070, &database, 16), boost::asio::use_future);
+        const auto accounts = result.get();
+
+        CHECK(accounts.size() == serial_accounts.size());
+        CHECK(accounts == serial_accounts);
+    }
+
     SECTION("start > end") {
         auto result = boost::asio::co_spawn(pool, get_modified_accounts(tx_database, 0x52a011, 0x52a010), boost::asio::use_future);
         auto accounts = result.get();
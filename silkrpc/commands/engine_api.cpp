@@ -23,6 +23,7 @@
 
 #include <silkrpc/core/rawdb/chain.hpp>
 #include <silkrpc/types/execution_payload.hpp>
+#include <silkrpc/ethdb/memoized_database.hpp>
 #include <silkrpc/ethdb/transaction_database.hpp>
 
 namespace silkrpc::commands {
@@ -62,7 +63,7 @@ boost::asio::awaitable<void> EngineRpcApi::handle_engine_get_payload_v1(const nl
 // Format for params is a JSON object ie [ExecutionPayload]
 // https://github.com/ethereum/execution-apis/blob/main/src/engine/specification.md#engine_newpayloadv1
 boost::asio::awaitable<void> EngineRpcApi::handle_engine_new_payload_v1(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request.at("params");
+    const auto& params = request.at("params");
 
     if (params.size() != 1) {
         auto error_msg = "invalid engine_newPayloadV1 params: " + params.dump();
@@ -73,8 +74,8 @@ boost::asio::awaitable<void> EngineRpcApi::handle_engine_new_payload_v1(const nl
     #ifndef BUILD_COVERAGE
     try {
     #endif
-        const auto payload = params[0].get<ExecutionPayload>();
-        auto new_payload = co_await backend_->engine_new_payload_v1(payload);
+        // Decode the payload straight into the backend request, no copy of its transactions being made on the way
+        auto new_payload = co_await backend_->engine_new_payload_v1_json(params[0]);
         reply = make_json_content(request["id"], new_payload);
     #ifndef BUILD_COVERAGE
     } catch (const boost::system::system_error& se) {
@@ -167,10 +168,10 @@ boost::asio::awaitable<void> EngineRpcApi::handle_engine_exchange_transition_con
     #ifndef BUILD_COVERAGE
     try {
     #endif
-        ethdb::TransactionDatabase tx_database{*tx};
-        const auto chain_config{co_await core::rawdb::read_chain_config(tx_database)};
-        SILKRPC_DEBUG << "chain config: " << chain_config << "\n";
-        auto config = silkworm::ChainConfig::from_json(chain_config.config).value();
+        ethdb::MemoizedDatabase tx_database{*tx};
+        const auto parsed_chain_config{co_await core::rawdb::read_parsed_chain_config(tx_database)};
+        SILKRPC_DEBUG << "chain config: " << parsed_chain_config->chain_config << "\n";
+        const auto& config = parsed_chain_config->silkworm_config.value();
         // CL will always pass in 0 as the terminal block number
         if (cl_configuration.terminal_block_number != 0) {
             SILKRPC_ERROR << "consensus layer has the wrong terminal block number expected zero but instead got: "
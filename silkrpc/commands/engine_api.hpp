@@ -20,6 +20,8 @@
 #include <memory>
 #include <vector>
 
+#include <silkrpc/config.hpp>
+
 #include <boost/asio/awaitable.hpp>
 #include <boost/asio/thread_pool.hpp>
 #include <nlohmann/json.hpp>
@@ -17,6 +17,9 @@
 #include "erigon_api.hpp"
 
 #include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -26,12 +29,14 @@
 #include <silkrpc/common/constants.hpp>
 #include <silkrpc/common/log.hpp>
 #include <silkrpc/common/util.hpp>
-#include <silkrpc/consensus/ethash.hpp>
 #include <silkrpc/core/blocks.hpp>
 #include <silkrpc/core/cached_chain.hpp>
+#include <silkrpc/core/issuance.hpp>
 #include <silkrpc/core/receipts.hpp>
 #include <silkrpc/core/rawdb/chain.hpp>
+#include <silkrpc/core/state_reader.hpp>
 #include <silkrpc/ethdb/kv/cached_database.hpp>
+#include <silkrpc/ethdb/memoized_database.hpp>
 #include <silkrpc/ethdb/transaction_database.hpp>
 #include <silkrpc/json/types.hpp>
 #include <silkworm/common/binary_search.hpp>
@@ -39,16 +44,20 @@
 
 namespace silkrpc::commands {
 
+//! The number of concurrent header probes at each step of the block search by timestamp
+constexpr std::size_t kBlockByTimestampProbes{4};
+
 ErigonRpcApi::ErigonRpcApi(Context& context)
     : database_(context.database()),
       context_(context),
       block_cache_(context.block_cache()),
+      receipt_cache_(context.receipt_cache()),
       state_cache_(context.state_cache()) {}
 
 // https://eth.wiki/json-rpc/API#erigon_getBlockByTimestamp
 boost::asio::awaitable<void> ErigonRpcApi::handle_erigon_get_block_by_timestamp(const nlohmann::json& request, nlohmann::json& reply) {
     // Decode request parameters
-    const auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 2) {
         auto error_msg = "invalid erigon_getBlockByTimestamp params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -67,38 +76,25 @@ boost::asio::awaitable<void> ErigonRpcApi::handle_erigon_get_block_by_timestamp(
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
-        // Lookup the first and last block headers
-        const auto first_header = co_await core::rawdb::read_header_by_number(tx_database, core::kEarliestBlockNumber);
-        const auto current_header = co_await core::rawdb::read_current_header(tx_database);
-        const uint64_t current_block_number = current_header.number;
+        // Find the block locally in the timestamp index, if enabled and covering the timestamp
+        std::optional<uint64_t> indexed_block_number;
+        if (context_.timestamp_index()) {
+            indexed_block_number = context_.timestamp_index()->find_block(timestamp);
+        }
 
-        // Find the lowest block header w/ timestamp greater or equal to provided timestamp
         uint64_t block_number;
-        if (current_header.timestamp <= timestamp) {
-            block_number = current_block_number;
-        } else if (first_header.timestamp >= timestamp) {
-            block_number = core::kEarliestBlockNumber;
+        if (indexed_block_number) {
+            block_number = *indexed_block_number;
         } else {
-            // Good-ol' binary search to find the lowest block header matching timestamp
-            const auto matching_block_number = co_await binary_search(current_block_number, [&](uint64_t i) -> boost::asio::awaitable<bool> {
-                const auto header = co_await core::rawdb::read_header_by_number(tx_database, i);
-                co_return header.timestamp >= timestamp;
-            });
-            // TODO(canepat) we should try to avoid this block header lookup (just done in search)
-            const auto matching_header = co_await core::rawdb::read_header_by_number(tx_database, matching_block_number);
-            if (matching_header.timestamp > timestamp) {
-                block_number = matching_block_number - 1;
-            } else {
-                block_number = matching_block_number;
-            }
+            block_number = co_await search_block_by_timestamp(tx_database, timestamp);
         }
 
         // Lookup and return the matching block
         const auto block_with_hash = co_await core::read_block_by_number(*block_cache_, tx_database, block_number);
-        const auto total_difficulty = co_await core::rawdb::read_total_difficulty(tx_database, block_with_hash.hash, block_number);
-        const Block extended_block{block_with_hash, total_difficulty, full_tx};
+        const auto total_difficulty = co_await core::rawdb::read_total_difficulty(tx_database, block_with_hash->hash, block_number);
+        const Block extended_block{*block_with_hash, total_difficulty, full_tx, block_cache_->hashes(*block_with_hash)};
 
         reply = make_json_content(request["id"], extended_block);
     } catch (const std::exception& e) {
@@ -114,9 +110,59 @@ boost::asio::awaitable<void> ErigonRpcApi::handle_erigon_get_block_by_timestamp(
     co_return;
 }
 
+boost::asio::awaitable<uint64_t> ErigonRpcApi::search_block_by_timestamp(core::rawdb::DatabaseReader& db_reader, uint64_t timestamp) {
+    // Lookup the first and last block headers
+    const auto first_header = co_await core::rawdb::read_header_by_number(db_reader, core::kEarliestBlockNumber);
+    const auto current_header = co_await core::rawdb::read_current_header(db_reader);
+    const uint64_t current_block_number = current_header.number;
+
+    // Find the lowest block header w/ timestamp greater or equal to provided timestamp
+    uint64_t block_number;
+    if (current_header.timestamp <= timestamp) {
+        block_number = current_block_number;
+    } else if (first_header.timestamp >= timestamp) {
+        block_number = core::kEarliestBlockNumber;
+    } else {
+        // K-ary search to find the lowest block header matching timestamp, each probe slot but the first one within its own
+        // transaction (concurrent reads within the same transaction are not supported)
+        std::vector<std::unique_ptr<ethdb::Transaction>> probe_txs;
+        std::vector<std::unique_ptr<ethdb::TransactionDatabase>> probe_databases;
+        std::exception_ptr search_exception;
+        uint64_t matching_block_number{0};
+        try {
+            for (std::size_t slot{1}; slot < kBlockByTimestampProbes; ++slot) {
+                probe_txs.push_back(co_await database_->begin());
+                probe_databases.push_back(std::make_unique<ethdb::TransactionDatabase>(*probe_txs.back()));
+            }
+            matching_block_number = co_await kary_search(current_block_number, kBlockByTimestampProbes,
+                [&](std::size_t slot, std::size_t i) -> boost::asio::awaitable<bool> {
+                    const core::rawdb::DatabaseReader& probe_reader = slot == 0 ? db_reader : *probe_databases[slot - 1];
+                    const auto header = co_await core::rawdb::read_header_by_number(probe_reader, i);
+                    co_return header.timestamp >= timestamp;
+                });
+        } catch (...) {
+            search_exception = std::current_exception();
+        }
+        for (auto& probe_tx : probe_txs) {
+            co_await probe_tx->close(); // RAII not (yet) available with coroutines
+        }
+        if (search_exception) {
+            std::rethrow_exception(search_exception);
+        }
+        // TODO(canepat) we should try to avoid this block header lookup (just done in search)
+        const auto matching_header = co_await core::rawdb::read_header_by_number(db_reader, matching_block_number);
+        if (matching_header.timestamp > timestamp) {
+            block_number = matching_block_number - 1;
+        } else {
+            block_number = matching_block_number;
+        }
+    }
+    co_return block_number;
+}
+
 // https://eth.wiki/json-rpc/API#erigon_getHeaderByHash
 boost::asio::awaitable<void> ErigonRpcApi::handle_erigon_get_header_by_hash(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 1) {
         auto error_msg = "invalid erigon_getHeaderByHash params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -129,11 +175,16 @@ boost::asio::awaitable<void> ErigonRpcApi::handle_erigon_get_header_by_hash(cons
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
-        const auto header{co_await core::rawdb::read_header_by_hash(tx_database, block_hash)};
-
-        reply = make_json_content(request["id"], header);
+        const auto& header_cache = context_.header_cache();
+        if (header_cache) {
+            const auto header{co_await core::read_header_by_hash(*header_cache, tx_database, block_hash)};
+            reply = make_json_content(request["id"], *header);
+        } else {
+            const auto header{co_await core::rawdb::read_header_by_hash(tx_database, block_hash)};
+            reply = make_json_content(request["id"], header);
+        }
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
         reply = make_json_error(request["id"], 100, e.what());
@@ -148,7 +199,7 @@ boost::asio::awaitable<void> ErigonRpcApi::handle_erigon_get_header_by_hash(cons
 
 // https://eth.wiki/json-rpc/API#erigon_getHeaderByNumber
 boost::asio::awaitable<void> ErigonRpcApi::handle_erigon_get_header_by_number(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 1) {
         auto error_msg = "invalid erigon_getHeaderByNumber params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -169,12 +220,17 @@ boost::asio::awaitable<void> ErigonRpcApi::handle_erigon_get_header_by_number(co
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_number = co_await core::get_block_number(block_id, tx_database);
-        const auto header{co_await core::rawdb::read_header_by_number(tx_database, block_number)};
-
-        reply = make_json_content(request["id"], header);
+        const auto& header_cache = context_.header_cache();
+        if (header_cache) {
+            const auto header{co_await core::read_header_by_number(*header_cache, tx_database, block_number)};
+            reply = make_json_content(request["id"], *header);
+        } else {
+            const auto header{co_await core::rawdb::read_header_by_number(tx_database, block_number)};
+            reply = make_json_content(request["id"], header);
+        }
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
         reply = make_json_error(request["id"], 100, e.what());
@@ -189,7 +245,7 @@ boost::asio::awaitable<void> ErigonRpcApi::handle_erigon_get_header_by_number(co
 
 // https://eth.wiki/json-rpc/API#erigon_getlogsbyhash
 boost::asio::awaitable<void> ErigonRpcApi::handle_erigon_get_logs_by_hash(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 1) {
         auto error_msg = "invalid erigon_getHeaderByHash params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -202,15 +258,15 @@ boost::asio::awaitable<void> ErigonRpcApi::handle_erigon_get_logs_by_hash(const
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_with_hash = co_await core::read_block_by_hash(*block_cache_, tx_database, block_hash);
-        const auto receipts{co_await core::get_receipts(tx_database, block_with_hash)};
+        const auto receipts{co_await core::get_receipts(*receipt_cache_, tx_database, *block_with_hash)};
 
-        SILKRPC_DEBUG << "receipts.size(): " << receipts.size() << "\n";
+        SILKRPC_DEBUG << "receipts.size(): " << receipts->size() << "\n";
         std::vector<Logs> logs{};
-        logs.reserve(receipts.size());
-        for (const auto receipt : receipts) {
+        logs.reserve(receipts->size());
+        for (const auto& receipt : *receipts) {
             SILKRPC_DEBUG << "receipt.logs.size(): " << receipt.logs.size() << "\n";
             logs.push_back(receipt.logs);
         }
@@ -234,12 +290,12 @@ boost::asio::awaitable<void> ErigonRpcApi::handle_erigon_forks(const nlohmann::j
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
-        const auto chain_config{co_await silkrpc::core::rawdb::read_chain_config(tx_database)};
-        SILKRPC_DEBUG << "chain config: " << chain_config << "\n";
+        const auto chain_config{co_await silkrpc::core::rawdb::read_parsed_chain_config(tx_database)};
+        SILKRPC_DEBUG << "chain config: " << chain_config->chain_config << "\n";
 
-        Forks forks{chain_config};
+        Forks forks{*chain_config};
 
         reply = make_json_content(request["id"], forks);
     } catch (const std::exception& e) {
@@ -254,9 +310,89 @@ boost::asio::awaitable<void> ErigonRpcApi::handle_erigon_forks(const nlohmann::j
     co_return;
 }
 
+// Read the balance, nonce and code of many accounts at the same block with one transaction, reading all the accounts together
+// and then all their distinct codes together instead of one eth_getBalance, eth_getTransactionCount and eth_getCode each
+boost::asio::awaitable<void> ErigonRpcApi::handle_erigon_get_accounts(const nlohmann::json& request, nlohmann::json& reply) {
+    const auto& params = request["params"];
+    if (params.size() != 2 || !params[0].is_array()) {
+        auto error_msg = "invalid erigon_getAccounts params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        reply = make_json_error(request["id"], 100, error_msg);
+        co_return;
+    }
+    const auto addresses = params[0].get<std::vector<evmc::address>>();
+    const auto block_id = params[1].get<std::string>();
+    SILKRPC_DEBUG << "#addresses: " << addresses.size() << " block_id: " << block_id << "\n";
+    if (addresses.size() > kGetAccountsMaxAddresses) {
+        auto error_msg = "too many erigon_getAccounts addresses: " + std::to_string(addresses.size()) + " max: " +
+            std::to_string(kGetAccountsMaxAddresses);
+        SILKRPC_ERROR << error_msg << "\n";
+        reply = make_json_error(request["id"], -32602, error_msg);
+        co_return;
+    }
+
+    auto tx = co_await database_->begin();
+
+    try {
+        ethdb::MemoizedDatabase tx_database{*tx};
+        ethdb::kv::CachedDatabase cached_database{BlockNumberOrHash{block_id}, *tx, *state_cache_};
+        const auto [block_number, is_latest_block] = co_await core::get_block_number(block_id, tx_database, /*latest_required=*/true);
+
+        StateReader state_reader(is_latest_block ? (core::rawdb::DatabaseReader&)cached_database : (core::rawdb::DatabaseReader&)tx_database,
+            context_.history_cache());
+        const auto accounts{co_await state_reader.read_accounts(addresses, block_number + 1)};
+
+        // The code shared among all the executions is looked up first, the missing one is read all together
+        auto& code_cache = context_.code_cache();
+        std::vector<std::shared_ptr<const silkworm::Bytes>> codes(accounts.size());
+        std::vector<std::size_t> missing_indexes;
+        std::vector<evmc::bytes32> missing_hashes;
+        for (std::size_t i{0}; i < accounts.size(); ++i) {
+            if (!accounts[i] || accounts[i]->code_hash == silkworm::kEmptyHash) {
+                continue;
+            }
+            codes[i] = code_cache ? code_cache->get(accounts[i]->code_hash) : nullptr;
+            if (!codes[i]) {
+                missing_indexes.push_back(i);
+                missing_hashes.push_back(accounts[i]->code_hash);
+            }
+        }
+        auto missing_codes{co_await state_reader.read_codes(missing_hashes)};
+        for (std::size_t j{0}; j < missing_codes.size(); ++j) {
+            auto code{std::make_shared<const silkworm::Bytes>(std::move(missing_codes[j]))};
+            if (code_cache && !code->empty()) {
+                code_cache->insert(missing_hashes[j], code);
+            }
+            codes[missing_indexes[j]] = std::move(code);
+        }
+
+        nlohmann::json result = nlohmann::json::array();
+        for (std::size_t i{0}; i < addresses.size(); ++i) {
+            const auto& account = accounts[i];
+            nlohmann::json entry;
+            entry["address"] = addresses[i];
+            entry["balance"] = to_quantity(account ? account->balance : intx::uint256{0});
+            entry["nonce"] = to_quantity(account ? account->nonce : 0);
+            entry["codeHash"] = account ? account->code_hash : silkworm::kEmptyHash;
+            entry["code"] = "0x" + (codes[i] ? silkworm::to_hex(*codes[i]) : "");
+            result.push_back(std::move(entry));
+        }
+        reply = make_json_content(request["id"], result);
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], 100, e.what());
+    } catch (...) {
+        SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], 100, "unexpected exception");
+    }
+
+    co_await tx->close(); // RAII not (yet) available with coroutines
+    co_return;
+}
+
 // https://eth.wiki/json-rpc/API#erigon_WatchTheBurn
 boost::asio::awaitable<void> ErigonRpcApi::handle_erigon_watch_the_burn(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 1) {
         auto error_msg = "invalid erigon_watchTheBurn params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -269,47 +405,33 @@ boost::asio::awaitable<void> ErigonRpcApi::handle_erigon_watch_the_burn(const nl
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
-        const auto chain_config{co_await silkrpc::core::rawdb::read_chain_config(tx_database)};
-        SILKRPC_DEBUG << "chain config: " << chain_config << "\n";
+        const auto chain_config{co_await silkrpc::core::rawdb::read_parsed_chain_config(tx_database)};
+        SILKRPC_DEBUG << "chain config: " << chain_config->chain_config << "\n";
 
         Issuance issuance{}; // default is empty: no PoW => no issuance
-        if (chain_config.config.count("ethash") != 0) {
+        if (core::has_issuance(chain_config->chain_config)) {
             const auto block_number = co_await core::get_block_number(block_id, tx_database);
-            const auto block_with_hash{co_await core::rawdb::read_block_by_number(tx_database, block_number)};
-            const auto block_reward{ethash::compute_reward(chain_config, block_with_hash.block)};
-            intx::uint256 total_ommer_reward = 0;
-            for (const auto ommer_reward :  block_reward.ommer_rewards) {
-                total_ommer_reward += ommer_reward;
+            // Compute the block issuance and fees unless already done when the block arrived
+            std::optional<BlockIssuance> block_issuance;
+            if (context_.issuance_index()) {
+                block_issuance = context_.issuance_index()->find(block_number);
             }
-            intx::uint256 block_issuance = block_reward.miner_reward + total_ommer_reward;
-            issuance.block_reward = "0x" + intx::hex(block_reward.miner_reward);
-            issuance.ommer_reward = "0x" + intx::hex(total_ommer_reward);
-            issuance.issuance = "0x" + intx::hex(block_issuance);
-            intx::uint256 burnt;
-            if (block_with_hash.block.header.base_fee_per_gas) {
-               burnt = *block_with_hash.block.header.base_fee_per_gas * block_with_hash.block.header.gas_used;
-            } else {
-               burnt = 0;
+            if (!block_issuance) {
+                block_issuance = co_await core::read_block_issuance(*chain_config, tx_database, block_number);
             }
-            issuance.burnt = "0x" + intx::hex(burnt);
+            issuance.block_reward = "0x" + intx::hex(block_issuance->block_reward);
+            issuance.ommer_reward = "0x" + intx::hex(block_issuance->ommer_reward);
+            issuance.issuance = "0x" + intx::hex(block_issuance->issuance());
+            issuance.burnt = "0x" + intx::hex(block_issuance->burnt);
 
             const auto total_issued = co_await core::rawdb::read_total_issued(tx_database, block_number);
             const auto total_burnt = co_await core::rawdb::read_total_burnt(tx_database, block_number);
 
             issuance.total_issued = "0x" + intx::hex(total_issued);
             issuance.total_burnt = "0x" + intx::hex(total_burnt);
-            intx::uint256 tips = 0;
-            if (block_with_hash.block.header.base_fee_per_gas) {
-               const auto receipts{co_await core::get_receipts(tx_database, block_with_hash)};
-               const auto block{block_with_hash.block};
-               for (size_t i{0}; i < block.transactions.size(); i++) {
-                  auto tip = block.transactions[i].effective_gas_price(block.header.base_fee_per_gas.value_or(0));
-                  tips += tip * receipts[i].gas_used;
-               }
-            }
-            issuance.tips = "0x" + intx::hex(tips);
+            issuance.tips = "0x" + intx::hex(block_issuance->tips);
         }
         reply = make_json_content(request["id"], issuance);
     } catch (const std::exception& e) {
@@ -327,7 +449,7 @@ boost::asio::awaitable<void> ErigonRpcApi::handle_erigon_watch_the_burn(const nl
 
 // https://eth.wiki/json-rpc/API#erigon_blockNumber
 boost::asio::awaitable<void> ErigonRpcApi::handle_erigon_block_number(const nlohmann::json& request, nlohmann::json& reply) {
-    const auto params = request["params"];
+    const auto& params = request["params"];
     std::string block_id;
     if (params.size() == 0) {
         block_id = core::kLatestExecutedBlockId;
@@ -344,7 +466,7 @@ boost::asio::awaitable<void> ErigonRpcApi::handle_erigon_block_number(const nloh
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_number{co_await core::get_block_number_by_tag(block_id, tx_database)};
 
@@ -49,11 +49,16 @@ protected:
     boost::asio::awaitable<void> handle_erigon_get_header_by_number(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_erigon_get_logs_by_hash(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_erigon_forks(const nlohmann::json& request, nlohmann::json& reply);
+    boost::asio::awaitable<void> handle_erigon_get_accounts(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_erigon_watch_the_burn(const nlohmann::json& request, nlohmann::json& reply);
 
+    //! Binary search through the headers the highest block having timestamp not greater than the specified one
+    boost::asio::awaitable<uint64_t> search_block_by_timestamp(core::rawdb::DatabaseReader& db_reader, uint64_t timestamp);
+
 private:
     Context& context_;
     std::shared_ptr<BlockCache>& block_cache_;
+    std::shared_ptr<ReceiptCache>& receipt_cache_;
     std::shared_ptr<ethdb::kv::StateCache>& state_cache_;
     std::unique_ptr<ethdb::Database>& database_;
 
@@ -49,6 +49,9 @@ class ErigonRpcApi_ForTest : public ErigonRpcApi {
     boost::asio::awaitable<void> handle_erigon_forks(const nlohmann::json& request, nlohmann::json& reply) {
         co_return co_await ErigonRpcApi::handle_erigon_forks(request, reply);
     }
+    boost::asio::awaitable<void> handle_erigon_get_accounts(const nlohmann::json& request, nlohmann::json& reply) {
+        co_return co_await ErigonRpcApi::handle_erigon_get_accounts(request, reply);
+    }
     boost::asio::awaitable<void> handle_erigon_watch_the_burn(const nlohmann::json& request, nlohmann::json& reply) {
         co_return co_await ErigonRpcApi::handle_erigon_watch_the_burn(request, reply);
     }
@@ -135,6 +138,37 @@ TEST_CASE_METHOD(ErigonRpcApiTest, "ErigonRpcApi::handle_erigon_get_header_by_ha
     }
 }
 
+TEST_CASE_METHOD(ErigonRpcApiTest, "ErigonRpcApi::handle_erigon_get_accounts", "[silkrpc][erigon_api]") {
+    nlohmann::json reply;
+
+    SECTION("request params are incomplete: return error") {
+        CHECK_NOTHROW(run<&ErigonRpcApi_ForTest::handle_erigon_get_accounts>(R"({
+            "jsonrpc":"2.0",
+            "id":1,
+            "method":"erigon_getAccounts",
+            "params":["latest"]
+        })"_json, reply));
+        CHECK(reply == R"({
+            "jsonrpc":"2.0",
+            "id":1,
+            "error":{"code":100,"message":"invalid erigon_getAccounts params: [\"latest\"]"}
+        })"_json);
+    }
+    SECTION("request 1st param is not an array: return error") {
+        CHECK_NOTHROW(run<&ErigonRpcApi_ForTest::handle_erigon_get_accounts>(R"({
+            "jsonrpc":"2.0",
+            "id":1,
+            "method":"erigon_getAccounts",
+            "params":["0x0715a7794a1dc8e42615f059dd6e406a6594651a", "latest"]
+        })"_json, reply));
+        CHECK(reply == R"({
+            "jsonrpc":"2.0",
+            "id":1,
+            "error":{"code":100,"message":"invalid erigon_getAccounts params: [\"0x0715a7794a1dc8e42615f059dd6e406a6594651a\",\"latest\"]"}
+        })"_json);
+    }
+}
+
 TEST_CASE_METHOD(ErigonRpcApiTest, "ErigonRpcApi::handle_erigon_watch_the_burn", "[silkrpc][erigon_api]") {
     nlohmann::json reply;
 
@@ -22,9 +22,13 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <optional>
+#include <stdexcept>
 #include <string>
 #include <utility>
+#include <variant>
 
+#include <boost/asio/this_coro.hpp>
 #include <boost/endian/conversion.hpp>
 #include <evmc/evmc.hpp>
 #include <silkworm/chain/config.hpp>
@@ -36,25 +40,35 @@
 #include <silkworm/types/receipt.hpp>
 #include <silkworm/types/transaction.hpp>
 
+#include <silkrpc/common/call_result_cache.hpp>
 #include <silkrpc/common/constants.hpp>
 #include <silkrpc/common/log.hpp>
 #include <silkrpc/common/util.hpp>
+#include <silkrpc/concurrency/parallel_for.hpp>
 #include <silkrpc/core/cached_chain.hpp>
 #include <silkrpc/core/blocks.hpp>
 #include <silkrpc/core/evm_executor.hpp>
 #include <silkrpc/core/evm_access_list_tracer.hpp>
 #include <silkrpc/core/estimate_gas_oracle.hpp>
+#include <silkrpc/core/fee_history_oracle.hpp>
 #include <silkrpc/core/gas_price_oracle.hpp>
+#include <silkrpc/core/logs_planner.hpp>
+#include <silkrpc/core/overlay_state.hpp>
+#include <silkrpc/core/proof_builder.hpp>
 #include <silkrpc/core/rawdb/chain.hpp>
 #include <silkrpc/core/receipts.hpp>
 #include <silkrpc/core/remote_state.hpp>
+#include <silkrpc/core/sender_recovery.hpp>
 #include <silkrpc/core/state_reader.hpp>
 #include <silkrpc/ethdb/bitmap.hpp>
 #include <silkrpc/ethdb/cbor.hpp>
+#include <silkrpc/ethdb/file/log_index.hpp>
+#include <silkrpc/ethdb/memoized_database.hpp>
 #include <silkrpc/ethdb/tables.hpp>
 #include <silkrpc/ethdb/transaction_database.hpp>
 #include <silkrpc/ethdb/kv/cached_database.hpp>
 #include <silkrpc/json/types.hpp>
+#include <silkrpc/json/writer.hpp>
 #include <silkrpc/stagedsync/stages.hpp>
 #include <silkrpc/types/block.hpp>
 #include <silkrpc/types/call.hpp>
@@ -64,12 +78,41 @@
 
 namespace silkrpc::commands {
 
+//! The gas price actually paid by the transaction included in the block having the specified header
+static intx::uint256 effective_gas_price_of(const silkworm::Transaction& transaction, const silkworm::BlockHeader& header) {
+    const intx::uint256 base_fee_per_gas{header.base_fee_per_gas.value_or(0)};
+    return transaction.max_fee_per_gas >= base_fee_per_gas ? transaction.effective_gas_price(base_fee_per_gas) : transaction.max_priority_fee_per_gas;
+}
+
+//! Read the projection from the optional fields parameter (e.g. ["hash", "transactions.from"]) following the standard
+//! ones at the specified index, returning the error message if invalid
+static std::optional<std::string> read_projection(const nlohmann::json& params, std::size_t index,
+    FieldProjection (*make_projection)(const std::vector<std::string>&), FieldProjection& projection) {
+    if (params.size() <= index || params[index].is_null()) {
+        return std::nullopt;
+    }
+    if (!params[index].is_array()) {
+        return "invalid fields: " + params[index].dump();
+    }
+    try {
+        projection = make_projection(params[index].get<std::vector<std::string>>());
+    } catch (const std::exception& e) {
+        return std::string{"invalid fields: "} + e.what();
+    }
+    return std::nullopt;
+}
+
+//! Check if the projection writes the senders of the full transactions, which need to be recovered if missing
+static bool needs_senders(const FieldProjection& projection) {
+    return is_selected(projection.fields, block_field::transactions) && is_selected(projection.transaction_fields, transaction_field::from);
+}
+
 // https://eth.wiki/json-rpc/API#eth_blocknumber
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_block_number(const nlohmann::json& request, nlohmann::json& reply) {
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         const auto block_height = co_await core::get_latest_block_number(tx_database);
         reply = make_json_content(request["id"], to_quantity(block_height));
     } catch (const std::exception& e) {
@@ -89,7 +132,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_chain_id(const nlohmann:
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         const auto chain_id = co_await core::rawdb::read_chain_id(tx_database);
         reply = make_json_content(request["id"], to_quantity(chain_id));
     } catch (const std::exception& e) {
@@ -125,7 +168,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_syncing(const nlohmann::
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         const auto current_block_height = co_await core::get_current_block_number(tx_database);
         const auto highest_block_height = co_await core::get_highest_block_number(tx_database);
         if (current_block_height >= highest_block_height) {
@@ -160,7 +203,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_gas_price(const nlohmann
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         const auto block_number = co_await core::get_block_number(core::kLatestBlockId, tx_database);
         SILKRPC_INFO << "block_number " << block_number << "\n";
 
@@ -168,11 +211,11 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_gas_price(const nlohmann
             return core::read_block_by_number(*block_cache_, tx_database, block_number);
         };
 
-        GasPriceOracle gas_price_oracle{ block_provider};
+        GasPriceOracle gas_price_oracle{block_provider, context_.gas_price_cache().get()};
         auto gas_price = co_await gas_price_oracle.suggested_price(block_number);
 
         const auto block_with_hash = co_await block_provider(block_number);
-        const auto base_fee = block_with_hash.block.header.base_fee_per_gas.value_or(0);
+        const auto base_fee = block_with_hash->block.header.base_fee_per_gas.value_or(0);
         gas_price += base_fee;
         reply = make_json_content(request["id"], to_quantity(gas_price));
     } catch (const std::exception& e) {
@@ -187,39 +230,96 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_gas_price(const nlohmann
     co_return;
 }
 
+// https://github.com/ethereum/execution-apis/blob/main/src/eth/fee_market.yaml
+boost::asio::awaitable<void> EthereumRpcApi::handle_eth_fee_history(const nlohmann::json& request, nlohmann::json& reply) {
+    const auto& params = request["params"];
+    if (params.size() < 2 || params.size() > 3) {
+        auto error_msg = "invalid eth_feeHistory params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        reply = make_json_error(request["id"], 100, error_msg);
+        co_return;
+    }
+    const auto block_count = params[0].is_string() ? std::stoull(params[0].get<std::string>(), 0, 0) : params[0].get<uint64_t>();
+    const auto newest_block_id = params[1].is_string() ? params[1].get<std::string>() : to_quantity(params[1].get<uint64_t>());
+    std::vector<double> reward_percentiles;
+    if (params.size() == 3 && !params[2].is_null()) {
+        reward_percentiles = params[2].get<std::vector<double>>();
+    }
+    SILKRPC_DEBUG << "block_count: " << block_count << " newest_block_id: " << newest_block_id << " #percentiles: " << reward_percentiles.size() << "\n";
+
+    auto tx = co_await database_->begin();
+
+    try {
+        ethdb::MemoizedDatabase tx_database{*tx};
+        const auto chain_id = co_await core::rawdb::read_chain_id(tx_database);
+        const auto chain_config_ptr = lookup_chain_config(chain_id);
+        const auto newest_block_number = co_await core::get_block_number(newest_block_id, tx_database);
+
+        BlockProvider block_provider = [this, &tx_database](uint64_t block_number) {
+            return core::read_block_by_number(*block_cache_, tx_database, block_number);
+        };
+        ReceiptsProvider receipts_provider = [this, &tx_database](const silkworm::BlockWithHash& block_with_hash) {
+            return core::get_receipts(*receipt_cache_, tx_database, block_with_hash);
+        };
+
+        FeeHistoryOracle fee_history_oracle{*chain_config_ptr, block_provider, receipts_provider, context_.fee_history_cache().get()};
+        const auto fee_history = co_await fee_history_oracle.fee_history(newest_block_number, block_count, reward_percentiles);
+
+        reply = make_json_content(request["id"], fee_history);
+    } catch (const std::invalid_argument& iv) {
+        SILKRPC_WARN << "invalid_argument: " << iv.what() << " processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], -32602, iv.what());
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], 100, e.what());
+    } catch (...) {
+        SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], 100, "unexpected exception");
+    }
+
+    co_await tx->close(); // RAII not (yet) available with coroutines
+    co_return;
+}
+
 // https://eth.wiki/json-rpc/API#eth_getblockbyhash
-boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_by_hash(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
-    if (params.size() != 2) {
+boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_by_hash(const nlohmann::json& request, std::string& reply) {
+    const auto& params = request["params"];
+    if (params.size() < 2 || params.size() > 3) {
         auto error_msg = "invalid eth_getBlockByHash params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
-        reply = make_json_error(request["id"], 100, error_msg);
+        reply = make_json_error(request["id"], 100, error_msg).dump();
         co_return;
     }
     auto block_hash = params[0].get<evmc::bytes32>();
     auto full_tx = params[1].get<bool>();
+    FieldProjection projection;
+    if (const auto error_msg = read_projection(params, 2, make_block_projection, projection)) {
+        SILKRPC_ERROR << *error_msg << "\n";
+        reply = make_json_error(request["id"], -32602, *error_msg).dump();
+        co_return;
+    }
     SILKRPC_DEBUG << "block_hash: " << block_hash << " full_tx: " << std::boolalpha << full_tx << "\n";
 
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
-        const auto block_with_hash = co_await core::read_block_by_hash(*block_cache_, tx_database, block_hash);
-        const auto block_number = block_with_hash.block.header.number;
-        const auto total_difficulty = co_await core::rawdb::read_total_difficulty(tx_database, block_hash, block_number);
-        const Block extended_block{block_with_hash, total_difficulty, full_tx};
+        // The full transactions need the senders, so any missing one is recovered on the workers and cached with the block
+        auto* sender_recovery = full_tx && needs_senders(projection) ? context_.sender_recovery().get() : nullptr;
+        const auto block_with_hash = co_await core::read_block_by_hash(*block_cache_, tx_database, block_hash, sender_recovery);
+        const auto block_json = co_await get_block_json(tx_database, *block_with_hash, full_tx, projection);
 
-        reply = make_json_content(request["id"], extended_block);
+        write_raw_json_content(reply, request["id"], *block_json);
     } catch (const std::invalid_argument& iv) {
         SILKRPC_WARN << "invalid_argument: " << iv.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_content(request["id"], {});
+        reply = make_json_content(request["id"], {}).dump();
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, e.what());
+        reply = make_json_error(request["id"], 100, e.what()).dump();
     } catch (...) {
         SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, "unexpected exception");
+        reply = make_json_error(request["id"], 100, "unexpected exception").dump();
     }
 
     co_await tx->close(); // RAII not (yet) available with coroutines
@@ -227,38 +327,45 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_by_hash(const
 }
 
 // https://eth.wiki/json-rpc/API#eth_getblockbynumber
-boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_by_number(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
-    if (params.size() != 2) {
+boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_by_number(const nlohmann::json& request, std::string& reply) {
+    const auto& params = request["params"];
+    if (params.size() < 2 || params.size() > 3) {
         auto error_msg = "invalid getBlockByNumber params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
-        reply = make_json_error(request["id"], 100, error_msg);
+        reply = make_json_error(request["id"], 100, error_msg).dump();
         co_return;
     }
     const auto block_id = params[0].get<std::string>();
     auto full_tx = params[1].get<bool>();
+    FieldProjection projection;
+    if (const auto error_msg = read_projection(params, 2, make_block_projection, projection)) {
+        SILKRPC_ERROR << *error_msg << "\n";
+        reply = make_json_error(request["id"], -32602, *error_msg).dump();
+        co_return;
+    }
     SILKRPC_DEBUG << "block_id: " << block_id << " full_tx: " << std::boolalpha << full_tx << "\n";
 
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_number = co_await core::get_block_number(block_id, tx_database);
-        const auto block_with_hash = co_await core::read_block_by_number(*block_cache_, tx_database, block_number);
-        const auto total_difficulty = co_await core::rawdb::read_total_difficulty(tx_database, block_with_hash.hash, block_number);
-        const Block extended_block{block_with_hash, total_difficulty, full_tx};
+        // The full transactions need the senders, so any missing one is recovered on the workers and cached with the block
+        auto* sender_recovery = full_tx && needs_senders(projection) ? context_.sender_recovery().get() : nullptr;
+        const auto block_with_hash = co_await core::read_block_by_number(*block_cache_, tx_database, block_number, sender_recovery);
+        const auto block_json = co_await get_block_json(tx_database, *block_with_hash, full_tx, projection);
 
-        reply = make_json_content(request["id"], extended_block);
+        write_raw_json_content(reply, request["id"], *block_json);
     } catch (const std::invalid_argument& iv) {
         SILKRPC_WARN << "invalid_argument: " << iv.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_content(request["id"], nlohmann::detail::value_t::null);
+        reply = make_json_content(request["id"], nlohmann::detail::value_t::null).dump();
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, e.what());
+        reply = make_json_error(request["id"], 100, e.what()).dump();
     } catch (...) {
         SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, "unexpected exception");
+        reply = make_json_error(request["id"], 100, "unexpected exception").dump();
     }
 
     co_await tx->close(); // RAII not (yet) available with coroutines
@@ -267,7 +374,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_by_number(cons
 
 // https://eth.wiki/json-rpc/API#eth_getblocktransactioncountbyhash
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_transaction_count_by_hash(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 1) {
         auto error_msg = "invalid eth_getBlockTransactionCountByHash params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -280,10 +387,10 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_transaction_co
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_with_hash = co_await core::read_block_by_hash(*block_cache_, tx_database, block_hash);
-        const auto tx_count = block_with_hash.block.transactions.size();
+        const auto tx_count = block_with_hash->block.transactions.size();
 
         reply = make_json_content(request["id"], to_quantity(tx_count));
     } catch (const std::exception& e) {
@@ -300,7 +407,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_transaction_co
 
 // https://eth.wiki/json-rpc/API#eth_getblocktransactioncountbynumber
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_transaction_count_by_number(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 1) {
         auto error_msg = "invalid eth_getBlockTransactionCountByNumber params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -313,12 +420,12 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_transaction_co
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_number = co_await core::get_block_number(block_id, tx_database);
         const auto block_with_hash = co_await core::read_block_by_number(*block_cache_, tx_database, block_number);
 
-        reply = make_json_content(request["id"], to_quantity(block_with_hash.block.transactions.size()));
+        reply = make_json_content(request["id"], to_quantity(block_with_hash->block.transactions.size()));
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
         reply = make_json_error(request["id"], 100, e.what());
@@ -333,7 +440,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_transaction_co
 
 // https://eth.wiki/json-rpc/API#eth_getunclebyblockhashandindex
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_uncle_by_block_hash_and_index(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 2) {
         auto error_msg = "invalid eth_getUncleByBlockHashAndIndex params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -347,17 +454,17 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_uncle_by_block_hash_
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_with_hash = co_await core::read_block_by_hash(*block_cache_, tx_database, block_hash);
-        const auto ommers = block_with_hash.block.ommers;
+        const auto& ommers = block_with_hash->block.ommers;
 
         const auto idx = std::stoul(index, 0, 16);
         if (idx >= ommers.size()) {
             SILKRPC_WARN << "invalid_argument: index not found processing request: " << request.dump() << "\n";
             reply = make_json_content(request["id"], nullptr);
         } else {
-            const auto block_number = block_with_hash.block.header.number;
+            const auto block_number = block_with_hash->block.header.number;
             const auto total_difficulty = co_await core::rawdb::read_total_difficulty(tx_database, block_hash, block_number);
             auto uncle = ommers[idx];
 
@@ -380,7 +487,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_uncle_by_block_hash_
 
 // https://eth.wiki/json-rpc/API#eth_getunclebyblocknumberandindex
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_uncle_by_block_number_and_index(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 2) {
         auto error_msg = "invalid eth_getUncleByBlockNumberAndIndex params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -394,18 +501,18 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_uncle_by_block_numbe
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_number = co_await core::get_block_number(block_id, tx_database);
         const auto block_with_hash = co_await core::read_block_by_number(*block_cache_, tx_database, block_number);
-        const auto ommers = block_with_hash.block.ommers;
+        const auto& ommers = block_with_hash->block.ommers;
 
         const auto idx = std::stoul(index, 0, 16);
         if (idx >= ommers.size()) {
             SILKRPC_WARN << "invalid_argument: index not found processing request: " << request.dump() << "\n";
             reply = make_json_content(request["id"], nullptr);
         } else {
-            const auto total_difficulty = co_await core::rawdb::read_total_difficulty(tx_database, block_with_hash.hash, block_number);
+            const auto total_difficulty = co_await core::rawdb::read_total_difficulty(tx_database, block_with_hash->hash, block_number);
             auto uncle = ommers[idx];
 
             silkworm::BlockWithHash uncle_block_with_hash{{{}, uncle}, uncle.hash()};
@@ -427,7 +534,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_uncle_by_block_numbe
 
 // https://eth.wiki/json-rpc/API#eth_getunclecountbyblockhash
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_uncle_count_by_block_hash(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 1) {
         auto error_msg = "invalid eth_getUncleCountByBlockHash params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -440,10 +547,10 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_uncle_count_by_block
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_with_hash = co_await core::read_block_by_hash(*block_cache_, tx_database, block_hash);
-        const auto ommers = block_with_hash.block.ommers;
+        const auto& ommers = block_with_hash->block.ommers;
 
         reply = make_json_content(request["id"], to_quantity(ommers.size()));
     } catch (const std::exception& e) {
@@ -460,7 +567,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_uncle_count_by_block
 
 // https://eth.wiki/json-rpc/API#eth_getunclecountbyblocknumber
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_uncle_count_by_block_number(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 1) {
         auto error_msg = "invalid eth_getUncleCountByBlockNumber params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -473,11 +580,11 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_uncle_count_by_block
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_number = co_await core::get_block_number(block_id, tx_database);
         const auto block_with_hash = co_await core::read_block_by_number(*block_cache_, tx_database, block_number);
-        const auto ommers = block_with_hash.block.ommers;
+        const auto& ommers = block_with_hash->block.ommers;
 
         reply = make_json_content(request["id"], to_quantity(ommers.size()));
     } catch (const std::exception& e) {
@@ -493,12 +600,12 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_uncle_count_by_block
 }
 
 // https://eth.wiki/json-rpc/API#eth_gettransactionbyhash
-boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_by_hash(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_by_hash(const nlohmann::json& request, std::string& reply) {
+    const auto& params = request["params"];
     if (params.size() != 1) {
         auto error_msg = "invalid eth_getTransactionByHash params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
-        reply = make_json_error(request["id"], 100, error_msg);
+        reply = make_json_error(request["id"], 100, error_msg).dump();
         co_return;
     }
     auto transaction_hash = params[0].get<evmc::bytes32>();
@@ -507,7 +614,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_by_hash(
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         const auto tx_with_block = co_await core::read_transaction_by_hash(*block_cache_, tx_database, transaction_hash);
         if (!tx_with_block) {
             const auto tx_rlp_buffer = co_await tx_pool_->get_transaction(transaction_hash);
@@ -517,29 +624,33 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_by_hash(
                 const auto error = silkworm::rlp::decode<silkworm::Transaction>(encoded_tx_view, transaction);
                 if (error == silkworm::DecodingResult::kOk) {
                     transaction.queued_in_pool = true;
-                    reply = make_json_content(request["id"], transaction);
+                    // The sender of the transactions submitted here has been recovered already, skip the recovery
+                    if (context_.sender_recovery()) {
+                        context_.sender_recovery()->lookup_sender(transaction_hash, transaction);
+                    }
+                    write_json_content(reply, request["id"], transaction);
                 } else {
                     const auto error_msg = "invalid RLP decoding for tx hash: " + silkworm::to_hex(transaction_hash);
                     SILKRPC_ERROR << error_msg << "\n";
-                    reply = make_json_error(request["id"], 100, error_msg);
+                    reply = make_json_error(request["id"], 100, error_msg).dump();
                 }
             } else {
                 const auto error_msg = "tx hash: " + silkworm::to_hex(transaction_hash) + " does not exist in pool";
                 SILKRPC_ERROR << error_msg << "\n";
-                reply = make_json_error(request["id"], 100, error_msg);
+                reply = make_json_error(request["id"], 100, error_msg).dump();
             }
         } else {
-            reply = make_json_content(request["id"], tx_with_block->transaction);
+            write_json_content(reply, request["id"], tx_with_block->transaction);
         }
     } catch (const std::invalid_argument& iv) {
         SILKRPC_WARN << "invalid_argument: " << iv.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_content(request["id"], {});
+        reply = make_json_content(request["id"], {}).dump();
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, e.what());
+        reply = make_json_error(request["id"], 100, e.what()).dump();
     } catch (...) {
         SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, "unexpected exception");
+        reply = make_json_error(request["id"], 100, "unexpected exception").dump();
     }
 
     co_await tx->close(); // RAII not (yet) available with coroutines
@@ -548,7 +659,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_by_hash(
 
 // https://eth.wiki/json-rpc/API#eth_getrawtransactionbyhash
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_raw_transaction_by_hash(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 1) {
         auto error_msg = "invalid eth_getRawTransactionByHash params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -561,7 +672,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_raw_transaction_by_h
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         const auto tx_with_block = co_await core::read_transaction_by_hash(*block_cache_, tx_database, transaction_hash);
         if (!tx_with_block) {
             const auto tx_rlp_buffer = co_await tx_pool_->get_transaction(transaction_hash);
@@ -595,7 +706,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_raw_transaction_by_h
 
 // https://eth.wiki/json-rpc/API#eth_gettransactionbyblockhashandindex
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_by_block_hash_and_index(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 2) {
         auto error_msg = "invalid eth_getTransactionByBlockHashAndIndex params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -609,18 +720,18 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_by_block
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_with_hash = co_await core::read_block_by_hash(*block_cache_, tx_database, block_hash);
-        const auto transactions = block_with_hash.block.transactions;
+        const auto& transactions = block_with_hash->block.transactions;
 
         const auto idx = std::stoul(index, 0, 16);
         if (idx >= transactions.size()) {
             SILKRPC_WARN << "Transaction not found for index: " << index << "\n";
             reply = make_json_content(request["id"], nullptr);
         } else {
-            const auto block_header = block_with_hash.block.header;
-            silkrpc::Transaction txn{transactions[idx], block_with_hash.hash, block_header.number, block_header.base_fee_per_gas, idx};
+            const auto& block_header = block_with_hash->block.header;
+            silkrpc::Transaction txn{transactions[idx], block_with_hash->hash, block_header.number, block_header.base_fee_per_gas, idx};
             reply = make_json_content(request["id"], txn);
         }
     } catch (const std::exception& e) {
@@ -637,7 +748,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_by_block
 
 // https://eth.wiki/json-rpc/API#eth_getrawtransactionbyblockhashandindex
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_raw_transaction_by_block_hash_and_index(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 2) {
         auto error_msg = "invalid eth_getRawTransactionByBlockHashAndIndex params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -651,10 +762,10 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_raw_transaction_by_b
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_with_hash = co_await core::read_block_by_hash(*block_cache_, tx_database, block_hash);
-        const auto transactions = block_with_hash.block.transactions;
+        const auto& transactions = block_with_hash->block.transactions;
 
         const auto idx = std::stoul(index, 0, 16);
         if (idx >= transactions.size()) {
@@ -683,7 +794,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_raw_transaction_by_b
 
 // https://eth.wiki/json-rpc/API#eth_gettransactionbyblocknumberandindex
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_by_block_number_and_index(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 2) {
         auto error_msg = "invalid eth_getTransactionByBlockNumberAndIndex params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -697,19 +808,19 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_by_block
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_number = co_await core::get_block_number(block_id, tx_database);
         const auto block_with_hash = co_await core::read_block_by_number(*block_cache_, tx_database, block_number);
-        const auto transactions = block_with_hash.block.transactions;
+        const auto& transactions = block_with_hash->block.transactions;
 
         const auto idx = std::stoul(index, 0, 16);
         if (idx >= transactions.size()) {
             SILKRPC_WARN << "Transaction not found for index: " << index << "\n";
             reply = make_json_content(request["id"], nullptr);
         } else {
-            const auto block_header = block_with_hash.block.header;
-            silkrpc::Transaction txn{transactions[idx], block_with_hash.hash, block_header.number, block_header.base_fee_per_gas, idx};
+            const auto& block_header = block_with_hash->block.header;
+            silkrpc::Transaction txn{transactions[idx], block_with_hash->hash, block_header.number, block_header.base_fee_per_gas, idx};
             reply = make_json_content(request["id"], txn);
         }
     } catch (const std::exception& e) {
@@ -726,7 +837,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_by_block
 
 // https://eth.wiki/json-rpc/API#eth_getrawtransactionbyblocknumberandindex
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_raw_transaction_by_block_number_and_index(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 2) {
         auto error_msg = "invalid eth_getRawTransactionByBlockNumberAndIndex params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -740,11 +851,11 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_raw_transaction_by_b
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_number = co_await core::get_block_number(block_id, tx_database);
         const auto block_with_hash = co_await core::read_block_by_number(*block_cache_, tx_database, block_number);
-        const auto transactions = block_with_hash.block.transactions;
+        const auto& transactions = block_with_hash->block.transactions;
 
         const auto idx = std::stoul(index, 0, 16);
         if (idx >= transactions.size()) {
@@ -772,55 +883,105 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_raw_transaction_by_b
 }
 
 // https://eth.wiki/json-rpc/API#eth_gettransactionreceipt
-boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_receipt(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
-    if (params.size() != 1) {
+boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_receipt(const nlohmann::json& request, std::string& reply) {
+    const auto& params = request["params"];
+    if (params.empty() || params.size() > 2) {
         auto error_msg = "invalid eth_getTransactionReceipt params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
-        reply = make_json_error(request["id"], 100, error_msg);
+        reply = make_json_error(request["id"], 100, error_msg).dump();
         co_return;
     }
     auto transaction_hash = params[0].get<evmc::bytes32>();
+    FieldProjection projection;
+    if (const auto error_msg = read_projection(params, 1, make_receipt_projection, projection)) {
+        SILKRPC_ERROR << *error_msg << "\n";
+        reply = make_json_error(request["id"], -32602, *error_msg).dump();
+        co_return;
+    }
     SILKRPC_DEBUG << "transaction_hash: " << transaction_hash << "\n";
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_with_hash = co_await core::read_block_by_transaction_hash(*block_cache_, tx_database, transaction_hash);
-        auto receipts = co_await core::get_receipts(tx_database, block_with_hash);
-        auto transactions = block_with_hash.block.transactions;
-        if (receipts.size() != transactions.size()) {
+        const auto receipts = co_await core::get_receipts(*receipt_cache_, tx_database, *block_with_hash);
+        const auto& transactions = block_with_hash->block.transactions;
+        if (receipts->size() != transactions.size()) {
             throw std::invalid_argument{"Unexpected size for receipts in handle_eth_get_transaction_receipt"};
         }
 
-        size_t tx_index = -1;
-        for (size_t idx{0}; idx < transactions.size(); idx++) {
-            auto ethash_hash{hash_of_transaction(transactions[idx])};
-
-            SILKRPC_TRACE << "tx " << idx << ") hash: " << silkworm::to_bytes32({ethash_hash.bytes, silkworm::kHashLength}) << "\n";
-            if (std::memcmp(transaction_hash.bytes, ethash_hash.bytes, silkworm::kHashLength) == 0) {
-                tx_index = idx;
-                const intx::uint256 base_fee_per_gas{block_with_hash.block.header.base_fee_per_gas.value_or(0)};
-                const intx::uint256 effective_gas_price{transactions[idx].max_fee_per_gas >= base_fee_per_gas ? transactions[idx].effective_gas_price(base_fee_per_gas)
-                                                        : transactions[idx].max_priority_fee_per_gas};
-                receipts[tx_index].effective_gas_price = effective_gas_price;
-                break;
-            }
-        }
-        if (tx_index == -1) {
+        // The receipts already carry the transaction hashes computed once per block, so there is no need to hash again
+        const auto receipt_it = std::find_if(receipts->begin(), receipts->end(), [&](const auto& r) { return r.tx_hash == transaction_hash; });
+        if (receipt_it == receipts->end()) {
             throw std::invalid_argument{"Unexpected transaction index in handle_eth_get_transaction_receipt"};
         }
-        reply = make_json_content(request["id"], receipts[tx_index]);
+        const auto tx_index = static_cast<std::size_t>(receipt_it - receipts->begin());
+        // copy just the requested receipt, the shared ones are immutable
+        auto receipt{*receipt_it};
+        receipt.effective_gas_price = effective_gas_price_of(transactions[tx_index], block_with_hash->block.header);
+        write_json_content(reply, request["id"], receipt, projection);
     } catch (const std::invalid_argument& iv) {
         SILKRPC_WARN << "invalid_argument: " << iv.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_content(request["id"], {});
+        reply = make_json_content(request["id"]).dump();
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, e.what());
+        reply = make_json_error(request["id"], 100, e.what()).dump();
     } catch (...) {
         SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, "unexpected exception");
+        reply = make_json_error(request["id"], 100, "unexpected exception").dump();
+    }
+
+    co_await tx->close(); // RAII not (yet) available with coroutines
+    co_return;
+}
+
+// https://geth.ethereum.org/docs/interacting-with-geth/rpc/ns-eth#eth-getblockreceipts
+boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_receipts(const nlohmann::json& request, std::string& reply) {
+    const auto& params = request["params"];
+    if (params.empty() || params.size() > 2) {
+        auto error_msg = "invalid eth_getBlockReceipts params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        reply = make_json_error(request["id"], 100, error_msg).dump();
+        co_return;
+    }
+    const auto block_number_or_hash = params[0].get<BlockNumberOrHash>();
+    FieldProjection projection;
+    if (const auto error_msg = read_projection(params, 1, make_receipt_projection, projection)) {
+        SILKRPC_ERROR << *error_msg << "\n";
+        reply = make_json_error(request["id"], -32602, *error_msg).dump();
+        co_return;
+    }
+    SILKRPC_DEBUG << "block_number_or_hash: " << block_number_or_hash << "\n";
+
+    auto tx = co_await database_->begin();
+
+    try {
+        ethdb::MemoizedDatabase tx_database{*tx};
+
+        // The receipts of the whole block are derived once and shared with the other requests through the receipt cache
+        const auto block_with_hash = co_await core::read_block_by_number_or_hash(*block_cache_, tx_database, block_number_or_hash);
+        const auto receipts = co_await core::get_receipts(*receipt_cache_, tx_database, *block_with_hash);
+        const auto& block{block_with_hash->block};
+        if (receipts->size() != block.transactions.size()) {
+            throw std::invalid_argument{"Unexpected size for receipts in handle_eth_get_block_receipts"};
+        }
+
+        // copy the receipts to add the effective gas price, the shared ones are immutable
+        auto block_receipts{*receipts};
+        for (std::size_t i{0}; i < block.transactions.size(); i++) {
+            block_receipts[i].effective_gas_price = effective_gas_price_of(block.transactions[i], block.header);
+        }
+        write_json_content(reply, request["id"], block_receipts, projection);
+    } catch (const std::invalid_argument& iv) {
+        SILKRPC_WARN << "invalid_argument: " << iv.what() << " processing request: " << request.dump() << "\n";
+        reply = make_json_content(request["id"]).dump();
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], 100, e.what()).dump();
+    } catch (...) {
+        SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], 100, "unexpected exception").dump();
     }
 
     co_await tx->close(); // RAII not (yet) available with coroutines
@@ -829,7 +990,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_receipt(
 
 // https://eth.wiki/json-rpc/API#eth_estimategas
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_estimate_gas(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 1) {
         auto error_msg = "invalid eth_estimategas params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -844,7 +1005,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_estimate_gas(const nlohm
     try {
         const BlockNumberOrHash block_number_or_hash{core::kLatestBlockId};
         ethdb::kv::CachedDatabase cached_database{block_number_or_hash, *tx, *state_cache_};
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto chain_id = co_await core::rawdb::read_chain_id(tx_database);
         const auto chain_config_ptr = lookup_chain_config(chain_id);
@@ -852,15 +1013,27 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_estimate_gas(const nlohm
         SILKRPC_DEBUG << "chain_id: " << chain_id << ", latest_block_number: " << latest_block_number << "\n";
 
         const auto latest_block_with_hash = co_await core::read_block_by_number(*block_cache_, tx_database, latest_block_number);
-        const auto latest_block = latest_block_with_hash.block;
-        StateReader state_reader(cached_database);
-        state::RemoteState remote_state{*context_.io_context(), cached_database, latest_block.header.number};
-
-        Tracers tracers;
-        EVMExecutor evm_executor{*context_.io_context(), cached_database, *chain_config_ptr, workers_, latest_block.header.number, remote_state};
-
-        ego::Executor executor = [&latest_block, &evm_executor, &tracers](const silkworm::Transaction &transaction) {
-            return evm_executor.call(latest_block, transaction, tracers);
+        const auto& latest_block = latest_block_with_hash->block;
+        StateReader state_reader(cached_database, context_.history_cache());
+
+        // The probes of each round run concurrently, so each one executes within its own transaction
+        ego::Executor executor = [&](const silkworm::Transaction &transaction) -> boost::asio::awaitable<ExecutionResult> {
+            auto probe_tx = co_await database_->begin();
+            std::exception_ptr eptr;
+            ExecutionResult result{evmc_status_code::EVMC_SUCCESS, 0, {}};
+            try {
+                ethdb::kv::CachedDatabase probe_database{block_number_or_hash, *probe_tx, *state_cache_};
+                state::RemoteState probe_state{*context_.io_context(), probe_database, latest_block.header.number};
+                EVMExecutor evm_executor{*context_.io_context(), probe_database, *chain_config_ptr, workers_, latest_block.header.number, probe_state};
+                result = co_await evm_executor.call(latest_block, transaction);
+            } catch (...) {
+                eptr = std::current_exception();
+            }
+            co_await probe_tx->close(); // RAII not (yet) available with coroutines
+            if (eptr) {
+                std::rethrow_exception(eptr);
+            }
+            co_return result;
         };
 
         ego::BlockHeaderProvider block_header_provider = [&cached_database](uint64_t block_number) {
@@ -872,7 +1045,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_estimate_gas(const nlohm
             return state_reader.read_account(address, block_number + 1);
         };
 
-        ego::EstimateGasOracle estimate_gas_oracle{block_header_provider, account_reader, executor};
+        ego::EstimateGasOracle estimate_gas_oracle{block_header_provider, account_reader, executor, kEstimateGasProbesPerRound};
 
         auto estimated_gas = co_await estimate_gas_oracle.estimate_gas(call, latest_block_number);
 
@@ -898,7 +1071,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_estimate_gas(const nlohm
 
 // https://eth.wiki/json-rpc/API#eth_getbalance
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_balance(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 2) {
         auto error_msg = "invalid eth_getBalance params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -912,11 +1085,11 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_balance(const nlohma
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         ethdb::kv::CachedDatabase cached_database{BlockNumberOrHash{block_id}, *tx, *state_cache_};
         const auto [block_number, is_latest_block] = co_await core::get_block_number(block_id, tx_database, /*latest_required=*/true);
 
-        StateReader state_reader(is_latest_block ? (core::rawdb::DatabaseReader&)cached_database : (core::rawdb::DatabaseReader&)tx_database);
+        StateReader state_reader(is_latest_block ? (core::rawdb::DatabaseReader&)cached_database : (core::rawdb::DatabaseReader&)tx_database, context_.history_cache());
         std::optional<silkworm::Account> account{co_await state_reader.read_account(address, block_number + 1)};
 
         reply = make_json_content(request["id"], "0x" + (account ? intx::hex(account->balance) : "0"));
@@ -932,9 +1105,75 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_balance(const nlohma
     co_return;
 }
 
+// eth_getBalance requests in the same JSON batch executed together: one transaction and one account read per block
+boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_balance_many(const std::vector<const nlohmann::json*>& requests,
+    std::vector<nlohmann::json>& replies) {
+    replies.resize(requests.size());
+
+    std::vector<evmc::address> addresses(requests.size());
+    std::map<std::string, std::vector<std::size_t>> indexes_by_block_id;
+    for (std::size_t i{0}; i < requests.size(); ++i) {
+        const auto& request = *requests[i];
+        const auto& params = request["params"];
+        if (params.size() != 2) {
+            auto error_msg = "invalid eth_getBalance params: " + params.dump();
+            SILKRPC_ERROR << error_msg << "\n";
+            replies[i] = make_json_error(request["id"], 100, error_msg);
+            continue;
+        }
+        try {
+            addresses[i] = params[0].get<evmc::address>();
+            indexes_by_block_id[params[1].get<std::string>()].push_back(i);
+        } catch (const std::exception& e) {
+            SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
+            replies[i] = make_json_error(request["id"], 100, e.what());
+        }
+    }
+    if (indexes_by_block_id.empty()) {
+        co_return;
+    }
+    SILKRPC_DEBUG << "requests: " << requests.size() << " blocks: " << indexes_by_block_id.size() << "\n";
+
+    auto tx = co_await database_->begin();
+
+    ethdb::MemoizedDatabase tx_database{*tx};
+    for (const auto& [block_id, indexes] : indexes_by_block_id) {
+        try {
+            ethdb::kv::CachedDatabase cached_database{BlockNumberOrHash{block_id}, *tx, *state_cache_};
+            const auto [block_number, is_latest_block] = co_await core::get_block_number(block_id, tx_database, /*latest_required=*/true);
+
+            std::vector<evmc::address> block_addresses;
+            block_addresses.reserve(indexes.size());
+            for (const auto index : indexes) {
+                block_addresses.push_back(addresses[index]);
+            }
+            StateReader state_reader(is_latest_block ? (core::rawdb::DatabaseReader&)cached_database : (core::rawdb::DatabaseReader&)tx_database, context_.history_cache());
+            const auto accounts{co_await state_reader.read_accounts(block_addresses, block_number + 1)};
+
+            for (std::size_t j{0}; j < indexes.size(); ++j) {
+                const auto& account = accounts[j];
+                replies[indexes[j]] = make_json_content((*requests[indexes[j]])["id"], "0x" + (account ? intx::hex(account->balance) : "0"));
+            }
+        } catch (const std::exception& e) {
+            SILKRPC_ERROR << "exception: " << e.what() << " processing eth_getBalance requests at block: " << block_id << "\n";
+            for (const auto index : indexes) {
+                replies[index] = make_json_error((*requests[index])["id"], 100, e.what());
+            }
+        } catch (...) {
+            SILKRPC_ERROR << "unexpected exception processing eth_getBalance requests at block: " << block_id << "\n";
+            for (const auto index : indexes) {
+                replies[index] = make_json_error((*requests[index])["id"], 100, "unexpected exception");
+            }
+        }
+    }
+
+    co_await tx->close(); // RAII not (yet) available with coroutines
+    co_return;
+}
+
 // https://eth.wiki/json-rpc/API#eth_getcode
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_code(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 2) {
         auto error_msg = "invalid eth_getCode params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -948,10 +1187,10 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_code(const nlohmann:
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         ethdb::kv::CachedDatabase cached_database{BlockNumberOrHash{block_id}, *tx, *state_cache_};
         const auto [block_number, is_latest_block] = co_await core::get_block_number(block_id, tx_database, /*latest_required=*/true);
-        StateReader state_reader(is_latest_block ? (core::rawdb::DatabaseReader&)cached_database : (core::rawdb::DatabaseReader&)tx_database);
+        StateReader state_reader(is_latest_block ? (core::rawdb::DatabaseReader&)cached_database : (core::rawdb::DatabaseReader&)tx_database, context_.history_cache());
 
         std::optional<silkworm::Account> account{co_await state_reader.read_account(address, block_number + 1)};
 
@@ -976,7 +1215,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_code(const nlohmann:
 
 // https://eth.wiki/json-rpc/API#eth_gettransactioncount
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_count(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 2) {
         auto error_msg = "invalid eth_getTransactionCount params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -990,10 +1229,10 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_count(co
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         ethdb::kv::CachedDatabase cached_database{BlockNumberOrHash{block_id}, *tx, *state_cache_};
         const auto [block_number, is_latest_block] = co_await core::get_block_number(block_id, tx_database, /*latest_required=*/true);
-        StateReader state_reader(is_latest_block ? (core::rawdb::DatabaseReader&)cached_database : (core::rawdb::DatabaseReader&)tx_database);
+        StateReader state_reader(is_latest_block ? (core::rawdb::DatabaseReader&)cached_database : (core::rawdb::DatabaseReader&)tx_database, context_.history_cache());
 
         std::optional<silkworm::Account> account{co_await state_reader.read_account(address, block_number + 1)};
 
@@ -1017,7 +1256,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_count(co
 
 // https://eth.wiki/json-rpc/API#eth_getstorageat
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_storage_at(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 3) {
         auto error_msg = "invalid eth_getStorageAt params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -1032,10 +1271,10 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_storage_at(const nlo
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         ethdb::kv::CachedDatabase cached_database{BlockNumberOrHash{block_id}, *tx, *state_cache_};
         const auto [block_number, is_latest_block] = co_await core::get_block_number(block_id, tx_database, /*latest_required=*/true);
-        StateReader state_reader(is_latest_block ? (core::rawdb::DatabaseReader&)cached_database : (core::rawdb::DatabaseReader&)tx_database);
+        StateReader state_reader(is_latest_block ? (core::rawdb::DatabaseReader&)cached_database : (core::rawdb::DatabaseReader&)tx_database, context_.history_cache());
         std::optional<silkworm::Account> account{co_await state_reader.read_account(address, block_number + 1)};
 
         if (account) {
@@ -1058,8 +1297,8 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_storage_at(const nlo
 
 // https://eth.wiki/json-rpc/API#eth_call
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_call(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
-    if (params.size() != 2) {
+    const auto& params = request["params"];
+    if (params.size() < 2 || params.size() > 3) {
         auto error_msg = "invalid eth_call params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
         reply = make_json_error(request["id"], 100, error_msg);
@@ -1067,38 +1306,158 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_call(const nlohmann::jso
     }
     const auto call = params[0].get<Call>();
     const auto block_id = params[1].get<std::string>();
-    SILKRPC_DEBUG << "call: " << call << " block_id: " << block_id << "\n";
+    StateOverrides state_overrides;
+    if (params.size() == 3 && !params[2].is_null()) {
+        try {
+            state_overrides = params[2].get<StateOverrides>();
+        } catch (const std::exception& e) {
+            auto error_msg = "invalid eth_call state overrides: " + std::string{e.what()};
+            SILKRPC_ERROR << error_msg << "\n";
+            reply = make_json_error(request["id"], -32602, error_msg);
+            co_return;
+        }
+    }
+    SILKRPC_DEBUG << "call: " << call << " block_id: " << block_id << " #state_overrides: " << state_overrides.size() << "\n";
 
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         ethdb::kv::CachedDatabase cached_database{BlockNumberOrHash{block_id}, *tx, *state_cache_};
 
         const auto chain_id = co_await core::rawdb::read_chain_id(tx_database);
         const auto chain_config_ptr = lookup_chain_config(chain_id);
         const auto [block_number, is_latest_block] = co_await core::get_block_number(block_id, tx_database, /*latest_required=*/true);
 
+        const auto make_reply = [&](int64_t error_code, const silkworm::Bytes& data) {
+            if (error_code == evmc_status_code::EVMC_SUCCESS) {
+                reply = make_json_content(request["id"], "0x" + silkworm::to_hex(data));
+            } else {
+                const auto error_message = EVMExecutor<>::get_error_message(error_code, data);
+                if (data.empty()) {
+                    reply = make_json_error(request["id"], -32000, error_message);
+                } else {
+                    reply = make_json_error(request["id"], {3, error_message, data});
+                }
+            }
+        };
+
+        // Only the fee-less calls towards some contract at latest are memoized, their result depending just on the state read
+        silkworm::Transaction txn{call.to_transaction()};
+        auto& call_result_cache = context_.call_result_cache();
+        const bool cacheable{call_result_cache && is_latest_block && state_overrides.empty() && txn.to &&
+                             txn.max_fee_per_gas == 0 && txn.max_priority_fee_per_gas == 0};
+        const auto revision{chain_config_ptr->revision(block_number)};
+        const auto call_key{cacheable ? CallResultCache::key_of(txn) : CallResultCache::Key{}};
+        if (cacheable) {
+            const auto cached_result{call_result_cache->find(call_key, block_number, revision)};
+            if (cached_result) {
+                SILKRPC_DEBUG << "eth_call result cached at block_number: " << block_number << "\n";
+                make_reply(cached_result->error_code, cached_result->data);
+                co_await tx->close(); // RAII not (yet) available with coroutines
+                co_return;
+            }
+        }
+        const auto call_generation{cacheable ? call_result_cache->generation() : 0};
+
         state::RemoteState remote_state{*context_.io_context(),
                                         is_latest_block ? (core::rawdb::DatabaseReader&)cached_database : (core::rawdb::DatabaseReader&)tx_database,
-                                        block_number};
-        EVMExecutor executor{*context_.io_context(), tx_database, *chain_config_ptr, workers_, block_number, remote_state};
+                                        block_number,
+                                        context_.history_cache(), context_.code_cache()};
+        state::OverlayState overlay_state{remote_state};
+        overlay_state.apply(state_overrides);
+        EVMExecutor executor{*context_.io_context(), tx_database, *chain_config_ptr, workers_, block_number, remote_state, overlay_state,
+                             context_.access_history()};
         const auto block_with_hash = co_await core::read_block_by_number(*block_cache_, tx_database, block_number);
-        silkworm::Transaction txn{call.to_transaction()};
-        const auto execution_result = co_await executor.call(block_with_hash.block, txn);
+        const auto execution_result = co_await executor.call(block_with_hash->block, txn);
 
         if (execution_result.pre_check_error) {
             reply = make_json_error(request["id"], -32000, execution_result.pre_check_error.value());
-        } else if (execution_result.error_code == evmc_status_code::EVMC_SUCCESS) {
-            reply = make_json_content(request["id"], "0x" + silkworm::to_hex(execution_result.data));
         } else {
-            const auto error_message = EVMExecutor<>::get_error_message(execution_result.error_code, execution_result.data);
-            if (execution_result.data.empty()) {
-                reply = make_json_error(request["id"], -32000, error_message);
+            make_reply(execution_result.error_code, execution_result.data);
+            if (cacheable) {
+                bool reads_block_context{false};
+                for (const auto& [code_hash, code] : remote_state.accessed_code()) {
+                    reads_block_context = reads_block_context || call_result_cache->reads_block_context(code_hash, code);
+                }
+                auto result{std::make_shared<const CallResult>(CallResult{execution_result.error_code, execution_result.data})};
+                call_result_cache->store(call_key, std::move(result), block_number, revision, reads_block_context, executor.read_set(),
+                                         call_generation);
+            }
+        }
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], 100, e.what());
+    } catch (...) {
+        SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], 100, "unexpected exception");
+    }
+
+    co_await tx->close(); // RAII not (yet) available with coroutines
+    co_return;
+}
+
+// Execute the calls in sequence on top of the same block, each one seeing the state changes of the previous ones
+boost::asio::awaitable<void> EthereumRpcApi::handle_eth_call_many(const nlohmann::json& request, nlohmann::json& reply) {
+    const auto& params = request["params"];
+    const auto is_object = [](const nlohmann::json& call) { return call.is_object(); };
+    if (params.size() < 1 || params.size() > 2 || !params[0].is_array() || !std::all_of(params[0].begin(), params[0].end(), is_object) ||
+        (params.size() == 2 && !params[1].is_string())) {
+        auto error_msg = "invalid eth_callMany params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        reply = make_json_error(request["id"], 100, error_msg);
+        co_return;
+    }
+    std::vector<Call> calls;
+    try {
+        calls = params[0].get<std::vector<Call>>();
+    } catch (const std::exception& e) {
+        auto error_msg = "invalid eth_callMany params: " + params.dump();
+        SILKRPC_ERROR << error_msg << " exception: " << e.what() << "\n";
+        reply = make_json_error(request["id"], 100, error_msg);
+        co_return;
+    }
+    const auto block_id = params.size() == 2 ? params[1].get<std::string>() : std::string{core::kLatestBlockId};
+    SILKRPC_DEBUG << "#calls: " << calls.size() << " block_id: " << block_id << "\n";
+
+    auto tx = co_await database_->begin();
+
+    try {
+        ethdb::MemoizedDatabase tx_database{*tx};
+        ethdb::kv::CachedDatabase cached_database{BlockNumberOrHash{block_id}, *tx, *state_cache_};
+
+        const auto chain_id = co_await core::rawdb::read_chain_id(tx_database);
+        const auto chain_config_ptr = lookup_chain_config(chain_id);
+        const auto [block_number, is_latest_block] = co_await core::get_block_number(block_id, tx_database, /*latest_required=*/true);
+
+        // The remote state and the intra-block state on top of it are set up once and stay warm for the whole sequence
+        state::RemoteState remote_state{*context_.io_context(),
+                                        is_latest_block ? (core::rawdb::DatabaseReader&)cached_database : (core::rawdb::DatabaseReader&)tx_database,
+                                        block_number,
+                                        context_.history_cache(), context_.code_cache()};
+        EVMExecutor executor{*context_.io_context(), tx_database, *chain_config_ptr, workers_, block_number, remote_state, context_.access_history()};
+        const auto block_with_hash = co_await core::read_block_by_number(*block_cache_, tx_database, block_number);
+
+        std::vector<silkworm::Transaction> txns;
+        txns.reserve(calls.size());
+        for (const auto& call : calls) {
+            txns.push_back(call.to_transaction());
+        }
+        const auto execution_results = co_await executor.call_many(block_with_hash->block, txns);
+
+        nlohmann::json results = nlohmann::json::array();
+        for (const auto& execution_result : execution_results) {
+            nlohmann::json result = nlohmann::json::object();
+            if (execution_result.pre_check_error) {
+                result["error"] = execution_result.pre_check_error.value();
+            } else if (execution_result.error_code == evmc_status_code::EVMC_SUCCESS) {
+                result["value"] = "0x" + silkworm::to_hex(execution_result.data);
             } else {
-                reply = make_json_error(request["id"], {3, error_message, execution_result.data});
+                result["error"] = EVMExecutor<>::get_error_message(execution_result.error_code, execution_result.data);
             }
+            results.push_back(std::move(result));
         }
+        reply = make_json_content(request["id"], results);
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
         reply = make_json_error(request["id"], 100, e.what());
@@ -1113,7 +1472,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_call(const nlohmann::jso
 
 // https://geth.ethereum.org/docs/rpc/ns-eth#eth_createaccesslist
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_create_access_list(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 2) {
         auto error_msg = "invalid eth_call params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -1128,17 +1487,17 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_create_access_list(const
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         ethdb::kv::CachedDatabase cached_database{block_number_or_hash, *tx, *state_cache_};
 
         const auto block_with_hash = co_await core::read_block_by_number_or_hash(*block_cache_, tx_database, block_number_or_hash);
         const auto chain_id = co_await core::rawdb::read_chain_id(tx_database);
         const auto chain_config_ptr = lookup_chain_config(chain_id);
 
-        const bool is_latest_block = co_await core::get_latest_executed_block_number(tx_database) == block_with_hash.block.header.number;
+        const bool is_latest_block = co_await core::get_latest_executed_block_number(tx_database) == block_with_hash->block.header.number;
         const core::rawdb::DatabaseReader& db_reader = is_latest_block ? (core::rawdb::DatabaseReader&)cached_database : (core::rawdb::DatabaseReader&)tx_database;
-        StateReader state_reader(db_reader);
-        state::RemoteState remote_state{*context_.io_context(), db_reader, block_with_hash.block.header.number};
+        StateReader state_reader(db_reader, context_.history_cache());
+        state::RemoteState remote_state{*context_.io_context(), db_reader, block_with_hash->block.header.number, context_.history_cache(), context_.code_cache()};
 
         evmc::address to{};
         if (call.to) {
@@ -1149,7 +1508,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_create_access_list(const
                 // Retrieve nonce by txpool
                 auto nonce_option = co_await tx_pool_->nonce(*call.from);
                 if (!nonce_option) {
-                    std::optional<silkworm::Account> account{co_await state_reader.read_account(*call.from,  block_with_hash.block.header.number + 1)};
+                    std::optional<silkworm::Account> account{co_await state_reader.read_account(*call.from,  block_with_hash->block.header.number + 1)};
                     if (account) {
                         nonce = (*account).nonce;
                     }
@@ -1168,10 +1527,10 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_create_access_list(const
         Tracers tracers{tracer};
         bool access_lists_match{false};
         do {
-            EVMExecutor executor{*context_.io_context(), tx_database, *chain_config_ptr, workers_, block_with_hash.block.header.number, remote_state};
+            EVMExecutor executor{*context_.io_context(), tx_database, *chain_config_ptr, workers_, block_with_hash->block.header.number, remote_state};
             const auto txn = call.to_transaction();
             tracer->reset_access_list();
-            const auto execution_result = co_await executor.call(block_with_hash.block, txn, tracers, /* refund */true, /* gasBailout */false);
+            const auto execution_result = co_await executor.call(block_with_hash->block, txn, tracers, /* refund */true, /* gasBailout */false);
             if (execution_result.pre_check_error) {
                 reply = make_json_error(request["id"], -32000, execution_result.pre_check_error.value());
                 break;
@@ -1189,6 +1548,19 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_create_access_list(const
                 reply = make_json_content(request["id"], access_list_result);
                 break;
             }
+            // The same accesses are made with any gas schedule unless gas dependent, so applying the current access list
+            // changes the gas used only: predict it instead of executing again (the coinbase may be warm since Shanghai)
+            const auto predicted_gas_used = tracer->predict_gas_used(call.access_list, txn.gas_limit - execution_result.gas_left);
+            const auto& beneficiary = block_with_hash->block.header.beneficiary;
+            const bool touches_beneficiary = std::any_of(current_access_list.cbegin(), current_access_list.cend(),
+                [&](const auto& entry) { return entry.account == beneficiary; });
+            if (predicted_gas_used && *predicted_gas_used <= txn.gas_limit && !touches_beneficiary) {
+                AccessListResult access_list_result;
+                access_list_result.access_list = current_access_list;
+                access_list_result.gas_used = *predicted_gas_used;
+                reply = make_json_content(request["id"], access_list_result);
+                break;
+            }
             call.set_access_list(current_access_list);
         } while (!access_lists_match);
     } catch (const std::exception& e) {
@@ -1205,7 +1577,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_create_access_list(const
 
 //https://docs.flashbots.net/flashbots-auction/miners/mev-geth-spec/v06-rpc/eth_callBundle
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_call_bundle(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 3) {
         auto error_msg = "invalid eth_callBundle params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -1236,10 +1608,10 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_call_bundle(const nlohma
         const auto chain_id = co_await core::rawdb::read_chain_id(tx_database);
         const auto chain_config_ptr = lookup_chain_config(chain_id);
 
-        const bool is_latest_block = co_await core::get_latest_executed_block_number(tx_database) == block_with_hash.block.header.number;
+        const bool is_latest_block = co_await core::get_latest_executed_block_number(tx_database) == block_with_hash->block.header.number;
         core::rawdb::DatabaseReader& db_reader = is_latest_block ? (core::rawdb::DatabaseReader&)cached_database : (core::rawdb::DatabaseReader&)tx_database;
-        auto block_number = block_with_hash.block.header.number;
-        state::RemoteState remote_state{*context_.io_context(), db_reader, block_number};
+        auto block_number = block_with_hash->block.header.number;
+        state::RemoteState remote_state{*context_.io_context(), db_reader, block_number, context_.history_cache(), context_.code_cache()};
 
         const auto start_time = clock_time::now();
 
@@ -1259,7 +1631,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_call_bundle(const nlohma
             }
 
             EVMExecutor executor{*context_.io_context(), tx_database, *chain_config_ptr, workers_, block_number, remote_state};
-            const auto execution_result = co_await executor.call(block_with_hash.block, tx_with_block->transaction);
+            const auto execution_result = co_await executor.call(block_with_hash->block, tx_with_block->transaction);
             if (execution_result.pre_check_error) {
                 reply = make_json_error(request["id"], -32000, execution_result.pre_check_error.value());
                 error = true;
@@ -1304,12 +1676,20 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_call_bundle(const nlohma
 
 // https://eth.wiki/json-rpc/API#eth_newfilter
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_new_filter(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    const auto& params = request["params"];
+    if (params.size() != 1) {
+        auto error_msg = "invalid eth_newFilter params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        reply = make_json_error(request["id"], 100, error_msg);
+        co_return;
+    }
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        auto filter = params[0].get<Filter>();
+        SILKRPC_DEBUG << "filter: " << filter << "\n";
 
-        reply = make_json_content(request["id"], to_quantity(0));
+        const auto filter_id = context_.filter_registry()->new_log_filter(std::move(filter));
+        reply = make_json_content(request["id"], filter_id);
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
         reply = make_json_error(request["id"], 100, e.what());
@@ -1318,18 +1698,14 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_new_filter(const nlohman
         reply = make_json_error(request["id"], 100, "unexpected exception");
     }
 
-    co_await tx->close(); // RAII not (yet) available with coroutines
     co_return;
 }
 
 // https://eth.wiki/json-rpc/API#eth_newblockfilter
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_new_block_filter(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
-
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
-
-        reply = make_json_content(request["id"], to_quantity(0));
+        const auto filter_id = context_.filter_registry()->new_block_filter();
+        reply = make_json_content(request["id"], filter_id);
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
         reply = make_json_error(request["id"], 100, e.what());
@@ -1338,7 +1714,6 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_new_block_filter(const n
         reply = make_json_error(request["id"], 100, "unexpected exception");
     }
 
-    co_await tx->close(); // RAII not (yet) available with coroutines
     co_return;
 }
 
@@ -1347,7 +1722,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_new_pending_transaction_
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         reply = make_json_content(request["id"], to_quantity(0));
     } catch (const std::exception& e) {
@@ -1364,12 +1739,26 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_new_pending_transaction_
 
 // https://eth.wiki/json-rpc/API#eth_getfilterchanges
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_filter_changes(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    const auto& params = request["params"];
+    if (params.size() != 1 || !params[0].is_string()) {
+        auto error_msg = "invalid eth_getFilterChanges params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        reply = make_json_error(request["id"], 100, error_msg);
+        co_return;
+    }
+    const auto filter_id = params[0].get<std::string>();
+    SILKRPC_DEBUG << "filter_id: " << filter_id << "\n";
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
-
-        reply = make_json_content(request["id"], to_quantity(0));
+        // The changes are just drained from the filter queue, the block logs have been matched when published
+        const auto changes = context_.filter_registry()->changes(filter_id);
+        if (!changes) {
+            reply = make_json_error(request["id"], -32000, "filter not found");
+        } else if (std::holds_alternative<Logs>(*changes)) {
+            reply = make_json_content(request["id"], std::get<Logs>(*changes));
+        } else {
+            reply = make_json_content(request["id"], std::get<std::vector<evmc::bytes32>>(*changes));
+        }
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
         reply = make_json_error(request["id"], 100, e.what());
@@ -1378,18 +1767,24 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_filter_changes(const
         reply = make_json_error(request["id"], 100, "unexpected exception");
     }
 
-    co_await tx->close(); // RAII not (yet) available with coroutines
     co_return;
 }
 
 // https://eth.wiki/json-rpc/API#eth_uninstallfilter
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_uninstall_filter(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    const auto& params = request["params"];
+    if (params.size() != 1 || !params[0].is_string()) {
+        auto error_msg = "invalid eth_uninstallFilter params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        reply = make_json_error(request["id"], 100, error_msg);
+        co_return;
+    }
+    const auto filter_id = params[0].get<std::string>();
+    SILKRPC_DEBUG << "filter_id: " << filter_id << "\n";
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
-
-        reply = make_json_content(request["id"], to_quantity(0));
+        const auto uninstalled = context_.filter_registry()->uninstall(filter_id);
+        reply = make_json_content(request["id"], uninstalled);
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
         reply = make_json_error(request["id"], 100, e.what());
@@ -1398,17 +1793,16 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_uninstall_filter(const n
         reply = make_json_error(request["id"], 100, "unexpected exception");
     }
 
-    co_await tx->close(); // RAII not (yet) available with coroutines
     co_return;
 }
 
 // https://eth.wiki/json-rpc/API#eth_getlogs
-boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_logs(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_logs(const nlohmann::json& request, std::string& reply) {
+    const auto& params = request["params"];
     if (params.size() != 1) {
         auto error_msg = "invalid eth_getLogs params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
-        reply = make_json_error(request["id"], 100, error_msg);
+        reply = make_json_error(request["id"], 100, error_msg).dump();
         co_return;
     }
     auto filter = params[0].get<Filter>();
@@ -1419,137 +1813,126 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_logs(const nlohmann:
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
-        uint64_t start{}, end{};
-        if (filter.block_hash.has_value()) {
-            auto block_hash_bytes = silkworm::from_hex(filter.block_hash.value());
-            if (!block_hash_bytes.has_value()) {
-                auto error_msg = "invalid eth_getLogs filter block_hash: " + filter.block_hash.value();
-                SILKRPC_ERROR << error_msg << "\n";
-                reply = make_json_error(request["id"], 100, error_msg);
-                co_await tx->close(); // RAII not (yet) available with coroutines
-                co_return;
-            }
-            auto block_hash = silkworm::to_bytes32(block_hash_bytes.value());
-            auto block_number = co_await core::rawdb::read_header_number(tx_database, block_hash);
-            start = end = block_number;
-        } else {
-            uint64_t last_executed_block_number = std::numeric_limits<std::uint64_t>::max();
-            if (filter.from_block.has_value()) {
-               start = filter.from_block.value();
-            } else {
-               last_executed_block_number = co_await core::get_latest_executed_block_number(tx_database);
-               start = last_executed_block_number;
-            }
-            if (filter.to_block.has_value()) {
-               end = filter.to_block.value();
-            } else {
-               if (last_executed_block_number == std::numeric_limits<std::uint64_t>::max()) {
-                  last_executed_block_number = co_await core::get_latest_executed_block_number(tx_database);
-               }
-               end = last_executed_block_number;
-            }
+        const auto block_numbers = co_await get_block_numbers(tx_database, filter, /*streamed=*/false);
+        const core::LogFilterMatcher matcher{filter};
+        auto block_it = block_numbers.begin();
+        while (block_it != block_numbers.end()) {
+            co_await get_next_logs(tx_database, filter, matcher, block_numbers, block_it, logs);
         }
-        SILKRPC_INFO << "start block: " << start << " end block: " << end << "\n";
+        SILKRPC_INFO << "logs.size(): " << logs.size() << "\n";
 
-        roaring::Roaring block_numbers;
-        block_numbers.addRange(start, end + 1); // [min, max)
+        write_json_content(reply, request["id"], logs);
+    } catch (const std::invalid_argument& iv) {
+        SILKRPC_WARN << "invalid_argument: " << iv.what() << " processing request: " << request.dump() << "\n";
+        write_json_content(reply, request["id"], logs);
+    } catch (const core::LogsQueryRejected& rejected) {
+        SILKRPC_WARN << "rejected: " << rejected.what() << " processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], -32005, rejected.what()).dump();
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], 100, e.what()).dump();
+    } catch (...) {
+        SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], 100, "unexpected exception").dump();
+    }
 
-        SILKRPC_DEBUG << "block_numbers.cardinality(): " << block_numbers.cardinality() << "\n";
+    co_await tx->close(); // RAII not (yet) available with coroutines
+    co_return;
+}
 
-        if (filter.topics.has_value()) {
-            auto topics_bitmap = co_await get_topics_bitmap(tx_database, filter.topics.value(), start, end);
-            SILKRPC_TRACE << "topics_bitmap: " << topics_bitmap.toString() << "\n";
-            if (topics_bitmap.isEmpty()) {
-                block_numbers = topics_bitmap;
-            } else {
-                block_numbers &= topics_bitmap;
-            }
-        }
-        SILKRPC_DEBUG << "block_numbers.cardinality(): " << block_numbers.cardinality() << "\n";
-        SILKRPC_TRACE << "block_numbers: " << block_numbers.toString() << "\n";
+//! Write the beginning of the eth_getLogs reply up to the opening of the result array
+static boost::asio::awaitable<void> open_get_logs_result(json::Stream& stream, uint32_t request_id) {
+    co_await stream.open_object();
+    co_await stream.write_field("id", request_id);
+    co_await stream.write_field("jsonrpc", "2.0");
+    co_await stream.write_field("result");
+    co_await stream.open_array();
+}
 
-        if (filter.addresses.has_value()) {
-            auto addresses_bitmap = co_await get_addresses_bitmap(tx_database, filter.addresses.value(), start, end);
-            if (addresses_bitmap.isEmpty()) {
-                block_numbers = addresses_bitmap;
-            } else {
-                block_numbers &= addresses_bitmap;
-            }
-        }
-        SILKRPC_DEBUG << "block_numbers.cardinality(): " << block_numbers.cardinality() << "\n";
-        SILKRPC_TRACE << "block_numbers: " << block_numbers.toString() << "\n";
+// https://eth.wiki/json-rpc/API#eth_getlogs
+boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_logs_stream(const nlohmann::json& request, json::Stream& stream) {
+    const auto& params = request["params"];
+    if (params.size() != 1) {
+        auto error_msg = "invalid eth_getLogs params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        co_await stream.write_json(make_json_error(request["id"], 100, error_msg));
+        co_return;
+    }
+    auto filter = params[0].get<Filter>();
+    SILKRPC_DEBUG << "filter: " << filter << "\n";
+    const auto request_id = request["id"].get<uint32_t>();
 
-        if (block_numbers.cardinality() == 0) {
-            reply = make_json_content(request["id"], logs);
-            co_await tx->close(); // RAII not (yet) available with coroutines
-            co_return;
-        }
+    auto tx = co_await database_->begin();
 
-        for (auto block_to_match : block_numbers) {
-            uint64_t log_index{0};
-
-            Logs filtered_block_logs{};
-            const auto block_key = silkworm::db::block_key(block_to_match);
-            SILKRPC_TRACE << "block_to_match: " << block_to_match << " block_key: " << silkworm::to_hex(block_key) << "\n";
-            co_await tx_database.for_prefix(db::table::kLogs, block_key, [&](const silkworm::Bytes& k, const silkworm::Bytes& v) {
-                Logs chunck_logs{};
-                const bool decoding_ok{cbor_decode(v, chunck_logs)};
-                if (!decoding_ok) {
-                    return false;
-                }
-                for (auto& log : chunck_logs) {
-                    log.index = log_index++;
-                }
-                SILKRPC_DEBUG << "chunck_logs.size(): " << chunck_logs.size() << "\n";
-                auto filtered_chunck_logs = filter_logs(chunck_logs, filter);
-                SILKRPC_DEBUG << "filtered_chunck_logs.size(): " << filtered_chunck_logs.size() << "\n";
-                if (filtered_chunck_logs.size() > 0) {
-                    const auto tx_id = boost::endian::load_big_u32(&k[sizeof(uint64_t)]);
-                    SILKRPC_DEBUG << "tx_id: " << tx_id << "\n";
-                    for (auto& log : filtered_chunck_logs) {
-                        log.tx_index = tx_id;
-                    }
-                    filtered_block_logs.insert(filtered_block_logs.end(), filtered_chunck_logs.begin(), filtered_chunck_logs.end());
-                }
-                return true;
-            });
-            SILKRPC_DEBUG << "filtered_block_logs.size(): " << filtered_block_logs.size() << "\n";
-
-            if (filtered_block_logs.size() > 0) {
-                const auto block_with_hash = co_await core::read_block_by_number(*block_cache_, tx_database, block_to_match);
-                SILKRPC_DEBUG << "block_hash: " << silkworm::to_hex(block_with_hash.hash) << "\n";
-                for (auto& log : filtered_block_logs) {
-                    const auto tx_hash{hash_of_transaction(block_with_hash.block.transactions[log.tx_index])};
-                    log.block_number = block_to_match;
-                    log.block_hash = block_with_hash.hash;
-                    log.tx_hash = silkworm::to_bytes32({tx_hash.bytes, silkworm::kHashLength});
+    // The logs are written block after block, so once the result has been started any error can just follow it
+    bool result_started{false};
+    std::size_t num_logs{0};
+    int32_t error_code{100};
+    std::optional<std::string> error_msg;
+    std::exception_ptr eptr;
+    try {
+        ethdb::MemoizedDatabase tx_database{*tx};
+
+        const auto block_numbers = co_await get_block_numbers(tx_database, filter, /*streamed=*/true);
+        const core::LogFilterMatcher matcher{filter};
+
+        co_await open_get_logs_result(stream, request_id);
+        result_started = true;
+
+        std::vector<Log> logs;
+        auto block_it = block_numbers.begin();
+        while (block_it != block_numbers.end() && !error_msg) {
+            logs.clear();
+            co_await get_next_logs(tx_database, filter, matcher, block_numbers, block_it, logs);
+            for (const auto& log : logs) {
+                if (num_logs == kGetLogsMaxStreamedResults || stream.bytes_written() >= kGetLogsMaxStreamedBytes) {
+                    error_code = -32005;
+                    error_msg = "query exceeds max results " + std::to_string(kGetLogsMaxStreamedResults) +
+                        " or max bytes " + std::to_string(kGetLogsMaxStreamedBytes) + ", result truncated";
+                    SILKRPC_WARN << *error_msg << " processing request: " << request.dump() << "\n";
+                    break;
                 }
-                logs.insert(logs.end(), filtered_block_logs.begin(), filtered_block_logs.end());
+                ++num_logs;
+                co_await stream.write_entry(log);
             }
         }
-        SILKRPC_INFO << "logs.size(): " << logs.size() << "\n";
-
-        reply = make_json_content(request["id"], logs);
+        SILKRPC_INFO << "num_logs: " << num_logs << " bytes_written: " << stream.bytes_written() << "\n";
     } catch (const std::invalid_argument& iv) {
         SILKRPC_WARN << "invalid_argument: " << iv.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_content(request["id"], logs);
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, e.what());
+        error_msg = e.what();
+        eptr = std::current_exception();
     } catch (...) {
         SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, "unexpected exception");
+        error_msg = "unexpected exception";
+        eptr = std::current_exception();
     }
 
     co_await tx->close(); // RAII not (yet) available with coroutines
-    co_return;
+
+    if (stream.failed()) {
+        std::rethrow_exception(eptr);
+    }
+    if (!result_started && error_msg) {
+        co_await stream.write_json(make_json_error(request_id, error_code, *error_msg));
+        co_return;
+    }
+    if (!result_started) {
+        co_await open_get_logs_result(stream, request_id);
+    }
+    co_await stream.close_array();
+    if (error_msg) {
+        co_await stream.write_field("error", nlohmann::json{{"code", error_code}, {"message", *error_msg}});
+    }
+    co_await stream.close_object();
 }
 
 // https://eth.wiki/json-rpc/API#eth_sendrawtransaction
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_send_raw_transaction(const nlohmann::json& request, nlohmann::json& reply) {
-    const auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 1) {
         auto error_msg = "invalid eth_sendRawTransaction params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -1565,11 +1948,13 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_send_raw_transaction(con
         co_return;
     }
 
-    silkworm::ByteView encoded_tx_view{*encoded_tx_bytes};
-    Transaction txn;
-    const auto err{silkworm::rlp::decode<silkworm::Transaction>(encoded_tx_view, txn)};
-    if (err != silkworm::DecodingResult::kOk) {
-        const auto error_msg = decoding_result_to_string(err);
+    // Decode and recover the sender on the workers, if enabled, so that the signature recovery does not stall the I/O
+    const auto& sender_recovery = context_.sender_recovery();
+    auto recovered = sender_recovery ? co_await sender_recovery->recover(*encoded_tx_bytes)
+        : core::SenderRecovery::decode_and_recover(*encoded_tx_bytes);
+    auto& txn = recovered.transaction;
+    if (recovered.result != silkworm::DecodingResult::kOk) {
+        const auto error_msg = decoding_result_to_string(recovered.result);
         SILKRPC_ERROR << error_msg << "\n";
         reply = make_json_error(request["id"], -32000, error_msg);
         co_return;
@@ -1599,7 +1984,6 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_send_raw_transaction(con
         co_return;
     }
 
-    txn.recover_sender();
     if (!txn.from.has_value()) {
         const auto error_msg = "cannot recover sender";
         SILKRPC_ERROR << error_msg << "\n";
@@ -1607,8 +1991,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_send_raw_transaction(con
         co_return;
     }
 
-    const auto ethash_hash{hash_of_transaction(txn)};
-    const auto hash = silkworm::to_bytes32({ethash_hash.bytes, silkworm::kHashLength});
+    const auto& hash = recovered.hash;
     if (!txn.to.has_value()) {
         const auto contract_address = silkworm::create_address(*txn.from, txn.nonce);
         SILKRPC_DEBUG << "submitted contract creation hash: " << hash << " from: " << *txn.from <<  " nonce: " << txn.nonce << " contract: " << contract_address <<
@@ -1627,7 +2010,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_send_transaction(const n
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         reply = make_json_content(request["id"], to_quantity(0));
     } catch (const std::exception& e) {
@@ -1647,7 +2030,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_sign_transaction(const n
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         reply = make_json_content(request["id"], to_quantity(0));
     } catch (const std::exception& e) {
@@ -1664,12 +2047,41 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_sign_transaction(const n
 
 // https://eth.wiki/json-rpc/API#eth_getproof
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_proof(const nlohmann::json& request, nlohmann::json& reply) {
+    const auto& params = request["params"];
+    if (params.size() != 3) {
+        auto error_msg = "invalid eth_getProof params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        reply = make_json_error(request["id"], 100, error_msg);
+        co_return;
+    }
+    const auto address = params[0].get<evmc::address>();
+    const auto locations = params[1].get<std::vector<evmc::bytes32>>();
+    const auto block_id = params[2].get<std::string>();
+    SILKRPC_DEBUG << "address: " << silkworm::to_hex(address) << " #locations: " << locations.size() << " block_id: " << block_id << "\n";
+
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
-
-        reply = make_json_content(request["id"], to_quantity(0));
+        ethdb::MemoizedDatabase tx_database{*tx};
+        const auto [block_number, is_latest_block] = co_await core::get_block_number(block_id, tx_database, /*latest_required=*/true);
+        if (!is_latest_block) {
+            // The trie tables hold just the nodes of the latest state
+            const auto error_msg = "proofs are available only for the latest block, requested block: " + std::to_string(block_number);
+            SILKRPC_ERROR << error_msg << "\n";
+            reply = make_json_error(request["id"], 100, error_msg);
+        } else {
+            core::ProofBuilder proof_builder{*tx, context_.trie_node_cache().get()};
+            const auto account_proof = co_await proof_builder.build_proof(address, locations);
+            const auto header = co_await core::rawdb::read_header_by_number(tx_database, block_number);
+            if (proof_builder.state_root() != header.state_root) {
+                // The intermediate hashes stage may lag behind the execution one
+                const auto error_msg = "trie not up to date with block: " + std::to_string(block_number);
+                SILKRPC_ERROR << error_msg << " state root: 0x" << proof_builder.state_root() << "\n";
+                reply = make_json_error(request["id"], 100, error_msg);
+            } else {
+                reply = make_json_content(request["id"], account_proof);
+            }
+        }
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
         reply = make_json_error(request["id"], 100, e.what());
@@ -1741,7 +2153,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_hashrate(const nlohmann:
 
 // https://eth.wiki/json-rpc/API#eth_submithashrate
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_submit_hashrate(const nlohmann::json& request, nlohmann::json& reply) {
-    const auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 2) {
         const auto error_msg = "invalid eth_submitHashrate params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -1772,6 +2184,13 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_submit_hashrate(const nl
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_work(const nlohmann::json& request, nlohmann::json& reply) {
     try {
         const auto work = co_await miner_->get_work();
+        if (context_.work_verifier()) {
+            uint64_t block_number{0};
+            for (const auto byte : work.block_number) {
+                block_number = (block_number << 8) | byte;
+            }
+            context_.work_verifier()->add_work(work.header_hash, work.target, block_number);
+        }
         const std::vector<std::string> current_work{
             silkworm::to_hex(work.header_hash),
             silkworm::to_hex(work.seed_hash),
@@ -1795,7 +2214,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_get_work(const nlohmann:
 
 // https://eth.wiki/json-rpc/API#eth_submitwork
 boost::asio::awaitable<void> EthereumRpcApi::handle_eth_submit_work(const nlohmann::json& request, nlohmann::json& reply) {
-    const auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 3) {
         const auto error_msg = "invalid eth_submitWork params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -1813,6 +2232,15 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_submit_work(const nlohma
         }
         const auto pow_hash = params[1].get<evmc::bytes32>();
         const auto digest = params[2].get<evmc::bytes32>();
+        // Reject locally the invalid solutions of the known work packages, the remote miner having the last word otherwise
+        if (context_.work_verifier() && block_nonce->size() == sizeof(uint64_t)) {
+            const auto valid = co_await context_.work_verifier()->verify(boost::endian::load_big_u64(block_nonce->data()), pow_hash, digest);
+            if (valid && !*valid) {
+                SILKRPC_WARN << "invalid proof of work submitted for: " << pow_hash << "\n";
+                reply = make_json_content(request["id"], false);
+                co_return;
+            }
+        }
         const auto success = co_await miner_->submit_work(block_nonce.value(), pow_hash, digest);
         reply = make_json_content(request["id"], success);
     } catch (const boost::system::system_error& se) {
@@ -1834,7 +2262,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_subscribe(const nlohmann
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         reply = make_json_content(request["id"], to_quantity(0));
     } catch (const std::exception& e) {
@@ -1854,7 +2282,7 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_unsubscribe(const nlohma
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         reply = make_json_content(request["id"], to_quantity(0));
     } catch (const std::exception& e) {
@@ -1869,89 +2297,286 @@ boost::asio::awaitable<void> EthereumRpcApi::handle_eth_unsubscribe(const nlohma
     co_return;
 }
 
-boost::asio::awaitable<roaring::Roaring> EthereumRpcApi::get_topics_bitmap(core::rawdb::DatabaseReader& db_reader, FilterTopics& topics, uint64_t start, uint64_t end) {
-    SILKRPC_DEBUG << "#topics: " << topics.size() << " start: " << start << " end: " << end << "\n";
-    roaring::Roaring result_bitmap;
-    for (auto subtopics : topics) {
-        SILKRPC_DEBUG << "#subtopics: " << subtopics.size() << "\n";
-        roaring::Roaring subtopic_bitmap;
-        for (auto topic : subtopics) {
-            silkworm::Bytes topic_key{std::begin(topic.bytes), std::end(topic.bytes)};
-            SILKRPC_TRACE << "topic: " << topic << " topic_key: " << silkworm::to_hex(topic) <<"\n";
-            auto bitmap = co_await ethdb::bitmap::get(db_reader, db::table::kLogTopicIndex, topic_key, start, end);
-            SILKRPC_TRACE << "bitmap: " << bitmap.toString() << "\n";
-            subtopic_bitmap |= bitmap;
-            SILKRPC_TRACE << "subtopic_bitmap: " << subtopic_bitmap.toString() << "\n";
+boost::asio::awaitable<roaring::Roaring> EthereumRpcApi::get_block_numbers(core::rawdb::DatabaseReader& db_reader, Filter& filter, bool streamed) {
+    uint64_t start{}, end{};
+    if (filter.block_hash.has_value()) {
+        auto block_hash_bytes = silkworm::from_hex(filter.block_hash.value());
+        if (!block_hash_bytes.has_value()) {
+            throw std::runtime_error{"invalid eth_getLogs filter block_hash: " + filter.block_hash.value()};
         }
-        if (!subtopic_bitmap.isEmpty()) {
-            if (result_bitmap.isEmpty()) {
-                result_bitmap = subtopic_bitmap;
-            } else {
-                result_bitmap &= subtopic_bitmap;
+        auto block_hash = silkworm::to_bytes32(block_hash_bytes.value());
+        auto block_number = co_await core::rawdb::read_header_number(db_reader, block_hash);
+        start = end = block_number;
+    } else {
+        uint64_t last_executed_block_number = std::numeric_limits<std::uint64_t>::max();
+        if (filter.from_block.has_value()) {
+           start = filter.from_block.value();
+        } else {
+           last_executed_block_number = co_await core::get_latest_executed_block_number(db_reader);
+           start = last_executed_block_number;
+        }
+        if (filter.to_block.has_value()) {
+           end = filter.to_block.value();
+        } else {
+           if (last_executed_block_number == std::numeric_limits<std::uint64_t>::max()) {
+              last_executed_block_number = co_await core::get_latest_executed_block_number(db_reader);
+           }
+           end = last_executed_block_number;
+        }
+    }
+    const auto plan = core::plan_logs_query(filter, start, end);
+    SILKRPC_INFO << "eth_getLogs plan: " << plan << " streamed: " << std::boolalpha << streamed << "\n";
+
+    roaring::Roaring block_numbers;
+    switch (plan.kind) {
+        case core::LogsPlanKind::none:
+            co_return block_numbers;
+        case core::LogsPlanKind::scan:
+            // Streaming keeps the memory bounded and is capped anyway, while the whole reply must be held otherwise
+            if (!streamed && plan.num_blocks() > kGetLogsMaxScanBlocks) {
+                throw core::LogsQueryRejected{"query without addresses nor topics exceeds max block range " +
+                    std::to_string(kGetLogsMaxScanBlocks) + ", narrow the range or add some filter"};
+            }
+            block_numbers.addRange(start, end + 1); // [min, max)
+            co_return block_numbers;
+        case core::LogsPlanKind::bloom:
+            co_await add_bloom_matching_blocks(db_reader, filter, start, end, block_numbers);
+            SILKRPC_DEBUG << "block_numbers.cardinality(): " << block_numbers.cardinality() << "\n";
+            co_return block_numbers;
+        case core::LogsPlanKind::bitmap:
+            break;
+    }
+
+    block_numbers.addRange(start, end + 1); // [min, max)
+
+    // Addresses come first because usually they are the most selective, so that the topics are read just where needed
+    std::vector<ethdb::bitmap::QueryTerm> terms;
+    if (filter.addresses) {
+        auto& term = terms.emplace_back(ethdb::bitmap::QueryTerm{db::table::kLogAddressIndex, {}});
+        for (const auto& address : filter.addresses.value()) {
+            term.keys.emplace_back(std::begin(address.bytes), std::end(address.bytes));
+        }
+    }
+    if (filter.topics) {
+        for (const auto& subtopics : filter.topics.value()) {
+            SILKRPC_DEBUG << "#subtopics: " << subtopics.size() << "\n";
+            auto& term = terms.emplace_back(ethdb::bitmap::QueryTerm{db::table::kLogTopicIndex, {}});
+            for (const auto& topic : subtopics) {
+                term.keys.emplace_back(std::begin(topic.bytes), std::end(topic.bytes));
             }
         }
-        SILKRPC_DEBUG << "result_bitmap: " << result_bitmap.toString() << "\n";
     }
-    co_return result_bitmap;
+    const auto matching_blocks = co_await ethdb::bitmap::query(db_reader, terms, start, end, context_.bitmap_cache().get());
+    if (matching_blocks) {
+        SILKRPC_TRACE << "matching_blocks: " << matching_blocks->toString() << "\n";
+        block_numbers &= matching_blocks.value();
+    }
+    SILKRPC_DEBUG << "block_numbers.cardinality(): " << block_numbers.cardinality() << "\n";
+    SILKRPC_TRACE << "block_numbers: " << block_numbers.toString() << "\n";
+
+    co_return block_numbers;
 }
 
-boost::asio::awaitable<roaring::Roaring> EthereumRpcApi::get_addresses_bitmap(core::rawdb::DatabaseReader& db_reader, FilterAddresses& addresses, uint64_t start, uint64_t end) {
-    SILKRPC_TRACE << "#addresses: " << addresses.size() << " start: " << start << " end: " << end << "\n";
-    roaring::Roaring result_bitmap;
-    for (auto address : addresses) {
-        silkworm::Bytes address_key{std::begin(address.bytes), std::end(address.bytes)};
-        auto bitmap = co_await ethdb::bitmap::get(db_reader, db::table::kLogAddressIndex, address_key, start, end);
-        SILKRPC_TRACE << "bitmap: " << bitmap.toString() << "\n";
-        result_bitmap |= bitmap;
-    }
-    SILKRPC_TRACE << "result_bitmap: " << result_bitmap.toString() << "\n";
-    co_return result_bitmap;
+boost::asio::awaitable<void> EthereumRpcApi::add_bloom_matching_blocks(core::rawdb::DatabaseReader& db_reader, const Filter& filter,
+    uint64_t start, uint64_t end, roaring::Roaring& block_numbers) {
+    // The blocks not executed yet have no logs, so their headers (if any) are not read at all
+    const auto last_block = std::min(end, co_await core::get_latest_executed_block_number(db_reader));
+    const core::LogsBloomMatcher matcher{filter};
+    const auto& header_cache = context_.header_cache();
+    for (auto block_number{start}; block_number <= last_block; ++block_number) {
+        bool may_match{false};
+        if (header_cache) {
+            const auto header{co_await core::read_header_by_number(*header_cache, db_reader, block_number)};
+            may_match = matcher.may_match(header->logs_bloom);
+        } else {
+            const auto header{co_await core::rawdb::read_header_by_number(db_reader, block_number)};
+            may_match = matcher.may_match(header.logs_bloom);
+        }
+        if (may_match) {
+            block_numbers.add(static_cast<uint32_t>(block_number));
+        }
+    }
 }
 
-std::vector<Log> EthereumRpcApi::filter_logs(std::vector<Log>& logs, const Filter& filter) {
-    std::vector<Log> filtered_logs;
+boost::asio::awaitable<void> EthereumRpcApi::get_next_logs(core::rawdb::DatabaseReader& db_reader, const Filter& filter,
+    const core::LogFilterMatcher& matcher, const roaring::Roaring& block_numbers, roaring::Roaring::const_iterator& block_it, std::vector<Log>& logs) {
+    constexpr std::size_t kMaxBlocksPerWindow{kGetLogsBlocksPerChunk * kGetLogsMaxConcurrentChunks};
+    std::vector<uint32_t> window_blocks;
+    window_blocks.reserve(kMaxBlocksPerWindow);
+    for (; block_it != block_numbers.end() && window_blocks.size() < kMaxBlocksPerWindow; ++block_it) {
+        window_blocks.push_back(*block_it);
+    }
+    SILKRPC_DEBUG << "window_blocks.size(): " << window_blocks.size() << "\n";
+
+    if (window_blocks.size() <= kGetLogsBlocksPerChunk) {
+        for (const auto block_to_match : window_blocks) {
+            co_await get_block_logs(db_reader, filter, matcher, block_to_match, logs);
+        }
+        co_return;
+    }
 
-    auto addresses = filter.addresses;
-    auto topics = filter.topics;
-    SILKRPC_DEBUG << "filter.addresses: " << filter.addresses << "\n";
-    for (auto log : logs) {
-        SILKRPC_DEBUG << "log: " << log << "\n";
-        if (addresses.has_value() && std::find(addresses.value().begin(), addresses.value().end(), log.address) == addresses.value().end()) {
-            SILKRPC_DEBUG << "skipped log for address: 0x" << silkworm::to_hex(log.address) << "\n";
-            continue;
+    // Scan the chunks of matched blocks concurrently, each one within its own transaction, then merge them in order
+    const auto num_chunks = (window_blocks.size() + kGetLogsBlocksPerChunk - 1) / kGetLogsBlocksPerChunk;
+    std::vector<std::vector<Log>> chunk_logs(num_chunks);
+    const auto executor = co_await boost::asio::this_coro::executor;
+    co_await parallel_for(executor, num_chunks, kGetLogsMaxConcurrentChunks, [&](std::size_t chunk) -> boost::asio::awaitable<void> {
+        const auto chunk_begin = chunk * kGetLogsBlocksPerChunk;
+        const auto chunk_end = std::min(chunk_begin + kGetLogsBlocksPerChunk, window_blocks.size());
+        auto chunk_tx = co_await database_->begin();
+        std::exception_ptr chunk_exception;
+        try {
+            ethdb::TransactionDatabase chunk_database{*chunk_tx};
+            for (auto i{chunk_begin}; i < chunk_end; ++i) {
+                co_await get_block_logs(chunk_database, filter, matcher, window_blocks[i], chunk_logs[chunk]);
+            }
+        } catch (...) {
+            chunk_exception = std::current_exception();
         }
-        auto matches = true;
-        if (topics.has_value()) {
-            if (topics.value().size() > log.topics.size()) {
-                SILKRPC_DEBUG << "#topics: " << topics.value().size() << " #log.topics: " << log.topics.size() << "\n";
+        co_await chunk_tx->close(); // RAII not (yet) available with coroutines
+        if (chunk_exception) {
+            std::rethrow_exception(chunk_exception);
+        }
+    });
+    for (auto& logs_in_chunk : chunk_logs) {
+        logs.insert(logs.end(), std::make_move_iterator(logs_in_chunk.begin()), std::make_move_iterator(logs_in_chunk.end()));
+    }
+}
+
+boost::asio::awaitable<void> EthereumRpcApi::get_block_logs(core::rawdb::DatabaseReader& db_reader, const Filter& filter,
+    const core::LogFilterMatcher& matcher, uint64_t block_to_match, std::vector<Log>& logs) {
+    Logs filtered_block_logs{};
+    // Add the matching logs emitted by one transaction, returning their total number or nothing if not decoded
+    // Just the logs matching the filter are materialized, the others are skipped while decoding
+    const LogMatcher match = [&](const LogView& log) { return matcher.match(log); };
+    // The logs decoded while scanning the whole block are also summarized in the transaction Bloom filter, if given
+    const auto add_tx_logs = [&](uint32_t tx_id, uint32_t first_log_index, const silkworm::Bytes& v,
+                                 ethdb::file::LogBloom* bloom) -> std::optional<uint32_t> {
+        const auto first_filtered{filtered_block_logs.size()};
+        const auto num_logs{bloom == nullptr ? cbor_decode(v, match, filtered_block_logs) : cbor_decode(v, [&](const LogView& log) {
+            ethdb::file::LogIndex::add(*bloom, log.address);
+            for (const auto& topic : log.topics) {
+                ethdb::file::LogIndex::add(*bloom, topic);
+            }
+            return match(log);
+        }, filtered_block_logs)};
+        if (!num_logs) {
+            return std::nullopt;
+        }
+        SILKRPC_DEBUG << "tx_id: " << tx_id << " #logs: " << *num_logs << " #filtered: " << filtered_block_logs.size() - first_filtered << "\n";
+        for (auto i{first_filtered}; i < filtered_block_logs.size(); ++i) {
+            filtered_block_logs[i].index += first_log_index;
+            filtered_block_logs[i].tx_index = tx_id;
+        }
+        return static_cast<uint32_t>(*num_logs);
+    };
+
+    const auto block_key = silkworm::db::block_key(block_to_match);
+    SILKRPC_TRACE << "block_to_match: " << block_to_match << " block_key: " << silkworm::to_hex(block_key) << "\n";
+    const auto& block_log_index = context_.log_index();
+    const auto indexed_entries = block_log_index ? block_log_index->get(block_to_match) : std::nullopt;
+    // The blocks not in the log index are served by their cached log offset table, once the whole block has been scanned
+    const auto& log_offset_cache = context_.log_offset_cache();
+    const auto cached_offsets = !indexed_entries && log_offset_cache ? log_offset_cache->find(block_to_match) : nullptr;
+    const auto* entries = indexed_entries ? &*indexed_entries : cached_offsets ? &cached_offsets->entries : nullptr;
+    if (entries != nullptr) {
+        // The block is indexed, so just the transactions whose Bloom filter may match are read (if any)
+        std::vector<silkworm::Bytes> tx_keys;
+        std::vector<const ethdb::file::TxLogBloom*> tx_entries;
+        for (const auto& entry : *entries) {
+            if (ethdb::file::LogIndex::may_match(entry.bloom, filter)) {
+                silkworm::Bytes tx_key(block_key.size() + sizeof(uint32_t), '\0');
+                std::copy(block_key.cbegin(), block_key.cend(), tx_key.begin());
+                boost::endian::store_big_u32(&tx_key[block_key.size()], entry.tx_index);
+                tx_keys.push_back(std::move(tx_key));
+                tx_entries.push_back(&entry);
+            }
+        }
+        SILKRPC_DEBUG << "indexed block: " << block_to_match << " #entries: " << entries->size() << " #candidates: " << tx_entries.size() << "\n";
+        if (tx_entries.empty()) {
+            co_return;
+        }
+        const auto values = co_await db_reader.get_many(db::table::kLogs, tx_keys);
+        for (std::size_t i{0}; i < values.size(); ++i) {
+            if (values[i].empty()) {
                 continue;
             }
-            for (size_t i{0}; i < topics.value().size(); i++) {
-                SILKRPC_DEBUG << "log.topics[i]: " << log.topics[i] << "\n";
-                auto subtopics = topics.value()[i];
-                auto matches_subtopics = subtopics.empty(); // empty rule set == wildcard
-                SILKRPC_TRACE << "matches_subtopics: " << std::boolalpha << matches_subtopics << "\n";
-                for (auto topic : subtopics) {
-                    SILKRPC_DEBUG << "topic: " << topic << "\n";
-                    if (log.topics[i] == topic) {
-                        matches_subtopics = true;
-                        SILKRPC_TRACE << "matches_subtopics: " << matches_subtopics << "\n";
-                        break;
-                    }
-                }
-                if (!matches_subtopics) {
-                    SILKRPC_TRACE << "No subtopic matches\n";
-                    matches = false;
-                    break;
-                }
+            if (!add_tx_logs(tx_entries[i]->tx_index, tx_entries[i]->first_log_index, values[i], nullptr)) {
+                break;
             }
         }
-        SILKRPC_DEBUG << "matches: " << matches << "\n";
-        if (matches) {
-            filtered_logs.push_back(log);
+    } else {
+        // The log offset table is built while scanning, then cached unless some logs cannot be decoded
+        const auto read_generation = log_offset_cache ? log_offset_cache->generation() : 0;
+        std::vector<ethdb::file::TxLogBloom> scanned_entries;
+        bool scan_completed{true};
+        uint32_t log_index{0};
+        co_await db_reader.for_prefix(db::table::kLogs, block_key, [&](const silkworm::Bytes& k, const silkworm::Bytes& v) {
+            const auto tx_id = boost::endian::load_big_u32(&k[sizeof(uint64_t)]);
+            ethdb::file::TxLogBloom entry{tx_id, log_index, {}};
+            const auto num_logs = add_tx_logs(tx_id, log_index, v, log_offset_cache ? &entry.bloom : nullptr);
+            if (!num_logs) {
+                scan_completed = false;
+                return false;
+            }
+            if (log_offset_cache && *num_logs > 0) {
+                scanned_entries.push_back(entry);
+            }
+            log_index += *num_logs;
+            return true;
+        });
+        if (log_offset_cache && scan_completed) {
+            log_offset_cache->store(block_to_match, std::move(scanned_entries), read_generation);
+        }
+    }
+    SILKRPC_DEBUG << "filtered_block_logs.size(): " << filtered_block_logs.size() << "\n";
+
+    if (filtered_block_logs.size() > 0) {
+        // Just the hashes of the transactions emitting the matching logs are needed, not the whole block
+        std::vector<uint32_t> tx_indexes;
+        tx_indexes.reserve(filtered_block_logs.size());
+        for (const auto& log : filtered_block_logs) {
+            tx_indexes.push_back(log.tx_index);
+        }
+        std::sort(tx_indexes.begin(), tx_indexes.end());
+        tx_indexes.erase(std::unique(tx_indexes.begin(), tx_indexes.end()), tx_indexes.end());
+        const auto block_tx_hashes = co_await core::read_transaction_hashes(*block_cache_, db_reader, block_to_match, tx_indexes);
+        SILKRPC_DEBUG << "block_hash: " << silkworm::to_hex(block_tx_hashes.block_hash) << " #tx_hashes: " << tx_indexes.size() << "\n";
+        for (auto& log : filtered_block_logs) {
+            const auto position = std::lower_bound(tx_indexes.begin(), tx_indexes.end(), log.tx_index) - tx_indexes.begin();
+            log.block_number = block_to_match;
+            log.block_hash = block_tx_hashes.block_hash;
+            log.tx_hash = block_tx_hashes.transaction_hashes[static_cast<std::size_t>(position)];
         }
+        logs.insert(logs.end(), filtered_block_logs.begin(), filtered_block_logs.end());
     }
-    return filtered_logs;
+}
+
+boost::asio::awaitable<std::shared_ptr<const std::string>> EthereumRpcApi::get_block_json(const core::rawdb::DatabaseReader& db_reader,
+    const silkworm::BlockWithHash& block_with_hash, bool full_tx, const FieldProjection& projection) {
+    const auto block_number = block_with_hash.block.header.number;
+    if (!projection.is_full()) {
+        // The projected JSON is specific to the request, so it is never cached and the total difficulty read only if needed
+        intx::uint256 total_difficulty{0};
+        if (is_selected(projection.fields, block_field::total_difficulty)) {
+            total_difficulty = co_await core::rawdb::read_total_difficulty(db_reader, block_with_hash.hash, block_number);
+        }
+        const Block extended_block{block_with_hash, total_difficulty, full_tx, block_cache_->hashes(block_with_hash)};
+        std::string extended_block_json;
+        write_json(extended_block_json, extended_block, projection);
+        co_return std::make_shared<const std::string>(std::move(extended_block_json));
+    }
+    // The JSON of a block depends just on its hash, including the total difficulty, so it is never stale
+    auto& block_json_cache = block_cache_->block_json(full_tx);
+    auto block_json = block_json_cache.get(block_with_hash.hash);
+    if (!block_json) {
+        const auto total_difficulty = co_await core::rawdb::read_total_difficulty(db_reader, block_with_hash.hash, block_number);
+        const Block extended_block{block_with_hash, total_difficulty, full_tx, block_cache_->hashes(block_with_hash)};
+        std::string extended_block_json;
+        write_json(extended_block_json, extended_block);
+        block_json = std::make_shared<const std::string>(std::move(extended_block_json));
+        block_json_cache.insert(block_with_hash.hash, block_json);
+    }
+    co_return block_json;
 }
 
 } // namespace silkrpc::commands
@@ -18,6 +18,7 @@
 #define SILKRPC_COMMANDS_ETH_API_HPP_
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <silkrpc/config.hpp> // NOLINT(build/include_order)
@@ -30,8 +31,11 @@
 #include <silkrpc/txpool/transaction_pool.hpp>
 #include <silkworm/types/receipt.hpp>
 #include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/core/log_filter_matcher.hpp>
 #include <silkrpc/core/rawdb/accessors.hpp>
 #include <silkrpc/croaring/roaring.hh>
+#include <silkrpc/json/projection.hpp>
+#include <silkrpc/json/stream.hpp>
 #include <silkrpc/json/types.hpp>
 #include <silkrpc/ethbackend/backend.hpp>
 #include <silkrpc/ethdb/database.hpp>
@@ -48,6 +52,7 @@ public:
     explicit EthereumRpcApi(Context& context, boost::asio::thread_pool& workers)
         : context_(context),
           block_cache_(context.block_cache()),
+          receipt_cache_(context.receipt_cache()),
           state_cache_(context.state_cache()),
           database_(context.database()),
           backend_(context.backend()),
@@ -66,27 +71,31 @@ protected:
     boost::asio::awaitable<void> handle_eth_protocol_version(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_syncing(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_gas_price(const nlohmann::json& request, nlohmann::json& reply);
-    boost::asio::awaitable<void> handle_eth_get_block_by_hash(const nlohmann::json& request, nlohmann::json& reply);
-    boost::asio::awaitable<void> handle_eth_get_block_by_number(const nlohmann::json& request, nlohmann::json& reply);
+    boost::asio::awaitable<void> handle_eth_fee_history(const nlohmann::json& request, nlohmann::json& reply);
+    boost::asio::awaitable<void> handle_eth_get_block_by_hash(const nlohmann::json& request, std::string& reply);
+    boost::asio::awaitable<void> handle_eth_get_block_by_number(const nlohmann::json& request, std::string& reply);
     boost::asio::awaitable<void> handle_eth_get_block_transaction_count_by_hash(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_get_block_transaction_count_by_number(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_get_uncle_by_block_hash_and_index(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_get_uncle_by_block_number_and_index(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_get_uncle_count_by_block_hash(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_get_uncle_count_by_block_number(const nlohmann::json& request, nlohmann::json& reply);
-    boost::asio::awaitable<void> handle_eth_get_transaction_by_hash(const nlohmann::json& request, nlohmann::json& reply);
+    boost::asio::awaitable<void> handle_eth_get_transaction_by_hash(const nlohmann::json& request, std::string& reply);
     boost::asio::awaitable<void> handle_eth_get_transaction_by_block_hash_and_index(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_get_transaction_by_block_number_and_index(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_get_raw_transaction_by_hash(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_get_raw_transaction_by_block_hash_and_index(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_get_raw_transaction_by_block_number_and_index(const nlohmann::json& request, nlohmann::json& reply);
-    boost::asio::awaitable<void> handle_eth_get_transaction_receipt(const nlohmann::json& request, nlohmann::json& reply);
+    boost::asio::awaitable<void> handle_eth_get_transaction_receipt(const nlohmann::json& request, std::string& reply);
+    boost::asio::awaitable<void> handle_eth_get_block_receipts(const nlohmann::json& request, std::string& reply);
     boost::asio::awaitable<void> handle_eth_estimate_gas(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_get_balance(const nlohmann::json& request, nlohmann::json& reply);
+    boost::asio::awaitable<void> handle_eth_get_balance_many(const std::vector<const nlohmann::json*>& requests, std::vector<nlohmann::json>& replies);
     boost::asio::awaitable<void> handle_eth_get_code(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_get_transaction_count(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_get_storage_at(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_call(const nlohmann::json& request, nlohmann::json& reply);
+    boost::asio::awaitable<void> handle_eth_call_many(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_call_bundle(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_create_access_list(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_new_filter(const nlohmann::json& request, nlohmann::json& reply);
@@ -94,7 +103,8 @@ protected:
     boost::asio::awaitable<void> handle_eth_new_pending_transaction_filter(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_get_filter_changes(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_uninstall_filter(const nlohmann::json& request, nlohmann::json& reply);
-    boost::asio::awaitable<void> handle_eth_get_logs(const nlohmann::json& request, nlohmann::json& reply);
+    boost::asio::awaitable<void> handle_eth_get_logs(const nlohmann::json& request, std::string& reply);
+    boost::asio::awaitable<void> handle_eth_get_logs_stream(const nlohmann::json& request, json::Stream& stream);
     boost::asio::awaitable<void> handle_eth_send_raw_transaction(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_send_transaction(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_sign_transaction(const nlohmann::json& request, nlohmann::json& reply);
@@ -107,13 +117,26 @@ protected:
     boost::asio::awaitable<void> handle_eth_submit_work(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_subscribe(const nlohmann::json& request, nlohmann::json& reply);
     boost::asio::awaitable<void> handle_eth_unsubscribe(const nlohmann::json& request, nlohmann::json& reply);
-    boost::asio::awaitable<roaring::Roaring> get_topics_bitmap(core::rawdb::DatabaseReader& db_reader, FilterTopics& topics, uint64_t start, uint64_t end);
-    boost::asio::awaitable<roaring::Roaring> get_addresses_bitmap(core::rawdb::DatabaseReader& db_reader, FilterAddresses& addresses, uint64_t start, uint64_t end);
-
-    std::vector<Log> filter_logs(std::vector<Log>& logs, const Filter& filter);
+    //! Get the numbers of the blocks in the filter range possibly matching the filter, according to the plan chosen by
+    //! core::plan_logs_query: wide range scans are rejected unless the reply is streamed
+    boost::asio::awaitable<roaring::Roaring> get_block_numbers(core::rawdb::DatabaseReader& db_reader, Filter& filter, bool streamed);
+    //! Add the numbers of the blocks in [start, end] whose header logsBloom may match the filter
+    boost::asio::awaitable<void> add_bloom_matching_blocks(core::rawdb::DatabaseReader& db_reader, const Filter& filter, uint64_t start, uint64_t end,
+        roaring::Roaring& block_numbers);
+    //! Append the logs matching the filter in the next window of block numbers, advancing the block iterator past it
+    boost::asio::awaitable<void> get_next_logs(core::rawdb::DatabaseReader& db_reader, const Filter& filter, const core::LogFilterMatcher& matcher,
+        const roaring::Roaring& block_numbers, roaring::Roaring::const_iterator& block_it, std::vector<Log>& logs);
+    //! Append the logs of the given block matching the filter, checked by the matcher prepared once for the whole query
+    boost::asio::awaitable<void> get_block_logs(core::rawdb::DatabaseReader& db_reader, const Filter& filter, const core::LogFilterMatcher& matcher,
+        uint64_t block_to_match, std::vector<Log>& logs);
+
+    //! Get the serialized JSON of the block, built once and kept along with the block in the block cache unless projected
+    boost::asio::awaitable<std::shared_ptr<const std::string>> get_block_json(const core::rawdb::DatabaseReader& db_reader,
+        const silkworm::BlockWithHash& block_with_hash, bool full_tx, const FieldProjection& projection = {});
 
     Context& context_;
     std::shared_ptr<BlockCache>& block_cache_;
+    std::shared_ptr<ReceiptCache>& receipt_cache_;
     std::shared_ptr<ethdb::kv::StateCache>& state_cache_;
     std::unique_ptr<ethdb::Database>& database_;
     std::unique_ptr<ethbackend::BackEnd>& backend_;
@@ -41,6 +41,7 @@ public:
     explicit EthereumRpcApiTest(Context& context, boost::asio::thread_pool& workers) : EthereumRpcApi{context, workers} {}
 
     using EthereumRpcApi::handle_eth_block_number;
+    using EthereumRpcApi::handle_eth_call_many;
     using EthereumRpcApi::handle_eth_send_raw_transaction;
 };
 
@@ -116,4 +117,77 @@ TEST_CASE("handle_eth_send_raw_transaction fails wrong number digit", "[silkrpc]
 */
 }
 
+TEST_CASE("handle_eth_call_many fails if request malformed", "[silkrpc][eth_api]") {
+    nlohmann::json reply;
+
+    SECTION("no params") {
+        test_eth_api(&EthereumRpcApiTest::handle_eth_call_many, R"({
+            "jsonrpc":"2.0",
+            "id":1,
+            "method":"eth_callMany",
+            "params":[]
+        })"_json, reply);
+        CHECK(reply == R"({
+            "jsonrpc":"2.0",
+            "id":1,
+            "error":{"code":100,"message":"invalid eth_callMany params: []"}
+        })"_json);
+    }
+
+    SECTION("calls not in array") {
+        test_eth_api(&EthereumRpcApiTest::handle_eth_call_many, R"({
+            "jsonrpc":"2.0",
+            "id":1,
+            "method":"eth_callMany",
+            "params":[{"to":"0x0715a7794a1dc8e42615f059dd6e406a6594651a"},"latest"]
+        })"_json, reply);
+        CHECK(reply["error"]["code"] == 100);
+        CHECK(reply["error"]["message"].get<std::string>().starts_with("invalid eth_callMany params"));
+    }
+
+    SECTION("call not an object") {
+        test_eth_api(&EthereumRpcApiTest::handle_eth_call_many, R"({
+            "jsonrpc":"2.0",
+            "id":1,
+            "method":"eth_callMany",
+            "params":[[1],"latest"]
+        })"_json, reply);
+        CHECK(reply["error"]["code"] == 100);
+        CHECK(reply["error"]["message"].get<std::string>().starts_with("invalid eth_callMany params"));
+    }
+
+    SECTION("call having invalid field") {
+        test_eth_api(&EthereumRpcApiTest::handle_eth_call_many, R"({
+            "jsonrpc":"2.0",
+            "id":1,
+            "method":"eth_callMany",
+            "params":[[{"from":"0x0715a7794a1dc8e42615f059dd6e406a6594651a","gas":"zz"}],"latest"]
+        })"_json, reply);
+        CHECK(reply["error"]["code"] == 100);
+        CHECK(reply["error"]["message"].get<std::string>().starts_with("invalid eth_callMany params"));
+    }
+
+    SECTION("block not a string") {
+        test_eth_api(&EthereumRpcApiTest::handle_eth_call_many, R"({
+            "jsonrpc":"2.0",
+            "id":1,
+            "method":"eth_callMany",
+            "params":[[],{"blockNumber":"0x1"}]
+        })"_json, reply);
+        CHECK(reply["error"]["code"] == 100);
+        CHECK(reply["error"]["message"].get<std::string>().starts_with("invalid eth_callMany params"));
+    }
+
+    SECTION("too many params") {
+        test_eth_api(&EthereumRpcApiTest::handle_eth_call_many, R"({
+            "jsonrpc":"2.0",
+            "id":1,
+            "method":"eth_callMany",
+            "params":[[],"latest","0x1"]
+        })"_json, reply);
+        CHECK(reply["error"]["code"] == 100);
+        CHECK(reply["error"]["message"].get<std::string>().starts_with("invalid eth_callMany params"));
+    }
+}
+
 } // namespace silkrpc::commands
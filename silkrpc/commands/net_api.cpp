@@ -32,7 +32,14 @@ boost::asio::awaitable<void> NetRpcApi::handle_net_listening(const nlohmann::jso
 // https://eth.wiki/json-rpc/API#net_peercount
 boost::asio::awaitable<void> NetRpcApi::handle_net_peer_count(const nlohmann::json& request, nlohmann::json& reply) {
     try {
-        const auto peer_count = co_await backend_->net_peer_count();
+        // Served from the values refreshed in background, if any
+        const auto info = backend_info_cache_ ? backend_info_cache_->get() : nullptr;
+        uint64_t peer_count{0};
+        if (info) {
+            peer_count = info->peer_count;
+        } else {
+            peer_count = co_await backend_->net_peer_count();
+        }
         reply = make_json_content(request["id"], to_quantity(peer_count));
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
@@ -46,7 +53,13 @@ boost::asio::awaitable<void> NetRpcApi::handle_net_peer_count(const nlohmann::js
 // https://eth.wiki/json-rpc/API#net_version
 boost::asio::awaitable<void> NetRpcApi::handle_net_version(const nlohmann::json& request, nlohmann::json& reply) {
     try {
-        const auto net_version = co_await backend_->net_version();
+        const auto info = backend_info_cache_ ? backend_info_cache_->get() : nullptr;
+        uint64_t net_version{0};
+        if (info) {
+            net_version = info->net_version;
+        } else {
+            net_version = co_await backend_->net_version();
+        }
         reply = make_json_content(request["id"], std::to_string(net_version));
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
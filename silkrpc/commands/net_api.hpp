@@ -27,7 +27,9 @@
 
 #include <silkrpc/json/types.hpp>
 #include <silkrpc/types/log.hpp>
+#include <silkrpc/concurrency/context_pool.hpp>
 #include <silkrpc/ethbackend/backend.hpp>
+#include <silkrpc/ethbackend/backend_info.hpp>
 #include <silkrpc/common/log.hpp>
 
 namespace silkrpc::http { class RequestHandler; }
@@ -36,7 +38,7 @@ namespace silkrpc::commands {
 
 class NetRpcApi {
 public:
-    explicit NetRpcApi(std::unique_ptr<ethbackend::BackEnd>& backend) : backend_(backend) {}
+    explicit NetRpcApi(Context& context) : backend_(context.backend()), backend_info_cache_(context.backend_info_cache()) {}
     virtual ~NetRpcApi() = default;
 
     NetRpcApi(const NetRpcApi&) = delete;
@@ -51,6 +53,7 @@ private:
     friend class silkrpc::http::RequestHandler;
 
     std::unique_ptr<ethbackend::BackEnd>& backend_;
+    std::shared_ptr<ethbackend::BackEndInfoCache>& backend_info_cache_;
 };
 } // namespace silkrpc::commands
 
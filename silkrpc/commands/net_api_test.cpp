@@ -16,25 +16,18 @@
 
 #include "net_api.hpp"
 
-#include <agrpc/grpc_context.hpp>
-#include <agrpc/test.hpp>
 #include <catch2/catch.hpp>
 #include <grpcpp/grpcpp.h>
 
-#include <silkrpc/ethbackend/remote_backend.hpp>
-
 namespace silkrpc::commands {
 
 using Catch::Matchers::Message;
 
 TEST_CASE("NetRpcApi::NetRpcApi", "[silkrpc][erigon_api]") {
-    boost::asio::io_context io_context;
-    auto channel{grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials())};
-    agrpc::GrpcContext grpc_context{std::make_unique<grpc::CompletionQueue>()};
-    std::unique_ptr<ethbackend::BackEnd> backend{
-        std::make_unique<ethbackend::RemoteBackEnd>(io_context, channel, grpc_context)
-    };
-    CHECK_NOTHROW(NetRpcApi{backend});
+    ContextPool context_pool{1, []() {
+        return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials());
+    }};
+    CHECK_NOTHROW(NetRpcApi{context_pool.next_context()});
 }
 
 } // namespace silkrpc::commands
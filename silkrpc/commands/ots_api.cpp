@@ -0,0 +1,449 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "ots_api.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <intx/intx.hpp>
+#include <silkworm/common/util.hpp>
+
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/common/util.hpp>
+#include <silkrpc/core/blocks.hpp>
+#include <silkrpc/core/cached_chain.hpp>
+#include <silkrpc/core/issuance.hpp>
+#include <silkrpc/core/receipts.hpp>
+#include <silkrpc/core/state_reader.hpp>
+#include <silkrpc/core/rawdb/chain.hpp>
+#include <silkrpc/ethdb/bitmap.hpp>
+#include <silkrpc/ethdb/memoized_database.hpp>
+#include <silkrpc/ethdb/tables.hpp>
+#include <silkrpc/ethdb/transaction_database.hpp>
+#include <silkrpc/types/block.hpp>
+#include <silkrpc/types/receipt.hpp>
+#include <silkrpc/types/transaction.hpp>
+
+namespace silkrpc::commands {
+
+namespace {
+
+//! Cursor over the blocks where the address is sender or recipient of some call according to the call indexes, within
+//! [from_block, to_block] in ascending or descending order. The indexes are read lazily one window of blocks at a time,
+//! starting small and doubling up to kOtsSearchMaxWindowBlocks, so that the recent activity of busy addresses is found
+//! reading just a few index chunks whereas sparse activity needs few windows anyway
+class CallIndexCursor {
+public:
+    CallIndexCursor(const core::rawdb::DatabaseReader& reader, BitmapCache* cache, const evmc::address& address,
+                    uint64_t from_block, uint64_t to_block, bool descending)
+    : reader_{reader}, cache_{cache}, key_{address.bytes, silkworm::kAddressLength}, low_{from_block}, high_{to_block},
+      descending_{descending}, exhausted_{from_block > to_block} {}
+
+    //! Return the next block touching the address, if any
+    boost::asio::awaitable<std::optional<uint64_t>> next() {
+        while (position_ == blocks_.size()) {
+            if (exhausted_) {
+                co_return std::nullopt;
+            }
+            co_await read_window();
+        }
+        co_return blocks_[position_++];
+    }
+
+private:
+    boost::asio::awaitable<void> read_window() {
+        uint64_t begin, end;
+        if (descending_) {
+            end = high_;
+            begin = high_ - low_ < window_ ? low_ : high_ - window_ + 1;
+            exhausted_ = begin == low_;
+            high_ = begin - 1;
+        } else {
+            begin = low_;
+            end = high_ - low_ < window_ ? high_ : low_ + window_ - 1;
+            exhausted_ = end == high_;
+            low_ = end + 1;
+        }
+        window_ = std::min(window_ * 2, kOtsSearchMaxWindowBlocks);
+
+        const std::vector<ethdb::bitmap::QueryTerm> from_terms{{db::table::kCallFromIndex, {key_}}};
+        const std::vector<ethdb::bitmap::QueryTerm> to_terms{{db::table::kCallToIndex, {key_}}};
+        const auto from_block = static_cast<uint32_t>(begin);
+        const auto to_block = static_cast<uint32_t>(end);
+        auto blocks = (co_await ethdb::bitmap::query(reader_, from_terms, from_block, to_block, cache_)).value_or(roaring::Roaring{});
+        blocks |= (co_await ethdb::bitmap::query(reader_, to_terms, from_block, to_block, cache_)).value_or(roaring::Roaring{});
+
+        std::vector<uint32_t> block_numbers(blocks.cardinality());
+        blocks.toUint32Array(block_numbers.data());
+        if (descending_) {
+            std::reverse(block_numbers.begin(), block_numbers.end());
+        }
+        blocks_.assign(block_numbers.begin(), block_numbers.end());
+        position_ = 0;
+        SILKRPC_DEBUG << "CallIndexCursor::read_window [" << begin << ", " << end << "] #blocks: " << blocks_.size() << "\n";
+    }
+
+    const core::rawdb::DatabaseReader& reader_;
+    BitmapCache* cache_;
+    silkworm::Bytes key_;
+    uint64_t low_;
+    uint64_t high_;
+    bool descending_;
+    bool exhausted_;
+    uint64_t window_{kOtsSearchMinWindowBlocks};
+    std::vector<uint64_t> blocks_;
+    std::size_t position_{0};
+};
+
+std::optional<uint64_t> read_block_number_param(const nlohmann::json& param) {
+    if (param.is_number_unsigned()) {
+        return param.get<uint64_t>();
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+std::vector<std::size_t> find_touching_transactions(const std::vector<trace::Trace>& traces, const evmc::address& address,
+                                                    std::size_t num_transactions) {
+    std::vector<bool> touching(num_transactions, false);
+    for (const auto& trace : traces) {
+        if (!trace.transaction_position || *trace.transaction_position >= num_transactions) {
+            continue; // block reward
+        }
+        bool touched{false};
+        if (const auto* action = std::get_if<trace::TraceAction>(&trace.action)) {
+            touched = action->from == address || (action->to && *action->to == address);
+        }
+        if (trace.trace_result && trace.trace_result->address && *trace.trace_result->address == address) {
+            touched = true;
+        }
+        if (touched) {
+            touching[*trace.transaction_position] = true;
+        }
+    }
+    std::vector<std::size_t> positions;
+    for (std::size_t i{0}; i < num_transactions; ++i) {
+        if (touching[i]) {
+            positions.push_back(i);
+        }
+    }
+    return positions;
+}
+
+// https://github.com/otterscan/otterscan/blob/develop/docs/custom-jsonrpc.md#ots_getapilevel
+boost::asio::awaitable<void> OtsRpcApi::handle_ots_get_api_level(const nlohmann::json& request, nlohmann::json& reply) {
+    reply = make_json_content(request["id"], kOtsApiLevel);
+    co_return;
+}
+
+// https://github.com/otterscan/otterscan/blob/develop/docs/custom-jsonrpc.md#ots_getblockdetails
+boost::asio::awaitable<void> OtsRpcApi::handle_ots_get_block_details(const nlohmann::json& request, nlohmann::json& reply) {
+    const auto& params = request["params"];
+    if (params.size() != 1) {
+        auto error_msg = "invalid ots_getBlockDetails params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        reply = make_json_error(request["id"], 100, error_msg);
+        co_return;
+    }
+    const auto block_number_param = read_block_number_param(params[0]);
+    const auto block_id = block_number_param ? std::string{} : params[0].get<std::string>();
+    SILKRPC_DEBUG << "block: " << params[0].dump() << "\n";
+
+    auto tx = co_await database_->begin();
+
+    try {
+        ethdb::MemoizedDatabase tx_database{*tx};
+
+        uint64_t block_number{0};
+        if (block_number_param) {
+            block_number = *block_number_param;
+        } else {
+            block_number = co_await core::get_block_number(block_id, tx_database);
+        }
+        const auto block_with_hash = co_await core::read_block_by_number(*context_.block_cache(), tx_database, block_number);
+        const auto block_details = co_await get_block_details(tx_database, *block_with_hash);
+        reply = make_json_content(request["id"], block_details);
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], 100, e.what());
+    } catch (...) {
+        SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], 100, "unexpected exception");
+    }
+
+    co_await tx->close(); // RAII not (yet) available with coroutines
+    co_return;
+}
+
+// https://github.com/otterscan/otterscan/blob/develop/docs/custom-jsonrpc.md#ots_getblockdetails
+boost::asio::awaitable<void> OtsRpcApi::handle_ots_get_block_details_by_hash(const nlohmann::json& request, nlohmann::json& reply) {
+    const auto& params = request["params"];
+    if (params.size() != 1) {
+        auto error_msg = "invalid ots_getBlockDetailsByHash params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        reply = make_json_error(request["id"], 100, error_msg);
+        co_return;
+    }
+    const auto block_hash = params[0].get<evmc::bytes32>();
+    SILKRPC_DEBUG << "block_hash: " << block_hash << "\n";
+
+    auto tx = co_await database_->begin();
+
+    try {
+        ethdb::MemoizedDatabase tx_database{*tx};
+
+        const auto block_with_hash = co_await core::read_block_by_hash(*context_.block_cache(), tx_database, block_hash);
+        const auto block_details = co_await get_block_details(tx_database, *block_with_hash);
+        reply = make_json_content(request["id"], block_details);
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], 100, e.what());
+    } catch (...) {
+        SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], 100, "unexpected exception");
+    }
+
+    co_await tx->close(); // RAII not (yet) available with coroutines
+    co_return;
+}
+
+// https://github.com/otterscan/otterscan/blob/develop/docs/custom-jsonrpc.md#ots_getcontractcreator
+boost::asio::awaitable<void> OtsRpcApi::handle_ots_get_contract_creator(const nlohmann::json& request, nlohmann::json& reply) {
+    const auto& params = request["params"];
+    if (params.size() != 1) {
+        auto error_msg = "invalid ots_getContractCreator params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        reply = make_json_error(request["id"], 100, error_msg);
+        co_return;
+    }
+    const auto address = params[0].get<evmc::address>();
+    SILKRPC_DEBUG << "address: 0x" << silkworm::to_hex(address) << "\n";
+
+    auto tx = co_await database_->begin();
+
+    try {
+        ethdb::MemoizedDatabase tx_database{*tx};
+        StateReader state_reader{tx_database, context_.history_cache()};
+
+        const auto has_code = [&](uint64_t block_number) -> boost::asio::awaitable<bool> {
+            const auto account = co_await state_reader.read_account(address, block_number);
+            co_return account && account->code_hash != silkworm::kEmptyHash;
+        };
+
+        // The state after some block is the state read at the next one
+        const auto latest_block_number = co_await core::get_latest_block_number(tx_database);
+        std::optional<uint64_t> creation_block_number;
+        if (co_await has_code(latest_block_number + 1)) {
+            // The contract has been created in one of the blocks changing the account: find the first one leaving code
+            silkworm::Bytes key{address.bytes, silkworm::kAddressLength};
+            const auto changes = co_await ethdb::bitmap::get(tx_database, db::table::kAccountHistory, key, 0,
+                static_cast<uint32_t>(latest_block_number));
+            std::vector<uint32_t> change_blocks(changes.cardinality());
+            changes.toUint32Array(change_blocks.data());
+            std::size_t low{0}, high{change_blocks.size()};
+            while (low < high) {
+                const auto middle = low + (high - low) / 2;
+                if (co_await has_code(change_blocks[middle] + 1)) {
+                    high = middle;
+                } else {
+                    low = middle + 1;
+                }
+            }
+            if (low < change_blocks.size()) {
+                creation_block_number = change_blocks[low];
+            }
+        }
+
+        nlohmann::json creator_json; // null unless some contract has been created at the address
+        if (creation_block_number) {
+            SILKRPC_DEBUG << "contract created in block_number: " << *creation_block_number << "\n";
+            const auto block_with_hash = co_await core::read_block_by_number(*context_.block_cache(), tx_database, *creation_block_number);
+            trace::TraceCallExecutor executor{*context_.io_context(), *context_.block_cache(), tx_database, workers_, context_.trace_store().get()};
+            const auto traces = co_await executor.trace_block(*block_with_hash);
+            for (const auto& trace : traces) {
+                const auto* action = std::get_if<trace::TraceAction>(&trace.action);
+                if (action && trace.type == "create" && trace.transaction_hash && trace.trace_result && trace.trace_result->address == address) {
+                    creator_json["hash"] = *trace.transaction_hash;
+                    creator_json["creator"] = action->from;
+                    break;
+                }
+            }
+        }
+        reply = make_json_content(request["id"], creator_json);
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], 100, e.what());
+    } catch (...) {
+        SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], 100, "unexpected exception");
+    }
+
+    co_await tx->close(); // RAII not (yet) available with coroutines
+    co_return;
+}
+
+// https://github.com/otterscan/otterscan/blob/develop/docs/custom-jsonrpc.md#ots_searchtransactionsbefore-and-ots_searchtransactionsafter
+boost::asio::awaitable<void> OtsRpcApi::handle_ots_search_transactions_before(const nlohmann::json& request, nlohmann::json& reply) {
+    co_await search_transactions(request, reply, /*before=*/true);
+}
+
+boost::asio::awaitable<void> OtsRpcApi::handle_ots_search_transactions_after(const nlohmann::json& request, nlohmann::json& reply) {
+    co_await search_transactions(request, reply, /*before=*/false);
+}
+
+boost::asio::awaitable<void> OtsRpcApi::search_transactions(const nlohmann::json& request, nlohmann::json& reply, bool before) {
+    const auto& params = request["params"];
+    const auto method = before ? "ots_searchTransactionsBefore" : "ots_searchTransactionsAfter";
+    const auto block_number_param = params.size() == 3 ? read_block_number_param(params[1]) : std::nullopt;
+    const auto page_size_param = params.size() == 3 ? read_block_number_param(params[2]) : std::nullopt;
+    if (!block_number_param || !page_size_param || *page_size_param == 0 || *page_size_param > kOtsMaxPageSize) {
+        auto error_msg = std::string{"invalid "} + method + " params: " + params.dump();
+        SILKRPC_ERROR << error_msg << "\n";
+        reply = make_json_error(request["id"], 100, error_msg);
+        co_return;
+    }
+    const auto address = params[0].get<evmc::address>();
+    const auto block_number = *block_number_param;
+    const auto page_size = *page_size_param;
+    SILKRPC_DEBUG << method << " address: 0x" << silkworm::to_hex(address) << " block_number: " << block_number << " page_size: " << page_size << "\n";
+
+    auto tx = co_await database_->begin();
+
+    try {
+        ethdb::MemoizedDatabase tx_database{*tx};
+
+        // Zero means the most recent blocks when searching before, the oldest ones when searching after
+        const auto latest_block_number = co_await core::get_latest_block_number(tx_database);
+        uint64_t from_block_number{0}, to_block_number{latest_block_number};
+        if (before && block_number > 0) {
+            to_block_number = std::min(block_number - 1, latest_block_number);
+        } else if (!before) {
+            from_block_number = block_number + 1;
+        }
+        CallIndexCursor cursor{tx_database, context_.bitmap_cache().get(), address, from_block_number, to_block_number, /*descending=*/before};
+        trace::TraceCallExecutor executor{*context_.io_context(), *context_.block_cache(), tx_database, workers_, context_.trace_store().get()};
+
+        // Pages never split a block: all the matching transactions of the last block are included
+        auto transactions = nlohmann::json::array();
+        auto receipts = nlohmann::json::array();
+        bool has_more{false};
+        while (true) {
+            const auto next_block_number = co_await cursor.next();
+            if (!next_block_number) {
+                break;
+            }
+            if (transactions.size() >= page_size) {
+                has_more = true;
+                break;
+            }
+            const auto block_with_hash = co_await core::read_block_by_number(*context_.block_cache(), tx_database, *next_block_number);
+            const auto& block = block_with_hash->block;
+            const auto traces = co_await executor.trace_block(*block_with_hash);
+            const auto positions = find_touching_transactions(traces, address, block.transactions.size());
+            if (positions.empty()) {
+                continue; // e.g. just the block reward
+            }
+            const auto block_receipts = co_await core::get_receipts(*context_.receipt_cache(), tx_database, *block_with_hash);
+            if (block_receipts->size() != block.transactions.size()) {
+                throw std::runtime_error{"unexpected number of receipts in block " + std::to_string(*next_block_number)};
+            }
+
+            // Transactions are collected in descending order anyway
+            auto block_transactions = nlohmann::json::array();
+            auto block_transaction_receipts = nlohmann::json::array();
+            for (const auto position : positions) {
+                const silkrpc::Transaction transaction{block.transactions[position], block_with_hash->hash, block.header.number,
+                    block.header.base_fee_per_gas, position};
+                auto receipt = (*block_receipts)[position];
+                receipt.effective_gas_price = transaction.effective_gas_price();
+                nlohmann::json receipt_json = receipt;
+                receipt_json["timestamp"] = block.header.timestamp;
+                block_transactions.push_back(transaction);
+                block_transaction_receipts.push_back(std::move(receipt_json));
+            }
+            if (before) {
+                std::reverse(block_transactions.begin(), block_transactions.end());
+                std::reverse(block_transaction_receipts.begin(), block_transaction_receipts.end());
+            }
+            transactions.insert(transactions.end(), block_transactions.begin(), block_transactions.end());
+            receipts.insert(receipts.end(), block_transaction_receipts.begin(), block_transaction_receipts.end());
+        }
+        if (!before) {
+            std::reverse(transactions.begin(), transactions.end());
+            std::reverse(receipts.begin(), receipts.end());
+        }
+        SILKRPC_DEBUG << method << " #transactions: " << transactions.size() << " has_more: " << has_more << "\n";
+
+        nlohmann::json result;
+        result["txs"] = std::move(transactions);
+        result["receipts"] = std::move(receipts);
+        result["firstPage"] = before ? block_number == 0 : !has_more;
+        result["lastPage"] = before ? !has_more : block_number == 0;
+        reply = make_json_content(request["id"], result);
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], 100, e.what());
+    } catch (...) {
+        SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
+        reply = make_json_error(request["id"], 100, "unexpected exception");
+    }
+
+    co_await tx->close(); // RAII not (yet) available with coroutines
+    co_return;
+}
+
+boost::asio::awaitable<nlohmann::json> OtsRpcApi::get_block_details(const core::rawdb::DatabaseReader& reader,
+                                                                  const silkworm::BlockWithHash& block_with_hash) {
+    const auto& block = block_with_hash.block;
+    const auto total_difficulty = co_await core::rawdb::read_total_difficulty(reader, block_with_hash.hash, block.header.number);
+    const Block extended_block{block_with_hash, total_difficulty, /*full_tx=*/false};
+    nlohmann::json block_json = extended_block;
+    block_json.erase("transactions");
+    block_json["transactionCount"] = block.transactions.size();
+    block_json["logsBloom"] = nullptr;
+
+    const auto receipts = co_await core::get_receipts(*context_.receipt_cache(), reader, block_with_hash);
+    intx::uint256 total_fees{0};
+    for (std::size_t i{0}; i < block.transactions.size() && i < receipts->size(); ++i) {
+        const auto effective_gas_price = block.transactions[i].effective_gas_price(block.header.base_fee_per_gas.value_or(0));
+        total_fees += effective_gas_price * (*receipts)[i].gas_used;
+    }
+
+    BlockIssuance block_issuance{}; // default is empty: no PoW => no issuance
+    const auto chain_config{co_await core::rawdb::read_parsed_chain_config(reader)};
+    if (core::has_issuance(chain_config->chain_config)) {
+        block_issuance = core::compute_block_issuance(*chain_config, block, *receipts);
+    }
+
+    nlohmann::json block_details;
+    block_details["block"] = std::move(block_json);
+    block_details["issuance"]["blockReward"] = "0x" + intx::hex(block_issuance.block_reward);
+    block_details["issuance"]["uncleReward"] = "0x" + intx::hex(block_issuance.ommer_reward);
+    block_details["issuance"]["issuance"] = "0x" + intx::hex(block_issuance.issuance());
+    block_details["totalFees"] = "0x" + intx::hex(total_fees);
+    co_return block_details;
+}
+
+} // namespace silkrpc::commands
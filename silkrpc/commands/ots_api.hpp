@@ -0,0 +1,83 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMANDS_OTS_API_HPP_
+#define SILKRPC_COMMANDS_OTS_API_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <silkrpc/config.hpp> // NOLINT(build/include_order)
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <evmc/evmc.hpp>
+#include <nlohmann/json.hpp>
+#include <silkworm/types/block.hpp>
+
+#include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/core/evm_trace.hpp>
+#include <silkrpc/core/rawdb/accessors.hpp>
+#include <silkrpc/json/types.hpp>
+#include <silkrpc/ethdb/database.hpp>
+
+namespace silkrpc::http { class RequestHandler; }
+
+namespace silkrpc::commands {
+
+//! Otterscan API (https://github.com/otterscan/otterscan/blob/develop/docs/custom-jsonrpc.md) served by the existing
+//! tables: the transaction search selects the blocks touching the address by the call indexes, replaying (or reading
+//! from the trace store) just those blocks, and the contract creator is found searching the account history.
+class OtsRpcApi {
+public:
+    explicit OtsRpcApi(Context& context, boost::asio::thread_pool& workers)
+        : context_(context), database_(context.database()), workers_{workers} {}
+    virtual ~OtsRpcApi() {}
+
+    OtsRpcApi(const OtsRpcApi&) = delete;
+    OtsRpcApi& operator=(const OtsRpcApi&) = delete;
+
+protected:
+    boost::asio::awaitable<void> handle_ots_get_api_level(const nlohmann::json& request, nlohmann::json& reply);
+    boost::asio::awaitable<void> handle_ots_get_block_details(const nlohmann::json& request, nlohmann::json& reply);
+    boost::asio::awaitable<void> handle_ots_get_block_details_by_hash(const nlohmann::json& request, nlohmann::json& reply);
+    boost::asio::awaitable<void> handle_ots_get_contract_creator(const nlohmann::json& request, nlohmann::json& reply);
+    boost::asio::awaitable<void> handle_ots_search_transactions_before(const nlohmann::json& request, nlohmann::json& reply);
+    boost::asio::awaitable<void> handle_ots_search_transactions_after(const nlohmann::json& request, nlohmann::json& reply);
+
+private:
+    //! Search the transactions touching the address before or after the block, a whole block at a time until the page is full
+    boost::asio::awaitable<void> search_transactions(const nlohmann::json& request, nlohmann::json& reply, bool before);
+
+    //! Return the block with its issuance and total fees, omitting the transactions
+    boost::asio::awaitable<nlohmann::json> get_block_details(const core::rawdb::DatabaseReader& reader, const silkworm::BlockWithHash& block_with_hash);
+
+    Context& context_;
+    std::unique_ptr<ethdb::Database>& database_;
+    boost::asio::thread_pool& workers_;
+
+    friend class silkrpc::http::RequestHandler;
+};
+
+//! Return the positions of the transactions touching the address given the block traces, i.e. sending or receiving any
+//! call or value transfer at any depth or creating the address
+std::vector<std::size_t> find_touching_transactions(const std::vector<trace::Trace>& traces, const evmc::address& address,
+    std::size_t num_transactions);
+
+} // namespace silkrpc::commands
+
+#endif  // SILKRPC_COMMANDS_OTS_API_HPP_
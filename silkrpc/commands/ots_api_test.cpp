@@ -0,0 +1,76 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "ots_api.hpp"
+
+#include <vector>
+
+#include <boost/asio/thread_pool.hpp>
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+#include <grpcpp/grpcpp.h>
+
+namespace silkrpc::commands {
+
+using evmc::literals::operator""_address;
+
+TEST_CASE("OtsRpcApi::OtsRpcApi", "[silkrpc][ots_api]") {
+    ContextPool context_pool{1, []() {
+        return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials());
+    }};
+    boost::asio::thread_pool workers{1};
+    CHECK_NOTHROW(OtsRpcApi{context_pool.next_context(), workers});
+}
+
+TEST_CASE("find_touching_transactions", "[silkrpc][ots_api]") {
+    const auto address{0x0715a7794a1dc8e42615f059dd6e406a6594651a_address};
+    const auto other{0xe0a2bd4258d2768837baa26a28fe71dc079f84c7_address};
+
+    const auto call = [](uint32_t position, const evmc::address& from, const evmc::address& to) {
+        trace::Trace trace;
+        trace.action = trace::TraceAction{.from = from, .to = to};
+        trace.type = "call";
+        trace.transaction_position = position;
+        return trace;
+    };
+
+    SECTION("no traces") {
+        CHECK(find_touching_transactions({}, address, 3).empty());
+    }
+
+    SECTION("sender, recipient and internal calls") {
+        std::vector<trace::Trace> traces{call(0, address, other), call(1, other, other), call(2, other, other), call(2, other, address)};
+        CHECK(find_touching_transactions(traces, address, 3) == std::vector<std::size_t>{0, 2});
+    }
+
+    SECTION("contract creation") {
+        trace::Trace create;
+        create.action = trace::TraceAction{.from = other};
+        create.type = "create";
+        create.trace_result = trace::TraceResult{.address = address};
+        create.transaction_position = 1;
+        CHECK(find_touching_transactions({call(0, other, other), create}, address, 2) == std::vector<std::size_t>{1});
+    }
+
+    SECTION("block reward ignored") {
+        trace::Trace reward;
+        reward.action = trace::RewardAction{.author = address};
+        reward.type = "reward";
+        CHECK(find_touching_transactions({reward}, address, 1).empty());
+    }
+}
+
+} // namespace silkrpc::commands
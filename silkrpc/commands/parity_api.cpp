@@ -30,6 +30,7 @@
 #include <silkrpc/core/receipts.hpp>
 #include <silkrpc/core/state_reader.hpp>
 #include <silkrpc/core/rawdb/chain.hpp>
+#include <silkrpc/ethdb/memoized_database.hpp>
 #include <silkrpc/ethdb/transaction_database.hpp>
 #include <silkrpc/ethdb/tables.hpp>
 #include <silkrpc/json/types.hpp>
@@ -40,7 +41,7 @@ namespace silkrpc::commands {
 
 // https://eth.wiki/json-rpc/API#parity_getblockreceipts
 boost::asio::awaitable<void> ParityRpcApi::handle_parity_get_block_receipts(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 1) {
         auto error_msg = "invalid parity_getBlockReceipts params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -53,14 +54,14 @@ boost::asio::awaitable<void> ParityRpcApi::handle_parity_get_block_receipts(cons
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_number = co_await core::get_block_number(block_id, tx_database);
         const auto block_with_hash = co_await core::read_block_by_number(*context_.block_cache(), tx_database, block_number);
-        auto receipts{co_await core::get_receipts(tx_database, block_with_hash)};
+        auto receipts{*co_await core::get_receipts(*context_.receipt_cache(), tx_database, *block_with_hash)};
         SILKRPC_INFO << "#receipts: " << receipts.size() << "\n";
 
-        const auto block{block_with_hash.block};
+        const auto& block{block_with_hash->block};
         for (size_t i{0}; i < block.transactions.size(); i++) {
             receipts[i].effective_gas_price = block.transactions[i].effective_gas_price(block.header.base_fee_per_gas.value_or(0));
         }
@@ -83,7 +84,7 @@ boost::asio::awaitable<void> ParityRpcApi::handle_parity_get_block_receipts(cons
 
 // TODO(canepat) will raise error until Silkrpc implements Erigon2u1 https://github.com/ledgerwatch/erigon-lib/pull/559
 boost::asio::awaitable<void> ParityRpcApi::handle_parity_list_storage_keys(const nlohmann::json& request, nlohmann::json& reply) {
-    const auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() < 2) {
         auto error_msg = "invalid parity_listStorageKeys params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -108,7 +109,7 @@ boost::asio::awaitable<void> ParityRpcApi::handle_parity_list_storage_keys(const
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         silkrpc::StateReader state_reader{tx_database};
 
         const auto block_number = co_await silkrpc::core::get_block_number(block_id, tx_database);
@@ -123,16 +124,17 @@ boost::asio::awaitable<void> ParityRpcApi::handle_parity_list_storage_keys(const
 
         std::vector<evmc::bytes32> keys;
         auto v = co_await cursor->seek_both(seek_bytes, seek_val);
-        // We look for keys until we have the quantity we want or the key is invalid/empty
-        while (v.size() >= silkworm::kHashLength && keys.size() != quantity) {
-            auto value = silkworm::bytes32_from_hex(silkworm::to_hex(v));
-            keys.push_back(value);
-            const auto kv_pair = co_await cursor->next_dup();
-
-            if (kv_pair.key != seek_bytes) {
-                break;
+        // We look for keys until we have the quantity we want or the key is invalid/empty: the following locations are read
+        // by next, which walks the duplicates reading them ahead, instead of one next_dup round trip per location
+        if (v.size() >= silkworm::kHashLength && keys.size() != quantity) {
+            keys.push_back(silkworm::to_bytes32(silkworm::ByteView{v}.substr(0, silkworm::kHashLength)));
+            while (keys.size() != quantity) {
+                const auto kv = co_await cursor->next_view();
+                if (kv.key != seek_bytes || kv.value.size() < silkworm::kHashLength) {
+                    break;
+                }
+                keys.push_back(silkworm::to_bytes32(kv.value.substr(0, silkworm::kHashLength)));
             }
-            v = kv_pair.value;
         }
         reply = make_json_content(request["id"], keys);
     } catch (const std::invalid_argument& iv) {
@@ -19,31 +19,36 @@
 
 #include <memory>
 
-#include <boost/asio/thread_pool.hpp>
+#include <silkrpc/concurrency/worker_pool.hpp>
 
 #include <silkrpc/commands/eth_api.hpp>
 #include <silkrpc/commands/debug_api.hpp>
 #include <silkrpc/commands/net_api.hpp>
 #include <silkrpc/commands/parity_api.hpp>
 #include <silkrpc/commands/erigon_api.hpp>
+#include <silkrpc/commands/ots_api.hpp>
 #include <silkrpc/commands/trace_api.hpp>
 #include <silkrpc/commands/web3_api.hpp>
 #include <silkrpc/commands/engine_api.hpp>
 #include <silkrpc/commands/txpool_api.hpp>
 
 namespace silkrpc::http { class RequestHandler; }
+namespace silkrpc::ws { class Connection; }
 
 namespace silkrpc::commands {
 
 class RpcApiTable;
 
-class RpcApi : protected EthereumRpcApi, NetRpcApi, Web3RpcApi, DebugRpcApi, ParityRpcApi, ErigonRpcApi, TraceRpcApi, EngineRpcApi, TxPoolRpcApi {
+class RpcApi : protected EthereumRpcApi, NetRpcApi, Web3RpcApi, DebugRpcApi, ParityRpcApi, ErigonRpcApi, TraceRpcApi, EngineRpcApi, TxPoolRpcApi,
+    OtsRpcApi {
 public:
-    explicit RpcApi(Context& context, boost::asio::thread_pool& workers) :
-        EthereumRpcApi{context, workers}, NetRpcApi{context.backend()}, Web3RpcApi{context}, DebugRpcApi{context, workers},
-        ParityRpcApi{context}, ErigonRpcApi{context}, TraceRpcApi{context, workers},
+    //! The debug, trace and ots namespaces execute on the long-running workers, so that they cannot delay the short calls
+    explicit RpcApi(Context& context, WorkerPool& workers) :
+        EthereumRpcApi{context, workers.pool(WorkloadClass::short_call)}, NetRpcApi{context}, Web3RpcApi{context},
+        DebugRpcApi{context, workers.pool(WorkloadClass::long_running)},
+        ParityRpcApi{context}, ErigonRpcApi{context}, TraceRpcApi{context, workers.pool(WorkloadClass::long_running)},
         EngineRpcApi(context.database(), context.backend()),
-        TxPoolRpcApi(context) {}
+        TxPoolRpcApi(context), OtsRpcApi{context, workers.pool(WorkloadClass::long_running)} {}
     virtual ~RpcApi() {}
 
     RpcApi(const RpcApi&) = delete;
@@ -51,6 +56,7 @@ public:
 
     friend class RpcApiTable;
     friend class silkrpc::http::RequestHandler;
+    friend class silkrpc::ws::Connection;
 };
 
 } // namespace silkrpc::commands
@@ -17,6 +17,7 @@
 #include "rpc_api_table.hpp"
 
 #include <cstring>
+#include <utility>
 
 #include <silkrpc/common/constants.hpp>
 #include <silkrpc/common/log.hpp>
@@ -24,27 +25,71 @@
 
 namespace silkrpc::commands {
 
+//! The number of hash seeds tried for each dispatch table size before doubling it
+constexpr uint64_t kMaxDispatchSeedsPerSize{64};
+
 RpcApiTable::RpcApiTable(const std::string& api_spec) {
     build_handlers(api_spec);
 }
 
-std::optional<RpcApiTable::HandleMethod> RpcApiTable::find_json_handler(const std::string& method) const {
-    const auto handle_method_pair = method_handlers_.find(method);
-    if (handle_method_pair == method_handlers_.end()) {
-        return std::nullopt;
+void RpcApiTable::reload(const std::string& api_spec) {
+    build_handlers(api_spec);
+    SILKRPC_INFO << "RpcApiTable::reload api_spec: " << api_spec << "\n";
+}
+
+uint32_t RpcApiTable::weight_of(MethodCost cost) noexcept {
+    switch (cost) {
+        case MethodCost::light: return 1;
+        case MethodCost::medium: return 10;
+        case MethodCost::heavy: return 100;
     }
-    return handle_method_pair->second;
+    return 1;
 }
 
-std::optional<RpcApiTable::HandleStream> RpcApiTable::find_stream_handler(const std::string& method) const {
-    const auto handle_method_pair = stream_handlers_.find(method);
-    if (handle_method_pair == stream_handlers_.end()) {
-        return std::nullopt;
+const RpcApiTable::MethodEntry* RpcApiTable::find_method(std::string_view method) const {
+    const auto* table = dispatch_table_.load(std::memory_order_acquire);
+    if (table->slots.empty()) {
+        return nullptr;
+    }
+    const auto index = table->slots[table->slot_of(method)];
+    if (index == 0 || table->entries[index - 1].method != method) {
+        return nullptr;
     }
-    return handle_method_pair->second;
+    return &table->entries[index - 1];
+}
+
+std::optional<RpcApiTable::HandleMethod> RpcApiTable::find_json_handler(std::string_view method) const {
+    const auto* entry = find_method(method);
+    return entry ? entry->json_handler : std::nullopt;
+}
+
+std::optional<RpcApiTable::HandleText> RpcApiTable::find_text_handler(std::string_view method) const {
+    const auto* entry = find_method(method);
+    return entry ? entry->text_handler : std::nullopt;
+}
+
+std::optional<RpcApiTable::HandleStream> RpcApiTable::find_stream_handler(std::string_view method) const {
+    const auto* entry = find_method(method);
+    return entry ? entry->stream_handler : std::nullopt;
+}
+
+std::optional<RpcApiTable::HandleBatch> RpcApiTable::find_batch_handler(std::string_view method) const {
+    const auto* entry = find_method(method);
+    return entry ? entry->batch_handler : std::nullopt;
+}
+
+bool RpcApiTable::is_coalescible(std::string_view method) const {
+    const auto* entry = find_method(method);
+    return entry && entry->coalescible;
+}
+
+bool RpcApiTable::is_cacheable(std::string_view method) const {
+    const auto* entry = find_method(method);
+    return entry && entry->cacheable;
 }
 
 void RpcApiTable::build_handlers(const std::string& api_spec) {
+    std::scoped_lock build_lock{build_mutex_};
     auto start = 0u;
     auto end = api_spec.find(kApiSpecSeparator);
     while (end != std::string::npos) {
@@ -53,6 +98,91 @@ void RpcApiTable::build_handlers(const std::string& api_spec) {
         end = api_spec.find(kApiSpecSeparator, start);
     }
     add_handlers(api_spec.substr(start, end));
+    dispatch_tables_.push_back(build_dispatch_table());
+    dispatch_table_.store(dispatch_tables_.back().get(), std::memory_order_release);
+}
+
+std::unique_ptr<const RpcApiTable::DispatchTable> RpcApiTable::build_dispatch_table() {
+    std::map<std::string, MethodEntry> entries;
+    const auto entry_of = [&](const std::string& method) -> MethodEntry& {
+        auto& entry = entries[method];
+        entry.method = method;
+        return entry;
+    };
+    for (const auto& [method, handler] : method_handlers_) {
+        entry_of(method).json_handler = handler;
+    }
+    for (const auto& [method, handler] : text_handlers_) {
+        entry_of(method).text_handler = handler;
+    }
+    for (const auto& [method, handler] : stream_handlers_) {
+        entry_of(method).stream_handler = handler;
+    }
+    for (const auto& [method, handler] : batch_handlers_) {
+        entry_of(method).batch_handler = handler;
+    }
+    for (const auto& method : coalescible_methods_) {
+        entry_of(method).coalescible = true;
+    }
+    for (const auto& method : cacheable_methods_) {
+        entry_of(method).cacheable = true;
+    }
+    for (const auto& [method, cost] : method_costs_) {
+        entry_of(method).cost = cost;
+    }
+    method_handlers_.clear();
+    text_handlers_.clear();
+    stream_handlers_.clear();
+    batch_handlers_.clear();
+    coalescible_methods_.clear();
+    cacheable_methods_.clear();
+    method_costs_.clear();
+
+    auto table = std::make_unique<DispatchTable>();
+    table->entries.reserve(entries.size());
+    for (auto& method_entry : entries) {
+        table->entries.push_back(std::move(method_entry.second));
+    }
+    if (table->entries.empty()) {
+        return table;
+    }
+
+    // With at least n^2 slots a random seed has no collisions with probability above 1/2, so seeds are tried in turn and
+    // the table is doubled just if unlucky
+    std::size_t num_slots{1};
+    while (num_slots < table->entries.size() * table->entries.size()) {
+        num_slots <<= 1;
+    }
+    for (uint64_t seed{0};; ++seed) {
+        if (seed > 0 && seed % kMaxDispatchSeedsPerSize == 0) {
+            num_slots <<= 1;
+        }
+        table->seed = seed;
+        table->slots.assign(num_slots, 0);
+        bool collision{false};
+        for (std::size_t i{0}; i < table->entries.size() && !collision; ++i) {
+            auto& slot = table->slots[table->slot_of(table->entries[i].method)];
+            collision = slot != 0;
+            slot = static_cast<uint16_t>(i + 1);
+        }
+        if (!collision) {
+            break;
+        }
+    }
+    SILKRPC_DEBUG << "RpcApiTable::build_dispatch_table methods: " << table->entries.size() << " slots: " << table->slots.size()
+                  << " seed: " << table->seed << "\n";
+    return table;
+}
+
+std::size_t RpcApiTable::DispatchTable::slot_of(std::string_view method) const {
+    // FNV-1a seeded, then folded so that the high bits count as well
+    uint64_t hash{0xcbf29ce484222325 ^ (seed * 0x9e3779b97f4a7c15)};
+    for (const auto c : method) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3;
+    }
+    hash ^= hash >> 29;
+    return static_cast<std::size_t>(hash & (slots.size() - 1));
 }
 
 void RpcApiTable::add_handlers(const std::string& api_namespace) {
@@ -74,6 +204,8 @@ void RpcApiTable::add_handlers(const std::string& api_namespace) {
         add_engine_handlers();
     } else if (api_namespace == kTxPoolApiNamespace) {
         add_txpool_handlers();
+    } else if (api_namespace == kOtsApiNamespace) {
+        add_ots_handlers();
     } else {
         SILKRPC_WARN << "Server::add_handlers invalid namespace [" << api_namespace << "] ignored\n";
     }
@@ -81,13 +213,35 @@ void RpcApiTable::add_handlers(const std::string& api_namespace) {
 
 void RpcApiTable::add_debug_handlers() {
     method_handlers_[http::method::k_debug_accountRange] = &commands::RpcApi::handle_debug_account_range;
+    stream_handlers_[http::method::k_debug_accountRange] = &commands::RpcApi::handle_debug_account_range_stream;
     method_handlers_[http::method::k_debug_getModifiedAccountsByNumber] = &commands::RpcApi::handle_debug_get_modified_accounts_by_number;
+    stream_handlers_[http::method::k_debug_getModifiedAccountsByNumber] = &commands::RpcApi::handle_debug_get_modified_accounts_by_number_stream;
     method_handlers_[http::method::k_debug_getModifiedAccountsByHash] = &commands::RpcApi::handle_debug_get_modified_accounts_by_hash;
+    stream_handlers_[http::method::k_debug_getModifiedAccountsByHash] = &commands::RpcApi::handle_debug_get_modified_accounts_by_hash_stream;
     method_handlers_[http::method::k_debug_storageRangeAt] = &commands::RpcApi::handle_debug_storage_range_at;
     method_handlers_[http::method::k_debug_traceTransaction] = &commands::RpcApi::handle_debug_trace_transaction;
+    stream_handlers_[http::method::k_debug_traceTransaction] = &commands::RpcApi::handle_debug_trace_transaction_stream;
     method_handlers_[http::method::k_debug_traceCall] = &commands::RpcApi::handle_debug_trace_call;
+    stream_handlers_[http::method::k_debug_traceCall] = &commands::RpcApi::handle_debug_trace_call_stream;
     method_handlers_[http::method::k_debug_traceBlockByNumber] = &commands::RpcApi::handle_debug_trace_block_by_number;
+    stream_handlers_[http::method::k_debug_traceBlockByNumber] = &commands::RpcApi::handle_debug_trace_block_by_number_stream;
     method_handlers_[http::method::k_debug_traceBlockByHash] = &commands::RpcApi::handle_debug_trace_block_by_hash;
+    stream_handlers_[http::method::k_debug_traceBlockByHash] = &commands::RpcApi::handle_debug_trace_block_by_hash_stream;
+
+    // The traces of a transaction or block never change once it is canonical, so their replies are cached
+    cacheable_methods_.insert(http::method::k_debug_traceTransaction);
+    cacheable_methods_.insert(http::method::k_debug_traceBlockByNumber);
+    cacheable_methods_.insert(http::method::k_debug_traceBlockByHash);
+
+    // The traces replay the transactions, while the other methods walk some state or change sets
+    method_costs_[http::method::k_debug_accountRange] = MethodCost::medium;
+    method_costs_[http::method::k_debug_getModifiedAccountsByNumber] = MethodCost::medium;
+    method_costs_[http::method::k_debug_getModifiedAccountsByHash] = MethodCost::medium;
+    method_costs_[http::method::k_debug_storageRangeAt] = MethodCost::heavy;
+    method_costs_[http::method::k_debug_traceTransaction] = MethodCost::heavy;
+    method_costs_[http::method::k_debug_traceCall] = MethodCost::heavy;
+    method_costs_[http::method::k_debug_traceBlockByNumber] = MethodCost::heavy;
+    method_costs_[http::method::k_debug_traceBlockByHash] = MethodCost::heavy;
 }
 
 void RpcApiTable::add_eth_handlers() {
@@ -96,35 +250,39 @@ void RpcApiTable::add_eth_handlers() {
     method_handlers_[http::method::k_eth_protocolVersion] = &commands::RpcApi::handle_eth_protocol_version;
     method_handlers_[http::method::k_eth_syncing] = &commands::RpcApi::handle_eth_syncing;
     method_handlers_[http::method::k_eth_gasPrice] = &commands::RpcApi::handle_eth_gas_price;
-    method_handlers_[http::method::k_eth_getBlockByHash] = &commands::RpcApi::handle_eth_get_block_by_hash;
-    method_handlers_[http::method::k_eth_getBlockByNumber] = &commands::RpcApi::handle_eth_get_block_by_number;
+    method_handlers_[http::method::k_eth_feeHistory] = &commands::RpcApi::handle_eth_fee_history;
+    text_handlers_[http::method::k_eth_getBlockByHash] = &commands::RpcApi::handle_eth_get_block_by_hash;
+    text_handlers_[http::method::k_eth_getBlockByNumber] = &commands::RpcApi::handle_eth_get_block_by_number;
     method_handlers_[http::method::k_eth_getBlockTransactionCountByHash] = &commands::RpcApi::handle_eth_get_block_transaction_count_by_hash;
     method_handlers_[http::method::k_eth_getBlockTransactionCountByNumber] = &commands::RpcApi::handle_eth_get_block_transaction_count_by_number;
     method_handlers_[http::method::k_eth_getUncleByBlockHashAndIndex] = &commands::RpcApi::handle_eth_get_uncle_by_block_hash_and_index;
     method_handlers_[http::method::k_eth_getUncleByBlockNumberAndIndex] = &commands::RpcApi::handle_eth_get_uncle_by_block_number_and_index;
     method_handlers_[http::method::k_eth_getUncleCountByBlockHash] = &commands::RpcApi::handle_eth_get_uncle_count_by_block_hash;
     method_handlers_[http::method::k_eth_getUncleCountByBlockNumber] = &commands::RpcApi::handle_eth_get_uncle_count_by_block_number;
-    method_handlers_[http::method::k_eth_getTransactionByHash] = &commands::RpcApi::handle_eth_get_transaction_by_hash;
+    text_handlers_[http::method::k_eth_getTransactionByHash] = &commands::RpcApi::handle_eth_get_transaction_by_hash;
     method_handlers_[http::method::k_eth_getTransactionByBlockHashAndIndex] = &commands::RpcApi::handle_eth_get_transaction_by_block_hash_and_index;
     method_handlers_[http::method::k_eth_getTransactionByBlockNumberAndIndex] = &commands::RpcApi::handle_eth_get_transaction_by_block_number_and_index;
     method_handlers_[http::method::k_eth_getRawTransactionByHash] = &commands::RpcApi::handle_eth_get_raw_transaction_by_hash;
     method_handlers_[http::method::k_eth_getRawTransactionByBlockHashAndIndex] = &commands::RpcApi::handle_eth_get_raw_transaction_by_block_hash_and_index;
     method_handlers_[http::method::k_eth_getRawTransactionByBlockNumberAndIndex] = &commands::RpcApi::handle_eth_get_raw_transaction_by_block_number_and_index;
-    method_handlers_[http::method::k_eth_getTransactionReceipt] = &commands::RpcApi::handle_eth_get_transaction_receipt;
+    text_handlers_[http::method::k_eth_getTransactionReceipt] = &commands::RpcApi::handle_eth_get_transaction_receipt;
     method_handlers_[http::method::k_eth_estimateGas] = &commands::RpcApi::handle_eth_estimate_gas;
     method_handlers_[http::method::k_eth_getBalance] = &commands::RpcApi::handle_eth_get_balance;
+    batch_handlers_[http::method::k_eth_getBalance] = &commands::RpcApi::handle_eth_get_balance_many;
     method_handlers_[http::method::k_eth_getCode] = &commands::RpcApi::handle_eth_get_code;
     method_handlers_[http::method::k_eth_getTransactionCount] = &commands::RpcApi::handle_eth_get_transaction_count;
     method_handlers_[http::method::k_eth_getStorageAt] = &commands::RpcApi::handle_eth_get_storage_at;
     method_handlers_[http::method::k_eth_call] = &commands::RpcApi::handle_eth_call;
     method_handlers_[http::method::k_eth_callBundle] = &commands::RpcApi::handle_eth_call_bundle;
+    method_handlers_[http::method::k_eth_callMany] = &commands::RpcApi::handle_eth_call_many;
     method_handlers_[http::method::k_eth_createAccessList] = &commands::RpcApi::handle_eth_create_access_list;
     method_handlers_[http::method::k_eth_newFilter] = &commands::RpcApi::handle_eth_new_filter;
     method_handlers_[http::method::k_eth_newBlockFilter] = &commands::RpcApi::handle_eth_new_block_filter;
     method_handlers_[http::method::k_eth_newPendingTransactionFilter] = &commands::RpcApi::handle_eth_new_pending_transaction_filter;
     method_handlers_[http::method::k_eth_getFilterChanges] = &commands::RpcApi::handle_eth_get_filter_changes;
     method_handlers_[http::method::k_eth_uninstallFilter] = &commands::RpcApi::handle_eth_uninstall_filter;
-    method_handlers_[http::method::k_eth_getLogs] = &commands::RpcApi::handle_eth_get_logs;
+    text_handlers_[http::method::k_eth_getLogs] = &commands::RpcApi::handle_eth_get_logs;
+    stream_handlers_[http::method::k_eth_getLogs] = &commands::RpcApi::handle_eth_get_logs_stream;
     method_handlers_[http::method::k_eth_sendRawTransaction] = &commands::RpcApi::handle_eth_send_raw_transaction;
     method_handlers_[http::method::k_eth_sendTransaction] = &commands::RpcApi::handle_eth_send_transaction;
     method_handlers_[http::method::k_eth_signTransaction] = &commands::RpcApi::handle_eth_sign_transaction;
@@ -135,9 +293,39 @@ void RpcApiTable::add_eth_handlers() {
     method_handlers_[http::method::k_eth_submitHashrate] = &commands::RpcApi::handle_eth_submit_hashrate;
     method_handlers_[http::method::k_eth_getWork] = &commands::RpcApi::handle_eth_get_work;
     method_handlers_[http::method::k_eth_submitWork] = &commands::RpcApi::handle_eth_submit_work;
+
     method_handlers_[http::method::k_eth_subscribe] = &commands::RpcApi::handle_eth_subscribe;
     method_handlers_[http::method::k_eth_unsubscribe] = &commands::RpcApi::handle_eth_unsubscribe;
-    method_handlers_[http::method::k_eth_getBlockReceipts] = &commands::RpcApi::handle_parity_get_block_receipts;
+    text_handlers_[http::method::k_eth_getBlockReceipts] = &commands::RpcApi::handle_eth_get_block_receipts;
+
+    // The hottest read-only methods at each new head, whose identical requests are coalesced
+    coalescible_methods_.insert(http::method::k_eth_blockNumber);
+    coalescible_methods_.insert(http::method::k_eth_chainId);
+    coalescible_methods_.insert(http::method::k_eth_gasPrice);
+    coalescible_methods_.insert(http::method::k_eth_feeHistory);
+    coalescible_methods_.insert(http::method::k_eth_getBlockByHash);
+    coalescible_methods_.insert(http::method::k_eth_getBlockByNumber);
+    coalescible_methods_.insert(http::method::k_eth_getTransactionReceipt);
+    coalescible_methods_.insert(http::method::k_eth_estimateGas);
+    coalescible_methods_.insert(http::method::k_eth_getBalance);
+    coalescible_methods_.insert(http::method::k_eth_getCode);
+    coalescible_methods_.insert(http::method::k_eth_getStorageAt);
+    coalescible_methods_.insert(http::method::k_eth_call);
+    coalescible_methods_.insert(http::method::k_eth_getLogs);
+
+    // The methods whose replies never change once the block they are pinned to is canonical, so they are cached
+    cacheable_methods_.insert(http::method::k_eth_getBlockByHash);
+    cacheable_methods_.insert(http::method::k_eth_getBlockByNumber);
+    cacheable_methods_.insert(http::method::k_eth_getTransactionReceipt);
+    cacheable_methods_.insert(http::method::k_eth_getBlockReceipts);
+
+    // The methods executing calls or scanning block ranges
+    method_costs_[http::method::k_eth_estimateGas] = MethodCost::medium;
+    method_costs_[http::method::k_eth_call] = MethodCost::medium;
+    method_costs_[http::method::k_eth_callBundle] = MethodCost::medium;
+    method_costs_[http::method::k_eth_callMany] = MethodCost::medium;
+    method_costs_[http::method::k_eth_createAccessList] = MethodCost::medium;
+    method_costs_[http::method::k_eth_getLogs] = MethodCost::medium;
 }
 
 void RpcApiTable::add_net_handlers() {
@@ -157,6 +345,7 @@ void RpcApiTable::add_erigon_handlers() {
     method_handlers_[http::method::k_erigon_getHeaderByNumber] = &commands::RpcApi::handle_erigon_get_header_by_number;
     method_handlers_[http::method::k_erigon_getLogsByHash] = &commands::RpcApi::handle_erigon_get_logs_by_hash;
     method_handlers_[http::method::k_erigon_forks] = &commands::RpcApi::handle_erigon_forks;
+    method_handlers_[http::method::k_erigon_getAccounts] = &commands::RpcApi::handle_erigon_get_accounts;
     method_handlers_[http::method::k_erigon_watchTheBurn] = &commands::RpcApi::handle_erigon_watch_the_burn;
     method_handlers_[http::method::k_erigon_blockNumber] = &commands::RpcApi::handle_erigon_block_number;
 }
@@ -172,6 +361,17 @@ void RpcApiTable::add_trace_handlers() {
     method_handlers_[http::method::k_trace_get] = &commands::RpcApi::handle_trace_get;
     method_handlers_[http::method::k_trace_transaction] = &commands::RpcApi::handle_trace_transaction;
 
+    // The traces of a transaction or block never change once it is canonical, so their replies are cached
+    cacheable_methods_.insert(http::method::k_trace_block);
+    cacheable_methods_.insert(http::method::k_trace_transaction);
+
+    // All the traces replay some transactions at least
+    for (const auto& [method, handler] : method_handlers_) {
+        if (method.starts_with("trace_")) {
+            method_costs_[method] = MethodCost::heavy;
+        }
+    }
+
     // stream_handlers_[http::method::k_trace_transaction] = &commands::RpcApi::handle_trace_transaction_stream;
 }
 
@@ -192,4 +392,17 @@ void RpcApiTable::add_txpool_handlers() {
     method_handlers_[http::method::k_txpool_content] = &commands::RpcApi::handle_txpool_content;
 }
 
+void RpcApiTable::add_ots_handlers() {
+    method_handlers_[http::method::k_ots_getApiLevel] = &commands::RpcApi::handle_ots_get_api_level;
+    method_handlers_[http::method::k_ots_getBlockDetails] = &commands::RpcApi::handle_ots_get_block_details;
+    method_handlers_[http::method::k_ots_getBlockDetailsByHash] = &commands::RpcApi::handle_ots_get_block_details_by_hash;
+    method_handlers_[http::method::k_ots_getContractCreator] = &commands::RpcApi::handle_ots_get_contract_creator;
+    method_handlers_[http::method::k_ots_searchTransactionsBefore] = &commands::RpcApi::handle_ots_search_transactions_before;
+    method_handlers_[http::method::k_ots_searchTransactionsAfter] = &commands::RpcApi::handle_ots_search_transactions_after;
+
+    // The searches scan the history of the address
+    method_costs_[http::method::k_ots_searchTransactionsBefore] = MethodCost::medium;
+    method_costs_[http::method::k_ots_searchTransactionsAfter] = MethodCost::medium;
+}
+
 } // namespace silkrpc::commands
@@ -17,9 +17,16 @@
 #ifndef SILKRPC_COMMANDS_RPC_API_TABLE_HPP_
 #define SILKRPC_COMMANDS_RPC_API_TABLE_HPP_
 
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <silkrpc/config.hpp>
 
@@ -35,17 +42,79 @@ class RpcApiTable {
 public:
     typedef boost::asio::awaitable<void> (RpcApi::*HandleMethod)(const nlohmann::json&, nlohmann::json&);
     typedef boost::asio::awaitable<void> (RpcApi::*HandleStream)(const nlohmann::json&, json::Stream&);
+    //! Handler writing the JSON reply text directly, skipping the nlohmann::json model on hot paths
+    typedef boost::asio::awaitable<void> (RpcApi::*HandleText)(const nlohmann::json&, std::string&);
+    //! Handler executing together the requests for the same method in one JSON batch, so that their reads can be batched
+    typedef boost::asio::awaitable<void> (RpcApi::*HandleBatch)(const std::vector<const nlohmann::json*>&, std::vector<nlohmann::json>&);
+
+    //! The cost class of one method, i.e. roughly how much work its requests take compared to the light ones
+    enum class MethodCost : uint8_t {
+        light,  // reads some keys
+        medium, // executes one call or scans some range (e.g. eth_call, eth_getLogs)
+        heavy,  // replays or traces whole transactions or blocks (e.g. trace_*, debug_trace*)
+    };
+
+    //! Return the weight of the cost class, i.e. the tokens taken from the rate limits by each request
+    static uint32_t weight_of(MethodCost cost) noexcept;
+
+    //! The handlers and the properties of one method
+    struct MethodEntry {
+        std::string method;
+        std::optional<HandleMethod> json_handler;
+        std::optional<HandleText> text_handler;
+        std::optional<HandleStream> stream_handler;
+        std::optional<HandleBatch> batch_handler;
+        //! True if identical concurrent requests for the method can share one reply, i.e. it just reads the chain
+        bool coalescible{false};
+        //! True if the replies for the method can be cached when its request is pinned to some block
+        bool cacheable{false};
+        //! The cost class of the method
+        MethodCost cost{MethodCost::light};
+    };
 
     explicit RpcApiTable(const std::string& api_spec);
 
     RpcApiTable(const RpcApiTable&) = delete;
     RpcApiTable& operator=(const RpcApiTable&) = delete;
 
-    std::optional<HandleMethod> find_json_handler(const std::string& method) const;
-    std::optional<HandleStream> find_stream_handler(const std::string& method) const;
+    //! Rebuild the handlers for the API namespaces while serving requests: the lookups switch atomically to the new
+    //! handlers, whilst the entries already found stay valid (the replaced tables are kept until destruction)
+    void reload(const std::string& api_spec);
+
+    //! Return the entry of the method, if any, in a single probe of the dispatch table and without allocating
+    const MethodEntry* find_method(std::string_view method) const;
+
+    std::optional<HandleMethod> find_json_handler(std::string_view method) const;
+    std::optional<HandleText> find_text_handler(std::string_view method) const;
+    std::optional<HandleStream> find_stream_handler(std::string_view method) const;
+    std::optional<HandleBatch> find_batch_handler(std::string_view method) const;
+
+    //! Return true if identical concurrent requests for the method can share one reply, i.e. it just reads the chain
+    bool is_coalescible(std::string_view method) const;
+
+    //! Return true if the replies for the method can be cached when its request is pinned to some block
+    bool is_cacheable(std::string_view method) const;
 
 private:
+    //! The dispatch table of the methods, immutable once built
+    struct DispatchTable {
+        //! The entries of all the methods
+        std::vector<MethodEntry> entries;
+
+        //! The perfect-hash table: the index in entries plus one of the method hashed to each slot, zero if none
+        std::vector<uint16_t> slots;
+
+        //! The seed of the method hash, chosen so that no two methods collide
+        uint64_t seed{0};
+
+        std::size_t slot_of(std::string_view method) const;
+    };
+
     void build_handlers(const std::string& api_spec);
+
+    //! Build the dispatch table from the handlers added, with a seed for which no two methods share the same slot
+    std::unique_ptr<const DispatchTable> build_dispatch_table();
+
     void add_handlers(const std::string& api_namespace);
     void add_debug_handlers();
     void add_eth_handlers();
@@ -56,9 +125,25 @@ private:
     void add_web3_handlers();
     void add_engine_handlers();
     void add_txpool_handlers();
+    void add_ots_handlers();
 
+    //! The mutex serializing the builds, protecting all the members below except dispatch_table_
+    std::mutex build_mutex_;
+
+    // The handlers and the properties added by namespace, merged into the dispatch table once built
     std::map<std::string, HandleMethod> method_handlers_;
+    std::map<std::string, HandleText> text_handlers_;
     std::map<std::string, HandleStream> stream_handlers_;
+    std::map<std::string, HandleBatch> batch_handlers_;
+    std::set<std::string> coalescible_methods_;
+    std::set<std::string> cacheable_methods_;
+    std::map<std::string, MethodCost> method_costs_;
+
+    //! All the dispatch tables built so far, the last one being current
+    std::vector<std::unique_ptr<const DispatchTable>> dispatch_tables_;
+
+    //! The current dispatch table, read without locking
+    std::atomic<const DispatchTable*> dispatch_table_{nullptr};
 };
 
 } // namespace silkrpc::commands
@@ -0,0 +1,122 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "rpc_api_table.hpp"
+
+#include <string>
+#include <string_view>
+
+#include <catch2/catch.hpp>
+
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/http/methods.hpp>
+
+namespace silkrpc::commands {
+
+TEST_CASE("RpcApiTable::find_method", "[silkrpc][commands][rpc_api_table]") {
+    SILKRPC_LOG_STREAMS(null_stream(), null_stream());
+    RpcApiTable table{kDefaultEth1ApiSpec};
+
+    SECTION("known method") {
+        const auto* entry = table.find_method(http::method::k_eth_blockNumber);
+        REQUIRE(entry != nullptr);
+        CHECK(entry->method == http::method::k_eth_blockNumber);
+        CHECK(entry->json_handler);
+        CHECK(entry->coalescible);
+        CHECK(table.find_json_handler(http::method::k_eth_blockNumber));
+        CHECK(table.is_coalescible(http::method::k_eth_blockNumber));
+    }
+
+    SECTION("method having several handlers") {
+        const auto* entry = table.find_method(http::method::k_debug_traceTransaction);
+        REQUIRE(entry != nullptr);
+        CHECK(entry->json_handler);
+        CHECK(entry->stream_handler);
+        CHECK(entry->cacheable);
+        CHECK(!entry->coalescible);
+    }
+
+    SECTION("method having text handler") {
+        const auto* entry = table.find_method(http::method::k_eth_getBlockReceipts);
+        REQUIRE(entry != nullptr);
+        CHECK(!entry->json_handler);
+        CHECK(entry->text_handler);
+        CHECK(entry->cacheable);
+    }
+
+    SECTION("method borrowed from longer text") {
+        const std::string text{"eth_blockNumberAndMore"};
+        CHECK(table.find_method(std::string_view{text}.substr(0, 15)) != nullptr);
+        CHECK(table.find_method(text) == nullptr);
+    }
+
+    SECTION("unknown method") {
+        CHECK(table.find_method("eth_unknown") == nullptr);
+        CHECK(table.find_method("") == nullptr);
+        CHECK(!table.find_json_handler("eth_unknown"));
+        CHECK(!table.is_cacheable("eth_unknown"));
+    }
+
+    SECTION("method of namespace not enabled") {
+        CHECK(table.find_method(http::method::k_engine_getPayloadV1) == nullptr);
+    }
+}
+
+TEST_CASE("RpcApiTable method costs", "[silkrpc][commands][rpc_api_table]") {
+    SILKRPC_LOG_STREAMS(null_stream(), null_stream());
+    RpcApiTable table{kDefaultEth1ApiSpec};
+
+    const auto cost_of = [&](std::string_view method) {
+        const auto* entry = table.find_method(method);
+        REQUIRE(entry != nullptr);
+        return entry->cost;
+    };
+    CHECK(cost_of(http::method::k_eth_blockNumber) == RpcApiTable::MethodCost::light);
+    CHECK(cost_of(http::method::k_eth_call) == RpcApiTable::MethodCost::medium);
+    CHECK(cost_of(http::method::k_eth_getLogs) == RpcApiTable::MethodCost::medium);
+    CHECK(cost_of(http::method::k_debug_traceTransaction) == RpcApiTable::MethodCost::heavy);
+    CHECK(cost_of(http::method::k_trace_replayBlockTransactions) == RpcApiTable::MethodCost::heavy);
+
+    CHECK(RpcApiTable::weight_of(RpcApiTable::MethodCost::light) < RpcApiTable::weight_of(RpcApiTable::MethodCost::medium));
+    CHECK(RpcApiTable::weight_of(RpcApiTable::MethodCost::medium) < RpcApiTable::weight_of(RpcApiTable::MethodCost::heavy));
+}
+
+TEST_CASE("RpcApiTable with no namespace", "[silkrpc][commands][rpc_api_table]") {
+    SILKRPC_LOG_STREAMS(null_stream(), null_stream());
+    RpcApiTable table{""};
+    CHECK(table.find_method(http::method::k_eth_blockNumber) == nullptr);
+}
+
+TEST_CASE("RpcApiTable::reload", "[silkrpc][commands][rpc_api_table]") {
+    SILKRPC_LOG_STREAMS(null_stream(), null_stream());
+    RpcApiTable table{kDefaultEth1ApiSpec};
+    const auto* entry = table.find_method(http::method::k_debug_traceTransaction);
+    REQUIRE(entry != nullptr);
+
+    table.reload(kEthApiNamespace);
+    CHECK(table.find_method(http::method::k_eth_blockNumber) != nullptr);
+    CHECK(table.find_method(http::method::k_debug_traceTransaction) == nullptr);
+
+    // The entry found before reloading is still valid
+    CHECK(entry->method == http::method::k_debug_traceTransaction);
+    CHECK(entry->json_handler);
+
+    table.reload(kDefaultEth1ApiSpec);
+    CHECK(table.find_method(http::method::k_debug_traceTransaction) != nullptr);
+}
+
+} // namespace silkrpc::commands
@@ -29,6 +29,7 @@
 #include <silkrpc/core/cached_chain.hpp>
 #include <silkrpc/core/evm_trace.hpp>
 #include <silkrpc/ethdb/kv/cached_database.hpp>
+#include <silkrpc/ethdb/memoized_database.hpp>
 #include <silkrpc/ethdb/transaction_database.hpp>
 #include <silkrpc/json/types.hpp>
 #include <silkrpc/types/call.hpp>
@@ -37,7 +38,7 @@ namespace silkrpc::commands {
 
 // https://eth.wiki/json-rpc/API#trace_call
 boost::asio::awaitable<void> TraceRpcApi::handle_trace_call(const nlohmann::json& request, nlohmann::json& reply) {
-    const auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() < 3) {
         auto error_msg = "invalid trace_call params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -54,13 +55,13 @@ boost::asio::awaitable<void> TraceRpcApi::handle_trace_call(const nlohmann::json
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         ethdb::kv::CachedDatabase cached_database{block_number_or_hash, *tx, *context_.state_cache()};
         const auto block_with_hash = co_await core::read_block_by_number_or_hash(*context_.block_cache(), tx_database, block_number_or_hash);
-        const bool is_latest_block = co_await core::is_latest_block_number(block_with_hash.block.header.number, tx_database);
+        const bool is_latest_block = co_await core::is_latest_block_number(block_with_hash->block.header.number, tx_database);
         core::rawdb::DatabaseReader& db_reader = is_latest_block ? (core::rawdb::DatabaseReader&)cached_database : (core::rawdb::DatabaseReader&)tx_database;
         trace::TraceCallExecutor executor{*context_.io_context(), *context_.block_cache(), db_reader, workers_};
-        const auto result = co_await executor.trace_call(block_with_hash.block, call, config);
+        const auto result = co_await executor.trace_call(block_with_hash->block, call, config);
 
         if (result.pre_check_error) {
             reply = make_json_error(request["id"], -32000, result.pre_check_error.value());
@@ -81,7 +82,7 @@ boost::asio::awaitable<void> TraceRpcApi::handle_trace_call(const nlohmann::json
 
 // https://eth.wiki/json-rpc/API#trace_callmany
 boost::asio::awaitable<void> TraceRpcApi::handle_trace_call_many(const nlohmann::json& request, nlohmann::json& reply) {
-    const auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() < 2) {
         auto error_msg = "invalid trace_callMany params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -96,14 +97,14 @@ boost::asio::awaitable<void> TraceRpcApi::handle_trace_call_many(const nlohmann:
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         ethdb::kv::CachedDatabase cached_database{block_number_or_hash, *tx, *context_.state_cache()};
         const auto block_with_hash = co_await core::read_block_by_number_or_hash(*context_.block_cache(), tx_database, block_number_or_hash);
-        const bool is_latest_block = co_await core::is_latest_block_number(block_with_hash.block.header.number, tx_database);
+        const bool is_latest_block = co_await core::is_latest_block_number(block_with_hash->block.header.number, tx_database);
 
         core::rawdb::DatabaseReader& db_reader = is_latest_block ? (core::rawdb::DatabaseReader&)cached_database : (core::rawdb::DatabaseReader&)tx_database;
         trace::TraceCallExecutor executor{*context_.io_context(), *context_.block_cache(), db_reader, workers_};
-        const auto result = co_await executor.trace_calls(block_with_hash.block, trace_calls);
+        const auto result = co_await executor.trace_calls(block_with_hash->block, trace_calls);
 
         if (result.pre_check_error) {
             reply = make_json_error(request["id"], -32000, result.pre_check_error.value());
@@ -124,7 +125,7 @@ boost::asio::awaitable<void> TraceRpcApi::handle_trace_call_many(const nlohmann:
 
 // https://eth.wiki/json-rpc/API#trace_rawtransaction
 boost::asio::awaitable<void> TraceRpcApi::handle_trace_raw_transaction(const nlohmann::json& request, nlohmann::json& reply) {
-    const auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() < 2) {
         const auto error_msg = "invalid trace_rawTransaction params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -181,13 +182,13 @@ boost::asio::awaitable<void> TraceRpcApi::handle_trace_raw_transaction(const nlo
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_number = co_await core::get_latest_block_number(tx_database);
         const auto block_with_hash = co_await core::read_block_by_number(*context_.block_cache(), tx_database, block_number);
 
         trace::TraceCallExecutor executor{*context_.io_context(), *context_.block_cache(), tx_database, workers_};
-        const auto result = co_await executor.trace_transaction(block_with_hash.block, transaction, config);
+        const auto result = co_await executor.trace_transaction(block_with_hash->block, transaction, config);
 
         if (result.pre_check_error) {
             reply = make_json_error(request["id"], -32000, result.pre_check_error.value());
@@ -208,7 +209,7 @@ boost::asio::awaitable<void> TraceRpcApi::handle_trace_raw_transaction(const nlo
 
 // https://eth.wiki/json-rpc/API#trace_replayblocktransactions
 boost::asio::awaitable<void> TraceRpcApi::handle_trace_replay_block_transactions(const nlohmann::json& request, nlohmann::json& reply) {
-    const auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() < 2) {
         auto error_msg = "invalid trace_replayBlockTransactions params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -223,12 +224,12 @@ boost::asio::awaitable<void> TraceRpcApi::handle_trace_replay_block_transactions
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_with_hash = co_await core::read_block_by_number_or_hash(*context_.block_cache(), tx_database, block_number_or_hash);
 
         trace::TraceCallExecutor executor{*context_.io_context(), *context_.block_cache(), tx_database, workers_};
-        const auto result = co_await executor.trace_block_transactions(block_with_hash.block, config);
+        const auto result = co_await executor.trace_block_transactions(block_with_hash->block, config);
         reply = make_json_content(request["id"], result);
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
@@ -244,7 +245,7 @@ boost::asio::awaitable<void> TraceRpcApi::handle_trace_replay_block_transactions
 
 // https://eth.wiki/json-rpc/API#trace_replaytransaction
 boost::asio::awaitable<void> TraceRpcApi::handle_trace_replay_transaction(const nlohmann::json& request, nlohmann::json& reply) {
-    const auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() < 2) {
         auto error_msg = "invalid trace_replayTransaction params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -259,14 +260,15 @@ boost::asio::awaitable<void> TraceRpcApi::handle_trace_replay_transaction(const
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         const auto tx_with_block = co_await core::read_transaction_by_hash(*context_.block_cache(), tx_database, transaction_hash);
         if (!tx_with_block) {
             std::ostringstream oss;
             oss << "transaction 0x" << transaction_hash << " not found";
             reply = make_json_error(request["id"], -32000, oss.str());
         } else {
-            trace::TraceCallExecutor executor{*context_.io_context(), *context_.block_cache(), tx_database, workers_};
+            trace::TraceCallExecutor executor{*context_.io_context(), *context_.block_cache(), tx_database, workers_, nullptr,
+                                              context_.state_checkpoint_cache().get()};
             const auto result = co_await executor.trace_transaction(tx_with_block->block_with_hash.block, tx_with_block->transaction, config);
 
             if (result.pre_check_error) {
@@ -289,7 +291,7 @@ boost::asio::awaitable<void> TraceRpcApi::handle_trace_replay_transaction(const
 
 // https://eth.wiki/json-rpc/API#trace_block
 boost::asio::awaitable<void> TraceRpcApi::handle_trace_block(const nlohmann::json& request, nlohmann::json& reply) {
-    const auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() < 1) {
         auto error_msg = "invalid trace_block params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -303,12 +305,12 @@ boost::asio::awaitable<void> TraceRpcApi::handle_trace_block(const nlohmann::jso
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto block_with_hash = co_await core::read_block_by_number_or_hash(*context_.block_cache(), tx_database, block_number_or_hash);
 
-        trace::TraceCallExecutor executor{*context_.io_context(), *context_.block_cache(), tx_database, workers_};
-        const auto result = co_await executor.trace_block(block_with_hash);
+        trace::TraceCallExecutor executor{*context_.io_context(), *context_.block_cache(), tx_database, workers_, context_.trace_store().get()};
+        const auto result = co_await executor.trace_block(*block_with_hash);
         reply = make_json_content(request["id"], result);
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
@@ -324,7 +326,7 @@ boost::asio::awaitable<void> TraceRpcApi::handle_trace_block(const nlohmann::jso
 
 // https://eth.wiki/json-rpc/API#trace_filter
 boost::asio::awaitable<void> TraceRpcApi::handle_trace_filter(const nlohmann::json& request, nlohmann::json& reply) {
-    const auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() < 1) {
         auto error_msg = "invalid trace_filter params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -339,10 +341,10 @@ boost::asio::awaitable<void> TraceRpcApi::handle_trace_filter(const nlohmann::js
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
-        trace::TraceCallExecutor executor{*context_.io_context(), *context_.block_cache(), tx_database, workers_};
-        const auto result = co_await executor.trace_filter(trace_filter);
+        trace::TraceCallExecutor executor{*context_.io_context(), *context_.block_cache(), tx_database, workers_, context_.trace_store().get()};
+        const auto result = co_await executor.trace_filter(trace_filter, database_.get());
         if (result.pre_check_error) {
             reply = make_json_error(request["id"], -32000, result.pre_check_error.value());
         } else {
@@ -362,7 +364,7 @@ boost::asio::awaitable<void> TraceRpcApi::handle_trace_filter(const nlohmann::js
 
 // https://eth.wiki/json-rpc/API#trace_get
 boost::asio::awaitable<void> TraceRpcApi::handle_trace_get(const nlohmann::json& request, nlohmann::json& reply) {
-    const auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() < 2) {
         auto error_msg = "invalid trace_get params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -387,13 +389,14 @@ boost::asio::awaitable<void> TraceRpcApi::handle_trace_get(const nlohmann::json&
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
 
         const auto tx_with_block = co_await core::read_transaction_by_hash(*context_.block_cache(), tx_database, transaction_hash);
         if (!tx_with_block) {
             reply = make_json_content(request["id"]);
         } else {
-            trace::TraceCallExecutor executor{*context_.io_context(), *context_.block_cache(), tx_database, workers_};
+            trace::TraceCallExecutor executor{*context_.io_context(), *context_.block_cache(), tx_database, workers_, context_.trace_store().get(),
+                                              context_.state_checkpoint_cache().get()};
             const auto result = co_await executor.trace_transaction(tx_with_block->block_with_hash, tx_with_block->transaction);
 
             // TODO(sixtysixter) for RPCDAEMON compatibility
@@ -417,7 +420,7 @@ boost::asio::awaitable<void> TraceRpcApi::handle_trace_get(const nlohmann::json&
 
 // https://eth.wiki/json-rpc/API#trace_transaction
 boost::asio::awaitable<void> TraceRpcApi::handle_trace_transaction(const nlohmann::json& request, nlohmann::json& reply) {
-    const auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() < 1) {
         auto error_msg = "invalid trace_transaction params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -431,12 +434,13 @@ boost::asio::awaitable<void> TraceRpcApi::handle_trace_transaction(const nlohman
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         const auto tx_with_block = co_await core::read_transaction_by_hash(*context_.block_cache(), tx_database, transaction_hash);
         if (!tx_with_block) {
             reply = make_json_content(request["id"]);
         } else {
-            trace::TraceCallExecutor executor{*context_.io_context(), *context_.block_cache(), tx_database, workers_};
+            trace::TraceCallExecutor executor{*context_.io_context(), *context_.block_cache(), tx_database, workers_, context_.trace_store().get(),
+                                              context_.state_checkpoint_cache().get()};
             auto result = co_await executor.trace_transaction(tx_with_block->block_with_hash, tx_with_block->transaction);
             reply = make_json_content(request["id"], result);
         }
@@ -452,7 +456,7 @@ boost::asio::awaitable<void> TraceRpcApi::handle_trace_transaction(const nlohman
 }
 
 boost::asio::awaitable<void> TraceRpcApi::handle_trace_transaction_stream(const nlohmann::json& request, json::Stream& stream) {
-    const auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() < 1) {
         auto error_msg = "invalid trace_transaction params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
@@ -466,7 +470,7 @@ boost::asio::awaitable<void> TraceRpcApi::handle_trace_transaction_stream(const
     auto tx = co_await database_->begin();
 
     try {
-        ethdb::TransactionDatabase tx_database{*tx};
+        ethdb::MemoizedDatabase tx_database{*tx};
         const auto tx_with_block = co_await core::read_transaction_by_hash(*context_.block_cache(), tx_database, transaction_hash);
         if (!tx_with_block) {
             const auto reply = make_json_content(request["id"]);
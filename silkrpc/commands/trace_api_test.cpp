@@ -29,7 +29,8 @@ TEST_CASE("TraceRpcApi") {
     ChannelFactory create_channel = []() {
         return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials());
     };
-    Context context{create_channel, std::make_shared<BlockCache>(), std::make_shared<ethdb::kv::CoherentStateCache>()};
+    Context context{create_channel, std::make_shared<BlockCache>(), std::make_shared<ReceiptCache>(), std::make_shared<ethdb::kv::CoherentStateCache>(),
+        std::make_shared<AccessHistory>()};
     boost::asio::thread_pool workers{1};
 
     SECTION("CTOR") {
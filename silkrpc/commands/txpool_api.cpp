@@ -41,7 +41,8 @@ boost::asio::awaitable<void> TxPoolRpcApi::handle_txpool_status(const nlohmann::
 // https://geth.ethereum.org/docs/rpc/ns-txpool
 boost::asio::awaitable<void> TxPoolRpcApi::handle_txpool_content(const nlohmann::json& request, nlohmann::json& reply) {
     try {
-        const auto txpool_transactions = co_await tx_pool_->get_transactions();
+        const auto txpool_snapshot = co_await tx_pool_->get_transactions_snapshot();
+        const auto& txpool_transactions = *txpool_snapshot;
 
         TransactionContent transactions_content;
         transactions_content["queued"];
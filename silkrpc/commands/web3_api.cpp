@@ -30,7 +30,14 @@ namespace silkrpc::commands {
 // https://eth.wiki/json-rpc/API#web3_clientversion
 boost::asio::awaitable<void> Web3RpcApi::handle_web3_client_version(const nlohmann::json& request, nlohmann::json& reply) {
     try {
-        const auto client_version = co_await backend_->client_version();
+        // Served from the values refreshed in background, if any
+        const auto info = backend_info_cache_ ? backend_info_cache_->get() : nullptr;
+        std::string client_version;
+        if (info) {
+            client_version = info->client_version;
+        } else {
+            client_version = co_await backend_->client_version();
+        }
         reply = make_json_content(request["id"], client_version);
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
@@ -44,7 +51,7 @@ boost::asio::awaitable<void> Web3RpcApi::handle_web3_client_version(const nlohma
 
 // https://eth.wiki/json-rpc/API#web3_sha3
 boost::asio::awaitable<void> Web3RpcApi::handle_web3_sha3(const nlohmann::json& request, nlohmann::json& reply) {
-    auto params = request["params"];
+    const auto& params = request["params"];
     if (params.size() != 1) {
         auto error_msg = "invalid web3_sha3 params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
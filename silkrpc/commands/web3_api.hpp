@@ -26,6 +26,7 @@
 
 #include <silkrpc/concurrency/context_pool.hpp>
 #include <silkrpc/ethbackend/backend.hpp>
+#include <silkrpc/ethbackend/backend_info.hpp>
 #include <silkrpc/core/rawdb/accessors.hpp>
 #include <silkrpc/json/types.hpp>
 #include <silkrpc/ethdb/database.hpp>
@@ -36,7 +37,8 @@ namespace silkrpc::commands {
 
 class Web3RpcApi {
 public:
-    explicit Web3RpcApi(Context& context) : database_(context.database()), backend_(context.backend()) {}
+    explicit Web3RpcApi(Context& context)
+    : database_(context.database()), backend_(context.backend()), backend_info_cache_(context.backend_info_cache()) {}
     virtual ~Web3RpcApi() {}
 
     Web3RpcApi(const Web3RpcApi&) = delete;
@@ -49,6 +51,7 @@ protected:
 private:
     std::unique_ptr<ethdb::Database>& database_;
     std::unique_ptr<ethbackend::BackEnd>& backend_;
+    std::shared_ptr<ethbackend::BackEndInfoCache>& backend_info_cache_;
 
     friend class silkrpc::http::RequestHandler;
 };
@@ -0,0 +1,52 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "access_history.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace silkrpc {
+
+void AccessedState::normalize() {
+    std::sort(accounts.begin(), accounts.end());
+    accounts.erase(std::unique(accounts.begin(), accounts.end()), accounts.end());
+    std::sort(locations.begin(), locations.end());
+    locations.erase(std::unique(locations.begin(), locations.end()), locations.end());
+}
+
+void AccessHistory::record(const evmc::address& to, AccessedState state) {
+    state.normalize();
+    if (state.accounts.size() > kMaxAccountsPerEntry) {
+        state.accounts.resize(kMaxAccountsPerEntry);
+    }
+    if (state.locations.size() > kMaxLocationsPerEntry) {
+        state.locations.resize(kMaxLocationsPerEntry);
+    }
+    insert(key_of(to), std::make_shared<const AccessedState>(std::move(state)));
+}
+
+std::size_t AccessHistory::approximate_size(const AccessedState& state) {
+    return sizeof(AccessedState) + state.accounts.size() * sizeof(evmc::address) + state.locations.size() * sizeof(StorageLocation);
+}
+
+evmc::bytes32 AccessHistory::key_of(const evmc::address& address) {
+    evmc::bytes32 key{};
+    std::memcpy(key.bytes, address.bytes, sizeof(address.bytes));
+    return key;
+}
+
+} // namespace silkrpc
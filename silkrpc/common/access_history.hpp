@@ -0,0 +1,73 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_ACCESS_HISTORY_HPP_
+#define SILKRPC_COMMON_ACCESS_HISTORY_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <evmc/evmc.hpp>
+
+#include <silkrpc/common/sharded_cache.hpp>
+
+namespace silkrpc {
+
+//! The storage location of one account
+using StorageLocation = std::pair<evmc::address, evmc::bytes32>;
+
+//! The accounts and storage locations read by EVM executions
+struct AccessedState {
+    std::vector<evmc::address> accounts;
+    std::vector<StorageLocation> locations;
+
+    //! Sort and deduplicate both the accounts and the locations
+    void normalize();
+};
+
+//! Cache of the state read by the latest execution towards each recipient, used to prefetch the state for the next
+//! executions towards the same recipient, bounded by the approximate memory footprint of the entries (see ShardedCache).
+class AccessHistory : public ShardedCache<AccessedState> {
+public:
+    //! The default memory budget in bytes
+    static constexpr std::size_t kDefaultMaxBytes{16 * 1024 * 1024};
+
+    //! The max number of accounts and of locations recorded for each recipient
+    static constexpr std::size_t kMaxAccountsPerEntry{256};
+    static constexpr std::size_t kMaxLocationsPerEntry{1024};
+
+    explicit AccessHistory(std::size_t max_bytes = kDefaultMaxBytes, bool shared_cache = true, std::size_t num_shards = kDefaultNumShards)
+    : ShardedCache{&AccessHistory::approximate_size, max_bytes, shared_cache, num_shards} {}
+
+    //! Return the state recorded for the given recipient, if any, or nullptr otherwise
+    std::shared_ptr<const AccessedState> find(const evmc::address& to) { return get(key_of(to)); }
+
+    //! Record the state read by an execution towards the given recipient, replacing any previous one
+    void record(const evmc::address& to, AccessedState state);
+
+    //! Return the approximate memory footprint of the accessed state
+    static std::size_t approximate_size(const AccessedState& state);
+
+private:
+    //! Addresses are hashes, so their leading bytes are already uniformly distributed as required by the cache
+    static evmc::bytes32 key_of(const evmc::address& address);
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_ACCESS_HISTORY_HPP_
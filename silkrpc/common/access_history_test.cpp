@@ -0,0 +1,73 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "access_history.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+using evmc::literals::operator""_address;
+using evmc::literals::operator""_bytes32;
+
+static const evmc::address kTo{0x0715a7794a1dc8e42615f059dd6e406a6594651a_address};
+static const evmc::address kSender{0x52728289eba496b6080d57d0250a90663a07e556_address};
+static const evmc::bytes32 kLocation1{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+static const evmc::bytes32 kLocation2{0x0000000000000000000000000000000000000000000000000000000000000002_bytes32};
+
+TEST_CASE("AccessedState::normalize", "[silkrpc][common][access_history]") {
+    AccessedState state{{kTo, kSender, kTo}, {{kTo, kLocation2}, {kTo, kLocation1}, {kTo, kLocation2}}};
+    state.normalize();
+    CHECK(state.accounts == std::vector<evmc::address>{kTo, kSender});
+    CHECK(state.locations == std::vector<StorageLocation>{{kTo, kLocation1}, {kTo, kLocation2}});
+}
+
+TEST_CASE("access history find and record", "[silkrpc][common][access_history]") {
+    AccessHistory access_history;
+    CHECK(!access_history.find(kTo));
+
+    access_history.record(kTo, AccessedState{{kSender, kTo}, {{kTo, kLocation1}, {kTo, kLocation1}}});
+    const auto state = access_history.find(kTo);
+    REQUIRE(state);
+    CHECK(state->accounts.size() == 2);
+    CHECK(state->locations == std::vector<StorageLocation>{{kTo, kLocation1}});
+    CHECK(!access_history.find(kSender));
+    CHECK(access_history.size() == 1);
+
+    access_history.record(kTo, AccessedState{{kTo}, {}});
+    CHECK(access_history.find(kTo)->locations.empty());
+    CHECK(access_history.size() == 1);
+}
+
+TEST_CASE("access history bounds the recorded entries", "[silkrpc][common][access_history]") {
+    AccessedState state;
+    for (uint64_t i{0}; i < AccessHistory::kMaxLocationsPerEntry + 10; ++i) {
+        evmc::bytes32 location{};
+        location.bytes[31] = static_cast<uint8_t>(i);
+        location.bytes[30] = static_cast<uint8_t>(i >> 8);
+        state.locations.emplace_back(kTo, location);
+    }
+    AccessHistory access_history;
+    access_history.record(kTo, state);
+    CHECK(access_history.find(kTo)->locations.size() == AccessHistory::kMaxLocationsPerEntry);
+}
+
+TEST_CASE("access history approximate size", "[silkrpc][common][access_history]") {
+    const AccessedState state{{kTo}, {{kTo, kLocation1}}};
+    CHECK(AccessHistory::approximate_size(state) == sizeof(AccessedState) + sizeof(evmc::address) + sizeof(StorageLocation));
+}
+
+} // namespace silkrpc
@@ -0,0 +1,239 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "allocator.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <cstdlib>
+#include <latch>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#if defined(SILKRPC_HAS_MIMALLOC)
+#include <mimalloc.h>
+#elif defined(SILKRPC_HAS_JEMALLOC)
+#include <jemalloc/jemalloc.h>
+#elif defined(SILKRPC_HAS_TCMALLOC)
+#include <gperftools/malloc_extension_c.h>
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <boost/asio/post.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc {
+
+namespace {
+
+struct Heap {
+    std::string name;
+    std::size_t thread_count{0};
+    unsigned arena{0};
+};
+
+std::mutex heaps_mutex;
+std::vector<Heap> heaps;
+
+#if defined(SILKRPC_HAS_JEMALLOC)
+//! Read the size_t statistic, zero if not available (e.g. jemalloc built without --enable-stats)
+uint64_t read_jemalloc_stat(const std::string& name) {
+    std::size_t value{0};
+    std::size_t size{sizeof(value)};
+    if (mallctl(name.c_str(), &value, &size, nullptr, 0) != 0) {
+        return 0;
+    }
+    return value;
+}
+
+//! Refresh the statistics cached by jemalloc, which are updated only when advancing the epoch
+void advance_jemalloc_epoch() {
+    uint64_t epoch{1};
+    std::size_t size{sizeof(epoch)};
+    mallctl("epoch", &epoch, &size, &epoch, size);
+}
+#endif
+
+#if !defined(SILKRPC_HAS_JEMALLOC)
+//! The bytes allocated by the calling thread through the replaced global operator new
+thread_local uint64_t thread_new_bytes{0};
+#endif
+
+} // namespace
+
+std::string_view allocator_name() noexcept {
+#if defined(SILKRPC_HAS_MIMALLOC)
+    return "mimalloc";
+#elif defined(SILKRPC_HAS_JEMALLOC)
+    return "jemalloc";
+#elif defined(SILKRPC_HAS_TCMALLOC)
+    return "tcmalloc";
+#else
+    return "system";
+#endif
+}
+
+AllocatorStats allocator_stats() {
+    AllocatorStats stats;
+#if defined(SILKRPC_HAS_MIMALLOC)
+    std::size_t elapsed_msecs{0}, user_msecs{0}, system_msecs{0}, peak_rss{0}, peak_commit{0}, page_faults{0};
+    std::size_t current_rss{0}, current_commit{0};
+    mi_process_info(&elapsed_msecs, &user_msecs, &system_msecs, &current_rss, &peak_rss, &current_commit, &peak_commit, &page_faults);
+    // The allocated total is tracked by mimalloc only in its statistics, which have no public accessor
+    stats.resident_bytes = current_rss;
+    stats.mapped_bytes = current_commit;
+#elif defined(SILKRPC_HAS_JEMALLOC)
+    advance_jemalloc_epoch();
+    stats.allocated_bytes = read_jemalloc_stat("stats.allocated");
+    stats.resident_bytes = read_jemalloc_stat("stats.resident");
+    stats.mapped_bytes = read_jemalloc_stat("stats.mapped");
+#elif defined(SILKRPC_HAS_TCMALLOC)
+    std::size_t allocated{0}, heap_size{0}, unmapped{0};
+    MallocExtension_GetNumericProperty("generic.current_allocated_bytes", &allocated);
+    MallocExtension_GetNumericProperty("generic.heap_size", &heap_size);
+    MallocExtension_GetNumericProperty("tcmalloc.pageheap_unmapped_bytes", &unmapped);
+    stats.allocated_bytes = allocated;
+    stats.resident_bytes = heap_size - unmapped;
+    stats.mapped_bytes = heap_size;
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    const auto info = mallinfo2();
+    stats.allocated_bytes = info.uordblks + info.hblkhd;
+    stats.mapped_bytes = info.arena + info.hblkhd;
+#endif
+    return stats;
+}
+
+bool heap_stats_supported() noexcept {
+#if defined(SILKRPC_HAS_JEMALLOC)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void bind_thread_heap(const std::string& name) {
+    std::scoped_lock lock{heaps_mutex};
+    auto it = std::find_if(heaps.begin(), heaps.end(), [&](const auto& heap) { return heap.name == name; });
+    if (it == heaps.end()) {
+        Heap heap{name};
+#if defined(SILKRPC_HAS_JEMALLOC)
+        std::size_t size{sizeof(heap.arena)};
+        if (mallctl("arenas.create", &heap.arena, &size, nullptr, 0) != 0) {
+            SILKRPC_WARN << "bind_thread_heap cannot create arena for heap: " << name << "\n";
+            return;
+        }
+#endif
+        heaps.push_back(std::move(heap));
+        it = std::prev(heaps.end());
+    }
+#if defined(SILKRPC_HAS_JEMALLOC)
+    if (mallctl("thread.arena", nullptr, nullptr, &it->arena, sizeof(it->arena)) != 0) {
+        SILKRPC_WARN << "bind_thread_heap cannot bind thread to arena: " << it->arena << " heap: " << name << "\n";
+        return;
+    }
+#endif
+    ++it->thread_count;
+    SILKRPC_DEBUG << "bind_thread_heap thread bound to heap: " << name << " allocator: " << allocator_name() << "\n";
+}
+
+void bind_thread_pool_heap(boost::asio::thread_pool& pool, std::size_t num_threads, const std::string& name) {
+    // Each task blocks until all of them have started, so that every thread in the pool executes exactly one of them
+    std::latch all_started{static_cast<std::ptrdiff_t>(num_threads)};
+    std::latch all_bound{static_cast<std::ptrdiff_t>(num_threads)};
+    for (std::size_t i{0}; i < num_threads; ++i) {
+        boost::asio::post(pool, [&]() {
+            all_started.arrive_and_wait();
+            bind_thread_heap(name);
+            all_bound.count_down();
+        });
+    }
+    all_bound.wait();
+}
+
+std::vector<HeapStats> heap_stats() {
+    std::scoped_lock lock{heaps_mutex};
+#if defined(SILKRPC_HAS_JEMALLOC)
+    advance_jemalloc_epoch();
+#endif
+    std::vector<HeapStats> stats;
+    stats.reserve(heaps.size());
+    for (const auto& heap : heaps) {
+        HeapStats heap_stats{heap.name, heap.thread_count};
+#if defined(SILKRPC_HAS_JEMALLOC)
+        const auto prefix = "stats.arenas." + std::to_string(heap.arena);
+        heap_stats.allocated_bytes = read_jemalloc_stat(prefix + ".small.allocated") + read_jemalloc_stat(prefix + ".large.allocated");
+#endif
+        stats.push_back(std::move(heap_stats));
+    }
+    return stats;
+}
+
+uint64_t thread_allocated_bytes() noexcept {
+#if defined(SILKRPC_HAS_JEMALLOC)
+    // The counter of the thread is kept by jemalloc itself, so it is looked up just once and then read directly
+    thread_local const uint64_t* allocated = []() -> const uint64_t* {
+        uint64_t* counter{nullptr};
+        std::size_t size{sizeof(counter)};
+        if (mallctl("thread.allocatedp", &counter, &size, nullptr, 0) != 0) {
+            return nullptr;
+        }
+        return counter;
+    }();
+    return allocated ? *allocated : 0;
+#else
+    return thread_new_bytes;
+#endif
+}
+
+} // namespace silkrpc
+
+#if !defined(SILKRPC_HAS_JEMALLOC)
+// The replaced operators allocate through malloc like the default ones, so that the default operator delete still
+// matches: all the other forms of operator new (arrays, nothrow) are implemented by the standard library on top of these
+void* operator new(std::size_t size) {
+    silkrpc::thread_new_bytes += size;
+    for (;;) {
+        if (void* p = std::malloc(size == 0 ? 1 : size)) {
+            return p;
+        }
+        const auto handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc{};
+        }
+        handler();
+    }
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    silkrpc::thread_new_bytes += size;
+    const auto align = static_cast<std::size_t>(alignment);
+    // aligned_alloc requires the size to be a multiple of the alignment
+    const auto aligned_size = (size + align - 1) & ~(align - 1);
+    for (;;) {
+        if (void* p = std::aligned_alloc(align, aligned_size == 0 ? align : aligned_size)) {
+            return p;
+        }
+        const auto handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc{};
+        }
+        handler();
+    }
+}
+#endif
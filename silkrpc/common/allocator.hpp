@@ -0,0 +1,72 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_ALLOCATOR_HPP_
+#define SILKRPC_COMMON_ALLOCATOR_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/asio/thread_pool.hpp>
+
+namespace silkrpc {
+
+//! The name of the allocator selected at build time (see SILKRPC_ALLOCATOR), i.e. mimalloc, jemalloc, tcmalloc or system
+std::string_view allocator_name() noexcept;
+
+//! The process-wide statistics of the allocator, zero when not provided by it
+struct AllocatorStats {
+    uint64_t allocated_bytes{0};    // bytes of the blocks in use by the application
+    uint64_t resident_bytes{0};     // bytes of physical memory held by the allocator
+    uint64_t mapped_bytes{0};       // bytes of virtual memory committed or mapped by the allocator
+};
+
+//! Return the process-wide statistics of the allocator
+AllocatorStats allocator_stats();
+
+//! The statistics of one named heap, shared by the threads of one subsystem (e.g. one execution context or worker class)
+struct HeapStats {
+    std::string name;
+    std::size_t thread_count{0};    // number of threads bound to the heap
+    uint64_t allocated_bytes{0};    // bytes of the blocks in use allocated from the heap, zero unless heap_stats_supported
+};
+
+//! Return true if the allocator keeps separate statistics for each heap, i.e. only jemalloc (one arena per heap)
+bool heap_stats_supported() noexcept;
+
+//! Make the calling thread allocate from the named heap, created at first use. All the supported allocators keep a cache
+//! per thread anyway, so the small allocations of the coroutine frames, JSON nodes and buffers never contend on a lock;
+//! with jemalloc each heap is also a dedicated arena, so that threads of different subsystems never share one and their
+//! allocations are accounted separately. Memory can still be freed by any thread
+void bind_thread_heap(const std::string& name);
+
+//! Bind each thread of the pool to the named heap: it waits until all the threads are bound
+void bind_thread_pool_heap(boost::asio::thread_pool& pool, std::size_t num_threads, const std::string& name);
+
+//! Return the statistics of the named heaps in order of creation
+std::vector<HeapStats> heap_stats();
+
+//! Return the bytes allocated so far by the calling thread, never decreasing: the difference between two readings gives
+//! the bytes allocated in between. With jemalloc all the allocations are counted by the allocator itself, otherwise it is
+//! just the ones made through the global operator new, which is replaced for the purpose
+uint64_t thread_allocated_bytes() noexcept;
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_ALLOCATOR_HPP_
@@ -0,0 +1,102 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "allocator.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+#include <boost/asio/thread_pool.hpp>
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+static const HeapStats* find_heap(const std::vector<HeapStats>& heaps, const std::string& name) {
+    const auto it = std::find_if(heaps.begin(), heaps.end(), [&](const auto& heap) { return heap.name == name; });
+    return it == heaps.end() ? nullptr : &*it;
+}
+
+TEST_CASE("allocator_name", "[silkrpc][common][allocator]") {
+    const auto name = allocator_name();
+    CHECK((name == "mimalloc" || name == "jemalloc" || name == "tcmalloc" || name == "system"));
+}
+
+TEST_CASE("allocator_stats", "[silkrpc][common][allocator]") {
+    const auto block = std::make_unique<char[]>(1024 * 1024);
+    const auto stats = allocator_stats();
+    CHECK(stats.allocated_bytes <= stats.mapped_bytes);
+}
+
+TEST_CASE("bind_thread_heap", "[silkrpc][common][allocator]") {
+    SECTION("one thread") {
+        std::thread{[]() { bind_thread_heap("allocator_test_single"); }}.join();
+        const auto heaps = heap_stats();
+        const auto heap = find_heap(heaps, "allocator_test_single");
+        REQUIRE(heap != nullptr);
+        CHECK(heap->thread_count == 1);
+    }
+
+    SECTION("allocations are accounted to the heap") {
+        std::unique_ptr<char[]> block;
+        std::thread{[&]() {
+            bind_thread_heap("allocator_test_accounted");
+            block = std::make_unique<char[]>(64 * 1024);
+        }}.join();
+        const auto heaps = heap_stats();
+        const auto heap = find_heap(heaps, "allocator_test_accounted");
+        REQUIRE(heap != nullptr);
+        if (heap_stats_supported()) {
+            CHECK(heap->allocated_bytes >= 64 * 1024);
+        } else {
+            CHECK(heap->allocated_bytes == 0);
+        }
+    }
+}
+
+TEST_CASE("bind_thread_pool_heap", "[silkrpc][common][allocator]") {
+    boost::asio::thread_pool pool{3};
+    bind_thread_pool_heap(pool, 3, "allocator_test_pool");
+    const auto heaps = heap_stats();
+    const auto heap = find_heap(heaps, "allocator_test_pool");
+    REQUIRE(heap != nullptr);
+    CHECK(heap->thread_count == 3);
+    pool.join();
+}
+
+TEST_CASE("thread_allocated_bytes", "[silkrpc][common][allocator]") {
+    SECTION("counts the allocations of the calling thread") {
+        const auto before = thread_allocated_bytes();
+        const auto block = std::make_unique<char[]>(64 * 1024);
+        CHECK(thread_allocated_bytes() - before >= 64 * 1024);
+    }
+    SECTION("counts the over-aligned allocations") {
+        struct alignas(64) Aligned {
+            char bytes[64];
+        };
+        const auto before = thread_allocated_bytes();
+        const auto block = std::make_unique<Aligned[]>(1024);
+        CHECK(thread_allocated_bytes() - before >= 64 * 1024);
+        CHECK(reinterpret_cast<std::uintptr_t>(block.get()) % 64 == 0);
+    }
+    SECTION("ignores the allocations of other threads") {
+        const auto before = thread_allocated_bytes();
+        std::thread{[]() { const auto block = std::make_unique<char[]>(1024 * 1024); }}.join();
+        CHECK(thread_allocated_bytes() - before < 1024 * 1024);
+    }
+}
+
+} // namespace silkrpc
@@ -16,6 +16,13 @@
 
 #include "binary_search.hpp"
 
+#include <algorithm>
+#include <vector>
+
+#include <boost/asio/this_coro.hpp>
+
+#include <silkrpc/concurrency/parallel_for.hpp>
+
 namespace silkrpc {
 
 boost::asio::awaitable<std::size_t> binary_search(std::size_t n, BinaryPredicate pred) {
@@ -33,4 +40,37 @@ boost::asio::awaitable<std::size_t> binary_search(std::size_t n, BinaryPredicate
     co_return i;
 }
 
+boost::asio::awaitable<std::size_t> kary_search(std::size_t n, std::size_t num_probes, ProbePredicate pred) {
+    if (num_probes <= 1) {
+        co_return co_await binary_search(n, [&](std::size_t m) { return pred(0, m); });
+    }
+    const auto executor = co_await boost::asio::this_coro::executor;
+    std::vector<std::size_t> probes;
+    std::vector<char> results;
+    std::size_t i{0};
+    std::size_t j{n};
+    while (j > i) {
+        // Split [i, j) into k + 1 parts by k distinct probes, the only one being the binary search middle point if k == 1
+        const std::size_t count{j - i};
+        const std::size_t k{std::min(num_probes, count)};
+        probes.resize(k);
+        results.assign(k, false);
+        for (std::size_t r{0}; r < k; ++r) {
+            probes[r] = i + count * (r + 1) / (k + 1);
+        }
+        co_await parallel_for(executor, k, k, [&](std::size_t r) -> boost::asio::awaitable<void> {
+            results[r] = co_await pred(r, probes[r]);
+        });
+        // The predicate is monotonic: the lowest matching index is after the last failing probe, up to the first matching
+        const auto first_match = static_cast<std::size_t>(std::find(results.cbegin(), results.cend(), true) - results.cbegin());
+        if (first_match < k) {
+            j = probes[first_match];
+        }
+        if (first_match > 0) {
+            i = probes[first_match - 1] + 1;
+        }
+    }
+    co_return i;
+}
+
 } // namespace silkrpc
@@ -30,6 +30,15 @@ using BinaryPredicate = absl::FunctionRef<boost::asio::awaitable<bool>(std::size
 
 boost::asio::awaitable<std::size_t> binary_search(std::size_t n, BinaryPredicate pred);
 
+//! Predicate probing the index in some slot, i.e. a number in [0, num_probes) unique among the probes in flight
+using ProbePredicate = absl::FunctionRef<boost::asio::awaitable<bool>(std::size_t slot, std::size_t index)>;
+
+//! Find the lowest index in [0, n) satisfying the monotonic predicate (n if none) by a k-ary search, evaluating num_probes
+//! evenly spaced probes concurrently at each step: the dependent steps are log(n)/log(num_probes + 1) instead of log2(n)
+//! at the cost of more probes overall. The executor of the calling coroutine must not run the probes in parallel (see
+//! parallel_for), the slot can be used to give each concurrent probe its own resources (e.g. a database transaction).
+boost::asio::awaitable<std::size_t> kary_search(std::size_t n, std::size_t num_probes, ProbePredicate pred);
+
 } // namespace silkrpc
 
 #endif // SILKRPC_COMMON_BINARY_SEARCH_HPP_
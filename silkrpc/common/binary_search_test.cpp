@@ -16,10 +16,17 @@
 
 #include "binary_search.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
 #include <catch2/catch.hpp>
 
 #include <silkrpc/test/context_test_base.hpp>
@@ -65,4 +72,60 @@ TEST_CASE_METHOD(BinarySearchTest, "binary_search", "[silkrpc][common][binary_se
     }
 }
 
+boost::asio::awaitable<std::size_t> kary_search_in_vector(std::vector<std::size_t> sequence, std::size_t num_probes, std::size_t value) {
+    co_return co_await kary_search(sequence.size(), num_probes, [&, value](std::size_t, std::size_t i) -> boost::asio::awaitable<bool> {
+        co_return i < sequence.size() && sequence[i] >= value;
+    });
+}
+
+TEST_CASE_METHOD(BinarySearchTest, "kary_search", "[silkrpc][common][binary_search]") {
+    SECTION("same as binary_search") {
+        for (std::size_t num_probes{0}; num_probes <= 4; ++num_probes) {
+            for (const auto& [s, v, r] : kTestData) {
+                CHECK(spawn_and_wait(kary_search_in_vector(s, num_probes, v)) == r);
+            }
+        }
+    }
+
+    SECTION("all values in long sequence") {
+        std::vector<std::size_t> sequence(1000);
+        for (std::size_t i{0}; i < sequence.size(); ++i) {
+            sequence[i] = i * 2;
+        }
+        for (std::size_t value{0}; value <= 2000; value += 7) {
+            CHECK(spawn_and_wait(kary_search_in_vector(sequence, 3, value)) == (value + 1) / 2);
+        }
+    }
+
+    SECTION("fewer rounds than binary_search") {
+        std::size_t rounds{0};
+        std::size_t in_flight{0};
+        std::size_t max_in_flight{0};
+        const auto result = spawn_and_wait(kary_search(1'000'000, 7, [&](std::size_t slot, std::size_t i) -> boost::asio::awaitable<bool> {
+            CHECK(slot < 7);
+            if (slot == 0) {
+                ++rounds;
+            }
+            max_in_flight = std::max(max_in_flight, ++in_flight);
+            boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor, std::chrono::milliseconds{1}};
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            --in_flight;
+            co_return i >= 123'456;
+        }));
+        CHECK(result == 123'456);
+        CHECK(rounds <= 7); // log8(1'000'000) < 7, log2(1'000'000) ~ 20
+        CHECK(max_in_flight == 7);
+    }
+
+    SECTION("exception thrown by probe") {
+        const auto probe = [](std::size_t, std::size_t i) -> boost::asio::awaitable<bool> {
+            if (i == 50) {
+                throw std::runtime_error{"probe failed"};
+            }
+            co_return false;
+        };
+        CHECK_THROWS_AS(spawn_and_wait(kary_search(100, 3, probe)), std::runtime_error);
+    }
+}
+
 } // namespace silkrpc
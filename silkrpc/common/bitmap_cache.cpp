@@ -0,0 +1,57 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "bitmap_cache.hpp"
+
+#include <cstring>
+
+#include <silkworm/common/util.hpp>
+
+namespace silkrpc {
+
+std::shared_ptr<const BitmapChunks> BitmapCache::find(const std::string& table, silkworm::ByteView key) {
+    auto chunks = get(key_of(table, key));
+    if (!chunks || chunks->generation != generation()) {
+        return nullptr;
+    }
+    return chunks;
+}
+
+void BitmapCache::store(const std::string& table, silkworm::ByteView key, BitmapChunks chunks) {
+    if (chunks.generation != generation()) {
+        return;
+    }
+    insert(key_of(table, key), std::make_shared<const BitmapChunks>(std::move(chunks)));
+}
+
+std::size_t BitmapCache::approximate_size(const BitmapChunks& chunks) {
+    std::size_t size{sizeof(BitmapChunks)};
+    for (const auto& chunk : chunks.chunks) {
+        size += sizeof(chunk) + sizeof(roaring::Roaring) + chunk.second->getSizeInBytes();
+    }
+    return size;
+}
+
+evmc::bytes32 BitmapCache::key_of(const std::string& table, silkworm::ByteView key) {
+    silkworm::Bytes table_key{table.begin(), table.end()};
+    table_key.append(key);
+    const auto hash{silkworm::keccak256(table_key)};
+    evmc::bytes32 cache_key;
+    std::memcpy(cache_key.bytes, hash.bytes, sizeof(cache_key.bytes));
+    return cache_key;
+}
+
+} // namespace silkrpc
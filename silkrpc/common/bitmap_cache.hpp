@@ -0,0 +1,86 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_BITMAP_CACHE_HPP_
+#define SILKRPC_COMMON_BITMAP_CACHE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <evmc/evmc.hpp>
+#include <silkworm/common/base.hpp>
+
+#include <silkrpc/common/sharded_cache.hpp>
+#include <silkrpc/croaring/roaring.hh>
+
+namespace silkrpc {
+
+//! The sealed chunks of one bitmap index key (e.g. topic or address), i.e. all its chunks but the open-ended last one
+struct BitmapChunks {
+    //! The sealed chunks in key order, each one with the last block number in its key suffix
+    std::vector<std::pair<uint32_t, std::shared_ptr<const roaring::Roaring>>> chunks;
+
+    //! The block number the chunks start from: all the sealed chunks ending here or later are present up to the last one
+    uint32_t from_block{0};
+
+    //! The cache generation the chunks have been read at
+    uint64_t generation{0};
+};
+
+//! Cache of the deserialized sealed chunks of the log bitmap indexes, bounded by their approximate memory footprint (see
+//! ShardedCache). The open-ended last chunk of each key keeps changing as new blocks arrive, so it is never cached, while
+//! sealed chunks change only when unwinding: the cache is invalidated after each chain reorganization.
+class BitmapCache : public ShardedCache<BitmapChunks> {
+public:
+    //! The default memory budget in bytes
+    static constexpr std::size_t kDefaultMaxBytes{64 * 1024 * 1024};
+
+    //! The key suffix of the open-ended last chunk
+    static constexpr uint32_t kLastChunkSuffix{0xFFFFFFFF};
+
+    explicit BitmapCache(std::size_t max_bytes = kDefaultMaxBytes, bool shared_cache = true, std::size_t num_shards = kDefaultNumShards)
+    : ShardedCache{&BitmapCache::approximate_size, max_bytes, shared_cache, num_shards} {}
+
+    //! Return the sealed chunks cached for the key in the table, if any and still valid, or nullptr otherwise
+    std::shared_ptr<const BitmapChunks> find(const std::string& table, silkworm::ByteView key);
+
+    //! Store the sealed chunks for the key in the table, unless the cache has been invalidated since they have been read
+    void store(const std::string& table, silkworm::ByteView key, BitmapChunks chunks);
+
+    //! The current generation, to be taken before reading the chunks to store
+    uint64_t generation() const { return generation_.load(std::memory_order_acquire); }
+
+    //! Invalidate all the cached chunks
+    void invalidate() { generation_.fetch_add(1, std::memory_order_acq_rel); }
+
+    //! Return the approximate memory footprint of the chunks
+    static std::size_t approximate_size(const BitmapChunks& chunks);
+
+private:
+    //! Keys are hashed together with their table, because topics often are left-padded addresses
+    static evmc::bytes32 key_of(const std::string& table, silkworm::ByteView key);
+
+    std::atomic<uint64_t> generation_{0};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_BITMAP_CACHE_HPP_
@@ -0,0 +1,86 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "bitmap_cache.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+static const std::string kTopicTable{"LogTopicIndex"};
+static const std::string kAddressTable{"LogAddressIndex"};
+static const silkworm::Bytes kKey{0x01, 0x02, 0x03};
+
+static BitmapChunks make_chunks(const BitmapCache& cache, std::initializer_list<uint32_t> last_blocks) {
+    BitmapChunks chunks{{}, 0, cache.generation()};
+    for (const auto last_block : last_blocks) {
+        auto bitmap = std::make_shared<roaring::Roaring>();
+        bitmap->add(last_block);
+        chunks.chunks.emplace_back(last_block, std::move(bitmap));
+    }
+    return chunks;
+}
+
+TEST_CASE("bitmap cache find and store", "[silkrpc][common][bitmap_cache]") {
+    BitmapCache cache;
+    CHECK(!cache.find(kTopicTable, kKey));
+
+    cache.store(kTopicTable, kKey, make_chunks(cache, {100, 200}));
+    const auto chunks = cache.find(kTopicTable, kKey);
+    REQUIRE(chunks);
+    REQUIRE(chunks->chunks.size() == 2);
+    CHECK(chunks->chunks[0].first == 100);
+    CHECK(chunks->chunks[1].second->contains(200));
+
+    // Same key in another table is another entry
+    CHECK(!cache.find(kAddressTable, kKey));
+    CHECK(cache.size() == 1);
+}
+
+TEST_CASE("bitmap cache invalidation", "[silkrpc][common][bitmap_cache]") {
+    BitmapCache cache;
+    cache.store(kTopicTable, kKey, make_chunks(cache, {100}));
+    REQUIRE(cache.find(kTopicTable, kKey));
+
+    SECTION("cached chunks dropped") {
+        cache.invalidate();
+        CHECK(!cache.find(kTopicTable, kKey));
+    }
+
+    SECTION("chunks read before invalidation not stored") {
+        auto stale_chunks = make_chunks(cache, {100, 200});
+        cache.invalidate();
+        cache.store(kAddressTable, kKey, std::move(stale_chunks));
+        CHECK(!cache.find(kAddressTable, kKey));
+    }
+
+    SECTION("chunks read after invalidation stored") {
+        cache.invalidate();
+        cache.store(kTopicTable, kKey, make_chunks(cache, {100, 200}));
+        const auto chunks = cache.find(kTopicTable, kKey);
+        REQUIRE(chunks);
+        CHECK(chunks->chunks.size() == 2);
+    }
+}
+
+TEST_CASE("bitmap cache approximate size", "[silkrpc][common][bitmap_cache]") {
+    BitmapCache cache;
+    const auto empty_size = BitmapCache::approximate_size(make_chunks(cache, {}));
+    CHECK(empty_size == sizeof(BitmapChunks));
+    CHECK(BitmapCache::approximate_size(make_chunks(cache, {100, 200})) > empty_size);
+}
+
+} // namespace silkrpc
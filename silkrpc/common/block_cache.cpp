@@ -0,0 +1,155 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "block_cache.hpp"
+
+#include <cstring>
+#include <utility>
+
+#include <silkrpc/common/usdt.hpp>
+
+namespace silkrpc {
+
+namespace {
+
+struct BlockHashHash {
+    std::size_t operator()(const evmc::bytes32& hash) const noexcept {
+        // Keys are hashes, so any of their bytes is already uniformly distributed: skip those picking the shard
+        uint64_t infix;
+        std::memcpy(&infix, hash.bytes + sizeof(infix), sizeof(infix));
+        return static_cast<std::size_t>(infix);
+    }
+};
+
+using LocalBlockCache = LocalCache<evmc::bytes32, std::shared_ptr<const silkworm::BlockWithHash>, BlockHashHash, BlockCache::kNumLocalBlocks>;
+
+} // namespace
+
+std::size_t TransactionLocationCache::approximate_size(const TransactionLocation& location) {
+    return sizeof(location) + kCacheEntryOverhead;
+}
+
+std::size_t BlockJsonCache::approximate_size(const std::string& json) {
+    return sizeof(json) + json.capacity() + kCacheEntryOverhead;
+}
+
+std::size_t BlockHashesCache::approximate_size(const BlockHashes& hashes) {
+    return sizeof(hashes) + (hashes.transaction_hashes.capacity() + hashes.ommer_hashes.capacity()) * sizeof(evmc::bytes32) + kCacheEntryOverhead;
+}
+
+BlockCache::BlockCache(std::size_t max_bytes, bool shared_cache, std::size_t num_shards, bool compact, std::size_t compression_threshold)
+: ShardedCache{&BlockCache::approximate_size, compact ? 0 : max_bytes, shared_cache, num_shards},
+  compression_threshold_{compression_threshold},
+  transaction_locations_{TransactionLocationCache::kDefaultMaxBytes, shared_cache, num_shards},
+  full_block_json_{BlockJsonCache::kDefaultMaxBytes, shared_cache, num_shards},
+  block_json_{BlockJsonCache::kDefaultMaxBytes, shared_cache, num_shards},
+  block_hashes_{BlockHashesCache::kDefaultMaxBytes, shared_cache, num_shards} {
+    if (compact) {
+        compact_blocks_ = std::make_unique<ShardedCache<CompactBlock>>(&BlockCache::approximate_compact_size, max_bytes, shared_cache,
+            num_shards);
+    }
+}
+
+std::shared_ptr<const silkworm::BlockWithHash> BlockCache::get(const evmc::bytes32& key) {
+    thread_local LocalBlockCache local_blocks;
+
+    // Take the generation before reading, so that a block evicted meanwhile is never kept at the new generation
+    const auto generation = this->generation();
+    if (const auto* local_block = local_blocks.find(local_owner_, generation, key)) {
+        SILKRPC_PROBE(block_cache_hit, key.bytes);
+        return *local_block;
+    }
+    std::shared_ptr<const silkworm::BlockWithHash> block;
+    if (compact_blocks_) {
+        const auto compact_block = compact_blocks_->get(key);
+        if (compact_block) {
+            block = std::make_shared<silkworm::BlockWithHash>(compact_block->decode());
+        }
+    } else {
+        block = ShardedCache::get(key);
+    }
+    if (block) {
+        SILKRPC_PROBE(block_cache_hit, key.bytes);
+        local_blocks.put(local_owner_, generation, key, block);
+    } else {
+        SILKRPC_PROBE(block_cache_miss, key.bytes);
+    }
+    return block;
+}
+
+void BlockCache::insert(const evmc::bytes32& key, std::shared_ptr<const silkworm::BlockWithHash> block) {
+    if (!block_hashes_.get(key)) {
+        block_hashes_.insert(key, std::make_shared<const BlockHashes>(make_block_hashes(block->block)));
+    }
+    if (compact_blocks_) {
+        compact_blocks_->insert(key, std::make_shared<CompactBlock>(*block, compression_threshold_));
+    } else {
+        ShardedCache::insert(key, std::move(block));
+    }
+}
+
+std::shared_ptr<const BlockHashes> BlockCache::hashes(const silkworm::BlockWithHash& block) {
+    auto block_hashes = block_hashes_.get(block.hash);
+    if (!block_hashes) {
+        block_hashes = std::make_shared<const BlockHashes>(make_block_hashes(block.block));
+        block_hashes_.insert(block.hash, block_hashes);
+    }
+    return block_hashes;
+}
+
+std::size_t BlockCache::size() const {
+    return compact_blocks_ ? compact_blocks_->size() : ShardedCache::size();
+}
+
+std::size_t BlockCache::size_bytes() const {
+    return compact_blocks_ ? compact_blocks_->size_bytes() : ShardedCache::size_bytes();
+}
+
+void BlockCache::set_max_bytes(std::size_t max_bytes) {
+    if (compact_blocks_) {
+        compact_blocks_->set_max_bytes(max_bytes);
+    } else {
+        ShardedCache::set_max_bytes(max_bytes);
+    }
+}
+
+std::size_t BlockCache::max_bytes() const {
+    return compact_blocks_ ? compact_blocks_->max_bytes() : ShardedCache::max_bytes();
+}
+
+std::size_t BlockCache::approximate_size(const silkworm::BlockWithHash& block) {
+    const auto header_size = [](const silkworm::BlockHeader& header) {
+        return sizeof(silkworm::BlockHeader) + header.extra_data.size();
+    };
+
+    std::size_t size{sizeof(silkworm::BlockWithHash) + header_size(block.block.header)};
+    for (const auto& transaction : block.block.transactions) {
+        size += sizeof(silkworm::Transaction) + transaction.data.size();
+        for (const auto& entry : transaction.access_list) {
+            size += sizeof(silkworm::AccessListEntry) + entry.storage_keys.size() * sizeof(evmc::bytes32);
+        }
+    }
+    for (const auto& ommer : block.block.ommers) {
+        size += header_size(ommer);
+    }
+    return size;
+}
+
+std::size_t BlockCache::approximate_compact_size(const CompactBlock& block) {
+    return block.size_bytes() + kCacheEntryOverhead;
+}
+
+} // namespace silkrpc
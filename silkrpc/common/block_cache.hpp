@@ -18,7 +18,9 @@
 #define SILKRPC_COMMON_BLOCK_CACHE_HPP_
 
 #include <cstddef>
-#include <mutex>
+#include <cstdint>
+#include <memory>
+#include <string>
 
 #include <evmc/evmc.hpp>
 #include <silkworm/chain/config.hpp>
@@ -29,35 +31,146 @@
 #include <silkworm/types/receipt.hpp>
 #include <silkworm/types/transaction.hpp>
 
-#include <boost/compute/detail/lru_cache.hpp>
+#include <silkrpc/common/compact_block.hpp>
+#include <silkrpc/common/disk_cache.hpp>
+#include <silkrpc/common/local_cache.hpp>
+#include <silkrpc/common/sharded_cache.hpp>
+#include <silkrpc/types/block.hpp>
 
 namespace silkrpc {
 
-class BlockCache {
+//! The position of a transaction in the block including it
+struct TransactionLocation {
+    uint64_t block_number{0};
+    evmc::bytes32 block_hash;
+    std::size_t index{0};
+};
+
+//! Cache of the transaction locations by transaction hash, bounded by their approximate memory footprint, so that
+//! looking up a recent transaction skips both the transaction lookup table and the scan of its block. A location does
+//! not say if its block is still canonical, so it must be checked against the canonical hash of the block number.
+class TransactionLocationCache : public ShardedCache<TransactionLocation> {
+public:
+    //! The default memory budget in bytes
+    static constexpr std::size_t kDefaultMaxBytes{16 * 1024 * 1024};
+
+    explicit TransactionLocationCache(std::size_t max_bytes = kDefaultMaxBytes, bool shared_cache = true, std::size_t num_shards = kDefaultNumShards)
+    : ShardedCache{&TransactionLocationCache::approximate_size, max_bytes, shared_cache, num_shards} {}
+
+    //! Return the approximate memory footprint of the location, including the bookkeeping of its cache entry
+    static std::size_t approximate_size(const TransactionLocation& location);
+};
+
+//! Cache of the serialized JSON of the blocks by hash, as returned by eth_getBlockByHash and eth_getBlockByNumber, bounded
+//! by the size of the JSON text, so that the replies for the hottest blocks are built by copying it. The JSON of a block
+//! never changes (the total difficulty depends just on its hash), so no invalidation is needed.
+class BlockJsonCache : public ShardedCache<std::string> {
 public:
-    explicit BlockCache(std::size_t capacity = 1024, bool shared_cache = true)
-        : block_cache_(capacity), shared_cache_(shared_cache) {}
-
-    boost::optional <silkworm::BlockWithHash> get(const evmc::bytes32& key) {
-        if (shared_cache_) {
-            const std::lock_guard<std::mutex> lock(access_);
-            return block_cache_.get(key);
-        }
-        return block_cache_.get(key);
-    }
-
-    void insert(const evmc::bytes32 &key, const silkworm::BlockWithHash& block) {
-        if (shared_cache_) {
-            const std::lock_guard<std::mutex> lock(access_);
-            return block_cache_.insert(key, block);
-        }
-        block_cache_.insert(key, block);
-    }
+    //! The default memory budget in bytes
+    static constexpr std::size_t kDefaultMaxBytes{32 * 1024 * 1024};
+
+    explicit BlockJsonCache(std::size_t max_bytes = kDefaultMaxBytes, bool shared_cache = true, std::size_t num_shards = kDefaultNumShards)
+    : ShardedCache{&BlockJsonCache::approximate_size, max_bytes, shared_cache, num_shards} {}
+
+    //! Return the approximate memory footprint of the JSON text, including the bookkeeping of its cache entry
+    static std::size_t approximate_size(const std::string& json);
+};
+
+//! Cache of the hashes of the transactions and of the ommers of the blocks by block hash, bounded by their approximate
+//! memory footprint, so that the hashes are computed once per block instead of on each serialization or log lookup. The
+//! hashes of a block never change, so no invalidation is needed.
+class BlockHashesCache : public ShardedCache<BlockHashes> {
+public:
+    //! The default memory budget in bytes
+    static constexpr std::size_t kDefaultMaxBytes{16 * 1024 * 1024};
+
+    explicit BlockHashesCache(std::size_t max_bytes = kDefaultMaxBytes, bool shared_cache = true, std::size_t num_shards = kDefaultNumShards)
+    : ShardedCache{&BlockHashesCache::approximate_size, max_bytes, shared_cache, num_shards} {}
+
+    //! Return the approximate memory footprint of the hashes, including the bookkeeping of their cache entry
+    static std::size_t approximate_size(const BlockHashes& hashes);
+};
+
+//! Cache of blocks by hash, bounded by the approximate memory footprint of the blocks (see ShardedCache). The locations
+//! of the transactions looked up by hash are kept along with the blocks, so that they index straight into them, and so
+//! is the serialized JSON of the blocks, both with full transactions and with transaction hashes only. The hashes of the
+//! transactions and of the ommers are computed when a block is inserted and kept along with it as well.
+//! The last blocks hit by each thread are kept in a small thread-local cache in front (see LocalCache), so that the
+//! hottest blocks (e.g. the chain head) are served without touching the locks shared with the other execution contexts.
+//! In compact mode the blocks are kept in their compact form instead (see CompactBlock), so that the same budget holds
+//! several times more blocks: each block is decoded when missing from the thread-local cache, which keeps it decoded.
+//! The compact blocks can also be compressed when their encoded parts exceed the compression threshold, so that the same
+//! budget (i.e. in compressed bytes) holds even more of the mid-age blocks, paying the decompression on each decoding.
+class BlockCache : public ShardedCache<silkworm::BlockWithHash> {
+public:
+    //! The default memory budget in bytes
+    static constexpr std::size_t kDefaultMaxBytes{128 * 1024 * 1024};
+
+    //! The number of blocks kept in the thread-local cache
+    static constexpr std::size_t kNumLocalBlocks{16};
+
+    explicit BlockCache(std::size_t max_bytes = kDefaultMaxBytes, bool shared_cache = true, std::size_t num_shards = kDefaultNumShards,
+                        bool compact = false, std::size_t compression_threshold = 0);
+
+    //! Return the cached block for the given hash, if any, or nullptr otherwise: the thread-local cache is checked first
+    std::shared_ptr<const silkworm::BlockWithHash> get(const evmc::bytes32& key);
+
+    //! Insert the block, turning it into its compact form (compressed if big enough) in compact mode, and memoize its hashes
+    void insert(const evmc::bytes32& key, std::shared_ptr<const silkworm::BlockWithHash> block);
+
+    //! Return the hashes of the block, computing and memoizing them if missing (e.g. evicted before the block)
+    std::shared_ptr<const BlockHashes> hashes(const silkworm::BlockWithHash& block);
+
+    //! Return the memoized hashes of the block having the specified hash, if any, or nullptr otherwise
+    std::shared_ptr<const BlockHashes> find_hashes(const evmc::bytes32& block_hash) { return block_hashes_.get(block_hash); }
+
+    std::size_t size() const;
+
+    //! Return the approximate number of bytes accounted for all the cached blocks
+    std::size_t size_bytes() const;
+
+    //! Change the memory budget in place (see ShardedCache::set_max_bytes)
+    void set_max_bytes(std::size_t max_bytes);
+
+    //! Return the memory budget of the blocks
+    std::size_t max_bytes() const;
+
+    //! The current generation of the blocks (see ShardedCache::generation)
+    uint64_t generation() const { return compact_blocks_ ? compact_blocks_->generation() : ShardedCache::generation(); }
+
+    //! Return true if the blocks are kept in their compact form
+    bool compact() const noexcept { return compact_blocks_ != nullptr; }
+
+    //! Return the approximate memory footprint of the block, including its variable-length parts
+    static std::size_t approximate_size(const silkworm::BlockWithHash& block);
+
+    //! Return the approximate memory footprint of the compact block, including the bookkeeping of its cache entry
+    static std::size_t approximate_compact_size(const CompactBlock& block);
+
+    //! The locations of the transactions looked up by hash
+    TransactionLocationCache& transaction_locations() noexcept { return transaction_locations_; }
+
+    //! The serialized JSON of the blocks with full transactions or with transaction hashes only
+    BlockJsonCache& block_json(bool full_tx) noexcept { return full_tx ? full_block_json_ : block_json_; }
+
+    //! The on-disk secondary tier of the blocks evicted from memory, if any (see DiskCache)
+    std::shared_ptr<DiskCache>& disk_cache() noexcept { return disk_cache_; }
 
 private:
-    mutable std::mutex access_;
-    boost::compute::detail::lru_cache<evmc::bytes32, silkworm::BlockWithHash> block_cache_;
-    bool shared_cache_;
+    //! The compact blocks, in compact mode only
+    std::unique_ptr<ShardedCache<CompactBlock>> compact_blocks_;
+
+    //! The minimum size of the encoded parts of the compact blocks to be compressed, 0 means never
+    std::size_t compression_threshold_;
+
+    TransactionLocationCache transaction_locations_;
+    BlockJsonCache full_block_json_;
+    BlockJsonCache block_json_;
+    BlockHashesCache block_hashes_;
+    std::shared_ptr<DiskCache> disk_cache_;
+
+    //! The owner id tagging the entries of this cache in the thread-local caches
+    uint64_t local_owner_{make_local_cache_owner()};
 };
 
 } // namespace silkrpc
@@ -0,0 +1,99 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "block_cache.hpp"
+
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/endian/conversion.hpp>
+#include <evmc/evmc.hpp>
+
+namespace silkrpc {
+
+static constexpr uint64_t kNumBlocks{10'000};
+
+static evmc::bytes32 block_hash(uint64_t block_number) {
+    evmc::bytes32 hash{};
+    boost::endian::store_big_u64(hash.bytes + sizeof(hash.bytes) - sizeof(uint64_t), block_number);
+    return hash;
+}
+
+static std::shared_ptr<const silkworm::BlockWithHash> make_block(uint64_t block_number) {
+    auto block = std::make_shared<silkworm::BlockWithHash>();
+    block->hash = block_hash(block_number);
+    block->block.header.number = block_number;
+    block->block.transactions.resize(100);
+    for (auto& transaction : block->block.transactions) {
+        transaction.data.resize(100);
+    }
+    return block;
+}
+
+//! The cache having all the blocks, shared by all the benchmark threads
+static BlockCache& full_cache() {
+    static const auto cache = []() {
+        auto cache = std::make_unique<BlockCache>();
+        for (uint64_t i{0}; i < kNumBlocks; ++i) {
+            cache->insert(block_hash(i), make_block(i));
+        }
+        return cache;
+    }();
+    return *cache;
+}
+
+static void BM_BlockCache_get(benchmark::State& state) {
+    auto& cache = full_cache();
+    std::vector<evmc::bytes32> hashes;
+    for (uint64_t i{0}; i < kNumBlocks; ++i) {
+        hashes.push_back(block_hash((i * 7'919) % kNumBlocks));
+    }
+    std::size_t i{0};
+    for (auto _ : state) {
+        auto block = cache.get(hashes[i++ % hashes.size()]);
+        benchmark::DoNotOptimize(block);
+    }
+}
+BENCHMARK(BM_BlockCache_get)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_BlockCache_get_miss(benchmark::State& state) {
+    auto& cache = full_cache();
+    const auto unknown_hash = block_hash(kNumBlocks + 1);
+    for (auto _ : state) {
+        auto block = cache.get(unknown_hash);
+        benchmark::DoNotOptimize(block);
+    }
+}
+BENCHMARK(BM_BlockCache_get_miss);
+
+//! Insert the blocks into a cache holding just a fraction of them, so that each insertion evicts some entries
+static void BM_BlockCache_insert(benchmark::State& state) {
+    std::vector<std::shared_ptr<const silkworm::BlockWithHash>> blocks;
+    for (uint64_t i{0}; i < kNumBlocks; ++i) {
+        blocks.push_back(make_block(i));
+    }
+    BlockCache cache{BlockCache::approximate_size(*blocks[0]) * kNumBlocks / 10};
+    std::size_t i{0};
+    for (auto _ : state) {
+        const auto& block = blocks[i++ % blocks.size()];
+        cache.insert(block->hash, block);
+    }
+}
+BENCHMARK(BM_BlockCache_insert);
+
+} // namespace silkrpc
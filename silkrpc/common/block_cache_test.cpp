@@ -17,6 +17,8 @@
 #include "block_cache.hpp"
 #include <catch2/catch.hpp>
 
+#include <silkrpc/common/util.hpp>
+
 namespace silkrpc {
 
 using Catch::Matchers::Message;
@@ -44,11 +46,11 @@ TEST_CASE("insert entry in cache(lock)", "[silkrpc][commands][block_cache]") {
     auto ret_block_option = block_cache.get(bh1);
     CHECK(!ret_block_option);
 
-    const silkworm::BlockWithHash block1 {};
+    const auto block1 = std::make_shared<silkworm::BlockWithHash>();
     block_cache.insert(bh1, block1);
 
     ret_block_option = block_cache.get(bh1);
-    CHECK((*ret_block_option).hash == block1.hash);
+    CHECK(ret_block_option == block1);
 }
 
 TEST_CASE("insert entry in cache(no-lock)", "[silkrpc][commands][block_cache]") {
@@ -57,12 +59,274 @@ TEST_CASE("insert entry in cache(no-lock)", "[silkrpc][commands][block_cache]")
     auto ret_block_option = block_cache.get(bh1);
     CHECK(!ret_block_option);
 
-    const silkworm::BlockWithHash block1 {};
+    const auto block1 = std::make_shared<silkworm::BlockWithHash>();
     block_cache.insert(bh1, block1);
 
     ret_block_option = block_cache.get(bh1);
-    CHECK((*ret_block_option).hash == block1.hash);
+    CHECK(ret_block_option == block1);
 }
 
-} // namespace silkrpc
+TEST_CASE("budget split among shards", "[silkrpc][commands][block_cache]") {
+    CHECK(BlockCache{1024, true, 0}.num_shards() == 1);
+    CHECK(BlockCache{1024, true, 8}.num_shards() == 8);
+    CHECK(BlockCache{}.num_shards() == BlockCache::kDefaultNumShards);
+}
+
+TEST_CASE("approximate size accounts for variable-length parts", "[silkrpc][commands][block_cache]") {
+    silkworm::BlockWithHash block{};
+    const auto empty_size = BlockCache::approximate_size(block);
+    CHECK(empty_size >= sizeof(silkworm::BlockWithHash));
+
+    block.block.transactions.resize(1);
+    block.block.transactions[0].data.resize(1000);
+    CHECK(BlockCache::approximate_size(block) >= empty_size + 1000);
+}
+
+TEST_CASE("insert existing entry in cache replaces it", "[silkrpc][commands][block_cache]") {
+    evmc::bytes32 bh1{0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    BlockCache block_cache;
+
+    auto block1 = std::make_shared<silkworm::BlockWithHash>();
+    block_cache.insert(bh1, block1);
+    const auto block1_size = block_cache.size_bytes();
+    block1 = std::make_shared<silkworm::BlockWithHash>();
+    block1->block.header.number = 1;
+    block_cache.insert(bh1, block1);
+
+    CHECK(block_cache.size() == 1);
+    CHECK(block_cache.size_bytes() == block1_size);
+    const auto ret_block_option = block_cache.get(bh1);
+    CHECK(ret_block_option);
+    CHECK(ret_block_option->block.header.number == 1);
+}
+
+TEST_CASE("hit shares the cached block", "[silkrpc][commands][block_cache]") {
+    evmc::bytes32 bh1{0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    BlockCache block_cache;
+
+    block_cache.insert(bh1, std::make_shared<silkworm::BlockWithHash>());
+    CHECK(block_cache.get(bh1).get() == block_cache.get(bh1).get());
+}
 
+TEST_CASE("evict unreferenced entry first", "[silkrpc][commands][block_cache]") {
+    evmc::bytes32 bh1{0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    evmc::bytes32 bh2{0x474f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    evmc::bytes32 bh3{0x574f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    const auto block_size = BlockCache::approximate_size(silkworm::BlockWithHash{});
+    BlockCache block_cache(2 * block_size, true, 1);
+
+    block_cache.insert(bh1, std::make_shared<silkworm::BlockWithHash>());
+    block_cache.insert(bh2, std::make_shared<silkworm::BlockWithHash>());
+    CHECK(block_cache.get(bh1));
+    block_cache.insert(bh3, std::make_shared<silkworm::BlockWithHash>());
+
+    CHECK(block_cache.size() == 2);
+    CHECK(block_cache.size_bytes() == 2 * block_size);
+    CHECK(block_cache.get(bh1));
+    CHECK(!block_cache.get(bh2));
+    CHECK(block_cache.get(bh3));
+}
+
+TEST_CASE("hit after replacement returns new block", "[silkrpc][commands][block_cache]") {
+    evmc::bytes32 bh1{0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    BlockCache block_cache;
+
+    block_cache.insert(bh1, std::make_shared<silkworm::BlockWithHash>());
+    CHECK(block_cache.get(bh1));
+    const auto generation = block_cache.generation();
+    auto block1 = std::make_shared<silkworm::BlockWithHash>();
+    block1->block.header.number = 1;
+    block_cache.insert(bh1, block1);
+
+    CHECK(block_cache.generation() > generation);
+    CHECK(block_cache.get(bh1) == block1);
+}
+
+TEST_CASE("evicted entry not served after hit", "[silkrpc][commands][block_cache]") {
+    evmc::bytes32 bh1{0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    evmc::bytes32 bh2{0x474f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    const auto block_size = BlockCache::approximate_size(silkworm::BlockWithHash{});
+    BlockCache block_cache(block_size, true, 1);
+
+    block_cache.insert(bh1, std::make_shared<silkworm::BlockWithHash>());
+    CHECK(block_cache.get(bh1));
+    CHECK(block_cache.get(bh1));
+    block_cache.insert(bh2, std::make_shared<silkworm::BlockWithHash>());
+
+    CHECK(block_cache.size() == 1);
+    CHECK(!block_cache.get(bh1));
+    CHECK(block_cache.get(bh2));
+}
+
+TEST_CASE("insertion of new entry keeps generation", "[silkrpc][commands][block_cache]") {
+    evmc::bytes32 bh1{0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    evmc::bytes32 bh2{0x474f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    BlockCache block_cache;
+
+    block_cache.insert(bh1, std::make_shared<silkworm::BlockWithHash>());
+    const auto generation = block_cache.generation();
+    block_cache.insert(bh2, std::make_shared<silkworm::BlockWithHash>());
+    CHECK(block_cache.generation() == generation);
+}
+
+TEST_CASE("evict as many entries as needed by large block", "[silkrpc][commands][block_cache]") {
+    evmc::bytes32 bh1{0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    evmc::bytes32 bh2{0x474f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    evmc::bytes32 bh3{0x574f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    const auto block_size = BlockCache::approximate_size(silkworm::BlockWithHash{});
+    BlockCache block_cache(2 * block_size, true, 1);
+
+    block_cache.insert(bh1, std::make_shared<silkworm::BlockWithHash>());
+    block_cache.insert(bh2, std::make_shared<silkworm::BlockWithHash>());
+    auto large_block = std::make_shared<silkworm::BlockWithHash>();
+    large_block->block.transactions.resize(1);
+    large_block->block.transactions[0].data.resize(4 * block_size);
+    block_cache.insert(bh3, large_block);
+
+    CHECK(block_cache.size() == 1);
+    CHECK(!block_cache.get(bh1));
+    CHECK(!block_cache.get(bh2));
+    CHECK(block_cache.get(bh3) == large_block);
+}
+
+TEST_CASE("resize in place", "[silkrpc][commands][block_cache]") {
+    const auto block_size = BlockCache::approximate_size(silkworm::BlockWithHash{});
+    BlockCache block_cache(8 * block_size, true, 1);
+    const auto block_hash = [](uint8_t n) {
+        evmc::bytes32 hash;
+        hash.bytes[31] = n;
+        return hash;
+    };
+    for (uint8_t n{0}; n < 8; ++n) {
+        block_cache.insert(block_hash(n), std::make_shared<silkworm::BlockWithHash>());
+    }
+    CHECK(block_cache.size() == 8);
+
+    SECTION("growing keeps all the entries") {
+        block_cache.set_max_bytes(16 * block_size);
+        CHECK(block_cache.max_bytes() == 16 * block_size);
+        block_cache.insert(block_hash(8), std::make_shared<silkworm::BlockWithHash>());
+        CHECK(block_cache.size() == 9);
+    }
+
+    SECTION("shrinking evicts gradually") {
+        block_cache.set_max_bytes(2 * block_size);
+        CHECK(block_cache.size() == 8);
+        block_cache.insert(block_hash(8), std::make_shared<silkworm::BlockWithHash>());
+        CHECK(block_cache.size() == 8 - BlockCache::kMaxShrinkEvictions + 1);
+        block_cache.insert(block_hash(9), std::make_shared<silkworm::BlockWithHash>());
+        CHECK(block_cache.size() == 2);
+        CHECK(block_cache.size_bytes() == 2 * block_size);
+        CHECK(block_cache.get(block_hash(9)));
+    }
+}
+
+TEST_CASE("block JSON kept by variant", "[silkrpc][commands][block_cache]") {
+    BlockCache block_cache;
+    const evmc::bytes32 bh1{0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    CHECK(!block_cache.block_json(true).get(bh1));
+    CHECK(!block_cache.block_json(false).get(bh1));
+
+    const auto full_json = std::make_shared<const std::string>("{\"transactions\":[{}]}");
+    block_cache.block_json(true).insert(bh1, full_json);
+    CHECK(block_cache.block_json(true).get(bh1) == full_json);
+    CHECK(!block_cache.block_json(false).get(bh1));
+    CHECK(!block_cache.get(bh1));
+    CHECK(BlockJsonCache::approximate_size(*full_json) > full_json->size());
+}
+
+TEST_CASE("block hashes memoized on insertion", "[silkrpc][commands][block_cache]") {
+    BlockCache block_cache;
+    const evmc::bytes32 bh1{0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    auto block1 = std::make_shared<silkworm::BlockWithHash>();
+    block1->hash = bh1;
+    block1->block.transactions.resize(2);
+    block1->block.transactions[1].data = silkworm::Bytes(100, 0x01);
+    block1->block.ommers.resize(1);
+    block_cache.insert(bh1, block1);
+
+    const auto hashes = block_cache.hashes(*block1);
+    REQUIRE(hashes);
+    CHECK(hashes->transaction_hashes == hashes_of_transactions(block1->block.transactions));
+    REQUIRE(hashes->ommer_hashes.size() == 1);
+    CHECK(hashes->ommer_hashes[0] == block1->block.ommers[0].hash());
+    CHECK(block_cache.hashes(*block1) == hashes);
+
+    // Blocks not inserted get their hashes memoized on first use
+    const evmc::bytes32 bh2{0x474f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    silkworm::BlockWithHash block2;
+    block2.hash = bh2;
+    block2.block.transactions.resize(1);
+    const auto hashes2 = block_cache.hashes(block2);
+    REQUIRE(hashes2->transaction_hashes.size() == 1);
+    CHECK(hashes2->transaction_hashes[0] == hashes->transaction_hashes[0]);
+    CHECK(block_cache.hashes(block2) == hashes2);
+    CHECK(!block_cache.get(bh2));
+    CHECK(BlockHashesCache::approximate_size(*hashes) > 3 * sizeof(evmc::bytes32));
+}
+
+TEST_CASE("compact mode keeps blocks in compact form", "[silkrpc][commands][block_cache]") {
+    const evmc::bytes32 bh1{0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    const evmc::bytes32 bh2{0x474f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    BlockCache block_cache{BlockCache::kDefaultMaxBytes, true, 1, /*compact=*/true};
+    CHECK(block_cache.compact());
+    CHECK(block_cache.max_bytes() == BlockCache::kDefaultMaxBytes);
+
+    auto block1 = std::make_shared<silkworm::BlockWithHash>();
+    block1->hash = bh1;
+    block1->block.header.number = 1;
+    block1->block.transactions.resize(2);
+    block1->block.transactions[0].data = silkworm::Bytes(100, 0x01);
+    block1->block.transactions[0].from = 0x0715a7794a1dc8e42615f059dd6e406a6594651a_address;
+    block1->block.ommers.resize(1);
+    block_cache.insert(bh1, block1);
+
+    CHECK(block_cache.size() == 1);
+    CHECK(block_cache.size_bytes() == BlockCache::approximate_compact_size(CompactBlock{*block1}));
+    const auto cached_block = block_cache.get(bh1);
+    REQUIRE(cached_block);
+    CHECK(cached_block != block1);
+    CHECK(cached_block->hash == bh1);
+    CHECK(cached_block->block.header.number == 1);
+    REQUIRE(cached_block->block.transactions.size() == 2);
+    CHECK(cached_block->block.transactions[0].data == block1->block.transactions[0].data);
+    CHECK(cached_block->block.transactions[0].from == block1->block.transactions[0].from);
+    CHECK(!cached_block->block.transactions[1].from);
+    CHECK(cached_block->block.ommers.size() == 1);
+    CHECK(block_cache.get(bh1) == cached_block);
+    CHECK(!block_cache.get(bh2));
+
+    const auto generation = block_cache.generation();
+    auto block1_with_senders = std::make_shared<silkworm::BlockWithHash>(*block1);
+    block1_with_senders->block.transactions[1].from = 0x0715a7794a1dc8e42615f059dd6e406a6594651a_address;
+    block_cache.insert(bh1, block1_with_senders);
+    CHECK(block_cache.generation() > generation);
+    CHECK(block_cache.get(bh1)->block.transactions[1].from);
+
+    block_cache.set_max_bytes(1024);
+    CHECK(block_cache.max_bytes() == 1024);
+}
+
+TEST_CASE("compact mode compresses big blocks", "[silkrpc][commands][block_cache]") {
+    const evmc::bytes32 bh1{0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    BlockCache block_cache{BlockCache::kDefaultMaxBytes, true, 1, /*compact=*/true, /*compression_threshold=*/1024};
+
+    auto block1 = std::make_shared<silkworm::BlockWithHash>();
+    block1->hash = bh1;
+    block1->block.header.number = 1;
+    block1->block.transactions.resize(1);
+    block1->block.transactions[0].data = silkworm::Bytes(8192, 0x01);
+    block_cache.insert(bh1, block1);
+
+    const CompactBlock compressed_block{*block1, 1024};
+    CHECK(block_cache.size_bytes() == BlockCache::approximate_compact_size(compressed_block));
+    if (compressed_block.compressed()) {
+        CHECK(block_cache.size_bytes() < BlockCache::approximate_compact_size(CompactBlock{*block1}));
+    }
+    const auto cached_block = block_cache.get(bh1);
+    REQUIRE(cached_block);
+    REQUIRE(cached_block->block.transactions.size() == 1);
+    CHECK(cached_block->block.transactions[0].data == block1->block.transactions[0].data);
+}
+
+} // namespace silkrpc
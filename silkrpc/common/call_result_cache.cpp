@@ -0,0 +1,204 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "call_result_cache.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include <silkrpc/common/util.hpp>
+
+namespace silkrpc {
+
+namespace {
+
+constexpr uint8_t kOpBlockHash{0x40};
+constexpr uint8_t kOpGasLimit{0x45};
+constexpr uint8_t kOpBaseFee{0x48};
+constexpr uint8_t kOpPush1{0x60};
+constexpr uint8_t kOpPush32{0x7f};
+constexpr uint8_t kOpCreate{0xf0};
+constexpr uint8_t kOpCreate2{0xf5};
+
+} // namespace
+
+CallResultCache::Key CallResultCache::key_of(const silkworm::Transaction& txn) {
+    silkworm::Bytes encoding;
+    if (txn.from) {
+        encoding.append(txn.from->bytes, sizeof(txn.from->bytes));
+    }
+    silkworm::rlp::encode(encoding, txn, /*for_signing=*/false, /*wrap_eip2718_as_array=*/false);
+    const auto hash{hash_of(encoding)};
+    return silkworm::to_bytes32({hash.bytes, silkworm::kHashLength});
+}
+
+std::shared_ptr<const CallResult> CallResultCache::find(const Key& key, uint64_t block_number, evmc_revision revision) {
+    std::lock_guard lock{mutex_};
+    const auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return nullptr;
+    }
+    const auto& entry = it->second;
+    // The results are valid from the block they have been computed at up to the latest block applied
+    if (entry.revision != revision || block_number < entry.block_number || block_number > latest_block_ ||
+        (entry.reads_block_context && block_number != entry.block_number)) {
+        return nullptr;
+    }
+    recency_.splice(recency_.begin(), recency_, entry.recency);
+    return entry.result;
+}
+
+void CallResultCache::store(const Key& key, std::shared_ptr<const CallResult> result, uint64_t block_number, evmc_revision revision,
+                            bool reads_block_context, AccessedState read_set, uint64_t generation) {
+    if (max_entries_ == 0 || read_set.accounts.size() > kMaxReadAccounts || read_set.locations.size() > kMaxReadLocations) {
+        return;
+    }
+    read_set.normalize();
+
+    std::lock_guard lock{mutex_};
+    if (generation != generation_ || block_number != latest_block_) {
+        return;
+    }
+    if (entries_.contains(key)) {
+        remove(key);
+    }
+    while (entries_.size() >= max_entries_) {
+        remove(recency_.back());
+    }
+
+    recency_.push_front(key);
+    const auto it = entries_.emplace(key, Entry{std::move(result), block_number, revision, reads_block_context, std::move(read_set),
+        recency_.begin()}).first;
+    for (const auto& address : it->second.read_set.accounts) {
+        readers_[address].insert(key);
+    }
+    for (const auto& location : it->second.read_set.locations) {
+        readers_[location.first].insert(key);
+    }
+}
+
+uint64_t CallResultCache::generation() const {
+    std::lock_guard lock{mutex_};
+    return generation_;
+}
+
+void CallResultCache::apply(uint64_t block_number, const std::vector<evmc::address>& changed_accounts,
+                            const std::vector<StorageLocation>& changed_locations) {
+    std::lock_guard lock{mutex_};
+    ++generation_;
+    latest_block_ = block_number;
+
+    std::vector<Key> stale_keys;
+    for (const auto& address : changed_accounts) {
+        const auto readers_it = readers_.find(address);
+        if (readers_it != readers_.end()) {
+            stale_keys.insert(stale_keys.end(), readers_it->second.cbegin(), readers_it->second.cend());
+        }
+    }
+    for (const auto& location : changed_locations) {
+        const auto readers_it = readers_.find(location.first);
+        if (readers_it == readers_.end()) {
+            continue;
+        }
+        for (const auto& key : readers_it->second) {
+            const auto& locations = entries_.at(key).read_set.locations;
+            if (std::binary_search(locations.cbegin(), locations.cend(), location)) {
+                stale_keys.push_back(key);
+            }
+        }
+    }
+    for (const auto& key : stale_keys) {
+        if (entries_.contains(key)) {
+            remove(key);
+            ++invalidated_count_;
+        }
+    }
+}
+
+void CallResultCache::unwind() {
+    std::lock_guard lock{mutex_};
+    ++generation_;
+    invalidated_count_ += entries_.size();
+    entries_.clear();
+    recency_.clear();
+    readers_.clear();
+}
+
+bool CallResultCache::reads_block_context(const evmc::bytes32& code_hash, silkworm::ByteView code) {
+    {
+        std::lock_guard lock{mutex_};
+        const auto it = code_scans_.find(code_hash);
+        if (it != code_scans_.end()) {
+            return it->second;
+        }
+    }
+    const bool reads = scan_block_context(code);
+
+    std::lock_guard lock{mutex_};
+    if (code_scans_.size() >= kMaxCodeScans) {
+        code_scans_.clear();
+    }
+    code_scans_.emplace(code_hash, reads);
+    return reads;
+}
+
+bool CallResultCache::scan_block_context(silkworm::ByteView code) {
+    for (std::size_t i{0}; i < code.size(); ++i) {
+        const uint8_t opcode = code[i];
+        if ((opcode >= kOpBlockHash && opcode <= kOpGasLimit) || opcode == kOpBaseFee || opcode == kOpCreate || opcode == kOpCreate2) {
+            return true;
+        }
+        // Skip the immediate data of the pushes, which may contain any byte
+        if (opcode >= kOpPush1 && opcode <= kOpPush32) {
+            i += opcode - kOpPush1 + 1;
+        }
+    }
+    return false;
+}
+
+std::size_t CallResultCache::size() const {
+    std::lock_guard lock{mutex_};
+    return entries_.size();
+}
+
+uint64_t CallResultCache::invalidated_count() const {
+    std::lock_guard lock{mutex_};
+    return invalidated_count_;
+}
+
+void CallResultCache::remove(const Key& key) {
+    const auto it = entries_.find(key);
+    const auto unregister = [&](const evmc::address& address) {
+        const auto readers_it = readers_.find(address);
+        if (readers_it != readers_.end()) {
+            readers_it->second.erase(key);
+            if (readers_it->second.empty()) {
+                readers_.erase(readers_it);
+            }
+        }
+    };
+    for (const auto& address : it->second.read_set.accounts) {
+        unregister(address);
+    }
+    for (const auto& location : it->second.read_set.locations) {
+        unregister(location.first);
+    }
+    recency_.erase(it->second.recency);
+    entries_.erase(it);
+}
+
+} // namespace silkrpc
@@ -0,0 +1,138 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_COMMON_CALL_RESULT_CACHE_HPP_
+#define SILKRPC_COMMON_CALL_RESULT_CACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <evmc/evmc.hpp>
+#include <silkworm/common/base.hpp>
+#include <silkworm/types/transaction.hpp>
+
+#include <silkrpc/common/access_history.hpp>
+
+namespace silkrpc {
+
+//! The outcome of an eth_call executed past the pre-checks, i.e. the reply depends just on it
+struct CallResult {
+    int64_t error_code{0};
+    silkworm::Bytes data;
+};
+
+//! Cache of the results of the eth_call requests at the latest block, keyed by the call and shared among the execution
+//! contexts. Each result is kept along with its read set, i.e. the accounts and the storage locations read by the
+//! execution, and it is dropped only when some new block changes any of them: the results of the view calls carry across
+//! the blocks until their inputs change. The results reading the block context (e.g. TIMESTAMP or NUMBER) are served
+//! just at the block they have been computed at. The cache is bounded by the number of results, evicting the least
+//! recently used one first, and the generation taken before computing a result prevents storing stale entries.
+class CallResultCache {
+public:
+    //! The key of a call, i.e. the hash of its sender and of its transaction encoding
+    using Key = evmc::bytes32;
+
+    //! The default max number of cached results
+    static constexpr std::size_t kDefaultMaxEntries{16 * 1024};
+
+    //! The max number of accounts and of locations read by the results stored, so that each entry stays small
+    static constexpr std::size_t kMaxReadAccounts{AccessHistory::kMaxAccountsPerEntry};
+    static constexpr std::size_t kMaxReadLocations{AccessHistory::kMaxLocationsPerEntry};
+
+    //! The max number of code hashes whose opcode scan is memoized
+    static constexpr std::size_t kMaxCodeScans{4096};
+
+    explicit CallResultCache(std::size_t max_entries = kDefaultMaxEntries) : max_entries_{max_entries} {}
+
+    CallResultCache(const CallResultCache&) = delete;
+    CallResultCache& operator=(const CallResultCache&) = delete;
+
+    //! Return the key of the call executed as the given transaction
+    static Key key_of(const silkworm::Transaction& txn);
+
+    //! Return the result of the call at the block executed with the revision, if cached and still valid, or nullptr otherwise
+    std::shared_ptr<const CallResult> find(const Key& key, uint64_t block_number, evmc_revision revision);
+
+    //! Store the result of the call computed at the block and generation along with the state it has read, unless some
+    //! block has been applied since or the read set is too large: the result is valid until any of such state changes
+    void store(const Key& key, std::shared_ptr<const CallResult> result, uint64_t block_number, evmc_revision revision,
+               bool reads_block_context, AccessedState read_set, uint64_t generation);
+
+    //! The current generation, to be taken before computing the result to store
+    uint64_t generation() const;
+
+    //! Apply the changes of the new block, dropping the results which have read any of the changed accounts or locations
+    void apply(uint64_t block_number, const std::vector<evmc::address>& changed_accounts,
+               const std::vector<StorageLocation>& changed_locations);
+
+    //! Drop all the results on chain reorganizations, since the unwound changes are not known
+    void unwind();
+
+    //! Return true if the code reads the block context or creates contracts, using the scan memoized by code hash if any
+    bool reads_block_context(const evmc::bytes32& code_hash, silkworm::ByteView code);
+
+    //! Return true if the code contains any opcode reading the block context (BLOCKHASH, COINBASE, TIMESTAMP, NUMBER,
+    //! PREVRANDAO, GASLIMIT, BASEFEE) or creating contracts (CREATE, CREATE2), whose init code is never scanned
+    static bool scan_block_context(silkworm::ByteView code);
+
+    //! The number of cached results
+    std::size_t size() const;
+
+    //! The total number of results dropped by the changes of their read set
+    uint64_t invalidated_count() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<const CallResult> result;
+        uint64_t block_number{0};
+        evmc_revision revision{EVMC_FRONTIER};
+        bool reads_block_context{false};
+        //! The read set, i.e. the accounts read and the storage locations read in ascending order
+        AccessedState read_set;
+        //! The position in the recency list, most recent first
+        std::list<Key>::iterator recency;
+    };
+
+    void remove(const Key& key);
+
+    const std::size_t max_entries_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<Key, Entry> entries_;
+    std::list<Key> recency_;
+
+    //! The keys of the results having read each account or some of its storage locations
+    std::unordered_map<evmc::address, std::unordered_set<Key>> readers_;
+
+    //! The opcode scans of the code by code hash, cleared when full: the code of a given hash never changes
+    std::unordered_map<evmc::bytes32, bool> code_scans_;
+
+    //! The latest block applied, i.e. the one the cached results are known to be valid at
+    uint64_t latest_block_{0};
+    uint64_t generation_{0};
+    uint64_t invalidated_count_{0};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_CALL_RESULT_CACHE_HPP_
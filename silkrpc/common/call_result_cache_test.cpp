@@ -0,0 +1,189 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "call_result_cache.hpp"
+
+#include <memory>
+
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+
+namespace silkrpc {
+
+using evmc::literals::operator""_address;
+using evmc::literals::operator""_bytes32;
+
+static const evmc::address kContract{0x0715a7794a1dc8e42615f059dd6e406a6594651a_address};
+static const evmc::address kSender{0x52728289eba496b6080d57d0250a90663a07e556_address};
+static const evmc::address kOther{0x6951c35e335fa18c97cb207119133cd8009580cd_address};
+static const evmc::bytes32 kLocation1{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+static const evmc::bytes32 kLocation2{0x0000000000000000000000000000000000000000000000000000000000000002_bytes32};
+static const evmc::bytes32 kCodeHash{0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+
+static CallResultCache::Key key(uint8_t i) {
+    CallResultCache::Key key{};
+    key.bytes[31] = i;
+    return key;
+}
+
+static std::shared_ptr<const CallResult> result_of(uint8_t byte) {
+    return std::make_shared<const CallResult>(CallResult{0, silkworm::Bytes{byte}});
+}
+
+static AccessedState read_set() {
+    return AccessedState{{kContract, kSender}, {{kContract, kLocation1}}};
+}
+
+TEST_CASE("CallResultCache::key_of", "[silkrpc][common][call_result_cache]") {
+    silkworm::Transaction txn{};
+    txn.to = kContract;
+    txn.from = kSender;
+    txn.data = silkworm::Bytes{0x70, 0xa0, 0x82, 0x31};
+    const auto call_key{CallResultCache::key_of(txn)};
+    CHECK(CallResultCache::key_of(txn) == call_key);
+
+    SECTION("depends on the sender") {
+        txn.from = kOther;
+        CHECK(CallResultCache::key_of(txn) != call_key);
+    }
+    SECTION("depends on the input") {
+        txn.data.push_back(0x00);
+        CHECK(CallResultCache::key_of(txn) != call_key);
+    }
+}
+
+TEST_CASE("CallResultCache::store", "[silkrpc][common][call_result_cache]") {
+    CallResultCache cache;
+    cache.apply(100, {}, {});
+    CHECK(cache.find(key(1), 100, EVMC_LONDON) == nullptr);
+
+    SECTION("result found at its block and revision") {
+        const auto result{result_of(0x01)};
+        cache.store(key(1), result, 100, EVMC_LONDON, false, read_set(), cache.generation());
+        CHECK(cache.size() == 1);
+        CHECK(cache.find(key(1), 100, EVMC_LONDON) == result);
+        CHECK(cache.find(key(1), 100, EVMC_SHANGHAI) == nullptr);
+        CHECK(cache.find(key(1), 99, EVMC_LONDON) == nullptr);
+        CHECK(cache.find(key(1), 101, EVMC_LONDON) == nullptr);
+    }
+
+    SECTION("result not stored if some block is applied meanwhile") {
+        const auto generation{cache.generation()};
+        cache.apply(101, {}, {});
+        cache.store(key(1), result_of(0x01), 100, EVMC_LONDON, false, read_set(), generation);
+        CHECK(cache.size() == 0);
+    }
+
+    SECTION("result not stored if computed at another block") {
+        cache.store(key(1), result_of(0x01), 99, EVMC_LONDON, false, read_set(), cache.generation());
+        CHECK(cache.size() == 0);
+    }
+
+    SECTION("result not stored if the read set is too large") {
+        AccessedState large_read_set;
+        for (std::size_t i{0}; i <= CallResultCache::kMaxReadLocations; ++i) {
+            evmc::bytes32 location{};
+            location.bytes[30] = static_cast<uint8_t>(i >> 8);
+            location.bytes[31] = static_cast<uint8_t>(i);
+            large_read_set.locations.emplace_back(kContract, location);
+        }
+        cache.store(key(1), result_of(0x01), 100, EVMC_LONDON, false, large_read_set, cache.generation());
+        CHECK(cache.size() == 0);
+    }
+}
+
+TEST_CASE("CallResultCache::apply", "[silkrpc][common][call_result_cache]") {
+    CallResultCache cache;
+    cache.apply(100, {}, {});
+    const auto result{result_of(0x01)};
+    cache.store(key(1), result, 100, EVMC_LONDON, false, read_set(), cache.generation());
+
+    SECTION("result kept across the blocks not changing its read set") {
+        cache.apply(101, {kOther}, {{kOther, kLocation1}, {kContract, kLocation2}});
+        CHECK(cache.find(key(1), 101, EVMC_LONDON) == result);
+        CHECK(cache.find(key(1), 100, EVMC_LONDON) == result);
+        CHECK(cache.invalidated_count() == 0);
+    }
+
+    SECTION("result dropped when some account read changes") {
+        cache.apply(101, {kSender}, {});
+        CHECK(cache.find(key(1), 101, EVMC_LONDON) == nullptr);
+        CHECK(cache.size() == 0);
+        CHECK(cache.invalidated_count() == 1);
+    }
+
+    SECTION("result dropped when some location read changes") {
+        cache.apply(101, {}, {{kContract, kLocation1}});
+        CHECK(cache.find(key(1), 101, EVMC_LONDON) == nullptr);
+        CHECK(cache.invalidated_count() == 1);
+    }
+
+    SECTION("result reading the block context served just at its block") {
+        cache.store(key(2), result_of(0x02), 100, EVMC_LONDON, true, read_set(), cache.generation());
+        CHECK(cache.find(key(2), 100, EVMC_LONDON));
+        cache.apply(101, {}, {});
+        CHECK(cache.find(key(2), 101, EVMC_LONDON) == nullptr);
+        CHECK(cache.find(key(2), 100, EVMC_LONDON));
+    }
+
+    SECTION("results dropped on unwind") {
+        cache.unwind();
+        CHECK(cache.find(key(1), 100, EVMC_LONDON) == nullptr);
+        CHECK(cache.size() == 0);
+    }
+}
+
+TEST_CASE("CallResultCache evicts the least recently used result", "[silkrpc][common][call_result_cache]") {
+    CallResultCache cache{2};
+    cache.apply(100, {}, {});
+    cache.store(key(1), result_of(0x01), 100, EVMC_LONDON, false, read_set(), cache.generation());
+    cache.store(key(2), result_of(0x02), 100, EVMC_LONDON, false, read_set(), cache.generation());
+    CHECK(cache.find(key(1), 100, EVMC_LONDON));
+    cache.store(key(3), result_of(0x03), 100, EVMC_LONDON, false, read_set(), cache.generation());
+    CHECK(cache.size() == 2);
+    CHECK(cache.find(key(1), 100, EVMC_LONDON));
+    CHECK(cache.find(key(2), 100, EVMC_LONDON) == nullptr);
+    CHECK(cache.find(key(3), 100, EVMC_LONDON));
+
+    // The evicted result is not dropped again by the changes of its read set
+    cache.apply(101, {kSender}, {});
+    CHECK(cache.size() == 0);
+    CHECK(cache.invalidated_count() == 2);
+}
+
+TEST_CASE("CallResultCache::scan_block_context", "[silkrpc][common][call_result_cache]") {
+    CHECK(!CallResultCache::scan_block_context({}));
+    CHECK(!CallResultCache::scan_block_context(silkworm::Bytes{0x60, 0x00, 0x54, 0x60, 0x00, 0x52, 0x60, 0x20, 0x60, 0x00, 0xf3}));
+    CHECK(CallResultCache::scan_block_context(silkworm::Bytes{0x42, 0x60, 0x00, 0x52}));  // TIMESTAMP
+    CHECK(CallResultCache::scan_block_context(silkworm::Bytes{0x60, 0x00, 0x40}));        // BLOCKHASH
+    CHECK(CallResultCache::scan_block_context(silkworm::Bytes{0x48}));                    // BASEFEE
+    CHECK(CallResultCache::scan_block_context(silkworm::Bytes{0x60, 0x00, 0x80, 0xf0}));  // CREATE
+
+    SECTION("skipping the push immediates") {
+        CHECK(!CallResultCache::scan_block_context(silkworm::Bytes{0x61, 0x42, 0x43, 0x00}));
+        CHECK(CallResultCache::scan_block_context(silkworm::Bytes{0x61, 0x42, 0x43, 0x43}));
+        CHECK(!CallResultCache::scan_block_context(silkworm::Bytes{0x7f, 0x42}));  // truncated PUSH32
+    }
+
+    SECTION("memoized by code hash") {
+        CallResultCache cache;
+        CHECK(cache.reads_block_context(kCodeHash, silkworm::Bytes{0x43}));
+        CHECK(cache.reads_block_context(kCodeHash, {}));
+    }
+}
+
+} // namespace silkrpc
@@ -0,0 +1,129 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "canonical_hash_ring.hpp"
+
+#include <mutex>
+
+namespace silkrpc {
+
+CanonicalHashRing::CanonicalHashRing(std::size_t capacity) : entries_(capacity > 0 ? capacity : 1) {}
+
+std::optional<evmc::bytes32> CanonicalHashRing::get_hash(uint64_t view_id, uint64_t block_number) const {
+    std::shared_lock lock{mutex_};
+    if (view_id != view_id_ || !in_range(block_number)) {
+        return std::nullopt;
+    }
+    const auto& entry = entries_[block_number % entries_.size()];
+    if (!entry.valid || entry.block_number != block_number) {
+        return std::nullopt;
+    }
+    return entry.block_hash;
+}
+
+std::optional<uint64_t> CanonicalHashRing::get_number(uint64_t view_id, const evmc::bytes32& block_hash) const {
+    std::shared_lock lock{mutex_};
+    if (view_id != view_id_) {
+        return std::nullopt;
+    }
+    const auto it = numbers_.find(block_hash);
+    if (it == numbers_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void CanonicalHashRing::put(uint64_t view_id, uint64_t block_number, const evmc::bytes32& block_hash) {
+    std::unique_lock lock{mutex_};
+    if (view_id != view_id_ || !in_range(block_number)) {
+        return;
+    }
+    auto& entry = entries_[block_number % entries_.size()];
+    if (entry.valid) {
+        return;
+    }
+    entry = Entry{block_number, block_hash, true};
+    numbers_[block_hash] = block_number;
+}
+
+void CanonicalHashRing::apply(uint64_t view_id, const std::vector<CanonicalChange>& changes) {
+    std::unique_lock lock{mutex_};
+    view_id_ = view_id;
+    for (const auto& change : changes) {
+        if (change.unwind) {
+            unwind_to(change.block_number);
+        } else {
+            extend(change.block_number, change.block_hash);
+        }
+    }
+}
+
+std::optional<uint64_t> CanonicalHashRing::head() const {
+    std::shared_lock lock{mutex_};
+    return head_;
+}
+
+void CanonicalHashRing::clear() {
+    for (auto& entry : entries_) {
+        entry.valid = false;
+    }
+    numbers_.clear();
+    head_.reset();
+}
+
+void CanonicalHashRing::erase(Entry& entry) {
+    if (entry.valid) {
+        numbers_.erase(entry.block_hash);
+        entry.valid = false;
+    }
+}
+
+void CanonicalHashRing::unwind_to(uint64_t block_number) {
+    if (!head_) {
+        return;
+    }
+    if (block_number == 0 || *head_ - block_number >= entries_.size()) {
+        clear();
+        return;
+    }
+    for (auto number = block_number; number <= *head_; ++number) {
+        auto& entry = entries_[number % entries_.size()];
+        if (entry.block_number == number) {
+            erase(entry);
+        }
+    }
+    head_ = block_number - 1;
+}
+
+void CanonicalHashRing::extend(uint64_t block_number, const evmc::bytes32& block_hash) {
+    if (head_ && block_number <= *head_) {
+        unwind_to(block_number);  // implicit reorganization
+    }
+    if (head_ && block_number != *head_ + 1) {
+        clear();  // some changes have been missed
+    }
+    auto& entry = entries_[block_number % entries_.size()];
+    erase(entry);
+    entry = Entry{block_number, block_hash, true};
+    numbers_[block_hash] = block_number;
+    head_ = block_number;
+}
+
+bool CanonicalHashRing::in_range(uint64_t block_number) const {
+    return head_ && block_number <= *head_ && *head_ - block_number < entries_.size();
+}
+
+} // namespace silkrpc
@@ -0,0 +1,90 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_CANONICAL_HASH_RING_HPP_
+#define SILKRPC_COMMON_CANONICAL_HASH_RING_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <evmc/evmc.hpp>
+
+namespace silkrpc {
+
+//! One change of the canonical chain: the block appended at the head or, if unwinding, the block removed from it
+struct CanonicalChange {
+    uint64_t block_number{0};
+    evmc::bytes32 block_hash;
+    bool unwind{false};
+};
+
+//! Fixed-size ring of the canonical (number, hash) pairs of the most recent blocks up to the head, advanced and rewound
+//! by the changes of each new database view, so that both the canonical hash of a recent block number and the number of
+//! a recent block hash are resolved in constant time. Like ChainHeadCache, the ring is coherent just with the view of the
+//! last changes applied: readers of any other view always miss. The changes of each view are applied atomically, so
+//! that readers never see a partially unwound chain.
+class CanonicalHashRing {
+public:
+    //! The default number of the most recent blocks kept
+    static constexpr std::size_t kDefaultCapacity{4096};
+
+    explicit CanonicalHashRing(std::size_t capacity = kDefaultCapacity);
+
+    //! Return the canonical hash of the block number on the specified view, if cached
+    std::optional<evmc::bytes32> get_hash(uint64_t view_id, uint64_t block_number) const;
+
+    //! Return the number of the canonical block hash on the specified view, if cached
+    std::optional<uint64_t> get_number(uint64_t view_id, const evmc::bytes32& block_hash) const;
+
+    //! Store the canonical pair read from the specified view, if it is the current one and the block is within the ring
+    void put(uint64_t view_id, uint64_t block_number, const evmc::bytes32& block_hash);
+
+    //! Apply the canonical changes, in order, committed by the specified view and make it the current one. The ring is
+    //! cleared if the changes are not contiguous with the current head, e.g. because some views have been missed.
+    void apply(uint64_t view_id, const std::vector<CanonicalChange>& changes);
+
+    //! The current head block number, if any
+    std::optional<uint64_t> head() const;
+
+    std::size_t capacity() const noexcept { return entries_.size(); }
+
+private:
+    struct Entry {
+        uint64_t block_number{0};
+        evmc::bytes32 block_hash;
+        bool valid{false};
+    };
+
+    void clear();
+    void erase(Entry& entry);
+    void unwind_to(uint64_t block_number);
+    void extend(uint64_t block_number, const evmc::bytes32& block_hash);
+    bool in_range(uint64_t block_number) const;
+
+    std::vector<Entry> entries_;
+    std::unordered_map<evmc::bytes32, uint64_t> numbers_;
+    std::optional<uint64_t> head_;
+    uint64_t view_id_{0};
+    mutable std::shared_mutex mutex_;
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_CANONICAL_HASH_RING_HPP_
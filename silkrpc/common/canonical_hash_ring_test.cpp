@@ -0,0 +1,128 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "canonical_hash_ring.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+static evmc::bytes32 hash_of(uint64_t block_number, uint8_t fork = 0) {
+    evmc::bytes32 block_hash{};
+    block_hash.bytes[0] = fork;
+    for (std::size_t i{0}; i < sizeof(block_number); ++i) {
+        block_hash.bytes[31 - i] = static_cast<uint8_t>(block_number >> (8 * i));
+    }
+    return block_hash;
+}
+
+static std::vector<CanonicalChange> forward(uint64_t from_block, uint64_t to_block, uint8_t fork = 0) {
+    std::vector<CanonicalChange> changes;
+    for (auto block_number = from_block; block_number <= to_block; ++block_number) {
+        changes.push_back(CanonicalChange{block_number, hash_of(block_number, fork), false});
+    }
+    return changes;
+}
+
+TEST_CASE("canonical hash ring empty", "[silkrpc][common][canonical_hash_ring]") {
+    CanonicalHashRing ring{8};
+    CHECK(ring.capacity() == 8);
+    CHECK(!ring.head());
+    CHECK(!ring.get_hash(0, 0));
+    CHECK(!ring.get_number(0, hash_of(0)));
+    ring.put(0, 0, hash_of(0));
+    CHECK(!ring.get_hash(0, 0));
+}
+
+TEST_CASE("canonical hash ring forward changes", "[silkrpc][common][canonical_hash_ring]") {
+    CanonicalHashRing ring{8};
+    ring.apply(1, forward(100, 104));
+    CHECK(ring.head() == 104);
+    CHECK(ring.get_hash(1, 100) == hash_of(100));
+    CHECK(ring.get_hash(1, 104) == hash_of(104));
+    CHECK(ring.get_number(1, hash_of(102)) == 102);
+    CHECK(!ring.get_hash(1, 99));
+    CHECK(!ring.get_hash(1, 105));
+
+    SECTION("other views miss") {
+        CHECK(!ring.get_hash(0, 100));
+        CHECK(!ring.get_hash(2, 100));
+        CHECK(!ring.get_number(2, hash_of(100)));
+    }
+
+    SECTION("oldest blocks evicted") {
+        ring.apply(2, forward(105, 110));
+        CHECK(ring.head() == 110);
+        CHECK(!ring.get_hash(2, 100));
+        CHECK(!ring.get_number(2, hash_of(102)));
+        CHECK(ring.get_hash(2, 103) == hash_of(103));
+        CHECK(ring.get_hash(2, 110) == hash_of(110));
+    }
+
+    SECTION("missed changes clear") {
+        ring.apply(2, forward(106, 107));
+        CHECK(ring.head() == 107);
+        CHECK(!ring.get_hash(2, 104));
+        CHECK(ring.get_hash(2, 107) == hash_of(107));
+    }
+
+    SECTION("lazy fill within range") {
+        ring.apply(2, forward(110, 110));
+        CHECK(!ring.get_hash(2, 105));
+        ring.put(1, 105, hash_of(105));
+        CHECK(!ring.get_hash(2, 105));
+        ring.put(2, 105, hash_of(105));
+        ring.put(2, 99, hash_of(99));
+        CHECK(ring.get_hash(2, 105) == hash_of(105));
+        CHECK(ring.get_number(2, hash_of(105)) == 105);
+        CHECK(!ring.get_hash(2, 99));
+    }
+}
+
+TEST_CASE("canonical hash ring unwind changes", "[silkrpc][common][canonical_hash_ring]") {
+    CanonicalHashRing ring{8};
+    ring.apply(1, forward(100, 104));
+
+    SECTION("unwind and forward") {
+        auto changes = std::vector<CanonicalChange>{{104, hash_of(104), true}, {103, hash_of(103), true}};
+        const auto new_fork = forward(103, 105, 1);
+        changes.insert(changes.end(), new_fork.begin(), new_fork.end());
+        ring.apply(2, changes);
+        CHECK(ring.head() == 105);
+        CHECK(ring.get_hash(2, 102) == hash_of(102));
+        CHECK(ring.get_hash(2, 103) == hash_of(103, 1));
+        CHECK(ring.get_hash(2, 105) == hash_of(105, 1));
+        CHECK(!ring.get_number(2, hash_of(104)));
+        CHECK(ring.get_number(2, hash_of(104, 1)) == 104);
+    }
+
+    SECTION("implicit unwind") {
+        ring.apply(2, forward(102, 102, 1));
+        CHECK(ring.head() == 102);
+        CHECK(ring.get_hash(2, 101) == hash_of(101));
+        CHECK(ring.get_hash(2, 102) == hash_of(102, 1));
+        CHECK(!ring.get_hash(2, 103));
+        CHECK(!ring.get_number(2, hash_of(103)));
+    }
+
+    SECTION("unwind beyond range") {
+        ring.apply(2, {{90, hash_of(90), true}});
+        CHECK(!ring.head());
+        CHECK(!ring.get_hash(2, 100));
+    }
+}
+
+} // namespace silkrpc
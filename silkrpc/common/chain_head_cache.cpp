@@ -0,0 +1,65 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "chain_head_cache.hpp"
+
+#include <utility>
+
+namespace silkrpc {
+
+template <typename Update>
+void ChainHeadCache::update(uint64_t view_id, Update update) {
+    auto current = snapshot();
+    while (true) {
+        if (current && current->view_id > view_id) {
+            return;
+        }
+        auto updated = current && current->view_id == view_id ? std::make_shared<ChainHeadSnapshot>(*current) : std::make_shared<ChainHeadSnapshot>();
+        updated->view_id = view_id;
+        update(*updated);
+        std::shared_ptr<const ChainHeadSnapshot> desired{std::move(updated)};
+        if (snapshot_.compare_exchange_weak(current, desired, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return;
+        }
+    }
+}
+
+std::optional<uint64_t> ChainHeadCache::get(uint64_t view_id, ChainHeadTag tag) const {
+    const auto current = snapshot();
+    if (!current || current->view_id != view_id) {
+        return std::nullopt;
+    }
+    return current->block_numbers[static_cast<std::size_t>(tag)];
+}
+
+void ChainHeadCache::put(uint64_t view_id, ChainHeadTag tag, uint64_t block_number) {
+    update(view_id, [&](ChainHeadSnapshot& snapshot) { snapshot.block_numbers[static_cast<std::size_t>(tag)] = block_number; });
+}
+
+std::shared_ptr<const ParsedChainConfig> ChainHeadCache::get_chain_config(uint64_t view_id) const {
+    const auto current = snapshot();
+    if (!current || current->view_id != view_id) {
+        return nullptr;
+    }
+    return current->chain_config;
+}
+
+void ChainHeadCache::put_chain_config(uint64_t view_id, std::shared_ptr<const ParsedChainConfig> chain_config) {
+    latest_chain_config_.store(chain_config, std::memory_order_release);
+    update(view_id, [&](ChainHeadSnapshot& snapshot) { snapshot.chain_config = chain_config; });
+}
+
+} // namespace silkrpc
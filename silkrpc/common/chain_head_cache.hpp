@@ -0,0 +1,100 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_CHAIN_HEAD_CACHE_HPP_
+#define SILKRPC_COMMON_CHAIN_HEAD_CACHE_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include <silkrpc/common/canonical_hash_ring.hpp>
+
+namespace silkrpc {
+
+struct ParsedChainConfig;
+
+//! The block tags whose number is read from the stage progress or the forkchoice tables
+enum class ChainHeadTag : std::size_t {
+    kLatest,
+    kLatestExecuted,
+    kCurrent,
+    kHighest,
+    kSafe,
+    kFinalized,
+};
+
+constexpr std::size_t kNumChainHeadTags{6};
+
+//! The block numbers of the tags read so far from one database view
+struct ChainHeadSnapshot {
+    uint64_t view_id{0};
+    std::array<std::optional<uint64_t>, kNumChainHeadTags> block_numbers;
+
+    //! The chain config read from the view, if any
+    std::shared_ptr<const ParsedChainConfig> chain_config;
+};
+
+//! Cache of the block numbers of the chain head tags (latest, executed, safe, finalized...) on the latest database view,
+//! so that the requests referring to these tags skip reading the stage progress and forkchoice tables. Such tables
+//! change just by committing a new view, so each number depends only on the view it is read from: the cache is coherent
+//! as long as it is looked up with the view of the reading transaction. The snapshot is swapped atomically, so readers
+//! on any thread never block. The canonical hashes of the most recent blocks are kept along with the tags, coherent
+//! in the same way (see CanonicalHashRing). The chain config is kept as well, so that it is read once per view, and the
+//! latest one read is kept across the views, so that it is parsed again only if its stored data changes.
+class ChainHeadCache {
+public:
+    explicit ChainHeadCache(std::size_t num_canonical_hashes = CanonicalHashRing::kDefaultCapacity)
+    : canonical_hashes_{num_canonical_hashes} {}
+
+    //! Return the block number of the tag on the specified view, if cached
+    std::optional<uint64_t> get(uint64_t view_id, ChainHeadTag tag) const;
+
+    //! Store the block number of the tag read from the specified view, dropping the snapshot of any older view (the
+    //! numbers read from views older than the snapshot are ignored instead)
+    void put(uint64_t view_id, ChainHeadTag tag, uint64_t block_number);
+
+    //! Return the chain config on the specified view, if cached
+    std::shared_ptr<const ParsedChainConfig> get_chain_config(uint64_t view_id) const;
+
+    //! Store the chain config read from the specified view, like put, making it the latest one
+    void put_chain_config(uint64_t view_id, std::shared_ptr<const ParsedChainConfig> chain_config);
+
+    //! Return the latest chain config read from any view, if any, to be checked against the stored data before use
+    std::shared_ptr<const ParsedChainConfig> latest_chain_config() const { return latest_chain_config_.load(std::memory_order_acquire); }
+
+    //! Return the current snapshot, if any
+    std::shared_ptr<const ChainHeadSnapshot> snapshot() const { return snapshot_.load(std::memory_order_acquire); }
+
+    //! The canonical hashes of the most recent blocks
+    CanonicalHashRing& canonical_hashes() noexcept { return canonical_hashes_; }
+
+private:
+    //! Apply the update to a copy of the snapshot of the specified view (or to an empty one for a newer view) and swap it
+    template <typename Update>
+    void update(uint64_t view_id, Update update);
+
+    std::atomic<std::shared_ptr<const ChainHeadSnapshot>> snapshot_;
+    std::atomic<std::shared_ptr<const ParsedChainConfig>> latest_chain_config_;
+    CanonicalHashRing canonical_hashes_;
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_CHAIN_HEAD_CACHE_HPP_
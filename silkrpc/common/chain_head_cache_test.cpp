@@ -0,0 +1,83 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "chain_head_cache.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <silkrpc/types/chain_config.hpp>
+
+namespace silkrpc {
+
+TEST_CASE("chain head cache empty", "[silkrpc][common][chain_head_cache]") {
+    ChainHeadCache cache;
+    CHECK(cache.snapshot() == nullptr);
+    CHECK(!cache.get(0, ChainHeadTag::kLatest));
+    CHECK(!cache.get(10, ChainHeadTag::kFinalized));
+}
+
+TEST_CASE("chain head cache same view", "[silkrpc][common][chain_head_cache]") {
+    ChainHeadCache cache;
+    cache.put(10, ChainHeadTag::kLatest, 1000);
+    cache.put(10, ChainHeadTag::kFinalized, 936);
+    CHECK(cache.get(10, ChainHeadTag::kLatest) == 1000);
+    CHECK(cache.get(10, ChainHeadTag::kFinalized) == 936);
+    CHECK(!cache.get(10, ChainHeadTag::kSafe));
+    CHECK(!cache.get(9, ChainHeadTag::kLatest));
+    CHECK(!cache.get(11, ChainHeadTag::kLatest));
+}
+
+TEST_CASE("chain head cache new view", "[silkrpc][common][chain_head_cache]") {
+    ChainHeadCache cache;
+    cache.put(10, ChainHeadTag::kLatest, 1000);
+    cache.put(10, ChainHeadTag::kSafe, 968);
+    cache.put(11, ChainHeadTag::kLatest, 1001);
+    CHECK(cache.snapshot()->view_id == 11);
+    CHECK(cache.get(11, ChainHeadTag::kLatest) == 1001);
+    CHECK(!cache.get(11, ChainHeadTag::kSafe));
+    CHECK(!cache.get(10, ChainHeadTag::kLatest));
+}
+
+TEST_CASE("chain head cache old view", "[silkrpc][common][chain_head_cache]") {
+    ChainHeadCache cache;
+    cache.put(11, ChainHeadTag::kLatest, 1001);
+    cache.put(10, ChainHeadTag::kLatest, 1000);
+    cache.put(10, ChainHeadTag::kCurrent, 1000);
+    CHECK(cache.snapshot()->view_id == 11);
+    CHECK(cache.get(11, ChainHeadTag::kLatest) == 1001);
+    CHECK(!cache.get(11, ChainHeadTag::kCurrent));
+    CHECK(!cache.get(10, ChainHeadTag::kLatest));
+}
+
+TEST_CASE("chain head cache chain config", "[silkrpc][common][chain_head_cache]") {
+    ChainHeadCache cache;
+    CHECK(cache.get_chain_config(10) == nullptr);
+    CHECK(cache.latest_chain_config() == nullptr);
+    const auto chain_config = std::make_shared<ParsedChainConfig>(ChainConfig{evmc::bytes32{}, nlohmann::json{{"chainId", 5}}});
+    cache.put(10, ChainHeadTag::kLatest, 1000);
+    cache.put_chain_config(10, chain_config);
+    CHECK(cache.get_chain_config(10) == chain_config);
+    CHECK(cache.get(10, ChainHeadTag::kLatest) == 1000);
+    CHECK(cache.get_chain_config(9) == nullptr);
+
+    // Read again once per view, while the latest one is kept
+    cache.put(11, ChainHeadTag::kLatest, 1001);
+    CHECK(cache.get_chain_config(11) == nullptr);
+    CHECK(cache.get_chain_config(10) == nullptr);
+    CHECK(cache.latest_chain_config() == chain_config);
+}
+
+} // namespace silkrpc
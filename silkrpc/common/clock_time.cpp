@@ -16,6 +16,8 @@
 
 #include "clock_time.hpp"
 
+#include <time.h>
+
 namespace silkrpc::clock_time {
 
 uint64_t now() {
@@ -26,4 +28,10 @@ uint64_t since(uint64_t start) {
     return now() - start;
 }
 
+uint64_t thread_cpu_now() {
+    timespec ts{};
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<uint64_t>(ts.tv_nsec);
+}
+
 } // namespace silkrpc::clock_time
@@ -25,6 +25,9 @@ namespace silkrpc::clock_time {
 uint64_t now();
 uint64_t since(uint64_t start);
 
+//! The CPU time consumed by the calling thread in nanoseconds, i.e. CLOCK_THREAD_CPUTIME_ID
+uint64_t thread_cpu_now();
+
 } // namespace silkrpc::clock_time
 
 #endif  // SILKRPC_COMMON_CLOCK_TIME_HPP_
@@ -42,4 +42,17 @@ TEST_CASE("check elapsed time", "[silkrpc][common][clock_time]") {
     CHECK(elapsed <= window);
 }
 
+TEST_CASE("check thread CPU time", "[silkrpc][common][clock_time]") {
+    const auto start{clock_time::now()};
+    const auto cpu_start{thread_cpu_now()};
+    volatile uint64_t sum{0};
+    for (uint64_t i{0}; i < 10'000'000; ++i) {
+        sum = sum + i;
+    }
+    const auto cpu{thread_cpu_now() - cpu_start};
+    const auto elapsed{clock_time::since(start)};
+    CHECK(cpu > 0);
+    CHECK(cpu <= elapsed);
+}
+
 } // namespace silkrpc::clock_time
@@ -0,0 +1,50 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_CODE_CACHE_HPP_
+#define SILKRPC_COMMON_CODE_CACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <silkworm/common/base.hpp>
+
+#include <silkrpc/common/sharded_cache.hpp>
+
+namespace silkrpc {
+
+//! Cache of the contract bytecode by code hash shared by all the executions, bounded by the approximate memory footprint
+//! (see ShardedCache). The code is immutable for a given hash whatever the block, so the cache is never invalidated, and
+//! the few contracts called over and over again (routers, tokens) are kept by frequency rather than recency, so that
+//! a burst of calls to many cold contracts does not flush them.
+class CodeCache : public ShardedCache<silkworm::Bytes> {
+public:
+    //! The default memory budget in bytes
+    static constexpr std::size_t kDefaultMaxBytes{64 * 1024 * 1024};
+
+    //! The hits counted for each code, i.e. the number of sweeps a code hit often survives
+    static constexpr uint8_t kMaxFrequency{8};
+
+    explicit CodeCache(std::size_t max_bytes = kDefaultMaxBytes, bool shared_cache = true, std::size_t num_shards = kDefaultNumShards)
+    : ShardedCache{&CodeCache::approximate_size, max_bytes, shared_cache, num_shards, kMaxFrequency} {}
+
+    //! Return the approximate memory footprint of the code, including the bookkeeping of its cache entry
+    static std::size_t approximate_size(const silkworm::Bytes& code);
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_CODE_CACHE_HPP_
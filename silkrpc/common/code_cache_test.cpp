@@ -0,0 +1,77 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "code_cache.hpp"
+
+#include <memory>
+
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+
+namespace silkrpc {
+
+using evmc::literals::operator""_bytes32;
+
+static const evmc::bytes32 kHotHash{0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+
+static evmc::bytes32 cold_hash(uint8_t i) {
+    evmc::bytes32 hash{};
+    hash.bytes[0] = i;
+    hash.bytes[31] = 1;
+    return hash;
+}
+
+TEST_CASE("CodeCache::get", "[silkrpc][common][code_cache]") {
+    CodeCache code_cache;
+    CHECK(code_cache.get(kHotHash) == nullptr);
+
+    const auto code = std::make_shared<silkworm::Bytes>(silkworm::Bytes{0x60, 0x00});
+    code_cache.insert(kHotHash, code);
+    CHECK(code_cache.get(kHotHash) == code);
+    CHECK(code_cache.size() == 1);
+    CHECK(code_cache.size_bytes() == CodeCache::approximate_size(*code));
+}
+
+TEST_CASE("CodeCache keeps the code hit often", "[silkrpc][common][code_cache]") {
+    const silkworm::Bytes code(1000, 0x5b);
+    const auto code_size{CodeCache::approximate_size(code)};
+    CodeCache code_cache{2 * code_size, true, 1};
+
+    code_cache.insert(kHotHash, std::make_shared<silkworm::Bytes>(code));
+    for (uint8_t i{0}; i < CodeCache::kMaxFrequency; ++i) {
+        CHECK(code_cache.get(kHotHash));
+    }
+
+    SECTION("across more sweeps than a hit") {
+        // Each insertion past the budget sweeps the hot code once, evicting the cold one inserted before
+        for (uint8_t i{0}; i < CodeCache::kMaxFrequency; ++i) {
+            code_cache.insert(cold_hash(i), std::make_shared<silkworm::Bytes>(code));
+        }
+        CHECK(code_cache.get(cold_hash(CodeCache::kMaxFrequency - 1)));
+        CHECK(code_cache.get(kHotHash));
+        CHECK(code_cache.size() == 2);
+    }
+
+    SECTION("until not hit anymore") {
+        for (uint8_t i{0}; i <= CodeCache::kMaxFrequency + 1; ++i) {
+            code_cache.insert(cold_hash(i), std::make_shared<silkworm::Bytes>(code));
+        }
+        CHECK(code_cache.get(kHotHash) == nullptr);
+        CHECK(code_cache.size() == 2);
+    }
+}
+
+} // namespace silkrpc
@@ -0,0 +1,67 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "code_hotness.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+
+namespace silkrpc {
+
+CodeHotness::CodeHotness(uint16_t threshold, std::size_t num_counters)
+    : threshold_{std::max<uint16_t>(threshold, 1)}, mask_{std::bit_ceil(std::max<std::size_t>(num_counters, 1)) - 1},
+      aging_period_{(mask_ + 1) * kAgingCallsPerCounter}, counters_{std::make_unique<std::atomic<uint16_t>[]>(mask_ + 1)} {}
+
+bool CodeHotness::record(const evmc::bytes32& code_hash) {
+    auto& counter{counter_of(code_hash)};
+    uint16_t count{counter.load(std::memory_order_relaxed)};
+    while (count < std::numeric_limits<uint16_t>::max() &&
+           !counter.compare_exchange_weak(count, static_cast<uint16_t>(count + 1), std::memory_order_relaxed)) {
+    }
+    if ((num_records_.fetch_add(1, std::memory_order_relaxed) + 1) % aging_period_ == 0) {
+        age();
+    }
+    return count + 1 >= threshold_;
+}
+
+bool CodeHotness::is_hot(const evmc::bytes32& code_hash) const {
+    return count(code_hash) >= threshold_;
+}
+
+uint16_t CodeHotness::count(const evmc::bytes32& code_hash) const {
+    return counter_of(code_hash).load(std::memory_order_relaxed);
+}
+
+std::atomic<uint16_t>& CodeHotness::counter_of(const evmc::bytes32& code_hash) const {
+    // The code hash is a Keccak hash, so any of its words is uniformly distributed
+    uint64_t word{0};
+    std::memcpy(&word, code_hash.bytes, sizeof(word));
+    return counters_[word & mask_];
+}
+
+void CodeHotness::age() {
+    // Racing with the concurrent increments may lose some of them, which is fine for an approximate count
+    for (std::size_t i{0}; i <= mask_; ++i) {
+        const auto count{counters_[i].load(std::memory_order_relaxed)};
+        if (count != 0) {
+            counters_[i].store(static_cast<uint16_t>(count / 2), std::memory_order_relaxed);
+        }
+    }
+}
+
+} // namespace silkrpc
@@ -0,0 +1,78 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_CODE_HOTNESS_HPP_
+#define SILKRPC_COMMON_CODE_HOTNESS_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <evmc/evmc.hpp>
+
+namespace silkrpc {
+
+//! Approximate count of the recent calls to each contract code by code hash shared by all the executions, telling the
+//! hot code worth analysing once for the advanced interpreter from the cold code better run on the baseline one.
+//! The counts are kept in a fixed table of saturating counters indexed by code hash, so that any number of contracts
+//! fits in bounded memory without locking: colliding hashes share their count, which can only promote some code early.
+//! All the counts are halved periodically, so that code not called anymore cools down.
+class CodeHotness {
+public:
+    //! The default number of calls making the code hot
+    static constexpr uint16_t kDefaultThreshold{16};
+
+    //! The default number of counters, rounded up to a power of two
+    static constexpr std::size_t kDefaultNumCounters{64 * 1024};
+
+    //! The number of calls recorded between two halvings for each counter
+    static constexpr uint64_t kAgingCallsPerCounter{8};
+
+    explicit CodeHotness(uint16_t threshold = kDefaultThreshold, std::size_t num_counters = kDefaultNumCounters);
+
+    CodeHotness(const CodeHotness&) = delete;
+    CodeHotness& operator=(const CodeHotness&) = delete;
+
+    //! Record one call to the code, returning true if hot including such call
+    bool record(const evmc::bytes32& code_hash);
+
+    //! Return true if the code has been called at least threshold times recently
+    bool is_hot(const evmc::bytes32& code_hash) const;
+
+    //! Return the approximate number of recent calls to the code
+    uint16_t count(const evmc::bytes32& code_hash) const;
+
+    uint16_t threshold() const noexcept { return threshold_; }
+
+    std::size_t num_counters() const noexcept { return mask_ + 1; }
+
+private:
+    std::atomic<uint16_t>& counter_of(const evmc::bytes32& code_hash) const;
+
+    //! Halve all the counters
+    void age();
+
+    uint16_t threshold_;
+    std::size_t mask_;
+    uint64_t aging_period_;
+    std::unique_ptr<std::atomic<uint16_t>[]> counters_;
+    std::atomic<uint64_t> num_records_{0};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_CODE_HOTNESS_HPP_
@@ -0,0 +1,61 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "code_hotness.hpp"
+
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+
+namespace silkrpc {
+
+using evmc::literals::operator""_bytes32;
+
+static const evmc::bytes32 kHotHash{0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+static const evmc::bytes32 kColdHash{0x9a2f0e7c1b8a0f3e4d5c6b7a8f9e0d1c2b3a4f5e6d7c8b9a0f1e2d3c4b5a6978_bytes32};
+
+TEST_CASE("CodeHotness::record", "[silkrpc][common][code_hotness]") {
+    CodeHotness hotness{4};
+    CHECK_FALSE(hotness.is_hot(kHotHash));
+
+    CHECK_FALSE(hotness.record(kHotHash));
+    CHECK_FALSE(hotness.record(kHotHash));
+    CHECK_FALSE(hotness.record(kHotHash));
+    CHECK(hotness.record(kHotHash));
+    CHECK(hotness.is_hot(kHotHash));
+    CHECK(hotness.count(kHotHash) == 4);
+
+    CHECK_FALSE(hotness.is_hot(kColdHash));
+    CHECK(hotness.count(kColdHash) == 0);
+}
+
+TEST_CASE("CodeHotness rounds the counters up to a power of two", "[silkrpc][common][code_hotness]") {
+    CHECK(CodeHotness{1, 1000}.num_counters() == 1024);
+    CHECK(CodeHotness{1, 0}.num_counters() == 1);
+    CHECK(CodeHotness{0}.threshold() == 1);
+}
+
+TEST_CASE("CodeHotness cools down the code not called anymore", "[silkrpc][common][code_hotness]") {
+    // A single counter shared by any code, halved every kAgingCallsPerCounter calls
+    CodeHotness hotness{4, 1};
+    for (uint64_t i{0}; i < CodeHotness::kAgingCallsPerCounter - 1; ++i) {
+        hotness.record(kHotHash);
+    }
+    CHECK(hotness.count(kHotHash) == CodeHotness::kAgingCallsPerCounter - 1);
+    hotness.record(kColdHash);
+    CHECK(hotness.count(kHotHash) == CodeHotness::kAgingCallsPerCounter / 2);
+}
+
+} // namespace silkrpc
@@ -0,0 +1,123 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "compact_block.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include <silkworm/rlp/decode.hpp>
+#include <silkworm/rlp/encode.hpp>
+
+namespace silkrpc {
+
+CompactBlock::CompactBlock(const silkworm::BlockWithHash& block_with_hash, std::size_t compression_threshold)
+: hash_{block_with_hash.hash}, header_{block_with_hash.block.header} {
+    const auto& block = block_with_hash.block;
+    silkworm::Bytes encoded;
+    offsets_.reserve(block.transactions.size() + block.ommers.size() + 1);
+    senders_.reserve(block.transactions.size());
+    for (const auto& transaction : block.transactions) {
+        offsets_.push_back(static_cast<uint32_t>(encoded.size()));
+        silkworm::rlp::encode(encoded, transaction, /*for_signing=*/false, /*wrap_eip2718_into_string=*/false);
+        senders_.push_back(transaction.from);
+    }
+    for (const auto& ommer : block.ommers) {
+        offsets_.push_back(static_cast<uint32_t>(encoded.size()));
+        silkworm::rlp::encode(encoded, ommer);
+    }
+    offsets_.push_back(static_cast<uint32_t>(encoded.size()));
+    encoded_ = CompressedBytes{encoded, compression_threshold};
+}
+
+silkworm::ByteView CompactBlock::item(silkworm::ByteView encoded, std::size_t position) const {
+    return encoded.substr(offsets_[position], offsets_[position + 1] - offsets_[position]);
+}
+
+silkworm::ByteView CompactBlock::transaction_rlp(std::size_t index) const {
+    if (index >= transaction_count()) {
+        throw std::out_of_range{"transaction index " + std::to_string(index) + " out of range in compact block"};
+    }
+    if (encoded_.compressed()) {
+        throw std::logic_error{"transaction encoding not available in compressed compact block"};
+    }
+    return item(encoded_.stored(), index);
+}
+
+silkworm::Transaction CompactBlock::transaction(std::size_t index) const {
+    if (index >= transaction_count()) {
+        throw std::out_of_range{"transaction index " + std::to_string(index) + " out of range in compact block"};
+    }
+    if (encoded_.compressed()) {
+        return decode_transaction(encoded_.bytes(), index);
+    }
+    return decode_transaction(encoded_.stored(), index);
+}
+
+silkworm::BlockHeader CompactBlock::ommer(std::size_t index) const {
+    if (index >= ommer_count()) {
+        throw std::out_of_range{"ommer index " + std::to_string(index) + " out of range in compact block"};
+    }
+    if (encoded_.compressed()) {
+        return decode_ommer(encoded_.bytes(), index);
+    }
+    return decode_ommer(encoded_.stored(), index);
+}
+
+silkworm::BlockWithHash CompactBlock::decode() const {
+    // Decompress once for all the transactions and ommers
+    const auto decompressed = encoded_.compressed() ? encoded_.bytes() : silkworm::Bytes{};
+    const auto encoded = encoded_.compressed() ? silkworm::ByteView{decompressed} : encoded_.stored();
+
+    silkworm::BlockWithHash block_with_hash;
+    block_with_hash.hash = hash_;
+    block_with_hash.block.header = header_;
+    block_with_hash.block.transactions.reserve(transaction_count());
+    for (std::size_t i{0}; i < transaction_count(); ++i) {
+        block_with_hash.block.transactions.push_back(decode_transaction(encoded, i));
+    }
+    block_with_hash.block.ommers.reserve(ommer_count());
+    for (std::size_t i{0}; i < ommer_count(); ++i) {
+        block_with_hash.block.ommers.push_back(decode_ommer(encoded, i));
+    }
+    return block_with_hash;
+}
+
+silkworm::Transaction CompactBlock::decode_transaction(silkworm::ByteView encoded, std::size_t index) const {
+    auto encoded_transaction = item(encoded, index);
+    silkworm::Transaction transaction{};
+    if (silkworm::rlp::decode(encoded_transaction, transaction) != silkworm::DecodingResult::kOk) {
+        throw std::runtime_error{"invalid RLP decoding for transaction in compact block"};
+    }
+    transaction.from = senders_[index];
+    return transaction;
+}
+
+silkworm::BlockHeader CompactBlock::decode_ommer(silkworm::ByteView encoded, std::size_t index) const {
+    auto encoded_ommer = item(encoded, transaction_count() + index);
+    silkworm::BlockHeader ommer{};
+    if (silkworm::rlp::decode(encoded_ommer, ommer) != silkworm::DecodingResult::kOk) {
+        throw std::runtime_error{"invalid RLP decoding for ommer in compact block"};
+    }
+    return ommer;
+}
+
+std::size_t CompactBlock::size_bytes() const noexcept {
+    return sizeof(CompactBlock) + header_.extra_data.size() + encoded_.stored_size() + offsets_.capacity() * sizeof(uint32_t) +
+        senders_.capacity() * sizeof(std::optional<evmc::address>);
+}
+
+} // namespace silkrpc
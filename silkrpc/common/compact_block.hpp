@@ -0,0 +1,96 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_COMPACT_BLOCK_HPP_
+#define SILKRPC_COMMON_COMPACT_BLOCK_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <evmc/evmc.hpp>
+#include <silkworm/common/base.hpp>
+#include <silkworm/types/block.hpp>
+#include <silkworm/types/transaction.hpp>
+
+#include <silkrpc/common/compressed_bytes.hpp>
+
+namespace silkrpc {
+
+//! Compact form of a cached block: the header stays decoded, because almost any access reads it, whilst the transactions
+//! and the ommers are kept RLP-encoded back to back in one buffer along with the table of their offsets. A block then
+//! costs about its encoded size instead of the many small allocations of the decoded transactions, and each transaction
+//! is decoded only when accessed. The senders already recovered are kept aside, because the encoding does not have them.
+//! The encoded transactions and ommers can also be compressed when big enough (see CompressedBytes), in which case each
+//! access decompresses them: such blocks are meant to be decoded whole.
+class CompactBlock {
+public:
+    //! Build the compact form of the block, compressing its encoded parts if at least threshold bytes (0 means never)
+    explicit CompactBlock(const silkworm::BlockWithHash& block_with_hash, std::size_t compression_threshold = 0);
+
+    const evmc::bytes32& hash() const noexcept { return hash_; }
+
+    const silkworm::BlockHeader& header() const noexcept { return header_; }
+
+    std::size_t transaction_count() const noexcept { return senders_.size(); }
+
+    std::size_t ommer_count() const noexcept { return offsets_.size() - 1 - senders_.size(); }
+
+    //! Return true if the encoded transactions and ommers are kept compressed
+    bool compressed() const noexcept { return encoded_.compressed(); }
+
+    //! Return the canonical encoding of the transaction at the specified index, i.e. the bytes hashed into its hash
+    //! \throws std::logic_error if the block is compressed
+    silkworm::ByteView transaction_rlp(std::size_t index) const;
+
+    //! Decode the transaction at the specified index, along with its sender if recovered
+    //! \throws std::runtime_error if the encoding is invalid
+    silkworm::Transaction transaction(std::size_t index) const;
+
+    //! Decode the ommer at the specified index
+    //! \throws std::runtime_error if the encoding is invalid
+    silkworm::BlockHeader ommer(std::size_t index) const;
+
+    //! Decode the whole block
+    //! \throws std::runtime_error if the encoding is invalid
+    silkworm::BlockWithHash decode() const;
+
+    //! Return the approximate memory footprint of the compact block, including its variable-length parts
+    std::size_t size_bytes() const noexcept;
+
+private:
+    silkworm::ByteView item(silkworm::ByteView encoded, std::size_t position) const;
+
+    silkworm::Transaction decode_transaction(silkworm::ByteView encoded, std::size_t index) const;
+    silkworm::BlockHeader decode_ommer(silkworm::ByteView encoded, std::size_t index) const;
+
+    evmc::bytes32 hash_;
+    silkworm::BlockHeader header_;
+
+    //! The encoded transactions followed by the encoded ommers, possibly compressed
+    CompressedBytes encoded_;
+
+    //! The offsets of the transactions and then of the ommers within the encoded bytes, followed by their total size
+    std::vector<uint32_t> offsets_;
+
+    //! The senders of the transactions, if recovered
+    std::vector<std::optional<evmc::address>> senders_;
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_COMPACT_BLOCK_HPP_
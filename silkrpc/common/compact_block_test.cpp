@@ -0,0 +1,125 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "compact_block.hpp"
+
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+using evmc::literals::operator""_address, evmc::literals::operator""_bytes32;
+
+static silkworm::BlockWithHash make_block(std::size_t num_transactions, std::size_t num_ommers) {
+    silkworm::BlockWithHash block_with_hash;
+    block_with_hash.hash = 0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32;
+    block_with_hash.block.header.number = 5;
+    block_with_hash.block.header.extra_data = silkworm::Bytes(32, 0xaa);
+    block_with_hash.block.transactions.resize(num_transactions);
+    for (std::size_t i{0}; i < num_transactions; ++i) {
+        block_with_hash.block.transactions[i].data = silkworm::Bytes(i + 1, static_cast<uint8_t>(i));
+    }
+    block_with_hash.block.ommers.resize(num_ommers);
+    for (std::size_t i{0}; i < num_ommers; ++i) {
+        block_with_hash.block.ommers[i].number = 4 - i;
+    }
+    return block_with_hash;
+}
+
+TEST_CASE("compact block of empty block", "[silkrpc][common][compact_block]") {
+    const CompactBlock compact_block{make_block(0, 0)};
+    CHECK(compact_block.hash() == 0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32);
+    CHECK(compact_block.header().number == 5);
+    CHECK(compact_block.transaction_count() == 0);
+    CHECK(compact_block.ommer_count() == 0);
+
+    const auto decoded = compact_block.decode();
+    CHECK(decoded.hash == compact_block.hash());
+    CHECK(decoded.block.transactions.empty());
+    CHECK(decoded.block.ommers.empty());
+}
+
+TEST_CASE("compact block decodes transactions one by one", "[silkrpc][common][compact_block]") {
+    auto block_with_hash = make_block(3, 2);
+    block_with_hash.block.transactions[1].from = 0x0715a7794a1dc8e42615f059dd6e406a6594651a_address;
+    const CompactBlock compact_block{block_with_hash};
+    REQUIRE(compact_block.transaction_count() == 3);
+    REQUIRE(compact_block.ommer_count() == 2);
+
+    for (std::size_t i{0}; i < 3; ++i) {
+        const auto transaction = compact_block.transaction(i);
+        CHECK(transaction.data == block_with_hash.block.transactions[i].data);
+        CHECK(transaction.from == block_with_hash.block.transactions[i].from);
+        CHECK(!compact_block.transaction_rlp(i).empty());
+    }
+    CHECK(compact_block.ommer(0).number == 4);
+    CHECK(compact_block.ommer(1).number == 3);
+    CHECK_THROWS_AS(compact_block.transaction(3), std::out_of_range);
+    CHECK_THROWS_AS(compact_block.ommer(2), std::out_of_range);
+}
+
+TEST_CASE("compact block decodes whole block", "[silkrpc][common][compact_block]") {
+    const auto block_with_hash = make_block(4, 1);
+    const auto decoded = CompactBlock{block_with_hash}.decode();
+    CHECK(decoded.hash == block_with_hash.hash);
+    CHECK(decoded.block.header.extra_data == block_with_hash.block.header.extra_data);
+    REQUIRE(decoded.block.transactions.size() == 4);
+    for (std::size_t i{0}; i < 4; ++i) {
+        CHECK(decoded.block.transactions[i].data == block_with_hash.block.transactions[i].data);
+    }
+    REQUIRE(decoded.block.ommers.size() == 1);
+    CHECK(decoded.block.ommers[0].number == 4);
+}
+
+TEST_CASE("compressed compact block decodes like uncompressed", "[silkrpc][common][compact_block]") {
+    auto block_with_hash = make_block(3, 1);
+    block_with_hash.block.transactions[0].data = silkworm::Bytes(4096, 0x01);
+    block_with_hash.block.transactions[2].from = 0x0715a7794a1dc8e42615f059dd6e406a6594651a_address;
+    const CompactBlock compact_block{block_with_hash, /*compression_threshold=*/1024};
+    CHECK(compact_block.compressed() == compression_available());
+    REQUIRE(compact_block.transaction_count() == 3);
+    REQUIRE(compact_block.ommer_count() == 1);
+
+    const auto decoded = compact_block.decode();
+    REQUIRE(decoded.block.transactions.size() == 3);
+    for (std::size_t i{0}; i < 3; ++i) {
+        CHECK(decoded.block.transactions[i].data == block_with_hash.block.transactions[i].data);
+        CHECK(decoded.block.transactions[i].from == block_with_hash.block.transactions[i].from);
+        CHECK(compact_block.transaction(i).data == block_with_hash.block.transactions[i].data);
+    }
+    REQUIRE(decoded.block.ommers.size() == 1);
+    CHECK(compact_block.ommer(0).number == 4);
+    if (compact_block.compressed()) {
+        CHECK(compact_block.size_bytes() < CompactBlock{block_with_hash}.size_bytes());
+        CHECK_THROWS_AS(compact_block.transaction_rlp(0), std::logic_error);
+    }
+}
+
+TEST_CASE("compact block below compression threshold is kept uncompressed", "[silkrpc][common][compact_block]") {
+    const CompactBlock compact_block{make_block(2, 0), /*compression_threshold=*/1024};
+    CHECK(!compact_block.compressed());
+    CHECK(!compact_block.transaction_rlp(0).empty());
+}
+
+TEST_CASE("compact block size accounts for encoded parts", "[silkrpc][common][compact_block]") {
+    CHECK(CompactBlock{make_block(0, 0)}.size_bytes() >= sizeof(CompactBlock));
+    auto block_with_hash = make_block(1, 0);
+    block_with_hash.block.transactions[0].data = silkworm::Bytes(1000, 0x01);
+    CHECK(CompactBlock{block_with_hash}.size_bytes() >= sizeof(CompactBlock) + 1000);
+}
+
+} // namespace silkrpc
@@ -0,0 +1,74 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "compressed_bytes.hpp"
+
+#include <stdexcept>
+
+#ifdef SILKRPC_HAS_LZ4
+#include <lz4.h>
+#endif
+
+namespace silkrpc {
+
+bool compression_available() noexcept {
+#ifdef SILKRPC_HAS_LZ4
+    return true;
+#else
+    return false;
+#endif
+}
+
+CompressedBytes::CompressedBytes(silkworm::ByteView bytes, std::size_t threshold) : size_{bytes.size()} {
+#ifdef SILKRPC_HAS_LZ4
+    if (threshold > 0 && bytes.size() >= threshold && bytes.size() <= LZ4_MAX_INPUT_SIZE) {
+        const auto source_size = static_cast<int>(bytes.size());
+        stored_.resize(static_cast<std::size_t>(LZ4_compressBound(source_size)));
+        const auto compressed_size = LZ4_compress_default(reinterpret_cast<const char*>(bytes.data()),
+            reinterpret_cast<char*>(stored_.data()), source_size, static_cast<int>(stored_.size()));
+        // Keep the bytes as they are unless worth it, e.g. already compressed or random data
+        if (compressed_size > 0 && static_cast<std::size_t>(compressed_size) < bytes.size()) {
+            stored_.resize(static_cast<std::size_t>(compressed_size));
+            stored_.shrink_to_fit();
+            compressed_ = true;
+            return;
+        }
+    }
+#else
+    (void)threshold;
+#endif
+    stored_ = bytes;
+}
+
+silkworm::Bytes CompressedBytes::bytes() const {
+    if (!compressed_) {
+        return stored_;
+    }
+#ifdef SILKRPC_HAS_LZ4
+    silkworm::Bytes bytes(size_, 0);
+    const auto decompressed_size = LZ4_decompress_safe(reinterpret_cast<const char*>(stored_.data()), reinterpret_cast<char*>(bytes.data()),
+        static_cast<int>(stored_.size()), static_cast<int>(size_));
+    if (decompressed_size < 0 || static_cast<std::size_t>(decompressed_size) != size_) {
+        throw std::runtime_error{"corrupted LZ4 compressed bytes"};
+    }
+    return bytes;
+#else
+    throw std::runtime_error{"LZ4 compression not available"};
+#endif
+}
+
+} // namespace silkrpc
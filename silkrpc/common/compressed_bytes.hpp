@@ -0,0 +1,65 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_COMMON_COMPRESSED_BYTES_HPP_
+#define SILKRPC_COMMON_COMPRESSED_BYTES_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <silkworm/common/base.hpp>
+
+namespace silkrpc {
+
+//! Return true if the cached values can be compressed, i.e. if built with LZ4 (see SILKRPC_USE_LZ4)
+bool compression_available() noexcept;
+
+//! Bytes kept in a cache compressed with LZ4 when at least as long as the threshold and actually shrinking, as they are
+//! otherwise: the compression is paid once on insertion and the decompression on each hit, which LZ4 makes cheap enough
+//! for the values whose decoding costs more anyway (e.g. blocks, contract code)
+class CompressedBytes {
+public:
+    CompressedBytes() = default;
+
+    //! Keep the bytes, compressing them if at least threshold bytes long (0 disables the compression)
+    CompressedBytes(silkworm::ByteView bytes, std::size_t threshold);
+
+    //! Return true if the bytes are kept compressed
+    bool compressed() const noexcept { return compressed_; }
+
+    //! Return the size of the original bytes
+    std::size_t size() const noexcept { return size_; }
+
+    //! Return the size of the kept bytes, compressed or not
+    std::size_t stored_size() const noexcept { return stored_.size(); }
+
+    //! Return the kept bytes, i.e. the original ones if not compressed
+    silkworm::ByteView stored() const noexcept { return stored_; }
+
+    //! Return the original bytes, decompressing them if kept compressed
+    //! \throws std::runtime_error if the compressed bytes are corrupted
+    silkworm::Bytes bytes() const;
+
+private:
+    silkworm::Bytes stored_;
+    std::size_t size_{0};
+    bool compressed_{false};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_COMPRESSED_BYTES_HPP_
@@ -0,0 +1,71 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "compressed_bytes.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+TEST_CASE("CompressedBytes", "[silkrpc][common][compressed_bytes]") {
+    const silkworm::Bytes repetitive(4096, 0x60);
+
+    SECTION("disabled compression keeps the bytes") {
+        const CompressedBytes bytes{repetitive, 0};
+        CHECK(!bytes.compressed());
+        CHECK(bytes.size() == repetitive.size());
+        CHECK(bytes.stored_size() == repetitive.size());
+        CHECK(bytes.stored() == repetitive);
+        CHECK(bytes.bytes() == repetitive);
+    }
+
+    SECTION("bytes below threshold are kept") {
+        const CompressedBytes bytes{repetitive, repetitive.size() + 1};
+        CHECK(!bytes.compressed());
+        CHECK(bytes.bytes() == repetitive);
+    }
+
+    SECTION("bytes above threshold are compressed if available") {
+        const CompressedBytes bytes{repetitive, 1024};
+        CHECK(bytes.compressed() == compression_available());
+        CHECK(bytes.size() == repetitive.size());
+        if (compression_available()) {
+            CHECK(bytes.stored_size() < repetitive.size());
+        }
+        CHECK(bytes.bytes() == repetitive);
+    }
+
+    SECTION("incompressible bytes are kept") {
+        silkworm::Bytes random(64, 0);
+        uint32_t state{0x12345678};
+        for (auto& byte : random) {
+            state = state * 1664525 + 1013904223;
+            byte = static_cast<uint8_t>(state >> 24);
+        }
+        const CompressedBytes bytes{random, 1};
+        CHECK(!bytes.compressed());
+        CHECK(bytes.bytes() == random);
+    }
+
+    SECTION("empty bytes") {
+        const CompressedBytes bytes{silkworm::ByteView{}, 1};
+        CHECK(!bytes.compressed());
+        CHECK(bytes.bytes().empty());
+    }
+}
+
+} // namespace silkrpc
@@ -19,6 +19,7 @@
 
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 
 namespace silkrpc {
 
@@ -30,9 +31,11 @@ constexpr const char* kParityApiNamespace{"parity"};
 constexpr const char* kErigonApiNamespace{"erigon"};
 constexpr const char* kTxPoolApiNamespace{"txpool"};
 constexpr const char* kTraceApiNamespace{"trace"};
+constexpr const char* kOtsApiNamespace{"ots"};
 constexpr const char* kWeb3ApiNamespace{"web3"};
 
 constexpr const char* kAddressPortSeparator{":"};
+constexpr const char* kUnixSocketPrefix{"unix:"};
 constexpr const char* kApiSpecSeparator{","};
 constexpr const char* kDefaultJwtFilename{"jwt.hex"};
 
@@ -45,8 +48,72 @@ constexpr const char* kDefaultEth2ApiSpec{"engine,eth"};
 constexpr const std::chrono::milliseconds kDefaultTimeout{10000};
 
 constexpr const std::size_t kHttpIncomingBufferSize{8192};
+constexpr const std::size_t kHttpIncomingBufferMaxSize{128 * 1024};
+constexpr const char* kMetricsUri{"/metrics"};
+constexpr const char* kProfileUri{"/debug/profile"};
+constexpr const int32_t kLimitExceededErrorCode{-32005};
+constexpr const std::chrono::milliseconds kDefaultAdmissionQueueBudget{100};
+constexpr const char* kRequestTimeoutHeader{"X-Request-Timeout"};
+constexpr const char* kForwardedRequestHeader{"X-Silkrpc-Forwarded"};
+constexpr const uint32_t kDefaultTraceSampleInterval{1000};
+constexpr const uint32_t kDefaultRecordSampleInterval{1};
+constexpr const uint32_t kDefaultDiskCacheSize{16384}; // MiB
+
+constexpr const uint32_t kDefaultMaxPipelinedRequests{1};
+constexpr const uint32_t kDefaultMaxBatchConcurrency{8};
+constexpr const uint32_t kDefaultHttpCompressionLevel{0};
+constexpr const uint32_t kDefaultHttpCompressionMinSize{1024};
+constexpr const uint32_t kDefaultHttpIdleTimeout{60000};
+constexpr const uint32_t kDefaultHttpReadTimeout{30000};
+constexpr const uint32_t kHttp2MaxConcurrentStreams{128};
+constexpr const std::size_t kHttp2MaxWriteSize{64 * 1024};
+
+constexpr const uint32_t kDefaultNumKvChannels{1};
+constexpr const uint32_t kDefaultNumLongRunningWorkers{4};
+constexpr const std::size_t kNumEngineWorkers{2};
+constexpr const std::size_t kEngineContextIndex{0};    // reserved context serving the Engine API
+constexpr const std::size_t kStreamingContextIndex{1}; // reserved context following the chain (StateChanges, backend updates)
+constexpr const std::size_t kNumReservedContexts{2};
+constexpr const uint32_t kDefaultGrpcStreamWindowSize{0};
+constexpr const uint32_t kDefaultGrpcKeepAliveTime{0};
+constexpr const std::chrono::milliseconds kGrpcKeepAliveTimeout{20000};
+constexpr const std::chrono::microseconds kDefaultWaitLatencyBudget{1000};
+
+constexpr const std::size_t kWebSocketMaxPendingNotifications{1024};
+
+constexpr const std::size_t kGetLogsBlocksPerChunk{64};
+constexpr const std::size_t kGetLogsMaxConcurrentChunks{8};
+constexpr const std::size_t kGetLogsMaxStreamedResults{1'000'000};
+constexpr const std::size_t kGetLogsMaxStreamedBytes{1024 * 1024 * 1024};
+constexpr const uint64_t kGetLogsMaxBloomBlocks{1024};
+constexpr const uint64_t kGetLogsMaxScanBlocks{10'000};
+
+constexpr const std::size_t kTraceFilterBlocksPerWindow{16};
+constexpr const std::size_t kTraceFilterMaxConcurrentBlocks{8};
+constexpr const uint32_t kOtsApiLevel{8};
+constexpr const uint64_t kOtsSearchMinWindowBlocks{4096};
+constexpr const uint64_t kOtsSearchMaxWindowBlocks{1024 * 1024};
+constexpr const uint64_t kOtsMaxPageSize{1000};
+
+constexpr const std::size_t kAccountDumpMaxConcurrentAccounts{8};
+constexpr const std::size_t kGetAccountsMaxAddresses{1024};
+
+constexpr const uint64_t kModifiedAccountsBlocksPerChunk{1024};
+constexpr const std::size_t kModifiedAccountsMaxConcurrentChunks{8};
+
+constexpr const std::size_t kDebugTraceMinTxsPerSegment{32};
+constexpr const std::size_t kDebugTraceMaxConcurrentSegments{4};
+
+constexpr const std::size_t kEvmAnalysisCacheSize{5'000};
+
+constexpr const std::size_t kEstimateGasProbesPerRound{4};
+
+constexpr const std::size_t kMaxIdleTransactionsPerContext{16};
 
 constexpr const std::size_t kRequestContentInitialCapacity{1024};
+constexpr const std::size_t kRequestContentMaxPreallocatedSize{16 * 1024 * 1024};
+constexpr const std::size_t kRequestArenaInitialSize{64 * 1024};
+constexpr const std::size_t kConnectionMaxRetainedCapacity{16 * 1024};
 constexpr const std::size_t kRequestHeadersInitialCapacity{8};
 constexpr const std::size_t kRequestMethodInitialCapacity{64};
 constexpr const std::size_t kRequestUriInitialCapacity{64};
@@ -0,0 +1,368 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "disk_cache.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <boost/asio/compose.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/endian/conversion.hpp>
+#include <zlib.h>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc {
+
+namespace {
+
+constexpr char kSegmentMagic[] = "SRPCDC1\n";
+constexpr std::size_t kMagicSize{sizeof(kSegmentMagic) - 1};
+constexpr const char* kSegmentExtension{".seg"};
+
+//! Each record is [value size (u32 LE)][kind (u8)][key (32 bytes)][value][crc32 (u32 LE) of kind, key and value]
+constexpr std::size_t kKeyBytes{sizeof(evmc::bytes32::bytes)};
+constexpr std::size_t kHeaderBytes{sizeof(uint32_t) + 1 + kKeyBytes};
+constexpr std::size_t kRecordOverhead{kHeaderBytes + sizeof(uint32_t)};
+
+std::string error_message(const std::string& operation, const std::filesystem::path& path, int error) {
+    return "cannot " + operation + " " + path.string() + ": " + std::strerror(error);
+}
+
+bool read_fully(int fd, uint8_t* data, std::size_t size, uint64_t offset) {
+    while (size > 0) {
+        const auto count = ::pread(fd, data, size, static_cast<off_t>(offset));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        data += count;
+        size -= static_cast<std::size_t>(count);
+        offset += static_cast<uint64_t>(count);
+    }
+    return true;
+}
+
+void write_fully(int fd, const uint8_t* data, std::size_t size, uint64_t offset, const std::filesystem::path& path) {
+    while (size > 0) {
+        const auto count = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count < 0) {
+            throw std::runtime_error{error_message("write", path, errno)};
+        }
+        data += count;
+        size -= static_cast<std::size_t>(count);
+        offset += static_cast<uint64_t>(count);
+    }
+}
+
+uint32_t checksum(const uint8_t* data, std::size_t size) {
+    return static_cast<uint32_t>(::crc32(::crc32(0L, Z_NULL, 0), data, static_cast<uInt>(size)));
+}
+
+bool valid_kind(uint8_t kind) {
+    return kind == static_cast<uint8_t>(DiskCache::Kind::block) || kind == static_cast<uint8_t>(DiskCache::Kind::receipts);
+}
+
+std::optional<uint64_t> segment_id_of(const std::filesystem::path& path) {
+    if (path.extension() != kSegmentExtension) {
+        return std::nullopt;
+    }
+    const auto stem = path.stem().string();
+    uint64_t id{0};
+    const auto [end, error] = std::from_chars(stem.data(), stem.data() + stem.size(), id);
+    if (error != std::errc{} || end != stem.data() + stem.size()) {
+        return std::nullopt;
+    }
+    return id;
+}
+
+} // namespace
+
+DiskCache::Segment::~Segment() {
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+DiskCache::DiskCache(const std::filesystem::path& dir, std::size_t max_bytes, std::size_t segment_bytes, std::size_t num_threads)
+    : dir_{dir},
+      max_bytes_{max_bytes},
+      segment_bytes_{std::max(std::min(segment_bytes, max_bytes / 2), kMagicSize + kRecordOverhead)},
+      pool_{num_threads > 0 ? num_threads : 1} {
+    std::filesystem::create_directories(dir_);
+
+    std::vector<uint64_t> ids;
+    for (const auto& entry : std::filesystem::directory_iterator{dir_}) {
+        if (const auto id = segment_id_of(entry.path()); id && entry.is_regular_file()) {
+            ids.push_back(*id);
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+
+    for (std::size_t i{0}; i < ids.size(); ++i) {
+        auto segment = open_segment(ids[i], /*create=*/false);
+        // Only the last segment may have been interrupted while appending, so only its records need a full check
+        load_segment(*segment, /*verify=*/i + 1 == ids.size());
+        size_bytes_ += segment->size;
+        segments_.emplace(segment->id, std::move(segment));
+    }
+    while (size_bytes_ > max_bytes_ && segments_.size() > 1) {
+        evict_oldest_segment();
+    }
+    SILKRPC_DEBUG << "DiskCache: loaded " << index_.size() << " values in " << segments_.size() << " segments from " << dir_.string() << "\n";
+}
+
+DiskCache::~DiskCache() {
+    pool_.join();
+}
+
+std::shared_ptr<DiskCache::Segment> DiskCache::open_segment(uint64_t id, bool create) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%08llu%s", static_cast<unsigned long long>(id), kSegmentExtension);
+
+    auto segment = std::make_shared<Segment>();
+    segment->id = id;
+    segment->path = dir_ / name;
+    segment->fd = ::open(segment->path.c_str(), O_RDWR | O_CLOEXEC | (create ? O_CREAT | O_EXCL : 0), 0644);
+    if (segment->fd < 0) {
+        throw std::runtime_error{error_message("open", segment->path, errno)};
+    }
+    if (create) {
+        write_fully(segment->fd, reinterpret_cast<const uint8_t*>(kSegmentMagic), kMagicSize, 0, segment->path);
+        segment->size = kMagicSize;
+    }
+    return segment;
+}
+
+void DiskCache::load_segment(Segment& segment, bool verify) {
+    struct stat file_stat{};
+    if (::fstat(segment.fd, &file_stat) < 0) {
+        throw std::runtime_error{error_message("stat", segment.path, errno)};
+    }
+    const auto file_size = static_cast<uint64_t>(file_stat.st_size);
+
+    uint8_t magic[kMagicSize];
+    uint64_t offset{0};
+    if (file_size >= kMagicSize && read_fully(segment.fd, magic, kMagicSize, 0) && std::memcmp(magic, kSegmentMagic, kMagicSize) == 0) {
+        offset = kMagicSize;
+    }
+
+    silkworm::Bytes record;
+    uint8_t header[kHeaderBytes];
+    while (offset > 0 && offset + kRecordOverhead <= file_size) {
+        if (!read_fully(segment.fd, header, kHeaderBytes, offset)) {
+            break;
+        }
+        const auto value_size = boost::endian::load_little_u32(header);
+        const auto kind = header[sizeof(uint32_t)];
+        if (value_size > kMaxValueBytes || !valid_kind(kind) || offset + kRecordOverhead + value_size > file_size) {
+            break;
+        }
+        if (verify) {
+            // The checksummed bytes (kind, key and value) followed by the checksum itself
+            record.resize(kRecordOverhead - sizeof(uint32_t) + value_size);
+            if (!read_fully(segment.fd, record.data(), record.size(), offset + sizeof(uint32_t))) {
+                break;
+            }
+            const auto checksummed_size = record.size() - sizeof(uint32_t);
+            if (boost::endian::load_little_u32(record.data() + checksummed_size) != checksum(record.data(), checksummed_size)) {
+                break;
+            }
+        }
+        IndexKey index_key{static_cast<Kind>(kind), {}};
+        std::memcpy(index_key.key.bytes, header + sizeof(uint32_t) + 1, kKeyBytes);
+        // A value appended twice (e.g. by an older instance racing on the same directory) keeps its first location
+        if (index_.emplace(index_key, Location{segment.id, offset, value_size}).second) {
+            segment.keys.push_back(index_key);
+        }
+        offset += kRecordOverhead + value_size;
+    }
+
+    if (offset == 0) {
+        SILKRPC_WARN << "DiskCache: resetting segment " << segment.path.string() << " having no valid header\n";
+        if (::ftruncate(segment.fd, 0) < 0) {
+            throw std::runtime_error{error_message("truncate", segment.path, errno)};
+        }
+        write_fully(segment.fd, reinterpret_cast<const uint8_t*>(kSegmentMagic), kMagicSize, 0, segment.path);
+        offset = kMagicSize;
+    } else if (offset < file_size) {
+        SILKRPC_WARN << "DiskCache: truncating segment " << segment.path.string() << " at " << offset << " of " << file_size << " bytes\n";
+        if (::ftruncate(segment.fd, static_cast<off_t>(offset)) < 0) {
+            throw std::runtime_error{error_message("truncate", segment.path, errno)};
+        }
+    }
+    segment.size = offset;
+}
+
+bool DiskCache::put(Kind kind, const evmc::bytes32& key, silkworm::ByteView value) {
+    if (value.size() > kMaxValueBytes) {
+        return false;
+    }
+    const IndexKey index_key{kind, key};
+
+    // Only the appends add to the index, so the lookup holds until the record is indexed
+    std::scoped_lock write_lock{write_mutex_};
+    std::shared_ptr<Segment> active;
+    {
+        std::shared_lock lock{mutex_};
+        if (index_.contains(index_key)) {
+            return false;
+        }
+        if (!segments_.empty()) {
+            active = segments_.rbegin()->second;
+        }
+    }
+
+    const auto record_size = kRecordOverhead + value.size();
+    if (!active || (active->size > kMagicSize && active->size + record_size > segment_bytes_)) {
+        active = open_segment(active ? active->id + 1 : 0, /*create=*/true);
+        std::unique_lock lock{mutex_};
+        size_bytes_ += active->size;
+        segments_.emplace(active->id, active);
+    }
+
+    silkworm::Bytes record(record_size, 0);
+    boost::endian::store_little_u32(record.data(), static_cast<uint32_t>(value.size()));
+    record[sizeof(uint32_t)] = static_cast<uint8_t>(kind);
+    std::memcpy(record.data() + sizeof(uint32_t) + 1, key.bytes, kKeyBytes);
+    std::memcpy(record.data() + kHeaderBytes, value.data(), value.size());
+    const auto checksummed_size = 1 + kKeyBytes + value.size();
+    boost::endian::store_little_u32(record.data() + kHeaderBytes + value.size(), checksum(record.data() + sizeof(uint32_t), checksummed_size));
+
+    const auto offset = active->size;
+    write_fully(active->fd, record.data(), record.size(), offset, active->path);
+
+    std::unique_lock lock{mutex_};
+    active->size += record_size;
+    active->keys.push_back(index_key);
+    index_.emplace(index_key, Location{active->id, offset, static_cast<uint32_t>(value.size())});
+    size_bytes_ += record_size;
+    while (size_bytes_ > max_bytes_ && segments_.size() > 1) {
+        evict_oldest_segment();
+    }
+    return true;
+}
+
+std::optional<silkworm::Bytes> DiskCache::get(Kind kind, const evmc::bytes32& key) {
+    const IndexKey index_key{kind, key};
+    Location location;
+    std::shared_ptr<Segment> segment;
+    {
+        std::shared_lock lock{mutex_};
+        const auto it = index_.find(index_key);
+        if (it != index_.end()) {
+            location = it->second;
+            segment = segments_.at(location.segment_id);
+        }
+    }
+    if (!segment) {
+        miss_count_.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    // The segment stays open even if evicted meanwhile, so the record is read without holding the lock
+    silkworm::Bytes record(1 + kKeyBytes + location.value_size + sizeof(uint32_t), 0);
+    const auto checksummed_size = record.size() - sizeof(uint32_t);
+    if (!read_fully(segment->fd, record.data(), record.size(), location.offset + sizeof(uint32_t)) ||
+        record[0] != static_cast<uint8_t>(kind) || std::memcmp(record.data() + 1, key.bytes, kKeyBytes) != 0 ||
+        boost::endian::load_little_u32(record.data() + checksummed_size) != checksum(record.data(), checksummed_size)) {
+        SILKRPC_WARN << "DiskCache: corrupted record at " << location.offset << " in " << segment->path.string() << "\n";
+        miss_count_.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+    hit_count_.fetch_add(1, std::memory_order_relaxed);
+    return silkworm::Bytes{record.data() + 1 + kKeyBytes, location.value_size};
+}
+
+bool DiskCache::contains(Kind kind, const evmc::bytes32& key) const {
+    std::shared_lock lock{mutex_};
+    return index_.contains(IndexKey{kind, key});
+}
+
+boost::asio::awaitable<std::optional<silkworm::Bytes>> DiskCache::async_get(Kind kind, const evmc::bytes32& key) {
+    const auto executor = co_await boost::asio::this_coro::executor;
+    co_return co_await boost::asio::async_compose<decltype(boost::asio::use_awaitable), void(std::optional<silkworm::Bytes>)>(
+        [&](auto&& self) {
+            boost::asio::post(pool_, [this, kind, key, executor, self = std::move(self)]() mutable {
+                auto value = get(kind, key);
+                boost::asio::post(executor, [self = std::move(self), value = std::move(value)]() mutable {
+                    self.complete(std::move(value));
+                });
+            });
+        },
+        boost::asio::use_awaitable);
+}
+
+void DiskCache::post_put(Kind kind, const evmc::bytes32& key, silkworm::Bytes value) {
+    boost::asio::post(pool_, [this, kind, key, value = std::move(value)]() {
+        try {
+            put(kind, key, value);
+        } catch (const std::exception& e) {
+            SILKRPC_ERROR << "DiskCache: cannot append value: " << e.what() << "\n";
+        }
+    });
+}
+
+std::size_t DiskCache::size() const {
+    std::shared_lock lock{mutex_};
+    return index_.size();
+}
+
+std::size_t DiskCache::size_bytes() const {
+    std::shared_lock lock{mutex_};
+    return size_bytes_;
+}
+
+std::size_t DiskCache::segment_count() const {
+    std::shared_lock lock{mutex_};
+    return segments_.size();
+}
+
+void DiskCache::evict_oldest_segment() {
+    const auto oldest = segments_.begin()->second;
+    for (const auto& index_key : oldest->keys) {
+        index_.erase(index_key);
+    }
+    evicted_count_.fetch_add(oldest->keys.size(), std::memory_order_relaxed);
+    size_bytes_ -= oldest->size;
+    segments_.erase(segments_.begin());
+    std::error_code error;
+    std::filesystem::remove(oldest->path, error);
+    if (error) {
+        SILKRPC_WARN << "DiskCache: cannot remove " << oldest->path.string() << ": " << error.message() << "\n";
+    }
+}
+
+} // namespace silkrpc
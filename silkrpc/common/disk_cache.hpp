@@ -0,0 +1,175 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_COMMON_DISK_CACHE_HPP_
+#define SILKRPC_COMMON_DISK_CACHE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <evmc/evmc.hpp>
+#include <silkworm/common/base.hpp>
+
+namespace silkrpc {
+
+//! Secondary cache tier of the immutable values keyed by block hash (i.e. blocks and receipts) on local disk, so that the
+//! values evicted from the in-memory caches are read back with one positional read instead of a remote lookup. The values
+//! are appended to a log of segment files, while their index is kept in memory and rebuilt at startup by scanning the
+//! segments (a torn record at the tail of the last one is cut off), hence the cache survives restarts. Once exceeding
+//! the budget the oldest segment is deleted, i.e. the values are evicted in insertion order. Each record carries the
+//! checksum of its value, verified on each read. The asynchronous reads and appends run on a small thread pool owned by
+//! the cache, so that the disk I/O never stalls the I/O contexts.
+class DiskCache {
+public:
+    //! The kinds of the cached values, each one having its own key space
+    enum class Kind : uint8_t {
+        block = 1,
+        receipts = 2,
+    };
+
+    //! The default max size in bytes of all the segments
+    static constexpr std::size_t kDefaultMaxBytes{std::size_t{16} << 30};
+
+    //! The default size in bytes beyond which a new segment is started
+    static constexpr std::size_t kDefaultSegmentBytes{std::size_t{64} << 20};
+
+    //! The default number of threads running the asynchronous reads and appends
+    static constexpr std::size_t kDefaultNumThreads{2};
+
+    //! The max size in bytes of one value
+    static constexpr std::size_t kMaxValueBytes{std::size_t{16} << 20};
+
+    //! Open the cache in the specified directory, creating it if missing and loading the index of the existing segments
+    //! \throws std::runtime_error if the directory or the segments cannot be opened
+    explicit DiskCache(const std::filesystem::path& dir, std::size_t max_bytes = kDefaultMaxBytes,
+        std::size_t segment_bytes = kDefaultSegmentBytes, std::size_t num_threads = kDefaultNumThreads);
+
+    //! Wait for the pending appends before closing the segments
+    ~DiskCache();
+
+    DiskCache(const DiskCache&) = delete;
+    DiskCache& operator=(const DiskCache&) = delete;
+
+    //! Append the value unless already present or too big, return true if appended
+    //! \throws std::runtime_error if the segment cannot be written
+    bool put(Kind kind, const evmc::bytes32& key, silkworm::ByteView value);
+
+    //! Read the value, if present and intact
+    std::optional<silkworm::Bytes> get(Kind kind, const evmc::bytes32& key);
+
+    bool contains(Kind kind, const evmc::bytes32& key) const;
+
+    //! Read the value on the cache threads, resuming the caller on its own executor
+    boost::asio::awaitable<std::optional<silkworm::Bytes>> async_get(Kind kind, const evmc::bytes32& key);
+
+    //! Append the value on the cache threads without waiting for it, skipping it if already present
+    void post_put(Kind kind, const evmc::bytes32& key, silkworm::Bytes value);
+
+    //! The number of cached values
+    std::size_t size() const;
+
+    //! The total size in bytes of the segments
+    std::size_t size_bytes() const;
+
+    std::size_t segment_count() const;
+
+    std::size_t max_bytes() const noexcept { return max_bytes_; }
+
+    uint64_t hit_count() const noexcept { return hit_count_.load(std::memory_order_relaxed); }
+    uint64_t miss_count() const noexcept { return miss_count_.load(std::memory_order_relaxed); }
+
+    //! The number of values evicted by deleting their segment
+    uint64_t evicted_count() const noexcept { return evicted_count_.load(std::memory_order_relaxed); }
+
+private:
+    struct IndexKey {
+        Kind kind;
+        evmc::bytes32 key;
+
+        bool operator==(const IndexKey& other) const noexcept { return kind == other.kind && key == other.key; }
+    };
+
+    struct IndexKeyHash {
+        std::size_t operator()(const IndexKey& index_key) const noexcept {
+            // Keys are hashes, so any of their bytes is already uniformly distributed
+            std::size_t hash;
+            std::memcpy(&hash, index_key.key.bytes, sizeof(hash));
+            return hash ^ static_cast<std::size_t>(index_key.kind);
+        }
+    };
+
+    //! One segment file, closed when the last reader is done with it even if deleted meanwhile
+    struct Segment {
+        uint64_t id{0};
+        std::filesystem::path path;
+        int fd{-1};
+        uint64_t size{0};
+        std::vector<IndexKey> keys;
+
+        ~Segment();
+    };
+
+    //! The position of a value within the segments
+    struct Location {
+        uint64_t segment_id{0};
+        uint64_t offset{0}; // the offset of the record
+        uint32_t value_size{0};
+    };
+
+    std::shared_ptr<Segment> open_segment(uint64_t id, bool create);
+    void load_segment(Segment& segment, bool verify);
+    void evict_oldest_segment();
+
+    const std::filesystem::path dir_;
+    const std::size_t max_bytes_;
+    const std::size_t segment_bytes_;
+
+    //! Serialize the appends, so that the records are written outside the index lock
+    std::mutex write_mutex_;
+
+    //! Protect the index and the segments, exclusively held to change them and shared by the lookups
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<IndexKey, Location, IndexKeyHash> index_;
+    std::map<uint64_t, std::shared_ptr<Segment>> segments_;
+    std::size_t size_bytes_{0};
+
+    std::atomic<uint64_t> hit_count_{0};
+    std::atomic<uint64_t> miss_count_{0};
+    std::atomic<uint64_t> evicted_count_{0};
+
+    //! The threads running the asynchronous reads and appends, stopped first on destruction
+    boost::asio::thread_pool pool_;
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_DISK_CACHE_HPP_
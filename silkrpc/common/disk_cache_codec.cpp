@@ -0,0 +1,313 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "disk_cache_codec.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include <boost/endian/conversion.hpp>
+#include <intx/intx.hpp>
+#include <silkworm/rlp/decode.hpp>
+#include <silkworm/rlp/encode.hpp>
+
+namespace silkrpc {
+
+namespace {
+
+//! The max number of topics of one log (i.e. LOG0 to LOG4)
+constexpr uint32_t kMaxTopics{4};
+
+//! Writer of the disk cache format, appending to the bytes
+class CacheWriter {
+  public:
+    explicit CacheWriter(silkworm::Bytes& bytes) : bytes_{bytes} {}
+
+    void write_u8(uint8_t value) { bytes_.push_back(value); }
+
+    void write_u32(uint32_t value) {
+        uint8_t buffer[sizeof(uint32_t)];
+        boost::endian::store_big_u32(buffer, value);
+        bytes_.append(buffer, sizeof(buffer));
+    }
+
+    void write_u64(uint64_t value) {
+        uint8_t buffer[sizeof(uint64_t)];
+        boost::endian::store_big_u64(buffer, value);
+        bytes_.append(buffer, sizeof(buffer));
+    }
+
+    void write_bytes(silkworm::ByteView bytes) {
+        write_u32(static_cast<uint32_t>(bytes.size()));
+        bytes_.append(bytes);
+    }
+
+    void write_address(const evmc::address& address) { bytes_.append(address.bytes, sizeof(address.bytes)); }
+
+    void write_bytes32(const evmc::bytes32& bytes32) { bytes_.append(bytes32.bytes, sizeof(bytes32.bytes)); }
+
+    void write_uint256(const intx::uint256& value) { write_bytes32(intx::be::store<evmc::bytes32>(value)); }
+
+    void write_optional_address(const std::optional<evmc::address>& address) {
+        write_u8(address ? 1 : 0);
+        if (address) {
+            write_address(*address);
+        }
+    }
+
+  private:
+    silkworm::Bytes& bytes_;
+};
+
+//! Reader of the disk cache format, failing on any truncated or malformed input
+class CacheReader {
+  public:
+    explicit CacheReader(silkworm::ByteView bytes) : bytes_{bytes} {}
+
+    bool at_end() const { return bytes_.empty(); }
+
+    std::size_t remaining() const { return bytes_.size(); }
+
+    silkworm::ByteView& view() { return bytes_; }
+
+    bool read_u8(uint8_t& value) {
+        if (remaining() < 1) {
+            return false;
+        }
+        value = bytes_[0];
+        bytes_.remove_prefix(1);
+        return true;
+    }
+
+    bool read_u32(uint32_t& value) {
+        if (remaining() < sizeof(uint32_t)) {
+            return false;
+        }
+        value = boost::endian::load_big_u32(bytes_.data());
+        bytes_.remove_prefix(sizeof(uint32_t));
+        return true;
+    }
+
+    bool read_u64(uint64_t& value) {
+        if (remaining() < sizeof(uint64_t)) {
+            return false;
+        }
+        value = boost::endian::load_big_u64(bytes_.data());
+        bytes_.remove_prefix(sizeof(uint64_t));
+        return true;
+    }
+
+    bool read_bytes(silkworm::Bytes& bytes) {
+        uint32_t size{0};
+        if (!read_u32(size) || size > remaining()) {
+            return false;
+        }
+        bytes = bytes_.substr(0, size);
+        bytes_.remove_prefix(size);
+        return true;
+    }
+
+    bool read_address(evmc::address& address) { return read_fixed(address.bytes, sizeof(address.bytes)); }
+
+    bool read_bytes32(evmc::bytes32& bytes32) { return read_fixed(bytes32.bytes, sizeof(bytes32.bytes)); }
+
+    bool read_uint256(intx::uint256& value) {
+        evmc::bytes32 bytes32;
+        if (!read_bytes32(bytes32)) {
+            return false;
+        }
+        value = intx::be::load<intx::uint256>(bytes32);
+        return true;
+    }
+
+    bool read_optional_address(std::optional<evmc::address>& address) {
+        uint8_t present{0};
+        if (!read_u8(present) || present > 1) {
+            return false;
+        }
+        if (present == 0) {
+            address.reset();
+            return true;
+        }
+        address.emplace();
+        return read_address(*address);
+    }
+
+  private:
+    bool read_fixed(uint8_t* data, std::size_t size) {
+        if (remaining() < size) {
+            return false;
+        }
+        std::copy_n(bytes_.data(), size, data);
+        bytes_.remove_prefix(size);
+        return true;
+    }
+
+    silkworm::ByteView bytes_;
+};
+
+// The bits of the receipt flags
+constexpr uint8_t kSuccessFlag{0x01};
+constexpr uint8_t kTypeFlag{0x02};
+constexpr uint8_t kFromFlag{0x04};
+constexpr uint8_t kToFlag{0x08};
+
+} // namespace
+
+silkworm::Bytes encode_cached_block(const silkworm::BlockWithHash& block_with_hash) {
+    const auto& block = block_with_hash.block;
+    silkworm::Bytes bytes;
+    silkworm::rlp::encode(bytes, block);
+    CacheWriter writer{bytes};
+    writer.write_u32(static_cast<uint32_t>(block.transactions.size()));
+    for (const auto& transaction : block.transactions) {
+        writer.write_optional_address(transaction.from);
+    }
+    return bytes;
+}
+
+bool decode_cached_block(silkworm::ByteView bytes, const evmc::bytes32& hash, silkworm::BlockWithHash& block_with_hash) {
+    CacheReader reader{bytes};
+    silkworm::BlockWithHash decoded;
+    if (silkworm::rlp::decode(reader.view(), decoded.block) != silkworm::DecodingResult::kOk) {
+        return false;
+    }
+    uint32_t num_senders{0};
+    if (!reader.read_u32(num_senders) || num_senders != decoded.block.transactions.size()) {
+        return false;
+    }
+    for (auto& transaction : decoded.block.transactions) {
+        if (!reader.read_optional_address(transaction.from)) {
+            return false;
+        }
+    }
+    if (!reader.at_end()) {
+        return false;
+    }
+    decoded.hash = hash;
+    block_with_hash = std::move(decoded);
+    return true;
+}
+
+silkworm::Bytes encode_cached_receipts(const Receipts& receipts) {
+    silkworm::Bytes bytes;
+    CacheWriter writer{bytes};
+    writer.write_u32(static_cast<uint32_t>(receipts.size()));
+    for (const auto& receipt : receipts) {
+        uint8_t flags{0};
+        flags |= receipt.success ? kSuccessFlag : 0;
+        flags |= receipt.type ? kTypeFlag : 0;
+        flags |= receipt.from ? kFromFlag : 0;
+        flags |= receipt.to ? kToFlag : 0;
+        writer.write_u8(flags);
+        writer.write_u8(receipt.type.value_or(0));
+        writer.write_u64(receipt.cumulative_gas_used);
+        writer.write_u64(receipt.gas_used);
+        writer.write_bytes32(receipt.tx_hash);
+        writer.write_address(receipt.contract_address);
+        writer.write_bytes32(receipt.block_hash);
+        writer.write_u64(receipt.block_number);
+        writer.write_u32(receipt.tx_index);
+        if (receipt.from) {
+            writer.write_address(*receipt.from);
+        }
+        if (receipt.to) {
+            writer.write_address(*receipt.to);
+        }
+        writer.write_uint256(receipt.effective_gas_price);
+        writer.write_u32(static_cast<uint32_t>(receipt.logs.size()));
+        for (const auto& log : receipt.logs) {
+            writer.write_address(log.address);
+            writer.write_u8(static_cast<uint8_t>(log.topics.size()));
+            for (const auto& topic : log.topics) {
+                writer.write_bytes32(topic);
+            }
+            writer.write_bytes(log.data);
+            writer.write_u32(log.index);
+        }
+    }
+    return bytes;
+}
+
+bool decode_cached_receipts(silkworm::ByteView bytes, Receipts& receipts) {
+    CacheReader reader{bytes};
+    uint32_t num_receipts{0};
+    if (!reader.read_u32(num_receipts) || num_receipts > reader.remaining()) {
+        return false;
+    }
+    Receipts decoded(num_receipts);
+    for (auto& receipt : decoded) {
+        uint8_t flags{0};
+        uint8_t type{0};
+        if (!reader.read_u8(flags) || !reader.read_u8(type) || !reader.read_u64(receipt.cumulative_gas_used) ||
+            !reader.read_u64(receipt.gas_used) || !reader.read_bytes32(receipt.tx_hash) || !reader.read_address(receipt.contract_address) ||
+            !reader.read_bytes32(receipt.block_hash) || !reader.read_u64(receipt.block_number) || !reader.read_u32(receipt.tx_index)) {
+            return false;
+        }
+        receipt.success = (flags & kSuccessFlag) != 0;
+        if (flags & kTypeFlag) {
+            receipt.type = type;
+        }
+        if (flags & kFromFlag) {
+            receipt.from.emplace();
+            if (!reader.read_address(*receipt.from)) {
+                return false;
+            }
+        }
+        if (flags & kToFlag) {
+            receipt.to.emplace();
+            if (!reader.read_address(*receipt.to)) {
+                return false;
+            }
+        }
+        uint32_t num_logs{0};
+        if (!reader.read_uint256(receipt.effective_gas_price) || !reader.read_u32(num_logs) || num_logs > reader.remaining()) {
+            return false;
+        }
+        receipt.logs.resize(num_logs);
+        for (auto& log : receipt.logs) {
+            uint8_t num_topics{0};
+            if (!reader.read_address(log.address) || !reader.read_u8(num_topics) || num_topics > kMaxTopics) {
+                return false;
+            }
+            log.topics.resize(num_topics);
+            for (auto& topic : log.topics) {
+                if (!reader.read_bytes32(topic)) {
+                    return false;
+                }
+            }
+            if (!reader.read_bytes(log.data) || !reader.read_u32(log.index)) {
+                return false;
+            }
+            log.block_number = receipt.block_number;
+            log.block_hash = receipt.block_hash;
+            log.tx_hash = receipt.tx_hash;
+            log.tx_index = receipt.tx_index;
+            log.removed = false;
+        }
+        receipt.bloom = bloom_from_logs(receipt.logs);
+    }
+    if (!reader.at_end()) {
+        return false;
+    }
+    receipts = std::move(decoded);
+    return true;
+}
+
+} // namespace silkrpc
@@ -0,0 +1,44 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_COMMON_DISK_CACHE_CODEC_HPP_
+#define SILKRPC_COMMON_DISK_CACHE_CODEC_HPP_
+
+#include <evmc/evmc.hpp>
+#include <silkworm/common/base.hpp>
+#include <silkworm/types/block.hpp>
+
+#include <silkrpc/types/receipt.hpp>
+
+namespace silkrpc {
+
+//! Encode the block in the binary form kept by DiskCache, i.e. its RLP encoding followed by the senders recovered so far
+silkworm::Bytes encode_cached_block(const silkworm::BlockWithHash& block_with_hash);
+
+//! Decode the block encoded by encode_cached_block, whose hash is the cache key, returning false if malformed
+bool decode_cached_block(silkworm::ByteView bytes, const evmc::bytes32& hash, silkworm::BlockWithHash& block_with_hash);
+
+//! Encode the receipts of a block in the compact binary form kept by DiskCache: the blooms are left out, because they
+//! are computed from the logs anyway, and so are the derived fields of the logs, which are those of their receipt
+silkworm::Bytes encode_cached_receipts(const Receipts& receipts);
+
+//! Decode the receipts encoded by encode_cached_receipts, returning false if malformed
+bool decode_cached_receipts(silkworm::ByteView bytes, Receipts& receipts);
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_DISK_CACHE_CODEC_HPP_
@@ -0,0 +1,119 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "disk_cache_codec.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+using evmc::literals::operator""_address, evmc::literals::operator""_bytes32;
+
+static const evmc::bytes32 kBlockHash{0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+
+TEST_CASE("encode and decode cached block", "[silkrpc][common][disk_cache_codec]") {
+    silkworm::BlockWithHash block_with_hash;
+    block_with_hash.hash = kBlockHash;
+    block_with_hash.block.header.number = 5;
+    block_with_hash.block.header.extra_data = silkworm::Bytes(32, 0xaa);
+    block_with_hash.block.transactions.resize(2);
+    block_with_hash.block.transactions[0].data = silkworm::Bytes(3, 0x01);
+    block_with_hash.block.transactions[1].from = 0x0715a7794a1dc8e42615f059dd6e406a6594651a_address;
+    block_with_hash.block.ommers.resize(1);
+    block_with_hash.block.ommers[0].number = 4;
+
+    const auto encoded = encode_cached_block(block_with_hash);
+
+    SECTION("round trip") {
+        silkworm::BlockWithHash decoded;
+        REQUIRE(decode_cached_block(encoded, kBlockHash, decoded));
+        CHECK(decoded.hash == kBlockHash);
+        CHECK(decoded.block.header.number == 5);
+        CHECK(decoded.block.header.extra_data == block_with_hash.block.header.extra_data);
+        REQUIRE(decoded.block.transactions.size() == 2);
+        CHECK(decoded.block.transactions[0].data == block_with_hash.block.transactions[0].data);
+        CHECK(!decoded.block.transactions[0].from);
+        CHECK(decoded.block.transactions[1].from == block_with_hash.block.transactions[1].from);
+        REQUIRE(decoded.block.ommers.size() == 1);
+        CHECK(decoded.block.ommers[0].number == 4);
+    }
+
+    SECTION("truncated") {
+        silkworm::BlockWithHash decoded;
+        CHECK(!decode_cached_block(silkworm::ByteView{encoded}.substr(0, encoded.size() - 1), kBlockHash, decoded));
+    }
+}
+
+TEST_CASE("encode and decode cached receipts", "[silkrpc][common][disk_cache_codec]") {
+    Receipts receipts(2);
+    receipts[0].success = true;
+    receipts[0].cumulative_gas_used = 21000;
+    receipts[0].gas_used = 21000;
+    receipts[0].type = 2;
+    receipts[0].from = 0x0715a7794a1dc8e42615f059dd6e406a6594651a_address;
+    receipts[0].effective_gas_price = 1000000000;
+    receipts[1].cumulative_gas_used = 71000;
+    receipts[1].gas_used = 50000;
+    receipts[1].to = 0x6d03eb5c2b8cfeab2e8a89d0a27ee1aff5e1e6a1_address;
+    receipts[1].tx_index = 1;
+    Log log;
+    log.address = 0x6d03eb5c2b8cfeab2e8a89d0a27ee1aff5e1e6a1_address;
+    log.topics = {0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef_bytes32};
+    log.data = silkworm::Bytes(32, 0x01);
+    log.index = 7;
+    receipts[1].logs.push_back(log);
+    for (auto& receipt : receipts) {
+        receipt.block_hash = kBlockHash;
+        receipt.block_number = 5;
+        receipt.bloom = bloom_from_logs(receipt.logs);
+    }
+
+    const auto encoded = encode_cached_receipts(receipts);
+
+    SECTION("round trip") {
+        Receipts decoded;
+        REQUIRE(decode_cached_receipts(encoded, decoded));
+        REQUIRE(decoded.size() == 2);
+        CHECK(decoded[0].success);
+        CHECK(decoded[0].type == 2);
+        CHECK(decoded[0].from == receipts[0].from);
+        CHECK(!decoded[0].to);
+        CHECK(decoded[0].effective_gas_price == 1000000000);
+        CHECK(!decoded[1].success);
+        CHECK(!decoded[1].type);
+        CHECK(decoded[1].gas_used == 50000);
+        CHECK(decoded[1].to == receipts[1].to);
+        CHECK(decoded[1].bloom == receipts[1].bloom);
+        REQUIRE(decoded[1].logs.size() == 1);
+        CHECK(decoded[1].logs[0].address == log.address);
+        CHECK(decoded[1].logs[0].topics == log.topics);
+        CHECK(decoded[1].logs[0].data == log.data);
+        CHECK(decoded[1].logs[0].index == 7);
+        CHECK(decoded[1].logs[0].block_hash == kBlockHash);
+        CHECK(decoded[1].logs[0].block_number == 5);
+        CHECK(decoded[1].logs[0].tx_index == 1);
+    }
+
+    SECTION("trailing bytes") {
+        auto trailing = encoded;
+        trailing.push_back(0);
+        Receipts decoded;
+        CHECK(!decode_cached_receipts(trailing, decoded));
+    }
+}
+
+} // namespace silkrpc
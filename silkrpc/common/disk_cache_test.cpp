@@ -0,0 +1,145 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "disk_cache.hpp"
+
+#include <filesystem>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/use_future.hpp>
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+using evmc::literals::operator""_bytes32;
+
+static const evmc::bytes32 kKey1{0x4f85816f12361224a8ee15a4bd643faf3b59beba85f4942c2d0c7e19ea0ad46b_bytes32};
+static const evmc::bytes32 kKey2{0x5f85816f12361224a8ee15a4bd643faf3b59beba85f4942c2d0c7e19ea0ad46b_bytes32};
+static const evmc::bytes32 kKey3{0x6f85816f12361224a8ee15a4bd643faf3b59beba85f4942c2d0c7e19ea0ad46b_bytes32};
+
+TEST_CASE("DiskCache", "[silkrpc][common][disk_cache]") {
+    const auto dir = std::filesystem::temp_directory_path() / "silkrpc_disk_cache_test";
+    std::filesystem::remove_all(dir);
+    const silkworm::Bytes value1(100, 0x01);
+    const silkworm::Bytes value2(200, 0x02);
+
+    SECTION("put and get") {
+        DiskCache cache{dir};
+        CHECK(!cache.get(DiskCache::Kind::block, kKey1));
+        CHECK(cache.put(DiskCache::Kind::block, kKey1, value1));
+        CHECK(!cache.put(DiskCache::Kind::block, kKey1, value2));
+        CHECK(cache.get(DiskCache::Kind::block, kKey1) == value1);
+        CHECK(!cache.get(DiskCache::Kind::receipts, kKey1));
+        CHECK(cache.put(DiskCache::Kind::receipts, kKey1, value2));
+        CHECK(cache.get(DiskCache::Kind::receipts, kKey1) == value2);
+        CHECK(cache.size() == 2);
+        CHECK(cache.hit_count() == 2);
+        CHECK(cache.miss_count() == 2);
+    }
+
+    SECTION("empty value") {
+        DiskCache cache{dir};
+        CHECK(cache.put(DiskCache::Kind::block, kKey1, {}));
+        CHECK(cache.get(DiskCache::Kind::block, kKey1) == silkworm::Bytes{});
+    }
+
+    SECTION("values survive restarts") {
+        {
+            DiskCache cache{dir};
+            cache.put(DiskCache::Kind::block, kKey1, value1);
+            cache.put(DiskCache::Kind::receipts, kKey2, value2);
+        }
+        DiskCache cache{dir};
+        CHECK(cache.size() == 2);
+        CHECK(cache.get(DiskCache::Kind::block, kKey1) == value1);
+        CHECK(cache.get(DiskCache::Kind::receipts, kKey2) == value2);
+    }
+
+    SECTION("torn tail is truncated at startup") {
+        std::filesystem::path segment_path;
+        {
+            DiskCache cache{dir};
+            cache.put(DiskCache::Kind::block, kKey1, value1);
+            cache.put(DiskCache::Kind::block, kKey2, value2);
+            segment_path = std::filesystem::directory_iterator{dir}->path();
+        }
+        std::filesystem::resize_file(segment_path, std::filesystem::file_size(segment_path) - 10);
+        {
+            DiskCache cache{dir};
+            CHECK(cache.size() == 1);
+            CHECK(cache.get(DiskCache::Kind::block, kKey1) == value1);
+            CHECK(!cache.get(DiskCache::Kind::block, kKey2));
+            CHECK(cache.put(DiskCache::Kind::block, kKey2, value2));
+        }
+        DiskCache cache{dir};
+        CHECK(cache.get(DiskCache::Kind::block, kKey2) == value2);
+    }
+
+    SECTION("corrupted value is not returned") {
+        std::filesystem::path segment_path;
+        {
+            DiskCache cache{dir};
+            cache.put(DiskCache::Kind::block, kKey1, value1);
+            segment_path = std::filesystem::directory_iterator{dir}->path();
+        }
+        DiskCache cache{dir};
+        REQUIRE(cache.contains(DiskCache::Kind::block, kKey1));
+        {
+            std::fstream file{segment_path, std::ios::in | std::ios::out | std::ios::binary};
+            file.seekp(static_cast<std::streamoff>(std::filesystem::file_size(segment_path) - 20));
+            file.put('\xff');
+        }
+        CHECK(!cache.get(DiskCache::Kind::block, kKey1));
+    }
+
+    SECTION("oldest segments are evicted") {
+        DiskCache cache{dir, /*max_bytes=*/1000, /*segment_bytes=*/300};
+        cache.put(DiskCache::Kind::block, kKey1, value2);
+        cache.put(DiskCache::Kind::block, kKey2, value2);
+        cache.put(DiskCache::Kind::block, kKey3, value2);
+        CHECK(cache.segment_count() >= 2);
+        CHECK(cache.size_bytes() <= 1000);
+        cache.put(DiskCache::Kind::receipts, kKey1, value2);
+        cache.put(DiskCache::Kind::receipts, kKey2, value2);
+        CHECK(cache.size_bytes() <= 1000);
+        CHECK(cache.evicted_count() > 0);
+        CHECK(!cache.get(DiskCache::Kind::block, kKey1));
+        CHECK(cache.get(DiskCache::Kind::receipts, kKey2) == value2);
+    }
+
+    SECTION("async get and post put") {
+        boost::asio::thread_pool callers{1};
+        DiskCache cache{dir};
+        cache.post_put(DiskCache::Kind::block, kKey1, value1);
+        for (int i{0}; i < 1000 && !cache.contains(DiskCache::Kind::block, kKey1); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        auto hit = boost::asio::co_spawn(callers, cache.async_get(DiskCache::Kind::block, kKey1), boost::asio::use_future);
+        CHECK(hit.get() == value1);
+        auto miss = boost::asio::co_spawn(callers, cache.async_get(DiskCache::Kind::block, kKey2), boost::asio::use_future);
+        CHECK(!miss.get());
+        callers.join();
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+} // namespace silkrpc
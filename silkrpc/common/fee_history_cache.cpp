@@ -0,0 +1,74 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "fee_history_cache.hpp"
+
+#include <algorithm>
+
+namespace silkrpc {
+
+intx::uint256 BlockFees::reward_at(double percentile) const {
+    if (rewards.empty()) {
+        return 0;
+    }
+    const auto threshold = static_cast<uint64_t>(static_cast<double>(gas_used) * percentile / 100);
+    const auto it = std::lower_bound(rewards.begin(), rewards.end(), threshold, [](const auto& reward, uint64_t gas) {
+        return reward.second < gas;
+    });
+    return it == rewards.end() ? rewards.back().first : it->first;
+}
+
+std::shared_ptr<const BlockFees> FeeHistoryCache::find(uint64_t block_number) const {
+    std::lock_guard lock{mutex_};
+    if (slots_.empty()) {
+        return nullptr;
+    }
+    const auto& fees = slots_[block_number % slots_.size()];
+    if (!fees || fees->block_number != block_number) {
+        return nullptr;
+    }
+    return fees;
+}
+
+void FeeHistoryCache::store(std::shared_ptr<const BlockFees> fees, uint64_t generation) {
+    std::lock_guard lock{mutex_};
+    if (slots_.empty() || generation != generation_) {
+        return;
+    }
+    auto& slot = slots_[fees->block_number % slots_.size()];
+    // Keep the latest block when an older one wraps around onto the same slot
+    if (slot && slot->block_number > fees->block_number) {
+        return;
+    }
+    slot = std::move(fees);
+}
+
+uint64_t FeeHistoryCache::generation() const {
+    std::lock_guard lock{mutex_};
+    return generation_;
+}
+
+void FeeHistoryCache::unwind(uint64_t from_block) {
+    std::lock_guard lock{mutex_};
+    ++generation_;
+    for (auto& slot : slots_) {
+        if (slot && slot->block_number >= from_block) {
+            slot.reset();
+        }
+    }
+}
+
+} // namespace silkrpc
@@ -0,0 +1,82 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_FEE_HISTORY_CACHE_HPP_
+#define SILKRPC_COMMON_FEE_HISTORY_CACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <intx/intx.hpp>
+
+namespace silkrpc {
+
+//! The fee statistics of one block
+struct BlockFees {
+    uint64_t block_number{0};
+    intx::uint256 base_fee;
+    //! The base fee of the next block as implied by this one
+    intx::uint256 next_base_fee;
+    double gas_used_ratio{0};
+    uint64_t gas_used{0};
+    //! The distinct priority fees per gas paid in ascending order, each with the cumulative gas used by the transactions up to it
+    std::vector<std::pair<intx::uint256, uint64_t>> rewards;
+
+    //! Return the lowest priority fee paid by the transactions using the given percentile of the block gas
+    intx::uint256 reward_at(double percentile) const;
+};
+
+//! Fixed-size ring buffer of the fee statistics of the latest blocks, shared among the execution contexts: each block has
+//! its own slot given by its number. The statistics of a canonical block never change, so the slots are dropped just from
+//! the unwound blocks on after each chain reorganization: the generation taken before reading prevents storing stale ones.
+class FeeHistoryCache {
+public:
+    //! The default number of slots, that is the max number of blocks served by one fee history request
+    static constexpr std::size_t kDefaultMaxBlocks{1024};
+
+    explicit FeeHistoryCache(std::size_t max_blocks = kDefaultMaxBlocks) : slots_(max_blocks) {}
+
+    FeeHistoryCache(const FeeHistoryCache&) = delete;
+    FeeHistoryCache& operator=(const FeeHistoryCache&) = delete;
+
+    //! Return the fee statistics of the block, if present, or nullptr otherwise
+    std::shared_ptr<const BlockFees> find(uint64_t block_number) const;
+
+    //! Store the fee statistics of the block read at the given generation, replacing the block in the same slot
+    void store(std::shared_ptr<const BlockFees> fees, uint64_t generation);
+
+    //! The current generation, to be taken before reading the blocks to store
+    uint64_t generation() const;
+
+    //! Drop the fee statistics of all the blocks starting from the specified one
+    void unwind(uint64_t from_block);
+
+    //! The number of slots
+    std::size_t capacity() const { return slots_.size(); }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<const BlockFees>> slots_;
+    uint64_t generation_{0};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_FEE_HISTORY_CACHE_HPP_
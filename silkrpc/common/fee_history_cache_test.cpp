@@ -0,0 +1,82 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "fee_history_cache.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+static std::shared_ptr<const BlockFees> make_fees(uint64_t block_number) {
+    auto fees = std::make_shared<BlockFees>();
+    fees->block_number = block_number;
+    fees->base_fee = block_number;
+    return fees;
+}
+
+TEST_CASE("block fees reward at percentile", "[silkrpc][common][fee_history_cache]") {
+    BlockFees fees;
+    CHECK(fees.reward_at(50) == 0);
+
+    fees.gas_used = 100;
+    fees.rewards = {{1, 10}, {2, 60}, {5, 100}};
+    CHECK(fees.reward_at(0) == 1);
+    CHECK(fees.reward_at(10) == 1);
+    CHECK(fees.reward_at(10.5) == 2);
+    CHECK(fees.reward_at(60) == 2);
+    CHECK(fees.reward_at(75) == 5);
+    CHECK(fees.reward_at(100) == 5);
+}
+
+TEST_CASE("fee history cache ring buffer", "[silkrpc][common][fee_history_cache]") {
+    FeeHistoryCache cache{4};
+    CHECK(cache.capacity() == 4);
+    CHECK(!cache.find(1));
+
+    for (uint64_t block_number{1}; block_number <= 4; ++block_number) {
+        cache.store(make_fees(block_number), cache.generation());
+    }
+    const auto fees = cache.find(3);
+    REQUIRE(fees);
+    CHECK(fees->base_fee == 3);
+
+    SECTION("newer block replaces the one in the same slot") {
+        cache.store(make_fees(5), cache.generation());
+        CHECK(!cache.find(1));
+        CHECK(cache.find(5));
+    }
+
+    SECTION("older block does not replace the one in the same slot") {
+        cache.store(make_fees(5), cache.generation());
+        cache.store(make_fees(1), cache.generation());
+        CHECK(!cache.find(1));
+        CHECK(cache.find(5));
+    }
+
+    SECTION("unwind drops the blocks from the specified one and the stale stores") {
+        const auto generation = cache.generation();
+        cache.unwind(3);
+        CHECK(cache.find(2));
+        CHECK(!cache.find(3));
+        CHECK(!cache.find(4));
+        cache.store(make_fees(3), generation);
+        CHECK(!cache.find(3));
+        cache.store(make_fees(3), cache.generation());
+        CHECK(cache.find(3));
+    }
+}
+
+} // namespace silkrpc
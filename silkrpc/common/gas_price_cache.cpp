@@ -0,0 +1,80 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "gas_price_cache.hpp"
+
+namespace silkrpc {
+
+std::optional<BlockPriceSamples> GasPriceCache::find_samples(uint64_t block_number) const {
+    std::lock_guard lock{mutex_};
+    const auto it = samples_.find(block_number);
+    if (it == samples_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void GasPriceCache::store_samples(uint64_t block_number, BlockPriceSamples samples, uint64_t generation) {
+    std::lock_guard lock{mutex_};
+    if (generation != generation_ || max_blocks_ == 0) {
+        return;
+    }
+    if (samples_.size() >= max_blocks_ && !samples_.contains(block_number)) {
+        // Blocks older than the whole window are not worth evicting a newer one
+        if (block_number < samples_.begin()->first) {
+            return;
+        }
+        samples_.erase(samples_.begin());
+    }
+    samples_.insert_or_assign(block_number, std::move(samples));
+}
+
+std::optional<intx::uint256> GasPriceCache::find_price(uint64_t block_number) const {
+    std::lock_guard lock{mutex_};
+    if (!price_ || price_->first != block_number) {
+        return std::nullopt;
+    }
+    return price_->second;
+}
+
+void GasPriceCache::store_price(uint64_t block_number, const intx::uint256& price, uint64_t generation) {
+    std::lock_guard lock{mutex_};
+    if (generation != generation_ || (price_ && price_->first > block_number)) {
+        return;
+    }
+    price_ = std::make_pair(block_number, price);
+}
+
+uint64_t GasPriceCache::generation() const {
+    std::lock_guard lock{mutex_};
+    return generation_;
+}
+
+void GasPriceCache::unwind(uint64_t from_block) {
+    std::lock_guard lock{mutex_};
+    ++generation_;
+    samples_.erase(samples_.lower_bound(from_block), samples_.end());
+    if (price_ && price_->first >= from_block) {
+        price_.reset();
+    }
+}
+
+std::size_t GasPriceCache::size() const {
+    std::lock_guard lock{mutex_};
+    return samples_.size();
+}
+
+} // namespace silkrpc
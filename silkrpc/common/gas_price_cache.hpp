@@ -0,0 +1,80 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_GAS_PRICE_CACHE_HPP_
+#define SILKRPC_COMMON_GAS_PRICE_CACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <intx/intx.hpp>
+
+namespace silkrpc {
+
+//! The lowest priority fees per gas sampled from the transactions of one block, in ascending order
+using BlockPriceSamples = std::vector<intx::uint256>;
+
+//! Rolling window of the price samples of the latest blocks together with the price suggested at the latest head, shared
+//! among the execution contexts. The samples of a canonical block never change, so the window is dropped just from the
+//! unwound blocks on after each chain reorganization: the generation taken before reading prevents storing stale entries.
+class GasPriceCache {
+public:
+    //! The default max number of blocks in the window
+    static constexpr std::size_t kDefaultMaxBlocks{256};
+
+    explicit GasPriceCache(std::size_t max_blocks = kDefaultMaxBlocks) : max_blocks_{max_blocks} {}
+
+    GasPriceCache(const GasPriceCache&) = delete;
+    GasPriceCache& operator=(const GasPriceCache&) = delete;
+
+    //! Return the samples of the block, if present in the window
+    std::optional<BlockPriceSamples> find_samples(uint64_t block_number) const;
+
+    //! Store the samples of the block read at the given generation, evicting the oldest block if the window is full
+    void store_samples(uint64_t block_number, BlockPriceSamples samples, uint64_t generation);
+
+    //! Return the price suggested at the block, if it is the latest head the price has been computed at
+    std::optional<intx::uint256> find_price(uint64_t block_number) const;
+
+    //! Store the price suggested at the block computed at the given generation, unless a later head is already present
+    void store_price(uint64_t block_number, const intx::uint256& price, uint64_t generation);
+
+    //! The current generation, to be taken before reading the block samples or computing the price to store
+    uint64_t generation() const;
+
+    //! Drop the samples of all the blocks starting from the specified one and any price suggested at them
+    void unwind(uint64_t from_block);
+
+    //! The number of blocks in the window
+    std::size_t size() const;
+
+private:
+    const std::size_t max_blocks_;
+
+    mutable std::mutex mutex_;
+    std::map<uint64_t, BlockPriceSamples> samples_;
+    std::optional<std::pair<uint64_t, intx::uint256>> price_;
+    uint64_t generation_{0};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_GAS_PRICE_CACHE_HPP_
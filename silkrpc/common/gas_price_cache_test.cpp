@@ -0,0 +1,88 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "gas_price_cache.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+TEST_CASE("gas price cache samples window", "[silkrpc][common][gas_price_cache]") {
+    GasPriceCache cache{3};
+    CHECK(!cache.find_samples(1));
+
+    for (uint64_t block_number{1}; block_number <= 3; ++block_number) {
+        cache.store_samples(block_number, {block_number, block_number * 10}, cache.generation());
+    }
+    const auto samples = cache.find_samples(2);
+    REQUIRE(samples);
+    CHECK(*samples == BlockPriceSamples{2, 20});
+    CHECK(cache.size() == 3);
+
+    SECTION("oldest block evicted when full") {
+        cache.store_samples(4, {4}, cache.generation());
+        CHECK(cache.size() == 3);
+        CHECK(!cache.find_samples(1));
+        CHECK(cache.find_samples(4));
+    }
+
+    SECTION("block older than the window not stored when full") {
+        cache.store_samples(0, {0}, cache.generation());
+        CHECK(!cache.find_samples(0));
+        CHECK(cache.find_samples(1));
+    }
+
+    SECTION("samples read before unwind not stored") {
+        const auto generation = cache.generation();
+        cache.unwind(3);
+        CHECK(!cache.find_samples(3));
+        CHECK(cache.find_samples(2));
+        cache.store_samples(3, {3}, generation);
+        CHECK(!cache.find_samples(3));
+        cache.store_samples(3, {3}, cache.generation());
+        CHECK(cache.find_samples(3));
+    }
+}
+
+TEST_CASE("gas price cache suggested price", "[silkrpc][common][gas_price_cache]") {
+    GasPriceCache cache;
+    CHECK(!cache.find_price(10));
+
+    cache.store_price(10, 7, cache.generation());
+    CHECK(cache.find_price(10) == intx::uint256{7});
+    CHECK(!cache.find_price(9));
+
+    SECTION("price at later head replaces the previous one") {
+        cache.store_price(11, 8, cache.generation());
+        CHECK(!cache.find_price(10));
+        CHECK(cache.find_price(11) == intx::uint256{8});
+    }
+
+    SECTION("price at earlier head ignored") {
+        cache.store_price(9, 6, cache.generation());
+        CHECK(!cache.find_price(9));
+        CHECK(cache.find_price(10) == intx::uint256{7});
+    }
+
+    SECTION("price dropped by unwind of its head") {
+        cache.unwind(11);
+        CHECK(cache.find_price(10) == intx::uint256{7});
+        cache.unwind(10);
+        CHECK(!cache.find_price(10));
+    }
+}
+
+} // namespace silkrpc
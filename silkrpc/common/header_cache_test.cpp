@@ -0,0 +1,55 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "header_cache.hpp"
+
+#include <memory>
+
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+
+namespace silkrpc {
+
+using evmc::literals::operator""_bytes32;
+
+static const evmc::bytes32 kBlockHash{0x439816753229fc0736bf86a5048de4bc9fcdede8c91dadf88c828c76b2281dff_bytes32};
+
+TEST_CASE("HeaderCache::get", "[silkrpc][common][header_cache]") {
+    HeaderCache header_cache;
+    CHECK(header_cache.get(kBlockHash) == nullptr);
+
+    auto header = std::make_shared<silkworm::BlockHeader>();
+    header->number = 4'000'000;
+    header->timestamp = 1'500'000'000;
+    header_cache.insert(kBlockHash, header);
+    const auto cached_header = header_cache.get(kBlockHash);
+    REQUIRE(cached_header);
+    CHECK(cached_header->number == 4'000'000);
+    CHECK(cached_header->timestamp == 1'500'000'000);
+    CHECK(header_cache.size_bytes() == HeaderCache::approximate_size(*header));
+}
+
+TEST_CASE("HeaderCache stays within budget", "[silkrpc][common][header_cache]") {
+    const silkworm::BlockHeader header;
+    HeaderCache header_cache{4 * HeaderCache::approximate_size(header), true, 1};
+    for (uint8_t i{0}; i < 10; ++i) {
+        evmc::bytes32 block_hash{};
+        block_hash.bytes[0] = i;
+        header_cache.insert(block_hash, std::make_shared<silkworm::BlockHeader>(header));
+    }
+    CHECK(header_cache.size() == 4);
+}
+
+} // namespace silkrpc
@@ -0,0 +1,296 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "hex.hpp"
+
+#include <array>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SILKRPC_HEX_X86_64
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define SILKRPC_HEX_NEON
+#include <arm_neon.h>
+#endif
+
+namespace silkrpc {
+
+namespace {
+
+constexpr char kHexDigits[]{"0123456789abcdef"};
+
+constexpr std::array<int8_t, 256> make_nibbles() {
+    std::array<int8_t, 256> nibbles{};
+    for (int c{0}; c < 256; ++c) {
+        if (c >= '0' && c <= '9') {
+            nibbles[c] = static_cast<int8_t>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            nibbles[c] = static_cast<int8_t>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            nibbles[c] = static_cast<int8_t>(c - 'A' + 10);
+        } else {
+            nibbles[c] = -1;
+        }
+    }
+    return nibbles;
+}
+
+//! The value of each hex digit, or -1 for any other character
+constexpr std::array<int8_t, 256> kNibbles{make_nibbles()};
+
+//! The vector kernels encode or decode as many whole blocks as they can, returning the number of bytes done: the rest is
+//! done by the scalar code, including any block having some invalid digit so that it is reported there
+using EncodeKernel = std::size_t (*)(const uint8_t* in, std::size_t size, char* out);
+using DecodeKernel = std::size_t (*)(const char* in, std::size_t size, uint8_t* out);
+
+struct Kernels {
+    std::string_view name;
+    EncodeKernel encode{nullptr};
+    DecodeKernel decode{nullptr};
+};
+
+void encode_scalar(const uint8_t* in, std::size_t size, char* out) {
+    for (std::size_t i{0}; i < size; ++i) {
+        out[2 * i] = kHexDigits[in[i] >> 4];
+        out[2 * i + 1] = kHexDigits[in[i] & 0x0f];
+    }
+}
+
+bool decode_scalar(const char* in, std::size_t size, uint8_t* out) {
+    for (std::size_t i{0}; i < size; ++i) {
+        const int hi = kNibbles[static_cast<uint8_t>(in[2 * i])];
+        const int lo = kNibbles[static_cast<uint8_t>(in[2 * i + 1])];
+        if ((hi | lo) < 0) {
+            return false;
+        }
+        out[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+}
+
+#if defined(SILKRPC_HEX_X86_64)
+
+__attribute__((target("ssse3"))) std::size_t encode_ssse3(const uint8_t* in, std::size_t size, char* out) {
+    const __m128i digits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kHexDigits));
+    const __m128i low_mask = _mm_set1_epi8(0x0f);
+    std::size_t i{0};
+    for (; i + 16 <= size; i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), low_mask));
+        const __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(bytes, low_mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    return i;
+}
+
+//! Return the values of the hex digits, flagging in invalid those of any other character
+__attribute__((target("ssse3"))) inline __m128i decode_nibbles_ssse3(__m128i chars, __m128i& invalid) {
+    const __m128i digits = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    const __m128i letters = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+    const __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letters, _mm_set1_epi8(5)), letters);
+    invalid = _mm_or_si128(invalid, _mm_andnot_si128(_mm_or_si128(is_digit, is_letter), _mm_set1_epi8(-1)));
+    return _mm_or_si128(_mm_and_si128(is_digit, digits), _mm_and_si128(is_letter, _mm_add_epi8(letters, _mm_set1_epi8(10))));
+}
+
+__attribute__((target("ssse3"))) std::size_t decode_ssse3(const char* in, std::size_t size, uint8_t* out) {
+    // Each pair of nibbles is combined as 16 * high + low by one multiply-add
+    const __m128i weights = _mm_set1_epi16(0x0110);
+    std::size_t i{0};
+    for (; i + 16 <= size; i += 16) {
+        __m128i invalid = _mm_setzero_si128();
+        const __m128i first = decode_nibbles_ssse3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i)), invalid);
+        const __m128i second = decode_nibbles_ssse3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i + 16)), invalid);
+        if (_mm_movemask_epi8(invalid) != 0) {
+            break;
+        }
+        const __m128i bytes = _mm_packus_epi16(_mm_maddubs_epi16(first, weights), _mm_maddubs_epi16(second, weights));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), bytes);
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) std::size_t encode_avx2(const uint8_t* in, std::size_t size, char* out) {
+    const __m256i digits = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(kHexDigits)));
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    std::size_t i{0};
+    for (; i + 32 <= size; i += 32) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        const __m256i hi = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), low_mask));
+        const __m256i lo = _mm256_shuffle_epi8(digits, _mm256_and_si256(bytes, low_mask));
+        // The unpacking works within each 128-bit lane, giving bytes 0-7 and 16-23, then 8-15 and 24-31
+        const __m256i first = _mm256_unpacklo_epi8(hi, lo);
+        const __m256i second = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i + 32), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+    return i + encode_ssse3(in + i, size - i, out + 2 * i);
+}
+
+__attribute__((target("avx2"))) inline __m256i decode_nibbles_avx2(__m256i chars, __m256i& invalid) {
+    const __m256i digits = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+    const __m256i letters = _mm256_sub_epi8(_mm256_or_si256(chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    const __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digits, _mm256_set1_epi8(9)), digits);
+    const __m256i is_letter = _mm256_cmpeq_epi8(_mm256_min_epu8(letters, _mm256_set1_epi8(5)), letters);
+    invalid = _mm256_or_si256(invalid, _mm256_andnot_si256(_mm256_or_si256(is_digit, is_letter), _mm256_set1_epi8(-1)));
+    return _mm256_or_si256(_mm256_and_si256(is_digit, digits), _mm256_and_si256(is_letter, _mm256_add_epi8(letters, _mm256_set1_epi8(10))));
+}
+
+__attribute__((target("avx2"))) std::size_t decode_avx2(const char* in, std::size_t size, uint8_t* out) {
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    std::size_t i{0};
+    for (; i + 32 <= size; i += 32) {
+        __m256i invalid = _mm256_setzero_si256();
+        const __m256i first = decode_nibbles_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i)), invalid);
+        const __m256i second = decode_nibbles_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i + 32)), invalid);
+        if (_mm256_movemask_epi8(invalid) != 0) {
+            break;
+        }
+        // The packing works within each 128-bit lane, giving bytes 0-7, 16-23, 8-15 and 24-31
+        const __m256i bytes = _mm256_packus_epi16(_mm256_maddubs_epi16(first, weights), _mm256_maddubs_epi16(second, weights));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_permute4x64_epi64(bytes, 0xd8));
+    }
+    return i + decode_ssse3(in + 2 * i, size - i, out + i);
+}
+
+Kernels select_kernels() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {"avx2", &encode_avx2, &decode_avx2};
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        return {"ssse3", &encode_ssse3, &decode_ssse3};
+    }
+    return {"scalar"};
+}
+
+#elif defined(SILKRPC_HEX_NEON)
+
+std::size_t encode_neon(const uint8_t* in, std::size_t size, char* out) {
+    const uint8x16_t digits = vld1q_u8(reinterpret_cast<const uint8_t*>(kHexDigits));
+    const uint8x16_t low_mask = vdupq_n_u8(0x0f);
+    std::size_t i{0};
+    for (; i + 16 <= size; i += 16) {
+        const uint8x16_t bytes = vld1q_u8(in + i);
+        uint8x16x2_t chars;
+        chars.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(bytes, 4));
+        chars.val[1] = vqtbl1q_u8(digits, vandq_u8(bytes, low_mask));
+        vst2q_u8(reinterpret_cast<uint8_t*>(out + 2 * i), chars);
+    }
+    return i;
+}
+
+inline uint8x16_t decode_nibbles_neon(uint8x16_t chars, uint8x16_t& invalid) {
+    const uint8x16_t digits = vsubq_u8(chars, vdupq_n_u8('0'));
+    const uint8x16_t letters = vsubq_u8(vorrq_u8(chars, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    const uint8x16_t is_digit = vcleq_u8(digits, vdupq_n_u8(9));
+    const uint8x16_t is_letter = vcleq_u8(letters, vdupq_n_u8(5));
+    invalid = vorrq_u8(invalid, vmvnq_u8(vorrq_u8(is_digit, is_letter)));
+    return vorrq_u8(vandq_u8(is_digit, digits), vandq_u8(is_letter, vaddq_u8(letters, vdupq_n_u8(10))));
+}
+
+std::size_t decode_neon(const char* in, std::size_t size, uint8_t* out) {
+    std::size_t i{0};
+    for (; i + 16 <= size; i += 16) {
+        // The interleaved load splits the high and the low digits
+        const uint8x16x2_t chars = vld2q_u8(reinterpret_cast<const uint8_t*>(in + 2 * i));
+        uint8x16_t invalid = vdupq_n_u8(0);
+        const uint8x16_t hi = decode_nibbles_neon(chars.val[0], invalid);
+        const uint8x16_t lo = decode_nibbles_neon(chars.val[1], invalid);
+        if (vmaxvq_u8(invalid) != 0) {
+            break;
+        }
+        vst1q_u8(out + i, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+    }
+    return i;
+}
+
+Kernels select_kernels() {
+    return {"neon", &encode_neon, &decode_neon};
+}
+
+#else
+
+Kernels select_kernels() {
+    return {"scalar"};
+}
+
+#endif
+
+const Kernels& kernels() {
+    static const Kernels kKernels{select_kernels()};
+    return kKernels;
+}
+
+} // namespace
+
+std::string to_hex(silkworm::ByteView bytes, bool with_prefix) {
+    const std::size_t prefix_size{with_prefix ? 2u : 0u};
+    std::string out(prefix_size + 2 * bytes.size(), '0');
+    if (with_prefix) {
+        out[1] = 'x';
+    }
+    hex::encode(bytes, out.data() + prefix_size);
+    return out;
+}
+
+std::optional<silkworm::Bytes> from_hex(std::string_view hex) {
+    if (hex.size() >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) {
+        hex.remove_prefix(2);
+    }
+    const std::size_t odd_digit{hex.size() % 2};
+    silkworm::Bytes bytes(hex.size() / 2 + odd_digit, 0);
+    if (odd_digit != 0) {
+        const auto nibble = kNibbles[static_cast<uint8_t>(hex[0])];
+        if (nibble < 0) {
+            return std::nullopt;
+        }
+        bytes[0] = static_cast<uint8_t>(nibble);
+        hex.remove_prefix(1);
+    }
+    if (!hex::decode(hex, bytes.data() + odd_digit)) {
+        return std::nullopt;
+    }
+    return bytes;
+}
+
+namespace hex {
+
+void encode(silkworm::ByteView bytes, char* out) {
+    std::size_t done{0};
+    if (const auto kernel = kernels().encode) {
+        done = kernel(bytes.data(), bytes.size(), out);
+    }
+    encode_scalar(bytes.data() + done, bytes.size() - done, out + 2 * done);
+}
+
+bool decode(std::string_view hex, uint8_t* out) {
+    const std::size_t size{hex.size() / 2};
+    std::size_t done{0};
+    if (const auto kernel = kernels().decode) {
+        done = kernel(hex.data(), size, out);
+    }
+    return decode_scalar(hex.data() + 2 * done, size - done, out + done);
+}
+
+std::string_view kernel_name() {
+    return kernels().name;
+}
+
+} // namespace hex
+
+} // namespace silkrpc
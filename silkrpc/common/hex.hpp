@@ -0,0 +1,65 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_HEX_HPP_
+#define SILKRPC_COMMON_HEX_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <evmc/evmc.hpp>
+#include <silkworm/common/base.hpp>
+
+namespace silkrpc {
+
+//! Return the lowercase hex digits of the bytes, prefixed by 0x if requested. Same as silkworm::to_hex, but the digits
+//! are written in one go into the string sized upfront, many bytes at a time using the vector instructions available at
+//! runtime (AVX2 or SSSE3 on x86-64, NEON on AArch64), so that the long data, topics and hashes of logs and traces are
+//! serialized at a fraction of the cost
+std::string to_hex(silkworm::ByteView bytes, bool with_prefix = false);
+
+inline std::string to_hex(const evmc::address& address, bool with_prefix = false) {
+    return to_hex(silkworm::ByteView{address.bytes, sizeof(address.bytes)}, with_prefix);
+}
+
+inline std::string to_hex(const evmc::bytes32& hash, bool with_prefix = false) {
+    return to_hex(silkworm::ByteView{hash.bytes, sizeof(hash.bytes)}, with_prefix);
+}
+
+//! Decode the hex digits, optionally prefixed by 0x, an odd number of digits being read as preceded by zero. Same as
+//! silkworm::from_hex, but many digits at a time, returning nothing if any of them is not a hex digit
+std::optional<silkworm::Bytes> from_hex(std::string_view hex);
+
+namespace hex {
+
+//! Write the 2 * bytes.size() lowercase hex digits of the bytes into the specified buffer
+void encode(silkworm::ByteView bytes, char* out);
+
+//! Decode the even number of hex digits into the hex.size() / 2 bytes of the specified buffer, returning false if any
+//! of them is not a hex digit (the buffer contents being unspecified then)
+bool decode(std::string_view hex, uint8_t* out);
+
+//! The name of the vector instructions used, e.g. "avx2", or "scalar" if none
+std::string_view kernel_name();
+
+} // namespace hex
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_HEX_HPP_
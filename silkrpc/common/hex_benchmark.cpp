@@ -0,0 +1,70 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "hex.hpp"
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <silkworm/common/util.hpp>
+
+namespace silkrpc {
+
+static silkworm::Bytes make_data(std::size_t size) {
+    silkworm::Bytes data(size, 0);
+    for (std::size_t i{0}; i < size; ++i) {
+        data[i] = static_cast<uint8_t>(i * 37 + 11);
+    }
+    return data;
+}
+
+static void BM_silkworm_to_hex(benchmark::State& state) {
+    const auto data = make_data(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto hex = "0x" + silkworm::to_hex(data);
+        benchmark::DoNotOptimize(hex);
+    }
+}
+BENCHMARK(BM_silkworm_to_hex)->Arg(20)->Arg(32)->Arg(1024);
+
+static void BM_to_hex(benchmark::State& state) {
+    const auto data = make_data(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto hex = to_hex(data, /*with_prefix=*/true);
+        benchmark::DoNotOptimize(hex);
+    }
+}
+BENCHMARK(BM_to_hex)->Arg(20)->Arg(32)->Arg(1024);
+
+static void BM_silkworm_from_hex(benchmark::State& state) {
+    const auto hex = "0x" + silkworm::to_hex(make_data(static_cast<std::size_t>(state.range(0))));
+    for (auto _ : state) {
+        auto data = silkworm::from_hex(hex);
+        benchmark::DoNotOptimize(data);
+    }
+}
+BENCHMARK(BM_silkworm_from_hex)->Arg(20)->Arg(32)->Arg(1024);
+
+static void BM_from_hex(benchmark::State& state) {
+    const auto hex = to_hex(make_data(static_cast<std::size_t>(state.range(0))), /*with_prefix=*/true);
+    for (auto _ : state) {
+        auto data = from_hex(hex);
+        benchmark::DoNotOptimize(data);
+    }
+}
+BENCHMARK(BM_from_hex)->Arg(20)->Arg(32)->Arg(1024);
+
+} // namespace silkrpc
@@ -0,0 +1,96 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "hex.hpp"
+
+#include <string>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+static std::string reference_hex(silkworm::ByteView bytes) {
+    static const char* kHexDigits{"0123456789abcdef"};
+    std::string hex;
+    for (const auto b : bytes) {
+        hex.push_back(kHexDigits[b >> 4]);
+        hex.push_back(kHexDigits[b & 0x0f]);
+    }
+    return hex;
+}
+
+static silkworm::Bytes make_bytes(std::size_t size) {
+    silkworm::Bytes bytes(size, 0);
+    for (std::size_t i{0}; i < size; ++i) {
+        bytes[i] = static_cast<uint8_t>(i * 37 + 11);
+    }
+    return bytes;
+}
+
+TEST_CASE("to_hex", "[silkrpc][common][hex]") {
+    CHECK(to_hex({}) == "");
+    CHECK(to_hex({}, /*with_prefix=*/true) == "0x");
+    const silkworm::Bytes bytes{0x00, 0x01, 0x7f, 0x80, 0xab, 0xff};
+    CHECK(to_hex(bytes) == "00017f80abff");
+    CHECK(to_hex(bytes, /*with_prefix=*/true) == "0x00017f80abff");
+}
+
+TEST_CASE("to_hex matches scalar encoding for any size", "[silkrpc][common][hex]") {
+    // The sizes cover the vector blocks, their tails and the addresses and hashes
+    for (std::size_t size{0}; size <= 200; ++size) {
+        const auto bytes = make_bytes(size);
+        CHECK(to_hex(bytes) == reference_hex(bytes));
+    }
+    const silkworm::Bytes all_ones(64, 0xff);
+    CHECK(to_hex(all_ones) == std::string(128, 'f'));
+}
+
+TEST_CASE("from_hex", "[silkrpc][common][hex]") {
+    CHECK(from_hex("") == silkworm::Bytes{});
+    CHECK(from_hex("0x") == silkworm::Bytes{});
+    CHECK(from_hex("0x00017f80abff") == silkworm::Bytes{0x00, 0x01, 0x7f, 0x80, 0xab, 0xff});
+    CHECK(from_hex("0X00017F80ABFF") == silkworm::Bytes{0x00, 0x01, 0x7f, 0x80, 0xab, 0xff});
+    CHECK(from_hex("abc") == silkworm::Bytes{0x0a, 0xbc});
+    CHECK(!from_hex("0xzz"));
+    CHECK(!from_hex("g"));
+    CHECK(!from_hex("0x0x"));
+}
+
+TEST_CASE("from_hex round trips for any size", "[silkrpc][common][hex]") {
+    for (std::size_t size{0}; size <= 200; ++size) {
+        const auto bytes = make_bytes(size);
+        CHECK(from_hex(reference_hex(bytes)) == bytes);
+        CHECK(from_hex("0x" + to_hex(bytes)) == bytes);
+    }
+}
+
+TEST_CASE("from_hex rejects invalid digit anywhere", "[silkrpc][common][hex]") {
+    const auto hex = reference_hex(make_bytes(100));
+    for (const char invalid : {'g', 'G', 'x', ' ', '/', ':', '@', '`', '\0', '\x80', '\xff'}) {
+        for (std::size_t position{0}; position < hex.size(); position += 7) {
+            auto corrupted = hex;
+            corrupted[position] = invalid;
+            CHECK(!from_hex(corrupted));
+        }
+    }
+}
+
+TEST_CASE("hex kernel name", "[silkrpc][common][hex]") {
+    const auto name = hex::kernel_name();
+    CHECK((name == "avx2" || name == "ssse3" || name == "neon" || name == "scalar"));
+}
+
+} // namespace silkrpc
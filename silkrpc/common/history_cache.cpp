@@ -0,0 +1,129 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "history_cache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include <silkworm/common/util.hpp>
+
+namespace silkrpc {
+
+std::optional<uint64_t> HistoryChunk::seek(uint64_t block_number) const {
+    const auto it = std::lower_bound(change_blocks.begin(), change_blocks.end(), block_number);
+    if (it == change_blocks.end()) {
+        return std::nullopt;
+    }
+    return *it;
+}
+
+std::shared_ptr<const HistoryChunk> HistoryChunks::find(uint64_t block_number) const {
+    const auto it = std::lower_bound(chunks.begin(), chunks.end(), block_number, [](const auto& chunk, uint64_t n) {
+        return chunk->to_block < n;
+    });
+    if (it == chunks.end() || !(*it)->covers(block_number)) {
+        return nullptr;
+    }
+    return *it;
+}
+
+void HistoryChunks::add(std::shared_ptr<const HistoryChunk> chunk) {
+    const auto it = std::lower_bound(chunks.begin(), chunks.end(), chunk->to_block, [](const auto& c, uint64_t n) {
+        return c->to_block < n;
+    });
+    if (it != chunks.end() && (*it)->to_block == chunk->to_block) {
+        *it = std::move(chunk);
+    } else {
+        chunks.insert(it, std::move(chunk));
+    }
+}
+
+std::shared_ptr<const HistoryChunk> HistoryCache::find(const std::string& table, silkworm::ByteView key, uint64_t block_number) {
+    const auto chunks = get(key_of(table, key));
+    if (!chunks || chunks->generation != generation()) {
+        return nullptr;
+    }
+    return chunks->find(block_number);
+}
+
+void HistoryCache::store(const std::string& table, silkworm::ByteView key, std::shared_ptr<const HistoryChunk> chunk, uint64_t read_generation) {
+    if (chunk->to_block == kLastChunkSuffix || read_generation != generation()) {
+        return;
+    }
+    // Cached values are immutable, so the chunks already cached for the key are copied along with the new one
+    const auto cache_key = key_of(table, key);
+    HistoryChunks chunks;
+    if (const auto cached_chunks = get(cache_key); cached_chunks && cached_chunks->generation == read_generation) {
+        chunks.chunks = cached_chunks->chunks;
+    }
+    chunks.generation = read_generation;
+    chunks.add(std::move(chunk));
+    insert(cache_key, std::make_shared<const HistoryChunks>(std::move(chunks)));
+}
+
+std::shared_ptr<const HistoryChange> HistoryCache::find_change(const std::string& table, silkworm::ByteView key) {
+    auto change = changes_.get(key_of(table, key));
+    if (!change || change->generation != change_generation()) {
+        return nullptr;
+    }
+    return change;
+}
+
+void HistoryCache::store_change(const std::string& table, silkworm::ByteView key, uint64_t change_block,
+                                std::optional<silkworm::Bytes> value, uint64_t read_generation) {
+    if (change_block > final_block() || read_generation != change_generation()) {
+        return;
+    }
+    changes_.insert(key_of(table, key), std::make_shared<const HistoryChange>(HistoryChange{std::move(value), read_generation}));
+}
+
+void HistoryCache::set_head_block(uint64_t block_number) {
+    final_block_.store(block_number > kFinalityDepth ? block_number - kFinalityDepth : 0, std::memory_order_release);
+}
+
+void HistoryCache::unwind(uint64_t from_block) {
+    if (from_block <= final_block()) {
+        // Unwinding that deep is unexpected but possible before the merge: none of the cached changes is trusted anymore
+        final_block_.store(from_block > 0 ? from_block - 1 : 0, std::memory_order_release);
+        change_generation_.fetch_add(1, std::memory_order_acq_rel);
+    }
+}
+
+std::size_t HistoryCache::approximate_size(const HistoryChunks& chunks) {
+    std::size_t size{sizeof(HistoryChunks)};
+    for (const auto& chunk : chunks.chunks) {
+        size += sizeof(chunk) + sizeof(HistoryChunk) + chunk->change_blocks.size() * sizeof(uint64_t);
+    }
+    return size;
+}
+
+std::size_t HistoryCache::approximate_change_size(const HistoryChange& change) {
+    return sizeof(HistoryChange) + (change.value ? change.value->size() : 0);
+}
+
+evmc::bytes32 HistoryCache::key_of(const std::string& table, silkworm::ByteView key) {
+    silkworm::Bytes table_key{table.begin(), table.end()};
+    table_key.append(key);
+    const auto hash{silkworm::keccak256(table_key)};
+    evmc::bytes32 cache_key;
+    std::memcpy(cache_key.bytes, hash.bytes, sizeof(cache_key.bytes));
+    return cache_key;
+}
+
+} // namespace silkrpc
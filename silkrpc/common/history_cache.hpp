@@ -0,0 +1,155 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_HISTORY_CACHE_HPP_
+#define SILKRPC_COMMON_HISTORY_CACHE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <evmc/evmc.hpp>
+#include <silkworm/common/base.hpp>
+
+#include <silkrpc/common/sharded_cache.hpp>
+
+namespace silkrpc {
+
+//! One chunk of the history index of an account or storage location, i.e. the blocks changing it in some range. The chunk
+//! found seeking the index at some block is also the one found seeking at any block between from_block and to_block.
+struct HistoryChunk {
+    //! The lowest block number served by the chunk, i.e. the lowest between the seek block and the first change block
+    uint64_t from_block{0};
+
+    //! The highest block number served by the chunk, i.e. its key suffix
+    uint64_t to_block{0};
+
+    //! The blocks changing the account or storage location in ascending order
+    std::vector<uint64_t> change_blocks;
+
+    bool covers(uint64_t block_number) const noexcept { return from_block <= block_number && block_number <= to_block; }
+
+    //! Return the first block changing the account or storage location at or after the specified one, if any
+    std::optional<uint64_t> seek(uint64_t block_number) const;
+};
+
+//! The chunks of the history index of one account or storage location read so far, in ascending order of block range
+struct HistoryChunks {
+    std::vector<std::shared_ptr<const HistoryChunk>> chunks;
+
+    //! The cache generation the chunks have been read at
+    uint64_t generation{0};
+
+    //! Return the chunk serving the specified block number, if any, or nullptr otherwise
+    std::shared_ptr<const HistoryChunk> find(uint64_t block_number) const;
+
+    //! Add the chunk, replacing the one having the same key suffix (which serves a narrower block range)
+    void add(std::shared_ptr<const HistoryChunk> chunk);
+};
+
+//! The value of an account or storage location found in the change set of the block changing it, i.e. the value it had
+//! before that block: such change is immutable as long as the block is not unwound
+struct HistoryChange {
+    std::optional<silkworm::Bytes> value;
+
+    //! The change generation the value has been read at
+    uint64_t generation{0};
+};
+
+//! Cache of the decoded sealed chunks of the account and storage history indexes, bounded by their approximate memory
+//! footprint (see ShardedCache), so that historical state reads skip the history lookup for hot accounts and storage
+//! locations. The open-ended last chunk of each index keeps changing as new blocks arrive, so it is never cached, while
+//! sealed chunks change only when unwinding: the cache is invalidated after each chain reorganization.
+//! The cache also keeps the account and storage changes read at the resolved change blocks, so that repeated historical
+//! reads of the same contracts skip the change set lookup as well. Only the changes of the blocks at least kFinalityDepth
+//! below the chain head are cached and never invalidated, unless some unwind reaches that deep.
+class HistoryCache : public ShardedCache<HistoryChunks> {
+public:
+    //! The default memory budget in bytes
+    static constexpr std::size_t kDefaultMaxBytes{64 * 1024 * 1024};
+
+    //! The default memory budget in bytes of the changes
+    static constexpr std::size_t kDefaultMaxChangeBytes{64 * 1024 * 1024};
+
+    //! The number of blocks below the chain head whose changes are considered final (i.e. two epochs after the merge)
+    static constexpr uint64_t kFinalityDepth{64};
+
+    //! The key suffix of the open-ended last chunk
+    static constexpr uint64_t kLastChunkSuffix{std::numeric_limits<uint64_t>::max()};
+
+    explicit HistoryCache(std::size_t max_bytes = kDefaultMaxBytes, bool shared_cache = true, std::size_t num_shards = kDefaultNumShards,
+                          std::size_t max_change_bytes = kDefaultMaxChangeBytes)
+    : ShardedCache{&HistoryCache::approximate_size, max_bytes, shared_cache, num_shards},
+      changes_{&HistoryCache::approximate_change_size, max_change_bytes, shared_cache, num_shards} {}
+
+    //! Return the cached chunk of the history key in the table serving the block number, if any and still valid
+    std::shared_ptr<const HistoryChunk> find(const std::string& table, silkworm::ByteView key, uint64_t block_number);
+
+    //! Store the chunk of the history key in the table, unless open-ended or the cache has been invalidated since read
+    void store(const std::string& table, silkworm::ByteView key, std::shared_ptr<const HistoryChunk> chunk, uint64_t read_generation);
+
+    //! The current generation, to be taken before reading the chunks to store
+    uint64_t generation() const { return generation_.load(std::memory_order_acquire); }
+
+    //! Invalidate all the cached chunks
+    void invalidate() { generation_.fetch_add(1, std::memory_order_acq_rel); }
+
+    //! Return the cached change of the key in the change set table, if any and still valid
+    std::shared_ptr<const HistoryChange> find_change(const std::string& table, silkworm::ByteView key);
+
+    //! Store the change of the key in the change set table read at the change block, unless not final yet or unwound since read
+    void store_change(const std::string& table, silkworm::ByteView key, uint64_t change_block, std::optional<silkworm::Bytes> value,
+                      uint64_t read_generation);
+
+    //! The current change generation, to be taken before reading the changes to store
+    uint64_t change_generation() const { return change_generation_.load(std::memory_order_acquire); }
+
+    //! The highest block whose changes are cached
+    uint64_t final_block() const { return final_block_.load(std::memory_order_acquire); }
+
+    //! Record the new chain head, making final the changes of the blocks at least kFinalityDepth below it
+    void set_head_block(uint64_t block_number);
+
+    //! Record the unwinding of the blocks from the specified one, dropping the cached changes if any of them is unwound
+    void unwind(uint64_t from_block);
+
+    //! The number of cached changes
+    std::size_t change_count() const { return changes_.size(); }
+
+    //! Return the approximate memory footprint of the chunks
+    static std::size_t approximate_size(const HistoryChunks& chunks);
+
+    //! Return the approximate memory footprint of the change
+    static std::size_t approximate_change_size(const HistoryChange& change);
+
+private:
+    static evmc::bytes32 key_of(const std::string& table, silkworm::ByteView key);
+
+    std::atomic<uint64_t> generation_{0};
+
+    ShardedCache<HistoryChange> changes_;
+    std::atomic<uint64_t> change_generation_{0};
+    std::atomic<uint64_t> final_block_{0};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_HISTORY_CACHE_HPP_
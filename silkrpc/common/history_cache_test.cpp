@@ -0,0 +1,169 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "history_cache.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+static const std::string kAccountHistory{"AccountHistory"};
+static const std::string kStorageHistory{"StorageHistory"};
+static const silkworm::Bytes kKey{0x01, 0x02, 0x03};
+
+static std::shared_ptr<const HistoryChunk> make_chunk(uint64_t from_block, uint64_t to_block, std::vector<uint64_t> change_blocks) {
+    return std::make_shared<const HistoryChunk>(HistoryChunk{from_block, to_block, std::move(change_blocks)});
+}
+
+TEST_CASE("history chunk seek", "[silkrpc][common][history_cache]") {
+    const auto chunk = make_chunk(10, 100, {10, 50, 100});
+    CHECK(!chunk->covers(9));
+    CHECK(chunk->covers(10));
+    CHECK(chunk->covers(100));
+    CHECK(!chunk->covers(101));
+    CHECK(chunk->seek(10) == 10);
+    CHECK(chunk->seek(11) == 50);
+    CHECK(chunk->seek(100) == 100);
+    CHECK(!chunk->seek(101));
+    CHECK(!make_chunk(10, HistoryCache::kLastChunkSuffix, {})->seek(10));
+}
+
+TEST_CASE("history chunks find and add", "[silkrpc][common][history_cache]") {
+    HistoryChunks chunks;
+    CHECK(!chunks.find(10));
+
+    chunks.add(make_chunk(201, 300, {201, 300}));
+    chunks.add(make_chunk(1, 100, {1, 100}));
+    REQUIRE(chunks.chunks.size() == 2);
+    CHECK(chunks.chunks[0]->to_block == 100);
+    CHECK(chunks.find(50)->to_block == 100);
+    CHECK(chunks.find(250)->to_block == 300);
+    CHECK(!chunks.find(150));
+    CHECK(!chunks.find(301));
+
+    // The same chunk found seeking at a lower block serves a wider range
+    chunks.add(make_chunk(150, 300, {201, 300}));
+    REQUIRE(chunks.chunks.size() == 2);
+    CHECK(chunks.find(150)->to_block == 300);
+}
+
+TEST_CASE("history cache find and store", "[silkrpc][common][history_cache]") {
+    HistoryCache cache;
+    CHECK(!cache.find(kAccountHistory, kKey, 50));
+
+    cache.store(kAccountHistory, kKey, make_chunk(1, 100, {1, 100}), cache.generation());
+    cache.store(kAccountHistory, kKey, make_chunk(101, 200, {101, 200}), cache.generation());
+    CHECK(cache.find(kAccountHistory, kKey, 50)->to_block == 100);
+    CHECK(cache.find(kAccountHistory, kKey, 150)->to_block == 200);
+    CHECK(!cache.find(kAccountHistory, kKey, 250));
+    CHECK(cache.size() == 1);
+
+    SECTION("same key in another table is another entry") {
+        CHECK(!cache.find(kStorageHistory, kKey, 50));
+    }
+
+    SECTION("open-ended last chunk never stored") {
+        cache.store(kAccountHistory, kKey, make_chunk(201, HistoryCache::kLastChunkSuffix, {201}), cache.generation());
+        CHECK(!cache.find(kAccountHistory, kKey, 250));
+    }
+}
+
+TEST_CASE("history cache invalidation", "[silkrpc][common][history_cache]") {
+    HistoryCache cache;
+    const auto generation = cache.generation();
+    cache.store(kAccountHistory, kKey, make_chunk(1, 100, {1, 100}), generation);
+    REQUIRE(cache.find(kAccountHistory, kKey, 50));
+
+    SECTION("cached chunks dropped") {
+        cache.invalidate();
+        CHECK(!cache.find(kAccountHistory, kKey, 50));
+    }
+
+    SECTION("chunks read before invalidation not stored") {
+        cache.invalidate();
+        cache.store(kAccountHistory, kKey, make_chunk(101, 200, {101, 200}), generation);
+        CHECK(!cache.find(kAccountHistory, kKey, 150));
+    }
+
+    SECTION("chunks read before invalidation not merged") {
+        cache.invalidate();
+        cache.store(kAccountHistory, kKey, make_chunk(101, 200, {101, 200}), cache.generation());
+        CHECK(!cache.find(kAccountHistory, kKey, 50));
+        CHECK(cache.find(kAccountHistory, kKey, 150));
+    }
+}
+
+TEST_CASE("history cache changes", "[silkrpc][common][history_cache]") {
+    static const std::string kStorageChangeSet{"StorageChangeSet"};
+    const silkworm::Bytes other_key{0x04, 0x05};
+    const silkworm::Bytes value{0x0a};
+    HistoryCache cache;
+    CHECK(!cache.find_change(kStorageChangeSet, kKey));
+
+    SECTION("changes not final not stored") {
+        cache.store_change(kStorageChangeSet, kKey, 100, value, cache.change_generation());
+        CHECK(!cache.find_change(kStorageChangeSet, kKey));
+        cache.set_head_block(100 + HistoryCache::kFinalityDepth - 1);
+        cache.store_change(kStorageChangeSet, kKey, 100, value, cache.change_generation());
+        CHECK(!cache.find_change(kStorageChangeSet, kKey));
+    }
+
+    SECTION("final changes stored") {
+        cache.set_head_block(100 + HistoryCache::kFinalityDepth);
+        CHECK(cache.final_block() == 100);
+        cache.store_change(kStorageChangeSet, kKey, 100, value, cache.change_generation());
+        cache.store_change(kStorageChangeSet, other_key, 99, std::nullopt, cache.change_generation());
+        const auto change = cache.find_change(kStorageChangeSet, kKey);
+        REQUIRE(change);
+        CHECK(change->value == value);
+        const auto empty_change = cache.find_change(kStorageChangeSet, other_key);
+        REQUIRE(empty_change);
+        CHECK(!empty_change->value);
+        CHECK(cache.change_count() == 2);
+        CHECK(!cache.find_change(kAccountHistory, kKey));
+    }
+
+    SECTION("final changes kept by shallow unwind") {
+        cache.set_head_block(100 + HistoryCache::kFinalityDepth);
+        cache.store_change(kStorageChangeSet, kKey, 100, value, cache.change_generation());
+        cache.unwind(101);
+        cache.invalidate();
+        CHECK(cache.find_change(kStorageChangeSet, kKey));
+    }
+
+    SECTION("final changes dropped by deep unwind") {
+        cache.set_head_block(100 + HistoryCache::kFinalityDepth);
+        const auto generation = cache.change_generation();
+        cache.store_change(kStorageChangeSet, kKey, 100, value, generation);
+        cache.unwind(100);
+        CHECK(cache.final_block() == 99);
+        CHECK(!cache.find_change(kStorageChangeSet, kKey));
+        cache.store_change(kStorageChangeSet, kKey, 90, value, generation);
+        CHECK(!cache.find_change(kStorageChangeSet, kKey));
+        cache.store_change(kStorageChangeSet, kKey, 90, value, cache.change_generation());
+        CHECK(cache.find_change(kStorageChangeSet, kKey));
+    }
+}
+
+TEST_CASE("history cache approximate size", "[silkrpc][common][history_cache]") {
+    HistoryChunks chunks;
+    const auto empty_size = HistoryCache::approximate_size(chunks);
+    chunks.add(make_chunk(1, 100, {1, 2, 3, 4}));
+    CHECK(HistoryCache::approximate_size(chunks) >= empty_size + 4 * sizeof(uint64_t));
+}
+
+} // namespace silkrpc
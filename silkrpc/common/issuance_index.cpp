@@ -0,0 +1,97 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "issuance_index.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+namespace silkrpc {
+
+IssuanceIndex::IssuanceIndex(std::size_t max_blocks) : max_blocks_{std::max<std::size_t>(max_blocks, 1)} {}
+
+bool IssuanceIndex::append(uint64_t block_number, const BlockIssuance& issuance) {
+    std::unique_lock lock{mutex_};
+    const auto next_block = first_block_ + entries_.size();
+    if (!entries_.empty() && block_number < next_block) {
+        return false;
+    }
+    if (entries_.empty() || block_number > next_block) {
+        entries_.clear();
+        first_block_ = block_number;
+    }
+    Entry entry{issuance, {issuance.issuance(), issuance.burnt, issuance.tips}};
+    if (!entries_.empty()) {
+        const auto& previous = entries_.back().cumulative;
+        entry.cumulative.issued += previous.issued;
+        entry.cumulative.burnt += previous.burnt;
+        entry.cumulative.tips += previous.tips;
+    }
+    entries_.push_back(entry);
+    if (entries_.size() > max_blocks_) {
+        // The running totals of the remaining blocks stay valid, just no longer starting from the first block
+        entries_.pop_front();
+        ++first_block_;
+    }
+    return true;
+}
+
+void IssuanceIndex::truncate(uint64_t from_block) {
+    std::unique_lock lock{mutex_};
+    if (from_block <= first_block_) {
+        entries_.clear();
+    } else if (from_block < first_block_ + entries_.size()) {
+        entries_.resize(from_block - first_block_);
+    }
+}
+
+std::size_t IssuanceIndex::size() const {
+    std::shared_lock lock{mutex_};
+    return entries_.size();
+}
+
+std::optional<uint64_t> IssuanceIndex::next_block() const {
+    std::shared_lock lock{mutex_};
+    if (entries_.empty()) {
+        return std::nullopt;
+    }
+    return first_block_ + entries_.size();
+}
+
+std::optional<BlockIssuance> IssuanceIndex::find(uint64_t block_number) const {
+    std::shared_lock lock{mutex_};
+    if (block_number < first_block_ || block_number >= first_block_ + entries_.size()) {
+        return std::nullopt;
+    }
+    return entries_[block_number - first_block_].issuance;
+}
+
+std::optional<IssuanceTotals> IssuanceIndex::totals(uint64_t from_block, uint64_t to_block) const {
+    std::shared_lock lock{mutex_};
+    if (from_block > to_block || from_block < first_block_ || to_block >= first_block_ + entries_.size()) {
+        return std::nullopt;
+    }
+    const auto& from_entry = entries_[from_block - first_block_];
+    const auto& to_cumulative = entries_[to_block - first_block_].cumulative;
+    return IssuanceTotals{
+        to_cumulative.issued - from_entry.cumulative.issued + from_entry.issuance.issuance(),
+        to_cumulative.burnt - from_entry.cumulative.burnt + from_entry.issuance.burnt,
+        to_cumulative.tips - from_entry.cumulative.tips + from_entry.issuance.tips,
+    };
+}
+
+} // namespace silkrpc
@@ -0,0 +1,97 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_COMMON_ISSUANCE_INDEX_HPP_
+#define SILKRPC_COMMON_ISSUANCE_INDEX_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <shared_mutex>
+
+#include <intx/intx.hpp>
+
+namespace silkrpc {
+
+//! The issuance and the fees of one block
+struct BlockIssuance {
+    intx::uint256 block_reward;
+    intx::uint256 ommer_reward;
+    intx::uint256 burnt;
+    intx::uint256 tips;
+
+    intx::uint256 issuance() const { return block_reward + ommer_reward; }
+};
+
+//! The issuance and the fees aggregated over a block range
+struct IssuanceTotals {
+    intx::uint256 issued;
+    intx::uint256 burnt;
+    intx::uint256 tips;
+};
+
+//! In-memory index of the issuance and the fees of the most recent blocks, contiguous by block number, keeping the running
+//! totals since the first block appended next to the values of each block, so that the totals of any indexed block range
+//! are the difference of two entries rather than the sum of as many block computations. The index is appended at each
+//! new head, truncated when unwinding and bounded in size by evicting the oldest blocks.
+class IssuanceIndex {
+public:
+    //! The default maximum number of blocks indexed, i.e. a couple of days of Ethereum mainnet blocks
+    static constexpr std::size_t kDefaultMaxBlocks{16 * 1024};
+
+    explicit IssuanceIndex(std::size_t max_blocks = kDefaultMaxBlocks);
+
+    IssuanceIndex(const IssuanceIndex&) = delete;
+    IssuanceIndex& operator=(const IssuanceIndex&) = delete;
+
+    //! Append the issuance of the block, restarting the index from it if not the next one: return false if the block is
+    //! already indexed, in which case the index must be truncated first
+    bool append(uint64_t block_number, const BlockIssuance& issuance);
+
+    //! Remove the issuance of all the blocks starting from the specified one
+    void truncate(uint64_t from_block);
+
+    //! The number of blocks indexed
+    std::size_t size() const;
+
+    //! The next block to index, if any has been indexed
+    std::optional<uint64_t> next_block() const;
+
+    //! Return the issuance of the block, if indexed
+    std::optional<BlockIssuance> find(uint64_t block_number) const;
+
+    //! Return the totals of the blocks between from_block and to_block (both included), if all indexed
+    std::optional<IssuanceTotals> totals(uint64_t from_block, uint64_t to_block) const;
+
+private:
+    struct Entry {
+        BlockIssuance issuance;
+
+        //! The running totals since the first block appended, this one included
+        IssuanceTotals cumulative;
+    };
+
+    std::size_t max_blocks_;
+    mutable std::shared_mutex mutex_;
+    uint64_t first_block_{0};
+    std::deque<Entry> entries_;
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_ISSUANCE_INDEX_HPP_
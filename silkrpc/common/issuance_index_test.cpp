@@ -0,0 +1,100 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "issuance_index.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+//! The issuance of the block: reward 2, ommer reward 1, burnt and tips growing with the block number
+static BlockIssuance issuance_of(uint64_t block_number) {
+    return BlockIssuance{2, 1, block_number * 10, block_number};
+}
+
+static void fill(IssuanceIndex& index, uint64_t from_block, uint64_t to_block) {
+    for (auto i{from_block}; i <= to_block; ++i) {
+        REQUIRE(index.append(i, issuance_of(i)));
+    }
+}
+
+TEST_CASE("IssuanceIndex::append", "[silkrpc][common][issuance_index]") {
+    IssuanceIndex index;
+    CHECK(index.size() == 0);
+    CHECK(!index.next_block());
+    CHECK(!index.find(0));
+
+    fill(index, 100, 199);
+    CHECK(index.size() == 100);
+    CHECK(index.next_block() == 200);
+    CHECK(!index.find(99));
+    CHECK(index.find(100)->burnt == 1000);
+    CHECK(index.find(199)->tips == 199);
+    CHECK(!index.find(200));
+
+    SECTION("already indexed") {
+        CHECK(!index.append(150, issuance_of(150)));
+        CHECK(index.size() == 100);
+    }
+
+    SECTION("gap restarts the index") {
+        CHECK(index.append(300, issuance_of(300)));
+        CHECK(index.size() == 1);
+        CHECK(!index.find(199));
+        CHECK(index.find(300)->burnt == 3000);
+    }
+}
+
+TEST_CASE("IssuanceIndex::truncate", "[silkrpc][common][issuance_index]") {
+    IssuanceIndex index;
+    fill(index, 100, 199);
+
+    index.truncate(150);
+    CHECK(index.next_block() == 150);
+    CHECK(!index.find(150));
+    CHECK(index.append(150, issuance_of(150)));
+
+    index.truncate(1000);
+    CHECK(index.size() == 51);
+
+    index.truncate(50);
+    CHECK(index.size() == 0);
+}
+
+TEST_CASE("IssuanceIndex::totals", "[silkrpc][common][issuance_index]") {
+    IssuanceIndex index{64};
+    fill(index, 100, 199);
+    CHECK(index.size() == 64);
+    CHECK(!index.find(135));
+    CHECK(!index.totals(135, 150));
+    CHECK(!index.totals(150, 200));
+    CHECK(!index.totals(160, 150));
+
+    const auto single = index.totals(150, 150);
+    REQUIRE(single);
+    CHECK(single->issued == 3);
+    CHECK(single->burnt == 1500);
+    CHECK(single->tips == 150);
+
+    const auto range = index.totals(136, 199);
+    REQUIRE(range);
+    CHECK(range->issued == 3 * 64);
+    CHECK(range->burnt == 10 * (136 + 199) * 64 / 2);
+    CHECK(range->tips == (136 + 199) * 64 / 2);
+}
+
+} // namespace silkrpc
@@ -0,0 +1,108 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "latency_histogram.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace silkrpc {
+
+void LatencyHistogram::observe(std::chrono::microseconds latency) {
+    const auto micros = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+    const auto bound_it = std::lower_bound(kBucketBounds.begin(), kBucketBounds.end(), micros);
+    if (bound_it != kBucketBounds.end()) {
+        buckets_[static_cast<std::size_t>(bound_it - kBucketBounds.begin())].fetch_add(1, std::memory_order_relaxed);
+    }
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(static_cast<int64_t>(micros), std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::cumulative_count(std::size_t bucket_index) const {
+    uint64_t count{0};
+    for (std::size_t i{0}; i <= bucket_index && i < buckets_.size(); ++i) {
+        count += buckets_[i].load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+std::string_view to_string(RequestPhase phase) {
+    switch (phase) {
+        case RequestPhase::parse: return "parse";
+        case RequestPhase::queue: return "queue";
+        case RequestPhase::backend_io: return "backend_io";
+        case RequestPhase::evm: return "evm";
+        case RequestPhase::serialization: return "serialization";
+    }
+    return "unknown";
+}
+
+MethodLatencies::MethodLatencies() : snapshot_{std::make_shared<const HistogramMap>()} {}
+
+void MethodLatencies::observe(const std::string& method, std::chrono::microseconds latency) {
+    histograms(method).total.observe(latency);
+}
+
+void MethodLatencies::observe(const std::string& method, std::chrono::microseconds latency, const RequestProfile& profile) {
+    auto& method_histograms = histograms(method);
+    method_histograms.total.observe(latency);
+    for (std::size_t i{0}; i < kNumRequestPhases; ++i) {
+        const auto elapsed = profile.elapsed(static_cast<RequestPhase>(i));
+        method_histograms.phases[i].observe(std::chrono::duration_cast<std::chrono::microseconds>(elapsed));
+    }
+    if (profile.costs_accounted()) {
+        method_histograms.cpu_time.observe(std::chrono::duration_cast<std::chrono::microseconds>(profile.cpu_time()));
+        method_histograms.allocated_bytes.fetch_add(profile.allocated_bytes(), std::memory_order_relaxed);
+    }
+}
+
+void MethodLatencies::for_each(const std::function<void(const std::string&, const Histograms&)>& f) const {
+    const auto snapshot = snapshot_.load(std::memory_order_acquire);
+    std::vector<std::pair<const std::string*, const Histograms*>> entries;
+    entries.reserve(snapshot->size());
+    snapshot->for_each([&](const std::string& method, const std::shared_ptr<Histograms>& histograms) {
+        entries.emplace_back(&method, histograms.get());
+    });
+    std::sort(entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) { return *lhs.first < *rhs.first; });
+    for (const auto& [method, histograms] : entries) {
+        f(*method, *histograms);
+    }
+}
+
+std::size_t MethodLatencies::size() const {
+    return snapshot_.load(std::memory_order_acquire)->size();
+}
+
+MethodLatencies::Histograms& MethodLatencies::histograms(const std::string& method) {
+    // The histograms are never removed, so they outlive the snapshot they are found in
+    auto snapshot = snapshot_.load(std::memory_order_acquire);
+    if (const auto* histograms = snapshot->find(method)) {
+        return **histograms;
+    }
+    std::scoped_lock lock{mutex_};
+    snapshot = snapshot_.load(std::memory_order_acquire);
+    if (const auto* histograms = snapshot->find(method)) {
+        return **histograms;
+    }
+    auto updated = std::make_shared<HistogramMap>(*snapshot);
+    auto histograms = std::make_shared<Histograms>();
+    updated->insert_or_assign(method, histograms);
+    snapshot_.store(std::move(updated), std::memory_order_release);
+    return *histograms;
+}
+
+} // namespace silkrpc
@@ -0,0 +1,168 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_LATENCY_HISTOGRAM_HPP_
+#define SILKRPC_COMMON_LATENCY_HISTOGRAM_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include <silkrpc/common/persistent_map.hpp>
+
+namespace silkrpc {
+
+//! Histogram of latencies with fixed buckets, updated without locking by concurrent observers
+class LatencyHistogram {
+public:
+    //! The upper bounds of the buckets in microseconds, from 10us up to 10s (the last bucket is unbounded)
+    static constexpr std::array<uint64_t, 18> kBucketBounds{
+        10, 25, 50, 100, 250, 500, 1'000, 2'500, 5'000, 10'000, 25'000, 50'000, 100'000, 250'000, 500'000, 1'000'000, 2'500'000, 10'000'000
+    };
+
+    void observe(std::chrono::microseconds latency);
+
+    //! Return the number of observations not greater than the bound of the bucket at the specified index (i.e. cumulative)
+    uint64_t cumulative_count(std::size_t bucket_index) const;
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+    std::chrono::microseconds sum() const { return std::chrono::microseconds{sum_.load(std::memory_order_relaxed)}; }
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketBounds.size()> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<int64_t> sum_{0};
+};
+
+//! The coarse-grained phases of a request: the waiting for admission or for a worker is queueing, the time spent in the
+//! remote cursors is backend I/O and the reply JSON dumping is serialization
+enum class RequestPhase : std::size_t {
+    parse,
+    queue,
+    backend_io,
+    evm,
+    serialization,
+};
+
+constexpr std::size_t kNumRequestPhases{static_cast<std::size_t>(RequestPhase::serialization) + 1};
+
+std::string_view to_string(RequestPhase phase);
+
+//! Time spent by one request in each phase, accumulated by any thread: the phases of concurrent operations add up,
+//! so their sum can exceed the request latency
+class RequestProfile {
+public:
+    void add(RequestPhase phase, std::chrono::nanoseconds elapsed) {
+        elapsed_[static_cast<std::size_t>(phase)].fetch_add(elapsed.count(), std::memory_order_relaxed);
+    }
+
+    std::chrono::nanoseconds elapsed(RequestPhase phase) const {
+        return std::chrono::nanoseconds{elapsed_[static_cast<std::size_t>(phase)].load(std::memory_order_relaxed)};
+    }
+
+    //! The method name of the request, outliving the profile, used to tag the samples taken while serving it
+    const char* method() const noexcept { return method_; }
+
+    void set_method(const std::string& method) noexcept { method_ = method.c_str(); }
+
+    //! Account the CPU time consumed and the bytes allocated by some work of the request, on any thread
+    void add_cost(std::chrono::nanoseconds cpu_time, uint64_t allocated_bytes) {
+        cpu_time_.fetch_add(cpu_time.count(), std::memory_order_relaxed);
+        allocated_bytes_.fetch_add(allocated_bytes, std::memory_order_relaxed);
+    }
+
+    std::chrono::nanoseconds cpu_time() const { return std::chrono::nanoseconds{cpu_time_.load(std::memory_order_relaxed)}; }
+
+    uint64_t allocated_bytes() const { return allocated_bytes_.load(std::memory_order_relaxed); }
+
+    //! Return true if the work of the request accounts its costs (see RequestWorkScope)
+    bool costs_accounted() const noexcept { return costs_accounted_; }
+
+    void set_costs_accounted(bool costs_accounted) noexcept { costs_accounted_ = costs_accounted; }
+
+private:
+    std::array<std::atomic<int64_t>, kNumRequestPhases> elapsed_{};
+    const char* method_{nullptr};
+    std::atomic<int64_t> cpu_time_{0};
+    std::atomic<uint64_t> allocated_bytes_{0};
+    bool costs_accounted_{false};
+};
+
+//! Latency histograms by method name, created on first observation: the lookups read an immutable snapshot of the
+//! methods without locking, just the first observation of a method copies the snapshot under the lock
+class MethodLatencies {
+public:
+    struct Histograms {
+        LatencyHistogram total;
+        std::array<LatencyHistogram, kNumRequestPhases> phases;
+        LatencyHistogram cpu_time;
+        std::atomic<uint64_t> allocated_bytes{0};
+    };
+
+    MethodLatencies();
+
+    //! Observe the total latency of one request for the method
+    void observe(const std::string& method, std::chrono::microseconds latency);
+
+    //! Observe the total latency of one request for the method together with the time spent in each phase and its costs,
+    //! if accounted
+    void observe(const std::string& method, std::chrono::microseconds latency, const RequestProfile& profile);
+
+    //! Observe the time spent writing one reply to the socket, which covers all the methods of a batch
+    void observe_write(std::chrono::microseconds latency) { write_.observe(latency); }
+
+    //! Apply the function to each method and its histograms, in method order
+    void for_each(const std::function<void(const std::string&, const Histograms&)>& f) const;
+
+    const LatencyHistogram& write_latency() const { return write_; }
+
+    std::size_t size() const;
+
+    //! Return true if the CPU time and the allocated bytes of the requests are accounted, which costs some overhead on
+    //! each resumption of their coroutines
+    bool costs_accounted() const noexcept { return costs_accounted_; }
+
+    void set_costs_accounted(bool costs_accounted) noexcept { costs_accounted_ = costs_accounted; }
+
+    //! The latency beyond which the requests are logged along with their phases and costs, zero means disabled
+    std::chrono::milliseconds slow_request_threshold() const noexcept { return slow_request_threshold_; }
+
+    void set_slow_request_threshold(std::chrono::milliseconds threshold) noexcept { slow_request_threshold_ = threshold; }
+
+private:
+    using HistogramMap = PersistentHashMap<std::string, std::shared_ptr<Histograms>>;
+
+    //! Return the histograms for the method, creating them if missing
+    Histograms& histograms(const std::string& method);
+
+    std::atomic<std::shared_ptr<const HistogramMap>> snapshot_;
+    std::mutex mutex_;
+    LatencyHistogram write_;
+    bool costs_accounted_{false};
+    std::chrono::milliseconds slow_request_threshold_{0};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_LATENCY_HISTOGRAM_HPP_
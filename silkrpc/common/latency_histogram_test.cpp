@@ -0,0 +1,131 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "latency_histogram.hpp"
+
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+using namespace std::chrono_literals; // NOLINT(build/namespaces)
+
+TEST_CASE("LatencyHistogram::observe", "[silkrpc][common][latency_histogram]") {
+    LatencyHistogram histogram;
+    CHECK(histogram.count() == 0);
+    CHECK(histogram.cumulative_count(LatencyHistogram::kBucketBounds.size() - 1) == 0);
+
+    histogram.observe(50us);
+    histogram.observe(100us);
+    histogram.observe(101us);
+    histogram.observe(3ms);
+    histogram.observe(20s);
+    CHECK(histogram.count() == 5);
+    CHECK(histogram.sum() == 50us + 100us + 101us + 3ms + 20s);
+    CHECK(histogram.cumulative_count(0) == 0);
+    CHECK(histogram.cumulative_count(2) == 1);
+    CHECK(histogram.cumulative_count(3) == 2);
+    CHECK(histogram.cumulative_count(4) == 3);
+    CHECK(histogram.cumulative_count(7) == 3);
+    CHECK(histogram.cumulative_count(8) == 4);
+    // The observations above the last bound are counted only in the total
+    CHECK(histogram.cumulative_count(LatencyHistogram::kBucketBounds.size() - 1) == 4);
+}
+
+TEST_CASE("MethodLatencies::observe", "[silkrpc][common][latency_histogram]") {
+    MethodLatencies latencies;
+    CHECK(latencies.size() == 0);
+
+    latencies.observe("engine_newPayloadV1", 1ms);
+    latencies.observe("engine_forkchoiceUpdatedV1", 2ms);
+    latencies.observe("engine_newPayloadV1", 3ms);
+    CHECK(latencies.size() == 2);
+
+    std::vector<std::string> methods;
+    std::vector<uint64_t> counts;
+    latencies.for_each([&](const std::string& method, const MethodLatencies::Histograms& histograms) {
+        methods.push_back(method);
+        counts.push_back(histograms.total.count());
+        CHECK(histograms.phases[static_cast<std::size_t>(RequestPhase::parse)].count() == 0);
+    });
+    CHECK(methods == std::vector<std::string>{"engine_forkchoiceUpdatedV1", "engine_newPayloadV1"});
+    CHECK(counts == std::vector<uint64_t>{1, 2});
+}
+
+TEST_CASE("MethodLatencies::observe with profile", "[silkrpc][common][latency_histogram]") {
+    MethodLatencies latencies;
+    RequestProfile profile;
+    profile.add(RequestPhase::backend_io, 300us);
+    profile.add(RequestPhase::backend_io, 200us);
+    profile.add(RequestPhase::evm, 2ms);
+    CHECK(profile.elapsed(RequestPhase::backend_io) == 500us);
+    CHECK(profile.elapsed(RequestPhase::parse) == 0us);
+
+    latencies.observe("eth_call", 3ms, profile);
+    latencies.observe("eth_call", 1ms, RequestProfile{});
+    CHECK(latencies.size() == 1);
+    latencies.for_each([&](const std::string& method, const MethodLatencies::Histograms& histograms) {
+        CHECK(method == "eth_call");
+        CHECK(histograms.total.count() == 2);
+        CHECK(histograms.total.sum() == 4ms);
+        const auto& backend_io = histograms.phases[static_cast<std::size_t>(RequestPhase::backend_io)];
+        CHECK(backend_io.count() == 2);
+        CHECK(backend_io.sum() == 500us);
+        CHECK(histograms.phases[static_cast<std::size_t>(RequestPhase::evm)].sum() == 2ms);
+    });
+
+    latencies.observe_write(40us);
+    CHECK(latencies.write_latency().count() == 1);
+}
+
+TEST_CASE("MethodLatencies::observe with costs", "[silkrpc][common][latency_histogram]") {
+    MethodLatencies latencies;
+    RequestProfile profile;
+    profile.add_cost(700us, 1024);
+    profile.add_cost(300us, 512);
+    CHECK(profile.cpu_time() == 1ms);
+    CHECK(profile.allocated_bytes() == 1536);
+
+    SECTION("not accounted") {
+        latencies.observe("eth_call", 3ms, profile);
+        latencies.for_each([&](const std::string&, const MethodLatencies::Histograms& histograms) {
+            CHECK(histograms.cpu_time.count() == 0);
+            CHECK(histograms.allocated_bytes == 0);
+        });
+    }
+    SECTION("accounted") {
+        profile.set_costs_accounted(true);
+        latencies.observe("eth_call", 3ms, profile);
+        latencies.observe("eth_call", 3ms, profile);
+        latencies.for_each([&](const std::string&, const MethodLatencies::Histograms& histograms) {
+            CHECK(histograms.cpu_time.count() == 2);
+            CHECK(histograms.cpu_time.sum() == 2ms);
+            CHECK(histograms.allocated_bytes == 3072);
+        });
+    }
+}
+
+TEST_CASE("RequestPhase to_string", "[silkrpc][common][latency_histogram]") {
+    CHECK(to_string(RequestPhase::parse) == "parse");
+    CHECK(to_string(RequestPhase::queue) == "queue");
+    CHECK(to_string(RequestPhase::backend_io) == "backend_io");
+    CHECK(to_string(RequestPhase::evm) == "evm");
+    CHECK(to_string(RequestPhase::serialization) == "serialization");
+}
+
+} // namespace silkrpc
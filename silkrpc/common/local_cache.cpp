@@ -0,0 +1,29 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "local_cache.hpp"
+
+#include <atomic>
+
+namespace silkrpc {
+
+uint64_t make_local_cache_owner() {
+    static std::atomic<uint64_t> next_owner{1};
+    return next_owner.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace silkrpc
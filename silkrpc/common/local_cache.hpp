@@ -0,0 +1,90 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_COMMON_LOCAL_CACHE_HPP_
+#define SILKRPC_COMMON_LOCAL_CACHE_HPP_
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace silkrpc {
+
+//! Return a new owner id for the entries of the local caches, never returned before (zero marks the empty slots)
+uint64_t make_local_cache_owner();
+
+//! Small direct-mapped cache private to one thread, put in front of a shared cache (see BlockCache and CoherentStateCache)
+//! so that the hot keys are served without touching any lock or any memory written by other threads. Each execution
+//! context runs on one single thread, so a thread-local instance is the L1 cache of one context: no locking is needed.
+//! The entries are tagged with the owner, i.e. the shared cache they come from, and with its generation, so that they
+//! are invalidated all together just by advancing the generation and never served from another instance of the cache.
+//! Each key has just one slot, so it replaces any entry of an older generation or colliding key at once.
+template <typename Key, typename Value, typename Hash, std::size_t kNumSlots>
+class LocalCache {
+    static_assert(std::has_single_bit(kNumSlots), "the number of slots must be a power of 2");
+
+public:
+    LocalCache() : slots_(kNumSlots) {}
+
+    LocalCache(const LocalCache&) = delete;
+    LocalCache& operator=(const LocalCache&) = delete;
+
+    //! Return the value of the key stored by the owner at the generation, if any, or nullptr otherwise
+    const Value* find(uint64_t owner, uint64_t generation, const Key& key) const {
+        const auto& slot = slots_[index_of(key)];
+        if (slot.owner != owner || slot.generation != generation || !(slot.key == key)) {
+            return nullptr;
+        }
+        return &slot.value;
+    }
+
+    //! Store the value of the key read by the owner at the generation, replacing the entry in the same slot
+    void put(uint64_t owner, uint64_t generation, const Key& key, Value value) {
+        auto& slot = slots_[index_of(key)];
+        slot.owner = owner;
+        slot.generation = generation;
+        slot.key = key;
+        slot.value = std::move(value);
+    }
+
+    //! Drop all the entries, releasing their values
+    void clear() {
+        for (auto& slot : slots_) {
+            slot = Slot{};
+        }
+    }
+
+    static constexpr std::size_t num_slots() noexcept { return kNumSlots; }
+
+private:
+    struct Slot {
+        uint64_t owner{0};
+        uint64_t generation{0};
+        Key key{};
+        Value value{};
+    };
+
+    static std::size_t index_of(const Key& key) { return Hash{}(key) & (kNumSlots - 1); }
+
+    std::vector<Slot> slots_;
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_LOCAL_CACHE_HPP_
@@ -0,0 +1,104 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "local_cache.hpp"
+
+#include <string>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+struct IdentityHash {
+    std::size_t operator()(uint64_t key) const noexcept { return static_cast<std::size_t>(key); }
+};
+
+using TestLocalCache = LocalCache<uint64_t, std::string, IdentityHash, 4>;
+
+TEST_CASE("local cache owner ids are unique", "[silkrpc][common][local_cache]") {
+    const auto owner1 = make_local_cache_owner();
+    const auto owner2 = make_local_cache_owner();
+    CHECK(owner1 != 0);
+    CHECK(owner2 != 0);
+    CHECK(owner1 != owner2);
+}
+
+TEST_CASE("local cache find", "[silkrpc][common][local_cache]") {
+    const auto owner = make_local_cache_owner();
+    TestLocalCache cache;
+    CHECK(TestLocalCache::num_slots() == 4);
+
+    SECTION("empty cache") {
+        CHECK(cache.find(owner, 0, 0) == nullptr);
+        CHECK(cache.find(owner, 0, 1) == nullptr);
+    }
+
+    SECTION("same owner, generation and key") {
+        cache.put(owner, 1, 2, "two");
+        const auto* value = cache.find(owner, 1, 2);
+        REQUIRE(value != nullptr);
+        CHECK(*value == "two");
+    }
+
+    SECTION("other owner") {
+        cache.put(owner, 1, 2, "two");
+        CHECK(cache.find(make_local_cache_owner(), 1, 2) == nullptr);
+    }
+
+    SECTION("other generation") {
+        cache.put(owner, 1, 2, "two");
+        CHECK(cache.find(owner, 0, 2) == nullptr);
+        CHECK(cache.find(owner, 2, 2) == nullptr);
+    }
+
+    SECTION("colliding key replaces") {
+        cache.put(owner, 1, 2, "two");
+        cache.put(owner, 1, 6, "six");
+        CHECK(cache.find(owner, 1, 2) == nullptr);
+        const auto* value = cache.find(owner, 1, 6);
+        REQUIRE(value != nullptr);
+        CHECK(*value == "six");
+    }
+
+    SECTION("distinct slots") {
+        for (uint64_t key{0}; key < TestLocalCache::num_slots(); ++key) {
+            cache.put(owner, 1, key, std::to_string(key));
+        }
+        for (uint64_t key{0}; key < TestLocalCache::num_slots(); ++key) {
+            const auto* value = cache.find(owner, 1, key);
+            REQUIRE(value != nullptr);
+            CHECK(*value == std::to_string(key));
+        }
+    }
+
+    SECTION("newer generation replaces") {
+        cache.put(owner, 1, 2, "two");
+        cache.put(owner, 2, 2, "deux");
+        CHECK(cache.find(owner, 1, 2) == nullptr);
+        const auto* value = cache.find(owner, 2, 2);
+        REQUIRE(value != nullptr);
+        CHECK(*value == "deux");
+    }
+
+    SECTION("clear") {
+        cache.put(owner, 1, 2, "two");
+        cache.clear();
+        CHECK(cache.find(owner, 1, 2) == nullptr);
+    }
+}
+
+} // namespace silkrpc
@@ -16,13 +16,23 @@
 
 #include "log.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include <absl/strings/str_cat.h>
 #include <absl/time/clock.h>
 
 #include <silkrpc/common/tee.hpp>
+#include <silkrpc/concurrency/spsc_ring.hpp>
 
 namespace silkrpc {
 
@@ -30,6 +40,12 @@ constexpr char const kLogTags_[7][6] = {
     "TRACE", "DEBUG", "INFO ", "WARN ", "ERROR", "CRIT ", "NONE ",
 };
 
+//! Number of records buffered per thread in asynchronous mode before dropping
+constexpr std::size_t kLogRingCapacity{1024};
+
+//! Max time the background writer waits before draining the records below Warn level
+constexpr std::chrono::milliseconds kLogWriterInterval{10};
+
 teestream log_streams_{std::cerr, null_stream()};
 
 LogLevel log_verbosity_{LogLevel::Info};
@@ -38,15 +54,195 @@ bool log_thread_enabled_{false};
 // Log to one or two output streams - typically the console and optional log file.
 void log_set_streams_(std::ostream& o1, std::ostream& o2) { log_streams_.set_streams(o1.rdbuf(), o2.rdbuf()); }
 
-std::mutex log_::log_mtx_;
+namespace {
+
+struct LogRecord {
+    LogLevel level{LogLevel::None};
+    absl::Time time;
+    std::thread::id thread_id;
+    std::string message;
+};
+
+// Per-thread logging state: the ring buffer plus the token bucket of the rate limiter, both touched lock-free
+struct ThreadLog {
+    SpscRing<LogRecord> ring{kLogRingCapacity};
+    double tokens{0};
+    absl::Time last_refill{absl::InfinitePast()};
+    uint64_t dropped{0};
+};
+
+std::atomic<uint32_t> log_rate_limit_{kDefaultLogRateLimit};
+std::atomic<bool> log_async_enabled_{false};
+
+// Serializes the direct writes when no background writer is running, the async mode writes from the writer only
+std::mutex log_mtx_;
+
+// Registry of the per-thread rings, locked just when a thread logs for the first time and by the writer
+std::mutex log_registry_mtx_;
+std::vector<std::shared_ptr<ThreadLog>> log_registry_;
+
+std::mutex log_writer_mtx_;
+std::condition_variable log_writer_cv_;
+std::thread log_writer_;
+bool log_writer_stopping_{false};
+
+ThreadLog& this_thread_log() {
+    thread_local const std::shared_ptr<ThreadLog> thread_log = [] {
+        auto thread_log = std::make_shared<ThreadLog>();
+        std::scoped_lock lock{log_registry_mtx_};
+        log_registry_.push_back(thread_log);
+        return thread_log;
+    }();
+    return *thread_log;
+}
+
+// Nested statements (e.g. logging while evaluating an operand) get their own buffer
+thread_local std::vector<std::unique_ptr<std::ostringstream>> record_streams_;
+thread_local std::size_t record_depth_{0};
+
+std::ostream& acquire_record_stream() {
+    if (record_depth_ == record_streams_.size()) {
+        record_streams_.push_back(std::make_unique<std::ostringstream>());
+    }
+    auto& stream = *record_streams_[record_depth_++];
+    stream.str({});
+    stream.clear();
+    return stream;
+}
+
+bool admit(ThreadLog& thread_log, LogLevel level, absl::Time now) {
+    const auto rate_limit = log_rate_limit_.load(std::memory_order_relaxed);
+    if (rate_limit == 0 || level >= LogLevel::Warn) {
+        return true;
+    }
+    const auto elapsed_seconds = absl::ToDoubleSeconds(now - thread_log.last_refill);
+    thread_log.tokens = std::min(thread_log.tokens + elapsed_seconds * rate_limit, static_cast<double>(rate_limit));
+    thread_log.last_refill = now;
+    if (thread_log.tokens < 1) {
+        return false;
+    }
+    thread_log.tokens -= 1;
+    return true;
+}
+
+LogRecord make_dropped_record(const LogRecord& record, uint64_t dropped) {
+    return {LogLevel::Warn, record.time, record.thread_id, absl::StrCat(" log: ", dropped, " records dropped\n")};
+}
 
-std::ostream& log_::header_(LogLevel level) {
-    log_streams_ << kLogTags_[static_cast<int>(level)] << "["
-                 << absl::FormatTime("%m-%d|%H:%M:%E3S", absl::Now(), absl::LocalTimeZone()) << "]";
+void write_record(const LogRecord& record) {
+    log_streams_ << kLogTags_[static_cast<int>(record.level)] << "["
+                 << absl::FormatTime("%m-%d|%H:%M:%E3S", record.time, absl::LocalTimeZone()) << "]";
     if (log_thread_enabled_) {
-        log_streams_ << " " << std::this_thread::get_id();
+        log_streams_ << " " << record.thread_id;
     }
-    return log_streams_;
+    log_streams_ << record.message;
+}
+
+void emit(LogLevel level, std::string&& message) {
+    LogRecord record{level, absl::Now(), std::this_thread::get_id(), std::move(message)};
+    auto& thread_log = this_thread_log();
+    if (!admit(thread_log, level, record.time)) {
+        ++thread_log.dropped;
+        return;
+    }
+    if (log_async_enabled_.load(std::memory_order_acquire)) {
+        if (thread_log.dropped > 0 && thread_log.ring.available() >= 2) {
+            thread_log.ring.push(make_dropped_record(record, thread_log.dropped));
+            thread_log.dropped = 0;
+        }
+        if (!thread_log.ring.push(std::move(record))) {
+            ++thread_log.dropped;
+        } else if (level >= LogLevel::Warn) {
+            log_writer_cv_.notify_one();
+        }
+        return;
+    }
+    std::scoped_lock lock{log_mtx_};
+    if (thread_log.dropped > 0) {
+        write_record(make_dropped_record(record, thread_log.dropped));
+        thread_log.dropped = 0;
+    }
+    write_record(record);
+}
+
+// Write the records buffered by all threads in timestamp order, forgetting the rings of the exited threads
+bool drain_records(std::vector<LogRecord>& records) {
+    {
+        std::scoped_lock lock{log_registry_mtx_};
+        for (auto it = log_registry_.begin(); it != log_registry_.end();) {
+            (*it)->ring.drain(records);
+            if (it->use_count() == 1 && (*it)->ring.empty()) {
+                it = log_registry_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    if (records.empty()) {
+        return false;
+    }
+    std::stable_sort(records.begin(), records.end(), [](const auto& r1, const auto& r2) { return r1.time < r2.time; });
+    std::scoped_lock lock{log_mtx_};
+    for (const auto& record : records) {
+        write_record(record);
+    }
+    log_streams_.flush();
+    records.clear();
+    return true;
+}
+
+void run_writer() {
+    std::vector<LogRecord> records;
+    records.reserve(kLogRingCapacity);
+    std::unique_lock lock{log_writer_mtx_};
+    while (!log_writer_stopping_) {
+        lock.unlock();
+        const auto drained = drain_records(records);
+        lock.lock();
+        if (!drained) {
+            log_writer_cv_.wait_for(lock, kLogWriterInterval);
+        }
+    }
+    lock.unlock();
+    drain_records(records);
+}
+
+} // namespace
+
+// Enable or disable the background writer: disabling drains the buffered records before returning
+void log_set_async_(bool enabled) {
+    std::unique_lock lock{log_writer_mtx_};
+    if (enabled == log_writer_.joinable()) {
+        return;
+    }
+    if (enabled) {
+        log_writer_stopping_ = false;
+        log_writer_ = std::thread{run_writer};
+        log_async_enabled_.store(true, std::memory_order_release);
+    } else {
+        log_async_enabled_.store(false, std::memory_order_release);
+        log_writer_stopping_ = true;
+        lock.unlock();
+        log_writer_cv_.notify_one();
+        log_writer_.join();
+        std::vector<LogRecord> records;
+        drain_records(records);
+    }
+}
+
+// Stop the background writer still running at exit, if any, so that the buffered records are not lost
+static const struct LogWriterGuard {
+    ~LogWriterGuard() { log_set_async_(false); }
+} log_writer_guard_;
+
+void log_set_rate_limit_(uint32_t records_per_second) { log_rate_limit_.store(records_per_second, std::memory_order_relaxed); }
+
+log_::log_(LogLevel level) : level_(level), stream_(acquire_record_stream()) {}
+
+log_::~log_() {
+    auto& stream = static_cast<std::ostringstream&>(stream_);
+    --record_depth_;
+    emit(level_, stream.str());
 }
 
 std::ostream& null_stream() {
@@ -17,7 +17,8 @@
 #ifndef SILKRPC_COMMON_LOG_HPP_
 #define SILKRPC_COMMON_LOG_HPP_
 
-#include <mutex>
+#include <cstdint>
+#include <ostream>
 #include <string>
 
 #include <absl/strings/string_view.h>
@@ -37,19 +38,30 @@ std::ostream& null_stream();
 extern LogLevel log_verbosity_;
 extern bool log_thread_enabled_;
 void log_set_streams_(std::ostream& o1, std::ostream& o2);
+void log_set_async_(bool enabled);
+void log_set_rate_limit_(uint32_t records_per_second);
+
+//! Max log records per second and per thread below Warn level, the exceeding ones are dropped and counted
+constexpr uint32_t kDefaultLogRateLimit{10'000};
+
+// Each statement is formatted into a thread-local buffer and emitted as one record when complete: records are either
+// written directly or, in asynchronous mode, pushed into a per-thread ring buffer drained by a background writer
 class log_ {
   public:
-    explicit log_(LogLevel level) : level_(level) { log_mtx_.lock(); }
-    ~log_() { log_mtx_.unlock(); }
-    std::ostream& header_(LogLevel);
+    explicit log_(LogLevel level);
+    ~log_();
+
+    log_(const log_&) = delete;
+    log_& operator=(const log_&) = delete;
+
     template <class T>
     std::ostream& operator<<(const T& message) {
-        return header_(level_) << message;
+        return stream_ << message;
     }
 
   private:
     LogLevel level_;
-    static std::mutex log_mtx_;
+    std::ostream& stream_;
 };
 
 using Logger = log_;
@@ -75,4 +87,8 @@ std::string AbslUnparseFlag(LogLevel level);
 
 #define SILKRPC_LOG_STREAMS(stream1_, stream2_) silkrpc::log_set_streams_((stream1_), (stream2_))
 
+#define SILKRPC_LOG_ASYNC(async_) silkrpc::log_set_async_((async_))
+
+#define SILKRPC_LOG_RATE_LIMIT(rate_) silkrpc::log_set_rate_limit_((rate_))
+
 #endif  // SILKRPC_COMMON_LOG_HPP_
@@ -16,6 +16,8 @@
 
 #include "log.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <sstream>
 #include <string>
 #include <thread>
@@ -171,5 +173,88 @@ TEST_CASE("SILKRPC_LOG_THREAD macro enables/disables thread tracing", "[silkrpc]
     CHECK(ss2.str().find(thread_id_stream.str()) == std::string::npos);
 }
 
+TEST_CASE("nested LOG statements are emitted as separate records", "[silkrpc][common][log]") {
+    std::stringstream ss;
+    SILKRPC_LOG_STREAMS(ss, null_stream());
+    SILKRPC_LOG_VERBOSITY(LogLevel::Info);
+    const auto nested = [] {
+        SILKRPC_INFO << "inner\n";
+        return "outer";
+    };
+    SILKRPC_INFO << nested() << "\n";
+    const auto content = ss.str();
+    CHECK(content.find("inner") != std::string::npos);
+    CHECK(content.find("outer") != std::string::npos);
+    CHECK(content.find("inner") < content.find("outer"));
+}
+
+TEST_CASE("SILKRPC_LOG_ASYNC macro writes records from all threads", "[silkrpc][common][log]") {
+    std::stringstream ss;
+    SILKRPC_LOG_STREAMS(ss, null_stream());
+    SILKRPC_LOG_VERBOSITY(LogLevel::Info);
+    SILKRPC_LOG_ASYNC(true);
+    std::vector<std::thread> threads;
+    for (auto t{0}; t < 4; ++t) {
+        threads.emplace_back([t]() {
+            for (auto i{0}; i < 100; ++i) {
+                SILKRPC_INFO << "thread " << t << " record " << i << "\n";
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    SILKRPC_LOG_ASYNC(false);
+    const auto content = ss.str();
+    CHECK(std::count(content.begin(), content.end(), '\n') == 400);
+    CHECK(content.find("thread 3 record 99\n") != std::string::npos);
+    CHECK(content.find("dropped") == std::string::npos);
+}
+
+TEST_CASE("SILKRPC_LOG_RATE_LIMIT macro drops the exceeding records below Warn", "[silkrpc][common][log]") {
+    std::stringstream ss;
+    SILKRPC_LOG_STREAMS(ss, null_stream());
+    SILKRPC_LOG_VERBOSITY(LogLevel::Info);
+    SILKRPC_LOG_RATE_LIMIT(5);
+
+    SECTION("in direct mode") {
+        std::thread{[]() {
+            for (auto i{0}; i < 100; ++i) {
+                SILKRPC_INFO << "info\n";
+                SILKRPC_WARN << "warn\n";
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds{500});
+            SILKRPC_INFO << "last\n";
+        }}.join();
+    }
+    SECTION("in asynchronous mode") {
+        SILKRPC_LOG_ASYNC(true);
+        std::thread{[]() {
+            for (auto i{0}; i < 100; ++i) {
+                SILKRPC_INFO << "info\n";
+                SILKRPC_WARN << "warn\n";
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds{500});
+            SILKRPC_INFO << "last\n";
+        }}.join();
+        SILKRPC_LOG_ASYNC(false);
+    }
+
+    SILKRPC_LOG_RATE_LIMIT(kDefaultLogRateLimit);
+    const auto content = ss.str();
+    std::size_t info_count{0};
+    std::size_t warn_count{0};
+    for (auto pos = content.find("info\n"); pos != std::string::npos; pos = content.find("info\n", pos + 1)) {
+        ++info_count;
+    }
+    for (auto pos = content.find("warn\n"); pos != std::string::npos; pos = content.find("warn\n", pos + 1)) {
+        ++warn_count;
+    }
+    CHECK(info_count <= 6);
+    CHECK(warn_count == 100);
+    CHECK(content.find("records dropped") != std::string::npos);
+    CHECK(content.find("last") != std::string::npos);
+}
+
 } // namespace silkrpc
 
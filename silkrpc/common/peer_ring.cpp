@@ -0,0 +1,108 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "peer_ring.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+
+namespace silkrpc {
+
+namespace {
+
+//! 64-bit FNV-1a, which is fully specified so that the ring is the same on all the replicas whatever their build
+uint64_t fnv1a(const void* data, std::size_t size, uint64_t hash = 0xcbf29ce484222325) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (std::size_t i{0}; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+//! Spread the bits of the FNV-1a hash (finalizer of MurmurHash3), whose outputs for similar inputs are close otherwise
+uint64_t mix(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccd;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+} // namespace
+
+std::vector<PeerEndpoint> PeerRing::parse_peers(const std::string& peers_spec) {
+    std::vector<PeerEndpoint> peers;
+    std::string_view remaining{peers_spec};
+    while (!remaining.empty()) {
+        const auto separator = remaining.find(',');
+        const auto item = remaining.substr(0, separator);
+        remaining = separator == std::string_view::npos ? std::string_view{} : remaining.substr(separator + 1);
+
+        const auto colon = item.rfind(':');
+        if (colon == std::string_view::npos || colon == 0 || colon == item.size() - 1) {
+            throw std::invalid_argument{"invalid peers: " + peers_spec};
+        }
+        const auto port = item.substr(colon + 1);
+        if (!std::all_of(port.begin(), port.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            throw std::invalid_argument{"invalid peers: " + peers_spec};
+        }
+        PeerEndpoint peer{std::string{item.substr(0, colon)}, std::string{port}};
+        if (std::find(peers.begin(), peers.end(), peer) != peers.end()) {
+            throw std::invalid_argument{"repeated peer " + peer.to_string() + " in peers: " + peers_spec};
+        }
+        peers.push_back(std::move(peer));
+    }
+    return peers;
+}
+
+PeerRing::PeerRing(std::vector<PeerEndpoint> peers, const PeerEndpoint& self, std::size_t virtual_nodes) : peers_{std::move(peers)} {
+    const auto self_it = std::find(peers_.begin(), peers_.end(), self);
+    if (self_it == peers_.end()) {
+        throw std::invalid_argument{"peer " + self.to_string() + " not among the peers"};
+    }
+    self_index_ = static_cast<std::size_t>(self_it - peers_.begin());
+
+    virtual_nodes = std::max<std::size_t>(virtual_nodes, 1);
+    points_.reserve(peers_.size() * virtual_nodes);
+    for (std::size_t i{0}; i < peers_.size(); ++i) {
+        const auto endpoint = peers_[i].to_string();
+        const auto endpoint_hash = fnv1a(endpoint.data(), endpoint.size());
+        for (uint64_t node{0}; node < virtual_nodes; ++node) {
+            // Little-endian whatever the host, as the rest of the hashed bytes
+            uint8_t node_bytes[sizeof(node)];
+            for (std::size_t j{0}; j < sizeof(node); ++j) {
+                node_bytes[j] = static_cast<uint8_t>(node >> (8 * j));
+            }
+            points_.emplace_back(mix(fnv1a(node_bytes, sizeof(node_bytes), endpoint_hash)), i);
+        }
+    }
+    std::sort(points_.begin(), points_.end());
+}
+
+std::size_t PeerRing::owner_of(silkworm::ByteView key) const {
+    const auto point = mix(fnv1a(key.data(), key.size()));
+    auto it = std::lower_bound(points_.begin(), points_.end(), std::make_pair(point, std::size_t{0}));
+    if (it == points_.end()) {
+        it = points_.begin();
+    }
+    return it->second;
+}
+
+} // namespace silkrpc
@@ -0,0 +1,81 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_COMMON_PEER_RING_HPP_
+#define SILKRPC_COMMON_PEER_RING_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <silkworm/common/base.hpp>
+
+namespace silkrpc {
+
+//! The location of one replica of the daemon serving the JSON RPC API over HTTP
+struct PeerEndpoint {
+    std::string host;
+    std::string port;
+
+    std::string to_string() const { return host + ":" + port; }
+};
+
+inline bool operator==(const PeerEndpoint& lhs, const PeerEndpoint& rhs) {
+    return lhs.host == rhs.host && lhs.port == rhs.port;
+}
+
+//! Consistent hashing of the routing keys (block hashes, addresses) over the replicas of the daemon, so that the requests
+//! scoped to the same block or account are served by the same replica and the caches of each replica hold a distinct
+//! shard of the hot set. Each replica is placed at many points of the ring (i.e. virtual nodes), so that the keys are
+//! spread evenly and adding or removing one replica moves just its share of them. The points are derived only from the
+//! endpoints, hence all the replicas configured with the same peers agree on the owner of each key.
+class PeerRing {
+public:
+    //! The default number of points of each replica on the ring
+    static constexpr std::size_t kDefaultVirtualNodes{128};
+
+    //! Parse the comma-separated list of peers like "host1:8545,host2:8545"
+    //! \throws std::invalid_argument if any endpoint is malformed or repeated
+    static std::vector<PeerEndpoint> parse_peers(const std::string& peers_spec);
+
+    //! Build the ring of the peers, the local replica being the one at self
+    //! \throws std::invalid_argument if there are no peers or self is not among them
+    PeerRing(std::vector<PeerEndpoint> peers, const PeerEndpoint& self, std::size_t virtual_nodes = kDefaultVirtualNodes);
+
+    //! Return the index of the peer owning the routing key
+    std::size_t owner_of(silkworm::ByteView key) const;
+
+    //! Return true if the routing key is owned by the local replica
+    bool is_local(silkworm::ByteView key) const { return owner_of(key) == self_index_; }
+
+    const std::vector<PeerEndpoint>& peers() const noexcept { return peers_; }
+
+    std::size_t self_index() const noexcept { return self_index_; }
+
+private:
+    std::vector<PeerEndpoint> peers_;
+    std::size_t self_index_{0};
+
+    //! The points of the ring in ascending order, each one with the index of its peer
+    std::vector<std::pair<uint64_t, std::size_t>> points_;
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_PEER_RING_HPP_
@@ -0,0 +1,115 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "peer_ring.hpp"
+
+#include <map>
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+static silkworm::Bytes make_key(uint32_t n) {
+    silkworm::Bytes key(20, 0);
+    key[16] = static_cast<uint8_t>(n >> 24);
+    key[17] = static_cast<uint8_t>(n >> 16);
+    key[18] = static_cast<uint8_t>(n >> 8);
+    key[19] = static_cast<uint8_t>(n);
+    return key;
+}
+
+TEST_CASE("PeerRing::parse_peers", "[silkrpc][common][peer_ring]") {
+    SECTION("empty") {
+        CHECK(PeerRing::parse_peers("").empty());
+    }
+
+    SECTION("valid") {
+        const auto peers = PeerRing::parse_peers("10.0.0.1:8545,rpc2:8546");
+        REQUIRE(peers.size() == 2);
+        CHECK(peers[0] == PeerEndpoint{"10.0.0.1", "8545"});
+        CHECK(peers[1] == PeerEndpoint{"rpc2", "8546"});
+        CHECK(peers[1].to_string() == "rpc2:8546");
+    }
+
+    SECTION("invalid") {
+        CHECK_THROWS_AS(PeerRing::parse_peers("rpc1"), std::invalid_argument);
+        CHECK_THROWS_AS(PeerRing::parse_peers(":8545"), std::invalid_argument);
+        CHECK_THROWS_AS(PeerRing::parse_peers("rpc1:"), std::invalid_argument);
+        CHECK_THROWS_AS(PeerRing::parse_peers("rpc1:85a5"), std::invalid_argument);
+        CHECK_THROWS_AS(PeerRing::parse_peers("rpc1:8545,rpc1:8545"), std::invalid_argument);
+    }
+}
+
+TEST_CASE("PeerRing::PeerRing", "[silkrpc][common][peer_ring]") {
+    const auto peers = PeerRing::parse_peers("rpc1:8545,rpc2:8545,rpc3:8545");
+    CHECK_THROWS_AS(PeerRing(peers, PeerEndpoint{"rpc4", "8545"}), std::invalid_argument);
+    CHECK_THROWS_AS(PeerRing({}, PeerEndpoint{"rpc1", "8545"}), std::invalid_argument);
+
+    const PeerRing ring{peers, PeerEndpoint{"rpc2", "8545"}};
+    CHECK(ring.peers() == peers);
+    CHECK(ring.self_index() == 1);
+}
+
+TEST_CASE("PeerRing::owner_of", "[silkrpc][common][peer_ring]") {
+    const auto peers = PeerRing::parse_peers("rpc1:8545,rpc2:8545,rpc3:8545");
+    const PeerRing ring1{peers, peers[0]};
+    const PeerRing ring3{peers, peers[2]};
+    constexpr uint32_t kNumKeys{3000};
+
+    SECTION("single peer owns all the keys") {
+        const PeerRing single_ring{{peers[0]}, peers[0]};
+        for (uint32_t n{0}; n < 100; ++n) {
+            CHECK(single_ring.is_local(make_key(n)));
+        }
+    }
+
+    SECTION("all the replicas agree on the owners") {
+        for (uint32_t n{0}; n < kNumKeys; ++n) {
+            const auto key = make_key(n);
+            CHECK(ring1.owner_of(key) == ring3.owner_of(key));
+            CHECK(ring1.is_local(key) == (ring1.owner_of(key) == 0));
+        }
+    }
+
+    SECTION("keys spread evenly") {
+        std::map<std::size_t, uint32_t> num_owned;
+        for (uint32_t n{0}; n < kNumKeys; ++n) {
+            ++num_owned[ring1.owner_of(make_key(n))];
+        }
+        REQUIRE(num_owned.size() == peers.size());
+        for (const auto& [_, count] : num_owned) {
+            CHECK(count > kNumKeys / peers.size() / 2);
+            CHECK(count < kNumKeys / peers.size() * 3 / 2);
+        }
+    }
+
+    SECTION("removing one peer moves just its keys") {
+        const PeerRing smaller_ring{{peers[0], peers[2]}, peers[0]};
+        for (uint32_t n{0}; n < kNumKeys; ++n) {
+            const auto key = make_key(n);
+            const auto owner = ring1.owner_of(key);
+            if (owner == 0) {
+                CHECK(smaller_ring.owner_of(key) == 0);
+            } else if (owner == 2) {
+                CHECK(smaller_ring.owner_of(key) == 1);
+            }
+        }
+    }
+}
+
+} // namespace silkrpc
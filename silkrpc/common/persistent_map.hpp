@@ -0,0 +1,251 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_PERSISTENT_MAP_HPP_
+#define SILKRPC_COMMON_PERSISTENT_MAP_HPP_
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace silkrpc {
+
+//! Persistent hash map implemented as a Hash Array Mapped Trie (HAMT) with path copying: nodes are immutable and shared
+//! among all the copies, so copying the map is O(1) and each update copies just the O(log32 N) nodes on the key path.
+//! A copy is a consistent snapshot: it can be read by any thread without synchronization while the original is updated.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class PersistentHashMap {
+public:
+    PersistentHashMap() = default;
+
+    //! Return a pointer to the value for the given key, if any, or nullptr otherwise: it is valid as long as this map
+    const Value* find(const Key& key) const {
+        const Node* node = root_.get();
+        const uint64_t hash = Hash{}(key);
+        for (std::size_t depth{0}; node != nullptr; ++depth) {
+            if (depth == kMaxDepth) {
+                for (const auto& leaf : node->collisions) {
+                    if (leaf->first == key) {
+                        return &leaf->second;
+                    }
+                }
+                return nullptr;
+            }
+            const auto bit = bit_at(hash, depth);
+            if ((node->bitmap & bit) == 0) {
+                return nullptr;
+            }
+            const auto& slot = node->slots[index_of(node->bitmap, bit)];
+            if (slot.leaf) {
+                return slot.leaf->first == key ? &slot.leaf->second : nullptr;
+            }
+            node = slot.child.get();
+        }
+        return nullptr;
+    }
+
+    bool contains(const Key& key) const { return find(key) != nullptr; }
+
+    //! Insert the key-value pair or replace the value of an existing key, returning true if inserted
+    bool insert_or_assign(const Key& key, const Value& value) {
+        bool inserted{false};
+        const uint64_t hash = Hash{}(key);
+        root_ = insert(root_, hash, std::make_shared<const Leaf>(key, value), 0, inserted);
+        if (inserted) {
+            ++size_;
+        }
+        return inserted;
+    }
+
+    //! Erase the key, if any, returning the number of erased elements
+    std::size_t erase(const Key& key) {
+        bool erased{false};
+        root_ = erase(root_, Hash{}(key), key, 0, erased);
+        if (erased) {
+            --size_;
+            return 1;
+        }
+        return 0;
+    }
+
+    //! Apply the function to each key-value pair, in no particular order
+    template <typename F>
+    void for_each(F&& f) const {
+        for_each(root_.get(), f);
+    }
+
+    std::size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+    void clear() {
+        root_.reset();
+        size_ = 0;
+    }
+
+private:
+    using Leaf = std::pair<const Key, Value>;
+    using LeafPtr = std::shared_ptr<const Leaf>;
+
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    struct Slot {
+        //! Either a leaf or a child node
+        LeafPtr leaf;
+        NodePtr child;
+        uint64_t hash{0};
+    };
+
+    struct Node {
+        //! The bits present among the 32 values of the hash fragment at this depth
+        uint32_t bitmap{0};
+        //! The slots of the present bits, in bit order
+        std::vector<Slot> slots;
+        //! The leaves with the whole hash colliding, used only at max depth
+        std::vector<LeafPtr> collisions;
+    };
+
+    static constexpr std::size_t kBitsPerLevel{5};
+    static constexpr std::size_t kMaxDepth{(64 + kBitsPerLevel - 1) / kBitsPerLevel};
+
+    static uint32_t bit_at(uint64_t hash, std::size_t depth) {
+        return uint32_t{1} << ((hash >> (depth * kBitsPerLevel)) & 0x1f);
+    }
+
+    static std::size_t index_of(uint32_t bitmap, uint32_t bit) {
+        return static_cast<std::size_t>(std::popcount(bitmap & (bit - 1)));
+    }
+
+    static NodePtr insert(const NodePtr& node, uint64_t hash, LeafPtr leaf, std::size_t depth, bool& inserted) {
+        auto copy = node ? std::make_shared<Node>(*node) : std::make_shared<Node>();
+        if (depth == kMaxDepth) {
+            for (auto& collision : copy->collisions) {
+                if (collision->first == leaf->first) {
+                    collision = std::move(leaf);
+                    return copy;
+                }
+            }
+            copy->collisions.push_back(std::move(leaf));
+            inserted = true;
+            return copy;
+        }
+
+        const auto bit = bit_at(hash, depth);
+        const auto index = index_of(copy->bitmap, bit);
+        if ((copy->bitmap & bit) == 0) {
+            copy->slots.insert(copy->slots.begin() + static_cast<std::ptrdiff_t>(index), Slot{std::move(leaf), nullptr, hash});
+            copy->bitmap |= bit;
+            inserted = true;
+            return copy;
+        }
+
+        auto& slot = copy->slots[index];
+        if (slot.leaf) {
+            if (slot.leaf->first == leaf->first) {
+                slot.leaf = std::move(leaf);
+                return copy;
+            }
+            // Push down both the existing leaf and the new one into a new child node
+            bool ignored{false};
+            auto child = insert(nullptr, slot.hash, std::move(slot.leaf), depth + 1, ignored);
+            slot.child = insert(child, hash, std::move(leaf), depth + 1, inserted);
+            slot.leaf.reset();
+            return copy;
+        }
+        slot.child = insert(slot.child, hash, std::move(leaf), depth + 1, inserted);
+        return copy;
+    }
+
+    static NodePtr erase(const NodePtr& node, uint64_t hash, const Key& key, std::size_t depth, bool& erased) {
+        if (!node) {
+            return node;
+        }
+        if (depth == kMaxDepth) {
+            for (std::size_t i{0}; i < node->collisions.size(); ++i) {
+                if (node->collisions[i]->first == key) {
+                    erased = true;
+                    if (node->collisions.size() == 1) {
+                        return nullptr;
+                    }
+                    auto copy = std::make_shared<Node>(*node);
+                    copy->collisions.erase(copy->collisions.begin() + static_cast<std::ptrdiff_t>(i));
+                    return copy;
+                }
+            }
+            return node;
+        }
+
+        const auto bit = bit_at(hash, depth);
+        if ((node->bitmap & bit) == 0) {
+            return node;
+        }
+        const auto index = index_of(node->bitmap, bit);
+        const auto& slot = node->slots[index];
+        NodePtr new_child;
+        if (slot.leaf) {
+            if (slot.leaf->first != key) {
+                return node;
+            }
+            erased = true;
+        } else {
+            new_child = erase(slot.child, hash, key, depth + 1, erased);
+            if (!erased) {
+                return node;
+            }
+        }
+
+        if (!new_child && node->slots.size() == 1) {
+            return nullptr;
+        }
+        auto copy = std::make_shared<Node>(*node);
+        if (new_child) {
+            copy->slots[index].child = std::move(new_child);
+        } else {
+            copy->slots.erase(copy->slots.begin() + static_cast<std::ptrdiff_t>(index));
+            copy->bitmap &= ~bit;
+        }
+        return copy;
+    }
+
+    template <typename F>
+    static void for_each(const Node* node, F& f) {
+        if (node == nullptr) {
+            return;
+        }
+        for (const auto& slot : node->slots) {
+            if (slot.leaf) {
+                f(slot.leaf->first, slot.leaf->second);
+            } else {
+                for_each(slot.child.get(), f);
+            }
+        }
+        for (const auto& leaf : node->collisions) {
+            f(leaf->first, leaf->second);
+        }
+    }
+
+    NodePtr root_;
+    std::size_t size_{0};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_PERSISTENT_MAP_HPP_
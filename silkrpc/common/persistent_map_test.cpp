@@ -0,0 +1,111 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "persistent_map.hpp"
+
+#include <map>
+#include <random>
+#include <string>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+struct ConstantHash {
+    std::size_t operator()(int) const { return 42; }
+};
+
+TEST_CASE("PersistentHashMap empty", "[silkrpc][common][persistent_map]") {
+    PersistentHashMap<int, std::string> map;
+    CHECK(map.empty());
+    CHECK(map.size() == 0);
+    CHECK(map.find(1) == nullptr);
+    CHECK(map.erase(1) == 0);
+}
+
+TEST_CASE("PersistentHashMap insert, replace and erase", "[silkrpc][common][persistent_map]") {
+    PersistentHashMap<int, std::string> map;
+    CHECK(map.insert_or_assign(1, "one"));
+    CHECK(map.insert_or_assign(2, "two"));
+    CHECK(!map.insert_or_assign(1, "uno"));
+    CHECK(map.size() == 2);
+    CHECK(*map.find(1) == "uno");
+    CHECK(*map.find(2) == "two");
+
+    CHECK(map.erase(1) == 1);
+    CHECK(map.erase(1) == 0);
+    CHECK(map.size() == 1);
+    CHECK(!map.contains(1));
+    CHECK(map.contains(2));
+}
+
+TEST_CASE("PersistentHashMap copies are snapshots", "[silkrpc][common][persistent_map]") {
+    PersistentHashMap<int, int> map;
+    for (int i{0}; i < 1000; ++i) {
+        map.insert_or_assign(i, i);
+    }
+    const auto snapshot = map;
+    for (int i{0}; i < 1000; i += 2) {
+        map.erase(i);
+    }
+    map.insert_or_assign(1, -1);
+
+    CHECK(snapshot.size() == 1000);
+    CHECK(map.size() == 500);
+    CHECK(*snapshot.find(1) == 1);
+    CHECK(*map.find(1) == -1);
+    CHECK(snapshot.contains(0));
+    CHECK(!map.contains(0));
+}
+
+TEST_CASE("PersistentHashMap full hash collisions", "[silkrpc][common][persistent_map]") {
+    PersistentHashMap<int, int, ConstantHash> map;
+    for (int i{0}; i < 10; ++i) {
+        CHECK(map.insert_or_assign(i, i * 10));
+    }
+    CHECK(!map.insert_or_assign(3, 33));
+    CHECK(map.size() == 10);
+    CHECK(*map.find(3) == 33);
+    CHECK(*map.find(9) == 90);
+    for (int i{0}; i < 10; ++i) {
+        CHECK(map.erase(i) == 1);
+    }
+    CHECK(map.empty());
+    CHECK(map.find(3) == nullptr);
+}
+
+TEST_CASE("PersistentHashMap matches std::map", "[silkrpc][common][persistent_map]") {
+    PersistentHashMap<uint64_t, uint64_t> map;
+    std::map<uint64_t, uint64_t> expected;
+    std::mt19937_64 generator{0};
+    for (int i{0}; i < 20000; ++i) {
+        const uint64_t key = generator() % 5000;
+        if (generator() % 3 == 0) {
+            CHECK(map.erase(key) == expected.erase(key));
+        } else {
+            CHECK(map.insert_or_assign(key, i) == expected.insert_or_assign(key, i).second);
+        }
+    }
+    CHECK(map.size() == expected.size());
+    std::size_t visited{0};
+    map.for_each([&](const uint64_t& key, const uint64_t& value) {
+        CHECK(expected.at(key) == value);
+        ++visited;
+    });
+    CHECK(visited == expected.size());
+}
+
+} // namespace silkrpc
@@ -0,0 +1,32 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "receipt_cache.hpp"
+
+namespace silkrpc {
+
+std::size_t ReceiptCache::approximate_size(const Receipts& receipts) {
+    std::size_t size{sizeof(Receipts)};
+    for (const auto& receipt : receipts) {
+        size += sizeof(Receipt);
+        for (const auto& log : receipt.logs) {
+            size += sizeof(Log) + log.topics.size() * sizeof(evmc::bytes32) + log.data.size();
+        }
+    }
+    return size;
+}
+
+} // namespace silkrpc
@@ -0,0 +1,50 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_RECEIPT_CACHE_HPP_
+#define SILKRPC_COMMON_RECEIPT_CACHE_HPP_
+
+#include <cstddef>
+#include <memory>
+
+#include <silkrpc/common/disk_cache.hpp>
+#include <silkrpc/common/sharded_cache.hpp>
+#include <silkrpc/types/receipt.hpp>
+
+namespace silkrpc {
+
+//! Cache of decoded block receipts by block hash, bounded by the approximate memory footprint of the receipts (see ShardedCache).
+class ReceiptCache : public ShardedCache<Receipts> {
+public:
+    //! The default memory budget in bytes
+    static constexpr std::size_t kDefaultMaxBytes{64 * 1024 * 1024};
+
+    explicit ReceiptCache(std::size_t max_bytes = kDefaultMaxBytes, bool shared_cache = true, std::size_t num_shards = kDefaultNumShards)
+    : ShardedCache{&ReceiptCache::approximate_size, max_bytes, shared_cache, num_shards} {}
+
+    //! Return the approximate memory footprint of the receipts, including their logs
+    static std::size_t approximate_size(const Receipts& receipts);
+
+    //! The on-disk secondary tier of the receipts evicted from memory, if any (see DiskCache)
+    std::shared_ptr<DiskCache>& disk_cache() noexcept { return disk_cache_; }
+
+private:
+    std::shared_ptr<DiskCache> disk_cache_;
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_RECEIPT_CACHE_HPP_
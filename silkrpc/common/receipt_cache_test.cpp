@@ -0,0 +1,66 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "receipt_cache.hpp"
+
+#include <memory>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+using evmc::literals::operator""_bytes32;
+
+TEST_CASE("receipt cache get and insert", "[silkrpc][common][receipt_cache]") {
+    evmc::bytes32 bh1{0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    ReceiptCache receipt_cache;
+    CHECK(!receipt_cache.get(bh1));
+
+    const auto receipts = std::make_shared<const Receipts>(Receipts{Receipt{}, Receipt{}});
+    receipt_cache.insert(bh1, receipts);
+
+    CHECK(receipt_cache.get(bh1) == receipts);
+    CHECK(receipt_cache.size() == 1);
+    CHECK(receipt_cache.size_bytes() == ReceiptCache::approximate_size(*receipts));
+}
+
+TEST_CASE("receipt cache approximate size accounts for logs", "[silkrpc][common][receipt_cache]") {
+    Receipts receipts{Receipt{}};
+    const auto no_logs_size = ReceiptCache::approximate_size(receipts);
+    CHECK(no_logs_size >= sizeof(Receipt));
+
+    Log log{};
+    log.topics.resize(2);
+    log.data.resize(100);
+    receipts[0].logs.push_back(log);
+    CHECK(ReceiptCache::approximate_size(receipts) == no_logs_size + sizeof(Log) + 2 * sizeof(evmc::bytes32) + 100);
+}
+
+TEST_CASE("receipt cache evicts within budget", "[silkrpc][common][receipt_cache]") {
+    evmc::bytes32 bh1{0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    evmc::bytes32 bh2{0x474f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    const Receipts receipts{Receipt{}};
+    ReceiptCache receipt_cache{ReceiptCache::approximate_size(receipts), false, 1};
+
+    receipt_cache.insert(bh1, std::make_shared<const Receipts>(receipts));
+    receipt_cache.insert(bh2, std::make_shared<const Receipts>(receipts));
+
+    CHECK(receipt_cache.size() == 1);
+    CHECK(!receipt_cache.get(bh1));
+    CHECK(receipt_cache.get(bh2));
+}
+
+} // namespace silkrpc
@@ -0,0 +1,91 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "reply_cache.hpp"
+
+#include <utility>
+
+namespace silkrpc {
+
+ReplyCache::Content ReplyCache::find(const std::string& key) {
+    std::lock_guard lock{mutex_};
+    const auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return nullptr;
+    }
+    recency_.splice(recency_.begin(), recency_, it->second.recency);
+    return it->second.content;
+}
+
+void ReplyCache::store(const std::string& key, Content content, uint64_t block_number, uint64_t generation) {
+    const auto size_bytes = key.size() + content->size();
+
+    std::lock_guard lock{mutex_};
+    if (generation != generation_ || size_bytes > max_bytes_) {
+        return;
+    }
+    if (entries_.contains(key)) {
+        remove(key);
+    }
+    while (used_bytes_ + size_bytes > max_bytes_) {
+        remove(*recency_.back());
+    }
+
+    const auto it = entries_.emplace(key, Entry{std::move(content), size_bytes, {}, {}}).first;
+    const KeyRef key_ref{&it->first};
+    recency_.push_front(key_ref);
+    it->second.recency = recency_.begin();
+    it->second.pinning = by_block_.emplace(block_number, key_ref);
+    used_bytes_ += size_bytes;
+}
+
+uint64_t ReplyCache::generation() const {
+    std::lock_guard lock{mutex_};
+    return generation_;
+}
+
+void ReplyCache::unwind(uint64_t from_block) {
+    std::lock_guard lock{mutex_};
+    ++generation_;
+    const auto first = by_block_.lower_bound(from_block);
+    for (auto it = first; it != by_block_.end(); ++it) {
+        const auto entry = entries_.find(*it->second);
+        used_bytes_ -= entry->second.size_bytes;
+        recency_.erase(entry->second.recency);
+        entries_.erase(entry);
+    }
+    by_block_.erase(first, by_block_.end());
+}
+
+std::size_t ReplyCache::size() const {
+    std::lock_guard lock{mutex_};
+    return entries_.size();
+}
+
+std::size_t ReplyCache::size_bytes() const {
+    std::lock_guard lock{mutex_};
+    return used_bytes_;
+}
+
+void ReplyCache::remove(const std::string& key) {
+    const auto it = entries_.find(key);
+    used_bytes_ -= it->second.size_bytes;
+    recency_.erase(it->second.recency);
+    by_block_.erase(it->second.pinning);
+    entries_.erase(it);
+}
+
+} // namespace silkrpc
@@ -0,0 +1,97 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_REPLY_CACHE_HPP_
+#define SILKRPC_COMMON_REPLY_CACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace silkrpc {
+
+//! Cache of the serialized replies to the requests pinned to some block, keyed by method and parameters and shared among
+//! the execution contexts. The cache is bounded by the size of the replies and evicts the least recently used one first.
+//! Each reply is indexed by the block it is pinned to, so that a chain reorganization drops just the replies pinned to
+//! the unwound blocks: the generation taken before computing a reply prevents storing stale entries.
+class ReplyCache {
+public:
+    //! The serialized reply, shared by all the hits
+    using Content = std::shared_ptr<const std::string>;
+
+    //! The default memory budget in bytes
+    static constexpr std::size_t kDefaultMaxBytes{64 * 1024 * 1024};
+
+    //! The block of the replies pinned to a block whose number is unknown, dropped by any unwind
+    static constexpr uint64_t kUnknownBlock{std::numeric_limits<uint64_t>::max()};
+
+    explicit ReplyCache(std::size_t max_bytes = kDefaultMaxBytes) : max_bytes_{max_bytes} {}
+
+    ReplyCache(const ReplyCache&) = delete;
+    ReplyCache& operator=(const ReplyCache&) = delete;
+
+    //! Return the cached reply for the given key, if any, or nullptr otherwise
+    Content find(const std::string& key);
+
+    //! Store the reply pinned to the block computed at the given generation, evicting the least recently used replies
+    void store(const std::string& key, Content content, uint64_t block_number, uint64_t generation);
+
+    //! The current generation, to be taken before computing the reply to store
+    uint64_t generation() const;
+
+    //! Drop all the replies pinned to the blocks starting from the specified one, including the unknown ones
+    void unwind(uint64_t from_block);
+
+    //! The number of cached replies
+    std::size_t size() const;
+
+    //! The number of bytes accounted for all the cached replies
+    std::size_t size_bytes() const;
+
+private:
+    //! The keys are referenced by address, because the keys of an unordered map never move
+    using KeyRef = const std::string*;
+
+    struct Entry {
+        Content content;
+        std::size_t size_bytes;
+        //! The position in the recency list, most recent first
+        std::list<KeyRef>::iterator recency;
+        //! The position in the block index
+        std::multimap<uint64_t, KeyRef>::iterator pinning;
+    };
+
+    void remove(const std::string& key);
+
+    const std::size_t max_bytes_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<KeyRef> recency_;
+    std::multimap<uint64_t, KeyRef> by_block_;
+    std::size_t used_bytes_{0};
+    uint64_t generation_{0};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_REPLY_CACHE_HPP_
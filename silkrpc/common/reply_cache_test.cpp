@@ -0,0 +1,95 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "reply_cache.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+static ReplyCache::Content make_content(const std::string& content) {
+    return std::make_shared<const std::string>(content);
+}
+
+TEST_CASE("reply cache find and store", "[silkrpc][common][reply_cache]") {
+    ReplyCache cache;
+    CHECK(cache.find("k1") == nullptr);
+
+    cache.store("k1", make_content("r1"), 10, cache.generation());
+    const auto content = cache.find("k1");
+    REQUIRE(content != nullptr);
+    CHECK(*content == "r1");
+    CHECK(cache.size() == 1);
+    CHECK(cache.size_bytes() == 4);
+
+    SECTION("reply for the same key replaced") {
+        cache.store("k1", make_content("r11"), 11, cache.generation());
+        CHECK(*cache.find("k1") == "r11");
+        CHECK(cache.size() == 1);
+        CHECK(cache.size_bytes() == 5);
+    }
+
+    SECTION("reply computed before unwind not stored") {
+        const auto generation = cache.generation();
+        cache.unwind(20);
+        cache.store("k2", make_content("r2"), 10, generation);
+        CHECK(cache.find("k2") == nullptr);
+    }
+}
+
+TEST_CASE("reply cache eviction", "[silkrpc][common][reply_cache]") {
+    ReplyCache cache{12};
+    cache.store("k1", make_content("r1"), 1, cache.generation());
+    cache.store("k2", make_content("r2"), 2, cache.generation());
+    cache.store("k3", make_content("r3"), 3, cache.generation());
+    CHECK(cache.size() == 3);
+
+    SECTION("least recently used evicted") {
+        CHECK(cache.find("k1") != nullptr);
+        cache.store("k4", make_content("r4"), 4, cache.generation());
+        CHECK(cache.size() == 3);
+        CHECK(cache.find("k1") != nullptr);
+        CHECK(cache.find("k2") == nullptr);
+        CHECK(cache.find("k4") != nullptr);
+    }
+
+    SECTION("reply bigger than budget not stored") {
+        cache.store("k5", make_content("too big reply"), 5, cache.generation());
+        CHECK(cache.find("k5") == nullptr);
+        CHECK(cache.size() == 3);
+    }
+}
+
+TEST_CASE("reply cache unwind", "[silkrpc][common][reply_cache]") {
+    ReplyCache cache;
+    cache.store("k1", make_content("r1"), 1, cache.generation());
+    cache.store("k2", make_content("r2"), 2, cache.generation());
+    cache.store("k3", make_content("r3"), 2, cache.generation());
+    cache.store("k4", make_content("r4"), ReplyCache::kUnknownBlock, cache.generation());
+
+    cache.unwind(2);
+    CHECK(cache.size() == 1);
+    CHECK(cache.size_bytes() == 4);
+    CHECK(cache.find("k1") != nullptr);
+    CHECK(cache.find("k2") == nullptr);
+    CHECK(cache.find("k3") == nullptr);
+    CHECK(cache.find("k4") == nullptr);
+
+    cache.store("k2", make_content("r2"), 2, cache.generation());
+    CHECK(cache.find("k2") != nullptr);
+}
+
+} // namespace silkrpc
@@ -0,0 +1,188 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "request_recorder.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include <boost/endian/conversion.hpp>
+
+namespace silkrpc {
+
+template <typename T>
+static void write_integer(std::ostream& output, T value) {
+    boost::endian::native_to_little_inplace(value);
+    output.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+static bool read_integer(std::istream& input, T& value) {
+    if (!input.read(reinterpret_cast<char*>(&value), sizeof(value))) {
+        return false;
+    }
+    boost::endian::little_to_native_inplace(value);
+    return true;
+}
+
+static uint32_t saturated_u32(uint64_t value) {
+    return static_cast<uint32_t>(std::min<uint64_t>(value, std::numeric_limits<uint32_t>::max()));
+}
+
+//! The instances are told apart by id rather than address, so that no thread can mistake a new recorder for a dead one
+static std::atomic<uint64_t> next_recorder_id{1};
+
+RequestRecorder::RequestRecorder(const std::filesystem::path& file_path, uint32_t sample_interval, bool with_replies)
+    : instance_id_{next_recorder_id.fetch_add(1)}, sample_interval_{sample_interval}, with_replies_{with_replies},
+      origin_{Clock::now()}, file_{file_path, std::ios::out | std::ios::trunc | std::ios::binary} {
+    if (!file_) {
+        throw std::runtime_error{"cannot open recording file " + file_path.string()};
+    }
+    const auto start_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch());
+    file_.write(RecordingFormat::kMagic.data(), RecordingFormat::kMagic.size());
+    write_integer(file_, RecordingFormat::kVersion);
+    write_integer(file_, with_replies_ ? RecordingFormat::kWithRepliesFlag : uint32_t{0});
+    write_integer(file_, static_cast<uint64_t>(start_time.count()));
+    writer_ = std::thread{[&]() { run_writer(); }};
+}
+
+RequestRecorder::~RequestRecorder() {
+    {
+        std::scoped_lock lock{writer_mutex_};
+        stopping_ = true;
+    }
+    writer_cv_.notify_one();
+    writer_.join();
+    flush();
+}
+
+bool RequestRecorder::sample() noexcept {
+    return sample_interval_ != 0 && sample_count_.fetch_add(1, std::memory_order_relaxed) % sample_interval_ == 0;
+}
+
+void RequestRecorder::record(Clock::time_point received, std::string_view content, std::size_t reply_size, Clock::duration latency) {
+    RecordedRequest record{received - origin_, std::string{content}};
+    if (with_replies_) {
+        record.reply_size = saturated_u32(reply_size);
+        record.latency = std::chrono::duration_cast<std::chrono::microseconds>(latency);
+    }
+    if (!this_thread_buffer().records.push(std::move(record))) {
+        dropped_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void RequestRecorder::flush() {
+    std::scoped_lock lock{write_mutex_};
+    write_records();
+}
+
+RequestRecorder::ThreadBuffer& RequestRecorder::this_thread_buffer() {
+    // Just one recorder is expected, so the buffer of the latest one used by the thread is enough not to lock
+    thread_local struct {
+        uint64_t instance_id{0};
+        std::shared_ptr<ThreadBuffer> buffer;
+    } cached;
+    if (cached.instance_id != instance_id_) {
+        std::scoped_lock lock{buffers_mutex_};
+        cached.buffer = std::make_shared<ThreadBuffer>();
+        cached.instance_id = instance_id_;
+        buffers_.push_back(cached.buffer);
+    }
+    return *cached.buffer;
+}
+
+void RequestRecorder::run_writer() {
+    std::unique_lock lock{writer_mutex_};
+    while (!stopping_) {
+        writer_cv_.wait_for(lock, kWriteInterval);
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+void RequestRecorder::write_records() {
+    std::scoped_lock lock{buffers_mutex_};
+    for (auto it = buffers_.begin(); it != buffers_.end();) {
+        auto& buffer = **it;
+        buffer.records.drain(drained_records_);
+        for (const auto& record : drained_records_) {
+            write_record(record);
+        }
+        written_count_.fetch_add(drained_records_.size(), std::memory_order_relaxed);
+        drained_records_.clear();
+        // The buffers of the exited threads are not referenced by them anymore
+        if (it->use_count() == 1 && buffer.records.empty()) {
+            it = buffers_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    file_.flush();
+}
+
+void RequestRecorder::write_record(const RecordedRequest& record) {
+    write_integer(file_, static_cast<uint64_t>(record.offset.count()));
+    write_integer(file_, saturated_u32(record.content.size()));
+    if (with_replies_) {
+        write_integer(file_, record.reply_size);
+        write_integer(file_, saturated_u32(record.latency.count()));
+    }
+    file_.write(record.content.data(), saturated_u32(record.content.size()));
+}
+
+RecordingReader::RecordingReader(const std::filesystem::path& file_path) : file_{file_path, std::ios::in | std::ios::binary} {
+    if (!file_) {
+        throw std::runtime_error{"cannot open recording file " + file_path.string()};
+    }
+    std::string magic(RecordingFormat::kMagic.size(), '\0');
+    uint32_t version{0}, flags{0};
+    uint64_t start_time{0};
+    if (!file_.read(magic.data(), magic.size()) || magic != RecordingFormat::kMagic || !read_integer(file_, version) ||
+        version != RecordingFormat::kVersion || !read_integer(file_, flags) || !read_integer(file_, start_time)) {
+        throw std::runtime_error{"invalid recording file " + file_path.string()};
+    }
+    with_replies_ = (flags & RecordingFormat::kWithRepliesFlag) != 0;
+    start_time_ = std::chrono::system_clock::time_point{std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        std::chrono::nanoseconds{start_time})};
+}
+
+std::optional<RecordedRequest> RecordingReader::next() {
+    uint64_t offset{0};
+    if (!read_integer(file_, offset)) {
+        return std::nullopt;
+    }
+    RecordedRequest record{std::chrono::nanoseconds{offset}};
+    uint32_t content_size{0}, latency{0};
+    bool complete = read_integer(file_, content_size);
+    if (complete && with_replies_) {
+        complete = read_integer(file_, record.reply_size) && read_integer(file_, latency);
+        record.latency = std::chrono::microseconds{latency};
+    }
+    if (complete) {
+        record.content.resize(content_size);
+        complete = static_cast<bool>(file_.read(record.content.data(), content_size));
+    }
+    if (!complete) {
+        throw std::runtime_error{"truncated record in recording file"};
+    }
+    return record;
+}
+
+} // namespace silkrpc
@@ -0,0 +1,143 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_COMMON_REQUEST_RECORDER_HPP_
+#define SILKRPC_COMMON_REQUEST_RECORDER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <silkrpc/concurrency/spsc_ring.hpp>
+
+namespace silkrpc {
+
+//! One request body captured by the recorder
+struct RecordedRequest {
+    //! The time the request was received, since the recording start
+    std::chrono::nanoseconds offset{0};
+    std::string content;
+    //! The reply size and latency, zero if the recording has no replies
+    uint32_t reply_size{0};
+    std::chrono::microseconds latency{0};
+};
+
+//! The binary recording layout: a header made of magic, version, flags and recording start (Unix time in nanoseconds),
+//! then the records made of offset, content size, [reply size and latency if recording replies,] content. All the
+//! integers are little-endian.
+struct RecordingFormat {
+    static constexpr std::string_view kMagic{"SRPCRECD"};
+    static constexpr uint32_t kVersion{1};
+    static constexpr uint32_t kWithRepliesFlag{0x1};
+    static constexpr std::size_t kHeaderSize{kMagic.size() + 2 * sizeof(uint32_t) + sizeof(uint64_t)};
+};
+
+//! Recorder sampling one request out of sample_interval and appending its body to a compact binary file, so that the
+//! production traffic can be replayed later by the toolbox. The records are buffered lock-free by each thread and
+//! written by a background writer, which drops them if a buffer becomes full.
+class RequestRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    //! Number of records buffered by each thread before dropping
+    static constexpr std::size_t kBufferCapacity{1024};
+
+    //! Max time the writer waits before writing the buffered records
+    static constexpr std::chrono::milliseconds kWriteInterval{100};
+
+    RequestRecorder(const std::filesystem::path& file_path, uint32_t sample_interval, bool with_replies);
+    ~RequestRecorder();
+
+    RequestRecorder(const RequestRecorder&) = delete;
+    RequestRecorder& operator=(const RequestRecorder&) = delete;
+
+    //! Return true if the next request is sampled
+    bool sample() noexcept;
+
+    //! Buffer the sampled request received at the specified time for writing, called by the receiving thread
+    void record(Clock::time_point received, std::string_view content, std::size_t reply_size, Clock::duration latency);
+
+    //! Write all the records buffered so far
+    void flush();
+
+    uint64_t written_count() const noexcept { return written_count_.load(std::memory_order_relaxed); }
+    uint64_t dropped_count() const noexcept { return dropped_count_.load(std::memory_order_relaxed); }
+
+private:
+    struct ThreadBuffer {
+        SpscRing<RecordedRequest> records{kBufferCapacity};
+    };
+
+    ThreadBuffer& this_thread_buffer();
+    void run_writer();
+    void write_records();
+    void write_record(const RecordedRequest& record);
+
+    const uint64_t instance_id_;
+    const uint32_t sample_interval_;
+    const bool with_replies_;
+    const Clock::time_point origin_;
+    std::atomic<uint64_t> sample_count_{0};
+    std::atomic<uint64_t> written_count_{0};
+    std::atomic<uint64_t> dropped_count_{0};
+
+    //! Registry of the per-thread buffers, locked just when a thread records its first request and when writing
+    std::mutex buffers_mutex_;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+
+    //! Write state, accessed by one thread at a time (i.e. the writer or the flushing thread)
+    std::mutex write_mutex_;
+    std::ofstream file_;
+    std::vector<RecordedRequest> drained_records_;
+
+    std::mutex writer_mutex_;
+    std::condition_variable writer_cv_;
+    bool stopping_{false};
+    std::thread writer_;
+};
+
+//! Reader of the requests captured by RequestRecorder, in the order they were written
+class RecordingReader {
+public:
+    //! Open the recording, throwing std::runtime_error if it cannot be opened or its header is invalid
+    explicit RecordingReader(const std::filesystem::path& file_path);
+
+    bool with_replies() const noexcept { return with_replies_; }
+    std::chrono::system_clock::time_point start_time() const noexcept { return start_time_; }
+
+    //! Return the next request or nullopt at the end, throwing std::runtime_error if the record is truncated
+    std::optional<RecordedRequest> next();
+
+private:
+    std::ifstream file_;
+    bool with_replies_{false};
+    std::chrono::system_clock::time_point start_time_;
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_REQUEST_RECORDER_HPP_
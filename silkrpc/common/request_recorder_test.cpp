@@ -0,0 +1,156 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "request_recorder.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+using namespace std::chrono_literals; // NOLINT(build/namespaces)
+
+static std::filesystem::path make_recording_file_path() {
+    return std::filesystem::temp_directory_path() / ("silkrpc_recording_" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".bin");
+}
+
+static std::vector<RecordedRequest> read_all(RecordingReader& reader) {
+    std::vector<RecordedRequest> records;
+    while (auto record = reader.next()) {
+        records.push_back(std::move(*record));
+    }
+    return records;
+}
+
+TEST_CASE("RequestRecorder samples one request every interval", "[silkrpc][common][request_recorder]") {
+    const auto file_path = make_recording_file_path();
+
+    SECTION("zero interval disables recording") {
+        RequestRecorder recorder{file_path, 0, false};
+        CHECK(!recorder.sample());
+        CHECK(!recorder.sample());
+    }
+
+    SECTION("interval") {
+        RequestRecorder recorder{file_path, 2, false};
+        CHECK(recorder.sample());
+        CHECK(!recorder.sample());
+        CHECK(recorder.sample());
+    }
+
+    std::filesystem::remove(file_path);
+}
+
+TEST_CASE("RequestRecorder writes the recording read by RecordingReader", "[silkrpc][common][request_recorder]") {
+    const auto file_path = make_recording_file_path();
+    const auto before_start = std::chrono::system_clock::now();
+
+    SECTION("without replies") {
+        {
+            RequestRecorder recorder{file_path, 1, false};
+            const auto now = RequestRecorder::Clock::now();
+            recorder.record(now, R"({"jsonrpc":"2.0","id":1,"method":"eth_blockNumber"})", 100, 5ms);
+            recorder.record(now + 10ms, std::string{"\0\x01\xff", 3}, 0, 0ms);
+            recorder.flush();
+            CHECK(recorder.written_count() == 2);
+        }
+        RecordingReader reader{file_path};
+        CHECK(!reader.with_replies());
+        CHECK(reader.start_time() >= std::chrono::time_point_cast<std::chrono::system_clock::duration>(before_start - 1ms));
+        const auto records = read_all(reader);
+        REQUIRE(records.size() == 2);
+        CHECK(records[0].content == R"({"jsonrpc":"2.0","id":1,"method":"eth_blockNumber"})");
+        CHECK(records[0].reply_size == 0);
+        CHECK(records[0].latency == 0us);
+        CHECK(records[1].content == std::string{"\0\x01\xff", 3});
+        CHECK(records[1].offset - records[0].offset == 10ms);
+    }
+
+    SECTION("with replies") {
+        {
+            RequestRecorder recorder{file_path, 1, true};
+            recorder.record(RequestRecorder::Clock::now(), "{}", 1234, 5ms);
+        }
+        RecordingReader reader{file_path};
+        CHECK(reader.with_replies());
+        const auto records = read_all(reader);
+        REQUIRE(records.size() == 1);
+        CHECK(records[0].content == "{}");
+        CHECK(records[0].reply_size == 1234);
+        CHECK(records[0].latency == 5ms);
+    }
+
+    SECTION("records from many threads") {
+        {
+            RequestRecorder recorder{file_path, 1, false};
+            std::vector<std::thread> threads;
+            for (int t{0}; t < 4; ++t) {
+                threads.emplace_back([&, t]() {
+                    for (int i{0}; i < 100; ++i) {
+                        recorder.record(RequestRecorder::Clock::now(), std::to_string(t * 100 + i), 0, 0ms);
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
+        RecordingReader reader{file_path};
+        std::set<std::string> contents;
+        for (const auto& record : read_all(reader)) {
+            contents.insert(record.content);
+        }
+        CHECK(contents.size() == 400);
+    }
+
+    std::filesystem::remove(file_path);
+}
+
+TEST_CASE("RecordingReader errors", "[silkrpc][common][request_recorder]") {
+    const auto file_path = make_recording_file_path();
+
+    SECTION("missing file") {
+        CHECK_THROWS_AS(RecordingReader{"/nonexistent/recording.bin"}, std::runtime_error);
+    }
+
+    SECTION("invalid header") {
+        std::ofstream{file_path} << "not a recording";
+        CHECK_THROWS_AS(RecordingReader{file_path}, std::runtime_error);
+    }
+
+    SECTION("truncated record") {
+        {
+            RequestRecorder recorder{file_path, 1, false};
+            recorder.record(RequestRecorder::Clock::now(), "0123456789", 0, 0ms);
+        }
+        std::filesystem::resize_file(file_path, std::filesystem::file_size(file_path) - 1);
+        RecordingReader reader{file_path};
+        CHECK_THROWS_AS(reader.next(), std::runtime_error);
+    }
+
+    std::filesystem::remove(file_path);
+}
+
+} // namespace silkrpc
@@ -0,0 +1,276 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "sampling_profiler.hpp"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <ucontext.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc {
+
+namespace {
+
+struct Sample {
+    std::atomic_bool ready{false};
+    uint32_t num_frames{0};
+    std::array<uintptr_t, SamplingProfiler::kMaxFrames> frames{};
+    std::array<char, SamplingProfiler::kMaxTagSize> tag{};
+};
+
+//! The state shared with the signal handler, which must be async-signal-safe: lock-free atomics only, no allocation
+std::atomic_bool running{false};
+std::atomic_bool sampling{false};
+std::atomic<Sample*> samples{nullptr};
+std::atomic<std::size_t> next_sample{0};
+
+//! The sample buffer, allocated by the first profiling and never released, because a late signal could still write it
+std::unique_ptr<Sample[]> sample_buffer;
+std::once_flag handler_installed;
+
+thread_local std::atomic<const char*> thread_tag{nullptr};
+thread_local std::atomic<uintptr_t> stack_low{0};
+thread_local std::atomic<uintptr_t> stack_high{0};
+
+//! Extract the program counter, the frame pointer and the stack pointer of the interrupted frame
+bool interrupted_registers(void* context, uintptr_t& pc, uintptr_t& fp, uintptr_t& sp) {
+    const auto* user_context = static_cast<const ucontext_t*>(context);
+#if defined(__x86_64__)
+    pc = static_cast<uintptr_t>(user_context->uc_mcontext.gregs[REG_RIP]);
+    fp = static_cast<uintptr_t>(user_context->uc_mcontext.gregs[REG_RBP]);
+    sp = static_cast<uintptr_t>(user_context->uc_mcontext.gregs[REG_RSP]);
+    return true;
+#elif defined(__aarch64__)
+    pc = static_cast<uintptr_t>(user_context->uc_mcontext.pc);
+    fp = static_cast<uintptr_t>(user_context->uc_mcontext.regs[29]);
+    sp = static_cast<uintptr_t>(user_context->uc_mcontext.sp);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void handle_sigprof(int /*signal*/, siginfo_t* /*info*/, void* context) {
+    if (!sampling.load(std::memory_order_acquire)) {
+        return;
+    }
+    auto* buffer = samples.load(std::memory_order_acquire);
+    const auto index = next_sample.fetch_add(1, std::memory_order_relaxed);
+    if (buffer == nullptr || index >= SamplingProfiler::kMaxSamples) {
+        return;
+    }
+    const int saved_errno = errno;
+    auto& sample = buffer[index];
+
+    uintptr_t pc{0}, fp{0}, sp{0};
+    uint32_t num_frames{0};
+    if (interrupted_registers(context, pc, fp, sp)) {
+        sample.frames[num_frames++] = pc;
+        // Walk the chain of the saved frame pointers and return addresses while staying within the thread stack
+        const auto low = std::max(stack_low.load(std::memory_order_relaxed), sp);
+        const auto high = stack_high.load(std::memory_order_relaxed);
+        while (num_frames < SamplingProfiler::kMaxFrames && fp >= low && fp + 2 * sizeof(uintptr_t) <= high && fp % sizeof(uintptr_t) == 0) {
+            const auto* frame = reinterpret_cast<const uintptr_t*>(fp);
+            const auto return_address = frame[1];
+            if (return_address == 0) {
+                break;
+            }
+            sample.frames[num_frames++] = return_address;
+            if (frame[0] <= fp) {
+                break;
+            }
+            fp = frame[0];
+        }
+    }
+    sample.num_frames = num_frames;
+
+    std::size_t tag_size{0};
+    if (const auto* tag = thread_tag.load(std::memory_order_relaxed); tag != nullptr) {
+        for (; tag_size + 1 < SamplingProfiler::kMaxTagSize && tag[tag_size] != '\0'; ++tag_size) {
+            sample.tag[tag_size] = tag[tag_size];
+        }
+    }
+    sample.tag[tag_size] = '\0';
+
+    sample.ready.store(true, std::memory_order_release);
+    errno = saved_errno;
+}
+
+//! Return the name of the function containing the address, demangled if possible, or the module and offset otherwise
+std::string symbolize(uintptr_t address) {
+    Dl_info info{};
+    if (dladdr(reinterpret_cast<void*>(address), &info) == 0) {
+        std::ostringstream out;
+        out << "0x" << std::hex << address;
+        return out.str();
+    }
+    if (info.dli_sname != nullptr) {
+        int status{0};
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        std::string name{status == 0 && demangled != nullptr ? demangled : info.dli_sname};
+        std::free(demangled); // NOLINT(cppcoreguidelines-no-malloc)
+        std::replace(name.begin(), name.end(), ';', ':');
+        return name;
+    }
+    std::string module{info.dli_fname != nullptr ? info.dli_fname : "?"};
+    module = module.substr(module.find_last_of('/') + 1);
+    std::ostringstream out;
+    out << module << "+0x" << std::hex << (address - reinterpret_cast<uintptr_t>(info.dli_fbase));
+    return out.str();
+}
+
+} // namespace
+
+SamplingProfiler::Tag::Tag(const char* tag) noexcept : previous_{thread_tag.load(std::memory_order_relaxed)} {
+    if (stack_high.load(std::memory_order_relaxed) == 0) {
+        register_thread();
+    }
+    thread_tag.store(tag, std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+SamplingProfiler::Tag::~Tag() {
+    thread_tag.store(previous_, std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+bool SamplingProfiler::active() noexcept {
+    return sampling.load(std::memory_order_relaxed);
+}
+
+void SamplingProfiler::register_thread() noexcept {
+    pthread_attr_t attributes;
+    if (pthread_getattr_np(pthread_self(), &attributes) != 0) {
+        return;
+    }
+    void* stack_address{nullptr};
+    std::size_t stack_size{0};
+    if (pthread_attr_getstack(&attributes, &stack_address, &stack_size) == 0) {
+        stack_low.store(reinterpret_cast<uintptr_t>(stack_address), std::memory_order_relaxed);
+        stack_high.store(reinterpret_cast<uintptr_t>(stack_address) + stack_size, std::memory_order_relaxed);
+    }
+    pthread_attr_destroy(&attributes);
+}
+
+bool SamplingProfiler::start() {
+    bool expected{false};
+    if (!running.compare_exchange_strong(expected, true)) {
+        return false;
+    }
+
+    // The handler is never uninstalled, because restoring the default disposition of SIGPROF, i.e. terminating the
+    // process, could make any signal still pending kill it: the handler just returns when not sampling
+    try {
+        std::call_once(handler_installed, []() {
+            struct sigaction action{};
+            action.sa_sigaction = handle_sigprof;
+            action.sa_flags = SA_SIGINFO | SA_RESTART;
+            sigemptyset(&action.sa_mask);
+            if (sigaction(SIGPROF, &action, nullptr) != 0) {
+                throw std::system_error{errno, std::generic_category(), "SamplingProfiler::start sigaction failed"};
+            }
+            sample_buffer = std::make_unique<Sample[]>(kMaxSamples);
+        });
+    } catch (...) {
+        running = false;
+        throw;
+    }
+
+    for (std::size_t i{0}; i < kMaxSamples; ++i) {
+        sample_buffer[i].ready.store(false, std::memory_order_relaxed);
+    }
+    next_sample.store(0, std::memory_order_relaxed);
+    samples.store(sample_buffer.get(), std::memory_order_release);
+    sampling.store(true, std::memory_order_release);
+
+    itimerval timer{};
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = static_cast<suseconds_t>(kSamplingInterval.count());
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        const int error = errno;
+        sampling = false;
+        running = false;
+        throw std::system_error{error, std::generic_category(), "SamplingProfiler::start setitimer failed"};
+    }
+    SILKRPC_INFO << "SamplingProfiler::start sampling every " << kSamplingInterval.count() << "us of CPU time\n";
+    return true;
+}
+
+std::string SamplingProfiler::stop() {
+    if (!running.load()) {
+        return {};
+    }
+    const itimerval timer{};
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    sampling.store(false, std::memory_order_release);
+
+    const auto num_samples = next_sample.load(std::memory_order_relaxed);
+    dropped_samples_ = num_samples > kMaxSamples ? num_samples - kMaxSamples : 0;
+
+    std::unordered_map<uintptr_t, std::string> symbols;
+    std::map<std::string, uint64_t> folded_stacks;
+    std::string stack;
+    for (std::size_t i{0}; i < std::min(num_samples, kMaxSamples); ++i) {
+        const auto& sample = sample_buffer[i];
+        if (!sample.ready.load(std::memory_order_acquire)) {
+            continue;
+        }
+        stack.assign(sample.tag.data());
+        for (auto frame = sample.num_frames; frame > 0; --frame) {
+            // The return addresses point after the call, which may already be in the next function
+            const auto address = frame > 1 ? sample.frames[frame - 1] - 1 : sample.frames[0];
+            auto symbol_it = symbols.find(address);
+            if (symbol_it == symbols.end()) {
+                symbol_it = symbols.emplace(address, symbolize(address)).first;
+            }
+            if (!stack.empty()) {
+                stack.push_back(';');
+            }
+            stack.append(symbol_it->second);
+        }
+        ++folded_stacks[stack];
+    }
+
+    std::string content;
+    for (const auto& [folded_stack, count] : folded_stacks) {
+        content.append(folded_stack).append(" ").append(std::to_string(count)).append("\n");
+    }
+    SILKRPC_INFO << "SamplingProfiler::stop samples: " << std::min(num_samples, kMaxSamples) << " dropped: " << dropped_samples_ << "\n";
+    running.store(false);
+    return content;
+}
+
+} // namespace silkrpc
@@ -0,0 +1,88 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_COMMON_SAMPLING_PROFILER_HPP_
+#define SILKRPC_COMMON_SAMPLING_PROFILER_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace silkrpc {
+
+//! In-process sampling profiler: while running, SIGPROF is delivered every kSamplingInterval of CPU time consumed by the
+//! process (ITIMER_PROF) to the thread consuming it, whose stack is unwound by the frame pointers and recorded with the
+//! tag of the thread (e.g. the JSON-RPC method running on it). The samples are aggregated into folded stacks, i.e. the
+//! input of flamegraph.pl. The stacks are complete only when built using SILKRPC_FRAME_POINTERS and unwound only on the
+//! threads whose stack bounds are known (see register_thread), the others giving just the interrupted frame.
+//! The signal disposition and the timer are process-wide, hence at most one profiling runs at a time.
+class SamplingProfiler {
+public:
+    //! The CPU time between two consecutive samples
+    static constexpr std::chrono::microseconds kSamplingInterval{1000};
+
+    //! The max number of samples kept for each profiling, the ones in excess being dropped
+    static constexpr std::size_t kMaxSamples{16 * 1024};
+
+    //! The max number of frames of each sample
+    static constexpr std::size_t kMaxFrames{48};
+
+    //! The max size of the thread tag kept in each sample
+    static constexpr std::size_t kMaxTagSize{48};
+
+    //! The max duration of one profiling
+    static constexpr std::chrono::seconds kMaxDuration{60};
+
+    //! The tag of the samples taken on the calling thread while in scope, restoring the previous one when destroyed: the tag
+    //! is read by the signal handler, so it must outlive the scope.
+    class Tag {
+    public:
+        explicit Tag(const char* tag) noexcept;
+        ~Tag();
+
+        Tag(const Tag&) = delete;
+        Tag& operator=(const Tag&) = delete;
+
+    private:
+        const char* previous_;
+    };
+
+    //! Return true if some profiling is running
+    static bool active() noexcept;
+
+    //! Record the stack bounds of the calling thread, so that its samples are unwound beyond the interrupted frame
+    static void register_thread() noexcept;
+
+    //! Start profiling, returning false if some profiling is already running
+    //! \throws std::system_error if the signal handler or the timer cannot be installed
+    bool start();
+
+    //! Stop profiling and return the folded stacks as "tag;outermost frame;...;innermost frame count" lines, the
+    //! untagged samples having no tag prefix
+    std::string stop();
+
+    //! The number of samples dropped by the latest profiling because in excess
+    uint64_t dropped_samples() const noexcept { return dropped_samples_; }
+
+private:
+    uint64_t dropped_samples_{0};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_SAMPLING_PROFILER_HPP_
@@ -0,0 +1,78 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "sampling_profiler.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <catch2/catch.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc {
+
+//! Consume the CPU of the calling thread for the specified duration
+static uint64_t burn_cpu(std::chrono::milliseconds duration) {
+    volatile uint64_t sum{0};
+    const auto deadline = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < deadline) {
+        for (uint64_t i{0}; i < 10'000; ++i) {
+            sum = sum + i;
+        }
+    }
+    return sum;
+}
+
+TEST_CASE("SamplingProfiler", "[silkrpc][common][sampling_profiler]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    SamplingProfiler profiler;
+    CHECK(!SamplingProfiler::active());
+    CHECK(profiler.stop().empty());
+
+    SECTION("one profiling at a time") {
+        CHECK(profiler.start());
+        CHECK(SamplingProfiler::active());
+        CHECK(!profiler.start());
+        profiler.stop();
+        CHECK(!SamplingProfiler::active());
+    }
+
+    SECTION("tagged samples folded") {
+        CHECK(profiler.start());
+        std::thread tagged_thread{[]() {
+            const SamplingProfiler::Tag tag{"eth_call"};
+            burn_cpu(std::chrono::milliseconds{200});
+        }};
+        tagged_thread.join();
+        const auto folded_stacks = profiler.stop();
+        CHECK(folded_stacks.find("eth_call;") != std::string::npos);
+        CHECK(folded_stacks.back() == '\n');
+        CHECK(profiler.dropped_samples() == 0);
+    }
+
+    SECTION("restart after stop") {
+        CHECK(profiler.start());
+        profiler.stop();
+        CHECK(profiler.start());
+        burn_cpu(std::chrono::milliseconds{50});
+        CHECK(!profiler.stop().empty());
+    }
+}
+
+} // namespace silkrpc
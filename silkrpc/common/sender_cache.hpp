@@ -0,0 +1,44 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef SILKRPC_COMMON_SENDER_CACHE_HPP_
+#define SILKRPC_COMMON_SENDER_CACHE_HPP_
+
+#include <cstddef>
+
+#include <evmc/evmc.hpp>
+
+#include <silkrpc/common/sharded_cache.hpp>
+
+namespace silkrpc {
+
+//! Cache of the transaction senders by transaction hash, bounded by the approximate memory footprint (see ShardedCache),
+//! so that the lookups of the pending transactions submitted through this daemon skip the signature recovery. The sender
+//! is determined by the signed transaction, hence by its hash, so the cache is never invalidated.
+class SenderCache : public ShardedCache<evmc::address> {
+public:
+    //! The default memory budget in bytes
+    static constexpr std::size_t kDefaultMaxBytes{8 * 1024 * 1024};
+
+    explicit SenderCache(std::size_t max_bytes = kDefaultMaxBytes, bool shared_cache = true, std::size_t num_shards = kDefaultNumShards)
+    : ShardedCache{&SenderCache::approximate_size, max_bytes, shared_cache, num_shards} {}
+
+    //! Return the approximate memory footprint of the sender, including the bookkeeping of its cache entry
+    static std::size_t approximate_size(const evmc::address& sender);
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_SENDER_CACHE_HPP_
@@ -0,0 +1,255 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_SHARDED_CACHE_HPP_
+#define SILKRPC_COMMON_SHARDED_CACHE_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <evmc/evmc.hpp>
+
+namespace silkrpc {
+
+//! The approximate memory footprint of a cached entry besides its value: the shared value, the cache entry and the index node
+constexpr std::size_t kCacheEntryOverhead{128};
+
+//! Cache of immutable values by hash, sharded by key and using CLOCK eviction: a hit just marks the entry as referenced
+//! without reordering anything, so that concurrent readers of the same shard share the lock and never block each other.
+//! The cache is bounded by the approximate memory footprint of the values rather than by their number and hands out
+//! shared values, so that a hit costs just a reference count increment instead of a deep copy. With a maximum frequency
+//! above one the reference bit becomes a saturating hit counter decremented by each sweep (GCLOCK), approximating LFU:
+//! frequently hit entries survive several sweeps, so that a burst of one-off insertions does not flush them.
+template <typename Value>
+class ShardedCache {
+public:
+    //! The function returning the approximate memory footprint of a value
+    using SizeFunction = std::size_t (*)(const Value&);
+
+    //! The default number of shards
+    static constexpr std::size_t kDefaultNumShards{16};
+
+    //! The max number of entries evicted by one insertion beyond those making room for it, while some shard exceeds its
+    //! budget after shrinking: the excess is evicted gradually by the next insertions rather than all at once
+    static constexpr std::size_t kMaxShrinkEvictions{4};
+
+    ShardedCache(SizeFunction size_of, std::size_t max_bytes, bool shared_cache, std::size_t num_shards, uint8_t max_frequency = 1)
+    : size_of_{size_of}, shared_cache_{shared_cache}, max_frequency_{std::max<uint8_t>(max_frequency, 1)} {
+        num_shards = std::max<std::size_t>(num_shards, 1);
+        const std::size_t shard_max_bytes = max_bytes / num_shards;
+        shards_.reserve(num_shards);
+        for (std::size_t i{0}; i < num_shards; ++i) {
+            shards_.emplace_back(std::make_unique<Shard>(shard_max_bytes));
+        }
+    }
+
+    ShardedCache(const ShardedCache&) = delete;
+    ShardedCache& operator=(const ShardedCache&) = delete;
+
+    //! Return the cached value for the given key, if any, or nullptr otherwise
+    std::shared_ptr<const Value> get(const evmc::bytes32& key) {
+        auto& shard = shard_for(key);
+        std::shared_lock lock{shard.access, std::defer_lock};
+        if (shared_cache_) {
+            lock.lock();
+        }
+        const auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            return nullptr;
+        }
+        auto& entry = *shard.entries[it->second];
+        // Concurrent readers may lose some increments, which is fine for an approximate frequency
+        const auto frequency = entry.frequency.load(std::memory_order_relaxed);
+        if (frequency < max_frequency_) {
+            entry.frequency.store(frequency + 1, std::memory_order_relaxed);
+        }
+        return entry.value;
+    }
+
+    //! Insert the value evicting as many entries as needed to stay within budget: each shard always keeps the newest entry
+    void insert(const evmc::bytes32& key, std::shared_ptr<const Value> value) {
+        const auto value_size = size_of_(*value);
+
+        auto& shard = shard_for(key);
+        std::unique_lock lock{shard.access, std::defer_lock};
+        if (shared_cache_) {
+            lock.lock();
+        }
+
+        const auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            remove(shard, it->second);
+            generation_.fetch_add(1, std::memory_order_acq_rel);
+        }
+        const bool shrinking = shard.used_bytes > shard.max_bytes;
+        const auto used_bytes_before = shard.used_bytes;
+        std::size_t num_evicted{0};
+        while (!shard.entries.empty() && shard.used_bytes + value_size > shard.max_bytes) {
+            if (shrinking && num_evicted >= kMaxShrinkEvictions && shard.used_bytes + value_size <= used_bytes_before) {
+                break;
+            }
+            evict_one(shard);
+            ++num_evicted;
+        }
+        if (num_evicted > 0) {
+            generation_.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        shard.entries.emplace_back(std::make_unique<Entry>(key, std::move(value), value_size));
+        shard.index.emplace(key, shard.entries.size() - 1);
+        shard.used_bytes += value_size;
+    }
+
+    std::size_t size() const {
+        std::size_t size{0};
+        for (const auto& shard : shards_) {
+            std::shared_lock lock{shard->access, std::defer_lock};
+            if (shared_cache_) {
+                lock.lock();
+            }
+            size += shard->index.size();
+        }
+        return size;
+    }
+
+    //! Return the approximate number of bytes accounted for all the cached values
+    std::size_t size_bytes() const {
+        std::size_t size_bytes{0};
+        for (const auto& shard : shards_) {
+            std::shared_lock lock{shard->access, std::defer_lock};
+            if (shared_cache_) {
+                lock.lock();
+            }
+            size_bytes += shard->used_bytes;
+        }
+        return size_bytes;
+    }
+
+    std::size_t num_shards() const { return shards_.size(); }
+
+    //! The current generation, advanced whenever some entry is replaced or evicted: the values got at some generation
+    //! are still those cached as long as the generation does not change, so they can be kept by local caches in front
+    uint64_t generation() const { return generation_.load(std::memory_order_acquire); }
+
+    //! Change the memory budget in place: growing takes effect at once, whilst the entries exceeding the budget after
+    //! shrinking are evicted gradually by the next insertions (see kMaxShrinkEvictions)
+    void set_max_bytes(std::size_t max_bytes) {
+        const std::size_t shard_max_bytes = max_bytes / shards_.size();
+        for (auto& shard : shards_) {
+            std::unique_lock lock{shard->access, std::defer_lock};
+            if (shared_cache_) {
+                lock.lock();
+            }
+            shard->max_bytes = shard_max_bytes;
+        }
+    }
+
+    //! Return the memory budget of all the shards together
+    std::size_t max_bytes() const {
+        std::size_t max_bytes{0};
+        for (const auto& shard : shards_) {
+            std::shared_lock lock{shard->access, std::defer_lock};
+            if (shared_cache_) {
+                lock.lock();
+            }
+            max_bytes += shard->max_bytes;
+        }
+        return max_bytes;
+    }
+
+private:
+    struct Entry {
+        Entry(const evmc::bytes32& k, std::shared_ptr<const Value> v, std::size_t s)
+        : key{k}, value{std::move(v)}, size_bytes{s} {}
+
+        evmc::bytes32 key;
+        std::shared_ptr<const Value> value;
+        std::size_t size_bytes;
+        //! The CLOCK reference counter, incremented by readers holding just the shared lock
+        std::atomic<uint8_t> frequency{0};
+    };
+
+    struct Shard {
+        explicit Shard(std::size_t budget) : max_bytes(budget) {}
+
+        mutable std::shared_mutex access;
+        //! The ring of entries scanned by the CLOCK hand
+        std::vector<std::unique_ptr<Entry>> entries;
+        //! The position of each cached key in the ring
+        std::unordered_map<evmc::bytes32, std::size_t> index;
+        //! The memory budget of this shard
+        std::size_t max_bytes;
+        //! The bytes accounted for the entries in use
+        std::size_t used_bytes{0};
+        //! The CLOCK hand pointing to the next eviction candidate
+        std::size_t hand{0};
+    };
+
+    Shard& shard_for(const evmc::bytes32& key) const {
+        // Keys are hashes, so any of their bytes is already uniformly distributed
+        uint64_t prefix;
+        std::memcpy(&prefix, key.bytes, sizeof(prefix));
+        return *shards_[prefix % shards_.size()];
+    }
+
+    static void remove(Shard& shard, std::size_t position) {
+        shard.index.erase(shard.entries[position]->key);
+        shard.used_bytes -= shard.entries[position]->size_bytes;
+
+        // Fill the hole with the last entry, so that the ring stays compact
+        if (position != shard.entries.size() - 1) {
+            shard.entries[position] = std::move(shard.entries.back());
+            shard.index[shard.entries[position]->key] = position;
+        }
+        shard.entries.pop_back();
+        if (shard.hand >= shard.entries.size()) {
+            shard.hand = 0;
+        }
+    }
+
+    static void evict_one(Shard& shard) {
+        // CLOCK eviction: give another chance to the entries referenced since the last sweep, one per hit
+        while (true) {
+            auto& frequency = shard.entries[shard.hand]->frequency;
+            const auto current = frequency.load(std::memory_order_relaxed);
+            if (current == 0) {
+                break;
+            }
+            frequency.store(current - 1, std::memory_order_relaxed);
+            shard.hand = (shard.hand + 1) % shard.entries.size();
+        }
+        remove(shard, shard.hand);
+    }
+
+    SizeFunction size_of_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    bool shared_cache_;
+    uint8_t max_frequency_;
+    std::atomic<uint64_t> generation_{0};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_SHARDED_CACHE_HPP_
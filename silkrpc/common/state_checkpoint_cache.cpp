@@ -0,0 +1,89 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "state_checkpoint_cache.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace silkrpc {
+
+std::shared_ptr<const StateCheckpoint> StateCheckpoints::find(uint32_t max_transaction_count) const {
+    const auto it = std::upper_bound(checkpoints.begin(), checkpoints.end(), max_transaction_count, [](uint32_t n, const auto& checkpoint) {
+        return n < checkpoint->transaction_count;
+    });
+    if (it == checkpoints.begin()) {
+        return nullptr;
+    }
+    return *std::prev(it);
+}
+
+void StateCheckpoints::add(std::shared_ptr<const StateCheckpoint> checkpoint, std::size_t max_checkpoints) {
+    const auto it = std::lower_bound(checkpoints.begin(), checkpoints.end(), checkpoint->transaction_count, [](const auto& c, uint32_t n) {
+        return c->transaction_count < n;
+    });
+    if (it != checkpoints.end() && (*it)->transaction_count == checkpoint->transaction_count) {
+        *it = std::move(checkpoint);
+        return;
+    }
+    checkpoints.insert(it, std::move(checkpoint));
+    while (checkpoints.size() > std::max<std::size_t>(max_checkpoints, 1)) {
+        std::size_t closest{0};
+        uint32_t closest_gap{checkpoints[0]->transaction_count};
+        for (std::size_t i{1}; i < checkpoints.size(); ++i) {
+            const uint32_t gap = checkpoints[i]->transaction_count - checkpoints[i - 1]->transaction_count;
+            if (gap < closest_gap) {
+                closest = i;
+                closest_gap = gap;
+            }
+        }
+        checkpoints.erase(checkpoints.begin() + static_cast<std::ptrdiff_t>(closest));
+    }
+}
+
+std::shared_ptr<const StateCheckpoint> StateCheckpointCache::find(const evmc::bytes32& block_hash, uint32_t transaction_index) {
+    const auto checkpoints = get(block_hash);
+    if (!checkpoints) {
+        return nullptr;
+    }
+    return checkpoints->find(transaction_index);
+}
+
+void StateCheckpointCache::store(const evmc::bytes32& block_hash, std::shared_ptr<const StateCheckpoint> checkpoint) {
+    // Cached values are immutable, so the checkpoints already cached for the block are copied along with the new one
+    StateCheckpoints checkpoints;
+    if (const auto cached_checkpoints = get(block_hash)) {
+        checkpoints.checkpoints = cached_checkpoints->checkpoints;
+    }
+    checkpoints.add(std::move(checkpoint), kMaxCheckpointsPerBlock);
+    insert(block_hash, std::make_shared<const StateCheckpoints>(std::move(checkpoints)));
+}
+
+std::size_t StateCheckpointCache::approximate_size(const StateCheckpoints& checkpoints) {
+    std::size_t size{sizeof(StateCheckpoints)};
+    for (const auto& checkpoint : checkpoints.checkpoints) {
+        size += sizeof(checkpoint) + sizeof(StateCheckpoint);
+        size += checkpoint->accounts.size() * (sizeof(evmc::address) + sizeof(std::optional<silkworm::Account>) + 2 * sizeof(void*));
+        for (const auto& [code_hash, code] : checkpoint->code) {
+            size += sizeof(code_hash) + sizeof(code) + code.size() + 2 * sizeof(void*);
+        }
+        size += checkpoint->storage.size() * (sizeof(StateCheckpoint::StorageKey) + sizeof(evmc::bytes32) + 4 * sizeof(void*));
+        size += checkpoint->incarnations.size() * (sizeof(evmc::address) + sizeof(uint64_t) + 2 * sizeof(void*));
+    }
+    return size;
+}
+
+} // namespace silkrpc
@@ -0,0 +1,97 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_STATE_CHECKPOINT_CACHE_HPP_
+#define SILKRPC_COMMON_STATE_CHECKPOINT_CACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <evmc/evmc.hpp>
+#include <silkworm/common/base.hpp>
+#include <silkworm/types/account.hpp>
+
+#include <silkrpc/common/sharded_cache.hpp>
+
+namespace silkrpc {
+
+//! The state written by the first transactions of one block on top of the state preceding it, i.e. the write set
+//! overlay to resume the execution of the block from the next transaction
+struct StateCheckpoint {
+    using StorageKey = std::tuple<evmc::address, uint64_t, evmc::bytes32>;
+
+    //! The number of transactions of the block executed, i.e. the index of the next transaction
+    uint32_t transaction_count{0};
+
+    //! The accounts changed so far, those destructed being empty
+    std::unordered_map<evmc::address, std::optional<silkworm::Account>> accounts;
+
+    //! The code deployed so far
+    std::unordered_map<evmc::bytes32, silkworm::Bytes> code;
+
+    //! The storage locations changed so far
+    std::map<StorageKey, evmc::bytes32> storage;
+
+    //! The incarnation of the accounts destructed so far, needed when they are created again
+    std::unordered_map<evmc::address, uint64_t> incarnations;
+};
+
+//! The checkpoints of one block in ascending order of transaction count
+struct StateCheckpoints {
+    std::vector<std::shared_ptr<const StateCheckpoint>> checkpoints;
+
+    //! Return the checkpoint having the highest transaction count not above the specified one, if any, or nullptr otherwise
+    std::shared_ptr<const StateCheckpoint> find(uint32_t max_transaction_count) const;
+
+    //! Add the checkpoint, replacing the one having the same transaction count: beyond the specified maximum number of
+    //! checkpoints, the one closest to its predecessor is dropped, so that the rest stay spread across the block
+    void add(std::shared_ptr<const StateCheckpoint> checkpoint, std::size_t max_checkpoints);
+};
+
+//! Cache of the intra-block state checkpoints by block hash, bounded by their approximate memory footprint (see
+//! ShardedCache), so that tracing a transaction replays just the transactions following the nearest checkpoint instead
+//! of all those preceding it in the block. A block hash identifies the whole state the block executes on, so the
+//! checkpoints are immutable and never invalidated.
+class StateCheckpointCache : public ShardedCache<StateCheckpoints> {
+public:
+    //! The default memory budget in bytes
+    static constexpr std::size_t kDefaultMaxBytes{64 * 1024 * 1024};
+
+    //! The max number of checkpoints kept for one block
+    static constexpr std::size_t kMaxCheckpointsPerBlock{4};
+
+    explicit StateCheckpointCache(std::size_t max_bytes = kDefaultMaxBytes, bool shared_cache = true, std::size_t num_shards = kDefaultNumShards)
+    : ShardedCache{&StateCheckpointCache::approximate_size, max_bytes, shared_cache, num_shards} {}
+
+    //! Return the nearest checkpoint of the block preceding the transaction at the specified index, if any
+    std::shared_ptr<const StateCheckpoint> find(const evmc::bytes32& block_hash, uint32_t transaction_index);
+
+    //! Store the checkpoint of the block along with those already cached
+    void store(const evmc::bytes32& block_hash, std::shared_ptr<const StateCheckpoint> checkpoint);
+
+    //! Return the approximate memory footprint of the checkpoints
+    static std::size_t approximate_size(const StateCheckpoints& checkpoints);
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_STATE_CHECKPOINT_CACHE_HPP_
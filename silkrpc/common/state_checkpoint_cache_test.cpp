@@ -0,0 +1,92 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "state_checkpoint_cache.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+using evmc::literals::operator""_address, evmc::literals::operator""_bytes32;
+
+static const evmc::bytes32 kBlockHash{0x2f1e7e4e1ead1e2bce7d3e5bb3a1c44e2c6a6b451191695ae1a1a4aa6a3f5bd1_bytes32};
+static const evmc::address kAddress{0x0715a7794a1dc8e42615f059dd6e406a6594651a_address};
+
+static std::shared_ptr<const StateCheckpoint> make_checkpoint(uint32_t transaction_count) {
+    StateCheckpoint checkpoint;
+    checkpoint.transaction_count = transaction_count;
+    checkpoint.accounts.emplace(kAddress, silkworm::Account{transaction_count});
+    return std::make_shared<const StateCheckpoint>(std::move(checkpoint));
+}
+
+TEST_CASE("state checkpoints find and add", "[silkrpc][common][state_checkpoint_cache]") {
+    StateCheckpoints checkpoints;
+    CHECK(!checkpoints.find(10));
+
+    checkpoints.add(make_checkpoint(20), 4);
+    checkpoints.add(make_checkpoint(5), 4);
+    REQUIRE(checkpoints.checkpoints.size() == 2);
+    CHECK(checkpoints.checkpoints[0]->transaction_count == 5);
+    CHECK(!checkpoints.find(4));
+    CHECK(checkpoints.find(5)->transaction_count == 5);
+    CHECK(checkpoints.find(19)->transaction_count == 5);
+    CHECK(checkpoints.find(20)->transaction_count == 20);
+    CHECK(checkpoints.find(100)->transaction_count == 20);
+
+    SECTION("replace same transaction count") {
+        checkpoints.add(make_checkpoint(20), 4);
+        CHECK(checkpoints.checkpoints.size() == 2);
+    }
+
+    SECTION("drop the closest to its predecessor beyond max") {
+        checkpoints.add(make_checkpoint(40), 4);
+        checkpoints.add(make_checkpoint(22), 4);
+        checkpoints.add(make_checkpoint(30), 4);
+        REQUIRE(checkpoints.checkpoints.size() == 4);
+        CHECK(checkpoints.checkpoints[0]->transaction_count == 5);
+        CHECK(checkpoints.checkpoints[1]->transaction_count == 20);
+        CHECK(checkpoints.checkpoints[2]->transaction_count == 30);
+        CHECK(checkpoints.checkpoints[3]->transaction_count == 40);
+    }
+}
+
+TEST_CASE("state checkpoint cache find and store", "[silkrpc][common][state_checkpoint_cache]") {
+    StateCheckpointCache cache;
+    CHECK(!cache.find(kBlockHash, 10));
+
+    cache.store(kBlockHash, make_checkpoint(3));
+    cache.store(kBlockHash, make_checkpoint(8));
+    CHECK(cache.size() == 1);
+    CHECK(!cache.find(kBlockHash, 2));
+    CHECK(cache.find(kBlockHash, 3)->transaction_count == 3);
+    CHECK(cache.find(kBlockHash, 7)->transaction_count == 3);
+    const auto checkpoint = cache.find(kBlockHash, 10);
+    REQUIRE(checkpoint);
+    CHECK(checkpoint->transaction_count == 8);
+    CHECK(checkpoint->accounts.at(kAddress)->nonce == 8);
+    CHECK(!cache.find(0x01_bytes32, 10));
+
+    SECTION("approximate size grows with the write set") {
+        StateCheckpoint bigger{*checkpoint};
+        bigger.code.emplace(0x02_bytes32, silkworm::Bytes(1024, 0x60));
+        bigger.storage.emplace(StateCheckpoint::StorageKey{kAddress, 1, 0x03_bytes32}, 0x04_bytes32);
+        StateCheckpoints small{{checkpoint}};
+        StateCheckpoints big{{std::make_shared<const StateCheckpoint>(std::move(bigger))}};
+        CHECK(StateCheckpointCache::approximate_size(big) > StateCheckpointCache::approximate_size(small) + 1024);
+    }
+}
+
+} // namespace silkrpc
@@ -17,6 +17,7 @@
 #ifndef SILKRPC_COMMON_TEE_HPP_
 #define SILKRPC_COMMON_TEE_HPP_
 
+#include <algorithm>
 #include <cstdio>
 #include <ctime>
 #include <fstream>
@@ -49,6 +50,13 @@ class teebuf : public std::streambuf {
         }
     }
 
+    // Put whole character sequences directly into the teed buffers.
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        const auto n1 = sb1->sputn(s, n);
+        const auto n2 = sb2->sputn(s, n);
+        return std::min(n1, n2);
+    }
+
     // Sync both teed buffers.
     int sync() override {
         int const r1 = sb1->pubsync();
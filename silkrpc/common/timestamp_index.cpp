@@ -0,0 +1,218 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "timestamp_index.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace silkrpc {
+
+namespace {
+
+//! The file layout: magic, number of blocks, number of long gaps, checkpoints, deltas, padding to 8 bytes, long gaps as
+//! (block number, delta) pairs, all fixed-width integers in host byte order
+constexpr std::string_view kTimestampIndexMagic{"SRPCTSI1"};
+
+template <typename T>
+void write_values(std::ofstream& output, const T* values, std::size_t count) {
+    output.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+template <typename T>
+bool read_values(std::ifstream& input, T* values, std::size_t count) {
+    return static_cast<bool>(input.read(reinterpret_cast<char*>(values), static_cast<std::streamsize>(count * sizeof(T))));
+}
+
+std::size_t padding_of(std::size_t num_deltas) {
+    return (8 - (num_deltas * sizeof(uint16_t)) % 8) % 8;
+}
+
+} // namespace
+
+bool TimestampIndex::append(uint64_t block_number, uint64_t timestamp) {
+    std::unique_lock lock{mutex_};
+    if (block_number > deltas_.size()) {
+        return false;
+    }
+    const auto parent_timestamp = block_number > 0 ? timestamp_locked(block_number - 1) : 0;
+    if (timestamp < parent_timestamp) {
+        return false;
+    }
+    truncate_locked(block_number);
+
+    if (block_number % kCheckpointInterval == 0) {
+        checkpoints_.push_back(timestamp);
+        deltas_.push_back(0);
+    } else {
+        const auto delta = timestamp - parent_timestamp;
+        if (delta >= kEscapeDelta) {
+            deltas_.push_back(kEscapeDelta);
+            long_deltas_.emplace(block_number, delta);
+        } else {
+            deltas_.push_back(static_cast<uint16_t>(delta));
+        }
+    }
+    last_timestamp_ = timestamp;
+    return true;
+}
+
+void TimestampIndex::truncate(uint64_t from_block) {
+    std::unique_lock lock{mutex_};
+    truncate_locked(from_block);
+}
+
+uint64_t TimestampIndex::size() const {
+    std::shared_lock lock{mutex_};
+    return deltas_.size();
+}
+
+std::optional<uint64_t> TimestampIndex::timestamp(uint64_t block_number) const {
+    std::shared_lock lock{mutex_};
+    if (block_number >= deltas_.size()) {
+        return std::nullopt;
+    }
+    return timestamp_locked(block_number);
+}
+
+std::optional<uint64_t> TimestampIndex::find_block(uint64_t timestamp) const {
+    std::shared_lock lock{mutex_};
+    if (deltas_.empty() || timestamp >= last_timestamp_) {
+        return std::nullopt;
+    }
+    if (timestamp < checkpoints_.front()) {
+        return 0;
+    }
+    const auto checkpoint = static_cast<std::size_t>(std::upper_bound(checkpoints_.cbegin(), checkpoints_.cend(), timestamp) - checkpoints_.cbegin() - 1);
+    uint64_t block_number{checkpoint * kCheckpointInterval};
+    uint64_t block_timestamp{checkpoints_[checkpoint]};
+    for (auto next{block_number + 1}; next < deltas_.size(); ++next) {
+        const uint64_t delta = deltas_[next] == kEscapeDelta ? long_deltas_.at(next) : deltas_[next];
+        if (next % kCheckpointInterval == 0 || block_timestamp + delta > timestamp) {
+            break;
+        }
+        block_timestamp += delta;
+        block_number = next;
+    }
+    return block_number;
+}
+
+void TimestampIndex::save(const std::filesystem::path& file_path) const {
+    std::shared_lock lock{mutex_};
+
+    // Write into a temporary file renamed at the end, so that an interrupted write never leaves a truncated file
+    auto tmp_file_path = file_path;
+    tmp_file_path += ".tmp";
+    {
+        std::ofstream output{tmp_file_path, std::ios::binary | std::ios::trunc};
+        if (!output) {
+            throw std::runtime_error{"cannot open timestamp index file: " + tmp_file_path.string()};
+        }
+        output.write(kTimestampIndexMagic.data(), static_cast<std::streamsize>(kTimestampIndexMagic.size()));
+        const uint64_t num_blocks{deltas_.size()};
+        const uint64_t num_long_deltas{long_deltas_.size()};
+        write_values(output, &num_blocks, 1);
+        write_values(output, &num_long_deltas, 1);
+        write_values(output, checkpoints_.data(), checkpoints_.size());
+        write_values(output, deltas_.data(), deltas_.size());
+        const uint8_t padding[8]{};
+        write_values(output, padding, padding_of(deltas_.size()));
+        for (const auto& [block_number, delta] : long_deltas_) {
+            const uint64_t long_delta[2]{block_number, delta};
+            write_values(output, long_delta, 2);
+        }
+        if (!output.flush()) {
+            throw std::runtime_error{"cannot write timestamp index file: " + tmp_file_path.string()};
+        }
+    }
+    std::filesystem::rename(tmp_file_path, file_path);
+}
+
+bool TimestampIndex::load(const std::filesystem::path& file_path) {
+    std::ifstream input{file_path, std::ios::binary};
+    if (!input) {
+        return false;
+    }
+    std::string magic(kTimestampIndexMagic.size(), '\0');
+    if (!input.read(magic.data(), static_cast<std::streamsize>(magic.size())) || magic != kTimestampIndexMagic) {
+        return false;
+    }
+    uint64_t num_blocks{0};
+    uint64_t num_long_deltas{0};
+    if (!read_values(input, &num_blocks, 1) || !read_values(input, &num_long_deltas, 1) || num_long_deltas > num_blocks) {
+        return false;
+    }
+    const auto file_size = std::filesystem::file_size(file_path);
+    const auto num_checkpoints = (num_blocks + kCheckpointInterval - 1) / kCheckpointInterval;
+    const auto expected_size = kTimestampIndexMagic.size() + 2 * sizeof(uint64_t) + num_checkpoints * sizeof(uint64_t) +
+        num_blocks * sizeof(uint16_t) + padding_of(num_blocks) + num_long_deltas * 2 * sizeof(uint64_t);
+    if (file_size != expected_size) {
+        return false;
+    }
+
+    std::vector<uint64_t> checkpoints(num_checkpoints);
+    std::vector<uint16_t> deltas(num_blocks);
+    uint8_t padding[8]{};
+    if (!read_values(input, checkpoints.data(), checkpoints.size()) || !read_values(input, deltas.data(), deltas.size()) ||
+        !read_values(input, padding, padding_of(num_blocks))) {
+        return false;
+    }
+    std::map<uint64_t, uint64_t> long_deltas;
+    for (uint64_t i{0}; i < num_long_deltas; ++i) {
+        uint64_t long_delta[2]{};
+        if (!read_values(input, long_delta, 2) || long_delta[0] >= num_blocks || deltas[long_delta[0]] != kEscapeDelta) {
+            return false;
+        }
+        long_deltas.emplace(long_delta[0], long_delta[1]);
+    }
+    for (uint64_t block_number{0}; block_number < num_blocks; ++block_number) {
+        if (block_number % kCheckpointInterval != 0 && deltas[block_number] == kEscapeDelta && !long_deltas.contains(block_number)) {
+            return false;
+        }
+    }
+
+    std::unique_lock lock{mutex_};
+    checkpoints_ = std::move(checkpoints);
+    deltas_ = std::move(deltas);
+    long_deltas_ = std::move(long_deltas);
+    last_timestamp_ = deltas_.empty() ? 0 : timestamp_locked(deltas_.size() - 1);
+    return true;
+}
+
+uint64_t TimestampIndex::timestamp_locked(uint64_t block_number) const {
+    const auto checkpoint = block_number / kCheckpointInterval;
+    uint64_t timestamp{checkpoints_[checkpoint]};
+    for (auto next{checkpoint * kCheckpointInterval + 1}; next <= block_number; ++next) {
+        timestamp += deltas_[next] == kEscapeDelta ? long_deltas_.at(next) : deltas_[next];
+    }
+    return timestamp;
+}
+
+void TimestampIndex::truncate_locked(uint64_t from_block) {
+    if (from_block >= deltas_.size()) {
+        return;
+    }
+    deltas_.resize(from_block);
+    checkpoints_.resize((from_block + kCheckpointInterval - 1) / kCheckpointInterval);
+    long_deltas_.erase(long_deltas_.lower_bound(from_block), long_deltas_.end());
+    last_timestamp_ = from_block > 0 ? timestamp_locked(from_block - 1) : 0;
+}
+
+} // namespace silkrpc
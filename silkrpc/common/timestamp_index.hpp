@@ -0,0 +1,83 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef SILKRPC_COMMON_TIMESTAMP_INDEX_HPP_
+#define SILKRPC_COMMON_TIMESTAMP_INDEX_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
+
+namespace silkrpc {
+
+//! In-memory index of the block timestamps by block number, contiguous from genesis, so that finding the block at some
+//! timestamp is a local binary search rather than a remote header read for each probe. The timestamps are delta-encoded
+//! on 16 bits from the previous block (the rare longer gaps are kept aside) with an absolute checkpoint every so many
+//! blocks, i.e. about 2 bytes per block. The index is appended at each new head, truncated when unwinding and saved to
+//! a flat file of fixed-width arrays, which can be read back or memory-mapped as is.
+class TimestampIndex {
+public:
+    //! The number of blocks between two absolute timestamps
+    static constexpr std::size_t kCheckpointInterval{256};
+
+    TimestampIndex() = default;
+
+    TimestampIndex(const TimestampIndex&) = delete;
+    TimestampIndex& operator=(const TimestampIndex&) = delete;
+
+    //! Append the timestamp of the block, replacing the ones of the same and higher blocks if any: return false if the
+    //! block is beyond the next one to index or its timestamp is lower than the parent one
+    bool append(uint64_t block_number, uint64_t timestamp);
+
+    //! Remove the timestamps of all the blocks starting from the specified one
+    void truncate(uint64_t from_block);
+
+    //! The number of blocks indexed, i.e. the next block to index
+    uint64_t size() const;
+
+    //! Return the timestamp of the block, if indexed
+    std::optional<uint64_t> timestamp(uint64_t block_number) const;
+
+    //! Return the highest block having timestamp not greater than the specified one, or genesis if none has: nothing if the
+    //! timestamp is not lower than the last indexed one, because the blocks not indexed yet may match it as well
+    std::optional<uint64_t> find_block(uint64_t timestamp) const;
+
+    //! Write the index into the file, atomically replacing it
+    void save(const std::filesystem::path& file_path) const;
+
+    //! Read the index from the file, replacing the current content: return false if missing or invalid
+    bool load(const std::filesystem::path& file_path);
+
+private:
+    //! The delta escaping to the longer gaps kept aside
+    static constexpr uint16_t kEscapeDelta{0xffff};
+
+    uint64_t timestamp_locked(uint64_t block_number) const;
+    void truncate_locked(uint64_t from_block);
+
+    mutable std::shared_mutex mutex_;
+    std::vector<uint64_t> checkpoints_;
+    std::vector<uint16_t> deltas_;
+    std::map<uint64_t, uint64_t> long_deltas_;
+    uint64_t last_timestamp_{0};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_TIMESTAMP_INDEX_HPP_
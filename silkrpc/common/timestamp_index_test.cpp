@@ -0,0 +1,139 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "timestamp_index.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+static constexpr uint64_t kGenesisTimestamp{1'438'269'973};
+
+//! Append the blocks up to the specified one, each 13 seconds after its parent and a long gap before block 1
+static void fill(TimestampIndex& index, uint64_t num_blocks) {
+    for (uint64_t i{index.size()}; i < num_blocks; ++i) {
+        const auto timestamp = i == 0 ? 0 : kGenesisTimestamp + 13 * i;
+        REQUIRE(index.append(i, timestamp));
+    }
+}
+
+TEST_CASE("TimestampIndex::append", "[silkrpc][common][timestamp_index]") {
+    TimestampIndex index;
+    CHECK(index.size() == 0);
+    CHECK(!index.timestamp(0));
+    CHECK(!index.append(1, 100));
+
+    fill(index, 1000);
+    CHECK(index.size() == 1000);
+    CHECK(index.timestamp(0) == 0);
+    CHECK(index.timestamp(1) == kGenesisTimestamp + 13);
+    CHECK(index.timestamp(255) == kGenesisTimestamp + 13 * 255);
+    CHECK(index.timestamp(256) == kGenesisTimestamp + 13 * 256);
+    CHECK(index.timestamp(999) == kGenesisTimestamp + 13 * 999);
+    CHECK(!index.timestamp(1000));
+
+    SECTION("gap") {
+        CHECK(!index.append(1001, kGenesisTimestamp + 13 * 1001));
+        CHECK(index.size() == 1000);
+    }
+
+    SECTION("timestamp lower than the parent one") {
+        CHECK(!index.append(1000, kGenesisTimestamp));
+        CHECK(index.size() == 1000);
+    }
+
+    SECTION("long gap") {
+        const auto timestamp = kGenesisTimestamp + 13 * 999 + 100'000;
+        CHECK(index.append(1000, timestamp));
+        CHECK(index.timestamp(1000) == timestamp);
+    }
+
+    SECTION("replacing higher blocks") {
+        CHECK(index.append(500, kGenesisTimestamp + 13 * 500 + 1));
+        CHECK(index.size() == 501);
+        CHECK(index.timestamp(500) == kGenesisTimestamp + 13 * 500 + 1);
+        CHECK(index.timestamp(499) == kGenesisTimestamp + 13 * 499);
+    }
+}
+
+TEST_CASE("TimestampIndex::truncate", "[silkrpc][common][timestamp_index]") {
+    TimestampIndex index;
+    fill(index, 600);
+
+    index.truncate(512);
+    CHECK(index.size() == 512);
+    CHECK(index.timestamp(511) == kGenesisTimestamp + 13 * 511);
+    CHECK(!index.timestamp(512));
+    CHECK(index.append(512, kGenesisTimestamp + 13 * 512));
+
+    index.truncate(0);
+    CHECK(index.size() == 0);
+    CHECK(!index.find_block(kGenesisTimestamp));
+}
+
+TEST_CASE("TimestampIndex::find_block", "[silkrpc][common][timestamp_index]") {
+    TimestampIndex index;
+    CHECK(!index.find_block(kGenesisTimestamp));
+    fill(index, 1000);
+
+    CHECK(index.find_block(0) == 0);
+    CHECK(index.find_block(kGenesisTimestamp) == 0);
+    CHECK(index.find_block(kGenesisTimestamp + 13) == 1);
+    CHECK(index.find_block(kGenesisTimestamp + 13 * 256 - 1) == 255);
+    CHECK(index.find_block(kGenesisTimestamp + 13 * 256) == 256);
+    CHECK(index.find_block(kGenesisTimestamp + 13 * 700 + 5) == 700);
+    CHECK(index.find_block(kGenesisTimestamp + 13 * 998 + 12) == 998);
+
+    // The blocks not indexed yet may match as well
+    CHECK(!index.find_block(kGenesisTimestamp + 13 * 999));
+    CHECK(!index.find_block(kGenesisTimestamp + 13 * 2000));
+}
+
+TEST_CASE("TimestampIndex::save and load", "[silkrpc][common][timestamp_index]") {
+    const auto file_path = std::filesystem::temp_directory_path() / "silkrpc_timestamp_index_test";
+    std::filesystem::remove(file_path);
+
+    TimestampIndex index;
+    CHECK(!index.load(file_path));
+    fill(index, 777);
+    index.save(file_path);
+
+    TimestampIndex loaded_index;
+    REQUIRE(loaded_index.load(file_path));
+    CHECK(loaded_index.size() == 777);
+    CHECK(loaded_index.timestamp(1) == kGenesisTimestamp + 13);
+    CHECK(loaded_index.timestamp(776) == kGenesisTimestamp + 13 * 776);
+    CHECK(loaded_index.find_block(kGenesisTimestamp + 13 * 300) == 300);
+    CHECK(loaded_index.append(777, kGenesisTimestamp + 13 * 777));
+
+    SECTION("truncated file") {
+        std::filesystem::resize_file(file_path, std::filesystem::file_size(file_path) - 1);
+        TimestampIndex truncated_index;
+        CHECK(!truncated_index.load(file_path));
+    }
+
+    SECTION("unknown format") {
+        std::ofstream{file_path, std::ios::binary | std::ios::trunc} << "not an index";
+        TimestampIndex unknown_index;
+        CHECK(!unknown_index.load(file_path));
+    }
+
+    std::filesystem::remove(file_path);
+}
+
+} // namespace silkrpc
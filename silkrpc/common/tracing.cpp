@@ -0,0 +1,200 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "tracing.hpp"
+
+#include <cstdio>
+#include <stdexcept>
+#include <utility>
+
+namespace silkrpc {
+
+//! Append the text as JSON string content, escaping the characters not allowed unescaped
+static void append_escaped(std::string& output, std::string_view text) {
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            output.push_back('\\');
+            output.push_back(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[7];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(c));
+            output.append(escaped);
+        } else {
+            output.push_back(c);
+        }
+    }
+}
+
+//! Return the duration in microseconds with nanosecond precision, as expected by the trace event format
+static std::string to_microseconds(std::chrono::nanoseconds duration) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3f", static_cast<double>(duration.count()) / 1'000);
+    return text;
+}
+
+TraceSpan::TraceSpan(const TraceContext& context, const char* name) {
+    if (context) {
+        tracer_ = context.tracer;
+        span_.trace_id = context.trace_id;
+        span_.span_id = tracer_->next_id();
+        span_.parent_id = context.parent_id;
+        span_.name = name;
+        span_.start = std::chrono::steady_clock::now();
+    }
+}
+
+TraceSpan::TraceSpan(const TraceContext& context, const char* name, std::chrono::steady_clock::time_point start)
+    : TraceSpan{context, name} {
+    span_.start = start;
+}
+
+TraceSpan::TraceSpan(TraceSpan&& other) noexcept : tracer_{std::exchange(other.tracer_, nullptr)}, span_{std::move(other.span_)} {}
+
+TraceSpan& TraceSpan::operator=(TraceSpan&& other) noexcept {
+    if (this != &other) {
+        end();
+        tracer_ = std::exchange(other.tracer_, nullptr);
+        span_ = std::move(other.span_);
+    }
+    return *this;
+}
+
+TraceContext TraceSpan::context() const noexcept {
+    return tracer_ ? TraceContext{tracer_, span_.trace_id, span_.span_id} : TraceContext{};
+}
+
+void TraceSpan::set_attribute(std::string_view key, std::string_view value) {
+    if (!tracer_) {
+        return;
+    }
+    span_.attributes.append(",\"").append(key).append("\":\"");
+    append_escaped(span_.attributes, value);
+    span_.attributes.push_back('"');
+}
+
+void TraceSpan::set_attribute(std::string_view key, uint64_t value) {
+    if (!tracer_) {
+        return;
+    }
+    span_.attributes.append(",\"").append(key).append("\":").append(std::to_string(value));
+}
+
+void TraceSpan::end() {
+    if (!tracer_) {
+        return;
+    }
+    span_.duration = std::chrono::steady_clock::now() - span_.start;
+    std::exchange(tracer_, nullptr)->record(std::move(span_));
+}
+
+//! The instances are told apart by id rather than address, so that no thread can mistake a new tracer for a dead one
+static std::atomic<uint64_t> next_tracer_id{1};
+
+Tracer::Tracer(const std::filesystem::path& file_path, uint32_t sample_interval)
+    : instance_id_{next_tracer_id.fetch_add(1)}, sample_interval_{sample_interval}, origin_{std::chrono::steady_clock::now()},
+      file_{file_path, std::ios::out | std::ios::trunc} {
+    if (!file_) {
+        throw std::runtime_error{"cannot open trace file " + file_path.string()};
+    }
+    file_ << "[";
+    exporter_ = std::thread{[&]() { run_exporter(); }};
+}
+
+Tracer::~Tracer() {
+    {
+        std::scoped_lock lock{exporter_mutex_};
+        stopping_ = true;
+    }
+    exporter_cv_.notify_one();
+    exporter_.join();
+    flush();
+    file_ << "\n]\n";
+}
+
+TraceContext Tracer::start_trace() {
+    if (sample_interval_ == 0 || sample_count_.fetch_add(1, std::memory_order_relaxed) % sample_interval_ != 0) {
+        return {};
+    }
+    return {this, next_id(), 0};
+}
+
+void Tracer::record(Span&& span) {
+    if (!this_thread_buffer().spans.push(std::move(span))) {
+        dropped_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Tracer::flush() {
+    std::scoped_lock lock{export_mutex_};
+    export_spans();
+}
+
+Tracer::ThreadBuffer& Tracer::this_thread_buffer() {
+    // Just one tracer is expected, so the buffer of the latest one used by the thread is enough not to lock
+    thread_local struct {
+        uint64_t instance_id{0};
+        std::shared_ptr<ThreadBuffer> buffer;
+    } cached;
+    if (cached.instance_id != instance_id_) {
+        std::scoped_lock lock{buffers_mutex_};
+        cached.buffer = std::make_shared<ThreadBuffer>(next_thread_index_++);
+        cached.instance_id = instance_id_;
+        buffers_.push_back(cached.buffer);
+    }
+    return *cached.buffer;
+}
+
+void Tracer::run_exporter() {
+    std::unique_lock lock{exporter_mutex_};
+    while (!stopping_) {
+        exporter_cv_.wait_for(lock, kExportInterval);
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+void Tracer::export_spans() {
+    std::scoped_lock lock{buffers_mutex_};
+    for (auto it = buffers_.begin(); it != buffers_.end();) {
+        auto& buffer = **it;
+        buffer.spans.drain(drained_spans_);
+        for (const auto& span : drained_spans_) {
+            write_span(span, buffer.thread_index);
+        }
+        exported_count_.fetch_add(drained_spans_.size(), std::memory_order_relaxed);
+        drained_spans_.clear();
+        // The buffers of the exited threads are not referenced by them anymore
+        if (it->use_count() == 1 && buffer.spans.empty()) {
+            it = buffers_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    file_.flush();
+}
+
+void Tracer::write_span(const Span& span, uint32_t thread_index) {
+    file_ << (first_event_ ? "\n" : ",\n");
+    first_event_ = false;
+    file_ << R"({"name":")" << span.name << R"(","cat":"silkrpc","ph":"X","pid":1,"tid":)" << thread_index
+          << R"(,"ts":)" << to_microseconds(span.start - origin_) << R"(,"dur":)" << to_microseconds(span.duration)
+          << R"(,"args":{"trace_id":)" << span.trace_id << R"(,"span_id":)" << span.span_id << R"(,"parent_id":)" << span.parent_id
+          << span.attributes << "}}";
+}
+
+} // namespace silkrpc
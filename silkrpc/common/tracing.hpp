@@ -0,0 +1,167 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_COMMON_TRACING_HPP_
+#define SILKRPC_COMMON_TRACING_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <silkrpc/concurrency/spsc_ring.hpp>
+
+namespace silkrpc {
+
+class Tracer;
+
+//! A finished span, i.e. one timed operation of a traced request
+struct Span {
+    uint64_t trace_id{0};
+    uint64_t span_id{0};
+    //! The id of the enclosing span, zero for the root span of the trace
+    uint64_t parent_id{0};
+    //! The operation name, which must be a string literal
+    const char* name{""};
+    //! The attributes as comma-separated JSON members
+    std::string attributes;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::nanoseconds duration{0};
+};
+
+//! The trace of a sampled request along with the parent of its new spans, empty if the request is not traced
+struct TraceContext {
+    Tracer* tracer{nullptr};
+    uint64_t trace_id{0};
+    uint64_t parent_id{0};
+
+    explicit operator bool() const noexcept { return tracer != nullptr; }
+
+    friend bool operator==(const TraceContext&, const TraceContext&) = default;
+};
+
+//! Span under construction, recorded when ended or destroyed: nothing is done (not even reading the clock) when the
+//! context is empty, so that the spans cost nothing to the requests not sampled
+class TraceSpan {
+public:
+    TraceSpan() = default;
+    TraceSpan(const TraceContext& context, const char* name);
+    TraceSpan(const TraceContext& context, const char* name, std::chrono::steady_clock::time_point start);
+    ~TraceSpan() { end(); }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+    TraceSpan(TraceSpan&& other) noexcept;
+    TraceSpan& operator=(TraceSpan&& other) noexcept;
+
+    bool is_recording() const noexcept { return tracer_ != nullptr; }
+
+    //! Return the context for the children of this span, empty if not recording
+    TraceContext context() const noexcept;
+
+    void set_attribute(std::string_view key, std::string_view value);
+    void set_attribute(std::string_view key, uint64_t value);
+
+    //! Record the span as finished now, if recording and not ended yet
+    void end();
+
+private:
+    Tracer* tracer_{nullptr};
+    Span span_;
+};
+
+//! Tracer sampling one request out of sample_interval and exporting their spans into a file in the Chrome trace event
+//! format (JSON array format, viewable by chrome://tracing or Perfetto). The spans are recorded lock-free into buffers
+//! owned by each thread and written by a background exporter, which drops them if a buffer becomes full.
+class Tracer {
+public:
+    //! Number of spans buffered by each thread before dropping
+    static constexpr std::size_t kBufferCapacity{4096};
+
+    //! Max time the exporter waits before writing the buffered spans
+    static constexpr std::chrono::milliseconds kExportInterval{100};
+
+    Tracer(const std::filesystem::path& file_path, uint32_t sample_interval);
+    ~Tracer();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    //! Return the context of a new trace if the next request is sampled, otherwise an empty context
+    TraceContext start_trace();
+
+    //! Return a new trace or span id, unique within this tracer
+    uint64_t next_id() noexcept { return next_id_.fetch_add(1, std::memory_order_relaxed); }
+
+    //! Buffer the finished span for export, called by the recording thread
+    void record(Span&& span);
+
+    //! Write all the spans buffered so far
+    void flush();
+
+    uint64_t exported_count() const noexcept { return exported_count_.load(std::memory_order_relaxed); }
+    uint64_t dropped_count() const noexcept { return dropped_count_.load(std::memory_order_relaxed); }
+
+private:
+    struct ThreadBuffer {
+        explicit ThreadBuffer(uint32_t index) : thread_index{index} {}
+
+        SpscRing<Span> spans{kBufferCapacity};
+        const uint32_t thread_index;
+    };
+
+    ThreadBuffer& this_thread_buffer();
+    void run_exporter();
+    void export_spans();
+    void write_span(const Span& span, uint32_t thread_index);
+
+    const uint64_t instance_id_;
+    const uint32_t sample_interval_;
+    const std::chrono::steady_clock::time_point origin_;
+    std::atomic<uint64_t> sample_count_{0};
+    std::atomic<uint64_t> next_id_{1};
+    std::atomic<uint64_t> exported_count_{0};
+    std::atomic<uint64_t> dropped_count_{0};
+
+    //! Registry of the per-thread buffers, locked just when a thread records its first span and when exporting
+    std::mutex buffers_mutex_;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+    uint32_t next_thread_index_{1};
+
+    //! Export state, accessed by one thread at a time (i.e. the exporter or the flushing thread)
+    std::mutex export_mutex_;
+    std::ofstream file_;
+    std::vector<Span> drained_spans_;
+    bool first_event_{true};
+
+    std::mutex exporter_mutex_;
+    std::condition_variable exporter_cv_;
+    bool stopping_{false};
+    std::thread exporter_;
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_TRACING_HPP_
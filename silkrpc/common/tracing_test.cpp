@@ -0,0 +1,141 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "tracing.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <catch2/catch.hpp>
+#include <nlohmann/json.hpp>
+
+namespace silkrpc {
+
+static std::filesystem::path make_trace_file_path() {
+    return std::filesystem::temp_directory_path() / ("silkrpc_trace_" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".json");
+}
+
+static nlohmann::json read_trace_file(const std::filesystem::path& file_path) {
+    std::ifstream file{file_path};
+    std::stringstream content;
+    content << file.rdbuf();
+    return nlohmann::json::parse(content.str());
+}
+
+TEST_CASE("TraceSpan with empty context", "[silkrpc][common][tracing]") {
+    TraceSpan span{TraceContext{}, "test"};
+    span.set_attribute("key", "value");
+    CHECK(!span.is_recording());
+    CHECK(!span.context());
+    CHECK_NOTHROW(span.end());
+}
+
+TEST_CASE("Tracer samples one request every interval", "[silkrpc][common][tracing]") {
+    const auto file_path = make_trace_file_path();
+
+    SECTION("zero interval disables tracing") {
+        Tracer tracer{file_path, 0};
+        CHECK(!tracer.start_trace());
+        CHECK(!tracer.start_trace());
+    }
+
+    SECTION("interval") {
+        Tracer tracer{file_path, 3};
+        CHECK(tracer.start_trace());
+        CHECK(!tracer.start_trace());
+        CHECK(!tracer.start_trace());
+        const auto trace = tracer.start_trace();
+        CHECK(trace);
+        CHECK(trace.tracer == &tracer);
+        CHECK(trace.trace_id != 0);
+        CHECK(trace.parent_id == 0);
+    }
+
+    std::filesystem::remove(file_path);
+}
+
+TEST_CASE("Tracer exports spans in trace event format", "[silkrpc][common][tracing]") {
+    const auto file_path = make_trace_file_path();
+    uint64_t trace_id{0};
+    uint64_t root_id{0};
+    {
+        Tracer tracer{file_path, 1};
+        const auto trace = tracer.start_trace();
+        trace_id = trace.trace_id;
+        TraceSpan root{trace, "root"};
+        root_id = root.context().parent_id;
+        {
+            TraceSpan child{root.context(), "child"};
+            child.set_attribute("table", "Plain\"State");
+            child.set_attribute("bytes", uint64_t{42});
+        }
+        std::thread{[&]() {
+            TraceSpan other{root.context(), "other"};
+        }}.join();
+        root.end();
+        tracer.flush();
+        CHECK(tracer.exported_count() == 3);
+        CHECK(tracer.dropped_count() == 0);
+    }
+
+    const auto events = read_trace_file(file_path);
+    REQUIRE(events.is_array());
+    REQUIRE(events.size() == 3);
+    std::map<std::string, nlohmann::json> event_by_name;
+    for (const auto& event : events) {
+        event_by_name[event["name"].get<std::string>()] = event;
+        CHECK(event["ph"] == "X");
+        CHECK(event["args"]["trace_id"] == trace_id);
+    }
+    CHECK(event_by_name["root"]["args"]["parent_id"] == 0);
+    CHECK(event_by_name["root"]["args"]["span_id"] == root_id);
+    CHECK(event_by_name["child"]["args"]["parent_id"] == root_id);
+    CHECK(event_by_name["child"]["args"]["table"] == "Plain\"State");
+    CHECK(event_by_name["child"]["args"]["bytes"] == 42);
+    CHECK(event_by_name["other"]["args"]["parent_id"] == root_id);
+    CHECK(event_by_name["other"]["tid"] != event_by_name["child"]["tid"]);
+    CHECK(event_by_name["root"]["dur"].get<double>() >= event_by_name["child"]["dur"].get<double>());
+
+    std::filesystem::remove(file_path);
+}
+
+TEST_CASE("TraceSpan move", "[silkrpc][common][tracing]") {
+    const auto file_path = make_trace_file_path();
+    {
+        Tracer tracer{file_path, 1};
+        TraceSpan span;
+        CHECK(!span.is_recording());
+        span = TraceSpan{tracer.start_trace(), "moved"};
+        CHECK(span.is_recording());
+        TraceSpan other{std::move(span)};
+        CHECK(!span.is_recording());  // NOLINT(bugprone-use-after-move)
+        CHECK(other.is_recording());
+        other.end();
+        CHECK(!other.is_recording());
+        tracer.flush();
+        CHECK(tracer.exported_count() == 1);
+    }
+    CHECK(read_trace_file(file_path).size() == 1);
+    std::filesystem::remove(file_path);
+}
+
+} // namespace silkrpc
@@ -0,0 +1,51 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "trie_node_cache.hpp"
+
+#include <cstring>
+#include <utility>
+
+#include <boost/endian/conversion.hpp>
+#include <silkworm/common/util.hpp>
+
+namespace silkrpc {
+
+std::shared_ptr<const KeyValue> TrieNodeCache::find(uint64_t view_id, const std::string& table, silkworm::ByteView seek_key) {
+    return get(key_of(view_id, table, seek_key));
+}
+
+void TrieNodeCache::store(uint64_t view_id, const std::string& table, silkworm::ByteView seek_key, KeyValue kv) {
+    insert(key_of(view_id, table, seek_key), std::make_shared<const KeyValue>(std::move(kv)));
+}
+
+std::size_t TrieNodeCache::approximate_size(const KeyValue& kv) {
+    return sizeof(kv) + kv.key.capacity() + kv.value.capacity() + kCacheEntryOverhead;
+}
+
+evmc::bytes32 TrieNodeCache::key_of(uint64_t view_id, const std::string& table, silkworm::ByteView seek_key) {
+    silkworm::Bytes cache_key_bytes(sizeof(uint64_t), '\0');
+    boost::endian::store_big_u64(&cache_key_bytes[0], view_id);
+    cache_key_bytes.append(table.begin(), table.end());
+    cache_key_bytes.append(seek_key);
+    const auto hash{silkworm::keccak256(cache_key_bytes)};
+    evmc::bytes32 cache_key;
+    std::memcpy(cache_key.bytes, hash.bytes, sizeof(cache_key.bytes));
+    return cache_key;
+}
+
+} // namespace silkrpc
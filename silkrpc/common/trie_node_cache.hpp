@@ -0,0 +1,64 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_COMMON_TRIE_NODE_CACHE_HPP_
+#define SILKRPC_COMMON_TRIE_NODE_CACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <evmc/evmc.hpp>
+#include <silkworm/common/base.hpp>
+
+#include <silkrpc/common/sharded_cache.hpp>
+#include <silkrpc/common/util.hpp>
+
+namespace silkrpc {
+
+//! Cache of the trie table records found seeking the intermediate trie nodes at some path, shared by all the proofs built
+//! on the same database view: the proofs for the same contracts, or just close enough accounts, share most of the upper
+//! nodes. The trie tables change at each block, so the records are keyed by view id and those of the older views just
+//! age out (see ShardedCache), while the upper nodes hit by many proofs are kept by frequency rather than recency.
+class TrieNodeCache : public ShardedCache<KeyValue> {
+public:
+    //! The default memory budget in bytes
+    static constexpr std::size_t kDefaultMaxBytes{32 * 1024 * 1024};
+
+    //! The hits counted for each record, i.e. the number of sweeps a record hit often survives
+    static constexpr uint8_t kMaxFrequency{4};
+
+    explicit TrieNodeCache(std::size_t max_bytes = kDefaultMaxBytes, bool shared_cache = true, std::size_t num_shards = kDefaultNumShards)
+    : ShardedCache{&TrieNodeCache::approximate_size, max_bytes, shared_cache, num_shards, kMaxFrequency} {}
+
+    //! Return the cached record found seeking the key in the trie table of the view, if any, or nullptr otherwise
+    std::shared_ptr<const KeyValue> find(uint64_t view_id, const std::string& table, silkworm::ByteView seek_key);
+
+    //! Store the record found seeking the key in the trie table of the view (empty if none)
+    void store(uint64_t view_id, const std::string& table, silkworm::ByteView seek_key, KeyValue kv);
+
+    //! Return the approximate memory footprint of the record, including the bookkeeping of its cache entry
+    static std::size_t approximate_size(const KeyValue& kv);
+
+private:
+    static evmc::bytes32 key_of(uint64_t view_id, const std::string& table, silkworm::ByteView seek_key);
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_TRIE_NODE_CACHE_HPP_
@@ -0,0 +1,73 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "trie_node_cache.hpp"
+
+#include <catch2/catch.hpp>
+#include <silkworm/common/util.hpp>
+
+namespace silkrpc {
+
+TEST_CASE("TrieNodeCache::find", "[silkrpc][common][trie_node_cache]") {
+    TrieNodeCache cache;
+    const silkworm::Bytes seek_key{0x01, 0x02};
+    const KeyValue kv{silkworm::Bytes{0x01, 0x02, 0x03}, *silkworm::from_hex("ffff00000001")};
+    CHECK(cache.find(1, "TrieAccount", seek_key) == nullptr);
+
+    cache.store(1, "TrieAccount", seek_key, kv);
+    const auto cached = cache.find(1, "TrieAccount", seek_key);
+    REQUIRE(cached);
+    CHECK(cached->key == kv.key);
+    CHECK(cached->value == kv.value);
+    CHECK(cache.size() == 1);
+    CHECK(cache.size_bytes() == TrieNodeCache::approximate_size(kv));
+
+    SECTION("another view") {
+        CHECK(cache.find(2, "TrieAccount", seek_key) == nullptr);
+    }
+
+    SECTION("another table") {
+        CHECK(cache.find(1, "TrieStorage", seek_key) == nullptr);
+    }
+
+    SECTION("another key") {
+        CHECK(cache.find(1, "TrieAccount", silkworm::Bytes{0x01}) == nullptr);
+    }
+}
+
+TEST_CASE("TrieNodeCache stores the missing records", "[silkrpc][common][trie_node_cache]") {
+    TrieNodeCache cache;
+    cache.store(1, "TrieAccount", silkworm::Bytes{0x0f}, KeyValue{});
+    const auto cached = cache.find(1, "TrieAccount", silkworm::Bytes{0x0f});
+    REQUIRE(cached);
+    CHECK(cached->key.empty());
+    CHECK(cached->value.empty());
+}
+
+TEST_CASE("TrieNodeCache is bounded by its memory budget", "[silkrpc][common][trie_node_cache]") {
+    const KeyValue kv{silkworm::Bytes(8, 0x01), silkworm::Bytes(6 + 16 * 32, 0x02)};
+    const auto kv_size{TrieNodeCache::approximate_size(kv)};
+    TrieNodeCache cache{10 * kv_size, true, 1};
+    for (uint64_t view_id{0}; view_id < 100; ++view_id) {
+        cache.store(view_id, "TrieAccount", silkworm::Bytes{}, kv);
+    }
+    CHECK(cache.size() <= 10);
+    CHECK(cache.size_bytes() <= 10 * kv_size);
+    CHECK(cache.find(99, "TrieAccount", silkworm::Bytes{}));
+}
+
+} // namespace silkrpc
@@ -0,0 +1,34 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_USDT_HPP_
+#define SILKRPC_COMMON_USDT_HPP_
+
+//! Static tracepoints (USDT) of the silkrpc provider on the hot paths, for eBPF tools like bpftrace, e.g.
+//!   bpftrace -e 'usdt:./silkrpc:silkrpc:cursor_op_done { @ns[str(arg0), str(arg1)] = hist(nsecs - arg3); }'
+//! When enabled (see SILKRPC_USE_USDT) each probe is a single nop until attached, its arguments being just evaluated into
+//! registers: keep them cheap, i.e. integers or pointers to data already at hand. The times are CLOCK_MONOTONIC nanoseconds
+//! (clock_time::now), the same clock as nsecs in bpftrace.
+//! When disabled the probes are compiled out, arguments included.
+#if defined(SILKRPC_HAS_USDT)
+#include <sys/sdt.h>
+
+#define SILKRPC_PROBE(name, ...) STAP_PROBEV(silkrpc, name, __VA_ARGS__)
+#else
+#define SILKRPC_PROBE(name, ...) do {} while (false)
+#endif
+
+#endif // SILKRPC_COMMON_USDT_HPP_
@@ -19,6 +19,7 @@
 
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -48,6 +49,19 @@ inline bool operator==(const KeyValue& lhs, const KeyValue& rhs) {
     return lhs.key == rhs.key;
 }
 
+//! Key-value pair borrowed from the buffers owned by its producer, e.g. a cursor, valid just as long as they are
+struct KeyValueView {
+    silkworm::ByteView key;
+    silkworm::ByteView value;
+};
+
+//! View of bytes sharing the ownership of the buffer they are stored in (e.g. the reply message they have been received
+//! in), so that they can be read w/o copying them for as long as any copy of the view is kept
+struct SharedByteView {
+    std::shared_ptr<const void> owner;
+    silkworm::ByteView bytes;
+};
+
 std::string base64_encode(const uint8_t* bytes_to_encode, size_t len, bool url);
 
 std::string to_dec(intx::uint256 number);
@@ -109,6 +123,20 @@ inline auto hash_of_transaction(const silkworm::Transaction& txn) {
     return ethash::keccak256(txn_rlp.data(), txn_rlp.length());
 }
 
+//! Return the hashes of the transactions, encoding all of them into the same buffer
+inline std::vector<evmc::bytes32> hashes_of_transactions(const std::vector<silkworm::Transaction>& transactions) {
+    std::vector<evmc::bytes32> hashes;
+    hashes.reserve(transactions.size());
+    silkworm::Bytes txn_rlp{};
+    for (const auto& txn : transactions) {
+        txn_rlp.clear();
+        silkworm::rlp::encode(txn_rlp, txn, /*for_signing=*/false, /*wrap_eip2718_as_array=*/false);
+        const auto hash{ethash::keccak256(txn_rlp.data(), txn_rlp.length())};
+        hashes.emplace_back(silkworm::to_bytes32({hash.bytes, silkworm::kHashLength}));
+    }
+    return hashes;
+}
+
 inline std::ostream& operator<<(std::ostream& out, const silkworm::ByteView& bytes) {
     for (const auto& b : bytes) {
         out << std::hex << std::setw(2) << std::setfill('0') << int(b);
@@ -57,6 +57,18 @@ TEST_CASE("calculate hash of transaction", "[silkrpc][common][util]") {
     CHECK(silkworm::to_bytes32(silkworm::ByteView{eth_hash.bytes, silkworm::kHashLength}) == 0x3763e4f6e4198413383534c763f3f5dac5c5e939f0a81724e3beb96d6e2ad0d5_bytes32);
 }
 
+TEST_CASE("calculate hashes of transactions", "[silkrpc][common][util]") {
+    CHECK(hashes_of_transactions({}).empty());
+
+    std::vector<silkworm::Transaction> transactions(2);
+    transactions[1].data = silkworm::Bytes(100, 0x01);
+    const auto hashes{hashes_of_transactions(transactions)};
+    REQUIRE(hashes.size() == 2);
+    CHECK(hashes[0] == 0x3763e4f6e4198413383534c763f3f5dac5c5e939f0a81724e3beb96d6e2ad0d5_bytes32);
+    const auto eth_hash{hash_of_transaction(transactions[1])};
+    CHECK(hashes[1] == silkworm::to_bytes32(silkworm::ByteView{eth_hash.bytes, silkworm::kHashLength}));
+}
+
 TEST_CASE("print ByteView", "[silkrpc][common][util]") {
     silkworm::ByteView bv1{};
     CHECK_NOTHROW(null_stream() << bv1);
@@ -0,0 +1,170 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "admission_control.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+namespace silkrpc {
+
+struct AdmissionControl::Waiter {
+    explicit Waiter(const boost::asio::any_io_executor& executor) : timer{executor} {}
+
+    //! The timer expiring at the end of the queue budget, cancelled on its executor when the waiter gets a slot
+    boost::asio::steady_timer timer;
+    bool granted{false};
+};
+
+AdmissionControl::Limits AdmissionControl::parse_limits(const std::string& limits_spec) {
+    Limits limits;
+    std::string_view remaining{limits_spec};
+    while (!remaining.empty()) {
+        const auto separator = remaining.find(',');
+        const auto item = remaining.substr(0, separator);
+        remaining = separator == std::string_view::npos ? std::string_view{} : remaining.substr(separator + 1);
+
+        const auto equal = item.find('=');
+        if (equal == std::string_view::npos || equal == 0) {
+            throw std::invalid_argument{"invalid admission limits: " + limits_spec};
+        }
+        const auto value = item.substr(equal + 1);
+        std::size_t limit{0};
+        const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), limit);
+        if (value.empty() || ec != std::errc{} || end != value.data() + value.size() || limit == 0) {
+            throw std::invalid_argument{"invalid admission limits: " + limits_spec};
+        }
+        limits.insert_or_assign(std::string{item.substr(0, equal)}, limit);
+    }
+    return limits;
+}
+
+AdmissionControl::AdmissionControl(const Limits& limits, std::chrono::milliseconds queue_budget) : queue_budget_{queue_budget} {
+    for (const auto& [name, limit] : limits) {
+        auto limiter = std::make_unique<Limiter>();
+        limiter->limit = limit;
+        limiters_.emplace(name, std::move(limiter));
+    }
+}
+
+AdmissionControl::Ticket& AdmissionControl::Ticket::operator=(Ticket&& other) noexcept {
+    if (this != &other) {
+        release();
+        control_ = other.control_;
+        limiter_ = other.limiter_;
+        other.limiter_ = nullptr;
+    }
+    return *this;
+}
+
+void AdmissionControl::Ticket::release() {
+    if (limiter_ != nullptr) {
+        control_->release(limiter_);
+        limiter_ = nullptr;
+    }
+}
+
+AdmissionControl::Limiter* AdmissionControl::find_limiter(const std::string& method) {
+    if (const auto it = limiters_.find(method); it != limiters_.end()) {
+        return it->second.get();
+    }
+    const auto underscore = method.find('_');
+    if (underscore == std::string::npos) {
+        return nullptr;
+    }
+    if (const auto it = limiters_.find(std::string_view{method}.substr(0, underscore)); it != limiters_.end()) {
+        return it->second.get();
+    }
+    return nullptr;
+}
+
+boost::asio::awaitable<std::optional<AdmissionControl::Ticket>> AdmissionControl::admit(const std::string& method) {
+    auto* limiter = find_limiter(method);
+    if (limiter == nullptr) {
+        co_return Ticket{};
+    }
+
+    const auto executor = co_await boost::asio::this_coro::executor;
+    std::shared_ptr<Waiter> waiter;
+    {
+        std::lock_guard lock{mutex_};
+        if (limiter->in_flight < limiter->limit) {
+            ++limiter->in_flight;
+            co_return Ticket{this, limiter};
+        }
+        if (queue_budget_.count() == 0) {
+            ++limiter->rejected;
+            co_return std::nullopt;
+        }
+        waiter = std::make_shared<Waiter>(executor);
+        waiter->timer.expires_after(queue_budget_);
+        limiter->waiters.push_back(waiter);
+    }
+
+    // The wait ends either at the end of the queue budget or when the slot released by another request is handed over
+    boost::system::error_code ec;
+    co_await waiter->timer.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+    std::lock_guard lock{mutex_};
+    if (waiter->granted) {
+        co_return Ticket{this, limiter};
+    }
+    auto& waiters = limiter->waiters;
+    waiters.erase(std::remove(waiters.begin(), waiters.end(), waiter), waiters.end());
+    ++limiter->rejected;
+    co_return std::nullopt;
+}
+
+void AdmissionControl::release(Limiter* limiter) {
+    std::lock_guard lock{mutex_};
+    if (limiter->waiters.empty()) {
+        --limiter->in_flight;
+        return;
+    }
+    // Hand over the slot to the first waiter without decrementing the in-flight requests
+    auto waiter = std::move(limiter->waiters.front());
+    limiter->waiters.pop_front();
+    waiter->granted = true;
+    auto& timer = waiter->timer;
+    boost::asio::post(timer.get_executor(), [waiter = std::move(waiter)]() { waiter->timer.cancel(); });
+}
+
+void AdmissionControl::for_each(const std::function<void(const std::string&, std::size_t, uint64_t)>& f) const {
+    std::lock_guard lock{mutex_};
+    for (const auto& [name, limiter] : limiters_) {
+        f(name, limiter->in_flight, limiter->rejected);
+    }
+}
+
+uint64_t AdmissionControl::rejected_count() const {
+    std::lock_guard lock{mutex_};
+    uint64_t rejected{0};
+    for (const auto& [name, limiter] : limiters_) {
+        rejected += limiter->rejected;
+    }
+    return rejected;
+}
+
+} // namespace silkrpc
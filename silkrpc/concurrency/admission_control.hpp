@@ -0,0 +1,111 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_CONCURRENCY_ADMISSION_CONTROL_HPP_
+#define SILKRPC_CONCURRENCY_ADMISSION_CONTROL_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+
+namespace silkrpc {
+
+//! Admission control of the requests by method: the methods matching a limit, either by name or by namespace (i.e. the
+//! method prefix before the first underscore), are executed at most limit at a time. The requests exceeding the limit
+//! wait for a free slot in FIFO order up to the queue budget, then they are rejected, so that under overload the
+//! expensive methods are shed fast instead of slowing down all the others. The callers can run on any executor.
+class AdmissionControl {
+public:
+    //! The max concurrent requests by method name or namespace
+    using Limits = std::map<std::string, std::size_t, std::less<>>;
+
+    //! Parse the limits specified as comma-separated list of <method or namespace>=<max concurrent requests>, e.g.
+    //! "debug=8,trace=8,eth_getLogs=16", throwing std::invalid_argument if malformed
+    static Limits parse_limits(const std::string& limits_spec);
+
+    explicit AdmissionControl(const Limits& limits, std::chrono::milliseconds queue_budget);
+
+    AdmissionControl(const AdmissionControl&) = delete;
+    AdmissionControl& operator=(const AdmissionControl&) = delete;
+
+  private:
+    struct Limiter;
+
+  public:
+    //! The slot taken by an admitted request, released on destruction (empty for the methods without any limit)
+    class Ticket {
+    public:
+        Ticket() = default;
+        Ticket(AdmissionControl* control, Limiter* limiter) : control_{control}, limiter_{limiter} {}
+        ~Ticket() { release(); }
+
+        Ticket(const Ticket&) = delete;
+        Ticket& operator=(const Ticket&) = delete;
+
+        Ticket(Ticket&& other) noexcept : control_{other.control_}, limiter_{other.limiter_} { other.limiter_ = nullptr; }
+        Ticket& operator=(Ticket&& other) noexcept;
+
+    private:
+        void release();
+
+        AdmissionControl* control_{nullptr};
+        Limiter* limiter_{nullptr};
+    };
+
+    //! Admit the request for the method, waiting for a free slot up to the queue budget: nothing if rejected
+    boost::asio::awaitable<std::optional<Ticket>> admit(const std::string& method);
+
+    //! Apply the function to the name, the in-flight requests and the rejected requests of each limit, in name order
+    void for_each(const std::function<void(const std::string&, std::size_t, uint64_t)>& f) const;
+
+    //! The number of requests rejected for any limit
+    uint64_t rejected_count() const;
+
+private:
+    struct Waiter;
+
+    struct Limiter {
+        std::size_t limit{0};
+        std::size_t in_flight{0};
+        uint64_t rejected{0};
+        std::deque<std::shared_ptr<Waiter>> waiters;
+    };
+
+    //! Return the limiter for the method name, if any, otherwise the one for its namespace, if any
+    Limiter* find_limiter(const std::string& method);
+
+    void release(Limiter* limiter);
+
+    //! The limiters are created at construction and never changed, so that they can be found without locking
+    std::map<std::string, std::unique_ptr<Limiter>, std::less<>> limiters_;
+    std::chrono::milliseconds queue_budget_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_CONCURRENCY_ADMISSION_CONTROL_HPP_
@@ -0,0 +1,120 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "admission_control.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/use_future.hpp>
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+using namespace std::chrono_literals; // NOLINT(build/namespaces)
+
+//! Request holding its admission ticket for the specified duration, returning true if admitted
+static boost::asio::awaitable<bool> request(AdmissionControl& admission_control, const std::string& method,
+    std::chrono::milliseconds duration) {
+    auto ticket = co_await admission_control.admit(method);
+    if (!ticket) {
+        co_return false;
+    }
+    boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor, duration};
+    co_await timer.async_wait(boost::asio::use_awaitable);
+    co_return true;
+}
+
+TEST_CASE("parse admission limits", "[silkrpc][concurrency][admission_control]") {
+    CHECK(AdmissionControl::parse_limits("").empty());
+    CHECK(AdmissionControl::parse_limits("debug=8,trace=4,eth_getLogs=16") == AdmissionControl::Limits{
+        {"debug", 8}, {"eth_getLogs", 16}, {"trace", 4}
+    });
+
+    CHECK_THROWS_AS(AdmissionControl::parse_limits("debug"), std::invalid_argument);
+    CHECK_THROWS_AS(AdmissionControl::parse_limits("=8"), std::invalid_argument);
+    CHECK_THROWS_AS(AdmissionControl::parse_limits("debug="), std::invalid_argument);
+    CHECK_THROWS_AS(AdmissionControl::parse_limits("debug=0"), std::invalid_argument);
+    CHECK_THROWS_AS(AdmissionControl::parse_limits("debug=a"), std::invalid_argument);
+}
+
+TEST_CASE("admission control", "[silkrpc][concurrency][admission_control]") {
+    boost::asio::io_context io_context;
+
+    SECTION("methods without limit always admitted") {
+        AdmissionControl admission_control{{{"debug", 1}}, 0ms};
+        auto result1 = boost::asio::co_spawn(io_context, request(admission_control, "eth_call", 10ms), boost::asio::use_future);
+        auto result2 = boost::asio::co_spawn(io_context, request(admission_control, "eth_call", 10ms), boost::asio::use_future);
+        io_context.run();
+        CHECK(result1.get());
+        CHECK(result2.get());
+        CHECK(admission_control.rejected_count() == 0);
+    }
+
+    SECTION("namespace limit rejects immediately without queue budget") {
+        AdmissionControl admission_control{{{"debug", 1}}, 0ms};
+        auto result1 = boost::asio::co_spawn(io_context, request(admission_control, "debug_traceTransaction", 10ms), boost::asio::use_future);
+        auto result2 = boost::asio::co_spawn(io_context, request(admission_control, "debug_traceCall", 10ms), boost::asio::use_future);
+        io_context.run();
+        CHECK(result1.get());
+        CHECK(!result2.get());
+        CHECK(admission_control.rejected_count() == 1);
+    }
+
+    SECTION("method limit takes precedence over namespace limit") {
+        AdmissionControl admission_control{{{"eth", 1}, {"eth_getLogs", 2}}, 0ms};
+        auto result1 = boost::asio::co_spawn(io_context, request(admission_control, "eth_getLogs", 10ms), boost::asio::use_future);
+        auto result2 = boost::asio::co_spawn(io_context, request(admission_control, "eth_getLogs", 10ms), boost::asio::use_future);
+        auto result3 = boost::asio::co_spawn(io_context, request(admission_control, "eth_getLogs", 10ms), boost::asio::use_future);
+        io_context.run();
+        CHECK(result1.get());
+        CHECK(result2.get());
+        CHECK(!result3.get());
+    }
+
+    SECTION("queued request admitted when slot released within budget") {
+        AdmissionControl admission_control{{{"trace", 1}}, 1000ms};
+        auto result1 = boost::asio::co_spawn(io_context, request(admission_control, "trace_block", 10ms), boost::asio::use_future);
+        auto result2 = boost::asio::co_spawn(io_context, request(admission_control, "trace_block", 10ms), boost::asio::use_future);
+        io_context.run();
+        CHECK(result1.get());
+        CHECK(result2.get());
+        CHECK(admission_control.rejected_count() == 0);
+    }
+
+    SECTION("queued request rejected when budget exhausted") {
+        AdmissionControl admission_control{{{"trace", 1}}, 10ms};
+        auto result1 = boost::asio::co_spawn(io_context, request(admission_control, "trace_block", 100ms), boost::asio::use_future);
+        auto result2 = boost::asio::co_spawn(io_context, request(admission_control, "trace_block", 10ms), boost::asio::use_future);
+        io_context.run();
+        CHECK(result1.get());
+        CHECK(!result2.get());
+        CHECK(admission_control.rejected_count() == 1);
+        admission_control.for_each([](const std::string& name, std::size_t in_flight, uint64_t rejected) {
+            CHECK(name == "trace");
+            CHECK(in_flight == 0);
+            CHECK(rejected == 1);
+        });
+    }
+}
+
+} // namespace silkrpc
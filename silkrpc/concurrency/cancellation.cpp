@@ -0,0 +1,110 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "cancellation.hpp"
+
+#include <algorithm>
+#include <charconv>
+
+namespace silkrpc {
+
+CancellationToken::CancellationToken(std::optional<Clock::time_point> deadline, const CancellationToken& parent)
+    : state_{std::make_shared<State>()} {
+    state_->parent = parent.state_;
+    const auto parent_deadline = parent.deadline();
+    if (deadline && parent_deadline) {
+        state_->deadline = std::min(*deadline, *parent_deadline);
+    } else {
+        state_->deadline = deadline ? deadline : parent_deadline;
+    }
+}
+
+void CancellationToken::cancel() noexcept {
+    if (state_) {
+        state_->cancelled.store(true, std::memory_order_relaxed);
+    }
+}
+
+bool CancellationToken::is_cancelled() const noexcept {
+    if (!state_) {
+        return false;
+    }
+    return is_cancelled(state_.get()) || (state_->deadline && Clock::now() >= *state_->deadline);
+}
+
+void CancellationToken::throw_if_cancelled() const {
+    if (!state_) {
+        return;
+    }
+    if (is_cancelled(state_.get())) {
+        throw RequestCancelled{"request cancelled"};
+    }
+    if (state_->deadline && Clock::now() >= *state_->deadline) {
+        throw RequestCancelled{"request timed out"};
+    }
+}
+
+bool CancellationToken::is_cancelled(const State* state) noexcept {
+    for (; state != nullptr; state = state->parent.get()) {
+        if (state->cancelled.load(std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+RequestTimeouts::Timeouts RequestTimeouts::parse_timeouts(const std::string& timeouts_spec) {
+    Timeouts timeouts;
+    std::string_view remaining{timeouts_spec};
+    while (!remaining.empty()) {
+        const auto separator = remaining.find(',');
+        const auto item = remaining.substr(0, separator);
+        remaining = separator == std::string_view::npos ? std::string_view{} : remaining.substr(separator + 1);
+
+        const auto equal = item.find('=');
+        if (equal == std::string_view::npos || equal == 0) {
+            throw std::invalid_argument{"invalid request timeouts: " + timeouts_spec};
+        }
+        const auto value = item.substr(equal + 1);
+        uint64_t milliseconds{0};
+        const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), milliseconds);
+        if (value.empty() || ec != std::errc{} || end != value.data() + value.size()) {
+            throw std::invalid_argument{"invalid request timeouts: " + timeouts_spec};
+        }
+        timeouts.insert_or_assign(std::string{item.substr(0, equal)}, std::chrono::milliseconds{milliseconds});
+    }
+    return timeouts;
+}
+
+std::optional<std::chrono::milliseconds> RequestTimeouts::find(std::string_view method) const {
+    auto it = timeouts_.find(method);
+    if (it == timeouts_.end()) {
+        const auto underscore = method.find('_');
+        if (underscore != std::string_view::npos) {
+            it = timeouts_.find(method.substr(0, underscore));
+        }
+    }
+    if (it == timeouts_.end()) {
+        it = timeouts_.find(kDefaultKey);
+    }
+    if (it == timeouts_.end() || it->second.count() == 0) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+} // namespace silkrpc
@@ -0,0 +1,103 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_CONCURRENCY_CANCELLATION_HPP_
+#define SILKRPC_CONCURRENCY_CANCELLATION_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace silkrpc {
+
+//! The error thrown by the operations of a request cancelled explicitly or by its deadline
+class RequestCancelled : public std::runtime_error {
+public:
+    explicit RequestCancelled(const std::string& reason) : std::runtime_error{reason} {}
+};
+
+//! Cooperative cancellation of a request: the token is cancelled explicitly, when its deadline (if any) expires or when
+//! its parent (if any) is cancelled, and the long operations check it between their steps. All the copies share the same
+//! state, which can be checked and cancelled by any thread.
+class CancellationToken {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    //! Create a token never cancelled
+    CancellationToken() = default;
+
+    //! Create a token cancelled at the given deadline, if any, or whenever the parent is cancelled
+    explicit CancellationToken(std::optional<Clock::time_point> deadline, const CancellationToken& parent = {});
+
+    void cancel() noexcept;
+
+    bool is_cancelled() const noexcept;
+
+    //! Throw RequestCancelled if the token has been cancelled
+    void throw_if_cancelled() const;
+
+    //! The earliest deadline among this token and its ancestors, if any
+    std::optional<Clock::time_point> deadline() const noexcept { return state_ ? state_->deadline : std::nullopt; }
+
+    friend bool operator==(const CancellationToken& lhs, const CancellationToken& rhs) noexcept { return lhs.state_ == rhs.state_; }
+    friend bool operator!=(const CancellationToken& lhs, const CancellationToken& rhs) noexcept { return lhs.state_ != rhs.state_; }
+
+private:
+    struct State {
+        std::atomic_bool cancelled{false};
+        std::optional<Clock::time_point> deadline;
+        std::shared_ptr<const State> parent;
+    };
+
+    //! Return true if this state or any of its ancestors has been cancelled explicitly
+    static bool is_cancelled(const State* state) noexcept;
+
+    std::shared_ptr<State> state_;
+};
+
+//! Default timeouts of the requests by method: the timeout for the method name takes precedence over the one for its
+//! namespace (i.e. the method prefix before the first underscore), which in turn takes precedence over the default one
+class RequestTimeouts {
+public:
+    using Timeouts = std::map<std::string, std::chrono::milliseconds, std::less<>>;
+
+    //! The key of the timeout applied to the methods without any specific timeout
+    static constexpr std::string_view kDefaultKey{"default"};
+
+    //! Parse the timeouts specified as comma-separated list of <method, namespace or default>=<milliseconds>, e.g.
+    //! "default=10000,debug=60000,eth_call=5000" (zero means no timeout), throwing std::invalid_argument if malformed
+    static Timeouts parse_timeouts(const std::string& timeouts_spec);
+
+    explicit RequestTimeouts(Timeouts timeouts) : timeouts_{std::move(timeouts)} {}
+
+    //! Return the timeout for the method, if any
+    std::optional<std::chrono::milliseconds> find(std::string_view method) const;
+
+private:
+    Timeouts timeouts_;
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_CONCURRENCY_CANCELLATION_HPP_
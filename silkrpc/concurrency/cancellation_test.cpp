@@ -0,0 +1,110 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "cancellation.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+using namespace std::chrono_literals; // NOLINT(build/namespaces)
+
+TEST_CASE("CancellationToken", "[silkrpc][concurrency][cancellation]") {
+    SECTION("default token is never cancelled") {
+        CancellationToken token;
+        token.cancel();
+        CHECK(!token.is_cancelled());
+        CHECK_NOTHROW(token.throw_if_cancelled());
+        CHECK(!token.deadline());
+    }
+
+    SECTION("explicit cancellation is shared among copies") {
+        CancellationToken token{std::nullopt};
+        const auto copy = token;
+        CHECK(!copy.is_cancelled());
+        token.cancel();
+        CHECK(copy.is_cancelled());
+        CHECK_THROWS_MATCHES(copy.throw_if_cancelled(), RequestCancelled, Catch::Message("request cancelled"));
+    }
+
+    SECTION("deadline expiration") {
+        CancellationToken expired{CancellationToken::Clock::now() - 1ms};
+        CHECK(expired.is_cancelled());
+        CHECK_THROWS_MATCHES(expired.throw_if_cancelled(), RequestCancelled, Catch::Message("request timed out"));
+        CancellationToken pending{CancellationToken::Clock::now() + 1h};
+        CHECK(!pending.is_cancelled());
+    }
+
+    SECTION("parent cancellation and deadline propagate to children") {
+        const auto parent_deadline = CancellationToken::Clock::now() + 1h;
+        CancellationToken parent{parent_deadline};
+        CancellationToken child{std::nullopt, parent};
+        CancellationToken later_child{parent_deadline + 1h, parent};
+        CancellationToken earlier_child{parent_deadline - 1min, parent};
+        CHECK(child.deadline() == parent_deadline);
+        CHECK(later_child.deadline() == parent_deadline);
+        CHECK(earlier_child.deadline() == parent_deadline - 1min);
+        CHECK(!child.is_cancelled());
+        parent.cancel();
+        CHECK(child.is_cancelled());
+        CHECK(later_child.is_cancelled());
+    }
+
+    SECTION("child cancellation does not propagate to parent") {
+        CancellationToken parent{std::nullopt};
+        CancellationToken child{std::nullopt, parent};
+        child.cancel();
+        CHECK(child.is_cancelled());
+        CHECK(!parent.is_cancelled());
+    }
+}
+
+TEST_CASE("RequestTimeouts", "[silkrpc][concurrency][cancellation]") {
+    SECTION("parse valid timeouts") {
+        const auto timeouts = RequestTimeouts::parse_timeouts("default=10000,debug=60000,eth_call=0");
+        CHECK(timeouts.size() == 3);
+        CHECK(timeouts.at("default") == 10000ms);
+        CHECK(timeouts.at("eth_call") == 0ms);
+        CHECK(RequestTimeouts::parse_timeouts("").empty());
+    }
+
+    SECTION("parse invalid timeouts") {
+        CHECK_THROWS_AS(RequestTimeouts::parse_timeouts("debug"), std::invalid_argument);
+        CHECK_THROWS_AS(RequestTimeouts::parse_timeouts("=100"), std::invalid_argument);
+        CHECK_THROWS_AS(RequestTimeouts::parse_timeouts("debug=-1"), std::invalid_argument);
+        CHECK_THROWS_AS(RequestTimeouts::parse_timeouts("debug=1s"), std::invalid_argument);
+    }
+
+    SECTION("method name over namespace over default") {
+        RequestTimeouts timeouts{RequestTimeouts::parse_timeouts("default=10000,debug=60000,debug_traceCall=5000,trace=0")};
+        CHECK(timeouts.find("debug_traceCall") == 5000ms);
+        CHECK(timeouts.find("debug_traceTransaction") == 60000ms);
+        CHECK(timeouts.find("eth_call") == 10000ms);
+        CHECK(!timeouts.find("trace_block"));
+    }
+
+    SECTION("no default timeout") {
+        RequestTimeouts timeouts{RequestTimeouts::parse_timeouts("debug=60000")};
+        CHECK(!timeouts.find("eth_call"));
+        CHECK(timeouts.find("debug_traceBlockByNumber") == 60000ms);
+    }
+}
+
+} // namespace silkrpc
@@ -0,0 +1,43 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "context_load.hpp"
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+namespace silkrpc {
+
+void ContextLoad::add_queue_latency(std::chrono::microseconds latency) noexcept {
+    // Just the context thread adds samples, so the read-modify-write needs no atomicity
+    const auto average = queue_latency_.load(std::memory_order_relaxed);
+    queue_latency_.store(average + (latency.count() - average) / kAverageDivisor, std::memory_order_relaxed);
+}
+
+boost::asio::awaitable<void> ContextLoad::probe(boost::asio::io_context& io_context) {
+    boost::asio::steady_timer timer{io_context};
+    while (!io_context.stopped()) {
+        timer.expires_after(kProbeInterval);
+        co_await timer.async_wait(boost::asio::use_awaitable);
+        const auto posted = std::chrono::steady_clock::now();
+        co_await boost::asio::post(io_context, boost::asio::use_awaitable);
+        add_queue_latency(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - posted));
+    }
+}
+
+} // namespace silkrpc
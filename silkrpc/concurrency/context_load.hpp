@@ -0,0 +1,97 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_CONCURRENCY_CONTEXT_LOAD_HPP_
+#define SILKRPC_CONCURRENCY_CONTEXT_LOAD_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/io_context.hpp>
+
+namespace silkrpc {
+
+//! The load of one execution context, i.e. the requests in flight on it and its queue latency, the time the handlers
+//! posted to it wait before running as averaged over the recent probes: the least loaded context is picked for the new
+//! connections. The load is updated on the context thread and read by any thread.
+class ContextLoad {
+public:
+    //! The queue latency weighing as one request in flight
+    static constexpr std::chrono::microseconds kQueueLatencyPerRequest{100};
+
+    //! The interval between two consecutive probes of the queue latency
+    static constexpr std::chrono::milliseconds kProbeInterval{10};
+
+    //! The weight of the older samples in the average queue latency, i.e. each new sample weighs 1/kAverageDivisor
+    static constexpr int64_t kAverageDivisor{8};
+
+    //! The request in flight tracked until destruction
+    class Request {
+    public:
+        explicit Request(ContextLoad& load) : load_{&load} { load_->in_flight_.fetch_add(1, std::memory_order_relaxed); }
+        ~Request() {
+            if (load_ != nullptr) {
+                load_->in_flight_.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+        Request(const Request&) = delete;
+        Request& operator=(const Request&) = delete;
+
+        Request(Request&& other) noexcept : load_{other.load_} { other.load_ = nullptr; }
+
+    private:
+        ContextLoad* load_;
+    };
+
+    ContextLoad() = default;
+
+    ContextLoad(const ContextLoad&) = delete;
+    ContextLoad& operator=(const ContextLoad&) = delete;
+
+    //! Track the request in flight on the context until the returned one is destroyed
+    Request track_request() { return Request{*this}; }
+
+    uint32_t in_flight_requests() const noexcept { return in_flight_.load(std::memory_order_relaxed); }
+
+    std::chrono::microseconds queue_latency() const noexcept {
+        return std::chrono::microseconds{queue_latency_.load(std::memory_order_relaxed)};
+    }
+
+    //! Add one sample to the average queue latency
+    void add_queue_latency(std::chrono::microseconds latency) noexcept;
+
+    //! The load score, i.e. the requests in flight plus the queue latency in units of kQueueLatencyPerRequest
+    uint64_t score() const noexcept {
+        return in_flight_requests() + static_cast<uint64_t>(queue_latency() / kQueueLatencyPerRequest);
+    }
+
+    //! Sample the queue latency of the context every kProbeInterval until the context is stopped
+    boost::asio::awaitable<void> probe(boost::asio::io_context& io_context);
+
+private:
+    std::atomic<uint32_t> in_flight_{0};
+    std::atomic<int64_t> queue_latency_{0};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_CONCURRENCY_CONTEXT_LOAD_HPP_
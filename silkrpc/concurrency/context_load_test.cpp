@@ -0,0 +1,92 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "context_load.hpp"
+
+#include <chrono>
+#include <thread>
+#include <utility>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+using namespace std::chrono_literals; // NOLINT(build/namespaces)
+
+TEST_CASE("ContextLoad::track_request", "[silkrpc][concurrency][context_load]") {
+    ContextLoad load;
+    CHECK(load.in_flight_requests() == 0);
+    CHECK(load.score() == 0);
+
+    SECTION("count the requests in flight") {
+        {
+            const auto request1 = load.track_request();
+            const auto request2 = load.track_request();
+            CHECK(load.in_flight_requests() == 2);
+            CHECK(load.score() == 2);
+        }
+        CHECK(load.in_flight_requests() == 0);
+    }
+
+    SECTION("count the moved request once") {
+        auto request1 = load.track_request();
+        {
+            const auto request2{std::move(request1)};
+            CHECK(load.in_flight_requests() == 1);
+        }
+        CHECK(load.in_flight_requests() == 0);
+    }
+}
+
+TEST_CASE("ContextLoad::add_queue_latency", "[silkrpc][concurrency][context_load]") {
+    ContextLoad load;
+
+    SECTION("average the samples") {
+        load.add_queue_latency(800us);
+        CHECK(load.queue_latency() == 100us);
+        load.add_queue_latency(100us);
+        CHECK(load.queue_latency() == 100us);
+    }
+
+    SECTION("weigh the queue latency in the score") {
+        for (int i{0}; i < 100; ++i) {
+            load.add_queue_latency(ContextLoad::kQueueLatencyPerRequest * 10);
+        }
+        CHECK(load.score() > 5);
+        const auto request = load.track_request();
+        CHECK(load.score() > 6);
+    }
+}
+
+TEST_CASE("ContextLoad::probe", "[silkrpc][concurrency][context_load]") {
+    boost::asio::io_context io_context;
+    ContextLoad load;
+    boost::asio::co_spawn(io_context, load.probe(io_context), boost::asio::detached);
+    std::thread stopper{[&]() {
+        std::this_thread::sleep_for(ContextLoad::kProbeInterval * 5);
+        io_context.stop();
+    }};
+    io_context.run();
+    stopper.join();
+    CHECK(io_context.stopped());
+    CHECK(load.queue_latency() < ContextLoad::kProbeInterval);
+}
+
+} // namespace silkrpc
@@ -16,16 +16,31 @@
 
 #include "context_pool.hpp"
 
+#include <random>
 #include <stdexcept>
+#include <string>
 #include <thread>
 #include <utility>
 
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+
+#include <silkrpc/common/allocator.hpp>
+#include <silkrpc/common/constants.hpp>
 #include <silkrpc/common/log.hpp>
+#include <silkrpc/concurrency/handoff.hpp>
+#include <silkrpc/config.hpp>
 #include <silkrpc/ethbackend/remote_backend.hpp>
+#include <silkrpc/ethdb/file/local_database.hpp>
 #include <silkrpc/ethdb/kv/remote_database.hpp>
 
 namespace silkrpc {
 
+#ifdef BOOST_ASIO_HAS_IO_URING
+// Epoll is disabled along with enabling io_uring, so the io_context of each Context has no other backend to fall back to
+static_assert(kIoUringBackend, "io_uring enabled but not the default Asio backend");
+#endif // BOOST_ASIO_HAS_IO_URING
+
 std::ostream& operator<<(std::ostream& out, Context& c) {
     out << "io_context: " << c.io_context() << " queue: " << c.grpc_queue();
     return out;
@@ -34,17 +49,60 @@ std::ostream& operator<<(std::ostream& out, Context& c) {
 Context::Context(
     ChannelFactory create_channel,
     std::shared_ptr<BlockCache> block_cache,
+    std::shared_ptr<ReceiptCache> receipt_cache,
     std::shared_ptr<ethdb::kv::StateCache> state_cache,
-    WaitMode wait_mode)
+    std::shared_ptr<AccessHistory> access_history,
+    WaitMode wait_mode,
+    std::shared_ptr<::mdbx::env_managed> chaindata_env,
+    std::shared_ptr<BitmapCache> bitmap_cache,
+    std::shared_ptr<ethdb::file::LogIndex> log_index,
+    std::shared_ptr<GasPriceCache> gas_price_cache,
+    std::shared_ptr<FeeHistoryCache> fee_history_cache,
+    std::shared_ptr<SingleFlight> single_flight,
+    std::shared_ptr<ReplyCache> reply_cache,
+    std::shared_ptr<MethodLatencies> method_latencies,
+    uint32_t num_kv_channels,
+    std::chrono::microseconds wait_latency_budget,
+    std::vector<ChannelFactory> create_replica_channels)
     : io_context_{std::make_shared<boost::asio::io_context>()},
       io_context_work_{boost::asio::make_work_guard(*io_context_)},
       grpc_context_{std::make_unique<agrpc::GrpcContext>(std::make_unique<grpc::CompletionQueue>())},
       grpc_context_work_{boost::asio::make_work_guard(grpc_context_->get_executor())},
+      load_{std::make_shared<ContextLoad>()},
       block_cache_(block_cache),
+      receipt_cache_(receipt_cache),
       state_cache_(state_cache),
-      wait_mode_(wait_mode) {
+      access_history_(access_history),
+      bitmap_cache_(bitmap_cache),
+      log_index_(log_index),
+      gas_price_cache_(gas_price_cache),
+      fee_history_cache_(fee_history_cache),
+      single_flight_(single_flight),
+      reply_cache_(reply_cache),
+      method_latencies_(method_latencies),
+      buffer_pool_{std::make_shared<http::BufferPool>()},
+      account_range_sessions_{std::make_shared<AccountRangeSessions>()},
+      wait_mode_(wait_mode),
+      wait_latency_budget_(wait_latency_budget) {
     std::shared_ptr<grpc::Channel> channel = create_channel();
-    database_ = std::make_unique<ethdb::kv::RemoteDatabase>(*grpc_context_, channel);
+    if (chaindata_env) {
+        database_ = std::make_unique<ethdb::file::LocalDatabase>(std::move(chaindata_env));
+    } else {
+        // Each channel factory call creates a new connection, so the transactions are spread over distinct connections
+        std::vector<std::vector<std::shared_ptr<grpc::Channel>>> kv_channels(1);
+        kv_channels[0].push_back(channel);
+        for (uint32_t i{1}; i < num_kv_channels; ++i) {
+            kv_channels[0].push_back(create_channel());
+        }
+        // The replicas serve just the transactions, so the primary backend is the first one
+        for (const auto& create_replica_channel : create_replica_channels) {
+            auto& replica_channels = kv_channels.emplace_back();
+            for (uint32_t i{0}; i < num_kv_channels; ++i) {
+                replica_channels.push_back(create_replica_channel());
+            }
+        }
+        database_ = std::make_unique<ethdb::kv::RemoteDatabase>(*grpc_context_, kv_channels, kMaxIdleTransactionsPerContext);
+    }
     backend_ = std::make_unique<ethbackend::RemoteBackEnd>(*io_context_, channel, *grpc_context_);
     miner_ = std::make_unique<txpool::Miner>(*io_context_, channel, *grpc_context_);
     tx_pool_ = std::make_unique<txpool::TransactionPool>(*io_context_, channel, *grpc_context_);
@@ -59,11 +117,16 @@ void Context::execute_loop_agrpc() {
 template <typename WaitStrategy>
 void Context::execute_loop_single_threaded(WaitStrategy&& wait_strategy) {
     SILKRPC_DEBUG << "Single-thread execution loop start [" << this << "]\n";
+    // This loop polls the handed off handlers as well, so that the other threads never post to Asio to wake it up
+    auto& handoff = boost::asio::use_service<Handoff>(*io_context_);
+    handoff.set_polled(true);
     while (!io_context_->stopped()) {
         int work_count = grpc_context_->poll_completion_queue();
         work_count += io_context_->poll();
+        work_count += static_cast<int>(handoff.poll());
         wait_strategy.idle(work_count);
     }
+    handoff.set_polled(false);
     SILKRPC_DEBUG << "Single-thread execution loop end [" << this << "]\n";
 }
 
@@ -81,6 +144,8 @@ void Context::execute_loop_multi_threaded() {
 }
 
 void Context::execute_loop() {
+    SamplingProfiler::register_thread();
+    boost::asio::co_spawn(*io_context_, load_->probe(*io_context_), boost::asio::detached);
     switch (wait_mode_) {
         case WaitMode::backoff:
             execute_loop_agrpc();
@@ -100,6 +165,9 @@ void Context::execute_loop() {
         case WaitMode::busy_spin:
             execute_loop_single_threaded(BusySpinWaitStrategy{});
         break;
+        case WaitMode::adaptive:
+            execute_loop_single_threaded(AdaptiveWaitStrategy{wait_latency_budget_});
+        break;
     }
 }
 
@@ -108,7 +176,11 @@ void Context::stop() {
     SILKRPC_DEBUG << "Context::stop io_context " << io_context_ << " [" << this << "]\n";
 }
 
-ContextPool::ContextPool(std::size_t pool_size, ChannelFactory create_channel, WaitMode wait_mode) : next_index_{0} {
+ContextPool::ContextPool(std::size_t pool_size, ChannelFactory create_channel, WaitMode wait_mode,
+    std::shared_ptr<::mdbx::env_managed> chaindata_env, std::shared_ptr<ethdb::file::LogIndex> log_index, uint32_t num_kv_channels,
+    CpuList context_cpus, std::chrono::microseconds wait_latency_budget, std::size_t num_reserved_contexts,
+    std::vector<ChannelFactory> create_replica_channels)
+    : pool_size_{pool_size}, next_index_{0}, context_cpus_{std::move(context_cpus)} {
     if (pool_size == 0) {
         throw std::logic_error("ContextPool::ContextPool pool_size is 0");
     }
@@ -117,12 +189,36 @@ ContextPool::ContextPool(std::size_t pool_size, ChannelFactory create_channel, W
     // Create the unique block cache to be shared among the execution contexts
     auto block_cache = std::make_shared<BlockCache>();
 
+    // Create the unique receipt cache to be shared among the execution contexts
+    auto receipt_cache = std::make_shared<ReceiptCache>();
+
     // Create the unique state cache to be shared among the execution contexts
     auto state_cache = std::make_shared<ethdb::kv::CoherentStateCache>();
 
-    // Create as many execution contexts as required by the pool size
-    for (std::size_t i{0}; i < pool_size; ++i) {
-        contexts_.emplace_back(Context{create_channel, block_cache, state_cache, wait_mode});
+    // Create the unique history of the state accessed by executions to be shared among the execution contexts
+    auto access_history = std::make_shared<AccessHistory>();
+
+    // Create the unique cache of log index chunks to be shared among the execution contexts
+    auto bitmap_cache = std::make_shared<BitmapCache>();
+
+    // Create the unique window of gas price samples to be shared among the execution contexts
+    auto gas_price_cache = std::make_shared<GasPriceCache>();
+
+    // Create the unique ring buffer of block fee statistics to be shared among the execution contexts
+    auto fee_history_cache = std::make_shared<FeeHistoryCache>();
+
+    // Create the unique coalescing of identical in-flight requests to be shared among the execution contexts
+    auto single_flight = std::make_shared<SingleFlight>();
+
+    // Create the unique cache of the replies pinned to some block to be shared among the execution contexts
+    auto reply_cache = std::make_shared<ReplyCache>();
+
+    // Create the unique latency histograms by method to be shared among the execution contexts
+    auto method_latencies = std::make_shared<MethodLatencies>();
+
+    // Create as many execution contexts as required by the pool size plus the reserved ones
+    for (std::size_t i{0}; i < pool_size + num_reserved_contexts; ++i) {
+        contexts_.emplace_back(Context{create_channel, block_cache, receipt_cache, state_cache, access_history, wait_mode, chaindata_env, bitmap_cache, log_index, gas_price_cache, fee_history_cache, single_flight, reply_cache, method_latencies, num_kv_channels, wait_latency_budget, create_replica_channels});
         SILKRPC_DEBUG << "ContextPool::ContextPool context[" << i << "] " << contexts_[i] << "\n";
     }
 }
@@ -145,6 +241,10 @@ void ContextPool::start() {
         auto& context = contexts_[i];
         context_threads_.create_thread([&, i = i]() {
             SILKRPC_DEBUG << "Thread start context[" << i << "] thread_id: " << std::this_thread::get_id() << "\n";
+            if (!context_cpus_.empty()) {
+                pin_current_thread(context_cpus_[i % context_cpus_.size()]);
+            }
+            bind_thread_heap("context_" + std::to_string(i));
             context.execute_loop();
             SILKRPC_DEBUG << "Thread end context[" << i << "] thread_id: " << std::this_thread::get_id() << "\n";
         });
@@ -183,10 +283,22 @@ void ContextPool::run() {
 }
 
 Context& ContextPool::next_context() {
-    // Use a round-robin scheme to choose the next context to use
-    auto& context = contexts_[next_index_];
-    next_index_ = ++next_index_ % contexts_.size();
-    return context;
+    // Use the power of two choices: pick the less loaded between the round-robin context and another one at random,
+    // so that the load is balanced without scanning the whole pool and the contexts equally loaded still take turns
+    const auto index = next_index_;
+    next_index_ = (next_index_ + 1) % pool_size_;
+    auto& context = contexts_[index];
+    if (pool_size_ < 2) {
+        return context;
+    }
+    thread_local std::minstd_rand random_engine{std::random_device{}()};
+    std::uniform_int_distribution<std::size_t> distribution{0, pool_size_ - 2};
+    auto other_index = distribution(random_engine);
+    if (other_index >= index) {
+        ++other_index; // skip the round-robin context itself
+    }
+    auto& other_context = contexts_[other_index];
+    return other_context.load()->score() < context.load()->score() ? other_context : context;
 }
 
 boost::asio::io_context& ContextPool::next_io_context() {
@@ -194,4 +306,191 @@ boost::asio::io_context& ContextPool::next_io_context() {
     return *client_context.io_context();
 }
 
+Context& ContextPool::reserved_context(std::size_t index) {
+    if (pool_size_ + index >= contexts_.size()) {
+        throw std::out_of_range("ContextPool::reserved_context index out of range: " + std::to_string(index));
+    }
+    return contexts_[pool_size_ + index];
+}
+
+void ContextPool::set_admission_control(std::shared_ptr<AdmissionControl> admission_control) {
+    for (auto& context : contexts_) {
+        context.admission_control() = admission_control;
+    }
+}
+
+void ContextPool::set_rate_limiter(std::shared_ptr<RateLimiter> rate_limiter) {
+    for (auto& context : contexts_) {
+        context.rate_limiter() = rate_limiter;
+    }
+}
+
+void ContextPool::set_request_timeouts(std::shared_ptr<RequestTimeouts> request_timeouts) {
+    for (auto& context : contexts_) {
+        context.request_timeouts() = request_timeouts;
+    }
+}
+
+void ContextPool::set_tracer(std::shared_ptr<Tracer> tracer) {
+    for (auto& context : contexts_) {
+        context.tracer() = tracer;
+    }
+}
+
+void ContextPool::set_request_recorder(std::shared_ptr<RequestRecorder> request_recorder) {
+    for (auto& context : contexts_) {
+        context.request_recorder() = request_recorder;
+    }
+}
+
+void ContextPool::set_block_cache(std::shared_ptr<BlockCache> block_cache) {
+    for (auto& context : contexts_) {
+        context.block_cache() = block_cache;
+    }
+}
+
+void ContextPool::set_state_cache(std::shared_ptr<ethdb::kv::StateCache> state_cache) {
+    for (auto& context : contexts_) {
+        context.state_cache() = state_cache;
+    }
+}
+
+void ContextPool::set_history_cache(std::shared_ptr<HistoryCache> history_cache) {
+    for (auto& context : contexts_) {
+        context.history_cache() = history_cache;
+    }
+}
+
+void ContextPool::set_log_offset_cache(std::shared_ptr<ethdb::file::LogOffsetCache> log_offset_cache) {
+    for (auto& context : contexts_) {
+        context.log_offset_cache() = log_offset_cache;
+    }
+}
+
+void ContextPool::set_code_cache(std::shared_ptr<CodeCache> code_cache) {
+    for (auto& context : contexts_) {
+        context.code_cache() = code_cache;
+    }
+}
+
+void ContextPool::set_state_checkpoint_cache(std::shared_ptr<StateCheckpointCache> state_checkpoint_cache) {
+    for (auto& context : contexts_) {
+        context.state_checkpoint_cache() = state_checkpoint_cache;
+    }
+}
+
+void ContextPool::set_call_result_cache(std::shared_ptr<CallResultCache> call_result_cache) {
+    for (auto& context : contexts_) {
+        context.call_result_cache() = call_result_cache;
+    }
+}
+
+void ContextPool::set_trace_store(std::shared_ptr<ethdb::file::TraceStore> trace_store) {
+    for (auto& context : contexts_) {
+        context.trace_store() = trace_store;
+    }
+}
+
+void ContextPool::set_filter_registry(std::shared_ptr<filters::FilterRegistry> filter_registry) {
+    for (auto& context : contexts_) {
+        context.filter_registry() = filter_registry;
+    }
+}
+
+void ContextPool::set_pool_mirror(std::shared_ptr<txpool::PoolMirror> pool_mirror) {
+    for (auto& context : contexts_) {
+        context.tx_pool()->set_mirror(pool_mirror);
+    }
+}
+
+void ContextPool::set_sender_recovery(std::shared_ptr<core::SenderRecovery> sender_recovery) {
+    for (auto& context : contexts_) {
+        context.sender_recovery() = sender_recovery;
+    }
+}
+
+void ContextPool::set_work_verifier(std::shared_ptr<ethash::WorkVerifier> work_verifier) {
+    for (auto& context : contexts_) {
+        context.work_verifier() = work_verifier;
+    }
+}
+
+void ContextPool::set_header_cache(std::shared_ptr<HeaderCache> header_cache) {
+    for (auto& context : contexts_) {
+        context.header_cache() = header_cache;
+    }
+}
+
+void ContextPool::set_timestamp_index(std::shared_ptr<TimestampIndex> timestamp_index) {
+    for (auto& context : contexts_) {
+        context.timestamp_index() = timestamp_index;
+    }
+}
+
+void ContextPool::set_issuance_index(std::shared_ptr<IssuanceIndex> issuance_index) {
+    for (auto& context : contexts_) {
+        context.issuance_index() = issuance_index;
+    }
+}
+
+void ContextPool::set_trie_node_cache(std::shared_ptr<TrieNodeCache> trie_node_cache) {
+    for (auto& context : contexts_) {
+        context.trie_node_cache() = trie_node_cache;
+    }
+}
+
+void ContextPool::set_backend_info_cache(std::shared_ptr<ethbackend::BackEndInfoCache> backend_info_cache) {
+    for (auto& context : contexts_) {
+        context.backend_info_cache() = backend_info_cache;
+    }
+}
+
+void ContextPool::set_peer_ring(std::shared_ptr<const PeerRing> peer_ring) {
+    for (auto& context : contexts_) {
+        context.peer_client() = std::make_shared<http::PeerClient>(*context.io_context(), peer_ring);
+    }
+}
+
+void ContextPool::set_state_changes_applier(std::shared_ptr<ethdb::kv::StateChangesApplier> state_changes_applier) {
+    for (auto& context : contexts_) {
+        context.state_changes_applier() = state_changes_applier;
+    }
+}
+
+void ContextPool::set_streaming_load(std::shared_ptr<ContextLoad> streaming_load) {
+    for (auto& context : contexts_) {
+        context.streaming_load() = streaming_load;
+    }
+}
+
+void ContextPool::set_sampling_profiler(std::shared_ptr<SamplingProfiler> sampling_profiler) {
+    for (auto& context : contexts_) {
+        context.sampling_profiler() = sampling_profiler;
+    }
+}
+
+void ContextPool::set_chain_head_cache(std::shared_ptr<ChainHeadCache> chain_head_cache) {
+    for (auto& context : contexts_) {
+        context.database()->set_chain_head_cache(chain_head_cache);
+    }
+}
+
+void ContextPool::enable_read_combining() {
+    for (auto& context : contexts_) {
+        context.database()->set_read_combiner(std::make_shared<ethdb::ReadCombiner>());
+    }
+}
+
+void ContextPool::set_snapshots(std::shared_ptr<const ethdb::snapshot::SnapshotRepository> snapshots) {
+    for (auto& context : contexts_) {
+        context.database()->set_snapshots(snapshots);
+    }
+}
+
+void ContextPool::notify_new_view(uint64_t view_id) {
+    for (auto& context : contexts_) {
+        context.database()->on_new_view(view_id);
+    }
+}
+
 } // namespace silkrpc
@@ -17,6 +17,7 @@
 #ifndef SILKRPC_CONCURRENCY_CONTEXT_POOL_HPP_
 #define SILKRPC_CONCURRENCY_CONTEXT_POOL_HPP_
 
+#include <chrono>
 #include <cstddef>
 #include <functional>
 #include <iostream>
@@ -29,13 +30,52 @@
 #include <boost/asio/executor_work_guard.hpp>
 #include <boost/asio/io_context.hpp>
 #include <grpcpp/grpcpp.h>
+#include <silkworm/db/mdbx.hpp>
 
+#include <silkrpc/common/access_history.hpp>
+#include <silkrpc/common/bitmap_cache.hpp>
+#include <silkrpc/common/call_result_cache.hpp>
+#include <silkrpc/common/constants.hpp>
 #include <silkrpc/common/block_cache.hpp>
+#include <silkrpc/common/chain_head_cache.hpp>
+#include <silkrpc/common/code_cache.hpp>
+#include <silkrpc/common/fee_history_cache.hpp>
+#include <silkrpc/common/gas_price_cache.hpp>
+#include <silkrpc/common/header_cache.hpp>
+#include <silkrpc/common/history_cache.hpp>
+#include <silkrpc/common/issuance_index.hpp>
+#include <silkrpc/common/latency_histogram.hpp>
 #include <silkrpc/common/log.hpp>
+#include <silkrpc/common/receipt_cache.hpp>
+#include <silkrpc/common/reply_cache.hpp>
+#include <silkrpc/common/request_recorder.hpp>
+#include <silkrpc/common/sampling_profiler.hpp>
+#include <silkrpc/common/state_checkpoint_cache.hpp>
+#include <silkrpc/common/timestamp_index.hpp>
+#include <silkrpc/common/tracing.hpp>
+#include <silkrpc/common/trie_node_cache.hpp>
+#include <silkrpc/concurrency/admission_control.hpp>
+#include <silkrpc/concurrency/cancellation.hpp>
+#include <silkrpc/concurrency/context_load.hpp>
+#include <silkrpc/concurrency/cpu_affinity.hpp>
+#include <silkrpc/concurrency/rate_limiter.hpp>
+#include <silkrpc/concurrency/single_flight.hpp>
 #include <silkrpc/concurrency/wait_strategy.hpp>
+#include <silkrpc/consensus/ethash_verifier.hpp>
+#include <silkrpc/core/account_range_sessions.hpp>
+#include <silkrpc/core/sender_recovery.hpp>
 #include <silkrpc/ethbackend/backend.hpp>
+#include <silkrpc/ethbackend/backend_info.hpp>
 #include <silkrpc/ethdb/database.hpp>
+#include <silkrpc/ethdb/file/log_index.hpp>
+#include <silkrpc/ethdb/file/log_offset_cache.hpp>
+#include <silkrpc/ethdb/file/trace_store.hpp>
 #include <silkrpc/ethdb/kv/state_cache.hpp>
+#include <silkrpc/ethdb/kv/state_changes_applier.hpp>
+#include <silkrpc/ethdb/snapshot/repository.hpp>
+#include <silkrpc/filters/filter_registry.hpp>
+#include <silkrpc/http/buffer_pool.hpp>
+#include <silkrpc/http/peer_client.hpp>
 #include <silkrpc/txpool/miner.hpp>
 #include <silkrpc/txpool/transaction_pool.hpp>
 
@@ -49,8 +89,21 @@ class Context {
     explicit Context(
         ChannelFactory create_channel,
         std::shared_ptr<BlockCache> block_cache,
+        std::shared_ptr<ReceiptCache> receipt_cache,
         std::shared_ptr<ethdb::kv::StateCache> state_cache,
-        WaitMode wait_mode = WaitMode::blocking);
+        std::shared_ptr<AccessHistory> access_history,
+        WaitMode wait_mode = WaitMode::blocking,
+        std::shared_ptr<::mdbx::env_managed> chaindata_env = nullptr,
+        std::shared_ptr<BitmapCache> bitmap_cache = nullptr,
+        std::shared_ptr<ethdb::file::LogIndex> log_index = nullptr,
+        std::shared_ptr<GasPriceCache> gas_price_cache = nullptr,
+        std::shared_ptr<FeeHistoryCache> fee_history_cache = nullptr,
+        std::shared_ptr<SingleFlight> single_flight = nullptr,
+        std::shared_ptr<ReplyCache> reply_cache = nullptr,
+        std::shared_ptr<MethodLatencies> method_latencies = nullptr,
+        uint32_t num_kv_channels = kDefaultNumKvChannels,
+        std::chrono::microseconds wait_latency_budget = kDefaultWaitLatencyBudget,
+        std::vector<ChannelFactory> create_replica_channels = {});
 
     boost::asio::io_context* io_context() const noexcept { return io_context_.get(); }
     grpc::CompletionQueue* grpc_queue() const noexcept { return grpc_context_->get_completion_queue(); }
@@ -60,7 +113,42 @@ class Context {
     std::unique_ptr<txpool::Miner>& miner() noexcept { return miner_; }
     std::unique_ptr<txpool::TransactionPool>& tx_pool() noexcept { return tx_pool_; }
     std::shared_ptr<BlockCache>& block_cache() noexcept { return block_cache_; }
+    std::shared_ptr<ReceiptCache>& receipt_cache() noexcept { return receipt_cache_; }
     std::shared_ptr<ethdb::kv::StateCache>& state_cache() noexcept { return state_cache_; }
+    std::shared_ptr<AccessHistory>& access_history() noexcept { return access_history_; }
+    std::shared_ptr<BitmapCache>& bitmap_cache() noexcept { return bitmap_cache_; }
+    std::shared_ptr<ethdb::file::LogIndex>& log_index() noexcept { return log_index_; }
+    std::shared_ptr<ethdb::file::LogOffsetCache>& log_offset_cache() noexcept { return log_offset_cache_; }
+    std::shared_ptr<GasPriceCache>& gas_price_cache() noexcept { return gas_price_cache_; }
+    std::shared_ptr<FeeHistoryCache>& fee_history_cache() noexcept { return fee_history_cache_; }
+    std::shared_ptr<SingleFlight>& single_flight() noexcept { return single_flight_; }
+    std::shared_ptr<ReplyCache>& reply_cache() noexcept { return reply_cache_; }
+    std::shared_ptr<MethodLatencies>& method_latencies() noexcept { return method_latencies_; }
+    std::shared_ptr<AdmissionControl>& admission_control() noexcept { return admission_control_; }
+    std::shared_ptr<RateLimiter>& rate_limiter() noexcept { return rate_limiter_; }
+    std::shared_ptr<RequestTimeouts>& request_timeouts() noexcept { return request_timeouts_; }
+    std::shared_ptr<Tracer>& tracer() noexcept { return tracer_; }
+    std::shared_ptr<RequestRecorder>& request_recorder() noexcept { return request_recorder_; }
+    std::shared_ptr<HistoryCache>& history_cache() noexcept { return history_cache_; }
+    std::shared_ptr<CodeCache>& code_cache() noexcept { return code_cache_; }
+    std::shared_ptr<StateCheckpointCache>& state_checkpoint_cache() noexcept { return state_checkpoint_cache_; }
+    std::shared_ptr<CallResultCache>& call_result_cache() noexcept { return call_result_cache_; }
+    std::shared_ptr<ethdb::file::TraceStore>& trace_store() noexcept { return trace_store_; }
+    std::shared_ptr<filters::FilterRegistry>& filter_registry() noexcept { return filter_registry_; }
+    std::shared_ptr<core::SenderRecovery>& sender_recovery() noexcept { return sender_recovery_; }
+    std::shared_ptr<ethash::WorkVerifier>& work_verifier() noexcept { return work_verifier_; }
+    std::shared_ptr<HeaderCache>& header_cache() noexcept { return header_cache_; }
+    std::shared_ptr<TimestampIndex>& timestamp_index() noexcept { return timestamp_index_; }
+    std::shared_ptr<IssuanceIndex>& issuance_index() noexcept { return issuance_index_; }
+    std::shared_ptr<TrieNodeCache>& trie_node_cache() noexcept { return trie_node_cache_; }
+    std::shared_ptr<ethbackend::BackEndInfoCache>& backend_info_cache() noexcept { return backend_info_cache_; }
+    std::shared_ptr<ethdb::kv::StateChangesApplier>& state_changes_applier() noexcept { return state_changes_applier_; }
+    std::shared_ptr<http::PeerClient>& peer_client() noexcept { return peer_client_; }
+    std::shared_ptr<http::BufferPool>& buffer_pool() noexcept { return buffer_pool_; }
+    std::shared_ptr<AccountRangeSessions>& account_range_sessions() noexcept { return account_range_sessions_; }
+    std::shared_ptr<ContextLoad>& load() noexcept { return load_; }
+    std::shared_ptr<ContextLoad>& streaming_load() noexcept { return streaming_load_; }
+    std::shared_ptr<SamplingProfiler>& sampling_profiler() noexcept { return sampling_profiler_; }
 
     //! Execute the scheduler loop until stopped.
     void execute_loop();
@@ -89,13 +177,52 @@ class Context {
 
     boost::asio::executor_work_guard<agrpc::GrpcContext::executor_type> grpc_context_work_;
 
+    //! The load of this context, i.e. its requests in flight and queue latency
+    std::shared_ptr<ContextLoad> load_;
+
     std::unique_ptr<ethdb::Database> database_;
     std::unique_ptr<ethbackend::BackEnd> backend_;
     std::unique_ptr<txpool::Miner> miner_;
     std::unique_ptr<txpool::TransactionPool> tx_pool_;
     std::shared_ptr<BlockCache> block_cache_;
+    std::shared_ptr<ReceiptCache> receipt_cache_;
     std::shared_ptr<ethdb::kv::StateCache> state_cache_;
+    std::shared_ptr<AccessHistory> access_history_;
+    std::shared_ptr<BitmapCache> bitmap_cache_;
+    std::shared_ptr<ethdb::file::LogIndex> log_index_;
+    std::shared_ptr<ethdb::file::LogOffsetCache> log_offset_cache_;
+    std::shared_ptr<GasPriceCache> gas_price_cache_;
+    std::shared_ptr<FeeHistoryCache> fee_history_cache_;
+    std::shared_ptr<SingleFlight> single_flight_;
+    std::shared_ptr<ReplyCache> reply_cache_;
+    std::shared_ptr<MethodLatencies> method_latencies_;
+    std::shared_ptr<AdmissionControl> admission_control_;
+    std::shared_ptr<RateLimiter> rate_limiter_;
+    std::shared_ptr<RequestTimeouts> request_timeouts_;
+    std::shared_ptr<Tracer> tracer_;
+    std::shared_ptr<RequestRecorder> request_recorder_;
+    std::shared_ptr<HistoryCache> history_cache_;
+    std::shared_ptr<CodeCache> code_cache_;
+    std::shared_ptr<StateCheckpointCache> state_checkpoint_cache_;
+    std::shared_ptr<CallResultCache> call_result_cache_;
+    std::shared_ptr<ethdb::file::TraceStore> trace_store_;
+    std::shared_ptr<filters::FilterRegistry> filter_registry_;
+    std::shared_ptr<core::SenderRecovery> sender_recovery_;
+    std::shared_ptr<ethash::WorkVerifier> work_verifier_;
+    std::shared_ptr<HeaderCache> header_cache_;
+    std::shared_ptr<TimestampIndex> timestamp_index_;
+    std::shared_ptr<IssuanceIndex> issuance_index_;
+    std::shared_ptr<TrieNodeCache> trie_node_cache_;
+    std::shared_ptr<ethbackend::BackEndInfoCache> backend_info_cache_;
+    std::shared_ptr<ethdb::kv::StateChangesApplier> state_changes_applier_;
+    std::shared_ptr<ContextLoad> streaming_load_;
+    std::shared_ptr<SamplingProfiler> sampling_profiler_;
+    std::shared_ptr<http::PeerClient> peer_client_;
+    std::shared_ptr<http::BufferPool> buffer_pool_;
+    //! The debug_accountRange sessions are bound to the transactions of this context, so they are never shared
+    std::shared_ptr<AccountRangeSessions> account_range_sessions_;
     WaitMode wait_mode_;
+    std::chrono::microseconds wait_latency_budget_;
 };
 
 std::ostream& operator<<(std::ostream& out, Context& c);
@@ -104,7 +231,18 @@ std::ostream& operator<<(std::ostream& out, Context& c);
 // [currently cannot start/stop more than once because grpc::CompletionQueue cannot be used after shutdown]
 class ContextPool {
 public:
-    explicit ContextPool(std::size_t pool_size, ChannelFactory create_channel, WaitMode wait_mode = WaitMode::blocking);
+    //! The chaindata environment, if any, is read directly by all the contexts instead of using the remote KV interface
+    //! and the log index, if any, is consulted by all the contexts before reading the logs. Otherwise each context opens
+    //! its own channels for the remote KV transactions, so that the connections grow with the number of contexts.
+    //! The context threads, if CPUs are specified, are pinned in round-robin order to them (the gRPC threads polling
+    //! the completion queues are spawned by the context threads, so they inherit the same affinity). The reserved contexts
+    //! are additional contexts never returned by next_context, so that the traffic served on them is isolated from the rest.
+    //! The replica channel factories, if any, create the channels to the additional KV backends serving the transactions
+    explicit ContextPool(std::size_t pool_size, ChannelFactory create_channel, WaitMode wait_mode = WaitMode::blocking,
+        std::shared_ptr<::mdbx::env_managed> chaindata_env = nullptr, std::shared_ptr<ethdb::file::LogIndex> log_index = nullptr,
+        uint32_t num_kv_channels = kDefaultNumKvChannels, CpuList context_cpus = {},
+        std::chrono::microseconds wait_latency_budget = kDefaultWaitLatencyBudget, std::size_t num_reserved_contexts = 0,
+        std::vector<ChannelFactory> create_replica_channels = {});
     ~ContextPool();
 
     ContextPool(const ContextPool&) = delete;
@@ -118,20 +256,121 @@ public:
 
     void run();
 
+    //! Return the less loaded between the next context in round-robin order and another one at random (see ContextLoad)
     Context& next_context();
 
     boost::asio::io_context& next_io_context();
 
+    //! Return the reserved context at the specified index, which must be less than the number of reserved contexts
+    Context& reserved_context(std::size_t index);
+
+    //! Enable the admission control shared among all the execution contexts, reserved ones included
+    void set_admission_control(std::shared_ptr<AdmissionControl> admission_control);
+
+    //! Enable the per-client rate limiting shared among all the execution contexts, reserved ones included
+    void set_rate_limiter(std::shared_ptr<RateLimiter> rate_limiter);
+
+    //! Enable the default request timeouts shared among all the execution contexts, reserved ones included
+    void set_request_timeouts(std::shared_ptr<RequestTimeouts> request_timeouts);
+
+    //! Enable the request tracing shared among all the execution contexts, reserved ones included
+    void set_tracer(std::shared_ptr<Tracer> tracer);
+
+    //! Enable the request recording shared among all the execution contexts, reserved ones included
+    void set_request_recorder(std::shared_ptr<RequestRecorder> request_recorder);
+
+    //! Replace the block cache shared among all the execution contexts, reserved ones included
+    void set_block_cache(std::shared_ptr<BlockCache> block_cache);
+
+    //! Replace the state cache shared among all the execution contexts, reserved ones included
+    void set_state_cache(std::shared_ptr<ethdb::kv::StateCache> state_cache);
+
+    //! Enable the history cache shared among all the execution contexts, reserved ones included
+    void set_history_cache(std::shared_ptr<HistoryCache> history_cache);
+
+    //! Enable the log offset cache shared among all the execution contexts, reserved ones included
+    void set_log_offset_cache(std::shared_ptr<ethdb::file::LogOffsetCache> log_offset_cache);
+
+    //! Enable the code cache shared among all the execution contexts, reserved ones included
+    void set_code_cache(std::shared_ptr<CodeCache> code_cache);
+
+    //! Enable the intra-block state checkpoints shared among all the execution contexts, reserved ones included
+    void set_state_checkpoint_cache(std::shared_ptr<StateCheckpointCache> state_checkpoint_cache);
+
+    //! Enable the eth_call result cache shared among all the execution contexts, reserved ones included
+    void set_call_result_cache(std::shared_ptr<CallResultCache> call_result_cache);
+
+    //! Enable the trace store shared among all the execution contexts, reserved ones included
+    void set_trace_store(std::shared_ptr<ethdb::file::TraceStore> trace_store);
+
+    //! Enable the registry of the eth_newFilter filters shared among all the execution contexts, reserved ones included
+    void set_filter_registry(std::shared_ptr<filters::FilterRegistry> filter_registry);
+
+    //! Enable the mirror of the transaction pool serving the pool lookups of all the execution contexts, reserved ones included
+    void set_pool_mirror(std::shared_ptr<txpool::PoolMirror> pool_mirror);
+
+    //! Enable the sender recovery on the workers shared among all the execution contexts, reserved ones included
+    void set_sender_recovery(std::shared_ptr<core::SenderRecovery> sender_recovery);
+
+    //! Enable the verification of the submitted proofs of work shared among all the execution contexts, reserved ones included
+    void set_work_verifier(std::shared_ptr<ethash::WorkVerifier> work_verifier);
+
+    //! Enable the header cache shared among all the execution contexts, reserved ones included
+    void set_header_cache(std::shared_ptr<HeaderCache> header_cache);
+
+    //! Enable the block timestamp index shared among all the execution contexts, reserved ones included
+    void set_timestamp_index(std::shared_ptr<TimestampIndex> timestamp_index);
+
+    //! Enable the index of the recent block issuance shared among all the execution contexts, reserved ones included
+    void set_issuance_index(std::shared_ptr<IssuanceIndex> issuance_index);
+
+    //! Enable the trie node cache shared among all the execution contexts, reserved ones included
+    void set_trie_node_cache(std::shared_ptr<TrieNodeCache> trie_node_cache);
+
+    //! Enable the remote backend values cache shared among all the execution contexts, reserved ones included
+    void set_backend_info_cache(std::shared_ptr<ethbackend::BackEndInfoCache> backend_info_cache);
+
+    //! Enable the applier of the state changes off the stream scheduler shared among all the execution contexts, reserved ones included
+    void set_state_changes_applier(std::shared_ptr<ethdb::kv::StateChangesApplier> state_changes_applier);
+
+    //! Enable the load of the context dedicated to the streams shared among all the execution contexts, reserved ones included
+    void set_streaming_load(std::shared_ptr<ContextLoad> streaming_load);
+
+    //! Enable the sampling profiler served on the profile endpoint shared among all the execution contexts, reserved ones included
+    void set_sampling_profiler(std::shared_ptr<SamplingProfiler> sampling_profiler);
+
+    //! Enable the routing of the requests to the replicas owning them on the peer ring shared among all the execution
+    //! contexts, reserved ones included: each context gets its own client, keeping its connections to the peers
+    void set_peer_ring(std::shared_ptr<const PeerRing> peer_ring);
+
+    //! Enable the chain head cache shared among the databases of all the execution contexts, reserved ones included
+    void set_chain_head_cache(std::shared_ptr<ChainHeadCache> chain_head_cache);
+
+    //! Enable the combining of the identical point reads in flight on the database of each execution context, reserved ones included
+    void enable_read_combining();
+
+    //! Enable the local reading of the frozen blocks shared among the databases of all the execution contexts, reserved ones included
+    void set_snapshots(std::shared_ptr<const ethdb::snapshot::SnapshotRepository> snapshots);
+
+    //! Notify all the execution contexts that the specified database view is the latest one
+    void notify_new_view(uint64_t view_id);
+
 private:
-    // The pool of contexts
+    // The pool of contexts, the reserved ones last
     std::vector<Context> contexts_;
 
+    //! The number of contexts returned by next_context, i.e. not reserved
+    std::size_t pool_size_;
+
     //! The pool of threads running the execution contexts.
     boost::asio::detail::thread_group context_threads_;
 
     // The next index to use for a context
     std::size_t next_index_;
 
+    //! The CPUs to pin the context threads to, empty means no pinning.
+    CpuList context_cpus_;
+
     //! Flag indicating if pool has been stopped.
     bool stopped_{false};
 };
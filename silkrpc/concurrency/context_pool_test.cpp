@@ -38,23 +38,27 @@ TEST_CASE("Context", "[silkrpc][context_pool]") {
     SILKRPC_LOG_VERBOSITY(LogLevel::None);
 
     auto block_cache = std::make_shared<BlockCache>();
+    auto receipt_cache = std::make_shared<ReceiptCache>();
     auto state_cache = std::make_shared<ethdb::kv::CoherentStateCache>();
+    auto access_history = std::make_shared<AccessHistory>();
 
     WaitMode all_wait_modes[] = {
-        WaitMode::backoff, WaitMode::blocking, WaitMode::sleeping, WaitMode::yielding, WaitMode::spin_wait, WaitMode::busy_spin
+        WaitMode::backoff, WaitMode::blocking, WaitMode::sleeping, WaitMode::yielding, WaitMode::spin_wait, WaitMode::busy_spin,
+        WaitMode::adaptive
     };
     for (auto wait_mode : all_wait_modes) {
         SECTION(std::string("Context::Context wait_mode=") + std::to_string(static_cast<int>(wait_mode))) {
-            Context context{create_channel, block_cache, state_cache, wait_mode};
+            Context context{create_channel, block_cache, receipt_cache, state_cache, access_history, wait_mode};
             CHECK_NOTHROW(context.io_context() != nullptr);
             CHECK_NOTHROW(context.grpc_context() != nullptr);
             CHECK_NOTHROW(context.backend() != nullptr);
             CHECK_NOTHROW(context.miner() != nullptr);
             CHECK_NOTHROW(context.block_cache() != nullptr);
+            CHECK_NOTHROW(context.receipt_cache() != nullptr);
         }
 
         SECTION(std::string("Context::execute_loop wait_mode=") + std::to_string(static_cast<int>(wait_mode))) {
-            Context context{create_channel, block_cache, state_cache, wait_mode};
+            Context context{create_channel, block_cache, receipt_cache, state_cache, access_history, wait_mode};
             std::atomic_bool processed{false};
             auto* io_context = context.io_context();
             boost::asio::post(*io_context, [&]() {
@@ -67,7 +71,7 @@ TEST_CASE("Context", "[silkrpc][context_pool]") {
         }
 
         SECTION(std::string("Context::stop wait_mode=") + std::to_string(static_cast<int>(wait_mode))) {
-            Context context{create_channel, block_cache, state_cache, wait_mode};
+            Context context{create_channel, block_cache, receipt_cache, state_cache, access_history, wait_mode};
             std::atomic_bool processed{false};
             auto* io_context = context.io_context();
             boost::asio::post(*io_context, [&]() {
@@ -120,6 +124,41 @@ TEST_CASE("create context pool", "[silkrpc][context_pool]") {
         CHECK(&io_context2 == &io_context5);
         CHECK(&io_context3 == &io_context6);
     }
+
+    SECTION("prefer the less loaded context") {
+        ContextPool cp{2, create_channel};
+
+        auto& context1 = cp.next_context();
+        auto& context2 = cp.next_context();
+        CHECK(&context1 != &context2);
+
+        const auto request = context1.load()->track_request();
+        CHECK(&cp.next_context() == &context2);
+        CHECK(&cp.next_context() == &context2);
+    }
+
+    SECTION("open multiple KV channels per context") {
+        std::size_t num_channels{0};
+        ChannelFactory counting_create_channel = [&]() {
+            ++num_channels;
+            return create_channel();
+        };
+        ContextPool cp{2, counting_create_channel, WaitMode::blocking, nullptr, nullptr, /*num_kv_channels=*/3};
+        CHECK(num_channels == 2 * 3);
+        CHECK(cp.next_context().database() != nullptr);
+    }
+
+    SECTION("reserve contexts never returned as next") {
+        ContextPool cp{2, create_channel, WaitMode::blocking, nullptr, nullptr, kDefaultNumKvChannels, {}, kDefaultWaitLatencyBudget,
+            /*num_reserved_contexts=*/1};
+        auto& reserved_context = cp.reserved_context(0);
+        for (auto i{0}; i < 4; ++i) {
+            CHECK(&cp.next_context() != &reserved_context);
+        }
+        CHECK(reserved_context.block_cache() == cp.next_context().block_cache());
+        CHECK(reserved_context.method_latencies() != nullptr);
+        CHECK_THROWS_AS(cp.reserved_context(1), std::out_of_range);
+    }
 }
 
 TEST_CASE("start context pool", "[silkrpc][context_pool]") {
@@ -138,6 +177,13 @@ TEST_CASE("start context pool", "[silkrpc][context_pool]") {
         cp.stop();
         cp.join();
     }
+
+    SECTION("running 3 thread pinned to CPU") {
+        ContextPool cp{3, create_channel, WaitMode::blocking, nullptr, nullptr, kDefaultNumKvChannels, CpuList{0}};
+        cp.start();
+        cp.stop();
+        cp.join();
+    }
 }
 
 TEST_CASE("run context pool", "[silkrpc][context_pool]") {
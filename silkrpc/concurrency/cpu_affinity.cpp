@@ -0,0 +1,111 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "cpu_affinity.hpp"
+
+#include <atomic>
+#include <charconv>
+#include <fstream>
+#include <latch>
+#include <stdexcept>
+#include <string_view>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <boost/asio/post.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc {
+
+static uint32_t parse_cpu(std::string_view cpu, const std::string& cpu_list) {
+    uint32_t index{0};
+    const auto [end, ec] = std::from_chars(cpu.data(), cpu.data() + cpu.size(), index);
+    if (cpu.empty() || ec != std::errc{} || end != cpu.data() + cpu.size()) {
+        throw std::invalid_argument{"invalid CPU list: " + cpu_list};
+    }
+    return index;
+}
+
+CpuList parse_cpu_list(const std::string& cpu_list) {
+    CpuList cpus;
+    std::string_view remaining{cpu_list};
+    while (!remaining.empty()) {
+        const auto separator = remaining.find(',');
+        const auto item = remaining.substr(0, separator);
+        remaining = separator == std::string_view::npos ? std::string_view{} : remaining.substr(separator + 1);
+
+        const auto dash = item.find('-');
+        const auto first = parse_cpu(item.substr(0, dash), cpu_list);
+        const auto last = dash == std::string_view::npos ? first : parse_cpu(item.substr(dash + 1), cpu_list);
+        if (last < first) {
+            throw std::invalid_argument{"invalid CPU list: " + cpu_list};
+        }
+        for (auto cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+CpuList numa_node_cpus(uint32_t numa_node) {
+    std::ifstream cpu_list_file{"/sys/devices/system/node/node" + std::to_string(numa_node) + "/cpulist"};
+    std::string cpu_list;
+    if (!cpu_list_file || !std::getline(cpu_list_file, cpu_list)) {
+        return {};
+    }
+    return parse_cpu_list(cpu_list);
+}
+
+bool pin_current_thread(uint32_t cpu) {
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    const auto result = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    if (result != 0) {
+        SILKRPC_WARN << "pin_current_thread cpu: " << cpu << " failed error: " << result << "\n";
+        return false;
+    }
+    return true;
+#else
+    SILKRPC_WARN << "pin_current_thread cpu: " << cpu << " not supported on this platform\n";
+    return false;
+#endif
+}
+
+void pin_thread_pool(boost::asio::thread_pool& pool, std::size_t num_threads, const CpuList& cpus) {
+    if (cpus.empty() || num_threads == 0) {
+        return;
+    }
+    // Each task blocks until all of them have started, so that every thread in the pool executes exactly one of them
+    std::latch all_started{static_cast<std::ptrdiff_t>(num_threads)};
+    std::latch all_pinned{static_cast<std::ptrdiff_t>(num_threads)};
+    std::atomic<std::size_t> next_cpu_index{0};
+    for (std::size_t i{0}; i < num_threads; ++i) {
+        boost::asio::post(pool, [&]() {
+            all_started.arrive_and_wait();
+            pin_current_thread(cpus[next_cpu_index++ % cpus.size()]);
+            all_pinned.count_down();
+        });
+    }
+    all_pinned.wait();
+}
+
+} // namespace silkrpc
@@ -0,0 +1,46 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_CONCURRENCY_CPU_AFFINITY_HPP_
+#define SILKRPC_CONCURRENCY_CPU_AFFINITY_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/asio/thread_pool.hpp>
+
+namespace silkrpc {
+
+//! The CPUs (i.e. cores or hardware threads) by index, in the order they are assigned to threads
+using CpuList = std::vector<uint32_t>;
+
+//! Parse the CPU list in the Linux format, i.e. comma-separated indexes or inclusive ranges like "0-3,8,10-11"
+CpuList parse_cpu_list(const std::string& cpu_list);
+
+//! Return the CPUs local to the NUMA node, empty if unknown
+CpuList numa_node_cpus(uint32_t numa_node);
+
+//! Pin the calling thread to the CPU, returning false if not supported or failed
+bool pin_current_thread(uint32_t cpu);
+
+//! Pin each thread of the pool to one CPU of the list, in round-robin order: it waits until all the threads are pinned
+void pin_thread_pool(boost::asio::thread_pool& pool, std::size_t num_threads, const CpuList& cpus);
+
+} // namespace silkrpc
+
+#endif // SILKRPC_CONCURRENCY_CPU_AFFINITY_HPP_
@@ -0,0 +1,48 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "cpu_affinity.hpp"
+
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc {
+
+TEST_CASE("parse CPU list", "[silkrpc][concurrency][cpu_affinity]") {
+    CHECK(parse_cpu_list("").empty());
+    CHECK(parse_cpu_list("3") == CpuList{3});
+    CHECK(parse_cpu_list("0-3") == CpuList{0, 1, 2, 3});
+    CHECK(parse_cpu_list("0-1,8,10-11") == CpuList{0, 1, 8, 10, 11});
+
+    CHECK_THROWS_AS(parse_cpu_list("a"), std::invalid_argument);
+    CHECK_THROWS_AS(parse_cpu_list("1,"), std::invalid_argument);
+    CHECK_THROWS_AS(parse_cpu_list("3-1"), std::invalid_argument);
+    CHECK_THROWS_AS(parse_cpu_list("1-"), std::invalid_argument);
+}
+
+TEST_CASE("pin thread pool", "[silkrpc][concurrency][cpu_affinity]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+
+    boost::asio::thread_pool pool{2};
+    CHECK_NOTHROW(pin_thread_pool(pool, 2, CpuList{0}));
+    CHECK_NOTHROW(pin_thread_pool(pool, 2, CpuList{}));
+    pool.join();
+}
+
+} // namespace silkrpc
@@ -0,0 +1,125 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "frame_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <new>
+
+namespace silkrpc {
+
+namespace {
+
+struct FreeFrame {
+    FreeFrame* next;
+};
+
+//! The free lists of one thread: trivially destructible, so that they stay usable while the thread exits
+struct FreeLists {
+    std::array<FreeFrame*, FramePool::kNumBuckets> heads;
+    std::array<std::size_t, FramePool::kNumBuckets> counts;
+    FramePool::Stats stats;
+    bool registered;
+    bool released;
+};
+
+thread_local FreeLists free_lists{};
+
+//! Release the frames kept by the thread when it exits, any frame released afterwards going to the underlying allocator
+struct FreeListsReleaser {
+    ~FreeListsReleaser() {
+        FramePool::release_thread_frames();
+        free_lists.released = true;
+    }
+};
+
+thread_local FreeListsReleaser free_lists_releaser;
+
+constexpr std::size_t round_up(std::size_t size, std::size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+constexpr std::size_t bucket_of(std::size_t size) {
+    return (std::max<std::size_t>(size, 1) - 1) / FramePool::kBucketGranularity;
+}
+
+void* allocate_frame(std::size_t size, std::size_t alignment) {
+    // std::aligned_alloc requires the size to be a multiple of the alignment, any frame is released by std::free
+    void* pointer = std::aligned_alloc(alignment, round_up(size, alignment));
+    if (pointer == nullptr) {
+        throw std::bad_alloc{};
+    }
+    return pointer;
+}
+
+} // namespace
+
+void* FramePool::allocate(std::size_t size, std::size_t alignment) {
+    if (size > kMaxPooledSize || alignment > kBucketGranularity) {
+        ++free_lists.stats.misses;
+        return allocate_frame(size, std::max(alignment, kBucketGranularity));
+    }
+    const auto bucket = bucket_of(size);
+    if (auto frame = free_lists.heads[bucket]; frame != nullptr) {
+        free_lists.heads[bucket] = frame->next;
+        --free_lists.counts[bucket];
+        --free_lists.stats.pooled_frames;
+        ++free_lists.stats.hits;
+        return frame;
+    }
+    ++free_lists.stats.misses;
+    return allocate_frame((bucket + 1) * kBucketGranularity, kBucketGranularity);
+}
+
+void FramePool::deallocate(void* pointer, std::size_t size) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+    const auto bucket = bucket_of(size);
+    if (size > kMaxPooledSize || free_lists.released || free_lists.counts[bucket] == kMaxFramesPerBucket) {
+        std::free(pointer);
+        return;
+    }
+    if (!free_lists.registered) {
+        // Touch the releaser just once, so that it is constructed and then destroyed when the thread exits
+        free_lists.registered = true;
+        static_cast<void>(&free_lists_releaser);
+    }
+    auto frame = static_cast<FreeFrame*>(pointer);
+    frame->next = free_lists.heads[bucket];
+    free_lists.heads[bucket] = frame;
+    ++free_lists.counts[bucket];
+    ++free_lists.stats.pooled_frames;
+}
+
+FramePool::Stats FramePool::thread_stats() noexcept {
+    return free_lists.stats;
+}
+
+void FramePool::release_thread_frames() noexcept {
+    for (std::size_t bucket{0}; bucket < kNumBuckets; ++bucket) {
+        while (auto frame = free_lists.heads[bucket]) {
+            free_lists.heads[bucket] = frame->next;
+            std::free(frame);
+        }
+        free_lists.counts[bucket] = 0;
+    }
+    free_lists.stats.pooled_frames = 0;
+}
+
+} // namespace silkrpc
@@ -0,0 +1,92 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_CONCURRENCY_FRAME_POOL_HPP_
+#define SILKRPC_CONCURRENCY_FRAME_POOL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/asio/detail/thread_info_base.hpp>
+#include <boost/asio/version.hpp>
+
+namespace silkrpc {
+
+//! Recycling allocator of the coroutine frames, keeping for each thread the released frames in free lists bucketed by
+//! size, so that the short-lived frames of the handlers, cursor operations and state reads reuse the memory of the ones
+//! just completed. A frame released by a thread other than the allocating one goes into the free lists of the former.
+//! Asio recycles at most one frame per thread, which is of no use for the deep chains of frames spawned when walking
+class FramePool {
+public:
+    //! The size granularity of the buckets, also the alignment of the frames
+    static constexpr std::size_t kBucketGranularity{64};
+
+    //! The maximum size of the pooled frames, the larger ones being allocated and released directly
+    static constexpr std::size_t kMaxPooledSize{8 * 1024};
+
+    //! The number of buckets, one for each multiple of the granularity up to the maximum size
+    static constexpr std::size_t kNumBuckets{kMaxPooledSize / kBucketGranularity};
+
+    //! The maximum number of released frames kept in each bucket, so that one thread cannot hoard memory after a burst
+    static constexpr std::size_t kMaxFramesPerBucket{256};
+
+    //! The statistics of the calling thread
+    struct Stats {
+        uint64_t hits{0};           // allocations served from the free lists
+        uint64_t misses{0};         // allocations served by the underlying allocator
+        uint64_t pooled_frames{0};  // released frames currently kept in the free lists
+    };
+
+    //! Allocate one frame of the specified size and alignment, reusing one released by the calling thread if any
+    static void* allocate(std::size_t size, std::size_t alignment);
+
+    //! Release the frame of the specified size, keeping it in the free lists of the calling thread unless full
+    static void deallocate(void* pointer, std::size_t size) noexcept;
+
+    //! Return the statistics of the calling thread
+    static Stats thread_stats() noexcept;
+
+    //! Release to the underlying allocator all the frames kept by the calling thread
+    static void release_thread_frames() noexcept;
+};
+
+} // namespace silkrpc
+
+// Plug the pool into the allocation of the awaitable frames by Asio, which goes through these recycling hooks. The
+// specializations must be visible before any coroutine is defined, i.e. in every translation unit including
+// <silkrpc/config.hpp> before Asio, otherwise frames allocated and released in different units would mismatch
+namespace boost::asio::detail {
+
+#if BOOST_ASIO_VERSION >= 102100
+template <>
+inline void* thread_info_base::allocate(thread_info_base::awaitable_frame_tag, thread_info_base*, std::size_t size, std::size_t align) {
+    return silkrpc::FramePool::allocate(size, align);
+}
+#else
+template <>
+inline void* thread_info_base::allocate(thread_info_base::awaitable_frame_tag, thread_info_base*, std::size_t size) {
+    return silkrpc::FramePool::allocate(size, alignof(std::max_align_t));
+}
+#endif // BOOST_ASIO_VERSION >= 102100
+
+template <>
+inline void thread_info_base::deallocate(thread_info_base::awaitable_frame_tag, thread_info_base*, void* pointer, std::size_t size) {
+    silkrpc::FramePool::deallocate(pointer, size);
+}
+
+} // namespace boost::asio::detail
+
+#endif // SILKRPC_CONCURRENCY_FRAME_POOL_HPP_
@@ -0,0 +1,111 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "frame_pool.hpp"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+static boost::asio::awaitable<int> leaf(int value) {
+    co_return value + 1;
+}
+
+static boost::asio::awaitable<int> walk(int depth) {
+    int sum{0};
+    for (int i{0}; i < depth; ++i) {
+        sum += co_await leaf(i);
+    }
+    co_return sum;
+}
+
+TEST_CASE("FramePool::allocate", "[silkrpc][concurrency][frame_pool]") {
+    std::thread{[]() {
+        SECTION("reuse released frame in same bucket") {
+            void* frame = FramePool::allocate(100, alignof(std::max_align_t));
+            FramePool::deallocate(frame, 100);
+            CHECK(FramePool::thread_stats().pooled_frames == 1);
+            CHECK(FramePool::allocate(120, alignof(std::max_align_t)) == frame);
+            CHECK(FramePool::thread_stats().hits == 1);
+            CHECK(FramePool::thread_stats().pooled_frames == 0);
+            FramePool::deallocate(frame, 120);
+        }
+
+        SECTION("no reuse across buckets") {
+            void* frame = FramePool::allocate(64, alignof(std::max_align_t));
+            FramePool::deallocate(frame, 64);
+            void* other = FramePool::allocate(65, alignof(std::max_align_t));
+            CHECK(FramePool::thread_stats().hits == 0);
+            FramePool::deallocate(other, 65);
+            CHECK(FramePool::thread_stats().pooled_frames == 2);
+        }
+
+        SECTION("large frames are not pooled") {
+            void* frame = FramePool::allocate(FramePool::kMaxPooledSize + 1, alignof(std::max_align_t));
+            FramePool::deallocate(frame, FramePool::kMaxPooledSize + 1);
+            CHECK(FramePool::thread_stats().pooled_frames == 0);
+        }
+
+        SECTION("over-aligned frames") {
+            void* frame = FramePool::allocate(100, 256);
+            CHECK(reinterpret_cast<std::uintptr_t>(frame) % 256 == 0);
+            FramePool::deallocate(frame, 100);
+        }
+
+        SECTION("bounded free lists") {
+            std::vector<void*> frames;
+            for (std::size_t i{0}; i < FramePool::kMaxFramesPerBucket + 1; ++i) {
+                frames.push_back(FramePool::allocate(32, alignof(std::max_align_t)));
+            }
+            for (auto frame : frames) {
+                FramePool::deallocate(frame, 32);
+            }
+            CHECK(FramePool::thread_stats().pooled_frames == FramePool::kMaxFramesPerBucket);
+        }
+
+        FramePool::release_thread_frames();
+        CHECK(FramePool::thread_stats().pooled_frames == 0);
+    }}.join();
+}
+
+TEST_CASE("FramePool recycles awaitable frames", "[silkrpc][concurrency][frame_pool]") {
+    std::thread{[]() {
+        boost::asio::io_context io_context;
+        int result{0};
+        boost::asio::co_spawn(io_context, [&]() -> boost::asio::awaitable<void> {
+            for (int i{0}; i < 100; ++i) {
+                result = co_await walk(10);
+            }
+        }, boost::asio::detached);
+        io_context.run();
+        CHECK(result == 55);
+        const auto stats = FramePool::thread_stats();
+        CHECK(stats.hits > 1000);
+        CHECK(stats.misses < 10);
+    }}.join();
+}
+
+} // namespace silkrpc
@@ -0,0 +1,34 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "handoff.hpp"
+
+namespace silkrpc {
+
+void Handoff::drain() {
+    drain_pending_.store(false, std::memory_order_relaxed);
+    // Pair with the fence in post, so that any handler pushed after the last pop below finds no drain pending
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    drain_count_.fetch_add(1, std::memory_order_relaxed);
+    queue_.run();
+}
+
+void Handoff::shutdown() {
+    queue_.clear();
+}
+
+} // namespace silkrpc
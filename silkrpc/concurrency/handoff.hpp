@@ -0,0 +1,93 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_CONCURRENCY_HANDOFF_HPP_
+#define SILKRPC_CONCURRENCY_HANDOFF_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/execution_context.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+
+#include <silkrpc/concurrency/handoff_queue.hpp>
+
+namespace silkrpc {
+
+//! Handoff of the handlers posted from other threads (e.g. the workers running the EVM) to the thread running one
+//! io_context through a lock-free HandoffQueue instead of the mutex-protected Asio queue, the handlers too large or
+//! finding the queue full falling back to the latter. The handlers handed off while the context thread keeps running
+//! are executed altogether by one single drain handler posted to Asio or, if the context thread polls this handoff in
+//! its loop, without posting anything at all. Asio service of the io_context: get it once by boost::asio::use_service,
+//! which locks the service registry, and keep it.
+class Handoff : public boost::asio::execution_context::service {
+public:
+    using key_type = Handoff;
+
+    static inline boost::asio::execution_context::id id;
+
+    //! The capacity of the queue
+    static constexpr std::size_t kCapacity{1024};
+
+    explicit Handoff(boost::asio::io_context& io_context)
+        : boost::asio::execution_context::service{io_context}, io_context_{io_context}, queue_{kCapacity} {}
+
+    boost::asio::io_context& io_context() noexcept { return io_context_; }
+
+    //! Hand off the handler to the context thread
+    template <typename Handler>
+    void post(Handler&& handler) {
+        if (!queue_.try_push(std::forward<Handler>(handler))) {
+            // The handler is left untouched when not pushed, because it is constructed into the claimed cell only
+            boost::asio::post(io_context_, std::forward<Handler>(handler)); // NOLINT(bugprone-use-after-move)
+            return;
+        }
+        // Pair with the fence in drain, so that either the drain handler sees this handler or this sees no drain pending
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!polled_.load(std::memory_order_relaxed) && !drain_pending_.exchange(true, std::memory_order_relaxed)) {
+            boost::asio::post(io_context_, [this]() { drain(); });
+        }
+    }
+
+    //! Make the context thread poll this handoff in its loop, so that no drain handler is ever posted
+    void set_polled(bool polled) noexcept { polled_.store(polled, std::memory_order_relaxed); }
+
+    //! Execute the handlers handed off so far on the calling context thread, returning their count
+    std::size_t poll() { return queue_.run(); }
+
+    uint64_t drain_count() const noexcept { return drain_count_.load(std::memory_order_relaxed); }
+
+private:
+    void drain();
+
+    void shutdown() override;
+
+    boost::asio::io_context& io_context_;
+    HandoffQueue queue_;
+    std::atomic_bool polled_{false};
+    std::atomic_bool drain_pending_{false};
+    std::atomic<uint64_t> drain_count_{0};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_CONCURRENCY_HANDOFF_HPP_
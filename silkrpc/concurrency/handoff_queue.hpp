@@ -0,0 +1,183 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_CONCURRENCY_HANDOFF_QUEUE_HPP_
+#define SILKRPC_CONCURRENCY_HANDOFF_QUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace silkrpc {
+
+//! Bounded lock-free queue of handlers having any number of producer and consumer threads (Dmitry Vyukov's MPMC
+//! algorithm): each handler is constructed in place into the storage of its cell and executed there, so that handing it
+//! off costs neither a lock nor a heap allocation. Pushing into a full queue or a handler larger than kHandlerSize
+//! just fails, leaving the caller free to fall back to another channel.
+class HandoffQueue {
+public:
+    //! The max size of the handlers stored inline in the cells
+    static constexpr std::size_t kHandlerSize{96};
+
+    //! Return true if the handler type fits into the cells
+    template <typename Handler>
+    static constexpr bool fits() noexcept {
+        return sizeof(Handler) <= kHandlerSize && alignof(Handler) <= alignof(std::max_align_t) && std::is_nothrow_destructible_v<Handler>;
+    }
+
+    //! The capacity must be a power of 2
+    explicit HandoffQueue(std::size_t capacity) : mask_{mask_of(capacity)}, cells_{std::make_unique<Cell[]>(capacity)} {
+        for (std::size_t i{0}; i < capacity; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    ~HandoffQueue() { clear(); }
+
+    HandoffQueue(const HandoffQueue&) = delete;
+    HandoffQueue& operator=(const HandoffQueue&) = delete;
+
+    std::size_t capacity() const noexcept { return mask_ + 1; }
+
+    //! Construct the handler at the back, returning false if the queue is full or the handler does not fit
+    template <typename Handler>
+    bool try_push(Handler&& handler) {
+        using DecayedHandler = std::decay_t<Handler>;
+        // The cell is claimed before constructing the handler into it, hence such construction must never throw
+        if constexpr (!fits<DecayedHandler>() || !std::is_nothrow_constructible_v<DecayedHandler, Handler&&>) {
+            return false;
+        } else {
+            auto position = enqueue_position_.load(std::memory_order_relaxed);
+            Cell* cell{nullptr};
+            while (true) {
+                cell = &cells_[position & mask_];
+                const auto sequence = cell->sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+                if (difference == 0) {
+                    if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (difference < 0) {
+                    return false; // full
+                } else {
+                    position = enqueue_position_.load(std::memory_order_relaxed);
+                }
+            }
+            ::new (static_cast<void*>(cell->storage)) DecayedHandler(std::forward<Handler>(handler));
+            cell->run = [](void* storage, bool execute) {
+                auto* stored_handler = std::launder(static_cast<DecayedHandler*>(storage));
+                if (execute) {
+                    const HandlerDestroyer<DecayedHandler> destroyer{stored_handler};
+                    (*stored_handler)();
+                } else {
+                    stored_handler->~DecayedHandler();
+                }
+            };
+            cell->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+    }
+
+    //! Execute the handler at the front, if any, returning false if the queue is empty
+    bool try_run_one() { return pop(/*execute=*/true); }
+
+    //! Execute all the handlers found in the queue, including the ones pushed meanwhile, returning their count
+    std::size_t run() {
+        std::size_t count{0};
+        while (pop(/*execute=*/true)) {
+            ++count;
+        }
+        return count;
+    }
+
+    //! Destroy all the handlers found in the queue without executing them
+    void clear() noexcept {
+        while (pop(/*execute=*/false)) {
+        }
+    }
+
+    //! Return true if the queue looks empty, possibly missing the handlers being pushed concurrently
+    bool empty() const noexcept {
+        const auto position = dequeue_position_.load(std::memory_order_relaxed);
+        return cells_[position & mask_].sequence.load(std::memory_order_acquire) != position + 1;
+    }
+
+private:
+    using RunFunction = void (*)(void*, bool);
+
+    static std::size_t mask_of(std::size_t capacity) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument{"HandoffQueue::HandoffQueue capacity is not a power of 2: " + std::to_string(capacity)};
+        }
+        return capacity - 1;
+    }
+
+    struct alignas(64) Cell {
+        std::atomic<std::size_t> sequence{0};
+        RunFunction run{nullptr};
+        alignas(std::max_align_t) std::byte storage[kHandlerSize];
+    };
+
+    //! Destroy the handler once executed, even if it throws
+    template <typename Handler>
+    struct HandlerDestroyer {
+        Handler* handler;
+        ~HandlerDestroyer() { handler->~Handler(); }
+    };
+
+    //! Release the cell to the producers once its handler is gone, even if it throws
+    struct CellReleaser {
+        Cell* cell;
+        std::size_t next_sequence;
+        ~CellReleaser() { cell->sequence.store(next_sequence, std::memory_order_release); }
+    };
+
+    bool pop(bool execute) {
+        auto position = dequeue_position_.load(std::memory_order_relaxed);
+        Cell* cell{nullptr};
+        while (true) {
+            cell = &cells_[position & mask_];
+            const auto sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+            if (difference == 0) {
+                if (dequeue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false; // empty
+            } else {
+                position = dequeue_position_.load(std::memory_order_relaxed);
+            }
+        }
+        const CellReleaser releaser{cell, position + mask_ + 1};
+        cell->run(cell->storage, execute);
+        return true;
+    }
+
+    const std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<std::size_t> enqueue_position_{0};
+    alignas(64) std::atomic<std::size_t> dequeue_position_{0};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_CONCURRENCY_HANDOFF_QUEUE_HPP_
@@ -0,0 +1,128 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "handoff_queue.hpp"
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+TEST_CASE("HandoffQueue::HandoffQueue", "[silkrpc][concurrency][handoff_queue]") {
+    CHECK_THROWS_AS(HandoffQueue{0}, std::invalid_argument);
+    CHECK_THROWS_AS(HandoffQueue{3}, std::invalid_argument);
+    CHECK(HandoffQueue{4}.capacity() == 4);
+}
+
+TEST_CASE("HandoffQueue::try_push", "[silkrpc][concurrency][handoff_queue]") {
+    HandoffQueue queue{4};
+    CHECK(queue.empty());
+    CHECK(!queue.try_run_one());
+
+    SECTION("run in push order") {
+        std::vector<int> executed;
+        for (int i{0}; i < 3; ++i) {
+            CHECK(queue.try_push([&executed, i]() { executed.push_back(i); }));
+        }
+        CHECK(!queue.empty());
+        CHECK(queue.run() == 3);
+        CHECK(executed == std::vector<int>{0, 1, 2});
+        CHECK(queue.empty());
+    }
+
+    SECTION("full queue") {
+        int executed{0};
+        for (int i{0}; i < 4; ++i) {
+            CHECK(queue.try_push([&executed]() { ++executed; }));
+        }
+        CHECK(!queue.try_push([&executed]() { ++executed; }));
+        CHECK(queue.try_run_one());
+        CHECK(queue.try_push([&executed]() { ++executed; }));
+        CHECK(queue.run() == 4);
+        CHECK(executed == 5);
+    }
+
+    SECTION("handler too large") {
+        struct LargeHandler {
+            std::byte padding[HandoffQueue::kHandlerSize + 1];
+            void operator()() {}
+        };
+        CHECK(!HandoffQueue::fits<LargeHandler>());
+        CHECK(!queue.try_push(LargeHandler{}));
+        CHECK(queue.empty());
+    }
+
+    SECTION("handler destroyed once executed or cleared") {
+        auto resource = std::make_shared<int>(0);
+        CHECK(queue.try_push([resource]() { ++*resource; }));
+        CHECK(queue.try_push([resource]() { ++*resource; }));
+        CHECK(resource.use_count() == 3);
+        CHECK(queue.try_run_one());
+        CHECK(resource.use_count() == 2);
+        queue.clear();
+        CHECK(resource.use_count() == 1);
+        CHECK(*resource == 1);
+    }
+
+    SECTION("handler throwing") {
+        CHECK(queue.try_push([]() { throw std::runtime_error{"error"}; }));
+        CHECK_THROWS_AS(queue.try_run_one(), std::runtime_error);
+        for (int i{0}; i < 4; ++i) {
+            CHECK(queue.try_push([]() {}));
+        }
+        CHECK(queue.run() == 4);
+    }
+}
+
+TEST_CASE("HandoffQueue many producers and consumers", "[silkrpc][concurrency][handoff_queue]") {
+    constexpr int kNumThreads{4};
+    constexpr int kNumHandlers{10'000};
+    HandoffQueue queue{64};
+    std::atomic<int> executed{0};
+    std::atomic<int> producers_done{0};
+
+    std::vector<std::thread> threads;
+    for (int t{0}; t < kNumThreads; ++t) {
+        threads.emplace_back([&]() {
+            for (int i{0}; i < kNumHandlers; ++i) {
+                while (!queue.try_push([&executed]() { ++executed; })) {
+                    std::this_thread::yield();
+                }
+            }
+            ++producers_done;
+        });
+        threads.emplace_back([&]() {
+            while (producers_done < kNumThreads || !queue.empty()) {
+                if (!queue.try_run_one()) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    queue.run();
+    CHECK(executed == kNumThreads * kNumHandlers);
+}
+
+} // namespace silkrpc
@@ -0,0 +1,85 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "handoff.hpp"
+
+#include <array>
+#include <atomic>
+#include <thread>
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+TEST_CASE("Handoff::post", "[silkrpc][concurrency][handoff]") {
+    boost::asio::io_context io_context;
+    auto& handoff = boost::asio::use_service<Handoff>(io_context);
+    CHECK(&boost::asio::use_service<Handoff>(io_context) == &handoff);
+    CHECK(&handoff.io_context() == &io_context);
+
+    SECTION("handlers drained together") {
+        int executed{0};
+        for (int i{0}; i < 10; ++i) {
+            handoff.post([&executed]() { ++executed; });
+        }
+        CHECK(executed == 0);
+        io_context.run();
+        CHECK(executed == 10);
+        CHECK(handoff.drain_count() == 1);
+    }
+
+    SECTION("handler too large posted to Asio") {
+        std::array<char, HandoffQueue::kHandlerSize> payload{};
+        int executed{0};
+        handoff.post([&executed, payload]() { executed += payload[0] + 1; });
+        io_context.run();
+        CHECK(executed == 1);
+        CHECK(handoff.drain_count() == 0);
+    }
+
+    SECTION("polled handoff") {
+        handoff.set_polled(true);
+        int executed{0};
+        handoff.post([&executed]() { ++executed; });
+        CHECK(io_context.poll() == 0);
+        CHECK(handoff.poll() == 1);
+        CHECK(executed == 1);
+    }
+
+    SECTION("handlers from other threads") {
+        auto work{boost::asio::make_work_guard(io_context)};
+        std::thread io_context_thread{[&]() { io_context.run(); }};
+        std::atomic<int> executed{0};
+        std::array<std::thread, 4> threads;
+        for (auto& thread : threads) {
+            thread = std::thread{[&]() {
+                for (int i{0}; i < 10'000; ++i) {
+                    handoff.post([&executed]() { ++executed; });
+                }
+            }};
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        work.reset();
+        io_context_thread.join();
+        CHECK(executed == 40'000);
+    }
+}
+
+} // namespace silkrpc
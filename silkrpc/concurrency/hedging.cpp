@@ -0,0 +1,58 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "hedging.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace silkrpc {
+
+void HedgingDelay::observe(std::chrono::microseconds latency) {
+    std::lock_guard lock{mutex_};
+    samples_[num_observed_ % kNumSamples] = latency.count();
+    ++num_observed_;
+    if (num_observed_ < kMinSamples || num_observed_ % kUpdateInterval != 0) {
+        return;
+    }
+    std::vector<int64_t> samples(samples_.begin(), samples_.begin() + static_cast<std::ptrdiff_t>(std::min(num_observed_, kNumSamples)));
+    const auto rank = static_cast<std::size_t>(std::ceil(quantile_ * static_cast<double>(samples.size()))) - 1;
+    const auto nth = samples.begin() + static_cast<std::ptrdiff_t>(std::min(rank, samples.size() - 1));
+    std::nth_element(samples.begin(), nth, samples.end());
+    delay_.store(std::max(*nth, kMinDelay.count()), std::memory_order_relaxed);
+}
+
+void HedgingBudget::deposit() {
+    auto balance = balance_.load(std::memory_order_relaxed);
+    while (balance < max_balance_ &&
+           !balance_.compare_exchange_weak(balance, std::min(balance + deposit_, max_balance_), std::memory_order_relaxed)) {
+    }
+}
+
+bool HedgingBudget::try_withdraw() {
+    auto balance = balance_.load(std::memory_order_relaxed);
+    do {
+        if (balance < kTokenUnit) {
+            return false;
+        }
+    } while (!balance_.compare_exchange_weak(balance, balance - kTokenUnit, std::memory_order_relaxed));
+    hedged_count_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+} // namespace silkrpc
@@ -0,0 +1,197 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_CONCURRENCY_HEDGING_HPP_
+#define SILKRPC_CONCURRENCY_HEDGING_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+namespace silkrpc {
+
+//! The recent latencies of one operation, giving the delay after which a duplicate call is worth issuing, i.e. the
+//! configured quantile of the latest samples. The delay is recomputed every few samples, so reading it is lock-free
+class HedgingDelay {
+public:
+    //! The number of latest samples the quantile is computed on
+    static constexpr std::size_t kNumSamples{256};
+
+    //! The number of samples needed before giving any delay, so that no call is hedged until the latency is known
+    static constexpr std::size_t kMinSamples{32};
+
+    //! The number of new samples after which the delay is recomputed
+    static constexpr std::size_t kUpdateInterval{16};
+
+    static constexpr double kDefaultQuantile{0.95};
+
+    //! The lowest delay, so that the fastest operations are never duplicated because of the timer resolution
+    static constexpr std::chrono::microseconds kMinDelay{200};
+
+    explicit HedgingDelay(double quantile = kDefaultQuantile) : quantile_{quantile} {}
+
+    void observe(std::chrono::microseconds latency);
+
+    //! The delay after which the call should be hedged, if enough samples have been observed
+    std::optional<std::chrono::microseconds> value() const {
+        const auto delay = delay_.load(std::memory_order_relaxed);
+        return delay < 0 ? std::nullopt : std::make_optional(std::chrono::microseconds{delay});
+    }
+
+private:
+    const double quantile_;
+    std::mutex mutex_;
+    std::array<int64_t, kNumSamples> samples_{};
+    std::size_t num_observed_{0};
+    std::atomic<int64_t> delay_{-1};
+};
+
+//! Token bucket bounding the hedged calls to some fraction of all the calls, so that a slow backend is not overloaded
+//! further by the duplicates: each call deposits the ratio of one token, each hedged call withdraws one
+class HedgingBudget {
+public:
+    //! The default fraction of calls that can be hedged
+    static constexpr double kDefaultRatio{0.05};
+
+    //! The default maximum number of tokens, i.e. the hedged calls allowed in a burst
+    static constexpr std::size_t kDefaultMaxTokens{10};
+
+    explicit HedgingBudget(double ratio = kDefaultRatio, std::size_t max_tokens = kDefaultMaxTokens)
+        : deposit_{static_cast<int64_t>(ratio * kTokenUnit)}, max_balance_{static_cast<int64_t>(max_tokens) * kTokenUnit} {}
+
+    void deposit();
+
+    //! Withdraw one token, returning false if not available
+    bool try_withdraw();
+
+    void record_win() { won_count_.fetch_add(1, std::memory_order_relaxed); }
+
+    //! The number of hedged calls
+    uint64_t hedged_count() const { return hedged_count_.load(std::memory_order_relaxed); }
+
+    //! The number of hedged calls answered first by the duplicate
+    uint64_t won_count() const { return won_count_.load(std::memory_order_relaxed); }
+
+private:
+    //! The fixed-point unit of one token
+    static constexpr int64_t kTokenUnit{1'000'000};
+
+    const int64_t deposit_;
+    const int64_t max_balance_;
+    std::atomic<int64_t> balance_{0};
+    std::atomic<uint64_t> hedged_count_{0};
+    std::atomic<uint64_t> won_count_{0};
+};
+
+//! Execute attempt(0) and, if not completed after the hedging delay and the budget allows, attempt(1) as well, returning
+//! the result of the first attempt succeeding. The result of the other one, if any, is given to discard instead, e.g. to
+//! close the duplicate resource. The latency of each attempt succeeding is observed by the delay. If both attempts fail,
+//! the first exception is rethrown. The attempts may still run after returning, so they must not refer to the caller
+//! frame. The executor of the calling coroutine must not run tasks in parallel (see parallel_for).
+template <typename Result, typename Attempt, typename Discard>
+boost::asio::awaitable<Result> hedged_call(HedgingDelay& delay, HedgingBudget& budget, Attempt attempt, Discard discard) {
+    using Clock = std::chrono::steady_clock;
+    budget.deposit();
+    const auto hedging_delay = delay.value();
+    if (!hedging_delay) {
+        const auto start_time = Clock::now();
+        auto result = co_await attempt(std::size_t{0});
+        delay.observe(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start_time));
+        co_return result;
+    }
+
+    struct State {
+        State(const boost::asio::any_io_executor& executor, Attempt attempt, Discard discard)
+            : completed{executor}, attempt{std::move(attempt)}, discard{std::move(discard)} {}
+
+        boost::asio::steady_timer completed;
+        Attempt attempt;
+        Discard discard;
+        std::optional<Result> result;
+        std::size_t winner{0};
+        std::size_t running{0};
+        bool returned{false};
+        std::exception_ptr first_exception;
+    };
+    const auto executor = co_await boost::asio::this_coro::executor;
+    auto state = std::make_shared<State>(executor, std::move(attempt), std::move(discard));
+    const auto spawn = [&](std::size_t index) {
+        ++state->running;
+        const auto start_time = Clock::now();
+        boost::asio::co_spawn(executor, state->attempt(index), [state, index, start_time, &delay](std::exception_ptr eptr, Result result) {
+            --state->running;
+            if (eptr) {
+                if (!state->first_exception) {
+                    state->first_exception = eptr;
+                }
+            } else {
+                delay.observe(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start_time));
+                if (!state->result && !state->returned) {
+                    state->result = std::move(result);
+                    state->winner = index;
+                } else {
+                    state->discard(std::move(result));
+                }
+            }
+            state->completed.cancel();
+        });
+    };
+
+    spawn(0);
+    state->completed.expires_after(*hedging_delay);
+    boost::system::error_code ec;
+    co_await state->completed.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+    if (!state->result && state->running > 0 && budget.try_withdraw()) {
+        spawn(1);
+    }
+    while (!state->result && state->running > 0) {
+        state->completed.expires_at(boost::asio::steady_timer::time_point::max());
+        co_await state->completed.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+    }
+
+    if (!state->result) {
+        std::rethrow_exception(state->first_exception);
+    }
+    if (state->winner > 0) {
+        budget.record_win();
+    }
+    auto result = std::move(*state->result);
+    state->result.reset();
+    state->returned = true;
+    co_return result;
+}
+
+} // namespace silkrpc
+
+#endif // SILKRPC_CONCURRENCY_HEDGING_HPP_
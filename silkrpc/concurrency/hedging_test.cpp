@@ -0,0 +1,196 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "hedging.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_future.hpp>
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+using Catch::Matchers::Message;
+using namespace std::chrono_literals; // NOLINT(build/namespaces)
+
+boost::asio::awaitable<int> delayed_value(int value, std::chrono::milliseconds latency) {
+    boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor, latency};
+    co_await timer.async_wait(boost::asio::use_awaitable);
+    co_return value;
+}
+
+boost::asio::awaitable<int> delayed_failure(std::chrono::milliseconds latency) {
+    boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor, latency};
+    co_await timer.async_wait(boost::asio::use_awaitable);
+    throw std::runtime_error{"attempt failed"};
+}
+
+template <typename Attempt>
+int run_hedged_call(HedgingDelay& delay, HedgingBudget& budget, Attempt attempt, std::vector<int>& discarded) {
+    boost::asio::io_context io_context;
+    auto result = boost::asio::co_spawn(io_context, hedged_call<int>(delay, budget, attempt, [&](int value) { discarded.push_back(value); }),
+        boost::asio::use_future);
+    io_context.run();
+    return result.get();
+}
+
+void prime(HedgingDelay& delay, std::chrono::microseconds latency) {
+    for (std::size_t i{0}; i < HedgingDelay::kMinSamples; ++i) {
+        delay.observe(latency);
+    }
+}
+
+void fill(HedgingBudget& budget, std::size_t num_calls) {
+    for (std::size_t i{0}; i < num_calls; ++i) {
+        budget.deposit();
+    }
+}
+
+TEST_CASE("HedgingDelay", "[silkrpc][concurrency][hedging]") {
+    HedgingDelay delay;
+
+    SECTION("no delay until enough samples") {
+        for (std::size_t i{0}; i < HedgingDelay::kMinSamples - 1; ++i) {
+            delay.observe(1ms);
+            CHECK(!delay.value());
+        }
+        delay.observe(1ms);
+        CHECK(delay.value() == 1ms);
+    }
+
+    SECTION("delay is the quantile of the samples") {
+        for (std::size_t i{1}; i <= 96; ++i) {
+            delay.observe(std::chrono::microseconds{i * 1'000});
+        }
+        CHECK(delay.value() == 92ms); // the 92nd of 96 samples in ascending order
+    }
+
+    SECTION("delay follows the latest samples") {
+        prime(delay, 1ms);
+        for (std::size_t i{0}; i < HedgingDelay::kNumSamples; ++i) {
+            delay.observe(10ms);
+        }
+        CHECK(delay.value() == 10ms);
+    }
+
+    SECTION("delay never below minimum") {
+        prime(delay, 1us);
+        CHECK(delay.value() == HedgingDelay::kMinDelay);
+    }
+}
+
+TEST_CASE("HedgingBudget", "[silkrpc][concurrency][hedging]") {
+    HedgingBudget budget{/*ratio=*/0.1, /*max_tokens=*/2};
+
+    SECTION("no token without calls") {
+        CHECK(!budget.try_withdraw());
+        CHECK(budget.hedged_count() == 0);
+    }
+
+    SECTION("one token every ratio inverse calls") {
+        fill(budget, 9);
+        CHECK(!budget.try_withdraw());
+        budget.deposit();
+        CHECK(budget.try_withdraw());
+        CHECK(!budget.try_withdraw());
+        CHECK(budget.hedged_count() == 1);
+    }
+
+    SECTION("tokens bounded by maximum") {
+        fill(budget, 100);
+        CHECK(budget.try_withdraw());
+        CHECK(budget.try_withdraw());
+        CHECK(!budget.try_withdraw());
+        CHECK(budget.hedged_count() == 2);
+    }
+}
+
+TEST_CASE("hedged_call", "[silkrpc][concurrency][hedging]") {
+    HedgingDelay delay;
+    HedgingBudget budget{/*ratio=*/1.0};
+    std::vector<int> discarded;
+    std::vector<std::size_t> attempts;
+
+    SECTION("no hedging until latency known") {
+        const auto value = run_hedged_call(delay, budget, [&](std::size_t index) {
+            attempts.push_back(index);
+            return delayed_value(1, 5ms);
+        }, discarded);
+        CHECK(value == 1);
+        CHECK(attempts == std::vector<std::size_t>{0});
+        CHECK(budget.hedged_count() == 0);
+    }
+
+    SECTION("fast attempt not hedged") {
+        prime(delay, 20ms);
+        const auto value = run_hedged_call(delay, budget, [&](std::size_t index) {
+            attempts.push_back(index);
+            return delayed_value(1, 1ms);
+        }, discarded);
+        CHECK(value == 1);
+        CHECK(attempts == std::vector<std::size_t>{0});
+        CHECK(discarded.empty());
+    }
+
+    SECTION("slow attempt hedged and duplicate wins") {
+        prime(delay, 1ms);
+        const auto value = run_hedged_call(delay, budget, [&](std::size_t index) {
+            attempts.push_back(index);
+            return index == 0 ? delayed_value(1, 50ms) : delayed_value(2, 1ms);
+        }, discarded);
+        CHECK(value == 2);
+        CHECK(attempts == std::vector<std::size_t>{0, 1});
+        CHECK(discarded == std::vector<int>{1});
+        CHECK(budget.hedged_count() == 1);
+        CHECK(budget.won_count() == 1);
+    }
+
+    SECTION("slow attempt not hedged without budget") {
+        prime(delay, 1ms);
+        HedgingBudget empty_budget{/*ratio=*/0.0};
+        const auto value = run_hedged_call(delay, empty_budget, [&](std::size_t index) {
+            attempts.push_back(index);
+            return delayed_value(1, 10ms);
+        }, discarded);
+        CHECK(value == 1);
+        CHECK(attempts == std::vector<std::size_t>{0});
+    }
+
+    SECTION("failed duplicate ignored") {
+        prime(delay, 1ms);
+        const auto value = run_hedged_call(delay, budget, [&](std::size_t index) {
+            attempts.push_back(index);
+            return index == 0 ? delayed_value(1, 10ms) : delayed_failure(1ms);
+        }, discarded);
+        CHECK(value == 1);
+        CHECK(budget.won_count() == 0);
+    }
+
+    SECTION("first exception rethrown if both attempts fail") {
+        prime(delay, 1ms);
+        CHECK_THROWS_MATCHES(run_hedged_call(delay, budget, [&](std::size_t) { return delayed_failure(10ms); }, discarded),
+            std::runtime_error, Message("attempt failed"));
+    }
+}
+
+} // namespace silkrpc
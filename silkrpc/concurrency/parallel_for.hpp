@@ -0,0 +1,88 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_CONCURRENCY_PARALLEL_FOR_HPP_
+#define SILKRPC_CONCURRENCY_PARALLEL_FOR_HPP_
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+namespace silkrpc {
+
+//! Execute task(i) for each i in [0, count) as concurrent coroutines, keeping at most max_concurrency of them in flight
+//! (zero means unbounded). The executor must be the one of the calling coroutine and must not run tasks in parallel
+//! (i.e. an io_context run by one thread or a strand): the concurrency achieved is the overlapping of asynchronous waits.
+//! All tasks are always completed before returning, the first exception thrown by any task (if any) is then rethrown.
+template <typename Executor, typename Task>
+boost::asio::awaitable<void> parallel_for(const Executor& executor, std::size_t count, std::size_t max_concurrency, Task task) {
+    if (count == 0) {
+        co_return;
+    }
+    if (max_concurrency == 0 || max_concurrency > count) {
+        max_concurrency = count;
+    }
+
+    struct State {
+        explicit State(const Executor& executor) : completed{executor} {}
+
+        std::size_t next_index{0};
+        std::size_t running{0};
+        std::exception_ptr first_exception;
+        boost::asio::steady_timer completed;
+    };
+    auto state = std::make_shared<State>(executor);
+
+    for (std::size_t i{0}; i < max_concurrency; ++i) {
+        ++state->running;
+        boost::asio::co_spawn(executor, [state, &task, count]() -> boost::asio::awaitable<void> {
+            // Each runner picks the next task until exhaustion or failure
+            while (state->next_index < count && !state->first_exception) {
+                const auto index = state->next_index++;
+                co_await task(index);
+            }
+        }, [state](std::exception_ptr eptr) {
+            if (eptr && !state->first_exception) {
+                state->first_exception = eptr;
+            }
+            if (--state->running == 0) {
+                state->completed.cancel();
+            }
+        });
+    }
+
+    while (state->running > 0) {
+        state->completed.expires_at(boost::asio::steady_timer::time_point::max());
+        boost::system::error_code ec;
+        co_await state->completed.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+    }
+
+    if (state->first_exception) {
+        std::rethrow_exception(state->first_exception);
+    }
+}
+
+} // namespace silkrpc
+
+#endif // SILKRPC_CONCURRENCY_PARALLEL_FOR_HPP_
@@ -0,0 +1,93 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "parallel_for.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_future.hpp>
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+using Catch::Matchers::Message;
+using namespace std::chrono_literals; // NOLINT(build/namespaces)
+
+template <typename Task>
+void run_parallel_for(std::size_t count, std::size_t max_concurrency, Task task) {
+    boost::asio::io_context io_context;
+    auto result = boost::asio::co_spawn(io_context, parallel_for(io_context.get_executor(), count, max_concurrency, task), boost::asio::use_future);
+    io_context.run();
+    result.get();
+}
+
+TEST_CASE("parallel_for", "[silkrpc][concurrency][parallel_for]") {
+    SECTION("no task") {
+        std::size_t executed{0};
+        CHECK_NOTHROW(run_parallel_for(0, 4, [&](std::size_t) -> boost::asio::awaitable<void> { ++executed; co_return; }));
+        CHECK(executed == 0);
+    }
+
+    SECTION("all tasks executed once") {
+        for (std::size_t max_concurrency : {0, 1, 3, 10, 20}) {
+            std::vector<int> executions(10, 0);
+            run_parallel_for(executions.size(), max_concurrency, [&](std::size_t i) -> boost::asio::awaitable<void> {
+                ++executions[i];
+                co_return;
+            });
+            CHECK(executions == std::vector<int>(10, 1));
+        }
+    }
+
+    SECTION("concurrency bounded by limit") {
+        for (std::size_t max_concurrency : {1, 2, 5}) {
+            std::size_t running{0}, max_running{0};
+            run_parallel_for(10, max_concurrency, [&](std::size_t) -> boost::asio::awaitable<void> {
+                ++running;
+                max_running = std::max(max_running, running);
+                boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor, 1ms};
+                co_await timer.async_wait(boost::asio::use_awaitable);
+                --running;
+            });
+            CHECK(running == 0);
+            CHECK(max_running == max_concurrency);
+        }
+    }
+
+    SECTION("exception rethrown after running tasks complete") {
+        std::size_t started{0}, completed{0};
+        CHECK_THROWS_MATCHES(run_parallel_for(6, 3, [&](std::size_t i) -> boost::asio::awaitable<void> {
+            if (i == 1) {
+                throw std::runtime_error{"task failed"};
+            }
+            ++started;
+            boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor, 1ms};
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            ++completed;
+        }), std::runtime_error, Message("task failed"));
+        CHECK(started < 5);
+        CHECK(completed == started);
+    }
+}
+
+} // namespace silkrpc
@@ -0,0 +1,114 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "rate_limiter.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace silkrpc {
+
+//! Mix the bits of the key (as in the splitmix64 finalizer), so that both the shard and the slot depend on all of them
+static uint64_t mix(uint64_t key) noexcept {
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111eb;
+    key ^= key >> 31;
+    return key;
+}
+
+RateLimiter::RateLimiter(uint32_t rate, uint32_t burst, std::size_t num_shards, std::size_t shard_capacity)
+    : rate_{rate},
+      burst_{burst > 0 ? burst : rate},
+      token_interval_{rate > 0 ? std::max<int64_t>(1'000'000'000 / rate, 1) : 0},
+      burst_interval_{token_interval_ * burst_},
+      num_shards_{std::max<std::size_t>(num_shards, 1)},
+      shard_mask_{std::bit_ceil(std::max<std::size_t>(shard_capacity, kMaxProbes)) - 1},
+      buckets_{std::make_unique<Bucket[]>(num_shards_ * (shard_mask_ + 1))} {
+    if (rate == 0) {
+        throw std::invalid_argument{"rate limit must be positive"};
+    }
+}
+
+uint64_t RateLimiter::client_key_of(std::string_view client_id) noexcept {
+    // FNV-1a, then the reserved zero key is moved away
+    uint64_t hash{0xcbf29ce484222325};
+    for (const auto c : client_id) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3;
+    }
+    return hash != 0 ? hash : 1;
+}
+
+bool RateLimiter::try_acquire(uint64_t client_key, uint32_t tokens, Clock::time_point now) noexcept {
+    const int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+    auto* bucket = find_bucket(client_key, now_ns);
+    if (bucket == nullptr) {
+        untracked_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // The requests weighing more than the burst would never fit, so they just need the bucket full
+    const int64_t increment = token_interval_ * std::min(tokens, burst_);
+    int64_t arrival_time = bucket->arrival_time.load(std::memory_order_relaxed);
+    while (true) {
+        const int64_t next_arrival_time = std::max(arrival_time, now_ns) + increment;
+        if (next_arrival_time - now_ns > burst_interval_) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (bucket->arrival_time.compare_exchange_weak(arrival_time, next_arrival_time, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+RateLimiter::Bucket* RateLimiter::find_bucket(uint64_t client_key, int64_t now) noexcept {
+    const auto hash = mix(client_key);
+    Bucket* shard = buckets_.get() + (hash % num_shards_) * (shard_mask_ + 1);
+    const auto start = static_cast<std::size_t>(hash >> 32);
+
+    Bucket* full_bucket{nullptr};
+    uint64_t full_bucket_key{0};
+    for (std::size_t i{0}; i < kMaxProbes; ++i) {
+        Bucket& bucket = shard[(start + i) & shard_mask_];
+        uint64_t key = bucket.client_key.load(std::memory_order_acquire);
+        if (key == client_key) {
+            return &bucket;
+        }
+        if (key == 0) {
+            if (bucket.client_key.compare_exchange_strong(key, client_key, std::memory_order_acq_rel) || key == client_key) {
+                return &bucket;
+            }
+        }
+        if (full_bucket == nullptr && bucket.arrival_time.load(std::memory_order_relaxed) <= now) {
+            full_bucket = &bucket;
+            full_bucket_key = key;
+        }
+    }
+
+    // The owner of a full bucket taken over at the same time may spend some tokens of the new client just once
+    if (full_bucket != nullptr &&
+        (full_bucket->client_key.compare_exchange_strong(full_bucket_key, client_key, std::memory_order_acq_rel) || full_bucket_key == client_key)) {
+        return full_bucket;
+    }
+    return nullptr;
+}
+
+} // namespace silkrpc
@@ -0,0 +1,105 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_CONCURRENCY_RATE_LIMITER_HPP_
+#define SILKRPC_CONCURRENCY_RATE_LIMITER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace silkrpc {
+
+//! Rate limiting of the requests by client (e.g. the remote address or the JWT subject), each one having its own token
+//! bucket refilled at the same rate up to the same burst: every request takes as many tokens as the weight of its method
+//! and it is rejected if not enough are left. Each bucket is one atomic holding its theoretical arrival time (i.e. the
+//! time when it would be full again, as in GCRA), updated by compare-and-swap, so that the buckets are checked from any
+//! thread without locking. The buckets live in a table split in shards probed linearly for a few slots: the slots of the
+//! buckets full again are reclaimed for new clients, since a full bucket is the same as a new one, while the clients
+//! finding no slot are let through untracked rather than blocking the others.
+class RateLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    //! The default number of table shards
+    static constexpr std::size_t kDefaultNumShards{16};
+
+    //! The default number of buckets in each shard
+    static constexpr std::size_t kDefaultShardCapacity{1024};
+
+    //! The max number of slots probed for the bucket of one client
+    static constexpr std::size_t kMaxProbes{8};
+
+    //! Build the limiter of rate tokens per second for each client up to burst tokens (the rate if zero)
+    explicit RateLimiter(uint32_t rate, uint32_t burst = 0, std::size_t num_shards = kDefaultNumShards,
+                         std::size_t shard_capacity = kDefaultShardCapacity);
+
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    //! Return the key identifying the client in the table, which is never zero
+    static uint64_t client_key_of(std::string_view client_id) noexcept;
+
+    //! Take the tokens (at most the burst) from the bucket of the client, returning false if not enough are left
+    bool try_acquire(uint64_t client_key, uint32_t tokens, Clock::time_point now = Clock::now()) noexcept;
+
+    uint32_t rate() const noexcept { return rate_; }
+    uint32_t burst() const noexcept { return burst_; }
+
+    //! The number of requests rejected so far
+    uint64_t rejected_count() const noexcept { return rejected_.load(std::memory_order_relaxed); }
+
+    //! The number of requests let through untracked so far, because all the slots probed were taken by other clients
+    uint64_t untracked_count() const noexcept { return untracked_.load(std::memory_order_relaxed); }
+
+private:
+    //! The bucket of one client, aligned so that no two buckets share a cache line
+    struct alignas(64) Bucket {
+        //! The key of the client owning the bucket, zero if free
+        std::atomic<uint64_t> client_key{0};
+
+        //! The theoretical arrival time in nanoseconds since the clock epoch: the bucket is full if not after now
+        std::atomic<int64_t> arrival_time{0};
+    };
+
+    //! Return the bucket of the client, taking a free or full one if not found, or nullptr if none is left
+    Bucket* find_bucket(uint64_t client_key, int64_t now) noexcept;
+
+    const uint32_t rate_;
+    const uint32_t burst_;
+
+    //! The nanoseconds needed to refill one token
+    const int64_t token_interval_;
+
+    //! The nanoseconds needed to refill the whole bucket, i.e. the max a bucket can run ahead of now
+    const int64_t burst_interval_;
+
+    const std::size_t num_shards_;
+    const std::size_t shard_mask_;
+    std::unique_ptr<Bucket[]> buckets_;
+
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> untracked_{0};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_CONCURRENCY_RATE_LIMITER_HPP_
@@ -0,0 +1,134 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "rate_limiter.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+using namespace std::chrono_literals; // NOLINT(build/namespaces)
+
+TEST_CASE("RateLimiter::client_key_of", "[silkrpc][concurrency][rate_limiter]") {
+    CHECK(RateLimiter::client_key_of("10.0.0.1") != 0);
+    CHECK(RateLimiter::client_key_of("") != 0);
+    CHECK(RateLimiter::client_key_of("10.0.0.1") == RateLimiter::client_key_of("10.0.0.1"));
+    CHECK(RateLimiter::client_key_of("10.0.0.1") != RateLimiter::client_key_of("10.0.0.2"));
+}
+
+TEST_CASE("RateLimiter", "[silkrpc][concurrency][rate_limiter]") {
+    const auto now = RateLimiter::Clock::now();
+    const auto client = RateLimiter::client_key_of("client");
+    const auto other_client = RateLimiter::client_key_of("other_client");
+
+    SECTION("invalid rate") {
+        CHECK_THROWS_AS(RateLimiter{0}, std::invalid_argument);
+    }
+
+    SECTION("burst defaults to rate") {
+        RateLimiter limiter{100};
+        CHECK(limiter.rate() == 100);
+        CHECK(limiter.burst() == 100);
+    }
+
+    SECTION("burst then refill") {
+        RateLimiter limiter{10, 5};
+        for (int i{0}; i < 5; ++i) {
+            CHECK(limiter.try_acquire(client, 1, now));
+        }
+        CHECK(!limiter.try_acquire(client, 1, now));
+        CHECK(limiter.rejected_count() == 1);
+
+        // One token every 100ms
+        CHECK(!limiter.try_acquire(client, 1, now + 50ms));
+        CHECK(limiter.try_acquire(client, 1, now + 100ms));
+        CHECK(!limiter.try_acquire(client, 1, now + 100ms));
+        CHECK(limiter.try_acquire(client, 3, now + 400ms));
+        CHECK(limiter.rejected_count() == 3);
+    }
+
+    SECTION("weighted requests") {
+        RateLimiter limiter{100};
+        CHECK(limiter.try_acquire(client, 60, now));
+        CHECK(!limiter.try_acquire(client, 60, now));
+        CHECK(limiter.try_acquire(client, 40, now));
+        CHECK(!limiter.try_acquire(client, 1, now));
+    }
+
+    SECTION("requests weighing more than the burst need the bucket full") {
+        RateLimiter limiter{10, 5};
+        CHECK(limiter.try_acquire(client, 100, now));
+        CHECK(!limiter.try_acquire(client, 1, now));
+        CHECK(limiter.try_acquire(client, 100, now + 500ms));
+    }
+
+    SECTION("clients have separate buckets") {
+        RateLimiter limiter{1, 1};
+        CHECK(limiter.try_acquire(client, 1, now));
+        CHECK(!limiter.try_acquire(client, 1, now));
+        CHECK(limiter.try_acquire(other_client, 1, now));
+        CHECK(!limiter.try_acquire(other_client, 1, now));
+    }
+
+    SECTION("full table lets new clients through untracked") {
+        RateLimiter limiter{1, 1, /*num_shards=*/1, /*shard_capacity=*/RateLimiter::kMaxProbes};
+        for (uint64_t key{1}; key <= RateLimiter::kMaxProbes; ++key) {
+            CHECK(limiter.try_acquire(key, 1, now));
+        }
+        CHECK(limiter.untracked_count() == 0);
+        const auto new_client = RateLimiter::kMaxProbes + 1;
+        CHECK(limiter.try_acquire(new_client, 1, now));
+        CHECK(limiter.try_acquire(new_client, 1, now));
+        CHECK(limiter.untracked_count() == 2);
+
+        // The buckets full again are taken over by the new clients
+        CHECK(limiter.try_acquire(new_client, 1, now + 1s));
+        CHECK(!limiter.try_acquire(new_client, 1, now + 1s));
+        CHECK(limiter.untracked_count() == 2);
+    }
+
+    SECTION("concurrent clients") {
+        RateLimiter limiter{1, 1000};
+        constexpr int kNumThreads{4};
+        constexpr int kNumRequests{1000};
+        std::vector<uint64_t> admitted(kNumThreads, 0);
+        std::vector<std::thread> threads;
+        for (int t{0}; t < kNumThreads; ++t) {
+            threads.emplace_back([&, t]() {
+                for (int i{0}; i < kNumRequests; ++i) {
+                    admitted[t] += limiter.try_acquire(client, 1, now) ? 1 : 0;
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        uint64_t total_admitted{0};
+        for (const auto count : admitted) {
+            total_admitted += count;
+        }
+        CHECK(total_admitted == 1000);
+        CHECK(limiter.rejected_count() == kNumThreads * kNumRequests - 1000);
+    }
+}
+
+} // namespace silkrpc
@@ -0,0 +1,99 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "request_executor.hpp"
+
+#include <chrono>
+#include <typeinfo>
+
+#include <silkrpc/common/allocator.hpp>
+#include <silkrpc/common/clock_time.hpp>
+
+namespace silkrpc {
+
+//! The outermost request work scope on the calling thread, if any
+static thread_local RequestWorkScope* current_scope{nullptr};
+
+RequestWorkScope::RequestWorkScope(RequestProfile* profile) noexcept {
+    if (profile == nullptr || current_scope != nullptr) {
+        return;
+    }
+    profile_ = profile;
+    current_scope = this;
+    if (profile->method() != nullptr && SamplingProfiler::active()) {
+        tag_.emplace(profile->method());
+    }
+    if (profile->costs_accounted()) {
+        cpu_start_ = clock_time::thread_cpu_now();
+        allocated_start_ = thread_allocated_bytes();
+    }
+}
+
+RequestWorkScope::~RequestWorkScope() {
+    end();
+}
+
+void RequestWorkScope::end() noexcept {
+    if (profile_ == nullptr) {
+        return;
+    }
+    if (profile_->costs_accounted()) {
+        const auto cpu_time = std::chrono::nanoseconds{clock_time::thread_cpu_now() - cpu_start_};
+        profile_->add_cost(cpu_time, thread_allocated_bytes() - allocated_start_);
+    }
+    tag_.reset();
+    profile_ = nullptr;
+    current_scope = nullptr;
+}
+
+void RequestWorkScope::end_current(const RequestProfile& profile) noexcept {
+    if (current_scope != nullptr && current_scope->profile_ == &profile) {
+        current_scope->end();
+    }
+}
+
+//! Return the request executor wrapped by the executor, if any: the target type must be checked explicitly, because
+//! some Asio versions do not check it in target
+static const RequestExecutor* request_executor_of(const boost::asio::any_io_executor& executor) noexcept {
+    if (executor.target_type() != typeid(RequestExecutor)) {
+        return nullptr;
+    }
+    return executor.target<RequestExecutor>();
+}
+
+const CancellationToken& cancellation_token_of(const boost::asio::any_io_executor& executor) noexcept {
+    static const CancellationToken kNeverCancelled;
+    const auto* request_executor = request_executor_of(executor);
+    return request_executor ? request_executor->token() : kNeverCancelled;
+}
+
+RequestProfile* request_profile_of(const boost::asio::any_io_executor& executor) noexcept {
+    const auto* request_executor = request_executor_of(executor);
+    return request_executor ? request_executor->profile() : nullptr;
+}
+
+TraceContext trace_context_of(const boost::asio::any_io_executor& executor) noexcept {
+    const auto* request_executor = request_executor_of(executor);
+    return request_executor ? request_executor->trace() : TraceContext{};
+}
+
+ethdb::BatchTransaction* batch_transaction_of(const boost::asio::any_io_executor& executor) noexcept {
+    const auto* request_executor = request_executor_of(executor);
+    return request_executor ? request_executor->batch_transaction() : nullptr;
+}
+
+} // namespace silkrpc
@@ -0,0 +1,157 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_CONCURRENCY_REQUEST_EXECUTOR_HPP_
+#define SILKRPC_CONCURRENCY_REQUEST_EXECUTOR_HPP_
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/execution.hpp>
+
+#include <silkrpc/common/latency_histogram.hpp>
+#include <silkrpc/common/sampling_profiler.hpp>
+#include <silkrpc/common/tracing.hpp>
+#include <silkrpc/concurrency/cancellation.hpp>
+
+namespace silkrpc {
+
+namespace ethdb {
+class BatchTransaction;
+} // namespace ethdb
+
+//! Scope of some work of a request running on the calling thread: the samples taken in scope are tagged with the method
+//! of the request and, if its costs are accounted, the thread CPU time and the bytes allocated in scope are added to them.
+//! A scope nested in another one on the same thread (e.g. some handler dispatched inline) is part of the outer one. The
+//! scope must end before the request completes, since the profile goes away with it: the last resumption of a request
+//! can complete it inline, hence the request owner ends it explicitly (see end_current).
+class RequestWorkScope {
+public:
+    //! Enter the scope of the work of the request, if any
+    explicit RequestWorkScope(RequestProfile* profile) noexcept;
+    ~RequestWorkScope();
+
+    RequestWorkScope(const RequestWorkScope&) = delete;
+    RequestWorkScope& operator=(const RequestWorkScope&) = delete;
+
+    //! End the scope before going out of it, accounting the costs so far
+    void end() noexcept;
+
+    //! End the scope of the work of the request running on the calling thread, if any
+    static void end_current(const RequestProfile& profile) noexcept;
+
+    //! Return true if the work of the request must run in its scope, i.e. either costs or samples are taken
+    static bool needed(const RequestProfile* profile) noexcept {
+        return profile != nullptr && (profile->costs_accounted() || (profile->method() != nullptr && SamplingProfiler::active()));
+    }
+
+private:
+    RequestProfile* profile_{nullptr};
+    std::optional<SamplingProfiler::Tag> tag_;
+    uint64_t cpu_start_{0};
+    uint64_t allocated_start_{0};
+};
+
+//! Executor carrying the cancellation token, the profile, the trace context and the batch transaction of a request, so
+//! that the coroutines spawned on it can find them through their own executor (see cancellation_token_of,
+//! request_profile_of, trace_context_of and batch_transaction_of) without passing them down explicitly. All the work is
+//! executed by the wrapped executor.
+class RequestExecutor {
+public:
+    RequestExecutor(boost::asio::any_io_executor executor, CancellationToken token, RequestProfile* profile = nullptr,
+        TraceContext trace = {}, ethdb::BatchTransaction* batch_transaction = nullptr)
+        : executor_{std::move(executor)}, token_{std::move(token)}, profile_{profile}, trace_{trace},
+          batch_transaction_{batch_transaction} {}
+
+    const CancellationToken& token() const noexcept { return token_; }
+
+    RequestProfile* profile() const noexcept { return profile_; }
+
+    const TraceContext& trace() const noexcept { return trace_; }
+
+    ethdb::BatchTransaction* batch_transaction() const noexcept { return batch_transaction_; }
+
+    template <typename Property>
+    auto query(const Property& property) const noexcept
+        -> decltype(boost::asio::query(std::declval<const boost::asio::any_io_executor&>(), property)) {
+        return boost::asio::query(executor_, property);
+    }
+
+    template <typename Property>
+    auto require(const Property& property) const
+        -> decltype(boost::asio::require(std::declval<const boost::asio::any_io_executor&>(), property), RequestExecutor(std::declval<RequestExecutor>())) {
+        return RequestExecutor{boost::asio::require(executor_, property), token_, profile_, trace_, batch_transaction_};
+    }
+
+    template <typename Property>
+    auto prefer(const Property& property) const
+        -> decltype(boost::asio::prefer(std::declval<const boost::asio::any_io_executor&>(), property), RequestExecutor(std::declval<RequestExecutor>())) {
+        return RequestExecutor{boost::asio::prefer(executor_, property), token_, profile_, trace_, batch_transaction_};
+    }
+
+    template <typename Function>
+    void execute(Function&& f) const {
+        if (RequestWorkScope::needed(profile_)) {
+            // Each resumption of the request coroutines runs in scope, so that it is tagged and accounted
+            boost::asio::execution::execute(executor_, [profile = profile_, f = std::forward<Function>(f)]() mutable {
+                const RequestWorkScope scope{profile};
+                f();
+            });
+            return;
+        }
+        boost::asio::execution::execute(executor_, std::forward<Function>(f));
+    }
+
+    friend bool operator==(const RequestExecutor& lhs, const RequestExecutor& rhs) noexcept {
+        return lhs.executor_ == rhs.executor_ && lhs.token_ == rhs.token_ && lhs.profile_ == rhs.profile_ && lhs.trace_ == rhs.trace_ &&
+            lhs.batch_transaction_ == rhs.batch_transaction_;
+    }
+    friend bool operator!=(const RequestExecutor& lhs, const RequestExecutor& rhs) noexcept { return !(lhs == rhs); }
+
+private:
+    boost::asio::any_io_executor executor_;
+    CancellationToken token_;
+    RequestProfile* profile_;
+    TraceContext trace_;
+    ethdb::BatchTransaction* batch_transaction_;
+};
+
+//! Return the cancellation token carried by the executor, if it is a RequestExecutor, otherwise a token never cancelled
+const CancellationToken& cancellation_token_of(const boost::asio::any_io_executor& executor) noexcept;
+
+//! Throw RequestCancelled if the token carried by the executor has been cancelled, typically called with the executor
+//! of the current coroutine as in throw_if_cancelled(co_await boost::asio::this_coro::executor)
+inline void throw_if_cancelled(const boost::asio::any_io_executor& executor) {
+    cancellation_token_of(executor).throw_if_cancelled();
+}
+
+//! Return the profile carried by the executor, if it is a RequestExecutor having one, otherwise nullptr
+RequestProfile* request_profile_of(const boost::asio::any_io_executor& executor) noexcept;
+
+//! Return the trace context carried by the executor, if it is a RequestExecutor having one, otherwise an empty context
+TraceContext trace_context_of(const boost::asio::any_io_executor& executor) noexcept;
+
+//! Return the transaction shared by the batch of the request carried by the executor, if any, otherwise nullptr
+ethdb::BatchTransaction* batch_transaction_of(const boost::asio::any_io_executor& executor) noexcept;
+
+} // namespace silkrpc
+
+#endif // SILKRPC_CONCURRENCY_REQUEST_EXECUTOR_HPP_
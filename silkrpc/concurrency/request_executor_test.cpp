@@ -0,0 +1,190 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "request_executor.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/use_future.hpp>
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+using namespace std::chrono_literals; // NOLINT(build/namespaces)
+
+//! Return true if the token reached through the executor after some waiting is the expected one
+static boost::asio::awaitable<bool> has_token(CancellationToken expected) {
+    auto executor = co_await boost::asio::this_coro::executor;
+    boost::asio::steady_timer timer{executor, 1ms};
+    co_await timer.async_wait(boost::asio::use_awaitable);
+    co_return cancellation_token_of(co_await boost::asio::this_coro::executor) == expected;
+}
+
+TEST_CASE("RequestExecutor", "[silkrpc][concurrency][request_executor]") {
+    boost::asio::io_context io_context;
+    CancellationToken token{std::nullopt};
+
+    SECTION("token reachable through the executor of the coroutine") {
+        RequestExecutor executor{io_context.get_executor(), token};
+        auto result = boost::asio::co_spawn(executor, has_token(token), boost::asio::use_future);
+        io_context.run();
+        CHECK(result.get());
+    }
+
+    SECTION("no token through other executors") {
+        auto result = boost::asio::co_spawn(io_context, has_token(CancellationToken{}), boost::asio::use_future);
+        io_context.run();
+        CHECK(result.get());
+    }
+
+    SECTION("profile reachable through the executor of the coroutine") {
+        RequestProfile profile;
+        RequestExecutor executor{io_context.get_executor(), token, &profile};
+        auto result = boost::asio::co_spawn(executor, []() -> boost::asio::awaitable<RequestProfile*> {
+            co_return request_profile_of(co_await boost::asio::this_coro::executor);
+        }, boost::asio::use_future);
+        io_context.run();
+        CHECK(result.get() == &profile);
+    }
+
+    SECTION("no profile through other executors") {
+        auto result = boost::asio::co_spawn(io_context, []() -> boost::asio::awaitable<RequestProfile*> {
+            co_return request_profile_of(co_await boost::asio::this_coro::executor);
+        }, boost::asio::use_future);
+        io_context.run();
+        CHECK(result.get() == nullptr);
+    }
+
+    SECTION("trace context reachable through the executor of the coroutine") {
+        Tracer tracer{std::filesystem::temp_directory_path() / "silkrpc_request_executor_trace.json", 1};
+        const auto trace = tracer.start_trace();
+        RequestExecutor executor{io_context.get_executor(), token, nullptr, trace};
+        auto result = boost::asio::co_spawn(executor, []() -> boost::asio::awaitable<TraceContext> {
+            co_return trace_context_of(co_await boost::asio::this_coro::executor);
+        }, boost::asio::use_future);
+        io_context.run();
+        CHECK(result.get() == trace);
+    }
+
+    SECTION("no trace context through other executors") {
+        auto result = boost::asio::co_spawn(io_context, []() -> boost::asio::awaitable<TraceContext> {
+            co_return trace_context_of(co_await boost::asio::this_coro::executor);
+        }, boost::asio::use_future);
+        io_context.run();
+        CHECK(!result.get());
+    }
+
+    SECTION("throw_if_cancelled through the executor") {
+        token.cancel();
+        RequestExecutor executor{io_context.get_executor(), token};
+        auto result = boost::asio::co_spawn(executor, []() -> boost::asio::awaitable<void> {
+            throw_if_cancelled(co_await boost::asio::this_coro::executor);
+        }, boost::asio::use_future);
+        io_context.run();
+        CHECK_THROWS_AS(result.get(), RequestCancelled);
+    }
+
+    SECTION("costs accounted on each resumption") {
+        RequestProfile profile;
+        profile.set_costs_accounted(true);
+        RequestExecutor executor{io_context.get_executor(), token, &profile};
+        auto result = boost::asio::co_spawn(executor, []() -> boost::asio::awaitable<void> {
+            boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor, 1ms};
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            volatile uint64_t sum{0};
+            for (uint64_t i{0}; i < 1'000'000; ++i) {
+                sum = sum + i;
+            }
+            const auto block = std::make_unique<char[]>(64 * 1024);
+        }, boost::asio::use_future);
+        io_context.run();
+        result.get();
+        CHECK(profile.cpu_time() > 0ns);
+        CHECK(profile.allocated_bytes() >= 64 * 1024);
+    }
+
+    SECTION("no costs accounted if not enabled") {
+        RequestProfile profile;
+        RequestExecutor executor{io_context.get_executor(), token, &profile};
+        auto result = boost::asio::co_spawn(executor, []() -> boost::asio::awaitable<void> {
+            const auto block = std::make_unique<char[]>(64 * 1024);
+            co_return;
+        }, boost::asio::use_future);
+        io_context.run();
+        result.get();
+        CHECK(profile.cpu_time() == 0ns);
+        CHECK(profile.allocated_bytes() == 0);
+    }
+}
+
+TEST_CASE("RequestWorkScope", "[silkrpc][concurrency][request_executor]") {
+    RequestProfile profile;
+    profile.set_costs_accounted(true);
+
+    SECTION("costs of the scope") {
+        {
+            const RequestWorkScope scope{&profile};
+            const auto block = std::make_unique<char[]>(1024);
+        }
+        CHECK(profile.allocated_bytes() >= 1024);
+    }
+
+    SECTION("nested scope part of the outer one") {
+        RequestProfile other;
+        other.set_costs_accounted(true);
+        {
+            const RequestWorkScope scope{&profile};
+            const RequestWorkScope nested{&other};
+            const auto block = std::make_unique<char[]>(1024);
+        }
+        CHECK(profile.allocated_bytes() >= 1024);
+        CHECK(other.allocated_bytes() == 0);
+    }
+
+    SECTION("ended by the request owner") {
+        RequestWorkScope scope{&profile};
+        RequestWorkScope::end_current(profile);
+        const auto allocated = profile.allocated_bytes();
+        const auto block = std::make_unique<char[]>(1024);
+        scope.end();
+        CHECK(profile.allocated_bytes() == allocated);
+
+        // A new scope can start once the previous one has ended
+        RequestProfile next;
+        next.set_costs_accounted(true);
+        {
+            const RequestWorkScope next_scope{&next};
+            const auto next_block = std::make_unique<char[]>(1024);
+        }
+        CHECK(next.allocated_bytes() >= 1024);
+    }
+
+    SECTION("no scope without profile") {
+        const RequestWorkScope scope{nullptr};
+        RequestWorkScope::end_current(profile);
+        CHECK(profile.allocated_bytes() == 0);
+    }
+}
+
+} // namespace silkrpc
@@ -0,0 +1,118 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "single_flight.hpp"
+
+#include <type_traits>
+#include <utility>
+
+#include <boost/asio/compose.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+namespace silkrpc {
+
+boost::asio::awaitable<SingleFlight::Result> SingleFlight::execute(std::string key, Computation computation) {
+    std::shared_ptr<Flight> flight;
+    bool leader{false};
+    {
+        std::lock_guard lock{mutex_};
+        auto& entry = flights_[key];
+        if (entry && entry->epoch == epoch_) {
+            ++joined_count_;
+        } else {
+            // Any flight of a previous epoch goes on, but it is not reachable anymore by the new callers
+            entry = std::make_shared<Flight>();
+            entry->epoch = epoch_;
+            leader = true;
+        }
+        flight = entry;
+    }
+    if (!leader) {
+        co_return co_await wait(std::move(flight));
+    }
+
+    Result result;
+    std::exception_ptr exception;
+    try {
+        result = std::make_shared<const std::string>(co_await computation());
+    } catch (...) {
+        exception = std::current_exception();
+    }
+
+    std::vector<std::function<void()>> waiters;
+    {
+        std::lock_guard lock{mutex_};
+        const auto it = flights_.find(key);
+        if (it != flights_.end() && it->second == flight) {
+            flights_.erase(it);
+        }
+        flight->done = true;
+        flight->result = result;
+        flight->exception = exception;
+        waiters.swap(flight->waiters);
+    }
+    for (const auto& waiter : waiters) {
+        waiter();
+    }
+
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+    co_return result;
+}
+
+boost::asio::awaitable<SingleFlight::Result> SingleFlight::wait(std::shared_ptr<Flight> flight) {
+    // The waiter is resumed on its own executor, whatever the thread completing the flight
+    const auto executor = co_await boost::asio::this_coro::executor;
+    co_await boost::asio::async_compose<decltype(boost::asio::use_awaitable), void()>(
+        [&](auto&& self) {
+            auto shared_self = std::make_shared<std::decay_t<decltype(self)>>(std::move(self));
+            auto resume = [executor, shared_self]() {
+                boost::asio::post(executor, [shared_self]() { shared_self->complete(); });
+            };
+            std::lock_guard lock{mutex_};
+            if (flight->done) {
+                resume();
+            } else {
+                flight->waiters.emplace_back(std::move(resume));
+            }
+        },
+        boost::asio::use_awaitable);
+
+    if (flight->exception) {
+        std::rethrow_exception(flight->exception);
+    }
+    co_return flight->result;
+}
+
+void SingleFlight::advance_epoch() {
+    std::lock_guard lock{mutex_};
+    ++epoch_;
+}
+
+std::size_t SingleFlight::size() const {
+    std::lock_guard lock{mutex_};
+    return flights_.size();
+}
+
+uint64_t SingleFlight::joined_count() const {
+    std::lock_guard lock{mutex_};
+    return joined_count_;
+}
+
+} // namespace silkrpc
@@ -0,0 +1,82 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_CONCURRENCY_SINGLE_FLIGHT_HPP_
+#define SILKRPC_CONCURRENCY_SINGLE_FLIGHT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+
+namespace silkrpc {
+
+//! Coalescing of identical in-flight computations: the first caller for a key (the leader) executes the computation,
+//! while the callers for the same key arriving before it completes just await and share its result (or exception).
+//! The flights belong to the current epoch, advanced at each new chain head: the callers arriving after a new head never
+//! join a flight started before, so that the shared result is the one they would have got by computing it themselves.
+//! The callers can run on any executor, each one is resumed on its own.
+class SingleFlight {
+public:
+    using Result = std::shared_ptr<const std::string>;
+    using Computation = std::function<boost::asio::awaitable<std::string>()>;
+
+    SingleFlight() = default;
+
+    SingleFlight(const SingleFlight&) = delete;
+    SingleFlight& operator=(const SingleFlight&) = delete;
+
+    //! Execute the computation for the key, unless an identical one is already in flight in the current epoch
+    boost::asio::awaitable<Result> execute(std::string key, Computation computation);
+
+    //! Advance the epoch, so that the flights in progress are not joined anymore
+    void advance_epoch();
+
+    //! The number of flights in progress
+    std::size_t size() const;
+
+    //! The number of callers which have joined an existing flight
+    uint64_t joined_count() const;
+
+private:
+    struct Flight {
+        uint64_t epoch{0};
+        bool done{false};
+        Result result;
+        std::exception_ptr exception;
+        std::vector<std::function<void()>> waiters;
+    };
+
+    boost::asio::awaitable<Result> wait(std::shared_ptr<Flight> flight);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Flight>> flights_;
+    uint64_t epoch_{0};
+    uint64_t joined_count_{0};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_CONCURRENCY_SINGLE_FLIGHT_HPP_
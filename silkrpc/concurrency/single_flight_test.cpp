@@ -0,0 +1,143 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "single_flight.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/use_future.hpp>
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+using Catch::Matchers::Message;
+using namespace std::chrono_literals; // NOLINT(build/namespaces)
+
+//! Computation returning the value after a short delay, counting its executions
+static SingleFlight::Computation delayed(const std::string& value, std::size_t& executions) {
+    return [&executions, value]() -> boost::asio::awaitable<std::string> {
+        ++executions;
+        boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor, 10ms};
+        co_await timer.async_wait(boost::asio::use_awaitable);
+        co_return value;
+    };
+}
+
+TEST_CASE("single flight", "[silkrpc][concurrency][single_flight]") {
+    boost::asio::io_context io_context;
+    SingleFlight single_flight;
+    std::size_t executions{0};
+
+    SECTION("identical concurrent calls share one execution") {
+        std::vector<std::future<SingleFlight::Result>> results;
+        for (int i{0}; i < 5; ++i) {
+            results.push_back(boost::asio::co_spawn(io_context, single_flight.execute("key", delayed("value", executions)), boost::asio::use_future));
+        }
+        io_context.run();
+        for (auto& result : results) {
+            CHECK(*result.get() == "value");
+        }
+        CHECK(executions == 1);
+        CHECK(single_flight.joined_count() == 4);
+        CHECK(single_flight.size() == 0);
+    }
+
+    SECTION("different keys executed separately") {
+        auto result1 = boost::asio::co_spawn(io_context, single_flight.execute("key1", delayed("value1", executions)), boost::asio::use_future);
+        auto result2 = boost::asio::co_spawn(io_context, single_flight.execute("key2", delayed("value2", executions)), boost::asio::use_future);
+        io_context.run();
+        CHECK(*result1.get() == "value1");
+        CHECK(*result2.get() == "value2");
+        CHECK(executions == 2);
+    }
+
+    SECTION("sequential calls executed separately") {
+        auto result1 = boost::asio::co_spawn(io_context, single_flight.execute("key", delayed("value1", executions)), boost::asio::use_future);
+        io_context.run();
+        io_context.restart();
+        auto result2 = boost::asio::co_spawn(io_context, single_flight.execute("key", delayed("value2", executions)), boost::asio::use_future);
+        io_context.run();
+        CHECK(*result1.get() == "value1");
+        CHECK(*result2.get() == "value2");
+        CHECK(executions == 2);
+    }
+
+    SECTION("calls after new epoch do not join the flight in progress") {
+        auto result1 = boost::asio::co_spawn(io_context, single_flight.execute("key", delayed("value1", executions)), boost::asio::use_future);
+        io_context.poll();
+        single_flight.advance_epoch();
+        auto result2 = boost::asio::co_spawn(io_context, single_flight.execute("key", delayed("value2", executions)), boost::asio::use_future);
+        auto result3 = boost::asio::co_spawn(io_context, single_flight.execute("key", delayed("value3", executions)), boost::asio::use_future);
+        io_context.run();
+        CHECK(*result1.get() == "value1");
+        CHECK(*result2.get() == "value2");
+        CHECK(*result3.get() == "value2");
+        CHECK(executions == 2);
+        CHECK(single_flight.size() == 0);
+    }
+
+    SECTION("exception shared by all the calls") {
+        SingleFlight::Computation failing = [&]() -> boost::asio::awaitable<std::string> {
+            ++executions;
+            boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor, 10ms};
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            throw std::runtime_error{"error"};
+        };
+        auto result1 = boost::asio::co_spawn(io_context, single_flight.execute("key", failing), boost::asio::use_future);
+        auto result2 = boost::asio::co_spawn(io_context, single_flight.execute("key", failing), boost::asio::use_future);
+        io_context.run();
+        CHECK_THROWS_MATCHES(result1.get(), std::runtime_error, Message("error"));
+        CHECK_THROWS_MATCHES(result2.get(), std::runtime_error, Message("error"));
+        CHECK(executions == 1);
+    }
+
+    SECTION("waiter resumed on its own executor") {
+        boost::asio::io_context other_io_context;
+        auto work = boost::asio::make_work_guard(other_io_context);
+        std::thread other_thread{[&]() { other_io_context.run(); }};
+
+        auto result1 = boost::asio::co_spawn(io_context, single_flight.execute("key", delayed("value", executions)), boost::asio::use_future);
+        io_context.poll();
+        std::thread::id waiter_thread_id;
+        auto result2 = boost::asio::co_spawn(other_io_context, [&]() -> boost::asio::awaitable<SingleFlight::Result> {
+            auto result = co_await single_flight.execute("key", delayed("other", executions));
+            waiter_thread_id = std::this_thread::get_id();
+            co_return result;
+        }, boost::asio::use_future);
+        while (single_flight.joined_count() == 0) {
+            std::this_thread::yield();
+        }
+        io_context.run();
+        CHECK(*result2.get() == "value");
+        CHECK(*result1.get() == "value");
+        CHECK(waiter_thread_id == other_thread.get_id());
+        CHECK(executions == 1);
+
+        work.reset();
+        other_thread.join();
+    }
+}
+
+} // namespace silkrpc
@@ -0,0 +1,80 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_CONCURRENCY_SPSC_RING_HPP_
+#define SILKRPC_CONCURRENCY_SPSC_RING_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace silkrpc {
+
+//! Bounded lock-free ring of elements having exactly one producer thread and one consumer thread: the producer never
+//! blocks, because pushing into a full ring just fails. The slots are allocated once and reused, so the elements keep
+//! their buffers (e.g. string capacity) across uses when moved out and assigned again.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity) : capacity_{capacity}, slots_{std::make_unique<T[]>(capacity)} {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    std::size_t capacity() const noexcept { return capacity_; }
+
+    //! Push the element at the back, returning false if the ring is full (producer only)
+    bool push(T&& element) {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == capacity_) {
+            return false;
+        }
+        slots_[tail % capacity_] = std::move(element);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    //! Return the number of elements that can be pushed without failing (exact for the producer only)
+    std::size_t available() const noexcept {
+        return capacity_ - (tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_acquire));
+    }
+
+    //! Move all the elements pushed so far into the output in push order, returning their count (consumer only)
+    template <typename Output>
+    std::size_t drain(Output& output) {
+        const auto head = head_.load(std::memory_order_relaxed);
+        const auto tail = tail_.load(std::memory_order_acquire);
+        for (auto i{head}; i != tail; ++i) {
+            output.push_back(std::move(slots_[i % capacity_]));
+        }
+        head_.store(tail, std::memory_order_release);
+        return tail - head;
+    }
+
+    bool empty() const noexcept { return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_acquire); }
+
+private:
+    const std::size_t capacity_;
+    std::unique_ptr<T[]> slots_;
+    std::atomic<std::size_t> head_{0};
+    std::atomic<std::size_t> tail_{0};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_CONCURRENCY_SPSC_RING_HPP_
@@ -0,0 +1,78 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "spsc_ring.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+TEST_CASE("SpscRing", "[silkrpc][concurrency][spsc_ring]") {
+    SpscRing<std::string> ring{2};
+    std::vector<std::string> output;
+
+    SECTION("empty ring") {
+        CHECK(ring.empty());
+        CHECK(ring.capacity() == 2);
+        CHECK(ring.available() == 2);
+        CHECK(ring.drain(output) == 0);
+        CHECK(output.empty());
+    }
+
+    SECTION("push fails when full") {
+        CHECK(ring.push("a"));
+        CHECK(ring.push("b"));
+        CHECK(ring.available() == 0);
+        CHECK(!ring.push("c"));
+        CHECK(ring.drain(output) == 2);
+        CHECK(output == std::vector<std::string>{"a", "b"});
+        CHECK(ring.empty());
+        CHECK(ring.push("c"));
+        CHECK(ring.drain(output) == 1);
+        CHECK(output == std::vector<std::string>{"a", "b", "c"});
+    }
+}
+
+TEST_CASE("SpscRing with concurrent producer and consumer", "[silkrpc][concurrency][spsc_ring]") {
+    constexpr int kNumElements{10'000};
+    SpscRing<int> ring{16};
+    std::thread producer{[&]() {
+        for (int i{0}; i < kNumElements;) {
+            if (ring.push(int{i})) {
+                ++i;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }};
+    std::vector<int> output;
+    while (output.size() < kNumElements) {
+        ring.drain(output);
+    }
+    producer.join();
+    bool in_order{true};
+    for (int i{0}; i < kNumElements; ++i) {
+        in_order = in_order && output[i] == i;
+    }
+    CHECK(in_order);
+}
+
+} // namespace silkrpc
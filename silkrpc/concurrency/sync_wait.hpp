@@ -0,0 +1,98 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_CONCURRENCY_SYNC_WAIT_HPP_
+#define SILKRPC_CONCURRENCY_SYNC_WAIT_HPP_
+
+#include <atomic>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+
+#include <silkrpc/concurrency/handoff.hpp>
+
+namespace silkrpc {
+
+namespace detail {
+
+//! Spawn the awaitable by the spawner with the completion and block the calling thread until it completes
+template <typename T, typename Spawner>
+T sync_wait(Spawner&& spawn) {
+    std::atomic_flag completed;
+    std::exception_ptr exception;
+    if constexpr (std::is_void_v<T>) {
+        spawn([&](std::exception_ptr eptr) {
+            exception = eptr;
+            completed.test_and_set(std::memory_order_release);
+            completed.notify_one();
+        });
+        completed.wait(false, std::memory_order_acquire);
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    } else {
+        std::optional<T> result;
+        spawn([&](std::exception_ptr eptr, T value) {
+            if (eptr) {
+                exception = eptr;
+            } else {
+                result.emplace(std::move(value));
+            }
+            completed.test_and_set(std::memory_order_release);
+            completed.notify_one();
+        });
+        completed.wait(false, std::memory_order_acquire);
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        return std::move(*result);
+    }
+}
+
+} // namespace detail
+
+//! Run the awaitable on the given executor and block the calling thread until it completes, returning its result or
+//! rethrowing its exception. Unlike co_spawn with use_future, no promise/future shared state is allocated and locked
+//! for each call: the result is moved into the caller frame and the completion is signalled by an atomic flag, so that
+//! synchronous code (e.g. the EVM on a worker thread) pays just the handoff to the asynchronous side and back.
+//! Must never be called from a thread running the executor, because the awaitable could never be executed.
+template <typename T, typename Executor>
+T sync_wait(const Executor& executor, boost::asio::awaitable<T> awaitable) {
+    return detail::sync_wait<T>([&](auto&& completion) {
+        boost::asio::co_spawn(executor, std::move(awaitable), std::forward<decltype(completion)>(completion));
+    });
+}
+
+//! Run the awaitable on the io_context of the given handoff as above, spawning it from the context thread once handed
+//! off there, so that the calling thread takes no lock in the common case
+template <typename T>
+T sync_wait(Handoff& handoff, boost::asio::awaitable<T> awaitable) {
+    return detail::sync_wait<T>([&](auto&& completion) {
+        handoff.post([&handoff, &awaitable, completion = std::forward<decltype(completion)>(completion)]() mutable {
+            boost::asio::co_spawn(handoff.io_context(), std::move(awaitable), std::move(completion));
+        });
+    });
+}
+
+} // namespace silkrpc
+
+#endif // SILKRPC_CONCURRENCY_SYNC_WAIT_HPP_
@@ -0,0 +1,124 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "sync_wait.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+using Catch::Matchers::Message;
+using namespace std::chrono_literals; // NOLINT(build/namespaces)
+
+TEST_CASE("sync_wait", "[silkrpc][concurrency][sync_wait]") {
+    boost::asio::io_context io_context;
+    auto work{boost::asio::make_work_guard(io_context)};
+    std::thread io_context_thread{[&]() { io_context.run(); }};
+
+    SECTION("value returned") {
+        auto value = sync_wait(io_context.get_executor(), []() -> boost::asio::awaitable<std::string> { co_return "value"; }());
+        CHECK(value == "value");
+    }
+
+    SECTION("value returned after asynchronous wait") {
+        auto value = sync_wait(io_context.get_executor(), []() -> boost::asio::awaitable<int> {
+            boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor, 1ms};
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            co_return 42;
+        }());
+        CHECK(value == 42);
+    }
+
+    SECTION("void completed") {
+        bool executed{false};
+        sync_wait(io_context.get_executor(), [&]() -> boost::asio::awaitable<void> { executed = true; co_return; }());
+        CHECK(executed);
+    }
+
+    SECTION("exception rethrown") {
+        CHECK_THROWS_MATCHES(sync_wait(io_context.get_executor(), []() -> boost::asio::awaitable<int> {
+            throw std::runtime_error{"error"};
+            co_return 0;
+        }()), std::runtime_error, Message("error"));
+    }
+
+    SECTION("many calls in sequence") {
+        int sum{0};
+        for (int i{0}; i < 1000; ++i) {
+            sum += sync_wait(io_context.get_executor(), [i]() -> boost::asio::awaitable<int> { co_return i; }());
+        }
+        CHECK(sum == 999 * 1000 / 2);
+    }
+
+    work.reset();
+    io_context_thread.join();
+}
+
+TEST_CASE("sync_wait by handoff", "[silkrpc][concurrency][sync_wait]") {
+    boost::asio::io_context io_context;
+    auto work{boost::asio::make_work_guard(io_context)};
+    auto& handoff = boost::asio::use_service<Handoff>(io_context);
+    std::thread io_context_thread{[&]() { io_context.run(); }};
+
+    SECTION("value returned after asynchronous wait") {
+        auto value = sync_wait(handoff, []() -> boost::asio::awaitable<int> {
+            boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor, 1ms};
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            co_return 42;
+        }());
+        CHECK(value == 42);
+    }
+
+    SECTION("exception rethrown") {
+        CHECK_THROWS_MATCHES(sync_wait(handoff, []() -> boost::asio::awaitable<int> {
+            throw std::runtime_error{"error"};
+            co_return 0;
+        }()), std::runtime_error, Message("error"));
+    }
+
+    SECTION("many calls from many threads") {
+        std::atomic<int> sum{0};
+        std::vector<std::thread> threads;
+        for (int t{0}; t < 4; ++t) {
+            threads.emplace_back([&]() {
+                for (int i{0}; i < 1000; ++i) {
+                    sum += sync_wait(handoff, [i]() -> boost::asio::awaitable<int> { co_return i; }());
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        CHECK(sum == 4 * 999 * 1000 / 2);
+    }
+
+    work.reset();
+    io_context_thread.join();
+}
+
+} // namespace silkrpc
@@ -47,6 +47,10 @@ bool AbslParseFlag(absl::string_view text, WaitMode* wait_mode, std::string* err
         *wait_mode = WaitMode::busy_spin;
         return true;
     }
+    if (text == "adaptive") {
+        *wait_mode = WaitMode::adaptive;
+        return true;
+    }
     *error = "unknown value for WaitMode";
     return false;
 }
@@ -59,6 +63,7 @@ std::string AbslUnparseFlag(WaitMode wait_mode) {
         case WaitMode::yielding: return "yielding";
         case WaitMode::spin_wait: return "spin_wait";
         case WaitMode::busy_spin: return "busy_spin";
+        case WaitMode::adaptive: return "adaptive";
         default: return absl::StrCat(wait_mode);
     }
 }
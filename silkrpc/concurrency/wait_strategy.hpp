@@ -37,6 +37,7 @@
 #ifndef SILKRPC_CONCURRENCY_WAIT_STRATEGY_HPP_
 #define SILKRPC_CONCURRENCY_WAIT_STRATEGY_HPP_
 
+#include <algorithm>
 #include <chrono>
 #include <limits>
 #include <memory>
@@ -47,7 +48,7 @@
 
 namespace silkrpc {
 
-// These wait strategies are experimental for performance tests and not yet production-ready.
+// These wait strategies are experimental for performance tests and not yet production-ready, except AdaptiveWaitStrategy.
 
 class SleepingWaitStrategy {
   public:
@@ -148,13 +149,82 @@ class BusySpinWaitStrategy {
     }
 };
 
+//! Wait strategy adapting to the observed arrival rate of work: it keeps spinning while the next work is expected soon
+//! enough, i.e. within twice the average gap between arrivals, then it yields for a while and finally it sleeps backing
+//! off exponentially, never sleeping longer than the latency budget (0 means never sleeping)
+class AdaptiveWaitStrategy {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Phase {
+        spinning,
+        yielding,
+        sleeping
+    };
+
+    //! The max spin window: if the work arrives less frequently than this, spinning is not worth it
+    inline static const std::chrono::microseconds kMaxSpinWindow{100};
+    //! The min spin window when spinning is worth it, covering the jitter of the arrivals
+    inline static const std::chrono::microseconds kMinSpinWindow{10};
+    //! The time spent yielding after spinning, before starting to sleep
+    inline static const std::chrono::microseconds kYieldWindow{1000};
+    //! The first sleep duration, doubled at each sleep up to the latency budget
+    inline static const std::chrono::microseconds kMinSleep{50};
+
+    explicit AdaptiveWaitStrategy(std::chrono::microseconds latency_budget = std::chrono::milliseconds{1})
+        : latency_budget_{latency_budget} {}
+
+    inline void idle(int work_count) {
+        const auto now = Clock::now();
+        if (work_count > 0) {
+            // Exponentially-weighted moving average of the gap between arrivals, with weight 1/8 for the latest one
+            const auto gap = std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_work_time_);
+            average_gap_ += (std::min<std::chrono::nanoseconds>(gap, kMaxAverageGap) - average_gap_) / 8;
+            last_work_time_ = now;
+            sleep_duration_ = kMinSleep;
+            phase_ = Phase::spinning;
+            return;
+        }
+
+        const auto idle_time = now - last_work_time_;
+        const auto spin_window = average_gap_ <= kMaxSpinWindow ? std::max<std::chrono::nanoseconds>(2 * average_gap_, kMinSpinWindow)
+                                                                : std::chrono::nanoseconds{0};
+        if (idle_time < spin_window) {
+            phase_ = Phase::spinning;
+        } else if (idle_time < spin_window + kYieldWindow || latency_budget_.count() == 0) {
+            phase_ = Phase::yielding;
+            std::this_thread::yield();
+        } else {
+            phase_ = Phase::sleeping;
+            std::this_thread::sleep_for(std::min(sleep_duration_, latency_budget_));
+            sleep_duration_ = std::min(2 * sleep_duration_, latency_budget_);
+        }
+    }
+
+    Phase phase() const noexcept { return phase_; }
+    std::chrono::microseconds average_gap() const noexcept {
+        return std::chrono::duration_cast<std::chrono::microseconds>(average_gap_);
+    }
+
+  private:
+    //! The cap on the gaps in the average, so that a long idle period does not take too long to be forgotten
+    inline static const std::chrono::microseconds kMaxAverageGap{10'000};
+
+    std::chrono::microseconds latency_budget_;
+    std::chrono::nanoseconds average_gap_{kMaxAverageGap};
+    std::chrono::microseconds sleep_duration_{kMinSleep};
+    Clock::time_point last_work_time_{Clock::now()};
+    Phase phase_{Phase::spinning};
+};
+
 enum class WaitMode {
     backoff,    /* Wait strategy implemented in asio-grpc's agrpc::run */
     blocking,   /* Custom multi-thread wait strategy implemented here */
     sleeping,   /* Custom single-thread wait strategies implemented here */
     yielding,
     spin_wait,
-    busy_spin
+    busy_spin,
+    adaptive    /* Custom single-thread wait strategy adapting to the work arrival rate implemented here */
 };
 
 bool AbslParseFlag(absl::string_view text, WaitMode* wait_mode, std::string* error);
@@ -35,7 +35,7 @@ using Catch::Matchers::Message;
 
 TEST_CASE("parse wait mode", "[silkrpc][common][log]") {
     std::vector<absl::string_view> input_texts{
-        "backoff", "blocking", "sleeping", "yielding", "spin_wait", "busy_spin"
+        "backoff", "blocking", "sleeping", "yielding", "spin_wait", "busy_spin", "adaptive"
     };
     std::vector<WaitMode> expected_wait_modes{
         WaitMode::backoff,
@@ -44,6 +44,7 @@ TEST_CASE("parse wait mode", "[silkrpc][common][log]") {
         WaitMode::yielding,
         WaitMode::spin_wait,
         WaitMode::busy_spin,
+        WaitMode::adaptive,
     };
     for (auto i{0}; i < input_texts.size(); i++) {
         WaitMode wait_mode;
@@ -71,9 +72,10 @@ TEST_CASE("unparse wait mode", "[silkrpc][common][log]") {
         WaitMode::yielding,
         WaitMode::spin_wait,
         WaitMode::busy_spin,
+        WaitMode::adaptive,
     };
     std::vector<absl::string_view> expected_texts{
-        "backoff", "blocking", "sleeping", "yielding", "spin_wait", "busy_spin"
+        "backoff", "blocking", "sleeping", "yielding", "spin_wait", "busy_spin", "adaptive"
     };
     for (auto i{0}; i < input_wait_modes.size(); i++) {
         const auto text{AbslUnparseFlag(input_wait_modes[i])};
@@ -119,4 +121,44 @@ TEST_CASE("BusySpinWaitStrategy", "[silkrpc][context_pool]") {
     sleep_then_check_wait(wait_strategy, 10ms, 1);
 }
 
+TEST_CASE("AdaptiveWaitStrategy", "[silkrpc][context_pool]") {
+    SECTION("sleep_then_check_wait") {
+        AdaptiveWaitStrategy wait_strategy;
+        sleep_then_check_wait(wait_strategy, 10ms, 1);
+        sleep_then_check_wait(wait_strategy, 20ms, 0);
+        sleep_then_check_wait(wait_strategy, 20ms, 0);
+        sleep_then_check_wait(wait_strategy, 10ms, 1);
+    }
+
+    SECTION("spin while work arrives frequently") {
+        AdaptiveWaitStrategy wait_strategy;
+        for (auto i{0}; i < 100; ++i) {
+            wait_strategy.idle(1);
+        }
+        CHECK(wait_strategy.average_gap() <= AdaptiveWaitStrategy::kMaxSpinWindow);
+        wait_strategy.idle(0);
+        CHECK(wait_strategy.phase() == AdaptiveWaitStrategy::Phase::spinning);
+    }
+
+    SECTION("yield then sleep when idle") {
+        AdaptiveWaitStrategy wait_strategy;
+        wait_strategy.idle(1);
+        wait_strategy.idle(0);
+        CHECK(wait_strategy.phase() == AdaptiveWaitStrategy::Phase::yielding);
+        std::this_thread::sleep_for(2ms);
+        wait_strategy.idle(0);
+        CHECK(wait_strategy.phase() == AdaptiveWaitStrategy::Phase::sleeping);
+        wait_strategy.idle(1);
+        CHECK(wait_strategy.phase() == AdaptiveWaitStrategy::Phase::spinning);
+    }
+
+    SECTION("never sleep with zero latency budget") {
+        AdaptiveWaitStrategy wait_strategy{0us};
+        wait_strategy.idle(1);
+        std::this_thread::sleep_for(2ms);
+        wait_strategy.idle(0);
+        CHECK(wait_strategy.phase() == AdaptiveWaitStrategy::Phase::yielding);
+    }
+}
+
 } // namespace silkrpc
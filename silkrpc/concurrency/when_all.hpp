@@ -0,0 +1,96 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_CONCURRENCY_WHEN_ALL_HPP_
+#define SILKRPC_CONCURRENCY_WHEN_ALL_HPP_
+
+#include <array>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/this_coro.hpp>
+
+#include <silkrpc/concurrency/parallel_for.hpp>
+
+namespace silkrpc {
+
+namespace detail {
+
+//! The result of an operation awaited by when_all, std::monostate standing for void
+template <typename T>
+using WhenAllResult = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+template <std::size_t I, typename... Ts>
+boost::asio::awaitable<void> await_nth(std::size_t index, std::tuple<boost::asio::awaitable<Ts>...>& operations,
+                                       std::tuple<std::optional<WhenAllResult<Ts>>...>& results) {
+    if (index == I) {
+        if constexpr (std::is_void_v<std::tuple_element_t<I, std::tuple<Ts...>>>) {
+            co_await std::move(std::get<I>(operations));
+            std::get<I>(results).emplace();
+        } else {
+            std::get<I>(results).emplace(co_await std::move(std::get<I>(operations)));
+        }
+    } else if constexpr (I + 1 < sizeof...(Ts)) {
+        co_await await_nth<I + 1>(index, operations, results);
+    }
+}
+
+} // namespace detail
+
+//! Await the operations as concurrent coroutines on the executor of the calling coroutine, returning their results in the
+//! same order (std::monostate for void operations). The executor must not run coroutines in parallel as in parallel_for,
+//! so the concurrency achieved is the overlapping of the asynchronous waits: e.g. independent reads through the same
+//! DatabaseReader are all in flight together instead of one after another. All operations are always completed before
+//! returning, then the exception thrown by the first failed operation in argument order (if any) is rethrown.
+//! The operations start just when awaited here, so any temporary they refer to must live until when_all completes.
+template <typename... Ts>
+boost::asio::awaitable<std::tuple<detail::WhenAllResult<Ts>...>> when_all(boost::asio::awaitable<Ts>... operations) {
+    static_assert(sizeof...(Ts) > 0, "when_all needs at least one operation");
+
+    std::tuple<boost::asio::awaitable<Ts>...> pending{std::move(operations)...};
+    std::tuple<std::optional<detail::WhenAllResult<Ts>>...> results;
+    std::array<std::exception_ptr, sizeof...(Ts)> exceptions;
+
+    const auto executor = co_await boost::asio::this_coro::executor;
+    co_await parallel_for(executor, sizeof...(Ts), sizeof...(Ts), [&](std::size_t index) -> boost::asio::awaitable<void> {
+        try {
+            co_await detail::await_nth<0>(index, pending, results);
+        } catch (...) {
+            exceptions[index] = std::current_exception();
+        }
+    });
+
+    for (const auto& exception : exceptions) {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+    co_return std::apply([](auto&... result) {
+        return std::tuple<detail::WhenAllResult<Ts>...>{std::move(*result)...};
+    }, results);
+}
+
+} // namespace silkrpc
+
+#endif // SILKRPC_CONCURRENCY_WHEN_ALL_HPP_
@@ -0,0 +1,99 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "when_all.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_future.hpp>
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+using Catch::Matchers::Message;
+using namespace std::chrono_literals; // NOLINT(build/namespaces)
+
+template <typename T>
+T run(boost::asio::awaitable<T> awaitable) {
+    boost::asio::io_context io_context;
+    auto result = boost::asio::co_spawn(io_context, std::move(awaitable), boost::asio::use_future);
+    io_context.run();
+    return result.get();
+}
+
+boost::asio::awaitable<int> delayed_value(int value, std::chrono::milliseconds delay, std::vector<int>& completions) {
+    boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor, delay};
+    co_await timer.async_wait(boost::asio::use_awaitable);
+    completions.push_back(value);
+    co_return value;
+}
+
+boost::asio::awaitable<void> delayed_failure(const std::string& message, std::chrono::milliseconds delay) {
+    boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor, delay};
+    co_await timer.async_wait(boost::asio::use_awaitable);
+    throw std::runtime_error{message};
+}
+
+TEST_CASE("when_all", "[silkrpc][concurrency][when_all]") {
+    SECTION("single operation") {
+        std::vector<int> completions;
+        const auto [value] = run(when_all(delayed_value(1, 1ms, completions)));
+        CHECK(value == 1);
+        CHECK(completions == std::vector<int>{1});
+    }
+
+    SECTION("results in argument order") {
+        std::vector<int> completions;
+        const auto [first, second, third] = run(when_all(delayed_value(1, 30ms, completions), delayed_value(2, 1ms, completions),
+            delayed_value(3, 15ms, completions)));
+        CHECK(first == 1);
+        CHECK(second == 2);
+        CHECK(third == 3);
+        CHECK(completions == std::vector<int>{2, 3, 1});
+    }
+
+    SECTION("operations overlapped") {
+        std::vector<int> completions;
+        const auto start = std::chrono::steady_clock::now();
+        run(when_all(delayed_value(1, 50ms, completions), delayed_value(2, 50ms, completions), delayed_value(3, 50ms, completions)));
+        CHECK(std::chrono::steady_clock::now() - start < 140ms);
+        CHECK(completions.size() == 3);
+    }
+
+    SECTION("void operations") {
+        bool executed{false};
+        auto void_operation = [&]() -> boost::asio::awaitable<void> { executed = true; co_return; };
+        std::vector<int> completions;
+        const auto [unused, value] = run(when_all(void_operation(), delayed_value(2, 1ms, completions)));
+        CHECK(executed);
+        CHECK(value == 2);
+    }
+
+    SECTION("first failure in argument order rethrown after all completed") {
+        std::vector<int> completions;
+        CHECK_THROWS_MATCHES(run(when_all(delayed_value(1, 30ms, completions), delayed_failure("second", 20ms),
+            delayed_failure("third", 1ms))), std::runtime_error, Message("second"));
+        CHECK(completions == std::vector<int>{1});
+    }
+}
+
+} // namespace silkrpc
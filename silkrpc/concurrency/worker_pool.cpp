@@ -0,0 +1,189 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "worker_pool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include <boost/asio/post.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc {
+
+//! Tell the elastic workers, which may be parked, from the fixed ones
+static thread_local bool is_elastic_worker{false};
+
+WorkerPool::WorkerPool(std::size_t num_workers, std::size_t num_long_running_workers, std::size_t max_workers)
+    : num_workers_{num_workers}, num_long_running_workers_{num_long_running_workers}, max_workers_{std::max(max_workers, num_workers)},
+      workers_{num_workers} {
+    if (num_long_running_workers > 0) {
+        long_running_workers_ = std::make_unique<boost::asio::thread_pool>(num_long_running_workers);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    release();
+    workers_.stop();
+    for (auto& elastic_thread : elastic_threads_) {
+        elastic_thread.join();
+    }
+}
+
+boost::asio::thread_pool& WorkerPool::pool(WorkloadClass workload_class) noexcept {
+    if (workload_class == WorkloadClass::long_running && long_running_workers_) {
+        return *long_running_workers_;
+    }
+    return workers_;
+}
+
+std::size_t WorkerPool::size(WorkloadClass workload_class) const noexcept {
+    if (workload_class == WorkloadClass::long_running && long_running_workers_) {
+        return num_long_running_workers_;
+    }
+    return num_workers_ + num_active_elastic_.load(std::memory_order_relaxed);
+}
+
+std::size_t WorkerPool::max_size() const noexcept {
+    return max_workers_.load(std::memory_order_relaxed);
+}
+
+void WorkerPool::set_max_size(std::size_t max_workers) {
+    std::scoped_lock lock{elastic_mutex_};
+    max_workers_ = std::max(max_workers, num_workers_);
+    while (num_workers_ + num_active_elastic_ - num_parking_ > max_workers_) {
+        shrink();
+    }
+}
+
+void WorkerPool::scale(std::chrono::microseconds queue_wait) {
+    std::scoped_lock lock{elastic_mutex_};
+    if (released_) {
+        return;
+    }
+    if (queue_wait > kGrowQueueWait) {
+        num_short_waits_ = 0;
+        if (num_workers_ + num_active_elastic_ < max_workers_) {
+            grow();
+        }
+    } else if (queue_wait < kShrinkQueueWait && num_active_elastic_ > num_parking_) {
+        if (++num_short_waits_ >= kShrinkProbes) {
+            num_short_waits_ = 0;
+            shrink();
+        }
+    } else {
+        num_short_waits_ = 0;
+    }
+}
+
+void WorkerPool::grow() {
+    ++num_active_elastic_;
+    if (num_parked_ > 0) {
+        --num_parked_;
+        ++num_resumed_;
+        elastic_resumed_.notify_one();
+        return;
+    }
+    elastic_threads_.emplace_back([&]() {
+        is_elastic_worker = true;
+        workers_.attach();
+    });
+    SILKRPC_DEBUG << "WorkerPool::grow started elastic worker, short-call workers: " << size() << "\n";
+}
+
+void WorkerPool::shrink() {
+    ++num_parking_;
+    boost::asio::post(workers_, [&]() { park(); });
+}
+
+void WorkerPool::park() {
+    std::unique_lock lock{elastic_mutex_};
+    --num_parking_;
+    if (!is_elastic_worker || released_) {
+        return; // the next short queue waits will try again
+    }
+    --num_active_elastic_;
+    ++num_parked_;
+    elastic_resumed_.wait(lock, [&]() { return num_resumed_ > 0 || released_; });
+    if (num_resumed_ > 0) {
+        --num_resumed_;
+    } else {
+        --num_parked_;
+    }
+}
+
+void WorkerPool::release() {
+    {
+        std::scoped_lock lock{elastic_mutex_};
+        released_ = true;
+    }
+    elastic_resumed_.notify_all();
+}
+
+void WorkerPool::probe_queue_wait() {
+    for (const auto workload_class : {WorkloadClass::short_call, WorkloadClass::long_running}) {
+        auto& probe = probes_[static_cast<std::size_t>(workload_class)];
+        if (probe.waiting.exchange(true)) {
+            continue;
+        }
+        const auto posted = Clock::now();
+        probe.posted_time = posted.time_since_epoch().count();
+        boost::asio::post(pool(workload_class), [this, &probe, workload_class, posted]() {
+            const auto wait = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - posted);
+            probe.wait_microseconds = wait.count();
+            probe.posted_time = 0;
+            probe.waiting = false;
+            if (workload_class == WorkloadClass::short_call) {
+                scale(wait);
+            }
+        });
+    }
+}
+
+std::chrono::microseconds WorkerPool::queue_wait(WorkloadClass workload_class) const noexcept {
+    const auto& probe = probes_[static_cast<std::size_t>(workload_class)];
+    const std::chrono::microseconds last_wait{probe.wait_microseconds.load()};
+    const auto posted_time = probe.posted_time.load();
+    if (posted_time == 0) {
+        return last_wait;
+    }
+    const Clock::time_point posted{Clock::duration{posted_time}};
+    const auto pending_wait = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - posted);
+    return std::max(last_wait, pending_wait);
+}
+
+void WorkerPool::stop() {
+    release();
+    workers_.stop();
+    if (long_running_workers_) {
+        long_running_workers_->stop();
+    }
+}
+
+void WorkerPool::join() {
+    release();
+    workers_.join();
+    if (long_running_workers_) {
+        long_running_workers_->join();
+    }
+    for (auto& elastic_thread : elastic_threads_) {
+        elastic_thread.join();
+    }
+    elastic_threads_.clear();
+}
+
+} // namespace silkrpc
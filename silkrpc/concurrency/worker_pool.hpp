@@ -0,0 +1,137 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_CONCURRENCY_WORKER_POOL_HPP_
+#define SILKRPC_CONCURRENCY_WORKER_POOL_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/thread_pool.hpp>
+
+namespace silkrpc {
+
+//! The class of workload executed by the workers, so that the long-running ones cannot delay the short ones
+enum class WorkloadClass : std::size_t {
+    short_call = 0,   // e.g. eth_call, eth_estimateGas and the reply serialization
+    long_running = 1, // e.g. debug_traceBlockByNumber, trace_filter
+};
+
+//! Pools of worker threads, one for each workload class: the long-running pool, if empty, is the short-call one.
+//! The short-call pool is elastic if its max size exceeds the fixed workers: the queue wait of the short calls measured
+//! by the probes makes it grow one elastic worker at a time up to such size and shrink again once the queue is short,
+//! the elastic workers in excess parking on a condition variable until needed again.
+class WorkerPool {
+public:
+    //! The number of workload classes
+    static constexpr std::size_t kNumClasses{2};
+
+    //! The queue wait of the short calls above which the pool grows by one worker
+    static constexpr std::chrono::microseconds kGrowQueueWait{1000};
+
+    //! The queue wait of the short calls below which the pool may shrink
+    static constexpr std::chrono::microseconds kShrinkQueueWait{100};
+
+    //! The number of consecutive probes below kShrinkQueueWait making the pool shrink by one worker
+    static constexpr uint32_t kShrinkProbes{64};
+
+    //! The max number of short-call workers equal to 0 or not exceeding the fixed ones means no elastic worker at all
+    explicit WorkerPool(std::size_t num_workers, std::size_t num_long_running_workers = 0, std::size_t max_workers = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    //! Return the thread pool executing the specified class of workload
+    boost::asio::thread_pool& pool(WorkloadClass workload_class = WorkloadClass::short_call) noexcept;
+
+    //! Return the number of threads executing the specified class of workload, the parked elastic workers excluded
+    std::size_t size(WorkloadClass workload_class = WorkloadClass::short_call) const noexcept;
+
+    //! Return the max number of threads the short-call pool can grow to
+    std::size_t max_size() const noexcept;
+
+    //! Change the max number of threads the short-call pool can grow to, parking the elastic workers in excess if any
+    void set_max_size(std::size_t max_workers);
+
+    //! Grow or shrink the short-call pool by one elastic worker depending on the queue wait measured by one probe
+    void scale(std::chrono::microseconds queue_wait);
+
+    //! Post a probe task measuring how long the tasks of each class wait in the queue, unless one is still waiting
+    void probe_queue_wait();
+
+    //! Return the queue wait measured by the latest completed probe of the specified class or, if longer, the time
+    //! the pending probe has been waiting so far
+    std::chrono::microseconds queue_wait(WorkloadClass workload_class) const noexcept;
+
+    void stop();
+
+    void join();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Probe {
+        std::atomic<int64_t> wait_microseconds{0};
+        std::atomic<Clock::rep> posted_time{0}; // 0 means no probe pending
+        std::atomic_bool waiting{false};
+    };
+
+    //! Start one more elastic worker or resume a parked one, if any
+    void grow();
+
+    //! Post the task parking the first elastic worker picking it, unless some fixed worker picks it instead
+    void shrink();
+
+    //! Park the elastic worker executing this until resumed or stopped
+    void park();
+
+    //! Resume all the parked elastic workers and prevent any further scaling
+    void release();
+
+    std::size_t num_workers_;
+    std::size_t num_long_running_workers_;
+
+    //! The probes must outlive the pools, because the pools run the pending probes when destroyed
+    std::array<Probe, kNumClasses> probes_;
+
+    //! The elastic state must outlive the pools as well, because the pending probes scale the pool
+    std::atomic<std::size_t> max_workers_;
+    std::atomic<std::size_t> num_active_elastic_{0};
+    std::mutex elastic_mutex_;
+    std::condition_variable elastic_resumed_;
+    std::vector<std::thread> elastic_threads_;
+    std::size_t num_parked_{0};
+    std::size_t num_parking_{0}; // parking tasks posted but not executed yet
+    std::size_t num_resumed_{0}; // parked workers resumed but not woken up yet
+    uint32_t num_short_waits_{0};
+    bool released_{false};
+
+    boost::asio::thread_pool workers_;
+    std::unique_ptr<boost::asio::thread_pool> long_running_workers_;
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_CONCURRENCY_WORKER_POOL_HPP_
@@ -0,0 +1,145 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "worker_pool.hpp"
+
+#include <chrono>
+#include <future>
+#include <latch>
+#include <thread>
+
+#include <boost/asio/post.hpp>
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+TEST_CASE("WorkerPool::pool", "[silkrpc][concurrency][worker_pool]") {
+    SECTION("shared pool") {
+        WorkerPool workers{2};
+        CHECK(&workers.pool(WorkloadClass::short_call) == &workers.pool(WorkloadClass::long_running));
+        CHECK(workers.size(WorkloadClass::short_call) == 2);
+        CHECK(workers.size(WorkloadClass::long_running) == 2);
+    }
+
+    SECTION("dedicated long-running pool") {
+        WorkerPool workers{2, 1};
+        CHECK(&workers.pool(WorkloadClass::short_call) != &workers.pool(WorkloadClass::long_running));
+        CHECK(workers.size(WorkloadClass::short_call) == 2);
+        CHECK(workers.size(WorkloadClass::long_running) == 1);
+    }
+}
+
+TEST_CASE("WorkerPool short calls not blocked by long-running ones", "[silkrpc][concurrency][worker_pool]") {
+    WorkerPool workers{1, 1};
+    std::latch long_running_done{1};
+    boost::asio::post(workers.pool(WorkloadClass::long_running), [&]() { long_running_done.wait(); });
+
+    std::promise<void> short_call_done;
+    boost::asio::post(workers.pool(WorkloadClass::short_call), [&]() { short_call_done.set_value(); });
+    CHECK(short_call_done.get_future().wait_for(std::chrono::seconds{5}) == std::future_status::ready);
+
+    long_running_done.count_down();
+    workers.join();
+}
+
+TEST_CASE("WorkerPool::queue_wait", "[silkrpc][concurrency][worker_pool]") {
+    WorkerPool workers{1, 1};
+    CHECK(workers.queue_wait(WorkloadClass::short_call) == std::chrono::microseconds{0});
+    CHECK(workers.queue_wait(WorkloadClass::long_running) == std::chrono::microseconds{0});
+
+    SECTION("pending probe") {
+        std::latch long_running_done{1};
+        boost::asio::post(workers.pool(WorkloadClass::long_running), [&]() { long_running_done.wait(); });
+        workers.probe_queue_wait();
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        CHECK(workers.queue_wait(WorkloadClass::long_running) >= std::chrono::milliseconds{10});
+        long_running_done.count_down();
+    }
+
+    SECTION("completed probe") {
+        workers.probe_queue_wait();
+        workers.join();
+        CHECK(workers.queue_wait(WorkloadClass::short_call) < std::chrono::seconds{5});
+    }
+}
+
+//! Keep reporting short queue waits until the elastic workers in excess are parked, returning false if never
+static bool scale_down_to(WorkerPool& workers, std::size_t size) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+    while (workers.size() > size && std::chrono::steady_clock::now() < deadline) {
+        for (uint32_t i{0}; i < WorkerPool::kShrinkProbes; ++i) {
+            workers.scale(std::chrono::microseconds{0});
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    return workers.size() == size;
+}
+
+TEST_CASE("WorkerPool::scale", "[silkrpc][concurrency][worker_pool]") {
+    SECTION("fixed pool") {
+        WorkerPool workers{2};
+        CHECK(workers.max_size() == 2);
+        workers.scale(WorkerPool::kGrowQueueWait * 2);
+        CHECK(workers.size() == 2);
+    }
+
+    SECTION("elastic pool") {
+        WorkerPool workers{1, 0, 3};
+        CHECK(workers.max_size() == 3);
+        CHECK(workers.size() == 1);
+
+        workers.scale(WorkerPool::kGrowQueueWait * 2);
+        CHECK(workers.size() == 2);
+        workers.scale(WorkerPool::kGrowQueueWait * 2);
+        workers.scale(WorkerPool::kGrowQueueWait * 2);
+        CHECK(workers.size() == 3);
+
+        workers.scale(WorkerPool::kShrinkQueueWait);
+        CHECK(workers.size() == 3);
+        CHECK(scale_down_to(workers, 2));
+
+        workers.scale(WorkerPool::kGrowQueueWait * 2);
+        CHECK(workers.size() == 3);
+
+        std::promise<void> short_call_done;
+        boost::asio::post(workers.pool(WorkloadClass::short_call), [&]() { short_call_done.set_value(); });
+        CHECK(short_call_done.get_future().wait_for(std::chrono::seconds{5}) == std::future_status::ready);
+
+        CHECK(scale_down_to(workers, 1));
+        workers.stop();
+        workers.join();
+    }
+
+    SECTION("max size changed") {
+        WorkerPool workers{1, 0, 3};
+        workers.scale(WorkerPool::kGrowQueueWait * 2);
+        workers.scale(WorkerPool::kGrowQueueWait * 2);
+        CHECK(workers.size() == 3);
+
+        workers.set_max_size(0);
+        CHECK(workers.max_size() == 1);
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+        while (workers.size() > 1 && std::chrono::steady_clock::now() < deadline) {
+            workers.set_max_size(1);
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        CHECK(workers.size() == 1);
+        workers.scale(WorkerPool::kGrowQueueWait * 2);
+        CHECK(workers.size() == 1);
+    }
+}
+
+} // namespace silkrpc
@@ -20,6 +20,7 @@
 #if __has_include(<coroutine>)
 # include <boost/asio/detail/config.hpp>
 # include <coroutine>
+# include <silkrpc/concurrency/frame_pool.hpp>
 #elif __has_include(<experimental/coroutine>)
 # include <experimental/coroutine>
 namespace std {
@@ -30,4 +31,15 @@ namespace std {
 } // namespace std
 #endif // __has_include(<coroutine>)
 
+namespace silkrpc {
+
+//! Whether the asynchronous I/O of all the Asio sockets is served by io_uring (SILKRPC_USE_IO_URING) instead of epoll
+#ifdef BOOST_ASIO_HAS_IO_URING_AS_DEFAULT
+inline constexpr bool kIoUringBackend{true};
+#else
+inline constexpr bool kIoUringBackend{false};
+#endif // BOOST_ASIO_HAS_IO_URING_AS_DEFAULT
+
+} // namespace silkrpc
+
 #endif // SILKRPC_CONFIG_HPP_
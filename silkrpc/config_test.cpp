@@ -16,6 +16,14 @@
 
 #include "config.hpp"
 
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
 #include <catch2/catch.hpp>
 
 namespace silkrpc {
@@ -40,5 +48,37 @@ TEST_CASE("check configuration", "[silkrpc][config]") {
     CHECK(&typeid(std::suspend_never) != nullptr);
 }
 
+TEST_CASE("check asynchronous I/O backend", "[silkrpc][config]") {
+    boost::asio::io_context io_context;
+    boost::asio::ip::tcp::acceptor acceptor{io_context, {boost::asio::ip::address_v4::loopback(), 0}};
+    boost::asio::ip::tcp::socket client{io_context};
+    boost::asio::ip::tcp::socket server{io_context};
+    std::array<char, 4> received{};
+    std::size_t bytes_received{0};
+    acceptor.async_accept(server, [&](const boost::system::error_code& accept_ec) {
+        REQUIRE(!accept_ec);
+        boost::asio::async_read(server, boost::asio::buffer(received), [&](const boost::system::error_code& read_ec, std::size_t n) {
+            CHECK(!read_ec);
+            bytes_received = n;
+        });
+    });
+    client.async_connect(acceptor.local_endpoint(), [&](const boost::system::error_code& connect_ec) {
+        REQUIRE(!connect_ec);
+        boost::asio::async_write(client, boost::asio::buffer("ping", 4), [](const boost::system::error_code& write_ec, std::size_t) {
+            CHECK(!write_ec);
+        });
+    });
+    io_context.run();
+    CHECK(bytes_received == received.size());
+    CHECK(std::string_view{received.data(), received.size()} == "ping");
+#ifdef BOOST_ASIO_HAS_IO_URING_AS_DEFAULT
+    CHECK(kIoUringBackend);
+    CHECK(boost::asio::has_service<boost::asio::detail::io_uring_service>(io_context));
+#else
+    CHECK(!kIoUringBackend);
+    CHECK(boost::asio::has_service<boost::asio::detail::reactor>(io_context));
+#endif // BOOST_ASIO_HAS_IO_URING_AS_DEFAULT
+}
+
 } // namespace silkrpc
 
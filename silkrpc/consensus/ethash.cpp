@@ -22,12 +22,14 @@
 namespace silkrpc::ethash {
 
 BlockReward compute_reward(const ChainConfig& config, const silkworm::Block& block) {
-    const auto cc_optional = silkworm::ChainConfig::from_json(config.config);
-    if (!cc_optional) {
+    return compute_reward(ParsedChainConfig{config}, block);
+}
+
+BlockReward compute_reward(const ParsedChainConfig& config, const silkworm::Block& block) {
+    if (!config.silkworm_config) {
         throw std::runtime_error("Invalid chain config");
     }
-    const auto chain_config = cc_optional.value();
-    const auto revision = chain_config.revision(block.header.number);
+    const auto revision = config.revision(block.header.number);
     BlockReward block_reward;
     block_reward.miner_reward = silkworm::param::kBlockRewardFrontier;
     if (revision > evmc_revision::EVMC_BYZANTIUM) {
@@ -35,6 +35,9 @@ struct BlockReward {
 
 BlockReward compute_reward(const ChainConfig& config, const silkworm::Block& block);
 
+//! Compute the rewards of the block looking up the fork table of the parsed config, w/o parsing it again
+BlockReward compute_reward(const ParsedChainConfig& config, const silkworm::Block& block);
+
 std::ostream& operator<<(std::ostream& out, const BlockReward& reward);
 
 } // namespace silkrpc::ethash
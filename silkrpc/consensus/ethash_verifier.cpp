@@ -0,0 +1,183 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "ethash_verifier.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+#include <boost/asio/compose.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::ethash {
+
+EpochCache::EpochCache(boost::asio::thread_pool& workers, std::size_t max_epochs)
+    : workers_{workers}, state_{std::make_shared<State>(std::max<std::size_t>(max_epochs, 1))} {}
+
+boost::asio::awaitable<EpochCache::EpochContext> EpochCache::get(int epoch_number) {
+    const auto executor = co_await boost::asio::this_coro::executor;
+    while (true) {
+        EpochContext context;
+        {
+            std::lock_guard lock{state_->mutex};
+            const auto it = state_->entries.find(epoch_number);
+            if (it != state_->entries.end()) {
+                context = it->second.context;
+            }
+        }
+        if (context) {
+            prefetch(epoch_number + 1);
+            co_return context;
+        }
+
+        // Await the build, unless completed meanwhile: the context may be evicted before resuming, then try again
+        co_await boost::asio::async_compose<decltype(boost::asio::use_awaitable), void()>(
+            [&](auto&& self) {
+                auto shared_self = std::make_shared<std::decay_t<decltype(self)>>(std::move(self));
+                auto resume = [executor, shared_self]() {
+                    boost::asio::post(executor, [shared_self]() { shared_self->complete(); });
+                };
+                std::lock_guard lock{state_->mutex};
+                build_locked(epoch_number);
+                auto& entry = state_->entries.at(epoch_number);
+                if (entry.context) {
+                    resume();
+                } else {
+                    entry.waiters.emplace_back(std::move(resume));
+                }
+            },
+            boost::asio::use_awaitable);
+    }
+}
+
+void EpochCache::prefetch(int epoch_number) {
+    std::lock_guard lock{state_->mutex};
+    build_locked(epoch_number);
+}
+
+bool EpochCache::contains(int epoch_number) const {
+    std::lock_guard lock{state_->mutex};
+    const auto it = state_->entries.find(epoch_number);
+    return it != state_->entries.end() && it->second.context;
+}
+
+std::size_t EpochCache::size() const {
+    std::lock_guard lock{state_->mutex};
+    return state_->entries.size();
+}
+
+int EpochCache::epoch_of(uint64_t block_number) noexcept {
+    return static_cast<int>(block_number / ::ethash::epoch_length);
+}
+
+void EpochCache::build_locked(int epoch_number) {
+    if (state_->entries.contains(epoch_number)) {
+        return;
+    }
+    state_->entries.emplace(epoch_number, Entry{});
+    SILKRPC_DEBUG << "EpochCache::build_locked epoch: " << epoch_number << " build started\n";
+    boost::asio::post(workers_, [state = state_, epoch_number]() {
+        const auto start_time = std::chrono::steady_clock::now();
+        auto context_ptr = ::ethash::create_epoch_context(epoch_number);
+        EpochContext context{context_ptr.release(), ethash_destroy_epoch_context};
+        SILKRPC_INFO << "EpochCache: epoch " << epoch_number << " context built in "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count() << " ms\n";
+        on_built(*state, epoch_number, std::move(context));
+    });
+}
+
+void EpochCache::on_built(State& state, int epoch_number, EpochContext context) {
+    std::vector<std::function<void()>> waiters;
+    {
+        std::lock_guard lock{state.mutex};
+        auto& entry = state.entries.at(epoch_number);
+        entry.context = std::move(context);
+        waiters.swap(entry.waiters);
+
+        // Evict the oldest epochs already built, the ones being built have waiters or have just been prefetched
+        for (auto it = state.entries.begin(); state.entries.size() > state.max_epochs && it != state.entries.end();) {
+            if (it->second.context && it->first != epoch_number) {
+                it = state.entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    for (const auto& waiter : waiters) {
+        waiter();
+    }
+}
+
+WorkVerifier::WorkVerifier(boost::asio::thread_pool& workers, std::size_t max_epochs)
+    : workers_{workers}, epoch_cache_{workers, max_epochs} {}
+
+void WorkVerifier::add_work(const evmc::bytes32& header_hash, const evmc::bytes32& target, uint64_t block_number) {
+    {
+        std::lock_guard lock{mutex_};
+        work_packages_.insert_or_assign(header_hash, WorkPackage{target, block_number, ++sequence_});
+        if (work_packages_.size() > kMaxWorkPackages) {
+            const auto oldest = std::min_element(work_packages_.begin(), work_packages_.end(),
+                [](const auto& lhs, const auto& rhs) { return lhs.second.sequence < rhs.second.sequence; });
+            work_packages_.erase(oldest);
+        }
+    }
+    epoch_cache_.prefetch(EpochCache::epoch_of(block_number));
+}
+
+boost::asio::awaitable<std::optional<bool>> WorkVerifier::verify(uint64_t nonce, const evmc::bytes32& header_hash, const evmc::bytes32& mix_digest) {
+    std::optional<WorkPackage> work_package;
+    {
+        std::lock_guard lock{mutex_};
+        const auto it = work_packages_.find(header_hash);
+        if (it != work_packages_.end()) {
+            work_package = it->second;
+        }
+    }
+    if (!work_package) {
+        co_return std::nullopt;
+    }
+
+    const auto context = co_await epoch_cache_.get(EpochCache::epoch_of(work_package->block_number));
+    const auto executor = co_await boost::asio::this_coro::executor;
+    const auto valid = co_await boost::asio::async_compose<decltype(boost::asio::use_awaitable), void(bool)>(
+        [&](auto&& self) {
+            boost::asio::post(workers_, [&, executor, self = std::move(self)]() mutable {
+                const auto valid = verify(*context, nonce, header_hash, mix_digest, work_package->target);
+                boost::asio::post(executor, [valid, self = std::move(self)]() mutable { self.complete(valid); });
+            });
+        },
+        boost::asio::use_awaitable);
+    co_return valid;
+}
+
+bool WorkVerifier::verify(const ::ethash::epoch_context& context, uint64_t nonce, const evmc::bytes32& header_hash,
+    const evmc::bytes32& mix_digest, const evmc::bytes32& target) {
+    ::ethash::hash256 ethash_header_hash;
+    std::memcpy(ethash_header_hash.bytes, header_hash.bytes, sizeof(ethash_header_hash.bytes));
+    const auto result = ::ethash::hash(context, ethash_header_hash, nonce);
+    if (std::memcmp(result.mix_hash.bytes, mix_digest.bytes, sizeof(mix_digest.bytes)) != 0) {
+        return false;
+    }
+    // Both the final hash and the target are big-endian 256-bit numbers
+    return std::memcmp(result.final_hash.bytes, target.bytes, sizeof(target.bytes)) <= 0;
+}
+
+} // namespace silkrpc::ethash
@@ -0,0 +1,133 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef SILKRPC_CONSENSUS_ETHASH_VERIFIER_HPP_
+#define SILKRPC_CONSENSUS_ETHASH_VERIFIER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <silkrpc/config.hpp> // NOLINT(build/include_order)
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <ethash/ethash.hpp>
+#include <evmc/evmc.hpp>
+
+namespace silkrpc::ethash {
+
+//! Cache of the ethash epoch contexts (i.e. the light caches) shared by all the verifications: each context is built once
+//! on the worker threads, while the callers needing it await without blocking their executor and are resumed on their
+//! own. Getting a context also prefetches the next epoch in the background, so that the verifications never stall on a
+//! multi-second build at the epoch boundaries. Only the most recent epochs are kept, the light cache being tens of MB.
+class EpochCache {
+public:
+    using EpochContext = std::shared_ptr<const ::ethash::epoch_context>;
+
+    //! The default number of epochs kept, i.e. the previous, current and next ones
+    static constexpr std::size_t kDefaultMaxEpochs{3};
+
+    explicit EpochCache(boost::asio::thread_pool& workers, std::size_t max_epochs = kDefaultMaxEpochs);
+
+    EpochCache(const EpochCache&) = delete;
+    EpochCache& operator=(const EpochCache&) = delete;
+
+    //! Return the context of the epoch, awaiting its build if not ready yet, and prefetch the next one
+    boost::asio::awaitable<EpochContext> get(int epoch_number);
+
+    //! Start building the context of the epoch in the background, unless cached or being built already
+    void prefetch(int epoch_number);
+
+    //! Return true if the context of the epoch is ready
+    bool contains(int epoch_number) const;
+
+    //! The number of epochs cached or being built
+    std::size_t size() const;
+
+    //! Return the epoch of the block number
+    static int epoch_of(uint64_t block_number) noexcept;
+
+private:
+    struct Entry {
+        EpochContext context;
+        std::vector<std::function<void()>> waiters;
+    };
+
+    //! The state shared with the builds in progress, which may outlive the cache
+    struct State {
+        explicit State(std::size_t max_epochs) : max_epochs{max_epochs} {}
+
+        std::size_t max_epochs;
+        std::mutex mutex;
+        std::map<int, Entry> entries;
+    };
+
+    //! Start building the context of the epoch unless present, the mutex being held
+    void build_locked(int epoch_number);
+
+    //! Store the context built, evicting the oldest epochs in excess, and resume its waiters
+    static void on_built(State& state, int epoch_number, EpochContext context);
+
+    boost::asio::thread_pool& workers_;
+    std::shared_ptr<State> state_;
+};
+
+//! Local verification of the proofs of work submitted by eth_submitWork for the work packages handed out by eth_getWork,
+//! so that an invalid solution is rejected on the worker pool without reaching the remote miner
+class WorkVerifier {
+public:
+    //! The maximum number of recent work packages remembered
+    static constexpr std::size_t kMaxWorkPackages{16};
+
+    explicit WorkVerifier(boost::asio::thread_pool& workers, std::size_t max_epochs = EpochCache::kDefaultMaxEpochs);
+
+    WorkVerifier(const WorkVerifier&) = delete;
+    WorkVerifier& operator=(const WorkVerifier&) = delete;
+
+    //! Remember the work package handed out, prefetching the context of its epoch
+    void add_work(const evmc::bytes32& header_hash, const evmc::bytes32& target, uint64_t block_number);
+
+    //! Verify the solution of the work package on the workers: return nothing if the work package is unknown
+    boost::asio::awaitable<std::optional<bool>> verify(uint64_t nonce, const evmc::bytes32& header_hash, const evmc::bytes32& mix_digest);
+
+    EpochCache& epoch_cache() noexcept { return epoch_cache_; }
+
+    //! Return true if the ethash of the header hash and nonce gives the mix digest and does not exceed the target
+    static bool verify(const ::ethash::epoch_context& context, uint64_t nonce, const evmc::bytes32& header_hash,
+        const evmc::bytes32& mix_digest, const evmc::bytes32& target);
+
+private:
+    struct WorkPackage {
+        evmc::bytes32 target;
+        uint64_t block_number{0};
+        uint64_t sequence{0};
+    };
+
+    boost::asio::thread_pool& workers_;
+    EpochCache epoch_cache_;
+    std::mutex mutex_;
+    std::map<evmc::bytes32, WorkPackage> work_packages_;
+    uint64_t sequence_{0};
+};
+
+} // namespace silkrpc::ethash
+
+#endif // SILKRPC_CONSENSUS_ETHASH_VERIFIER_HPP_
@@ -0,0 +1,105 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "ethash_verifier.hpp"
+
+#include <cstring>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/use_future.hpp>
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+
+namespace silkrpc::ethash {
+
+using evmc::literals::operator""_bytes32;
+
+static const evmc::bytes32 kHeaderHash{0x2a8de2adf89af77358250bf908bf04ba94a6e8c3ba87775564a41d269a05e4ce_bytes32};
+static const evmc::bytes32 kMaxTarget{0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff_bytes32};
+static constexpr uint64_t kNonce{0x4242424242424242};
+
+TEST_CASE("EpochCache::epoch_of", "[silkrpc][consensus][ethash_verifier]") {
+    CHECK(EpochCache::epoch_of(0) == 0);
+    CHECK(EpochCache::epoch_of(29'999) == 0);
+    CHECK(EpochCache::epoch_of(30'000) == 1);
+    CHECK(EpochCache::epoch_of(15'537'393) == 517);
+}
+
+TEST_CASE("EpochCache::get", "[silkrpc][consensus][ethash_verifier]") {
+    boost::asio::thread_pool workers{2};
+    boost::asio::thread_pool callers{1};
+    EpochCache epoch_cache{workers, 2};
+    CHECK(!epoch_cache.contains(0));
+
+    auto result1 = boost::asio::co_spawn(callers, epoch_cache.get(0), boost::asio::use_future);
+    auto result2 = boost::asio::co_spawn(callers, epoch_cache.get(0), boost::asio::use_future);
+    const auto context = result1.get();
+    REQUIRE(context);
+    CHECK(context->epoch_number == 0);
+    CHECK(result2.get() == context);
+    CHECK(epoch_cache.contains(0));
+    CHECK(epoch_cache.size() == 2); // the next epoch is being prefetched
+}
+
+TEST_CASE("WorkVerifier::verify", "[silkrpc][consensus][ethash_verifier]") {
+    boost::asio::thread_pool workers{2};
+    boost::asio::thread_pool callers{1};
+    WorkVerifier work_verifier{workers};
+
+    auto context = boost::asio::co_spawn(callers, work_verifier.epoch_cache().get(0), boost::asio::use_future).get();
+    ::ethash::hash256 header_hash;
+    std::memcpy(header_hash.bytes, kHeaderHash.bytes, sizeof(header_hash.bytes));
+    const auto result = ::ethash::hash(*context, header_hash, kNonce);
+    evmc::bytes32 mix_digest;
+    std::memcpy(mix_digest.bytes, result.mix_hash.bytes, sizeof(mix_digest.bytes));
+    evmc::bytes32 final_hash;
+    std::memcpy(final_hash.bytes, result.final_hash.bytes, sizeof(final_hash.bytes));
+
+    SECTION("unknown work package") {
+        auto valid = boost::asio::co_spawn(callers, work_verifier.verify(kNonce, kHeaderHash, mix_digest), boost::asio::use_future);
+        CHECK(!valid.get());
+    }
+
+    SECTION("valid solution") {
+        work_verifier.add_work(kHeaderHash, kMaxTarget, 1);
+        auto valid = boost::asio::co_spawn(callers, work_verifier.verify(kNonce, kHeaderHash, mix_digest), boost::asio::use_future);
+        CHECK(valid.get() == true);
+        CHECK(WorkVerifier::verify(*context, kNonce, kHeaderHash, mix_digest, final_hash));
+    }
+
+    SECTION("wrong mix digest") {
+        work_verifier.add_work(kHeaderHash, kMaxTarget, 1);
+        auto valid = boost::asio::co_spawn(callers, work_verifier.verify(kNonce, kHeaderHash, final_hash), boost::asio::use_future);
+        CHECK(valid.get() == false);
+    }
+
+    SECTION("final hash above target") {
+        CHECK(!WorkVerifier::verify(*context, kNonce, kHeaderHash, mix_digest, evmc::bytes32{}));
+    }
+
+    SECTION("oldest work package forgotten") {
+        work_verifier.add_work(kHeaderHash, kMaxTarget, 1);
+        for (std::size_t i{0}; i < WorkVerifier::kMaxWorkPackages; ++i) {
+            evmc::bytes32 header{};
+            header.bytes[0] = static_cast<uint8_t>(i + 1);
+            work_verifier.add_work(header, kMaxTarget, 1);
+        }
+        auto valid = boost::asio::co_spawn(callers, work_verifier.verify(kNonce, kHeaderHash, mix_digest), boost::asio::use_future);
+        CHECK(!valid.get());
+    }
+}
+
+} // namespace silkrpc::ethash
@@ -16,9 +16,14 @@
 
 #include "account_dumper.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <exception>
 #include <sstream>
 #include <utility>
 
+#include <boost/asio/this_coro.hpp>
+
 #include <silkworm/core/silkworm/common/endian.hpp>
 #include <silkworm/core/silkworm/trie/hash_builder.hpp>
 #include <silkworm/core/silkworm/trie/nibbles.hpp>
@@ -26,8 +31,10 @@
 #include <silkworm/node/silkworm/db/bitmap.hpp>
 #include <silkworm/node/silkworm/db/util.hpp>
 
+#include <silkrpc/common/constants.hpp>
 #include <silkrpc/common/log.hpp>
 #include <silkrpc/common/util.hpp>
+#include <silkrpc/concurrency/parallel_for.hpp>
 #include <silkrpc/core/cached_chain.hpp>
 #include <silkrpc/core/account_walker.hpp>
 #include <silkrpc/core/rawdb/chain.hpp>
@@ -42,19 +49,54 @@ namespace silkrpc {
 
 boost::asio::awaitable<DumpAccounts> AccountDumper::dump_accounts(BlockCache& cache, const BlockNumberOrHash& bnoh, const evmc::address& start_address, int16_t max_result,
                                                            bool exclude_code, bool exclude_storage) {
-    DumpAccounts dump_accounts;
-    ethdb::TransactionDatabase tx_database{transaction_};
+    AccountRangeSession session;
+    session.next = start_address;
+    session.exclude_code = exclude_code;
+    session.exclude_storage = exclude_storage;
+    co_return co_await dump_accounts(cache, bnoh, session, max_result);
+}
+
+boost::asio::awaitable<DumpAccounts> AccountDumper::dump_accounts(BlockCache& cache, const BlockNumberOrHash& bnoh, AccountRangeSession& session, int16_t max_result) {
+    DumpAccounts dump;
+    co_await dump_accounts(cache, bnoh, session, max_result, [&](DumpAccounts& window) -> boost::asio::awaitable<void> {
+        dump.root = window.root;
+        dump.next = window.next;
+        dump.accounts.merge(window.accounts);
+        co_return;
+    });
+    co_return dump;
+}
 
-    const auto block_with_hash = co_await core::read_block_by_number_or_hash(cache, tx_database, bnoh);
-    const auto block_number = block_with_hash.block.header.number;
+boost::asio::awaitable<void> AccountDumper::dump_accounts(BlockCache& cache, const BlockNumberOrHash& bnoh, const evmc::address& start_address, int16_t max_result,
+                                                           bool exclude_code, bool exclude_storage, const AccountSink& sink) {
+    AccountRangeSession session;
+    session.next = start_address;
+    session.exclude_code = exclude_code;
+    session.exclude_storage = exclude_storage;
+    co_await dump_accounts(cache, bnoh, session, max_result, sink);
+}
+
+boost::asio::awaitable<void> AccountDumper::dump_accounts(BlockCache& cache, const BlockNumberOrHash& bnoh, AccountRangeSession& session, int16_t max_result,
+                                                           const AccountSink& sink) {
+    // The block is resolved just once per session, so that all the pages are dumped at the same state
+    if (!session.walker) {
+        ethdb::TransactionDatabase tx_database{transaction_};
+        const auto block_with_hash = co_await core::read_block_by_number_or_hash(cache, tx_database, bnoh);
+        session.block_number = block_with_hash->block.header.number;
+        session.root = block_with_hash->block.header.state_root;
+    }
+    const auto block_number = session.block_number;
+    const auto exclude_code = session.exclude_code;
+    const auto exclude_storage = session.exclude_storage;
 
-    dump_accounts.root = block_with_hash.block.header.state_root;
+    DumpAccounts window;
+    window.root = session.root;
 
     std::vector<silkrpc::KeyValue> collected_data;
 
     AccountWalker::Collector collector = [&](silkworm::ByteView k, silkworm::ByteView v) {
         if (max_result > 0 && collected_data.size() >= max_result) {
-            dump_accounts.next = silkworm::to_evmc_address(k);
+            window.next = silkworm::to_evmc_address(k);
             return false;
         }
 
@@ -69,87 +111,113 @@ boost::asio::awaitable<DumpAccounts> AccountDumper::dump_accounts(BlockCache& ca
         return true;
     };
 
-    AccountWalker walker{transaction_};
-    co_await walker.walk_of_accounts(block_number + 1, start_address, collector);
+    if (!session.walker) {
+        session.walker = std::make_unique<AccountWalker>(transaction_);
+        co_await session.walker->walk_of_accounts(block_number + 1, session.next, collector);
+    } else {
+        co_await session.walker->resume(collector);
+    }
+    session.next = window.next;
 
-    co_await load_accounts(tx_database, collected_data, dump_accounts, exclude_code);
-    if (!exclude_storage) {
-        co_await load_storage(block_number, dump_accounts);
+    if (collected_data.empty()) {
+        co_await sink(window);
+        co_return;
     }
 
-    co_return dump_accounts;
-}
+    // Load the accounts window after window, the ones in the same window concurrently if each can have its own transaction
+    const auto executor = co_await boost::asio::this_coro::executor;
+    for (std::size_t window_begin{0}; window_begin < collected_data.size(); window_begin += kAccountDumpMaxConcurrentAccounts) {
+        const auto window_size = std::min(kAccountDumpMaxConcurrentAccounts, collected_data.size() - window_begin);
+        std::vector<DumpAccount> loaded_accounts(window_size);
+        co_await parallel_for(executor, window_size, database_ ? window_size : 1, [&](std::size_t i) -> boost::asio::awaitable<void> {
+            const auto& kv = collected_data[window_begin + i];
+            if (!database_) {
+                co_await load_account(transaction_, block_number, kv, loaded_accounts[i], exclude_code, exclude_storage);
+                co_return;
+            }
+            auto account_tx = co_await database_->begin();
+            std::exception_ptr account_exception;
+            try {
+                co_await load_account(*account_tx, block_number, kv, loaded_accounts[i], exclude_code, exclude_storage);
+            } catch (...) {
+                account_exception = std::current_exception();
+            }
+            co_await account_tx->close(); // RAII not (yet) available with coroutines
+            if (account_exception) {
+                std::rethrow_exception(account_exception);
+            }
+        });
 
-boost::asio::awaitable<void> AccountDumper::load_accounts(ethdb::TransactionDatabase& tx_database,
-    const std::vector<silkrpc::KeyValue>& collected_data, DumpAccounts& dump_accounts, bool exclude_code) {
+        window.accounts.clear();
+        for (std::size_t i{0}; i < window_size; ++i) {
+            window.accounts.emplace(silkworm::to_evmc_address(collected_data[window_begin + i].key), std::move(loaded_accounts[i]));
+        }
+        co_await sink(window);
+    }
+}
 
-    StateReader state_reader{tx_database};
-    for (auto kv : collected_data) {
-        const auto address = silkworm::to_evmc_address(kv.key);
+boost::asio::awaitable<void> AccountDumper::load_account(ethdb::Transaction& transaction, uint64_t block_number, const silkrpc::KeyValue& kv,
+    DumpAccount& dump_account, bool exclude_code, bool exclude_storage) {
+    ethdb::TransactionDatabase tx_database{transaction};
+    const auto address = silkworm::to_evmc_address(kv.key);
 
-        auto [account, err]{silkworm::Account::from_encoded_storage(kv.value)};
-        silkworm::rlp::success_or_throw(err);
+    auto [account, err]{silkworm::Account::from_encoded_storage(kv.value)};
+    silkworm::rlp::success_or_throw(err);
 
-        DumpAccount dump_account;
-        dump_account.balance = account.balance;
-        dump_account.nonce = account.nonce;
-        dump_account.code_hash = account.code_hash;
-        dump_account.incarnation = account.incarnation;
+    dump_account.balance = account.balance;
+    dump_account.nonce = account.nonce;
+    dump_account.code_hash = account.code_hash;
+    dump_account.incarnation = account.incarnation;
 
-        if (account.incarnation > 0 && account.code_hash == silkworm::kEmptyHash) {
-            const auto storage_key{silkworm::db::storage_prefix(full_view(address), account.incarnation)};
-            auto code_hash{co_await tx_database.get_one(db::table::kPlainContractCode, storage_key)};
-            if (code_hash.length() == silkworm::kHashLength) {
-                std::memcpy(dump_account.code_hash.bytes, code_hash.data(), silkworm::kHashLength);
-            }
+    if (account.incarnation > 0 && account.code_hash == silkworm::kEmptyHash) {
+        const auto storage_key{silkworm::db::storage_prefix(full_view(address), account.incarnation)};
+        auto code_hash{co_await tx_database.get_one(db::table::kPlainContractCode, storage_key)};
+        if (code_hash.length() == silkworm::kHashLength) {
+            std::memcpy(dump_account.code_hash.bytes, code_hash.data(), silkworm::kHashLength);
         }
-        if (!exclude_code) {
-            auto code = co_await state_reader.read_code(account.code_hash);
-            dump_account.code.swap(code);
-        }
-        dump_accounts.accounts.insert(std::pair<evmc::address, DumpAccount>(address, dump_account));
     }
-
-    co_return;
+    if (!exclude_code) {
+        StateReader state_reader{tx_database};
+        auto code = co_await state_reader.read_code(account.code_hash);
+        dump_account.code.swap(code);
+    }
+    if (!exclude_storage) {
+        co_await load_storage(transaction, block_number, address, dump_account);
+    }
 }
 
-boost::asio::awaitable<void> AccountDumper::load_storage(uint64_t block_number, DumpAccounts& dump_accounts) {
-    SILKRPC_TRACE << "block_number " << block_number << " START\n";
-    StorageWalker storage_walker{transaction_};
+boost::asio::awaitable<void> AccountDumper::load_storage(ethdb::Transaction& transaction, uint64_t block_number, const evmc::address& address, DumpAccount& account) {
+    SILKRPC_TRACE << "block_number " << block_number << " address " << address << " START\n";
+    StorageWalker storage_walker{transaction};
     evmc::bytes32 start_location{};
-    for (AccountsMap::iterator itr = dump_accounts.accounts.begin(); itr != dump_accounts.accounts.end(); itr++) {
-        auto& address = itr->first;
-        auto& account = itr->second;
-
-        std::map<silkworm::Bytes, silkworm::Bytes> collected_entries;
-        StorageWalker::AccountCollector collector = [&](const evmc::address& address, silkworm::ByteView loc, silkworm::ByteView data) {
-            if (!account.storage.has_value()) {
-                account.storage = Storage{};
-            }
-            auto& storage = *account.storage;
-            storage[silkworm::to_bytes32(loc)] = data;
-            auto hash = hash_of(loc);
-            auto key = full_view(hash);
-            collected_entries[silkworm::Bytes{key}] = data;
 
-            return true;
-        };
+    std::map<silkworm::Bytes, silkworm::Bytes> collected_entries;
+    StorageWalker::AccountCollector collector = [&](const evmc::address& address, silkworm::ByteView loc, silkworm::ByteView data) {
+        if (!account.storage.has_value()) {
+            account.storage = Storage{};
+        }
+        auto& storage = *account.storage;
+        storage[silkworm::to_bytes32(loc)] = data;
+        auto hash = hash_of(loc);
+        auto key = full_view(hash);
+        collected_entries[silkworm::Bytes{key}] = data;
 
-        co_await storage_walker.walk_of_storages(block_number, address, start_location, account.incarnation, collector);
+        return true;
+    };
 
-        silkworm::trie::HashBuilder hb;
-        for (const auto& [key, value] : collected_entries) {
-            silkworm::Bytes encoded{};
-            silkworm::rlp::encode(encoded, value);
-            silkworm::Bytes unpacked = silkworm::trie::unpack_nibbles(key);
+    co_await storage_walker.walk_of_storages(block_number, address, start_location, account.incarnation, collector);
 
-            hb.add_leaf(unpacked, encoded);
-        }
+    silkworm::trie::HashBuilder hb;
+    for (const auto& [key, value] : collected_entries) {
+        silkworm::Bytes encoded{};
+        silkworm::rlp::encode(encoded, value);
+        silkworm::Bytes unpacked = silkworm::trie::unpack_nibbles(key);
 
-        account.root = hb.root_hash();
+        hb.add_leaf(unpacked, encoded);
     }
-    SILKRPC_TRACE << "block_number " << block_number << " END\n";
-    co_return;
+
+    account.root = hb.root_hash();
+    SILKRPC_TRACE << "block_number " << block_number << " address " << address << " END\n";
 }
 
 } // namespace silkrpc
@@ -17,6 +17,7 @@
 #ifndef SILKRPC_CORE_ACCOUNT_DUMPER_HPP_
 #define SILKRPC_CORE_ACCOUNT_DUMPER_HPP_
 
+#include <functional>
 #include <optional>
 #include <map>
 #include <vector>
@@ -30,6 +31,7 @@
 #include <silkworm/types/account.hpp>
 
 #include <silkrpc/common/util.hpp>
+#include <silkrpc/core/account_range_sessions.hpp>
 #include <silkrpc/core/cached_chain.hpp>
 #include <silkrpc/core/rawdb/accessors.hpp>
 #include <silkrpc/ethdb/cursor.hpp>
@@ -42,7 +44,13 @@ namespace silkrpc {
 
 class AccountDumper {
 public:
-    explicit AccountDumper(silkrpc::ethdb::Transaction& transaction) : transaction_(transaction) {}
+    //! Consumer of the dumped accounts, given in consecutive windows in ascending order of address
+    using AccountSink = std::function<boost::asio::awaitable<void>(DumpAccounts& window)>;
+
+    //! If the database is specified, the accounts in each window are loaded concurrently each one within its own transaction
+    //! (the transaction cursors cannot be shared by concurrent walks), otherwise one after another within the given transaction
+    explicit AccountDumper(silkrpc::ethdb::Transaction& transaction, silkrpc::ethdb::Database* database = nullptr)
+    : transaction_(transaction), database_(database) {}
 
     AccountDumper(const AccountDumper&) = delete;
     AccountDumper& operator=(const AccountDumper&) = delete;
@@ -50,11 +58,26 @@ public:
     boost::asio::awaitable<DumpAccounts> dump_accounts(BlockCache& cache, const BlockNumberOrHash& bnoh, const evmc::address& start_address, int16_t max_result,
                                                 bool exclude_code, bool exclude_storage);
 
+    //! Dump the accounts passing them to the sink one window at a time, so that just one window is loaded in memory: the sink
+    //! is called at least once (with no accounts if none is found) and every window has the same root and next
+    boost::asio::awaitable<void> dump_accounts(BlockCache& cache, const BlockNumberOrHash& bnoh, const evmc::address& start_address, int16_t max_result,
+                                                bool exclude_code, bool exclude_storage, const AccountSink& sink);
+
+    boost::asio::awaitable<DumpAccounts> dump_accounts(BlockCache& cache, const BlockNumberOrHash& bnoh, AccountRangeSession& session, int16_t max_result);
+
+    //! Dump the next page of the accounts walked by the session, resuming its walker where the previous page stopped or
+    //! starting it at the block and the session next address if not started yet (the dumper transaction must be the session
+    //! one, if any): the session next address is updated to the first account of the following page
+    boost::asio::awaitable<void> dump_accounts(BlockCache& cache, const BlockNumberOrHash& bnoh, AccountRangeSession& session, int16_t max_result,
+                                                const AccountSink& sink);
+
 private:
-    boost::asio::awaitable<void> load_accounts(ethdb::TransactionDatabase& tx_database, const std::vector<silkrpc::KeyValue>& collected_data, DumpAccounts& dump_accounts, bool exclude_code);
-    boost::asio::awaitable<void> load_storage(uint64_t block_number, DumpAccounts& dump_accounts);
+    boost::asio::awaitable<void> load_account(ethdb::Transaction& transaction, uint64_t block_number, const silkrpc::KeyValue& kv,
+                                              DumpAccount& dump_account, bool exclude_code, bool exclude_storage);
+    boost::asio::awaitable<void> load_storage(ethdb::Transaction& transaction, uint64_t block_number, const evmc::address& address, DumpAccount& account);
 
     silkrpc::ethdb::Transaction& transaction_;
+    silkrpc::ethdb::Database* database_;
 };
 
 } // namespace silkrpc
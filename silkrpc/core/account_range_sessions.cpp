@@ -0,0 +1,142 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "account_range_sessions.hpp"
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <utility>
+
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/json/writer.hpp>
+
+namespace silkrpc {
+
+bool AccountRangeSession::continues(const evmc::address& start_address, bool excluding_code, bool excluding_storage) const {
+    return walker && !walker->done() && next == start_address && exclude_code == excluding_code && exclude_storage == excluding_storage;
+}
+
+AccountRangeSessions::AccountRangeSessions(std::chrono::steady_clock::duration session_timeout, std::size_t max_sessions)
+    : session_timeout_{session_timeout}, max_sessions_{std::max<std::size_t>(max_sessions, 1)}, token_generator_{std::random_device{}()} {}
+
+AccountRangeSessionPtr AccountRangeSessions::take(const std::string& token) {
+    std::lock_guard lock{mutex_};
+    const auto it = sessions_.find(token);
+    if (it == sessions_.end()) {
+        return nullptr;
+    }
+    auto session = std::move(it->second);
+    sessions_.erase(it);
+    return session;
+}
+
+std::string AccountRangeSessions::park(AccountRangeSessionPtr session, std::vector<AccountRangeSessionPtr>& evicted) {
+    std::lock_guard lock{mutex_};
+
+    std::string token;
+    do {
+        std::array<uint8_t, 16> token_bytes{};
+        for (std::size_t i{0}; i < token_bytes.size(); i += sizeof(uint64_t)) {
+            const auto random = token_generator_();
+            std::copy_n(reinterpret_cast<const uint8_t*>(&random), sizeof(uint64_t), token_bytes.data() + i);
+        }
+        token.clear();
+        write_hex(token, {token_bytes.data(), token_bytes.size()});
+    } while (sessions_.contains(token));
+
+    // Make room evicting the least recently parked sessions, which are the least likely to be continued
+    while (sessions_.size() >= max_sessions_) {
+        const auto oldest = std::min_element(sessions_.begin(), sessions_.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.second->last_use < rhs.second->last_use;
+        });
+        SILKRPC_DEBUG << "AccountRangeSessions::park evicted token: " << oldest->first << "\n";
+        evicted.push_back(std::move(oldest->second));
+        sessions_.erase(oldest);
+    }
+
+    session->last_use = std::chrono::steady_clock::now();
+    sessions_.emplace(token, std::move(session));
+    SILKRPC_DEBUG << "AccountRangeSessions::park token: " << token << " #sessions: " << sessions_.size() << "\n";
+    return token;
+}
+
+std::vector<AccountRangeSessionPtr> AccountRangeSessions::expire(std::chrono::steady_clock::time_point now) {
+    std::lock_guard lock{mutex_};
+
+    std::vector<AccountRangeSessionPtr> expired;
+    for (auto it = sessions_.begin(); it != sessions_.end();) {
+        if (now - it->second->last_use >= session_timeout_) {
+            SILKRPC_DEBUG << "AccountRangeSessions::expire token: " << it->first << "\n";
+            expired.push_back(std::move(it->second));
+            it = sessions_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return expired;
+}
+
+std::size_t AccountRangeSessions::size() const {
+    std::lock_guard lock{mutex_};
+    return sessions_.size();
+}
+
+boost::asio::awaitable<void> AccountRangeSessions::close(std::vector<AccountRangeSessionPtr>& sessions) {
+    for (auto& session : sessions) {
+        if (!session->transaction) {
+            continue;
+        }
+        try {
+            co_await session->transaction->close(); // RAII not (yet) available with coroutines
+        } catch (const std::exception& e) {
+            SILKRPC_WARN << "AccountRangeSessions::close exception: " << e.what() << "\n";
+        }
+    }
+    sessions.clear();
+}
+
+boost::asio::awaitable<void> AccountRangeSessions::sweep(std::shared_ptr<AccountRangeSessions> sessions) {
+    {
+        std::lock_guard lock{sessions->mutex_};
+        if (sessions->sweeping_) {
+            co_return;
+        }
+        sessions->sweeping_ = true;
+    }
+
+    boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor};
+    while (true) {
+        timer.expires_after(sessions->session_timeout_);
+        co_await timer.async_wait(boost::asio::use_awaitable);
+
+        auto expired = sessions->expire(std::chrono::steady_clock::now());
+        co_await close(expired);
+
+        std::lock_guard lock{sessions->mutex_};
+        if (sessions->sessions_.empty()) {
+            sessions->sweeping_ = false;
+            co_return;
+        }
+    }
+}
+
+} // namespace silkrpc
@@ -0,0 +1,125 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_CORE_ACCOUNT_RANGE_SESSIONS_HPP_
+#define SILKRPC_CORE_ACCOUNT_RANGE_SESSIONS_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <silkrpc/config.hpp> // NOLINT(build/include_order)
+
+#include <boost/asio/awaitable.hpp>
+#include <evmc/evmc.hpp>
+
+#include <silkrpc/core/account_walker.hpp>
+#include <silkrpc/ethdb/transaction.hpp>
+
+namespace silkrpc {
+
+//! The walk of the accounts paged by debug_accountRange, kept open across the pages within its own transaction so that
+//! each page resumes from the cursors positioned by the previous one, instead of opening a transaction and seeking again
+struct AccountRangeSession {
+    //! The transaction the walk is opened in, owned by the session (if any) until closed
+    std::unique_ptr<ethdb::Transaction> transaction;
+
+    //! The walker positioned at the first account of the next page, once started
+    std::unique_ptr<AccountWalker> walker;
+
+    //! The block the accounts are walked at, resolved by the first page
+    uint64_t block_number{0};
+    evmc::bytes32 root{};
+
+    //! The address of the first account of the next page (the start address before the first page)
+    evmc::address next{};
+
+    bool exclude_code{false};
+    bool exclude_storage{false};
+
+    //! The time the session has been parked at
+    std::chrono::steady_clock::time_point last_use{};
+
+    //! Check if the page starting at the address with the same exclusions continues the session
+    bool continues(const evmc::address& start_address, bool excluding_code, bool excluding_storage) const;
+};
+
+using AccountRangeSessionPtr = std::unique_ptr<AccountRangeSession>;
+
+//! The sessions of debug_accountRange parked between pages, identified by opaque continuation tokens and safe for
+//! concurrent use. The sessions hold open transactions, so they are bound to the context they have been opened in,
+//! are few and expire soon: the sessions taken out of the registry must be closed by the caller.
+class AccountRangeSessions {
+  public:
+    //! The default time after which a session not continued anymore is closed
+    static constexpr std::chrono::seconds kDefaultSessionTimeout{30};
+
+    //! The default maximum number of parked sessions, the least recently used one is closed when exceeded
+    static constexpr std::size_t kDefaultMaxSessions{16};
+
+    explicit AccountRangeSessions(std::chrono::steady_clock::duration session_timeout = kDefaultSessionTimeout,
+                                  std::size_t max_sessions = kDefaultMaxSessions);
+
+    AccountRangeSessions(const AccountRangeSessions&) = delete;
+    AccountRangeSessions& operator=(const AccountRangeSessions&) = delete;
+
+    //! Take the session parked with the token, if any, so that it serves just one page at a time
+    AccountRangeSessionPtr take(const std::string& token);
+
+    //! Park the session until its next page returning its new token, adding to evicted the sessions to be closed
+    std::string park(AccountRangeSessionPtr session, std::vector<AccountRangeSessionPtr>& evicted);
+
+    //! Remove the sessions parked since the session timeout before the specified time, returning them to be closed
+    std::vector<AccountRangeSessionPtr> expire(std::chrono::steady_clock::time_point now);
+
+    std::size_t size() const;
+
+    //! Close the transactions of the specified sessions
+    static boost::asio::awaitable<void> close(std::vector<AccountRangeSessionPtr>& sessions);
+
+    //! Close the expired sessions periodically as long as any session is parked, to be spawned after parking one:
+    //! nothing is done if the sessions are already being swept
+    static boost::asio::awaitable<void> sweep(std::shared_ptr<AccountRangeSessions> sessions);
+
+  private:
+    //! The timeout after which the sessions not continued anymore are closed
+    std::chrono::steady_clock::duration session_timeout_;
+
+    std::size_t max_sessions_;
+
+    //! Protect the sessions from concurrent access by request handlers and sweeper
+    mutable std::mutex mutex_;
+
+    //! The parked sessions by token
+    std::map<std::string, AccountRangeSessionPtr> sessions_;
+
+    //! Flag indicating if the sessions are being swept
+    bool sweeping_{false};
+
+    //! The generator of unpredictable tokens
+    std::mt19937_64 token_generator_;
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_CORE_ACCOUNT_RANGE_SESSIONS_HPP_
@@ -0,0 +1,96 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "account_range_sessions.hpp"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+
+namespace silkrpc {
+
+using evmc::literals::operator""_address;
+
+static AccountRangeSessionPtr make_session(const evmc::address& next) {
+    auto session = std::make_unique<AccountRangeSession>();
+    session->next = next;
+    return session;
+}
+
+TEST_CASE("AccountRangeSessions park and take", "[silkrpc][core][account_range_sessions]") {
+    const auto address1{0x79a4d418f7887dd4d5123a41b6c8c186686ae8cb_address};
+    const auto address2{0x79a4d706e4bc7fd8ff9d0593a1311386a7a981ea_address};
+    AccountRangeSessions sessions;
+    std::vector<AccountRangeSessionPtr> evicted;
+
+    const auto token1 = sessions.park(make_session(address1), evicted);
+    const auto token2 = sessions.park(make_session(address2), evicted);
+    CHECK(token1.starts_with("0x"));
+    CHECK(token1.size() == 34);
+    CHECK(token1 != token2);
+    CHECK(sessions.size() == 2);
+    CHECK(evicted.empty());
+
+    auto session1 = sessions.take(token1);
+    REQUIRE(session1);
+    CHECK(session1->next == address1);
+    CHECK(!sessions.take(token1));
+    CHECK(!sessions.take("0x1234"));
+    CHECK(sessions.size() == 1);
+
+    // Parking again the same session gives a new token
+    const auto token3 = sessions.park(std::move(session1), evicted);
+    CHECK(token3 != token1);
+    CHECK(sessions.size() == 2);
+}
+
+TEST_CASE("AccountRangeSessions evict the least recently parked", "[silkrpc][core][account_range_sessions]") {
+    AccountRangeSessions sessions{AccountRangeSessions::kDefaultSessionTimeout, 2};
+    std::vector<AccountRangeSessionPtr> evicted;
+
+    const auto token1 = sessions.park(make_session(0x01_address), evicted);
+    const auto token2 = sessions.park(make_session(0x02_address), evicted);
+    const auto token3 = sessions.park(make_session(0x03_address), evicted);
+    CHECK(sessions.size() == 2);
+    REQUIRE(evicted.size() == 1);
+    CHECK(evicted[0]->next == 0x01_address);
+    CHECK(!sessions.take(token1));
+    CHECK(sessions.take(token2));
+    CHECK(sessions.take(token3));
+}
+
+TEST_CASE("AccountRangeSessions expire", "[silkrpc][core][account_range_sessions]") {
+    AccountRangeSessions sessions{std::chrono::seconds{10}};
+    std::vector<AccountRangeSessionPtr> evicted;
+
+    const auto token = sessions.park(make_session(0x01_address), evicted);
+    const auto now = std::chrono::steady_clock::now();
+    CHECK(sessions.expire(now).empty());
+    CHECK(sessions.size() == 1);
+
+    const auto expired = sessions.expire(now + std::chrono::seconds{10});
+    REQUIRE(expired.size() == 1);
+    CHECK(expired[0]->next == 0x01_address);
+    CHECK(sessions.size() == 0);
+    CHECK(!sessions.take(token));
+}
+
+} // namespace silkrpc
@@ -35,69 +35,84 @@
 namespace silkrpc {
 
 boost::asio::awaitable<void> AccountWalker::walk_of_accounts(uint64_t block_number, const evmc::address& start_address, Collector& collector) {
-    auto ps_cursor = co_await transaction_.cursor(db::table::kPlainState);
+    block_number_ = block_number;
+    done_ = true;
+    ps_cursor_ = co_await transaction_.cursor(db::table::kPlainState);
 
     auto start_key = full_view(start_address);
-    auto ps_kv = co_await seek(*ps_cursor, start_key, silkworm::kAddressLength);
-    if (ps_kv.key.empty()) {
+    ps_kv_ = co_await seek(*ps_cursor_, start_key, silkworm::kAddressLength);
+    if (ps_kv_.key.empty()) {
         co_return;
     }
 
-    auto ah_cursor = co_await transaction_.cursor(db::table::kAccountHistory);
-    silkrpc::ethdb::SplitCursor split_cursor{*ah_cursor, start_key, 0, silkworm::kAddressLength,
-        silkworm::kAddressLength, silkworm::kAddressLength + 8};
+    ah_cursor_ = co_await transaction_.cursor(db::table::kAccountHistory);
+    split_cursor_ = std::make_unique<silkrpc::ethdb::SplitCursor>(*ah_cursor_, start_key, 0, silkworm::kAddressLength,
+        silkworm::kAddressLength, silkworm::kAddressLength + 8);
 
-    auto s_kv = co_await seek(split_cursor, block_number);
+    s_kv_ = co_await seek(*split_cursor_, block_number);
 
-    auto acs_cursor = co_await transaction_.cursor_dup_sort(db::table::kPlainAccountChangeSet);
+    acs_cursor_ = co_await transaction_.cursor_dup_sort(db::table::kPlainAccountChangeSet);
 
+    done_ = false;
+    co_await walk(collector);
+}
+
+boost::asio::awaitable<void> AccountWalker::resume(Collector& collector) {
+    if (done_) {
+        co_return;
+    }
+    co_await walk(collector);
+}
+
+boost::asio::awaitable<void> AccountWalker::walk(Collector& collector) {
     auto go_on = true;
     while (go_on) {
-        if (ps_kv.key.empty() && s_kv.key1.empty()) {
+        if (ps_kv_.key.empty() && s_kv_.key1.empty()) {
+            done_ = true;
             break;
         }
-        auto cmp = ps_kv.key.compare(s_kv.key1);
+        auto cmp = ps_kv_.key.compare(s_kv_.key1);
         if (cmp < 0) {
-            go_on = collector(ps_kv.key, ps_kv.value);
+            go_on = collector(ps_kv_.key, ps_kv_.value);
         } else {
-            const auto bitmap = silkworm::db::bitmap::parse(s_kv.value);
-            uint64_t* ans = new uint64_t[bitmap.cardinality()];
-            bitmap.toUint64Array(ans);
+            const auto bitmap = silkworm::db::bitmap::parse(s_kv_.value);
 
             std::optional<silkworm::Account> result;
-            const auto found = silkworm::db::bitmap::seek(bitmap, block_number);
+            const auto found = silkworm::db::bitmap::seek(bitmap, block_number_);
             if (found) {
                 const auto block_key{silkworm::db::block_key(found.value())};
-                auto data = co_await acs_cursor->seek_both(block_key, s_kv.key1);
+                auto data = co_await acs_cursor_->seek_both(block_key, s_kv_.key1);
 
                 if (data.size() > silkworm::kAddressLength) {
                     data = data.substr(silkworm::kAddressLength);
-                    go_on = collector(s_kv.key1, data);
+                    go_on = collector(s_kv_.key1, data);
                 } else {
                 }
             } else if (cmp == 0) {
-                go_on = collector(ps_kv.key, ps_kv.value);
+                go_on = collector(ps_kv_.key, ps_kv_.value);
             }
         }
 
+        // The cursors are left at the account stopping the collector, which is the first one given when resuming
         if (go_on) {
             if (cmp <= 0) {
-                ps_kv = co_await next(*ps_cursor, silkworm::kAddressLength);
+                ps_kv_ = co_await next(*ps_cursor_, silkworm::kAddressLength);
             }
             if (cmp >= 0) {
-                auto block = silkworm::endian::load_big_u64(s_kv.key2.data());
-                s_kv = co_await next(split_cursor, block_number, block, s_kv.key1);
+                auto block = silkworm::endian::load_big_u64(s_kv_.key2.data());
+                s_kv_ = co_await next(*split_cursor_, block_number_, block, s_kv_.key1);
             }
         }
     }
 }
 
 boost::asio::awaitable<KeyValue> AccountWalker::next(silkrpc::ethdb::Cursor& cursor, uint64_t len) {
-    auto kv = co_await cursor.next();
+    // The keys skipped are just looked at, w/o copying them
+    auto kv = co_await cursor.next_view();
     while (!kv.key.empty() && kv.key.size() > len) {
-        kv = co_await cursor.next();
+        kv = co_await cursor.next_view();
     }
-    co_return kv;
+    co_return KeyValue{silkworm::Bytes{kv.key}, silkworm::Bytes{kv.value}};
 }
 
 boost::asio::awaitable<KeyValue> AccountWalker::seek(silkrpc::ethdb::Cursor& cursor, silkworm::ByteView key, uint64_t len) {
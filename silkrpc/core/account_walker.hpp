@@ -17,6 +17,7 @@
 #ifndef SILKRPC_CORE_ACCOUNT_WALKER_HPP_
 #define SILKRPC_CORE_ACCOUNT_WALKER_HPP_
 
+#include <memory>
 #include <optional>
 #include <map>
 
@@ -45,15 +46,35 @@ public:
     AccountWalker(const AccountWalker&) = delete;
     AccountWalker& operator=(const AccountWalker&) = delete;
 
+    //! Walk the accounts from the start address until the collector stops, keeping the cursors positioned at the account
+    //! stopping it so that the walk can be resumed from there within the same transaction
     boost::asio::awaitable<void> walk_of_accounts(uint64_t block_number, const evmc::address& start_address, Collector& collector);
 
+    //! Resume the last walk from the account stopping its collector (passed again to the collector), w/o seeking again
+    boost::asio::awaitable<void> resume(Collector& collector);
+
+    //! Check if the last walk has reached the end of the accounts
+    bool done() const noexcept { return done_; }
+
 private:
+    boost::asio::awaitable<void> walk(Collector& collector);
+
     boost::asio::awaitable<KeyValue> next(silkrpc::ethdb::Cursor& cursor, uint64_t len);
     boost::asio::awaitable<KeyValue> seek(silkrpc::ethdb::Cursor& cursor, const silkworm::ByteView key, uint64_t len);
     boost::asio::awaitable<silkrpc::ethdb::SplittedKeyValue> next(silkrpc::ethdb::SplitCursor& cursor, uint64_t number, uint64_t block, silkworm::Bytes addr);
     boost::asio::awaitable<silkrpc::ethdb::SplittedKeyValue> seek(silkrpc::ethdb::SplitCursor& cursor, uint64_t number);
 
     silkrpc::ethdb::Transaction& transaction_;
+
+    //! The position of the last walk, i.e. the cursors and the current key-value in both plain state and history
+    uint64_t block_number_{0};
+    std::shared_ptr<silkrpc::ethdb::Cursor> ps_cursor_;
+    std::shared_ptr<silkrpc::ethdb::Cursor> ah_cursor_;
+    std::unique_ptr<silkrpc::ethdb::SplitCursor> split_cursor_;
+    std::shared_ptr<silkrpc::ethdb::CursorDupSort> acs_cursor_;
+    KeyValue ps_kv_;
+    silkrpc::ethdb::SplittedKeyValue s_kv_;
+    bool done_{true};
 };
 
 } // namespace silkrpc
@@ -290,6 +290,25 @@ TEST_CASE("AccountWalker::walk_of_accounts") {
         CHECK(silkworm::to_hex(kv.key) == "79a4d75bd00b1843ec5292217e71dace5e5a7439");
         CHECK(silkworm::to_hex(kv.value) == "03010107181855facbc200");
     }
+
+    SECTION("resume after 1 account") {
+        max_result = 1;
+
+        auto result = boost::asio::co_spawn(pool, walker.walk_of_accounts(block_number, start_address, collector), boost::asio::use_future);
+        result.get();
+        CHECK(collected_data.size() == 1);
+        CHECK(!walker.done());
+
+        max_result = 3;
+        auto resumed = boost::asio::co_spawn(pool, walker.resume(collector), boost::asio::use_future);
+        resumed.get();
+        CHECK(walker.done());
+
+        CHECK(collected_data.size() == 3);
+        CHECK(silkworm::to_hex(collected_data[0].key) == "79a4d492a05cfd836ea0967edb5943161dd041f7");
+        CHECK(silkworm::to_hex(collected_data[1].key) == "79a4d706e4bc7fd8ff9d0593a1311386a7a981ea");
+        CHECK(silkworm::to_hex(collected_data[2].key) == "79a4d75bd00b1843ec5292217e71dace5e5a7439");
+    }
 }
 
 }  // namespace silkrpc
@@ -0,0 +1,235 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/use_future.hpp>
+#include <silkworm/types/block.hpp>
+
+#include <silkrpc/bench/dataset_transaction.hpp>
+#include <silkrpc/bench/kv_dataset.hpp>
+#include <silkrpc/common/allocator.hpp>
+#include <silkrpc/common/block_cache.hpp>
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/common/util.hpp>
+#include <silkrpc/core/evm_debug.hpp>
+#include <silkrpc/core/evm_executor.hpp>
+#include <silkrpc/core/evm_trace.hpp>
+#include <silkrpc/core/overlay_state.hpp>
+#include <silkrpc/core/rawdb/chain.hpp>
+#include <silkrpc/core/remote_state.hpp>
+#include <silkrpc/ethdb/transaction_database.hpp>
+
+//! Replay of the blocks in a recorded corpus through the executors, reading the state in memory so that the EVM and the
+//! tracers are measured apart from the RPC handling, the remote KV interface and the network. The corpus is the dataset
+//! recorded by the fake_backend toolbox tool while silkrpc traces the blocks (e.g. by debug_traceBlockByNumber), which
+//! reads all the state the replay needs, specified by the environment variables:
+//!   SILKRPC_BLOCK_CORPUS         the dataset file
+//!   SILKRPC_BLOCK_CORPUS_BLOCKS  the replayed block range as <first>-<last> (or just one block number)
+//! The benchmarks are skipped w/o any corpus.
+
+namespace silkrpc {
+
+//! The blocks of the corpus, their senders recovered once at load not to be accounted in the replay
+class BlockCorpus {
+public:
+    static const BlockCorpus& instance() {
+        static const BlockCorpus corpus;
+        return corpus;
+    }
+
+    const std::optional<std::string>& error() const { return error_; }
+    const bench::KvDataset& dataset() const { return dataset_; }
+    const silkworm::ChainConfig& chain_config() const { return *chain_config_; }
+    const std::vector<silkworm::Block>& blocks() const { return blocks_; }
+    uint64_t gas_used() const { return gas_used_; }
+    uint64_t num_transactions() const { return num_transactions_; }
+
+private:
+    BlockCorpus() {
+        const char* dataset_file = std::getenv("SILKRPC_BLOCK_CORPUS");
+        const char* block_range = std::getenv("SILKRPC_BLOCK_CORPUS_BLOCKS");
+        if (dataset_file == nullptr || block_range == nullptr) {
+            error_ = "no corpus: set SILKRPC_BLOCK_CORPUS and SILKRPC_BLOCK_CORPUS_BLOCKS";
+            return;
+        }
+        try {
+            dataset_ = bench::KvDataset::load(dataset_file);
+            const std::string range{block_range};
+            const auto separator = range.find('-');
+            const auto first_block = std::stoull(range.substr(0, separator));
+            const auto last_block = separator == std::string::npos ? first_block : std::stoull(range.substr(separator + 1));
+            load_blocks(first_block, last_block);
+        } catch (const std::exception& e) {
+            error_ = std::string{"invalid corpus: "} + e.what();
+        }
+    }
+
+    void load_blocks(uint64_t first_block, uint64_t last_block) {
+        boost::asio::io_context io_context;
+        bench::DatasetTransaction tx{dataset_};
+        ethdb::TransactionDatabase database{tx};
+        auto load = [&]() -> boost::asio::awaitable<void> {
+            chain_config_ = lookup_chain_config(co_await core::rawdb::read_chain_id(database));
+            for (auto block_number{first_block}; block_number <= last_block; ++block_number) {
+                const auto block_with_hash = co_await core::rawdb::read_block_by_number(database, block_number);
+                blocks_.push_back(block_with_hash.block);
+            }
+        };
+        auto loaded = boost::asio::co_spawn(io_context, load(), boost::asio::use_future);
+        io_context.run();
+        loaded.get();
+        if (chain_config_ == nullptr) {
+            throw std::runtime_error{"unknown chain"};
+        }
+        for (auto& block : blocks_) {
+            for (auto& transaction : block.transactions) {
+                if (!transaction.from) {
+                    transaction.recover_sender();
+                }
+            }
+            gas_used_ += block.header.gas_used;
+            num_transactions_ += block.transactions.size();
+        }
+    }
+
+    std::optional<std::string> error_;
+    bench::KvDataset dataset_;
+    const silkworm::ChainConfig* chain_config_{nullptr};
+    std::vector<silkworm::Block> blocks_;
+    uint64_t gas_used_{0};
+    uint64_t num_transactions_{0};
+};
+
+//! The execution context and the single worker running the replay, so that the bytes allocated by both can be read
+class ReplayContext {
+public:
+    ReplayContext() : work_guard_{io_context_.get_executor()}, context_thread_{[&]() { io_context_.run(); }} {}
+
+    ~ReplayContext() {
+        work_guard_.reset();
+        context_thread_.join();
+        workers_.join();
+    }
+
+    boost::asio::io_context& io_context() { return io_context_; }
+    boost::asio::thread_pool& workers() { return workers_; }
+
+    //! The bytes allocated so far by the context thread and the worker
+    uint64_t allocated_bytes() {
+        const auto read_allocated_bytes = []() { return thread_allocated_bytes(); };
+        auto context_bytes = boost::asio::post(io_context_, boost::asio::use_future(read_allocated_bytes));
+        auto worker_bytes = boost::asio::post(workers_, boost::asio::use_future(read_allocated_bytes));
+        return context_bytes.get() + worker_bytes.get();
+    }
+
+private:
+    boost::asio::io_context io_context_;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work_guard_;
+    std::thread context_thread_;
+    boost::asio::thread_pool workers_{1};
+};
+
+//! Replay all the corpus blocks at each iteration, reporting the gas and the transactions executed per second and the
+//! bytes allocated per transaction
+template <typename ReplayBlock>
+static void replay_blocks(benchmark::State& state, ReplayBlock replay_block) {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    const auto& corpus = BlockCorpus::instance();
+    if (corpus.error()) {
+        state.SkipWithError(corpus.error()->c_str());
+        return;
+    }
+    ReplayContext context;
+    bench::DatasetTransaction tx{corpus.dataset()};
+    ethdb::TransactionDatabase database{tx};
+
+    uint64_t allocated_bytes{0};
+    for (auto _ : state) {
+        const auto allocated_before = context.allocated_bytes();
+        for (const auto& block : corpus.blocks()) {
+            auto replayed = boost::asio::co_spawn(context.io_context(), replay_block(context, database, block), boost::asio::use_future);
+            replayed.get();
+        }
+        allocated_bytes += context.allocated_bytes() - allocated_before;
+    }
+
+    const auto iterations = static_cast<double>(state.iterations());
+    state.counters["gas/s"] = benchmark::Counter(static_cast<double>(corpus.gas_used()) * iterations, benchmark::Counter::kIsRate);
+    state.counters["txs/s"] = benchmark::Counter(static_cast<double>(corpus.num_transactions()) * iterations, benchmark::Counter::kIsRate);
+    if (corpus.num_transactions() > 0) {
+        state.counters["bytes/tx"] = static_cast<double>(allocated_bytes) / (static_cast<double>(corpus.num_transactions()) * iterations);
+    }
+}
+
+//! Execute the block transactions w/o any tracer, i.e. the baseline of the tracer overhead
+static void BM_BlockReplay_EVMExecutor(benchmark::State& state) {
+    const auto& chain_config = BlockCorpus::instance().chain_config();
+    replay_blocks(state, [&](ReplayContext& context, const core::rawdb::DatabaseReader& database,
+                             const silkworm::Block& block) -> boost::asio::awaitable<void> {
+        state::RemoteState remote_state{context.io_context(), database, block.header.number - 1};
+        state::OverlayState block_state{remote_state};
+        EVMExecutor<> executor{context.io_context(), database, chain_config, context.workers(), block.header.number - 1, remote_state, block_state};
+        for (const auto& transaction : block.transactions) {
+            co_await executor.call(block, transaction, {}, /*refund=*/false, /*gas_bailout=*/false);
+        }
+    });
+}
+BENCHMARK(BM_BlockReplay_EVMExecutor)->UseRealTime();
+
+//! Trace the block transactions as trace_replayBlockTransactions does with the config
+static void BM_BlockReplay_TraceCallExecutor(benchmark::State& state, trace::TraceConfig config) {
+    BlockCache block_cache;
+    replay_blocks(state, [&](ReplayContext& context, const core::rawdb::DatabaseReader& database,
+                             const silkworm::Block& block) -> boost::asio::awaitable<void> {
+        trace::TraceCallExecutor<> executor{context.io_context(), block_cache, database, context.workers()};
+        benchmark::DoNotOptimize(co_await executor.trace_block_transactions(block, config));
+    });
+}
+BENCHMARK_CAPTURE(BM_BlockReplay_TraceCallExecutor, trace, trace::TraceConfig{false, true, false})->UseRealTime();
+BENCHMARK_CAPTURE(BM_BlockReplay_TraceCallExecutor, vm_trace, trace::TraceConfig{true, false, false})->UseRealTime();
+BENCHMARK_CAPTURE(BM_BlockReplay_TraceCallExecutor, state_diff, trace::TraceConfig{false, false, true})->UseRealTime();
+BENCHMARK_CAPTURE(BM_BlockReplay_TraceCallExecutor, all, trace::TraceConfig{true, true, true})->UseRealTime();
+
+//! Trace the block transactions as debug_traceBlockByNumber does with the config
+static void BM_BlockReplay_DebugExecutor(benchmark::State& state, debug::DebugConfig config) {
+    replay_blocks(state, [&](ReplayContext& context, const core::rawdb::DatabaseReader& database,
+                             const silkworm::Block& block) -> boost::asio::awaitable<void> {
+        debug::DebugExecutor<> executor{context.io_context(), database, context.workers(), config};
+        benchmark::DoNotOptimize(co_await executor.execute(block));
+    });
+}
+BENCHMARK_CAPTURE(BM_BlockReplay_DebugExecutor, struct_logs, debug::DebugConfig{})->UseRealTime();
+BENCHMARK_CAPTURE(BM_BlockReplay_DebugExecutor, struct_logs_no_stack_memory_storage, debug::DebugConfig{true, true, true})->UseRealTime();
+BENCHMARK_CAPTURE(BM_BlockReplay_DebugExecutor, call_tracer, debug::DebugConfig{false, false, false, debug::kCallTracer})->UseRealTime();
+BENCHMARK_CAPTURE(BM_BlockReplay_DebugExecutor, prestate_tracer, debug::DebugConfig{false, false, false, debug::kPrestateTracer})->UseRealTime();
+
+} // namespace silkrpc
@@ -28,6 +28,22 @@ constexpr const char* kHeadBlockHash = "headBlockHash";
 constexpr const char* kFinalizedBlockHash = "finalizedBlockHash";
 constexpr const char* kSafeBlockHash = "safeBlockHash";
 
+// Return the block number of the tag cached for the view read, if any, otherwise read it and cache it for the next readers
+template <typename Read>
+static boost::asio::awaitable<uint64_t> read_cached_block_number(const core::rawdb::DatabaseReader& reader, ChainHeadTag tag, Read read) {
+    auto* chain_head_cache = reader.chain_head_cache();
+    if (chain_head_cache == nullptr) {
+        co_return co_await read();
+    }
+    const auto view_id = reader.view_id();
+    const auto cached_block_number = chain_head_cache->get(view_id, tag);
+    if (cached_block_number) {
+        co_return *cached_block_number;
+    }
+    const auto block_number = co_await read();
+    chain_head_cache->put(view_id, tag, block_number);
+    co_return block_number;
+}
 
 boost::asio::awaitable<bool> is_latest_block_number(uint64_t block_number, const core::rawdb::DatabaseReader& db_reader) {
     const auto last_executed_block_number = co_await core::get_latest_executed_block_number(db_reader);
@@ -86,57 +102,69 @@ boost::asio::awaitable<uint64_t> get_block_number(const std::string& block_id, c
 }
 
 boost::asio::awaitable<uint64_t> get_current_block_number(const core::rawdb::DatabaseReader& reader) {
-    const auto current_block_number = co_await stages::get_sync_stage_progress(reader, stages::kFinish);
-    co_return current_block_number;
+    co_return co_await read_cached_block_number(reader, ChainHeadTag::kCurrent, [&]() -> boost::asio::awaitable<uint64_t> {
+        const auto current_block_number = co_await stages::get_sync_stage_progress(reader, stages::kFinish);
+        co_return current_block_number;
+    });
 }
 
 boost::asio::awaitable<uint64_t> get_highest_block_number(const core::rawdb::DatabaseReader& reader) {
-    const auto highest_block_number = co_await stages::get_sync_stage_progress(reader, stages::kHeaders);
-    co_return highest_block_number;
+    co_return co_await read_cached_block_number(reader, ChainHeadTag::kHighest, [&]() -> boost::asio::awaitable<uint64_t> {
+        const auto highest_block_number = co_await stages::get_sync_stage_progress(reader, stages::kHeaders);
+        co_return highest_block_number;
+    });
 }
 
 boost::asio::awaitable<uint64_t> get_latest_executed_block_number(const core::rawdb::DatabaseReader& reader) {
-    const auto latest_executed_block_number = co_await stages::get_sync_stage_progress(reader, stages::kExecution);
-    co_return latest_executed_block_number;
+    co_return co_await read_cached_block_number(reader, ChainHeadTag::kLatestExecuted, [&]() -> boost::asio::awaitable<uint64_t> {
+        const auto latest_executed_block_number = co_await stages::get_sync_stage_progress(reader, stages::kExecution);
+        co_return latest_executed_block_number;
+    });
 }
 
 boost::asio::awaitable<uint64_t> get_latest_block_number(const core::rawdb::DatabaseReader& reader) {
-    const auto kv_pair = co_await reader.get(db::table::kLastForkchoice, silkworm::bytes_of_string(kHeadBlockHash));
-    const auto head_block_hash_data = kv_pair.value;
-    if (!head_block_hash_data.empty()) {
-        const auto head_block_hash = silkworm::to_bytes32(head_block_hash_data);
-        const silkworm::BlockHeader head_block_header = co_await rawdb::read_header_by_hash(reader, head_block_hash);
-        co_return head_block_header.number;
-    }
+    co_return co_await read_cached_block_number(reader, ChainHeadTag::kLatest, [&]() -> boost::asio::awaitable<uint64_t> {
+        const auto kv_pair = co_await reader.get(db::table::kLastForkchoice, silkworm::bytes_of_string(kHeadBlockHash));
+        const auto head_block_hash_data = kv_pair.value;
+        if (!head_block_hash_data.empty()) {
+            const auto head_block_hash = silkworm::to_bytes32(head_block_hash_data);
+            const silkworm::BlockHeader head_block_header = co_await rawdb::read_header_by_hash(reader, head_block_hash);
+            co_return head_block_header.number;
+        }
 
-    const auto latest_block_number = co_await stages::get_sync_stage_progress(reader, stages::kExecution);
-    co_return latest_block_number;
+        const auto latest_block_number = co_await stages::get_sync_stage_progress(reader, stages::kExecution);
+        co_return latest_block_number;
+    });
 }
 
 boost::asio::awaitable<uint64_t> get_forkchoice_finalized_block_number(const core::rawdb::DatabaseReader& reader) {
-    const auto kv_pair = co_await reader.get(db::table::kLastForkchoice, silkworm::bytes_of_string(kFinalizedBlockHash));
-    const auto finalized_block_hash_data = kv_pair.value;
-    if (finalized_block_hash_data.empty()) {
-        SILKRPC_LOG << "no finalized forkchoice block number found\n";
-        co_return 0;
-    }
-    const auto finalized_block_hash = silkworm::to_bytes32(finalized_block_hash_data);
+    co_return co_await read_cached_block_number(reader, ChainHeadTag::kFinalized, [&]() -> boost::asio::awaitable<uint64_t> {
+        const auto kv_pair = co_await reader.get(db::table::kLastForkchoice, silkworm::bytes_of_string(kFinalizedBlockHash));
+        const auto finalized_block_hash_data = kv_pair.value;
+        if (finalized_block_hash_data.empty()) {
+            SILKRPC_LOG << "no finalized forkchoice block number found\n";
+            co_return 0;
+        }
+        const auto finalized_block_hash = silkworm::to_bytes32(finalized_block_hash_data);
 
-    const auto finalized_header = co_await rawdb::read_header_by_hash(reader, finalized_block_hash);
-    co_return finalized_header.number;
+        const auto finalized_header = co_await rawdb::read_header_by_hash(reader, finalized_block_hash);
+        co_return finalized_header.number;
+    });
 }
 
 boost::asio::awaitable<uint64_t> get_forkchoice_safe_block_number(const core::rawdb::DatabaseReader& reader) {
-    const auto kv_pair = co_await reader.get(db::table::kLastForkchoice, silkworm::bytes_of_string(kSafeBlockHash));
-    const auto safe_block_hash_data = kv_pair.value;
-    if (safe_block_hash_data.empty()) {
-        SILKRPC_LOG << "no safe forkchoice block number found\n";
-        co_return 0;
-    }
-    const auto safe_block_hash = silkworm::to_bytes32(safe_block_hash_data);
+    co_return co_await read_cached_block_number(reader, ChainHeadTag::kSafe, [&]() -> boost::asio::awaitable<uint64_t> {
+        const auto kv_pair = co_await reader.get(db::table::kLastForkchoice, silkworm::bytes_of_string(kSafeBlockHash));
+        const auto safe_block_hash_data = kv_pair.value;
+        if (safe_block_hash_data.empty()) {
+            SILKRPC_LOG << "no safe forkchoice block number found\n";
+            co_return 0;
+        }
+        const auto safe_block_hash = silkworm::to_bytes32(safe_block_hash_data);
 
-    const silkworm::BlockHeader safe_block_header = co_await rawdb::read_header_by_hash(reader, safe_block_hash);
-    co_return safe_block_header.number;
+        const silkworm::BlockHeader safe_block_header = co_await rawdb::read_header_by_hash(reader, safe_block_hash);
+        co_return safe_block_header.number;
+    });
 }
 
 boost::asio::awaitable<bool> is_latest_block_number(const BlockNumberOrHash& bnoh, const core::rawdb::DatabaseReader& reader) {
@@ -372,6 +372,44 @@ TEST_CASE("get_latest_executed_block_number", "[silkrpc][core][blocks]") {
     CHECK(result.get() == 0x0000ddff12345678);
 }
 
+class CachingDatabaseReader : public test::MockDatabaseReader {
+public:
+    uint64_t view_id() const override { return view_id_; }
+    ChainHeadCache* chain_head_cache() const override { return &chain_head_cache_; }
+
+    uint64_t view_id_{1};
+    mutable ChainHeadCache chain_head_cache_;
+};
+
+TEST_CASE("get_latest_executed_block_number with chain head cache", "[silkrpc][core][blocks]") {
+    const silkworm::ByteView kExecutionStage{stages::kExecution};
+    CachingDatabaseReader db_reader;
+    boost::asio::thread_pool pool{1};
+
+    SECTION("same view read once") {
+        EXPECT_CALL(db_reader, get(db::table::kSyncStageProgress, kExecutionStage)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<KeyValue> { co_return KeyValue{silkworm::Bytes{}, *silkworm::from_hex("0000ddff12345678")}; }
+        ));
+        auto result1 = boost::asio::co_spawn(pool, get_latest_executed_block_number(db_reader), boost::asio::use_future);
+        CHECK(result1.get() == 0x0000ddff12345678);
+        auto result2 = boost::asio::co_spawn(pool, get_latest_executed_block_number(db_reader), boost::asio::use_future);
+        CHECK(result2.get() == 0x0000ddff12345678);
+    }
+
+    SECTION("new view read again") {
+        EXPECT_CALL(db_reader, get(db::table::kSyncStageProgress, kExecutionStage))
+            .WillOnce(InvokeWithoutArgs(
+                []() -> boost::asio::awaitable<KeyValue> { co_return KeyValue{silkworm::Bytes{}, *silkworm::from_hex("0000000000000010")}; }))
+            .WillOnce(InvokeWithoutArgs(
+                []() -> boost::asio::awaitable<KeyValue> { co_return KeyValue{silkworm::Bytes{}, *silkworm::from_hex("0000000000000011")}; }));
+        auto result1 = boost::asio::co_spawn(pool, get_latest_executed_block_number(db_reader), boost::asio::use_future);
+        CHECK(result1.get() == 0x10);
+        db_reader.view_id_ = 2;
+        auto result2 = boost::asio::co_spawn(pool, get_latest_executed_block_number(db_reader), boost::asio::use_future);
+        CHECK(result2.get() == 0x11);
+    }
+}
+
 TEST_CASE("get_latest_block_number with head forkchoice number", "[silkrpc][core][blocks]") {
     const silkworm::ByteView kExecutionStage{stages::kExecution};
     MockDatabaseReader db_reader;
@@ -16,41 +16,137 @@
 
 #include "cached_chain.hpp"
 
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <silkrpc/common/disk_cache_codec.hpp>
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/common/util.hpp>
 #include <silkrpc/core/blocks.hpp>
 #include <silkrpc/core/rawdb/chain.hpp>
 
 namespace silkrpc::core {
 
-boost::asio::awaitable<silkworm::BlockWithHash> read_block_by_number(BlockCache& cache, const rawdb::DatabaseReader& reader, uint64_t block_number) {
-    const auto block_hash = co_await rawdb::read_canonical_block_hash(reader, block_number);
+// Recover the senders missing from the block, if enabled, replacing the cached block unless just read
+static boost::asio::awaitable<std::shared_ptr<const silkworm::BlockWithHash>> recover_senders(BlockCache& cache,
+    std::shared_ptr<const silkworm::BlockWithHash> block_with_hash, SenderRecovery* sender_recovery) {
+    if (sender_recovery == nullptr || !SenderRecovery::has_missing_senders(block_with_hash->block)) {
+        co_return block_with_hash;
+    }
+    // The cached block is shared with other readers, so the senders are recovered into a copy
+    auto recovered_block = std::make_shared<silkworm::BlockWithHash>(*block_with_hash);
+    co_await sender_recovery->recover_senders(recovered_block->block);
+    cache.insert(recovered_block->hash, recovered_block);
+    co_return recovered_block;
+}
+
+// Return the block from the on-disk cache tier, if enabled and cached there, promoting it into the memory cache
+static boost::asio::awaitable<std::shared_ptr<const silkworm::BlockWithHash>> read_disk_cached_block(BlockCache& cache,
+    const evmc::bytes32& block_hash) {
+    const auto disk_cache = cache.disk_cache();
+    if (!disk_cache) {
+        co_return nullptr;
+    }
+    const auto encoded = co_await disk_cache->async_get(DiskCache::Kind::block, block_hash);
+    if (!encoded) {
+        co_return nullptr;
+    }
+    auto block_with_hash = std::make_shared<silkworm::BlockWithHash>();
+    if (!decode_cached_block(*encoded, block_hash, *block_with_hash)) {
+        SILKRPC_WARN << "invalid disk cached block " << block_hash << ", reading it from the database\n";
+        co_return nullptr;
+    }
+    cache.insert(block_hash, block_with_hash);
+    co_return block_with_hash;
+}
+
+// Append the block just read from the database to the on-disk cache tier, if enabled
+static void write_disk_cached_block(BlockCache& cache, const silkworm::BlockWithHash& block_with_hash) {
+    const auto& disk_cache = cache.disk_cache();
+    if (disk_cache && !disk_cache->contains(DiskCache::Kind::block, block_with_hash.hash)) {
+        disk_cache->post_put(DiskCache::Kind::block, block_with_hash.hash, encode_cached_block(block_with_hash));
+    }
+}
+
+boost::asio::awaitable<std::shared_ptr<const silkworm::BlockWithHash>> read_block(BlockCache& cache, const rawdb::DatabaseReader& reader, const evmc::bytes32& block_hash, uint64_t block_number,
+    SenderRecovery* sender_recovery) {
     const auto cached_block = cache.get(block_hash);
     if (cached_block) {
-        co_return cached_block.value();
+        co_return co_await recover_senders(cache, cached_block, sender_recovery);
+    }
+    const auto disk_cached_block = co_await read_disk_cached_block(cache, block_hash);
+    if (disk_cached_block) {
+        co_return co_await recover_senders(cache, disk_cached_block, sender_recovery);
     }
-    auto block_with_hash = co_await rawdb::read_block(reader, block_hash, block_number);
-    if (block_with_hash.block.transactions.size() != 0) {
+    auto block_with_hash = std::make_shared<silkworm::BlockWithHash>(co_await rawdb::read_block(reader, block_hash, block_number));
+    if (sender_recovery != nullptr) {
+        co_await sender_recovery->recover_senders(block_with_hash->block);
+    }
+    if (block_with_hash->block.transactions.size() != 0) {
        // don't save empty (without txs) blocks to cache, if block become non-canonical (not in main chain), we remove it's transactions,
        // but block can in the future become canonical(inserted in main chain) with its transactions
        cache.insert(block_hash, block_with_hash);
+       write_disk_cached_block(cache, *block_with_hash);
     }
     co_return block_with_hash;
 }
 
-boost::asio::awaitable<silkworm::BlockWithHash> read_block_by_hash(BlockCache& cache, const rawdb::DatabaseReader& reader, const evmc::bytes32& block_hash) {
+// Return the block including the transaction and its index from the cached location, if any and still canonical
+static boost::asio::awaitable<std::optional<std::pair<std::shared_ptr<const silkworm::BlockWithHash>, std::size_t>>> read_cached_transaction_location(
+    BlockCache& cache, const rawdb::DatabaseReader& reader, const evmc::bytes32& transaction_hash) {
+    const auto location = cache.transaction_locations().get(transaction_hash);
+    if (!location) {
+        co_return std::nullopt;
+    }
+    evmc::bytes32 canonical_block_hash;
+    try {
+        canonical_block_hash = co_await rawdb::read_canonical_block_hash(reader, location->block_number);
+    } catch (const std::invalid_argument&) {
+        co_return std::nullopt; // unwound beyond the block, go through the lookup table
+    }
+    if (canonical_block_hash != location->block_hash) {
+        co_return std::nullopt;
+    }
+    const auto block_with_hash = co_await read_block(cache, reader, location->block_hash, location->block_number);
+    if (location->index >= block_with_hash->block.transactions.size()) {
+        co_return std::nullopt;
+    }
+    co_return std::make_pair(block_with_hash, location->index);
+}
+
+boost::asio::awaitable<std::shared_ptr<const silkworm::BlockWithHash>> read_block_by_number(BlockCache& cache, const rawdb::DatabaseReader& reader, uint64_t block_number,
+    SenderRecovery* sender_recovery) {
+    const auto block_hash = co_await rawdb::read_canonical_block_hash(reader, block_number);
+    co_return co_await read_block(cache, reader, block_hash, block_number, sender_recovery);
+}
+
+boost::asio::awaitable<std::shared_ptr<const silkworm::BlockWithHash>> read_block_by_hash(BlockCache& cache, const rawdb::DatabaseReader& reader, const evmc::bytes32& block_hash,
+    SenderRecovery* sender_recovery) {
     const auto cached_block = cache.get(block_hash);
     if (cached_block) {
-        co_return cached_block.value();
+        co_return co_await recover_senders(cache, cached_block, sender_recovery);
+    }
+    const auto disk_cached_block = co_await read_disk_cached_block(cache, block_hash);
+    if (disk_cached_block) {
+        co_return co_await recover_senders(cache, disk_cached_block, sender_recovery);
+    }
+    auto block_with_hash = std::make_shared<silkworm::BlockWithHash>(co_await rawdb::read_block_by_hash(reader, block_hash));
+    if (sender_recovery != nullptr) {
+        co_await sender_recovery->recover_senders(block_with_hash->block);
     }
-    auto block_with_hash = co_await rawdb::read_block_by_hash(reader, block_hash);
-    if (block_with_hash.block.transactions.size() != 0) {
+    if (block_with_hash->block.transactions.size() != 0) {
        // don't save empty (without txs) blocks to cache, if block become non-canonical (not in main chain), we remove it's transactions,
        // but block can in the future become canonical(inserted in main chain) with its transactions
        cache.insert(block_hash, block_with_hash);
+       write_disk_cached_block(cache, *block_with_hash);
     }
     co_return block_with_hash;
 }
 
-boost::asio::awaitable<silkworm::BlockWithHash> read_block_by_number_or_hash(BlockCache& cache, const rawdb::DatabaseReader& reader, const silkrpc::BlockNumberOrHash& bnoh) {
+boost::asio::awaitable<std::shared_ptr<const silkworm::BlockWithHash>> read_block_by_number_or_hash(BlockCache& cache, const rawdb::DatabaseReader& reader, const silkrpc::BlockNumberOrHash& bnoh) {
     if (bnoh.is_number()) {
         co_return co_await read_block_by_number(cache, reader, bnoh.number());
     } else if (bnoh.is_hash()) {
@@ -62,26 +158,88 @@ boost::asio::awaitable<silkworm::BlockWithHash> read_block_by_number_or_hash(Blo
     throw std::runtime_error{"invalid block_number_or_hash value"};
 }
 
-boost::asio::awaitable<silkworm::BlockWithHash> read_block_by_transaction_hash(BlockCache& cache, const rawdb::DatabaseReader& reader, const evmc::bytes32& transaction_hash) {
+boost::asio::awaitable<std::shared_ptr<const silkworm::BlockWithHash>> read_block_by_transaction_hash(BlockCache& cache, const rawdb::DatabaseReader& reader, const evmc::bytes32& transaction_hash) {
+    const auto cached_location = co_await read_cached_transaction_location(cache, reader, transaction_hash);
+    if (cached_location) {
+        co_return cached_location->first;
+    }
     auto block_number = co_await rawdb::read_block_number_by_transaction_hash(reader, transaction_hash);
     co_return co_await read_block_by_number(cache, reader, block_number);
 }
 
 boost::asio::awaitable<std::optional<silkrpc::TransactionWithBlock>> read_transaction_by_hash(BlockCache& cache, const rawdb::DatabaseReader& reader, const evmc::bytes32& transaction_hash) {
+    const auto make_transaction_with_block = [](const silkworm::BlockWithHash& block_with_hash, std::size_t idx) {
+        const auto& block_header = block_with_hash.block.header;
+        return TransactionWithBlock{block_with_hash, block_with_hash.block.transactions[idx], block_with_hash.hash, block_header.number,
+            block_header.base_fee_per_gas, idx};
+    };
+
+    const auto cached_location = co_await read_cached_transaction_location(cache, reader, transaction_hash);
+    if (cached_location) {
+        co_return make_transaction_with_block(*cached_location->first, cached_location->second);
+    }
+
     auto block_number = co_await rawdb::read_block_number_by_transaction_hash(reader, transaction_hash);
-    auto block_with_hash = co_await read_block_by_number(cache, reader, block_number);
-    const silkworm::ByteView tx_hash{transaction_hash.bytes, silkworm::kHashLength};
-
-    const auto transactions = block_with_hash.block.transactions;
-    for (std::size_t idx{0}; idx < transactions.size(); idx++) {
-        auto ethash_hash{hash_of_transaction(transactions[idx])};
-        silkworm::ByteView hash_view{ethash_hash.bytes, silkworm::kHashLength};
-        if (tx_hash == hash_view) {
-            const auto block_header = block_with_hash.block.header;
-            co_return TransactionWithBlock{block_with_hash, transactions[idx], block_with_hash.hash, block_header.number, block_header.base_fee_per_gas, idx};
+    const auto block_with_hash = co_await read_block_by_number(cache, reader, block_number);
+
+    // Index all the transactions of the block while scanning it, because the ones included nearby are often looked up next
+    std::optional<std::size_t> transaction_index;
+    const auto block_hashes = cache.hashes(*block_with_hash);
+    for (std::size_t idx{0}; idx < block_hashes->transaction_hashes.size(); idx++) {
+        const auto& hash{block_hashes->transaction_hashes[idx]};
+        cache.transaction_locations().insert(hash, std::make_shared<const TransactionLocation>(TransactionLocation{block_number, block_with_hash->hash, idx}));
+        if (!transaction_index && hash == transaction_hash) {
+            transaction_index = idx;
         }
     }
-    co_return std::nullopt;
+    if (!transaction_index) {
+        co_return std::nullopt;
+    }
+    co_return make_transaction_with_block(*block_with_hash, *transaction_index);
+}
+
+boost::asio::awaitable<BlockTransactionHashes> read_transaction_hashes(BlockCache& cache, const rawdb::DatabaseReader& reader, uint64_t block_number,
+    const std::vector<uint32_t>& tx_indexes) {
+    BlockTransactionHashes result{co_await rawdb::read_canonical_block_hash(reader, block_number), {}};
+    auto block_hashes = cache.find_hashes(result.block_hash);
+    if (!block_hashes) {
+        if (const auto cached_block = cache.get(result.block_hash)) {
+            block_hashes = cache.hashes(*cached_block);
+        }
+    }
+    if (!block_hashes) {
+        result.transaction_hashes = co_await rawdb::read_transaction_hashes(reader, result.block_hash, block_number, tx_indexes);
+        co_return result;
+    }
+    result.transaction_hashes.reserve(tx_indexes.size());
+    for (const auto tx_index : tx_indexes) {
+        if (tx_index >= block_hashes->transaction_hashes.size()) {
+            throw std::runtime_error{"transaction index out of range in read_transaction_hashes"};
+        }
+        result.transaction_hashes.push_back(block_hashes->transaction_hashes[tx_index]);
+    }
+    co_return result;
+}
+
+boost::asio::awaitable<std::shared_ptr<const silkworm::BlockHeader>> read_header_by_number(HeaderCache& cache, const rawdb::DatabaseReader& reader, uint64_t block_number) {
+    const auto block_hash = co_await rawdb::read_canonical_block_hash(reader, block_number);
+    const auto cached_header = cache.get(block_hash);
+    if (cached_header) {
+        co_return cached_header;
+    }
+    auto header = std::make_shared<const silkworm::BlockHeader>(co_await rawdb::read_header(reader, block_hash, block_number));
+    cache.insert(block_hash, header);
+    co_return header;
+}
+
+boost::asio::awaitable<std::shared_ptr<const silkworm::BlockHeader>> read_header_by_hash(HeaderCache& cache, const rawdb::DatabaseReader& reader, const evmc::bytes32& block_hash) {
+    const auto cached_header = cache.get(block_hash);
+    if (cached_header) {
+        co_return cached_header;
+    }
+    auto header = std::make_shared<const silkworm::BlockHeader>(co_await rawdb::read_header_by_hash(reader, block_hash));
+    cache.insert(block_hash, header);
+    co_return header;
 }
 
 } // namespace silkrpc::core
@@ -17,24 +17,51 @@
 #ifndef SILKRPC_CORE_CACHED_CHAIN_HPP_
 #define SILKRPC_CORE_CACHED_CHAIN_HPP_
 
+#include <memory>
+#include <vector>
+
 #include <silkrpc/config.hpp>
 
 #include <boost/asio/awaitable.hpp>
 #include <evmc/evmc.hpp>
 
 #include <silkrpc/common/block_cache.hpp>
+#include <silkrpc/common/header_cache.hpp>
 #include <silkrpc/core/rawdb/accessors.hpp>
+#include <silkrpc/core/sender_recovery.hpp>
 #include <silkrpc/types/block.hpp>
 #include <silkrpc/types/transaction.hpp>
 
 namespace silkrpc::core  {
 
-boost::asio::awaitable<silkworm::BlockWithHash> read_block_by_number(BlockCache& cache, const rawdb::DatabaseReader& reader, uint64_t block_number);
-boost::asio::awaitable<silkworm::BlockWithHash> read_block_by_hash(BlockCache& cache, const rawdb::DatabaseReader& reader, const evmc::bytes32& block_hash);
-boost::asio::awaitable<silkworm::BlockWithHash> read_block_by_number_or_hash(BlockCache& cache, const rawdb::DatabaseReader& reader, const silkrpc::BlockNumberOrHash& bnoh);
-boost::asio::awaitable<silkworm::BlockWithHash> read_block_by_transaction_hash(BlockCache& cache, const rawdb::DatabaseReader& reader, const evmc::bytes32& transaction_hash);
+//! Read the block from the cache or the database: the senders missing from the block, if the sender recovery is given,
+//! are recovered on the workers before caching it, so that they are recovered once per block rather than once per reply
+boost::asio::awaitable<std::shared_ptr<const silkworm::BlockWithHash>> read_block_by_number(BlockCache& cache, const rawdb::DatabaseReader& reader, uint64_t block_number,
+    SenderRecovery* sender_recovery = nullptr);
+boost::asio::awaitable<std::shared_ptr<const silkworm::BlockWithHash>> read_block_by_hash(BlockCache& cache, const rawdb::DatabaseReader& reader, const evmc::bytes32& block_hash,
+    SenderRecovery* sender_recovery = nullptr);
+//! Read the block having the specified hash and number from the cache or the database, e.g. once resolved in bulk
+boost::asio::awaitable<std::shared_ptr<const silkworm::BlockWithHash>> read_block(BlockCache& cache, const rawdb::DatabaseReader& reader, const evmc::bytes32& block_hash,
+    uint64_t block_number, SenderRecovery* sender_recovery = nullptr);
+boost::asio::awaitable<std::shared_ptr<const silkworm::BlockWithHash>> read_block_by_number_or_hash(BlockCache& cache, const rawdb::DatabaseReader& reader, const silkrpc::BlockNumberOrHash& bnoh);
+boost::asio::awaitable<std::shared_ptr<const silkworm::BlockWithHash>> read_block_by_transaction_hash(BlockCache& cache, const rawdb::DatabaseReader& reader, const evmc::bytes32& transaction_hash);
 boost::asio::awaitable<std::optional<TransactionWithBlock>> read_transaction_by_hash(BlockCache& cache, const rawdb::DatabaseReader& reader, const evmc::bytes32& transaction_hash);
 
+//! The hash of a block along with the hashes of some of its transactions
+struct BlockTransactionHashes {
+    evmc::bytes32 block_hash;
+    std::vector<evmc::bytes32> transaction_hashes;
+};
+
+//! Read the hash of the canonical block and the hashes of its transactions at the specified indexes: the hashes memoized
+//! along with the block are used if any, otherwise just the specified transactions are read instead of the whole block
+boost::asio::awaitable<BlockTransactionHashes> read_transaction_hashes(BlockCache& cache, const rawdb::DatabaseReader& reader, uint64_t block_number,
+    const std::vector<uint32_t>& tx_indexes);
+
+//! Read the header from the cache or the database, without reading the block body
+boost::asio::awaitable<std::shared_ptr<const silkworm::BlockHeader>> read_header_by_number(HeaderCache& cache, const rawdb::DatabaseReader& reader, uint64_t block_number);
+boost::asio::awaitable<std::shared_ptr<const silkworm::BlockHeader>> read_header_by_hash(HeaderCache& cache, const rawdb::DatabaseReader& reader, const evmc::bytes32& block_hash);
+
 } // namespace silkrpc::core
 
 #endif // SILKRPC_CORE_CACHED_CHAIN_HPP_
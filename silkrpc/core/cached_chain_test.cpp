@@ -127,7 +127,7 @@ public:
 TEST_CASE("read_block_by_number_or_hash") {
     boost::asio::thread_pool pool{1};
     MockDatabaseReader db_reader;
-    BlockCache cache(10, true);
+    BlockCache cache;
 
     SECTION("using valid number") {
         BlockNumberOrHash bnoh{4'000'000};
@@ -143,14 +143,17 @@ TEST_CASE("read_block_by_number_or_hash") {
         EXPECT_CALL(db_reader, walk(db::table::kEthTx, _, _, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<void> { co_return; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kSenders, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, read_block_by_number_or_hash(cache, db_reader, bnoh), boost::asio::use_future);
-        const silkworm::BlockWithHash bwh = result.get();
+        const silkworm::BlockWithHash bwh = *result.get();
         check_expected_block_with_hash(bwh);
     }
 
     SECTION("using valid hash") {
         BlockNumberOrHash bnoh{"0x439816753229fc0736bf86a5048de4bc9fcdede8c91dadf88c828c76b2281dff"};
-        BlockCache cache(10, true);
+        BlockCache cache;
 
         EXPECT_CALL(db_reader, get_one(db::table::kHeaderNumbers, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kNumber; }
@@ -164,14 +167,17 @@ TEST_CASE("read_block_by_number_or_hash") {
         EXPECT_CALL(db_reader, walk(db::table::kEthTx, _, _, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<void> { co_return; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kSenders, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, read_block_by_number_or_hash(cache, db_reader, bnoh), boost::asio::use_future);
-        const silkworm::BlockWithHash bwh = result.get();
+        const silkworm::BlockWithHash bwh = *result.get();
         check_expected_block_with_hash(bwh);
     }
 
     SECTION("using tag kEarliestBlockId") {
         BlockNumberOrHash bnoh{kEarliestBlockId};
-        BlockCache cache(10, true);
+        BlockCache cache;
 
         EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kBlockHash; }
@@ -185,8 +191,11 @@ TEST_CASE("read_block_by_number_or_hash") {
         EXPECT_CALL(db_reader, walk(db::table::kEthTx, _, _, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<void> { co_return; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kSenders, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, read_block_by_number_or_hash(cache, db_reader, bnoh), boost::asio::use_future);
-        const silkworm::BlockWithHash bwh = result.get();
+        const silkworm::BlockWithHash bwh = *result.get();
         check_expected_block_with_hash(bwh);
     }
 }
@@ -195,7 +204,7 @@ TEST_CASE("silkrpc::core::read_block_by_number") {
     uint64_t bn = 5'000'001;
     boost::asio::thread_pool pool{1};
     MockDatabaseReader db_reader;
-    BlockCache cache(10, true);
+    BlockCache cache;
 
     SECTION("using valid block_number") {
         EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, _)).WillOnce(InvokeWithoutArgs(
@@ -210,13 +219,16 @@ TEST_CASE("silkrpc::core::read_block_by_number") {
         EXPECT_CALL(db_reader, walk(db::table::kEthTx, _, _, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<void> { co_return; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kSenders, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, silkrpc::core::read_block_by_number(cache, db_reader, bn), boost::asio::use_future);
-        const silkworm::BlockWithHash bwh = result.get();
+        const silkworm::BlockWithHash bwh = *result.get();
         check_expected_block_with_hash(bwh);
     }
 
     SECTION("using valid block_number and hit cache") {
-        BlockCache cache(10, true);
+        BlockCache cache;
         EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kBlockHash; }
         ));
@@ -243,18 +255,19 @@ TEST_CASE("silkrpc::core::read_block_by_number") {
             }
         ));
         auto result = boost::asio::co_spawn(pool, silkrpc::core::read_block_by_number(cache, db_reader, bn), boost::asio::use_future);
-        const silkworm::BlockWithHash bwh = result.get();
-        check_expected_block_with_hash(bwh);
+        const auto bwh = result.get();
+        check_expected_block_with_hash(*bwh);
 
         EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kBlockHash; }
         ));
         auto result1 = boost::asio::co_spawn(pool, silkrpc::core::read_block_by_number(cache, db_reader, bn), boost::asio::use_future);
-        const silkworm::BlockWithHash bwh1 = result1.get();
+        const auto bwh1 = result1.get();
+        CHECK(bwh1 == bwh);
     }
 
     SECTION("using valid block_number and empty txs (miss cache)") {
-        BlockCache cache(10, true);
+        BlockCache cache;
         EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kBlockHash; }
         ));
@@ -267,8 +280,11 @@ TEST_CASE("silkrpc::core::read_block_by_number") {
         EXPECT_CALL(db_reader, walk(db::table::kEthTx, _, _, _)).WillOnce(Invoke(
             []() -> boost::asio::awaitable<void> { co_return; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kSenders, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, silkrpc::core::read_block_by_number(cache, db_reader, bn), boost::asio::use_future);
-        const silkworm::BlockWithHash bwh = result.get();
+        const silkworm::BlockWithHash bwh = *result.get();
         check_expected_block_with_hash(bwh);
 
         EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, _)).WillOnce(InvokeWithoutArgs(
@@ -283,8 +299,11 @@ TEST_CASE("silkrpc::core::read_block_by_number") {
         EXPECT_CALL(db_reader, walk(db::table::kEthTx, _, _, _)).WillOnce(Invoke(
             []() -> boost::asio::awaitable<void> { co_return; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kSenders, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result1 = boost::asio::co_spawn(pool, silkrpc::core::read_block_by_number(cache, db_reader, bn), boost::asio::use_future);
-        const silkworm::BlockWithHash bwh1 = result1.get();
+        const silkworm::BlockWithHash bwh1 = *result1.get();
    }
 }
 
@@ -292,7 +311,7 @@ TEST_CASE("silkrpc::core::read_block_by_hash") {
     const evmc::bytes32 bh = 0x439816753229fc0736bf86a5048de4bc9fcdede8c91dadf88c828c76b2281dff_bytes32;
     boost::asio::thread_pool pool{1};
     MockDatabaseReader db_reader;
-    BlockCache cache(10, true);
+    BlockCache cache;
 
     SECTION("using valid block_hash") {
         EXPECT_CALL(db_reader, get_one(db::table::kHeaderNumbers, _)).WillOnce(InvokeWithoutArgs(
@@ -321,7 +340,7 @@ TEST_CASE("silkrpc::core::read_block_by_hash") {
             }
         ));
         auto result = boost::asio::co_spawn(pool, silkrpc::core::read_block_by_hash(cache, db_reader, bh), boost::asio::use_future);
-        const silkworm::BlockWithHash bwh = result.get();
+        const silkworm::BlockWithHash bwh = *result.get();
         check_expected_block_with_hash(bwh);
     }
 
@@ -352,10 +371,10 @@ TEST_CASE("silkrpc::core::read_block_by_hash") {
             }
         ));
         auto result = boost::asio::co_spawn(pool, silkrpc::core::read_block_by_hash(cache, db_reader, bh), boost::asio::use_future);
-        const silkworm::BlockWithHash bwh = result.get();
+        const silkworm::BlockWithHash bwh = *result.get();
         check_expected_block_with_hash(bwh);
         auto result1 = boost::asio::co_spawn(pool, silkrpc::core::read_block_by_hash(cache, db_reader, bh), boost::asio::use_future);
-        const silkworm::BlockWithHash bwh1 = result1.get();
+        const silkworm::BlockWithHash bwh1 = *result1.get();
     }
 
     SECTION("using valid block_hash no txs (miss cache)") {
@@ -371,8 +390,11 @@ TEST_CASE("silkrpc::core::read_block_by_hash") {
         EXPECT_CALL(db_reader, walk(db::table::kEthTx, _, _, _)).WillOnce(Invoke(
             []() -> boost::asio::awaitable<void> { co_return; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kSenders, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, silkrpc::core::read_block_by_hash(cache, db_reader, bh), boost::asio::use_future);
-        const silkworm::BlockWithHash bwh = result.get();
+        const silkworm::BlockWithHash bwh = *result.get();
         check_expected_block_with_hash(bwh);
 
         EXPECT_CALL(db_reader, get_one(db::table::kHeaderNumbers, _)).WillOnce(InvokeWithoutArgs(
@@ -387,15 +409,18 @@ TEST_CASE("silkrpc::core::read_block_by_hash") {
         EXPECT_CALL(db_reader, walk(db::table::kEthTx, _, _, _)).WillOnce(Invoke(
             []() -> boost::asio::awaitable<void> { co_return; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kSenders, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result1 = boost::asio::co_spawn(pool, silkrpc::core::read_block_by_hash(cache, db_reader, bh), boost::asio::use_future);
-        const silkworm::BlockWithHash bwh1 = result1.get();
+        const silkworm::BlockWithHash bwh1 = *result1.get();
     }
 }
 
 TEST_CASE("read_block_by_transaction_hash") {
     boost::asio::thread_pool pool{1};
     MockDatabaseReader db_reader;
-    BlockCache cache(10, true);
+    BlockCache cache;
 
     SECTION("block header number not found") {
         const auto transaction_hash{0x18dcb90e76b61fe6f37c9a9cd269a66188c05af5f7a62c50ff3246c6e207dc6d_bytes32};
@@ -438,6 +463,9 @@ TEST_CASE("read_block_by_transaction_hash") {
         EXPECT_CALL(db_reader, get_one(db::table::kHeaders, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kBlockBodies, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, read_block_by_transaction_hash(cache, db_reader, transaction_hash), boost::asio::use_future);
         CHECK_THROWS_MATCHES(result.get(), std::runtime_error, Message("empty block header RLP in read_header"));
     }
@@ -477,8 +505,11 @@ TEST_CASE("read_block_by_transaction_hash") {
         EXPECT_CALL(db_reader, walk(db::table::kEthTx, _, _, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<void> { co_return; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kSenders, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, read_block_by_transaction_hash(cache, db_reader, transaction_hash), boost::asio::use_future);
-        const silkworm::BlockWithHash bwh = result.get();
+        const silkworm::BlockWithHash bwh = *result.get();
         check_expected_block_with_hash(bwh);
     }
 }
@@ -486,7 +517,7 @@ TEST_CASE("read_block_by_transaction_hash") {
 TEST_CASE("read_transaction_by_hash") {
     boost::asio::thread_pool pool{1};
     MockDatabaseReader db_reader;
-    BlockCache cache(10, true);
+    BlockCache cache;
 
     SECTION("block header number not found") {
         const auto transaction_hash{0x18dcb90e76b61fe6f37c9a9cd269a66188c05af5f7a62c50ff3246c6e207dc6d_bytes32};
@@ -523,6 +554,9 @@ TEST_CASE("read_transaction_by_hash") {
         EXPECT_CALL(db_reader, walk(db::table::kEthTx, _, _, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<void> { co_return; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kSenders, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, read_transaction_by_hash(cache, db_reader, transaction_hash), boost::asio::use_future);
         CHECK(result.get() == std::nullopt);
     }
@@ -562,8 +596,70 @@ TEST_CASE("read_transaction_by_hash") {
         CHECK(block_and_transaction.has_value());
         check_expected_transaction(block_and_transaction->transaction);
     }
+
+    SECTION("transaction found again from cached location") {
+        const auto transaction_hash{0x3ff7b8917f1941784c709d6e54db18500fddc2b4c1a90b5cdec675cd0f9fc042_bytes32};
+        EXPECT_CALL(db_reader, get_one(db::table::kTxLookup, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return *silkworm::from_hex("3D0900"); }
+        ));
+        EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, _)).Times(2).WillRepeatedly(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kBlockHash; }
+        ));
+        EXPECT_CALL(db_reader, get_one(db::table::kHeaders, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kHeader; }
+        ));
+        EXPECT_CALL(db_reader, get_one(db::table::kBlockBodies, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kNotEmptyBody; }
+        ));
+        EXPECT_CALL(db_reader, walk(db::table::kEthTx, _, _, _)).WillOnce(Invoke(
+            [](Unused, Unused, Unused, Walker w) -> boost::asio::awaitable<void> {
+                silkworm::Bytes key{};
+                silkworm::Bytes value{*silkworm::from_hex("f8ac8301942e8477359400834c4b40945f62669ba0c6cf41cc162d8157ed71a0b9d6dbaf80b844f2"
+                    "f0387700000000000000000000000000000000000000000000000000000000000158b09f0270fc889c577c1c64db7c819f921d"
+                    "1b6e8c7e5d3f2ff34f162cf4b324cc052ea0d5494ad16e2233197daa9d54cbbcb1ee534cf9f675fa587c264a4ce01e7d3d23a0"
+                    "1421bcf57f4b39eb84a35042dc4675ae167f3e2f50e808252afa23e62e692355")};
+                w(key, value);
+                co_return;
+            }
+        ));
+        EXPECT_CALL(db_reader, get_one(db::table::kSenders, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> {
+                co_return *silkworm::from_hex("70A5C9D346416f901826581d423Cd5B92d44Ff5a");
+            }
+        ));
+        auto result1 = boost::asio::co_spawn(pool, read_transaction_by_hash(cache, db_reader, transaction_hash), boost::asio::use_future);
+        CHECK(result1.get().has_value());
+        CHECK(cache.transaction_locations().size() == 1);
+        auto result2 = boost::asio::co_spawn(pool, read_transaction_by_hash(cache, db_reader, transaction_hash), boost::asio::use_future);
+        const std::optional<silkrpc::TransactionWithBlock> block_and_transaction = result2.get();
+        CHECK(block_and_transaction.has_value());
+        CHECK(block_and_transaction->transaction.transaction_index == 0);
+        check_expected_transaction(block_and_transaction->transaction);
+    }
 }
 
 
+TEST_CASE("silkrpc::core::read_header_by_hash") {
+    boost::asio::thread_pool pool{1};
+    MockDatabaseReader db_reader;
+    HeaderCache cache;
+    const auto block_hash{0x439816753229fc0736bf86a5048de4bc9fcdede8c91dadf88c828c76b2281dff_bytes32};
+
+    SECTION("using valid block_hash and hit cache") {
+        EXPECT_CALL(db_reader, get_one(db::table::kHeaderNumbers, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kNumber; }
+        ));
+        EXPECT_CALL(db_reader, get_one(db::table::kHeaders, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kHeader; }
+        ));
+        auto result1 = boost::asio::co_spawn(pool, silkrpc::core::read_header_by_hash(cache, db_reader, block_hash), boost::asio::use_future);
+        const auto header1 = result1.get();
+        CHECK(header1->number == 4000000);
+        auto result2 = boost::asio::co_spawn(pool, silkrpc::core::read_header_by_hash(cache, db_reader, block_hash), boost::asio::use_future);
+        const auto header2 = result2.get();
+        CHECK(header2 == header1);
+    }
+}
+
 } // namespace silkrpc::core::rawdb
 
@@ -19,14 +19,17 @@
 #include <algorithm>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <boost/asio/compose.hpp>
 #include <boost/asio/post.hpp>
+#include <boost/asio/this_coro.hpp>
 #include <boost/asio/use_awaitable.hpp>
 #include <silkrpc/core/blocks.hpp>
 #include <silkrpc/core/rawdb/chain.hpp>
 
 #include <silkrpc/common/log.hpp>
+#include <silkrpc/concurrency/parallel_for.hpp>
 
 namespace silkrpc::ego {
 
@@ -80,6 +83,11 @@ boost::asio::awaitable<intx::uint256> EstimateGasOracle::estimate_gas(const Call
     SILKRPC_DEBUG << "hi: " << hi << ", lo: " << lo << ", cap: " << cap << "\n";
 
     silkworm::Transaction transaction{call.to_transaction()};
+    if (probes_per_round_ > 1) {
+        hi = co_await search_in_rounds(transaction, lo, hi);
+        SILKRPC_DEBUG << "EstimateGasOracle::estimate_gas returns " << hi << "\n";
+        co_return hi;
+    }
     while (lo + 1 < hi) {
         auto mid = (hi + lo) / 2;
         transaction.gas_limit = mid;
@@ -107,9 +115,66 @@ boost::asio::awaitable<intx::uint256> EstimateGasOracle::estimate_gas(const Call
     co_return hi;
 }
 
+boost::asio::awaitable<std::uint64_t> EstimateGasOracle::search_in_rounds(silkworm::Transaction& transaction, std::uint64_t lo, std::uint64_t hi) {
+    // The execution with the whole allowance tells whether any estimate exists and which gas is surely needed
+    const auto cap = hi;
+    transaction.gas_limit = cap;
+    const auto cap_result = co_await executor_(transaction);
+    if (is_failed(cap_result)) {
+        throw EstimateGasException{-1, "gas required exceeds allowance (" + std::to_string(cap) + ")"};
+    }
+    const std::uint64_t gas_used = cap - cap_result.gas_left + cap_result.gas_refund;
+    lo = std::max(lo, std::min(gas_used, hi) - 1);
+
+    // Probe the gas limits concurrently: the lowest succeeding one and the highest failing one below it bound the next round
+    const auto executor = co_await boost::asio::this_coro::executor;
+    const auto probe_round = [&](const std::vector<std::uint64_t>& gas_limits) -> boost::asio::awaitable<void> {
+        std::vector<uint8_t> failed(gas_limits.size());
+        co_await parallel_for(executor, gas_limits.size(), gas_limits.size(), [&](std::size_t i) -> boost::asio::awaitable<void> {
+            silkworm::Transaction probe{transaction};
+            probe.gas_limit = gas_limits[i];
+            failed[i] = co_await try_execution(probe);
+        });
+        for (std::size_t i{0}; i < gas_limits.size(); ++i) {
+            if (!failed[i]) {
+                hi = gas_limits[i];
+                break;
+            }
+            lo = gas_limits[i];
+        }
+        SILKRPC_DEBUG << "search_in_rounds probes: " << gas_limits.size() << " hi: " << hi << ", lo: " << lo << "\n";
+    };
+
+    // The first round probes the gas used (refund included) and the optimistic guess adding the gas retained by the 63/64
+    // rule for the inner calls: most transactions need exactly the former, those with inner calls usually less than the latter
+    std::vector<std::uint64_t> seed_gas_limits;
+    if (lo + 1 < hi) {
+        seed_gas_limits.push_back(lo + 1);
+        const std::uint64_t optimistic_gas = (gas_used + kCallStipend) * 64 / 63;
+        if (optimistic_gas > lo + 1 && optimistic_gas < hi) {
+            seed_gas_limits.push_back(optimistic_gas);
+        }
+        co_await probe_round(seed_gas_limits);
+    }
+
+    while (lo + 1 < hi && (hi - lo) * 1000 > hi * kEstimateErrorPerMille) {
+        const auto num_probes = std::min<std::uint64_t>(probes_per_round_, hi - lo - 1);
+        std::vector<std::uint64_t> gas_limits;
+        gas_limits.reserve(num_probes);
+        for (std::uint64_t i{0}; i < num_probes; ++i) {
+            gas_limits.push_back(lo + (hi - lo) * (i + 1) / (num_probes + 1));
+        }
+        co_await probe_round(gas_limits);
+    }
+    co_return hi;
+}
+
 boost::asio::awaitable<bool> EstimateGasOracle::try_execution(const silkworm::Transaction& transaction) {
     const auto result = co_await executor_(transaction);
+    co_return is_failed(result);
+}
 
+bool EstimateGasOracle::is_failed(const silkrpc::ExecutionResult& result) {
     bool failed = true;
     if (result.pre_check_error) {
         SILKRPC_DEBUG << "result error " << result.pre_check_error.value() << "\n";
@@ -127,8 +192,7 @@ boost::asio::awaitable<bool> EstimateGasOracle::try_execution(const silkworm::Tr
             throw EstimateGasException{3, error_message, result.data};
         }
     }
-
-    co_return failed;
+    return failed;
 }
 
 } // namespace silkrpc::ego
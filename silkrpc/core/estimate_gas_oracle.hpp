@@ -17,6 +17,7 @@
 #ifndef SILKRPC_CORE_ESTIMATE_GAS_ORACLE_HPP_
 #define SILKRPC_CORE_ESTIMATE_GAS_ORACLE_HPP_
 
+#include <cstddef>
 #include <functional>
 #include <optional>
 #include <string>
@@ -39,6 +40,9 @@ namespace silkrpc::ego {
 
 const std::uint64_t kTxGas = 21'000;
 const std::uint64_t kGasCap = 25'000'000;
+const std::uint64_t kCallStipend = 2'300;
+//! The accepted error of the estimate searched in rounds, in per mille of the estimate
+const std::uint64_t kEstimateErrorPerMille = 15;
 
 using BlockHeaderProvider = std::function<boost::asio::awaitable<silkworm::BlockHeader>(uint64_t)>;
 using AccountReader = std::function<boost::asio::awaitable<std::optional<silkworm::Account>>(const evmc::address&, uint64_t)>;
@@ -78,8 +82,11 @@ private:
 
 class EstimateGasOracle {
 public:
-    explicit EstimateGasOracle(const BlockHeaderProvider& block_header_provider, const AccountReader& account_reader, const Executor& executor)
-        : block_header_provider_(block_header_provider), account_reader_{account_reader}, executor_(executor) {}
+    //! When more probes per round are allowed, the executor must support concurrent calls and must refund the gas: the search
+    //! is seeded by the gas used with the whole allowance, then probes that many gas limits at once in each round
+    explicit EstimateGasOracle(const BlockHeaderProvider& block_header_provider, const AccountReader& account_reader, const Executor& executor,
+        std::size_t probes_per_round = 1)
+        : block_header_provider_(block_header_provider), account_reader_{account_reader}, executor_(executor), probes_per_round_{probes_per_round} {}
     virtual ~EstimateGasOracle() {}
 
     EstimateGasOracle(const EstimateGasOracle&) = delete;
@@ -90,9 +97,15 @@ public:
 private:
     boost::asio::awaitable<bool> try_execution(const silkworm::Transaction& transaction);
 
+    //! Search the gas limit in (lo, hi] probing the gas limits of each round concurrently, up to the accepted error
+    boost::asio::awaitable<std::uint64_t> search_in_rounds(silkworm::Transaction& transaction, std::uint64_t lo, std::uint64_t hi);
+
+    static bool is_failed(const silkrpc::ExecutionResult& result);
+
     const BlockHeaderProvider& block_header_provider_;
     const AccountReader& account_reader_;
     const Executor& executor_;
+    const std::size_t probes_per_round_;
 };
 
 } // namespace silkrpc::ego
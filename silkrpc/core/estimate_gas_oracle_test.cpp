@@ -241,4 +241,64 @@ TEST_CASE("estimate gas") {
     }
 }
 
+TEST_CASE("estimate gas in rounds") {
+    boost::asio::thread_pool pool{1};
+
+    uint64_t count{0};
+    uint64_t gas_needed{0};
+    uint64_t gas_refund{0};
+
+    silkworm::BlockHeader kBlockHeader;
+    kBlockHeader.gas_limit = 1'000'000;
+
+    silkworm::Account kAccount{0, 1'000'000'000};
+
+    // The execution succeeds iff the gas limit covers the gas needed, then the refund is given back from the gas used
+    Executor executor = [&](const silkworm::Transaction& transaction) -> boost::asio::awaitable<silkrpc::ExecutionResult> {
+        ++count;
+        if (transaction.gas_limit < gas_needed) {
+            co_return silkrpc::ExecutionResult{evmc_status_code::EVMC_INSUFFICIENT_BALANCE, 0, {}};
+        }
+        co_return silkrpc::ExecutionResult{evmc_status_code::EVMC_SUCCESS, transaction.gas_limit - gas_needed + gas_refund, {}, std::nullopt, gas_refund};
+    };
+
+    BlockHeaderProvider block_header_provider = [&kBlockHeader](uint64_t block_number) -> boost::asio::awaitable<silkworm::BlockHeader> {
+        co_return kBlockHeader;
+    };
+
+    AccountReader account_reader = [&kAccount](const evmc::address& address, uint64_t block_number) -> boost::asio::awaitable<std::optional<silkworm::Account>> {
+        co_return kAccount;
+    };
+
+    Call call;
+    EstimateGasOracle estimate_gas_oracle{block_header_provider, account_reader, executor, 4};
+
+    SECTION("simple transfer, found by the seed round") {
+        gas_needed = kTxGas;
+        auto result = boost::asio::co_spawn(pool, estimate_gas_oracle.estimate_gas(call, 0), boost::asio::use_future);
+        const intx::uint256 estimate_gas = result.get();
+
+        CHECK(estimate_gas == kTxGas);
+        CHECK(count == 2);
+    }
+
+    SECTION("refund included in the gas used, within the accepted error") {
+        gas_needed = 100'000;
+        gas_refund = 20'000;
+        auto result = boost::asio::co_spawn(pool, estimate_gas_oracle.estimate_gas(call, 0), boost::asio::use_future);
+        const intx::uint256 estimate_gas = result.get();
+
+        CHECK(estimate_gas >= gas_needed);
+        CHECK(estimate_gas * 1000 <= gas_needed * (1000 + kEstimateErrorPerMille));
+        CHECK(count < 10);
+    }
+
+    SECTION("gas required exceeds allowance") {
+        gas_needed = 2'000'000;
+        auto result = boost::asio::co_spawn(pool, estimate_gas_oracle.estimate_gas(call, 0), boost::asio::use_future);
+        CHECK_THROWS_MATCHES(result.get(), EstimateGasException, Message("gas required exceeds allowance (1000000)"));
+        CHECK(count == 1);
+    }
+}
+
 } // namespace silkrpc::ego
@@ -14,6 +14,7 @@
    limitations under the License.
 */
 
+#include <cstring>
 #include <memory>
 
 #include "evm_access_list_tracer.hpp"
@@ -31,32 +32,46 @@
 
 namespace silkrpc {
 
-const char* SLOAD = evmone::instr::traits[evmc_opcode::OP_SLOAD].name;
-const char* SSTORE = evmone::instr::traits[evmc_opcode::OP_SSTORE].name;
-const char* EXTCODECOPY = evmone::instr::traits[evmc_opcode::OP_EXTCODECOPY].name;
-const char* EXTCODEHASH = evmone::instr::traits[evmc_opcode::OP_EXTCODEHASH].name;
-const char* EXTCODESIZE = evmone::instr::traits[evmc_opcode::OP_EXTCODESIZE].name;
-const char* BALANCE = evmone::instr::traits[evmc_opcode::OP_BALANCE].name;
-const char* SELFDESTRUCT = evmone::instr::traits[evmc_opcode::OP_SELFDESTRUCT].name;
-const char* DELEGATECALL = evmone::instr::traits[evmc_opcode::OP_DELEGATECALL].name;
-const char* CALL = evmone::instr::traits[evmc_opcode::OP_CALL].name;
-const char* STATICCALL = evmone::instr::traits[evmc_opcode::OP_STATICCALL].name;
-const char* CALLCODE = evmone::instr::traits[evmc_opcode::OP_CALLCODE].name;
+namespace {
+
+evmc::bytes32 to_bytes32(const intx::uint256& value) {
+    evmc::bytes32 bytes;
+    intx::be::store(bytes.bytes, value);
+    return bytes;
+}
+
+evmc::address to_address(const intx::uint256& value) {
+    const auto bytes = to_bytes32(value);
+    evmc::address address;
+    std::memcpy(address.bytes, bytes.bytes + sizeof(bytes.bytes) - sizeof(address.bytes), sizeof(address.bytes));
+    return address;
+}
+
+//! Whether the address may be a precompiled contract, which is always warm
+bool is_low_address(const evmc::address& address) {
+    for (std::size_t i{0}; i < sizeof(address.bytes) - 1; ++i) {
+        if (address.bytes[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
 
 std::string get_opcode_name(const char* const* names, std::uint8_t opcode) {
     const auto name = names[opcode];
     return (name != nullptr) ? name : "opcode 0x" + evmc::hex(opcode) + " not defined";
 }
 
-inline evmc::address AccessListTracer::address_from_hex_string(const std::string& s) {
-    const auto bytes = silkworm::from_hex(s);
-    return silkworm::to_evmc_address(bytes.value_or(silkworm::Bytes{}));
-}
-
 void AccessListTracer::on_execution_start(evmc_revision rev, const evmc_message& msg, evmone::bytes_view code) noexcept {
     if (opcode_names_ == nullptr) {
         opcode_names_ = evmc_get_instruction_names_table(rev);
     }
+    // Warm and cold accesses exist since Berlin only, the contracts created in nested frames are warm
+    if (rev < EVMC_BERLIN || (msg.depth > 0 && (msg.kind == EVMC_CREATE || msg.kind == EVMC_CREATE2))) {
+        gas_dependent_ = true;
+    }
 }
 
 void AccessListTracer::on_instruction_start(uint32_t pc, const intx::uint256 *stack_top, const int stack_height,
@@ -65,12 +80,11 @@ void AccessListTracer::on_instruction_start(uint32_t pc, const intx::uint256 *st
     evmc::address recipient(execution_state.msg->recipient);
 
     const auto opcode = execution_state.original_code[pc];
-    const auto opcode_name = get_opcode_name(opcode_names_, opcode);
 
     SILKRPC_DEBUG << "on_instruction_start:"
         << " pc: " << std::dec << pc
         << " opcode: 0x" << std::hex << evmc::hex(opcode)
-        << " opcode_name: " << opcode_name
+        << " opcode_name: " << get_opcode_name(opcode_names_, opcode)
         << " recipient: " << recipient
         << " execution_state: {"
         << "   gas_left: " << std::dec << execution_state.gas_left
@@ -79,70 +93,133 @@ void AccessListTracer::on_instruction_start(uint32_t pc, const intx::uint256 *st
         << "   msg.depth: " << std::dec << execution_state.msg->depth
         << "}\n";
 
-    if (is_storage_opcode(opcode_name) && stack_height >= 1 ) {
-        const auto address = silkworm::bytes32_from_hex(intx::hex(stack_top[0]));
-        add_storage(recipient, address);
-    } else if (is_contract_opcode(opcode_name) && stack_height >= 1 ) {
-        const auto address = address_from_hex_string(intx::hex(stack_top[0]));
-        if (!exclude(address)) {
-            add_address(address);
-        }
-    } else if (is_call_opcode(opcode_name) && stack_height  >= 5) {
-        const auto address = address_from_hex_string(intx::hex(stack_top[-1]));
-        if (!exclude(address)) {
-            add_address(address);
-        }
+    switch (opcode) {
+        case evmc_opcode::OP_SSTORE:
+            gas_dependent_ = true; // refunds and stipend checks
+            [[fallthrough]];
+        case evmc_opcode::OP_SLOAD:
+            if (stack_height >= 1) {
+                add_storage(recipient, to_bytes32(stack_top[0]));
+            }
+            break;
+        case evmc_opcode::OP_SELFDESTRUCT:
+            gas_dependent_ = true; // refunds before London
+            [[fallthrough]];
+        case evmc_opcode::OP_EXTCODECOPY:
+        case evmc_opcode::OP_EXTCODEHASH:
+        case evmc_opcode::OP_EXTCODESIZE:
+        case evmc_opcode::OP_BALANCE:
+            if (stack_height >= 1) {
+                const auto address = to_address(stack_top[0]);
+                if (!exclude(address)) {
+                    add_address(address);
+                }
+            }
+            break;
+        case evmc_opcode::OP_DELEGATECALL:
+        case evmc_opcode::OP_CALL:
+        case evmc_opcode::OP_STATICCALL:
+        case evmc_opcode::OP_CALLCODE:
+            if (stack_height >= 5) {
+                const auto address = to_address(stack_top[-1]);
+                if (!exclude(address)) {
+                    add_address(address);
+                }
+            }
+            break;
+        case evmc_opcode::OP_GAS:
+        case evmc_opcode::OP_CREATE:
+        case evmc_opcode::OP_CREATE2:
+            gas_dependent_ = true;
+            break;
+        default:
+            break;
     }
 }
 
-inline bool AccessListTracer::is_storage_opcode(const std::string & opcode_name) {
-    return (opcode_name == SLOAD || opcode_name == SSTORE);
-}
-
-inline bool AccessListTracer::is_contract_opcode(const std::string & opcode_name) {
-    return (opcode_name == EXTCODECOPY || opcode_name == EXTCODEHASH || opcode_name == EXTCODESIZE ||
-            opcode_name == BALANCE || opcode_name == SELFDESTRUCT);
+void AccessListTracer::on_execution_end(const evmc_result& result, const silkworm::IntraBlockState& intra_block_state) noexcept {
+    // Any failed frame drops its warm accesses (or has run out of gas)
+    if (result.status_code != EVMC_SUCCESS) {
+        gas_dependent_ = true;
+    }
 }
 
-inline bool AccessListTracer::is_call_opcode(const std::string & opcode_name) {
-    return (opcode_name == DELEGATECALL || opcode_name == CALL || opcode_name == STATICCALL || opcode_name == CALLCODE);
+void AccessListTracer::on_precompiled_run(const evmc_result& result, int64_t gas, const silkworm::IntraBlockState& intra_block_state) noexcept {
+    if (result.status_code != EVMC_SUCCESS) {
+        gas_dependent_ = true;
+    }
 }
 
-
 inline bool AccessListTracer::exclude(const evmc::address& address) {
     // return (address == from_ || address == to_ || is_precompiled(address)); // ADD check on precompiled when available from silkworm
     return (address == from_ || address == to_);
 }
 
+void AccessListTracer::reset_access_list() {
+    access_list_.clear();
+    accessed_accounts_.clear();
+    gas_dependent_ = false;
+}
+
 void AccessListTracer::add_storage(const evmc::address& address, const evmc::bytes32& storage) {
     SILKRPC_TRACE << "add_storage:" << address << " storage: " << storage << "\n";
-    for (int i = 0; i < access_list_.size(); i++) {
-        if (access_list_[i].account == address) {
-            for (int j = 0; j < access_list_[i].storage_keys.size(); j++) {
-                if (access_list_[i].storage_keys[j] == storage) {
-                    return;
-                }
-            }
-            access_list_[i].storage_keys.push_back(storage);
-            return;
-        }
+    // The account executing the code is warm already
+    auto [it, inserted] = accessed_accounts_.try_emplace(address, AccessedAccount{access_list_.size()});
+    if (inserted) {
+        silkworm::AccessListEntry item;
+        item.account = address;
+        access_list_.push_back(std::move(item));
+    }
+    if (it->second.storage_keys.insert(storage).second) {
+        access_list_[it->second.index].storage_keys.push_back(storage);
     }
-    silkworm::AccessListEntry item;
-    item.account = address;
-    item.storage_keys.push_back(storage);
-    access_list_.push_back(item);
 }
 
 void AccessListTracer::add_address(const evmc::address& address) {
     SILKRPC_TRACE << "add_address:" << address << "\n";
-    for (int i = 0; i < access_list_.size(); i++) {
-        if (access_list_[i].account == address) {
-            return;
+    const auto [it, inserted] = accessed_accounts_.try_emplace(address, AccessedAccount{access_list_.size(), /*cold=*/true});
+    if (inserted) {
+        if (is_low_address(address)) {
+            gas_dependent_ = true;
+        }
+        silkworm::AccessListEntry item;
+        item.account = address;
+        access_list_.push_back(std::move(item));
+    }
+}
+
+std::optional<uint64_t> AccessListTracer::predict_gas_used(const AccessList& initial_access_list, uint64_t gas_used) const {
+    if (gas_dependent_) {
+        return std::nullopt;
+    }
+    // The accounts and keys in the initial access list have been warm since the start and are charged as intrinsic gas
+    std::unordered_map<evmc::address, std::unordered_set<evmc::bytes32>> initial_accounts;
+    int64_t delta{0};
+    for (const auto& entry : initial_access_list) {
+        initial_accounts[entry.account].insert(entry.storage_keys.cbegin(), entry.storage_keys.cend());
+        delta -= kAccessListAddressCost + kAccessListStorageKeyCost * static_cast<int64_t>(entry.storage_keys.size());
+    }
+    for (const auto& entry : access_list_) {
+        delta += kAccessListAddressCost + kAccessListStorageKeyCost * static_cast<int64_t>(entry.storage_keys.size());
+        const auto initial_it = initial_accounts.find(entry.account);
+        const auto& accessed_account = accessed_accounts_.at(entry.account);
+        if (initial_it == initial_accounts.end()) {
+            if (accessed_account.cold) {
+                delta -= kColdAccountAccessSaving;
+            }
+            delta -= kColdSloadSaving * static_cast<int64_t>(entry.storage_keys.size());
+        } else {
+            for (const auto& storage_key : entry.storage_keys) {
+                if (!initial_it->second.contains(storage_key)) {
+                    delta -= kColdSloadSaving;
+                }
+            }
         }
     }
-    silkworm::AccessListEntry item;
-    item.account = address;
-    access_list_.push_back(item);
+    if (delta < 0 && static_cast<uint64_t>(-delta) > gas_used) {
+        return std::nullopt;
+    }
+    return static_cast<uint64_t>(static_cast<int64_t>(gas_used) + delta);
 }
 
 void AccessListTracer::dump(const std::string& user_string, const AccessList& acl) {
@@ -159,32 +236,22 @@ bool AccessListTracer::compare(const AccessList& acl1, const AccessList& acl2) {
     if (acl1.size() != acl2.size()) {
         return false;
     }
-    for (int i = 0; i < acl1.size(); i++) {
-        bool match_address = false;
-        for (int j = 0; j < acl2.size(); j++) {
-            if (acl2[j].account == acl1[i].account) {
-                match_address = true;
-                if (acl2[j].storage_keys.size() != acl1[i].storage_keys.size()) {
-                    return false;
-                }
-                bool match_storage = false;
-                for (int z = 0; z < acl1[i].storage_keys.size(); z++) {
-                    for (int t = 0; t < acl2[j].storage_keys.size(); t++) {
-                        if (acl2[j].storage_keys[t] == acl1[i].storage_keys[z]) {
-                            match_storage = true;
-                            break;
-                        }
-                    }
-                    if (!match_storage) {
-                        return false;
-                    }
-                }
-                break;
-            }
-        }
-        if (!match_address) {
+    std::unordered_map<evmc::address, const silkworm::AccessListEntry*> entries;
+    entries.reserve(acl2.size());
+    for (const auto& entry : acl2) {
+        entries.emplace(entry.account, &entry);
+    }
+    for (const auto& entry : acl1) {
+        const auto it = entries.find(entry.account);
+        if (it == entries.end() || it->second->storage_keys.size() != entry.storage_keys.size()) {
             return false;
         }
+        const std::unordered_set<evmc::bytes32> storage_keys{it->second->storage_keys.cbegin(), it->second->storage_keys.cend()};
+        for (const auto& storage_key : entry.storage_keys) {
+            if (!storage_keys.contains(storage_key)) {
+                return false;
+            }
+        }
     }
     return true;
 }
@@ -17,7 +17,11 @@
 #ifndef SILKRPC_CORE_EVM_ACCESS_LIST_TRACER_HPP_
 #define SILKRPC_CORE_EVM_ACCESS_LIST_TRACER_HPP_
 
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #pragma GCC diagnostic push
@@ -34,8 +38,23 @@
 
 namespace silkrpc {
 
+//! Tracer collecting the accounts and storage locations accessed by a call. Besides building the access list, it tracks
+//! the cold accesses and whether the execution could depend on the gas available, so that a single run is enough to
+//! predict the gas used with the collected access list applied (see predict_gas_used).
 class AccessListTracer : public silkworm::EvmTracer {
 public:
+    //! EIP-2930 intrinsic cost of each account in the access list
+    static constexpr int64_t kAccessListAddressCost{2400};
+
+    //! EIP-2930 intrinsic cost of each storage key in the access list
+    static constexpr int64_t kAccessListStorageKeyCost{1900};
+
+    //! EIP-2929 gas saved by the first access to a warm account instead of a cold one
+    static constexpr int64_t kColdAccountAccessSaving{2600 - 100};
+
+    //! EIP-2929 gas saved by the first SLOAD of a warm storage location instead of a cold one
+    static constexpr int64_t kColdSloadSaving{2100 - 100};
+
     explicit AccessListTracer(const evmc::address& from, const evmc::address& to): from_{from}, to_{to} {
     }
     AccessListTracer(const AccessListTracer&) = delete;
@@ -46,29 +65,41 @@ public:
     void on_execution_start(evmc_revision rev, const evmc_message& msg, evmone::bytes_view code) noexcept override;
     void on_instruction_start(uint32_t pc, const intx::uint256 *stack_top, const int stack_height,
             const evmone::ExecutionState& execution_state, const silkworm::IntraBlockState& intra_block_state) noexcept override;
-    void on_execution_end(const evmc_result& result, const silkworm::IntraBlockState& intra_block_state) noexcept override {}
-    void on_precompiled_run(const evmc_result& result, int64_t gas, const silkworm::IntraBlockState& intra_block_state) noexcept override {};
+    void on_execution_end(const evmc_result& result, const silkworm::IntraBlockState& intra_block_state) noexcept override;
+    void on_precompiled_run(const evmc_result& result, int64_t gas, const silkworm::IntraBlockState& intra_block_state) noexcept override;
     void on_reward_granted(const silkworm::CallResult& result, const silkworm::IntraBlockState& intra_block_state) noexcept override {};
     void on_creation_completed(const evmc_result& result, const silkworm::IntraBlockState& intra_block_state) noexcept override {};
 
+    void reset_access_list();
 
+    //! Whether the last execution could behave differently with another gas schedule, i.e. it read the gas left, ran out of
+    //! gas, reverted some frame (and thus its warm accesses), created contracts or changed storage (and thus the refunds)
+    bool gas_dependent() const { return gas_dependent_; }
+
+    //! Predict the gas used by the last execution if run with the collected access list instead of the initial one, given
+    //! the gas it has used: nothing is returned if the execution is gas dependent, so that it must be repeated instead
+    std::optional<uint64_t> predict_gas_used(const AccessList& initial_access_list, uint64_t gas_used) const;
 
-    void reset_access_list() {access_list_.clear();}
     static void dump(const std::string& str, const AccessList& acl);
     static bool compare(const AccessList& acl1, const AccessList& acl2);
 
 private:
+    //! The accessed storage keys of one account and whether its first access has been cold
+    struct AccessedAccount {
+        std::size_t index{0};
+        bool cold{false};
+        std::unordered_set<evmc::bytes32> storage_keys;
+    };
+
     inline bool exclude(const evmc::address& address);
-    inline evmc::address address_from_hex_string(const std::string& s);
-    inline bool is_storage_opcode(const std::string & opcode_name);
-    inline bool is_contract_opcode(const std::string & opcode_name);
-    inline bool is_call_opcode(const std::string & opcode_name);
 
     void add_storage(const evmc::address& address, const evmc::bytes32& storage);
     void add_address(const evmc::address& address);
 
-
     AccessList access_list_;
+    std::unordered_map<evmc::address, AccessedAccount> accessed_accounts_;
+    bool gas_dependent_{false};
+
     evmc::address from_;
     evmc::address to_;
 
@@ -0,0 +1,101 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "evm_access_list_tracer.hpp"
+
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+
+namespace silkrpc {
+
+using evmc::literals::operator""_address, evmc::literals::operator""_bytes32;
+
+static const evmc::address kFrom{0xe0a2bd4258d2768837baa26a28fe71dc079f84c7_address};
+static const evmc::address kTo{0x52728289eba496b6080d57d0250a90663a07e556_address};
+static const evmc::address kAccount1{0x0715a7794a1dc8e42615f059dd6e406a6594651a_address};
+static const evmc::address kAccount2{0x8e5476fc5990638a4fb0b5fd3f61bb4b5c5f395e_address};
+static const evmc::bytes32 kKey1{0x000000000000000000000000000000000000000000000000000000000000000a_bytes32};
+static const evmc::bytes32 kKey2{0x000000000000000000000000000000000000000000000000000000000000000b_bytes32};
+
+TEST_CASE("AccessListTracer::compare", "[silkrpc][core][evm_access_list_tracer]") {
+    const AccessList acl{{kAccount1, {kKey1, kKey2}}, {kAccount2, {}}};
+
+    SECTION("same entries in different order") {
+        const AccessList reordered{{kAccount2, {}}, {kAccount1, {kKey2, kKey1}}};
+        CHECK(AccessListTracer::compare(acl, reordered));
+        CHECK(acl == reordered);
+    }
+
+    SECTION("different accounts") {
+        const AccessList other{{kAccount1, {kKey1, kKey2}}, {kTo, {}}};
+        CHECK(!AccessListTracer::compare(acl, other));
+        CHECK(acl != other);
+    }
+
+    SECTION("different storage keys") {
+        const AccessList other{{kAccount1, {kKey1}}, {kAccount2, {kKey2}}};
+        CHECK(!AccessListTracer::compare(acl, other));
+        const AccessList same_size{{kAccount1, {kKey1, kKey1}}, {kAccount2, {}}};
+        CHECK(!AccessListTracer::compare(acl, same_size));
+    }
+
+    SECTION("different sizes") {
+        CHECK(!AccessListTracer::compare(acl, AccessList{}));
+        CHECK(AccessListTracer::compare(AccessList{}, AccessList{}));
+    }
+}
+
+TEST_CASE("AccessListTracer::predict_gas_used", "[silkrpc][core][evm_access_list_tracer]") {
+    AccessListTracer tracer{kFrom, kTo};
+
+    SECTION("no accesses") {
+        CHECK(!tracer.gas_dependent());
+        CHECK(tracer.predict_gas_used({}, 21'000) == 21'000);
+    }
+
+    SECTION("initial access list removed") {
+        const AccessList initial{{kAccount1, {kKey1, kKey2}}};
+        const auto initial_cost = AccessListTracer::kAccessListAddressCost + 2 * AccessListTracer::kAccessListStorageKeyCost;
+        CHECK(tracer.predict_gas_used(initial, 30'000) == 30'000 - initial_cost);
+        CHECK(!tracer.predict_gas_used(initial, 1'000));
+    }
+
+    SECTION("gas dependent before Berlin") {
+        evmc_message msg{};
+        tracer.on_execution_start(EVMC_ISTANBUL, msg, {});
+        CHECK(tracer.gas_dependent());
+        CHECK(!tracer.predict_gas_used({}, 21'000));
+        tracer.reset_access_list();
+        CHECK(!tracer.gas_dependent());
+    }
+
+    SECTION("gas dependent nested creation") {
+        evmc_message msg{};
+        msg.kind = EVMC_CREATE2;
+        msg.depth = 1;
+        tracer.on_execution_start(EVMC_LONDON, msg, {});
+        CHECK(tracer.gas_dependent());
+    }
+
+    SECTION("top-level creation") {
+        evmc_message msg{};
+        msg.kind = EVMC_CREATE;
+        tracer.on_execution_start(EVMC_LONDON, msg, {});
+        CHECK(!tracer.gas_dependent());
+    }
+}
+
+} // namespace silkrpc
@@ -16,10 +16,23 @@
 
 #include "evm_debug.hpp"
 
+#include <algorithm>
+#include <exception>
 #include <memory>
+#include <mutex>
 #include <stack>
+#include <stdexcept>
 #include <string>
+#include <utility>
 
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/use_future.hpp>
 #include <evmc/hex.hpp>
 #include <evmc/instructions.h>
 #include <intx/intx.hpp>
@@ -27,57 +40,366 @@
 #include <silkworm/third_party/evmone/lib/evmone/instructions.hpp>
 
 
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/hex.hpp>
 #include <silkrpc/common/log.hpp>
 #include <silkrpc/common/util.hpp>
+#include <silkrpc/concurrency/parallel_for.hpp>
 #include <silkrpc/core/evm_executor.hpp>
+#include <silkrpc/core/overlay_state.hpp>
 #include <silkrpc/core/rawdb/chain.hpp>
+#include <silkrpc/ethdb/transaction_database.hpp>
 #include <silkrpc/json/types.hpp>
 
 namespace silkrpc::debug {
 
 void from_json(const nlohmann::json& json, DebugConfig& tc) {
-    json.at("disableStorage").get_to(tc.disableStorage);
-    json.at("disableMemory").get_to(tc.disableMemory);
-    json.at("disableStack").get_to(tc.disableStack);
+    // The struct log options are meaningless for the native tracers, so they may be omitted
+    if (json.contains("disableStorage")) {
+        json.at("disableStorage").get_to(tc.disableStorage);
+    }
+    if (json.contains("disableMemory")) {
+        json.at("disableMemory").get_to(tc.disableMemory);
+    }
+    if (json.contains("disableStack")) {
+        json.at("disableStack").get_to(tc.disableStack);
+    }
+    if (json.contains("opcodes")) {
+        auto opcodes = json.at("opcodes").get<std::vector<std::string>>();
+        make_opcode_filter(opcodes); // just to reject the unknown names upfront
+        tc.opcodes = std::move(opcodes);
+    }
+    if (json.contains("maxDepth")) {
+        tc.maxDepth = json.at("maxDepth").get<std::uint32_t>();
+    }
+    if (json.contains("limit")) {
+        tc.limit = json.at("limit").get<std::uint64_t>();
+    }
+    if (json.contains("tracer")) {
+        const auto tracer = json.at("tracer").get<std::string>();
+        if (tracer != kCallTracer && tracer != kPrestateTracer) {
+            throw std::invalid_argument{"tracer " + tracer + " not supported"};
+        }
+        tc.tracer = tracer;
+    }
 }
 
 std::ostream& operator<<(std::ostream& out, const DebugConfig& tc) {
     out << "disableStorage: " << std::boolalpha << tc.disableStorage;
     out << " disableMemory: " << std::boolalpha << tc.disableMemory;
     out << " disableStack: " << std::boolalpha << tc.disableStack;
+    if (tc.tracer) {
+        out << " tracer: " << *tc.tracer;
+    }
+    if (tc.opcodes) {
+        out << " opcodes:";
+        for (const auto& opcode : *tc.opcodes) {
+            out << " " << opcode;
+        }
+    }
+    if (tc.maxDepth) {
+        out << " maxDepth: " << *tc.maxDepth;
+    }
+    if (tc.limit) {
+        out << " limit: " << *tc.limit;
+    }
 
     return out;
 }
 
+std::bitset<256> make_opcode_filter(const std::vector<std::string>& opcode_names) {
+    // The opcode values never change across revisions, so the names are just looked up in the latest ones
+    const auto names = evmc_get_instruction_names_table(EVMC_MAX_REVISION);
+    std::bitset<256> filter;
+    for (const auto& opcode_name : opcode_names) {
+        const auto& name = opcode_name == "SHA3" ? "KECCAK256" : opcode_name; // TODO(sixtysixter) for RPCDAEMON compatibility
+        bool found{false};
+        for (std::size_t opcode{0}; opcode < filter.size(); ++opcode) {
+            if (names[opcode] != nullptr && name == names[opcode]) {
+                filter.set(opcode);
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            throw std::invalid_argument{"opcode " + opcode_name + " not supported"};
+        }
+    }
+    return filter;
+}
+
+//! The size of the memory words in the struct logs
+constexpr std::size_t kMemoryWordSize{32};
+
+//! The opcode of MCOPY (EIP-5656), not yet in the evmc opcodes
+constexpr std::uint8_t kOpMcopy{0x5e};
+
+static nlohmann::json make_struct_log(const DebugLog& log, const DebugConfig& config) {
+    nlohmann::json entry;
+
+    entry["depth"] = log.depth;
+    entry["gas"] = log.gas;
+    entry["gasCost"] = log.gas_cost;
+    entry["op"] = log.op;
+    entry["pc"] = log.pc;
+    if (!config.disableStack) {
+        auto& stack = entry["stack"] = nlohmann::json::array();
+        for (const auto& item : log.stack) {
+            stack.push_back(to_quantity(item));
+        }
+    }
+    if (!config.disableMemory) {
+        auto& memory = entry["memory"] = nlohmann::json::array();
+        if (log.memory) {
+            const silkworm::ByteView bytes{*log.memory};
+            for (std::size_t start{0}; start < bytes.size(); start += kMemoryWordSize) {
+                memory.push_back(silkrpc::to_hex(bytes.substr(start, kMemoryWordSize)));
+            }
+        }
+    }
+    if (!config.disableStorage && !log.storage.empty()) {
+        entry["storage"] = log.storage;
+    }
+    if (log.error) {
+        entry["error"] = nlohmann::json::object();
+    }
+    return entry;
+}
+
+void to_json(nlohmann::json& json, const DebugCallFrame& frame) {
+    json["type"] = frame.type;
+    json["from"] = frame.from;
+    if (frame.to) {
+        json["to"] = frame.to.value();
+    }
+    json["value"] = to_quantity(frame.value);
+    json["gas"] = to_quantity(frame.gas);
+    json["gasUsed"] = to_quantity(frame.gas_used);
+    json["input"] = silkrpc::to_hex(frame.input, /*with_prefix=*/true);
+    if (!frame.output.empty()) {
+        json["output"] = silkrpc::to_hex(frame.output, /*with_prefix=*/true);
+    }
+    if (frame.error) {
+        json["error"] = frame.error.value();
+    }
+    if (!frame.calls.empty()) {
+        json["calls"] = frame.calls;
+    }
+}
+
+void to_json(nlohmann::json& json, const PrestateAccount& account) {
+    json["balance"] = to_quantity(account.balance);
+    json["nonce"] = account.nonce;
+    if (!account.code.empty()) {
+        json["code"] = silkrpc::to_hex(account.code, /*with_prefix=*/true);
+    }
+    if (!account.storage.empty()) {
+        auto& storage = json["storage"] = nlohmann::json::object();
+        for (const auto& [key, value] : account.storage) {
+            storage[silkrpc::to_hex(key, /*with_prefix=*/true)] = silkrpc::to_hex(value, /*with_prefix=*/true);
+        }
+    }
+}
+
 void to_json(nlohmann::json& json, const DebugTrace& debug_trace) {
+    if (debug_trace.call_frame) {
+        json = debug_trace.call_frame.value();
+        return;
+    }
+    if (debug_trace.prestate) {
+        json = nlohmann::json::object();
+        for (const auto& [address, account] : debug_trace.prestate.value()) {
+            json[silkrpc::to_hex(address, /*with_prefix=*/true)] = account;
+        }
+        return;
+    }
+
     json["failed"] = debug_trace.failed;
     json["gas"] = debug_trace.gas;
     json["returnValue"] = debug_trace.return_value;
 
-    const auto& config = debug_trace.debug_config;
     json["structLogs"] = nlohmann::json::array();
     for (auto& log : debug_trace.debug_logs) {
-        nlohmann::json entry;
-
-        entry["depth"] = log.depth;
-        entry["gas"] = log.gas;
-        entry["gasCost"] = log.gas_cost;
-        entry["op"] = log.op;
-        entry["pc"] = log.pc;
-        if (!config.disableStack) {
-            entry["stack"] = log.stack;
+        json["structLogs"].push_back(make_struct_log(log, debug_trace.debug_config));
+    }
+}
+
+DebugStreamWriter::DebugStreamWriter(boost::asio::io_context& io_context, json::Stream& stream, const DebugConfig& config, std::string prefix,
+    boost::asio::thread_pool* encoders, std::size_t flush_threshold)
+    : io_context_(io_context), stream_(stream), config_(config), flush_threshold_(flush_threshold), buffer_(std::move(prefix)),
+      encoders_(encoders) {
+    // The native tracer output is written as a whole at the end, so there is nothing worth encoding in background
+    if (encoders_ != nullptr && !config_.tracer) {
+        encoding_queue_ = std::make_shared<EncodingQueue>(config_);
+        batch_.reserve(kLogsPerBatch);
+    }
+}
+
+void DebugStreamWriter::begin_trace() {
+    if (num_traces_++ > 0) {
+        buffer_ += ',';
+    }
+    // The native tracer output is small enough to be written as a whole at the end
+    if (!config_.tracer) {
+        buffer_ += "{\"structLogs\":[";
+    }
+    num_logs_ = 0;
+    if (encoding_queue_) {
+        std::scoped_lock encoding_lock{encoding_queue_->encoding_mutex};
+        encoding_queue_->num_logs = 0;
+    }
+    trace_open_ = true;
+}
+
+void DebugStreamWriter::write_log(DebugLog&& log) noexcept {
+    if (write_exception_) {
+        return;
+    }
+    try {
+        if (encoding_queue_) {
+            batch_.push_back(std::move(log));
+            if (batch_.size() < kLogsPerBatch) {
+                return;
+            }
+            submit_batch();
+            take_encoded();
+        } else {
+            if (num_logs_++ > 0) {
+                buffer_ += ',';
+            }
+            buffer_ += make_struct_log(log, config_).dump();
         }
-        if (!config.disableMemory) {
-            entry["memory"] = log.memory;
+        // The tracer runs on the worker thread, so the write is done on the I/O context waiting for its completion (if
+        // already there, the buffer is just handed over at the end of the trace)
+        if (buffer_.size() >= flush_threshold_ && !io_context_.get_executor().running_in_this_thread()) {
+            boost::asio::co_spawn(io_context_, stream_.write(buffer_), boost::asio::use_future).get();
+            started_ = true;
+            buffer_.clear();
         }
-        if (!config.disableStorage && !log.storage.empty()) {
-            entry["storage"] = log.storage;
+    } catch (...) {
+        write_exception_ = std::current_exception();
+    }
+}
+
+boost::asio::awaitable<void> DebugStreamWriter::end_trace(const DebugTrace& debug_trace) {
+    if (encoding_queue_ && !write_exception_) {
+        co_await drain_batches();
+    }
+    if (config_.tracer) {
+        buffer_ += nlohmann::json(debug_trace).dump();
+    } else {
+        buffer_ += "],\"failed\":";
+        buffer_ += debug_trace.failed ? "true" : "false";
+        buffer_ += ",\"gas\":" + std::to_string(debug_trace.gas);
+        buffer_ += ",\"returnValue\":" + nlohmann::json(debug_trace.return_value).dump() + "}";
+    }
+    trace_open_ = false;
+    if (write_exception_ || buffer_.size() >= flush_threshold_) {
+        co_await write_buffer();
+    }
+}
+
+void DebugStreamWriter::EncodingQueue::drain() {
+    std::scoped_lock encoding_lock{encoding_mutex};
+    while (true) {
+        std::vector<DebugLog> batch;
+        {
+            std::scoped_lock lock{mutex};
+            if (batches.empty() || exception) {
+                return;
+            }
+            batch = std::move(batches.front());
+            batches.pop_front();
         }
-        if (log.error) {
-            entry["error"] = nlohmann::json::object();
+        std::string text;
+        try {
+            for (const auto& log : batch) {
+                if (num_logs++ > 0) {
+                    text += ',';
+                }
+                text += make_struct_log(log, config).dump();
+            }
+        } catch (...) {
+            std::scoped_lock lock{mutex};
+            exception = std::current_exception();
+            return;
         }
-        json["structLogs"].push_back(entry);
+        std::scoped_lock lock{mutex};
+        encoded += text;
+    }
+}
+
+void DebugStreamWriter::submit_batch() {
+    std::size_t num_pending_batches{0};
+    {
+        std::scoped_lock lock{encoding_queue_->mutex};
+        encoding_queue_->batches.push_back(std::move(batch_));
+        num_pending_batches = encoding_queue_->batches.size();
+    }
+    batch_ = {};
+    batch_.reserve(kLogsPerBatch);
+    if (num_pending_batches > kMaxPendingBatches) {
+        // The encoders lag too far behind (e.g. all busy executing), so help them rather than queueing more logs
+        encoding_queue_->drain();
+    } else {
+        boost::asio::post(*encoders_, [encoding_queue = encoding_queue_]() { encoding_queue->drain(); });
+    }
+}
+
+boost::asio::awaitable<void> DebugStreamWriter::drain_batches() {
+    if (!batch_.empty()) {
+        std::scoped_lock lock{encoding_queue_->mutex};
+        encoding_queue_->batches.push_back(std::move(batch_));
+        batch_ = {};
+    }
+    // The last batches are encoded by one encoder rather than here, so that the I/O context is never kept busy encoding
+    co_await boost::asio::async_compose<decltype(boost::asio::use_awaitable), void()>(
+        [this](auto&& self) {
+            boost::asio::post(*encoders_, [this, encoding_queue = encoding_queue_, self = std::move(self)]() mutable {
+                encoding_queue->drain();
+                boost::asio::post(io_context_, [self = std::move(self)]() mutable {
+                    self.complete();
+                });
+            });
+        },
+        boost::asio::use_awaitable);
+    take_encoded();
+}
+
+void DebugStreamWriter::take_encoded() {
+    std::scoped_lock lock{encoding_queue_->mutex};
+    if (encoding_queue_->exception) {
+        std::rethrow_exception(encoding_queue_->exception);
+    }
+    buffer_ += encoding_queue_->encoded;
+    encoding_queue_->encoded.clear();
+}
+
+boost::asio::awaitable<void> DebugStreamWriter::close(std::string_view suffix) {
+    if (encoding_queue_) {
+        // The struct logs still pending belong to the interrupted trace, if any, so they are just dropped
+        std::scoped_lock lock{encoding_queue_->mutex};
+        encoding_queue_->batches.clear();
+    }
+    if (trace_open_) {
+        // Terminate the interrupted trace just to keep the JSON text well-formed
+        buffer_ += config_.tracer ? "null" : "]}";
+        trace_open_ = false;
+    }
+    buffer_ += suffix;
+    co_await write_buffer();
+}
+
+boost::asio::awaitable<void> DebugStreamWriter::write_buffer() {
+    if (write_exception_) {
+        std::rethrow_exception(write_exception_);
+    }
+    if (buffer_.empty()) {
+        co_return;
     }
+    co_await stream_.write(buffer_);
+    started_ = true;
+    buffer_.clear();
 }
 
 std::string get_opcode_name(const char* const* names, std::uint8_t opcode) {
@@ -85,23 +407,30 @@ std::string get_opcode_name(const char* const* names, std::uint8_t opcode) {
     return (name != nullptr) ?name : "opcode 0x" + evmc::hex(opcode) + " not defined";
 }
 
-static std::string EMPTY_MEMORY(64, '0');
-
-void output_stack(std::vector<std::string>& vect, const evmone::uint256* stack, uint32_t stack_size) {
+void output_stack(std::vector<intx::uint256>& vect, const evmone::uint256* stack, uint32_t stack_size) {
     vect.reserve(stack_size);
     for (int i = stack_size -1 ; i >= 0; --i) {
-        vect.push_back("0x" + intx::to_string(stack[-i], 16));
+        vect.push_back(stack[-i]);
     }
 }
 
-void output_memory(std::vector<std::string>& vect, const evmone::Memory& memory) {
-    std::size_t len = 32;
-    vect.reserve(memory.size() / len);
-
-    const auto data = memory.data();
-    for (std::size_t start = 0; start < memory.size(); start += len) {
-        std::string entry{evmc::hex({data + start, len})};
-        vect.push_back(entry);
+//! Check if the instruction may write the memory w/o expanding it, i.e. changing its content but not its size
+static bool may_write_memory(std::uint8_t opcode) {
+    switch (opcode) {
+        case evmc_opcode::OP_MSTORE:
+        case evmc_opcode::OP_MSTORE8:
+        case evmc_opcode::OP_CALLDATACOPY:
+        case evmc_opcode::OP_CODECOPY:
+        case evmc_opcode::OP_EXTCODECOPY:
+        case evmc_opcode::OP_RETURNDATACOPY:
+        case evmc_opcode::OP_CALL:
+        case evmc_opcode::OP_CALLCODE:
+        case evmc_opcode::OP_DELEGATECALL:
+        case evmc_opcode::OP_STATICCALL:
+        case kOpMcopy:
+            return true;
+        default:
+            return false;
     }
 }
 
@@ -118,11 +447,23 @@ void insert_error(DebugLog& log, evmc_status_code status_code) {
     }
 }
 
+void DebugTracer::init_opcode_filter() {
+    if (config_.opcodes) {
+        try {
+            opcode_filter_ = make_opcode_filter(*config_.opcodes);
+        } catch (const std::invalid_argument& e) {
+            SILKRPC_WARN << "DebugTracer: " << e.what() << ", no struct log recorded\n";
+            opcode_filter_.emplace();
+        }
+    }
+}
+
 void DebugTracer::on_execution_start(evmc_revision rev, const evmc_message& msg, evmone::bytes_view code) noexcept {
     if (opcode_names_ == nullptr) {
         opcode_names_ = evmc_get_instruction_names_table(rev);
     }
     start_gas_ = msg.gas;
+    last_memory_.reset();
     evmc::address recipient(msg.recipient);
     evmc::address sender(msg.sender);
     SILKRPC_DEBUG << "on_execution_start: gas: " << std::dec << msg.gas
@@ -140,12 +481,11 @@ void DebugTracer::on_instruction_start(uint32_t pc , const intx::uint256 *stack_
     evmc::address sender(execution_state.msg->sender);
 
     const auto opcode = execution_state.original_code[pc];
-    auto opcode_name = get_opcode_name(opcode_names_, opcode);
 
     SILKRPC_DEBUG << "on_instruction_start:"
         << " pc: " << std::dec << pc
         << " opcode: 0x" << std::hex << evmc::hex(opcode)
-        << " opcode_name: " << opcode_name
+        << " opcode_name: " << get_opcode_name(opcode_names_, opcode)
         << " recipient: " << recipient
         << " sender: " << sender
         << " execution_state: {"
@@ -155,27 +495,28 @@ void DebugTracer::on_instruction_start(uint32_t pc , const intx::uint256 *stack_
         << "   msg.depth: " << std::dec << execution_state.msg->depth
         << "}\n";
 
+    // The storage seen so far is tracked even if the instruction is filtered out, because the next logs show it
     bool output_storage = false;
     if (!config_.disableStorage) {
-        if (opcode_name == "SLOAD" && stack_height >= 1) {
-            const auto address = silkworm::bytes32_from_hex(intx::hex(stack_top[0]));
+        if (opcode == evmc_opcode::OP_SLOAD && stack_height >= 1) {
+            const auto address = intx::be::store<evmc::bytes32>(stack_top[0]);
             const auto value = intra_block_state.get_current_storage(recipient, address);
-            storage_[recipient][silkworm::to_hex(address)] = silkworm::to_hex(value);
+            storage_[recipient][silkrpc::to_hex(address)] = silkrpc::to_hex(value);
             output_storage = true;
-        } else if (opcode_name == "SSTORE" && stack_height >= 2) {
-            const auto address = silkworm::bytes32_from_hex(intx::hex(stack_top[0]));
-            const auto value = silkworm::bytes32_from_hex(intx::hex(stack_top[-1]));
-            storage_[recipient][silkworm::to_hex(address)] = silkworm::to_hex(value);
+        } else if (opcode == evmc_opcode::OP_SSTORE && stack_height >= 2) {
+            const auto address = intx::be::store<evmc::bytes32>(stack_top[0]);
+            const auto value = intx::be::store<evmc::bytes32>(stack_top[-1]);
+            storage_[recipient][silkrpc::to_hex(address)] = silkrpc::to_hex(value);
             output_storage = true;
         }
     }
 
-    std::vector<std::string> current_memory;
     if (!config_.disableMemory) {
-        output_memory(current_memory, execution_state.memory);
+        track_memory(execution_state, opcode);
     }
 
-    if (logs_.size() > 0) {
+    // The previous log, if any, is completed just by the instruction following it
+    if (last_log_open_) {
         auto& log = logs_[logs_.size() - 1];
         auto depth = log.depth;
         if (depth == execution_state.msg->depth + 1) {
@@ -185,27 +526,43 @@ void DebugTracer::on_instruction_start(uint32_t pc , const intx::uint256 *stack_
             } else {
                log.gas_cost = log.gas - execution_state.gas_left;
             }
-            if (!config_.disableMemory) {
-                auto& memory = log.memory;
-                for (int idx = memory.size(); idx < current_memory.size(); idx++) {
-                    memory.push_back(EMPTY_MEMORY);
-                }
+            if (!config_.disableMemory && log.memory && log.memory->size() < execution_state.memory.size()) {
+                // The memory expanded by the previous instruction is given already zeroed, never touching the shared snapshot
+                auto expanded_memory = std::make_shared<silkworm::Bytes>(*log.memory);
+                expanded_memory->resize(execution_state.memory.size(), 0);
+                log.memory = std::move(expanded_memory);
             }
         } else if (depth == execution_state.msg->depth) {
             log.gas_cost = log.gas - execution_state.gas_left;
         }
+        last_log_open_ = false;
     }
+    if (sink_ && logs_.size() > 0) {
+        // The previous log is never updated once the next one starts, so it can be given away
+        sink_(std::move(logs_[logs_.size() - 1]));
+        logs_.clear();
+    }
+
+    // Filter out the instruction before building its log, so that the skipped ones cost no allocation
+    const auto log_depth = static_cast<std::uint32_t>(execution_state.msg->depth + 1);
+    if ((opcode_filter_ && !opcode_filter_->test(opcode)) || (config_.maxDepth && log_depth > *config_.maxDepth) ||
+        (config_.limit && num_logs_ >= *config_.limit)) {
+        return;
+    }
+
+    const auto opcode_name = get_opcode_name(opcode_names_, opcode);
+
     DebugLog log;
     log.pc = pc;
     log.op = opcode_name == "KECCAK256" ? "SHA3" : opcode_name; // TODO(sixtysixter) for RPCDAEMON compatibility
     log.gas = execution_state.gas_left;
-    log.depth = execution_state.msg->depth + 1;
+    log.depth = log_depth;
 
     if (!config_.disableStack) {
         output_stack(log.stack, stack_top, stack_height);
     }
     if (!config_.disableMemory) {
-        log.memory = current_memory;
+        log.memory = snapshot_memory(execution_state.memory);
     }
     if (output_storage) {
         for (const auto &entry : storage_[recipient]) {
@@ -215,6 +572,32 @@ void DebugTracer::on_instruction_start(uint32_t pc , const intx::uint256 *stack_
     insert_error(log, execution_state.status);
 
     logs_.push_back(log);
+    last_log_open_ = true;
+    ++num_logs_;
+}
+
+void DebugTracer::track_memory(const evmone::ExecutionState& execution_state, std::uint8_t opcode) {
+    // Memory is changed just by expanding it or by the writing instructions, so the last snapshot is dropped only after them
+    const auto depth = static_cast<std::uint32_t>(execution_state.msg->depth);
+    if (last_memory_ && (last_memory_depth_ != depth || last_memory_->size() != execution_state.memory.size() || may_write_memory(last_opcode_))) {
+        last_memory_.reset();
+    }
+    last_memory_depth_ = depth;
+    last_opcode_ = opcode;
+}
+
+std::shared_ptr<const silkworm::Bytes> DebugTracer::snapshot_memory(const evmone::Memory& memory) {
+    if (!last_memory_) {
+        last_memory_ = std::make_shared<const silkworm::Bytes>(memory.data(), memory.size());
+    }
+    return last_memory_;
+}
+
+void DebugTracer::flush() {
+    if (sink_ && logs_.size() > 0) {
+        sink_(std::move(logs_[logs_.size() - 1]));
+        logs_.clear();
+    }
 }
 
 void DebugTracer::on_precompiled_run(const evmc_result& result, int64_t gas, const silkworm::IntraBlockState& intra_block_state) noexcept {
@@ -228,7 +611,7 @@ void DebugTracer::on_precompiled_run(const evmc_result& result, int64_t gas, con
 
 
 void DebugTracer::on_execution_end(const evmc_result& result, const silkworm::IntraBlockState& intra_block_state) noexcept {
-    if (logs_.size() > 0) {
+    if (last_log_open_) {
         auto& log = logs_[logs_.size() - 1];
 
         insert_error(log, result.status_code);
@@ -253,8 +636,204 @@ void DebugTracer::on_execution_end(const evmc_result& result, const silkworm::In
         << "\n";
 }
 
+void CallTracer::on_execution_start(evmc_revision rev, const evmc_message& msg, evmone::bytes_view code) noexcept {
+    DebugCallFrame* frame{&root_};
+    if (!frames_.empty()) {
+        auto& calls = frames_.top()->calls;
+        calls.emplace_back();
+        frame = &calls.back();
+    }
+
+    frame->from = evmc::address{msg.sender};
+    frame->to = evmc::address{msg.recipient};
+    frame->value = intx::be::load<intx::uint256>(msg.value);
+    frame->gas = static_cast<std::uint64_t>(msg.gas);
+    frame->input = silkworm::Bytes{msg.input_data, msg.input_size};
+    const bool in_static_mode = (msg.flags & evmc_flags::EVMC_STATIC) != 0;
+    switch (msg.kind) {
+        case evmc_call_kind::EVMC_CALL:
+            frame->type = in_static_mode ? "STATICCALL" : "CALL";
+            break;
+        case evmc_call_kind::EVMC_DELEGATECALL:
+            frame->type = "DELEGATECALL";
+            frame->from = evmc::address{msg.recipient};
+            frame->to = evmc::address{msg.code_address};
+            break;
+        case evmc_call_kind::EVMC_CALLCODE:
+            frame->type = "CALLCODE";
+            frame->to = evmc::address{msg.code_address};
+            break;
+        case evmc_call_kind::EVMC_CREATE:
+        case evmc_call_kind::EVMC_CREATE2:
+            frame->type = msg.kind == evmc_call_kind::EVMC_CREATE ? "CREATE" : "CREATE2";
+            frame->input = silkworm::Bytes{code};
+            break;
+    }
+    frames_.push(frame);
+
+    SILKRPC_DEBUG << "CallTracer::on_execution_start: depth: " << msg.depth << " type: " << frame->type << " gas: " << std::dec << msg.gas << "\n";
+}
+
+void CallTracer::on_execution_end(const evmc_result& result, const silkworm::IntraBlockState& intra_block_state) noexcept {
+    if (frames_.empty()) {
+        return;
+    }
+    auto& frame = *frames_.top();
+    frames_.pop();
+
+    frame.gas_used = frame.gas - static_cast<std::uint64_t>(result.gas_left);
+    frame.output = silkworm::Bytes{result.output_data, result.output_size};
+    switch (result.status_code) {
+        case evmc_status_code::EVMC_SUCCESS:
+            break;
+        case evmc_status_code::EVMC_REVERT:
+            frame.error = "execution reverted";
+            break;
+        case evmc_status_code::EVMC_OUT_OF_GAS:
+            frame.error = "out of gas";
+            break;
+        case evmc_status_code::EVMC_UNDEFINED_INSTRUCTION:
+        case evmc_status_code::EVMC_INVALID_INSTRUCTION:
+            frame.error = "invalid opcode";
+            break;
+        case evmc_status_code::EVMC_STACK_OVERFLOW:
+            frame.error = "stack overflow";
+            break;
+        case evmc_status_code::EVMC_STACK_UNDERFLOW:
+            frame.error = "stack underflow";
+            break;
+        case evmc_status_code::EVMC_BAD_JUMP_DESTINATION:
+            frame.error = "invalid jump destination";
+            break;
+        default:
+            frame.error = "execution failed";
+            break;
+    }
+
+    SILKRPC_DEBUG << "CallTracer::on_execution_end: status_code: " << result.status_code << " gas_used: " << std::dec << frame.gas_used << "\n";
+}
+
+void PrestateTracer::on_execution_start(evmc_revision rev, const evmc_message& msg, evmone::bytes_view code) noexcept {
+    addresses_.insert(evmc::address{msg.sender});
+    addresses_.insert(evmc::address{msg.recipient});
+    if (msg.kind == evmc_call_kind::EVMC_DELEGATECALL || msg.kind == evmc_call_kind::EVMC_CALLCODE) {
+        addresses_.insert(evmc::address{msg.code_address});
+    }
+}
+
+void PrestateTracer::on_instruction_start(uint32_t pc, const intx::uint256* stack_top, const int stack_height,
+              const evmone::ExecutionState& execution_state, const silkworm::IntraBlockState& intra_block_state) noexcept {
+    const auto opcode = execution_state.original_code[pc];
+    switch (opcode) {
+        case evmc_opcode::OP_SLOAD:
+        case evmc_opcode::OP_SSTORE:
+            if (stack_height >= 1) {
+                storage_keys_[evmc::address{execution_state.msg->recipient}].insert(intx::be::store<evmc::bytes32>(stack_top[0]));
+            }
+            break;
+        case evmc_opcode::OP_BALANCE:
+        case evmc_opcode::OP_EXTCODESIZE:
+        case evmc_opcode::OP_EXTCODECOPY:
+        case evmc_opcode::OP_EXTCODEHASH:
+        case evmc_opcode::OP_SELFDESTRUCT:
+            if (stack_height >= 1) {
+                addresses_.insert(intx::be::trunc<evmc::address>(stack_top[0]));
+            }
+            break;
+        case evmc_opcode::OP_CALL:
+        case evmc_opcode::OP_CALLCODE:
+        case evmc_opcode::OP_DELEGATECALL:
+        case evmc_opcode::OP_STATICCALL:
+            // The callee may have no code, so its execution may not start at all
+            if (stack_height >= 2) {
+                addresses_.insert(intx::be::trunc<evmc::address>(stack_top[-1]));
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void PrestateTracer::on_reward_granted(const silkworm::CallResult& result, const silkworm::IntraBlockState& intra_block_state) noexcept {
+    SILKRPC_DEBUG << "PrestateTracer::on_reward_granted:"
+        << " result.status_code: " << result.status
+        << ", #touched: " << std::dec << intra_block_state.touched().size()
+        << ", #accessed: " << addresses_.size()
+        << "\n";
+
+    for (const auto& address : intra_block_state.touched()) {
+        addresses_.insert(address);
+    }
+    for (const auto& address : addresses_) {
+        if (!state_addresses_.exists(address) && !state_addresses_.balance_exists(address)) {
+            continue;
+        }
+        auto& account = prestate_[address];
+        account.balance = state_addresses_.get_balance(address);
+        account.nonce = state_addresses_.get_nonce(address);
+        account.code = silkworm::Bytes{state_addresses_.get_code(address)};
+        const auto keys_it = storage_keys_.find(address);
+        if (keys_it != storage_keys_.end()) {
+            for (const auto& key : keys_it->second) {
+                account.storage[key] = intra_block_state.get_original_storage(address, key);
+            }
+        }
+    }
+}
+
+//! Create the tracers of one transaction as configured, returning the struct log tracer if any: its output goes to the
+//! writer if given, otherwise it is recorded in the trace along with the one of the native tracers
+static std::shared_ptr<DebugTracer> make_tracers(const DebugConfig& config, DebugTrace& debug_trace, trace::StateAddresses& state_addresses,
+        DebugStreamWriter* writer, silkrpc::Tracers& tracers) {
+    debug_trace.debug_config = config;
+    if (writer != nullptr) {
+        writer->begin_trace();
+    }
+    if (config.tracer == kCallTracer) {
+        debug_trace.call_frame.emplace();
+        tracers.push_back(std::make_shared<CallTracer>(*debug_trace.call_frame));
+        return nullptr;
+    }
+    if (config.tracer == kPrestateTracer) {
+        debug_trace.prestate.emplace();
+        tracers.push_back(std::make_shared<PrestateTracer>(*debug_trace.prestate, state_addresses));
+        // Keep the state addresses up to date for the next transaction (if any), after the prestate has been recorded
+        tracers.push_back(std::make_shared<trace::IntraBlockStateTracer>(state_addresses));
+        return nullptr;
+    }
+    std::shared_ptr<DebugTracer> debug_tracer;
+    if (writer != nullptr) {
+        debug_tracer = std::make_shared<DebugTracer>([writer](DebugLog&& log) { writer->write_log(std::move(log)); }, config);
+    } else {
+        debug_tracer = std::make_shared<DebugTracer>(debug_trace.debug_logs, config);
+    }
+    tracers.push_back(debug_tracer);
+    return debug_tracer;
+}
+
+//! Complete the outermost call frame with the whole transaction gas, filling it if no code has been executed at all
+static void complete_call_frame(DebugCallFrame& frame, const silkrpc::Transaction& transaction, std::uint64_t gas_used) {
+    if (frame.type.empty()) {
+        frame.type = transaction.to ? "CALL" : "CREATE";
+        frame.from = transaction.from.value_or(evmc::address{});
+        frame.to = transaction.to;
+        frame.value = transaction.value;
+        frame.input = transaction.data;
+    }
+    frame.gas = transaction.gas_limit;
+    frame.gas_used = gas_used;
+}
+
+//! Return the number of contiguous segments the block transactions are split in to be traced concurrently, if possible
+static std::size_t num_trace_segments(std::size_t num_transactions, const ethdb::Database* database) {
+    if (database == nullptr) {
+        return 1;
+    }
+    return std::min(kDebugTraceMaxConcurrentSegments, (num_transactions + kDebugTraceMinTxsPerSegment - 1) / kDebugTraceMinTxsPerSegment);
+}
+
 template<typename WorldState, typename VM>
-boost::asio::awaitable<std::vector<DebugTrace>> DebugExecutor<WorldState, VM>::execute(const silkworm::Block& block) {
+boost::asio::awaitable<std::vector<DebugTrace>> DebugExecutor<WorldState, VM>::execute(const silkworm::Block& block, ethdb::Database* database) {
     auto block_number = block.header.number;
     const auto& transactions = block.transactions;
 
@@ -262,11 +841,129 @@ boost::asio::awaitable<std::vector<DebugTrace>> DebugExecutor<WorldState, VM>::e
 
     const auto chain_id = co_await core::rawdb::read_chain_id(database_reader_);
     const auto chain_config_ptr = lookup_chain_config(chain_id);
-    state::RemoteState remote_state{io_context_, database_reader_, block_number-1};
-    EVMExecutor<WorldState, VM> executor{io_context_, database_reader_, *chain_config_ptr, workers_, block_number-1, remote_state};
 
     std::vector<DebugTrace> debug_traces(transactions.size());
-    for (std::uint64_t idx = 0; idx < transactions.size(); idx++) {
+
+    // Split the transactions in contiguous segments traced concurrently, each one within its own transaction if possible
+    const auto num_segments = num_trace_segments(transactions.size(), database);
+    if (num_segments <= 1) {
+        state::RemoteState remote_state{io_context_, database_reader_, block_number-1};
+        state::OverlayState block_state{remote_state};
+        EVMExecutor<WorldState, VM> executor{io_context_, database_reader_, *chain_config_ptr, workers_, block_number-1, remote_state, block_state};
+        co_await execute_transactions(block_state, executor, block, 0, transactions.size(), debug_traces);
+        co_return debug_traces;
+    }
+
+    co_await execute_segments(block, *chain_config_ptr, *database, num_segments, debug_traces);
+    co_return debug_traces;
+}
+
+template<typename WorldState, typename VM>
+boost::asio::awaitable<void> DebugExecutor<WorldState, VM>::execute(const silkworm::Block& block, DebugStreamWriter& writer, ethdb::Database* database) {
+    auto block_number = block.header.number;
+    const auto& transactions = block.transactions;
+
+    SILKRPC_DEBUG << "execute: block_number: " << block_number << " #txns: " << transactions.size() << " config: " << config_ << "\n";
+
+    const auto chain_id = co_await core::rawdb::read_chain_id(database_reader_);
+    const auto chain_config_ptr = lookup_chain_config(chain_id);
+
+    std::vector<DebugTrace> debug_traces(transactions.size());
+
+    // The native tracer outputs are written as a whole anyway, so they are traced in concurrent segments written in order;
+    // the struct logs are rather written while traced, so that memory stays bounded, hence their transactions are serial
+    const auto num_segments = config_.tracer ? num_trace_segments(transactions.size(), database) : std::size_t{1};
+    if (num_segments <= 1) {
+        state::RemoteState remote_state{io_context_, database_reader_, block_number-1};
+        state::OverlayState block_state{remote_state};
+        EVMExecutor<WorldState, VM> executor{io_context_, database_reader_, *chain_config_ptr, workers_, block_number-1, remote_state, block_state};
+        co_await execute_transactions(block_state, executor, block, 0, transactions.size(), debug_traces, &writer);
+        co_return;
+    }
+
+    co_await execute_segments(block, *chain_config_ptr, *database, num_segments, debug_traces, &writer);
+}
+
+template<typename WorldState, typename VM>
+boost::asio::awaitable<void> DebugExecutor<WorldState, VM>::execute_segments(const silkworm::Block& block, const silkworm::ChainConfig& chain_config,
+        ethdb::Database& database, std::size_t num_segments, std::vector<DebugTrace>& debug_traces, DebugStreamWriter* writer) {
+    const auto block_number = block.header.number;
+    const auto& transactions = block.transactions;
+    const auto segment_size = (transactions.size() + num_segments - 1) / num_segments;
+    const auto executor = co_await boost::asio::this_coro::executor;
+
+    // Each segment traced ahead waits for the preceding ones to be written, unless some has failed
+    std::size_t num_segments_written{0};
+    bool writing_failed{false};
+    boost::asio::steady_timer segment_written{executor};
+
+    co_await parallel_for(executor, num_segments, num_segments, [&](std::size_t segment) -> boost::asio::awaitable<void> {
+        const auto segment_begin = std::min(segment * segment_size, transactions.size());
+        const auto segment_end = std::min(segment_begin + segment_size, transactions.size());
+        auto segment_tx = co_await database.begin();
+        std::exception_ptr segment_exception;
+        try {
+            ethdb::TransactionDatabase segment_database{*segment_tx};
+            state::RemoteState remote_state{io_context_, segment_database, block_number-1};
+            state::OverlayState block_state{remote_state};
+            EVMExecutor<WorldState, VM> segment_executor{io_context_, segment_database, chain_config, workers_, block_number-1, remote_state,
+                                                         block_state};
+            co_await execute_transactions(block_state, segment_executor, block, segment_begin, segment_end, debug_traces);
+        } catch (...) {
+            segment_exception = std::current_exception();
+        }
+        co_await segment_tx->close(); // RAII not (yet) available with coroutines
+        if (writer != nullptr) {
+            while (!segment_exception && !writing_failed && num_segments_written < segment) {
+                segment_written.expires_at(boost::asio::steady_timer::time_point::max());
+                boost::system::error_code ec;
+                co_await segment_written.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+            }
+            if (!segment_exception && !writing_failed) {
+                try {
+                    for (auto idx{segment_begin}; idx < segment_end; ++idx) {
+                        writer->begin_trace();
+                        co_await writer->end_trace(debug_traces[idx]);
+                        // The trace has been written, so there is no need to keep it
+                        debug_traces[idx] = {};
+                    }
+                } catch (...) {
+                    segment_exception = std::current_exception();
+                }
+            }
+            writing_failed = writing_failed || segment_exception;
+            ++num_segments_written;
+            segment_written.cancel();
+        }
+        if (segment_exception) {
+            std::rethrow_exception(segment_exception);
+        }
+    });
+}
+
+template<typename WorldState, typename VM>
+boost::asio::awaitable<void> DebugExecutor<WorldState, VM>::execute_transactions(silkworm::State& block_state,
+        EVMExecutor<WorldState, VM>& executor, const silkworm::Block& block, std::size_t begin, std::size_t end, std::vector<DebugTrace>& debug_traces,
+        DebugStreamWriter* writer) {
+    // The state preceding each transaction is tracked just for the prestate tracer
+    silkworm::IntraBlockState initial_ibs{block_state};
+    trace::StateAddresses state_addresses{initial_ibs};
+    silkrpc::Tracers replay_tracers;
+    if (config_.tracer == kPrestateTracer) {
+        replay_tracers.push_back(std::make_shared<trace::IntraBlockStateTracer>(state_addresses));
+    }
+
+    // Replay the preceding transactions without tracing, so that the state is the same as tracing the whole block
+    for (std::uint64_t idx = 0; idx < begin; idx++) {
+        silkrpc::Transaction txn{block.transactions[idx]};
+        if (!txn.from) {
+            txn.recover_sender();
+        }
+        SILKRPC_DEBUG << "replaying transaction: idx: " << idx << " txn: " << txn << "\n";
+        co_await executor.call(block, txn, replay_tracers, /* refund */false, /* gasBailout */false);
+    }
+
+    for (std::uint64_t idx = begin; idx < end; idx++) {
         silkrpc::Transaction txn{block.transactions[idx]};
         if (!txn.from) {
             txn.recover_sender();
@@ -275,10 +972,8 @@ boost::asio::awaitable<std::vector<DebugTrace>> DebugExecutor<WorldState, VM>::e
 
         auto& debug_trace = debug_traces.at(idx);
 
-        debug_trace.debug_config = config_;
-        auto debug_tracer = std::make_shared<debug::DebugTracer>(debug_trace.debug_logs, config_);
-
-        silkrpc::Tracers tracers{debug_tracer};
+        silkrpc::Tracers tracers;
+        const auto debug_tracer = make_tracers(config_, debug_trace, state_addresses, writer, tracers);
         const auto execution_result = co_await executor.call(block, txn, tracers, /* refund */false, /* gasBailout */false);
 
         if (execution_result.pre_check_error) {
@@ -287,10 +982,20 @@ boost::asio::awaitable<std::vector<DebugTrace>> DebugExecutor<WorldState, VM>::e
         } else {
             debug_trace.failed = execution_result.error_code != evmc_status_code::EVMC_SUCCESS;
             debug_trace.gas = txn.gas_limit - execution_result.gas_left;
-            debug_trace.return_value = silkworm::to_hex(execution_result.data);
+            debug_trace.return_value = silkrpc::to_hex(execution_result.data);
+        }
+        if (debug_trace.call_frame) {
+            complete_call_frame(*debug_trace.call_frame, txn, static_cast<std::uint64_t>(debug_trace.gas));
+        }
+        if (writer != nullptr) {
+            if (debug_tracer) {
+                debug_tracer->flush();
+            }
+            co_await writer->end_trace(debug_trace);
+            // The trace has been written, so there is no need to keep it
+            debug_trace = {};
         }
     }
-    co_return debug_traces;
 }
 
 template<typename WorldState, typename VM>
@@ -300,9 +1005,17 @@ boost::asio::awaitable<DebugExecutorResult> DebugExecutor<WorldState, VM>::execu
     co_return result;
 }
 
+template<typename WorldState, typename VM>
+boost::asio::awaitable<DebugExecutorResult> DebugExecutor<WorldState, VM>::execute(const silkworm::Block& block, const silkrpc::Call& call,
+        DebugStreamWriter& writer) {
+    silkrpc::Transaction transaction{call.to_transaction()};
+    auto result = co_await execute(block.header.number, block, transaction, -1, &writer);
+    co_return result;
+}
+
 template<typename WorldState, typename VM>
 boost::asio::awaitable<DebugExecutorResult> DebugExecutor<WorldState, VM>::execute(std::uint64_t block_number, const silkworm::Block& block,
-        const silkrpc::Transaction& transaction, std::int32_t index) {
+        const silkrpc::Transaction& transaction, std::int32_t index, DebugStreamWriter* writer) {
     SILKRPC_INFO << "DebugExecutor::execute: "
         << " block_number: " << block_number
         << " transaction: {" << transaction << "}"
@@ -313,26 +1026,51 @@ boost::asio::awaitable<DebugExecutorResult> DebugExecutor<WorldState, VM>::execu
     const auto chain_id = co_await core::rawdb::read_chain_id(database_reader_);
     const auto chain_config_ptr = lookup_chain_config(chain_id);
     state::RemoteState remote_state{io_context_, database_reader_, block_number};
-    EVMExecutor<WorldState, VM> executor{io_context_, database_reader_, *chain_config_ptr, workers_, block_number, remote_state};
+    state::OverlayState block_state{remote_state};
 
-    for (auto idx = 0; idx < index; idx++) {
+    // The state preceding the transaction is tracked just for the prestate tracer
+    silkworm::IntraBlockState initial_ibs{block_state};
+    trace::StateAddresses state_addresses{initial_ibs};
+    silkrpc::Tracers replay_tracers;
+    if (config_.tracer == kPrestateTracer) {
+        replay_tracers.push_back(std::make_shared<trace::IntraBlockStateTracer>(state_addresses));
+    }
+
+    // The preceding transactions are executed from the nearest checkpoint of the block (if any), see TraceCallExecutor
+    const bool use_checkpoints = checkpoint_cache_ != nullptr && index > 0;
+    const auto block_hash = use_checkpoints ? block.header.hash() : evmc::bytes32{};
+    const auto checkpoint = use_checkpoints ? checkpoint_cache_->find(block_hash, static_cast<uint32_t>(index)) : nullptr;
+    std::optional<state::OverlayState> checkpoint_state;
+    if (use_checkpoints) {
+        checkpoint_state.emplace(block_state);
+    }
+    if (checkpoint) {
+        checkpoint_state->apply(*checkpoint);
+        state_addresses.apply(*checkpoint);
+    }
+    state::OverlayState& execution_state = checkpoint_state ? *checkpoint_state : block_state;
+    const std::int32_t first_index = checkpoint ? static_cast<std::int32_t>(checkpoint->transaction_count) : 0;
+
+    EVMExecutor<WorldState, VM> executor{io_context_, database_reader_, *chain_config_ptr, workers_, block_number, remote_state, execution_state};
+    for (auto idx = first_index; idx < index; idx++) {
         silkrpc::Transaction txn{block.transactions[idx]};
 
         if (!txn.from) {
             txn.recover_sender();
         }
-        const auto execution_result = co_await executor.call(block, txn);
+        const auto execution_result = co_await executor.call(block, txn, replay_tracers);
     }
     executor.reset();
+    if (use_checkpoints && index > first_index) {
+        trace::store_state_checkpoint(*checkpoint_cache_, block_hash, checkpoint, static_cast<uint32_t>(index), executor, *checkpoint_state,
+                                      block.header.number);
+    }
 
     DebugExecutorResult result;
     auto& debug_trace = result.debug_trace;
 
-    debug_trace.debug_config = config_;
-
-    auto debug_tracer = std::make_shared<debug::DebugTracer>(debug_trace.debug_logs, config_);
-
-    silkrpc::Tracers tracers{debug_tracer};
+    silkrpc::Tracers tracers;
+    const auto debug_tracer = make_tracers(config_, debug_trace, state_addresses, writer, tracers);
     const auto execution_result = co_await executor.call(block, transaction, tracers);
 
     if (execution_result.pre_check_error) {
@@ -340,7 +1078,16 @@ boost::asio::awaitable<DebugExecutorResult> DebugExecutor<WorldState, VM>::execu
     } else {
         debug_trace.failed = execution_result.error_code != evmc_status_code::EVMC_SUCCESS;
         debug_trace.gas = transaction.gas_limit - execution_result.gas_left;
-        debug_trace.return_value = silkworm::to_hex(execution_result.data);
+        debug_trace.return_value = silkrpc::to_hex(execution_result.data);
+        if (debug_trace.call_frame) {
+            complete_call_frame(*debug_trace.call_frame, transaction, static_cast<std::uint64_t>(debug_trace.gas));
+        }
+        if (writer != nullptr) {
+            if (debug_tracer) {
+                debug_tracer->flush();
+            }
+            co_await writer->end_trace(debug_trace);
+        }
     }
 
     co_return result;
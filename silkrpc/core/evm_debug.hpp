@@ -17,11 +17,24 @@
 #ifndef SILKRPC_CORE_EVM_DEBUG_HPP_
 #define SILKRPC_CORE_EVM_DEBUG_HPP_
 
+#include <bitset>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
 #include <stack>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include <silkrpc/config.hpp>
+
 #include <boost/asio/awaitable.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/thread_pool.hpp>
@@ -33,20 +46,39 @@
 #pragma GCC diagnostic pop
 #include <silkworm/state/intra_block_state.hpp>
 
+#include <silkrpc/common/state_checkpoint_cache.hpp>
 #include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/core/evm_executor.hpp>
+#include <silkrpc/core/evm_trace.hpp>
 #include <silkrpc/core/rawdb/accessors.hpp>
+#include <silkrpc/ethdb/database.hpp>
+#include <silkrpc/json/stream.hpp>
 #include <silkrpc/types/block.hpp>
 #include <silkrpc/types/call.hpp>
 #include <silkrpc/types/transaction.hpp>
 
 namespace silkrpc::debug {
 
+//! The names of the native tracers producing their own output in place of the struct logs
+constexpr const char* kCallTracer{"callTracer"};
+constexpr const char* kPrestateTracer{"prestateTracer"};
+
 struct DebugConfig {
     bool disableStorage{false};
     bool disableMemory{false};
     bool disableStack{false};
+    std::optional<std::string> tracer;
+    //! The names of the only opcodes whose struct logs are recorded, if any
+    std::optional<std::vector<std::string>> opcodes;
+    //! The max call depth (starting from 1) whose struct logs are recorded, if any
+    std::optional<std::uint32_t> maxDepth;
+    //! The max number of struct logs recorded, if any
+    std::optional<std::uint64_t> limit;
 };
 
+//! Return the set of opcodes selected by the names, throwing std::invalid_argument on any unknown name
+std::bitset<256> make_opcode_filter(const std::vector<std::string>& opcode_names);
+
 static const DebugConfig DEFAULT_DEBUG_CONFIG{false, false, false};
 
 void from_json(const nlohmann::json& json, DebugConfig& tc);
@@ -61,15 +93,24 @@ struct DebugLog {
     std::int64_t gas_cost;
     std::uint32_t depth;
     bool error{false};
-    std::vector<std::string> memory;
-    std::vector<std::string> stack;
+    //! The memory at the instruction start, shared with the previous logs until written and split in words only when serialized
+    std::shared_ptr<const silkworm::Bytes> memory;
+    //! The stack items from the bottom, kept as raw words and hex-encoded only when serialized
+    std::vector<intx::uint256> stack;
     Storage storage;
 };
 
+//! Sink of the struct logs, each one given away as soon as it is complete (i.e. when the next one starts or on flush)
+using DebugLogSink = std::function<void(DebugLog&&)>;
+
 class DebugTracer : public silkworm::EvmTracer {
 public:
     explicit DebugTracer(std::vector<DebugLog>& logs, const DebugConfig& config = {})
-        : logs_(logs), config_(config) {}
+        : logs_(logs), config_(config) { init_opcode_filter(); }
+
+    //! Give the struct logs to the sink instead of collecting them, keeping in memory just the last one still incomplete
+    explicit DebugTracer(DebugLogSink sink, const DebugConfig& config = {})
+        : logs_(pending_logs_), config_(config), sink_(std::move(sink)) { init_opcode_filter(); }
 
     DebugTracer(const DebugTracer&) = delete;
     DebugTracer& operator=(const DebugTracer&) = delete;
@@ -83,15 +124,32 @@ public:
     void on_reward_granted(const silkworm::CallResult& result, const silkworm::IntraBlockState& intra_block_state) noexcept override {};
     void on_creation_completed(const evmc_result& result, const silkworm::IntraBlockState& intra_block_state) noexcept override {};
 
-
+    //! Give the last struct log to the sink, if any: to be called once the execution is over
+    void flush();
 
 private:
+    void init_opcode_filter();
+
+    //! Drop the last memory snapshot if the memory may have been changed by the previous instruction
+    void track_memory(const evmone::ExecutionState& execution_state, std::uint8_t opcode);
+
+    //! Return the memory snapshot at the start of the instruction, shared with the previous logs if left untouched since
+    std::shared_ptr<const silkworm::Bytes> snapshot_memory(const evmone::Memory& memory);
+
+    std::vector<DebugLog> pending_logs_;
     std::vector<DebugLog>& logs_;
     const DebugConfig& config_;
+    DebugLogSink sink_;
     std::map<evmc::address, Storage> storage_;
     const char* const* opcode_names_ = nullptr;
     std::int64_t start_gas_{0};
     std::int64_t gas_on_precompiled_{0};
+    std::shared_ptr<const silkworm::Bytes> last_memory_;
+    std::uint32_t last_memory_depth_{0};
+    std::uint8_t last_opcode_{0};
+    std::optional<std::bitset<256>> opcode_filter_;
+    bool last_log_open_{false};
+    std::uint64_t num_logs_{0};
 };
 
 class NullTracer : public silkworm::EvmTracer {
@@ -112,17 +170,179 @@ public:
     std::int64_t get_end_gas() const {return 0;}
 };
 
+//! Call frame recorded by the call tracer, with the frames of its inner calls
+struct DebugCallFrame {
+    std::string type;
+    evmc::address from;
+    std::optional<evmc::address> to;
+    intx::uint256 value{0};
+    std::uint64_t gas{0};
+    std::uint64_t gas_used{0};
+    silkworm::Bytes input;
+    silkworm::Bytes output;
+    std::optional<std::string> error;
+    std::vector<DebugCallFrame> calls;
+};
+
+void to_json(nlohmann::json& json, const DebugCallFrame& frame);
+
+//! Tracer recording just the call frames entered and exited, without any per-instruction capture
+class CallTracer : public silkworm::EvmTracer {
+public:
+    explicit CallTracer(DebugCallFrame& root) : root_(root) {}
+
+    CallTracer(const CallTracer&) = delete;
+    CallTracer& operator=(const CallTracer&) = delete;
+
+    void on_execution_start(evmc_revision rev, const evmc_message& msg, evmone::bytes_view code) noexcept override;
+    void on_instruction_start(uint32_t pc, const intx::uint256* stack_top, const int stack_height,
+         const evmone::ExecutionState& execution_state, const silkworm::IntraBlockState& intra_block_state) noexcept override {};
+    void on_execution_end(const evmc_result& result, const silkworm::IntraBlockState& intra_block_state) noexcept override;
+    void on_precompiled_run(const evmc_result& result, int64_t gas, const silkworm::IntraBlockState& intra_block_state) noexcept override {};
+    void on_reward_granted(const silkworm::CallResult& result, const silkworm::IntraBlockState& intra_block_state) noexcept override {};
+    void on_creation_completed(const evmc_result& result, const silkworm::IntraBlockState& intra_block_state) noexcept override {};
+
+private:
+    DebugCallFrame& root_;
+    //! The frames currently executing: each one is the last call of the previous one, so it is never moved meanwhile
+    std::stack<DebugCallFrame*> frames_;
+};
+
+//! Account state preceding the transaction, with the storage slots accessed by the transaction
+struct PrestateAccount {
+    intx::uint256 balance{0};
+    std::uint64_t nonce{0};
+    silkworm::Bytes code;
+    std::map<evmc::bytes32, evmc::bytes32> storage;
+};
+
+void to_json(nlohmann::json& json, const PrestateAccount& account);
+
+using Prestate = std::map<evmc::address, PrestateAccount>;
+
+//! Tracer recording the state preceding the transaction of the accounts it touched: the initial account state comes from
+//! the state addresses, which must be kept up to date with the preceding transactions (see trace::IntraBlockStateTracer)
+class PrestateTracer : public silkworm::EvmTracer {
+public:
+    explicit PrestateTracer(Prestate& prestate, trace::StateAddresses& state_addresses)
+        : prestate_(prestate), state_addresses_(state_addresses) {}
+
+    PrestateTracer(const PrestateTracer&) = delete;
+    PrestateTracer& operator=(const PrestateTracer&) = delete;
+
+    void on_execution_start(evmc_revision rev, const evmc_message& msg, evmone::bytes_view code) noexcept override;
+    void on_instruction_start(uint32_t pc, const intx::uint256* stack_top, const int stack_height,
+         const evmone::ExecutionState& execution_state, const silkworm::IntraBlockState& intra_block_state) noexcept override;
+    void on_execution_end(const evmc_result& result, const silkworm::IntraBlockState& intra_block_state) noexcept override {};
+    void on_precompiled_run(const evmc_result& result, int64_t gas, const silkworm::IntraBlockState& intra_block_state) noexcept override {};
+    void on_reward_granted(const silkworm::CallResult& result, const silkworm::IntraBlockState& intra_block_state) noexcept override;
+    void on_creation_completed(const evmc_result& result, const silkworm::IntraBlockState& intra_block_state) noexcept override {};
+
+private:
+    Prestate& prestate_;
+    trace::StateAddresses& state_addresses_;
+    std::set<evmc::address> addresses_;
+    std::map<evmc::address, std::set<evmc::bytes32>> storage_keys_;
+};
+
 struct DebugTrace {
     bool failed;
     std::int64_t gas{0};
     std::string return_value;
     std::vector<DebugLog> debug_logs;
+    //! The output of the native tracer, if any, replacing the struct logs
+    std::optional<DebugCallFrame> call_frame;
+    std::optional<Prestate> prestate;
 
     DebugConfig debug_config;
 };
 
 void to_json(nlohmann::json& json, const DebugTrace& debug_trace);
 
+//! Writer of the debug traces on the JSON stream while the transactions are executed: the struct logs given by the tracer
+//! on the worker thread are serialized in a local buffer, handed over to the stream on its I/O context whenever it exceeds
+//! the flush threshold, so that memory stays bounded whatever the trace size. Nothing is written on the stream before, so
+//! the whole output can still be replaced (e.g. by an error reply) as long as started() is false.
+//! When the encoders are given, the struct logs are rather handed over in batches to one encoder worker at a time, which
+//! serializes them in order while the tracer goes on executing the transaction on its own worker: the tracer encodes
+//! the batches itself only when the encoders lag too far behind, bounding the memory held by the pending struct logs.
+class DebugStreamWriter {
+public:
+    //! The number of struct logs handed over at once to the encoders
+    static constexpr std::size_t kLogsPerBatch{256};
+
+    //! The max number of batches waiting for the encoders, beyond which the tracer encodes them itself
+    static constexpr std::size_t kMaxPendingBatches{16};
+
+    explicit DebugStreamWriter(boost::asio::io_context& io_context, json::Stream& stream, const DebugConfig& config, std::string prefix = {},
+        boost::asio::thread_pool* encoders = nullptr, std::size_t flush_threshold = json::Stream::kDefaultFlushThreshold);
+
+    DebugStreamWriter(const DebugStreamWriter&) = delete;
+    DebugStreamWriter& operator=(const DebugStreamWriter&) = delete;
+
+    //! Start a new trace, following the previous one if any
+    void begin_trace();
+
+    //! Write the struct log of the current trace: to be used as tracer sink, any write failure is raised by the next call
+    void write_log(DebugLog&& log) noexcept;
+
+    //! Terminate the current trace with its outcome
+    boost::asio::awaitable<void> end_trace(const DebugTrace& debug_trace);
+
+    //! Terminate the current trace if still open (i.e. interrupted by an error), then write the suffix on the stream
+    boost::asio::awaitable<void> close(std::string_view suffix);
+
+    //! Whether some text has been handed over to the stream already
+    bool started() const { return started_; }
+
+private:
+    //! The struct logs of the current trace waiting to be encoded in order by the encoders, shared with the encoding tasks
+    //! since they may outlive the writer
+    struct EncodingQueue {
+        explicit EncodingQueue(const DebugConfig& config) : config{config} {}
+
+        //! Encode in order all the pending batches, appending their text to the encoded one
+        void drain();
+
+        const DebugConfig config;
+        //! Held while encoding, so that the batches are encoded one at a time in order
+        std::mutex encoding_mutex;
+        //! The number of struct logs encoded in the current trace, guarded by the encoding mutex
+        std::size_t num_logs{0};
+        //! Guarding all the fields below
+        std::mutex mutex;
+        std::deque<std::vector<DebugLog>> batches;
+        std::string encoded;
+        std::exception_ptr exception;
+    };
+
+    //! Hand the current batch over to the encoders, encoding the pending batches here if they lag too far behind
+    void submit_batch();
+
+    //! Hand the current batch over to the encoders and wait for all the pending batches to be encoded
+    boost::asio::awaitable<void> drain_batches();
+
+    //! Move the text encoded so far at the end of the buffer, raising any encoding failure
+    void take_encoded();
+
+    //! Hand the buffered text over to the stream, raising any previous write failure
+    boost::asio::awaitable<void> write_buffer();
+
+    boost::asio::io_context& io_context_;
+    json::Stream& stream_;
+    const DebugConfig config_;
+    const std::size_t flush_threshold_;
+    std::string buffer_;
+    std::size_t num_traces_{0};
+    std::size_t num_logs_{0};
+    boost::asio::thread_pool* encoders_;
+    std::shared_ptr<EncodingQueue> encoding_queue_;
+    std::vector<DebugLog> batch_;
+    bool trace_open_{false};
+    bool started_{false};
+    std::exception_ptr write_exception_;
+};
+
 struct DebugExecutorResult {
     DebugTrace debug_trace;
     std::optional<std::string> pre_check_error{std::nullopt};
@@ -135,26 +355,51 @@ public:
         boost::asio::io_context& io_context,
         const core::rawdb::DatabaseReader& database_reader,
         boost::asio::thread_pool& workers,
-        const DebugConfig& config = DEFAULT_DEBUG_CONFIG)
-        : io_context_(io_context), database_reader_(database_reader), workers_{workers}, config_{config} {}
+        const DebugConfig& config = DEFAULT_DEBUG_CONFIG,
+        StateCheckpointCache* checkpoint_cache = nullptr)
+        : io_context_(io_context), database_reader_(database_reader), workers_{workers}, config_{config}, checkpoint_cache_{checkpoint_cache} {}
     virtual ~DebugExecutor() {}
 
     DebugExecutor(const DebugExecutor&) = delete;
     DebugExecutor& operator=(const DebugExecutor&) = delete;
 
-    boost::asio::awaitable<std::vector<DebugTrace>> execute(const silkworm::Block& block);
+    //! Trace all the block transactions. When the database is given, the transactions are split in segments traced
+    //! concurrently, each one within its own transaction opened on it after replaying the preceding ones untraced
+    boost::asio::awaitable<std::vector<DebugTrace>> execute(const silkworm::Block& block, ethdb::Database* database = nullptr);
     boost::asio::awaitable<DebugExecutorResult> execute(const silkworm::Block& block, const silkrpc::Call& call);
     boost::asio::awaitable<DebugExecutorResult> execute(const silkworm::Block& block, const silkrpc::Transaction& transaction) {
         return execute(block.header.number-1, block, transaction, transaction.transaction_index);
     }
 
+    //! Trace all the block transactions in order, writing the traces on the writer as they are produced. When the database
+    //! is given and a native tracer is used, the transactions are traced in concurrent segments as above, each segment
+    //! being written once all the preceding ones have been
+    boost::asio::awaitable<void> execute(const silkworm::Block& block, DebugStreamWriter& writer, ethdb::Database* database = nullptr);
+    //! Trace the call or transaction writing the trace on the writer as it is produced, instead of collecting it in the result
+    boost::asio::awaitable<DebugExecutorResult> execute(const silkworm::Block& block, const silkrpc::Call& call, DebugStreamWriter& writer);
+    boost::asio::awaitable<DebugExecutorResult> execute(const silkworm::Block& block, const silkrpc::Transaction& transaction, DebugStreamWriter& writer) {
+        return execute(block.header.number-1, block, transaction, transaction.transaction_index, &writer);
+    }
+
 private:
-    boost::asio::awaitable<DebugExecutorResult> execute(std::uint64_t block_number, const silkworm::Block& block, const silkrpc::Transaction& transaction, std::int32_t = -1);
+    boost::asio::awaitable<DebugExecutorResult> execute(std::uint64_t block_number, const silkworm::Block& block, const silkrpc::Transaction& transaction,
+        std::int32_t = -1, DebugStreamWriter* writer = nullptr);
+
+    //! Trace the block transactions in the given number of contiguous segments concurrently, each one within its own
+    //! transaction opened on the database, writing the traces of each segment in order on the writer if any
+    boost::asio::awaitable<void> execute_segments(const silkworm::Block& block, const silkworm::ChainConfig& chain_config,
+        ethdb::Database& database, std::size_t num_segments, std::vector<DebugTrace>& debug_traces, DebugStreamWriter* writer = nullptr);
+
+    //! Trace the block transactions in [begin, end) using the executor on the state preceding the block, the one the executor
+    //! reads through, writing the traces on the writer if any
+    boost::asio::awaitable<void> execute_transactions(silkworm::State& block_state, EVMExecutor<WorldState, VM>& executor,
+        const silkworm::Block& block, std::size_t begin, std::size_t end, std::vector<DebugTrace>& debug_traces, DebugStreamWriter* writer = nullptr);
 
     boost::asio::io_context& io_context_;
     const core::rawdb::DatabaseReader& database_reader_;
     boost::asio::thread_pool& workers_;
     const DebugConfig& config_;
+    StateCheckpointCache* checkpoint_cache_;
 };
 } // namespace silkrpc::debug
 
@@ -16,7 +16,9 @@
 
 #include "evm_debug.hpp"
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <boost/asio/co_spawn.hpp>
 #include <boost/asio/thread_pool.hpp>
@@ -497,6 +499,172 @@ TEST_CASE("DebugExecutor::execute call 1") {
         })"_json);
     }
 
+    SECTION("Call: only SSTORE") {
+        EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, silkworm::ByteView{kZeroKey}))
+            .WillRepeatedly(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
+                co_return kZeroHeader;
+            }));
+        EXPECT_CALL(db_reader, get_one(db::table::kConfig, silkworm::ByteView{kConfigKey}))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
+                co_return kConfigValue;
+            }));
+        EXPECT_CALL(db_reader, get(db::table::kAccountHistory, silkworm::ByteView{kAccountHistoryKey1}))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<KeyValue> {
+                co_return KeyValue{kAccountHistoryKey1, kAccountHistoryValue1};
+            }));
+        EXPECT_CALL(db_reader, get(db::table::kAccountHistory, silkworm::ByteView{kAccountHistoryKey3}))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<KeyValue> {
+                co_return KeyValue{kAccountHistoryKey3, kAccountHistoryValue3};
+            }));
+        EXPECT_CALL(db_reader, get_both_range(db::table::kPlainAccountChangeSet, silkworm::ByteView{kAccountChangeSetKey1}, silkworm::ByteView{kAccountChangeSetSubkey1}))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<std::optional<silkworm::Bytes>> {
+                co_return kAccountChangeSetValue1;
+            }));
+        EXPECT_CALL(db_reader, get_both_range(db::table::kPlainAccountChangeSet, silkworm::ByteView{kAccountChangeSetKey2}, silkworm::ByteView{kAccountChangeSetSubKey2}))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<std::optional<silkworm::Bytes>> {
+                co_return kAccountChangeSetValue2;
+            }));
+        EXPECT_CALL(db_reader, get(db::table::kAccountHistory, silkworm::ByteView{kAccountHistoryKey2}))
+            .WillRepeatedly(InvokeWithoutArgs([]() -> boost::asio::awaitable<KeyValue> {
+                co_return KeyValue{kAccountHistoryKey2, kAccountHistoryValue2};
+            }));
+        EXPECT_CALL(db_reader, get_one(db::table::kPlainState, silkworm::ByteView{kPlainStateKey2}))
+            .WillRepeatedly(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
+                co_return silkworm::Bytes{};
+            }));
+
+        const auto block_number = 5'405'095; // 0x5279A7
+        silkrpc::Call call;
+        call.from = 0xe0a2Bd4258D2768837BAa26A28fE71Dc079f84c7_address;
+        call.gas = 118'936;
+        call.gas_price = 7;
+        call.data = *silkworm::from_hex("602a60005500");
+
+        silkworm::Block block{};
+        block.header.number = block_number;
+
+        DebugConfig config;
+        config.opcodes = std::vector<std::string>{"SSTORE"};
+        DebugExecutor executor{context_pool.next_io_context(), db_reader, workers, config};
+        boost::asio::io_context& io_context = context_pool.next_io_context();
+        auto execution_result = boost::asio::co_spawn(io_context.get_executor(), executor.execute(block, call), boost::asio::use_future);
+        auto result = execution_result.get();
+
+        context_pool.stop();
+        io_context.stop();
+        context_pool.join();
+
+        CHECK(result.pre_check_error.has_value() == false);
+        CHECK(result.debug_trace == R"({
+            "failed": false,
+            "gas": 75178,
+            "returnValue": "",
+            "structLogs": [
+                {
+                    "depth": 1,
+                    "gas": 65858,
+                    "gasCost": 22100,
+                    "memory": [],
+                    "op": "SSTORE",
+                    "pc": 4,
+                    "stack": [
+                        "0x2a",
+                        "0x0"
+                    ],
+                    "storage": {
+                        "0000000000000000000000000000000000000000000000000000000000000000": "000000000000000000000000000000000000000000000000000000000000002a"
+                    }
+                }
+            ]
+        })"_json);
+    }
+
+    SECTION("Call: limit and max depth") {
+        EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, silkworm::ByteView{kZeroKey}))
+            .WillRepeatedly(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
+                co_return kZeroHeader;
+            }));
+        EXPECT_CALL(db_reader, get_one(db::table::kConfig, silkworm::ByteView{kConfigKey}))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
+                co_return kConfigValue;
+            }));
+        EXPECT_CALL(db_reader, get(db::table::kAccountHistory, silkworm::ByteView{kAccountHistoryKey1}))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<KeyValue> {
+                co_return KeyValue{kAccountHistoryKey1, kAccountHistoryValue1};
+            }));
+        EXPECT_CALL(db_reader, get(db::table::kAccountHistory, silkworm::ByteView{kAccountHistoryKey3}))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<KeyValue> {
+                co_return KeyValue{kAccountHistoryKey3, kAccountHistoryValue3};
+            }));
+        EXPECT_CALL(db_reader, get_both_range(db::table::kPlainAccountChangeSet, silkworm::ByteView{kAccountChangeSetKey1}, silkworm::ByteView{kAccountChangeSetSubkey1}))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<std::optional<silkworm::Bytes>> {
+                co_return kAccountChangeSetValue1;
+            }));
+        EXPECT_CALL(db_reader, get_both_range(db::table::kPlainAccountChangeSet, silkworm::ByteView{kAccountChangeSetKey2}, silkworm::ByteView{kAccountChangeSetSubKey2}))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<std::optional<silkworm::Bytes>> {
+                co_return kAccountChangeSetValue2;
+            }));
+        EXPECT_CALL(db_reader, get(db::table::kAccountHistory, silkworm::ByteView{kAccountHistoryKey2}))
+            .WillRepeatedly(InvokeWithoutArgs([]() -> boost::asio::awaitable<KeyValue> {
+                co_return KeyValue{kAccountHistoryKey2, kAccountHistoryValue2};
+            }));
+        EXPECT_CALL(db_reader, get_one(db::table::kPlainState, silkworm::ByteView{kPlainStateKey2}))
+            .WillRepeatedly(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
+                co_return silkworm::Bytes{};
+            }));
+
+        const auto block_number = 5'405'095; // 0x5279A7
+        silkrpc::Call call;
+        call.from = 0xe0a2Bd4258D2768837BAa26A28fE71Dc079f84c7_address;
+        call.gas = 118'936;
+        call.gas_price = 7;
+        call.data = *silkworm::from_hex("602a60005500");
+
+        silkworm::Block block{};
+        block.header.number = block_number;
+
+        DebugConfig config;
+        config.maxDepth = 1;
+        config.limit = 2;
+        DebugExecutor executor{context_pool.next_io_context(), db_reader, workers, config};
+        boost::asio::io_context& io_context = context_pool.next_io_context();
+        auto execution_result = boost::asio::co_spawn(io_context.get_executor(), executor.execute(block, call), boost::asio::use_future);
+        auto result = execution_result.get();
+
+        context_pool.stop();
+        io_context.stop();
+        context_pool.join();
+
+        CHECK(result.pre_check_error.has_value() == false);
+        CHECK(result.debug_trace == R"({
+            "failed": false,
+            "gas": 75178,
+            "returnValue": "",
+            "structLogs": [
+                {
+                    "depth": 1,
+                    "gas": 65864,
+                    "gasCost": 3,
+                    "memory": [],
+                    "op": "PUSH1",
+                    "pc": 0,
+                    "stack": []
+                },
+                {
+                    "depth": 1,
+                    "gas": 65861,
+                    "gasCost": 3,
+                    "memory": [],
+                    "op": "PUSH1",
+                    "pc": 2,
+                    "stack": [
+                        "0x2a"
+                    ]
+                }
+            ]
+        })"_json);
+    }
+
     SECTION("Call: no memory") {
         EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, silkworm::ByteView{kZeroKey}))
             .WillRepeatedly(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
@@ -1768,8 +1936,8 @@ TEST_CASE("DebugTrace json serialization") {
     log.gas_cost = 4;
     log.depth = 1;
     log.error = false;
-    log.memory.push_back("0000000000000000000000000000000000000000000000000000000000000080");
-    log.stack.push_back("0x80");
+    log.memory = std::make_shared<silkworm::Bytes>(*silkworm::from_hex("0000000000000000000000000000000000000000000000000000000000000080"));
+    log.stack.push_back(0x80);
     log.storage["804292fe56769f4b9f0e91cf85875f67487cd9e85a084cbba2188be4466c4f23"] = "0000000000000000000000000000000000000000000000000000000000000008";
 
     SECTION("DebugTrace: no memory, stack and storage") {
@@ -1940,6 +2108,83 @@ TEST_CASE("DebugTrace json serialization") {
     }
 }
 
+TEST_CASE("DebugTrace json serialization of native tracers") {
+    SILKRPC_LOG_STREAMS(null_stream(), null_stream());
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+
+    SECTION("call tracer") {
+        DebugCallFrame inner_frame;
+        inner_frame.type = "STATICCALL";
+        inner_frame.from = 0x0715a7794a1dc8e42615f059dd6e406a6594651a_address;
+        inner_frame.to = 0x0000000000000000000000000000000000000001_address;
+        inner_frame.gas = 0x100;
+        inner_frame.gas_used = 0x10;
+        inner_frame.error = "execution reverted";
+
+        DebugTrace debug_trace;
+        debug_trace.call_frame.emplace();
+        auto& frame = debug_trace.call_frame.value();
+        frame.type = "CALL";
+        frame.from = 0xe0a2bd4258d2768837baa26a28fe71dc079f84c7_address;
+        frame.to = 0x0715a7794a1dc8e42615f059dd6e406a6594651a_address;
+        frame.value = 1;
+        frame.gas = 0x5208;
+        frame.gas_used = 0x5000;
+        frame.input = *silkworm::from_hex("602a");
+        frame.output = *silkworm::from_hex("2a");
+        frame.calls.push_back(inner_frame);
+
+        CHECK(debug_trace == R"({
+            "type": "CALL",
+            "from": "0xe0a2bd4258d2768837baa26a28fe71dc079f84c7",
+            "to": "0x0715a7794a1dc8e42615f059dd6e406a6594651a",
+            "value": "0x1",
+            "gas": "0x5208",
+            "gasUsed": "0x5000",
+            "input": "0x602a",
+            "output": "0x2a",
+            "calls": [{
+                "type": "STATICCALL",
+                "from": "0x0715a7794a1dc8e42615f059dd6e406a6594651a",
+                "to": "0x0000000000000000000000000000000000000001",
+                "value": "0x0",
+                "gas": "0x100",
+                "gasUsed": "0x10",
+                "input": "0x",
+                "error": "execution reverted"
+            }]
+        })"_json);
+    }
+
+    SECTION("prestate tracer") {
+        PrestateAccount account;
+        account.balance = 0x10;
+        account.nonce = 2;
+        account.code = *silkworm::from_hex("602a");
+        account.storage[evmc::bytes32{}] = evmc::bytes32{};
+
+        DebugTrace debug_trace;
+        debug_trace.prestate.emplace();
+        debug_trace.prestate.value()[0x0715a7794a1dc8e42615f059dd6e406a6594651a_address] = account;
+        debug_trace.prestate.value()[0xe0a2bd4258d2768837baa26a28fe71dc079f84c7_address] = PrestateAccount{};
+
+        CHECK(debug_trace == R"({
+            "0x0715a7794a1dc8e42615f059dd6e406a6594651a": {
+                "balance": "0x10",
+                "nonce": 2,
+                "code": "0x602a",
+                "storage": {
+                    "0x0000000000000000000000000000000000000000000000000000000000000000": "0x0000000000000000000000000000000000000000000000000000000000000000"
+                }
+            },
+            "0xe0a2bd4258d2768837baa26a28fe71dc079f84c7": {
+                "balance": "0x0",
+                "nonce": 0
+            }
+        })"_json);
+    }
+}
+
 TEST_CASE("DebugConfig") {
     SILKRPC_LOG_STREAMS(null_stream(), null_stream());
     SILKRPC_LOG_VERBOSITY(LogLevel::None);
@@ -1957,6 +2202,50 @@ TEST_CASE("DebugConfig") {
         CHECK(config.disableStorage == true);
         CHECK(config.disableMemory == false);
         CHECK(config.disableStack == true);
+        CHECK(!config.tracer);
+    }
+    SECTION("json deserialization with tracer") {
+        nlohmann::json json = R"({
+            "tracer": "callTracer"
+            })"_json;
+
+        DebugConfig config;
+        from_json(json, config);
+
+        CHECK(config.disableStorage == false);
+        CHECK(config.disableMemory == false);
+        CHECK(config.disableStack == false);
+        CHECK(config.tracer == kCallTracer);
+    }
+    SECTION("json deserialization with filters") {
+        nlohmann::json json = R"({
+            "opcodes": ["CALL", "SSTORE", "SHA3"],
+            "maxDepth": 2,
+            "limit": 1000
+            })"_json;
+
+        DebugConfig config;
+        from_json(json, config);
+
+        CHECK(config.opcodes == std::vector<std::string>{"CALL", "SSTORE", "SHA3"});
+        CHECK(config.maxDepth == 2);
+        CHECK(config.limit == 1000);
+    }
+    SECTION("json deserialization with unsupported opcode") {
+        nlohmann::json json = R"({
+            "opcodes": ["CALL", "FOO"]
+            })"_json;
+
+        DebugConfig config;
+        CHECK_THROWS_AS(from_json(json, config), std::invalid_argument);
+    }
+    SECTION("json deserialization with unsupported tracer") {
+        nlohmann::json json = R"({
+            "tracer": "4byteTracer"
+            })"_json;
+
+        DebugConfig config;
+        CHECK_THROWS_AS(from_json(json, config), std::invalid_argument);
     }
     SECTION("dump on stream") {
         DebugConfig config{true, false, true};
@@ -1965,5 +2254,15 @@ TEST_CASE("DebugConfig") {
         os << config;
         CHECK(os.str() == "disableStorage: true disableMemory: false disableStack: true");
     }
+    SECTION("dump on stream with filters") {
+        DebugConfig config{true, false, true};
+        config.opcodes = std::vector<std::string>{"CALL", "SSTORE"};
+        config.maxDepth = 2;
+        config.limit = 1000;
+
+        std::ostringstream os;
+        os << config;
+        CHECK(os.str() == "disableStorage: true disableMemory: false disableStack: true opcodes: CALL SSTORE maxDepth: 2 limit: 1000");
+    }
 }
 }  // namespace silkrpc::debug
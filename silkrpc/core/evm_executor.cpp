@@ -16,7 +16,9 @@
 
 #include "evm_executor.hpp"
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -24,19 +26,29 @@
 
 #include <boost/asio/compose.hpp>
 #include <boost/asio/post.hpp>
+#include <boost/asio/this_coro.hpp>
 #include <boost/asio/use_awaitable.hpp>
 #include <evmc/evmc.hpp>
 #include <intx/intx.hpp>
 #include <silkworm/chain/intrinsic_gas.hpp>
 #include <silkworm/chain/protocol_param.hpp>
 #include <silkworm/common/util.hpp>
+#include <silkworm/execution/analysis_cache.hpp>
+#include <silkworm/execution/state_pool.hpp>
 
+#include <silkrpc/common/code_hotness.hpp>
+#include <silkrpc/common/constants.hpp>
 #include <silkrpc/common/log.hpp>
+#include <silkrpc/common/usdt.hpp>
 #include <silkrpc/common/util.hpp>
+#include <silkrpc/concurrency/request_executor.hpp>
 #include <silkrpc/types/transaction.hpp>
 
 namespace silkrpc {
 
+//! The recent calls to each contract code by all the executors, promoting the hot code to the advanced interpreter
+static CodeHotness code_hotness;
+
 static silkworm::Bytes build_abi_selector(const std::string& signature) {
     const auto signature_hash = hash_of(silkworm::byte_view_of_string(signature));
     return {std::begin(signature_hash.bytes), std::begin(signature_hash.bytes) + 4};
@@ -176,6 +188,23 @@ template<typename WorldState, typename VM>
 void EVMExecutor<WorldState, VM>::reset() {
     state_.clear_journal_and_substate();
 }
+
+template<typename WorldState, typename VM>
+boost::asio::awaitable<std::vector<ExecutionResult>> EVMExecutor<WorldState, VM>::call_many(const silkworm::Block& block,
+    const std::vector<silkworm::Transaction>& txns) {
+    std::vector<ExecutionResult> results;
+    results.reserve(txns.size());
+    for (const auto& txn : txns) {
+        results.push_back(co_await call(block, txn));
+        reset();
+    }
+    co_return results;
+}
+
+template<typename WorldState, typename VM>
+void EVMExecutor<WorldState, VM>::write_state(uint64_t block_number) {
+    state_.write_to_db(block_number);
+}
 template<typename WorldState, typename VM>
 std::optional<std::string> EVMExecutor<WorldState, VM>::pre_check(const VM& evm, const silkworm::Transaction& txn, const intx::uint256 base_fee_per_gas, const intx::uint128 g0) {
     const evmc_revision rev{evm.revision()};
@@ -205,6 +234,38 @@ std::optional<std::string> EVMExecutor<WorldState, VM>::pre_check(const VM& evm,
     return std::nullopt;
 }
 
+template<typename WorldState, typename VM>
+boost::asio::awaitable<void> EVMExecutor<WorldState, VM>::prefetch(const silkworm::Block& block, const silkworm::Transaction& txn) {
+    AccessedState state;
+    if (txn.from) {
+        state.accounts.push_back(*txn.from);
+    }
+    if (txn.to) {
+        state.accounts.push_back(*txn.to);
+    }
+    state.accounts.push_back(block.header.beneficiary);
+    for (const silkworm::AccessListEntry& ae : txn.access_list) {
+        state.accounts.push_back(ae.account);
+        for (const evmc::bytes32& key : ae.storage_keys) {
+            state.locations.emplace_back(ae.account, key);
+        }
+    }
+    if (access_history_ && txn.to) {
+        const auto previous_state = access_history_->find(*txn.to);
+        if (previous_state) {
+            state.accounts.insert(state.accounts.end(), previous_state->accounts.begin(), previous_state->accounts.end());
+            state.locations.insert(state.locations.end(), previous_state->locations.begin(), previous_state->locations.end());
+        }
+    }
+    // The accounts of the storage locations are needed anyway to know their incarnation
+    for (const auto& location : state.locations) {
+        state.accounts.push_back(location.first);
+    }
+    state.normalize();
+
+    co_await remote_state_.prefetch(state);
+}
+
 template<typename WorldState, typename VM>
 boost::asio::awaitable<ExecutionResult> EVMExecutor<WorldState, VM>::call(
     const silkworm::Block& block,
@@ -215,10 +276,43 @@ boost::asio::awaitable<ExecutionResult> EVMExecutor<WorldState, VM>::call(
     SILKRPC_DEBUG << "EVMExecutor::call: " << block.header.number << " gasLimit: " << txn.gas_limit << " refund: " << refund << " gasBailout: " << gas_bailout << "\n";
     SILKRPC_DEBUG << "EVMExecutor::call:Transaction: " << &txn << "Txn: " << txn << "\n";
 
+    // The request may be cancelled while waiting for a worker, so the token is checked again before executing
+    const auto executor = co_await boost::asio::this_coro::executor;
+    const auto token = cancellation_token_of(executor);
+    token.throw_if_cancelled();
+    auto* profile = request_profile_of(executor);
+    TraceSpan call_span{trace_context_of(executor), "evm.call"};
+    call_span.set_attribute("block", block.header.number);
+    call_span.set_attribute("gas_limit", txn.gas_limit);
+    SILKRPC_PROBE(evm_call_start, block.header.number, txn.gas_limit);
+
+    co_await prefetch(block, txn);
+
     const auto exec_result = co_await boost::asio::async_compose<decltype(boost::asio::use_awaitable), void(ExecutionResult)>(
-        [this, &block, &txn, &tracers, &refund, &gas_bailout](auto&& self) {
+        [this, &block, &txn, &tracers, &refund, &gas_bailout, &token, profile](auto&& self) {
             SILKRPC_TRACE << "EVMExecutor::call post block: " << block.header.number << " txn: " << &txn << "\n";
-            boost::asio::post(workers_, [this, &block, &txn, &tracers, &refund, &gas_bailout, self = std::move(self)]() mutable {
+            const auto post_time = std::chrono::steady_clock::now();
+            boost::asio::post(workers_, [this, &block, &txn, &tracers, &refund, &gas_bailout, &token, profile, post_time, self = std::move(self)]() mutable {
+                const auto start_time = std::chrono::steady_clock::now();
+                if (profile != nullptr) {
+                    profile->add(RequestPhase::queue, start_time - post_time);
+                }
+                // The samples and the costs of the execution are the ones of the request, whose scope ends before completing it
+                RequestWorkScope scope{profile};
+                if (token.is_cancelled()) {
+                    ExecutionResult exec_result{1000, txn.gas_limit, silkworm::Bytes{}, "request cancelled"};
+                    scope.end();
+                    boost::asio::post(io_context_, [exec_result, self = std::move(self)]() mutable {
+                        self.complete(exec_result);
+                    });
+                    return;
+                }
+
+                // The code analyses and the execution states (with their memory) are kept warm on each worker thread across
+                // all the calls, since none of them is thread-safe: the analyses are keyed by code hash, so any block fits
+                thread_local silkworm::AnalysisCache analysis_cache{kEvmAnalysisCacheSize};
+                thread_local silkworm::EvmoneExecutionStatePool state_pool;
+
                 VM evm{block, state_, config_};
                 for (auto& tracer : tracers) {
                     evm.add_tracer(*tracer);
@@ -236,6 +330,7 @@ boost::asio::awaitable<ExecutionResult> EVMExecutor<WorldState, VM>::call(
                 if (error) {
                     silkworm::Bytes data{};
                     ExecutionResult exec_result{1000, txn.gas_limit, data, *error};
+                    scope.end();
                     boost::asio::post(io_context_, [exec_result, self = std::move(self)]() mutable {
                         self.complete(exec_result);
                     });
@@ -257,7 +352,8 @@ boost::asio::awaitable<ExecutionResult> EVMExecutor<WorldState, VM>::call(
                         std::string from = silkworm::to_hex(*txn.from);
                         std::string error = "insufficient funds for gas * price + value: address 0x" + from + " have " + intx::to_string(have) + " want " + intx::to_string(want+txn.value);
                         ExecutionResult exec_result{1000, txn.gas_limit, data, error};
-                        boost::asio::post(io_context_, [exec_result, self = std::move(self)]() mutable {
+                        scope.end();
+                    boost::asio::post(io_context_, [exec_result, self = std::move(self)]() mutable {
                             self.complete(exec_result);
                         });
                         return;
@@ -270,6 +366,14 @@ boost::asio::awaitable<ExecutionResult> EVMExecutor<WorldState, VM>::call(
                     state_.access_account(*txn.to);
                     // EVM itself increments the nonce for contract creation
                     state_.set_nonce(*txn.from, state_.get_nonce(*txn.from) + 1);
+
+                    // Cold code runs on the baseline interpreter, skipping the analysis, while the code called often enough
+                    // gets analysed once for the advanced one: the code called from the recipient follows the same choice
+                    const auto code_hash{state_.get_code_hash(*txn.to)};
+                    if (code_hash != silkworm::kEmptyHash && code_hotness.record(code_hash)) {
+                        evm.advanced_analysis_cache = &analysis_cache;
+                        evm.state_pool = &state_pool;
+                    }
                 }
                 for (const silkworm::AccessListEntry& ae : txn.access_list) {
                     state_.access_account(ae.account);
@@ -280,10 +384,12 @@ boost::asio::awaitable<ExecutionResult> EVMExecutor<WorldState, VM>::call(
 
                 SILKRPC_DEBUG << "EVMExecutor::call execute on EVM txn: " << &txn << " g0: " << static_cast<uint64_t>(g0) << " start\n";
                 const auto result{evm.execute(txn, txn.gas_limit - static_cast<uint64_t>(g0))};
+                num_execution_accounts_ = remote_state_.accessed_state().accounts.size();
                 SILKRPC_DEBUG << "EVMExecutor::call execute on EVM txn: " << &txn << " gas_left: " << result.gas_left << " end\n";
 
                 uint64_t gas_left = result.gas_left;
-                const uint64_t gas_used{txn.gas_limit - refund_gas(evm, txn, result.gas_left, result.gas_refund)};
+                const uint64_t refunded_gas_left{refund_gas(evm, txn, result.gas_left, result.gas_refund)};
+                const uint64_t gas_used{txn.gas_limit - refunded_gas_left};
                 if (refund) {
                     gas_left = txn.gas_limit - gas_used;
                 }
@@ -299,19 +405,41 @@ boost::asio::awaitable<ExecutionResult> EVMExecutor<WorldState, VM>::call(
                 }
                 state_.finalize_transaction();
 
-                ExecutionResult exec_result{result.status, gas_left, result.data};
+                ExecutionResult exec_result{result.status, gas_left, result.data, std::nullopt, refunded_gas_left - result.gas_left};
+                if (profile != nullptr) {
+                    profile->add(RequestPhase::evm, std::chrono::steady_clock::now() - start_time);
+                }
+                scope.end();
                 boost::asio::post(io_context_, [exec_result, self = std::move(self)]() mutable {
                     self.complete(exec_result);
                 });
             });
         },
         boost::asio::use_awaitable);
+    token.throw_if_cancelled();
 
     SILKRPC_DEBUG << "EVMExecutor::call exec_result: " << exec_result.error_code << " #data: " << exec_result.data.size() << " end\n";
+    call_span.set_attribute("status", static_cast<uint64_t>(exec_result.error_code));
+    SILKRPC_PROBE(evm_call_done, block.header.number, static_cast<uint64_t>(exec_result.error_code), exec_result.gas_left);
+
+    if (access_history_ && txn.to && !exec_result.pre_check_error) {
+        access_history_->record(*txn.to, remote_state_.accessed_state());
+    }
 
     co_return exec_result;
 }
 
+template<typename WorldState, typename VM>
+AccessedState EVMExecutor<WorldState, VM>::read_set() const {
+    const auto& accessed_state{remote_state_.accessed_state()};
+    const auto num_accounts{std::min(num_execution_accounts_, accessed_state.accounts.size())};
+    AccessedState read_set{
+        {accessed_state.accounts.cbegin(), accessed_state.accounts.cbegin() + static_cast<std::ptrdiff_t>(num_accounts)},
+        accessed_state.locations};
+    read_set.normalize();
+    return read_set;
+}
+
 template class EVMExecutor<silkworm::IntraBlockState, silkworm::EVM>;
 
 } // namespace silkrpc
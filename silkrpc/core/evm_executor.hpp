@@ -35,6 +35,7 @@
 #include <silkworm/types/block.hpp>
 #include <silkworm/types/transaction.hpp>
 
+#include <silkrpc/common/access_history.hpp>
 #include <silkrpc/concurrency/context_pool.hpp>
 #include <silkrpc/core/remote_state.hpp>
 #include <silkrpc/core/rawdb/accessors.hpp>
@@ -46,6 +47,8 @@ struct ExecutionResult {
     uint64_t gas_left;
     silkworm::Bytes data;
     std::optional<std::string> pre_check_error{std::nullopt};
+    //! The gas refunded to the sender at the end of the execution, included in gas_left when refunding
+    uint64_t gas_refund{0};
 };
 
 using Tracers = std::vector<std::shared_ptr<silkworm::EvmTracer>>;
@@ -61,8 +64,22 @@ public:
         const silkworm::ChainConfig& config,
         boost::asio::thread_pool& workers,
         uint64_t block_number,
-        state::RemoteState& remote_state)
-        : io_context_(io_context), db_reader_(db_reader), config_(config), workers_{workers}, remote_state_{remote_state}, state_{remote_state_} {}
+        state::RemoteState& remote_state,
+        std::shared_ptr<AccessHistory> access_history = nullptr)
+        : EVMExecutor{io_context, db_reader, config, workers, block_number, remote_state, remote_state, std::move(access_history)} {}
+
+    //! Execute on the specified state in front of the remote one, e.g. an OverlayState, still prefetching from the remote one
+    explicit EVMExecutor(
+        boost::asio::io_context& io_context,
+        const core::rawdb::DatabaseReader& db_reader,
+        const silkworm::ChainConfig& config,
+        boost::asio::thread_pool& workers,
+        uint64_t block_number,
+        state::RemoteState& remote_state,
+        silkworm::State& state,
+        std::shared_ptr<AccessHistory> access_history = nullptr)
+        : io_context_(io_context), db_reader_(db_reader), config_(config), workers_{workers}, remote_state_{remote_state}, state_{state},
+          access_history_{std::move(access_history)} {}
     virtual ~EVMExecutor() {}
 
     EVMExecutor(const EVMExecutor&) = delete;
@@ -71,7 +88,21 @@ public:
     boost::asio::awaitable<ExecutionResult> call(const silkworm::Block& block, const silkworm::Transaction& txn, const Tracers& tracers = {}, bool refund = true, bool gas_bailout = false);
     void reset();
 
+    //! Execute the transactions one after the other on the same state, so that each one sees the state changed by the
+    //! previous ones: any failed or reverted transaction just gets its own result, the following ones are executed anyway
+    boost::asio::awaitable<std::vector<ExecutionResult>> call_many(const silkworm::Block& block, const std::vector<silkworm::Transaction>& txns);
+
+    //! Write the state changed by the calls so far into the state executed on, e.g. an OverlayState recording a checkpoint
+    void write_state(uint64_t block_number);
+
+    //! The accounts and locations read by the last call up to the end of its execution, i.e. the state its result depends
+    //! on: the fee recipient read afterwards just to be rewarded is left out
+    AccessedState read_set() const;
+
 private:
+    //! Prefetch the state surely read by the transaction plus the one read by the previous executions towards the same recipient
+    boost::asio::awaitable<void> prefetch(const silkworm::Block& block, const silkworm::Transaction& txn);
+
     std::optional<std::string> pre_check(const VM& evm, const silkworm::Transaction& txn, const intx::uint256 base_fee_per_gas, const intx::uint128 g0);
     uint64_t refund_gas(const VM& evm, const silkworm::Transaction& txn, uint64_t gas_left, uint64_t gas_refund);
 
@@ -81,6 +112,8 @@ private:
     boost::asio::thread_pool& workers_;
     state::RemoteState& remote_state_;
     WorldState state_;
+    std::shared_ptr<AccessHistory> access_history_;
+    std::size_t num_execution_accounts_{0};
 };
 
 } // namespace silkrpc
@@ -0,0 +1,119 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "evm_executor.hpp"
+
+#include <optional>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/use_future.hpp>
+#include <evmc/evmc.hpp>
+#include <grpcpp/grpcpp.h>
+#include <silkworm/common/util.hpp>
+#include <silkworm/types/account.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/common/util.hpp>
+#include <silkrpc/ethdb/tables.hpp>
+
+namespace silkrpc {
+
+using evmc::literals::operator""_address, evmc::literals::operator""_bytes32;
+
+static constexpr auto kContractAddress{0x0715a7794a1dc8e42615f059dd6e406a6594651a_address};
+static constexpr auto kContractCodeHash{0x1f2e3d4c5b6a798897a6b5c4d3e2f1000f1e2d3c4b5a69788796a5b4c3d2e1f0_bytes32};
+static constexpr auto kSenderAddress{0xa872626373628737383927236382161739290870_address};
+static constexpr uint64_t kBlockNumber{6'000'000};
+
+//! Loop incrementing a counter from 0 to 1000 on the stack, i.e. just arithmetic and jumps without any state access
+static const silkworm::Bytes kContractCode{*silkworm::from_hex("60005b600101806103e81160025700")};
+
+//! In-memory state having just the contract account and its code, everything else being empty
+class ContractDatabase : public core::rawdb::DatabaseReader {
+public:
+    ContractDatabase() {
+        silkworm::Account account;
+        account.code_hash = kContractCodeHash;
+        encoded_account_ = account.encode_for_storage();
+    }
+
+    boost::asio::awaitable<KeyValue> get(const std::string& table, const silkworm::ByteView& key) const override {
+        co_return KeyValue{};
+    }
+    boost::asio::awaitable<silkworm::Bytes> get_one(const std::string& table, const silkworm::ByteView& key) const override {
+        if (table == db::table::kPlainState && key == full_view(kContractAddress)) {
+            co_return encoded_account_;
+        }
+        if (table == db::table::kCode && key == full_view(kContractCodeHash)) {
+            co_return kContractCode;
+        }
+        co_return silkworm::Bytes{};
+    }
+    boost::asio::awaitable<std::optional<silkworm::Bytes>> get_both_range(const std::string& table, const silkworm::ByteView& key, const silkworm::ByteView& subkey) const override {
+        co_return silkworm::Bytes{};
+    }
+    boost::asio::awaitable<void> walk(const std::string& table, const silkworm::ByteView& start_key, uint32_t fixed_bits, core::rawdb::Walker w) const override {
+        co_return;
+    }
+    boost::asio::awaitable<void> for_prefix(const std::string& table, const silkworm::ByteView& prefix, core::rawdb::Walker w) const override {
+        co_return;
+    }
+
+private:
+    silkworm::Bytes encoded_account_;
+};
+
+//! Execute one call on the worker, including the state reads through the context, as done by eth_call
+static void BM_EVMExecutor_call(benchmark::State& state) {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    ContractDatabase db;
+    const auto chain_config_ptr = lookup_chain_config(5);
+
+    ContextPool context_pool{1, []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); }};
+    boost::asio::thread_pool workers{1};
+    context_pool.start();
+    auto& io_context = context_pool.next_io_context();
+
+    silkworm::Block block{};
+    block.header.number = kBlockNumber;
+    block.header.base_fee_per_gas = 0;
+    silkworm::Transaction txn{};
+    txn.from = kSenderAddress;
+    txn.to = kContractAddress;
+    txn.gas_limit = 1'000'000;
+
+    for (auto _ : state) {
+        state::RemoteState remote_state{io_context, db, kBlockNumber};
+        EVMExecutor executor{io_context, db, *chain_config_ptr, workers, kBlockNumber, remote_state};
+        auto execution_result = boost::asio::co_spawn(io_context, executor.call(block, txn), boost::asio::use_future);
+        const auto result = execution_result.get();
+        if (result.error_code != evmc_status_code::EVMC_SUCCESS) {
+            state.SkipWithError(("call failed: " + result.pre_check_error.value_or(std::to_string(result.error_code))).c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(result.gas_left);
+    }
+
+    context_pool.stop();
+    context_pool.join();
+}
+BENCHMARK(BM_EVMExecutor_call)->UseRealTime();
+
+} // namespace silkrpc
@@ -16,6 +16,8 @@
 
 #include "evm_executor.hpp"
 
+#include <algorithm>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -26,6 +28,7 @@
 #include <catch2/catch.hpp>
 #include <evmc/evmc.hpp>
 #include <intx/intx.hpp>
+#include <silkworm/execution/address.hpp>
 
 #include <silkrpc/common/util.hpp>
 #include <silkrpc/types/transaction.hpp>
@@ -241,6 +244,38 @@ TEST_CASE("EVMexecutor") {
         CHECK(result.error_code == 0);
     }
 
+    SECTION("call records the state accessed towards the recipient") {
+        StubDatabase tx_database;
+        const uint64_t chain_id = 5;
+        const auto chain_config_ptr = lookup_chain_config(chain_id);
+
+        ChannelFactory my_channel = []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); };
+        ContextPool my_pool{1, my_channel};
+        boost::asio::thread_pool workers{1};
+        my_pool.start();
+
+        const auto block_number = 6000000;
+        silkworm::Block block{};
+        block.header.number = block_number;
+        silkworm::Transaction txn{};
+        txn.gas_limit = 600000;
+        txn.from = 0xa872626373628737383927236382161739290870_address;
+        txn.to = 0x0715a7794a1dc8e42615f059dd6e406a6594651a_address;
+
+        boost::asio::io_context& io_context = my_pool.next_io_context();
+        auto access_history = std::make_shared<AccessHistory>();
+        state::RemoteState remote_state{io_context, tx_database, block_number};
+        EVMExecutor executor{io_context, tx_database, *chain_config_ptr, workers, block_number, remote_state, access_history};
+        auto execution_result = boost::asio::co_spawn(my_pool.next_io_context().get_executor(), executor.call(block, txn, {}, true, true), boost::asio::use_future);
+        auto result = execution_result.get();
+        my_pool.stop();
+        my_pool.join();
+        CHECK(result.error_code == 0);
+        const auto accessed_state = access_history->find(*txn.to);
+        REQUIRE(accessed_state);
+        CHECK(std::find(accessed_state->accounts.begin(), accessed_state->accounts.end(), *txn.from) != accessed_state->accounts.end());
+    }
+
     static silkworm::Bytes error_data{
                                0x08, 0xc3, 0x79, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
                                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
@@ -835,6 +870,103 @@ TEST_CASE("EVMexecutor") {
         my_pool.join();
         CHECK(error_message == "wasm trap");
     }
+
+    // The init code of the contract returning 42 and of the one always reverting
+    static const silkworm::Bytes return_42_init_code{
+        0x69, 0x60, 0x2a, 0x60, 0x00, 0x52, 0x60, 0x20, 0x60, 0x00, 0xf3, 0x60, 0x00, 0x52, 0x60, 0x0a, 0x60, 0x16, 0xf3};
+    static const silkworm::Bytes revert_init_code{0x64, 0x60, 0x00, 0x60, 0x00, 0xfd, 0x60, 0x00, 0x52, 0x60, 0x05, 0x60, 0x1b, 0xf3};
+    static const auto sender{0xa872626373628737383927236382161739290870_address};
+
+    const auto make_deployment = [](const silkworm::Bytes& init_code) {
+        silkworm::Transaction txn{};
+        txn.gas_limit = 1'000'000;
+        txn.from = sender;
+        txn.data = init_code;
+        return txn;
+    };
+    const auto make_call = [](const evmc::address& to) {
+        silkworm::Transaction txn{};
+        txn.gas_limit = 100'000;
+        txn.from = sender;
+        txn.to = to;
+        return txn;
+    };
+    silkworm::Bytes value_42(32, 0x00);
+    value_42[31] = 0x2a;
+
+    SECTION("call_many executes each call on the state written by the previous ones") {
+        StubDatabase tx_database;
+        const auto chain_config_ptr = lookup_chain_config(5);
+
+        ChannelFactory my_channel = []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); };
+        ContextPool my_pool{1, my_channel};
+        boost::asio::thread_pool workers{1};
+        my_pool.start();
+
+        const auto block_number = 6000000;
+        silkworm::Block block{};
+        block.header.number = block_number;
+        const auto contract_address{silkworm::create_address(sender, 0)};
+        const std::vector<silkworm::Transaction> txns{make_deployment(return_42_init_code), make_call(contract_address)};
+
+        boost::asio::io_context& io_context = my_pool.next_io_context();
+        state::RemoteState remote_state{io_context, tx_database, block_number};
+        EVMExecutor executor{io_context, tx_database, *chain_config_ptr, workers, block_number, remote_state};
+        auto execution_results = boost::asio::co_spawn(io_context.get_executor(), executor.call_many(block, txns), boost::asio::use_future);
+        const auto results = execution_results.get();
+
+        // Without the deployment in front, the same call finds no code at all
+        state::RemoteState other_remote_state{io_context, tx_database, block_number};
+        EVMExecutor other_executor{io_context, tx_database, *chain_config_ptr, workers, block_number, other_remote_state};
+        const std::vector<silkworm::Transaction> other_txns{make_call(contract_address)};
+        auto other_execution_results = boost::asio::co_spawn(io_context.get_executor(), other_executor.call_many(block, other_txns),
+            boost::asio::use_future);
+        const auto other_results = other_execution_results.get();
+        my_pool.stop();
+        my_pool.join();
+
+        REQUIRE(results.size() == 2);
+        CHECK(results[0].error_code == evmc_status_code::EVMC_SUCCESS);
+        CHECK(results[1].error_code == evmc_status_code::EVMC_SUCCESS);
+        CHECK(results[1].data == value_42);
+        REQUIRE(other_results.size() == 1);
+        CHECK(other_results[0].error_code == evmc_status_code::EVMC_SUCCESS);
+        CHECK(other_results[0].data.empty());
+    }
+
+    SECTION("call_many executes the calls following a reverted one") {
+        StubDatabase tx_database;
+        const auto chain_config_ptr = lookup_chain_config(5);
+
+        ChannelFactory my_channel = []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); };
+        ContextPool my_pool{1, my_channel};
+        boost::asio::thread_pool workers{1};
+        my_pool.start();
+
+        const auto block_number = 6000000;
+        silkworm::Block block{};
+        block.header.number = block_number;
+        // Each call increments the sender nonce, so the second contract is created with nonce 2
+        const std::vector<silkworm::Transaction> txns{
+            make_deployment(revert_init_code), make_call(silkworm::create_address(sender, 0)),
+            make_deployment(return_42_init_code), make_call(silkworm::create_address(sender, 2))};
+
+        boost::asio::io_context& io_context = my_pool.next_io_context();
+        state::RemoteState remote_state{io_context, tx_database, block_number};
+        EVMExecutor executor{io_context, tx_database, *chain_config_ptr, workers, block_number, remote_state};
+        auto execution_results = boost::asio::co_spawn(io_context.get_executor(), executor.call_many(block, txns), boost::asio::use_future);
+        const auto results = execution_results.get();
+        my_pool.stop();
+        my_pool.join();
+
+        REQUIRE(results.size() == 4);
+        CHECK(results[0].error_code == evmc_status_code::EVMC_SUCCESS);
+        CHECK(results[1].error_code == evmc_status_code::EVMC_REVERT);
+        CHECK(EVMExecutor<>::get_error_message(results[1].error_code, results[1].data) == "execution reverted");
+        CHECK(results[2].error_code == evmc_status_code::EVMC_SUCCESS);
+        CHECK(results[3].error_code == evmc_status_code::EVMC_SUCCESS);
+        CHECK(results[3].data == value_42);
+    }
 }
 
 } // namespace silkrpc
@@ -17,11 +17,16 @@
 #include "evm_trace.hpp"
 
 #include <algorithm>
+#include <exception>
 #include <memory>
+#include <optional>
 #include <set>
 #include <stack>
 #include <string>
+#include <utility>
 
+#include <boost/asio/this_coro.hpp>
+#include <boost/endian/conversion.hpp>
 #include <evmc/hex.hpp>
 #include <evmc/instructions.h>
 #include <intx/intx.hpp>
@@ -31,12 +36,19 @@
 #include <silkworm/third_party/evmone/lib/evmone/execution_state.hpp>
 #include <silkworm/third_party/evmone/lib/evmone/instructions.hpp>
 
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/hex.hpp>
 #include <silkrpc/common/log.hpp>
 #include <silkrpc/common/util.hpp>
+#include <silkrpc/concurrency/parallel_for.hpp>
 #include <silkrpc/consensus/ethash.hpp>
 #include <silkrpc/core/cached_chain.hpp>
 #include <silkrpc/core/evm_executor.hpp>
+#include <silkrpc/core/overlay_state.hpp>
 #include <silkrpc/core/rawdb/chain.hpp>
+#include <silkrpc/ethdb/bitmap.hpp>
+#include <silkrpc/ethdb/tables.hpp>
+#include <silkrpc/ethdb/transaction_database.hpp>
 #include <silkrpc/json/types.hpp>
 
 namespace silkrpc::trace {
@@ -141,7 +153,10 @@ void to_json(nlohmann::json& json, const TraceEx& trace_ex) {
         json["mem"] = nlohmann::json::value_t::null;
     }
 
-    json["push"] = trace_ex.stack;
+    auto& push = json["push"] = nlohmann::json::array();
+    for (const auto& item : trace_ex.stack) {
+        push.push_back(to_quantity(item));
+    }
     if (trace_ex.storage) {
         const auto& storage = trace_ex.storage.value();
         json["store"] = storage;
@@ -153,7 +168,7 @@ void to_json(nlohmann::json& json, const TraceEx& trace_ex) {
 
 void to_json(nlohmann::json& json, const TraceMemory& trace_memory) {
     json = {
-        {"data", trace_memory.data},
+        {"data", silkrpc::to_hex(trace_memory.data, /*with_prefix=*/true)},
         {"off", trace_memory.offset}
     };
 }
@@ -177,10 +192,10 @@ void to_json(nlohmann::json& json, const TraceAction& action) {
     ss << "0x" << std::hex << action.gas;
     json["gas"] = ss.str();
     if (action.input) {
-        json["input"] = "0x" + silkworm::to_hex(action.input.value());
+        json["input"] = silkrpc::to_hex(action.input.value(), /*with_prefix=*/true);
     }
     if (action.init) {
-        json["init"] = "0x" + silkworm::to_hex(action.init.value());
+        json["init"] = silkrpc::to_hex(action.init.value(), /*with_prefix=*/true);
     }
     json["value"] = to_quantity(action.value);
 }
@@ -196,10 +211,10 @@ void to_json(nlohmann::json& json, const TraceResult& trace_result) {
         json["address"] = trace_result.address.value();
     }
     if (trace_result.code) {
-        json["code"] = "0x" + silkworm::to_hex(trace_result.code.value());
+        json["code"] = silkrpc::to_hex(trace_result.code.value(), /*with_prefix=*/true);
     }
     if (trace_result.output) {
-        json["output"] = "0x" + silkworm::to_hex(trace_result.output.value());
+        json["output"] = silkrpc::to_hex(trace_result.output.value(), /*with_prefix=*/true);
     }
     std::ostringstream ss;
     ss << "0x" << std::hex << trace_result.gas_used;
@@ -237,6 +252,276 @@ void to_json(nlohmann::json& json, const Trace& trace) {
     }
 }
 
+namespace {
+
+//! Writer of the trace store format: fixed-size big-endian integers, length-prefixed byte strings, presence-flagged optionals
+class TraceWriter {
+  public:
+    explicit TraceWriter(silkworm::Bytes& bytes) : bytes_{bytes} {}
+
+    void write_u8(uint8_t value) { bytes_.push_back(value); }
+
+    void write_u32(uint32_t value) {
+        uint8_t buffer[sizeof(uint32_t)];
+        boost::endian::store_big_u32(buffer, value);
+        bytes_.append(buffer, sizeof(buffer));
+    }
+
+    void write_u64(uint64_t value) {
+        uint8_t buffer[sizeof(uint64_t)];
+        boost::endian::store_big_u64(buffer, value);
+        bytes_.append(buffer, sizeof(buffer));
+    }
+
+    void write_bytes(silkworm::ByteView bytes) {
+        write_u32(static_cast<uint32_t>(bytes.size()));
+        bytes_.append(bytes);
+    }
+
+    void write_string(const std::string& s) { write_bytes({reinterpret_cast<const uint8_t*>(s.data()), s.size()}); }
+
+    void write_address(const evmc::address& address) { bytes_.append(address.bytes, sizeof(address.bytes)); }
+
+    void write_bytes32(const evmc::bytes32& bytes32) { bytes_.append(bytes32.bytes, sizeof(bytes32.bytes)); }
+
+    void write_uint256(const intx::uint256& value) { write_bytes32(intx::be::store<evmc::bytes32>(value)); }
+
+    template <typename T, typename F>
+    void write_optional(const std::optional<T>& value, F&& write) {
+        write_u8(value ? 1 : 0);
+        if (value) {
+            write(*value);
+        }
+    }
+
+  private:
+    silkworm::Bytes& bytes_;
+};
+
+//! Reader of the trace store format, failing on any truncated or malformed input
+class TraceReader {
+  public:
+    explicit TraceReader(silkworm::ByteView bytes) : bytes_{bytes} {}
+
+    bool at_end() const { return position_ == bytes_.size(); }
+
+    std::size_t remaining() const { return bytes_.size() - position_; }
+
+    bool read_u8(uint8_t& value) {
+        if (remaining() < 1) {
+            return false;
+        }
+        value = bytes_[position_++];
+        return true;
+    }
+
+    bool read_u32(uint32_t& value) {
+        if (remaining() < sizeof(uint32_t)) {
+            return false;
+        }
+        value = boost::endian::load_big_u32(&bytes_[position_]);
+        position_ += sizeof(uint32_t);
+        return true;
+    }
+
+    bool read_u64(uint64_t& value) {
+        if (remaining() < sizeof(uint64_t)) {
+            return false;
+        }
+        value = boost::endian::load_big_u64(&bytes_[position_]);
+        position_ += sizeof(uint64_t);
+        return true;
+    }
+
+    bool read_bytes(silkworm::Bytes& bytes) {
+        uint32_t size{0};
+        if (!read_u32(size) || size > remaining()) {
+            return false;
+        }
+        bytes = bytes_.substr(position_, size);
+        position_ += size;
+        return true;
+    }
+
+    bool read_string(std::string& s) {
+        uint32_t size{0};
+        if (!read_u32(size) || size > remaining()) {
+            return false;
+        }
+        s.assign(reinterpret_cast<const char*>(&bytes_[position_]), size);
+        position_ += size;
+        return true;
+    }
+
+    bool read_address(evmc::address& address) { return read_fixed(address.bytes, sizeof(address.bytes)); }
+
+    bool read_bytes32(evmc::bytes32& bytes32) { return read_fixed(bytes32.bytes, sizeof(bytes32.bytes)); }
+
+    bool read_uint256(intx::uint256& value) {
+        evmc::bytes32 bytes32;
+        if (!read_bytes32(bytes32)) {
+            return false;
+        }
+        value = intx::be::load<intx::uint256>(bytes32);
+        return true;
+    }
+
+    template <typename T, typename F>
+    bool read_optional(std::optional<T>& value, F&& read) {
+        uint8_t present{0};
+        if (!read_u8(present) || present > 1) {
+            return false;
+        }
+        if (present == 0) {
+            value.reset();
+            return true;
+        }
+        value.emplace();
+        return read(*value);
+    }
+
+  private:
+    bool read_fixed(uint8_t* data, std::size_t size) {
+        if (remaining() < size) {
+            return false;
+        }
+        std::copy_n(&bytes_[position_], size, data);
+        position_ += size;
+        return true;
+    }
+
+    silkworm::ByteView bytes_;
+    std::size_t position_{0};
+};
+
+//! The tags of the action alternatives in the trace store format
+constexpr uint8_t kTraceActionTag{0};
+constexpr uint8_t kRewardActionTag{1};
+
+} // namespace
+
+static void write_trace(TraceWriter& writer, const Trace& trace) {
+    const auto write_bytes = [&](const silkworm::Bytes& bytes) { writer.write_bytes(bytes); };
+    const auto write_string = [&](const std::string& s) { writer.write_string(s); };
+    const auto write_address = [&](const evmc::address& address) { writer.write_address(address); };
+    const auto write_bytes32 = [&](const evmc::bytes32& bytes32) { writer.write_bytes32(bytes32); };
+
+    if (std::holds_alternative<TraceAction>(trace.action)) {
+        const auto& action = std::get<TraceAction>(trace.action);
+        writer.write_u8(kTraceActionTag);
+        writer.write_optional(action.call_type, write_string);
+        writer.write_address(action.from);
+        writer.write_optional(action.to, write_address);
+        writer.write_u64(action.gas);
+        writer.write_optional(action.input, write_bytes);
+        writer.write_optional(action.init, write_bytes);
+        writer.write_uint256(action.value);
+    } else {
+        const auto& action = std::get<RewardAction>(trace.action);
+        writer.write_u8(kRewardActionTag);
+        writer.write_address(action.author);
+        writer.write_string(action.reward_type);
+        writer.write_uint256(action.value);
+    }
+    writer.write_optional(trace.trace_result, [&](const TraceResult& trace_result) {
+        writer.write_optional(trace_result.address, write_address);
+        writer.write_optional(trace_result.code, write_bytes);
+        writer.write_optional(trace_result.output, write_bytes);
+        writer.write_u64(trace_result.gas_used);
+    });
+    writer.write_u32(static_cast<uint32_t>(trace.sub_traces));
+    writer.write_u32(static_cast<uint32_t>(trace.trace_address.size()));
+    for (const auto index : trace.trace_address) {
+        writer.write_u32(index);
+    }
+    writer.write_optional(trace.error, write_string);
+    writer.write_string(trace.type);
+    writer.write_optional(trace.block_hash, write_bytes32);
+    writer.write_optional(trace.block_number, [&](uint64_t block_number) { writer.write_u64(block_number); });
+    writer.write_optional(trace.transaction_hash, write_bytes32);
+    writer.write_optional(trace.transaction_position, [&](uint32_t position) { writer.write_u32(position); });
+}
+
+static bool read_trace(TraceReader& reader, Trace& trace) {
+    const auto read_bytes = [&](silkworm::Bytes& bytes) { return reader.read_bytes(bytes); };
+    const auto read_string = [&](std::string& s) { return reader.read_string(s); };
+    const auto read_address = [&](evmc::address& address) { return reader.read_address(address); };
+    const auto read_bytes32 = [&](evmc::bytes32& bytes32) { return reader.read_bytes32(bytes32); };
+
+    uint8_t tag{0};
+    if (!reader.read_u8(tag)) {
+        return false;
+    }
+    if (tag == kTraceActionTag) {
+        TraceAction action;
+        if (!reader.read_optional(action.call_type, read_string) || !reader.read_address(action.from) ||
+            !reader.read_optional(action.to, read_address) || !reader.read_u64(action.gas) ||
+            !reader.read_optional(action.input, read_bytes) || !reader.read_optional(action.init, read_bytes) ||
+            !reader.read_uint256(action.value)) {
+            return false;
+        }
+        trace.action = std::move(action);
+    } else if (tag == kRewardActionTag) {
+        RewardAction action;
+        if (!reader.read_address(action.author) || !reader.read_string(action.reward_type) || !reader.read_uint256(action.value)) {
+            return false;
+        }
+        trace.action = std::move(action);
+    } else {
+        return false;
+    }
+    const auto read_trace_result = [&](TraceResult& trace_result) {
+        return reader.read_optional(trace_result.address, read_address) && reader.read_optional(trace_result.code, read_bytes) &&
+            reader.read_optional(trace_result.output, read_bytes) && reader.read_u64(trace_result.gas_used);
+    };
+    uint32_t sub_traces{0};
+    uint32_t trace_address_size{0};
+    if (!reader.read_optional(trace.trace_result, read_trace_result) || !reader.read_u32(sub_traces) ||
+        !reader.read_u32(trace_address_size) || trace_address_size > reader.remaining() / sizeof(uint32_t)) {
+        return false;
+    }
+    trace.sub_traces = static_cast<std::int32_t>(sub_traces);
+    trace.trace_address.resize(trace_address_size);
+    for (auto& index : trace.trace_address) {
+        if (!reader.read_u32(index)) {
+            return false;
+        }
+    }
+    return reader.read_optional(trace.error, read_string) && reader.read_string(trace.type) &&
+        reader.read_optional(trace.block_hash, read_bytes32) &&
+        reader.read_optional(trace.block_number, [&](uint64_t& block_number) { return reader.read_u64(block_number); }) &&
+        reader.read_optional(trace.transaction_hash, read_bytes32) &&
+        reader.read_optional(trace.transaction_position, [&](uint32_t& position) { return reader.read_u32(position); });
+}
+
+silkworm::Bytes encode_traces(const std::vector<Trace>& traces) {
+    silkworm::Bytes bytes;
+    TraceWriter writer{bytes};
+    writer.write_u32(static_cast<uint32_t>(traces.size()));
+    for (const auto& trace : traces) {
+        write_trace(writer, trace);
+    }
+    return bytes;
+}
+
+std::optional<std::vector<Trace>> decode_traces(silkworm::ByteView bytes) {
+    TraceReader reader{bytes};
+    uint32_t num_traces{0};
+    if (!reader.read_u32(num_traces) || num_traces > reader.remaining()) {
+        return std::nullopt;
+    }
+    std::vector<Trace> traces(num_traces);
+    for (auto& trace : traces) {
+        if (!read_trace(reader, trace)) {
+            return std::nullopt;
+        }
+    }
+    if (!reader.at_end()) {
+        return std::nullopt;
+    }
+    return traces;
+}
+
 void to_json(nlohmann::json& json, const DiffValue& dv) {
     if (dv.from && dv.to) {
         json["*"] = {
@@ -430,12 +715,11 @@ int get_stack_count(std::uint8_t op_code) {
     return count;
 }
 
-void copy_stack(std::uint8_t op_code, const evmone::uint256* stack, std::vector<std::string>& trace_stack) {
+void copy_stack(std::uint8_t op_code, const evmone::uint256* stack, std::vector<intx::uint256>& trace_stack) {
     int top = get_stack_count(op_code);
     trace_stack.reserve(top);
     for (int i = top - 1; i >= 0; i--) {
-        const auto str = intx::to_string(stack[-i], 16);
-        trace_stack.push_back("0x" + intx::to_string(stack[-i], 16));
+        trace_stack.push_back(stack[-i]);
     }
 }
 
@@ -446,13 +730,8 @@ void copy_memory(const evmone::Memory& memory, std::optional<TraceMemory>& trace
             trace_memory.reset();
             return;
         }
-        tm.data = "0x";
-        const auto data = memory.data();
-        auto start = tm.offset;
-        for (int idx = 0; idx < tm.len; idx++) {
-            std::string entry{evmc::hex({data + start + idx, 1})};
-            tm.data.append(entry);
-        }
+        // Just the region written by the instruction is copied, w/o any encoding until serialization
+        tm.data.assign(memory.data() + tm.offset, tm.len);
     }
 }
 
@@ -539,7 +818,7 @@ void VmTraceTracer::on_execution_start(evmc_revision rev, const evmc_message& ms
     start_gas_.push(msg.gas);
 
     if (msg.depth == 0) {
-        vm_trace_.code = "0x" + silkworm::to_hex(code);
+        vm_trace_.code = silkrpc::to_hex(code, /*with_prefix=*/true);
         traces_stack_.push(vm_trace_);
         if (transaction_index_ == -1) {
             index_prefix_.push("");
@@ -563,7 +842,7 @@ void VmTraceTracer::on_execution_start(evmc_revision rev, const evmc_message& ms
         }
         op.sub = std::make_shared<VmTrace>();
         traces_stack_.push(*op.sub);
-        op.sub->code = "0x" + silkworm::to_hex(code);
+        op.sub->code = silkrpc::to_hex(code, /*with_prefix=*/true);
     }
 
     auto& index_prefix = index_prefix_.top();
@@ -912,6 +1191,19 @@ void TraceTracer::on_reward_granted(const silkworm::CallResult& result, const si
     }
 }
 
+void StateAddresses::apply(const StateCheckpoint& checkpoint) noexcept {
+    for (const auto& [address, account] : checkpoint.accounts) {
+        set_exists(address, account.has_value());
+        set_balance(address, account ? account->balance : 0);
+        set_nonce(address, account ? account->nonce : 0);
+        if (!account) {
+            set_code(address, {});
+        } else if (const auto it = checkpoint.code.find(account->code_hash); it != checkpoint.code.end()) {
+            set_code(address, it->second);
+        }
+    }
+}
+
 intx::uint256 StateAddresses::get_balance(const evmc::address& address) const noexcept {
     auto it = balances_.find(address);
     if (it != balances_.end()) {
@@ -928,6 +1220,14 @@ uint64_t StateAddresses::get_nonce(const evmc::address& address) const noexcept
     return initial_ibs_.get_nonce(address);
 }
 
+bool StateAddresses::exists(const evmc::address& address) const noexcept {
+    auto it = exists_.find(address);
+    if (it != exists_.end()) {
+        return it->second;
+    }
+    return initial_ibs_.exists(address);
+}
+
 silkworm::ByteView StateAddresses::get_code(const evmc::address& address) const noexcept {
     auto it = codes_.find(address);
     if (it != codes_.end()) {
@@ -942,8 +1242,6 @@ void StateDiffTracer::on_execution_start(evmc_revision rev, const evmc_message&
     }
 
     auto recipient = evmc::address{msg.recipient};
-    code_[recipient] = code;
-
     auto exists = state_addresses_.exists(recipient);
 
     SILKRPC_DEBUG << "StateDiffTracer::on_execution_start: gas: " << std::dec << msg.gas
@@ -960,12 +1258,9 @@ void StateDiffTracer::on_instruction_start(uint32_t pc , const intx::uint256 *st
     auto opcode_name = get_op_name(opcode_names_, opcode);
 
     if (opcode == evmc_opcode::OP_SSTORE) {
-        auto key = to_string(stack_top[0]);
-        auto value = to_string(stack_top[-1]);
+        // The original and current values are read just once the call is over
         auto address = evmc::address{execution_state.msg->recipient};
-        auto original_value = intra_block_state.get_original_storage(address, silkworm::bytes32_from_hex(key));
-        auto& keys = diff_storage_[address];
-        keys.insert(key);
+        diff_storage_[address].insert(intx::be::store<evmc::bytes32>(stack_top[0]));
     }
 
     SILKRPC_DEBUG << "StateDiffTracer::on_instruction_start:"
@@ -1000,7 +1295,7 @@ void StateDiffTracer::on_reward_granted(const silkworm::CallResult& result, cons
         auto exists = intra_block_state.exists(address);
         auto& diff_storage = diff_storage_[address];
 
-        auto address_key = "0x" + silkworm::to_hex(address);
+        auto address_key = silkrpc::to_hex(address, /*with_prefix=*/true);
         auto& entry = state_diff_[address_key];
         if (initial_exists) {
             auto initial_balance = state_addresses_.get_balance(address);
@@ -1020,8 +1315,8 @@ void StateDiffTracer::on_reward_granted(const silkworm::CallResult& result, cons
                 if (initial_code != final_code) {
                     all_equals = false;
                     entry.code = DiffValue {
-                        "0x" + silkworm::to_hex(initial_code),
-                        "0x" + silkworm::to_hex(final_code)
+                        silkrpc::to_hex(initial_code, /*with_prefix=*/true),
+                        silkrpc::to_hex(final_code, /*with_prefix=*/true)
                     };
                 }
                 auto final_nonce = intra_block_state.get_nonce(address);
@@ -1032,17 +1327,15 @@ void StateDiffTracer::on_reward_granted(const silkworm::CallResult& result, cons
                         to_quantity(final_nonce)
                     };
                 }
-                for (auto& key : diff_storage) {
-                    auto key_b32 = silkworm::bytes32_from_hex(key);
-
-                    auto initial_storage = intra_block_state.get_original_storage(address, key_b32);
-                    auto final_storage = intra_block_state.get_current_storage(address, key_b32);
+                for (const auto& key : diff_storage) {
+                    const auto initial_storage = intra_block_state.get_original_storage(address, key);
+                    const auto final_storage = intra_block_state.get_current_storage(address, key);
 
                     if (initial_storage != final_storage) {
                         all_equals = false;
-                        entry.storage[key] = DiffValue{
-                            "0x" + silkworm::to_hex(intra_block_state.get_original_storage(address, key_b32)),
-                            "0x" + silkworm::to_hex(intra_block_state.get_current_storage(address, key_b32))
+                        entry.storage[silkrpc::to_hex(key, /*with_prefix=*/true)] = DiffValue{
+                            silkrpc::to_hex(initial_storage, /*with_prefix=*/true),
+                            silkrpc::to_hex(final_storage, /*with_prefix=*/true)
                         };
                     }
                 }
@@ -1054,15 +1347,14 @@ void StateDiffTracer::on_reward_granted(const silkworm::CallResult& result, cons
                     "0x" + intx::to_string(initial_balance, 16)
                 };
                 entry.code = DiffValue {
-                    "0x" + silkworm::to_hex(initial_code)
+                    silkrpc::to_hex(initial_code, /*with_prefix=*/true)
                 };
                 entry.nonce = DiffValue {
                     to_quantity(initial_nonce)
                 };
-                for (auto& key : diff_storage) {
-                    auto key_b32 = silkworm::bytes32_from_hex(key);
-                    entry.storage[key] = DiffValue {
-                        "0x" + silkworm::to_hex(intra_block_state.get_original_storage(address, key_b32))
+                for (const auto& key : diff_storage) {
+                    entry.storage[silkrpc::to_hex(key, /*with_prefix=*/true)] = DiffValue {
+                        silkrpc::to_hex(intra_block_state.get_original_storage(address, key), /*with_prefix=*/true)
                     };
                 }
             }
@@ -1075,7 +1367,7 @@ void StateDiffTracer::on_reward_granted(const silkworm::CallResult& result, cons
             const auto code = intra_block_state.get_code(address);
             entry.code = DiffValue {
                 {},
-                "0x" + silkworm::to_hex(code)
+                silkrpc::to_hex(code, /*with_prefix=*/true)
             };
             const auto nonce = intra_block_state.get_nonce(address);
             entry.nonce = DiffValue {
@@ -1084,12 +1376,12 @@ void StateDiffTracer::on_reward_granted(const silkworm::CallResult& result, cons
             };
 
             bool to_be_removed = (balance == 0) && (code == silkworm::Bytes{}) && (nonce == 0);
-            for (auto& key : diff_storage) {
-                auto key_b32 = silkworm::bytes32_from_hex(key);
-                if (intra_block_state.get_current_storage(address, key_b32) != evmc::bytes32{}) {
-                   entry.storage[key] = DiffValue {
+            for (const auto& key : diff_storage) {
+                const auto current_storage = intra_block_state.get_current_storage(address, key);
+                if (current_storage != evmc::bytes32{}) {
+                   entry.storage[silkrpc::to_hex(key, /*with_prefix=*/true)] = DiffValue {
                        {},
-                       "0x" + silkworm::to_hex(intra_block_state.get_current_storage(address, key_b32))
+                       silkrpc::to_hex(current_storage, /*with_prefix=*/true)
                    };
                 }
                 to_be_removed = false;
@@ -1124,11 +1416,25 @@ void IntraBlockStateTracer::on_reward_granted(const silkworm::CallResult& result
 
         auto code = intra_block_state.get_code(address);
         state_addresses_.set_code(address, code);
+
+        // The next call (if any) must see the accounts created or destructed by this one
+        state_addresses_.set_exists(address, intra_block_state.exists(address));
     }
 }
 
 template<typename WorldState, typename VM>
 boost::asio::awaitable<std::vector<Trace>> TraceCallExecutor<WorldState, VM>::trace_block(const silkworm::BlockWithHash& block_with_hash) {
+    const auto block_number = block_with_hash.block.header.number;
+    if (trace_store_ != nullptr) {
+        if (const auto stored_traces = trace_store_->get(block_number, block_with_hash.hash)) {
+            auto decoded_traces = decode_traces(*stored_traces);
+            if (decoded_traces) {
+                co_return std::move(*decoded_traces);
+            }
+            SILKRPC_WARN << "TraceCallExecutor::trace_block: invalid stored traces for block_number: " << block_number << ", replaying\n";
+        }
+    }
+
     std::vector<Trace> traces;
 
     const auto trace_call_results = co_await trace_block_transactions(block_with_hash.block, {false, true, false});
@@ -1154,8 +1460,8 @@ boost::asio::awaitable<std::vector<Trace>> TraceCallExecutor<WorldState, VM>::tr
         }
     }
 
-    const auto chain_config{co_await silkrpc::core::rawdb::read_chain_config(database_reader_)};
-    const auto block_rewards = ethash::compute_reward(chain_config, block_with_hash.block);
+    const auto chain_config{co_await silkrpc::core::rawdb::read_parsed_chain_config(database_reader_)};
+    const auto block_rewards = ethash::compute_reward(*chain_config, block_with_hash.block);
 
     RewardAction action;
     action.author = block_with_hash.block.header.beneficiary;
@@ -1170,6 +1476,10 @@ boost::asio::awaitable<std::vector<Trace>> TraceCallExecutor<WorldState, VM>::tr
 
     traces.push_back(trace);
 
+    if (trace_store_ != nullptr) {
+        trace_store_->put(block_number, block_with_hash.hash, encode_traces(traces));
+    }
+
     co_return traces;
 }
 
@@ -1183,14 +1493,15 @@ boost::asio::awaitable<std::vector<TraceCallResult>> TraceCallExecutor<WorldStat
     const auto chain_id = co_await core::rawdb::read_chain_id(database_reader_);
     const auto chain_config_ptr = lookup_chain_config(chain_id);
 
+    // The state preceding the block is read just once, whether by the executor or by the tracers
     state::RemoteState remote_state{io_context_, database_reader_, block_number-1};
-    silkworm::IntraBlockState initial_ibs{remote_state};
+    state::OverlayState block_state{remote_state};
+    silkworm::IntraBlockState initial_ibs{block_state};
 
     StateAddresses state_addresses(initial_ibs);
     std::shared_ptr<silkworm::EvmTracer> ibsTracer = std::make_shared<trace::IntraBlockStateTracer>(state_addresses);
 
-    state::RemoteState curr_remote_state{io_context_, database_reader_, block_number-1};
-    EVMExecutor<WorldState, VM> executor{io_context_, database_reader_, *chain_config_ptr, workers_, block_number-1, curr_remote_state};
+    EVMExecutor<WorldState, VM> executor{io_context_, database_reader_, *chain_config_ptr, workers_, block_number-1, remote_state, block_state};
 
     std::vector<TraceCallResult> trace_call_result(transactions.size());
     for (std::uint64_t index = 0; index < transactions.size(); index++) {
@@ -1227,7 +1538,7 @@ boost::asio::awaitable<std::vector<TraceCallResult>> TraceCallExecutor<WorldStat
         if (execution_result.pre_check_error) {
             result.pre_check_error = execution_result.pre_check_error.value();
         } else {
-            traces.output = "0x" + silkworm::to_hex(execution_result.data);
+            traces.output = silkrpc::to_hex(execution_result.data, /*with_prefix=*/true);
         }
         executor.reset();
     }
@@ -1252,12 +1563,13 @@ boost::asio::awaitable<TraceManyCallResult> TraceCallExecutor<WorldState, VM>::t
     const auto chain_id = co_await core::rawdb::read_chain_id(database_reader_);
     const auto chain_config_ptr = lookup_chain_config(chain_id);
 
+    // The state the calls start from is read just once, whether by the executor or by the tracers
     state::RemoteState remote_state{io_context_, database_reader_, block_number};
-    silkworm::IntraBlockState initial_ibs{remote_state};
+    state::OverlayState block_state{remote_state};
+    silkworm::IntraBlockState initial_ibs{block_state};
     StateAddresses state_addresses(initial_ibs);
 
-    state::RemoteState curr_remote_state{io_context_, database_reader_, block_number};
-    EVMExecutor<WorldState, VM> executor{io_context_, database_reader_, *chain_config_ptr, workers_, block_number, remote_state};
+    EVMExecutor<WorldState, VM> executor{io_context_, database_reader_, *chain_config_ptr, workers_, block_number, remote_state, block_state};
 
     std::shared_ptr<silkworm::EvmTracer> ibsTracer = std::make_shared<trace::IntraBlockStateTracer>(state_addresses);
 
@@ -1293,7 +1605,7 @@ boost::asio::awaitable<TraceManyCallResult> TraceCallExecutor<WorldState, VM>::t
             result.traces.clear();
             break;
         }
-        traces.output = "0x" + silkworm::to_hex(execution_result.data);
+        traces.output = silkrpc::to_hex(execution_result.data, /*with_prefix=*/true);
         result.traces.push_back(traces);
 
         executor.reset();
@@ -1306,6 +1618,20 @@ template<typename WorldState, typename VM>
 boost::asio::awaitable<std::vector<Trace>> TraceCallExecutor<WorldState, VM>::trace_transaction(const silkworm::BlockWithHash& block_with_hash, const silkrpc::Transaction& transaction) {
     std::vector<Trace> traces;
 
+    if (trace_store_ != nullptr) {
+        // The whole block is replayed just once to fill the store, a single transaction is cheaper to replay until then
+        const auto stored_traces = trace_store_->get(block_with_hash.block.header.number, block_with_hash.hash);
+        auto block_traces = stored_traces ? decode_traces(*stored_traces) : std::nullopt;
+        if (block_traces) {
+            for (auto& trace : *block_traces) {
+                if (trace.transaction_position == transaction.transaction_index) {
+                    traces.push_back(std::move(trace));
+                }
+            }
+            co_return traces;
+        }
+    }
+
     const auto result = co_await execute(block_with_hash.block.header.number-1, block_with_hash.block, transaction, transaction.transaction_index, {false, true, false});
     const auto& trace_result = result.traces.trace;
 
@@ -1326,15 +1652,57 @@ boost::asio::awaitable<std::vector<Trace>> TraceCallExecutor<WorldState, VM>::tr
     co_return traces;
 }
 
+//! Return the blocks indexed in the call index table by any of the addresses
+static boost::asio::awaitable<roaring::Roaring> get_call_blocks(const core::rawdb::DatabaseReader& database_reader, const std::string& table,
+    const std::set<evmc::address>& addresses, uint64_t from_block, uint64_t to_block) {
+    std::vector<silkworm::Bytes> keys;
+    keys.reserve(addresses.size());
+    for (const auto& address : addresses) {
+        keys.emplace_back(address.bytes, silkworm::kAddressLength);
+    }
+    const std::vector<ethdb::bitmap::QueryTerm> terms{{table, std::move(keys)}};
+    const auto blocks = co_await ethdb::bitmap::query(database_reader, terms, static_cast<uint32_t>(from_block), static_cast<uint32_t>(to_block));
+    co_return blocks.value_or(roaring::Roaring{});
+}
+
+//! Keep just the call traces whose sender is any of the from addresses or whose recipient is any of the to addresses
+static void filter_traces(std::vector<Trace>& traces, const std::set<evmc::address>& from_addresses, const std::set<evmc::address>& to_addresses) {
+    std::vector<Trace>::iterator itr = traces.begin();
+    while (itr != traces.end()) {
+        const auto& trace = *itr;
+        bool to_be_deleted = true;
+        if (std::holds_alternative<TraceAction>(trace.action)) {
+            const auto& action = std::get<TraceAction>(trace.action);
+            if (!from_addresses.empty()) {
+                if (from_addresses.find(action.from) != from_addresses.end()) {
+                    to_be_deleted = false;
+                }
+            }
+            if (!to_addresses.empty() && action.to) {
+                if (to_addresses.find(action.to.value()) != to_addresses.end()) {
+                    to_be_deleted = false;
+                }
+            }
+        }
+        if (to_be_deleted) {
+            itr = traces.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+}
+
 template<typename WorldState, typename VM>
-boost::asio::awaitable<TraceFilterResult> TraceCallExecutor<WorldState, VM>::trace_filter(const TraceFilter& trace_filter) {
+boost::asio::awaitable<TraceFilterResult> TraceCallExecutor<WorldState, VM>::trace_filter(const TraceFilter& trace_filter, ethdb::Database* database) {
     SILKRPC_INFO << "TraceCallExecutor::trace_filter: filter " << trace_filter << "\n";
 
     const auto from_block_with_hash = co_await core::read_block_by_number_or_hash(block_cache_, database_reader_, trace_filter.from_block);
     const auto to_block_with_hash = co_await core::read_block_by_number_or_hash(block_cache_, database_reader_, trace_filter.to_block);
 
     TraceFilterResult result;
-    if (from_block_with_hash.block.header.number > to_block_with_hash.block.header.number) {
+    const auto from_block_number = from_block_with_hash->block.header.number;
+    const auto to_block_number = to_block_with_hash->block.header.number;
+    if (from_block_number > to_block_number) {
         result.pre_check_error = "invalid parameters: fromBlock cannot be greater than toBlock";
         co_return result;
     }
@@ -1345,74 +1713,92 @@ boost::asio::awaitable<TraceFilterResult> TraceCallExecutor<WorldState, VM>::tra
     std::set<evmc::address> to_addresses;
     to_addresses.insert(trace_filter.to_addresses.begin(), trace_filter.to_addresses.end());
 
+    const bool filter_by_address{!from_addresses.empty() || !to_addresses.empty()};
+
+    // Preselect using the call indexes just the blocks where any filtered address is sender or recipient of some call
+    std::vector<uint32_t> matching_block_numbers;
+    if (filter_by_address) {
+        auto matching_blocks = co_await get_call_blocks(database_reader_, db::table::kCallFromIndex, from_addresses, from_block_number, to_block_number);
+        matching_blocks |= co_await get_call_blocks(database_reader_, db::table::kCallToIndex, to_addresses, from_block_number, to_block_number);
+        matching_block_numbers.resize(matching_blocks.cardinality());
+        matching_blocks.toUint32Array(matching_block_numbers.data());
+        SILKRPC_DEBUG << "TraceCallExecutor::trace_filter: " << matching_block_numbers.size() << " matching blocks\n";
+    }
+    const uint64_t num_blocks = filter_by_address ? matching_block_numbers.size() : to_block_number - from_block_number + 1;
+    const auto block_number_at = [&](uint64_t i) -> uint64_t {
+        return filter_by_address ? matching_block_numbers[i] : from_block_number + i;
+    };
+
+    // Trace the blocks one window at a time, each window concurrently if the database allows to open one transaction per block
+    const auto trace_block_number = [&](TraceCallExecutor& executor, const core::rawdb::DatabaseReader& database_reader,
+        uint64_t block_number) -> boost::asio::awaitable<std::vector<Trace>> {
+        std::shared_ptr<silkworm::BlockWithHash> block_with_hash;
+        if (block_number == from_block_number) {
+            block_with_hash = from_block_with_hash;
+        } else if (block_number == to_block_number) {
+            block_with_hash = to_block_with_hash;
+        } else {
+            block_with_hash = co_await core::read_block_by_number(block_cache_, database_reader, block_number);
+        }
+        SILKRPC_INFO << "TraceCallExecutor::trace_filter: processing block_number: " << block_number << "\n";
+        co_return co_await executor.trace_block(*block_with_hash);
+    };
+
     auto after = trace_filter.after;
     auto count = trace_filter.count;
 
-    auto block_number = from_block_with_hash.block.header.number;
-    auto block_with_hash = from_block_with_hash;
-    while (block_number++ <= to_block_with_hash.block.header.number) {
-        const Block block{block_with_hash, {}, false};
-        SILKRPC_INFO << "TraceCallExecutor::trace_filter: processing "
-            << " block_number: " << block_number-1
-            << " block: " << block
-            << "\n";
-
-        std::vector<Trace> traces = co_await trace_block(block_with_hash);
-        if (!from_addresses.empty() || !to_addresses.empty()) {
-            std::vector<Trace>::iterator itr = traces.begin();
-            while (itr != traces.end()) {
-                const auto& trace = *itr;
-                bool to_be_deleted = true;
-                if (std::holds_alternative<TraceAction>(trace.action)) {
-                    const auto& action = std::get<TraceAction>(trace.action);
-                    if (!from_addresses.empty()) {
-                        if (from_addresses.find(action.from) != from_addresses.end()) {
-                            to_be_deleted = false;
-                        }
-                    }
-                    if (!to_addresses.empty() && action.to) {
-                        if (to_addresses.find(action.to.value()) != to_addresses.end()) {
-                            to_be_deleted = false;
-                        }
-                    }
+    for (uint64_t window_begin{0}; window_begin < num_blocks && count > 0; window_begin += kTraceFilterBlocksPerWindow) {
+        const auto window_size = std::min<uint64_t>(kTraceFilterBlocksPerWindow, num_blocks - window_begin);
+        std::vector<std::vector<Trace>> window_traces(window_size);
+        if (database == nullptr || window_size == 1) {
+            for (uint64_t i{0}; i < window_size; ++i) {
+                window_traces[i] = co_await trace_block_number(*this, database_reader_, block_number_at(window_begin + i));
+            }
+        } else {
+            const auto executor = co_await boost::asio::this_coro::executor;
+            co_await parallel_for(executor, window_size, kTraceFilterMaxConcurrentBlocks, [&](std::size_t i) -> boost::asio::awaitable<void> {
+                auto block_tx = co_await database->begin();
+                std::exception_ptr block_exception;
+                try {
+                    ethdb::TransactionDatabase block_database{*block_tx};
+                    TraceCallExecutor block_executor{io_context_, block_cache_, block_database, workers_, trace_store_};
+                    window_traces[i] = co_await trace_block_number(block_executor, block_database, block_number_at(window_begin + i));
+                } catch (...) {
+                    block_exception = std::current_exception();
                 }
-                if (to_be_deleted) {
-                    itr = traces.erase(itr);
-                } else {
-                    ++itr;
+                co_await block_tx->close(); // RAII not (yet) available with coroutines
+                if (block_exception) {
+                    std::rethrow_exception(block_exception);
                 }
-            }
-
-            SILKRPC_DEBUG << "TraceCallExecutor::trace_filter: remaining " << traces.size() << " entries for "
-                << " block_number: " << block_number-1
-                << " after processing\n";
+            });
         }
 
-        auto begin = traces.begin();
-        if (after < traces.size()) {
-            begin += after;
-            after = 0;
-        } else {
-            begin = traces.end();
-            after -= traces.size();
-        }
-        auto end   = traces.end();
-        if (end - begin > count) {
-            end = begin + count;
-            count = 0;
-        } else {
-            count -= end - begin;
-        }
-        result.traces.insert(result.traces.end(), begin, end);
+        for (auto& traces : window_traces) {
+            if (filter_by_address) {
+                filter_traces(traces, from_addresses, to_addresses);
+                SILKRPC_DEBUG << "TraceCallExecutor::trace_filter: remaining " << traces.size() << " entries after processing\n";
+            }
 
-        if (count == 0) {
-            break;
-        }
+            auto begin = traces.begin();
+            if (after < traces.size()) {
+                begin += after;
+                after = 0;
+            } else {
+                begin = traces.end();
+                after -= traces.size();
+            }
+            auto end   = traces.end();
+            if (end - begin > count) {
+                end = begin + count;
+                count = 0;
+            } else {
+                count -= end - begin;
+            }
+            result.traces.insert(result.traces.end(), begin, end);
 
-        if (block_number == to_block_with_hash.block.header.number) {
-            block_with_hash = to_block_with_hash;
-        } else {
-            block_with_hash = co_await core::read_block_by_number(block_cache_, database_reader_, block_number);
+            if (count == 0) {
+                break;
+            }
         }
     }
 
@@ -1434,17 +1820,34 @@ boost::asio::awaitable<TraceCallResult> TraceCallExecutor<WorldState, VM>::execu
     const auto chain_id = co_await core::rawdb::read_chain_id(database_reader_);
     const auto chain_config_ptr = lookup_chain_config(chain_id);
 
+    // The state preceding the transaction is read just once, whether by the executor or by the tracers
     state::RemoteState remote_state{io_context_, database_reader_, block_number};
-    silkworm::IntraBlockState initial_ibs{remote_state};
+    state::OverlayState block_state{remote_state};
+    silkworm::IntraBlockState initial_ibs{block_state};
 
     Tracers tracers;
     StateAddresses state_addresses(initial_ibs);
     std::shared_ptr<silkworm::EvmTracer> tracer = std::make_shared<trace::IntraBlockStateTracer>(state_addresses);
     tracers.push_back(tracer);
 
-    state::RemoteState curr_remote_state{io_context_, database_reader_, block_number};
-    EVMExecutor<WorldState, VM> executor{io_context_, database_reader_, *chain_config_ptr, workers_, block_number, curr_remote_state};
-    for (auto idx = 0; idx < transaction.transaction_index; idx++) {
+    // The preceding transactions are executed from the nearest checkpoint of the block (if any) on a state in front of
+    // the one preceding the block, which is still the initial state seen by the tracers
+    const bool use_checkpoints = checkpoint_cache_ != nullptr && index > 0;
+    const auto block_hash = use_checkpoints ? block.header.hash() : evmc::bytes32{};
+    const auto checkpoint = use_checkpoints ? checkpoint_cache_->find(block_hash, static_cast<uint32_t>(index)) : nullptr;
+    std::optional<state::OverlayState> checkpoint_state;
+    if (use_checkpoints) {
+        checkpoint_state.emplace(block_state);
+    }
+    if (checkpoint) {
+        checkpoint_state->apply(*checkpoint);
+        state_addresses.apply(*checkpoint);
+    }
+    state::OverlayState& execution_state = checkpoint_state ? *checkpoint_state : block_state;
+    const std::int32_t first_index = checkpoint ? static_cast<std::int32_t>(checkpoint->transaction_count) : 0;
+
+    EVMExecutor<WorldState, VM> executor{io_context_, database_reader_, *chain_config_ptr, workers_, block_number, remote_state, execution_state};
+    for (auto idx = first_index; idx < transaction.transaction_index; idx++) {
         silkrpc::Transaction txn{block.transactions[idx]};
 
         if (!txn.from) {
@@ -1453,6 +1856,10 @@ boost::asio::awaitable<TraceCallResult> TraceCallExecutor<WorldState, VM>::execu
         const auto execution_result = co_await executor.call(block, txn, tracers, /*refund=*/true, /*gas_bailout=*/true);
         executor.reset();
     }
+    if (use_checkpoints && transaction.transaction_index > first_index) {
+        store_state_checkpoint(*checkpoint_cache_, block_hash, checkpoint, static_cast<uint32_t>(transaction.transaction_index),
+                               executor, *checkpoint_state, block.header.number);
+    }
 
     tracers.clear();
     TraceCallResult result;
@@ -1477,7 +1884,7 @@ boost::asio::awaitable<TraceCallResult> TraceCallExecutor<WorldState, VM>::execu
     if (execution_result.pre_check_error) {
         result.pre_check_error = execution_result.pre_check_error.value();
     } else {
-        traces.output = "0x" + silkworm::to_hex(execution_result.data);
+        traces.output = silkrpc::to_hex(execution_result.data, /*with_prefix=*/true);
     }
 
     co_return result;
@@ -22,12 +22,16 @@
 #include <limits>
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
 #include <stack>
 #include <string>
+#include <utility>
 #include <variant>
 #include <vector>
 
+#include <silkrpc/config.hpp>
+
 #include <boost/asio/awaitable.hpp>
 #include <boost/asio/thread_pool.hpp>
 #include <nlohmann/json.hpp>
@@ -39,8 +43,12 @@
 #include <silkworm/state/intra_block_state.hpp>
 
 #include <silkrpc/common/block_cache.hpp>
+#include <silkrpc/common/state_checkpoint_cache.hpp>
 #include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/core/overlay_state.hpp>
 #include <silkrpc/core/rawdb/accessors.hpp>
+#include <silkrpc/ethdb/database.hpp>
+#include <silkrpc/ethdb/file/trace_store.hpp>
 #include <silkrpc/types/block.hpp>
 #include <silkrpc/types/call.hpp>
 #include <silkrpc/types/transaction.hpp>
@@ -84,15 +92,17 @@ struct TraceStorage {
     std::string value;
 };
 
+//! The memory region written by one instruction, kept as raw bytes and hex-encoded only when serialized
 struct TraceMemory {
     std::uint64_t offset{0};
     std::uint64_t len{0};
-    std::string data;
+    silkworm::Bytes data;
 };
 
+//! The effects of one instruction, the pushed stack items kept as raw words and hex-encoded only when serialized
 struct TraceEx {
     std::optional<TraceMemory> memory;
-    std::vector<std::string> stack;
+    std::vector<intx::uint256> stack;
     std::optional<TraceStorage> storage;
     std::uint64_t used{0};
 };
@@ -123,7 +133,7 @@ void to_json(nlohmann::json& json, const TraceEx& trace_ex);
 void to_json(nlohmann::json& json, const TraceMemory& trace_memory);
 void to_json(nlohmann::json& json, const TraceStorage& trace_storage);
 
-void copy_stack(std::uint8_t op_code, const evmone::uint256* stack, std::vector<std::string>& trace_stack);
+void copy_stack(std::uint8_t op_code, const evmone::uint256* stack, std::vector<intx::uint256>& trace_stack);
 void copy_memory(const evmone::Memory& memory, std::optional<TraceMemory>& trace_memory);
 void copy_store(std::uint8_t op_code, const evmone::uint256* stack, std::optional<TraceStorage>& trace_storage);
 void copy_memory_offset_len(std::uint8_t op_code, const evmone::uint256* stack, std::optional<TraceMemory>& trace_memory);
@@ -197,6 +207,12 @@ void to_json(nlohmann::json& json, const RewardAction& action);
 void to_json(nlohmann::json& json, const TraceResult& trace_result);
 void to_json(nlohmann::json& json, const Trace& trace);
 
+//! Encode the traces in the compact binary format kept by the trace store
+silkworm::Bytes encode_traces(const std::vector<Trace>& traces);
+
+//! Decode the traces encoded by encode_traces, returning nothing if the bytes are truncated or malformed
+std::optional<std::vector<Trace>> decode_traces(silkworm::ByteView bytes);
+
 template<typename T, typename Container = std::deque<T>>
 class iterable_stack: public std::stack<T, Container> {
     using std::stack<T, Container>::c;
@@ -265,7 +281,9 @@ public:
     StateAddresses(const StateAddresses&) = delete;
     StateAddresses& operator=(const StateAddresses&) = delete;
 
-    bool exists(const evmc::address& address) const noexcept {return initial_ibs_.exists(address);}
+    //! Whether the account exists before the current call, i.e. after the previous ones (if any) or initially
+    bool exists(const evmc::address& address) const noexcept;
+    void set_exists(const evmc::address& address, bool exists) noexcept {exists_[address] = exists;}
 
     intx::uint256 get_balance(const evmc::address& address) const noexcept;
     void set_balance(const evmc::address& address, const intx::uint256& value) noexcept {balances_[address] = value;}
@@ -279,7 +297,11 @@ public:
     void set_code(const evmc::address& address, silkworm::ByteView code) noexcept {codes_[address] = silkworm::Bytes{code};}
     bool code_exists(const evmc::address& address) const noexcept {return codes_.find(address) != codes_.end();}
 
+    //! Track the accounts changed by the transactions preceding the checkpoint, as if they had been executed
+    void apply(const StateCheckpoint& checkpoint) noexcept;
+
 private:
+    std::map<evmc::address, bool> exists_;
     std::map<evmc::address, intx::uint256> balances_;
     std::map<evmc::address, uint64_t> nonces_;
     std::map<evmc::address, silkworm::Bytes> codes_;
@@ -308,8 +330,8 @@ public:
 private:
     StateDiff& state_diff_;
     StateAddresses& state_addresses_;
-    std::map<evmc::address, std::set<std::string>> diff_storage_;
-    std::map<evmc::address, silkworm::ByteView> code_;
+    //! The storage locations written by the call, kept raw and hex-encoded just when some value has changed
+    std::map<evmc::address, std::set<evmc::bytes32>> diff_storage_;
     const char* const* opcode_names_ = nullptr;
 };
 
@@ -360,19 +382,37 @@ private:
     StateAddresses& state_addresses_;
 };
 
+//! Store the checkpoint of the block after the specified number of transactions, made of the base checkpoint (if any)
+//! plus the state written by the executor on the checkpoint state, i.e. the one it executes on in front of the base one
+template<typename Executor>
+void store_state_checkpoint(StateCheckpointCache& checkpoint_cache, const evmc::bytes32& block_hash,
+        const std::shared_ptr<const StateCheckpoint>& base, uint32_t transaction_count, Executor& executor,
+        state::OverlayState& checkpoint_state, uint64_t block_number) {
+    auto checkpoint = base ? std::make_shared<StateCheckpoint>(*base) : std::make_shared<StateCheckpoint>();
+    checkpoint->transaction_count = transaction_count;
+    checkpoint_state.set_checkpoint_recorder(checkpoint.get());
+    executor.write_state(block_number);
+    checkpoint_state.set_checkpoint_recorder(nullptr);
+    checkpoint_cache.store(block_hash, std::move(checkpoint));
+}
+
 template<typename WorldState = silkworm::IntraBlockState, typename VM = silkworm::EVM>
 class TraceCallExecutor {
 public:
     explicit TraceCallExecutor(boost::asio::io_context& io_context,
         silkrpc::BlockCache& block_cache,
         const core::rawdb::DatabaseReader& database_reader,
-        boost::asio::thread_pool& workers)
-    : io_context_(io_context), block_cache_(block_cache), database_reader_(database_reader), workers_{workers} {}
+        boost::asio::thread_pool& workers,
+        ethdb::file::TraceStore* trace_store = nullptr,
+        StateCheckpointCache* checkpoint_cache = nullptr)
+    : io_context_(io_context), block_cache_(block_cache), database_reader_(database_reader), workers_{workers}, trace_store_{trace_store},
+      checkpoint_cache_{checkpoint_cache} {}
     virtual ~TraceCallExecutor() {}
 
     TraceCallExecutor(const TraceCallExecutor&) = delete;
     TraceCallExecutor& operator=(const TraceCallExecutor&) = delete;
 
+    //! Trace the block, reading the traces from the trace store if enabled and filling it on the first replay
     boost::asio::awaitable<std::vector<Trace>> trace_block(const silkworm::BlockWithHash& block_with_hash);
     boost::asio::awaitable<std::vector<TraceCallResult>> trace_block_transactions(const silkworm::Block& block, const TraceConfig& config);
     boost::asio::awaitable<TraceCallResult> trace_call(const silkworm::Block& block, const silkrpc::Call& call, const TraceConfig& config);
@@ -380,8 +420,11 @@ public:
     boost::asio::awaitable<TraceCallResult> trace_transaction(const silkworm::Block& block, const silkrpc::Transaction& transaction, const TraceConfig& config) {
         return execute(block.header.number-1, block, transaction, transaction.transaction_index, config);
     }
+    //! Trace the transaction, selecting its traces from the stored block traces if any or replaying it otherwise
     boost::asio::awaitable<std::vector<Trace>> trace_transaction(const silkworm::BlockWithHash& block, const silkrpc::Transaction& transaction);
-    boost::asio::awaitable<TraceFilterResult> trace_filter(const TraceFilter& trace_filter);
+    //! Trace the blocks touching the filtered addresses, preselected by the call indexes. When the database is given,
+    //! the blocks are traced concurrently, each one within its own transaction opened on it
+    boost::asio::awaitable<TraceFilterResult> trace_filter(const TraceFilter& trace_filter, ethdb::Database* database = nullptr);
 
 private:
     boost::asio::awaitable<TraceCallResult> execute(std::uint64_t block_number, const silkworm::Block& block,
@@ -391,6 +434,8 @@ private:
     silkrpc::BlockCache& block_cache_;
     const core::rawdb::DatabaseReader& database_reader_;
     boost::asio::thread_pool& workers_;
+    ethdb::file::TraceStore* trace_store_;
+    StateCheckpointCache* checkpoint_cache_;
 };
 } // namespace silkrpc::trace
 
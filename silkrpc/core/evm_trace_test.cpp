@@ -1922,6 +1922,96 @@ TEST_CASE("TraceCallExecutor::trace_calls") {
             }
         ])"_json);
     }
+
+    SECTION("callMany: account created by previous call") {
+        EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, silkworm::ByteView{kZeroKey}))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
+                co_return kZeroHeader;
+            }));
+        EXPECT_CALL(db_reader, get_one(db::table::kConfig, silkworm::ByteView{kConfigKey}))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
+                co_return kConfigValue;
+            }));
+        EXPECT_CALL(db_reader, get(db::table::kAccountHistory, silkworm::ByteView{kAccountHistoryKey1}))
+            .WillRepeatedly(InvokeWithoutArgs([]() -> boost::asio::awaitable<KeyValue> {
+                co_return KeyValue{kAccountHistoryKey1, kAccountHistoryValue1};
+            }));
+        EXPECT_CALL(db_reader, get_both_range(db::table::kPlainAccountChangeSet, silkworm::ByteView{kAccountChangeSetKey}, silkworm::ByteView{kAccountChangeSetSubkey}))
+            .WillRepeatedly(InvokeWithoutArgs([]() -> boost::asio::awaitable<std::optional<silkworm::Bytes>> {
+                co_return kAccountChangeSetValue;
+            }));
+        EXPECT_CALL(db_reader, get_both_range(db::table::kPlainAccountChangeSet, silkworm::ByteView{kAccountChangeSetKey1}, silkworm::ByteView{kAccountChangeSetSubkey1}))
+            .WillRepeatedly(InvokeWithoutArgs([]() -> boost::asio::awaitable<std::optional<silkworm::Bytes>> {
+                co_return kAccountChangeSetValue1;
+            }));
+        EXPECT_CALL(db_reader, get(db::table::kAccountHistory, silkworm::ByteView{kAccountHistoryKey2}))
+            .WillRepeatedly(InvokeWithoutArgs([]() -> boost::asio::awaitable<KeyValue> {
+                co_return KeyValue{kAccountHistoryKey2, kAccountHistoryValue2};
+            }));
+        EXPECT_CALL(db_reader, get(db::table::kAccountHistory, silkworm::ByteView{kAccountHistoryKey3}))
+            .WillRepeatedly(InvokeWithoutArgs([]() -> boost::asio::awaitable<KeyValue> {
+                co_return KeyValue{kAccountHistoryKey3, kAccountHistoryValue3};
+            }));
+        EXPECT_CALL(db_reader, get_one(db::table::kPlainState, silkworm::ByteView{kPlainStateKey2}))
+            .WillRepeatedly(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
+                co_return silkworm::Bytes{};
+            }));
+
+        const auto block_number = 5'405'095; // 0x5279A7
+        TraceCall create_call;
+        create_call.call.from = 0xe0a2Bd4258D2768837BAa26A28fE71Dc079f84c7_address;
+        create_call.call.gas = 118'936;
+        create_call.call.gas_price = 7;
+        create_call.call.data = *silkworm::from_hex("602a60005500");
+        create_call.trace_config = TraceConfig{false, false, true};
+
+        // The second call transfers some value to the contract created by the first one
+        TraceCall transfer_call;
+        transfer_call.call.from = 0xe0a2Bd4258D2768837BAa26A28fE71Dc079f84c7_address;
+        transfer_call.call.to = 0x52728289eba496b6080d57d0250a90663a07e556_address;
+        transfer_call.call.gas = 50'000;
+        transfer_call.call.gas_price = 7;
+        transfer_call.call.value = 1;
+        transfer_call.trace_config = TraceConfig{false, false, true};
+
+        std::vector<TraceCall> calls;
+        calls.push_back(create_call);
+        calls.push_back(transfer_call);
+
+        silkworm::Block block{};
+        block.header.number = block_number;
+
+        BlockCache block_cache;
+        TraceCallExecutor executor{context_pool.next_io_context(), block_cache, db_reader, workers};
+        boost::asio::io_context& io_context = context_pool.next_io_context();
+        auto execution_result = boost::asio::co_spawn(io_context.get_executor(), executor.trace_calls(block, calls), boost::asio::use_future);
+        auto result = execution_result.get();
+
+        context_pool.stop();
+        context_pool.join();
+
+        CHECK(result.pre_check_error.has_value() == false);
+        REQUIRE(result.traces.size() == 2);
+        const nlohmann::json create_traces = result.traces[0];
+        const nlohmann::json transfer_traces = result.traces[1];
+
+        // The contract is born in the first call...
+        CHECK(create_traces["stateDiff"]["0x52728289eba496b6080d57d0250a90663a07e556"]["balance"] == R"({"+": "0x0"})"_json);
+        CHECK(create_traces["stateDiff"]["0x52728289eba496b6080d57d0250a90663a07e556"]["nonce"] == R"({"+": "0x1"})"_json);
+
+        // ...so that in the second one it already exists, with just its balance changed
+        CHECK(transfer_traces["stateDiff"]["0x52728289eba496b6080d57d0250a90663a07e556"] == R"({
+            "balance": {
+                "*": {
+                    "from": "0x0",
+                    "to": "0x1"
+                }
+            },
+            "code": "=",
+            "nonce": "=",
+            "storage": {}
+        })"_json);
+    }
 }
 
 TEST_CASE("TraceCallExecutor::trace_block_transactions") {
@@ -4040,6 +4130,18 @@ TEST_CASE("TraceCallExecutor::trace_filter") {
             co_return;
         }));
 
+    // TransactionDatabase::get_one: TABLE Senders
+    EXPECT_CALL(db_reader, get_one(db::table::kSenders, silkworm::ByteView{kBlockBodyKey1}))
+        .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
+            co_return silkworm::Bytes{};
+        }));
+
+    // TransactionDatabase::get_one: TABLE Senders
+    EXPECT_CALL(db_reader, get_one(db::table::kSenders, silkworm::ByteView{kBlockBodyKey3}))
+        .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
+            co_return silkworm::Bytes{};
+        }));
+
     EXPECT_CALL(db_reader, get_one(db::table::kConfig, silkworm::ByteView{kConfigKey}))
         .WillRepeatedly(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
             co_return kConfigValue;
@@ -5468,42 +5570,6 @@ TEST_CASE("TraceCallExecutor::trace_filter") {
           "toBlock": "0x6DDD03"
         })"_json;
 
-        // TransactionDatabase::get_one: TABLE CanonicalHeader
-        static silkworm::Bytes kCanonicalHeaderKey3{*silkworm::from_hex("00000000006ddd04")};
-        static silkworm::Bytes kCanonicalHeaderValue3{*silkworm::from_hex("1b9ac5d63ba5c6a7e0c40a339499eef9b8b45fa247e701516f35a2357ccdaf1e")};
-        EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, silkworm::ByteView{kCanonicalHeaderKey3}))
-            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
-                co_return kCanonicalHeaderValue3;
-            }));
-
-        // TransactionDatabase::get: TABLE Header
-        static silkworm::Bytes kHeaderKey2{*silkworm::from_hex("00000000006ddd041b9ac5d63ba5c6a7e0c40a339499eef9b8b45fa247e701516f35a2357ccdaf1e")};
-        static silkworm::Bytes kHeaderValue2{*silkworm::from_hex(
-            "f9025ba0a316f156582fb5fba2166910becdb6342965a801fa473e18cd6a0c06143cac1aa01dcc4de8dec75d7aab85b567b6ccd41ad312"
-            "451b948a7413f0a142fd40d49347940000000000000000000000000000000000000000a000636fe848d9d0dd8d3fe77deef0286329b01f"
-            "4e971501d1dc481365deea77bfa056e81f171bcc55a6ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421a056e81f171bcc55a6"
-            "ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421b9010000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "000000000000000001836ddd048401c9c380808462ca3c74b8614e65746865726d696e6420312e31332e332d302d306533323839663535"
-            "2d3230a499270541450663356185c61f970959545219dee7616763658a87d3c80730c32cca058d57ccc16cc0b0ca4269c4dee474ee3612"
-            "f83cbf54f9fbffddba6d154401a00000000000000000000000000000000000000000000000000000000000000000880000000000000000"
-            "07")};
-        EXPECT_CALL(db_reader, get_one(db::table::kHeaders, silkworm::ByteView{kHeaderKey2}))
-            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
-                co_return kHeaderValue2;
-            }));
-
-        // TransactionDatabase::get: TABLE BlockBody
-        static silkworm::Bytes kBlockBodyKey2{*silkworm::from_hex("00000000006ddd041b9ac5d63ba5c6a7e0c40a339499eef9b8b45fa247e701516f35a2357ccdaf1e")};
-        static silkworm::Bytes kBlockBodyValue2{*silkworm::from_hex("c78405c62e6f02c0")};
-        EXPECT_CALL(db_reader, get_one(db::table::kBlockBodies, silkworm::ByteView{kBlockBodyKey2}))
-            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
-                co_return kBlockBodyValue2;
-            }));
-
         BlockCache block_cache;
         TraceCallExecutor executor{context_pool.next_io_context(), block_cache, db_reader, workers};
         boost::asio::io_context& io_context = context_pool.next_io_context();
@@ -5552,41 +5618,10 @@ TEST_CASE("TraceCallExecutor::trace_filter") {
           "fromAddress": ["0x2031832e54a2200bf678286f560f49a950db2ad5"]
         })"_json;
 
-        // TransactionDatabase::get_one: TABLE CanonicalHeader
-        static silkworm::Bytes kCanonicalHeaderKey3{*silkworm::from_hex("00000000006ddd04")};
-        static silkworm::Bytes kCanonicalHeaderValue3{*silkworm::from_hex("1b9ac5d63ba5c6a7e0c40a339499eef9b8b45fa247e701516f35a2357ccdaf1e")};
-        EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, silkworm::ByteView{kCanonicalHeaderKey3}))
-            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
-                co_return kCanonicalHeaderValue3;
-            }));
-
-        // TransactionDatabase::get: TABLE Header
-        static silkworm::Bytes kHeaderKey2{*silkworm::from_hex("00000000006ddd041b9ac5d63ba5c6a7e0c40a339499eef9b8b45fa247e701516f35a2357ccdaf1e")};
-        static silkworm::Bytes kHeaderValue2{*silkworm::from_hex(
-            "f9025ba0a316f156582fb5fba2166910becdb6342965a801fa473e18cd6a0c06143cac1aa01dcc4de8dec75d7aab85b567b6ccd41ad312"
-            "451b948a7413f0a142fd40d49347940000000000000000000000000000000000000000a000636fe848d9d0dd8d3fe77deef0286329b01f"
-            "4e971501d1dc481365deea77bfa056e81f171bcc55a6ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421a056e81f171bcc55a6"
-            "ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421b9010000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "000000000000000001836ddd048401c9c380808462ca3c74b8614e65746865726d696e6420312e31332e332d302d306533323839663535"
-            "2d3230a499270541450663356185c61f970959545219dee7616763658a87d3c80730c32cca058d57ccc16cc0b0ca4269c4dee474ee3612"
-            "f83cbf54f9fbffddba6d154401a00000000000000000000000000000000000000000000000000000000000000000880000000000000000"
-            "07")};
-        EXPECT_CALL(db_reader, get_one(db::table::kHeaders, silkworm::ByteView{kHeaderKey2}))
-            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
-                co_return kHeaderValue2;
-            }));
-
-        // TransactionDatabase::get: TABLE BlockBody
-        static silkworm::Bytes kBlockBodyKey2{*silkworm::from_hex("00000000006ddd041b9ac5d63ba5c6a7e0c40a339499eef9b8b45fa247e701516f35a2357ccdaf1e")};
-        static silkworm::Bytes kBlockBodyValue2{*silkworm::from_hex("c78405c62e6f02c0")};
-        EXPECT_CALL(db_reader, get_one(db::table::kBlockBodies, silkworm::ByteView{kBlockBodyKey2}))
-            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
-                co_return kBlockBodyValue2;
-            }));
+        // No block has any call from the address, so nothing is traced
+        EXPECT_CALL(db_reader, walk(db::table::kCallFromIndex, _, _, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<void> { co_return; }
+        ));
 
         BlockCache block_cache;
         TraceCallExecutor executor{context_pool.next_io_context(), block_cache, db_reader, workers};
@@ -5607,44 +5642,13 @@ TEST_CASE("TraceCallExecutor::trace_filter") {
         TraceFilter trace_filter = R"({
           "fromBlock": "0x6DDD02",
           "toBlock": "0x6DDD03",
-          "fromAddress": ["0x2031832e54a2200bf678286f560f49a950db2ad5"]
+          "toAddress": ["0x2031832e54a2200bf678286f560f49a950db2ad5"]
         })"_json;
 
-        // TransactionDatabase::get_one: TABLE CanonicalHeader
-        static silkworm::Bytes kCanonicalHeaderKey3{*silkworm::from_hex("00000000006ddd04")};
-        static silkworm::Bytes kCanonicalHeaderValue3{*silkworm::from_hex("1b9ac5d63ba5c6a7e0c40a339499eef9b8b45fa247e701516f35a2357ccdaf1e")};
-        EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, silkworm::ByteView{kCanonicalHeaderKey3}))
-            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
-                co_return kCanonicalHeaderValue3;
-            }));
-
-        // TransactionDatabase::get: TABLE Header
-        static silkworm::Bytes kHeaderKey2{*silkworm::from_hex("00000000006ddd041b9ac5d63ba5c6a7e0c40a339499eef9b8b45fa247e701516f35a2357ccdaf1e")};
-        static silkworm::Bytes kHeaderValue2{*silkworm::from_hex(
-            "f9025ba0a316f156582fb5fba2166910becdb6342965a801fa473e18cd6a0c06143cac1aa01dcc4de8dec75d7aab85b567b6ccd41ad312"
-            "451b948a7413f0a142fd40d49347940000000000000000000000000000000000000000a000636fe848d9d0dd8d3fe77deef0286329b01f"
-            "4e971501d1dc481365deea77bfa056e81f171bcc55a6ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421a056e81f171bcc55a6"
-            "ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421b9010000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "000000000000000001836ddd048401c9c380808462ca3c74b8614e65746865726d696e6420312e31332e332d302d306533323839663535"
-            "2d3230a499270541450663356185c61f970959545219dee7616763658a87d3c80730c32cca058d57ccc16cc0b0ca4269c4dee474ee3612"
-            "f83cbf54f9fbffddba6d154401a00000000000000000000000000000000000000000000000000000000000000000880000000000000000"
-            "07")};
-        EXPECT_CALL(db_reader, get_one(db::table::kHeaders, silkworm::ByteView{kHeaderKey2}))
-            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
-                co_return kHeaderValue2;
-            }));
-
-        // TransactionDatabase::get: TABLE BlockBody
-        static silkworm::Bytes kBlockBodyKey2{*silkworm::from_hex("00000000006ddd041b9ac5d63ba5c6a7e0c40a339499eef9b8b45fa247e701516f35a2357ccdaf1e")};
-        static silkworm::Bytes kBlockBodyValue2{*silkworm::from_hex("c78405c62e6f02c0")};
-        EXPECT_CALL(db_reader, get_one(db::table::kBlockBodies, silkworm::ByteView{kBlockBodyKey2}))
-            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
-                co_return kBlockBodyValue2;
-            }));
+        // No block has any call to the address, so nothing is traced
+        EXPECT_CALL(db_reader, walk(db::table::kCallToIndex, _, _, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<void> { co_return; }
+        ));
 
         BlockCache block_cache;
         TraceCallExecutor executor{context_pool.next_io_context(), block_cache, db_reader, workers};
@@ -5725,42 +5729,6 @@ TEST_CASE("TraceCallExecutor::trace_filter") {
           "after": 0
         })"_json;
 
-        // TransactionDatabase::get_one: TABLE CanonicalHeader
-        static silkworm::Bytes kCanonicalHeaderKey3{*silkworm::from_hex("00000000006ddd04")};
-        static silkworm::Bytes kCanonicalHeaderValue3{*silkworm::from_hex("1b9ac5d63ba5c6a7e0c40a339499eef9b8b45fa247e701516f35a2357ccdaf1e")};
-        EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, silkworm::ByteView{kCanonicalHeaderKey3}))
-            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
-                co_return kCanonicalHeaderValue3;
-            }));
-
-        // TransactionDatabase::get: TABLE Header
-        static silkworm::Bytes kHeaderKey2{*silkworm::from_hex("00000000006ddd041b9ac5d63ba5c6a7e0c40a339499eef9b8b45fa247e701516f35a2357ccdaf1e")};
-        static silkworm::Bytes kHeaderValue2{*silkworm::from_hex(
-            "f9025ba0a316f156582fb5fba2166910becdb6342965a801fa473e18cd6a0c06143cac1aa01dcc4de8dec75d7aab85b567b6ccd41ad312"
-            "451b948a7413f0a142fd40d49347940000000000000000000000000000000000000000a000636fe848d9d0dd8d3fe77deef0286329b01f"
-            "4e971501d1dc481365deea77bfa056e81f171bcc55a6ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421a056e81f171bcc55a6"
-            "ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421b9010000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "000000000000000001836ddd048401c9c380808462ca3c74b8614e65746865726d696e6420312e31332e332d302d306533323839663535"
-            "2d3230a499270541450663356185c61f970959545219dee7616763658a87d3c80730c32cca058d57ccc16cc0b0ca4269c4dee474ee3612"
-            "f83cbf54f9fbffddba6d154401a00000000000000000000000000000000000000000000000000000000000000000880000000000000000"
-            "07")};
-        EXPECT_CALL(db_reader, get_one(db::table::kHeaders, silkworm::ByteView{kHeaderKey2}))
-            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
-                co_return kHeaderValue2;
-            }));
-
-        // TransactionDatabase::get: TABLE BlockBody
-        static silkworm::Bytes kBlockBodyKey2{*silkworm::from_hex("00000000006ddd041b9ac5d63ba5c6a7e0c40a339499eef9b8b45fa247e701516f35a2357ccdaf1e")};
-        static silkworm::Bytes kBlockBodyValue2{*silkworm::from_hex("c78405c62e6f02c0")};
-        EXPECT_CALL(db_reader, get_one(db::table::kBlockBodies, silkworm::ByteView{kBlockBodyKey2}))
-            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
-                co_return kBlockBodyValue2;
-            }));
-
         BlockCache block_cache;
         TraceCallExecutor executor{context_pool.next_io_context(), block_cache, db_reader, workers};
         boost::asio::io_context& io_context = context_pool.next_io_context();
@@ -5809,42 +5777,6 @@ TEST_CASE("TraceCallExecutor::trace_filter") {
           "after": 1
         })"_json;
 
-        // TransactionDatabase::get_one: TABLE CanonicalHeader
-        static silkworm::Bytes kCanonicalHeaderKey3{*silkworm::from_hex("00000000006ddd04")};
-        static silkworm::Bytes kCanonicalHeaderValue3{*silkworm::from_hex("1b9ac5d63ba5c6a7e0c40a339499eef9b8b45fa247e701516f35a2357ccdaf1e")};
-        EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, silkworm::ByteView{kCanonicalHeaderKey3}))
-            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
-                co_return kCanonicalHeaderValue3;
-            }));
-
-        // TransactionDatabase::get: TABLE Header
-        static silkworm::Bytes kHeaderKey2{*silkworm::from_hex("00000000006ddd041b9ac5d63ba5c6a7e0c40a339499eef9b8b45fa247e701516f35a2357ccdaf1e")};
-        static silkworm::Bytes kHeaderValue2{*silkworm::from_hex(
-            "f9025ba0a316f156582fb5fba2166910becdb6342965a801fa473e18cd6a0c06143cac1aa01dcc4de8dec75d7aab85b567b6ccd41ad312"
-            "451b948a7413f0a142fd40d49347940000000000000000000000000000000000000000a000636fe848d9d0dd8d3fe77deef0286329b01f"
-            "4e971501d1dc481365deea77bfa056e81f171bcc55a6ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421a056e81f171bcc55a6"
-            "ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421b9010000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
-            "000000000000000001836ddd048401c9c380808462ca3c74b8614e65746865726d696e6420312e31332e332d302d306533323839663535"
-            "2d3230a499270541450663356185c61f970959545219dee7616763658a87d3c80730c32cca058d57ccc16cc0b0ca4269c4dee474ee3612"
-            "f83cbf54f9fbffddba6d154401a00000000000000000000000000000000000000000000000000000000000000000880000000000000000"
-            "07")};
-        EXPECT_CALL(db_reader, get_one(db::table::kHeaders, silkworm::ByteView{kHeaderKey2}))
-            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
-                co_return kHeaderValue2;
-            }));
-
-        // TransactionDatabase::get: TABLE BlockBody
-        static silkworm::Bytes kBlockBodyKey2{*silkworm::from_hex("00000000006ddd041b9ac5d63ba5c6a7e0c40a339499eef9b8b45fa247e701516f35a2357ccdaf1e")};
-        static silkworm::Bytes kBlockBodyValue2{*silkworm::from_hex("c78405c62e6f02c0")};
-        EXPECT_CALL(db_reader, get_one(db::table::kBlockBodies, silkworm::ByteView{kBlockBodyKey2}))
-            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
-                co_return kBlockBodyValue2;
-            }));
-
         BlockCache block_cache;
         TraceCallExecutor executor{context_pool.next_io_context(), block_cache, db_reader, workers};
         boost::asio::io_context& io_context = context_pool.next_io_context();
@@ -5880,8 +5812,8 @@ TEST_CASE("VmTrace json serialization") {
 
     TraceEx trace_ex;
     trace_ex.used = 5000;
-    trace_ex.stack.push_back("0xdeadbeaf");
-    trace_ex.memory = TraceMemory{10, 0, "data"};
+    trace_ex.stack.push_back(0xdeadbeaf);
+    trace_ex.memory = TraceMemory{10, 0, *silkworm::from_hex("0xdeadbeaf")};
     trace_ex.storage = TraceStorage{"key", "value"};
 
     TraceOp trace_op;
@@ -5903,7 +5835,7 @@ TEST_CASE("VmTrace json serialization") {
                     "cost":42,
                     "ex":{
                         "mem":{
-                            "data":"data",
+                            "data":"0xdeadbeaf",
                             "off":10
                         },
                         "push":["0xdeadbeaf"],
@@ -5926,7 +5858,7 @@ TEST_CASE("VmTrace json serialization") {
             "cost":42,
             "ex":{
                 "mem":{
-                    "data":"data",
+                    "data":"0xdeadbeaf",
                     "off":10
                 },
                 "push":["0xdeadbeaf"],
@@ -5945,7 +5877,7 @@ TEST_CASE("VmTrace json serialization") {
     SECTION("TraceEx") {
         CHECK(trace_ex == R"({
             "mem":{
-                "data":"data",
+                "data":"0xdeadbeaf",
                 "off":10
             },
             "push":["0xdeadbeaf"],
@@ -5959,7 +5891,7 @@ TEST_CASE("VmTrace json serialization") {
     SECTION("TraceMemory") {
         const auto& memory = trace_ex.memory.value();
         CHECK(memory == R"({
-            "data":"data",
+            "data":"0xdeadbeaf",
             "off":10
         })"_json);
     }
@@ -6124,6 +6056,63 @@ TEST_CASE("Trace json serialization") {
     }
 }
 
+TEST_CASE("Trace encoding for the trace store") {
+    SILKRPC_LOG_STREAMS(null_stream(), null_stream());
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+
+    TraceAction trace_action;
+    trace_action.call_type = "call";
+    trace_action.from = 0xe0a2Bd4258D2768837BAa26A28fE71Dc079f84c7_address;
+    trace_action.to = 0x5e1f0c9ddbe3cb57b80c933fab5151627d7966fa_address;
+    trace_action.gas = 1000;
+    trace_action.input = *silkworm::from_hex("0x602a60005500");
+    trace_action.value = intx::uint256{0xdeadbeaf};
+
+    Trace call_trace;
+    call_trace.action = trace_action;
+    call_trace.trace_result = TraceResult{std::nullopt, std::nullopt, *silkworm::from_hex("0x1234"), 500};
+    call_trace.sub_traces = 1;
+    call_trace.trace_address = {0, 2};
+    call_trace.type = "call";
+    call_trace.block_hash = 0x527198f474c1f1f1d01129d3a17ecc17895d85884a31b05ef0ecd480faee1592_bytes32;
+    call_trace.block_number = 1'024'165;
+    call_trace.transaction_hash = 0xbf3c7cbfbbcc40aa1a2fd9b0c2d3e8f6e6a8c3c3f716c70b7342b6f5b1e403e4_bytes32;
+    call_trace.transaction_position = 3;
+
+    RewardAction reward_action;
+    reward_action.author = 0xe0a2Bd4258D2768837BAa26A28fE71Dc079f84d8_address;
+    reward_action.reward_type = "block";
+    reward_action.value = intx::uint256{0xdeadbeaf};
+
+    Trace reward_trace;
+    reward_trace.action = reward_action;
+    reward_trace.error = "error";
+    reward_trace.type = "reward";
+
+    const std::vector<Trace> traces{call_trace, reward_trace};
+    const auto encoded_traces = encode_traces(traces);
+
+    SECTION("round trip") {
+        const auto decoded_traces = decode_traces(encoded_traces);
+        REQUIRE(decoded_traces);
+        CHECK(nlohmann::json(*decoded_traces) == nlohmann::json(traces));
+        const auto no_traces = decode_traces(encode_traces({}));
+        CHECK((no_traces && no_traces->empty()));
+    }
+
+    SECTION("truncated bytes") {
+        for (std::size_t size{0}; size < encoded_traces.size(); ++size) {
+            CHECK(!decode_traces(silkworm::ByteView{encoded_traces.data(), size}));
+        }
+    }
+
+    SECTION("trailing bytes") {
+        auto longer_traces = encoded_traces;
+        longer_traces.push_back(0);
+        CHECK(!decode_traces(longer_traces));
+    }
+}
+
 TEST_CASE("StateDiff json serialization") {
     SILKRPC_LOG_STREAMS(null_stream(), null_stream());
     SILKRPC_LOG_VERBOSITY(LogLevel::None);
@@ -6200,43 +6189,43 @@ TEST_CASE("copy_stack") {
 
     SECTION("PUSHX") {
         for (std::uint8_t op_code = evmc_opcode::OP_PUSH1; op_code < evmc_opcode::OP_PUSH32 + 1; op_code++) {
-            std::vector<std::string> trace_stack;
+            std::vector<intx::uint256> trace_stack;
             copy_stack(op_code, top_stack, trace_stack);
 
             CHECK(trace_stack.size() == 1);
-            CHECK(trace_stack[0] == "0x1f");
+            CHECK(trace_stack[0] == 0x1f);
         }
     }
 
     SECTION("OP_SWAPX") {
         for (std::uint8_t op_code = evmc_opcode::OP_SWAP1; op_code < evmc_opcode::OP_SWAP16 + 1; op_code++) {
-            std::vector<std::string> trace_stack;
+            std::vector<intx::uint256> trace_stack;
             copy_stack(op_code, top_stack, trace_stack);
 
             std::uint8_t size = op_code - evmc_opcode::OP_SWAP1 + 2;
             CHECK(trace_stack.size() == size);
             for (auto idx = 0; idx < size; idx++) {
-                CHECK(trace_stack[idx] == "0x" + intx::to_string(stack[stack_size-size+idx], 16));
+                CHECK(trace_stack[idx] == stack[stack_size-size+idx]);
             }
         }
     }
 
     SECTION("OP_DUPX") {
         for (std::uint8_t op_code = evmc_opcode::OP_DUP1; op_code < evmc_opcode::OP_DUP16 + 1; op_code++) {
-            std::vector<std::string> trace_stack;
+            std::vector<intx::uint256> trace_stack;
             copy_stack(op_code, top_stack, trace_stack);
 
             std::uint8_t size = op_code - evmc_opcode::OP_DUP1 + 2;
             CHECK(trace_stack.size() == size);
             for (auto idx = 0; idx < size; idx++) {
-                CHECK(trace_stack[idx] == "0x" + intx::to_string(stack[stack_size-size+idx], 16));
+                CHECK(trace_stack[idx] == stack[stack_size-size+idx]);
             }
         }
     }
 
     SECTION("OP_OTHER") {
         for (std::uint8_t op_code = evmc_opcode::OP_STOP; op_code < evmc_opcode::OP_SELFDESTRUCT; op_code++) {
-            std::vector<std::string> trace_stack;
+            std::vector<intx::uint256> trace_stack;
             switch (op_code) {
                 case evmc_opcode::OP_PUSH1:
                 case evmc_opcode::OP_PUSH2:
@@ -6364,7 +6353,7 @@ TEST_CASE("copy_stack") {
                     copy_stack(op_code, top_stack, trace_stack);
 
                     CHECK(trace_stack.size() == 1);
-                    CHECK(trace_stack[0] == "0x1f");
+                    CHECK(trace_stack[0] == 0x1f);
                     break;
                 default:
                     copy_stack(op_code, top_stack, trace_stack);
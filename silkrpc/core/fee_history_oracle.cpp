@@ -0,0 +1,167 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "fee_history_oracle.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <silkworm/chain/protocol_param.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/json/types.hpp>
+
+namespace silkrpc {
+
+void to_json(nlohmann::json& json, const FeeHistory& history) {
+    json["oldestBlock"] = to_quantity(history.oldest_block);
+    if (!history.base_fees.empty()) {
+        json["baseFeePerGas"] = nlohmann::json::array();
+        for (const auto& base_fee : history.base_fees) {
+            json["baseFeePerGas"].push_back(to_quantity(base_fee));
+        }
+        json["gasUsedRatio"] = history.gas_used_ratios;
+    }
+    if (!history.rewards.empty()) {
+        json["reward"] = nlohmann::json::array();
+        for (const auto& block_rewards : history.rewards) {
+            auto json_rewards = nlohmann::json::array();
+            for (const auto& reward : block_rewards) {
+                json_rewards.push_back(to_quantity(reward));
+            }
+            json["reward"].push_back(std::move(json_rewards));
+        }
+    }
+}
+
+boost::asio::awaitable<FeeHistory> FeeHistoryOracle::fee_history(uint64_t newest_block, uint64_t block_count,
+    const std::vector<double>& reward_percentiles) {
+    SILKRPC_DEBUG << "FeeHistoryOracle::fee_history newest_block: " << newest_block << " block_count: " << block_count << "\n";
+    for (std::size_t i{0}; i < reward_percentiles.size(); ++i) {
+        const auto percentile = reward_percentiles[i];
+        if (percentile < 0 || percentile > 100 || (i > 0 && percentile < reward_percentiles[i - 1])) {
+            throw std::invalid_argument{"invalid reward percentile: " + std::to_string(percentile)};
+        }
+    }
+
+    FeeHistory history;
+    block_count = std::min({block_count, kMaxFeeHistoryBlocks, newest_block + 1});
+    if (block_count == 0) {
+        co_return history;
+    }
+    history.oldest_block = newest_block + 1 - block_count;
+    history.base_fees.reserve(block_count + 1);
+    history.gas_used_ratios.reserve(block_count);
+    if (!reward_percentiles.empty()) {
+        history.rewards.reserve(block_count);
+    }
+
+    std::shared_ptr<const BlockFees> fees;
+    for (auto block_number = history.oldest_block; block_number <= newest_block; ++block_number) {
+        fees = co_await block_fees(block_number);
+        history.base_fees.push_back(fees->base_fee);
+        history.gas_used_ratios.push_back(fees->gas_used_ratio);
+        if (!reward_percentiles.empty()) {
+            std::vector<intx::uint256> block_rewards;
+            block_rewards.reserve(reward_percentiles.size());
+            for (const auto percentile : reward_percentiles) {
+                block_rewards.push_back(fees->reward_at(percentile));
+            }
+            history.rewards.push_back(std::move(block_rewards));
+        }
+    }
+    history.base_fees.push_back(fees->next_base_fee);
+
+    co_return history;
+}
+
+boost::asio::awaitable<std::shared_ptr<const BlockFees>> FeeHistoryOracle::block_fees(uint64_t block_number) {
+    const auto generation = cache_ ? cache_->generation() : 0;
+    if (cache_) {
+        if (auto cached_fees = cache_->find(block_number)) {
+            co_return cached_fees;
+        }
+    }
+
+    SILKRPC_TRACE << "FeeHistoryOracle::block_fees sampling block: " << block_number << "\n";
+    const auto block_with_hash = co_await block_provider_(block_number);
+    const auto receipts = co_await receipts_provider_(*block_with_hash);
+    auto fees = std::make_shared<const BlockFees>(sample_block_fees(config_, *block_with_hash, *receipts));
+    if (cache_) {
+        cache_->store(fees, generation);
+    }
+    co_return fees;
+}
+
+BlockFees FeeHistoryOracle::sample_block_fees(const silkworm::ChainConfig& config, const silkworm::BlockWithHash& block_with_hash,
+    const Receipts& receipts) {
+    const auto& block = block_with_hash.block;
+    BlockFees fees;
+    fees.block_number = block.header.number;
+    fees.base_fee = block.header.base_fee_per_gas.value_or(0);
+    fees.next_base_fee = next_base_fee(config, block.header);
+    fees.gas_used = block.header.gas_used;
+    if (block.header.gas_limit > 0) {
+        fees.gas_used_ratio = static_cast<double>(block.header.gas_used) / static_cast<double>(block.header.gas_limit);
+    }
+
+    // The rewards are weighted by the gas used, so they are left empty (i.e. zero) if the receipts are not available
+    if (receipts.size() != block.transactions.size()) {
+        return fees;
+    }
+    std::vector<std::pair<intx::uint256, uint64_t>> tx_rewards;
+    tx_rewards.reserve(block.transactions.size());
+    for (std::size_t i{0}; i < block.transactions.size(); ++i) {
+        tx_rewards.emplace_back(block.transactions[i].priority_fee_per_gas(fees.base_fee), receipts[i].gas_used);
+    }
+    std::sort(tx_rewards.begin(), tx_rewards.end(), [](const auto& r1, const auto& r2) { return r1.first < r2.first; });
+
+    uint64_t cumulative_gas_used{0};
+    for (const auto& [reward, gas_used] : tx_rewards) {
+        cumulative_gas_used += gas_used;
+        if (!fees.rewards.empty() && fees.rewards.back().first == reward) {
+            fees.rewards.back().second = cumulative_gas_used;
+        } else {
+            fees.rewards.emplace_back(reward, cumulative_gas_used);
+        }
+    }
+    return fees;
+}
+
+intx::uint256 FeeHistoryOracle::next_base_fee(const silkworm::ChainConfig& config, const silkworm::BlockHeader& header) {
+    if (config.revision(header.number + 1) < EVMC_LONDON) {
+        return 0;
+    }
+    if (!header.base_fee_per_gas) {
+        return silkworm::param::kInitialBaseFee;
+    }
+
+    const intx::uint256& base_fee = *header.base_fee_per_gas;
+    const uint64_t gas_target = header.gas_limit / silkworm::param::kElasticityMultiplier;
+    if (gas_target == 0 || header.gas_used == gas_target) {
+        return base_fee;
+    }
+    if (header.gas_used > gas_target) {
+        const intx::uint256 delta = base_fee * (header.gas_used - gas_target) / gas_target / silkworm::param::kBaseFeeMaxChangeDenominator;
+        return base_fee + std::max(delta, intx::uint256{1});
+    }
+    const intx::uint256 delta = base_fee * (gas_target - header.gas_used) / gas_target / silkworm::param::kBaseFeeMaxChangeDenominator;
+    return base_fee - delta;
+}
+
+} // namespace silkrpc
@@ -0,0 +1,89 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_CORE_FEE_HISTORY_ORACLE_HPP_
+#define SILKRPC_CORE_FEE_HISTORY_ORACLE_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <silkrpc/config.hpp> // NOLINT(build/include_order)
+
+#include <boost/asio/awaitable.hpp>
+#include <nlohmann/json.hpp>
+#include <silkworm/chain/config.hpp>
+#include <silkworm/types/block.hpp>
+
+#include <silkrpc/common/fee_history_cache.hpp>
+#include <silkrpc/core/gas_price_oracle.hpp>
+#include <silkrpc/types/receipt.hpp>
+
+namespace silkrpc {
+
+//! The max number of blocks in one fee history
+const std::uint64_t kMaxFeeHistoryBlocks = 1024;
+
+typedef std::function<boost::asio::awaitable<std::shared_ptr<const Receipts>>(const silkworm::BlockWithHash&)> ReceiptsProvider;
+
+//! The fee history of a range of blocks, as returned by eth_feeHistory
+struct FeeHistory {
+    uint64_t oldest_block{0};
+    //! The base fees of the blocks in the range plus the one of the block after the newest
+    std::vector<intx::uint256> base_fees;
+    std::vector<double> gas_used_ratios;
+    //! The rewards at the requested percentiles for each block, empty if no percentile has been requested
+    std::vector<std::vector<intx::uint256>> rewards;
+};
+
+void to_json(nlohmann::json& json, const FeeHistory& history);
+
+//! The fee statistics of the blocks are kept in the cache, if any: when the cache has been filled at each new head (see
+//! GasPriceUpdater), the fee history of the latest blocks is just a memory scan and the older ones are sampled lazily.
+class FeeHistoryOracle {
+public:
+    explicit FeeHistoryOracle(const silkworm::ChainConfig& config, const BlockProvider& block_provider,
+        const ReceiptsProvider& receipts_provider, FeeHistoryCache* cache = nullptr)
+        : config_(config), block_provider_(block_provider), receipts_provider_(receipts_provider), cache_(cache) {}
+    virtual ~FeeHistoryOracle() {}
+
+    FeeHistoryOracle(const FeeHistoryOracle&) = delete;
+    FeeHistoryOracle& operator=(const FeeHistoryOracle&) = delete;
+
+    //! Return the fee history of the block_count blocks ending at newest_block, throwing std::invalid_argument if the reward
+    //! percentiles are not monotonically increasing values in [0, 100]
+    boost::asio::awaitable<FeeHistory> fee_history(uint64_t newest_block, uint64_t block_count, const std::vector<double>& reward_percentiles);
+
+    //! Return the fee statistics of the block from the cache, if any, or by sampling the block filling the cache otherwise
+    boost::asio::awaitable<std::shared_ptr<const BlockFees>> block_fees(uint64_t block_number);
+
+    //! Compute the fee statistics of the block from its transactions and their receipts
+    static BlockFees sample_block_fees(const silkworm::ChainConfig& config, const silkworm::BlockWithHash& block_with_hash, const Receipts& receipts);
+
+    //! Compute the base fee of the block after the given one according to EIP-1559
+    static intx::uint256 next_base_fee(const silkworm::ChainConfig& config, const silkworm::BlockHeader& header);
+
+private:
+    const silkworm::ChainConfig& config_;
+    const BlockProvider& block_provider_;
+    const ReceiptsProvider& receipts_provider_;
+    FeeHistoryCache* cache_;
+};
+
+} // namespace silkrpc
+
+#endif  // SILKRPC_CORE_FEE_HISTORY_ORACLE_HPP_
@@ -0,0 +1,159 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "fee_history_oracle.hpp"
+
+#include <stdexcept>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/use_future.hpp>
+#include <catch2/catch.hpp>
+#include <silkworm/chain/config.hpp>
+#include <silkworm/chain/protocol_param.hpp>
+
+namespace silkrpc {
+
+static constexpr uint64_t kLondonBlock{12'965'000};
+
+//! Block with one transaction per given priority fee, each one using the given gas
+static silkworm::BlockWithHash make_block(uint64_t block_number, const std::vector<std::pair<uint64_t, uint64_t>>& txs) {
+    silkworm::BlockWithHash block_with_hash;
+    block_with_hash.block.header.number = block_number;
+    block_with_hash.block.header.gas_limit = 1'000'000;
+    block_with_hash.block.header.base_fee_per_gas = 100;
+    for (const auto& [priority_fee, gas_used] : txs) {
+        silkworm::Transaction transaction;
+        transaction.max_priority_fee_per_gas = priority_fee;
+        transaction.max_fee_per_gas = 100 + priority_fee;
+        block_with_hash.block.transactions.push_back(transaction);
+        block_with_hash.block.header.gas_used += gas_used;
+    }
+    return block_with_hash;
+}
+
+static Receipts make_receipts(const std::vector<std::pair<uint64_t, uint64_t>>& txs) {
+    Receipts receipts;
+    for (const auto& [priority_fee, gas_used] : txs) {
+        Receipt receipt;
+        receipt.gas_used = gas_used;
+        receipts.push_back(receipt);
+    }
+    return receipts;
+}
+
+TEST_CASE("next base fee", "[silkrpc][core][fee_history_oracle]") {
+    const auto& config = silkworm::kMainnetConfig;
+    silkworm::BlockHeader header;
+    header.gas_limit = 1'000'000;
+
+    SECTION("before London") {
+        header.number = kLondonBlock - 2;
+        CHECK(FeeHistoryOracle::next_base_fee(config, header) == 0);
+    }
+
+    SECTION("London fork block") {
+        header.number = kLondonBlock - 1;
+        CHECK(FeeHistoryOracle::next_base_fee(config, header) == silkworm::param::kInitialBaseFee);
+    }
+
+    SECTION("after London") {
+        header.number = kLondonBlock;
+        header.base_fee_per_gas = 800;
+        header.gas_used = 500'000;
+        CHECK(FeeHistoryOracle::next_base_fee(config, header) == 800);
+        header.gas_used = 1'000'000;
+        CHECK(FeeHistoryOracle::next_base_fee(config, header) == 900);
+        header.gas_used = 0;
+        CHECK(FeeHistoryOracle::next_base_fee(config, header) == 700);
+    }
+}
+
+TEST_CASE("fee history", "[silkrpc][core][fee_history_oracle]") {
+    boost::asio::thread_pool pool{1};
+
+    std::vector<silkworm::BlockWithHash> blocks;
+    std::vector<Receipts> receipts;
+    for (uint64_t block_number{0}; block_number < 10; ++block_number) {
+        const std::vector<std::pair<uint64_t, uint64_t>> txs{{block_number + 3, 21'000}, {block_number + 1, 50'000}, {block_number + 5, 29'000}};
+        blocks.push_back(make_block(block_number, txs));
+        receipts.push_back(make_receipts(txs));
+    }
+
+    std::size_t num_reads{0};
+    BlockProvider block_provider = [&](uint64_t block_number) -> boost::asio::awaitable<std::shared_ptr<const silkworm::BlockWithHash>> {
+        ++num_reads;
+        co_return std::make_shared<const silkworm::BlockWithHash>(blocks[block_number]);
+    };
+    ReceiptsProvider receipts_provider = [&](const silkworm::BlockWithHash& block_with_hash) -> boost::asio::awaitable<std::shared_ptr<const Receipts>> {
+        co_return std::make_shared<const Receipts>(receipts[block_with_hash.block.header.number]);
+    };
+
+    FeeHistoryCache cache;
+    FeeHistoryOracle oracle{silkworm::kMainnetConfig, block_provider, receipts_provider, &cache};
+
+    SECTION("rewards at percentiles weighted by gas used") {
+        const auto history = boost::asio::co_spawn(pool, oracle.fee_history(9, 3, {0, 50, 60, 100}), boost::asio::use_future).get();
+        CHECK(history.oldest_block == 7);
+        CHECK(history.base_fees == std::vector<intx::uint256>{100, 100, 100, 0});
+        REQUIRE(history.gas_used_ratios.size() == 3);
+        CHECK(history.gas_used_ratios[0] == Approx(0.1));
+        REQUIRE(history.rewards.size() == 3);
+        CHECK(history.rewards[0] == std::vector<intx::uint256>{8, 8, 10, 12});
+        CHECK(history.rewards[2] == std::vector<intx::uint256>{10, 10, 12, 14});
+    }
+
+    SECTION("block count capped by the chain length") {
+        const auto history = boost::asio::co_spawn(pool, oracle.fee_history(2, 100, {}), boost::asio::use_future).get();
+        CHECK(history.oldest_block == 0);
+        CHECK(history.base_fees.size() == 4);
+        CHECK(history.gas_used_ratios.size() == 3);
+        CHECK(history.rewards.empty());
+    }
+
+    SECTION("zero block count") {
+        const auto history = boost::asio::co_spawn(pool, oracle.fee_history(9, 0, {50}), boost::asio::use_future).get();
+        CHECK(history.base_fees.empty());
+        nlohmann::json json = history;
+        CHECK(json == R"({"oldestBlock":"0x0"})"_json);
+    }
+
+    SECTION("cached blocks are not read again") {
+        boost::asio::co_spawn(pool, oracle.fee_history(9, 5, {50}), boost::asio::use_future).get();
+        CHECK(num_reads == 5);
+        num_reads = 0;
+        boost::asio::co_spawn(pool, oracle.fee_history(9, 8, {50}), boost::asio::use_future).get();
+        CHECK(num_reads == 3);
+    }
+
+    SECTION("invalid reward percentiles") {
+        CHECK_THROWS_AS(boost::asio::co_spawn(pool, oracle.fee_history(9, 3, {50, 10}), boost::asio::use_future).get(), std::invalid_argument);
+        CHECK_THROWS_AS(boost::asio::co_spawn(pool, oracle.fee_history(9, 3, {101}), boost::asio::use_future).get(), std::invalid_argument);
+    }
+
+    SECTION("json serialization") {
+        const auto history = boost::asio::co_spawn(pool, oracle.fee_history(9, 1, {50}), boost::asio::use_future).get();
+        nlohmann::json json = history;
+        CHECK(json == R"({
+            "oldestBlock":"0x9",
+            "baseFeePerGas":["0x64","0x0"],
+            "gasUsedRatio":[0.1],
+            "reward":[["0xa"]]
+        })"_json);
+    }
+}
+
+} // namespace silkrpc
@@ -37,10 +37,30 @@ struct PriceComparator {
 
 boost::asio::awaitable<intx::uint256> GasPriceOracle::suggested_price(uint64_t block_number) {
     SILKRPC_INFO << "GasPriceOracle::suggested_price starting block: " << block_number << "\n";
+    const auto head_block_number = block_number;
+    const auto generation = cache_ ? cache_->generation() : 0;
+    if (cache_) {
+        if (const auto cached_price = cache_->find_price(head_block_number)) {
+            SILKRPC_DEBUG << "GasPriceOracle::suggested_price cached price: 0x" << intx::hex(*cached_price) << "\n";
+            co_return *cached_price;
+        }
+    }
+
     std::vector<intx::uint256> tx_prices;
     tx_prices.reserve(kMaxSamples);
     while (tx_prices.size() < kMaxSamples && block_number > 0) {
-        co_await load_block_prices(block_number--, kSamples, tx_prices);
+        const auto cached_samples = cache_ ? cache_->find_samples(block_number) : std::nullopt;
+        if (cached_samples) {
+            tx_prices.insert(tx_prices.end(), cached_samples->begin(), cached_samples->end());
+        } else {
+            std::vector<intx::uint256> block_samples;
+            co_await load_block_prices(block_number, kSamples, block_samples);
+            tx_prices.insert(tx_prices.end(), block_samples.begin(), block_samples.end());
+            if (cache_) {
+                cache_->store_samples(block_number, std::move(block_samples), generation);
+            }
+        }
+        --block_number;
     }
     SILKRPC_INFO << "GasPriceOracle::suggested_price ending block: " << block_number << "\n";
 
@@ -62,6 +82,9 @@ boost::asio::awaitable<intx::uint256> GasPriceOracle::suggested_price(uint64_t b
     }
 
     SILKRPC_INFO << "GasPriceOracle::suggested_price price: 0x" << intx::hex(price) << "\n";
+    if (cache_) {
+        cache_->store_price(head_block_number, price, generation);
+    }
 
     co_return price;
 }
@@ -70,17 +93,17 @@ boost::asio::awaitable<void> GasPriceOracle::load_block_prices(uint64_t block_nu
     SILKRPC_TRACE << "GasPriceOracle::load_block_prices processing block: " << block_number << "\n";
 
     const auto block_with_hash = co_await block_provider_(block_number);
-    const auto &base_fee = block_with_hash.block.header.base_fee_per_gas.value_or(0);
-    const auto &coinbase = block_with_hash.block.header.beneficiary;
+    const auto &base_fee = block_with_hash->block.header.base_fee_per_gas.value_or(0);
+    const auto &coinbase = block_with_hash->block.header.beneficiary;
 
-    SILKRPC_TRACE << "GasPriceOracle::load_block_prices # transactions in block: " << block_with_hash.block.transactions.size() << "\n";
+    SILKRPC_TRACE << "GasPriceOracle::load_block_prices # transactions in block: " << block_with_hash->block.transactions.size() << "\n";
     SILKRPC_TRACE << "GasPriceOracle::load_block_prices # block base_fee: 0x" << intx::hex(base_fee) << "\n";
     SILKRPC_TRACE << "GasPriceOracle::load_block_prices # block beneficiary: 0x" << coinbase << "\n";
 
     std::vector<intx::uint256> block_prices;
     int idx = 0;
-    block_prices.reserve(block_with_hash.block.transactions.size());
-    for (const auto& transaction : block_with_hash.block.transactions) {
+    block_prices.reserve(block_with_hash->block.transactions.size());
+    for (const auto& transaction : block_with_hash->block.transactions) {
         const auto priority_fee_per_gas  = transaction.priority_fee_per_gas(base_fee);
         SILKRPC_TRACE << "idx: " << idx++
             << " hash: " <<  silkworm::to_hex({hash_of_transaction(transaction).bytes, silkworm::kHashLength})
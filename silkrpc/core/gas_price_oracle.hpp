@@ -18,6 +18,7 @@
 #define SILKRPC_CORE_GAS_PRICE_ORACLE_HPP_
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -29,6 +30,7 @@
 #include <silkworm/types/block.hpp>
 #include <silkworm/types/transaction.hpp>
 
+#include <silkrpc/common/gas_price_cache.hpp>
 #include <silkrpc/core/blocks.hpp>
 #include <silkrpc/core/rawdb/accessors.hpp>
 
@@ -46,11 +48,14 @@ const std::uint8_t kSamples = 3;
 const std::uint8_t kMaxSamples = kCheckBlocks * kSamples;
 const std::uint8_t kPercentile = 60;
 
-typedef std::function<boost::asio::awaitable<silkworm::BlockWithHash>(uint64_t)> BlockProvider;
+typedef std::function<boost::asio::awaitable<std::shared_ptr<const silkworm::BlockWithHash>>(uint64_t)> BlockProvider;
 
+//! The price suggested at the latest block and the samples of the blocks are kept in the cache, if any: when the cache has
+//! been updated at each new head (see GasPriceUpdater), suggesting the price is just a lookup.
 class GasPriceOracle {
 public:
-    explicit GasPriceOracle(const BlockProvider& block_provider) : block_provider_(block_provider) {}
+    explicit GasPriceOracle(const BlockProvider& block_provider, GasPriceCache* cache = nullptr)
+        : block_provider_(block_provider), cache_(cache) {}
     virtual ~GasPriceOracle() {}
 
     GasPriceOracle(const GasPriceOracle&) = delete;
@@ -62,6 +67,7 @@ private:
     boost::asio::awaitable<void> load_block_prices(uint64_t block_number, uint64_t limit, std::vector<intx::uint256>& tx_prices);
 
     const BlockProvider& block_provider_;
+    GasPriceCache* cache_;
 };
 
 } // namespace silkrpc
@@ -115,9 +115,8 @@ TEST_CASE("suggested price") {
 
     std::vector<silkworm::BlockWithHash> blocks;
 
-    BlockProvider block_provider = [&](uint64_t block_number) -> boost::asio::awaitable<silkworm::BlockWithHash> {
-        silkworm::BlockWithHash block_with_hash = blocks[block_number];
-        co_return block_with_hash;
+    BlockProvider block_provider = [&](uint64_t block_number) -> boost::asio::awaitable<std::shared_ptr<const silkworm::BlockWithHash>> {
+        co_return std::make_shared<const silkworm::BlockWithHash>(blocks[block_number]);
     };
     GasPriceOracle gas_price_oracle{block_provider};
 
@@ -473,4 +472,47 @@ TEST_CASE("suggested price") {
     }
 }
 
+TEST_CASE("suggested price with cache") {
+    boost::asio::thread_pool pool{1};
+
+    std::vector<silkworm::BlockWithHash> blocks;
+    VariableBlockData data = {0x7, 0x10, 0x3, 0x20, 0x3};
+    blocks.reserve(40);
+    fill_blocks_vector(blocks, kBeneficiary, data);
+
+    std::size_t num_reads{0};
+    BlockProvider block_provider = [&](uint64_t block_number) -> boost::asio::awaitable<std::shared_ptr<const silkworm::BlockWithHash>> {
+        ++num_reads;
+        co_return std::make_shared<const silkworm::BlockWithHash>(blocks[block_number]);
+    };
+    GasPriceOracle uncached_oracle{block_provider};
+    const auto expected_price = boost::asio::co_spawn(pool, uncached_oracle.suggested_price(38), boost::asio::use_future).get();
+    const auto expected_next_price = boost::asio::co_spawn(pool, uncached_oracle.suggested_price(39), boost::asio::use_future).get();
+
+    GasPriceCache cache;
+    GasPriceOracle gas_price_oracle{block_provider, &cache};
+    num_reads = 0;
+    CHECK(boost::asio::co_spawn(pool, gas_price_oracle.suggested_price(38), boost::asio::use_future).get() == expected_price);
+    CHECK(num_reads == 30);
+
+    SECTION("same head is just a lookup") {
+        num_reads = 0;
+        CHECK(boost::asio::co_spawn(pool, gas_price_oracle.suggested_price(38), boost::asio::use_future).get() == expected_price);
+        CHECK(num_reads == 0);
+    }
+
+    SECTION("new head samples just the new block") {
+        num_reads = 0;
+        CHECK(boost::asio::co_spawn(pool, gas_price_oracle.suggested_price(39), boost::asio::use_future).get() == expected_next_price);
+        CHECK(num_reads == 1);
+    }
+
+    SECTION("unwound head sampled again") {
+        cache.unwind(38);
+        num_reads = 0;
+        CHECK(boost::asio::co_spawn(pool, gas_price_oracle.suggested_price(38), boost::asio::use_future).get() == expected_price);
+        CHECK(num_reads == 1);
+    }
+}
+
 } // namespace silkrpc
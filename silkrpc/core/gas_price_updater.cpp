@@ -0,0 +1,85 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "gas_price_updater.hpp"
+
+#include <exception>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/use_future.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/common/util.hpp>
+#include <silkrpc/core/cached_chain.hpp>
+#include <silkrpc/core/fee_history_oracle.hpp>
+#include <silkrpc/core/gas_price_oracle.hpp>
+#include <silkrpc/core/rawdb/chain.hpp>
+#include <silkrpc/core/receipts.hpp>
+#include <silkrpc/ethdb/transaction_database.hpp>
+
+namespace silkrpc {
+
+GasPriceUpdater::GasPriceUpdater(Context& context)
+    : strand_{boost::asio::make_strand(*context.io_context())},
+      database_(*context.database()),
+      block_cache_(context.block_cache()),
+      receipt_cache_(context.receipt_cache()),
+      gas_price_cache_(context.gas_price_cache()),
+      fee_history_cache_(context.fee_history_cache()) {}
+
+std::future<void> GasPriceUpdater::update(uint64_t block_number) {
+    return boost::asio::co_spawn(strand_, update_price(block_number), boost::asio::use_future);
+}
+
+void GasPriceUpdater::on_state_changes(const remote::StateChangeBatch& state_changes) {
+    for (const auto& state_change : state_changes.changebatch()) {
+        if (state_change.direction() == remote::Direction::UNWIND) {
+            gas_price_cache_->unwind(state_change.blockheight());
+            fee_history_cache_->unwind(state_change.blockheight());
+            SILKRPC_DEBUG << "GasPriceUpdater::on_state_changes unwind from block: " << state_change.blockheight() << "\n";
+        } else {
+            // The future is not awaited: the update runs in background and never throws
+            update(state_change.blockheight());
+        }
+    }
+}
+
+boost::asio::awaitable<void> GasPriceUpdater::update_price(uint64_t block_number) {
+    SILKRPC_DEBUG << "GasPriceUpdater::update_price block_number: " << block_number << "\n";
+
+    auto tx = co_await database_.begin();
+    try {
+        ethdb::TransactionDatabase tx_database{*tx};
+        BlockProvider block_provider = [&](uint64_t number) {
+            return core::read_block_by_number(*block_cache_, tx_database, number);
+        };
+        GasPriceOracle gas_price_oracle{block_provider, gas_price_cache_.get()};
+        co_await gas_price_oracle.suggested_price(block_number);
+
+        const auto chain_id = co_await core::rawdb::read_chain_id(tx_database);
+        const auto chain_config_ptr = lookup_chain_config(chain_id);
+        ReceiptsProvider receipts_provider = [&](const silkworm::BlockWithHash& block_with_hash) {
+            return core::get_receipts(*receipt_cache_, tx_database, block_with_hash);
+        };
+        FeeHistoryOracle fee_history_oracle{*chain_config_ptr, block_provider, receipts_provider, fee_history_cache_.get()};
+        co_await fee_history_oracle.block_fees(block_number);
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "GasPriceUpdater::update_price block_number: " << block_number << " exception: " << e.what() << "\n";
+    }
+    co_await tx->close(); // RAII not (yet) available with coroutines
+}
+
+} // namespace silkrpc
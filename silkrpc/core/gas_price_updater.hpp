@@ -0,0 +1,72 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_CORE_GAS_PRICE_UPDATER_HPP_
+#define SILKRPC_CORE_GAS_PRICE_UPDATER_HPP_
+
+#include <cstdint>
+#include <future>
+#include <memory>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <silkrpc/common/block_cache.hpp>
+#include <silkrpc/common/fee_history_cache.hpp>
+#include <silkrpc/common/gas_price_cache.hpp>
+#include <silkrpc/common/receipt_cache.hpp>
+#include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/ethdb/database.hpp>
+#include <silkrpc/interfaces/remote/kv.pb.h>
+
+namespace silkrpc {
+
+//! Keep the gas price and fee history caches up to date with the blocks announced by the state changes: the price suggested
+//! at each new head and the fee statistics of the new block are computed once within its own transaction, sampling just
+//! the new block, whilst the unwound blocks are dropped immediately. The heads are processed one at a time, so that a burst
+//! of blocks never piles up concurrent samplings.
+class GasPriceUpdater {
+public:
+    explicit GasPriceUpdater(Context& context);
+
+    GasPriceUpdater(const GasPriceUpdater&) = delete;
+    GasPriceUpdater& operator=(const GasPriceUpdater&) = delete;
+
+    //! Start computing the price suggested at the block and its fee statistics, the returned future becomes ready when cached
+    std::future<void> update(uint64_t block_number);
+
+    //! Drop the unwound blocks from the cache and start computing the price at the new heads
+    void on_state_changes(const remote::StateChangeBatch& state_changes);
+
+private:
+    boost::asio::awaitable<void> update_price(uint64_t block_number);
+
+    //! The strand serializing the price updates
+    boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+
+    ethdb::Database& database_;
+    std::shared_ptr<BlockCache> block_cache_;
+    std::shared_ptr<ReceiptCache> receipt_cache_;
+    std::shared_ptr<GasPriceCache> gas_price_cache_;
+    std::shared_ptr<FeeHistoryCache> fee_history_cache_;
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_CORE_GAS_PRICE_UPDATER_HPP_
@@ -0,0 +1,58 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "issuance.hpp"
+
+#include <cstddef>
+
+#include <silkrpc/consensus/ethash.hpp>
+#include <silkrpc/core/rawdb/chain.hpp>
+#include <silkrpc/core/receipts.hpp>
+
+namespace silkrpc::core {
+
+bool has_issuance(const ChainConfig& config) {
+    return config.config.count("ethash") != 0;
+}
+
+BlockIssuance compute_block_issuance(const ParsedChainConfig& config, const silkworm::Block& block, const Receipts& receipts) {
+    BlockIssuance issuance;
+    const auto block_reward{ethash::compute_reward(config, block)};
+    issuance.block_reward = block_reward.miner_reward;
+    for (const auto& ommer_reward : block_reward.ommer_rewards) {
+        issuance.ommer_reward += ommer_reward;
+    }
+    if (block.header.base_fee_per_gas) {
+        const auto base_fee = *block.header.base_fee_per_gas;
+        issuance.burnt = base_fee * block.header.gas_used;
+        for (std::size_t i{0}; i < block.transactions.size() && i < receipts.size(); ++i) {
+            issuance.tips += block.transactions[i].effective_gas_price(base_fee) * receipts[i].gas_used;
+        }
+    }
+    return issuance;
+}
+
+boost::asio::awaitable<BlockIssuance> read_block_issuance(const ParsedChainConfig& config, const rawdb::DatabaseReader& reader, uint64_t block_number) {
+    const auto block_with_hash{co_await rawdb::read_block_by_number(reader, block_number)};
+    Receipts receipts;
+    if (block_with_hash.block.header.base_fee_per_gas) {
+        receipts = co_await get_receipts(reader, block_with_hash);
+    }
+    co_return compute_block_issuance(config, block_with_hash.block, receipts);
+}
+
+} // namespace silkrpc::core
@@ -0,0 +1,46 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_CORE_ISSUANCE_HPP_
+#define SILKRPC_CORE_ISSUANCE_HPP_
+
+#include <cstdint>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <silkworm/types/block.hpp>
+
+#include <silkrpc/common/issuance_index.hpp>
+#include <silkrpc/core/rawdb/accessors.hpp>
+#include <silkrpc/types/chain_config.hpp>
+#include <silkrpc/types/receipt.hpp>
+
+namespace silkrpc::core {
+
+//! Return true if the chain issues block rewards, otherwise the issuance of any block is empty
+bool has_issuance(const ChainConfig& config);
+
+//! Compute the issuance and the fees of the block given its receipts, needed only if the block has a base fee
+BlockIssuance compute_block_issuance(const ParsedChainConfig& config, const silkworm::Block& block, const Receipts& receipts);
+
+//! Read the block and its receipts (if needed) and compute its issuance and fees
+boost::asio::awaitable<BlockIssuance> read_block_issuance(const ParsedChainConfig& config, const rawdb::DatabaseReader& reader, uint64_t block_number);
+
+} // namespace silkrpc::core
+
+#endif // SILKRPC_CORE_ISSUANCE_HPP_
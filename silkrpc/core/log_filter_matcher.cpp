@@ -0,0 +1,166 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "log_filter_matcher.hpp"
+
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SILKRPC_FILTER_X86_64
+#include <immintrin.h>
+#endif
+
+namespace silkrpc::core {
+
+namespace {
+
+//! The kernel returning true if the 32-byte value is among the values, compared one by one
+using ContainsKernel = bool (*)(const evmc::bytes32* values, std::size_t count, const uint8_t* value);
+
+bool contains_scalar(const evmc::bytes32* values, std::size_t count, const uint8_t* value) {
+    for (std::size_t i{0}; i < count; ++i) {
+        if (std::memcmp(values[i].bytes, value, sizeof(values[i].bytes)) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#if defined(SILKRPC_FILTER_X86_64)
+
+__attribute__((target("avx2"))) bool contains_avx2(const evmc::bytes32* values, std::size_t count, const uint8_t* value) {
+    const __m256i needle = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(value));
+    for (std::size_t i{0}; i < count; ++i) {
+        const __m256i candidate = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values[i].bytes));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(needle, candidate)) == -1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+ContainsKernel select_contains_kernel() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? &contains_avx2 : &contains_scalar;
+}
+
+#else
+
+ContainsKernel select_contains_kernel() {
+    return &contains_scalar;
+}
+
+#endif
+
+ContainsKernel contains_kernel() {
+    static const ContainsKernel kContainsKernel{select_contains_kernel()};
+    return kContainsKernel;
+}
+
+template <typename Value>
+bool contains_linear(const std::vector<Value>& values, const uint8_t* value) {
+    if constexpr (std::is_same_v<Value, evmc::bytes32>) {
+        return contains_kernel()(values.data(), values.size(), value);
+    } else {
+        for (const auto& v : values) {
+            if (std::memcmp(v.bytes, value, sizeof(v.bytes)) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+} // namespace
+
+template <typename Value>
+FilterValueSet<Value>::FilterValueSet(const std::vector<Value>& values) {
+    if (values.size() <= kMaxLinearValues) {
+        linear_ = values;
+    } else {
+        hashed_.insert(values.begin(), values.end());
+    }
+}
+
+template <typename Value>
+bool FilterValueSet<Value>::contains(silkworm::ByteView value) const {
+    if (value.size() != sizeof(Value::bytes)) {
+        return false;
+    }
+    if (!linear_.empty()) {
+        return contains_linear(linear_, value.data());
+    }
+    Value key;
+    std::memcpy(key.bytes, value.data(), sizeof(key.bytes));
+    return hashed_.contains(key);
+}
+
+template class FilterValueSet<evmc::address>;
+template class FilterValueSet<evmc::bytes32>;
+
+LogFilterMatcher::LogFilterMatcher(const Filter& filter) {
+    if (filter.addresses) {
+        addresses_.emplace(*filter.addresses);
+    }
+    if (filter.topics) {
+        auto& topics = topics_.emplace();
+        topics.reserve(filter.topics->size());
+        for (const auto& subtopics : *filter.topics) {
+            topics.emplace_back(subtopics);
+        }
+    }
+}
+
+bool LogFilterMatcher::match(const LogView& log) const {
+    if (addresses_ && !addresses_->contains(log.address)) {
+        return false;
+    }
+    if (topics_) {
+        if (topics_->size() > log.topics.size()) {
+            return false;
+        }
+        for (std::size_t i{0}; i < topics_->size(); ++i) {
+            const auto& subtopics = (*topics_)[i];
+            // Empty rule set means wildcard
+            if (!subtopics.empty() && !subtopics.contains(log.topics[i])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool LogFilterMatcher::match(const Log& log) const {
+    if (addresses_ && !addresses_->contains({log.address.bytes, sizeof(log.address.bytes)})) {
+        return false;
+    }
+    if (topics_) {
+        if (topics_->size() > log.topics.size()) {
+            return false;
+        }
+        for (std::size_t i{0}; i < topics_->size(); ++i) {
+            const auto& subtopics = (*topics_)[i];
+            // Empty rule set means wildcard
+            if (!subtopics.empty() && !subtopics.contains({log.topics[i].bytes, sizeof(log.topics[i].bytes)})) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace silkrpc::core
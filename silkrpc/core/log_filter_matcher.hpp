@@ -0,0 +1,74 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_CORE_LOG_FILTER_MATCHER_HPP_
+#define SILKRPC_CORE_LOG_FILTER_MATCHER_HPP_
+
+#include <cstddef>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+#include <evmc/evmc.hpp>
+#include <silkworm/common/base.hpp>
+
+#include <silkrpc/types/filter.hpp>
+#include <silkrpc/types/log.hpp>
+
+namespace silkrpc::core {
+
+//! The values allowed in one position of a filter, i.e. its addresses or the topics at some index. The small sets are
+//! matched by comparing all their values (the 32-byte ones by AVX2 compares if available), the others by hash lookup
+template <typename Value>
+class FilterValueSet {
+public:
+    //! The max number of values matched by comparing them all
+    static constexpr std::size_t kMaxLinearValues{16};
+
+    FilterValueSet() = default;
+    explicit FilterValueSet(const std::vector<Value>& values);
+
+    bool empty() const noexcept { return linear_.empty() && hashed_.empty(); }
+
+    //! Check if the raw value is in the set
+    bool contains(silkworm::ByteView value) const;
+
+private:
+    std::vector<Value> linear_;
+    std::unordered_set<Value> hashed_;
+};
+
+//! Matcher of the logs against the addresses and topics of one filter, prepared once per query or subscription and
+//! reused for all its blocks: a filter having addresses matches just the logs emitted by one of them (hence none if the
+//! addresses are empty), while an empty set of topics in some position is a wildcard
+class LogFilterMatcher {
+public:
+    explicit LogFilterMatcher(const Filter& filter);
+
+    //! Check if the raw fields of the log match the filter addresses and topics
+    bool match(const LogView& log) const;
+
+    //! Check if the log matches the filter addresses and topics
+    bool match(const Log& log) const;
+
+private:
+    std::optional<FilterValueSet<evmc::address>> addresses_;
+    std::optional<std::vector<FilterValueSet<evmc::bytes32>>> topics_;
+};
+
+} // namespace silkrpc::core
+
+#endif // SILKRPC_CORE_LOG_FILTER_MATCHER_HPP_
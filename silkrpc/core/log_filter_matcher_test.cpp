@@ -0,0 +1,107 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "log_filter_matcher.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc::core {
+
+using evmc::literals::operator""_address, evmc::literals::operator""_bytes32;
+
+static const evmc::address kAddress1{0x0715a7794a1dc8e42615f059dd6e406a6594651a_address};
+static const evmc::address kAddress2{0x0f572e5295c57f15886f9b263e2f6d2d6c7b5ec6_address};
+static const evmc::bytes32 kTopic1{0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef_bytes32};
+static const evmc::bytes32 kTopic2{0x0000000000000000000000000715a7794a1dc8e42615f059dd6e406a6594651a_bytes32};
+
+//! Return as many distinct addresses as requested, the specified one being the last
+static FilterAddresses make_addresses(std::size_t count, const evmc::address& last) {
+    FilterAddresses addresses(count - 1);
+    for (std::size_t i{0}; i < addresses.size(); ++i) {
+        addresses[i].bytes[0] = 0xff;
+        addresses[i].bytes[1] = static_cast<uint8_t>(i >> 8);
+        addresses[i].bytes[2] = static_cast<uint8_t>(i);
+    }
+    addresses.push_back(last);
+    return addresses;
+}
+
+static FilterSubTopics make_topics(std::size_t count, const evmc::bytes32& last) {
+    FilterSubTopics topics(count - 1);
+    for (std::size_t i{0}; i < topics.size(); ++i) {
+        topics[i].bytes[31] = 0xff;
+        topics[i].bytes[30] = static_cast<uint8_t>(i >> 8);
+        topics[i].bytes[29] = static_cast<uint8_t>(i);
+    }
+    topics.push_back(last);
+    return topics;
+}
+
+TEST_CASE("FilterValueSet contains", "[silkrpc][core][log_filter_matcher]") {
+    for (const std::size_t count : {std::size_t{1}, FilterValueSet<evmc::bytes32>::kMaxLinearValues, std::size_t{300}}) {
+        const FilterValueSet<evmc::bytes32> topics{make_topics(count, kTopic1)};
+        CHECK(!topics.empty());
+        CHECK(topics.contains({kTopic1.bytes, sizeof(kTopic1.bytes)}));
+        CHECK(!topics.contains({kTopic2.bytes, sizeof(kTopic2.bytes)}));
+        CHECK(!topics.contains({kTopic1.bytes, sizeof(kTopic1.bytes) - 1}));
+
+        const FilterValueSet<evmc::address> addresses{make_addresses(count, kAddress1)};
+        CHECK(addresses.contains({kAddress1.bytes, sizeof(kAddress1.bytes)}));
+        CHECK(!addresses.contains({kAddress2.bytes, sizeof(kAddress2.bytes)}));
+    }
+    CHECK(FilterValueSet<evmc::address>{}.empty());
+}
+
+TEST_CASE("LogFilterMatcher match", "[silkrpc][core][log_filter_matcher]") {
+    Log log;
+    log.address = kAddress1;
+    log.topics = {kTopic1, kTopic2};
+    LogView view;
+    view_of(log, view);
+
+    SECTION("no addresses nor topics") {
+        const LogFilterMatcher matcher{Filter{}};
+        CHECK(matcher.match(log));
+        CHECK(matcher.match(view));
+    }
+
+    SECTION("addresses") {
+        Filter filter;
+        filter.addresses = make_addresses(100, kAddress1);
+        CHECK(LogFilterMatcher{filter}.match(log));
+        CHECK(LogFilterMatcher{filter}.match(view));
+        filter.addresses = FilterAddresses{kAddress2};
+        CHECK(!LogFilterMatcher{filter}.match(log));
+        CHECK(!LogFilterMatcher{filter}.match(view));
+        filter.addresses = FilterAddresses{};
+        CHECK(!LogFilterMatcher{filter}.match(log));
+    }
+
+    SECTION("topics") {
+        Filter filter;
+        filter.topics = FilterTopics{{}, make_topics(50, kTopic2)};
+        CHECK(LogFilterMatcher{filter}.match(log));
+        CHECK(LogFilterMatcher{filter}.match(view));
+        filter.topics = FilterTopics{{kTopic2}};
+        CHECK(!LogFilterMatcher{filter}.match(log));
+        CHECK(!LogFilterMatcher{filter}.match(view));
+        filter.topics = FilterTopics{{kTopic1}, {kTopic2}, {}};
+        CHECK(!LogFilterMatcher{filter}.match(log));
+        CHECK(!LogFilterMatcher{filter}.match(view));
+    }
+}
+
+} // namespace silkrpc::core
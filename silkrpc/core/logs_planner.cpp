@@ -0,0 +1,130 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "logs_planner.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <ethash/keccak.hpp>
+
+namespace silkrpc::core {
+
+LogsPlan plan_logs_query(const Filter& filter, uint64_t start_block, uint64_t end_block, uint64_t max_bloom_blocks) {
+    LogsPlan plan{LogsPlanKind::scan, start_block, end_block};
+    if ((filter.addresses && filter.addresses->empty()) || plan.num_blocks() == 0) {
+        plan.kind = LogsPlanKind::none;
+        return plan;
+    }
+    if (filter.addresses) {
+        plan.num_keys += filter.addresses->size();
+    }
+    if (filter.topics) {
+        for (const auto& subtopics : filter.topics.value()) {
+            plan.num_keys += subtopics.size();
+        }
+    }
+    if (plan.num_keys == 0) {
+        plan.estimated_cost = plan.num_blocks() * kLogsPlanBlockScanCost;
+        return plan;
+    }
+
+    const auto bloom_cost = plan.num_blocks() * kLogsPlanHeaderCost;
+    const auto bitmap_cost = plan.num_keys * kLogsPlanIndexKeyCost;
+    if (plan.num_blocks() <= max_bloom_blocks && bloom_cost < bitmap_cost) {
+        plan.kind = LogsPlanKind::bloom;
+        plan.estimated_cost = bloom_cost;
+    } else {
+        plan.kind = LogsPlanKind::bitmap;
+        plan.estimated_cost = bitmap_cost;
+    }
+    return plan;
+}
+
+LogsBloomMatcher::LogsBloomMatcher(const Filter& filter) {
+    const auto add_group = [&](const auto& keys) {
+        if (keys.size() == 1) {
+            const auto mask{mask_of({keys[0].bytes, sizeof(keys[0].bytes)})};
+            for (std::size_t i{0}; i < kNumWords; ++i) {
+                required_[i] |= mask[i];
+            }
+            return;
+        }
+        auto& group = alternatives_.emplace_back();
+        group.reserve(keys.size());
+        for (const auto& key : keys) {
+            group.push_back(mask_of({key.bytes, sizeof(key.bytes)}));
+        }
+    };
+    // An empty list of addresses matches nothing, hence it gives a group without alternatives
+    if (filter.addresses) {
+        add_group(filter.addresses.value());
+    }
+    if (filter.topics) {
+        for (const auto& subtopics : filter.topics.value()) {
+            // An empty list of topics in some position matches any topic
+            if (!subtopics.empty()) {
+                add_group(subtopics);
+            }
+        }
+    }
+}
+
+bool LogsBloomMatcher::may_match(const silkworm::Bloom& bloom) const {
+    Mask bloom_words;
+    std::memcpy(bloom_words.data(), bloom.data(), sizeof(bloom_words));
+    if (!contains(bloom_words, required_)) {
+        return false;
+    }
+    for (const auto& group : alternatives_) {
+        const auto found = std::any_of(group.cbegin(), group.cend(), [&](const auto& mask) { return contains(bloom_words, mask); });
+        if (!found) {
+            return false;
+        }
+    }
+    return true;
+}
+
+LogsBloomMatcher::Mask LogsBloomMatcher::mask_of(silkworm::ByteView item) {
+    silkworm::Bloom bloom{};
+    const auto hash{ethash::keccak256(item.data(), item.size())};
+    for (std::size_t i{0}; i < 6; i += 2) {
+        const uint16_t bit_index = ((hash.bytes[i] << 8) | hash.bytes[i + 1]) & 0x7FF;
+        bloom[silkworm::kBloomByteLength - 1 - bit_index / 8] |= static_cast<uint8_t>(1 << (bit_index % 8));
+    }
+    Mask mask;
+    std::memcpy(mask.data(), bloom.data(), sizeof(mask));
+    return mask;
+}
+
+std::ostream& operator<<(std::ostream& out, LogsPlanKind kind) {
+    switch (kind) {
+        case LogsPlanKind::none: out << "none"; break;
+        case LogsPlanKind::scan: out << "scan"; break;
+        case LogsPlanKind::bloom: out << "bloom"; break;
+        case LogsPlanKind::bitmap: out << "bitmap"; break;
+    }
+    return out;
+}
+
+std::ostream& operator<<(std::ostream& out, const LogsPlan& plan) {
+    out << "kind: " << plan.kind << " start_block: " << plan.start_block << " end_block: " << plan.end_block
+        << " num_keys: " << plan.num_keys << " estimated_cost: " << plan.estimated_cost;
+    return out;
+}
+
+} // namespace silkrpc::core
@@ -0,0 +1,118 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_CORE_LOGS_PLANNER_HPP_
+#define SILKRPC_CORE_LOGS_PLANNER_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <silkworm/types/bloom.hpp>
+
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/types/filter.hpp>
+
+namespace silkrpc::core {
+
+//! The ways of finding the blocks in the range of eth_getLogs that may contain the logs matching the filter
+enum class LogsPlanKind {
+    none,   // no log can match, i.e. the filter has an empty list of addresses
+    scan,   // the filter has no address nor topic, so the logs of every block in the range are read
+    bloom,  // the logsBloom of the header of each block in the range is checked before reading its logs
+    bitmap  // the blocks are found intersecting the log address and topic indexes
+};
+
+//! The estimated cost in reads of one header lookup, usually served by the header cache
+constexpr uint64_t kLogsPlanHeaderCost{1};
+
+//! The estimated cost in reads of looking up one key in the log indexes, i.e. seeking and decoding its bitmap chunks
+constexpr uint64_t kLogsPlanIndexKeyCost{8};
+
+//! The estimated cost in reads of reading all the logs of one block
+constexpr uint64_t kLogsPlanBlockScanCost{4};
+
+//! The plan chosen by plan_logs_query for one eth_getLogs query, along with its estimated work
+struct LogsPlan {
+    LogsPlanKind kind{LogsPlanKind::scan};
+    uint64_t start_block{0};
+    uint64_t end_block{0};
+
+    //! The number of index keys of the filter, i.e. addresses plus topics
+    std::size_t num_keys{0};
+
+    //! The estimated number of reads needed to find the candidate blocks (or to read them all, when scanning)
+    uint64_t estimated_cost{0};
+
+    uint64_t num_blocks() const noexcept { return end_block >= start_block ? end_block - start_block + 1 : 0; }
+};
+
+//! The error thrown when the plan of a query is too expensive to be served
+class LogsQueryRejected : public std::runtime_error {
+public:
+    explicit LogsQueryRejected(const std::string& reason) : std::runtime_error{reason} {}
+};
+
+//! Choose the cheapest way of finding the candidate blocks in [start_block, end_block] for the filter: a range scan when
+//! the filter has no address nor topic, the header logsBloom precheck when the range is short enough that reading its
+//! headers costs less than reading the index bitmaps of all the keys, the bitmap intersection otherwise
+LogsPlan plan_logs_query(const Filter& filter, uint64_t start_block, uint64_t end_block, uint64_t max_bloom_blocks = kGetLogsMaxBloomBlocks);
+
+//! Matcher of the header logsBloom against the addresses and topics of one filter. The 2048-bit masks of the filter keys
+//! are computed once, so that each block is tested by a few word-wise AND comparisons over its logsBloom (vectorized by
+//! the compiler) rather than hashing every key again: the keys alone in their group (i.e. the only address or the only
+//! topic in some position) are merged into one mask, so that the most common filters need just one comparison
+class LogsBloomMatcher {
+public:
+    static constexpr std::size_t kNumWords{silkworm::kBloomByteLength / sizeof(uint64_t)};
+    using Mask = std::array<uint64_t, kNumWords>;
+
+    explicit LogsBloomMatcher(const Filter& filter);
+
+    //! Check if the logsBloom may contain some log matching the filter: false positives are possible, false negatives are not
+    bool may_match(const silkworm::Bloom& bloom) const;
+
+    //! Return the mask of the bits set by the item in the 2048-bit Bloom filter (see Yellow Paper 4.3.1)
+    static Mask mask_of(silkworm::ByteView item);
+
+    //! Check if all the bits set in the mask are set in the bloom as well
+    static bool contains(const Mask& bloom, const Mask& mask) noexcept {
+        uint64_t missing{0};
+        for (std::size_t i{0}; i < kNumWords; ++i) {
+            missing |= mask[i] & ~bloom[i];
+        }
+        return missing == 0;
+    }
+
+private:
+    //! The union of the masks of the keys alone in their group, all of which must be contained
+    Mask required_{};
+
+    //! The masks of the keys of the groups having several keys, at least one per group must be contained
+    std::vector<std::vector<Mask>> alternatives_;
+};
+
+std::ostream& operator<<(std::ostream& out, LogsPlanKind kind);
+std::ostream& operator<<(std::ostream& out, const LogsPlan& plan);
+
+} // namespace silkrpc::core
+
+#endif // SILKRPC_CORE_LOGS_PLANNER_HPP_
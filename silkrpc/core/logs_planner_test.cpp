@@ -0,0 +1,133 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "logs_planner.hpp"
+
+#include <cstring>
+
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+
+namespace silkrpc::core {
+
+using evmc::literals::operator""_address, evmc::literals::operator""_bytes32;
+
+static const auto kAddress1{0x0715a7794a1dc8e42615f059dd6e406a6594651a_address};
+static const auto kAddress2{0x6677907ab33937e392b9be983b30818f29d59403_address};
+static const auto kTopic1{0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef_bytes32};
+static const auto kTopic2{0x0000000000000000000000000715a7794a1dc8e42615f059dd6e406a6594651a_bytes32};
+
+static silkworm::Bloom make_bloom(const evmc::address& address, const evmc::bytes32& topic) {
+    silkworm::Bloom bloom{};
+    silkworm::m3_2048(bloom, {address.bytes, sizeof(address.bytes)});
+    silkworm::m3_2048(bloom, {topic.bytes, sizeof(topic.bytes)});
+    return bloom;
+}
+
+TEST_CASE("plan_logs_query", "[silkrpc][core][logs_planner]") {
+    SECTION("empty addresses") {
+        const auto plan = plan_logs_query(Filter{{}, {}, FilterAddresses{}, {}, {}}, 100, 200);
+        CHECK(plan.kind == LogsPlanKind::none);
+    }
+
+    SECTION("empty range") {
+        const auto plan = plan_logs_query(Filter{{}, {}, FilterAddresses{kAddress1}, {}, {}}, 200, 100);
+        CHECK(plan.kind == LogsPlanKind::none);
+        CHECK(plan.num_blocks() == 0);
+    }
+
+    SECTION("no address nor topic") {
+        const auto plan = plan_logs_query(Filter{}, 100, 199);
+        CHECK(plan.kind == LogsPlanKind::scan);
+        CHECK(plan.num_keys == 0);
+        CHECK(plan.estimated_cost == 100 * kLogsPlanBlockScanCost);
+    }
+
+    SECTION("wildcard topics only") {
+        const auto plan = plan_logs_query(Filter{{}, {}, {}, FilterTopics{{}, {}}, {}}, 100, 199);
+        CHECK(plan.kind == LogsPlanKind::scan);
+    }
+
+    SECTION("short range") {
+        const auto plan = plan_logs_query(Filter{{}, {}, FilterAddresses{kAddress1}, FilterTopics{{kTopic1}}, {}}, 100, 100);
+        CHECK(plan.kind == LogsPlanKind::bloom);
+        CHECK(plan.num_keys == 2);
+        CHECK(plan.estimated_cost == kLogsPlanHeaderCost);
+    }
+
+    SECTION("selective filter") {
+        const auto plan = plan_logs_query(Filter{{}, {}, FilterAddresses{kAddress1}, {}, {}}, 1, 1'000);
+        CHECK(plan.kind == LogsPlanKind::bitmap);
+        CHECK(plan.estimated_cost == kLogsPlanIndexKeyCost);
+    }
+
+    SECTION("many keys over a wide range") {
+        FilterAddresses addresses(1'000, kAddress1);
+        const auto plan = plan_logs_query(Filter{{}, {}, addresses, {}, {}}, 1, kGetLogsMaxBloomBlocks + 1);
+        CHECK(plan.kind == LogsPlanKind::bitmap);
+    }
+
+    SECTION("many keys over a medium range") {
+        FilterAddresses addresses(1'000, kAddress1);
+        const auto plan = plan_logs_query(Filter{{}, {}, addresses, {}, {}}, 1, kGetLogsMaxBloomBlocks);
+        CHECK(plan.kind == LogsPlanKind::bloom);
+        CHECK(plan.estimated_cost == kGetLogsMaxBloomBlocks * kLogsPlanHeaderCost);
+    }
+}
+
+TEST_CASE("LogsBloomMatcher::mask_of", "[silkrpc][core][logs_planner]") {
+    silkworm::Bloom bloom{};
+    silkworm::m3_2048(bloom, {kAddress1.bytes, sizeof(kAddress1.bytes)});
+    LogsBloomMatcher::Mask words;
+    std::memcpy(words.data(), bloom.data(), sizeof(words));
+    CHECK(LogsBloomMatcher::mask_of({kAddress1.bytes, sizeof(kAddress1.bytes)}) == words);
+    CHECK(LogsBloomMatcher::contains(words, LogsBloomMatcher::mask_of({kAddress1.bytes, sizeof(kAddress1.bytes)})));
+    CHECK(LogsBloomMatcher::contains(words, LogsBloomMatcher::Mask{}));
+    CHECK(!LogsBloomMatcher::contains(LogsBloomMatcher::Mask{}, words));
+}
+
+TEST_CASE("LogsBloomMatcher::may_match", "[silkrpc][core][logs_planner]") {
+    const auto bloom{make_bloom(kAddress1, kTopic1)};
+
+    SECTION("empty addresses") {
+        CHECK(!LogsBloomMatcher{Filter{{}, {}, FilterAddresses{}, {}, {}}}.may_match(bloom));
+    }
+
+    SECTION("no address nor topic") {
+        CHECK(LogsBloomMatcher{Filter{}}.may_match(silkworm::Bloom{}));
+    }
+
+    SECTION("addresses") {
+        CHECK(LogsBloomMatcher{Filter{{}, {}, FilterAddresses{kAddress1}, {}, {}}}.may_match(bloom));
+        CHECK(LogsBloomMatcher{Filter{{}, {}, FilterAddresses{kAddress2, kAddress1}, {}, {}}}.may_match(bloom));
+        CHECK(!LogsBloomMatcher{Filter{{}, {}, FilterAddresses{kAddress2}, {}, {}}}.may_match(bloom));
+    }
+
+    SECTION("topics") {
+        CHECK(LogsBloomMatcher{Filter{{}, {}, {}, FilterTopics{{kTopic1}}, {}}}.may_match(bloom));
+        CHECK(LogsBloomMatcher{Filter{{}, {}, {}, FilterTopics{{}, {kTopic2, kTopic1}}, {}}}.may_match(bloom));
+        CHECK(!LogsBloomMatcher{Filter{{}, {}, {}, FilterTopics{{kTopic1}, {kTopic2}}, {}}}.may_match(bloom));
+    }
+
+    SECTION("addresses and topics") {
+        CHECK(LogsBloomMatcher{Filter{{}, {}, FilterAddresses{kAddress1}, FilterTopics{{kTopic1}}, {}}}.may_match(bloom));
+        CHECK(!LogsBloomMatcher{Filter{{}, {}, FilterAddresses{kAddress1}, FilterTopics{{kTopic2}}, {}}}.may_match(bloom));
+        CHECK(!LogsBloomMatcher{Filter{{}, {}, FilterAddresses{kAddress2}, FilterTopics{{kTopic1}}, {}}}.may_match(bloom));
+    }
+}
+
+} // namespace silkrpc::core
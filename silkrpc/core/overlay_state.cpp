@@ -0,0 +1,164 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "overlay_state.hpp"
+
+#include <algorithm>
+
+namespace silkrpc::state {
+
+void OverlayState::apply(const StateOverrides& overrides) {
+    for (const auto& [address, account_overrides] : overrides) {
+        auto& field_overrides = account_overrides_[address];
+        if (account_overrides.balance) {
+            field_overrides.balance = account_overrides.balance;
+        }
+        if (account_overrides.nonce) {
+            field_overrides.nonce = account_overrides.nonce;
+        }
+        if (account_overrides.code) {
+            const ethash::hash256 hash{silkworm::keccak256(*account_overrides.code)};
+            const auto code_hash{silkworm::to_bytes32({hash.bytes, silkworm::kHashLength})};
+            code_.insert_or_assign(code_hash, *account_overrides.code);
+            field_overrides.code_hash = code_hash;
+        }
+        if (account_overrides.state) {
+            auto it = storage_overrides_.lower_bound(LocationKey{address, evmc::bytes32{}});
+            while (it != storage_overrides_.end() && it->first.first == address) {
+                it = storage_overrides_.erase(it);
+            }
+            for (const auto& [location, value] : *account_overrides.state) {
+                storage_overrides_.insert_or_assign(LocationKey{address, location}, value);
+            }
+            replaced_storage_.insert(address);
+        }
+        for (const auto& [location, value] : account_overrides.state_diff) {
+            storage_overrides_.insert_or_assign(LocationKey{address, location}, value);
+        }
+        accounts_.erase(address);
+    }
+}
+
+void OverlayState::apply(const StateCheckpoint& checkpoint) {
+    for (const auto& [address, account] : checkpoint.accounts) {
+        accounts_.insert_or_assign(address, account);
+    }
+    for (const auto& [code_hash, code] : checkpoint.code) {
+        code_.insert_or_assign(code_hash, code);
+    }
+    for (const auto& [storage_key, value] : checkpoint.storage) {
+        storage_.insert_or_assign(storage_key, value);
+    }
+    for (const auto& [address, incarnation] : checkpoint.incarnations) {
+        incarnations_.insert_or_assign(address, incarnation);
+    }
+}
+
+std::optional<silkworm::Account> OverlayState::read_account(const evmc::address& address) const noexcept {
+    const auto cached_it = accounts_.find(address);
+    if (cached_it != accounts_.end()) {
+        return cached_it->second;
+    }
+    std::optional<silkworm::Account> account;
+    const auto overrides_it = account_overrides_.find(address);
+    if (overrides_it == account_overrides_.end()) {
+        account = state_.read_account(address);
+    } else {
+        const auto& field_overrides = overrides_it->second;
+        // The underlying account is still needed for its incarnation unless the whole storage is overridden too
+        const bool fully_overridden = field_overrides.balance && field_overrides.nonce && field_overrides.code_hash &&
+            replaced_storage_.contains(address);
+        if (!fully_overridden) {
+            account = state_.read_account(address);
+        }
+        if (!account) {
+            account = silkworm::Account{};
+        }
+        if (field_overrides.balance) {
+            account->balance = *field_overrides.balance;
+        }
+        if (field_overrides.nonce) {
+            account->nonce = *field_overrides.nonce;
+        }
+        if (field_overrides.code_hash) {
+            account->code_hash = *field_overrides.code_hash;
+        }
+    }
+    accounts_.emplace(address, account);
+    return account;
+}
+
+silkworm::ByteView OverlayState::read_code(const evmc::bytes32& code_hash) const noexcept {
+    auto it = code_.find(code_hash);
+    if (it == code_.end()) {
+        it = code_.emplace(code_hash, silkworm::Bytes{state_.read_code(code_hash)}).first;
+    }
+    return it->second;
+}
+
+evmc::bytes32 OverlayState::read_storage(const evmc::address& address, uint64_t incarnation, const evmc::bytes32& location) const noexcept {
+    const auto overridden_it = storage_overrides_.find(LocationKey{address, location});
+    if (overridden_it != storage_overrides_.end()) {
+        return overridden_it->second;
+    }
+    if (replaced_storage_.contains(address)) {
+        return evmc::bytes32{};
+    }
+    const StorageKey storage_key{address, incarnation, location};
+    auto it = storage_.find(storage_key);
+    if (it == storage_.end()) {
+        it = storage_.emplace(storage_key, state_.read_storage(address, incarnation, location)).first;
+    }
+    return it->second;
+}
+
+uint64_t OverlayState::previous_incarnation(const evmc::address& address) const noexcept {
+    const auto it = incarnations_.find(address);
+    if (it != incarnations_.end()) {
+        return std::max(it->second, state_.previous_incarnation(address));
+    }
+    return state_.previous_incarnation(address);
+}
+
+void OverlayState::update_account(const evmc::address& address, std::optional<silkworm::Account> initial,
+                                  std::optional<silkworm::Account> current) {
+    if (recorder_ == nullptr || initial == current) {
+        return;
+    }
+    if (!current && initial) {
+        auto& incarnation = recorder_->incarnations[address];
+        incarnation = std::max(incarnation, initial->incarnation);
+    }
+    recorder_->accounts.insert_or_assign(address, current);
+}
+
+void OverlayState::update_account_code(const evmc::address& /*address*/, uint64_t /*incarnation*/, const evmc::bytes32& code_hash,
+                                       silkworm::ByteView code) {
+    if (recorder_ == nullptr) {
+        return;
+    }
+    recorder_->code.insert_or_assign(code_hash, silkworm::Bytes{code});
+}
+
+void OverlayState::update_storage(const evmc::address& address, uint64_t incarnation, const evmc::bytes32& location,
+                                  const evmc::bytes32& initial, const evmc::bytes32& current) {
+    if (recorder_ == nullptr || initial == current) {
+        return;
+    }
+    recorder_->storage.insert_or_assign(StorageKey{address, incarnation, location}, current);
+}
+
+} // namespace silkrpc::state
@@ -0,0 +1,143 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_CORE_OVERLAY_STATE_HPP_
+#define SILKRPC_CORE_OVERLAY_STATE_HPP_
+
+#include <map>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <evmc/evmc.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/state/state.hpp>
+
+#include <silkrpc/common/state_checkpoint_cache.hpp>
+#include <silkrpc/types/call.hpp>
+
+namespace silkrpc::state {
+
+//! State in front of another one, typically RemoteState, resolving locally the overridden accounts and storage locations
+//! and reading anything else from the underlying state just once: besides applying the state overrides of eth_call, it
+//! acts as the read cache of all the executions serving one request. Like RemoteState, it never writes anything and it
+//! must not be accessed concurrently. The writes can be recorded into a state checkpoint instead, which is applied to
+//! another overlay later to resume the execution of the same block.
+class OverlayState : public silkworm::State {
+public:
+    explicit OverlayState(const silkworm::State& state) : state_{state} {}
+
+    //! Apply the overrides on top of the current ones, replacing any value already read for the same accounts
+    void apply(const StateOverrides& overrides);
+
+    //! Apply the checkpoint, replacing any value already read for the same accounts and storage locations
+    void apply(const StateCheckpoint& checkpoint);
+
+    //! Record the state written from now on into the specified checkpoint, if any
+    void set_checkpoint_recorder(StateCheckpoint* recorder) { recorder_ = recorder; }
+
+    std::optional<silkworm::Account> read_account(const evmc::address& address) const noexcept override;
+
+    silkworm::ByteView read_code(const evmc::bytes32& code_hash) const noexcept override;
+
+    evmc::bytes32 read_storage(const evmc::address& address, uint64_t incarnation, const evmc::bytes32& location) const noexcept override;
+
+    uint64_t previous_incarnation(const evmc::address& address) const noexcept override;
+
+    std::optional<silkworm::BlockHeader> read_header(uint64_t block_number, const evmc::bytes32& block_hash) const noexcept override {
+        return state_.read_header(block_number, block_hash);
+    }
+
+    bool read_body(uint64_t block_number, const evmc::bytes32& block_hash, silkworm::BlockBody& out) const noexcept override {
+        return state_.read_body(block_number, block_hash, out);
+    }
+
+    std::optional<intx::uint256> total_difficulty(uint64_t block_number, const evmc::bytes32& block_hash) const noexcept override {
+        return state_.total_difficulty(block_number, block_hash);
+    }
+
+    evmc::bytes32 state_root_hash() const override { return state_.state_root_hash(); }
+
+    uint64_t current_canonical_block() const override { return state_.current_canonical_block(); }
+
+    std::optional<evmc::bytes32> canonical_hash(uint64_t block_number) const override { return state_.canonical_hash(block_number); }
+
+    void insert_block(const silkworm::Block& block, const evmc::bytes32& hash) override {}
+
+    void canonize_block(uint64_t block_number, const evmc::bytes32& block_hash) override {}
+
+    void decanonize_block(uint64_t block_number) override {}
+
+    void insert_receipts(uint64_t block_number, const std::vector<silkworm::Receipt>& receipts) override {}
+
+    void begin_block(uint64_t block_number) override {}
+
+    void update_account(
+        const evmc::address& address,
+        std::optional<silkworm::Account> initial,
+        std::optional<silkworm::Account> current) override;
+
+    void update_account_code(
+        const evmc::address& address,
+        uint64_t incarnation,
+        const evmc::bytes32& code_hash,
+        silkworm::ByteView code) override;
+
+    void update_storage(
+        const evmc::address& address,
+        uint64_t incarnation,
+        const evmc::bytes32& location,
+        const evmc::bytes32& initial,
+        const evmc::bytes32& current) override;
+
+    void unwind_state_changes(uint64_t block_number) override {}
+
+private:
+    using StorageKey = std::tuple<evmc::address, uint64_t, evmc::bytes32>;
+    using LocationKey = std::pair<evmc::address, evmc::bytes32>;
+
+    const silkworm::State& state_;
+
+    struct FieldOverrides {
+        std::optional<intx::uint256> balance;
+        std::optional<uint64_t> nonce;
+        std::optional<evmc::bytes32> code_hash;
+    };
+
+    //! The overrides of the account fields, resolved against the underlying account on first read
+    std::unordered_map<evmc::address, FieldOverrides> account_overrides_;
+
+    //! The overridden storage locations, whatever the incarnation, and the accounts whose whole storage is overridden
+    std::map<LocationKey, evmc::bytes32> storage_overrides_;
+    std::unordered_set<evmc::address> replaced_storage_;
+
+    //! The accounts, code and storage read so far, overrides applied
+    mutable std::unordered_map<evmc::address, std::optional<silkworm::Account>> accounts_;
+    mutable std::unordered_map<evmc::bytes32, silkworm::Bytes> code_;
+    mutable std::map<StorageKey, evmc::bytes32> storage_;
+
+    //! The incarnation of the accounts destructed by the applied checkpoints
+    std::unordered_map<evmc::address, uint64_t> incarnations_;
+
+    StateCheckpoint* recorder_{nullptr};
+};
+
+} // namespace silkrpc::state
+
+#endif  // SILKRPC_CORE_OVERLAY_STATE_HPP_
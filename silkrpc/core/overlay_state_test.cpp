@@ -0,0 +1,233 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "overlay_state.hpp"
+
+#include <map>
+#include <optional>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+
+namespace silkrpc::state {
+
+using evmc::literals::operator""_address, evmc::literals::operator""_bytes32;
+
+//! State counting the reads, having one account with some code and one storage location
+class CountingState : public silkworm::State {
+public:
+    std::optional<silkworm::Account> read_account(const evmc::address& address) const noexcept override {
+        ++account_reads;
+        if (address != kAccountAddress) {
+            return std::nullopt;
+        }
+        return silkworm::Account{.nonce = 7, .balance = 100, .code_hash = kCodeHash, .incarnation = 2};
+    }
+
+    silkworm::ByteView read_code(const evmc::bytes32& code_hash) const noexcept override {
+        ++code_reads;
+        return code_hash == kCodeHash ? silkworm::ByteView{code} : silkworm::ByteView{};
+    }
+
+    evmc::bytes32 read_storage(const evmc::address& address, uint64_t incarnation, const evmc::bytes32& location) const noexcept override {
+        ++storage_reads;
+        return address == kAccountAddress && incarnation == 2 && location == kLocation ? kValue : evmc::bytes32{};
+    }
+
+    uint64_t previous_incarnation(const evmc::address& address) const noexcept override { return 0; }
+
+    std::optional<silkworm::BlockHeader> read_header(uint64_t block_number, const evmc::bytes32& block_hash) const noexcept override {
+        return std::nullopt;
+    }
+
+    bool read_body(uint64_t block_number, const evmc::bytes32& block_hash, silkworm::BlockBody& out) const noexcept override { return false; }
+
+    std::optional<intx::uint256> total_difficulty(uint64_t block_number, const evmc::bytes32& block_hash) const noexcept override {
+        return std::nullopt;
+    }
+
+    evmc::bytes32 state_root_hash() const override { return evmc::bytes32{}; }
+
+    uint64_t current_canonical_block() const override { return 0; }
+
+    std::optional<evmc::bytes32> canonical_hash(uint64_t block_number) const override { return std::nullopt; }
+
+    void insert_block(const silkworm::Block& block, const evmc::bytes32& hash) override {}
+
+    void canonize_block(uint64_t block_number, const evmc::bytes32& block_hash) override {}
+
+    void decanonize_block(uint64_t block_number) override {}
+
+    void insert_receipts(uint64_t block_number, const std::vector<silkworm::Receipt>& receipts) override {}
+
+    void begin_block(uint64_t block_number) override {}
+
+    void update_account(const evmc::address& address, std::optional<silkworm::Account> initial, std::optional<silkworm::Account> current) override {}
+
+    void update_account_code(const evmc::address& address, uint64_t incarnation, const evmc::bytes32& code_hash, silkworm::ByteView code) override {}
+
+    void update_storage(const evmc::address& address, uint64_t incarnation, const evmc::bytes32& location, const evmc::bytes32& initial,
+        const evmc::bytes32& current) override {}
+
+    void unwind_state_changes(uint64_t block_number) override {}
+
+    static inline const evmc::address kAccountAddress{0x52c24586c31cff0485a6208bb63859290fba5bce_address};
+    static inline const evmc::bytes32 kCodeHash{0x0000000000000000000000000000000000000000000000000000000000000c0d_bytes32};
+    static inline const evmc::bytes32 kLocation{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+    static inline const evmc::bytes32 kValue{0x000000000000000000000000000000000000000000000000000000000000002a_bytes32};
+
+    silkworm::Bytes code{0x60, 0x00};
+    mutable int account_reads{0};
+    mutable int code_reads{0};
+    mutable int storage_reads{0};
+};
+
+TEST_CASE("OverlayState without overrides", "[silkrpc][core][overlay_state]") {
+    const auto other_address{0x0715a7794a1dc8e42615f059dd6e406a6594651a_address};
+    CountingState state;
+    OverlayState overlay{state};
+
+    SECTION("reads through the underlying state just once") {
+        for (int i{0}; i < 2; ++i) {
+            const auto account{overlay.read_account(CountingState::kAccountAddress)};
+            REQUIRE(account);
+            CHECK(account->nonce == 7);
+            CHECK(account->balance == 100);
+            CHECK(overlay.read_account(other_address) == std::nullopt);
+            CHECK(overlay.read_code(CountingState::kCodeHash) == silkworm::ByteView{state.code});
+            CHECK(overlay.read_storage(CountingState::kAccountAddress, 2, CountingState::kLocation) == CountingState::kValue);
+        }
+        CHECK(state.account_reads == 2);
+        CHECK(state.code_reads == 1);
+        CHECK(state.storage_reads == 1);
+    }
+
+    SECTION("keeps the storage of different incarnations apart") {
+        CHECK(overlay.read_storage(CountingState::kAccountAddress, 2, CountingState::kLocation) == CountingState::kValue);
+        CHECK(overlay.read_storage(CountingState::kAccountAddress, 3, CountingState::kLocation) == evmc::bytes32{});
+        CHECK(state.storage_reads == 2);
+    }
+}
+
+TEST_CASE("OverlayState with overrides", "[silkrpc][core][overlay_state]") {
+    const auto other_address{0x0715a7794a1dc8e42615f059dd6e406a6594651a_address};
+    const auto other_location{0x0000000000000000000000000000000000000000000000000000000000000002_bytes32};
+    const auto new_value{0x00000000000000000000000000000000000000000000000000000000000000ff_bytes32};
+    CountingState state;
+    OverlayState overlay{state};
+
+    SECTION("overrides some fields of an existing account") {
+        overlay.apply({{CountingState::kAccountAddress, AccountOverrides{.balance = 5}}});
+        const auto account{overlay.read_account(CountingState::kAccountAddress)};
+        REQUIRE(account);
+        CHECK(account->balance == 5);
+        CHECK(account->nonce == 7);
+        CHECK(account->code_hash == CountingState::kCodeHash);
+        CHECK(account->incarnation == 2);
+        CHECK(state.account_reads == 1);
+    }
+
+    SECTION("creates a fully overridden account without reading it") {
+        const silkworm::Bytes code{0x60, 0x01, 0x60, 0x00, 0x55};
+        overlay.apply({{other_address, AccountOverrides{.balance = 1, .nonce = 2, .code = code, .state = std::map<evmc::bytes32, evmc::bytes32>{}}}});
+        const auto account{overlay.read_account(other_address)};
+        REQUIRE(account);
+        CHECK(account->balance == 1);
+        CHECK(account->nonce == 2);
+        CHECK(overlay.read_code(account->code_hash) == silkworm::ByteView{code});
+        CHECK(overlay.read_storage(other_address, account->incarnation, CountingState::kLocation) == evmc::bytes32{});
+        CHECK(state.account_reads == 0);
+        CHECK(state.code_reads == 0);
+        CHECK(state.storage_reads == 0);
+    }
+
+    SECTION("patches the storage") {
+        overlay.apply({{CountingState::kAccountAddress, AccountOverrides{.state_diff = {{other_location, new_value}}}}});
+        CHECK(overlay.read_storage(CountingState::kAccountAddress, 2, other_location) == new_value);
+        CHECK(state.storage_reads == 0);
+        CHECK(overlay.read_storage(CountingState::kAccountAddress, 2, CountingState::kLocation) == CountingState::kValue);
+        CHECK(state.storage_reads == 1);
+    }
+
+    SECTION("replaces the storage") {
+        CHECK(overlay.read_storage(CountingState::kAccountAddress, 2, CountingState::kLocation) == CountingState::kValue);
+        overlay.apply({{CountingState::kAccountAddress, AccountOverrides{.state = std::map<evmc::bytes32, evmc::bytes32>{{other_location, new_value}}}}});
+        CHECK(overlay.read_storage(CountingState::kAccountAddress, 2, CountingState::kLocation) == evmc::bytes32{});
+        CHECK(overlay.read_storage(CountingState::kAccountAddress, 2, other_location) == new_value);
+        CHECK(state.storage_reads == 1);
+    }
+
+    SECTION("replaces the account already read") {
+        CHECK(overlay.read_account(CountingState::kAccountAddress)->nonce == 7);
+        overlay.apply({{CountingState::kAccountAddress, AccountOverrides{.nonce = 8}}});
+        CHECK(overlay.read_account(CountingState::kAccountAddress)->nonce == 8);
+        CHECK(overlay.read_account(CountingState::kAccountAddress)->balance == 100);
+    }
+}
+
+TEST_CASE("OverlayState with checkpoints", "[silkrpc][core][overlay_state]") {
+    const auto other_address{0x0715a7794a1dc8e42615f059dd6e406a6594651a_address};
+    const auto new_value{0x00000000000000000000000000000000000000000000000000000000000000ff_bytes32};
+    const silkworm::Account account{.nonce = 7, .balance = 100, .code_hash = CountingState::kCodeHash, .incarnation = 2};
+    CountingState state;
+
+    SECTION("records just the changed state") {
+        OverlayState overlay{state};
+        overlay.update_account(CountingState::kAccountAddress, account, account);
+        StateCheckpoint checkpoint;
+        overlay.set_checkpoint_recorder(&checkpoint);
+        overlay.update_account(CountingState::kAccountAddress, account, account);
+        overlay.update_storage(CountingState::kAccountAddress, 2, CountingState::kLocation, CountingState::kValue, CountingState::kValue);
+        CHECK(checkpoint.accounts.empty());
+        CHECK(checkpoint.storage.empty());
+
+        overlay.update_account(other_address, std::nullopt, silkworm::Account{.nonce = 1, .incarnation = 1});
+        overlay.update_account_code(other_address, 1, CountingState::kCodeHash, state.code);
+        overlay.update_storage(other_address, 1, CountingState::kLocation, evmc::bytes32{}, new_value);
+        overlay.update_account(CountingState::kAccountAddress, account, std::nullopt);
+        overlay.set_checkpoint_recorder(nullptr);
+        overlay.update_storage(other_address, 1, CountingState::kLocation, new_value, evmc::bytes32{});
+
+        CHECK(checkpoint.accounts.size() == 2);
+        CHECK(checkpoint.accounts.at(other_address)->nonce == 1);
+        CHECK(!checkpoint.accounts.at(CountingState::kAccountAddress));
+        CHECK(checkpoint.code.at(CountingState::kCodeHash) == state.code);
+        CHECK(checkpoint.storage.size() == 1);
+        CHECK(checkpoint.incarnations.at(CountingState::kAccountAddress) == 2);
+    }
+
+    SECTION("applies the checkpoint over the state read") {
+        StateCheckpoint checkpoint;
+        checkpoint.accounts.emplace(CountingState::kAccountAddress, std::nullopt);
+        checkpoint.accounts.emplace(other_address, silkworm::Account{.nonce = 1, .incarnation = 1});
+        checkpoint.storage.emplace(StateCheckpoint::StorageKey{other_address, 1, CountingState::kLocation}, new_value);
+        checkpoint.incarnations.emplace(CountingState::kAccountAddress, 2);
+
+        OverlayState overlay{state};
+        CHECK(overlay.read_account(CountingState::kAccountAddress));
+        overlay.apply(checkpoint);
+        CHECK(!overlay.read_account(CountingState::kAccountAddress));
+        CHECK(overlay.read_account(other_address)->nonce == 1);
+        CHECK(overlay.read_storage(other_address, 1, CountingState::kLocation) == new_value);
+        CHECK(overlay.previous_incarnation(CountingState::kAccountAddress) == 2);
+        CHECK(overlay.previous_incarnation(other_address) == 0);
+        CHECK(state.account_reads == 1);
+        CHECK(state.storage_reads == 0);
+    }
+}
+
+} // namespace silkrpc::state
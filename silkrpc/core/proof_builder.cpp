@@ -0,0 +1,666 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "proof_builder.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+#include <boost/endian/conversion.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/db/util.hpp>
+#include <silkworm/rlp/encode.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/ethdb/tables.hpp>
+
+namespace silkrpc::core {
+
+namespace {
+
+//! The number of nibbles of the hashed keys
+constexpr std::size_t kKeyNibbles{2 * silkworm::kHashLength};
+
+bool starts_with(silkworm::ByteView bytes, silkworm::ByteView prefix) {
+    return bytes.substr(0, prefix.size()) == prefix;
+}
+
+bool is_nibble_path(silkworm::ByteView path) {
+    return path.size() < kKeyNibbles && std::all_of(path.begin(), path.end(), [](uint8_t nibble) { return nibble < 16; });
+}
+
+silkworm::Bytes unpack_key(silkworm::ByteView key) {
+    silkworm::Bytes nibbles(2 * key.size(), '\0');
+    for (std::size_t i{0}; i < key.size(); ++i) {
+        nibbles[2 * i] = key[i] >> 4;
+        nibbles[2 * i + 1] = key[i] & 0x0f;
+    }
+    return nibbles;
+}
+
+//! Return the lowest hashed key starting with the nibbles
+evmc::bytes32 lower_bound_key(silkworm::ByteView nibbles) {
+    evmc::bytes32 key{};
+    for (std::size_t i{0}; i < nibbles.size() && i < kKeyNibbles; ++i) {
+        key.bytes[i / 2] |= i % 2 == 0 ? nibbles[i] << 4 : nibbles[i];
+    }
+    return key;
+}
+
+//! Make the key the next one, returning false if it was the last one
+bool increment(evmc::bytes32& key) {
+    for (std::size_t i{silkworm::kHashLength}; i > 0; --i) {
+        if (++key.bytes[i - 1] != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+evmc::bytes32 keccak(silkworm::ByteView bytes) {
+    const auto hash{silkworm::keccak256(bytes)};
+    evmc::bytes32 hash_bytes;
+    std::memcpy(hash_bytes.bytes, hash.bytes, sizeof(hash_bytes.bytes));
+    return hash_bytes;
+}
+
+silkworm::Bytes hash_reference(const evmc::bytes32& hash) {
+    silkworm::Bytes reference;
+    silkworm::rlp::encode(reference, silkworm::ByteView{hash.bytes, sizeof(hash.bytes)});
+    return reference;
+}
+
+silkworm::Bytes encode_list(silkworm::ByteView payload) {
+    silkworm::Bytes encoded;
+    silkworm::rlp::encode_header(encoded, silkworm::rlp::Header{/*list=*/true, payload.size()});
+    encoded.append(payload);
+    return encoded;
+}
+
+//! Check that the node at the path has the hash held by its parent, if any
+void check_node_hash(const std::optional<evmc::bytes32>& expected_hash, silkworm::ByteView encoded_node, silkworm::ByteView path) {
+    if (expected_hash && keccak(encoded_node) != *expected_hash) {
+        throw std::runtime_error{"inconsistent trie node at path 0x" + silkworm::to_hex(path)};
+    }
+}
+
+//! Check that the leaves below the node at the path have not been truncated
+void check_unstored_leaves(const std::vector<TrieLeaf>& leaves, silkworm::ByteView path) {
+    if (leaves.size() >= ProofBuilder::kMaxUnstoredLeaves) {
+        throw std::runtime_error{"too many leaves below unstored trie node at path 0x" + silkworm::to_hex(path)};
+    }
+}
+
+//! The walk of one target path down the trie
+struct PathWalk {
+    silkworm::ByteView target;
+    ProofNodes* proof{nullptr};
+    //! The nibble path of the child whose stored node (or the extension leading to it) comes next
+    silkworm::Bytes seek;
+    //! The hash of that child held by its parent, if any
+    std::optional<evmc::bytes32> expected_hash;
+    bool done{false};
+};
+
+//! The stored node reached by some path walks
+struct NodeVisit {
+    silkworm::Bytes path;
+    TrieNode node;
+    std::vector<PathWalk*> walks;
+    //! The index of the leaves collected below each child, if any
+    std::array<std::optional<std::size_t>, 16> leaves;
+};
+
+} // namespace
+
+const evmc::bytes32& TrieNode::child_hash(uint8_t nibble) const {
+    const auto lower_children = static_cast<uint16_t>(hash_mask & ((1u << nibble) - 1));
+    return hashes.at(static_cast<std::size_t>(std::popcount(lower_children)));
+}
+
+std::optional<TrieNode> decode_trie_node(silkworm::ByteView encoded) {
+    constexpr std::size_t kMasksSize{3 * sizeof(uint16_t)};
+    if (encoded.size() < kMasksSize || (encoded.size() - kMasksSize) % silkworm::kHashLength != 0) {
+        return std::nullopt;
+    }
+    TrieNode node;
+    node.state_mask = boost::endian::load_big_u16(&encoded[0]);
+    node.tree_mask = boost::endian::load_big_u16(&encoded[2]);
+    node.hash_mask = boost::endian::load_big_u16(&encoded[4]);
+    if ((node.tree_mask & ~node.state_mask) != 0 || (node.hash_mask & ~node.state_mask) != 0) {
+        return std::nullopt;
+    }
+    encoded.remove_prefix(kMasksSize);
+
+    const auto num_hashes = static_cast<std::size_t>(std::popcount(node.hash_mask));
+    const auto num_stored_hashes = encoded.size() / silkworm::kHashLength;
+    if (num_stored_hashes == num_hashes + 1) {
+        node.root_hash = silkworm::to_bytes32(encoded.substr(0, silkworm::kHashLength));
+        encoded.remove_prefix(silkworm::kHashLength);
+    } else if (num_stored_hashes != num_hashes) {
+        return std::nullopt;
+    }
+    node.hashes.reserve(num_hashes);
+    for (std::size_t i{0}; i < num_hashes; ++i) {
+        node.hashes.push_back(silkworm::to_bytes32(encoded.substr(i * silkworm::kHashLength, silkworm::kHashLength)));
+    }
+    return node;
+}
+
+silkworm::Bytes encode_path(silkworm::ByteView nibbles, bool leaf) {
+    const bool odd = nibbles.size() % 2 != 0;
+    silkworm::Bytes path;
+    path.reserve(nibbles.size() / 2 + 1);
+    const uint8_t flags = (leaf ? 0x20 : 0x00) | (odd ? 0x10 : 0x00);
+    if (odd) {
+        path.push_back(flags | nibbles[0]);
+        nibbles.remove_prefix(1);
+    } else {
+        path.push_back(flags);
+    }
+    for (std::size_t i{0}; i < nibbles.size(); i += 2) {
+        path.push_back(static_cast<uint8_t>(nibbles[i] << 4 | nibbles[i + 1]));
+    }
+    return path;
+}
+
+silkworm::Bytes encode_leaf_node(silkworm::ByteView path, silkworm::ByteView value) {
+    silkworm::Bytes payload;
+    silkworm::rlp::encode(payload, encode_path(path, /*leaf=*/true));
+    silkworm::rlp::encode(payload, value);
+    return encode_list(payload);
+}
+
+silkworm::Bytes encode_extension_node(silkworm::ByteView path, silkworm::ByteView child_reference) {
+    silkworm::Bytes payload;
+    silkworm::rlp::encode(payload, encode_path(path, /*leaf=*/false));
+    payload.append(child_reference);
+    return encode_list(payload);
+}
+
+silkworm::Bytes encode_branch_node(const std::array<silkworm::Bytes, 16>& child_references) {
+    constexpr uint8_t kEmptyString{0x80};
+    silkworm::Bytes payload;
+    for (const auto& reference : child_references) {
+        if (reference.empty()) {
+            payload.push_back(kEmptyString);
+        } else {
+            payload.append(reference);
+        }
+    }
+    payload.push_back(kEmptyString); // no value, all the keys have the same length
+    return encode_list(payload);
+}
+
+silkworm::Bytes node_reference(silkworm::ByteView encoded_node) {
+    if (encoded_node.size() < silkworm::kHashLength) {
+        return silkworm::Bytes{encoded_node};
+    }
+    return hash_reference(keccak(encoded_node));
+}
+
+silkworm::Bytes encode_subtrie(const TrieLeaf* first, const TrieLeaf* last, std::size_t depth, silkworm::ByteView target, ProofNodes* proof) {
+    const bool on_path = proof != nullptr && starts_with(target, silkworm::ByteView{first->nibbles}.substr(0, depth));
+    const auto proof_position = on_path ? proof->size() : 0;
+    if (on_path) {
+        proof->emplace_back(); // the node comes before those below it, filled once encoded
+    }
+
+    silkworm::Bytes encoded;
+    const silkworm::ByteView first_nibbles{first->nibbles};
+    if (last - first == 1) {
+        encoded = encode_leaf_node(first_nibbles.substr(depth), first->value);
+    } else {
+        // The leaves are sorted, so the common prefix of the first and last ones is shared by all of them
+        const silkworm::ByteView last_nibbles{(last - 1)->nibbles};
+        std::size_t common_length{0};
+        while (depth + common_length < kKeyNibbles && first_nibbles[depth + common_length] == last_nibbles[depth + common_length]) {
+            ++common_length;
+        }
+        if (common_length > 0) {
+            const auto child = encode_subtrie(first, last, depth + common_length, target, on_path ? proof : nullptr);
+            encoded = encode_extension_node(first_nibbles.substr(depth, common_length), node_reference(child));
+        } else {
+            std::array<silkworm::Bytes, 16> child_references;
+            for (auto child_first{first}; child_first != last;) {
+                const auto nibble = child_first->nibbles[depth];
+                const auto child_last = std::find_if(child_first, last, [&](const auto& leaf) { return leaf.nibbles[depth] != nibble; });
+                const auto child = encode_subtrie(child_first, child_last, depth + 1, target, on_path ? proof : nullptr);
+                child_references[nibble] = node_reference(child);
+                child_first = child_last;
+            }
+            encoded = encode_branch_node(child_references);
+        }
+    }
+
+    if (on_path) {
+        if (encoded.size() >= silkworm::kHashLength || depth == 0) {
+            (*proof)[proof_position] = encoded;
+        } else {
+            proof->erase(proof->begin() + static_cast<std::ptrdiff_t>(proof_position)); // embedded in the parent
+        }
+    }
+    return encoded;
+}
+
+boost::asio::awaitable<AccountProof> ProofBuilder::build_proof(const evmc::address& address, const std::vector<evmc::bytes32>& locations) {
+    AccountProof proof;
+    proof.address = address;
+    proof.code_hash = silkworm::kEmptyHash;
+    proof.storage_hash = silkworm::kEmptyRoot;
+
+    const auto hashed_address{keccak(silkworm::ByteView{address.bytes, sizeof(address.bytes)})};
+    const silkworm::Bytes hashed_address_key{silkworm::ByteView{hashed_address.bytes, sizeof(hashed_address.bytes)}};
+    const auto accounts_cursor = co_await transaction_.cursor(db::table::kHashedAccounts);
+    const auto account_kv = co_await accounts_cursor->seek_exact(hashed_address_key);
+
+    std::optional<StoredAccount> stored_account;
+    if (!account_kv.value.empty()) {
+        const std::vector<KeyValue> hashed_accounts{KeyValue{hashed_address_key, account_kv.value}};
+        const auto stored_accounts{co_await read_accounts(hashed_accounts)};
+        stored_account = stored_accounts.front();
+        proof.balance = stored_account->account.balance;
+        proof.code_hash = stored_account->account.code_hash;
+        proof.nonce = stored_account->account.nonce;
+        proof.storage_hash = stored_account->storage_root;
+    }
+
+    proof.storage_proofs.resize(locations.size());
+    if (stored_account && stored_account->account.incarnation > 0 && !locations.empty()) {
+        const auto storage_prefix{silkworm::db::storage_prefix(hashed_address_key, stored_account->account.incarnation)};
+        std::vector<silkworm::Bytes> hashed_locations;
+        std::vector<silkworm::Bytes> targets;
+        for (const auto& location : locations) {
+            const auto hashed_location{keccak(silkworm::ByteView{location.bytes, sizeof(location.bytes)})};
+            hashed_locations.emplace_back(hashed_location.bytes, sizeof(hashed_location.bytes));
+            targets.push_back(unpack_key(hashed_locations.back()));
+        }
+
+        const auto storage_cursor = co_await transaction_.cursor_dup_sort(db::table::kHashedStorage);
+        const std::vector<silkworm::Bytes> storage_keys(locations.size(), storage_prefix);
+        const auto storage_values = co_await storage_cursor->seek_both_many(storage_keys, hashed_locations);
+        for (std::size_t i{0}; i < locations.size(); ++i) {
+            if (starts_with(storage_values[i], hashed_locations[i])) {
+                proof.storage_proofs[i].value = storage_values[i].substr(silkworm::kHashLength);
+            }
+        }
+
+        std::vector<ProofNodes> storage_proofs;
+        const TrieTables storage_tables{db::table::kTrieOfStorage, storage_prefix, /*storage=*/true};
+        proof.storage_hash = co_await prove(storage_tables, targets, storage_proofs);
+        for (std::size_t i{0}; i < locations.size(); ++i) {
+            proof.storage_proofs[i].proof = std::move(storage_proofs[i]);
+        }
+    }
+    for (std::size_t i{0}; i < locations.size(); ++i) {
+        proof.storage_proofs[i].key = locations[i];
+    }
+
+    const std::vector<silkworm::Bytes> account_targets{unpack_key(hashed_address_key)};
+    std::vector<ProofNodes> account_proofs;
+    const TrieTables account_tables{db::table::kTrieOfAccounts, {}, /*storage=*/false};
+    state_root_ = co_await prove(account_tables, account_targets, account_proofs);
+    proof.account_proof = std::move(account_proofs.front());
+
+    SILKRPC_DEBUG << "ProofBuilder::build_proof " << proof << " state_root: 0x" << state_root_ << "\n";
+    co_return proof;
+}
+
+boost::asio::awaitable<evmc::bytes32> ProofBuilder::prove(const TrieTables& tables, const std::vector<silkworm::Bytes>& targets,
+                                                          std::vector<ProofNodes>& proofs) {
+    proofs.assign(targets.size(), ProofNodes{});
+    std::vector<PathWalk> walks(targets.size());
+    for (std::size_t i{0}; i < targets.size(); ++i) {
+        walks[i].target = targets[i];
+        walks[i].proof = &proofs[i];
+    }
+
+    std::optional<evmc::bytes32> root_hash;
+    for (bool at_root{true};; at_root = false) {
+        // Read the stored node coming next along each path, just once for all the paths going through it
+        std::map<silkworm::Bytes, std::vector<PathWalk*>> walks_by_seek;
+        for (auto& walk : walks) {
+            if (!walk.done) {
+                walks_by_seek[walk.seek].push_back(&walk);
+            }
+        }
+        if (walks_by_seek.empty()) {
+            if (!at_root) {
+                break;
+            }
+            walks_by_seek[silkworm::Bytes{}]; // the root hash is needed anyway
+        }
+        std::vector<silkworm::Bytes> node_keys;
+        node_keys.reserve(walks_by_seek.size());
+        for (const auto& [seek, _] : walks_by_seek) {
+            node_keys.push_back(tables.node_prefix + seek);
+        }
+        const auto records = co_await seek_nodes(tables.node_table, node_keys);
+
+        std::vector<NodeVisit> visits;
+        visits.reserve(walks_by_seek.size());
+        std::size_t record_index{0};
+        for (auto& [seek, seek_walks] : walks_by_seek) {
+            const auto& record = records[record_index];
+            const auto& node_key = node_keys[record_index];
+            ++record_index;
+            const bool found = !record.value.empty() && starts_with(record.key, node_key);
+            if (at_root && (!found || record.key.size() != node_key.size())) {
+                // The root is not stored (it is not a branch node or there is no branch node below it), the trie is small
+                co_return co_await prove_from_leaves(tables, targets, proofs);
+            }
+            const silkworm::ByteView path{silkworm::ByteView{record.key}.substr(tables.node_prefix.size())};
+            auto node = found ? decode_trie_node(record.value) : std::nullopt;
+            if (!found || !node || !is_nibble_path(path)) {
+                throw std::runtime_error{"missing or invalid trie node at path 0x" + silkworm::to_hex(node_key)};
+            }
+            visits.push_back(NodeVisit{silkworm::Bytes{path}, std::move(*node), seek_walks, {}});
+        }
+
+        // Collect the leaves of the children whose hash is not stored and those of the unstored children along the paths
+        std::vector<silkworm::Bytes> leaf_prefixes;
+        std::vector<std::size_t> max_leaves;
+        for (auto& visit : visits) {
+            const auto depth = visit.path.size();
+            for (uint8_t nibble{0}; nibble < 16; ++nibble) {
+                if (!TrieNode::has(visit.node.state_mask, nibble)) {
+                    continue;
+                }
+                const bool hashed = TrieNode::has(visit.node.hash_mask, nibble);
+                const bool tree = TrieNode::has(visit.node.tree_mask, nibble);
+                const bool on_path = std::any_of(visit.walks.begin(), visit.walks.end(), [&](const auto* walk) {
+                    return starts_with(walk->target, visit.path) && walk->target[depth] == nibble;
+                });
+                std::size_t max_child_leaves{0};
+                if (!hashed) {
+                    max_child_leaves = tree ? kMaxUnstoredLeaves : 1; // the children w/o hash nor stored node are leaves
+                } else if (on_path && !tree) {
+                    max_child_leaves = kMaxUnstoredLeaves;
+                }
+                if (max_child_leaves > 0) {
+                    visit.leaves[nibble] = leaf_prefixes.size();
+                    leaf_prefixes.push_back(visit.path);
+                    leaf_prefixes.back().push_back(nibble);
+                    max_leaves.push_back(max_child_leaves);
+                }
+            }
+        }
+        const auto leaves = co_await collect_leaves(tables, leaf_prefixes, max_leaves);
+
+        for (auto& visit : visits) {
+            const auto depth = visit.path.size();
+            const auto& node = visit.node;
+            const auto child_leaves = [&](uint8_t nibble) -> const std::vector<TrieLeaf>& {
+                const auto& collected = leaves[*visit.leaves[nibble]];
+                if (collected.empty()) {
+                    throw std::runtime_error{"missing trie leaf at path 0x" + silkworm::to_hex(leaf_prefixes[*visit.leaves[nibble]])};
+                }
+                if (max_leaves[*visit.leaves[nibble]] > 1) {
+                    check_unstored_leaves(collected, leaf_prefixes[*visit.leaves[nibble]]);
+                }
+                return collected;
+            };
+
+            std::array<silkworm::Bytes, 16> child_references;
+            for (uint8_t nibble{0}; nibble < 16; ++nibble) {
+                if (!TrieNode::has(node.state_mask, nibble)) {
+                    continue;
+                }
+                if (TrieNode::has(node.hash_mask, nibble)) {
+                    child_references[nibble] = hash_reference(node.child_hash(nibble));
+                } else {
+                    const auto& collected = child_leaves(nibble);
+                    child_references[nibble] = node_reference(encode_subtrie(collected.data(), collected.data() + collected.size(), depth + 1));
+                }
+            }
+            const auto encoded = encode_branch_node(child_references);
+            const auto hash = keccak(encoded);
+            if (at_root) {
+                if (node.root_hash && *node.root_hash != hash) {
+                    throw std::runtime_error{"inconsistent trie root 0x" + silkworm::to_hex(*node.root_hash)};
+                }
+                root_hash = hash;
+            }
+
+            for (auto* walk : visit.walks) {
+                if (depth > walk->seek.size()) {
+                    // The stored node is reached through an extension, which the target path may leave
+                    const auto extension = encode_extension_node(silkworm::ByteView{visit.path}.substr(walk->seek.size()), hash_reference(hash));
+                    check_node_hash(walk->expected_hash, extension, walk->seek);
+                    walk->proof->push_back(extension);
+                    if (!starts_with(walk->target, visit.path)) {
+                        walk->done = true;
+                        continue;
+                    }
+                } else {
+                    check_node_hash(walk->expected_hash, encoded, walk->seek);
+                }
+                walk->proof->push_back(encoded);
+
+                const auto nibble = walk->target[depth];
+                if (!TrieNode::has(node.state_mask, nibble)) {
+                    walk->done = true;
+                } else if (TrieNode::has(node.tree_mask, nibble)) {
+                    walk->seek = visit.path;
+                    walk->seek.push_back(nibble);
+                    walk->expected_hash = TrieNode::has(node.hash_mask, nibble) ? std::make_optional(node.child_hash(nibble)) : std::nullopt;
+                } else {
+                    const auto& collected = child_leaves(nibble);
+                    const auto child = encode_subtrie(collected.data(), collected.data() + collected.size(), depth + 1, walk->target, walk->proof);
+                    if (TrieNode::has(node.hash_mask, nibble)) {
+                        check_node_hash(node.child_hash(nibble), child, leaf_prefixes[*visit.leaves[nibble]]);
+                    }
+                    walk->done = true;
+                }
+            }
+        }
+    }
+    co_return *root_hash;
+}
+
+boost::asio::awaitable<evmc::bytes32> ProofBuilder::prove_from_leaves(const TrieTables& tables, const std::vector<silkworm::Bytes>& targets,
+                                                                      std::vector<ProofNodes>& proofs) {
+    const std::vector<silkworm::Bytes> prefixes{silkworm::Bytes{}};
+    const std::vector<std::size_t> max_leaves{kMaxUnstoredLeaves};
+    const auto all_leaves = co_await collect_leaves(tables, prefixes, max_leaves);
+    const auto& leaves = all_leaves.front();
+    check_unstored_leaves(leaves, {});
+
+    proofs.assign(targets.size(), ProofNodes{});
+    if (leaves.empty()) {
+        co_return silkworm::kEmptyRoot;
+    }
+    const auto first{leaves.data()};
+    const auto last{leaves.data() + leaves.size()};
+    for (std::size_t i{0}; i < targets.size(); ++i) {
+        encode_subtrie(first, last, 0, targets[i], &proofs[i]);
+    }
+    co_return keccak(encode_subtrie(first, last, 0));
+}
+
+boost::asio::awaitable<std::vector<std::vector<TrieLeaf>>> ProofBuilder::collect_leaves(const TrieTables& tables,
+    const std::vector<silkworm::Bytes>& prefixes, const std::vector<std::size_t>& max_leaves) {
+    std::vector<std::vector<TrieLeaf>> leaves(prefixes.size());
+    std::vector<evmc::bytes32> seek_keys(prefixes.size());
+    std::vector<std::size_t> pending;
+    for (std::size_t i{0}; i < prefixes.size(); ++i) {
+        if (max_leaves[i] > 0) {
+            seek_keys[i] = lower_bound_key(prefixes[i]);
+            pending.push_back(i);
+        }
+    }
+
+    // Read the next leaf under all the pending prefixes at once, until each one is exhausted or has enough leaves
+    while (!pending.empty()) {
+        std::vector<evmc::bytes32> keys;
+        keys.reserve(pending.size());
+        for (const auto i : pending) {
+            keys.push_back(seek_keys[i]);
+        }
+        auto found_leaves = co_await seek_leaves(tables, keys);
+
+        std::vector<std::size_t> still_pending;
+        for (std::size_t j{0}; j < pending.size(); ++j) {
+            const auto i = pending[j];
+            auto& leaf = found_leaves[j];
+            if (!leaf || !starts_with(leaf->nibbles, prefixes[i])) {
+                continue;
+            }
+            seek_keys[i] = lower_bound_key(leaf->nibbles);
+            leaves[i].push_back(std::move(*leaf));
+            if (leaves[i].size() < max_leaves[i] && increment(seek_keys[i])) {
+                still_pending.push_back(i);
+            }
+        }
+        pending.swap(still_pending);
+    }
+    co_return leaves;
+}
+
+boost::asio::awaitable<std::vector<std::optional<TrieLeaf>>> ProofBuilder::seek_leaves(const TrieTables& tables, const std::vector<evmc::bytes32>& keys) {
+    std::vector<std::optional<TrieLeaf>> leaves(keys.size());
+    std::vector<silkworm::Bytes> seek_keys;
+    seek_keys.reserve(keys.size());
+    for (const auto& key : keys) {
+        seek_keys.emplace_back(key.bytes, sizeof(key.bytes));
+    }
+
+    if (tables.storage) {
+        // The storage locations are the subkeys of the account storage prefix
+        const auto cursor = co_await transaction_.cursor_dup_sort(db::table::kHashedStorage);
+        const std::vector<silkworm::Bytes> storage_keys(keys.size(), tables.node_prefix);
+        const auto values = co_await cursor->seek_both_many(storage_keys, seek_keys);
+        for (std::size_t i{0}; i < values.size(); ++i) {
+            if (values[i].size() > silkworm::kHashLength) {
+                silkworm::Bytes encoded_value;
+                silkworm::rlp::encode(encoded_value, silkworm::ByteView{values[i]}.substr(silkworm::kHashLength));
+                leaves[i] = TrieLeaf{unpack_key(silkworm::ByteView{values[i]}.substr(0, silkworm::kHashLength)), std::move(encoded_value)};
+            }
+        }
+        co_return leaves;
+    }
+
+    const auto cursor = co_await transaction_.cursor(db::table::kHashedAccounts);
+    const auto kv_pairs = co_await cursor->seek_many(seek_keys);
+    std::vector<KeyValue> hashed_accounts;
+    std::vector<std::size_t> account_indexes;
+    for (std::size_t i{0}; i < kv_pairs.size(); ++i) {
+        if (kv_pairs[i].key.size() == silkworm::kHashLength && !kv_pairs[i].value.empty()) {
+            hashed_accounts.push_back(kv_pairs[i]);
+            account_indexes.push_back(i);
+        }
+    }
+    const auto stored_accounts = co_await read_accounts(hashed_accounts);
+    for (std::size_t j{0}; j < stored_accounts.size(); ++j) {
+        const auto& [account, storage_root] = stored_accounts[j];
+        leaves[account_indexes[j]] = TrieLeaf{unpack_key(hashed_accounts[j].key), account.rlp(storage_root)};
+    }
+    co_return leaves;
+}
+
+boost::asio::awaitable<std::vector<ProofBuilder::StoredAccount>> ProofBuilder::read_accounts(const std::vector<KeyValue>& hashed_accounts) {
+    std::vector<StoredAccount> stored_accounts;
+    stored_accounts.reserve(hashed_accounts.size());
+    std::vector<std::size_t> contract_indexes;
+    std::vector<silkworm::Bytes> storage_prefixes;
+    for (const auto& kv : hashed_accounts) {
+        auto [account, err]{silkworm::Account::from_encoded_storage(kv.value)};
+        silkworm::rlp::success_or_throw(err);
+        if (account.incarnation > 0) {
+            contract_indexes.push_back(stored_accounts.size());
+            storage_prefixes.push_back(silkworm::db::storage_prefix(kv.key, account.incarnation));
+        }
+        stored_accounts.push_back(StoredAccount{account, silkworm::kEmptyRoot});
+    }
+    if (contract_indexes.empty()) {
+        co_return stored_accounts;
+    }
+
+    // The code hash may be stored apart from the contract account
+    std::vector<silkworm::Bytes> code_hash_keys;
+    std::vector<std::size_t> code_hash_indexes;
+    for (std::size_t j{0}; j < contract_indexes.size(); ++j) {
+        if (stored_accounts[contract_indexes[j]].account.code_hash == silkworm::kEmptyHash) {
+            code_hash_keys.push_back(storage_prefixes[j]);
+            code_hash_indexes.push_back(contract_indexes[j]);
+        }
+    }
+    if (!code_hash_keys.empty()) {
+        const auto cursor = co_await transaction_.cursor(db::table::kContractCode);
+        const auto code_hashes = co_await cursor->seek_exact_many(code_hash_keys);
+        for (std::size_t j{0}; j < code_hashes.size(); ++j) {
+            if (code_hashes[j].value.size() == silkworm::kHashLength) {
+                stored_accounts[code_hash_indexes[j]].account.code_hash = silkworm::to_bytes32(code_hashes[j].value);
+            }
+        }
+    }
+
+    // The storage root is stored in the storage trie root node, unless the storage trie is small enough to be recomputed
+    const auto root_records = co_await seek_nodes(db::table::kTrieOfStorage, storage_prefixes);
+    for (std::size_t j{0}; j < contract_indexes.size(); ++j) {
+        auto& storage_root = stored_accounts[contract_indexes[j]].storage_root;
+        if (root_records[j].key == storage_prefixes[j]) {
+            const auto root_node = decode_trie_node(root_records[j].value);
+            if (root_node && root_node->root_hash) {
+                storage_root = *root_node->root_hash;
+                continue;
+            }
+        }
+        const TrieTables storage_tables{db::table::kTrieOfStorage, storage_prefixes[j], /*storage=*/true};
+        const std::vector<silkworm::Bytes> no_targets;
+        std::vector<ProofNodes> no_proofs;
+        storage_root = co_await prove_from_leaves(storage_tables, no_targets, no_proofs);
+    }
+    co_return stored_accounts;
+}
+
+boost::asio::awaitable<std::vector<KeyValue>> ProofBuilder::seek_nodes(const std::string& table, const std::vector<silkworm::Bytes>& keys) {
+    const auto view_id = transaction_.tx_id();
+    std::vector<KeyValue> records(keys.size());
+    std::vector<silkworm::Bytes> missing_keys;
+    std::vector<std::size_t> missing_indexes;
+    for (std::size_t i{0}; i < keys.size(); ++i) {
+        if (trie_node_cache_) {
+            if (const auto cached_record = trie_node_cache_->find(view_id, table, keys[i])) {
+                records[i] = *cached_record;
+                continue;
+            }
+        }
+        missing_keys.push_back(keys[i]);
+        missing_indexes.push_back(i);
+    }
+    if (missing_keys.empty()) {
+        co_return records;
+    }
+
+    const auto cursor = co_await transaction_.cursor(table);
+    auto found_records = co_await cursor->seek_many(missing_keys);
+    for (std::size_t j{0}; j < found_records.size(); ++j) {
+        if (trie_node_cache_) {
+            trie_node_cache_->store(view_id, table, missing_keys[j], found_records[j]);
+        }
+        records[missing_indexes[j]] = std::move(found_records[j]);
+    }
+    SILKRPC_DEBUG << "ProofBuilder::seek_nodes table: " << table << " keys: " << keys.size() << " read: " << missing_keys.size() << "\n";
+    co_return records;
+}
+
+} // namespace silkrpc::core
@@ -0,0 +1,154 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_CORE_PROOF_BUILDER_HPP_
+#define SILKRPC_CORE_PROOF_BUILDER_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <evmc/evmc.hpp>
+#include <silkworm/common/base.hpp>
+#include <silkworm/types/account.hpp>
+
+#include <silkrpc/common/trie_node_cache.hpp>
+#include <silkrpc/common/util.hpp>
+#include <silkrpc/ethdb/transaction.hpp>
+#include <silkrpc/types/account_proof.hpp>
+
+namespace silkrpc::core {
+
+//! The intermediate node stored by Erigon in the trie tables at its nibble path: a branch node along with the masks of its
+//! children and the hashes of those being branch or extension nodes, whilst the leaves are recomputed from the hashed state
+struct TrieNode {
+    //! The existing children
+    uint16_t state_mask{0};
+    //! The children having some node stored in the trie table, i.e. the child itself or some node below an extension
+    uint16_t tree_mask{0};
+    //! The children whose hash is stored
+    uint16_t hash_mask{0};
+    //! The hashes of the children in hash_mask, in ascending order of nibble
+    std::vector<evmc::bytes32> hashes;
+    //! The trie root hash, stored just in the root node
+    std::optional<evmc::bytes32> root_hash;
+
+    static bool has(uint16_t mask, uint8_t nibble) noexcept { return (mask & (1u << nibble)) != 0; }
+
+    //! Return the hash of the child, which must be in hash_mask
+    const evmc::bytes32& child_hash(uint8_t nibble) const;
+};
+
+//! Decode the trie node as stored in the trie tables, returning nothing if malformed
+std::optional<TrieNode> decode_trie_node(silkworm::ByteView encoded);
+
+//! One leaf of the trie, i.e. the unpacked nibbles of its hashed key and the value it holds
+struct TrieLeaf {
+    silkworm::Bytes nibbles;
+    silkworm::Bytes value;
+};
+
+//! Encode the nibbles using the hex-prefix encoding of the leaf or extension paths
+silkworm::Bytes encode_path(silkworm::ByteView nibbles, bool leaf);
+
+silkworm::Bytes encode_leaf_node(silkworm::ByteView path, silkworm::ByteView value);
+
+silkworm::Bytes encode_extension_node(silkworm::ByteView path, silkworm::ByteView child_reference);
+
+//! Encode the branch node w/o value having the specified child references, empty for the missing children
+silkworm::Bytes encode_branch_node(const std::array<silkworm::Bytes, 16>& child_references);
+
+//! Return the reference to the encoded node held by its parent: the node itself if shorter than a hash, its hash otherwise
+silkworm::Bytes node_reference(silkworm::ByteView encoded_node);
+
+//! Encode the node at the depth whose subtrie holds the leaves, which must be sorted by key and share the first depth
+//! nibbles. If the proof is specified, append to it the nodes along the target path from this node down, excluding those
+//! embedded in their parent (i.e. the nodes shorter than a hash, but the root)
+silkworm::Bytes encode_subtrie(const TrieLeaf* first, const TrieLeaf* last, std::size_t depth, silkworm::ByteView target = {},
+                               ProofNodes* proof = nullptr);
+
+//! Builder of the Merkle proofs of the accounts and storage locations in the latest state, made of the trie nodes along
+//! the paths of their hashed keys: the nodes are encoded from the intermediate nodes in the trie tables and the leaves
+//! in the hashed state tables, reading together all the nodes and leaves at the same depth of all the paths in the trie
+//! by pipelined requests, so that the round trips needed grow with the depth of the trie rather than with the number of paths.
+//! The stored nodes read are shared with the proofs built concurrently on the same view through the trie node cache.
+class ProofBuilder {
+public:
+    //! The max number of leaves below a node not stored in the trie tables (i.e. the unstored subtries are expected to be small)
+    static constexpr std::size_t kMaxUnstoredLeaves{4096};
+
+    explicit ProofBuilder(ethdb::Transaction& transaction, TrieNodeCache* trie_node_cache = nullptr)
+    : transaction_(transaction), trie_node_cache_(trie_node_cache) {}
+
+    ProofBuilder(const ProofBuilder&) = delete;
+    ProofBuilder& operator=(const ProofBuilder&) = delete;
+
+    //! Build the proofs of the account and its storage locations, the second ones against the account storage root
+    boost::asio::awaitable<AccountProof> build_proof(const evmc::address& address, const std::vector<evmc::bytes32>& locations);
+
+    //! The state root the last account proof has been built against
+    const evmc::bytes32& state_root() const noexcept { return state_root_; }
+
+private:
+    //! The tables of one trie: the storage tries share the same tables, their keys start with the account storage prefix
+    struct TrieTables {
+        std::string node_table;
+        silkworm::Bytes node_prefix;
+        bool storage{false};
+    };
+
+    //! Build the proofs of the target paths, returning the trie root
+    boost::asio::awaitable<evmc::bytes32> prove(const TrieTables& tables, const std::vector<silkworm::Bytes>& targets,
+                                                std::vector<ProofNodes>& proofs);
+
+    //! Build the proofs of the target paths from the leaves, in case the trie root is not stored
+    boost::asio::awaitable<evmc::bytes32> prove_from_leaves(const TrieTables& tables, const std::vector<silkworm::Bytes>& targets,
+                                                            std::vector<ProofNodes>& proofs);
+
+    //! Collect in order the leaves under each nibble prefix, up to the max count of each one
+    boost::asio::awaitable<std::vector<std::vector<TrieLeaf>>> collect_leaves(const TrieTables& tables,
+        const std::vector<silkworm::Bytes>& prefixes, const std::vector<std::size_t>& max_leaves);
+
+    //! Return the first leaf at or after each hashed key in the same order, if any
+    boost::asio::awaitable<std::vector<std::optional<TrieLeaf>>> seek_leaves(const TrieTables& tables, const std::vector<evmc::bytes32>& keys);
+
+    //! The account read from the hashed state along with its storage root
+    struct StoredAccount {
+        silkworm::Account account;
+        evmc::bytes32 storage_root;
+    };
+
+    //! Decode the accounts read from the hashed state, completing them with their code hash and storage root
+    boost::asio::awaitable<std::vector<StoredAccount>> read_accounts(const std::vector<KeyValue>& hashed_accounts);
+
+    //! Return the first record at or after each key in the trie table in the same order, going through the trie node cache
+    boost::asio::awaitable<std::vector<KeyValue>> seek_nodes(const std::string& table, const std::vector<silkworm::Bytes>& keys);
+
+    ethdb::Transaction& transaction_;
+    TrieNodeCache* trie_node_cache_;
+    evmc::bytes32 state_root_{};
+};
+
+} // namespace silkrpc::core
+
+#endif  // SILKRPC_CORE_PROOF_BUILDER_HPP_
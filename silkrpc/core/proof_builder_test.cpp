@@ -0,0 +1,705 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "proof_builder.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/use_future.hpp>
+#include <boost/endian/conversion.hpp>
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/db/util.hpp>
+#include <silkworm/rlp/encode.hpp>
+#include <silkworm/types/account.hpp>
+
+#include <silkrpc/ethdb/tables.hpp>
+#include <silkrpc/ethdb/transaction.hpp>
+
+namespace silkrpc::core {
+
+using evmc::literals::operator""_address;
+using evmc::literals::operator""_bytes32;
+
+//! The database tables: each key holds its values in ascending order, just one value unless the table is dup-sorted
+using Tables = std::map<std::string, std::map<silkworm::Bytes, std::vector<silkworm::Bytes>>>;
+
+//! The batches of requests to each table, i.e. the round trips to the remote database
+using RoundTrips = std::map<std::string, std::size_t>;
+
+class TablesCursor : public ethdb::CursorDupSort {
+public:
+    TablesCursor(const std::string& table_name, Tables& tables, RoundTrips& round_trips)
+    : table_name_{table_name}, table_{tables[table_name]}, round_trips_{round_trips} {}
+
+    uint32_t cursor_id() const override { return 0; }
+
+    boost::asio::awaitable<void> open_cursor(const std::string& /*table_name*/, bool /*is_dup_sorted*/) override { co_return; }
+
+    boost::asio::awaitable<KeyValue> seek(silkworm::ByteView key) override {
+        const auto it = table_.lower_bound(silkworm::Bytes{key});
+        co_return it != table_.end() ? KeyValue{it->first, it->second.front()} : KeyValue{};
+    }
+
+    boost::asio::awaitable<KeyValue> seek_exact(silkworm::ByteView key) override {
+        const auto it = table_.find(silkworm::Bytes{key});
+        co_return it != table_.end() ? KeyValue{it->first, it->second.front()} : KeyValue{};
+    }
+
+    boost::asio::awaitable<std::vector<KeyValue>> seek_exact_many(const std::vector<silkworm::Bytes>& keys) override {
+        ++round_trips_[table_name_];
+        co_return co_await ethdb::CursorDupSort::seek_exact_many(keys);
+    }
+
+    boost::asio::awaitable<std::vector<KeyValue>> seek_many(const std::vector<silkworm::Bytes>& keys) override {
+        ++round_trips_[table_name_];
+        co_return co_await ethdb::CursorDupSort::seek_many(keys);
+    }
+
+    boost::asio::awaitable<KeyValue> next() override { co_return KeyValue{}; }
+
+    boost::asio::awaitable<KeyValue> next_dup() override { co_return KeyValue{}; }
+
+    boost::asio::awaitable<void> close_cursor() override { co_return; }
+
+    boost::asio::awaitable<silkworm::Bytes> seek_both(silkworm::ByteView key, silkworm::ByteView value) override {
+        const auto it = table_.find(silkworm::Bytes{key});
+        if (it == table_.end()) {
+            co_return silkworm::Bytes{};
+        }
+        const auto value_it = std::lower_bound(it->second.begin(), it->second.end(), silkworm::Bytes{value});
+        co_return value_it != it->second.end() ? *value_it : silkworm::Bytes{};
+    }
+
+    boost::asio::awaitable<KeyValue> seek_both_exact(silkworm::ByteView /*key*/, silkworm::ByteView /*value*/) override {
+        co_return KeyValue{};
+    }
+
+    boost::asio::awaitable<std::vector<silkworm::Bytes>> seek_both_many(const std::vector<silkworm::Bytes>& keys,
+                                                                        const std::vector<silkworm::Bytes>& values) override {
+        ++round_trips_[table_name_];
+        co_return co_await ethdb::CursorDupSort::seek_both_many(keys, values);
+    }
+
+private:
+    std::string table_name_;
+    std::map<silkworm::Bytes, std::vector<silkworm::Bytes>>& table_;
+    RoundTrips& round_trips_;
+};
+
+class TablesTransaction : public ethdb::Transaction {
+public:
+    TablesTransaction(uint64_t tx_id, Tables& tables) : tx_id_{tx_id}, tables_{tables} {}
+
+    uint64_t tx_id() const override { return tx_id_; }
+
+    boost::asio::awaitable<void> open() override { co_return; }
+
+    boost::asio::awaitable<std::shared_ptr<ethdb::Cursor>> cursor(const std::string& table) override {
+        co_return std::make_shared<TablesCursor>(table, tables_, round_trips_);
+    }
+
+    boost::asio::awaitable<std::shared_ptr<ethdb::CursorDupSort>> cursor_dup_sort(const std::string& table) override {
+        co_return std::make_shared<TablesCursor>(table, tables_, round_trips_);
+    }
+
+    boost::asio::awaitable<void> close() override { co_return; }
+
+    const RoundTrips& round_trips() const { return round_trips_; }
+
+private:
+    uint64_t tx_id_;
+    Tables& tables_;
+    RoundTrips round_trips_;
+};
+
+static evmc::bytes32 keccak(silkworm::ByteView bytes) {
+    const auto hash{silkworm::keccak256(bytes)};
+    evmc::bytes32 hash_bytes;
+    std::memcpy(hash_bytes.bytes, hash.bytes, sizeof(hash_bytes.bytes));
+    return hash_bytes;
+}
+
+static silkworm::ByteView view_of(const evmc::bytes32& hash) {
+    return silkworm::ByteView{hash.bytes, sizeof(hash.bytes)};
+}
+
+static silkworm::Bytes unpack(silkworm::ByteView key) {
+    silkworm::Bytes nibbles;
+    for (const auto byte : key) {
+        nibbles.push_back(byte >> 4);
+        nibbles.push_back(byte & 0x0f);
+    }
+    return nibbles;
+}
+
+static evmc::bytes32 location_of(uint64_t n) {
+    evmc::bytes32 location{};
+    boost::endian::store_big_u64(&location.bytes[24], n);
+    return location;
+}
+
+//! The encoded subtrie stored along the way in the trie table as Erigon does
+struct StoredSubtrie {
+    silkworm::Bytes encoded;
+    bool leaf{false};
+    //! Whether any node of the subtrie is stored
+    bool stored{false};
+};
+
+//! Store the branch nodes of the subtrie having some child that is not a leaf, as Erigon intermediate hashes do
+static StoredSubtrie store_subtrie(Tables& tables, const std::string& table, const silkworm::Bytes& prefix, const TrieLeaf* first,
+                                   const TrieLeaf* last, std::size_t depth = 0) {
+    if (last - first == 1) {
+        return {encode_leaf_node(silkworm::ByteView{first->nibbles}.substr(depth), first->value), true, false};
+    }
+    std::size_t common_length{0};
+    while (first->nibbles[depth + common_length] == (last - 1)->nibbles[depth + common_length]) {
+        ++common_length;
+    }
+    if (common_length > 0) {
+        const auto child = store_subtrie(tables, table, prefix, first, last, depth + common_length);
+        const auto path{silkworm::ByteView{first->nibbles}.substr(depth, common_length)};
+        return {encode_extension_node(path, node_reference(child.encoded)), false, child.stored};
+    }
+
+    uint16_t state_mask{0}, tree_mask{0}, hash_mask{0};
+    std::vector<evmc::bytes32> hashes;
+    std::array<silkworm::Bytes, 16> child_references;
+    for (auto child_first{first}; child_first != last;) {
+        const auto nibble = child_first->nibbles[depth];
+        const auto child_last = std::find_if(child_first, last, [&](const auto& leaf) { return leaf.nibbles[depth] != nibble; });
+        const auto child = store_subtrie(tables, table, prefix, child_first, child_last, depth + 1);
+        state_mask |= static_cast<uint16_t>(1u << nibble);
+        if (!child.leaf) {
+            hash_mask |= static_cast<uint16_t>(1u << nibble);
+            hashes.push_back(keccak(child.encoded));
+        }
+        if (child.stored) {
+            tree_mask |= static_cast<uint16_t>(1u << nibble);
+        }
+        child_references[nibble] = node_reference(child.encoded);
+        child_first = child_last;
+    }
+    StoredSubtrie subtrie{encode_branch_node(child_references), false, tree_mask != 0 || hash_mask != 0};
+    if (subtrie.stored) {
+        silkworm::Bytes value(6, '\0');
+        boost::endian::store_big_u16(&value[0], state_mask);
+        boost::endian::store_big_u16(&value[2], tree_mask);
+        boost::endian::store_big_u16(&value[4], hash_mask);
+        if (depth == 0) {
+            value.append(view_of(keccak(subtrie.encoded)));
+        }
+        for (const auto& hash : hashes) {
+            value.append(view_of(hash));
+        }
+        tables[table][prefix + first->nibbles.substr(0, depth)] = {value};
+    }
+    return subtrie;
+}
+
+static evmc::bytes32 root_of(std::vector<TrieLeaf>& leaves) {
+    if (leaves.empty()) {
+        return silkworm::kEmptyRoot;
+    }
+    std::sort(leaves.begin(), leaves.end(), [](const auto& lhs, const auto& rhs) { return lhs.nibbles < rhs.nibbles; });
+    return keccak(encode_subtrie(leaves.data(), leaves.data() + leaves.size(), 0));
+}
+
+//! Decode the RLP item at the start of the bytes, consuming it: return the payload and whether it is a list
+static std::pair<silkworm::ByteView, bool> decode_item(silkworm::ByteView& bytes) {
+    REQUIRE(!bytes.empty());
+    const auto prefix = bytes[0];
+    std::size_t header_length{1}, payload_length{0};
+    if (prefix < 0x80) {
+        header_length = 0;
+        payload_length = 1;
+    } else if (prefix < 0xb8 || (prefix >= 0xc0 && prefix < 0xf8)) {
+        payload_length = prefix - (prefix < 0xc0 ? 0x80 : 0xc0);
+    } else {
+        const std::size_t length_of_length = prefix - (prefix < 0xc0 ? 0xb7 : 0xf7);
+        for (std::size_t i{1}; i <= length_of_length; ++i) {
+            payload_length = payload_length << 8 | bytes[i];
+        }
+        header_length += length_of_length;
+    }
+    REQUIRE(header_length + payload_length <= bytes.size());
+    const auto payload = bytes.substr(header_length, payload_length);
+    bytes.remove_prefix(header_length + payload_length);
+    return {payload, prefix >= 0xc0};
+}
+
+//! Verify the proof of the hashed key against the trie root, returning the leaf value if it holds the key
+static std::optional<silkworm::Bytes> verify_proof(const evmc::bytes32& root, const evmc::bytes32& hashed_key, const ProofNodes& proof) {
+    if (root == silkworm::kEmptyRoot) {
+        REQUIRE(proof.empty());
+        return std::nullopt;
+    }
+    const auto nibbles{unpack(view_of(hashed_key))};
+    std::size_t depth{0};
+    std::size_t proof_index{0};
+    silkworm::Bytes node;
+    // Move to the child node, either in the proof by hash or embedded in its parent
+    const auto follow = [&](silkworm::ByteView reference, bool embedded) {
+        if (embedded) {
+            node = reference;
+        } else {
+            REQUIRE(reference.size() == silkworm::kHashLength);
+            REQUIRE(proof_index < proof.size());
+            REQUIRE(keccak(proof[proof_index]) == silkworm::to_bytes32(reference));
+            node = proof[proof_index++];
+        }
+    };
+    follow(view_of(root), false);
+    while (true) {
+        silkworm::ByteView encoded{node};
+        const auto [payload, list] = decode_item(encoded);
+        REQUIRE(list);
+        std::vector<std::pair<silkworm::ByteView, bool>> items;
+        silkworm::ByteView rest{payload};
+        while (!rest.empty()) {
+            const auto item_start{rest};
+            const auto item = decode_item(rest);
+            // Keep the whole encoding of the embedded nodes
+            items.emplace_back(item.second ? item_start.substr(0, item_start.size() - rest.size()) : item.first, item.second);
+        }
+        if (items.size() == 17) {
+            REQUIRE(depth < nibbles.size());
+            const auto [child, embedded] = items[nibbles[depth++]];
+            if (child.empty()) {
+                REQUIRE(proof_index == proof.size());
+                return std::nullopt;
+            }
+            follow(child, embedded);
+            continue;
+        }
+        REQUIRE(items.size() == 2);
+        const auto path = items[0].first;
+        const bool leaf = (path[0] & 0x20) != 0;
+        silkworm::Bytes path_nibbles{unpack(path)};
+        path_nibbles.erase(0, (path[0] & 0x10) != 0 ? 1 : 2);
+        if (nibbles.substr(depth, path_nibbles.size()) != path_nibbles) {
+            REQUIRE(proof_index == proof.size());
+            return std::nullopt;
+        }
+        depth += path_nibbles.size();
+        if (leaf) {
+            REQUIRE(depth == nibbles.size());
+            REQUIRE(proof_index == proof.size());
+            return silkworm::Bytes{items[1].first};
+        }
+        follow(items[1].first, items[1].second);
+    }
+}
+
+static silkworm::Bytes storage_leaf_value(silkworm::ByteView value) {
+    silkworm::Bytes encoded;
+    silkworm::rlp::encode(encoded, value);
+    return encoded;
+}
+
+//! A contract storage to put in the state
+struct TestStorage {
+    std::map<evmc::bytes32, silkworm::Bytes> values;
+    //! Whether to store the storage trie nodes, otherwise recomputed from its leaves
+    bool store_nodes{true};
+};
+
+//! Put the accounts and their storage in the hashed state along with the trie nodes, returning the state root
+static evmc::bytes32 put_state(Tables& tables, const std::map<evmc::address, silkworm::Account>& accounts,
+                               const std::map<evmc::address, TestStorage>& storages, bool store_nodes = true) {
+    std::vector<TrieLeaf> account_leaves;
+    for (const auto& [address, account] : accounts) {
+        const auto hashed_address{keccak(silkworm::ByteView{address.bytes, sizeof(address.bytes)})};
+        tables[db::table::kHashedAccounts][silkworm::Bytes{view_of(hashed_address)}] = {account.encode_for_storage()};
+
+        evmc::bytes32 storage_root{silkworm::kEmptyRoot};
+        const auto storage_it = storages.find(address);
+        if (storage_it != storages.end()) {
+            const auto storage_prefix{silkworm::db::storage_prefix(view_of(hashed_address), account.incarnation)};
+            std::vector<TrieLeaf> storage_leaves;
+            auto& dup_values = tables[db::table::kHashedStorage][storage_prefix];
+            for (const auto& [location, value] : storage_it->second.values) {
+                const auto hashed_location{keccak(view_of(location))};
+                dup_values.push_back(silkworm::Bytes{view_of(hashed_location)} + value);
+                storage_leaves.push_back(TrieLeaf{unpack(view_of(hashed_location)), storage_leaf_value(value)});
+            }
+            std::sort(dup_values.begin(), dup_values.end());
+            storage_root = root_of(storage_leaves);
+            if (store_nodes && storage_it->second.store_nodes && !storage_leaves.empty()) {
+                store_subtrie(tables, db::table::kTrieOfStorage, storage_prefix, storage_leaves.data(), storage_leaves.data() + storage_leaves.size());
+            }
+        }
+        account_leaves.push_back(TrieLeaf{unpack(view_of(hashed_address)), account.rlp(storage_root)});
+    }
+    const auto state_root{root_of(account_leaves)};
+    if (store_nodes && !account_leaves.empty()) {
+        store_subtrie(tables, db::table::kTrieOfAccounts, {}, account_leaves.data(), account_leaves.data() + account_leaves.size());
+    }
+    return state_root;
+}
+
+static AccountProof build_proof(ethdb::Transaction& transaction, const evmc::address& address, const std::vector<evmc::bytes32>& locations,
+                                evmc::bytes32& state_root, TrieNodeCache* cache = nullptr) {
+    boost::asio::thread_pool pool{1};
+    ProofBuilder builder{transaction, cache};
+    auto result = boost::asio::co_spawn(pool, builder.build_proof(address, locations), boost::asio::use_future);
+    auto proof = result.get();
+    state_root = builder.state_root();
+    return proof;
+}
+
+static silkworm::Account make_account(uint64_t n, bool contract = false) {
+    silkworm::Account account;
+    account.nonce = n;
+    account.balance = n * 1'000'000'000;
+    if (contract) {
+        account.incarnation = 1;
+        account.code_hash = keccak(view_of(location_of(n)));
+    }
+    return account;
+}
+
+static evmc::address address_of(uint64_t n) {
+    evmc::address address{};
+    boost::endian::store_big_u64(&address.bytes[12], n + 1);
+    return address;
+}
+
+//! Check the account proof and the storage proofs against the state root
+static void check_proof(const AccountProof& proof, const evmc::bytes32& state_root, const std::optional<silkworm::Account>& account) {
+    const auto hashed_address{keccak(silkworm::ByteView{proof.address.bytes, sizeof(proof.address.bytes)})};
+    const auto account_value{verify_proof(state_root, hashed_address, proof.account_proof)};
+    if (account) {
+        silkworm::Bytes encoded_account;
+        silkworm::rlp::encode(encoded_account, account->rlp(proof.storage_hash));
+        REQUIRE(account_value);
+        CHECK(*account_value == account->rlp(proof.storage_hash));
+        CHECK(proof.nonce == account->nonce);
+        CHECK(proof.balance == account->balance);
+        CHECK(proof.code_hash == account->code_hash);
+    } else {
+        CHECK(!account_value);
+        CHECK(proof.storage_hash == silkworm::kEmptyRoot);
+    }
+    for (const auto& storage_proof : proof.storage_proofs) {
+        const auto value{verify_proof(proof.storage_hash, keccak(view_of(storage_proof.key)), storage_proof.proof)};
+        if (storage_proof.value.empty()) {
+            CHECK(!value);
+        } else {
+            REQUIRE(value);
+            CHECK(*value == storage_leaf_value(storage_proof.value));
+        }
+    }
+}
+
+TEST_CASE("encode_path", "[silkrpc][core][proof_builder]") {
+    CHECK(encode_path(silkworm::Bytes{1, 2, 3, 4, 5}, /*leaf=*/false) == silkworm::Bytes{0x11, 0x23, 0x45});
+    CHECK(encode_path(silkworm::Bytes{0, 1, 2, 3, 4, 5}, /*leaf=*/false) == silkworm::Bytes{0x00, 0x01, 0x23, 0x45});
+    CHECK(encode_path(silkworm::Bytes{0, 0x0f, 1, 0x0c, 0x0b, 8}, /*leaf=*/true) == silkworm::Bytes{0x20, 0x0f, 0x1c, 0xb8});
+    CHECK(encode_path(silkworm::Bytes{0x0f, 1, 0x0c, 0x0b, 8}, /*leaf=*/true) == silkworm::Bytes{0x3f, 0x1c, 0xb8});
+    CHECK(encode_path(silkworm::Bytes{}, /*leaf=*/true) == silkworm::Bytes{0x20});
+}
+
+TEST_CASE("encode_subtrie", "[silkrpc][core][proof_builder]") {
+    SECTION("single leaf") {
+        const std::string value(45, 'a');
+        const std::vector<TrieLeaf> leaves{TrieLeaf{silkworm::Bytes{4, 1}, silkworm::Bytes{value.begin(), value.end()}}};
+        const auto encoded{encode_subtrie(leaves.data(), leaves.data() + 1, 0)};
+        CHECK(encoded == *silkworm::from_hex("f1822041ad") + leaves[0].value);
+    }
+
+    SECTION("nodes shorter than a hash are embedded") {
+        const silkworm::Bytes leaf{encode_leaf_node(silkworm::Bytes{1}, silkworm::Bytes{0x01})};
+        CHECK(leaf.size() < silkworm::kHashLength);
+        CHECK(node_reference(leaf) == leaf);
+        const silkworm::Bytes short_branch{encode_branch_node({leaf, leaf})};
+        CHECK(node_reference(short_branch) == short_branch);
+        const silkworm::Bytes long_leaf{encode_leaf_node(silkworm::Bytes{1}, silkworm::Bytes(20, 0x01))};
+        const silkworm::Bytes branch{encode_branch_node({long_leaf})};
+        CHECK(node_reference(branch) == silkworm::Bytes{0xa0} + silkworm::Bytes{view_of(keccak(branch))});
+    }
+
+    SECTION("proof along the target path") {
+        std::vector<TrieLeaf> leaves;
+        for (uint64_t n{0}; n < 100; ++n) {
+            leaves.push_back(TrieLeaf{unpack(view_of(keccak(view_of(location_of(n))))), storage_leaf_value(silkworm::Bytes{0x2a})});
+        }
+        const auto root{root_of(leaves)};
+        for (uint64_t n{0}; n < 120; ++n) {
+            const auto hashed_key{keccak(view_of(location_of(n)))};
+            ProofNodes proof;
+            const auto encoded{encode_subtrie(leaves.data(), leaves.data() + leaves.size(), 0, unpack(view_of(hashed_key)), &proof)};
+            CHECK(keccak(encoded) == root);
+            REQUIRE(!proof.empty());
+            CHECK(proof.front() == encoded);
+            CHECK(verify_proof(root, hashed_key, proof).has_value() == (n < 100));
+        }
+    }
+}
+
+TEST_CASE("decode_trie_node", "[silkrpc][core][proof_builder]") {
+    const auto hash1{0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    const auto hash2{0xb10e2d527612073b26eecdfd717e6a320cf44b4afac2b0732d9fcbe2b7fa0cf6_bytes32};
+    silkworm::Bytes encoded{*silkworm::from_hex("f00f" "0003" "1001")};
+
+    SECTION("child hashes") {
+        encoded += view_of(hash1);
+        encoded += view_of(hash2);
+        const auto node{decode_trie_node(encoded)};
+        REQUIRE(node);
+        CHECK(node->state_mask == 0xf00f);
+        CHECK(node->tree_mask == 0x0003);
+        CHECK(node->hash_mask == 0x1001);
+        CHECK(!node->root_hash);
+        CHECK(node->child_hash(0) == hash1);
+        CHECK(node->child_hash(12) == hash2);
+        CHECK(TrieNode::has(node->tree_mask, 1));
+        CHECK(!TrieNode::has(node->tree_mask, 2));
+    }
+
+    SECTION("root hash") {
+        encoded += view_of(hash2);
+        encoded += view_of(hash1);
+        encoded += view_of(hash1);
+        const auto node{decode_trie_node(encoded)};
+        REQUIRE(node);
+        CHECK(node->root_hash == hash2);
+        CHECK(node->hashes == std::vector<evmc::bytes32>{hash1, hash1});
+    }
+
+    SECTION("malformed") {
+        CHECK(!decode_trie_node(silkworm::Bytes{0xf0, 0x0f}));
+        CHECK(!decode_trie_node(encoded));
+        CHECK(!decode_trie_node(encoded + silkworm::Bytes{view_of(hash1)} + silkworm::Bytes{0x00}));
+        CHECK(!decode_trie_node(*silkworm::from_hex("000f" "0010" "0000")));
+    }
+}
+
+TEST_CASE("ProofBuilder::build_proof", "[silkrpc][core][proof_builder]") {
+    Tables tables;
+    std::map<evmc::address, silkworm::Account> accounts;
+    std::map<evmc::address, TestStorage> storages;
+    evmc::bytes32 state_root;
+
+    SECTION("empty state") {
+        TablesTransaction transaction{1, tables};
+        const auto proof{build_proof(transaction, address_of(0), {location_of(1)}, state_root)};
+        CHECK(state_root == silkworm::kEmptyRoot);
+        CHECK(proof.account_proof.empty());
+        CHECK(proof.code_hash == silkworm::kEmptyHash);
+        REQUIRE(proof.storage_proofs.size() == 1);
+        CHECK(proof.storage_proofs[0].key == location_of(1));
+        CHECK(proof.storage_proofs[0].value.empty());
+        CHECK(proof.storage_proofs[0].proof.empty());
+        check_proof(proof, state_root, std::nullopt);
+    }
+
+    for (const bool store_nodes : {false, true}) {
+        DYNAMIC_SECTION("accounts with trie nodes stored: " << store_nodes) {
+            for (uint64_t n{0}; n < 300; ++n) {
+                accounts[address_of(n)] = make_account(n, n % 50 == 0);
+            }
+            for (uint64_t n{0}; n < 500; ++n) {
+                storages[address_of(0)].values[location_of(n)] = silkworm::Bytes{static_cast<uint8_t>(n % 255 + 1)};
+            }
+            storages[address_of(50)].values[location_of(1)] = *silkworm::from_hex("0badc0de");
+            storages[address_of(50)].values[location_of(2)] = *silkworm::from_hex("01");
+            storages[address_of(100)].store_nodes = false;
+            for (uint64_t n{0}; n < 30; ++n) {
+                storages[address_of(100)].values[location_of(n)] = *silkworm::from_hex("ff");
+            }
+            const auto expected_state_root{put_state(tables, accounts, storages, store_nodes)};
+            TablesTransaction transaction{1, tables};
+
+            for (const uint64_t n : {0, 1, 50, 100, 299, 300, 1000}) {
+                const auto address{address_of(n)};
+                std::vector<evmc::bytes32> locations;
+                for (uint64_t i{0}; i < 40; ++i) {
+                    locations.push_back(location_of(i * 16));
+                }
+                const auto proof{build_proof(transaction, address, locations, state_root)};
+                CHECK(state_root == expected_state_root);
+                CHECK(proof.address == address);
+                const auto account_it{accounts.find(address)};
+                check_proof(proof, state_root, account_it != accounts.end() ? std::make_optional(account_it->second) : std::nullopt);
+
+                const auto storage_it{storages.find(address)};
+                for (const auto& storage_proof : proof.storage_proofs) {
+                    const bool has_value = storage_it != storages.end() && storage_it->second.values.contains(storage_proof.key);
+                    CHECK(storage_proof.value == (has_value ? storage_it->second.values.at(storage_proof.key) : silkworm::Bytes{}));
+                }
+            }
+        }
+    }
+
+    SECTION("same proofs with or without trie nodes stored") {
+        for (uint64_t n{0}; n < 200; ++n) {
+            accounts[address_of(n)] = make_account(n, n == 7);
+        }
+        for (uint64_t n{0}; n < 1000; ++n) {
+            storages[address_of(7)].values[location_of(n)] = silkworm::Bytes{0x01, static_cast<uint8_t>(n)};
+        }
+        Tables tables_without_nodes;
+        put_state(tables_without_nodes, accounts, storages, /*store_nodes=*/false);
+        put_state(tables, accounts, storages);
+        TablesTransaction transaction_without_nodes{1, tables_without_nodes};
+        TablesTransaction transaction{1, tables};
+
+        const std::vector<evmc::bytes32> locations{location_of(3), location_of(999), location_of(1000)};
+        evmc::bytes32 state_root_without_nodes;
+        const auto proof_without_nodes{build_proof(transaction_without_nodes, address_of(7), locations, state_root_without_nodes)};
+        const auto proof{build_proof(transaction, address_of(7), locations, state_root)};
+        CHECK(state_root == state_root_without_nodes);
+        CHECK(proof.account_proof == proof_without_nodes.account_proof);
+        CHECK(proof.storage_hash == proof_without_nodes.storage_hash);
+        for (std::size_t i{0}; i < locations.size(); ++i) {
+            CHECK(proof.storage_proofs[i].proof == proof_without_nodes.storage_proofs[i].proof);
+        }
+    }
+
+    SECTION("stored node below an extension") {
+        // Select the locations having the root child 7 as an extension to the branch node at 73 storing the child 5
+        std::vector<evmc::bytes32> with_prefix_735, with_prefix_739, others;
+        for (uint64_t n{0}; with_prefix_735.size() < 2 || with_prefix_739.empty() || others.size() < 30; ++n) {
+            const auto location{location_of(n)};
+            const auto hashed_location{keccak(view_of(location))};
+            if (hashed_location.bytes[0] == 0x73 && hashed_location.bytes[1] >> 4 == 5) {
+                with_prefix_735.push_back(location);
+            } else if (hashed_location.bytes[0] == 0x73 && hashed_location.bytes[1] >> 4 == 9) {
+                with_prefix_739.push_back(location);
+            } else if (hashed_location.bytes[0] >> 4 != 7) {
+                others.push_back(location);
+            }
+        }
+        accounts[address_of(0)] = make_account(0, true);
+        for (const auto& locations : {with_prefix_735, with_prefix_739, others}) {
+            for (const auto& location : locations) {
+                storages[address_of(0)].values[location] = silkworm::Bytes{0x11};
+            }
+        }
+        put_state(tables, accounts, storages);
+        const auto root_key{silkworm::db::storage_prefix(view_of(keccak(silkworm::ByteView{address_of(0).bytes, 20})), 1)};
+        REQUIRE(tables[db::table::kTrieOfStorage].contains(root_key + silkworm::Bytes{7, 3}));
+        REQUIRE(!tables[db::table::kTrieOfStorage].contains(root_key + silkworm::Bytes{7}));
+
+        TablesTransaction transaction{1, tables};
+        std::vector<evmc::bytes32> locations{with_prefix_735[0], with_prefix_739[0], others[0]};
+        for (uint64_t n{0}; locations.size() < 10; ++n) {
+            if (keccak(view_of(location_of(1'000'000 + n))).bytes[0] >> 4 == 7) {
+                locations.push_back(location_of(1'000'000 + n)); // missing ones leaving the extension or not
+            }
+        }
+        const auto proof{build_proof(transaction, address_of(0), locations, state_root)};
+        check_proof(proof, state_root, accounts[address_of(0)]);
+        CHECK(proof.storage_proofs[0].value == silkworm::Bytes{0x11});
+        CHECK(proof.storage_proofs[1].value == silkworm::Bytes{0x11});
+        CHECK(proof.storage_proofs[3].value.empty());
+    }
+
+    SECTION("inconsistent trie node") {
+        for (uint64_t n{0}; n < 100; ++n) {
+            accounts[address_of(n)] = make_account(n);
+        }
+        put_state(tables, accounts, storages);
+        auto& root_node = tables[db::table::kTrieOfAccounts].at(silkworm::Bytes{}).front();
+        root_node.back() ^= 0x01; // the last child hash
+        TablesTransaction transaction{1, tables};
+        bool thrown{false};
+        for (uint64_t n{0}; n < 100 && !thrown; ++n) {
+            try {
+                build_proof(transaction, address_of(n), {}, state_root);
+            } catch (const std::runtime_error&) {
+                thrown = true;
+            }
+        }
+        CHECK(thrown);
+    }
+}
+
+TEST_CASE("ProofBuilder reads the storage paths together", "[silkrpc][core][proof_builder]") {
+    Tables tables;
+    std::map<evmc::address, silkworm::Account> accounts{{address_of(0), make_account(0, true)}};
+    std::map<evmc::address, TestStorage> storages;
+    for (uint64_t n{0}; n < 2000; ++n) {
+        storages[address_of(0)].values[location_of(n)] = silkworm::Bytes{0x01};
+    }
+    put_state(tables, accounts, storages);
+    evmc::bytes32 state_root;
+
+    std::size_t single_round_trips{0};
+    std::vector<evmc::bytes32> locations;
+    std::vector<AccountProof> single_proofs;
+    for (uint64_t n{0}; n < 16; ++n) {
+        locations.push_back(location_of(n * 100));
+        TablesTransaction transaction{1, tables};
+        single_proofs.push_back(build_proof(transaction, address_of(0), {locations.back()}, state_root));
+        single_round_trips += transaction.round_trips().at(db::table::kTrieOfStorage) + transaction.round_trips().at(db::table::kHashedStorage);
+    }
+
+    TablesTransaction transaction{1, tables};
+    const auto proof{build_proof(transaction, address_of(0), locations, state_root)};
+    check_proof(proof, state_root, accounts[address_of(0)]);
+    for (std::size_t i{0}; i < locations.size(); ++i) {
+        CHECK(proof.storage_proofs[i].proof == single_proofs[i].storage_proofs[0].proof);
+    }
+    const auto round_trips{transaction.round_trips().at(db::table::kTrieOfStorage) + transaction.round_trips().at(db::table::kHashedStorage)};
+    CHECK(round_trips * 4 < single_round_trips);
+}
+
+TEST_CASE("ProofBuilder shares the trie nodes through the cache", "[silkrpc][core][proof_builder]") {
+    Tables tables;
+    std::map<evmc::address, silkworm::Account> accounts;
+    for (uint64_t n{0}; n < 1000; ++n) {
+        accounts[address_of(n)] = make_account(n);
+    }
+    put_state(tables, accounts, {});
+    TrieNodeCache cache;
+    evmc::bytes32 state_root;
+
+    TablesTransaction transaction1{1, tables};
+    const auto proof1{build_proof(transaction1, address_of(1), {}, state_root, &cache)};
+    CHECK(transaction1.round_trips().at(db::table::kTrieOfAccounts) > 0);
+    CHECK(cache.size() > 0);
+
+    SECTION("same view") {
+        TablesTransaction transaction2{1, tables};
+        const auto proof2{build_proof(transaction2, address_of(1), {}, state_root, &cache)};
+        CHECK(proof2.account_proof == proof1.account_proof);
+        CHECK(!transaction2.round_trips().contains(db::table::kTrieOfAccounts));
+    }
+
+    SECTION("another view") {
+        TablesTransaction transaction2{2, tables};
+        const auto proof2{build_proof(transaction2, address_of(1), {}, state_root, &cache)};
+        CHECK(proof2.account_proof == proof1.account_proof);
+        CHECK(transaction2.round_trips().at(db::table::kTrieOfAccounts) == transaction1.round_trips().at(db::table::kTrieOfAccounts));
+    }
+}
+
+} // namespace silkrpc::core
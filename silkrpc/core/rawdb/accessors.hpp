@@ -22,28 +22,83 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include <boost/asio/awaitable.hpp>
 
 #include <silkworm/common/util.hpp>
 
+#include <silkrpc/common/chain_head_cache.hpp>
 #include <silkrpc/common/util.hpp>
+#include <silkrpc/ethdb/snapshot/repository.hpp>
 
 namespace silkrpc::core::rawdb {
 
 using Walker = std::function<bool(silkworm::Bytes&, silkworm::Bytes&)>;
 
+//! Reader of the database tables, whose operations can be awaited concurrently on the same executor (e.g. by when_all)
+//! provided that they read different tables: the cursor on each table may be shared by all the operations reading it
 class DatabaseReader {
 public:
     virtual boost::asio::awaitable<KeyValue> get(const std::string& table, const silkworm::ByteView& key) const = 0;
 
     virtual boost::asio::awaitable<silkworm::Bytes> get_one(const std::string& table, const silkworm::ByteView& key) const = 0;
 
+    //! Get the value of the key (empty if missing) as a view sharing the buffer holding it, so that large values can be read
+    //! w/o copying them. The default implementation just moves the value returned by get_one into the shared buffer
+    virtual boost::asio::awaitable<SharedByteView> get_one_shared(const std::string& table, const silkworm::ByteView& key) const {
+        const auto value = std::make_shared<const silkworm::Bytes>(co_await get_one(table, key));
+        co_return SharedByteView{value, *value};
+    }
+
+    //! Get the value of each key in the same order (empty if missing). The default implementation just calls get_one for each
+    //! key, readers able to pipeline the requests should override it
+    virtual boost::asio::awaitable<std::vector<silkworm::Bytes>> get_many(const std::string& table, const std::vector<silkworm::Bytes>& keys) const {
+        std::vector<silkworm::Bytes> values;
+        values.reserve(keys.size());
+        for (const auto& key : keys) {
+            values.push_back(co_await get_one(table, key));
+        }
+        co_return values;
+    }
+
+    //! Get the first key-value pair at or after each key in the same order, like get. The default implementation just calls
+    //! get for each key, readers able to pipeline the requests should override it
+    virtual boost::asio::awaitable<std::vector<KeyValue>> seek_many(const std::string& table, const std::vector<silkworm::Bytes>& keys) const {
+        std::vector<KeyValue> kv_pairs;
+        kv_pairs.reserve(keys.size());
+        for (const auto& key : keys) {
+            kv_pairs.push_back(co_await get(table, key));
+        }
+        co_return kv_pairs;
+    }
+
     virtual boost::asio::awaitable<std::optional<silkworm::Bytes>> get_both_range(const std::string& table, const silkworm::ByteView& key, const silkworm::ByteView& subkey) const = 0;
 
+    //! Get the value of each key and subkey pair in the same order, like get_both_range. The default implementation just
+    //! calls get_both_range for each pair, readers able to pipeline the requests should override it
+    virtual boost::asio::awaitable<std::vector<std::optional<silkworm::Bytes>>> get_both_range_many(const std::string& table,
+        const std::vector<silkworm::Bytes>& keys, const std::vector<silkworm::Bytes>& subkeys) const {
+        std::vector<std::optional<silkworm::Bytes>> values;
+        values.reserve(keys.size());
+        for (std::size_t i{0}; i < keys.size(); ++i) {
+            values.push_back(co_await get_both_range(table, keys[i], subkeys[i]));
+        }
+        co_return values;
+    }
+
     virtual boost::asio::awaitable<void> walk(const std::string& table, const silkworm::ByteView& start_key, uint32_t fixed_bits, Walker w) const = 0;
 
     virtual boost::asio::awaitable<void> for_prefix(const std::string& table, const silkworm::ByteView& prefix, Walker w) const = 0;
+
+    //! The id of the database view read, meaningful just if there is a chain head cache
+    virtual uint64_t view_id() const { return 0; }
+
+    //! The cache of the chain head block numbers shared by the readers of the same database, if any
+    virtual ChainHeadCache* chain_head_cache() const { return nullptr; }
+
+    //! The repository of the frozen blocks shared by the readers of the same database, if any
+    virtual const ethdb::snapshot::SnapshotRepository* snapshots() const { return nullptr; }
 };
 
 } // namespace silkrpc::core::rawdb
@@ -16,11 +16,15 @@
 
 #include "chain.hpp"
 
+#include <cstring>
 #include <iterator>
 #include <iostream>
 #include <iomanip>
+#include <memory>
 #include <string>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include <boost/endian/conversion.hpp>
 
@@ -33,6 +37,7 @@
 
 #include <silkrpc/common/log.hpp>
 #include <silkrpc/common/util.hpp>
+#include <silkrpc/concurrency/when_all.hpp>
 #include <silkrpc/core/blocks.hpp>
 #include <silkrpc/ethdb/cbor.hpp>
 #include <silkrpc/ethdb/tables.hpp>
@@ -43,6 +48,14 @@
 namespace silkrpc::core::rawdb {
 
 boost::asio::awaitable<uint64_t> read_header_number(const DatabaseReader& reader, const evmc::bytes32& block_hash) {
+    // Recent canonical blocks are resolved by the chain head cache, if any, without reading the table
+    auto* chain_head_cache = reader.chain_head_cache();
+    if (chain_head_cache != nullptr) {
+        const auto cached_block_number = chain_head_cache->canonical_hashes().get_number(reader.view_id(), block_hash);
+        if (cached_block_number) {
+            co_return *cached_block_number;
+        }
+    }
     const silkworm::ByteView block_hash_bytes{block_hash.bytes, silkworm::kHashLength};
     const auto value{co_await reader.get_one(db::table::kHeaderNumbers, block_hash_bytes)};
     if (value.empty()) {
@@ -51,29 +64,101 @@ boost::asio::awaitable<uint64_t> read_header_number(const DatabaseReader& reader
     co_return boost::endian::load_big_u64(value.data());
 }
 
-boost::asio::awaitable<ChainConfig> read_chain_config(const DatabaseReader& reader) {
-    const auto genesis_block_hash{co_await read_canonical_block_hash(reader, kEarliestBlockNumber)};
-    SILKRPC_DEBUG << "rawdb::read_chain_config genesis_block_hash: " << genesis_block_hash << "\n";
+namespace {
+
+//! Return the snapshots of the reader if they hold the block, so that it is read locally w/o any database round trip
+const ethdb::snapshot::SnapshotRepository* snapshots_holding(const DatabaseReader& reader, uint64_t block_number) {
+    const auto* snapshots = reader.snapshots();
+    return snapshots != nullptr && snapshots->is_frozen(block_number) ? snapshots : nullptr;
+}
+
+boost::asio::awaitable<silkworm::Bytes> read_chain_config_data(const DatabaseReader& reader, const evmc::bytes32& genesis_block_hash) {
     const silkworm::ByteView genesis_block_hash_bytes{genesis_block_hash.bytes, silkworm::kHashLength};
-    const auto data{co_await reader.get_one(db::table::kConfig, genesis_block_hash_bytes)};
+    auto data{co_await reader.get_one(db::table::kConfig, genesis_block_hash_bytes)};
     if (data.empty()) {
         throw std::invalid_argument{"empty chain config data in read_chain_config"};
     }
     SILKRPC_DEBUG << "rawdb::read_chain_config chain config data: " << data.c_str() << "\n";
+    co_return data;
+}
+
+evmc::bytes32 hash_of_chain_config_data(const silkworm::Bytes& data) {
+    const auto data_hash{hash_of(data)};
+    evmc::bytes32 hash;
+    std::memcpy(hash.bytes, data_hash.bytes, silkworm::kHashLength);
+    return hash;
+}
+
+std::shared_ptr<const ParsedChainConfig> parse_chain_config(const evmc::bytes32& genesis_block_hash, const silkworm::Bytes& data) {
     const auto json_config = nlohmann::json::parse(data.c_str());
     SILKRPC_TRACE << "rawdb::read_chain_config chain config JSON: " << json_config.dump() << "\n";
-    co_return ChainConfig{genesis_block_hash, json_config};
+    return std::make_shared<const ParsedChainConfig>(ChainConfig{genesis_block_hash, json_config}, hash_of_chain_config_data(data));
+}
+
+} // namespace
+
+boost::asio::awaitable<ChainConfig> read_chain_config(const DatabaseReader& reader) {
+    const auto parsed_chain_config = co_await read_parsed_chain_config(reader);
+    co_return parsed_chain_config->chain_config;
+}
+
+boost::asio::awaitable<std::shared_ptr<const ParsedChainConfig>> read_parsed_chain_config(const DatabaseReader& reader) {
+    auto* chain_head_cache = reader.chain_head_cache();
+    std::shared_ptr<const ParsedChainConfig> chain_config;
+    if (chain_head_cache != nullptr) {
+        auto cached_chain_config = chain_head_cache->get_chain_config(reader.view_id());
+        if (cached_chain_config) {
+            co_return cached_chain_config;
+        }
+        // The config changes very rarely (e.g. restarting the node with a new one), so the latest one read from any view is
+        // reused as long as the stored data has the same hash, skipping the genesis hash lookup and the parsing
+        const auto latest_chain_config = chain_head_cache->latest_chain_config();
+        if (latest_chain_config) {
+            const auto& genesis_block_hash = latest_chain_config->chain_config.genesis_hash;
+            const auto data{co_await read_chain_config_data(reader, genesis_block_hash)};
+            if (hash_of_chain_config_data(data) == latest_chain_config->data_hash) {
+                chain_config = latest_chain_config;
+            } else {
+                SILKRPC_INFO << "rawdb::read_chain_config chain config changed, parsing again\n";
+                chain_config = parse_chain_config(genesis_block_hash, data);
+            }
+        }
+    }
+    if (!chain_config) {
+        const auto genesis_block_hash{co_await read_canonical_block_hash(reader, kEarliestBlockNumber)};
+        SILKRPC_DEBUG << "rawdb::read_chain_config genesis_block_hash: " << genesis_block_hash << "\n";
+        chain_config = parse_chain_config(genesis_block_hash, co_await read_chain_config_data(reader, genesis_block_hash));
+    }
+    if (chain_head_cache != nullptr) {
+        chain_head_cache->put_chain_config(reader.view_id(), chain_config);
+    }
+    co_return chain_config;
 }
 
 boost::asio::awaitable<uint64_t> read_chain_id(const DatabaseReader& reader) {
-    const auto chain_info = co_await read_chain_config(reader);
-    if (chain_info.config.count("chainId") == 0) {
+    const auto parsed_chain_config = co_await read_parsed_chain_config(reader);
+    const auto& config = parsed_chain_config->chain_config.config;
+    if (config.count("chainId") == 0) {
         throw std::runtime_error{"missing chainId in chain config"};
     }
-    co_return chain_info.config["chainId"].get<uint64_t>();
+    co_return config.at("chainId").get<uint64_t>();
 }
 
 boost::asio::awaitable<evmc::bytes32> read_canonical_block_hash(const DatabaseReader& reader, uint64_t block_number) {
+    auto* chain_head_cache = reader.chain_head_cache();
+    if (chain_head_cache != nullptr) {
+        const auto cached_block_hash = chain_head_cache->canonical_hashes().get_hash(reader.view_id(), block_number);
+        if (cached_block_hash) {
+            co_return *cached_block_hash;
+        }
+    }
+    const auto* snapshots = snapshots_holding(reader, block_number);
+    if (snapshots != nullptr) {
+        const auto frozen_block_hash = snapshots->read_canonical_hash(block_number);
+        if (frozen_block_hash) {
+            co_return *frozen_block_hash;
+        }
+    }
     const auto block_key = silkworm::db::block_key(block_number);
     SILKRPC_TRACE << "rawdb::read_canonical_block_hash block_key: " << silkworm::to_hex(block_key) << "\n";
     const auto value{co_await reader.get_one(db::table::kCanonicalHashes, block_key)};
@@ -82,9 +167,49 @@ boost::asio::awaitable<evmc::bytes32> read_canonical_block_hash(const DatabaseRe
     }
     const auto canonical_block_hash{silkworm::to_bytes32(value)};
     SILKRPC_DEBUG << "rawdb::read_canonical_block_hash canonical block hash: " << canonical_block_hash << "\n";
+    if (chain_head_cache != nullptr) {
+        chain_head_cache->canonical_hashes().put(reader.view_id(), block_number, canonical_block_hash);
+    }
     co_return canonical_block_hash;
 }
 
+boost::asio::awaitable<std::vector<std::optional<evmc::bytes32>>> read_canonical_block_hashes(const DatabaseReader& reader, const std::vector<uint64_t>& block_numbers) {
+    std::vector<std::optional<evmc::bytes32>> block_hashes(block_numbers.size());
+    auto* chain_head_cache = reader.chain_head_cache();
+    std::vector<std::size_t> read_indexes;
+    std::vector<silkworm::Bytes> block_keys;
+    for (std::size_t i{0}; i < block_numbers.size(); ++i) {
+        const auto block_number = block_numbers[i];
+        if (chain_head_cache != nullptr) {
+            block_hashes[i] = chain_head_cache->canonical_hashes().get_hash(reader.view_id(), block_number);
+        }
+        if (!block_hashes[i]) {
+            if (const auto* snapshots = snapshots_holding(reader, block_number)) {
+                block_hashes[i] = snapshots->read_canonical_hash(block_number);
+            }
+        }
+        if (!block_hashes[i]) {
+            read_indexes.push_back(i);
+            block_keys.push_back(silkworm::db::block_key(block_number));
+        }
+    }
+    if (block_keys.empty()) {
+        co_return block_hashes;
+    }
+    const auto values = co_await reader.get_many(db::table::kCanonicalHashes, block_keys);
+    for (std::size_t j{0}; j < read_indexes.size() && j < values.size(); ++j) {
+        if (values[j].empty()) {
+            continue;
+        }
+        const auto index = read_indexes[j];
+        block_hashes[index] = silkworm::to_bytes32(values[j]);
+        if (chain_head_cache != nullptr) {
+            chain_head_cache->canonical_hashes().put(reader.view_id(), block_numbers[index], *block_hashes[index]);
+        }
+    }
+    co_return block_hashes;
+}
+
 boost::asio::awaitable<intx::uint256> read_total_difficulty(const DatabaseReader& reader, const evmc::bytes32& block_hash, uint64_t block_number) {
     const auto block_key = silkworm::db::block_key(block_number, block_hash.bytes);
     SILKRPC_TRACE << "rawdb::read_total_difficulty block_key: " << silkworm::to_hex(block_key) << "\n";
@@ -122,10 +247,36 @@ boost::asio::awaitable<uint64_t> read_block_number_by_transaction_hash(const Dat
     co_return std::stoul(silkworm::to_hex(block_number_bytes), 0, 16);
 }
 
+boost::asio::awaitable<std::vector<std::optional<uint64_t>>> read_block_numbers_by_transaction_hashes(const DatabaseReader& reader, const std::vector<evmc::bytes32>& transaction_hashes) {
+    std::vector<std::optional<uint64_t>> block_numbers(transaction_hashes.size());
+    if (transaction_hashes.empty()) {
+        co_return block_numbers;
+    }
+    std::vector<silkworm::Bytes> tx_hashes;
+    tx_hashes.reserve(transaction_hashes.size());
+    for (const auto& transaction_hash : transaction_hashes) {
+        tx_hashes.emplace_back(transaction_hash.bytes, silkworm::kHashLength);
+    }
+    const auto values = co_await reader.get_many(db::table::kTxLookup, tx_hashes);
+    for (std::size_t i{0}; i < block_numbers.size() && i < values.size(); ++i) {
+        // The block number is stored big-endian w/o leading zeros
+        const auto& block_number_bytes = values[i];
+        if (block_number_bytes.empty() || block_number_bytes.size() > sizeof(uint64_t)) {
+            continue;
+        }
+        uint64_t block_number{0};
+        for (const auto byte : block_number_bytes) {
+            block_number = (block_number << 8) | byte;
+        }
+        block_numbers[i] = block_number;
+    }
+    co_return block_numbers;
+}
+
 boost::asio::awaitable<silkworm::BlockWithHash> read_block(const DatabaseReader& reader, const evmc::bytes32& block_hash, uint64_t block_number) {
-    auto header = co_await read_header(reader, block_hash, block_number);
+    // Header and body are independent, so they are read concurrently
+    auto [header, body] = co_await when_all(read_header(reader, block_hash, block_number), read_body(reader, block_hash, block_number));
     SILKRPC_INFO << "header: number=" << header.number << "\n";
-    auto body = co_await read_body(reader, block_hash, block_number);
     SILKRPC_INFO << "body: #txn=" << body.transactions.size() << " #ommers=" << body.ommers.size() << "\n";
     silkworm::BlockWithHash block{silkworm::Block{body.transactions, body.ommers, header}, block_hash};
     co_return block;
@@ -142,12 +293,21 @@ boost::asio::awaitable<silkworm::BlockHeader> read_header_by_number(const Databa
 }
 
 boost::asio::awaitable<silkworm::BlockHeader> read_header(const DatabaseReader& reader, const evmc::bytes32& block_hash, uint64_t block_number) {
-    auto data = co_await read_header_rlp(reader, block_hash, block_number);
-    if (data.empty()) {
+    const auto* snapshots = snapshots_holding(reader, block_number);
+    if (snapshots != nullptr) {
+        auto frozen_header = snapshots->read_header(block_number, block_hash);
+        if (frozen_header) {
+            co_return std::move(*frozen_header);
+        }
+    }
+    // The RLP is decoded straight from the buffer it has been read in
+    const auto block_key = silkworm::db::block_key(block_number, block_hash.bytes);
+    const auto data = co_await reader.get_one_shared(db::table::kHeaders, block_key);
+    if (data.bytes.empty()) {
         throw std::runtime_error{"empty block header RLP in read_header"};
     }
-    SILKRPC_TRACE << "data: " << silkworm::to_hex(data) << "\n";
-    silkworm::ByteView data_view{data};
+    SILKRPC_TRACE << "data: " << silkworm::to_hex(data.bytes) << "\n";
+    silkworm::ByteView data_view{data.bytes};
     silkworm::BlockHeader header{};
     const auto error = silkworm::rlp::decode(data_view, header);
     if (error != silkworm::DecodingResult::kOk) {
@@ -173,20 +333,38 @@ boost::asio::awaitable<evmc::bytes32> read_head_header_hash(const DatabaseReader
 }
 
 boost::asio::awaitable<silkworm::BlockBody> read_body(const DatabaseReader& reader, const evmc::bytes32& block_hash, uint64_t block_number) {
-    const auto data = co_await read_body_rlp(reader, block_hash, block_number);
-    if (data.empty()) {
+    // The frozen bodies come with their transactions and senders at once
+    const auto* snapshots = snapshots_holding(reader, block_number);
+    if (snapshots != nullptr) {
+        auto frozen_body = snapshots->read_body(block_number, block_hash);
+        if (frozen_body) {
+            co_return std::move(*frozen_body);
+        }
+    }
+    // The RLP is decoded straight from the buffer it has been read in
+    const auto block_key = silkworm::db::block_key(block_number, block_hash.bytes);
+    const auto data = co_await reader.get_one_shared(db::table::kBlockBodies, block_key);
+    if (data.bytes.empty()) {
         throw std::runtime_error{"empty block body RLP in read_body"};
     }
-    SILKRPC_TRACE << "RLP data for block body #" << block_number << ": " << silkworm::to_hex(data) << "\n";
+    SILKRPC_TRACE << "RLP data for block body #" << block_number << ": " << silkworm::to_hex(data.bytes) << "\n";
 
     try {
-        silkworm::ByteView data_view{data};
+        silkworm::ByteView data_view{data.bytes};
         auto stored_body{silkworm::db::detail::decode_stored_block_body(data_view)};
         // 1 system txn in the begining of block, and 1 at the end
         SILKRPC_DEBUG << "base_txn_id: " << stored_body.base_txn_id + 1 << " txn_count: " << stored_body.txn_count -2 << "\n";
-        auto transactions = co_await read_canonical_transactions(reader, stored_body.base_txn_id+1, stored_body.txn_count-2);
+        const auto txn_count{stored_body.txn_count - 2};
+        Transactions transactions;
+        Addresses senders;
+        if (txn_count != 0) {
+            // The senders are read along with the transactions expected, w/o waiting for them
+            std::tie(transactions, senders) = co_await when_all(read_canonical_transactions(reader, stored_body.base_txn_id+1, txn_count),
+                read_senders(reader, block_hash, block_number));
+        } else {
+            transactions = co_await read_canonical_transactions(reader, stored_body.base_txn_id+1, txn_count);
+        }
         if (transactions.size() != 0) {
-            const auto senders = co_await read_senders(reader, block_hash, block_number);
             if (senders.size() == transactions.size()) {
                 // Fill sender in transactions
                 for (size_t i{0}; i < transactions.size(); i++) {
@@ -205,17 +383,86 @@ boost::asio::awaitable<silkworm::BlockBody> read_body(const DatabaseReader& read
     }
 }
 
+boost::asio::awaitable<std::vector<evmc::bytes32>> read_transaction_hashes(const DatabaseReader& reader, const evmc::bytes32& block_hash, uint64_t block_number,
+    const std::vector<uint32_t>& tx_indexes) {
+    std::vector<evmc::bytes32> transaction_hashes;
+    transaction_hashes.reserve(tx_indexes.size());
+    if (tx_indexes.empty()) {
+        co_return transaction_hashes;
+    }
+    const auto* snapshots = snapshots_holding(reader, block_number);
+    if (snapshots != nullptr) {
+        // The frozen transactions are read locally, so the whole body costs no database round trip
+        const auto body = co_await read_body(reader, block_hash, block_number);
+        for (const auto tx_index : tx_indexes) {
+            if (tx_index >= body.transactions.size()) {
+                throw std::runtime_error{"transaction index out of range in read_transaction_hashes"};
+            }
+            transaction_hashes.push_back(silkworm::to_bytes32({hash_of_transaction(body.transactions[tx_index]).bytes, silkworm::kHashLength}));
+        }
+        co_return transaction_hashes;
+    }
+    const auto block_key = silkworm::db::block_key(block_number, block_hash.bytes);
+    const auto data = co_await reader.get_one_shared(db::table::kBlockBodies, block_key);
+    if (data.bytes.empty()) {
+        throw std::runtime_error{"empty block body RLP in read_transaction_hashes"};
+    }
+    silkworm::ByteView data_view{data.bytes};
+    const auto stored_body{silkworm::db::detail::decode_stored_block_body(data_view)};
+    // 1 system txn in the begining of block, and 1 at the end
+    const auto txn_count{stored_body.txn_count - 2};
+    std::vector<silkworm::Bytes> txn_id_keys;
+    txn_id_keys.reserve(tx_indexes.size());
+    for (const auto tx_index : tx_indexes) {
+        if (tx_index >= txn_count) {
+            throw std::runtime_error{"transaction index out of range in read_transaction_hashes"};
+        }
+        silkworm::Bytes txn_id_key(8, '\0');
+        boost::endian::store_big_u64(txn_id_key.data(), stored_body.base_txn_id + 1 + tx_index);
+        txn_id_keys.push_back(std::move(txn_id_key));
+    }
+    const auto values = co_await reader.get_many(db::table::kEthTx, txn_id_keys);
+    for (const auto& value : values) {
+        if (value.empty()) {
+            throw std::runtime_error{"empty transaction RLP in read_transaction_hashes"};
+        }
+        transaction_hashes.push_back(silkworm::to_bytes32({hash_of(value).bytes, silkworm::kHashLength}));
+    }
+    co_return transaction_hashes;
+}
+
 boost::asio::awaitable<silkworm::Bytes> read_header_rlp(const DatabaseReader& reader, const evmc::bytes32& block_hash, uint64_t block_number) {
+    const auto* snapshots = snapshots_holding(reader, block_number);
+    if (snapshots != nullptr) {
+        auto frozen_header_rlp = snapshots->read_header_rlp(block_number, block_hash);
+        if (frozen_header_rlp) {
+            co_return std::move(*frozen_header_rlp);
+        }
+    }
     const auto block_key = silkworm::db::block_key(block_number, block_hash.bytes);
     co_return co_await reader.get_one(db::table::kHeaders, block_key);
 }
 
 boost::asio::awaitable<silkworm::Bytes> read_body_rlp(const DatabaseReader& reader, const evmc::bytes32& block_hash, uint64_t block_number) {
+    const auto* snapshots = snapshots_holding(reader, block_number);
+    if (snapshots != nullptr) {
+        auto frozen_body_rlp = snapshots->read_body_rlp(block_number, block_hash);
+        if (frozen_body_rlp) {
+            co_return std::move(*frozen_body_rlp);
+        }
+    }
     const auto block_key = silkworm::db::block_key(block_number, block_hash.bytes);
     co_return co_await reader.get_one(db::table::kBlockBodies, block_key);
 }
 
 boost::asio::awaitable<Addresses> read_senders(const DatabaseReader& reader, const evmc::bytes32& block_hash, uint64_t block_number) {
+    const auto* snapshots = snapshots_holding(reader, block_number);
+    if (snapshots != nullptr) {
+        auto frozen_senders = snapshots->read_senders(block_number, block_hash);
+        if (frozen_senders) {
+            co_return std::move(*frozen_senders);
+        }
+    }
     const auto block_key = silkworm::db::block_key(block_number, block_hash.bytes);
     const auto data = co_await reader.get_one(db::table::kSenders, block_key);
     SILKRPC_TRACE << "read_senders data: " << silkworm::to_hex(data) << "\n";
@@ -228,7 +475,27 @@ boost::asio::awaitable<Addresses> read_senders(const DatabaseReader& reader, con
 
 boost::asio::awaitable<Receipts> read_raw_receipts(const DatabaseReader& reader, const evmc::bytes32& block_hash, uint64_t block_number) {
     const auto block_key = silkworm::db::block_key(block_number);
-    const auto data = co_await reader.get_one(db::table::kBlockReceipts, block_key);
+    auto log_key = silkworm::db::log_key(block_number, 0);
+    SILKRPC_DEBUG << "log_key: " << silkworm::to_hex(log_key) << "\n";
+
+    // The logs are walked along with the receipts read, so they are collected by transaction and assigned afterwards
+    std::vector<std::pair<uint32_t, Logs>> logs_by_txn;
+    Walker walker = [&](const silkworm::Bytes& k, const silkworm::Bytes& v) {
+        if (k.size() != sizeof(uint64_t) + sizeof(uint32_t)) {
+            return false;
+        }
+        auto tx_id = boost::endian::load_big_u32(&k[sizeof(uint64_t)]);
+        Logs logs;
+        const bool decoding_ok{cbor_decode(v, logs)};
+        if (!decoding_ok) {
+            SILKRPC_WARN << "cannot decode logs for receipt: " << tx_id << " in block: " << block_number << "\n";
+            return false;
+        }
+        logs_by_txn.emplace_back(tx_id, std::move(logs));
+        return true;
+    };
+    const auto [data, unused] = co_await when_all(reader.get_one(db::table::kBlockReceipts, block_key),
+        reader.walk(db::table::kLogs, log_key, 8 * CHAR_BIT, walker));
     SILKRPC_TRACE << "read_raw_receipts data: " << silkworm::to_hex(data) << "\n";
     if (data.empty()) {
         co_return Receipts{}; // TODO(canepat): use std::null_opt with boost::asio::awaitable<std::optional<Receipts>>?
@@ -241,23 +508,15 @@ boost::asio::awaitable<Receipts> read_raw_receipts(const DatabaseReader& reader,
     }
     SILKRPC_DEBUG << "#receipts: " << receipts.size() << "\n";
 
-    auto log_key = silkworm::db::log_key(block_number, 0);
-    SILKRPC_DEBUG << "log_key: " << silkworm::to_hex(log_key) << "\n";
-    Walker walker = [&](const silkworm::Bytes& k, const silkworm::Bytes& v) {
-        if (k.size() != sizeof(uint64_t) + sizeof(uint32_t)) {
-            return false;
-        }
-        auto tx_id = boost::endian::load_big_u32(&k[sizeof(uint64_t)]);
-        const bool decoding_ok{cbor_decode(v, receipts[tx_id].logs)};
-        if (!decoding_ok) {
-            SILKRPC_WARN << "cannot decode logs for receipt: " << tx_id << " in block: " << block_number << "\n";
-            return false;
+    for (auto& [tx_id, logs] : logs_by_txn) {
+        if (tx_id >= receipts.size()) {
+            SILKRPC_WARN << "logs for missing receipt: " << tx_id << " in block: " << block_number << "\n";
+            continue;
         }
+        receipts[tx_id].logs = std::move(logs);
         receipts[tx_id].bloom = bloom_from_logs(receipts[tx_id].logs);
         SILKRPC_DEBUG << "#receipts[" << tx_id << "].logs: " << receipts[tx_id].logs.size() << "\n";
-        return true;
-    };
-    co_await reader.walk(db::table::kLogs, log_key, 8 * CHAR_BIT, walker);
+    }
 
     co_return receipts;
 }
@@ -268,7 +527,7 @@ boost::asio::awaitable<Receipts> read_receipts(const DatabaseReader& reader, con
     auto receipts = co_await read_raw_receipts(reader, block_hash, block_number);
 
     // Add derived fields to the receipts
-    auto transactions = block_with_hash.block.transactions;
+    const auto& transactions = block_with_hash.block.transactions;
     SILKRPC_DEBUG << "#transactions=" << block_with_hash.block.transactions.size() << " #receipts=" << receipts.size() << "\n";
     if (transactions.size() != receipts.size()) {
         throw std::runtime_error{"#transactions and #receipts do not match in read_receipts"};
@@ -320,6 +579,15 @@ boost::asio::awaitable<Transactions> read_canonical_transactions(const DatabaseR
         co_return txns;
     }
 
+    // The frozen transactions are read from the snapshots along with their senders
+    const auto* snapshots = reader.snapshots();
+    if (snapshots != nullptr && base_txn_id < snapshots->frozen_transactions()) {
+        auto frozen_txns = snapshots->read_transactions(base_txn_id, txn_count);
+        if (frozen_txns) {
+            co_return std::move(*frozen_txns);
+        }
+    }
+
     txns.reserve(txn_count);
 
     silkworm::Bytes txn_id_key(8, '\0');
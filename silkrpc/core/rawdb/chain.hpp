@@ -17,6 +17,8 @@
 #ifndef SILKRPC_CORE_RAWDB_CHAIN_HPP_
 #define SILKRPC_CORE_RAWDB_CHAIN_HPP_
 
+#include <memory>
+#include <optional>
 #include <vector>
 
 #include <silkrpc/config.hpp>
@@ -42,10 +44,18 @@ boost::asio::awaitable<uint64_t> read_header_number(const DatabaseReader& reader
 
 boost::asio::awaitable<ChainConfig> read_chain_config(const DatabaseReader& reader);
 
+//! Read the chain config parsed once per database view, shared through the chain head cache of the reader if any: once read,
+//! the next views just check that the stored config data is unchanged
+boost::asio::awaitable<std::shared_ptr<const ParsedChainConfig>> read_parsed_chain_config(const DatabaseReader& reader);
+
 boost::asio::awaitable<uint64_t> read_chain_id(const DatabaseReader& reader);
 
 boost::asio::awaitable<evmc::bytes32> read_canonical_block_hash(const DatabaseReader& reader, uint64_t block_number);
 
+//! Read the canonical hashes of the blocks at once, those neither cached nor frozen in one pipelined lookup, leaving
+//! empty those not found
+boost::asio::awaitable<std::vector<std::optional<evmc::bytes32>>> read_canonical_block_hashes(const DatabaseReader& reader, const std::vector<uint64_t>& block_numbers);
+
 boost::asio::awaitable<intx::uint256> read_total_difficulty(const DatabaseReader& reader, const evmc::bytes32& block_hash, uint64_t block_number);
 
 boost::asio::awaitable<silkworm::BlockWithHash> read_block_by_hash(const DatabaseReader& reader, const evmc::bytes32& block_hash);
@@ -54,6 +64,9 @@ boost::asio::awaitable<silkworm::BlockWithHash> read_block_by_number(const Datab
 
 boost::asio::awaitable<uint64_t> read_block_number_by_transaction_hash(const DatabaseReader& reader, const evmc::bytes32& transaction_hash);
 
+//! Read the numbers of the blocks including the transactions in one pipelined lookup, leaving empty those not found
+boost::asio::awaitable<std::vector<std::optional<uint64_t>>> read_block_numbers_by_transaction_hashes(const DatabaseReader& reader, const std::vector<evmc::bytes32>& transaction_hashes);
+
 boost::asio::awaitable<silkworm::BlockWithHash> read_block(const DatabaseReader& reader, const evmc::bytes32& block_hash, uint64_t block_number);
 
 boost::asio::awaitable<silkworm::BlockHeader> read_header_by_hash(const DatabaseReader& reader, const evmc::bytes32& block_hash);
@@ -68,6 +81,11 @@ boost::asio::awaitable<evmc::bytes32> read_head_header_hash(const DatabaseReader
 
 boost::asio::awaitable<silkworm::BlockBody> read_body(const DatabaseReader& reader, const evmc::bytes32& block_hash, uint64_t block_number);
 
+//! Read the hashes of just the canonical transactions at the specified indexes in the block, w/o reading the whole body:
+//! each one is hashed straight from its encoding, read at the base transaction id of the block plus its index
+boost::asio::awaitable<std::vector<evmc::bytes32>> read_transaction_hashes(const DatabaseReader& reader, const evmc::bytes32& block_hash, uint64_t block_number,
+    const std::vector<uint32_t>& tx_indexes);
+
 boost::asio::awaitable<silkworm::Bytes> read_header_rlp(const DatabaseReader& reader, const evmc::bytes32& block_hash, uint64_t block_number);
 
 boost::asio::awaitable<silkworm::Bytes> read_body_rlp(const DatabaseReader& reader, const evmc::bytes32& block_hash, uint64_t block_number);
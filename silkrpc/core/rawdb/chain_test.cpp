@@ -16,10 +16,15 @@
 
 #include "chain.hpp" // NOLINT(build/include)
 
+#include <chrono>
 #include <string>
+#include <vector>
 
 #include <boost/asio/co_spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
 #include <boost/asio/thread_pool.hpp>
+#include <boost/asio/use_awaitable.hpp>
 #include <boost/asio/use_future.hpp>
 #include <catch2/catch.hpp>
 #include <evmc/evmc.h>
@@ -29,6 +34,7 @@
 #include <silkworm/common/util.hpp>
 
 #include <silkrpc/common/block_cache.hpp>
+#include <silkrpc/common/util.hpp>
 #include <silkrpc/core/blocks.hpp>
 #include <silkrpc/ethdb/tables.hpp>
 
@@ -208,6 +214,72 @@ TEST_CASE("read_chain_config") {
     }
 }
 
+class ChainConfigCachingReader : public test::MockDatabaseReader {
+public:
+    uint64_t view_id() const override { return view_id_; }
+    ChainHeadCache* chain_head_cache() const override { return &chain_head_cache_; }
+
+    uint64_t view_id_{1};
+    mutable ChainHeadCache chain_head_cache_;
+};
+
+TEST_CASE("read_parsed_chain_config with chain head cache") {
+    boost::asio::thread_pool pool{1};
+    ChainConfigCachingReader db_reader;
+
+    SECTION("same view read and parsed once") {
+        EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kBlockHash; }
+        ));
+        EXPECT_CALL(db_reader, get_one(db::table::kConfig, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kChainConfig; }
+        ));
+        auto result1 = boost::asio::co_spawn(pool, read_parsed_chain_config(db_reader), boost::asio::use_future);
+        const auto chain_config1 = result1.get();
+        CHECK(chain_config1->silkworm_config);
+        auto result2 = boost::asio::co_spawn(pool, read_parsed_chain_config(db_reader), boost::asio::use_future);
+        CHECK(result2.get() == chain_config1);
+        auto result3 = boost::asio::co_spawn(pool, read_chain_id(db_reader), boost::asio::use_future);
+        CHECK(result3.get() == 1);
+    }
+
+    SECTION("new view checks unchanged config") {
+        EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kBlockHash; }
+        ));
+        EXPECT_CALL(db_reader, get_one(db::table::kConfig, _)).Times(2).WillRepeatedly(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kChainConfig; }
+        ));
+        auto result1 = boost::asio::co_spawn(pool, read_parsed_chain_config(db_reader), boost::asio::use_future);
+        const auto chain_config1 = result1.get();
+        db_reader.view_id_ = 2;
+        auto result2 = boost::asio::co_spawn(pool, read_parsed_chain_config(db_reader), boost::asio::use_future);
+        const auto chain_config2 = result2.get();
+        CHECK(chain_config2 == chain_config1);
+        CHECK(db_reader.chain_head_cache_.get_chain_config(2) == chain_config1);
+    }
+
+    SECTION("new view parses changed config again") {
+        EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kBlockHash; }
+        ));
+        EXPECT_CALL(db_reader, get_one(db::table::kConfig, _))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> { co_return kChainConfig; }))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> {
+                co_return silkworm::Bytes{reinterpret_cast<const uint8_t*>(R"({"chainId":5})")};
+            }));
+        auto result1 = boost::asio::co_spawn(pool, read_parsed_chain_config(db_reader), boost::asio::use_future);
+        const auto chain_config1 = result1.get();
+        db_reader.view_id_ = 2;
+        auto result2 = boost::asio::co_spawn(pool, read_parsed_chain_config(db_reader), boost::asio::use_future);
+        const auto chain_config2 = result2.get();
+        CHECK(chain_config2 != chain_config1);
+        CHECK(chain_config2->chain_config.genesis_hash == chain_config1->chain_config.genesis_hash);
+        CHECK(chain_config2->chain_config.config == R"({"chainId":5})"_json);
+        CHECK(chain_config2->data_hash != chain_config1->data_hash);
+    }
+}
+
 TEST_CASE("read_chain_id") {
     boost::asio::thread_pool pool{1};
     MockDatabaseReader db_reader;
@@ -291,6 +363,27 @@ TEST_CASE("read_canonical_block_hash") {
     }
 }
 
+TEST_CASE("read_canonical_block_hashes") {
+    boost::asio::thread_pool pool{1};
+    MockDatabaseReader db_reader;
+
+    SECTION("no block numbers") {
+        auto result = boost::asio::co_spawn(pool, read_canonical_block_hashes(db_reader, {}), boost::asio::use_future);
+        CHECK(result.get().empty());
+    }
+
+    SECTION("some canonical hashes not found") {
+        EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, _))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> { co_return kBlockHash; }))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }));
+        auto result = boost::asio::co_spawn(pool, read_canonical_block_hashes(db_reader, {4'000'000, 4'000'001}), boost::asio::use_future);
+        const auto block_hashes = result.get();
+        CHECK(block_hashes.size() == 2);
+        CHECK(block_hashes[0] == 0x439816753229fc0736bf86a5048de4bc9fcdede8c91dadf88c828c76b2281dff_bytes32);
+        CHECK(!block_hashes[1]);
+    }
+}
+
 TEST_CASE("read_total_difficulty") {
     boost::asio::thread_pool pool{1};
     MockDatabaseReader db_reader;
@@ -348,6 +441,9 @@ TEST_CASE("read_block_by_hash") {
         EXPECT_CALL(db_reader, get_one(db::table::kHeaders, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kBlockBodies, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, read_block_by_hash(db_reader, block_hash), boost::asio::use_future);
         CHECK_THROWS_AS(result.get(), std::runtime_error);
     }
@@ -360,6 +456,9 @@ TEST_CASE("read_block_by_hash") {
         EXPECT_CALL(db_reader, get_one(db::table::kHeaders, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{0x00, 0x01}; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kBlockBodies, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, read_block_by_hash(db_reader, block_hash), boost::asio::use_future);
         CHECK_THROWS_AS(result.get(), std::runtime_error);
     }
@@ -408,6 +507,9 @@ TEST_CASE("read_block_by_hash") {
         EXPECT_CALL(db_reader, walk(db::table::kEthTx, _, _, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<void> { co_return; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kSenders, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, read_block_by_hash(db_reader, block_hash), boost::asio::use_future);
         const silkworm::BlockWithHash bwh = result.get();
         check_expected_block_with_hash(bwh);
@@ -435,6 +537,9 @@ TEST_CASE("read_block_by_number") {
         EXPECT_CALL(db_reader, get_one(db::table::kHeaders, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kBlockBodies, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, read_block_by_number(db_reader, block_number), boost::asio::use_future);
         CHECK_THROWS_MATCHES(result.get(), std::runtime_error, Message("empty block header RLP in read_header"));
     }
@@ -447,6 +552,9 @@ TEST_CASE("read_block_by_number") {
         EXPECT_CALL(db_reader, get_one(db::table::kHeaders, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{0x00, 0x01}; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kBlockBodies, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, read_block_by_number(db_reader, block_number), boost::asio::use_future);
         CHECK_THROWS_MATCHES(result.get(), std::runtime_error, Message("invalid RLP decoding for block header"));
     }
@@ -495,6 +603,9 @@ TEST_CASE("read_block_by_number") {
         EXPECT_CALL(db_reader, walk(db::table::kEthTx, _, _, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<void> { co_return; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kSenders, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, read_block_by_number(db_reader, block_number), boost::asio::use_future);
         const silkworm::BlockWithHash bwh = result.get();
         check_expected_block_with_hash(bwh);
@@ -534,6 +645,31 @@ TEST_CASE("read_block_number_by_transaction_hash") {
     }
 }
 
+TEST_CASE("read_block_numbers_by_transaction_hashes") {
+    boost::asio::thread_pool pool{1};
+    MockDatabaseReader db_reader;
+
+    SECTION("no transaction hashes") {
+        auto result = boost::asio::co_spawn(pool, read_block_numbers_by_transaction_hashes(db_reader, {}), boost::asio::use_future);
+        CHECK(result.get().empty());
+    }
+
+    SECTION("some block numbers not found or invalid") {
+        const auto transaction_hash{0x18dcb90e76b61fe6f37c9a9cd269a66188c05af5f7a62c50ff3246c6e207dc6d_bytes32};
+        EXPECT_CALL(db_reader, get_one(db::table::kTxLookup, _))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> { co_return *silkworm::from_hex("3D0900"); }))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> { co_return *silkworm::from_hex("01FFFFFFFFFFFFFFFF"); }));
+        const std::vector<evmc::bytes32> transaction_hashes{transaction_hash, transaction_hash, transaction_hash};
+        auto result = boost::asio::co_spawn(pool, read_block_numbers_by_transaction_hashes(db_reader, transaction_hashes), boost::asio::use_future);
+        const auto block_numbers = result.get();
+        CHECK(block_numbers.size() == 3);
+        CHECK(block_numbers[0] == 4'000'000);
+        CHECK(!block_numbers[1]);
+        CHECK(!block_numbers[2]);
+    }
+}
+
 TEST_CASE("read_block") {
     boost::asio::thread_pool pool{1};
     MockDatabaseReader db_reader;
@@ -544,6 +680,9 @@ TEST_CASE("read_block") {
         EXPECT_CALL(db_reader, get_one(db::table::kHeaders, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kBlockBodies, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, read_block(db_reader, block_hash, block_number), boost::asio::use_future);
         CHECK_THROWS_MATCHES(result.get(), std::runtime_error, Message("empty block header RLP in read_header"));
     }
@@ -554,10 +693,37 @@ TEST_CASE("read_block") {
         EXPECT_CALL(db_reader, get_one(db::table::kHeaders, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{0x00, 0x01}; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kBlockBodies, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, read_block(db_reader, block_hash, block_number), boost::asio::use_future);
         CHECK_THROWS_MATCHES(result.get(), std::runtime_error, Message("invalid RLP decoding for block header"));
     }
 
+    SECTION("block header and body read concurrently") {
+        const auto block_hash{0x439816753229fc0736bf86a5048de4bc9fcdede8c91dadf88c828c76b2281dff_bytes32};
+        const uint64_t block_number{4'000'000};
+        std::vector<std::string> events;
+        EXPECT_CALL(db_reader, get_one(db::table::kHeaders, _)).WillOnce(InvokeWithoutArgs(
+            [&]() -> boost::asio::awaitable<silkworm::Bytes> {
+                events.push_back("header started");
+                boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor, std::chrono::milliseconds{10}};
+                co_await timer.async_wait(boost::asio::use_awaitable);
+                events.push_back("header completed");
+                co_return kHeader;
+            }
+        ));
+        EXPECT_CALL(db_reader, get_one(db::table::kBlockBodies, _)).WillOnce(InvokeWithoutArgs(
+            [&]() -> boost::asio::awaitable<silkworm::Bytes> {
+                events.push_back("body started");
+                co_return silkworm::Bytes{};
+            }
+        ));
+        auto result = boost::asio::co_spawn(pool, read_block(db_reader, block_hash, block_number), boost::asio::use_future);
+        CHECK_THROWS_MATCHES(result.get(), std::runtime_error, Message("empty block body RLP in read_body"));
+        CHECK(events == std::vector<std::string>{"header started", "body started", "header completed"});
+    }
+
     SECTION("block body not found") {
         const auto block_hash{0x439816753229fc0736bf86a5048de4bc9fcdede8c91dadf88c828c76b2281dff_bytes32};
         const uint64_t block_number{4'000'000};
@@ -596,6 +762,9 @@ TEST_CASE("read_block") {
         EXPECT_CALL(db_reader, walk(db::table::kEthTx, _, _, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<void> { co_return; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kSenders, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, read_block(db_reader, block_hash, block_number), boost::asio::use_future);
         const silkworm::BlockWithHash bwh = result.get();
         CHECK(bwh.block.transactions.size() == 0);
@@ -613,6 +782,9 @@ TEST_CASE("read_block") {
         EXPECT_CALL(db_reader, walk(db::table::kEthTx, _, _, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<void> { co_return; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kSenders, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, read_block(db_reader, block_hash, block_number), boost::asio::use_future);
         const silkworm::BlockWithHash bwh = result.get();
         check_expected_block_with_hash(bwh);
@@ -790,6 +962,9 @@ TEST_CASE("read_body") {
         EXPECT_CALL(db_reader, walk(db::table::kEthTx, _, _, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<void> { co_return; }
         ));
+        EXPECT_CALL(db_reader, get_one(db::table::kSenders, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
         auto result = boost::asio::co_spawn(pool, read_body(db_reader, block_hash, block_number), boost::asio::use_future);
         const silkworm::BlockBody body = result.get();
         check_expected_block_body(body);
@@ -864,6 +1039,48 @@ TEST_CASE("read_body") {
     }
 }
 
+TEST_CASE("read_transaction_hashes") {
+    boost::asio::thread_pool pool{1};
+    MockDatabaseReader db_reader;
+    const auto block_hash{0x439816753229fc0736bf86a5048de4bc9fcdede8c91dadf88c828c76b2281dff_bytes32};
+    const uint64_t block_number{4'000'000};
+
+    SECTION("no transaction indexes") {
+        auto result = boost::asio::co_spawn(pool, read_transaction_hashes(db_reader, block_hash, block_number, {}), boost::asio::use_future);
+        CHECK(result.get().empty());
+    }
+
+    SECTION("block body not found") {
+        EXPECT_CALL(db_reader, get_one(db::table::kBlockBodies, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
+        auto result = boost::asio::co_spawn(pool, read_transaction_hashes(db_reader, block_hash, block_number, {0}), boost::asio::use_future);
+        CHECK_THROWS_MATCHES(result.get(), std::runtime_error, Message("empty block body RLP in read_transaction_hashes"));
+    }
+
+    SECTION("transaction index out of range") {
+        EXPECT_CALL(db_reader, get_one(db::table::kBlockBodies, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kNotEmptyBody; }
+        ));
+        auto result = boost::asio::co_spawn(pool, read_transaction_hashes(db_reader, block_hash, block_number, {2}), boost::asio::use_future);
+        CHECK_THROWS_MATCHES(result.get(), std::runtime_error, Message("transaction index out of range in read_transaction_hashes"));
+    }
+
+    SECTION("just the requested transactions read") {
+        static const silkworm::Bytes kTxRlp{*silkworm::from_hex("02f86d0180843b9aca00")};
+        EXPECT_CALL(db_reader, get_one(db::table::kBlockBodies, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kNotEmptyBody; }
+        ));
+        EXPECT_CALL(db_reader, get_one(db::table::kEthTx, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kTxRlp; }
+        ));
+        auto result = boost::asio::co_spawn(pool, read_transaction_hashes(db_reader, block_hash, block_number, {1}), boost::asio::use_future);
+        const auto transaction_hashes = result.get();
+        CHECK(transaction_hashes.size() == 1);
+        CHECK(transaction_hashes[0] == silkworm::to_bytes32({hash_of(kTxRlp).bytes, silkworm::kHashLength}));
+    }
+}
+
 TEST_CASE("read_header_rlp") {
     boost::asio::thread_pool pool{1};
     MockDatabaseReader db_reader;
@@ -970,6 +1187,9 @@ TEST_CASE("read_raw_receipts") {
         EXPECT_CALL(db_reader, get_one(db::table::kBlockReceipts, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
         ));
+        EXPECT_CALL(db_reader, walk(db::table::kLogs, _, _, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<void> { co_return; }
+        ));
         auto result = boost::asio::co_spawn(pool, read_raw_receipts(db_reader, block_hash, block_number), boost::asio::use_future);
         //CHECK(result.get() == Receipts{}); // TODO(canepat): provide operator== and operator!= for Receipt type
         CHECK(result.get().size() == 0);
@@ -1126,6 +1346,9 @@ TEST_CASE("read_receipts") {
         EXPECT_CALL(db_reader, get_one(db::table::kBlockReceipts, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
         ));
+        EXPECT_CALL(db_reader, walk(db::table::kLogs, _, _, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<void> { co_return; }
+        ));
         auto result = boost::asio::co_spawn(pool, read_receipts(db_reader, block_with_hash), boost::asio::use_future);
         //CHECK(result.get() == Receipts{}); // TODO(canepat): provide operator== and operator!= for Receipt type
         CHECK(result.get().size() == 0);
@@ -1165,6 +1388,9 @@ TEST_CASE("read_receipts") {
         EXPECT_CALL(db_reader, get_one(db::table::kBlockReceipts, _)).WillOnce(InvokeWithoutArgs(
             []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
         ));
+        EXPECT_CALL(db_reader, walk(db::table::kLogs, _, _, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<void> { co_return; }
+        ));
         auto result1 = boost::asio::co_spawn(pool, read_receipts(db_reader, bwh), boost::asio::use_future);
         CHECK_THROWS_MATCHES(result1.get(), std::runtime_error, Message("#transactions and #receipts do not match in read_receipts"));
     }
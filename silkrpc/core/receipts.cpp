@@ -16,7 +16,11 @@
 
 #include "receipts.hpp"
 
+#include <utility>
+
+#include <silkrpc/common/disk_cache_codec.hpp>
 #include <silkrpc/common/log.hpp>
+#include <silkrpc/common/util.hpp>
 #include <silkrpc/core/rawdb/chain.hpp>
 
 namespace silkrpc::core {
@@ -34,4 +38,34 @@ boost::asio::awaitable<Receipts> get_receipts(const core::rawdb::DatabaseReader&
     co_return Receipts{};
 }
 
+boost::asio::awaitable<std::shared_ptr<const Receipts>> get_receipts(ReceiptCache& cache, const core::rawdb::DatabaseReader& db_reader,
+    const silkworm::BlockWithHash& block_with_hash) {
+    const auto cached_receipts = cache.get(block_with_hash.hash);
+    if (cached_receipts) {
+        co_return cached_receipts;
+    }
+    const auto disk_cache = cache.disk_cache();
+    if (disk_cache) {
+        const auto encoded = co_await disk_cache->async_get(DiskCache::Kind::receipts, block_with_hash.hash);
+        Receipts disk_cached_receipts;
+        if (encoded && decode_cached_receipts(*encoded, disk_cached_receipts)) {
+            auto receipts = std::make_shared<const Receipts>(std::move(disk_cached_receipts));
+            cache.insert(block_with_hash.hash, receipts);
+            co_return receipts;
+        }
+        if (encoded) {
+            SILKRPC_WARN << "invalid disk cached receipts of block " << block_with_hash.hash << ", reading them from the database\n";
+        }
+    }
+    auto receipts = std::make_shared<const Receipts>(co_await get_receipts(db_reader, block_with_hash));
+    if (!receipts->empty()) {
+        // don't save missing receipts to cache, they could be retrieved later by executing transactions
+        cache.insert(block_with_hash.hash, receipts);
+        if (disk_cache && !disk_cache->contains(DiskCache::Kind::receipts, block_with_hash.hash)) {
+            disk_cache->post_put(DiskCache::Kind::receipts, block_with_hash.hash, encode_cached_receipts(*receipts));
+        }
+    }
+    co_return receipts;
+}
+
 } // namespace silkrpc::core
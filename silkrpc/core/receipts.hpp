@@ -17,11 +17,14 @@
 #ifndef SILKRPC_CORE_RECEIPTS_HPP_
 #define SILKRPC_CORE_RECEIPTS_HPP_
 
+#include <memory>
+
 #include <silkrpc/config.hpp>
 
 #include <boost/asio/awaitable.hpp>
 #include <evmc/evmc.hpp>
 
+#include <silkrpc/common/receipt_cache.hpp>
 #include <silkrpc/core/rawdb/accessors.hpp>
 #include <silkrpc/types/receipt.hpp>
 
@@ -31,6 +34,10 @@ namespace silkrpc::core {
 
 boost::asio::awaitable<Receipts> get_receipts(const rawdb::DatabaseReader& db_reader, const silkworm::BlockWithHash& block_with_hash);
 
+//! Get the receipts of the block from the cache, if any, or from the database filling the cache otherwise
+boost::asio::awaitable<std::shared_ptr<const Receipts>> get_receipts(ReceiptCache& cache, const rawdb::DatabaseReader& db_reader,
+    const silkworm::BlockWithHash& block_with_hash);
+
 } // namespace silkrpc::core
 
 #endif  // SILKRPC_CORE_RECEIPTS_HPP_
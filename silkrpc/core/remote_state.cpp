@@ -16,33 +16,45 @@
 
 #include "remote_state.hpp"
 
-#include <future>
+#include <memory>
 #include <unordered_map>
 #include <utility>
 
-#include <boost/asio/co_spawn.hpp>
-#include <boost/asio/use_future.hpp>
 #include <silkworm/common/util.hpp>
 
 #include <silkrpc/common/log.hpp>
+#include <silkrpc/concurrency/sync_wait.hpp>
 #include <silkrpc/core/blocks.hpp>
 #include <silkrpc/core/rawdb/chain.hpp>
 
 namespace silkrpc::state {
 
-static std::unordered_map<evmc::bytes32, silkworm::Bytes> code;
-
 boost::asio::awaitable<std::optional<silkworm::Account>> AsyncRemoteState::read_account(const evmc::address& address) const noexcept {
     co_return co_await state_reader_.read_account(address, block_number_ + 1);
 }
 
+boost::asio::awaitable<std::vector<std::optional<silkworm::Account>>> AsyncRemoteState::read_accounts(const std::vector<evmc::address>& addresses) const {
+    co_return co_await state_reader_.read_accounts(addresses, block_number_ + 1);
+}
+
 boost::asio::awaitable<silkworm::ByteView> AsyncRemoteState::read_code(const evmc::bytes32& code_hash) const noexcept {
-    const auto optional_code{co_await state_reader_.read_code(code_hash)};
-    if (optional_code) {
-        code[code_hash] = std::move(*optional_code);
-        co_return code[code_hash]; // NOLINT(runtime/arrays)
+    const auto code_it = code_.find(code_hash);
+    if (code_it != code_.end()) {
+        co_return *code_it->second;
+    }
+    auto code{code_cache_ ? code_cache_->get(code_hash) : nullptr};
+    if (!code) {
+        auto optional_code{co_await state_reader_.read_code(code_hash)};
+        if (!optional_code) {
+            co_return silkworm::ByteView{};
+        }
+        code = std::make_shared<const silkworm::Bytes>(std::move(*optional_code));
+        if (code_cache_ && !code->empty()) {
+            code_cache_->insert(code_hash, code);
+        }
     }
-    co_return silkworm::ByteView{};
+    code_.emplace(code_hash, code);
+    co_return *code;
 }
 
 boost::asio::awaitable<evmc::bytes32> AsyncRemoteState::read_storage(const evmc::address& address, uint64_t incarnation, const evmc::bytes32& location) const noexcept {
@@ -82,9 +94,14 @@ boost::asio::awaitable<std::optional<evmc::bytes32>> AsyncRemoteState::canonical
 
 std::optional<silkworm::Account> RemoteState::read_account(const evmc::address& address) const noexcept {
     SILKRPC_DEBUG << "RemoteState::read_account address=" << address << " start\n";
+    accessed_state_.accounts.push_back(address);
+    const auto prefetched_it = prefetched_accounts_.find(address);
+    if (prefetched_it != prefetched_accounts_.end()) {
+        SILKRPC_DEBUG << "RemoteState::read_account address=" << address << " prefetched\n";
+        return prefetched_it->second;
+    }
     try {
-        std::future<std::optional<silkworm::Account>> result{boost::asio::co_spawn(io_context_, async_state_.read_account(address), boost::asio::use_future)};
-        const auto optional_account{result.get()};
+        const auto optional_account{sync_wait(handoff_, async_state_.read_account(address))};
         SILKRPC_DEBUG << "RemoteState::read_account account.nonce=" << (optional_account ? optional_account->nonce : 0) << " end\n";
         return optional_account;
     } catch (const std::exception& e) {
@@ -96,8 +113,8 @@ std::optional<silkworm::Account> RemoteState::read_account(const evmc::address&
 silkworm::ByteView RemoteState::read_code(const evmc::bytes32& code_hash) const noexcept {
     SILKRPC_DEBUG << "RemoteState::read_code code_hash=" << code_hash << " start\n";
     try {
-        std::future<silkworm::ByteView> result{boost::asio::co_spawn(io_context_, async_state_.read_code(code_hash), boost::asio::use_future)};
-        const auto code{result.get()};
+        const auto code{sync_wait(handoff_, async_state_.read_code(code_hash))};
+        accessed_code_.emplace_back(code_hash, code);
         return code;
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "RemoteState::read_code exception: " << e.what() << "\n";
@@ -107,9 +124,14 @@ silkworm::ByteView RemoteState::read_code(const evmc::bytes32& code_hash) const
 
 evmc::bytes32 RemoteState::read_storage(const evmc::address& address, uint64_t incarnation, const evmc::bytes32& location) const noexcept {
     SILKRPC_DEBUG << "RemoteState::read_storage address=" << address << " incarnation=" << incarnation << " location=" << location << " start\n";
+    accessed_state_.locations.emplace_back(address, location);
+    const auto prefetched_it = prefetched_storage_.find(StorageKey{address, incarnation, location});
+    if (prefetched_it != prefetched_storage_.end()) {
+        SILKRPC_DEBUG << "RemoteState::read_storage storage_value=" << prefetched_it->second << " prefetched\n";
+        return prefetched_it->second;
+    }
     try {
-        std::future<evmc::bytes32> result{boost::asio::co_spawn(io_context_, async_state_.read_storage(address, incarnation, location), boost::asio::use_future)};
-        const auto storage_value{result.get()};
+        const auto storage_value{sync_wait(handoff_, async_state_.read_storage(address, incarnation, location))};
         SILKRPC_DEBUG << "RemoteState::read_storage storage_value=" << storage_value << " end\n";
         return storage_value;
     } catch (const std::exception& e) {
@@ -126,8 +148,7 @@ uint64_t RemoteState::previous_incarnation(const evmc::address& address) const n
 std::optional<silkworm::BlockHeader> RemoteState::read_header(uint64_t block_number, const evmc::bytes32& block_hash) const noexcept {
     SILKRPC_DEBUG << "RemoteState::read_header block_number=" << block_number << " block_hash=" << block_hash << "\n";
     try {
-        std::future<std::optional<silkworm::BlockHeader>> result{boost::asio::co_spawn(io_context_, async_state_.read_header(block_number, block_hash), boost::asio::use_future)};
-        const auto optional_header{result.get()};
+        const auto optional_header{sync_wait(handoff_, async_state_.read_header(block_number, block_hash))};
         SILKRPC_DEBUG << "RemoteState::read_header block_number=" << block_number << " block_hash=" << block_hash << "\n";
         return optional_header;
     } catch (const std::exception& e) {
@@ -139,9 +160,9 @@ std::optional<silkworm::BlockHeader> RemoteState::read_header(uint64_t block_num
 bool RemoteState::read_body(uint64_t block_number, const evmc::bytes32& block_hash, silkworm::BlockBody& filled_body) const noexcept {
     SILKRPC_DEBUG << "RemoteState::read_body block_number=" << block_number << " block_hash=" << block_hash << "\n";
     try {
-        auto result{boost::asio::co_spawn(io_context_, async_state_.read_body(block_number, block_hash, filled_body), boost::asio::use_future)};
+        const auto result{sync_wait(handoff_, async_state_.read_body(block_number, block_hash, filled_body))};
         SILKRPC_DEBUG << "RemoteState::read_body block_number=" << block_number << " block_hash=" << block_hash << "\n";
-        return result.get();
+        return result;
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "RemoteState::read_body exception: " << e.what() << "\n";
         return false;
@@ -151,8 +172,7 @@ bool RemoteState::read_body(uint64_t block_number, const evmc::bytes32& block_ha
 std::optional<intx::uint256> RemoteState::total_difficulty(uint64_t block_number, const evmc::bytes32& block_hash) const noexcept {
     SILKRPC_DEBUG << "RemoteState::total_difficulty block_number=" << block_number << " block_hash=" << block_hash << "\n";
     try {
-        std::future<std::optional<intx::uint256>> result{boost::asio::co_spawn(io_context_, async_state_.total_difficulty(block_number, block_hash), boost::asio::use_future)};
-        const auto optional_total_difficulty{result.get()};
+        const auto optional_total_difficulty{sync_wait(handoff_, async_state_.total_difficulty(block_number, block_hash))};
         SILKRPC_DEBUG << "RemoteState::total_difficulty block_number=" << block_number << " block_hash=" << block_hash << "\n";
         return optional_total_difficulty;
     } catch (const std::exception& e) {
@@ -176,4 +196,39 @@ std::optional<evmc::bytes32> RemoteState::canonical_hash(uint64_t block_number)
     return std::nullopt;
 }
 
+boost::asio::awaitable<void> RemoteState::prefetch(const AccessedState& state) {
+    std::vector<evmc::address> addresses;
+    addresses.reserve(state.accounts.size());
+    for (const auto& address : state.accounts) {
+        if (!prefetched_accounts_.contains(address)) {
+            addresses.push_back(address);
+        }
+    }
+    SILKRPC_DEBUG << "RemoteState::prefetch #accounts=" << addresses.size() << " #locations=" << state.locations.size() << " start\n";
+
+    try {
+        // All the current accounts are read in one go, the storage locations just need the incarnation of their account
+        const auto accounts{co_await async_state_.read_accounts(addresses)};
+        for (std::size_t i{0}; i < addresses.size(); ++i) {
+            prefetched_accounts_.emplace(addresses[i], accounts[i]);
+        }
+        for (const auto& [address, location] : state.locations) {
+            const auto account_it = prefetched_accounts_.find(address);
+            if (account_it == prefetched_accounts_.end() || !account_it->second) {
+                continue;
+            }
+            StorageKey storage_key{address, account_it->second->incarnation, location};
+            if (prefetched_storage_.contains(storage_key)) {
+                continue;
+            }
+            const auto storage_value{co_await async_state_.read_storage(address, account_it->second->incarnation, location)};
+            prefetched_storage_.emplace(std::move(storage_key), storage_value);
+        }
+    } catch (const std::exception& e) {
+        SILKRPC_WARN << "RemoteState::prefetch exception: " << e.what() << "\n";
+    }
+
+    SILKRPC_DEBUG << "RemoteState::prefetch #accounts=" << prefetched_accounts_.size() << " #storage=" << prefetched_storage_.size() << " end\n";
+}
+
 } // namespace silkrpc::state
@@ -18,8 +18,13 @@
 #define SILKRPC_CORE_REMOTE_STATE_HPP_
 
 #include <iostream>
+#include <map>
+#include <memory>
 #include <optional>
 #include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <silkrpc/config.hpp> // NOLINT(build/include_order)
@@ -29,6 +34,10 @@
 #include <evmc/evmc.hpp>
 #include <silkworm/common/util.hpp>
 
+#include <silkrpc/common/access_history.hpp>
+#include <silkrpc/common/code_cache.hpp>
+#include <silkrpc/common/history_cache.hpp>
+#include <silkrpc/concurrency/handoff.hpp>
 #include <silkrpc/core/rawdb/accessors.hpp>
 #include <silkrpc/core/state_reader.hpp>
 #include <silkworm/state/state.hpp>
@@ -37,11 +46,15 @@ namespace silkrpc::state {
 
 class AsyncRemoteState {
 public:
-    explicit AsyncRemoteState(boost::asio::io_context& io_context, const core::rawdb::DatabaseReader& db_reader, uint64_t block_number)
-    : io_context_(io_context), db_reader_(db_reader), block_number_(block_number), state_reader_{db_reader} {}
+    explicit AsyncRemoteState(boost::asio::io_context& io_context, const core::rawdb::DatabaseReader& db_reader, uint64_t block_number,
+        std::shared_ptr<HistoryCache> history_cache = nullptr, std::shared_ptr<CodeCache> code_cache = nullptr)
+    : io_context_(io_context), db_reader_(db_reader), block_number_(block_number), state_reader_{db_reader, std::move(history_cache)},
+      code_cache_{std::move(code_cache)} {}
 
     boost::asio::awaitable<std::optional<silkworm::Account>> read_account(const evmc::address& address) const noexcept;
 
+    boost::asio::awaitable<std::vector<std::optional<silkworm::Account>>> read_accounts(const std::vector<evmc::address>& addresses) const;
+
     boost::asio::awaitable<silkworm::ByteView> read_code(const evmc::bytes32& code_hash) const noexcept;
 
     boost::asio::awaitable<evmc::bytes32> read_storage(const evmc::address& address, uint64_t incarnation, const evmc::bytes32& location) const noexcept;
@@ -65,12 +78,18 @@ private:
     const core::rawdb::DatabaseReader& db_reader_;
     uint64_t block_number_;
     StateReader state_reader_;
+    std::shared_ptr<CodeCache> code_cache_;
+
+    //! The code read so far, kept alive here because the views handed out must outlive any eviction from the code cache
+    mutable std::unordered_map<evmc::bytes32, std::shared_ptr<const silkworm::Bytes>> code_;
 };
 
 class RemoteState : public silkworm::State {
 public:
-    explicit RemoteState(boost::asio::io_context& io_context, const core::rawdb::DatabaseReader& db_reader, uint64_t block_number)
-    : io_context_(io_context), async_state_{io_context, db_reader, block_number} {}
+    explicit RemoteState(boost::asio::io_context& io_context, const core::rawdb::DatabaseReader& db_reader, uint64_t block_number,
+        std::shared_ptr<HistoryCache> history_cache = nullptr, std::shared_ptr<CodeCache> code_cache = nullptr)
+    : handoff_(boost::asio::use_service<Handoff>(io_context)),
+      async_state_{io_context, db_reader, block_number, std::move(history_cache), std::move(code_cache)} {}
 
     std::optional<silkworm::Account> read_account(const evmc::address& address) const noexcept override;
 
@@ -92,6 +111,16 @@ public:
 
     std::optional<evmc::bytes32> canonical_hash(uint64_t block_number) const override;
 
+    //! Load asynchronously the given accounts and locations before execution, so that the EVM will find them already here
+    //! instead of blocking on one database read at a time. Prefetch failures are just logged: the state is read on demand.
+    boost::asio::awaitable<void> prefetch(const AccessedState& state);
+
+    //! The accounts and locations read by the EVM through this state so far, whether prefetched or not
+    const AccessedState& accessed_state() const noexcept { return accessed_state_; }
+
+    //! The code read by the EVM through this state so far by code hash, the views being valid as long as this state
+    const std::vector<std::pair<evmc::bytes32, silkworm::ByteView>>& accessed_code() const noexcept { return accessed_code_; }
+
     void insert_block(const silkworm::Block& block, const evmc::bytes32& hash) override {}
 
     void canonize_block(uint64_t block_number, const evmc::bytes32& block_hash) override {}
@@ -123,8 +152,18 @@ public:
     void unwind_state_changes(uint64_t block_number) override {}
 
 private:
-    boost::asio::io_context& io_context_;
+    using StorageKey = std::tuple<evmc::address, uint64_t, evmc::bytes32>;
+
+    //! The handoff of the reads from the EVM thread to the io_context thread
+    Handoff& handoff_;
     AsyncRemoteState async_state_;
+
+    //! The state loaded by prefetch, never accessed concurrently because prefetch completes before execution starts
+    std::unordered_map<evmc::address, std::optional<silkworm::Account>> prefetched_accounts_;
+    std::map<StorageKey, evmc::bytes32> prefetched_storage_;
+
+    mutable AccessedState accessed_state_;
+    mutable std::vector<std::pair<evmc::bytes32, silkworm::ByteView>> accessed_code_;
 };
 
 std::ostream& operator<<(std::ostream& out, const RemoteState& s);
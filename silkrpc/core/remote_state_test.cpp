@@ -16,6 +16,10 @@
 
 #include "remote_state.hpp"
 
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include <boost/asio/co_spawn.hpp>
 #include <boost/asio/use_future.hpp>
 #include <boost/asio/thread_pool.hpp>
@@ -108,6 +112,28 @@ TEST_CASE("async remote buffer", "[silkrpc][core][remote_buffer]") {
         CHECK(future_code.get() == silkworm::ByteView{code});
     }
 
+    SECTION("read_code from code cache") {
+        boost::asio::io_context io_context;
+        silkworm::Bytes code{*silkworm::from_hex("0x0608")};
+        MockDatabaseReader db_reader{code};
+        MockDatabaseReader empty_db_reader;
+        const uint64_t block_number = 1'000'000;
+        auto code_cache{std::make_shared<CodeCache>()};
+        AsyncRemoteState state{io_context, db_reader, block_number, nullptr, code_cache};
+        const auto code_hash{0x04491edcd115127caedbd478e2e7895ed80c7847e903431f94f9cfa579cad47f_bytes32};
+        auto future_code{boost::asio::co_spawn(io_context, state.read_code(code_hash), boost::asio::use_future)};
+        io_context.run();
+        CHECK(future_code.get() == silkworm::ByteView{code});
+        CHECK(code_cache->size() == 1);
+
+        // Any other state finds the code in cache without reading the database
+        AsyncRemoteState other_state{io_context, empty_db_reader, block_number, nullptr, code_cache};
+        auto other_future_code{boost::asio::co_spawn(io_context, other_state.read_code(code_hash), boost::asio::use_future)};
+        io_context.restart();
+        io_context.run();
+        CHECK(other_future_code.get() == silkworm::ByteView{code});
+    }
+
     SECTION("read_code with empty response from db") {
         boost::asio::io_context io_context;
         boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work{io_context.get_executor()};
@@ -442,4 +468,71 @@ TEST_CASE_METHOD(RemoteStateTest, "RemoteState") {
     }
 }
 
+TEST_CASE("remote state prefetch", "[silkrpc][core][remote_state]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+
+    class CountingDatabaseReader : public core::rawdb::DatabaseReader {
+    public:
+        boost::asio::awaitable<KeyValue> get(const std::string& table, const silkworm::ByteView& key) const override {
+            co_return KeyValue{};
+        }
+        boost::asio::awaitable<silkworm::Bytes> get_one(const std::string& table, const silkworm::ByteView& key) const override {
+            ++reads;
+            co_return *silkworm::from_hex("0f01020203e8010520f1885eda54b7a053318cd41e2093220dab15d65381b1157a3633a83bfd5c9239");
+        }
+        boost::asio::awaitable<std::optional<silkworm::Bytes>> get_both_range(const std::string& table, const silkworm::ByteView& key, const silkworm::ByteView& subkey) const override {
+            ++reads;
+            co_return *silkworm::from_hex("0x0608");
+        }
+        boost::asio::awaitable<void> walk(const std::string& table, const silkworm::ByteView& start_key, uint32_t fixed_bits, core::rawdb::Walker w) const override {
+            co_return;
+        }
+        boost::asio::awaitable<void> for_prefix(const std::string& table, const silkworm::ByteView& prefix, core::rawdb::Walker w) const override {
+            co_return;
+        }
+
+        mutable std::size_t reads{0};
+    };
+
+    boost::asio::io_context io_context;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work{io_context.get_executor()};
+    std::thread io_context_thread{[&io_context]() { io_context.run(); }};
+
+    CountingDatabaseReader db_reader;
+    const uint64_t block_number = 1'000'000;
+    const evmc::address address{0x0715a7794a1dc8e42615f059dd6e406a6594651a_address};
+    const auto location{0x04491edcd115127caedbd478e2e7895ed80c7847e903431f94f9cfa579cad47f_bytes32};
+    RemoteState remote_state(io_context, db_reader, block_number);
+
+    SECTION("prefetched state is read w/o accessing the database") {
+        const AccessedState state{{address}, {{address, location}}};
+        CHECK_NOTHROW(boost::asio::co_spawn(io_context, remote_state.prefetch(state), boost::asio::use_future).get());
+        CHECK(db_reader.reads == 2);
+
+        const auto account = remote_state.read_account(address);
+        REQUIRE(account);
+        CHECK(account->incarnation == 5);
+        CHECK(remote_state.read_storage(address, account->incarnation, location) != evmc::bytes32{});
+        CHECK(db_reader.reads == 2);
+
+        CHECK(remote_state.accessed_state().accounts == std::vector<evmc::address>{address});
+        CHECK(remote_state.accessed_state().locations == std::vector<StorageLocation>{{address, location}});
+    }
+
+    SECTION("state already prefetched is not read again") {
+        const AccessedState state{{address}, {{address, location}}};
+        CHECK_NOTHROW(boost::asio::co_spawn(io_context, remote_state.prefetch(state), boost::asio::use_future).get());
+        CHECK_NOTHROW(boost::asio::co_spawn(io_context, remote_state.prefetch(state), boost::asio::use_future).get());
+        CHECK(db_reader.reads == 2);
+    }
+
+    SECTION("state not prefetched is read from the database") {
+        CHECK(remote_state.read_account(address));
+        CHECK(db_reader.reads == 1);
+    }
+
+    io_context.stop();
+    io_context_thread.join();
+}
+
 } // namespace silkrpc::state
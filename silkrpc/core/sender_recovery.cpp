@@ -0,0 +1,160 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "sender_recovery.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/compose.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/types/transaction.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/concurrency/parallel_for.hpp>
+
+namespace silkrpc::core {
+
+SenderRecovery::SenderRecovery(boost::asio::thread_pool& workers, std::shared_ptr<SenderCache> sender_cache, std::size_t max_batch_size)
+    : workers_{workers}, sender_cache_{std::move(sender_cache)}, max_batch_size_{max_batch_size > 0 ? max_batch_size : 1} {}
+
+boost::asio::awaitable<RecoveredTransaction> SenderRecovery::recover(silkworm::Bytes rlp) {
+    const auto executor = co_await boost::asio::this_coro::executor;
+    co_return co_await boost::asio::async_compose<decltype(boost::asio::use_awaitable), void(RecoveredTransaction)>(
+        [&](auto&& self) {
+            auto shared_self = std::make_shared<std::decay_t<decltype(self)>>(std::move(self));
+            enqueue(Job{std::move(rlp), [executor, shared_self](RecoveredTransaction recovered) {
+                boost::asio::post(executor, [shared_self, recovered = std::move(recovered)]() mutable {
+                    shared_self->complete(std::move(recovered));
+                });
+            }});
+        },
+        boost::asio::use_awaitable);
+}
+
+bool SenderRecovery::lookup_sender(const evmc::bytes32& hash, Transaction& transaction) const {
+    if (!sender_cache_) {
+        return false;
+    }
+    const auto sender = sender_cache_->get(hash);
+    if (!sender) {
+        return false;
+    }
+    transaction.from = *sender;
+    return true;
+}
+
+boost::asio::awaitable<std::size_t> SenderRecovery::recover_senders(silkworm::Block& block) {
+    std::vector<silkworm::Transaction*> missing;
+    for (auto& transaction : block.transactions) {
+        if (!transaction.from) {
+            missing.push_back(&transaction);
+        }
+    }
+    if (missing.empty()) {
+        co_return 0;
+    }
+    SILKRPC_DEBUG << "SenderRecovery::recover_senders block: " << block.header.number << " #missing: " << missing.size() << "\n";
+
+    const auto executor = co_await boost::asio::this_coro::executor;
+    const auto num_chunks = (missing.size() + kBlockChunkSize - 1) / kBlockChunkSize;
+    co_await parallel_for(executor, num_chunks, num_chunks, [&](std::size_t chunk) -> boost::asio::awaitable<void> {
+        const auto begin = chunk * kBlockChunkSize;
+        const auto end = std::min(begin + kBlockChunkSize, missing.size());
+        co_await boost::asio::async_compose<decltype(boost::asio::use_awaitable), void()>(
+            [&](auto&& self) {
+                boost::asio::post(workers_, [&missing, begin, end, executor, self = std::move(self)]() mutable {
+                    for (auto i{begin}; i < end; ++i) {
+                        missing[i]->recover_sender();
+                    }
+                    boost::asio::post(executor, [self = std::move(self)]() mutable { self.complete(); });
+                });
+            },
+            boost::asio::use_awaitable);
+    });
+
+    co_return static_cast<std::size_t>(std::count_if(missing.cbegin(), missing.cend(), [](const auto* txn) { return txn->from.has_value(); }));
+}
+
+bool SenderRecovery::has_missing_senders(const silkworm::Block& block) {
+    return std::any_of(block.transactions.cbegin(), block.transactions.cend(), [](const auto& txn) { return !txn.from; });
+}
+
+RecoveredTransaction SenderRecovery::decode_and_recover(silkworm::ByteView rlp) {
+    RecoveredTransaction recovered;
+    const auto hash{silkworm::keccak256(rlp)};
+    std::memcpy(recovered.hash.bytes, hash.bytes, sizeof(recovered.hash.bytes));
+
+    silkworm::ByteView encoded_tx{rlp};
+    recovered.result = silkworm::rlp::decode<silkworm::Transaction>(encoded_tx, recovered.transaction);
+    if (recovered.result == silkworm::DecodingResult::kOk) {
+        recovered.transaction.recover_sender();
+    }
+    return recovered;
+}
+
+void SenderRecovery::enqueue(Job job) {
+    std::lock_guard lock{jobs_mutex_};
+    jobs_.push_back(std::move(job));
+    if (!batch_posted_) {
+        batch_posted_ = true;
+        boost::asio::post(workers_, [this]() { recover_batch(); });
+    }
+}
+
+void SenderRecovery::recover_batch() {
+    std::vector<Job> batch;
+    {
+        std::lock_guard lock{jobs_mutex_};
+        const auto batch_size = std::min(jobs_.size(), max_batch_size_);
+        batch.reserve(batch_size);
+        for (std::size_t i{0}; i < batch_size; ++i) {
+            batch.push_back(std::move(jobs_.front()));
+            jobs_.pop_front();
+        }
+    }
+    SILKRPC_TRACE << "SenderRecovery::recover_batch #jobs: " << batch.size() << "\n";
+
+    std::vector<RecoveredTransaction> recovered_batch;
+    recovered_batch.reserve(batch.size());
+    for (const auto& job : batch) {
+        auto recovered = decode_and_recover(job.rlp);
+        if (sender_cache_ && recovered.transaction.from) {
+            sender_cache_->insert(recovered.hash, std::make_shared<evmc::address>(*recovered.transaction.from));
+        }
+        recovered_batch.push_back(std::move(recovered));
+    }
+
+    {
+        std::lock_guard lock{jobs_mutex_};
+        if (jobs_.empty()) {
+            batch_posted_ = false;
+        } else {
+            boost::asio::post(workers_, [this]() { recover_batch(); });
+        }
+    }
+
+    // Complete the jobs last, because the callers resumed may destroy this object
+    for (std::size_t i{0}; i < batch.size(); ++i) {
+        batch[i].complete(std::move(recovered_batch[i]));
+    }
+}
+
+} // namespace silkrpc::core
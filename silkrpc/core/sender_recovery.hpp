@@ -0,0 +1,104 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef SILKRPC_CORE_SENDER_RECOVERY_HPP_
+#define SILKRPC_CORE_SENDER_RECOVERY_HPP_
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include <silkrpc/config.hpp> // NOLINT(build/include_order)
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <evmc/evmc.hpp>
+#include <silkworm/common/base.hpp>
+#include <silkworm/rlp/decode.hpp>
+#include <silkworm/types/block.hpp>
+
+#include <silkrpc/common/sender_cache.hpp>
+#include <silkrpc/types/transaction.hpp>
+
+namespace silkrpc::core {
+
+//! The raw transaction decoded, hashed and with its sender recovered, if decoding succeeded
+struct RecoveredTransaction {
+    silkworm::DecodingResult result{silkworm::DecodingResult::kOk};
+    Transaction transaction;
+    evmc::bytes32 hash;
+};
+
+//! Decoding and sender recovery of the raw transactions on the worker threads, so that the signature recovery does not
+//! stall the I/O context. The transactions submitted while a batch is being recovered are queued and recovered by the next
+//! worker task all together, so that a burst of submissions costs one task rather than one each. The recovered senders are
+//! cached by transaction hash, if a cache is given, for the later lookups of the same transactions while pending.
+class SenderRecovery {
+public:
+    //! The default maximum number of transactions recovered by one worker task
+    static constexpr std::size_t kDefaultMaxBatchSize{64};
+
+    //! The number of transactions of a block recovered by one worker task
+    static constexpr std::size_t kBlockChunkSize{32};
+
+    explicit SenderRecovery(boost::asio::thread_pool& workers, std::shared_ptr<SenderCache> sender_cache = nullptr,
+        std::size_t max_batch_size = kDefaultMaxBatchSize);
+
+    SenderRecovery(const SenderRecovery&) = delete;
+    SenderRecovery& operator=(const SenderRecovery&) = delete;
+
+    //! Decode the raw transaction and recover its sender on the workers, resuming the caller on its own executor
+    boost::asio::awaitable<RecoveredTransaction> recover(silkworm::Bytes rlp);
+
+    std::shared_ptr<SenderCache>& sender_cache() noexcept { return sender_cache_; }
+
+    //! Set the sender of the transaction from the cache, if any and known: return true if the sender is set
+    bool lookup_sender(const evmc::bytes32& hash, Transaction& transaction) const;
+
+    //! Recover on the workers the senders missing from the transactions of the block, split in chunks recovered in
+    //! parallel: return the number of senders recovered. The caller must own the block until resumed.
+    boost::asio::awaitable<std::size_t> recover_senders(silkworm::Block& block);
+
+    //! Return true if the sender of any transaction in the block is missing
+    static bool has_missing_senders(const silkworm::Block& block);
+
+    //! Decode the raw transaction and recover its sender on the calling thread
+    static RecoveredTransaction decode_and_recover(silkworm::ByteView rlp);
+
+private:
+    struct Job {
+        silkworm::Bytes rlp;
+        std::function<void(RecoveredTransaction)> complete;
+    };
+
+    //! Queue the job, posting a batch to the workers unless one is already running
+    void enqueue(Job job);
+
+    //! Recover the next batch of queued jobs, posting another batch if more jobs have been queued meanwhile
+    void recover_batch();
+
+    boost::asio::thread_pool& workers_;
+    std::shared_ptr<SenderCache> sender_cache_;
+    std::size_t max_batch_size_;
+    std::mutex jobs_mutex_;
+    std::deque<Job> jobs_;
+    bool batch_posted_{false};
+};
+
+} // namespace silkrpc::core
+
+#endif // SILKRPC_CORE_SENDER_RECOVERY_HPP_
@@ -0,0 +1,138 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "sender_recovery.hpp"
+
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/use_future.hpp>
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+#include <silkworm/common/util.hpp>
+
+namespace silkrpc::core {
+
+using evmc::literals::operator""_address, evmc::literals::operator""_bytes32;
+
+//! The signed raw transaction 0x4f85816f12361224a8ee15a4bd643faf3b59beba85f4942c2d0c7e19ea0ad46b on Goerli, having nonce 25
+static const silkworm::Bytes kSignedTransaction{*silkworm::from_hex(
+    "0x02f8ad05198302a5b28302a5b282b640948efe26d6839108e831d3a37ca503ea4f136a8e7380b844395093510000000000000000000000"
+    "00d179c5bed30cade4e62d53dd89240745fb4c0cc20000000000000000000000000000000000000000000000001bc16d674ec80000c080a0"
+    "471cd0902900e7c9e1fb065c75c7516103c602c46010e0b8bb1fedead6eda570a01e47dff22e5f312176cee6bc5bc4430e2c2be3f3ec45c7"
+    "e37b953f27b62e8f53")};
+static const evmc::bytes32 kSignedTransactionHash{0x4f85816f12361224a8ee15a4bd643faf3b59beba85f4942c2d0c7e19ea0ad46b_bytes32};
+
+TEST_CASE("SenderRecovery::decode_and_recover", "[silkrpc][core][sender_recovery]") {
+    SECTION("signed transaction") {
+        const auto recovered = SenderRecovery::decode_and_recover(kSignedTransaction);
+        CHECK(recovered.result == silkworm::DecodingResult::kOk);
+        CHECK(recovered.hash == kSignedTransactionHash);
+        CHECK(recovered.transaction.nonce == 25);
+        CHECK(recovered.transaction.from.has_value());
+    }
+
+    SECTION("invalid RLP") {
+        const auto recovered = SenderRecovery::decode_and_recover(silkworm::Bytes{0x02, 0xf8});
+        CHECK(recovered.result != silkworm::DecodingResult::kOk);
+        CHECK(!recovered.transaction.from);
+    }
+}
+
+TEST_CASE("SenderRecovery::recover", "[silkrpc][core][sender_recovery]") {
+    const auto expected_sender = SenderRecovery::decode_and_recover(kSignedTransaction).transaction.from;
+    REQUIRE(expected_sender);
+
+    boost::asio::thread_pool workers{2};
+    boost::asio::thread_pool callers{1};
+
+    SECTION("caches the recovered sender") {
+        SenderRecovery sender_recovery{workers, std::make_shared<SenderCache>()};
+        Transaction transaction;
+        CHECK(!sender_recovery.lookup_sender(kSignedTransactionHash, transaction));
+
+        auto result = boost::asio::co_spawn(callers, sender_recovery.recover(kSignedTransaction), boost::asio::use_future);
+        const auto recovered = result.get();
+        CHECK(recovered.result == silkworm::DecodingResult::kOk);
+        CHECK(recovered.hash == kSignedTransactionHash);
+        CHECK(recovered.transaction.from == expected_sender);
+
+        CHECK(sender_recovery.lookup_sender(kSignedTransactionHash, transaction));
+        CHECK(transaction.from == expected_sender);
+    }
+
+    SECTION("without cache") {
+        SenderRecovery sender_recovery{workers};
+        auto result = boost::asio::co_spawn(callers, sender_recovery.recover(kSignedTransaction), boost::asio::use_future);
+        CHECK(result.get().transaction.from == expected_sender);
+        Transaction transaction;
+        CHECK(!sender_recovery.lookup_sender(kSignedTransactionHash, transaction));
+    }
+
+    SECTION("concurrent submissions in small batches") {
+        SenderRecovery sender_recovery{workers, std::make_shared<SenderCache>(), 2};
+        std::vector<std::future<RecoveredTransaction>> results;
+        for (std::size_t i{0}; i < 9; ++i) {
+            results.push_back(boost::asio::co_spawn(callers, sender_recovery.recover(kSignedTransaction), boost::asio::use_future));
+        }
+        results.push_back(boost::asio::co_spawn(callers, sender_recovery.recover(silkworm::Bytes{0x80}), boost::asio::use_future));
+        for (std::size_t i{0}; i < 9; ++i) {
+            CHECK(results[i].get().transaction.from == expected_sender);
+        }
+        CHECK(results.back().get().result != silkworm::DecodingResult::kOk);
+        CHECK(sender_recovery.sender_cache()->size() == 1);
+    }
+}
+
+TEST_CASE("SenderRecovery::recover_senders", "[silkrpc][core][sender_recovery]") {
+    auto signed_transaction = SenderRecovery::decode_and_recover(kSignedTransaction).transaction;
+    const auto expected_sender = signed_transaction.from;
+    REQUIRE(expected_sender);
+    signed_transaction.from.reset();
+
+    boost::asio::thread_pool workers{2};
+    boost::asio::thread_pool callers{1};
+    SenderRecovery sender_recovery{workers};
+
+    SECTION("no missing sender") {
+        silkworm::Block block;
+        CHECK(!SenderRecovery::has_missing_senders(block));
+        auto result = boost::asio::co_spawn(callers, sender_recovery.recover_senders(block), boost::asio::use_future);
+        CHECK(result.get() == 0);
+    }
+
+    SECTION("several chunks") {
+        const evmc::address known_sender{0x00000000000000000000000000000000000000aa_address};
+        silkworm::Block block;
+        for (std::size_t i{0}; i < 2 * SenderRecovery::kBlockChunkSize + 1; ++i) {
+            block.transactions.push_back(signed_transaction);
+        }
+        block.transactions[1].from = known_sender;
+        CHECK(SenderRecovery::has_missing_senders(block));
+
+        auto result = boost::asio::co_spawn(callers, sender_recovery.recover_senders(block), boost::asio::use_future);
+        CHECK(result.get() == block.transactions.size() - 1);
+        CHECK(!SenderRecovery::has_missing_senders(block));
+        CHECK(block.transactions[0].from == expected_sender);
+        CHECK(block.transactions[1].from == known_sender);
+        CHECK(block.transactions.back().from == expected_sender);
+    }
+}
+
+} // namespace silkrpc::core
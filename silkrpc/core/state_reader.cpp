@@ -16,6 +16,12 @@
 
 #include "state_reader.hpp"
 
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+#include <boost/endian/conversion.hpp>
+
 #include <silkworm/common/util.hpp>
 #include <silkworm/db/access_layer.hpp>
 #include <silkworm/db/bitmap.hpp>
@@ -24,39 +30,136 @@
 
 #include <silkrpc/common/log.hpp>
 #include <silkrpc/common/util.hpp>
+#include <silkrpc/core/blocks.hpp>
 #include <silkrpc/core/rawdb/util.hpp>
 #include <silkrpc/ethdb/tables.hpp>
 
 namespace silkrpc {
 
+static std::optional<silkworm::Account> decode_account(const std::optional<silkworm::Bytes>& encoded) {
+    if (!encoded || encoded->empty()) {
+        return std::nullopt;
+    }
+
+    auto [account, err]{silkworm::Account::from_encoded_storage(*encoded)};
+    silkworm::rlp::success_or_throw(err); // TODO(canepat) suggest rename as throw_if_error or better throw_if(err != kOk)
+    return account;
+}
+
+//! Make the history chunk found seeking the history index of the account or storage location at the block number: if the
+//! key found belongs to another one, there is no change since the block number and the empty chunk serves any block after
+static std::shared_ptr<const HistoryChunk> make_history_chunk(silkworm::ByteView entity_key, const KeyValue& kv_pair, uint64_t block_number) {
+    auto chunk{std::make_shared<HistoryChunk>()};
+    chunk->from_block = block_number;
+    if (kv_pair.key.substr(0, entity_key.size()) != entity_key) {
+        chunk->to_block = HistoryCache::kLastChunkSuffix;
+        return chunk;
+    }
+    // A key without block suffix can just serve the block number it has been found at
+    const bool has_suffix{kv_pair.key.size() >= entity_key.size() + sizeof(uint64_t)};
+    chunk->to_block = has_suffix ? boost::endian::load_big_u64(kv_pair.key.data() + entity_key.size()) : block_number;
+    if (!kv_pair.value.empty()) {
+        const auto bitmap{silkworm::db::bitmap::parse(kv_pair.value)};
+        SILKRPC_DEBUG << "make_history_chunk bitmap: " << bitmap.toString() << "\n";
+        chunk->change_blocks.resize(bitmap.cardinality());
+        bitmap.toUint64Array(chunk->change_blocks.data());
+        if (!chunk->change_blocks.empty()) {
+            chunk->from_block = std::min(block_number, chunk->change_blocks.front());
+        }
+    }
+    return chunk;
+}
+
+//! The key of the changes read so far: account and storage keys never collide, having different sizes
+static silkworm::Bytes change_values_key(silkworm::ByteView key, silkworm::ByteView subkey) {
+    silkworm::Bytes change_key{key};
+    change_key.append(subkey);
+    return change_key;
+}
+
+static bool has_code_hash_to_restore(const silkworm::Account& account) {
+    return account.incarnation > 0 && account.code_hash == silkworm::kEmptyHash;
+}
+
+static void restore_code_hash(silkworm::Account& account, const silkworm::Bytes& code_hash) {
+    if (code_hash.length() == silkworm::kHashLength) {
+        std::memcpy(account.code_hash.bytes, code_hash.data(), silkworm::kHashLength);
+    }
+}
+
 boost::asio::awaitable<std::optional<silkworm::Account>> StateReader::read_account(const evmc::address& address, uint64_t block_number) const {
-    std::optional<silkworm::Bytes> encoded{co_await read_historical_account(address, block_number)};
+    std::optional<silkworm::Bytes> encoded;
+    if (!co_await is_current_state(block_number)) {
+        encoded = co_await read_historical_account(address, block_number);
+    }
     if (!encoded) {
         encoded = co_await db_reader_.get_one(db::table::kPlainState, full_view(address));
     }
     SILKRPC_DEBUG << "StateReader::read_account encoded: " << (encoded ? *encoded : silkworm::Bytes{}) << "\n";
-    if (!encoded || encoded->empty()) {
+    auto account{decode_account(encoded)};
+    if (!account) {
         co_return std::nullopt;
     }
 
-    auto [account, err]{silkworm::Account::from_encoded_storage(*encoded)};
-    silkworm::rlp::success_or_throw(err); // TODO(canepat) suggest rename as throw_if_error or better throw_if(err != kOk)
-
-    if (account.incarnation > 0 && account.code_hash == silkworm::kEmptyHash) {
+    if (has_code_hash_to_restore(*account)) {
         // Restore code hash
-        const auto storage_key{silkworm::db::storage_prefix(full_view(address), account.incarnation)};
-        auto code_hash{co_await db_reader_.get_one(db::table::kPlainContractCode, storage_key)};
-        if (code_hash.length() == silkworm::kHashLength) {
-            std::memcpy(account.code_hash.bytes, code_hash.data(), silkworm::kHashLength);
-        }
+        const auto storage_key{silkworm::db::storage_prefix(full_view(address), account->incarnation)};
+        restore_code_hash(*account, co_await db_reader_.get_one(db::table::kPlainContractCode, storage_key));
     }
 
     co_return account;
 }
 
+boost::asio::awaitable<std::vector<std::optional<silkworm::Account>>> StateReader::read_accounts(const std::vector<evmc::address>& addresses,
+    uint64_t block_number) const {
+    // The history of all the addresses is looked up together, then the accounts unchanged since block_number are read together
+    std::vector<std::optional<silkworm::Bytes>> encoded_accounts(addresses.size());
+    if (!co_await is_current_state(block_number)) {
+        encoded_accounts = co_await read_historical_accounts(addresses, block_number);
+    }
+    std::vector<std::size_t> current_indexes;
+    std::vector<silkworm::Bytes> current_keys;
+    for (std::size_t i{0}; i < addresses.size(); ++i) {
+        if (!encoded_accounts[i]) {
+            current_indexes.push_back(i);
+            current_keys.emplace_back(full_view(addresses[i]));
+        }
+    }
+    auto current_values{co_await db_reader_.get_many(db::table::kPlainState, current_keys)};
+    for (std::size_t j{0}; j < current_values.size(); ++j) {
+        encoded_accounts[current_indexes[j]] = std::move(current_values[j]);
+    }
+
+    std::vector<std::optional<silkworm::Account>> accounts;
+    accounts.reserve(addresses.size());
+    std::vector<std::size_t> restore_indexes;
+    std::vector<silkworm::Bytes> restore_keys;
+    for (std::size_t i{0}; i < addresses.size(); ++i) {
+        auto account{decode_account(encoded_accounts[i])};
+        if (account && has_code_hash_to_restore(*account)) {
+            restore_indexes.push_back(i);
+            restore_keys.push_back(silkworm::db::storage_prefix(full_view(addresses[i]), account->incarnation));
+        }
+        accounts.push_back(std::move(account));
+    }
+    SILKRPC_DEBUG << "StateReader::read_accounts addresses: " << addresses.size() << " current: " << current_keys.size()
+        << " restored: " << restore_keys.size() << "\n";
+
+    // Restore code hashes
+    const auto code_hashes{co_await db_reader_.get_many(db::table::kPlainContractCode, restore_keys)};
+    for (std::size_t j{0}; j < code_hashes.size(); ++j) {
+        restore_code_hash(*accounts[restore_indexes[j]], code_hashes[j]);
+    }
+
+    co_return accounts;
+}
+
 boost::asio::awaitable<evmc::bytes32> StateReader::read_storage(const evmc::address& address, uint64_t incarnation, const evmc::bytes32& location_hash,
     uint64_t block_number) const {
-    std::optional<silkworm::Bytes> value{co_await read_historical_storage(address, incarnation, location_hash, block_number)};
+    std::optional<silkworm::Bytes> value;
+    if (!co_await is_current_state(block_number)) {
+        value = co_await read_historical_storage(address, incarnation, location_hash, block_number);
+    }
     if (!value) {
         auto composite_key{silkrpc::composite_storage_key(address, incarnation, location_hash.bytes)};
         SILKRPC_DEBUG << "StateReader::read_storage composite_key: " << composite_key << "\n";
@@ -72,6 +175,17 @@ boost::asio::awaitable<evmc::bytes32> StateReader::read_storage(const evmc::addr
     co_return storage_value;
 }
 
+boost::asio::awaitable<bool> StateReader::is_current_state(uint64_t block_number) const {
+    if (!latest_executed_block_number_) {
+        if (db_reader_.chain_head_cache() == nullptr) {
+            co_return false; // resolving it would cost a round trip per reader, more than the history lookups it saves
+        }
+        latest_executed_block_number_ = co_await core::get_latest_executed_block_number(db_reader_);
+    }
+    // The history records only the changes made by the executed blocks, so none of them applies after the latest one
+    co_return block_number > *latest_executed_block_number_;
+}
+
 boost::asio::awaitable<std::optional<silkworm::Bytes>> StateReader::read_code(const evmc::bytes32& code_hash) const {
     if (code_hash == silkworm::kEmptyHash) {
         co_return std::nullopt;
@@ -79,66 +193,194 @@ boost::asio::awaitable<std::optional<silkworm::Bytes>> StateReader::read_code(co
     co_return co_await db_reader_.get_one(db::table::kCode, full_view(code_hash));
 }
 
-boost::asio::awaitable<std::optional<silkworm::Bytes>> StateReader::read_historical_account(const evmc::address& address, uint64_t block_number) const {
-    const auto account_history_key{silkworm::db::account_history_key(address, block_number)};
-    SILKRPC_DEBUG << "StateReader::read_historical_account account_history_key: " << account_history_key << "\n";
-    const auto kv_pair{co_await db_reader_.get(db::table::kAccountHistory, account_history_key)};
-
-    SILKRPC_DEBUG << "StateReader::read_historical_account kv_pair.key: " << silkworm::to_hex(kv_pair.key) << "\n";
-    const auto address_view{full_view(address)};
-    if (kv_pair.key.substr(0, silkworm::kAddressLength) != address_view) {
-        co_return std::nullopt;
+boost::asio::awaitable<std::vector<silkworm::Bytes>> StateReader::read_codes(const std::vector<evmc::bytes32>& code_hashes) const {
+    // The code shared by many accounts (e.g. proxies) is read once, the accounts w/o code not at all
+    std::unordered_map<evmc::bytes32, std::size_t> key_indexes;
+    std::vector<silkworm::Bytes> code_keys;
+    for (const auto& code_hash : code_hashes) {
+        if (code_hash != silkworm::kEmptyHash && key_indexes.emplace(code_hash, code_keys.size()).second) {
+            code_keys.emplace_back(full_view(code_hash));
+        }
     }
+    SILKRPC_DEBUG << "StateReader::read_codes code_hashes: " << code_hashes.size() << " distinct: " << code_keys.size() << "\n";
+    const auto distinct_codes{co_await db_reader_.get_many(db::table::kCode, code_keys)};
 
-    SILKRPC_DEBUG << "StateReader::read_historical_account kv_pair.value: " << silkworm::to_hex(kv_pair.value) << "\n";
-    if (kv_pair.value.empty()) {
-        co_return std::nullopt;
+    std::vector<silkworm::Bytes> codes(code_hashes.size());
+    for (std::size_t i{0}; i < code_hashes.size(); ++i) {
+        const auto key_it = key_indexes.find(code_hashes[i]);
+        if (key_it != key_indexes.end()) {
+            codes[i] = distinct_codes[key_it->second];
+        }
     }
-    const auto bitmap{silkworm::db::bitmap::parse(kv_pair.value)};
-    SILKRPC_DEBUG << "StateReader::read_historical_account bitmap: " << bitmap.toString() << "\n";
+    co_return codes;
+}
 
-    const auto change_block{silkworm::db::bitmap::seek(bitmap, block_number)};
+boost::asio::awaitable<std::optional<silkworm::Bytes>> StateReader::read_historical_account(const evmc::address& address, uint64_t block_number) const {
+    const auto address_view{full_view(address)};
+    const auto change_block{co_await find_change_block(db::table::kAccountHistory, address_view, block_number)};
     if (!change_block) {
         co_return std::nullopt;
     }
 
     const auto block_key{silkworm::db::block_key(*change_block)};
     SILKRPC_DEBUG << "StateReader::read_historical_account block_key: " << block_key << "\n";
-    const auto address_subkey{address_view};
-    SILKRPC_DEBUG << "StateReader::read_historical_account address_subkey: " << address_subkey << "\n";
-    const auto value{co_await db_reader_.get_both_range(db::table::kPlainAccountChangeSet, block_key, address_subkey)};
+    const auto value{co_await read_change(db::table::kPlainAccountChangeSet, *change_block, block_key, address_view)};
     SILKRPC_DEBUG << "StateReader::read_historical_account value: " << (value ? *value : silkworm::Bytes{}) << "\n";
 
     co_return value;
 }
 
-boost::asio::awaitable<std::optional<silkworm::Bytes>> StateReader::read_historical_storage(const evmc::address& address, uint64_t incarnation,
-    const evmc::bytes32& location_hash, uint64_t block_number) const {
-    const auto storage_history_key{silkworm::db::storage_history_key(address, location_hash, block_number)};
-    SILKRPC_DEBUG << "StateReader::read_historical_storage storage_history_key: " << storage_history_key << "\n";
-    const auto kv_pair{co_await db_reader_.get(db::table::kStorageHistory, storage_history_key)};
+boost::asio::awaitable<std::vector<std::optional<silkworm::Bytes>>> StateReader::read_historical_accounts(
+    const std::vector<evmc::address>& addresses, uint64_t block_number) const {
+    // The history chunks not read yet are looked up all together, then the changes not read yet
+    std::vector<std::optional<uint64_t>> change_blocks(addresses.size());
+    std::vector<std::size_t> history_indexes;
+    std::vector<silkworm::Bytes> history_keys;
+    for (std::size_t i{0}; i < addresses.size(); ++i) {
+        const auto chunk{find_cached_chunk(db::table::kAccountHistory, full_view(addresses[i]), block_number)};
+        if (chunk) {
+            change_blocks[i] = chunk->seek(block_number);
+        } else {
+            history_indexes.push_back(i);
+            history_keys.push_back(silkworm::db::account_history_key(addresses[i], block_number));
+        }
+    }
+    if (!history_keys.empty()) {
+        const auto generation{history_cache_ ? history_cache_->generation() : 0};
+        const auto kv_pairs{co_await db_reader_.seek_many(db::table::kAccountHistory, history_keys)};
+        for (std::size_t j{0}; j < kv_pairs.size(); ++j) {
+            const auto i{history_indexes[j]};
+            const auto address_view{full_view(addresses[i])};
+            const auto chunk{make_history_chunk(address_view, kv_pairs[j], block_number)};
+            add_chunk(db::table::kAccountHistory, address_view, chunk, generation);
+            change_blocks[i] = chunk->seek(block_number);
+        }
+    }
 
-    const auto location_hash_view{full_view(location_hash)};
-    if (kv_pair.key.substr(0, silkworm::kAddressLength) != full_view(address) ||
-        kv_pair.key.substr(silkworm::kAddressLength, silkworm::kHashLength) != location_hash_view) {
-        co_return std::nullopt;
+    std::vector<std::optional<silkworm::Bytes>> values(addresses.size());
+    std::vector<std::size_t> change_indexes;
+    std::vector<silkworm::Bytes> change_keys;
+    std::vector<silkworm::Bytes> change_subkeys;
+    for (std::size_t i{0}; i < addresses.size(); ++i) {
+        if (!change_blocks[i]) {
+            continue;
+        }
+        auto block_key{silkworm::db::block_key(*change_blocks[i])};
+        const auto address_view{full_view(addresses[i])};
+        if (const auto* value{find_cached_change(db::table::kPlainAccountChangeSet, change_values_key(block_key, address_view))}) {
+            values[i] = *value;
+        } else {
+            change_indexes.push_back(i);
+            change_keys.push_back(std::move(block_key));
+            change_subkeys.emplace_back(address_view);
+        }
+    }
+    const auto generation{history_cache_ ? history_cache_->change_generation() : 0};
+    auto change_values{co_await db_reader_.get_both_range_many(db::table::kPlainAccountChangeSet, change_keys, change_subkeys)};
+    for (std::size_t j{0}; j < change_values.size(); ++j) {
+        const auto i{change_indexes[j]};
+        auto change_key{change_values_key(change_keys[j], change_subkeys[j])};
+        if (history_cache_) {
+            history_cache_->store_change(db::table::kPlainAccountChangeSet, change_key, *change_blocks[i], change_values[j], generation);
+        }
+        change_values_.emplace(std::move(change_key), change_values[j]);
+        values[i] = std::move(change_values[j]);
     }
+    SILKRPC_DEBUG << "StateReader::read_historical_accounts addresses: " << addresses.size() << " history reads: " << history_keys.size()
+        << " change reads: " << change_keys.size() << "\n";
 
-    const auto bitmap{silkworm::db::bitmap::parse(kv_pair.value)};
-    SILKRPC_DEBUG << "StateReader::read_historical_storage bitmap: " << bitmap.toString() << "\n";
+    co_return values;
+}
 
-    const auto change_block{silkworm::db::bitmap::seek(bitmap, block_number)};
+boost::asio::awaitable<std::optional<silkworm::Bytes>> StateReader::read_historical_storage(const evmc::address& address, uint64_t incarnation,
+    const evmc::bytes32& location_hash, uint64_t block_number) const {
+    const auto location_hash_view{full_view(location_hash)};
+    silkworm::Bytes storage_key{full_view(address)};
+    storage_key.append(location_hash_view);
+    const auto change_block{co_await find_change_block(db::table::kStorageHistory, storage_key, block_number)};
     if (!change_block) {
         co_return std::nullopt;
     }
 
     const auto storage_change_key{silkworm::db::storage_change_key(*change_block, address, incarnation)};
     SILKRPC_DEBUG << "StateReader::read_historical_storage storage_change_key: " << storage_change_key << "\n";
-    const auto location_subkey{location_hash_view};
-    SILKRPC_DEBUG << "StateReader::read_historical_storage location_subkey: " << location_subkey << "\n";
-    const auto value{co_await db_reader_.get_both_range(db::table::kPlainStorageChangeSet, storage_change_key, location_subkey)};
+    const auto value{co_await read_change(db::table::kPlainStorageChangeSet, *change_block, storage_change_key, location_hash_view)};
     SILKRPC_DEBUG << "StateReader::read_historical_storage value: " << (value ? *value : silkworm::Bytes{}) << "\n";
 
     co_return value;
 }
+
+boost::asio::awaitable<std::optional<uint64_t>> StateReader::find_change_block(const std::string& history_table, silkworm::ByteView entity_key,
+    uint64_t block_number) const {
+    auto chunk{find_cached_chunk(history_table, entity_key, block_number)};
+    if (!chunk) {
+        const auto generation{history_cache_ ? history_cache_->generation() : 0};
+        silkworm::Bytes history_key{entity_key};
+        history_key.append(silkworm::db::block_key(block_number));
+        SILKRPC_DEBUG << "StateReader::find_change_block history_key: " << history_key << "\n";
+        const auto kv_pair{co_await db_reader_.get(history_table, history_key)};
+        SILKRPC_DEBUG << "StateReader::find_change_block kv_pair.key: " << silkworm::to_hex(kv_pair.key) << "\n";
+        chunk = make_history_chunk(entity_key, kv_pair, block_number);
+        add_chunk(history_table, entity_key, chunk, generation);
+    }
+    co_return chunk->seek(block_number);
+}
+
+std::shared_ptr<const HistoryChunk> StateReader::find_cached_chunk(const std::string& history_table, silkworm::ByteView entity_key,
+    uint64_t block_number) const {
+    const auto chunks_it{history_chunks_.find(silkworm::Bytes{entity_key})};
+    if (chunks_it != history_chunks_.end()) {
+        if (auto chunk{chunks_it->second.find(block_number)}) {
+            return chunk;
+        }
+    }
+    if (!history_cache_) {
+        return nullptr;
+    }
+    auto chunk{history_cache_->find(history_table, entity_key, block_number)};
+    if (chunk) {
+        history_chunks_[silkworm::Bytes{entity_key}].add(chunk);
+    }
+    return chunk;
+}
+
+void StateReader::add_chunk(const std::string& history_table, silkworm::ByteView entity_key, std::shared_ptr<const HistoryChunk> chunk,
+    uint64_t generation) const {
+    if (history_cache_) {
+        history_cache_->store(history_table, entity_key, chunk, generation);
+    }
+    history_chunks_[silkworm::Bytes{entity_key}].add(std::move(chunk));
+}
+
+boost::asio::awaitable<std::optional<silkworm::Bytes>> StateReader::read_change(const std::string& change_set_table, uint64_t change_block,
+    silkworm::ByteView key, silkworm::ByteView subkey) const {
+    auto change_key{change_values_key(key, subkey)};
+    if (const auto* value{find_cached_change(change_set_table, change_key)}) {
+        co_return *value;
+    }
+    const auto generation{history_cache_ ? history_cache_->change_generation() : 0};
+    auto value{co_await db_reader_.get_both_range(change_set_table, key, subkey)};
+    if (history_cache_) {
+        history_cache_->store_change(change_set_table, change_key, change_block, value, generation);
+    }
+    change_values_.emplace(std::move(change_key), value);
+    co_return value;
+}
+
+const std::optional<silkworm::Bytes>* StateReader::find_cached_change(const std::string& change_set_table, const silkworm::Bytes& change_key) const {
+    const auto change_it{change_values_.find(change_key)};
+    if (change_it != change_values_.end()) {
+        return &change_it->second;
+    }
+    if (!history_cache_) {
+        return nullptr;
+    }
+    const auto change{history_cache_->find_change(change_set_table, change_key)};
+    if (!change) {
+        return nullptr;
+    }
+    const auto [it, _] = change_values_.emplace(change_key, change->value);
+    return &it->second;
+}
+
 } // namespace silkrpc
@@ -17,7 +17,12 @@
 #ifndef SILKRPC_CORE_STATE_READER_HPP_
 #define SILKRPC_CORE_STATE_READER_HPP_
 
+#include <map>
+#include <memory>
 #include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <silkrpc/config.hpp>
 
@@ -26,32 +31,85 @@
 #include <silkworm/common/util.hpp>
 #include <silkworm/types/account.hpp>
 
+#include <silkrpc/common/history_cache.hpp>
 #include <silkrpc/common/util.hpp>
 #include <silkrpc/core/rawdb/accessors.hpp>
 
 namespace silkrpc {
 
+//! Reader of the state at some block, which keeps the history chunks and the changes read so far: they are valid as long as
+//! the database view of the reader, so the reader should live as long as the request to avoid reading them again. The
+//! sealed history chunks and the final changes are also shared through the history cache, if any.
 class StateReader {
 public:
-    explicit StateReader(const core::rawdb::DatabaseReader& db_reader) : db_reader_(db_reader) {}
+    explicit StateReader(const core::rawdb::DatabaseReader& db_reader, std::shared_ptr<HistoryCache> history_cache = nullptr)
+    : db_reader_(db_reader), history_cache_{std::move(history_cache)} {}
 
     StateReader(const StateReader&) = delete;
     StateReader& operator=(const StateReader&) = delete;
 
+    //! Set the latest executed block number, when already known, so that the state read after it skips the history lookups
+    void set_latest_executed_block_number(uint64_t block_number) { latest_executed_block_number_ = block_number; }
+
     boost::asio::awaitable<std::optional<silkworm::Account>> read_account(const evmc::address& address, uint64_t block_number) const;
 
+    //! Read the accounts in the same order of the addresses, getting all the current ones from the database in one go
+    boost::asio::awaitable<std::vector<std::optional<silkworm::Account>>> read_accounts(const std::vector<evmc::address>& addresses,
+        uint64_t block_number) const;
+
     boost::asio::awaitable<evmc::bytes32> read_storage(const evmc::address& address, uint64_t incarnation, const evmc::bytes32& location_hash,
         uint64_t block_number) const;
 
     boost::asio::awaitable<std::optional<silkworm::Bytes>> read_code(const evmc::bytes32& code_hash) const;
 
+    //! Read the code of each code hash in the same order (empty if none), getting each distinct code from the database in one go
+    boost::asio::awaitable<std::vector<silkworm::Bytes>> read_codes(const std::vector<evmc::bytes32>& code_hashes) const;
+
     boost::asio::awaitable<std::optional<silkworm::Bytes>> read_historical_account(const evmc::address& address, uint64_t block_number) const;
 
     boost::asio::awaitable<std::optional<silkworm::Bytes>> read_historical_storage(const evmc::address& address, uint64_t incarnation,
         const evmc::bytes32& location_hash, uint64_t block_number) const;
 
 private:
+    //! Return true if the state at the block number is the current one, i.e. read straight from the plain state: the latest
+    //! executed block number is resolved once through the chain head cache of the database view, if any
+    boost::asio::awaitable<bool> is_current_state(uint64_t block_number) const;
+
+    //! Read the historical accounts looking up the history of all the addresses together, then all their changes together
+    boost::asio::awaitable<std::vector<std::optional<silkworm::Bytes>>> read_historical_accounts(const std::vector<evmc::address>& addresses,
+        uint64_t block_number) const;
+
+    //! Find the first block changing the account or storage location at or after the block number in the history table
+    boost::asio::awaitable<std::optional<uint64_t>> find_change_block(const std::string& history_table, silkworm::ByteView entity_key,
+        uint64_t block_number) const;
+
+    //! Return the history chunk serving the block number read so far by this reader or found in the history cache, if any
+    std::shared_ptr<const HistoryChunk> find_cached_chunk(const std::string& history_table, silkworm::ByteView entity_key,
+        uint64_t block_number) const;
+
+    //! Keep the history chunk read at the specified history cache generation
+    void add_chunk(const std::string& history_table, silkworm::ByteView entity_key, std::shared_ptr<const HistoryChunk> chunk,
+        uint64_t generation) const;
+
+    //! Read the change of the account or storage location in the change set table at the change block, unless already read
+    //! by this reader or found in the history cache
+    boost::asio::awaitable<std::optional<silkworm::Bytes>> read_change(const std::string& change_set_table, uint64_t change_block,
+        silkworm::ByteView key, silkworm::ByteView subkey) const;
+
+    //! Return the change read so far by this reader or found in the history cache, if any
+    const std::optional<silkworm::Bytes>* find_cached_change(const std::string& change_set_table, const silkworm::Bytes& change_key) const;
+
     const core::rawdb::DatabaseReader& db_reader_;
+    std::shared_ptr<HistoryCache> history_cache_;
+
+    //! The latest executed block number, once resolved or set
+    mutable std::optional<uint64_t> latest_executed_block_number_;
+
+    //! The history chunks read so far by account address or storage address and location (never colliding by size)
+    mutable std::map<silkworm::Bytes, HistoryChunks> history_chunks_;
+
+    //! The changes read so far by change set key and subkey
+    mutable std::map<silkworm::Bytes, std::optional<silkworm::Bytes>> change_values_;
 };
 
 } // namespace silkrpc
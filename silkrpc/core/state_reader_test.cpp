@@ -17,6 +17,9 @@
 #include "state_reader.hpp"
 
 #include <silkrpc/config.hpp>
+
+#include <vector>
+
 #include <boost/asio/awaitable.hpp>
 #include <catch2/catch.hpp>
 #include <evmc/evmc.hpp>
@@ -29,6 +32,7 @@
 
 namespace silkrpc {
 
+using evmc::literals::operator""_address;
 using evmc::literals::operator""_bytes32;
 using testing::InvokeWithoutArgs;
 using testing::_;
@@ -51,6 +55,9 @@ static const silkworm::Bytes kEncodedStorageHistory{*silkworm::from_hex(
     "00000040000000560000005a0000005e0000006a0000006e000000720000005da562a563a565a567a56aa59da5"
     "a0a5f0a5f5a57ef926a863a8eb520b535d1b951bb71b3c1c741caa4f53f5b0f5184f536018f6")};
 
+//! A chain head making final all the blocks changing the test storage location
+static constexpr uint64_t kFinalHeadBlock{20'000'000};
+
 static const silkworm::Bytes kBinaryCode{*silkworm::from_hex("0x60045e005c60016000555d")};
 static const evmc::bytes32 kCodeHash{0xef722d9baf50b9983c2fce6329c5a43a15b8d5ba79cd792e7199d615be88284d_bytes32};
 
@@ -155,6 +162,207 @@ TEST_CASE_METHOD(StateReaderTest, "StateReader::read_account") {
     }
 }
 
+TEST_CASE_METHOD(StateReaderTest, "StateReader reads the state after the latest executed block from current state") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    static constexpr uint64_t kLatestExecutedBlock{1'000};
+    state_reader_.set_latest_executed_block_number(kLatestExecutedBlock);
+
+    SECTION("account skips history") {
+        // Set the call expectations:
+        // 1. DatabaseReader::get_one call on kPlainState returns account data, no kAccountHistory lookup
+        EXPECT_CALL(database_reader_, get(db::table::kAccountHistory, _)).Times(0);
+        EXPECT_CALL(database_reader_, get_one(db::table::kPlainState, full_view(kZeroAddress))).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kEncodedAccount; }
+        ));
+
+        // Execute the test: calling read_account should return the expected account
+        std::optional<silkworm::Account> account;
+        CHECK_NOTHROW(account = spawn_and_wait(state_reader_.read_account(kZeroAddress, kLatestExecutedBlock + 1)));
+        CHECK(account);
+        if (account) {
+            CHECK(account->nonce == 2);
+        }
+    }
+
+    SECTION("accounts skip history") {
+        // Set the call expectations:
+        // 1. DatabaseReader::get_one call on kPlainState returns account data, no kAccountHistory lookup
+        EXPECT_CALL(database_reader_, get(db::table::kAccountHistory, _)).Times(0);
+        EXPECT_CALL(database_reader_, get_one(db::table::kPlainState, full_view(kZeroAddress))).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kEncodedAccount; }
+        ));
+
+        // Execute the test: calling read_accounts should return the expected account
+        std::vector<std::optional<silkworm::Account>> accounts;
+        CHECK_NOTHROW(accounts = spawn_and_wait(state_reader_.read_accounts({kZeroAddress}, kLatestExecutedBlock + 1)));
+        REQUIRE(accounts.size() == 1);
+        CHECK(accounts[0]);
+    }
+
+    SECTION("storage skips history") {
+        // Set the call expectations:
+        // 1. DatabaseReader::get_one call on kPlainState returns the storage location value, no kStorageHistory lookup
+        EXPECT_CALL(database_reader_, get(db::table::kStorageHistory, _)).Times(0);
+        EXPECT_CALL(database_reader_, get_one(db::table::kPlainState, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kStorageLocation; }
+        ));
+
+        // Execute the test: calling read_storage should return expected storage location
+        evmc::bytes32 location;
+        CHECK_NOTHROW(location = spawn_and_wait(state_reader_.read_storage(kZeroAddress, 0, kLocationHash, kLatestExecutedBlock + 1)));
+        CHECK(location == silkworm::to_bytes32(kStorageLocation));
+    }
+
+    SECTION("state at the latest executed block looks up history") {
+        // Set the call expectations:
+        // 1. DatabaseReader::get call on kAccountHistory returns empty key-value
+        EXPECT_CALL(database_reader_, get(db::table::kAccountHistory, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<KeyValue> { co_return KeyValue{}; }
+        ));
+        // 2. DatabaseReader::get_one call on kPlainState returns account data
+        EXPECT_CALL(database_reader_, get_one(db::table::kPlainState, full_view(kZeroAddress))).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kEncodedAccount; }
+        ));
+
+        // Execute the test: calling read_account should return the expected account
+        std::optional<silkworm::Account> account;
+        CHECK_NOTHROW(account = spawn_and_wait(state_reader_.read_account(kZeroAddress, kLatestExecutedBlock)));
+        CHECK(account);
+    }
+}
+
+TEST_CASE_METHOD(StateReaderTest, "StateReader::read_accounts") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+
+    SECTION("no address") {
+        // Execute the test: calling read_accounts should return no account w/o any database access
+        std::vector<std::optional<silkworm::Account>> accounts;
+        CHECK_NOTHROW(accounts = spawn_and_wait(state_reader_.read_accounts({}, core::kEarliestBlockNumber)));
+        CHECK(accounts.empty());
+    }
+
+    SECTION("accounts found in history and current state") {
+        static const evmc::address kOtherAddress{0x0000000000000000000000000000000000000001_address};
+
+        // Set the call expectations:
+        // 1. DatabaseReader::get call on kAccountHistory returns the account bitmap for the first address only
+        EXPECT_CALL(database_reader_, get(db::table::kAccountHistory, _))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<KeyValue> {
+                co_return KeyValue{silkworm::Bytes{full_view(kZeroAddress)}, kEncodedAccountHistory};
+            }))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<KeyValue> { co_return KeyValue{}; }));
+        // 2. DatabaseReader::get_both_range call on kPlainAccountChangeSet returns the account data
+        EXPECT_CALL(database_reader_, get_both_range(db::table::kPlainAccountChangeSet, _, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<std::optional<silkworm::Bytes>> { co_return kEncodedAccount; }
+        ));
+        // 3. DatabaseReader::get_one call on kPlainState returns the account data w/o code hash for the second address
+        EXPECT_CALL(database_reader_, get_one(db::table::kPlainState, full_view(kOtherAddress))).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kEncodedAccountWithoutCodeHash; }
+        ));
+        // 4. DatabaseReader::get_one call on kPlainContractCode returns the code hash for the second address
+        EXPECT_CALL(database_reader_, get_one(db::table::kPlainContractCode, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{kCodeHash.bytes, silkworm::kHashLength}; }
+        ));
+
+        // Execute the test: calling read_accounts should return the expected accounts in the same order
+        std::vector<std::optional<silkworm::Account>> accounts;
+        CHECK_NOTHROW(accounts = spawn_and_wait(state_reader_.read_accounts({kZeroAddress, kOtherAddress}, core::kEarliestBlockNumber)));
+        REQUIRE(accounts.size() == 2);
+        CHECK(accounts[0]);
+        if (accounts[0]) {
+            CHECK(accounts[0]->nonce == 2);
+            CHECK(accounts[0]->balance == 1000);
+            CHECK(accounts[0]->incarnation == 5);
+        }
+        CHECK(accounts[1]);
+        if (accounts[1]) {
+            CHECK(accounts[1]->nonce == 12345);
+            CHECK(accounts[1]->balance == silkworm::kEther);
+            CHECK(accounts[1]->code_hash == kCodeHash);
+        }
+    }
+}
+
+TEST_CASE_METHOD(StateReaderTest, "StateReader reuses the history read so far") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+
+    // The key suffix of the sealed chunk, beyond the highest block in the account bitmap
+    static constexpr uint64_t kChunkSuffix{10'000'000};
+
+    SECTION("history and changes read once by the same reader") {
+        // Set the call expectations:
+        // 1. DatabaseReader::get call on kAccountHistory returns the account bitmap just once
+        EXPECT_CALL(database_reader_, get(db::table::kAccountHistory, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<KeyValue> {
+                co_return KeyValue{silkworm::db::account_history_key(kZeroAddress, kChunkSuffix), kEncodedAccountHistory};
+            }
+        ));
+        // 2. DatabaseReader::get_both_range call on kPlainAccountChangeSet returns the account data just once
+        EXPECT_CALL(database_reader_, get_both_range(db::table::kPlainAccountChangeSet, _, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<std::optional<silkworm::Bytes>> { co_return kEncodedAccount; }
+        ));
+
+        // Execute the test: calling read_account twice should return the same account
+        for (int i{0}; i < 2; ++i) {
+            std::optional<silkworm::Account> account;
+            CHECK_NOTHROW(account = spawn_and_wait(state_reader_.read_account(kZeroAddress, core::kEarliestBlockNumber)));
+            CHECK(account);
+            if (account) {
+                CHECK(account->nonce == 2);
+            }
+        }
+    }
+
+    SECTION("sealed history chunks shared through the history cache") {
+        auto history_cache = std::make_shared<HistoryCache>();
+        StateReader first_reader{database_reader_, history_cache};
+        StateReader second_reader{database_reader_, history_cache};
+
+        // Set the call expectations:
+        // 1. DatabaseReader::get call on kAccountHistory returns the account bitmap just for the first reader
+        EXPECT_CALL(database_reader_, get(db::table::kAccountHistory, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<KeyValue> {
+                co_return KeyValue{silkworm::db::account_history_key(kZeroAddress, kChunkSuffix), kEncodedAccountHistory};
+            }
+        ));
+        // 2. DatabaseReader::get_both_range call on kPlainAccountChangeSet returns the account data for each reader
+        EXPECT_CALL(database_reader_, get_both_range(db::table::kPlainAccountChangeSet, _, _)).Times(2).WillRepeatedly(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<std::optional<silkworm::Bytes>> { co_return kEncodedAccount; }
+        ));
+
+        // Execute the test: calling read_account on both readers should return the same account
+        std::optional<silkworm::Account> account;
+        CHECK_NOTHROW(account = spawn_and_wait(first_reader.read_account(kZeroAddress, core::kEarliestBlockNumber)));
+        CHECK(account);
+        CHECK_NOTHROW(account = spawn_and_wait(second_reader.read_account(kZeroAddress, core::kEarliestBlockNumber)));
+        CHECK(account);
+        CHECK(history_cache->size() == 1);
+    }
+
+    SECTION("open-ended history chunks not shared") {
+        auto history_cache = std::make_shared<HistoryCache>();
+        StateReader reader{database_reader_, history_cache};
+
+        // Set the call expectations:
+        // 1. DatabaseReader::get call on kAccountHistory returns the account bitmap in the last chunk
+        EXPECT_CALL(database_reader_, get(db::table::kAccountHistory, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<KeyValue> {
+                co_return KeyValue{silkworm::db::account_history_key(kZeroAddress, HistoryCache::kLastChunkSuffix), kEncodedAccountHistory};
+            }
+        ));
+        // 2. DatabaseReader::get_both_range call on kPlainAccountChangeSet returns the account data
+        EXPECT_CALL(database_reader_, get_both_range(db::table::kPlainAccountChangeSet, _, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<std::optional<silkworm::Bytes>> { co_return kEncodedAccount; }
+        ));
+
+        // Execute the test: calling read_account should return the account w/o sharing the chunk
+        std::optional<silkworm::Account> account;
+        CHECK_NOTHROW(account = spawn_and_wait(reader.read_account(kZeroAddress, core::kEarliestBlockNumber)));
+        CHECK(account);
+        CHECK(history_cache->size() == 0);
+    }
+}
+
 TEST_CASE_METHOD(StateReaderTest, "StateReader::read_storage") {
     SILKRPC_LOG_VERBOSITY(LogLevel::None);
 
@@ -213,6 +421,66 @@ TEST_CASE_METHOD(StateReaderTest, "StateReader::read_storage") {
         CHECK_NOTHROW(location = spawn_and_wait(state_reader_.read_storage(kZeroAddress, 0, kLocationHash, core::kEarliestBlockNumber)));
         CHECK(location == silkworm::to_bytes32(kStorageLocation));
     }
+
+    SECTION("final storage changes shared through the history cache") {
+        auto history_cache = std::make_shared<HistoryCache>();
+        history_cache->set_head_block(kFinalHeadBlock);
+        StateReader first_reader{database_reader_, history_cache};
+        StateReader second_reader{database_reader_, history_cache};
+
+        // Set the call expectations:
+        // 1. DatabaseReader::get call on kStorageHistory returns the storage bitmap just for the first reader
+        EXPECT_CALL(database_reader_, get(db::table::kStorageHistory, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<KeyValue> {
+                co_return KeyValue{
+                    silkworm::db::storage_history_key(kZeroAddress, kLocationHash, core::kEarliestBlockNumber),
+                    kEncodedStorageHistory
+                };
+            }
+        ));
+        // 2. DatabaseReader::get_both_range call on kPlainStorageChangeSet returns the storage location value just once
+        EXPECT_CALL(database_reader_, get_both_range(db::table::kPlainStorageChangeSet, _, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<std::optional<silkworm::Bytes>> { co_return kStorageLocation; }
+        ));
+
+        // Execute the test: calling read_storage on both readers should return the same storage location
+        evmc::bytes32 location;
+        CHECK_NOTHROW(location = spawn_and_wait(first_reader.read_storage(kZeroAddress, 0, kLocationHash, core::kEarliestBlockNumber)));
+        CHECK(location == silkworm::to_bytes32(kStorageLocation));
+        CHECK_NOTHROW(location = spawn_and_wait(second_reader.read_storage(kZeroAddress, 0, kLocationHash, core::kEarliestBlockNumber)));
+        CHECK(location == silkworm::to_bytes32(kStorageLocation));
+        CHECK(history_cache->change_count() == 1);
+    }
+
+    SECTION("storage changes not shared after unwinding below the final block") {
+        auto history_cache = std::make_shared<HistoryCache>();
+        history_cache->set_head_block(kFinalHeadBlock);
+        StateReader first_reader{database_reader_, history_cache};
+        StateReader second_reader{database_reader_, history_cache};
+
+        // Set the call expectations:
+        // 1. DatabaseReader::get call on kStorageHistory returns the storage bitmap just for the first reader
+        EXPECT_CALL(database_reader_, get(db::table::kStorageHistory, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<KeyValue> {
+                co_return KeyValue{
+                    silkworm::db::storage_history_key(kZeroAddress, kLocationHash, core::kEarliestBlockNumber),
+                    kEncodedStorageHistory
+                };
+            }
+        ));
+        // 2. DatabaseReader::get_both_range call on kPlainStorageChangeSet returns the storage location value for each reader
+        EXPECT_CALL(database_reader_, get_both_range(db::table::kPlainStorageChangeSet, _, _)).Times(2).WillRepeatedly(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<std::optional<silkworm::Bytes>> { co_return kStorageLocation; }
+        ));
+
+        // Execute the test: the change read by the first reader is dropped by the deep unwind before the second read
+        evmc::bytes32 location;
+        CHECK_NOTHROW(location = spawn_and_wait(first_reader.read_storage(kZeroAddress, 0, kLocationHash, core::kEarliestBlockNumber)));
+        CHECK(location == silkworm::to_bytes32(kStorageLocation));
+        history_cache->unwind(1);
+        CHECK_NOTHROW(location = spawn_and_wait(second_reader.read_storage(kZeroAddress, 0, kLocationHash, core::kEarliestBlockNumber)));
+        CHECK(location == silkworm::to_bytes32(kStorageLocation));
+    }
 }
 
 TEST_CASE_METHOD(StateReaderTest, "StateReader::read_code") {
@@ -258,5 +526,34 @@ TEST_CASE_METHOD(StateReaderTest, "StateReader::read_code") {
     }
 }
 
+TEST_CASE_METHOD(StateReaderTest, "StateReader::read_codes") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+
+    SECTION("no code for empty code hashes") {
+        // Execute the test: calling read_codes should return empty codes w/o any database access
+        std::vector<silkworm::Bytes> codes;
+        CHECK_NOTHROW(codes = spawn_and_wait(state_reader_.read_codes({silkworm::kEmptyHash, silkworm::kEmptyHash})));
+        REQUIRE(codes.size() == 2);
+        CHECK(codes[0].empty());
+        CHECK(codes[1].empty());
+    }
+
+    SECTION("same code read once for many code hashes") {
+        // Set the call expectations:
+        // 1. DatabaseReader::get_one call on kCode returns the binary code just once
+        EXPECT_CALL(database_reader_, get_one(db::table::kCode, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kBinaryCode; }
+        ));
+
+        // Execute the test: calling read_codes should return the codes in the same order
+        std::vector<silkworm::Bytes> codes;
+        CHECK_NOTHROW(codes = spawn_and_wait(state_reader_.read_codes({kCodeHash, silkworm::kEmptyHash, kCodeHash})));
+        REQUIRE(codes.size() == 3);
+        CHECK(silkworm::to_hex(codes[0]) == silkworm::to_hex(kBinaryCode));
+        CHECK(codes[1].empty());
+        CHECK(silkworm::to_hex(codes[2]) == silkworm::to_hex(kBinaryCode));
+    }
+}
+
 } // namespace silkrpc
 
@@ -17,8 +17,9 @@
 
 #include "storage_walker.hpp"
 
-#include <set>
+#include <algorithm>
 #include <sstream>
+#include <vector>
 
 #include <boost/endian/conversion.hpp>
 
@@ -59,9 +60,8 @@ struct StorageItem {
     silkworm::Bytes value;
 };
 
-bool operator<(const StorageItem& k1, const StorageItem& k2) {
-    return k1.key < k2.key;
-}
+//! The max number of items preallocated for a storage range, whatever max_result
+constexpr std::size_t kStorageRangeMaxReserved{1024};
 
 boost::asio::awaitable<silkrpc::ethdb::SplittedKeyValue> next(silkrpc::ethdb::SplitCursor& cursor, uint64_t number) {
     auto kv = co_await cursor.next();
@@ -183,7 +183,11 @@ boost::asio::awaitable<void> StorageWalker::storage_range_at(uint64_t block_numb
     auto [account, err] = silkworm::Account::from_encoded_storage(account_data);
     silkworm::rlp::success_or_throw(err);
 
-    std::set<StorageItem> storage;
+    // The locations are walked in ascending order, so they are collected in order, just skipping any repeated one, up to
+    // the first one beyond max_result (needed for continuation) where the walk stops
+    std::vector<StorageItem> storage;
+    const std::size_t max_collected = max_result > 0 ? static_cast<std::size_t>(max_result) + 1 : 1;
+    storage.reserve(std::min(max_collected, kStorageRangeMaxReserved));
     AccountCollector walker = [&](const evmc::address& addr, const silkworm::ByteView loc, const silkworm::ByteView data) {
         if (addr != address) {
             return false;
@@ -191,26 +195,24 @@ boost::asio::awaitable<void> StorageWalker::storage_range_at(uint64_t block_numb
         if (data.size() == 0) {
             return true;
         }
+        if (!storage.empty() && storage.back().key == loc) {
+            return true;
+        }
 
         auto hash = hash_of(loc);
 
-        StorageItem storage_item;
+        StorageItem& storage_item = storage.emplace_back();
         storage_item.key = loc;
         storage_item.sec_key = full_view(hash);
         storage_item.value = data;
 
-        if (storage.find(storage_item) != storage.end()) {
-            return true;
-        }
-
-        storage.insert(storage_item);
-        return storage.size() <= max_result;
+        return storage.size() < max_collected;
     };
 
     StorageWalker storage_walker{transaction_};
     co_await storage_walker.walk_of_storages(block_number + 1, address, start_location, account.incarnation, walker);
 
-    for (auto item : storage) {
+    for (const auto& item : storage) {
         collector(item.key, item.sec_key, item.value);
     }
     co_return;
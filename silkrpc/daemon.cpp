@@ -20,12 +20,27 @@
 #include <cxxabi.h>
 #endif
 
+#include <algorithm>
+#include <charconv>
+#include <functional>
+#include <future>
 #include <filesystem>
+#include <fstream>
+#include <sstream>
 #include <stdexcept>
+#include <string_view>
+#include <vector>
 
 #include <boost/asio/signal_set.hpp>
 #include <boost/process/environment.hpp>
 #include <grpcpp/grpcpp.h>
+#include <silkworm/rpc/common/conversion.hpp>
+#include <silkrpc/common/allocator.hpp>
+#include <silkrpc/common/compressed_bytes.hpp>
+#include <silkrpc/common/disk_cache.hpp>
+#include <silkrpc/ethdb/file/local_database.hpp>
+#include <silkrpc/ethdb/snapshot/repository.hpp>
+#include <silkrpc/grpc/util.hpp>
 #include <silkrpc/http/jwt.hpp>
 
 namespace silkrpc {
@@ -41,6 +56,93 @@ void DaemonChecklist::success_or_throw() const {
     }
 }
 
+namespace {
+
+std::string_view trim(std::string_view text) {
+    constexpr std::string_view kWhitespaces{" \t\r"};
+    const auto first = text.find_first_not_of(kWhitespaces);
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    return text.substr(first, text.find_last_not_of(kWhitespaces) - first + 1);
+}
+
+template <typename T>
+T parse_number(std::string_view value, std::string_view line) {
+    T number{0};
+    const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), number);
+    if (value.empty() || ec != std::errc{} || end != value.data() + value.size()) {
+        throw std::invalid_argument{"invalid reload setting: " + std::string{line}};
+    }
+    return number;
+}
+
+} // namespace
+
+std::vector<std::string> parse_targets(const std::string& target) {
+    std::vector<std::string> targets;
+    std::string_view remaining{target};
+    while (!remaining.empty()) {
+        const auto separator = remaining.find(',');
+        const auto item = trim(remaining.substr(0, separator));
+        remaining = separator == std::string_view::npos ? std::string_view{} : remaining.substr(separator + 1);
+
+        const auto colon = item.rfind(':');
+        if (colon == std::string_view::npos || colon == item.size() - 1) {
+            throw std::invalid_argument{"invalid target: " + std::string{item}};
+        }
+        if (std::find(targets.begin(), targets.end(), item) != targets.end()) {
+            throw std::invalid_argument{"repeated target: " + std::string{item}};
+        }
+        targets.emplace_back(item);
+    }
+    return targets;
+}
+
+ReloadSettings ReloadSettings::parse(const std::string& text) {
+    ReloadSettings settings;
+    std::string_view remaining{text};
+    while (!remaining.empty()) {
+        const auto separator = remaining.find('\n');
+        const auto line = trim(remaining.substr(0, separator));
+        remaining = separator == std::string_view::npos ? std::string_view{} : remaining.substr(separator + 1);
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+
+        const auto equal = line.find('=');
+        if (equal == std::string_view::npos) {
+            throw std::invalid_argument{"invalid reload setting: " + std::string{line}};
+        }
+        const auto name = trim(line.substr(0, equal));
+        const auto value = trim(line.substr(equal + 1));
+        if (name == "api_spec") {
+            settings.api_spec = std::string{value};
+        } else if (name == "block_cache_size") {
+            settings.block_cache_size = parse_number<std::size_t>(value, line);
+        } else if (name == "state_cache_max_keys") {
+            settings.state_cache_max_keys = parse_number<uint32_t>(value, line);
+        } else if (name == "state_cache_max_code_size") {
+            settings.state_cache_max_code_size = parse_number<std::size_t>(value, line);
+        } else if (name == "max_workers") {
+            settings.max_workers = parse_number<uint32_t>(value, line);
+        } else {
+            throw std::invalid_argument{"unknown reload setting: " + std::string{line}};
+        }
+    }
+    return settings;
+}
+
+ReloadSettings ReloadSettings::read(const std::string& file_path) {
+    std::ifstream file{file_path};
+    if (!file) {
+        throw std::runtime_error{"cannot open reload file: " + file_path};
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    return parse(text.str());
+}
+
 const char* current_exception_name() {
 #ifdef WIN32
     return "<Exception name not supported on Windows>";
@@ -60,8 +162,10 @@ int Daemon::run(const DaemonSettings& settings, const DaemonInfo& info) {
     SILKRPC_LOG_THREAD(true);
 
     SILKRPC_LOG << "Silkrpc build info: " << info.build << " " << info.libraries << "\n";
+    SILKRPC_LOG << "Silkrpc memory allocator: " << allocator_name() << "\n";
 
     std::set_terminate([]() {
+        SILKRPC_LOG_ASYNC(false);
         try {
             auto exc = std::current_exception();
             if (exc) {
@@ -116,14 +220,36 @@ int Daemon::run(const DaemonSettings& settings, const DaemonInfo& info) {
         // Start execution context dedicated to handling termination signals
         boost::asio::io_context signal_context;
         boost::asio::signal_set signals{signal_context, SIGINT, SIGTERM};
+#ifndef WIN32
+        if (!settings.reload_file.empty()) {
+            signals.add(SIGHUP);
+        }
+#endif
         SILKRPC_DEBUG << "Signals registered on signal_context " << &signal_context << "\n" << std::flush;
-        signals.async_wait([&](const boost::system::error_code& error, int signal_number) {
+        std::function<void(const boost::system::error_code&, int)> on_signal = [&](const boost::system::error_code& error, int signal_number) {
             if (signal_number == SIGINT) std::cout << "\n";
             SILKRPC_INFO << "Signal number: " << signal_number << " caught, error: " << error.message() << "\n" << std::flush;
+#ifndef WIN32
+            if (!error && signal_number == SIGHUP) {
+                rpc_daemon.reload();
+                signals.async_wait(on_signal);
+                return;
+            }
+#endif
             rpc_daemon.stop();
-        });
+        };
+        signals.async_wait(on_signal);
 
         SILKRPC_LOG << "Starting ETH RPC API at " << settings.http_port << " ENGINE RPC API at " << settings.engine_port << "\n";
+        if (!settings.http_unix_socket.empty()) {
+            SILKRPC_LOG << "Starting ETH RPC API at Unix domain socket " << settings.http_unix_socket << "\n";
+        }
+        if (!settings.ws_port.empty()) {
+            SILKRPC_LOG << "Starting ETH RPC API over WebSocket at " << settings.ws_port << "\n";
+        }
+
+        // Log from now on without blocking the running threads, the records being written by a background thread
+        SILKRPC_LOG_ASYNC(true);
 
         rpc_daemon.start();
 
@@ -138,6 +264,8 @@ int Daemon::run(const DaemonSettings& settings, const DaemonInfo& info) {
         SILKRPC_CRIT << "Unexpected exception: " << current_exception_name() << "\n" << std::flush;
     }
 
+    SILKRPC_LOG_ASYNC(false);
+
     SILKRPC_LOG << "Silkrpc exiting [pid=" << pid << ", main thread=" << tid << "]\n" << std::flush;
 
     return 0;
@@ -158,6 +286,22 @@ bool Daemon::validate_settings(const DaemonSettings& settings) {
         return false;
     }
 
+    // The socket path must fit into sockaddr_un::sun_path including the null terminator
+    constexpr std::size_t kMaxUnixSocketPathSize{107};
+    const auto http_unix_socket = settings.http_unix_socket;
+    if (http_unix_socket.size() > kMaxUnixSocketPathSize) {
+        SILKRPC_ERROR << "Parameter http_unix_socket is invalid: [" << http_unix_socket << "]\n";
+        SILKRPC_ERROR << "Use --http_unix_socket flag to specify the Unix domain socket path (max " << kMaxUnixSocketPathSize << " chars)\n";
+        return false;
+    }
+
+    const auto ws_port = settings.ws_port;
+    if (!ws_port.empty() && ws_port.find(silkrpc::kAddressPortSeparator) == std::string::npos) {
+        SILKRPC_ERROR << "Parameter ws_port is invalid: [" << ws_port << "]\n";
+        SILKRPC_ERROR << "Use --ws_port flag to specify the local binding for Ethereum JSON RPC service over WebSocket\n";
+        return false;
+    }
+
     const auto engine_port = settings.engine_port;
     if (!engine_port.empty() && engine_port.find(silkrpc::kAddressPortSeparator) == std::string::npos) {
         SILKRPC_ERROR << "Parameter engine_port is invalid: [" << engine_port << "]\n";
@@ -166,9 +310,11 @@ bool Daemon::validate_settings(const DaemonSettings& settings) {
     }
 
     const auto target = settings.target;
-    if (!target.empty() && target.find(':') == std::string::npos) {
-        SILKRPC_ERROR << "Parameter target is invalid: [" << target << "]\n";
-        SILKRPC_ERROR << "Use --target flag to specify the location of Erigon running instance\n";
+    try {
+        parse_targets(target);
+    } catch (const std::invalid_argument& ia) {
+        SILKRPC_ERROR << "Parameter target is invalid: [" << target << "] " << ia.what() << "\n";
+        SILKRPC_ERROR << "Use --target flag to specify the location of Erigon running instance, or comma-separated list of them\n";
         return false;
     }
 
@@ -178,6 +324,89 @@ bool Daemon::validate_settings(const DaemonSettings& settings) {
         return false;
     }
 
+    if (settings.max_pipelined_requests == 0) {
+        SILKRPC_ERROR << "Parameter max_pipelined_requests is invalid: [" << settings.max_pipelined_requests << "]\n";
+        SILKRPC_ERROR << "Use --max_pipelined_requests flag to specify the max number of pipelined requests executed concurrently (1 disables pipelining)\n";
+        return false;
+    }
+
+    if (settings.http_compression_level > 9) {
+        SILKRPC_ERROR << "Parameter http_compression_level is invalid: [" << settings.http_compression_level << "]\n";
+        SILKRPC_ERROR << "Use --http_compression_level flag to specify the compression level in [1, 9] (0 disables compression)\n";
+        return false;
+    }
+
+    if (settings.max_batch_concurrency == 0) {
+        SILKRPC_ERROR << "Parameter max_batch_concurrency is invalid: [" << settings.max_batch_concurrency << "]\n";
+        SILKRPC_ERROR << "Use --max_batch_concurrency flag to specify the max number of batch elements executed concurrently (1 disables concurrency)\n";
+        return false;
+    }
+
+    const std::filesystem::path warm_up_file{settings.state_cache_warm_up_file};
+    if (!warm_up_file.empty() && warm_up_file.has_parent_path() && !std::filesystem::is_directory(warm_up_file.parent_path())) {
+        SILKRPC_ERROR << "Parameter state_cache_warm_up_file is invalid: [" << settings.state_cache_warm_up_file << "]\n";
+        SILKRPC_ERROR << "Use --state_cache_warm_up_file flag to specify a file in an existing directory (empty disables warm up)\n";
+        return false;
+    }
+
+    const std::filesystem::path log_index{settings.log_index};
+    if (!log_index.empty() && std::filesystem::exists(log_index) && !std::filesystem::is_directory(log_index)) {
+        SILKRPC_ERROR << "Parameter log_index is invalid: [" << settings.log_index << "]\n";
+        SILKRPC_ERROR << "Use --log_index flag to specify a directory holding the log index (empty disables the log index)\n";
+        return false;
+    }
+
+    const std::filesystem::path timestamp_index{settings.timestamp_index};
+    if (!timestamp_index.empty() && timestamp_index.has_parent_path() && !std::filesystem::is_directory(timestamp_index.parent_path())) {
+        SILKRPC_ERROR << "Parameter timestamp_index is invalid: [" << settings.timestamp_index << "]\n";
+        SILKRPC_ERROR << "Use --timestamp_index flag to specify a file in an existing directory (empty disables the timestamp index)\n";
+        return false;
+    }
+
+    const std::filesystem::path trace_store{settings.trace_store};
+    if (!trace_store.empty() && std::filesystem::exists(trace_store) && !std::filesystem::is_directory(trace_store)) {
+        SILKRPC_ERROR << "Parameter trace_store is invalid: [" << settings.trace_store << "]\n";
+        SILKRPC_ERROR << "Use --trace_store flag to specify a directory holding the trace store (empty disables the trace store)\n";
+        return false;
+    }
+
+    const std::filesystem::path snapshots_dir{settings.snapshots_dir};
+    if (!snapshots_dir.empty() && !std::filesystem::is_directory(snapshots_dir)) {
+        SILKRPC_ERROR << "Parameter snapshots_dir is invalid: [" << settings.snapshots_dir << "]\n";
+        SILKRPC_ERROR << "Use --snapshots_dir flag to specify the directory holding the Erigon snapshot segment files (empty disables the local snapshot reading)\n";
+        return false;
+    }
+
+    try {
+        ethdb::kv::StorageFilter::parse_addresses(settings.state_cache_storage_addresses);
+    } catch (const std::invalid_argument& ia) {
+        SILKRPC_ERROR << "Parameter state_cache_storage_addresses is invalid: " << ia.what() << "\n";
+        SILKRPC_ERROR << "Use --state_cache_storage_addresses flag to specify the contracts as comma-separated list of 0x-prefixed hex addresses (empty caches all)\n";
+        return false;
+    }
+
+    try {
+        parse_compression_algorithm(settings.grpc_compression);
+    } catch (const std::invalid_argument& ia) {
+        SILKRPC_ERROR << "Parameter grpc_compression is invalid: " << ia.what() << "\n";
+        SILKRPC_ERROR << "Use --grpc_compression flag to specify the gRPC message compression as gzip or deflate (empty disables compression)\n";
+        return false;
+    }
+
+    if (!settings.peers.empty()) {
+        try {
+            const auto self = PeerRing::parse_peers(settings.peer_self);
+            if (self.size() != 1) {
+                throw std::invalid_argument{"expected one peer: " + settings.peer_self};
+            }
+            PeerRing{PeerRing::parse_peers(settings.peers), self.front()};
+        } catch (const std::invalid_argument& ia) {
+            SILKRPC_ERROR << "Parameters peers and peer_self are invalid: " << ia.what() << "\n";
+            SILKRPC_ERROR << "Use --peers flag to specify the replicas as comma-separated list like rpc1:8545,rpc2:8545 and --peer_self for this one among them\n";
+            return false;
+        }
+    }
+
     const auto api_spec = settings.api_spec;
     if (api_spec.empty()) {
         SILKRPC_ERROR << "Parameter api_spec is invalid: [" << api_spec << "]\n";
@@ -188,73 +417,600 @@ bool Daemon::validate_settings(const DaemonSettings& settings) {
     return true;
 }
 
-ChannelFactory Daemon::make_channel_factory(const DaemonSettings& settings) {
-    return [&settings]() {
+ChannelFactory Daemon::make_channel_factory(const DaemonSettings& settings, std::size_t target_index) {
+    const auto targets = parse_targets(settings.target);
+    const auto target = target_index < targets.size() ? targets[target_index] : settings.target;
+    return [&settings, target]() {
         grpc::ChannelArguments channel_args;
         // Allow to receive messages up to specified max size
         channel_args.SetMaxReceiveMessageSize(kRpcMaxReceiveMessageSize);
         // Allow each client to open its own TCP connection to server (sharing one single connection becomes a bottleneck under high load)
         channel_args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
-        return grpc::CreateCustomChannel(settings.target, grpc::InsecureChannelCredentials(), channel_args);
+        // Use a fixed HTTP/2 flow-control window per stream, if any, instead of the one estimated by BDP probing
+        if (settings.grpc_stream_window_size > 0) {
+            channel_args.SetInt(GRPC_ARG_HTTP2_STREAM_LOOKAHEAD_BYTES, static_cast<int>(settings.grpc_stream_window_size));
+            channel_args.SetInt(GRPC_ARG_HTTP2_BDP_PROBE, 0);
+        }
+        // Detect the broken connections by keepalive pings, if enabled, also when no call is in progress
+        if (settings.grpc_keepalive_time > 0) {
+            channel_args.SetInt(GRPC_ARG_KEEPALIVE_TIME_MS, static_cast<int>(settings.grpc_keepalive_time));
+            channel_args.SetInt(GRPC_ARG_KEEPALIVE_TIMEOUT_MS, static_cast<int>(kGrpcKeepAliveTimeout.count()));
+            channel_args.SetInt(GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS, 1);
+        }
+        // Compress the calls by default, so that the backend compresses its replies in kind: the calls small both ways opt out
+        const auto compression_algorithm{parse_compression_algorithm(settings.grpc_compression)};
+        if (compression_algorithm != GRPC_COMPRESS_NONE) {
+            channel_args.SetCompressionAlgorithm(compression_algorithm);
+        }
+        return grpc::CreateCustomChannel(target, grpc::InsecureChannelCredentials(), channel_args);
     };
 }
 
+std::vector<ChannelFactory> Daemon::make_replica_channel_factories(const DaemonSettings& settings) {
+    std::vector<ChannelFactory> factories;
+    const auto num_targets = parse_targets(settings.target).size();
+    for (std::size_t i{1}; i < num_targets; ++i) {
+        factories.push_back(make_channel_factory(settings, i));
+    }
+    return factories;
+}
+
+std::shared_ptr<::mdbx::env_managed> Daemon::open_chaindata_env(const DaemonSettings& settings) {
+    if (settings.chaindata.empty()) {
+        return nullptr;
+    }
+    return ethdb::file::LocalDatabase::open_chaindata(settings.chaindata);
+}
+
+std::shared_ptr<ethdb::file::LogIndex> Daemon::open_log_index(const DaemonSettings& settings) {
+    if (settings.log_index.empty()) {
+        return nullptr;
+    }
+    return std::make_shared<ethdb::file::LogIndex>(settings.log_index);
+}
+
+CpuList Daemon::resolve_cpus(const std::string& cpu_list, int32_t numa_node) {
+    if (!cpu_list.empty()) {
+        return parse_cpu_list(cpu_list);
+    }
+    if (numa_node < 0) {
+        return {};
+    }
+    auto cpus = numa_node_cpus(static_cast<uint32_t>(numa_node));
+    if (cpus.empty()) {
+        SILKRPC_WARN << "Daemon::resolve_cpus no CPUs found for NUMA node: " << numa_node << ", threads not pinned\n";
+    }
+    return cpus;
+}
+
 Daemon::Daemon(const DaemonSettings& settings, const std::string& jwt_secret)
     : settings_(settings),
       create_channel_{make_channel_factory(settings_)},
-      context_pool_{settings_.num_contexts, create_channel_, settings_.wait_mode},
-      worker_pool_{settings_.num_workers},
+      create_replica_channels_{make_replica_channel_factories(settings_)},
+      chaindata_env_{open_chaindata_env(settings_)},
+      log_index_{open_log_index(settings_)},
+      context_pool_{settings_.num_contexts, create_channel_, settings_.wait_mode, chaindata_env_, log_index_, settings_.num_kv_channels,
+          resolve_cpus(settings_.context_cpus, settings_.numa_node), std::chrono::microseconds{settings_.wait_latency_budget},
+          kNumReservedContexts, create_replica_channels_},
+      worker_pool_{settings_.num_workers, settings_.num_long_running_workers, settings_.max_workers},
+      engine_worker_pool_{kNumEngineWorkers},
       jwt_secret_{jwt_secret},
       kv_stub_{remote::KV::NewStub(create_channel_())} {
-    // Create the unique KV state-changes stream feeding the state cache
-    auto& context = context_pool_.next_context();
+    // Pin the worker threads and bind their heaps before any task is posted, so that each one gets exactly one such task
+    const auto worker_cpus = resolve_cpus(settings_.worker_cpus, settings_.numa_node);
+    pin_thread_pool(worker_pool_.pool(WorkloadClass::short_call), worker_pool_.size(WorkloadClass::short_call), worker_cpus);
+    if (settings_.num_long_running_workers > 0) {
+        pin_thread_pool(worker_pool_.pool(WorkloadClass::long_running), worker_pool_.size(WorkloadClass::long_running), worker_cpus);
+    }
+    bind_thread_pool_heap(worker_pool_.pool(WorkloadClass::short_call), worker_pool_.size(WorkloadClass::short_call), "short_call");
+    if (settings_.num_long_running_workers > 0) {
+        bind_thread_pool_heap(worker_pool_.pool(WorkloadClass::long_running), worker_pool_.size(WorkloadClass::long_running), "long_running");
+    }
+    bind_thread_pool_heap(engine_worker_pool_.pool(), engine_worker_pool_.size(), "engine");
+
+    // Shed the requests exceeding their concurrency limits, if any
+    if (!settings_.admission_limits.empty()) {
+        const auto limits = AdmissionControl::parse_limits(settings_.admission_limits);
+        context_pool_.set_admission_control(
+            std::make_shared<AdmissionControl>(limits, std::chrono::milliseconds{settings_.admission_queue_budget}));
+    }
+
+    // Limit the rate of the requests of each client weighted by their method costs, if enabled
+    if (settings_.rate_limit > 0) {
+        context_pool_.set_rate_limiter(std::make_shared<RateLimiter>(settings_.rate_limit, settings_.rate_limit_burst));
+    }
+
+    // Stop the requests running past their default timeouts, if any
+    if (!settings_.request_timeouts.empty()) {
+        const auto timeouts = RequestTimeouts::parse_timeouts(settings_.request_timeouts);
+        context_pool_.set_request_timeouts(std::make_shared<RequestTimeouts>(timeouts));
+    }
+
+    // Trace a sample of the requests, if enabled
+    if (!settings_.trace_file.empty()) {
+        context_pool_.set_tracer(std::make_shared<Tracer>(settings_.trace_file, settings_.trace_sample_interval));
+    }
+
+    // Record a sample of the request bodies for later replay, if enabled
+    if (!settings_.record_file.empty()) {
+        context_pool_.set_request_recorder(std::make_shared<RequestRecorder>(settings_.record_file, settings_.record_sample_interval,
+            settings_.record_replies));
+    }
+
+    // The method latencies are shared among all the contexts, so any of them can configure the costs and slow requests
+    const auto& method_latencies = context_pool_.next_context().method_latencies();
+    method_latencies->set_costs_accounted(settings_.request_costs);
+    method_latencies->set_slow_request_threshold(std::chrono::milliseconds{settings_.slow_request_threshold});
+
+    // Serve the sampling profiler on the HTTP end-points, if enabled
+    if (settings_.profile_endpoint) {
+        context_pool_.set_sampling_profiler(std::make_shared<SamplingProfiler>());
+    }
+
+    // Compress the big cached blocks and contract code, if enabled and available
+    std::size_t compression_threshold{settings_.cache_compression_threshold};
+    if (compression_threshold > 0 && !compression_available()) {
+        SILKRPC_WARN << "Daemon::Daemon cache compression requested but LZ4 not available, values kept uncompressed\n";
+        compression_threshold = 0;
+    }
+
+    // Evict the state cache keys using the configured policy, cache the storage of the configured contracts only and the absent
+    // keys, if any, compressing the big code
+    if (settings_.state_cache_eviction_policy != ethdb::kv::EvictionPolicyType::lru || !settings_.state_cache_storage_addresses.empty() ||
+        settings_.state_cache_auto_storage_addresses > 0 || settings_.state_cache_max_absent_keys > 0 || compression_threshold > 0) {
+        ethdb::kv::CoherentCacheConfig state_cache_config;
+        state_cache_config.eviction_policy = settings_.state_cache_eviction_policy;
+        state_cache_config.storage_addresses = ethdb::kv::StorageFilter::parse_addresses(settings_.state_cache_storage_addresses);
+        state_cache_config.max_auto_storage_addresses = settings_.state_cache_auto_storage_addresses;
+        state_cache_config.max_absent_keys = settings_.state_cache_max_absent_keys;
+        state_cache_config.code_compression_threshold = compression_threshold;
+        context_pool_.set_state_cache(std::make_shared<ethdb::kv::CoherentStateCache>(state_cache_config));
+    }
+
+    // Keep the cached blocks RLP-encoded, if enabled, so that the same budget holds more of them, compressing the big ones
+    if (settings_.compact_block_cache || compression_threshold > 0) {
+        context_pool_.set_block_cache(std::make_shared<BlockCache>(BlockCache::kDefaultMaxBytes, /*shared_cache=*/true,
+            BlockCache::kDefaultNumShards, /*compact=*/true, compression_threshold));
+    }
+
+    // Keep the blocks and receipts read so far on local disk as secondary tier of their memory caches, if enabled
+    if (!settings_.disk_cache.empty()) {
+        auto disk_cache = std::make_shared<DiskCache>(settings_.disk_cache, std::size_t{settings_.disk_cache_size} << 20);
+        SILKRPC_LOG << "Disk cache enabled: " << disk_cache->size() << " values in " << disk_cache->size_bytes() << " bytes\n";
+        auto& context = context_pool_.next_context();
+        context.block_cache()->disk_cache() = disk_cache;
+        context.receipt_cache()->disk_cache() = disk_cache;
+    }
+
+    // Share the sealed chunks of the state history indexes among the historical state reads
+    context_pool_.set_history_cache(std::make_shared<HistoryCache>());
+
+    // Share the log offset tables of the blocks among the log scans, so that each block is fully decoded once
+    context_pool_.set_log_offset_cache(std::make_shared<ethdb::file::LogOffsetCache>());
+
+    // Share the contract code among all the executions, whatever the block
+    context_pool_.set_code_cache(std::make_shared<CodeCache>());
+
+    // Share the intra-block state checkpoints among the transaction traces, resuming the replay of their blocks
+    context_pool_.set_state_checkpoint_cache(std::make_shared<StateCheckpointCache>());
+
+    // Share the eth_call results at latest among all the contexts until their read set changes, if enabled
+    if (settings_.call_result_cache_size > 0) {
+        context_pool_.set_call_result_cache(std::make_shared<CallResultCache>(settings_.call_result_cache_size));
+    }
+
+    // Persist the traces of the replayed blocks for the later trace queries, if enabled
+    if (!settings_.trace_store.empty()) {
+        context_pool_.set_trace_store(std::make_shared<ethdb::file::TraceStore>(settings_.trace_store));
+    }
+
+    // Read the frozen blocks from the memory-mapped snapshot segment files, if enabled, instead of reading the database
+    if (!settings_.snapshots_dir.empty()) {
+        auto snapshots = std::make_shared<const ethdb::snapshot::SnapshotRepository>(settings_.snapshots_dir);
+        SILKRPC_LOG << "Snapshots enabled: " << snapshots->segment_count() << " segment ranges up to block " << snapshots->frozen_blocks() << "\n";
+        context_pool_.set_snapshots(std::move(snapshots));
+    }
+
+    // Keep the filters installed by eth_newFilter and eth_newBlockFilter for all the executions
+    context_pool_.set_filter_registry(std::make_shared<filters::FilterRegistry>());
+
+    // Recover the senders of the submitted raw transactions on the workers, keeping them for the lookups while pending
+    context_pool_.set_sender_recovery(std::make_shared<core::SenderRecovery>(worker_pool_.pool(WorkloadClass::short_call),
+        std::make_shared<SenderCache>()));
+
+    // Verify the proofs of work submitted against the epoch caches built in background, without stalling the short calls
+    context_pool_.set_work_verifier(std::make_shared<ethash::WorkVerifier>(worker_pool_.pool(WorkloadClass::long_running)));
+
+    // Share the block headers read without their bodies among all the header queries
+    context_pool_.set_header_cache(std::make_shared<HeaderCache>());
+
+    // Keep the block timestamps in memory for the lookups by timestamp, if enabled, starting from the ones saved last time
+    if (!settings_.timestamp_index.empty()) {
+        auto timestamp_index = std::make_shared<TimestampIndex>();
+        if (timestamp_index->load(settings_.timestamp_index)) {
+            SILKRPC_LOG << "Timestamp index loaded with " << timestamp_index->size() << " blocks from " << settings_.timestamp_index << "\n";
+        }
+        context_pool_.set_timestamp_index(timestamp_index);
+    }
+
+    // Keep the issuance of the recent blocks in memory with their running totals for erigon_watchTheBurn
+    context_pool_.set_issuance_index(std::make_shared<IssuanceIndex>());
+
+    // Share the trie nodes read by eth_getProof among the proofs built on the same database view
+    context_pool_.set_trie_node_cache(std::make_shared<TrieNodeCache>());
+
+    // Route the requests scoped to one block or account to the replica owning it, so that the replica caches do not overlap
+    if (!settings_.peers.empty()) {
+        const auto peers = PeerRing::parse_peers(settings_.peers);
+        const auto self = PeerRing::parse_peers(settings_.peer_self).front();
+        context_pool_.set_peer_ring(std::make_shared<PeerRing>(peers, self));
+        SILKRPC_LOG << "Peer mode enabled as " << self.to_string() << " among " << peers.size() << " replicas\n";
+    }
+
+    // Share the block numbers of the chain head tags among the requests reading the same database view
+    auto chain_head_cache = std::make_shared<ChainHeadCache>();
+    context_pool_.set_chain_head_cache(chain_head_cache);
+
+    // Combine the identical point reads in flight on the same database view among the requests of each context
+    context_pool_.enable_read_combining();
+
+    // Create the unique KV state-changes stream feeding the state cache through the applier off the stream scheduler: the
+    // stream and the components following the chain run on their own reserved context, i.e. their own completion queue and
+    // thread, so that the cache freshness does not depend on the query load
+    auto& context = context_pool_.reserved_context(kStreamingContextIndex);
+    context_pool_.set_streaming_load(context.load());
+    state_changes_applier_ = std::make_shared<ethdb::kv::StateChangesApplier>(context.state_cache().get());
+    context_pool_.set_state_changes_applier(state_changes_applier_);
     state_changes_stream_ = std::make_unique<ethdb::kv::StateChangesStream>(context, kv_stub_.get());
+
+    // Invalidate the cached log index, log offsets and state history chunks from the same stream, because unwinding
+    // rewrites them, and follow the chain head to tell the final state history changes
+    state_changes_stream_->add_listener([bitmap_cache = context.bitmap_cache(), history_cache = context.history_cache(),
+        log_offset_cache = context.log_offset_cache()](const remote::StateChangeBatch& state_changes) {
+        bool unwind{false};
+        for (const auto& state_change : state_changes.changebatch()) {
+            if (state_change.direction() == remote::Direction::UNWIND) {
+                history_cache->unwind(state_change.blockheight());
+                unwind = true;
+            } else {
+                history_cache->set_head_block(state_change.blockheight());
+            }
+        }
+        if (unwind) {
+            bitmap_cache->invalidate();
+            history_cache->invalidate();
+            log_offset_cache->invalidate();
+        }
+    });
+
+    // Drop the cached replies pinned to the unwound blocks on chain reorganizations from the same stream
+    state_changes_stream_->add_listener([reply_cache = context.reply_cache()](const remote::StateChangeBatch& state_changes) {
+        for (const auto& state_change : state_changes.changebatch()) {
+            if (state_change.direction() == remote::Direction::UNWIND) {
+                reply_cache->unwind(state_change.blockheight());
+            }
+        }
+    });
+
+    // Drop the cached eth_call results whose read set is changed by the new blocks from the same stream, if enabled
+    if (context.call_result_cache()) {
+        state_changes_stream_->add_listener([call_result_cache = context.call_result_cache()](const remote::StateChangeBatch& state_changes) {
+            for (const auto& state_change : state_changes.changebatch()) {
+                if (state_change.direction() == remote::Direction::UNWIND) {
+                    call_result_cache->unwind();
+                    continue;
+                }
+                std::vector<evmc::address> changed_accounts;
+                std::vector<StorageLocation> changed_locations;
+                for (const auto& account_change : state_change.changes()) {
+                    const auto address = silkworm::rpc::address_from_H160(account_change.address());
+                    if (account_change.action() != remote::Action::STORAGE) {
+                        changed_accounts.push_back(address);
+                        continue;
+                    }
+                    for (const auto& storage_change : account_change.storagechanges()) {
+                        changed_locations.emplace_back(address, silkworm::rpc::bytes32_from_H256(storage_change.location()));
+                    }
+                }
+                call_result_cache->apply(state_change.blockheight(), changed_accounts, changed_locations);
+            }
+        });
+    }
+
+    // Reclaim the stored traces of the unwound blocks from the same stream, if enabled: they are keyed by hash, so never stale
+    if (context.trace_store()) {
+        state_changes_stream_->add_listener([trace_store = context.trace_store()](const remote::StateChangeBatch& state_changes) {
+            for (const auto& state_change : state_changes.changebatch()) {
+                if (state_change.direction() == remote::Direction::UNWIND) {
+                    trace_store->unwind(state_change.blockheight());
+                }
+            }
+        });
+    }
+
+    // Rotate the transactions kept open by the execution contexts at each new view from the same stream
+    state_changes_stream_->add_listener([&](const remote::StateChangeBatch& state_changes) {
+        context_pool_.notify_new_view(state_changes.databaseviewid());
+    });
+
+    // Prime the latest block number of each new view from the same stream, i.e. the head reached by the forward changes
+    state_changes_stream_->add_listener([chain_head_cache](const remote::StateChangeBatch& state_changes) {
+        const auto& changes = state_changes.changebatch();
+        if (!changes.empty() && changes[changes.size() - 1].direction() == remote::Direction::FORWARD) {
+            chain_head_cache->put(state_changes.databaseviewid(), ChainHeadTag::kLatest, changes[changes.size() - 1].blockheight());
+        }
+    });
+
+    // Advance and rewind the canonical hashes of the most recent blocks of each new view from the same stream
+    state_changes_stream_->add_listener([chain_head_cache](const remote::StateChangeBatch& state_changes) {
+        std::vector<CanonicalChange> canonical_changes;
+        canonical_changes.reserve(static_cast<std::size_t>(state_changes.changebatch_size()));
+        for (const auto& state_change : state_changes.changebatch()) {
+            canonical_changes.push_back(CanonicalChange{
+                state_change.blockheight(),
+                silkworm::rpc::bytes32_from_H256(state_change.blockhash()),
+                state_change.direction() == remote::Direction::UNWIND});
+        }
+        chain_head_cache->canonical_hashes().apply(state_changes.databaseviewid(), canonical_changes);
+    });
+
+    // Stop coalescing the requests in flight before each new head from the same stream
+    state_changes_stream_->add_listener([single_flight = context.single_flight()](const remote::StateChangeBatch& /*state_changes*/) {
+        single_flight->advance_epoch();
+    });
+
+    // Keep the price suggested at the latest head up to date from the same stream
+    gas_price_updater_ = std::make_unique<GasPriceUpdater>(context);
+    state_changes_stream_->add_listener([&](const remote::StateChangeBatch& state_changes) {
+        gas_price_updater_->on_state_changes(state_changes);
+    });
+
+    // Build the log index from the same stream, if enabled
+    if (log_index_) {
+        log_indexer_ = std::make_unique<ethdb::kv::LogIndexer>(context, log_index_);
+        state_changes_stream_->add_listener([&](const remote::StateChangeBatch& state_changes) {
+            log_indexer_->on_state_changes(state_changes);
+        });
+    }
+
+    // Build the timestamp index from the same stream, if enabled
+    if (context.timestamp_index()) {
+        timestamp_indexer_ = std::make_unique<ethdb::kv::TimestampIndexer>(context, context.timestamp_index());
+        state_changes_stream_->add_listener([&](const remote::StateChangeBatch& state_changes) {
+            timestamp_indexer_->on_state_changes(state_changes);
+        });
+    }
+
+    // Prefetch each new head into the caches from the same stream, if enabled
+    if (settings_.prefetch_head_block) {
+        head_prefetcher_ = std::make_unique<ethdb::kv::HeadPrefetcher>(context);
+        state_changes_stream_->add_listener([&](const remote::StateChangeBatch& state_changes) {
+            head_prefetcher_->on_state_changes(state_changes);
+        });
+    }
+
+    // Compute the issuance of the new blocks from the same stream
+    issuance_indexer_ = std::make_unique<ethdb::kv::IssuanceIndexer>(context, context.issuance_index());
+    state_changes_stream_->add_listener([&](const remote::StateChangeBatch& state_changes) {
+        issuance_indexer_->on_state_changes(state_changes);
+    });
+
+    // Mirror the transaction pool locally, reconciling it at each new block from the same stream
+    auto pool_mirror = std::make_shared<txpool::PoolMirror>();
+    context_pool_.set_pool_mirror(pool_mirror);
+    pool_mirror_updater_ = std::make_unique<txpool::PoolMirrorUpdater>(context, create_channel_(), pool_mirror);
+    state_changes_stream_->add_listener([&](const remote::StateChangeBatch& state_changes) {
+        pool_mirror_updater_->on_state_changes(state_changes);
+    });
+
+    // Refresh in background the remote backend values polled by load balancers and health checkers
+    auto backend_info_cache = std::make_shared<ethbackend::BackEndInfoCache>();
+    context_pool_.set_backend_info_cache(backend_info_cache);
+    backend_info_updater_ = std::make_unique<ethbackend::BackEndInfoUpdater>(context, backend_info_cache);
+
+    // Feed the installed filters from the same stream
+    filter_publisher_ = std::make_unique<filters::FilterPublisher>(context, *context.filter_registry());
+    state_changes_stream_->add_listener([&](const remote::StateChangeBatch& state_changes) {
+        filter_publisher_->on_state_changes(state_changes);
+    });
+
+    // Feed the WebSocket subscriptions from the same stream, if enabled
+    if (!settings_.ws_port.empty()) {
+        subscription_publisher_ = std::make_unique<ws::SubscriptionPublisher>(context, subscription_registry_);
+        state_changes_stream_->add_listener([&](const remote::StateChangeBatch& state_changes) {
+            subscription_publisher_->on_state_changes(state_changes);
+        });
+    }
+
+    // Prefetch the hot keys abandoned by chain reorganizations from the same stream, if warm up is enabled
+    if (!settings_.state_cache_warm_up_file.empty()) {
+        state_cache_warmer_ = std::make_unique<ethdb::kv::StateCacheWarmer>(context);
+        state_changes_stream_->add_listener([&](const remote::StateChangeBatch& state_changes) {
+            state_cache_warmer_->on_state_changes(state_changes);
+        });
+    }
 }
 
 DaemonChecklist Daemon::run_checklist() {
     const auto core_service_channel{create_channel_()};
 
-    const auto kv_protocol_check{silkrpc::wait_for_kv_protocol_check(core_service_channel)};
-    const auto ethbackend_protocol_check{silkrpc::wait_for_ethbackend_protocol_check(core_service_channel)};
-    const auto mining_protocol_check{silkrpc::wait_for_mining_protocol_check(core_service_channel)};
-    const auto txpool_protocol_check{silkrpc::wait_for_txpool_protocol_check(core_service_channel)};
+    // Check all the protocols concurrently with a common deadline, so that the startup waits for the slowest one only
+    ProtocolCheckDeadline deadline;
+    if (settings_.protocol_check_timeout > 0) {
+        deadline = std::chrono::system_clock::now() + std::chrono::milliseconds{settings_.protocol_check_timeout};
+    }
+    auto kv_protocol_check{std::async(std::launch::async, [&]() { return wait_for_kv_protocol_check(core_service_channel, deadline); })};
+    auto ethbackend_protocol_check{std::async(std::launch::async, [&]() { return wait_for_ethbackend_protocol_check(core_service_channel, deadline); })};
+    auto mining_protocol_check{std::async(std::launch::async, [&]() { return wait_for_mining_protocol_check(core_service_channel, deadline); })};
+    auto txpool_protocol_check{std::async(std::launch::async, [&]() { return wait_for_txpool_protocol_check(core_service_channel, deadline); })};
 
-    DaemonChecklist checklist{{kv_protocol_check, ethbackend_protocol_check, mining_protocol_check, txpool_protocol_check}};
+    DaemonChecklist checklist{{kv_protocol_check.get(), ethbackend_protocol_check.get(), mining_protocol_check.get(), txpool_protocol_check.get()}};
     return checklist;
 }
 
 void Daemon::start() {
+    // Run the contexts before starting any service, because the state cache warm up reads from them
+    context_pool_.start();
+
+    if (state_cache_warmer_) {
+        warm_up_state_cache();
+    }
+
+    // The connections on the public end-points are limited all together, the Engine API ones are never timed out or refused
+    const http::ConnectionSettings connection_settings{std::chrono::milliseconds{settings_.http_idle_timeout},
+        std::chrono::milliseconds{settings_.http_read_timeout}, settings_.http_max_requests_per_connection};
+    if (settings_.http_max_connections > 0) {
+        connection_manager_ = std::make_shared<http::ConnectionManager>(settings_.http_max_connections);
+    }
+
     for (int i = 0; i < settings_.num_contexts; ++i) {
         auto& context = context_pool_.next_context();
         rpc_services_.emplace_back(
-            std::make_unique<http::Server>(settings_.http_port, settings_.api_spec, context, worker_pool_, std::nullopt /* no jwt_secret_file */));
+            std::make_unique<http::Server>(settings_.http_port, settings_.api_spec, context, worker_pool_, std::nullopt /* no jwt_secret_file */,
+                settings_.max_pipelined_requests, settings_.max_batch_concurrency,
+                http::CompressionSettings{settings_.http_compression_level, settings_.http_compression_min_size},
+                connection_settings, connection_manager_));
+        api_tables_.push_back(&rpc_services_.back()->handler_table());
+        if (!settings_.ws_port.empty()) {
+            ws_services_.emplace_back(
+                std::make_unique<ws::Server>(settings_.ws_port, settings_.api_spec, context, worker_pool_, subscription_registry_));
+            api_tables_.push_back(&ws_services_.back()->handler_table());
+        }
+    }
+
+    // The Engine API is served on its own reserved context and workers, so that its latency does not depend on the public traffic
+    rpc_services_.emplace_back(
+        std::make_unique<http::Server>(settings_.engine_port, kDefaultEth2ApiSpec, context_pool_.reserved_context(kEngineContextIndex), engine_worker_pool_,
+            jwt_secret_, settings_.max_pipelined_requests, settings_.max_batch_concurrency));
+
+    // One single acceptor for the Unix domain socket spreads its connections over all the contexts
+    if (!settings_.http_unix_socket.empty()) {
         rpc_services_.emplace_back(
-            std::make_unique<http::Server>(settings_.engine_port, kDefaultEth2ApiSpec, context, worker_pool_, jwt_secret_));
+            std::make_unique<http::Server>(kUnixSocketPrefix + settings_.http_unix_socket, settings_.api_spec, context_pool_, worker_pool_,
+                std::nullopt /* no jwt_secret_file */, settings_.max_pipelined_requests, settings_.max_batch_concurrency,
+                http::CompressionSettings{settings_.http_compression_level, settings_.http_compression_min_size},
+                connection_settings, connection_manager_));
+        api_tables_.push_back(&rpc_services_.back()->handler_table());
     }
 
     for (auto& service : rpc_services_) {
         service->start();
     }
+    for (auto& service : ws_services_) {
+        service->start();
+    }
 
     // Open the KV state-changes stream feeding the state cache
     state_changes_stream_->open();
 
-    context_pool_.start();
+    // Start mirroring the transaction pool
+    pool_mirror_updater_->open();
+
+    // Start refreshing the remote backend values
+    backend_info_updater_->open();
 }
 
 void Daemon::stop() {
     // Cancel registration for incoming KV state changes
     state_changes_stream_->close();
 
+    // Stop applying the state changes, so that no batch is notified anymore
+    state_changes_applier_->stop();
+
+    // Stop mirroring the transaction pool
+    pool_mirror_updater_->close();
+
+    // Stop refreshing the remote backend values
+    backend_info_updater_->close();
+
+    if (state_cache_warmer_) {
+        dump_state_cache_hot_keys();
+    }
+
+    if (timestamp_indexer_) {
+        save_timestamp_index();
+    }
+
     context_pool_.stop();
 
     for (auto& service : rpc_services_) {
         service->stop();
     }
+    for (auto& service : ws_services_) {
+        service->stop();
+    }
 }
 
 void Daemon::join() {
     context_pool_.join();
 }
 
+void Daemon::reload() {
+    ReloadSettings reload_settings;
+    try {
+        reload_settings = ReloadSettings::read(settings_.reload_file);
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "Daemon::reload failed, settings unchanged: " << e.what() << "\n";
+        return;
+    }
+
+    if (reload_settings.api_spec) {
+        SILKRPC_LOG << "Reloading API namespaces: " << *reload_settings.api_spec << "\n";
+        for (auto* api_table : api_tables_) {
+            api_table->reload(*reload_settings.api_spec);
+        }
+    }
+
+    // The caches are shared by all the contexts, hence any context gives access to them
+    auto& context = context_pool_.next_context();
+    if (reload_settings.block_cache_size) {
+        SILKRPC_LOG << "Resizing block cache to " << *reload_settings.block_cache_size << " bytes\n";
+        context.block_cache()->set_max_bytes(*reload_settings.block_cache_size);
+    }
+    if (reload_settings.state_cache_max_keys) {
+        SILKRPC_LOG << "Resizing state cache to " << *reload_settings.state_cache_max_keys << " keys\n";
+        context.state_cache()->set_max_state_keys(*reload_settings.state_cache_max_keys);
+    }
+    if (reload_settings.state_cache_max_code_size) {
+        SILKRPC_LOG << "Resizing state cache to " << *reload_settings.state_cache_max_code_size << " code bytes\n";
+        context.state_cache()->set_max_code_bytes(*reload_settings.state_cache_max_code_size);
+    }
+    if (reload_settings.max_workers) {
+        worker_pool_.set_max_size(*reload_settings.max_workers);
+        SILKRPC_LOG << "Changing max workers to " << worker_pool_.max_size() << "\n";
+    }
+}
+
+void Daemon::warm_up_state_cache() {
+    const auto hot_keys = ethdb::kv::read_hot_keys(settings_.state_cache_warm_up_file);
+    if (!hot_keys) {
+        return;
+    }
+    SILKRPC_LOG << "Warming up state cache with " << hot_keys->state_keys.size() << " state keys, " << hot_keys->code_keys.size()
+                << " code keys from " << settings_.state_cache_warm_up_file << "...\n";
+    const auto num_added = state_cache_warmer_->warm_up(*hot_keys).get();
+    SILKRPC_LOG << "State cache warmed up with " << num_added << " keys\n";
+}
+
+void Daemon::dump_state_cache_hot_keys() {
+    try {
+        const auto hot_keys = context_pool_.next_context().state_cache()->hot_keys();
+        ethdb::kv::write_hot_keys(settings_.state_cache_warm_up_file, hot_keys);
+        SILKRPC_LOG << "State cache hot keys dumped: " << hot_keys.state_keys.size() << " state keys, " << hot_keys.code_keys.size()
+                    << " code keys to " << settings_.state_cache_warm_up_file << "\n";
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "State cache hot keys not dumped: " << e.what() << "\n";
+    }
+}
+
+void Daemon::save_timestamp_index() {
+    try {
+        const auto& timestamp_index = context_pool_.next_context().timestamp_index();
+        timestamp_index->save(settings_.timestamp_index);
+        SILKRPC_LOG << "Timestamp index saved with " << timestamp_index->size() << " blocks to " << settings_.timestamp_index << "\n";
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "Timestamp index not saved: " << e.what() << "\n";
+    }
+}
+
 } // namespace silkrpc
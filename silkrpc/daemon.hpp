@@ -17,18 +17,34 @@
 #ifndef SILKRPC_DAEMON_HPP_
 #define SILKRPC_DAEMON_HPP_
 
+#include <cstddef>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
-#include <boost/asio/thread_pool.hpp>
-
 #include <silkrpc/common/constants.hpp>
 #include <silkrpc/common/log.hpp>
 #include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/concurrency/cpu_affinity.hpp>
+#include <silkrpc/concurrency/worker_pool.hpp>
+#include <silkrpc/core/gas_price_updater.hpp>
+#include <silkrpc/ethbackend/backend_info_updater.hpp>
+#include <silkrpc/ethdb/file/log_index.hpp>
+#include <silkrpc/ethdb/kv/head_prefetcher.hpp>
+#include <silkrpc/ethdb/kv/log_indexer.hpp>
+#include <silkrpc/ethdb/kv/state_cache.hpp>
+#include <silkrpc/ethdb/kv/state_cache_warmer.hpp>
 #include <silkrpc/ethdb/kv/state_changes_stream.hpp>
+#include <silkrpc/ethdb/kv/issuance_indexer.hpp>
+#include <silkrpc/ethdb/kv/timestamp_indexer.hpp>
+#include <silkrpc/filters/filter_publisher.hpp>
 #include <silkrpc/http/server.hpp>
 #include <silkrpc/protocol/version.hpp>
+#include <silkrpc/txpool/pool_mirror_updater.hpp>
+#include <silkrpc/ws/server.hpp>
+#include <silkrpc/ws/subscription_publisher.hpp>
+#include <silkrpc/ws/subscription_registry.hpp>
 
 namespace silkrpc {
 
@@ -37,14 +53,87 @@ struct DaemonSettings {
     std::string http_port; // eth_end_point
     std::string engine_port; // engine_end_point
     std::string api_spec; // eth_api_spec
-    std::string target; // backend_kv_address
+    std::string target; // backend_kv_address, e.g. "erigon1:9090,erigon2:9090" where the first one is the primary
     uint32_t num_contexts;
     uint32_t num_workers;
     LogLevel log_verbosity;
     WaitMode wait_mode;
     std::string jwt_secret_filename;
+    uint32_t max_pipelined_requests{kDefaultMaxPipelinedRequests};
+    uint32_t max_batch_concurrency{kDefaultMaxBatchConcurrency};
+    uint32_t http_compression_level{kDefaultHttpCompressionLevel};
+    uint32_t http_compression_min_size{kDefaultHttpCompressionMinSize};
+    std::string ws_port; // eth_ws_end_point, empty means disabled
+    std::string http_unix_socket; // eth_unix_socket_path, empty means disabled
+    std::string state_cache_warm_up_file; // empty means disabled
+    std::string log_index; // empty means disabled
+    uint32_t num_kv_channels{kDefaultNumKvChannels}; // channels per context for the remote KV transactions
+    uint32_t grpc_stream_window_size{kDefaultGrpcStreamWindowSize}; // bytes, 0 means gRPC default
+    uint32_t grpc_keepalive_time{kDefaultGrpcKeepAliveTime}; // milliseconds, 0 means disabled
+    uint32_t num_long_running_workers{kDefaultNumLongRunningWorkers}; // debug and trace workers, 0 means shared with the others
+    std::string context_cpus; // CPU list like "0-3,8", empty means no pinning
+    std::string worker_cpus; // CPU list like "0-3,8", empty means no pinning
+    int32_t numa_node{-1}; // NUMA node whose CPUs are used when the CPU lists are empty, -1 means none
+    uint32_t wait_latency_budget{static_cast<uint32_t>(kDefaultWaitLatencyBudget.count())}; // microseconds, adaptive wait mode only
+    std::string admission_limits; // e.g. "debug=8,trace=8,eth_getLogs=16", empty means disabled
+    uint32_t admission_queue_budget{static_cast<uint32_t>(kDefaultAdmissionQueueBudget.count())}; // milliseconds
+    std::string request_timeouts; // e.g. "default=10000,debug=60000" in milliseconds, empty means disabled
+    std::string trace_file; // trace event file of the sampled requests, empty means disabled
+    uint32_t trace_sample_interval{kDefaultTraceSampleInterval}; // one request traced every such number
+    std::string record_file; // binary recording of the sampled request bodies, empty means disabled
+    uint32_t record_sample_interval{kDefaultRecordSampleInterval}; // one request recorded every such number
+    bool record_replies{false}; // record also reply sizes and latencies
+    std::string trace_store; // empty means disabled
+    std::string timestamp_index; // empty means disabled
+    bool prefetch_head_block{false}; // load each new head into the block, header and receipt caches
+    ethdb::kv::EvictionPolicyType state_cache_eviction_policy{ethdb::kv::EvictionPolicyType::lru};
+    std::string reload_file; // settings applied on SIGHUP, empty means disabled
+    uint32_t protocol_check_timeout{0}; // milliseconds to wait for the core services at startup, 0 means forever
+    std::string peers; // replicas like "rpc1:8545,rpc2:8545" routing the requests by block hash or address, empty means disabled
+    std::string peer_self; // the endpoint of this replica among the peers
+    bool compact_block_cache{false}; // keep the cached blocks RLP-encoded, decoding them on access
+    uint32_t http_idle_timeout{kDefaultHttpIdleTimeout}; // milliseconds waiting for the next request, 0 means forever
+    uint32_t http_read_timeout{kDefaultHttpReadTimeout}; // milliseconds to receive a whole request, 0 means forever
+    uint32_t http_max_requests_per_connection{0}; // 0 means no limit
+    uint32_t http_max_connections{0}; // closing the least recently idle ones beyond it, 0 means no limit
+    std::string snapshots_dir; // Erigon snapshot segment files read locally for the frozen blocks, empty means disabled
+    std::string state_cache_storage_addresses; // contracts like "0xa0b8...,0xc02a..." whose storage is cached, empty means all
+    uint32_t state_cache_auto_storage_addresses{0}; // contracts whose storage is cached once read often, 0 means disabled
+    uint32_t state_cache_max_absent_keys{0}; // keys found absent whose absence is cached, 0 means disabled
+    uint32_t call_result_cache_size{0}; // eth_call results at latest cached until their read set changes, 0 means disabled
+    uint32_t max_workers{0}; // workers the short calls can grow to under load, up to num_workers means fixed
+    bool profile_endpoint{false}; // sampling profiler served on GET /debug/profile
+    bool request_costs{false}; // thread CPU time and allocated bytes of the requests accounted by method
+    uint32_t slow_request_threshold{0}; // milliseconds beyond which the requests are logged with phases and costs, 0 means disabled
+    uint32_t rate_limit{0}; // tokens per second refilled in the bucket of each client, 0 means disabled
+    uint32_t rate_limit_burst{0}; // max tokens in the bucket of each client, 0 means the rate limit
+    uint32_t cache_compression_threshold{0}; // min bytes of the cached blocks and code kept compressed, 0 means disabled
+    std::string disk_cache; // on-disk secondary tier of the block and receipt caches, empty means disabled
+    uint32_t disk_cache_size{kDefaultDiskCacheSize}; // MiB of the disk cache segments
+    std::string grpc_compression; // "gzip" or "deflate" for the calls carrying bulk data, empty means disabled
+};
+
+//! The settings changed at runtime by reloading, each one left unchanged if missing
+struct ReloadSettings {
+    std::optional<std::string> api_spec;
+    std::optional<std::size_t> block_cache_size; // bytes
+    std::optional<uint32_t> state_cache_max_keys;
+    std::optional<std::size_t> state_cache_max_code_size; // bytes
+    std::optional<uint32_t> max_workers;
+
+    //! Parse the settings from name=value lines, skipping the empty ones and the comments starting with '#'
+    //! \throws std::invalid_argument if any line is malformed or has an unknown name
+    static ReloadSettings parse(const std::string& text);
+
+    //! Read and parse the settings from the specified file
+    //! \throws std::runtime_error if the file cannot be read, std::invalid_argument if malformed
+    static ReloadSettings read(const std::string& file_path);
 };
 
+//! Parse the comma-separated list of Erigon KV endpoints like "erigon1:9090,erigon2:9090", the primary one first
+//! \throws std::invalid_argument if any endpoint lacks the port or is repeated
+std::vector<std::string> parse_targets(const std::string& target);
+
 struct DaemonInfo {
     std::string build;
     std::string libraries;
@@ -72,9 +161,27 @@ class Daemon {
 
     void join();
 
+    //! Apply the settings read from the reload file to the running services: the API namespaces of the public
+    //! end-points are swapped in place and the cache budgets shrunk or grown, the entries in excess evicted gradually
+    void reload();
+
   protected:
     static bool validate_settings(const DaemonSettings& settings);
-    static ChannelFactory make_channel_factory(const DaemonSettings& settings);
+    //! Create the factory of the channels to the target at the specified index in the target list, the primary one being the first
+    static ChannelFactory make_channel_factory(const DaemonSettings& settings, std::size_t target_index = 0);
+    static std::vector<ChannelFactory> make_replica_channel_factories(const DaemonSettings& settings);
+    static std::shared_ptr<::mdbx::env_managed> open_chaindata_env(const DaemonSettings& settings);
+    static std::shared_ptr<ethdb::file::LogIndex> open_log_index(const DaemonSettings& settings);
+    static CpuList resolve_cpus(const std::string& cpu_list, int32_t numa_node);
+
+    //! Prefetch into the state cache the hot keys persisted by the previous run, if any
+    void warm_up_state_cache();
+
+    //! Persist the hot keys of the state cache for the next run
+    void dump_state_cache_hot_keys();
+
+    //! Persist the timestamp index for the next run
+    void save_timestamp_index();
 
     //! The RPC daemon configuration settings.
     const DaemonSettings& settings_;
@@ -82,20 +189,76 @@ class Daemon {
     //! The factory of gRPC client-side channels.
     ChannelFactory create_channel_;
 
-    //! The execution contexts capturing the asynchronous scheduling model.
+    //! The factories of gRPC client-side channels to the additional KV backends serving just the transactions.
+    std::vector<ChannelFactory> create_replica_channels_;
+
+    //! The chaindata MDBX environment read directly, if any, instead of the remote KV interface.
+    std::shared_ptr<::mdbx::env_managed> chaindata_env_;
+
+    //! The log index owned by Silkrpc, if enabled.
+    std::shared_ptr<ethdb::file::LogIndex> log_index_;
+
+    //! The registry of eth_subscribe subscriptions made on all WebSocket connections, outliving them.
+    ws::SubscriptionRegistry subscription_registry_;
+
+    //! The execution contexts capturing the asynchronous scheduling model, plus the ones reserved to the Engine API and the streams.
     ContextPool context_pool_;
 
-    //! The pool of workers for long-running tasks.
-    boost::asio::thread_pool worker_pool_;
+    //! The pools of workers for long-running tasks, one for each workload class.
+    WorkerPool worker_pool_;
+
+    //! The pool of workers reserved to the Engine API.
+    WorkerPool engine_worker_pool_;
+
+    //! The registry of the connections on the public HTTP end-points enforcing their max number, if enabled.
+    std::shared_ptr<http::ConnectionManager> connection_manager_;
 
     std::vector<std::unique_ptr<http::Server>> rpc_services_;
 
+    std::vector<std::unique_ptr<ws::Server>> ws_services_;
+
+    //! The handler tables of the services exposing the configured API namespaces, i.e. all but the Engine API.
+    std::vector<commands::RpcApiTable*> api_tables_;
+
+    //! The publisher of subscription notifications for the blocks announced by StateChanges stream.
+    std::unique_ptr<ws::SubscriptionPublisher> subscription_publisher_;
+
+    //! The publisher of the blocks announced by StateChanges stream to the installed filters.
+    std::unique_ptr<filters::FilterPublisher> filter_publisher_;
+
+    //! The updater of the local mirror of the transaction pool.
+    std::unique_ptr<txpool::PoolMirrorUpdater> pool_mirror_updater_;
+
+    //! The updater of the remote backend values served by net_version, net_peerCount and web3_clientVersion.
+    std::unique_ptr<ethbackend::BackEndInfoUpdater> backend_info_updater_;
+
     //! The gRPC KV interface client stub.
     std::unique_ptr<remote::KV::StubInterface> kv_stub_;
 
+    //! The applier of the state changes to the state cache on its own thread.
+    std::shared_ptr<ethdb::kv::StateChangesApplier> state_changes_applier_;
+
     //! The stream handling StateChanges server-streaming RPC.
     std::unique_ptr<ethdb::kv::StateChangesStream> state_changes_stream_;
 
+    //! The warmer prefetching the hot keys into the state cache at startup and after chain reorganizations, if enabled.
+    std::unique_ptr<ethdb::kv::StateCacheWarmer> state_cache_warmer_;
+
+    //! The indexer adding the new blocks to the log index and removing the unwound ones, if enabled.
+    std::unique_ptr<ethdb::kv::LogIndexer> log_indexer_;
+
+    //! The indexer appending the timestamps of the new blocks and removing the unwound ones, if enabled.
+    std::unique_ptr<ethdb::kv::TimestampIndexer> timestamp_indexer_;
+
+    //! The prefetcher loading each new head into the caches before the requests for it, if enabled.
+    std::unique_ptr<ethdb::kv::HeadPrefetcher> head_prefetcher_;
+
+    //! The indexer appending the issuance of the new blocks and removing the unwound ones.
+    std::unique_ptr<ethdb::kv::IssuanceIndexer> issuance_indexer_;
+
+    //! The updater computing the price suggested at each new block and dropping the unwound ones from the gas price cache.
+    std::unique_ptr<GasPriceUpdater> gas_price_updater_;
+
     //! The secret key for communication from CL & EL
     const std::string& jwt_secret_;
 };
@@ -37,4 +37,64 @@ TEST_CASE("DaemonChecklist::success_or_throw", "[silkrpc]") {
 }
 #endif // BUILD_COVERAGE
 
+TEST_CASE("parse_targets", "[silkrpc]") {
+    SECTION("empty target") {
+        CHECK(parse_targets("").empty());
+    }
+
+    SECTION("single target") {
+        CHECK(parse_targets("localhost:9090") == std::vector<std::string>{"localhost:9090"});
+    }
+
+    SECTION("multiple targets keep the primary first") {
+        CHECK(parse_targets("erigon1:9090, erigon2:9091") == std::vector<std::string>{"erigon1:9090", "erigon2:9091"});
+    }
+
+    SECTION("invalid targets") {
+        CHECK_THROWS_AS(parse_targets("localhost"), std::invalid_argument);
+        CHECK_THROWS_AS(parse_targets("localhost:"), std::invalid_argument);
+        CHECK_THROWS_AS(parse_targets("erigon1:9090,,erigon2:9090"), std::invalid_argument);
+        CHECK_THROWS_AS(parse_targets("erigon1:9090,erigon1:9090"), std::invalid_argument);
+    }
+}
+
+TEST_CASE("ReloadSettings::parse", "[silkrpc]") {
+    SECTION("empty") {
+        const auto settings = ReloadSettings::parse("");
+        CHECK(!settings.api_spec);
+        CHECK(!settings.block_cache_size);
+        CHECK(!settings.state_cache_max_keys);
+        CHECK(!settings.state_cache_max_code_size);
+        CHECK(!settings.max_workers);
+    }
+
+    SECTION("all settings with comments and blanks") {
+        const auto settings = ReloadSettings::parse(
+            "# reloaded on SIGHUP\n"
+            "api_spec = eth,net\n"
+            "\n"
+            "block_cache_size=1048576\r\n"
+            "  state_cache_max_keys=1000\n"
+            "state_cache_max_code_size=2097152\n"
+            "max_workers=32");
+        CHECK(settings.api_spec == "eth,net");
+        CHECK(settings.block_cache_size == 1'048'576);
+        CHECK(settings.state_cache_max_keys == 1'000);
+        CHECK(settings.state_cache_max_code_size == 2'097'152);
+        CHECK(settings.max_workers == 32);
+    }
+
+    SECTION("invalid") {
+        CHECK_THROWS_AS(ReloadSettings::parse("api_spec"), std::invalid_argument);
+        CHECK_THROWS_AS(ReloadSettings::parse("block_cache_size=big"), std::invalid_argument);
+        CHECK_THROWS_AS(ReloadSettings::parse("block_cache_size="), std::invalid_argument);
+        CHECK_THROWS_AS(ReloadSettings::parse("state_cache_max_keys=-1"), std::invalid_argument);
+        CHECK_THROWS_AS(ReloadSettings::parse("unknown=1"), std::invalid_argument);
+    }
+}
+
+TEST_CASE("ReloadSettings::read", "[silkrpc]") {
+    CHECK_THROWS_AS(ReloadSettings::read("nonexistent_reload_file"), std::runtime_error);
+}
+
 } // namespace silkrpc
@@ -22,6 +22,9 @@
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/use_awaitable.hpp>
 #include <evmc/evmc.hpp>
+#include <nlohmann/json.hpp>
+
+#include <silkrpc/json/types.hpp>
 #include <silkrpc/types/execution_payload.hpp>
 
 namespace silkrpc::ethbackend {
@@ -36,6 +39,13 @@ public:
     virtual boost::asio::awaitable<uint64_t> net_peer_count() = 0;
     virtual boost::asio::awaitable<ExecutionPayload> engine_get_payload_v1(uint64_t payload_id) = 0;
     virtual boost::asio::awaitable<PayloadStatus> engine_new_payload_v1(ExecutionPayload payload) = 0;
+
+    //! Same as engine_new_payload_v1, but taking the payload still in JSON format: the backends able to decode it straight
+    //! into their own representation skip the conversion into ExecutionPayload, saving the copies of the transactions
+    virtual boost::asio::awaitable<PayloadStatus> engine_new_payload_v1_json(const nlohmann::json& payload) {
+        co_return co_await engine_new_payload_v1(payload.get<ExecutionPayload>());
+    }
+
     virtual boost::asio::awaitable<ForkChoiceUpdatedReply> engine_forkchoice_updated_v1(
         ForkChoiceUpdatedRequest forkchoice_updated_request) = 0;
 };
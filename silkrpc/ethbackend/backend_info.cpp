@@ -0,0 +1,30 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "backend_info.hpp"
+
+namespace silkrpc::ethbackend {
+
+std::shared_ptr<const BackEndInfo> BackEndInfoCache::get(std::chrono::steady_clock::time_point now) const {
+    auto info = snapshot();
+    if (!info || now - info->read_time > max_age_) {
+        return nullptr;
+    }
+    return info;
+}
+
+} // namespace silkrpc::ethbackend
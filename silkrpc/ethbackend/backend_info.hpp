@@ -0,0 +1,66 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_ETHBACKEND_BACKEND_INFO_HPP_
+#define SILKRPC_ETHBACKEND_BACKEND_INFO_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace silkrpc::ethbackend {
+
+//! The values of the remote backend served by net_version, net_peerCount and web3_clientVersion
+struct BackEndInfo {
+    uint64_t net_version{0};
+    std::string client_version;
+    uint64_t peer_count{0};
+
+    //! When the values have been read from the remote backend
+    std::chrono::steady_clock::time_point read_time;
+};
+
+//! Snapshot of the remote backend values refreshed in background (see BackEndInfoUpdater), so that the requests polled
+//! by load balancers and health checkers are served without any remote call. The network id and the client version do
+//! not change as long as the remote backend runs and the peer count changes slowly, so a snapshot a few seconds old is
+//! as good as a fresh one. The snapshot is swapped atomically, so readers on any thread never block.
+class BackEndInfoCache {
+public:
+    //! The default max age of the snapshot served, beyond which the values are read from the remote backend again
+    static constexpr std::chrono::milliseconds kDefaultMaxAge{10'000};
+
+    explicit BackEndInfoCache(std::chrono::milliseconds max_age = kDefaultMaxAge) : max_age_{max_age} {}
+
+    //! Return the current snapshot if not older than the max age, nullptr otherwise (e.g. the updater is failing)
+    std::shared_ptr<const BackEndInfo> get(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now()) const;
+
+    //! Replace the current snapshot
+    void put(std::shared_ptr<const BackEndInfo> info) { snapshot_.store(std::move(info), std::memory_order_release); }
+
+    //! Return the current snapshot, if any, whatever its age
+    std::shared_ptr<const BackEndInfo> snapshot() const { return snapshot_.load(std::memory_order_acquire); }
+
+private:
+    std::chrono::milliseconds max_age_;
+    std::atomic<std::shared_ptr<const BackEndInfo>> snapshot_;
+};
+
+} // namespace silkrpc::ethbackend
+
+#endif // SILKRPC_ETHBACKEND_BACKEND_INFO_HPP_
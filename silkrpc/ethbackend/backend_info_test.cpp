@@ -0,0 +1,56 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "backend_info.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc::ethbackend {
+
+TEST_CASE("BackEndInfoCache::get", "[silkrpc][ethbackend][backend_info]") {
+    BackEndInfoCache cache{std::chrono::milliseconds{1'000}};
+    const auto now{std::chrono::steady_clock::now()};
+    CHECK(cache.get(now) == nullptr);
+    CHECK(cache.snapshot() == nullptr);
+
+    auto info = std::make_shared<BackEndInfo>();
+    info->net_version = 1;
+    info->client_version = "erigon/2.30.0/linux-amd64/go1.19.3";
+    info->peer_count = 42;
+    info->read_time = now;
+    cache.put(info);
+
+    SECTION("fresh") {
+        CHECK(cache.get(now) == info);
+        CHECK(cache.get(now + std::chrono::milliseconds{1'000}) == info);
+    }
+
+    SECTION("too old") {
+        CHECK(cache.get(now + std::chrono::milliseconds{1'001}) == nullptr);
+        CHECK(cache.snapshot() == info);
+    }
+
+    SECTION("replaced") {
+        auto new_info = std::make_shared<BackEndInfo>(*info);
+        new_info->peer_count = 43;
+        new_info->read_time = now + std::chrono::milliseconds{2'000};
+        cache.put(new_info);
+        CHECK(cache.get(now + std::chrono::milliseconds{2'500})->peer_count == 43);
+    }
+}
+
+} // namespace silkrpc::ethbackend
@@ -0,0 +1,81 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "backend_info_updater.hpp"
+
+#include <exception>
+#include <utility>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/experimental/as_tuple.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::ethbackend {
+
+//! Define Asio coroutine-based completion token using error codes instead of exceptions for errors
+constexpr auto use_nothrow_awaitable = boost::asio::experimental::as_tuple(boost::asio::use_awaitable);
+
+BackEndInfoUpdater::BackEndInfoUpdater(Context& context, std::shared_ptr<BackEndInfoCache> cache, std::chrono::milliseconds refresh_interval)
+    : scheduler_(*context.io_context()),
+      backend_(context.backend()),
+      cache_(std::move(cache)),
+      refresh_interval_(refresh_interval),
+      refresh_timer_{scheduler_} {}
+
+void BackEndInfoUpdater::open() {
+    boost::asio::co_spawn(scheduler_, refresh_periodically(), boost::asio::detached);
+}
+
+void BackEndInfoUpdater::close() {
+    boost::asio::post(scheduler_, [&]() {
+        closed_ = true;
+        refresh_timer_.cancel();
+        SILKRPC_DEBUG << "Backend info updater closed\n";
+    });
+}
+
+boost::asio::awaitable<void> BackEndInfoUpdater::refresh_periodically() {
+    SILKRPC_TRACE << "BackEndInfoUpdater::refresh_periodically START\n";
+
+    while (!closed_) {
+        try {
+            auto info = std::make_shared<BackEndInfo>();
+            info->net_version = co_await backend_->net_version();
+            info->client_version = co_await backend_->client_version();
+            info->peer_count = co_await backend_->net_peer_count();
+            info->read_time = std::chrono::steady_clock::now();
+            cache_->put(std::move(info));
+        } catch (const std::exception& e) {
+            // The cached values age out, so that the requests read them from the backend and get its error meanwhile
+            SILKRPC_WARN << "Backend info refresh failed: " << e.what() << "\n";
+        }
+        if (closed_) {
+            break;
+        }
+
+        refresh_timer_.expires_after(refresh_interval_);
+        co_await refresh_timer_.async_wait(use_nothrow_awaitable);
+    }
+
+    SILKRPC_TRACE << "BackEndInfoUpdater::refresh_periodically END\n";
+}
+
+} // namespace silkrpc::ethbackend
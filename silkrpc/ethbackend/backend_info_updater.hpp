@@ -0,0 +1,79 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_ETHBACKEND_BACKEND_INFO_UPDATER_HPP_
+#define SILKRPC_ETHBACKEND_BACKEND_INFO_UPDATER_HPP_
+
+#include <chrono>
+#include <memory>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/ethbackend/backend.hpp>
+#include <silkrpc/ethbackend/backend_info.hpp>
+
+namespace silkrpc::ethbackend {
+
+//! Updater of the remote backend values cached for net_version, net_peerCount and web3_clientVersion, reading them
+//! periodically from the backend of the context running it
+class BackEndInfoUpdater {
+  public:
+    //! The default interval between successive refreshes
+    static constexpr std::chrono::milliseconds kDefaultRefreshInterval{2'000};
+
+    explicit BackEndInfoUpdater(Context& context, std::shared_ptr<BackEndInfoCache> cache,
+        std::chrono::milliseconds refresh_interval = kDefaultRefreshInterval);
+
+    BackEndInfoUpdater(const BackEndInfoUpdater&) = delete;
+    BackEndInfoUpdater& operator=(const BackEndInfoUpdater&) = delete;
+
+    //! Start refreshing the cached values
+    void open();
+
+    //! Stop refreshing the cached values
+    void close();
+
+  private:
+    //! The read-and-refresh asynchronous loop
+    boost::asio::awaitable<void> refresh_periodically();
+
+    //! Asio execution scheduler running the updater loop
+    boost::asio::io_context& scheduler_;
+
+    //! The remote backend reading the values
+    std::unique_ptr<BackEnd>& backend_;
+
+    //! The cache to refresh
+    std::shared_ptr<BackEndInfoCache> cache_;
+
+    //! The interval between successive refreshes
+    std::chrono::milliseconds refresh_interval_;
+
+    //! The timer waiting for the next refresh
+    boost::asio::steady_timer refresh_timer_;
+
+    bool closed_{false};
+};
+
+} // namespace silkrpc::ethbackend
+
+#endif // SILKRPC_ETHBACKEND_BACKEND_INFO_UPDATER_HPP_
@@ -16,20 +16,66 @@
 
 #include "remote_backend.hpp"
 
+#include <charconv>
 #include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
 #include <vector>
 
+#include <boost/asio/this_coro.hpp>
 #include <boost/endian/conversion.hpp>
 #include <grpcpp/grpcpp.h>
 
 #include <silkrpc/grpc/unary_rpc.hpp>
 #include <silkrpc/common/clock_time.hpp>
+#include <silkrpc/common/hex.hpp>
 #include <silkrpc/common/log.hpp>
 #include <silkrpc/common/util.hpp>
+#include <silkrpc/concurrency/hedging.hpp>
+#include <silkrpc/concurrency/request_executor.hpp>
 #include <silkrpc/config.hpp>
 
 namespace silkrpc::ethbackend {
 
+//! Return the digits of the hex string, without the 0x prefix, throwing if not a string
+static std::string_view hex_digits(const nlohmann::json& value) {
+    std::string_view digits{value.get_ref<const std::string&>()};
+    if (digits.size() >= 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')) {
+        digits.remove_prefix(2);
+    }
+    return digits;
+}
+
+//! Decode the hex quantity field, throwing if missing or invalid
+static uint64_t decode_quantity_field(const nlohmann::json& object, const char* name) {
+    const auto digits{hex_digits(object.at(name))};
+    uint64_t quantity{0};
+    const auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), quantity, 16);
+    if (digits.empty() || error != std::errc{} || end != digits.data() + digits.size()) {
+        throw std::invalid_argument{std::string{"invalid quantity "} + name + ": " + std::string{digits}};
+    }
+    return quantity;
+}
+
+//! Decode the fixed-size hex data field into the buffer, throwing if missing or invalid
+static void decode_data_field(const nlohmann::json& object, const char* name, uint8_t* out, std::size_t size) {
+    const auto digits{hex_digits(object.at(name))};
+    if (digits.size() != 2 * size || !hex::decode(digits, out)) {
+        throw std::invalid_argument{std::string{"invalid data "} + name + ": " + std::string{digits}};
+    }
+}
+
+//! Decode the variable-size hex data straight into the bytes, throwing if invalid
+static void decode_bytes(const nlohmann::json& value, const char* name, std::string& bytes) {
+    const auto digits{hex_digits(value)};
+    bytes.resize(digits.size() / 2);
+    if (digits.size() % 2 != 0 || !hex::decode(digits, reinterpret_cast<uint8_t*>(bytes.data()))) {
+        throw std::invalid_argument{std::string{"invalid data "} + name + ": " + std::string{digits.substr(0, 64)}};
+    }
+}
+
 RemoteBackEnd::RemoteBackEnd(boost::asio::io_context& context, std::shared_ptr<grpc::Channel> channel, agrpc::GrpcContext& grpc_context)
     : RemoteBackEnd(context.get_executor(), ::remote::ETHBACKEND::NewStub(channel), grpc_context) {}
 
@@ -43,9 +89,17 @@ RemoteBackEnd::~RemoteBackEnd() {
 }
 
 boost::asio::awaitable<evmc::address> RemoteBackEnd::etherbase() {
+    const auto attempt = [this](std::size_t) { return call_etherbase(); };
+    co_return co_await hedged_call<evmc::address>(etherbase_delay_, hedging_budget_, attempt, [](evmc::address) {});
+}
+
+boost::asio::awaitable<evmc::address> RemoteBackEnd::call_etherbase() {
     const auto start_time = clock_time::now();
     UnaryRpc<&::remote::ETHBACKEND::StubInterface::AsyncEtherbase> eb_rpc{*stub_, grpc_context_};
-    const auto reply = co_await eb_rpc.finish_on(executor_, ::remote::EtherbaseRequest{});
+    eb_rpc.set_deadline(cancellation_token_of(co_await boost::asio::this_coro::executor));
+    eb_rpc.disable_compression();
+    co_await eb_rpc.finish_on(executor_, ::remote::EtherbaseRequest{});
+    const auto& reply = eb_rpc.reply();
     evmc::address evmc_address;
     if (reply.has_address()) {
         const auto h160_address = reply.address();
@@ -56,36 +110,68 @@ boost::asio::awaitable<evmc::address> RemoteBackEnd::etherbase() {
 }
 
 boost::asio::awaitable<uint64_t> RemoteBackEnd::protocol_version() {
+    const auto attempt = [this](std::size_t) { return call_protocol_version(); };
+    co_return co_await hedged_call<uint64_t>(protocol_version_delay_, hedging_budget_, attempt, [](uint64_t) {});
+}
+
+boost::asio::awaitable<uint64_t> RemoteBackEnd::call_protocol_version() {
     const auto start_time = clock_time::now();
     UnaryRpc<&::remote::ETHBACKEND::StubInterface::AsyncProtocolVersion> pv_rpc{*stub_, grpc_context_};
-    const auto reply = co_await pv_rpc.finish_on(executor_, ::remote::ProtocolVersionRequest{});
+    pv_rpc.set_deadline(cancellation_token_of(co_await boost::asio::this_coro::executor));
+    pv_rpc.disable_compression();
+    co_await pv_rpc.finish_on(executor_, ::remote::ProtocolVersionRequest{});
+    const auto& reply = pv_rpc.reply();
     const auto pv = reply.id();
     SILKRPC_DEBUG << "RemoteBackEnd::protocol_version version=" << pv << " t=" << clock_time::since(start_time) << "\n";
     co_return pv;
 }
 
 boost::asio::awaitable<uint64_t> RemoteBackEnd::net_version() {
+    const auto attempt = [this](std::size_t) { return call_net_version(); };
+    co_return co_await hedged_call<uint64_t>(net_version_delay_, hedging_budget_, attempt, [](uint64_t) {});
+}
+
+boost::asio::awaitable<uint64_t> RemoteBackEnd::call_net_version() {
     const auto start_time = clock_time::now();
     UnaryRpc<&::remote::ETHBACKEND::StubInterface::AsyncNetVersion> nv_rpc{*stub_, grpc_context_};
-    const auto reply = co_await nv_rpc.finish_on(executor_, ::remote::NetVersionRequest{});
+    nv_rpc.set_deadline(cancellation_token_of(co_await boost::asio::this_coro::executor));
+    nv_rpc.disable_compression();
+    co_await nv_rpc.finish_on(executor_, ::remote::NetVersionRequest{});
+    const auto& reply = nv_rpc.reply();
     const auto nv = reply.id();
     SILKRPC_DEBUG << "RemoteBackEnd::net_version version=" << nv << " t=" << clock_time::since(start_time) << "\n";
     co_return nv;
 }
 
 boost::asio::awaitable<std::string> RemoteBackEnd::client_version() {
+    const auto attempt = [this](std::size_t) { return call_client_version(); };
+    co_return co_await hedged_call<std::string>(client_version_delay_, hedging_budget_, attempt, [](std::string) {});
+}
+
+boost::asio::awaitable<std::string> RemoteBackEnd::call_client_version() {
     const auto start_time = clock_time::now();
     UnaryRpc<&::remote::ETHBACKEND::StubInterface::AsyncClientVersion> cv_rpc{*stub_, grpc_context_};
-    const auto reply = co_await cv_rpc.finish_on(executor_, ::remote::ClientVersionRequest{});
+    cv_rpc.set_deadline(cancellation_token_of(co_await boost::asio::this_coro::executor));
+    cv_rpc.disable_compression();
+    co_await cv_rpc.finish_on(executor_, ::remote::ClientVersionRequest{});
+    const auto& reply = cv_rpc.reply();
     const auto cv = reply.nodename();
     SILKRPC_DEBUG << "RemoteBackEnd::client_version version=" << cv << " t=" << clock_time::since(start_time) << "\n";
     co_return cv;
 }
 
 boost::asio::awaitable<uint64_t> RemoteBackEnd::net_peer_count() {
+    const auto attempt = [this](std::size_t) { return call_net_peer_count(); };
+    co_return co_await hedged_call<uint64_t>(net_peer_count_delay_, hedging_budget_, attempt, [](uint64_t) {});
+}
+
+boost::asio::awaitable<uint64_t> RemoteBackEnd::call_net_peer_count() {
     const auto start_time = clock_time::now();
     UnaryRpc<&::remote::ETHBACKEND::StubInterface::AsyncNetPeerCount> npc_rpc{*stub_, grpc_context_};
-    const auto reply = co_await npc_rpc.finish_on(executor_, ::remote::NetPeerCountRequest{});
+    npc_rpc.set_deadline(cancellation_token_of(co_await boost::asio::this_coro::executor));
+    npc_rpc.disable_compression();
+    co_await npc_rpc.finish_on(executor_, ::remote::NetPeerCountRequest{});
+    const auto& reply = npc_rpc.reply();
     const auto count = reply.count();
     SILKRPC_DEBUG << "RemoteBackEnd::net_peer_count count=" << count << " t=" << clock_time::since(start_time) << "\n";
     co_return count;
@@ -94,19 +180,32 @@ boost::asio::awaitable<uint64_t> RemoteBackEnd::net_peer_count() {
 boost::asio::awaitable<ExecutionPayload> RemoteBackEnd::engine_get_payload_v1(uint64_t payload_id) {
     const auto start_time = clock_time::now();
     UnaryRpc<&::remote::ETHBACKEND::StubInterface::AsyncEngineGetPayloadV1> npc_rpc{*stub_, grpc_context_};
+    npc_rpc.set_deadline(cancellation_token_of(co_await boost::asio::this_coro::executor));
     ::remote::EngineGetPayloadRequest req;
     req.set_payloadid(payload_id);
-    const auto reply = co_await npc_rpc.finish_on(executor_, req);
+    co_await npc_rpc.finish_on(executor_, req);
+    const auto& reply = npc_rpc.reply();
     auto execution_payload{decode_execution_payload(reply)};
     SILKRPC_DEBUG << "RemoteBackEnd::engine_get_payload_v1 data=" << execution_payload << " t=" << clock_time::since(start_time) << "\n";
     co_return execution_payload;
 }
 
 boost::asio::awaitable<PayloadStatus> RemoteBackEnd::engine_new_payload_v1(ExecutionPayload payload) {
+    const auto req{encode_execution_payload(payload)};
+    co_return co_await call_engine_new_payload_v1(req);
+}
+
+boost::asio::awaitable<PayloadStatus> RemoteBackEnd::engine_new_payload_v1_json(const nlohmann::json& payload) {
+    const auto req{encode_execution_payload(payload)};
+    co_return co_await call_engine_new_payload_v1(req);
+}
+
+boost::asio::awaitable<PayloadStatus> RemoteBackEnd::call_engine_new_payload_v1(const types::ExecutionPayload& request) {
     const auto start_time = clock_time::now();
     UnaryRpc<&::remote::ETHBACKEND::StubInterface::AsyncEngineNewPayloadV1> npc_rpc{*stub_, grpc_context_};
-    auto req{encode_execution_payload(payload)};
-    const auto reply = co_await npc_rpc.finish_on(executor_, req);
+    npc_rpc.set_deadline(cancellation_token_of(co_await boost::asio::this_coro::executor));
+    co_await npc_rpc.finish_on(executor_, request);
+    const auto& reply = npc_rpc.reply();
     PayloadStatus payload_status = decode_payload_status(reply);
     SILKRPC_DEBUG << "RemoteBackEnd::engine_new_payload_v1 data=" << payload_status << " t=" << clock_time::since(start_time) << "\n";
     co_return payload_status;
@@ -116,8 +215,11 @@ boost::asio::awaitable<ForkChoiceUpdatedReply> RemoteBackEnd::engine_forkchoice_
     ForkChoiceUpdatedRequest forkchoice_updated_request) {
     const auto start_time = clock_time::now();
     UnaryRpc<&::remote::ETHBACKEND::StubInterface::AsyncEngineForkChoiceUpdatedV1> fcu_rpc{*stub_, grpc_context_};
+    fcu_rpc.set_deadline(cancellation_token_of(co_await boost::asio::this_coro::executor));
+    fcu_rpc.disable_compression();
     const auto req{encode_forkchoice_updated_request(forkchoice_updated_request)};
-    const auto reply = co_await fcu_rpc.finish_on(executor_, req);
+    co_await fcu_rpc.finish_on(executor_, req);
+    const auto& reply = fcu_rpc.reply();
     PayloadStatus payload_status = decode_payload_status(reply.payloadstatus());
     ForkChoiceUpdatedReply forkchoice_updated_reply{
         .payload_status = payload_status,
@@ -329,6 +431,44 @@ types::ExecutionPayload RemoteBackEnd::encode_execution_payload(const ExecutionP
     return execution_payload_grpc;
 }
 
+types::ExecutionPayload RemoteBackEnd::encode_execution_payload(const nlohmann::json& execution_payload) {
+    types::ExecutionPayload execution_payload_grpc;
+    // Numerical parameters
+    execution_payload_grpc.set_blocknumber(decode_quantity_field(execution_payload, "blockNumber"));
+    execution_payload_grpc.set_timestamp(decode_quantity_field(execution_payload, "timestamp"));
+    execution_payload_grpc.set_gaslimit(decode_quantity_field(execution_payload, "gasLimit"));
+    execution_payload_grpc.set_gasused(decode_quantity_field(execution_payload, "gasUsed"));
+    // coinbase
+    evmc::address coinbase;
+    decode_data_field(execution_payload, "feeRecipient", coinbase.bytes, sizeof(coinbase.bytes));
+    execution_payload_grpc.set_allocated_coinbase(H160_from_address(coinbase));
+    // 32-bytes parameters
+    uint8_t hash[32];
+    decode_data_field(execution_payload, "receiptsRoot", hash, sizeof(hash));
+    execution_payload_grpc.set_allocated_receiptroot(H256_from_bytes(hash));
+    decode_data_field(execution_payload, "stateRoot", hash, sizeof(hash));
+    execution_payload_grpc.set_allocated_stateroot(H256_from_bytes(hash));
+    decode_data_field(execution_payload, "parentHash", hash, sizeof(hash));
+    execution_payload_grpc.set_allocated_parenthash(H256_from_bytes(hash));
+    decode_data_field(execution_payload, "blockHash", hash, sizeof(hash));
+    execution_payload_grpc.set_allocated_blockhash(H256_from_bytes(hash));
+    decode_data_field(execution_payload, "prevRandao", hash, sizeof(hash));
+    execution_payload_grpc.set_allocated_prevrandao(H256_from_bytes(hash));
+    execution_payload_grpc.set_allocated_basefeepergas(H256_from_uint256(execution_payload.at("baseFeePerGas").get<intx::uint256>()));
+    // Logs Bloom
+    silkworm::Bloom logs_bloom;
+    decode_data_field(execution_payload, "logsBloom", logs_bloom.data(), logs_bloom.size());
+    execution_payload_grpc.set_allocated_logsbloom(H2048_from_bytes(logs_bloom.data()));
+    // String-like parameters, decoded in place into the protobuf fields
+    const auto& transactions = execution_payload.at("transactions");
+    execution_payload_grpc.mutable_transactions()->Reserve(static_cast<int>(transactions.size()));
+    for (const auto& transaction : transactions) {
+        decode_bytes(transaction, "transactions", *execution_payload_grpc.add_transactions());
+    }
+    decode_bytes(execution_payload.at("extraData"), "extraData", *execution_payload_grpc.mutable_extradata());
+    return execution_payload_grpc;
+}
+
 remote::EngineForkChoiceState* RemoteBackEnd::encode_forkchoice_state(const ForkChoiceState& forkchoice_state) {
     remote::EngineForkChoiceState *forkchoice_state_grpc = new remote::EngineForkChoiceState();
     // 32-bytes parameters
@@ -21,11 +21,15 @@
 #include <string>
 #include <memory>
 
+#include <silkrpc/config.hpp>
+
 #include <agrpc/grpc_context.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/use_awaitable.hpp>
 #include <evmc/evmc.hpp>
+#include <nlohmann/json.hpp>
 
+#include <silkrpc/concurrency/hedging.hpp>
 #include <silkrpc/interfaces/remote/ethbackend.grpc.pb.h>
 #include <silkrpc/interfaces/types/types.pb.h>
 #include <silkrpc/types/execution_payload.hpp>
@@ -33,6 +37,7 @@
 
 namespace silkrpc::ethbackend {
 
+//! The idempotent reads slower than the usual ones for the same method are hedged, i.e. duplicated within a small budget
 class RemoteBackEnd final: public BackEnd {
 public:
     explicit RemoteBackEnd(boost::asio::io_context& context, std::shared_ptr<grpc::Channel> channel, agrpc::GrpcContext& grpc_context);
@@ -49,10 +54,24 @@ public:
     boost::asio::awaitable<uint64_t> net_peer_count();
     boost::asio::awaitable<ExecutionPayload> engine_get_payload_v1(uint64_t payload_id);
     boost::asio::awaitable<PayloadStatus> engine_new_payload_v1(ExecutionPayload payload);
+    boost::asio::awaitable<PayloadStatus> engine_new_payload_v1_json(const nlohmann::json& payload) override;
     boost::asio::awaitable<ForkChoiceUpdatedReply> engine_forkchoice_updated_v1(
         ForkChoiceUpdatedRequest forkchoice_updated_request);
 
+    //! The budget of the hedged calls, counting them
+    const HedgingBudget& hedging_budget() const noexcept { return hedging_budget_; }
+
 private:
+    //! Make one call of the hedged methods
+    boost::asio::awaitable<evmc::address> call_etherbase();
+    boost::asio::awaitable<uint64_t> call_protocol_version();
+    boost::asio::awaitable<uint64_t> call_net_version();
+    boost::asio::awaitable<std::string> call_client_version();
+    boost::asio::awaitable<uint64_t> call_net_peer_count();
+
+    //! Make the new payload call with the payload already encoded
+    boost::asio::awaitable<PayloadStatus> call_engine_new_payload_v1(const types::ExecutionPayload& request);
+
     evmc::address address_from_H160(const types::H160& h160);
     silkworm::Bytes bytes_from_H128(const types::H128& h128);
     types::H128* H128_from_bytes(const uint8_t* bytes);
@@ -71,6 +90,7 @@ private:
 
     ExecutionPayload decode_execution_payload(const types::ExecutionPayload& execution_payload_grpc);
     types::ExecutionPayload encode_execution_payload(const ExecutionPayload& execution_payload);
+    types::ExecutionPayload encode_execution_payload(const nlohmann::json& execution_payload);
     remote::EngineForkChoiceState* encode_forkchoice_state(const ForkChoiceState& forkchoice_state);
     remote::EnginePayloadAttributes* encode_payload_attributes(const PayloadAttributes& payload_attributes);
     remote::EngineForkChoiceUpdatedRequest encode_forkchoice_updated_request(const ForkChoiceUpdatedRequest& forkchoice_updated_request);
@@ -80,6 +100,14 @@ private:
     boost::asio::io_context::executor_type executor_;
     std::unique_ptr<::remote::ETHBACKEND::StubInterface> stub_;
     agrpc::GrpcContext& grpc_context_;
+
+    //! The delays after which the calls of each hedged method are duplicated and the budget bounding such hedging
+    HedgingDelay etherbase_delay_;
+    HedgingDelay protocol_version_delay_;
+    HedgingDelay net_version_delay_;
+    HedgingDelay client_version_delay_;
+    HedgingDelay net_peer_count_delay_;
+    HedgingBudget hedging_budget_;
 };
 
 } // namespace silkrpc::ethbackend
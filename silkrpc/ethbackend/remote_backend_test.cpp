@@ -16,6 +16,7 @@
 
 #include "remote_backend.hpp"
 
+#include <stdexcept>
 #include <string>
 #include <system_error>
 #include <thread>
@@ -308,6 +309,61 @@ TEST_CASE_METHOD(EthBackendTest, "BackEnd::engine_new_payload_v1", "[silkrpc][et
     }
 }
 
+TEST_CASE_METHOD(EthBackendTest, "BackEnd::engine_new_payload_v1_json", "[silkrpc][ethbackend][backend]") {
+    const auto payload = R"({
+        "parentHash":"0x3b8fb240d288781d4aac94d3fd16809ee413bc99294a085798a589dae51ddd4a",
+        "feeRecipient":"0xa94f5374fce5edbc8e2a8697c15331677e6ebf0b",
+        "stateRoot":"0xca3149fa9e37db08d1cd49c9061db1002ef1cd58db2210f2115c8c989b2bdf45",
+        "receiptsRoot":"0x56e81f171bcc55a6ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421",
+        "logsBloom":"0x12000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000",
+        "prevRandao":"0x0000000000000000000000000000000000000000000000000000000000000001",
+        "blockNumber":"0x1",
+        "gasLimit":"0x1c9c380",
+        "gasUsed":"0x9",
+        "timestamp":"0x5",
+        "extraData":"0xabcd",
+        "baseFeePerGas":"0x7",
+        "blockHash":"0x3559e851470f6e7bbed1db474980683e8c315bfce99b2a6ef47c057c04de7858",
+        "transactions":["0xf92ebdeab45d368f6354e8c5a8ac586c", "0x02"]
+    })"_json;
+
+    SECTION("call engine_new_payload_v1_json and decode payload into request") {
+        test::StrictMockAsyncResponseReader<::remote::EnginePayloadStatus> reader;
+        ::types::ExecutionPayload request;
+        EXPECT_CALL(*stub_, AsyncEngineNewPayloadV1Raw).WillOnce(testing::DoAll(testing::SaveArg<1>(&request), testing::Return(&reader)));
+        ::remote::EnginePayloadStatus response;
+        response.set_status(::remote::EngineStatus::SYNCING);
+        EXPECT_CALL(reader, Finish).WillOnce(test::finish_with(grpc_context_, std::move(response)));
+        const auto payload_status = run<&ethbackend::RemoteBackEnd::engine_new_payload_v1_json>(payload);
+        CHECK(payload_status.status == "SYNCING");
+        CHECK(request.blocknumber() == 1);
+        CHECK(request.timestamp() == 5);
+        CHECK(request.gaslimit() == 0x1c9c380);
+        CHECK(request.gasused() == 9);
+        CHECK(request.coinbase().lo() == 0x7e6ebf0b);
+        CHECK(request.parenthash().hi().hi() == 0x3b8fb240d288781d);
+        CHECK(request.blockhash().lo().lo() == 0xf47c057c04de7858);
+        CHECK(request.basefeepergas().lo().lo() == 7);
+        CHECK(request.logsbloom().hi().hi().hi().hi().hi() == 0x1200000000000000);
+        CHECK(request.extradata() == std::string{"\xab\xcd"});
+        REQUIRE(request.transactions_size() == 2);
+        CHECK(request.transactions(0) == std::string{"\xf9\x2e\xbd\xea\xb4\x5d\x36\x8f\x63\x54\xe8\xc5\xa8\xac\x58\x6c"});
+        CHECK(request.transactions(1) == std::string{"\x02"});
+    }
+
+    SECTION("call engine_new_payload_v1_json with invalid transaction") {
+        auto invalid_payload = payload;
+        invalid_payload["transactions"][1] = "0x0g";
+        CHECK_THROWS_AS((run<&ethbackend::RemoteBackEnd::engine_new_payload_v1_json>(invalid_payload)), std::invalid_argument);
+    }
+
+    SECTION("call engine_new_payload_v1_json with missing field") {
+        auto invalid_payload = payload;
+        invalid_payload.erase("stateRoot");
+        CHECK_THROWS_AS((run<&ethbackend::RemoteBackEnd::engine_new_payload_v1_json>(invalid_payload)), nlohmann::json::out_of_range);
+    }
+}
+
 TEST_CASE_METHOD(EthBackendTest, "BackEnd::engine_forkchoice_updated_v1", "[silkrpc][ethbackend][backend]") {
     test::StrictMockAsyncResponseReader<::remote::EngineForkChoiceUpdatedReply> reader;
     EXPECT_CALL(*stub_, AsyncEngineForkChoiceUpdatedV1Raw).WillOnce(testing::Return(&reader));
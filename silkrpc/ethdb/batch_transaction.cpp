@@ -0,0 +1,100 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "batch_transaction.hpp"
+
+#include <map>
+#include <string>
+#include <utility>
+
+#include <boost/asio/this_coro.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/concurrency/request_executor.hpp>
+
+namespace silkrpc::ethdb {
+
+//! The lease of the shared transaction given to one request, keeping the cursors opened by such request
+class BatchTransaction::Lease : public Transaction {
+public:
+    explicit Lease(Transaction& txn) : txn_(txn) {
+        set_chain_head_cache(txn.chain_head_cache());
+        set_snapshots(txn.snapshots());
+        set_read_combiner(txn.read_combiner());
+    }
+
+    uint64_t tx_id() const override { return txn_.tx_id(); }
+
+    //! The shared transaction is already open
+    boost::asio::awaitable<void> open() override { co_return; }
+
+    boost::asio::awaitable<std::shared_ptr<Cursor>> cursor(const std::string& table) override {
+        auto& cursor = cursors_[table];
+        if (!cursor) {
+            cursor = co_await txn_.new_cursor(table);
+        }
+        co_return cursor;
+    }
+
+    boost::asio::awaitable<std::shared_ptr<CursorDupSort>> cursor_dup_sort(const std::string& table) override {
+        auto& cursor = dup_cursors_[table];
+        if (!cursor) {
+            cursor = co_await txn_.new_cursor_dup_sort(table);
+        }
+        co_return cursor;
+    }
+
+    //! The shared transaction is left open, just the cursors of the request are dropped
+    boost::asio::awaitable<void> close() override {
+        cursors_.clear();
+        dup_cursors_.clear();
+        co_return;
+    }
+
+private:
+    Transaction& txn_;
+    std::map<std::string, std::shared_ptr<Cursor>> cursors_;
+    std::map<std::string, std::shared_ptr<CursorDupSort>> dup_cursors_;
+};
+
+boost::asio::awaitable<void> BatchTransaction::open() {
+    txn_ = co_await database_.begin();
+    SILKRPC_DEBUG << "BatchTransaction::open tx_id: " << txn_->tx_id() << "\n";
+}
+
+std::unique_ptr<Transaction> BatchTransaction::lease() {
+    ++lease_count_;
+    return std::make_unique<Lease>(*txn_);
+}
+
+boost::asio::awaitable<void> BatchTransaction::close() {
+    if (!txn_) {
+        co_return;
+    }
+    SILKRPC_DEBUG << "BatchTransaction::close tx_id: " << txn_->tx_id() << " leases: " << lease_count_ << "\n";
+    auto txn = std::move(txn_);
+    co_await txn->close();
+}
+
+boost::asio::awaitable<std::unique_ptr<Transaction>> lease_batch_transaction(const Database& database) {
+    auto* batch_transaction = batch_transaction_of(co_await boost::asio::this_coro::executor);
+    if (batch_transaction == nullptr || !batch_transaction->is_open() || &batch_transaction->database() != &database) {
+        co_return nullptr;
+    }
+    co_return batch_transaction->lease();
+}
+
+} // namespace silkrpc::ethdb
@@ -0,0 +1,78 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_ETHDB_BATCH_TRANSACTION_HPP_
+#define SILKRPC_ETHDB_BATCH_TRANSACTION_HPP_
+
+#include <cstddef>
+#include <memory>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+
+#include <silkrpc/ethdb/database.hpp>
+#include <silkrpc/ethdb/transaction.hpp>
+
+namespace silkrpc::ethdb {
+
+//! The min number of requests in a batch worth sharing one transaction
+constexpr std::size_t kMinBatchTransactionSize{2};
+
+//! Transaction shared by all the requests of one JSON RPC batch, so that they read one coherent database view and skip
+//! opening and closing their own transactions: the database begins a lease of it instead of a new transaction when called
+//! by any request of the batch (see lease_batch_transaction). Each lease opens its own cursors on the shared transaction,
+//! because the requests run concurrently and a cursor shared by two of them would lose its position. Closing a lease
+//! keeps the shared transaction open, which is closed by the batch owner once all the requests are done.
+//! As any transaction, it must be used on just one executor, hence it needs no locking
+class BatchTransaction {
+public:
+    explicit BatchTransaction(Database& database) : database_(database) {}
+
+    BatchTransaction(const BatchTransaction&) = delete;
+    BatchTransaction& operator=(const BatchTransaction&) = delete;
+
+    //! Begin the shared transaction on the database
+    boost::asio::awaitable<void> open();
+
+    //! Return a new lease of the shared transaction, which must be open
+    std::unique_ptr<Transaction> lease();
+
+    //! Close the shared transaction, if open: all its leases must have been closed
+    boost::asio::awaitable<void> close();
+
+    const Database& database() const noexcept { return database_; }
+
+    bool is_open() const noexcept { return txn_ != nullptr; }
+
+    //! The number of leases given so far
+    std::size_t lease_count() const noexcept { return lease_count_; }
+
+private:
+    class Lease;
+
+    Database& database_;
+    std::unique_ptr<Transaction> txn_;
+    std::size_t lease_count_{0};
+};
+
+//! Return a lease of the batch transaction carried by the executor of the calling coroutine if open on the database,
+//! otherwise nullptr: the databases call it first in begin, so that the requests of one batch share its transaction
+boost::asio::awaitable<std::unique_ptr<Transaction>> lease_batch_transaction(const Database& database);
+
+} // namespace silkrpc::ethdb
+
+#endif  // SILKRPC_ETHDB_BATCH_TRANSACTION_HPP_
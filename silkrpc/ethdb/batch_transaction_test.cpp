@@ -0,0 +1,184 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "batch_transaction.hpp"
+
+#include <memory>
+#include <string>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/use_future.hpp>
+#include <catch2/catch.hpp>
+
+#include <silkrpc/concurrency/request_executor.hpp>
+#include <silkrpc/test/mock_cursor.hpp>
+
+namespace silkrpc::ethdb {
+
+//! Transaction counting its closures and the cursors opened on it
+class CountingTransaction : public Transaction {
+public:
+    explicit CountingTransaction(uint64_t tx_id, int& num_closed) : tx_id_{tx_id}, num_closed_{num_closed} {}
+
+    uint64_t tx_id() const override { return tx_id_; }
+
+    boost::asio::awaitable<void> open() override { co_return; }
+
+    boost::asio::awaitable<std::shared_ptr<Cursor>> cursor(const std::string& table) override {
+        co_return co_await cursor_dup_sort(table);
+    }
+
+    boost::asio::awaitable<std::shared_ptr<CursorDupSort>> cursor_dup_sort(const std::string& /*table*/) override {
+        if (!shared_cursor_) {
+            shared_cursor_ = std::make_shared<test::MockCursor>();
+        }
+        co_return shared_cursor_;
+    }
+
+    boost::asio::awaitable<std::shared_ptr<Cursor>> new_cursor(const std::string& /*table*/) override {
+        ++num_new_cursors;
+        co_return std::make_shared<test::MockCursor>();
+    }
+
+    boost::asio::awaitable<std::shared_ptr<CursorDupSort>> new_cursor_dup_sort(const std::string& /*table*/) override {
+        ++num_new_cursors;
+        co_return std::make_shared<test::MockCursor>();
+    }
+
+    boost::asio::awaitable<void> close() override {
+        ++num_closed_;
+        co_return;
+    }
+
+    int num_new_cursors{0};
+
+private:
+    uint64_t tx_id_;
+    int& num_closed_;
+    std::shared_ptr<CursorDupSort> shared_cursor_;
+};
+
+//! Database counting the transactions begun and closed
+class CountingDatabase : public Database {
+public:
+    boost::asio::awaitable<std::unique_ptr<Transaction>> begin() override {
+        if (auto batch_txn = co_await lease_batch_transaction(*this)) {
+            co_return batch_txn;
+        }
+        ++num_begun;
+        auto txn = std::make_unique<CountingTransaction>(num_begun, num_closed);
+        last_txn = txn.get();
+        co_return txn;
+    }
+
+    int num_begun{0};
+    int num_closed{0};
+    CountingTransaction* last_txn{nullptr};
+};
+
+template<typename T>
+static T run(boost::asio::io_context& io_context, const RequestExecutor& executor, boost::asio::awaitable<T> awaitable) {
+    auto result = boost::asio::co_spawn(executor, std::move(awaitable), boost::asio::use_future);
+    io_context.run();
+    io_context.restart();
+    return result.get();
+}
+
+TEST_CASE("BatchTransaction", "[silkrpc][ethdb][batch_transaction]") {
+    boost::asio::io_context io_context;
+    CountingDatabase database;
+    BatchTransaction batch_transaction{database};
+    CHECK_FALSE(batch_transaction.is_open());
+
+    const RequestExecutor plain_executor{io_context.get_executor(), CancellationToken{}};
+    run(io_context, plain_executor, batch_transaction.open());
+    CHECK(batch_transaction.is_open());
+    CHECK(database.num_begun == 1);
+
+    const RequestExecutor batch_executor{io_context.get_executor(), CancellationToken{}, nullptr, {}, &batch_transaction};
+
+    SECTION("the requests of the batch lease the shared transaction") {
+        auto txn1 = run(io_context, batch_executor, database.begin());
+        auto txn2 = run(io_context, batch_executor, database.begin());
+        CHECK(database.num_begun == 1);
+        CHECK(batch_transaction.lease_count() == 2);
+        CHECK(txn1->tx_id() == 1);
+        CHECK(txn2->tx_id() == 1);
+
+        run(io_context, batch_executor, txn1->close());
+        run(io_context, batch_executor, txn2->close());
+        CHECK(database.num_closed == 0);
+
+        run(io_context, plain_executor, batch_transaction.close());
+        CHECK(database.num_closed == 1);
+        CHECK_FALSE(batch_transaction.is_open());
+        run(io_context, plain_executor, batch_transaction.close());
+        CHECK(database.num_closed == 1);
+    }
+
+    SECTION("each lease opens its own cursors") {
+        auto txn1 = run(io_context, batch_executor, database.begin());
+        auto txn2 = run(io_context, batch_executor, database.begin());
+        const auto cursor1 = run(io_context, batch_executor, txn1->cursor("Header"));
+        const auto cursor2 = run(io_context, batch_executor, txn2->cursor("Header"));
+        CHECK(cursor1 != cursor2);
+        CHECK(run(io_context, batch_executor, txn1->cursor("Header")) == cursor1);
+        const auto dup_cursor1 = run(io_context, batch_executor, txn1->cursor_dup_sort("PlainState"));
+        CHECK(run(io_context, batch_executor, txn1->cursor_dup_sort("PlainState")) == dup_cursor1);
+        CHECK(database.last_txn->num_new_cursors == 3);
+        run(io_context, plain_executor, batch_transaction.close());
+    }
+
+    SECTION("the other requests begin their own transaction") {
+        auto txn = run(io_context, plain_executor, database.begin());
+        CHECK(database.num_begun == 2);
+        CHECK(txn->tx_id() == 2);
+        CHECK(batch_transaction.lease_count() == 0);
+        run(io_context, plain_executor, batch_transaction.close());
+    }
+
+    SECTION("the other databases begin their own transaction") {
+        CountingDatabase other_database;
+        auto txn = run(io_context, batch_executor, other_database.begin());
+        CHECK(other_database.num_begun == 1);
+        CHECK(batch_transaction.lease_count() == 0);
+        run(io_context, plain_executor, batch_transaction.close());
+    }
+}
+
+TEST_CASE("Transaction::new_cursor defaults to the shared cursor", "[silkrpc][ethdb][batch_transaction]") {
+    boost::asio::io_context io_context;
+    const RequestExecutor executor{io_context.get_executor(), CancellationToken{}};
+    int num_closed{0};
+
+    class SharedCursorTransaction : public CountingTransaction {
+    public:
+        using CountingTransaction::CountingTransaction;
+        boost::asio::awaitable<std::shared_ptr<Cursor>> new_cursor(const std::string& table) override {
+            co_return co_await Transaction::new_cursor(table);
+        }
+        boost::asio::awaitable<std::shared_ptr<CursorDupSort>> new_cursor_dup_sort(const std::string& table) override {
+            co_return co_await Transaction::new_cursor_dup_sort(table);
+        }
+    };
+    SharedCursorTransaction txn{1, num_closed};
+    const auto cursor = run(io_context, executor, txn.new_cursor("Header"));
+    CHECK(run(io_context, executor, txn.new_cursor_dup_sort("Header")) == cursor);
+    CHECK(run(io_context, executor, txn.cursor("Header")) == cursor);
+}
+
+} // namespace silkrpc::ethdb
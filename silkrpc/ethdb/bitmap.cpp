@@ -16,6 +16,7 @@
 
 #include "bitmap.hpp"
 
+#include <algorithm>
 #include <climits>
 #include <memory>
 #include <utility>
@@ -30,17 +31,18 @@ namespace silkrpc::ethdb::bitmap {
 
 using roaring_bitmap_t = roaring::api::roaring_bitmap_t;
 using Roaring = roaring::Roaring;
+using Chunks = std::vector<std::shared_ptr<const Roaring>>;
 
-static Roaring fast_or(size_t n, const std::vector<std::unique_ptr<Roaring>>& inputs) {
-    const roaring_bitmap_t **x = (const roaring_bitmap_t **)malloc(n * sizeof(roaring_bitmap_t *));
+static Roaring fast_or(const Chunks& inputs) {
+    const roaring_bitmap_t **x = (const roaring_bitmap_t **)malloc(inputs.size() * sizeof(roaring_bitmap_t *));
     if (x == NULL) {
         throw std::runtime_error("failed memory alloc in fast_or");
     }
-    for (size_t k = 0; k < n; ++k) {
+    for (size_t k = 0; k < inputs.size(); ++k) {
         x[k] = &inputs[k]->roaring;
     }
 
-    roaring_bitmap_t *c_ans = roaring_bitmap_or_many(n, x);
+    roaring_bitmap_t *c_ans = roaring_bitmap_or_many(inputs.size(), x);
     if (c_ans == NULL) {
         free(x);
         throw std::runtime_error("failed memory alloc in fast_or");
@@ -50,28 +52,114 @@ static Roaring fast_or(size_t n, const std::vector<std::unique_ptr<Roaring>>& in
     return ans;
 }
 
-boost::asio::awaitable<Roaring> get(core::rawdb::DatabaseReader& db_reader, const std::string& table, silkworm::Bytes& key, uint32_t from_block, uint32_t to_block) {
-    std::vector<std::unique_ptr<Roaring>> chuncks;
+static silkworm::Bytes make_chunk_key(const silkworm::Bytes& key, uint32_t block) {
+    silkworm::Bytes chunk_key{key.begin(), key.end()};
+    chunk_key.resize(key.size() + sizeof(uint32_t));
+    boost::endian::store_big_u32(&chunk_key[key.size()], block);
+    return chunk_key;
+}
+
+//! Append the chunks of the key overlapping the block range, taking the sealed ones from the cache whenever possible
+static boost::asio::awaitable<void> load_chunks(const core::rawdb::DatabaseReader& db_reader, const std::string& table, const silkworm::Bytes& key,
+    uint32_t from_block, uint32_t to_block, BitmapCache* cache, Chunks& chunks) {
+    BitmapChunks sealed_chunks{{}, from_block, cache ? cache->generation() : 0};
+
+    // Take the cached sealed chunks overlapping the range, if they start early enough
+    const auto cached_chunks = cache ? cache->find(table, key) : nullptr;
+    if (cached_chunks && cached_chunks->from_block <= from_block) {
+        const auto num_chunks = chunks.size();
+        for (const auto& [last_block, chunck] : cached_chunks->chunks) {
+            if (last_block < from_block) {
+                continue;
+            }
+            chunks.push_back(chunck);
+            if (last_block >= to_block) {
+                SILKRPC_DEBUG << "table: " << table << " key: " << key << " all " << chunks.size() - num_chunks << " chunks cached\n";
+                co_return;
+            }
+        }
+        sealed_chunks.chunks = cached_chunks->chunks;
+        sealed_chunks.from_block = cached_chunks->from_block;
+        if (!sealed_chunks.chunks.empty()) {
+            from_block = std::max(from_block, sealed_chunks.chunks.back().first + 1);
+        }
+    }
+    const auto num_cached_chunks = sealed_chunks.chunks.size();
 
-    silkworm::Bytes from_key{key.begin(), key.end()};
-    from_key.resize(key.size() + sizeof(uint32_t));
-    boost::endian::store_big_u32(&from_key[key.size()], from_block);
-    SILKRPC_DEBUG << "table: " << table << " key: " << key << " from_key: " << from_key << "\n";
+    // Read the remaining chunks, keeping the sealed ones for next time
+    const auto from_key{make_chunk_key(key, from_block)};
+    SILKRPC_DEBUG << "table: " << table << " key: " << key << " from_key: " << from_key << " #cached: " << num_cached_chunks << "\n";
 
-    Roaring chunck{};
     core::rawdb::Walker walker = [&](const silkworm::Bytes& k, const silkworm::Bytes& v) {
         SILKRPC_TRACE << "k: " << k << " v: " << v << "\n";
-        auto chunck = std::make_unique<Roaring>(Roaring::readSafe(reinterpret_cast<const char*>(v.data()), v.size()));
+        auto chunck = std::make_shared<const Roaring>(Roaring::readSafe(reinterpret_cast<const char*>(v.data()), v.size()));
         SILKRPC_TRACE << "chunck: " << chunck->toString() << "\n";
-        chuncks.push_back(std::move(chunck));
         auto block = boost::endian::load_big_u32(&k[k.size() - sizeof(uint32_t)]);
+        if (cache && block != BitmapCache::kLastChunkSuffix) {
+            sealed_chunks.chunks.emplace_back(block, chunck);
+        }
+        chunks.push_back(std::move(chunck));
         return block < to_block;
     };
     co_await db_reader.walk(table, from_key, key.size() * CHAR_BIT, walker);
 
-    auto result{fast_or(chuncks.size(), chuncks)};
+    // Replace the cached chunks unless they reach further
+    const auto reached_block = [](const BitmapChunks& c) { return c.chunks.empty() ? 0 : uint64_t{c.chunks.back().first} + 1; };
+    if (cache && sealed_chunks.chunks.size() > num_cached_chunks && (!cached_chunks || reached_block(sealed_chunks) >= reached_block(*cached_chunks))) {
+        cache->store(table, key, std::move(sealed_chunks));
+    }
+}
+
+boost::asio::awaitable<Roaring> get(const core::rawdb::DatabaseReader& db_reader, const std::string& table, silkworm::Bytes& key, uint32_t from_block, uint32_t to_block) {
+    Chunks chuncks;
+    co_await load_chunks(db_reader, table, key, from_block, to_block, nullptr, chuncks);
+    auto result{fast_or(chuncks)};
+    SILKRPC_DEBUG << "result: " << result.toString() << "\n";
+    co_return result;
+}
+
+boost::asio::awaitable<Roaring> get(const core::rawdb::DatabaseReader& db_reader, const std::string& table, silkworm::Bytes& key, uint32_t from_block, uint32_t to_block,
+    BitmapCache& cache) {
+    Chunks chuncks;
+    co_await load_chunks(db_reader, table, key, from_block, to_block, &cache, chuncks);
+    auto result{fast_or(chuncks)};
     SILKRPC_DEBUG << "result: " << result.toString() << "\n";
     co_return result;
 }
 
+boost::asio::awaitable<std::optional<Roaring>> query(const core::rawdb::DatabaseReader& db_reader, const std::vector<QueryTerm>& terms, uint32_t from_block, uint32_t to_block,
+    BitmapCache* cache) {
+    std::optional<Roaring> result;
+    for (const auto& term : terms) {
+        if (term.keys.empty()) {
+            continue;
+        }
+
+        // The chunks of all the keys are merged at once, instead of merging each key bitmap into the term bitmap
+        Chunks chuncks;
+        for (const auto& key : term.keys) {
+            co_await load_chunks(db_reader, term.table, key, from_block, to_block, cache, chuncks);
+        }
+        auto term_bitmap{fast_or(chuncks)};
+        SILKRPC_DEBUG << "table: " << term.table << " #keys: " << term.keys.size() << " #chunks: " << chuncks.size()
+            << " cardinality: " << term_bitmap.cardinality() << "\n";
+        chuncks.clear();
+
+        if (result) {
+            *result &= term_bitmap;
+        } else {
+            result = std::move(term_bitmap);
+        }
+        if (result->isEmpty()) {
+            SILKRPC_DEBUG << "empty result, query stopped\n";
+            break;
+        }
+
+        // Next terms can skip the chunks outside the blocks still matching
+        from_block = std::max(from_block, result->minimum());
+        to_block = std::min(to_block, result->maximum());
+    }
+    co_return result;
+}
+
 } // namespace silkrpc::ethdb::bitmap
@@ -17,19 +17,38 @@
 #ifndef SILKRPC_ETHDB_BITMAP_HPP_
 #define SILKRPC_ETHDB_BITMAP_HPP_
 
+#include <optional>
 #include <string>
+#include <vector>
 
 #include <silkrpc/config.hpp>
 
 #include <boost/asio/awaitable.hpp>
 
 #include <silkworm/common/util.hpp>
+#include <silkrpc/common/bitmap_cache.hpp>
 #include <silkrpc/core/rawdb/accessors.hpp>
 #include <silkrpc/croaring/roaring.hh>
 
 namespace silkrpc::ethdb::bitmap {
 
-boost::asio::awaitable<roaring::Roaring> get(core::rawdb::DatabaseReader& db_reader, const std::string& table, silkworm::Bytes& key, uint32_t from_block, uint32_t to_block);
+boost::asio::awaitable<roaring::Roaring> get(const core::rawdb::DatabaseReader& db_reader, const std::string& table, silkworm::Bytes& key, uint32_t from_block, uint32_t to_block);
+
+//! Same as above but reading the sealed chunks from the cache whenever possible, just the remaining ones from the database
+boost::asio::awaitable<roaring::Roaring> get(const core::rawdb::DatabaseReader& db_reader, const std::string& table, silkworm::Bytes& key, uint32_t from_block, uint32_t to_block,
+    BitmapCache& cache);
+
+//! One term of a bitmap query, matching the blocks indexed by any of its keys in its table (no keys means any block)
+struct QueryTerm {
+    std::string table;
+    std::vector<silkworm::Bytes> keys;
+};
+
+//! Evaluate the query matching the blocks of all its terms, i.e. the AND of the terms each one being the OR of its keys.
+//! Terms are evaluated in order, each one just within the block range still matching, and evaluation stops as soon as
+//! nothing matches. Return nullopt if no term has any key, i.e. if the query matches any block.
+boost::asio::awaitable<std::optional<roaring::Roaring>> query(const core::rawdb::DatabaseReader& db_reader, const std::vector<QueryTerm>& terms,
+    uint32_t from_block, uint32_t to_block, BitmapCache* cache = nullptr);
 
 } // silkrpc::ethdb::bitmap
 
@@ -0,0 +1,118 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "bitmap.hpp"
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/endian/conversion.hpp>
+
+namespace silkrpc {
+
+//! In-memory bitmap index table having the chunks of one key
+class BitmapChunksDatabase : public core::rawdb::DatabaseReader {
+public:
+    //! Add the chunks having the specified number of blocks each, every other block being indexed
+    BitmapChunksDatabase(const silkworm::Bytes& key, uint32_t num_chunks, uint32_t blocks_per_chunk) {
+        for (uint32_t i{0}; i < num_chunks; ++i) {
+            roaring::Roaring chunk;
+            const auto first_block = i * blocks_per_chunk;
+            for (uint32_t block{first_block}; block < first_block + blocks_per_chunk; block += 2) {
+                chunk.add(block);
+            }
+            silkworm::Bytes value(chunk.getSizeInBytes(), '\0');
+            chunk.write(reinterpret_cast<char*>(value.data()));
+            silkworm::Bytes chunk_key{key};
+            chunk_key.resize(key.size() + sizeof(uint32_t));
+            const auto last_block = i + 1 < num_chunks ? first_block + blocks_per_chunk - 1 : BitmapCache::kLastChunkSuffix;
+            boost::endian::store_big_u32(&chunk_key[key.size()], last_block);
+            chunks_[chunk_key] = value;
+        }
+    }
+
+    boost::asio::awaitable<KeyValue> get(const std::string& table, const silkworm::ByteView& key) const override {
+        co_return KeyValue{};
+    }
+    boost::asio::awaitable<silkworm::Bytes> get_one(const std::string& table, const silkworm::ByteView& key) const override {
+        co_return silkworm::Bytes{};
+    }
+    boost::asio::awaitable<std::optional<silkworm::Bytes>> get_both_range(const std::string& table, const silkworm::ByteView& key, const silkworm::ByteView& subkey) const override {
+        co_return silkworm::Bytes{};
+    }
+    boost::asio::awaitable<void> walk(const std::string& table, const silkworm::ByteView& start_key, uint32_t fixed_bits, core::rawdb::Walker w) const override {
+        const auto prefix = start_key.substr(0, fixed_bits / 8);
+        for (auto it = chunks_.lower_bound(silkworm::Bytes{start_key}); it != chunks_.end(); ++it) {
+            if (it->first.substr(0, prefix.size()) != prefix || !w(it->first, it->second)) {
+                break;
+            }
+        }
+        co_return;
+    }
+    boost::asio::awaitable<void> for_prefix(const std::string& table, const silkworm::ByteView& prefix, core::rawdb::Walker w) const override {
+        co_return;
+    }
+
+private:
+    std::map<silkworm::Bytes, silkworm::Bytes> chunks_;
+};
+
+static const std::string kAddressTable{"LogAddressIndex"};
+static constexpr uint32_t kBlocksPerChunk{10'000};
+
+//! Merge all the chunks of the key, i.e. the whole block range
+static void BM_bitmap_get(benchmark::State& state) {
+    silkworm::Bytes key{0x01, 0x02, 0x03};
+    const auto num_chunks = static_cast<uint32_t>(state.range(0));
+    BitmapChunksDatabase db{key, num_chunks, kBlocksPerChunk};
+    boost::asio::io_context io_context;
+    boost::asio::co_spawn(io_context, [&]() -> boost::asio::awaitable<void> {
+        for (auto _ : state) {
+            const auto bitmap = co_await ethdb::bitmap::get(db, kAddressTable, key, 0, num_chunks * kBlocksPerChunk);
+            benchmark::DoNotOptimize(bitmap.cardinality());
+        }
+    }, boost::asio::detached);
+    io_context.run();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_bitmap_get)->Arg(1)->Arg(16)->Arg(256);
+
+//! Same as above but the sealed chunks are read from the cache after the first iteration
+static void BM_bitmap_get_cached(benchmark::State& state) {
+    silkworm::Bytes key{0x01, 0x02, 0x03};
+    const auto num_chunks = static_cast<uint32_t>(state.range(0));
+    BitmapChunksDatabase db{key, num_chunks, kBlocksPerChunk};
+    BitmapCache cache;
+    boost::asio::io_context io_context;
+    boost::asio::co_spawn(io_context, [&]() -> boost::asio::awaitable<void> {
+        for (auto _ : state) {
+            const auto bitmap = co_await ethdb::bitmap::get(db, kAddressTable, key, 0, num_chunks * kBlocksPerChunk, cache);
+            benchmark::DoNotOptimize(bitmap.cardinality());
+        }
+    }, boost::asio::detached);
+    io_context.run();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_bitmap_get_cached)->Arg(1)->Arg(16)->Arg(256);
+
+} // namespace silkrpc
@@ -1,26 +1,199 @@
 /*
-   Copyright 2021 The Silkrpc Authors
+    Copyright 2020 The Silkrpc Authors
 
-   Licensed under the Apache License, Version 2.0 (the "License");
-   you may not use this file except in compliance with the License.
-   You may obtain a copy of the License at
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
 
-       http://www.apache.org/licenses/LICENSE-2.0
+        http://www.apache.org/licenses/LICENSE-2.0
 
-   Unless required by applicable law or agreed to in writing, software
-   distributed under the License is distributed on an "AS IS" BASIS,
-   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
-   See the License for the specific language governing permissions and
-   limitations under the License.
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
 */
 
 #include "bitmap.hpp"
 
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/use_future.hpp>
+#include <boost/endian/conversion.hpp>
 #include <catch2/catch.hpp>
 
 namespace silkrpc {
 
 using Catch::Matchers::Message;
 
-} // namespace silkrpc
+//! In-memory bitmap index tables counting the chunks walked through
+class BitmapIndexDatabase : public core::rawdb::DatabaseReader {
+public:
+    void add_chunk(const std::string& table, const silkworm::Bytes& key, uint32_t last_block, std::initializer_list<uint32_t> blocks) {
+        roaring::Roaring chunk{blocks};
+        silkworm::Bytes value(chunk.getSizeInBytes(), '\0');
+        chunk.write(reinterpret_cast<char*>(value.data()));
+        silkworm::Bytes chunk_key{key};
+        chunk_key.resize(key.size() + sizeof(uint32_t));
+        boost::endian::store_big_u32(&chunk_key[key.size()], last_block);
+        tables_[table][chunk_key] = value;
+    }
+
+    std::size_t walked_chunks(const std::string& table) const {
+        const auto it = walked_chunks_.find(table);
+        return it != walked_chunks_.end() ? it->second : 0;
+    }
+
+    boost::asio::awaitable<KeyValue> get(const std::string& table, const silkworm::ByteView& key) const override {
+        co_return KeyValue{};
+    }
+    boost::asio::awaitable<silkworm::Bytes> get_one(const std::string& table, const silkworm::ByteView& key) const override {
+        co_return silkworm::Bytes{};
+    }
+    boost::asio::awaitable<std::optional<silkworm::Bytes>> get_both_range(const std::string& table, const silkworm::ByteView& key, const silkworm::ByteView& subkey) const override {
+        co_return silkworm::Bytes{};
+    }
+    boost::asio::awaitable<void> walk(const std::string& table, const silkworm::ByteView& start_key, uint32_t fixed_bits, core::rawdb::Walker w) const override {
+        const auto table_it = tables_.find(table);
+        if (table_it == tables_.end()) {
+            co_return;
+        }
+        const auto prefix = start_key.substr(0, fixed_bits / 8);
+        for (auto it = table_it->second.lower_bound(silkworm::Bytes{start_key}); it != table_it->second.end(); ++it) {
+            if (it->first.substr(0, prefix.size()) != prefix) {
+                break;
+            }
+            ++walked_chunks_[table];
+            if (!w(it->first, it->second)) {
+                break;
+            }
+        }
+    }
+    boost::asio::awaitable<void> for_prefix(const std::string& table, const silkworm::ByteView& prefix, core::rawdb::Walker w) const override {
+        co_return;
+    }
+
+private:
+    std::map<std::string, std::map<silkworm::Bytes, silkworm::Bytes>> tables_;
+    mutable std::map<std::string, std::size_t> walked_chunks_;
+};
+
+static const std::string kAddressTable{"LogAddressIndex"};
+static const std::string kTopicTable{"LogTopicIndex"};
+static const silkworm::Bytes kKey1{0x01};
+static const silkworm::Bytes kKey2{0x02};
+static const silkworm::Bytes kKey3{0x03};
+
+//! Key 1 has blocks 10, 20 | 30 | 40 and key 2 has blocks 20 | 40, 50 in the address table, key 3 has 50 in the topic table
+static void add_chunks(BitmapIndexDatabase& db) {
+    db.add_chunk(kAddressTable, kKey1, 20, {10, 20});
+    db.add_chunk(kAddressTable, kKey1, 30, {30});
+    db.add_chunk(kAddressTable, kKey1, BitmapCache::kLastChunkSuffix, {40});
+    db.add_chunk(kAddressTable, kKey2, 20, {20});
+    db.add_chunk(kAddressTable, kKey2, BitmapCache::kLastChunkSuffix, {40, 50});
+    db.add_chunk(kTopicTable, kKey3, BitmapCache::kLastChunkSuffix, {50});
+}
+
+template <typename T>
+static T run(boost::asio::awaitable<T> awaitable) {
+    boost::asio::thread_pool pool{1};
+    auto result = boost::asio::co_spawn(pool, std::move(awaitable), boost::asio::use_future);
+    return result.get();
+}
+
+TEST_CASE("bitmap::get", "[silkrpc][ethdb][bitmap]") {
+    BitmapIndexDatabase db;
+    add_chunks(db);
+    silkworm::Bytes key{kKey1};
+
+    SECTION("all chunks") {
+        const auto bitmap = run(ethdb::bitmap::get(db, kAddressTable, key, 0, 100));
+        CHECK(bitmap == roaring::Roaring{10, 20, 30, 40});
+    }
+
+    SECTION("chunks up to the one reaching the last block") {
+        const auto bitmap = run(ethdb::bitmap::get(db, kAddressTable, key, 0, 25));
+        CHECK(bitmap == roaring::Roaring{10, 20, 30});
+    }
+
+    SECTION("chunks from the one reaching the first block") {
+        const auto bitmap = run(ethdb::bitmap::get(db, kAddressTable, key, 25, 100));
+        CHECK(bitmap == roaring::Roaring{30, 40});
+    }
 
+    SECTION("unknown key") {
+        silkworm::Bytes unknown_key{0x04};
+        const auto bitmap = run(ethdb::bitmap::get(db, kAddressTable, unknown_key, 0, 100));
+        CHECK(bitmap.isEmpty());
+    }
+
+    SECTION("sealed chunks read from cache") {
+        BitmapCache cache;
+        CHECK(run(ethdb::bitmap::get(db, kAddressTable, key, 0, 100, cache)) == roaring::Roaring{10, 20, 30, 40});
+        CHECK(db.walked_chunks(kAddressTable) == 3);
+        CHECK(run(ethdb::bitmap::get(db, kAddressTable, key, 0, 100, cache)) == roaring::Roaring{10, 20, 30, 40});
+        CHECK(db.walked_chunks(kAddressTable) == 4);
+        CHECK(run(ethdb::bitmap::get(db, kAddressTable, key, 15, 25, cache)) == roaring::Roaring{10, 20, 30});
+        CHECK(db.walked_chunks(kAddressTable) == 4);
+    }
+
+    SECTION("sealed chunks read again after invalidation") {
+        BitmapCache cache;
+        CHECK(run(ethdb::bitmap::get(db, kAddressTable, key, 0, 100, cache)) == roaring::Roaring{10, 20, 30, 40});
+        cache.invalidate();
+        CHECK(run(ethdb::bitmap::get(db, kAddressTable, key, 0, 100, cache)) == roaring::Roaring{10, 20, 30, 40});
+        CHECK(db.walked_chunks(kAddressTable) == 6);
+    }
+}
+
+TEST_CASE("bitmap::query", "[silkrpc][ethdb][bitmap]") {
+    BitmapIndexDatabase db;
+    add_chunks(db);
+
+    SECTION("no terms") {
+        CHECK(!run(ethdb::bitmap::query(db, {}, 0, 100)));
+    }
+
+    SECTION("terms without keys") {
+        std::vector<ethdb::bitmap::QueryTerm> terms{{kAddressTable, {}}, {kTopicTable, {}}};
+        CHECK(!run(ethdb::bitmap::query(db, terms, 0, 100)));
+    }
+
+    SECTION("OR of the term keys") {
+        std::vector<ethdb::bitmap::QueryTerm> terms{{kAddressTable, {kKey1, kKey2}}};
+        const auto bitmap = run(ethdb::bitmap::query(db, terms, 0, 100));
+        REQUIRE(bitmap);
+        CHECK(*bitmap == roaring::Roaring{10, 20, 30, 40, 50});
+    }
+
+    SECTION("AND of the terms") {
+        std::vector<ethdb::bitmap::QueryTerm> terms{{kAddressTable, {kKey1}}, {kTopicTable, {}}, {kAddressTable, {kKey2}}};
+        const auto bitmap = run(ethdb::bitmap::query(db, terms, 0, 100));
+        REQUIRE(bitmap);
+        CHECK(*bitmap == roaring::Roaring{20, 40});
+    }
+
+    SECTION("next terms restricted to the matching range") {
+        std::vector<ethdb::bitmap::QueryTerm> terms{{kTopicTable, {kKey3}}, {kAddressTable, {kKey1}}};
+        const auto bitmap = run(ethdb::bitmap::query(db, terms, 0, 100));
+        REQUIRE(bitmap);
+        CHECK(bitmap->isEmpty());
+        CHECK(db.walked_chunks(kAddressTable) == 1);
+    }
+
+    SECTION("evaluation stopped when empty") {
+        std::vector<ethdb::bitmap::QueryTerm> terms{{kAddressTable, {kKey1}}, {kTopicTable, {kKey3}}, {kAddressTable, {kKey2}}};
+        const auto bitmap = run(ethdb::bitmap::query(db, terms, 0, 100));
+        REQUIRE(bitmap);
+        CHECK(bitmap->isEmpty());
+        CHECK(db.walked_chunks(kAddressTable) == 3);
+    }
+}
+
+} // namespace silkrpc
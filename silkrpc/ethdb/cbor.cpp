@@ -16,6 +16,10 @@
 
 #include "cbor.hpp"
 
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
 #include <nlohmann/json.hpp>
 
 #include <silkrpc/common/log.hpp>
@@ -23,10 +27,223 @@
 
 namespace silkrpc {
 
-bool cbor_decode(const silkworm::Bytes& bytes, std::vector<Log>& logs) {
-    if (bytes.size() == 0) {
+namespace {
+
+constexpr uint8_t kCborUnsigned{0};
+constexpr uint8_t kCborBytes{2};
+constexpr uint8_t kCborArray{4};
+constexpr uint8_t kCborMap{5};
+constexpr uint8_t kCborTag{6};
+constexpr uint8_t kCborNull{0xf6};
+
+//! The maximum nesting of the items skipped by CborReader
+constexpr int kMaxSkipDepth{16};
+
+//! Reader of the definite-length CBOR items used by Erigon to encode logs and receipts, giving views into the encoded
+//! bytes. Any item not supported (indefinite length, tags, truncated input) makes it fail, so that the bytes can be
+//! decoded by the general-purpose decoder instead, which gives the same result or reports the error
+class CborReader {
+  public:
+    explicit CborReader(silkworm::ByteView bytes) : bytes_{bytes} {}
+
+    bool at_end() const { return position_ == bytes_.size(); }
+
+    std::size_t remaining() const { return bytes_.size() - position_; }
+
+    bool read_array(uint64_t& size) { return read_head(kCborArray, size); }
+
+    bool read_unsigned(uint64_t& value) { return read_head(kCborUnsigned, value); }
+
+    bool read_bytes(silkworm::ByteView& bytes) {
+        uint64_t size{0};
+        if (!read_head(kCborBytes, size) || size > bytes_.size() - position_) {
+            return false;
+        }
+        bytes = bytes_.substr(position_, size);
+        position_ += size;
+        return true;
+    }
+
+    bool read_null() {
+        if (at_end() || bytes_[position_] != kCborNull) {
+            return false;
+        }
+        ++position_;
+        return true;
+    }
+
+    bool is_null() const { return !at_end() && bytes_[position_] == kCborNull; }
+
+    bool skip(int depth = 0) {
+        if (at_end() || depth > kMaxSkipDepth) {
+            return false;
+        }
+        const uint8_t major = bytes_[position_] >> 5;
+        uint64_t argument{0};
+        if (!read_head(major, argument)) {
+            return false;
+        }
+        switch (major) {
+            case kCborBytes:
+            case kCborBytes + 1: // text string
+                if (argument > bytes_.size() - position_) {
+                    return false;
+                }
+                position_ += argument;
+                return true;
+            case kCborArray:
+            case kCborMap: {
+                const auto num_items = major == kCborMap ? argument * 2 : argument;
+                for (uint64_t i{0}; i < num_items; ++i) {
+                    if (!skip(depth + 1)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            case kCborTag:
+                return false; // rejected by the general-purpose decoder as well
+            default:
+                return true;
+        }
+    }
+
+  private:
+    bool read_head(uint8_t expected_major, uint64_t& argument) {
+        if (at_end()) {
+            return false;
+        }
+        const uint8_t major = bytes_[position_] >> 5;
+        const uint8_t info = bytes_[position_] & 0x1f;
+        if (major != expected_major) {
+            return false;
+        }
+        if (info < 24) {
+            argument = info;
+            ++position_;
+            return true;
+        }
+        if (info > 27) {
+            return false; // reserved or indefinite length
+        }
+        const std::size_t size = std::size_t{1} << (info - 24);
+        if (size > bytes_.size() - position_ - 1) {
+            return false;
+        }
+        argument = 0;
+        for (std::size_t i{1}; i <= size; ++i) {
+            argument = (argument << 8) | bytes_[position_ + i];
+        }
+        position_ += 1 + size;
+        return true;
+    }
+
+    silkworm::ByteView bytes_;
+    std::size_t position_{0};
+};
+
+//! Read the view of the next log encoded as [address, [topics...], data or null, ...], if supported
+bool read_log_view(CborReader& reader, LogView& view) {
+    uint64_t num_fields{0};
+    if (!reader.read_array(num_fields) || num_fields < 3) {
+        return false;
+    }
+    if (!reader.read_bytes(view.address) || view.address.size() != sizeof(evmc::address::bytes)) {
+        return false;
+    }
+    uint64_t num_topics{0};
+    if (!reader.read_array(num_topics) || num_topics > reader.remaining()) {
+        return false;
+    }
+    view.topics.resize(num_topics);
+    for (auto& topic : view.topics) {
+        if (!reader.read_bytes(topic) || topic.size() != sizeof(evmc::bytes32::bytes)) {
+            return false;
+        }
+    }
+    if (reader.is_null()) {
+        reader.read_null();
+        view.data = {};
+    } else if (!reader.read_bytes(view.data)) {
+        return false;
+    }
+    for (uint64_t i{3}; i < num_fields; ++i) {
+        if (!reader.skip()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Log make_log(const LogView& view, uint32_t index) {
+    Log log;
+    std::memcpy(log.address.bytes, view.address.data(), sizeof(log.address.bytes));
+    log.topics.resize(view.topics.size());
+    for (std::size_t i{0}; i < view.topics.size(); ++i) {
+        std::memcpy(log.topics[i].bytes, view.topics[i].data(), sizeof(log.topics[i].bytes));
+    }
+    log.data = view.data;
+    log.index = index;
+    return log;
+}
+
+//! Decode the logs selected by the matcher straight from the encoded bytes, returning nothing if unsupported
+std::optional<std::size_t> decode_log_views(silkworm::ByteView bytes, const LogMatcher& match, std::vector<Log>& logs) {
+    CborReader reader{bytes};
+    uint64_t num_logs{0};
+    if (!reader.read_array(num_logs)) {
+        return std::nullopt;
+    }
+    LogView view;
+    for (uint64_t i{0}; i < num_logs; ++i) {
+        if (!read_log_view(reader, view)) {
+            return std::nullopt;
+        }
+        if (match(view)) {
+            logs.push_back(make_log(view, static_cast<uint32_t>(i)));
+        }
+    }
+    if (!reader.at_end()) {
+        return std::nullopt;
+    }
+    return num_logs;
+}
+
+//! Decode the receipts encoded as [type, null, status, cumulative gas used, ...] each, returning false if unsupported
+bool decode_receipts(silkworm::ByteView bytes, std::vector<Receipt>& receipts) {
+    CborReader reader{bytes};
+    uint64_t num_receipts{0};
+    if (!reader.read_array(num_receipts)) {
+        return false;
+    }
+    std::vector<Receipt> decoded;
+    decoded.reserve(num_receipts <= reader.remaining() ? num_receipts : 0);
+    for (uint64_t i{0}; i < num_receipts; ++i) {
+        uint64_t num_fields{0};
+        uint64_t type{0};
+        uint64_t status{0};
+        Receipt receipt;
+        if (!reader.read_array(num_fields) || num_fields < 4 || !reader.read_unsigned(type) || type > UINT8_MAX || !reader.read_null() ||
+            !reader.read_unsigned(status) || !reader.read_unsigned(receipt.cumulative_gas_used)) {
+            return false;
+        }
+        for (uint64_t j{4}; j < num_fields; ++j) {
+            if (!reader.skip()) {
+                return false;
+            }
+        }
+        receipt.type = static_cast<uint8_t>(type);
+        receipt.success = status == 1u;
+        decoded.push_back(std::move(receipt));
+    }
+    if (!reader.at_end()) {
         return false;
     }
+    receipts = std::move(decoded);
+    return true;
+}
+
+bool cbor_decode_json(silkworm::ByteView bytes, std::vector<Log>& logs) {
     auto json = nlohmann::json::from_cbor(bytes);
     SILKRPC_TRACE << "cbor_decode<std::vector<Log>> json: " << json.dump() << "\n";
     if (json.is_array()) {
@@ -38,10 +255,57 @@ bool cbor_decode(const silkworm::Bytes& bytes, std::vector<Log>& logs) {
     }
 }
 
+} // namespace
+
+bool cbor_decode(const silkworm::Bytes& bytes, std::vector<Log>& logs) {
+    if (bytes.size() == 0) {
+        return false;
+    }
+    Logs decoded;
+    if (!decode_log_views(bytes, [](const LogView&) { return true; }, decoded)) {
+        return cbor_decode_json(bytes, logs);
+    }
+    for (auto& log : decoded) {
+        log.index = 0;
+    }
+    logs = std::move(decoded);
+    return true;
+}
+
+std::optional<std::size_t> cbor_decode(silkworm::ByteView bytes, const LogMatcher& match, std::vector<Log>& logs) {
+    if (bytes.size() == 0) {
+        return std::nullopt;
+    }
+    const auto initial_size{logs.size()};
+    const auto num_logs{decode_log_views(bytes, match, logs)};
+    if (num_logs) {
+        return num_logs;
+    }
+    logs.resize(initial_size);
+
+    // Fall back to the general-purpose decoder, matching the materialized logs
+    Logs decoded;
+    if (!cbor_decode_json(bytes, decoded)) {
+        return std::nullopt;
+    }
+    LogView view;
+    for (std::size_t i{0}; i < decoded.size(); ++i) {
+        view_of(decoded[i], view);
+        if (match(view)) {
+            decoded[i].index = static_cast<uint32_t>(i);
+            logs.push_back(std::move(decoded[i]));
+        }
+    }
+    return decoded.size();
+}
+
 bool cbor_decode(const silkworm::Bytes& bytes, std::vector<Receipt>& receipts) {
     if (bytes.size() == 0) {
         return false;
     }
+    if (decode_receipts(bytes, receipts)) {
+        return true;
+    }
     auto json = nlohmann::json::from_cbor(bytes);
     SILKRPC_TRACE << "cbor_decode<std::vector<Receipt>> json: " << json.dump() << "\n";
     if (json.is_array()) {
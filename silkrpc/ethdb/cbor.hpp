@@ -17,6 +17,9 @@
 #ifndef SILKRPC_ETHDB_CBOR_HPP_
 #define SILKRPC_ETHDB_CBOR_HPP_
 
+#include <cstddef>
+#include <functional>
+#include <optional>
 #include <vector>
 
 #include <silkworm/common/util.hpp>
@@ -28,6 +31,13 @@ namespace silkrpc {
 
 [[nodiscard]] bool cbor_decode(const silkworm::Bytes& bytes, std::vector<Log>& logs);
 
+//! Predicate selecting the logs to materialize, given the view of their raw fields valid just during the call
+using LogMatcher = std::function<bool(const LogView&)>;
+
+//! Append the logs selected by the matcher, setting their index to the position among all the decoded ones: the others
+//! are just skipped, w/o materializing their fields. Return the number of decoded logs or nothing if not decoded
+[[nodiscard]] std::optional<std::size_t> cbor_decode(silkworm::ByteView bytes, const LogMatcher& match, std::vector<Log>& logs);
+
 [[nodiscard]] bool cbor_decode(const silkworm::Bytes& bytes, std::vector<Receipt>& receipts);
 
 } // namespace silkrpc
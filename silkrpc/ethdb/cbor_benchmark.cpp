@@ -0,0 +1,109 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "cbor.hpp"
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <silkworm/common/util.hpp>
+
+#include <silkrpc/types/log.hpp>
+#include <silkrpc/types/receipt.hpp>
+
+namespace silkrpc {
+
+//! Return the CBOR header of the array having the specified number of items (less than 65536)
+static std::string cbor_array_header(std::size_t num_items) {
+    const auto* hex_digits = "0123456789abcdef";
+    std::string header;
+    if (num_items < 24) {
+        header.push_back(hex_digits[8]);
+        header.push_back(hex_digits[num_items]);
+    } else if (num_items < 256) {
+        header = "98";
+        header.push_back(hex_digits[num_items >> 4]);
+        header.push_back(hex_digits[num_items & 0xf]);
+    } else {
+        header = "99";
+        for (int shift{12}; shift >= 0; shift -= 4) {
+            header.push_back(hex_digits[(num_items >> shift) & 0xf]);
+        }
+    }
+    return header;
+}
+
+//! The receipts of a block as stored by Erigon, i.e. [type, post state, status, cumulative gas used] for each one
+static silkworm::Bytes make_receipts(std::size_t num_receipts) {
+    auto receipts_hex = cbor_array_header(num_receipts);
+    for (std::size_t i{0}; i < num_receipts; ++i) {
+        receipts_hex += "8402f6011a00371b0b";
+    }
+    return *silkworm::from_hex(receipts_hex);
+}
+
+//! The logs of a transaction as stored by Erigon, each one having 3 topics and 64 bytes of data
+static silkworm::Bytes make_logs(std::size_t num_logs) {
+    const std::string address_hex{"54ea674fdde714fd979de3edf0f56aa9716b898ec8"};
+    const std::string topic_hex{"5820ddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef"};
+    const std::string data_hex{"5840" + std::string(128, '1')};
+    auto logs_hex = cbor_array_header(num_logs);
+    for (std::size_t i{0}; i < num_logs; ++i) {
+        logs_hex += "83" + address_hex + "83" + topic_hex + topic_hex + topic_hex + data_hex;
+    }
+    return *silkworm::from_hex(logs_hex);
+}
+
+static void BM_cbor_decode_receipts(benchmark::State& state) {
+    const auto bytes = make_receipts(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        Receipts receipts;
+        const auto success = cbor_decode(bytes, receipts);
+        benchmark::DoNotOptimize(success);
+        benchmark::DoNotOptimize(receipts.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_cbor_decode_receipts)->Arg(1)->Arg(200)->Arg(1'000);
+
+static void BM_cbor_decode_logs(benchmark::State& state) {
+    const auto bytes = make_logs(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        Logs logs;
+        const auto success = cbor_decode(bytes, logs);
+        benchmark::DoNotOptimize(success);
+        benchmark::DoNotOptimize(logs.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_cbor_decode_logs)->Arg(1)->Arg(10)->Arg(100);
+
+static void BM_cbor_decode_matching_logs(benchmark::State& state) {
+    const auto bytes = make_logs(static_cast<std::size_t>(state.range(0)));
+    // No log matching, as most of the ones scanned by eth_getLogs
+    const LogMatcher match = [](const LogView& log) { return log.topics.empty(); };
+    for (auto _ : state) {
+        Logs logs;
+        const auto num_logs = cbor_decode(bytes, match, logs);
+        benchmark::DoNotOptimize(num_logs);
+        benchmark::DoNotOptimize(logs.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_cbor_decode_matching_logs)->Arg(1)->Arg(10)->Arg(100);
+
+} // namespace silkrpc
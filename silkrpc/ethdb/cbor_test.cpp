@@ -112,6 +112,96 @@ TEST_CASE("decode logs from incorrect bytes", "[silkrpc][ethdb][cbor]") {
     CHECK_THROWS_MATCHES(cbor_decode(b2, logs), std::system_error, Message("Log CBOR: missing entries: "s + invalidArgumentMessage));
 }
 
+TEST_CASE("decode matching logs", "[silkrpc][ethdb][cbor]") {
+    const auto bytes = *silkworm::from_hex(
+        "83"
+        "83540715a7794a1dc8e42615f059dd6e406a6594651a80f6"
+        "835456c0369e002852c2570ca0cc3442e26df98e01a2815820ddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef"
+        "4400110011"
+        "83540715a7794a1dc8e42615f059dd6e406a6594651a80420102");
+    const auto address = 0x0715a7794a1dc8e42615f059dd6e406a6594651a_address;
+    const LogMatcher match_address = [&](const LogView& log) {
+        return log.address == silkworm::ByteView{address.bytes, sizeof(address.bytes)};
+    };
+
+    SECTION("no matching log") {
+        Logs logs{};
+        const auto num_logs = cbor_decode(bytes, [](const LogView&) { return false; }, logs);
+        CHECK(num_logs == 3);
+        CHECK(logs.empty());
+    }
+
+    SECTION("matching logs appended with their index") {
+        Logs logs{Log{}};
+        const auto num_logs = cbor_decode(bytes, match_address, logs);
+        CHECK(num_logs == 3);
+        CHECK(logs.size() == 3);
+        CHECK(logs[1].address == address);
+        CHECK(logs[1].index == 0);
+        CHECK(logs[1].data == silkworm::Bytes{});
+        CHECK(logs[2].address == address);
+        CHECK(logs[2].index == 2);
+        CHECK(logs[2].data == *silkworm::from_hex("0102"));
+    }
+
+    SECTION("log views") {
+        std::vector<LogView> views;
+        Logs logs{};
+        const auto num_logs = cbor_decode(bytes, [&](const LogView& log) {
+            CHECK(log.address.size() == 20);
+            views.push_back(log);
+            return log.topics.size() == 1;
+        }, logs);
+        CHECK(num_logs == 3);
+        CHECK(views.size() == 3);
+        CHECK(views[1].topics[0] == *silkworm::from_hex("ddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef"));
+        CHECK(views[1].data == *silkworm::from_hex("00110011"));
+        CHECK(logs.size() == 1);
+        CHECK(logs[0].address == 0x56c0369e002852c2570ca0cc3442e26df98e01a2_address);
+        CHECK(logs[0].topics == std::vector<evmc::bytes32>{0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef_bytes32});
+        CHECK(logs[0].index == 1);
+    }
+
+    SECTION("same logs as decoding all") {
+        Logs all_logs{};
+        CHECK(cbor_decode(silkworm::Bytes{bytes}, all_logs));
+        Logs logs{};
+        CHECK(cbor_decode(bytes, [](const LogView&) { return true; }, logs) == 3);
+        CHECK(logs.size() == all_logs.size());
+        for (std::size_t i{0}; i < logs.size(); ++i) {
+            CHECK(logs[i].address == all_logs[i].address);
+            CHECK(logs[i].topics == all_logs[i].topics);
+            CHECK(logs[i].data == all_logs[i].data);
+            CHECK(logs[i].index == i);
+        }
+    }
+}
+
+TEST_CASE("decode matching logs in general CBOR layout", "[silkrpc][ethdb][cbor]") {
+    // Indefinite-length array of logs
+    const auto bytes = *silkworm::from_hex("9f8354ea674fdde714fd979de3edf0f56aa9716b898ec88043010043ff");
+    Logs logs{};
+    const auto num_logs = cbor_decode(bytes, [](const LogView& log) { return log.data.size() == 3; }, logs);
+    CHECK(num_logs == 1);
+    CHECK(logs.size() == 1);
+    CHECK(logs[0].address == 0xea674fdde714fd979de3edf0f56aa9716b898ec8_address);
+    CHECK(silkworm::to_hex(logs[0].data) == "010043");
+}
+
+TEST_CASE("decode matching logs from incorrect bytes", "[silkrpc][ethdb][cbor]") {
+    Logs logs{};
+    const LogMatcher match_all = [](const LogView&) { return true; };
+    CHECK(!cbor_decode(silkworm::ByteView{}, match_all, logs));
+    const auto b1 = *silkworm::from_hex("81");
+    CHECK_THROWS(cbor_decode(b1, match_all, logs));
+    const auto b2 = *silkworm::from_hex("83808040");
+    CHECK_THROWS_MATCHES(cbor_decode(b2, match_all, logs), std::system_error, Message("Log CBOR: missing entries: "s + invalidArgumentMessage));
+    // Truncated second log: the first one is not appended
+    const auto b3 = *silkworm::from_hex("828354ea674fdde714fd979de3edf0f56aa9716b898ec880430100438354ea67");
+    CHECK_THROWS(cbor_decode(b3, match_all, logs));
+    CHECK(logs.empty());
+}
+
 TEST_CASE("decode receipts from empty bytes", "[silkrpc][ethdb][cbor]") {
     Receipts receipts{};
     CHECK_NOTHROW(cbor_decode(*silkworm::from_hex(""), receipts));
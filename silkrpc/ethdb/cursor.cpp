@@ -16,8 +16,50 @@
 
 #include "cursor.hpp"
 
+#include <memory>
+#include <utility>
+
 namespace silkrpc::ethdb {
 
+boost::asio::awaitable<std::vector<KeyValue>> Cursor::seek_exact_many(const std::vector<silkworm::Bytes>& keys) {
+    std::vector<KeyValue> kv_pairs;
+    kv_pairs.reserve(keys.size());
+    for (const auto& key : keys) {
+        kv_pairs.push_back(co_await seek_exact(key));
+    }
+    co_return kv_pairs;
+}
+
+boost::asio::awaitable<std::vector<KeyValue>> Cursor::seek_many(const std::vector<silkworm::Bytes>& keys) {
+    std::vector<KeyValue> kv_pairs;
+    kv_pairs.reserve(keys.size());
+    for (const auto& key : keys) {
+        kv_pairs.push_back(co_await seek(key));
+    }
+    co_return kv_pairs;
+}
+
+boost::asio::awaitable<SharedByteView> Cursor::seek_exact_shared(silkworm::ByteView key) {
+    auto kv_pair = co_await seek_exact(key);
+    const auto value = std::make_shared<const silkworm::Bytes>(std::move(kv_pair.value));
+    co_return SharedByteView{value, *value};
+}
+
+boost::asio::awaitable<std::vector<silkworm::Bytes>> CursorDupSort::seek_both_many(const std::vector<silkworm::Bytes>& keys,
+    const std::vector<silkworm::Bytes>& values) {
+    std::vector<silkworm::Bytes> found_values;
+    found_values.reserve(keys.size());
+    for (std::size_t i{0}; i < keys.size(); ++i) {
+        found_values.push_back(co_await seek_both(keys[i], values[i]));
+    }
+    co_return found_values;
+}
+
+boost::asio::awaitable<KeyValueView> Cursor::next_view() {
+    next_kv_ = co_await next();
+    co_return KeyValueView{next_kv_.key, next_kv_.value};
+}
+
 SplitCursor::SplitCursor(Cursor& inner_cursor, silkworm::ByteView key, uint64_t match_bits, uint64_t part1_end, uint64_t part2_start, uint64_t part3_start)
 : inner_cursor_{inner_cursor}, key_{key} {
     part1_end_ = part1_end;
@@ -40,12 +82,12 @@ SplitCursor::SplitCursor(Cursor& inner_cursor, silkworm::ByteView key, uint64_t
 }
 
 boost::asio::awaitable<SplittedKeyValue> SplitCursor::seek() {
-    KeyValue kv = co_await inner_cursor_.seek(key_);
-    co_return split_key_value(kv);
+    const KeyValue kv = co_await inner_cursor_.seek(key_);
+    co_return split_key_value(KeyValueView{kv.key, kv.value});
 }
 
 boost::asio::awaitable<SplittedKeyValue> SplitCursor::next() {
-    KeyValue kv = co_await inner_cursor_.next();
+    const KeyValueView kv = co_await inner_cursor_.next_view();
     co_return split_key_value(kv);
 }
 
@@ -65,8 +107,8 @@ bool SplitCursor::match_key(const silkworm::ByteView& key) {
     return ((key[match_bytes_ - 1] & mask_) == last_bits_);
 }
 
-SplittedKeyValue SplitCursor::split_key_value(const KeyValue& kv) {
-    const silkworm::Bytes& key = kv.key;
+SplittedKeyValue SplitCursor::split_key_value(const KeyValueView& kv) {
+    const silkworm::ByteView key = kv.key;
 
     if (key.length() == 0) {
         return SplittedKeyValue{};
@@ -75,7 +117,7 @@ SplittedKeyValue SplitCursor::split_key_value(const KeyValue& kv) {
         return SplittedKeyValue{};
     }
 
-    SplittedKeyValue skv{key.substr(0, part1_end_)};
+    SplittedKeyValue skv{silkworm::Bytes{key.substr(0, part1_end_)}};
 
     if (key.length() > part2_start_) {
         skv.key2 = kv.key.substr(part2_start_, part3_start_ - part2_start_);
@@ -21,6 +21,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <boost/asio/awaitable.hpp>
 #include <silkworm/common/util.hpp>
@@ -45,9 +46,29 @@ public:
 
     virtual boost::asio::awaitable<KeyValue> seek_exact(silkworm::ByteView key) = 0;
 
+    //! Seek exactly each key, returning the key-value pairs in the same order of the keys. The default implementation
+    //! just calls seek_exact for each key, cursors able to pipeline the requests should override it
+    virtual boost::asio::awaitable<std::vector<KeyValue>> seek_exact_many(const std::vector<silkworm::Bytes>& keys);
+
+    //! Seek each key, returning the first key-value pair at or after each one in the same order of the keys. The default
+    //! implementation just calls seek for each key, cursors able to pipeline the requests should override it
+    virtual boost::asio::awaitable<std::vector<KeyValue>> seek_many(const std::vector<silkworm::Bytes>& keys);
+
+    //! Seek exactly the key, returning just the value as a view sharing the buffer holding it. The default implementation
+    //! just moves the value returned by seek_exact into the shared buffer, cursors owning the read buffers should override it
+    virtual boost::asio::awaitable<SharedByteView> seek_exact_shared(silkworm::ByteView key);
+
     virtual boost::asio::awaitable<KeyValue> next() = 0;
 
+    //! Move to the next key-value pair, returning it as views valid until the next operation on the cursor. The default
+    //! implementation just keeps the pair returned by next, cursors owning the read buffers should override it
+    virtual boost::asio::awaitable<KeyValueView> next_view();
+
     virtual boost::asio::awaitable<void> close_cursor() = 0;
+
+private:
+    //! The last key-value pair returned by the default next_view
+    KeyValue next_kv_;
 };
 
 class CursorDupSort : public Cursor {
@@ -56,6 +77,11 @@ public:
 
     virtual boost::asio::awaitable<KeyValue> seek_both_exact(silkworm::ByteView key, silkworm::ByteView value) = 0;
 
+    //! Seek both each key and the value at the same position, returning the values in the same order of the keys. The
+    //! default implementation just calls seek_both for each pair, cursors able to pipeline the requests should override it
+    virtual boost::asio::awaitable<std::vector<silkworm::Bytes>> seek_both_many(const std::vector<silkworm::Bytes>& keys,
+        const std::vector<silkworm::Bytes>& values);
+
     virtual boost::asio::awaitable<KeyValue> next_dup() = 0;
 };
 
@@ -87,7 +113,7 @@ private:
     uint8_t mask_;
 
     bool match_key(const silkworm::ByteView& key);
-    SplittedKeyValue split_key_value(const KeyValue& kv);
+    SplittedKeyValue split_key_value(const KeyValueView& kv);
 };
 
 } // namespace silkrpc::ethdb
@@ -18,12 +18,16 @@
 #define SILKRPC_ETHDB_DATABASE_HPP_
 
 #include <memory>
+#include <utility>
 
 #include <silkrpc/config.hpp>
 
 #include <boost/asio/awaitable.hpp>
 #include <boost/asio/io_context.hpp>
 
+#include <silkrpc/common/chain_head_cache.hpp>
+#include <silkrpc/ethdb/read_combiner.hpp>
+#include <silkrpc/ethdb/snapshot/repository.hpp>
 #include <silkrpc/ethdb/transaction.hpp>
 
 namespace silkrpc::ethdb {
@@ -37,6 +41,23 @@ public:
     Database& operator=(const Database&) = delete;
 
     virtual boost::asio::awaitable<std::unique_ptr<Transaction>> begin() = 0;
+
+    //! Notify that the specified database view is the latest one, so that transactions kept open on older ones are released
+    virtual void on_new_view(uint64_t /*view_id*/) {}
+
+    //! Share the cache of the chain head block numbers among the transactions begun from now on
+    void set_chain_head_cache(std::shared_ptr<ChainHeadCache> chain_head_cache) { chain_head_cache_ = std::move(chain_head_cache); }
+
+    //! Share the repository of the frozen blocks among the transactions begun from now on
+    void set_snapshots(std::shared_ptr<const snapshot::SnapshotRepository> snapshots) { snapshots_ = std::move(snapshots); }
+
+    //! Combine the identical point reads in flight on the transactions begun from now on
+    void set_read_combiner(std::shared_ptr<ReadCombiner> read_combiner) { read_combiner_ = std::move(read_combiner); }
+
+protected:
+    std::shared_ptr<ChainHeadCache> chain_head_cache_;
+    std::shared_ptr<const snapshot::SnapshotRepository> snapshots_;
+    std::shared_ptr<ReadCombiner> read_combiner_;
 };
 
 } // namespace silkrpc::ethdb
@@ -0,0 +1,87 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "local_cursor.hpp"
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::ethdb::file {
+
+boost::asio::awaitable<void> LocalCursor::open_cursor(const std::string& table_name, bool is_dup_sorted) {
+    SILKRPC_DEBUG << "LocalCursor::open_cursor opening cursor: " << cursor_id_ << " for table: " << table_name << "\n";
+    // Open the existing table accepting its flags as they are, because the remote interface does not tell dup-sorted ones
+    ::mdbx::map_handle map;
+    ::mdbx::error::success_or_throw(::mdbx_dbi_open(txn_, table_name.c_str(), MDBX_DB_ACCEDE, &map.dbi));
+    cursor_ = txn_.open_cursor(map);
+    co_return;
+}
+
+boost::asio::awaitable<KeyValue> LocalCursor::seek(silkworm::ByteView key) {
+    SILKRPC_DEBUG << "LocalCursor::seek cursor: " << cursor_id_ << " key: " << key << "\n";
+    const auto result = key.empty() ? cursor_.to_first(/*throw_notfound=*/false) : cursor_.lower_bound(silkworm::db::to_slice(key), false);
+    co_return to_key_value(result);
+}
+
+boost::asio::awaitable<KeyValue> LocalCursor::seek_exact(silkworm::ByteView key) {
+    SILKRPC_DEBUG << "LocalCursor::seek_exact cursor: " << cursor_id_ << " key: " << key << "\n";
+    co_return to_key_value(cursor_.find(silkworm::db::to_slice(key), /*throw_notfound=*/false));
+}
+
+boost::asio::awaitable<KeyValue> LocalCursor::next() {
+    SILKRPC_DEBUG << "LocalCursor::next cursor: " << cursor_id_ << "\n";
+    co_return to_key_value(cursor_.to_next(/*throw_notfound=*/false));
+}
+
+boost::asio::awaitable<KeyValueView> LocalCursor::next_view() {
+    SILKRPC_DEBUG << "LocalCursor::next_view cursor: " << cursor_id_ << "\n";
+    const auto result = cursor_.to_next(/*throw_notfound=*/false);
+    if (!result.done) {
+        co_return KeyValueView{};
+    }
+    co_return KeyValueView{silkworm::db::from_slice(result.key), silkworm::db::from_slice(result.value)};
+}
+
+boost::asio::awaitable<KeyValue> LocalCursor::next_dup() {
+    SILKRPC_DEBUG << "LocalCursor::next_dup cursor: " << cursor_id_ << "\n";
+    co_return to_key_value(cursor_.to_current_next_multi(/*throw_notfound=*/false));
+}
+
+boost::asio::awaitable<void> LocalCursor::close_cursor() {
+    SILKRPC_DEBUG << "LocalCursor::close_cursor cursor: " << cursor_id_ << "\n";
+    cursor_.close();
+    co_return;
+}
+
+boost::asio::awaitable<silkworm::Bytes> LocalCursor::seek_both(silkworm::ByteView key, silkworm::ByteView value) {
+    SILKRPC_DEBUG << "LocalCursor::seek_both cursor: " << cursor_id_ << " key: " << key << " subkey: " << value << "\n";
+    const auto result = cursor_.lower_bound_multivalue(silkworm::db::to_slice(key), silkworm::db::to_slice(value), /*throw_notfound=*/false);
+    co_return to_key_value(result).value;
+}
+
+boost::asio::awaitable<KeyValue> LocalCursor::seek_both_exact(silkworm::ByteView key, silkworm::ByteView value) {
+    SILKRPC_DEBUG << "LocalCursor::seek_both_exact cursor: " << cursor_id_ << " key: " << key << " subkey: " << value << "\n";
+    const auto result = cursor_.find_multivalue(silkworm::db::to_slice(key), silkworm::db::to_slice(value), /*throw_notfound=*/false);
+    co_return to_key_value(result);
+}
+
+KeyValue LocalCursor::to_key_value(const ::mdbx::cursor::move_result& result) {
+    if (!result.done) {
+        return KeyValue{};
+    }
+    return KeyValue{silkworm::Bytes{silkworm::db::from_slice(result.key)}, silkworm::Bytes{silkworm::db::from_slice(result.value)}};
+}
+
+} // namespace silkrpc::ethdb::file
@@ -0,0 +1,71 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_ETHDB_FILE_LOCAL_CURSOR_HPP_
+#define SILKRPC_ETHDB_FILE_LOCAL_CURSOR_HPP_
+
+#include <string>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/db/mdbx.hpp>
+
+#include <silkrpc/common/util.hpp>
+#include <silkrpc/ethdb/cursor.hpp>
+
+namespace silkrpc::ethdb::file {
+
+//! Cursor reading directly from the memory-mapped MDBX chaindata within the given read-only transaction: each operation
+//! completes synchronously, the awaitable interface is kept just to be interchangeable with the remote cursor.
+class LocalCursor : public CursorDupSort {
+public:
+    explicit LocalCursor(::mdbx::txn& txn, uint32_t cursor_id) : txn_{txn}, cursor_id_{cursor_id} {}
+
+    uint32_t cursor_id() const override { return cursor_id_; };
+
+    boost::asio::awaitable<void> open_cursor(const std::string& table_name, bool is_dup_sorted) override;
+
+    boost::asio::awaitable<KeyValue> seek(silkworm::ByteView key) override;
+
+    boost::asio::awaitable<KeyValue> seek_exact(silkworm::ByteView key) override;
+
+    boost::asio::awaitable<KeyValue> next() override;
+
+    //! Return views into the memory map, which are valid as long as the transaction is
+    boost::asio::awaitable<KeyValueView> next_view() override;
+
+    boost::asio::awaitable<KeyValue> next_dup() override;
+
+    boost::asio::awaitable<void> close_cursor() override;
+
+    boost::asio::awaitable<silkworm::Bytes> seek_both(silkworm::ByteView key, silkworm::ByteView value) override;
+
+    boost::asio::awaitable<KeyValue> seek_both_exact(silkworm::ByteView key, silkworm::ByteView value) override;
+
+private:
+    //! Copy the key-value pair out of the memory map, if the cursor moved successfully, or return an empty one otherwise
+    static KeyValue to_key_value(const ::mdbx::cursor::move_result& result);
+
+    ::mdbx::txn& txn_;
+    ::mdbx::cursor_managed cursor_;
+    uint32_t cursor_id_;
+};
+
+} // namespace silkrpc::ethdb::file
+
+#endif // SILKRPC_ETHDB_FILE_LOCAL_CURSOR_HPP_
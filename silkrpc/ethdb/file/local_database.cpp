@@ -0,0 +1,57 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "local_database.hpp"
+
+#include <utility>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/ethdb/batch_transaction.hpp>
+#include <silkrpc/ethdb/file/local_transaction.hpp>
+
+namespace silkrpc::ethdb::file {
+
+LocalDatabase::LocalDatabase(std::shared_ptr<::mdbx::env_managed> chaindata_env) : chaindata_env_{std::move(chaindata_env)} {
+    SILKRPC_TRACE << "LocalDatabase::ctor " << this << "\n";
+}
+
+LocalDatabase::~LocalDatabase() {
+    SILKRPC_TRACE << "LocalDatabase::dtor " << this << "\n";
+}
+
+boost::asio::awaitable<std::unique_ptr<Transaction>> LocalDatabase::begin() {
+    SILKRPC_TRACE << "LocalDatabase::begin " << this << " start\n";
+    // The requests of one batch share its transaction, so that all of them read the same view
+    if (auto batch_txn = co_await lease_batch_transaction(*this)) {
+        co_return batch_txn;
+    }
+    auto txn = std::make_unique<LocalTransaction>(*chaindata_env_);
+    co_await txn->open();
+    txn->set_chain_head_cache(chain_head_cache_.get());
+    txn->set_snapshots(snapshots_.get());
+    txn->set_read_combiner(read_combiner_.get());
+    SILKRPC_TRACE << "LocalDatabase::begin " << this << " txn: " << txn.get() << " end\n";
+    co_return txn;
+}
+
+std::shared_ptr<::mdbx::env_managed> LocalDatabase::open_chaindata(const std::string& chaindata_path) {
+    silkworm::db::EnvConfig config{chaindata_path};
+    config.readonly = true;
+    config.shared = true;
+    return std::make_shared<::mdbx::env_managed>(silkworm::db::open_env(config));
+}
+
+} // namespace silkrpc::ethdb::file
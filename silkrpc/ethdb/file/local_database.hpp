@@ -0,0 +1,51 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_ETHDB_FILE_LOCAL_DATABASE_HPP_
+#define SILKRPC_ETHDB_FILE_LOCAL_DATABASE_HPP_
+
+#include <memory>
+#include <string>
+
+#include <silkworm/db/mdbx.hpp>
+
+#include <silkrpc/ethdb/database.hpp>
+#include <silkrpc/ethdb/transaction.hpp>
+
+namespace silkrpc::ethdb::file {
+
+//! Database reading the Erigon chaindata directly from the local MDBX environment, skipping the KV gRPC interface
+class LocalDatabase : public Database {
+public:
+    explicit LocalDatabase(std::shared_ptr<::mdbx::env_managed> chaindata_env);
+
+    ~LocalDatabase();
+
+    LocalDatabase(const LocalDatabase&) = delete;
+    LocalDatabase& operator=(const LocalDatabase&) = delete;
+
+    boost::asio::awaitable<std::unique_ptr<Transaction>> begin() override;
+
+    //! Open the chaindata MDBX environment at the given path read-only, sharing it with the Erigon process writing it
+    static std::shared_ptr<::mdbx::env_managed> open_chaindata(const std::string& chaindata_path);
+
+private:
+    std::shared_ptr<::mdbx::env_managed> chaindata_env_;
+};
+
+} // namespace silkrpc::ethdb::file
+
+#endif // SILKRPC_ETHDB_FILE_LOCAL_DATABASE_HPP_
@@ -0,0 +1,133 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "local_database.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/use_future.hpp>
+#include <catch2/catch.hpp>
+#include <silkworm/common/util.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::ethdb::file {
+
+using namespace silkworm; // NOLINT(build/namespaces)
+
+static const char* kTestTable{"TestTable"};
+static const char* kTestDupTable{"TestDupTable"};
+
+//! Create a chaindata environment in a temporary folder with one plain table and one dup-sorted table
+struct LocalDatabaseTest {
+    LocalDatabaseTest() : path{std::filesystem::temp_directory_path() / "silkrpc_local_database_test"} {
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path);
+        db::EnvConfig config{path.string(), /*create=*/true};
+        auto env = db::open_env(config);
+        auto txn = env.start_write();
+        auto table = txn.create_map(kTestTable, ::mdbx::key_mode::usual, ::mdbx::value_mode::single);
+        txn.upsert(table, db::to_slice(*from_hex("01")), db::to_slice(*from_hex("aa")));
+        txn.upsert(table, db::to_slice(*from_hex("03")), db::to_slice(*from_hex("cc")));
+        auto dup_table = txn.create_map(kTestDupTable, ::mdbx::key_mode::usual, ::mdbx::value_mode::multi);
+        txn.upsert(dup_table, db::to_slice(*from_hex("01")), db::to_slice(*from_hex("0a")));
+        txn.upsert(dup_table, db::to_slice(*from_hex("01")), db::to_slice(*from_hex("0c")));
+        txn.commit();
+        env.close();
+    }
+    ~LocalDatabaseTest() { std::filesystem::remove_all(path); }
+
+    template <typename Awaitable>
+    auto spawn_and_wait(Awaitable&& awaitable) {
+        auto result = boost::asio::co_spawn(io_context, std::forward<Awaitable>(awaitable), boost::asio::use_future);
+        io_context.run();
+        io_context.restart();
+        return result.get();
+    }
+
+    std::filesystem::path path;
+    boost::asio::io_context io_context;
+};
+
+TEST_CASE_METHOD(LocalDatabaseTest, "LocalDatabase::begin", "[silkrpc][ethdb][file][local_database]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+
+    LocalDatabase database{LocalDatabase::open_chaindata(path.string())};
+    auto txn = spawn_and_wait(database.begin());
+    CHECK(txn->tx_id() != 0);
+    CHECK_NOTHROW(spawn_and_wait(txn->close()));
+    CHECK(txn->tx_id() == 0);
+}
+
+TEST_CASE_METHOD(LocalDatabaseTest, "LocalCursor", "[silkrpc][ethdb][file][local_database]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+
+    LocalDatabase database{LocalDatabase::open_chaindata(path.string())};
+    auto txn = spawn_and_wait(database.begin());
+
+    SECTION("seek and next") {
+        auto cursor = spawn_and_wait(txn->cursor(kTestTable));
+        auto kv = spawn_and_wait(cursor->seek(*from_hex("02")));
+        CHECK(kv.key == *from_hex("03"));
+        CHECK(kv.value == *from_hex("cc"));
+        kv = spawn_and_wait(cursor->seek(ByteView{}));
+        CHECK(kv.key == *from_hex("01"));
+        kv = spawn_and_wait(cursor->next());
+        CHECK(kv.key == *from_hex("03"));
+        kv = spawn_and_wait(cursor->next());
+        CHECK(kv.key.empty());
+    }
+
+    SECTION("seek_exact") {
+        auto cursor = spawn_and_wait(txn->cursor(kTestTable));
+        CHECK(spawn_and_wait(cursor->seek_exact(*from_hex("01"))).value == *from_hex("aa"));
+        CHECK(spawn_and_wait(cursor->seek_exact(*from_hex("02"))).key.empty());
+        const auto kvs = spawn_and_wait(cursor->seek_exact_many({*from_hex("03"), *from_hex("04")}));
+        REQUIRE(kvs.size() == 2);
+        CHECK(kvs[0].value == *from_hex("cc"));
+        CHECK(kvs[1].value.empty());
+    }
+
+    SECTION("same cursor for same table") {
+        auto cursor1 = spawn_and_wait(txn->cursor(kTestTable));
+        auto cursor2 = spawn_and_wait(txn->cursor(kTestTable));
+        CHECK(cursor1 == cursor2);
+    }
+
+    SECTION("dup-sorted operations") {
+        auto cursor = spawn_and_wait(txn->cursor_dup_sort(kTestDupTable));
+        CHECK(spawn_and_wait(cursor->seek_both(*from_hex("01"), *from_hex("0b"))) == *from_hex("0c"));
+        CHECK(spawn_and_wait(cursor->seek_both_exact(*from_hex("01"), *from_hex("0a"))).value == *from_hex("0a"));
+        CHECK(spawn_and_wait(cursor->seek_both_exact(*from_hex("01"), *from_hex("0b"))).key.empty());
+        spawn_and_wait(cursor->seek_exact(*from_hex("01")));
+        CHECK(spawn_and_wait(cursor->next_dup()).value == *from_hex("0c"));
+        CHECK(spawn_and_wait(cursor->next_dup()).key.empty());
+    }
+
+    SECTION("dup-sorted table opened by plain cursor") {
+        auto cursor = spawn_and_wait(txn->cursor(kTestDupTable));
+        CHECK(spawn_and_wait(cursor->seek_exact(*from_hex("01"))).value == *from_hex("0a"));
+    }
+
+    spawn_and_wait(txn->close());
+}
+
+} // namespace silkrpc::ethdb::file
@@ -0,0 +1,77 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "local_transaction.hpp"
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/ethdb/file/local_cursor.hpp>
+
+namespace silkrpc::ethdb::file {
+
+LocalTransaction::~LocalTransaction() {
+    // The cursors must be closed before the transaction they belong to
+    cursors_.clear();
+    dup_cursors_.clear();
+}
+
+boost::asio::awaitable<void> LocalTransaction::open() {
+    txn_ = env_.start_read();
+    tx_id_ = txn_.id();
+    co_return;
+}
+
+boost::asio::awaitable<std::shared_ptr<Cursor>> LocalTransaction::cursor(const std::string& table) {
+    co_return co_await get_cursor(table, false);
+}
+
+boost::asio::awaitable<std::shared_ptr<CursorDupSort>> LocalTransaction::cursor_dup_sort(const std::string& table) {
+    co_return co_await get_cursor(table, true);
+}
+
+boost::asio::awaitable<std::shared_ptr<Cursor>> LocalTransaction::new_cursor(const std::string& table) {
+    co_return co_await open_cursor(table, false);
+}
+
+boost::asio::awaitable<std::shared_ptr<CursorDupSort>> LocalTransaction::new_cursor_dup_sort(const std::string& table) {
+    co_return co_await open_cursor(table, true);
+}
+
+boost::asio::awaitable<void> LocalTransaction::close() {
+    cursors_.clear();
+    dup_cursors_.clear();
+    txn_.abort();
+    tx_id_ = 0;
+    co_return;
+}
+
+boost::asio::awaitable<std::shared_ptr<CursorDupSort>> LocalTransaction::get_cursor(const std::string& table, bool is_cursor_dup_sort) {
+    auto& table_cursors = is_cursor_dup_sort ? dup_cursors_ : cursors_;
+    auto cursor_it = table_cursors.find(table);
+    if (cursor_it != table_cursors.end()) {
+        co_return cursor_it->second;
+    }
+    auto cursor = co_await open_cursor(table, is_cursor_dup_sort);
+    table_cursors[table] = cursor;
+    co_return cursor;
+}
+
+boost::asio::awaitable<std::shared_ptr<CursorDupSort>> LocalTransaction::open_cursor(const std::string& table, bool is_cursor_dup_sort) {
+    auto cursor = std::make_shared<LocalCursor>(txn_, ++last_cursor_id_);
+    co_await cursor->open_cursor(table, is_cursor_dup_sort);
+    co_return cursor;
+}
+
+} // namespace silkrpc::ethdb::file
@@ -0,0 +1,71 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_ETHDB_FILE_LOCAL_TRANSACTION_HPP_
+#define SILKRPC_ETHDB_FILE_LOCAL_TRANSACTION_HPP_
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <silkworm/db/mdbx.hpp>
+
+#include <silkrpc/ethdb/cursor.hpp>
+#include <silkrpc/ethdb/transaction.hpp>
+
+namespace silkrpc::ethdb::file {
+
+//! Read-only MDBX transaction on the chaindata environment shared with Erigon
+class LocalTransaction : public Transaction {
+public:
+    explicit LocalTransaction(::mdbx::env& env) : env_{env} {}
+
+    ~LocalTransaction();
+
+    uint64_t tx_id() const override { return tx_id_; }
+
+    boost::asio::awaitable<void> open() override;
+
+    boost::asio::awaitable<std::shared_ptr<Cursor>> cursor(const std::string& table) override;
+
+    boost::asio::awaitable<std::shared_ptr<CursorDupSort>> cursor_dup_sort(const std::string& table) override;
+
+    boost::asio::awaitable<std::shared_ptr<Cursor>> new_cursor(const std::string& table) override;
+
+    boost::asio::awaitable<std::shared_ptr<CursorDupSort>> new_cursor_dup_sort(const std::string& table) override;
+
+    boost::asio::awaitable<void> close() override;
+
+private:
+    boost::asio::awaitable<std::shared_ptr<CursorDupSort>> get_cursor(const std::string& table, bool is_cursor_dup_sort);
+
+    //! Open a new cursor, which must be closed before the transaction
+    boost::asio::awaitable<std::shared_ptr<CursorDupSort>> open_cursor(const std::string& table, bool is_cursor_dup_sort);
+
+    ::mdbx::env& env_;
+    ::mdbx::txn_managed txn_;
+    std::map<std::string, std::shared_ptr<CursorDupSort>> cursors_;
+    std::map<std::string, std::shared_ptr<CursorDupSort>> dup_cursors_;
+    uint32_t last_cursor_id_{0};
+    uint64_t tx_id_{0};
+};
+
+} // namespace silkrpc::ethdb::file
+
+#endif // SILKRPC_ETHDB_FILE_LOCAL_TRANSACTION_HPP_
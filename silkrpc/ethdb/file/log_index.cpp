@@ -0,0 +1,202 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "log_index.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+#include <boost/endian/conversion.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/db/util.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/ethdb/cbor.hpp>
+#include <silkrpc/ethdb/tables.hpp>
+
+namespace silkrpc::ethdb::file {
+
+//! The value of each block is the sequence of its entries, each one made by tx index, first log index and Bloom filter
+constexpr std::size_t kEntrySize{2 * sizeof(uint32_t) + sizeof(LogBloom)};
+
+//! The number of bits set in the Bloom filter for each item
+constexpr std::size_t kBloomHashes{3};
+
+bool operator==(const TxLogBloom& lhs, const TxLogBloom& rhs) {
+    return lhs.tx_index == rhs.tx_index && lhs.first_log_index == rhs.first_log_index && lhs.bloom == rhs.bloom;
+}
+
+template <typename F>
+static bool for_each_bloom_bit(silkworm::ByteView item, F&& f) {
+    // Same scheme as the header logs bloom, i.e. bits taken from the hash byte pairs, just reduced to 256 bits
+    const auto hash{silkworm::keccak256(item)};
+    for (std::size_t i{0}; i < kBloomHashes; ++i) {
+        const uint8_t bit = hash.bytes[2 * i + 1];
+        if (!f(static_cast<std::size_t>(bit / 8), static_cast<uint8_t>(1 << (bit % 8)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LogIndex::add(LogBloom& bloom, silkworm::ByteView item) {
+    for_each_bloom_bit(item, [&](std::size_t byte, uint8_t mask) {
+        bloom[byte] |= mask;
+        return true;
+    });
+}
+
+bool LogIndex::may_contain(const LogBloom& bloom, silkworm::ByteView item) {
+    return for_each_bloom_bit(item, [&](std::size_t byte, uint8_t mask) { return (bloom[byte] & mask) != 0; });
+}
+
+bool LogIndex::may_match(const LogBloom& bloom, const Filter& filter) {
+    if (filter.addresses) {
+        bool any_address{false};
+        for (const auto& address : *filter.addresses) {
+            if (may_contain(bloom, silkworm::ByteView{address.bytes, sizeof(address.bytes)})) {
+                any_address = true;
+                break;
+            }
+        }
+        if (!any_address) {
+            return false;
+        }
+    }
+    if (filter.topics) {
+        for (const auto& subtopics : *filter.topics) {
+            if (subtopics.empty()) { // empty rule set == wildcard
+                continue;
+            }
+            bool any_topic{false};
+            for (const auto& topic : subtopics) {
+                if (may_contain(bloom, silkworm::ByteView{topic.bytes, sizeof(topic.bytes)})) {
+                    any_topic = true;
+                    break;
+                }
+            }
+            if (!any_topic) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+boost::asio::awaitable<std::vector<TxLogBloom>> LogIndex::read_entries(core::rawdb::DatabaseReader& db_reader, uint64_t block_number) {
+    std::vector<TxLogBloom> entries;
+    uint32_t log_index{0};
+    bool decoding_ok{true};
+    const auto block_key = silkworm::db::block_key(block_number);
+    co_await db_reader.for_prefix(db::table::kLogs, block_key, [&](const silkworm::Bytes& k, const silkworm::Bytes& v) {
+        // The Bloom filter is built straight from the log views, w/o materializing the logs
+        TxLogBloom entry{boost::endian::load_big_u32(&k[sizeof(uint64_t)]), log_index, {}};
+        Logs no_logs{};
+        const auto num_logs = cbor_decode(v, [&](const LogView& log) {
+            add(entry.bloom, log.address);
+            for (const auto& topic : log.topics) {
+                add(entry.bloom, topic);
+            }
+            return false;
+        }, no_logs);
+        decoding_ok = num_logs.has_value();
+        if (!decoding_ok) {
+            return false;
+        }
+        if (*num_logs == 0) {
+            return true;
+        }
+        log_index += static_cast<uint32_t>(*num_logs);
+        entries.push_back(entry);
+        return true;
+    });
+    if (!decoding_ok) {
+        throw std::runtime_error{"invalid logs in block " + std::to_string(block_number)};
+    }
+    co_return entries;
+}
+
+LogIndex::LogIndex(const std::string& path) {
+    std::filesystem::create_directories(path);
+    silkworm::db::EnvConfig config{path, /*create=*/true};
+    env_ = silkworm::db::open_env(config);
+    auto txn = env_.start_write();
+    map_ = txn.create_map(kTableName, ::mdbx::key_mode::usual, ::mdbx::value_mode::single);
+    txn.commit();
+    SILKRPC_INFO << "LogIndex opened at " << path << " last block: " << last_block().value_or(0) << "\n";
+}
+
+void LogIndex::put(uint64_t block_number, const std::vector<TxLogBloom>& entries) {
+    silkworm::Bytes value(entries.size() * kEntrySize, '\0');
+    auto data = value.data();
+    for (const auto& entry : entries) {
+        boost::endian::store_big_u32(data, entry.tx_index);
+        boost::endian::store_big_u32(data + sizeof(uint32_t), entry.first_log_index);
+        std::copy(entry.bloom.cbegin(), entry.bloom.cend(), data + 2 * sizeof(uint32_t));
+        data += kEntrySize;
+    }
+    const auto key = silkworm::db::block_key(block_number);
+    auto txn = env_.start_write();
+    txn.upsert(map_, silkworm::db::to_slice(key), silkworm::db::to_slice(value));
+    txn.commit();
+}
+
+std::optional<std::vector<TxLogBloom>> LogIndex::get(uint64_t block_number) const {
+    const auto key = silkworm::db::block_key(block_number);
+    auto txn = env_.start_read();
+    const auto value = txn.get(map_, silkworm::db::to_slice(key), ::mdbx::slice::invalid());
+    if (!value.is_valid() || value.length() % kEntrySize != 0) {
+        return std::nullopt;
+    }
+    const auto bytes = silkworm::db::from_slice(value);
+    std::vector<TxLogBloom> entries;
+    entries.reserve(bytes.size() / kEntrySize);
+    for (std::size_t offset{0}; offset < bytes.size(); offset += kEntrySize) {
+        TxLogBloom entry;
+        entry.tx_index = boost::endian::load_big_u32(&bytes[offset]);
+        entry.first_log_index = boost::endian::load_big_u32(&bytes[offset + sizeof(uint32_t)]);
+        std::copy_n(&bytes[offset + 2 * sizeof(uint32_t)], entry.bloom.size(), entry.bloom.begin());
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+std::size_t LogIndex::unwind(uint64_t from_block) {
+    const auto key = silkworm::db::block_key(from_block);
+    std::size_t num_removed{0};
+    auto txn = env_.start_write();
+    auto cursor = txn.open_cursor(map_);
+    for (auto result = cursor.lower_bound(silkworm::db::to_slice(key), /*throw_notfound=*/false); result; result = cursor.to_next(false)) {
+        cursor.erase();
+        ++num_removed;
+    }
+    txn.commit();
+    return num_removed;
+}
+
+std::optional<uint64_t> LogIndex::last_block() const {
+    auto txn = env_.start_read();
+    auto cursor = txn.open_cursor(map_);
+    const auto result = cursor.to_last(/*throw_notfound=*/false);
+    if (!result || result.key.length() != sizeof(uint64_t)) {
+        return std::nullopt;
+    }
+    return boost::endian::load_big_u64(static_cast<const uint8_t*>(result.key.data()));
+}
+
+} // namespace silkrpc::ethdb::file
@@ -0,0 +1,97 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_ETHDB_FILE_LOG_INDEX_HPP_
+#define SILKRPC_ETHDB_FILE_LOG_INDEX_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <silkworm/common/base.hpp>
+#include <silkworm/db/mdbx.hpp>
+
+#include <silkrpc/core/rawdb/accessors.hpp>
+#include <silkrpc/types/filter.hpp>
+#include <silkrpc/types/log.hpp>
+
+namespace silkrpc::ethdb::file {
+
+//! The 256-bit Bloom filter of the addresses and topics of the logs emitted by one transaction
+using LogBloom = std::array<uint8_t, 32>;
+
+//! The index entry of one transaction emitting some logs
+struct TxLogBloom {
+    uint32_t tx_index{0};
+    //! The block-wide index of the first log emitted by the transaction
+    uint32_t first_log_index{0};
+    LogBloom bloom{};
+};
+
+bool operator==(const TxLogBloom& lhs, const TxLogBloom& rhs);
+
+//! Secondary index of the logs owned by Silkrpc, i.e. for each indexed block the Bloom filters of the transactions
+//! emitting logs, persisted in its own memory-mapped MDBX environment. An indexed block without entries has no logs,
+//! whilst a missing block must be read from the TransactionLog table as usual.
+class LogIndex {
+public:
+    //! The table holding the index entries by big-endian block number
+    static constexpr const char* kTableName{"BlockLogBlooms"};
+
+    //! Open the index at the specified path, creating it if it does not exist
+    explicit LogIndex(const std::string& path);
+
+    LogIndex(const LogIndex&) = delete;
+    LogIndex& operator=(const LogIndex&) = delete;
+
+    //! Add the item (i.e. log address or topic) to the Bloom filter
+    static void add(LogBloom& bloom, silkworm::ByteView item);
+
+    //! Check if the item may be present in the Bloom filter
+    static bool may_contain(const LogBloom& bloom, silkworm::ByteView item);
+
+    //! Check if some log summarized by the Bloom filter may match the filter, ignoring the topic positions
+    static bool may_match(const LogBloom& bloom, const Filter& filter);
+
+    //! Build the index entries of one block reading its logs from the TransactionLog table
+    static boost::asio::awaitable<std::vector<TxLogBloom>> read_entries(core::rawdb::DatabaseReader& db_reader, uint64_t block_number);
+
+    //! Write the index entries of one block, replacing the existing ones if any
+    void put(uint64_t block_number, const std::vector<TxLogBloom>& entries);
+
+    //! Read the index entries of one block, if it has been indexed
+    std::optional<std::vector<TxLogBloom>> get(uint64_t block_number) const;
+
+    //! Remove the index entries of all the blocks starting from the specified one, returning the number of removed blocks
+    std::size_t unwind(uint64_t from_block);
+
+    //! Return the highest indexed block, if any
+    std::optional<uint64_t> last_block() const;
+
+private:
+    ::mdbx::env_managed env_;
+    ::mdbx::map_handle map_;
+};
+
+} // namespace silkrpc::ethdb::file
+
+#endif // SILKRPC_ETHDB_FILE_LOG_INDEX_HPP_
@@ -0,0 +1,145 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "log_index.hpp"
+
+#include <filesystem>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::ethdb::file {
+
+using evmc::literals::operator""_address, evmc::literals::operator""_bytes32;
+
+static const auto kAddress1{0x0715a7794a1dc8e42615f059dd6e406a6594651a_address};
+static const auto kAddress2{0x6677907ab33937e392b9be983b30818f29d59403_address};
+static const auto kTopic1{0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef_bytes32};
+static const auto kTopic2{0x0000000000000000000000000715a7794a1dc8e42615f059dd6e406a6594651a_bytes32};
+
+static silkworm::ByteView view_of(const evmc::address& address) { return {address.bytes, sizeof(address.bytes)}; }
+static silkworm::ByteView view_of(const evmc::bytes32& topic) { return {topic.bytes, sizeof(topic.bytes)}; }
+
+static LogBloom make_bloom(const evmc::address& address, const evmc::bytes32& topic) {
+    LogBloom bloom{};
+    LogIndex::add(bloom, view_of(address));
+    LogIndex::add(bloom, view_of(topic));
+    return bloom;
+}
+
+TEST_CASE("LogIndex::add and LogIndex::may_contain", "[silkrpc][ethdb][file][log_index]") {
+    LogBloom bloom{};
+    CHECK(!LogIndex::may_contain(bloom, view_of(kAddress1)));
+    LogIndex::add(bloom, view_of(kAddress1));
+    CHECK(LogIndex::may_contain(bloom, view_of(kAddress1)));
+    CHECK(bloom != LogBloom{});
+}
+
+TEST_CASE("LogIndex::may_match", "[silkrpc][ethdb][file][log_index]") {
+    const auto bloom = make_bloom(kAddress1, kTopic1);
+    Filter filter;
+
+    SECTION("empty filter") {
+        CHECK(LogIndex::may_match(bloom, filter));
+    }
+
+    SECTION("address") {
+        filter.addresses = FilterAddresses{kAddress1};
+        CHECK(LogIndex::may_match(bloom, filter));
+        filter.addresses = FilterAddresses{kAddress2, kAddress1};
+        CHECK(LogIndex::may_match(bloom, filter));
+        filter.addresses = FilterAddresses{};
+        CHECK(!LogIndex::may_match(bloom, filter));
+    }
+
+    SECTION("topics") {
+        filter.topics = FilterTopics{{}, {kTopic1}};
+        CHECK(LogIndex::may_match(bloom, filter));
+        filter.topics = FilterTopics{{kTopic2, kTopic1}};
+        CHECK(LogIndex::may_match(bloom, filter));
+        filter.topics = FilterTopics{{kTopic1}, {}};
+        CHECK(LogIndex::may_match(bloom, filter));
+    }
+
+    SECTION("no match") {
+        // The items are tested against the empty bloom, so that there are no false positives
+        filter.addresses = FilterAddresses{kAddress1};
+        CHECK(!LogIndex::may_match(LogBloom{}, filter));
+        filter.addresses.reset();
+        filter.topics = FilterTopics{{kTopic1}};
+        CHECK(!LogIndex::may_match(LogBloom{}, filter));
+    }
+}
+
+TEST_CASE("LogIndex storage", "[silkrpc][ethdb][file][log_index]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    const auto path = std::filesystem::temp_directory_path() / "silkrpc_log_index_test";
+    std::filesystem::remove_all(path);
+
+    const std::vector<TxLogBloom> entries{{0, 0, make_bloom(kAddress1, kTopic1)}, {3, 2, make_bloom(kAddress2, kTopic2)}};
+
+    SECTION("empty index") {
+        LogIndex log_index{path.string()};
+        CHECK(!log_index.last_block());
+        CHECK(!log_index.get(100));
+        CHECK(log_index.unwind(0) == 0);
+    }
+
+    SECTION("put and get") {
+        LogIndex log_index{path.string()};
+        log_index.put(100, entries);
+        log_index.put(101, {});
+        CHECK(log_index.get(100) == entries);
+        CHECK(log_index.get(101) == std::vector<TxLogBloom>{});
+        CHECK(!log_index.get(102));
+        CHECK(log_index.last_block() == 101);
+    }
+
+    SECTION("put replaces the entries") {
+        LogIndex log_index{path.string()};
+        log_index.put(100, entries);
+        log_index.put(100, {entries[1]});
+        CHECK(log_index.get(100) == std::vector<TxLogBloom>{entries[1]});
+    }
+
+    SECTION("unwind") {
+        LogIndex log_index{path.string()};
+        for (uint64_t block_number{100}; block_number < 105; ++block_number) {
+            log_index.put(block_number, entries);
+        }
+        CHECK(log_index.unwind(103) == 2);
+        CHECK(log_index.last_block() == 102);
+        CHECK(log_index.get(102));
+        CHECK(!log_index.get(103));
+        CHECK(log_index.unwind(200) == 0);
+    }
+
+    SECTION("reopen") {
+        {
+            LogIndex log_index{path.string()};
+            log_index.put(100, entries);
+        }
+        LogIndex log_index{path.string()};
+        CHECK(log_index.get(100) == entries);
+    }
+
+    std::filesystem::remove_all(path);
+}
+
+} // namespace silkrpc::ethdb::file
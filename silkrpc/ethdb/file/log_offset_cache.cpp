@@ -0,0 +1,50 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "log_offset_cache.hpp"
+
+#include <cstring>
+#include <utility>
+
+namespace silkrpc::ethdb::file {
+
+std::shared_ptr<const LogOffsets> LogOffsetCache::find(uint64_t block_number) {
+    auto offsets = get(key_of(block_number));
+    if (!offsets || offsets->generation != generation()) {
+        return nullptr;
+    }
+    return offsets;
+}
+
+void LogOffsetCache::store(uint64_t block_number, std::vector<TxLogBloom> entries, uint64_t read_generation) {
+    if (read_generation != generation()) {
+        return;
+    }
+    insert(key_of(block_number), std::make_shared<const LogOffsets>(LogOffsets{std::move(entries), read_generation}));
+}
+
+std::size_t LogOffsetCache::approximate_size(const LogOffsets& offsets) {
+    return sizeof(LogOffsets) + offsets.entries.size() * sizeof(TxLogBloom);
+}
+
+evmc::bytes32 LogOffsetCache::key_of(uint64_t block_number) {
+    // The shard is chosen by the key prefix, so the block number goes there to spread the consecutive blocks evenly
+    evmc::bytes32 cache_key;
+    std::memcpy(cache_key.bytes, &block_number, sizeof(block_number));
+    return cache_key;
+}
+
+} // namespace silkrpc::ethdb::file
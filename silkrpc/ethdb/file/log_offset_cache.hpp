@@ -0,0 +1,78 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_ETHDB_FILE_LOG_OFFSET_CACHE_HPP_
+#define SILKRPC_ETHDB_FILE_LOG_OFFSET_CACHE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <evmc/evmc.hpp>
+
+#include <silkrpc/common/sharded_cache.hpp>
+#include <silkrpc/ethdb/file/log_index.hpp>
+
+namespace silkrpc::ethdb::file {
+
+//! The log offset table of one block, i.e. for each transaction emitting some logs its block-wide index of the first log
+//! and the Bloom filter of its logs
+struct LogOffsets {
+    std::vector<TxLogBloom> entries;
+
+    //! The cache generation the entries have been read at
+    uint64_t generation{0};
+};
+
+//! Cache of the log offset tables of the blocks by block number, bounded by their approximate memory footprint (see
+//! ShardedCache), so that scanning the logs of a block not in the LogIndex (or w/o LogIndex at all) reads and decodes
+//! just the transactions whose logs may match, giving the absolute log indices w/o decoding the logs before them. The
+//! tables are built once per block while scanning it and the cache is invalidated after each chain reorganization,
+//! because unwinding rewrites the logs of the unwound block numbers.
+class LogOffsetCache : public ShardedCache<LogOffsets> {
+public:
+    //! The default memory budget in bytes
+    static constexpr std::size_t kDefaultMaxBytes{32 * 1024 * 1024};
+
+    explicit LogOffsetCache(std::size_t max_bytes = kDefaultMaxBytes, bool shared_cache = true, std::size_t num_shards = kDefaultNumShards)
+    : ShardedCache{&LogOffsetCache::approximate_size, max_bytes, shared_cache, num_shards} {}
+
+    //! Return the cached log offset table of the block, if any and still valid
+    std::shared_ptr<const LogOffsets> find(uint64_t block_number);
+
+    //! Store the log offset table of the block, unless the cache has been invalidated since read
+    void store(uint64_t block_number, std::vector<TxLogBloom> entries, uint64_t read_generation);
+
+    //! The current generation, to be taken before reading the logs of the tables to store
+    uint64_t generation() const { return generation_.load(std::memory_order_acquire); }
+
+    //! Invalidate all the cached tables
+    void invalidate() { generation_.fetch_add(1, std::memory_order_acq_rel); }
+
+    //! Return the approximate memory footprint of the table
+    static std::size_t approximate_size(const LogOffsets& offsets);
+
+private:
+    static evmc::bytes32 key_of(uint64_t block_number);
+
+    std::atomic<uint64_t> generation_{0};
+};
+
+} // namespace silkrpc::ethdb::file
+
+#endif // SILKRPC_ETHDB_FILE_LOG_OFFSET_CACHE_HPP_
@@ -0,0 +1,73 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "log_offset_cache.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc::ethdb::file {
+
+static std::vector<TxLogBloom> make_entries(uint32_t num_txs) {
+    std::vector<TxLogBloom> entries;
+    for (uint32_t i{0}; i < num_txs; ++i) {
+        entries.push_back(TxLogBloom{i * 2, i * 3, {}});
+    }
+    return entries;
+}
+
+TEST_CASE("LogOffsetCache find and store", "[silkrpc][ethdb][file][log_offset_cache]") {
+    LogOffsetCache cache;
+    CHECK(!cache.find(100));
+
+    SECTION("stored table found") {
+        cache.store(100, make_entries(3), cache.generation());
+        cache.store(101, {}, cache.generation());
+        const auto offsets = cache.find(100);
+        REQUIRE(offsets);
+        CHECK(offsets->entries == make_entries(3));
+        const auto empty_offsets = cache.find(101);
+        REQUIRE(empty_offsets);
+        CHECK(empty_offsets->entries.empty());
+        CHECK(!cache.find(102));
+    }
+
+    SECTION("invalidated tables not found") {
+        cache.store(100, make_entries(3), cache.generation());
+        cache.invalidate();
+        CHECK(!cache.find(100));
+    }
+
+    SECTION("table read before invalidation not stored") {
+        const auto read_generation = cache.generation();
+        cache.invalidate();
+        cache.store(100, make_entries(3), read_generation);
+        CHECK(!cache.find(100));
+        CHECK(cache.size() == 0);
+    }
+}
+
+TEST_CASE("LogOffsetCache memory budget", "[silkrpc][ethdb][file][log_offset_cache]") {
+    const auto table_size = LogOffsetCache::approximate_size(LogOffsets{make_entries(10), 0});
+    LogOffsetCache cache{4 * table_size, /*shared_cache=*/true, /*num_shards=*/1};
+    for (uint64_t block_number{0}; block_number < 8; ++block_number) {
+        cache.store(block_number, make_entries(10), cache.generation());
+    }
+    CHECK(cache.size() == 4);
+    CHECK(cache.size_bytes() <= 4 * table_size);
+    CHECK(cache.find(7));
+}
+
+} // namespace silkrpc::ethdb::file
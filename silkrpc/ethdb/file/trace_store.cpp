@@ -0,0 +1,85 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "trace_store.hpp"
+
+#include <filesystem>
+
+#include <boost/endian/conversion.hpp>
+#include <silkworm/db/util.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::ethdb::file {
+
+TraceStore::TraceStore(const std::string& path) {
+    std::filesystem::create_directories(path);
+    silkworm::db::EnvConfig config{path, /*create=*/true};
+    env_ = silkworm::db::open_env(config);
+    auto txn = env_.start_write();
+    map_ = txn.create_map(kTableName, ::mdbx::key_mode::usual, ::mdbx::value_mode::single);
+    txn.commit();
+    SILKRPC_INFO << "TraceStore opened at " << path << " last block: " << last_block().value_or(0) << "\n";
+}
+
+silkworm::Bytes TraceStore::key_of(uint64_t block_number, const evmc::bytes32& block_hash) {
+    auto key = silkworm::db::block_key(block_number);
+    key.append(block_hash.bytes, sizeof(block_hash.bytes));
+    return key;
+}
+
+void TraceStore::put(uint64_t block_number, const evmc::bytes32& block_hash, silkworm::ByteView traces) {
+    const auto key = key_of(block_number, block_hash);
+    auto txn = env_.start_write();
+    txn.upsert(map_, silkworm::db::to_slice(key), silkworm::db::to_slice(traces));
+    txn.commit();
+}
+
+std::optional<silkworm::Bytes> TraceStore::get(uint64_t block_number, const evmc::bytes32& block_hash) const {
+    const auto key = key_of(block_number, block_hash);
+    auto txn = env_.start_read();
+    const auto value = txn.get(map_, silkworm::db::to_slice(key), ::mdbx::slice::invalid());
+    if (!value.is_valid()) {
+        return std::nullopt;
+    }
+    return silkworm::Bytes{silkworm::db::from_slice(value)};
+}
+
+std::size_t TraceStore::unwind(uint64_t from_block) {
+    const auto key = silkworm::db::block_key(from_block);
+    std::size_t num_removed{0};
+    auto txn = env_.start_write();
+    auto cursor = txn.open_cursor(map_);
+    for (auto result = cursor.lower_bound(silkworm::db::to_slice(key), /*throw_notfound=*/false); result; result = cursor.to_next(false)) {
+        cursor.erase();
+        ++num_removed;
+    }
+    txn.commit();
+    return num_removed;
+}
+
+std::optional<uint64_t> TraceStore::last_block() const {
+    auto txn = env_.start_read();
+    auto cursor = txn.open_cursor(map_);
+    const auto result = cursor.to_last(/*throw_notfound=*/false);
+    if (!result || result.key.length() < sizeof(uint64_t)) {
+        return std::nullopt;
+    }
+    return boost::endian::load_big_u64(static_cast<const uint8_t*>(result.key.data()));
+}
+
+} // namespace silkrpc::ethdb::file
@@ -0,0 +1,67 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_ETHDB_FILE_TRACE_STORE_HPP_
+#define SILKRPC_ETHDB_FILE_TRACE_STORE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include <evmc/evmc.hpp>
+#include <silkworm/common/base.hpp>
+#include <silkworm/db/mdbx.hpp>
+
+namespace silkrpc::ethdb::file {
+
+//! Persistent store of the encoded traces of the replayed blocks owned by Silkrpc, held in its own memory-mapped MDBX
+//! environment and filled lazily as the blocks are traced. The key includes the block hash, so the traces stored for one
+//! block never change and a stale entry left by a reorganization is simply never found: unwinding just reclaims space.
+class TraceStore {
+public:
+    //! The table holding the encoded traces by big-endian block number plus block hash
+    static constexpr const char* kTableName{"BlockTraces"};
+
+    //! Open the store at the specified path, creating it if it does not exist
+    explicit TraceStore(const std::string& path);
+
+    TraceStore(const TraceStore&) = delete;
+    TraceStore& operator=(const TraceStore&) = delete;
+
+    //! Write the encoded traces of one block, replacing the existing ones if any
+    void put(uint64_t block_number, const evmc::bytes32& block_hash, silkworm::ByteView traces);
+
+    //! Read the encoded traces of one block, if it has been stored
+    std::optional<silkworm::Bytes> get(uint64_t block_number, const evmc::bytes32& block_hash) const;
+
+    //! Remove the traces of all the blocks starting from the specified one, returning the number of removed blocks
+    std::size_t unwind(uint64_t from_block);
+
+    //! Return the highest stored block, if any
+    std::optional<uint64_t> last_block() const;
+
+private:
+    static silkworm::Bytes key_of(uint64_t block_number, const evmc::bytes32& block_hash);
+
+    ::mdbx::env_managed env_;
+    ::mdbx::map_handle map_;
+};
+
+} // namespace silkrpc::ethdb::file
+
+#endif // SILKRPC_ETHDB_FILE_TRACE_STORE_HPP_
@@ -0,0 +1,94 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "trace_store.hpp"
+
+#include <filesystem>
+
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::ethdb::file {
+
+using evmc::literals::operator""_bytes32;
+
+static const auto kBlockHash1{0x439816753229fc0736bf86a5048de4bc9fcdede8c91dadf88c828c76b2281dff_bytes32};
+static const auto kBlockHash2{0xf4b3f95ba9a1b352e1e9bd1a9a5d0ba2e55a1b7d42d9d6e67a3da7b4a187c1dc_bytes32};
+
+TEST_CASE("TraceStore storage", "[silkrpc][ethdb][file][trace_store]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    const auto path = std::filesystem::temp_directory_path() / "silkrpc_trace_store_test";
+    std::filesystem::remove_all(path);
+
+    const silkworm::Bytes traces{0x01, 0x02, 0x03};
+    const silkworm::Bytes other_traces{0x04, 0x05};
+
+    SECTION("empty store") {
+        TraceStore trace_store{path.string()};
+        CHECK(!trace_store.last_block());
+        CHECK(!trace_store.get(100, kBlockHash1));
+        CHECK(trace_store.unwind(0) == 0);
+    }
+
+    SECTION("put and get") {
+        TraceStore trace_store{path.string()};
+        trace_store.put(100, kBlockHash1, traces);
+        trace_store.put(101, kBlockHash2, {});
+        CHECK(trace_store.get(100, kBlockHash1) == traces);
+        CHECK(trace_store.get(101, kBlockHash2) == silkworm::Bytes{});
+        CHECK(!trace_store.get(100, kBlockHash2));
+        CHECK(!trace_store.get(102, kBlockHash1));
+        CHECK(trace_store.last_block() == 101);
+    }
+
+    SECTION("blocks at the same height on different forks") {
+        TraceStore trace_store{path.string()};
+        trace_store.put(100, kBlockHash1, traces);
+        trace_store.put(100, kBlockHash2, other_traces);
+        CHECK(trace_store.get(100, kBlockHash1) == traces);
+        CHECK(trace_store.get(100, kBlockHash2) == other_traces);
+    }
+
+    SECTION("unwind") {
+        TraceStore trace_store{path.string()};
+        for (uint64_t block_number{100}; block_number < 105; ++block_number) {
+            trace_store.put(block_number, kBlockHash1, traces);
+        }
+        trace_store.put(103, kBlockHash2, other_traces);
+        CHECK(trace_store.unwind(103) == 3);
+        CHECK(trace_store.last_block() == 102);
+        CHECK(trace_store.get(102, kBlockHash1));
+        CHECK(!trace_store.get(103, kBlockHash1));
+        CHECK(!trace_store.get(103, kBlockHash2));
+        CHECK(trace_store.unwind(200) == 0);
+    }
+
+    SECTION("reopen") {
+        {
+            TraceStore trace_store{path.string()};
+            trace_store.put(100, kBlockHash1, traces);
+        }
+        TraceStore trace_store{path.string()};
+        CHECK(trace_store.get(100, kBlockHash1) == traces);
+    }
+
+    std::filesystem::remove_all(path);
+}
+
+} // namespace silkrpc::ethdb::file
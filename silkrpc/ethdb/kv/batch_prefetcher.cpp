@@ -0,0 +1,187 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "batch_prefetcher.hpp"
+
+#include <exception>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/core/blocks.hpp>
+#include <silkrpc/core/cached_chain.hpp>
+#include <silkrpc/core/rawdb/chain.hpp>
+#include <silkrpc/ethdb/kv/cached_database.hpp>
+#include <silkrpc/ethdb/transaction_database.hpp>
+#include <silkrpc/json/types.hpp>
+#include <silkrpc/types/block.hpp>
+
+namespace silkrpc::ethdb::kv {
+
+namespace {
+
+//! The methods having the block number or hash as first parameter
+const std::set<std::string> kBlockMethods{
+    "eth_getBlockByNumber", "eth_getBlockByHash", "eth_getBlockTransactionCountByNumber", "eth_getBlockTransactionCountByHash",
+    "eth_getTransactionByBlockNumberAndIndex", "eth_getTransactionByBlockHashAndIndex", "eth_getUncleCountByBlockNumber",
+    "eth_getUncleCountByBlockHash", "eth_getBlockReceipts", "trace_block", "debug_traceBlockByNumber", "debug_traceBlockByHash",
+};
+
+//! The methods having the transaction hash as first parameter
+const std::set<std::string> kTransactionMethods{
+    "eth_getTransactionByHash", "eth_getRawTransactionByHash", "eth_getTransactionReceipt", "trace_transaction", "trace_get",
+    "trace_replayTransaction", "debug_traceTransaction",
+};
+
+//! The methods having the account address as first parameter, paired with the position of the block parameter
+const std::map<std::string, std::size_t> kAccountMethods{
+    {"eth_getBalance", 1}, {"eth_getTransactionCount", 1}, {"eth_getCode", 1}, {"eth_getStorageAt", 2},
+};
+
+//! Return true if the block parameter at the specified position refers to the latest state, i.e. the cached one
+bool is_latest_block(const nlohmann::json& params, std::size_t position) {
+    if (params.size() <= position) {
+        return true;
+    }
+    if (!params[position].is_string()) {
+        return false;
+    }
+    const auto& block_id = params[position].get_ref<const std::string&>();
+    return block_id == core::kLatestBlockId || block_id == core::kPendingBlockId;
+}
+
+} // namespace
+
+void BatchPrefetchPlan::add(const nlohmann::json& request_json) {
+    if (!request_json.is_object() || !request_json.contains("method") || !request_json["method"].is_string() ||
+        !request_json.contains("params") || !request_json["params"].is_array() || request_json["params"].empty()) {
+        return;
+    }
+    const auto& method = request_json["method"].get_ref<const std::string&>();
+    const auto& params = request_json["params"];
+    try {
+        if (kBlockMethods.contains(method)) {
+            if (!params[0].is_string() && !params[0].is_number_unsigned()) {
+                return;
+            }
+            const auto block_id = params[0].get<BlockNumberOrHash>();
+            if (block_id.is_number()) {
+                block_numbers.insert(block_id.number());
+            } else if (block_id.is_hash()) {
+                block_hashes.insert(block_id.hash());
+            }
+        } else if (kTransactionMethods.contains(method)) {
+            transaction_hashes.insert(params[0].get<evmc::bytes32>());
+        } else if (const auto it = kAccountMethods.find(method); it != kAccountMethods.end()) {
+            if (is_latest_block(params, it->second)) {
+                addresses.insert(params[0].get<evmc::address>());
+            }
+        }
+    } catch (const std::exception& e) {
+        // Invalid parameters are reported by the handler, nothing to prefetch here
+        SILKRPC_DEBUG << "BatchPrefetchPlan::add method: " << method << " invalid params: " << e.what() << "\n";
+    }
+}
+
+BatchPrefetcher::BatchPrefetcher(Context& context)
+    : database_(*context.database()),
+      block_cache_(context.block_cache()),
+      header_cache_(context.header_cache()),
+      state_cache_(context.state_cache()),
+      sender_recovery_(context.sender_recovery()) {}
+
+boost::asio::awaitable<void> BatchPrefetcher::prefetch(const BatchPrefetchPlan& plan) {
+    SILKRPC_DEBUG << "BatchPrefetcher::prefetch blocks: " << plan.block_numbers.size() + plan.block_hashes.size()
+                  << " transactions: " << plan.transaction_hashes.size() << " accounts: " << plan.addresses.size() << "\n";
+
+    auto tx = co_await database_.begin();
+    try {
+        if (state_cache_ && !plan.addresses.empty()) {
+            std::vector<silkworm::Bytes> account_keys;
+            account_keys.reserve(plan.addresses.size());
+            for (const auto& address : plan.addresses) {
+                account_keys.emplace_back(address.bytes, sizeof(address.bytes));
+            }
+            CachedDatabase cached_database{BlockNumberOrHash{core::kLatestBlockId}, *tx, *state_cache_};
+            co_await cached_database.get_many(db::table::kPlainState, account_keys);
+        }
+
+        TransactionDatabase tx_database{*tx};
+
+        // The transactions already located are served by the cache, the others are looked up all at once
+        std::vector<evmc::bytes32> transaction_hashes;
+        for (const auto& transaction_hash : plan.transaction_hashes) {
+            if (!block_cache_->transaction_locations().get(transaction_hash)) {
+                transaction_hashes.push_back(transaction_hash);
+            }
+        }
+        const auto transaction_block_numbers = co_await core::rawdb::read_block_numbers_by_transaction_hashes(tx_database, transaction_hashes);
+
+        std::set<uint64_t> indexed_block_numbers;
+        for (const auto& block_number : transaction_block_numbers) {
+            if (block_number) {
+                indexed_block_numbers.insert(*block_number);
+            }
+        }
+        std::vector<uint64_t> block_numbers{plan.block_numbers.begin(), plan.block_numbers.end()};
+        for (const auto block_number : indexed_block_numbers) {
+            if (!plan.block_numbers.contains(block_number)) {
+                block_numbers.push_back(block_number);
+            }
+        }
+        if (block_numbers.size() > kMaxBatchPrefetchBlocks) {
+            block_numbers.resize(kMaxBatchPrefetchBlocks);
+        }
+        const auto block_hashes = co_await core::rawdb::read_canonical_block_hashes(tx_database, block_numbers);
+
+        std::size_t num_blocks{0};
+        const auto cache_block = [&](const std::shared_ptr<const silkworm::BlockWithHash>& block_with_hash) {
+            ++num_blocks;
+            if (header_cache_) {
+                header_cache_->insert(block_with_hash->hash, std::make_shared<const silkworm::BlockHeader>(block_with_hash->block.header));
+            }
+        };
+        for (std::size_t i{0}; i < block_numbers.size(); ++i) {
+            if (!block_hashes[i]) {
+                continue;
+            }
+            const auto block_number = block_numbers[i];
+            const auto block_with_hash = co_await core::read_block(*block_cache_, tx_database, *block_hashes[i], block_number, sender_recovery_.get());
+            cache_block(block_with_hash);
+
+            // Index the transactions of the blocks looked up by transaction hash, as the handlers do when scanning them
+            if (indexed_block_numbers.contains(block_number)) {
+                const auto hashes = block_cache_->hashes(*block_with_hash);
+                for (std::size_t idx{0}; idx < hashes->transaction_hashes.size(); ++idx) {
+                    block_cache_->transaction_locations().insert(hashes->transaction_hashes[idx],
+                        std::make_shared<const TransactionLocation>(TransactionLocation{block_number, block_with_hash->hash, idx}));
+                }
+            }
+        }
+        for (const auto& block_hash : plan.block_hashes) {
+            if (num_blocks >= kMaxBatchPrefetchBlocks) {
+                break;
+            }
+            cache_block(co_await core::read_block_by_hash(*block_cache_, tx_database, block_hash, sender_recovery_.get()));
+        }
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "BatchPrefetcher::prefetch exception: " << e.what() << "\n";
+    }
+    co_await tx->close(); // RAII not (yet) available with coroutines
+}
+
+} // namespace silkrpc::ethdb::kv
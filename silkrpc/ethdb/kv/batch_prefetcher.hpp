@@ -0,0 +1,82 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_ETHDB_KV_BATCH_PREFETCHER_HPP_
+#define SILKRPC_ETHDB_KV_BATCH_PREFETCHER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <set>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <evmc/evmc.hpp>
+#include <nlohmann/json.hpp>
+
+#include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/ethdb/database.hpp>
+
+namespace silkrpc::ethdb::kv {
+
+//! The min number of items referenced across a batch worth prefetching them
+constexpr std::size_t kMinBatchPrefetchSize{2};
+
+//! The max number of blocks prefetched for one batch, the remaining ones are read by the handlers as usual
+constexpr std::size_t kMaxBatchPrefetchBlocks{64};
+
+//! The blocks, transactions and accounts referenced by the requests of one batch
+struct BatchPrefetchPlan {
+    std::set<uint64_t> block_numbers;
+    std::set<evmc::bytes32> block_hashes;
+    std::set<evmc::bytes32> transaction_hashes;
+
+    //! The accounts whose latest state is requested
+    std::set<evmc::address> addresses;
+
+    //! Add the items referenced by the parameters of the request, if its method is known and its parameters valid
+    void add(const nlohmann::json& request_json);
+
+    bool empty() const { return size() == 0; }
+
+    std::size_t size() const { return block_numbers.size() + block_hashes.size() + transaction_hashes.size() + addresses.size(); }
+};
+
+//! Load into the caches the blocks, transactions and accounts referenced across one batch before its requests are
+//! handled, so that the handlers find them warm instead of reading them one at a time. The transaction lookups, the
+//! canonical hashes and the accounts are read in one pipelined lookup each within the same transaction.
+class BatchPrefetcher {
+public:
+    explicit BatchPrefetcher(Context& context);
+
+    BatchPrefetcher(const BatchPrefetcher&) = delete;
+    BatchPrefetcher& operator=(const BatchPrefetcher&) = delete;
+
+    //! Prefetch the items in the plan, never throws
+    boost::asio::awaitable<void> prefetch(const BatchPrefetchPlan& plan);
+
+private:
+    Database& database_;
+    std::shared_ptr<BlockCache> block_cache_;
+    std::shared_ptr<HeaderCache> header_cache_;
+    std::shared_ptr<StateCache> state_cache_;
+    std::shared_ptr<core::SenderRecovery> sender_recovery_;
+};
+
+} // namespace silkrpc::ethdb::kv
+
+#endif // SILKRPC_ETHDB_KV_BATCH_PREFETCHER_HPP_
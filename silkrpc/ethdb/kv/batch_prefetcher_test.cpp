@@ -0,0 +1,76 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "batch_prefetcher.hpp"
+
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+#include <nlohmann/json.hpp>
+
+namespace silkrpc::ethdb::kv {
+
+using evmc::literals::operator""_address, evmc::literals::operator""_bytes32;
+
+TEST_CASE("BatchPrefetchPlan::add", "[silkrpc][ethdb][kv][batch_prefetcher]") {
+    BatchPrefetchPlan plan;
+    CHECK(plan.empty());
+
+    SECTION("block number and hash") {
+        plan.add(R"({"jsonrpc":"2.0","id":1,"method":"eth_getBlockByNumber","params":["0x3d0900",false]})"_json);
+        plan.add(R"({"jsonrpc":"2.0","id":2,"method":"trace_block","params":["0x3d0900"]})"_json);
+        plan.add(R"({"jsonrpc":"2.0","id":3,"method":"eth_getBlockByHash",
+            "params":["0x439816753229fc0736bf86a5048de4bc9fcdede8c91dadf88c828c76b2281dff",true]})"_json);
+        CHECK(plan.size() == 2);
+        CHECK(plan.block_numbers == std::set<uint64_t>{4'000'000});
+        CHECK(plan.block_hashes == std::set<evmc::bytes32>{0x439816753229fc0736bf86a5048de4bc9fcdede8c91dadf88c828c76b2281dff_bytes32});
+    }
+
+    SECTION("block tag") {
+        plan.add(R"({"jsonrpc":"2.0","id":1,"method":"eth_getBlockByNumber","params":["latest",false]})"_json);
+        CHECK(plan.empty());
+    }
+
+    SECTION("transaction hash") {
+        plan.add(R"({"jsonrpc":"2.0","id":1,"method":"eth_getTransactionReceipt",
+            "params":["0x18dcb90e76b61fe6f37c9a9cd269a66188c05af5f7a62c50ff3246c6e207dc6d"]})"_json);
+        CHECK(plan.transaction_hashes == std::set<evmc::bytes32>{0x18dcb90e76b61fe6f37c9a9cd269a66188c05af5f7a62c50ff3246c6e207dc6d_bytes32});
+        CHECK(plan.size() == 1);
+    }
+
+    SECTION("account at latest block") {
+        plan.add(R"({"jsonrpc":"2.0","id":1,"method":"eth_getBalance","params":["0x0715a7794a1dc8e42615f059dd6e406a6594651a","latest"]})"_json);
+        plan.add(R"({"jsonrpc":"2.0","id":2,"method":"eth_getCode","params":["0x0715a7794a1dc8e42615f059dd6e406a6594651a"]})"_json);
+        plan.add(R"({"jsonrpc":"2.0","id":3,"method":"eth_getStorageAt",
+            "params":["0x0f572e5295c57f15886f9b263e2f6d2d6c7b5ec6","0x0","pending"]})"_json);
+        CHECK(plan.addresses == std::set<evmc::address>{0x0715a7794a1dc8e42615f059dd6e406a6594651a_address,
+            0x0f572e5295c57f15886f9b263e2f6d2d6c7b5ec6_address});
+    }
+
+    SECTION("account at historical block") {
+        plan.add(R"({"jsonrpc":"2.0","id":1,"method":"eth_getBalance","params":["0x0715a7794a1dc8e42615f059dd6e406a6594651a","0x3d0900"]})"_json);
+        CHECK(plan.empty());
+    }
+
+    SECTION("unknown method or invalid params") {
+        plan.add(R"({"jsonrpc":"2.0","id":1,"method":"eth_blockNumber","params":[]})"_json);
+        plan.add(R"({"jsonrpc":"2.0","id":2,"method":"eth_getTransactionByHash"})"_json);
+        plan.add(R"({"jsonrpc":"2.0","id":3,"method":"eth_getBalance","params":[123,"latest"]})"_json);
+        plan.add(R"({"jsonrpc":"2.0","id":4,"method":"eth_getBlockByNumber","params":[{"number":1}]})"_json);
+        CHECK(plan.empty());
+    }
+}
+
+} // namespace silkrpc::ethdb::kv
@@ -17,6 +17,7 @@
 #include "cached_database.hpp"
 
 #include <memory>
+#include <utility>
 
 #include <silkrpc/core/blocks.hpp>
 #include <silkrpc/ethdb/tables.hpp>
@@ -52,12 +53,54 @@ boost::asio::awaitable<silkworm::Bytes> CachedDatabase::get_one(const std::strin
     co_return co_await txn_database_.get_one(table, key);
 }
 
+boost::asio::awaitable<SharedByteView> CachedDatabase::get_one_shared(const std::string& table, const silkworm::ByteView& key) const {
+    // Just PlainState and Code tables are present in state cache
+    if (table == db::table::kPlainState || table == db::table::kCode) {
+        co_return co_await DatabaseReader::get_one_shared(table, key);
+    }
+
+    // Simply use transaction-based remote database as fallback
+    co_return co_await txn_database_.get_one_shared(table, key);
+}
+
+boost::asio::awaitable<std::vector<silkworm::Bytes>> CachedDatabase::get_many(const std::string& table,
+                                                                            const std::vector<silkworm::Bytes>& keys) const {
+    // Just PlainState table is looked up in state cache in one go, Code values are far less likely requested together
+    if (table == db::table::kPlainState) {
+        std::shared_ptr<kv::StateView> view = state_cache_.get_view(txn_);
+        if (view != nullptr) {
+            auto cached_values = co_await view->get_many(keys);
+            std::vector<silkworm::Bytes> values;
+            values.reserve(cached_values.size());
+            for (auto& value : cached_values) {
+                values.push_back(value ? std::move(*value) : silkworm::Bytes{});
+            }
+            co_return values;
+        }
+    } else if (table == db::table::kCode) {
+        co_return co_await DatabaseReader::get_many(table, keys);
+    }
+
+    // Simply use transaction-based remote database as fallback
+    co_return co_await txn_database_.get_many(table, keys);
+}
+
+boost::asio::awaitable<std::vector<KeyValue>> CachedDatabase::seek_many(const std::string& table,
+                                                                     const std::vector<silkworm::Bytes>& keys) const {
+    co_return co_await txn_database_.seek_many(table, keys);
+}
+
 boost::asio::awaitable<std::optional<silkworm::Bytes>> CachedDatabase::get_both_range(const std::string& table,
                                                                                       const silkworm::ByteView& key,
                                                                                       const silkworm::ByteView& subkey) const {
     co_return co_await txn_database_.get_both_range(table, key, subkey);
 }
 
+boost::asio::awaitable<std::vector<std::optional<silkworm::Bytes>>> CachedDatabase::get_both_range_many(const std::string& table,
+    const std::vector<silkworm::Bytes>& keys, const std::vector<silkworm::Bytes>& subkeys) const {
+    co_return co_await txn_database_.get_both_range_many(table, keys, subkeys);
+}
+
 boost::asio::awaitable<void> CachedDatabase::walk(const std::string& table, const silkworm::ByteView& start_key, uint32_t fixed_bits,
                                                   core::rawdb::Walker w) const {
     co_await txn_database_.walk(table, start_key, fixed_bits, w);
@@ -0,0 +1,77 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "head_prefetcher.hpp"
+
+#include <exception>
+#include <memory>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/use_future.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/core/cached_chain.hpp>
+#include <silkrpc/core/receipts.hpp>
+#include <silkrpc/ethdb/transaction_database.hpp>
+
+namespace silkrpc::ethdb::kv {
+
+HeadPrefetcher::HeadPrefetcher(Context& context)
+    : strand_{boost::asio::make_strand(*context.io_context())},
+      database_(*context.database()),
+      block_cache_(context.block_cache()),
+      receipt_cache_(context.receipt_cache()),
+      header_cache_(context.header_cache()),
+      sender_recovery_(context.sender_recovery()) {}
+
+std::future<void> HeadPrefetcher::prefetch(uint64_t block_number) {
+    latest_block_.store(block_number, std::memory_order_release);
+    return boost::asio::co_spawn(strand_, prefetch_block(block_number), boost::asio::use_future);
+}
+
+void HeadPrefetcher::on_state_changes(const remote::StateChangeBatch& state_changes) {
+    const auto& changes = state_changes.changebatch();
+    for (auto it = changes.rbegin(); it != changes.rend(); ++it) {
+        if (it->direction() == remote::Direction::FORWARD) {
+            // The future is not awaited: the prefetching runs in background and never throws
+            prefetch(it->blockheight());
+            return;
+        }
+    }
+}
+
+boost::asio::awaitable<void> HeadPrefetcher::prefetch_block(uint64_t block_number) {
+    if (block_number != latest_block_.load(std::memory_order_acquire)) {
+        SILKRPC_DEBUG << "HeadPrefetcher::prefetch_block block_number: " << block_number << " skipped\n";
+        co_return;
+    }
+    SILKRPC_DEBUG << "HeadPrefetcher::prefetch_block block_number: " << block_number << "\n";
+
+    auto tx = co_await database_.begin();
+    try {
+        TransactionDatabase tx_database{*tx};
+        const auto block_with_hash = co_await core::read_block_by_number(*block_cache_, tx_database, block_number, sender_recovery_.get());
+        if (header_cache_) {
+            header_cache_->insert(block_with_hash->hash, std::make_shared<const silkworm::BlockHeader>(block_with_hash->block.header));
+        }
+        co_await core::get_receipts(*receipt_cache_, tx_database, *block_with_hash);
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "HeadPrefetcher::prefetch_block block_number: " << block_number << " exception: " << e.what() << "\n";
+    }
+    co_await tx->close(); // RAII not (yet) available with coroutines
+}
+
+} // namespace silkrpc::ethdb::kv
@@ -0,0 +1,71 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_ETHDB_KV_HEAD_PREFETCHER_HPP_
+#define SILKRPC_ETHDB_KV_HEAD_PREFETCHER_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/ethdb/database.hpp>
+#include <silkrpc/interfaces/remote/kv.pb.h>
+
+namespace silkrpc::ethdb::kv {
+
+//! Load speculatively the head announced by the state changes into the caches, i.e. its header, body, senders and
+//! receipts, so that the burst of requests for the new head following each block hits warm caches instead of reading
+//! the same block many times at once. The heads are prefetched one at a time: any head superseded by a newer one
+//! while waiting is skipped.
+class HeadPrefetcher {
+public:
+    explicit HeadPrefetcher(Context& context);
+
+    HeadPrefetcher(const HeadPrefetcher&) = delete;
+    HeadPrefetcher& operator=(const HeadPrefetcher&) = delete;
+
+    //! Start prefetching the specified block, the returned future becomes ready when prefetched or skipped
+    std::future<void> prefetch(uint64_t block_number);
+
+    //! Start prefetching the last head announced by the state changes, if any
+    void on_state_changes(const remote::StateChangeBatch& state_changes);
+
+private:
+    boost::asio::awaitable<void> prefetch_block(uint64_t block_number);
+
+    //! The strand serializing the block prefetching
+    boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+
+    Database& database_;
+    std::shared_ptr<BlockCache> block_cache_;
+    std::shared_ptr<ReceiptCache> receipt_cache_;
+    std::shared_ptr<HeaderCache> header_cache_;
+    std::shared_ptr<core::SenderRecovery> sender_recovery_;
+
+    //! The most recent block to prefetch
+    std::atomic<uint64_t> latest_block_{0};
+};
+
+} // namespace silkrpc::ethdb::kv
+
+#endif // SILKRPC_ETHDB_KV_HEAD_PREFETCHER_HPP_
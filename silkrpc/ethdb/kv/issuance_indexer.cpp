@@ -0,0 +1,113 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "issuance_indexer.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/use_future.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/core/issuance.hpp>
+#include <silkrpc/core/rawdb/chain.hpp>
+#include <silkrpc/ethdb/transaction_database.hpp>
+
+namespace silkrpc::ethdb::kv {
+
+IssuanceIndexer::IssuanceIndexer(Context& context, std::shared_ptr<IssuanceIndex> issuance_index, uint64_t max_catch_up_blocks)
+    : strand_{boost::asio::make_strand(*context.io_context())},
+      database_(*context.database()),
+      issuance_index_(std::move(issuance_index)),
+      max_catch_up_blocks_(std::max<uint64_t>(max_catch_up_blocks, 1)) {}
+
+std::future<void> IssuanceIndexer::index(uint64_t block_number) {
+    uint64_t generation{0};
+    {
+        std::lock_guard lock{mutex_};
+        generation = generation_;
+    }
+    return boost::asio::co_spawn(strand_, index_up_to(block_number, generation), boost::asio::use_future);
+}
+
+void IssuanceIndexer::on_state_changes(const remote::StateChangeBatch& state_changes) {
+    for (const auto& state_change : state_changes.changebatch()) {
+        if (state_change.direction() == remote::Direction::UNWIND) {
+            std::lock_guard lock{mutex_};
+            ++generation_;
+            issuance_index_->truncate(state_change.blockheight());
+            SILKRPC_DEBUG << "IssuanceIndexer::on_state_changes unwind from block: " << state_change.blockheight() << "\n";
+        } else {
+            // The future is not awaited: the indexing runs in background and never throws
+            index(state_change.blockheight());
+        }
+    }
+}
+
+boost::asio::awaitable<void> IssuanceIndexer::index_up_to(uint64_t block_number, uint64_t generation) {
+    if (no_issuance_) {
+        co_return;
+    }
+    auto from_block = issuance_index_->next_block().value_or(block_number);
+    if (block_number < from_block) {
+        co_return;
+    }
+    if (block_number - from_block >= max_catch_up_blocks_) {
+        from_block = block_number - max_catch_up_blocks_ + 1;
+    }
+    SILKRPC_DEBUG << "IssuanceIndexer::index_up_to from_block: " << from_block << " to_block: " << block_number << "\n";
+
+    std::vector<BlockIssuance> issuances;
+    issuances.reserve(block_number - from_block + 1);
+    bool read_ok{false};
+    auto tx = co_await database_.begin();
+    try {
+        TransactionDatabase tx_database{*tx};
+        const auto chain_config{co_await core::rawdb::read_parsed_chain_config(tx_database)};
+        if (core::has_issuance(chain_config->chain_config)) {
+            for (auto number{from_block}; number <= block_number; ++number) {
+                issuances.push_back(co_await core::read_block_issuance(*chain_config, tx_database, number));
+            }
+            read_ok = true;
+        } else {
+            no_issuance_ = true;
+        }
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "IssuanceIndexer::index_up_to block_number: " << from_block + issuances.size() << " exception: " << e.what() << "\n";
+    }
+    co_await tx->close(); // RAII not (yet) available with coroutines
+
+    if (!read_ok) {
+        co_return;
+    }
+    std::lock_guard lock{mutex_};
+    if (generation != generation_) {
+        SILKRPC_DEBUG << "IssuanceIndexer::index_up_to block_number: " << block_number << " discarded after unwind\n";
+        co_return;
+    }
+    for (std::size_t i{0}; i < issuances.size(); ++i) {
+        if (!issuance_index_->append(from_block + i, issuances[i])) {
+            SILKRPC_ERROR << "IssuanceIndexer::index_up_to block_number: " << from_block + i << " not appended\n";
+            co_return;
+        }
+    }
+}
+
+} // namespace silkrpc::ethdb::kv
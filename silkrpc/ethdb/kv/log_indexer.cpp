@@ -0,0 +1,89 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "log_indexer.hpp"
+
+#include <exception>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/use_future.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/ethdb/transaction_database.hpp>
+
+namespace silkrpc::ethdb::kv {
+
+LogIndexer::LogIndexer(Context& context, std::shared_ptr<file::LogIndex> log_index)
+    : strand_{boost::asio::make_strand(*context.io_context())},
+      database_(*context.database()),
+      log_index_(std::move(log_index)) {}
+
+std::future<void> LogIndexer::index(uint64_t block_number) {
+    uint64_t generation{0};
+    {
+        std::lock_guard lock{mutex_};
+        generation = generation_;
+    }
+    return boost::asio::co_spawn(strand_, index_block(block_number, generation), boost::asio::use_future);
+}
+
+void LogIndexer::on_state_changes(const remote::StateChangeBatch& state_changes) {
+    for (const auto& state_change : state_changes.changebatch()) {
+        if (state_change.direction() == remote::Direction::UNWIND) {
+            std::lock_guard lock{mutex_};
+            ++generation_;
+            const auto num_removed = log_index_->unwind(state_change.blockheight());
+            SILKRPC_DEBUG << "LogIndexer::on_state_changes unwind from block: " << state_change.blockheight() << " removed: " << num_removed << "\n";
+        } else {
+            // The future is not awaited: the indexing runs in background and never throws
+            index(state_change.blockheight());
+        }
+    }
+}
+
+boost::asio::awaitable<void> LogIndexer::index_block(uint64_t block_number, uint64_t generation) {
+    SILKRPC_DEBUG << "LogIndexer::index_block block_number: " << block_number << "\n";
+
+    std::vector<file::TxLogBloom> entries;
+    bool read_ok{false};
+    auto tx = co_await database_.begin();
+    try {
+        TransactionDatabase tx_database{*tx};
+        entries = co_await file::LogIndex::read_entries(tx_database, block_number);
+        read_ok = true;
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "LogIndexer::index_block block_number: " << block_number << " exception: " << e.what() << "\n";
+    }
+    co_await tx->close(); // RAII not (yet) available with coroutines
+
+    if (!read_ok) {
+        co_return;
+    }
+    try {
+        std::lock_guard lock{mutex_};
+        if (generation != generation_) {
+            SILKRPC_DEBUG << "LogIndexer::index_block block_number: " << block_number << " discarded after unwind\n";
+            co_return;
+        }
+        log_index_->put(block_number, entries);
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "LogIndexer::index_block block_number: " << block_number << " exception: " << e.what() << "\n";
+    }
+}
+
+} // namespace silkrpc::ethdb::kv
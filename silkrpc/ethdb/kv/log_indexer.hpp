@@ -0,0 +1,70 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_ETHDB_KV_LOG_INDEXER_HPP_
+#define SILKRPC_ETHDB_KV_LOG_INDEXER_HPP_
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/ethdb/database.hpp>
+#include <silkrpc/ethdb/file/log_index.hpp>
+#include <silkrpc/interfaces/remote/kv.pb.h>
+
+namespace silkrpc::ethdb::kv {
+
+//! Build incrementally the log index from the blocks announced by the state changes: each new block is indexed within
+//! its own transaction, whilst the unwound blocks are removed immediately. The blocks are indexed one at a time and the
+//! entries read before an unwind are discarded, so that the index never contains the logs of non-canonical blocks.
+class LogIndexer {
+public:
+    explicit LogIndexer(Context& context, std::shared_ptr<file::LogIndex> log_index);
+
+    LogIndexer(const LogIndexer&) = delete;
+    LogIndexer& operator=(const LogIndexer&) = delete;
+
+    //! Start indexing the block, the returned future becomes ready when it has been indexed or discarded
+    std::future<void> index(uint64_t block_number);
+
+    //! Remove the unwound blocks from the index and start indexing the new ones
+    void on_state_changes(const remote::StateChangeBatch& state_changes);
+
+private:
+    boost::asio::awaitable<void> index_block(uint64_t block_number, uint64_t generation);
+
+    //! The strand serializing the block indexing
+    boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+
+    Database& database_;
+    std::shared_ptr<file::LogIndex> log_index_;
+
+    //! The mutex protecting the index updates and the generation, incremented at each unwind
+    std::mutex mutex_;
+    uint64_t generation_{0};
+};
+
+} // namespace silkrpc::ethdb::kv
+
+#endif // SILKRPC_ETHDB_KV_LOG_INDEXER_HPP_
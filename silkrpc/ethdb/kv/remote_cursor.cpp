@@ -16,13 +16,67 @@
 
 #include "remote_cursor.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <boost/asio/this_coro.hpp>
+
 #include <silkrpc/common/clock_time.hpp>
+#include <silkrpc/common/usdt.hpp>
+#include <silkrpc/concurrency/request_executor.hpp>
 
 namespace silkrpc::ethdb::kv {
 
+//! Start the cursor operation on the table, returning its start time
+static uint64_t begin_cursor_op([[maybe_unused]] const char* op, [[maybe_unused]] const std::string& table) {
+    SILKRPC_PROBE(cursor_op_start, table.c_str(), op);
+    return clock_time::now();
+}
+
+//! Complete the cursor operation started at the specified time: its time is accounted to the backend I/O of the request
+//! served on the executor, if profiled, and recorded as a span along with the bytes read, if traced
+static void end_cursor_op(const boost::asio::any_io_executor& executor, uint64_t start_time, const char* op, const std::string& table,
+    std::size_t bytes) {
+    SILKRPC_PROBE(cursor_op_done, table.c_str(), op, bytes, start_time);
+    if (auto* profile = request_profile_of(executor)) {
+        profile->add(RequestPhase::backend_io, std::chrono::nanoseconds{clock_time::since(start_time)});
+    }
+    if (const auto trace = trace_context_of(executor)) {
+        const std::chrono::steady_clock::time_point start{std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds{start_time})};
+        TraceSpan span{trace, "kv.cursor", start};
+        span.set_attribute("table", table);
+        span.set_attribute("op", op);
+        span.set_attribute("bytes", bytes);
+    }
+}
+
+boost::asio::awaitable<void> TxStream::settle() {
+    co_await tx_rpc_.settle_multiplexed();
+}
+
+std::optional<uint32_t> TxStream::next_cursor_id() const noexcept {
+    if (!id_prediction_ || pending_opens_ > 0) {
+        return std::nullopt;
+    }
+    return next_cursor_id_;
+}
+
+void TxStream::on_open_replied(uint32_t cursor_id) noexcept {
+    --pending_opens_;
+    next_cursor_id_ = std::max(next_cursor_id_.value_or(0), cursor_id + 1);
+}
+
 boost::asio::awaitable<void> RemoteCursor::open_cursor(const std::string& table_name, bool is_dup_sorted) {
-    const auto start_time = clock_time::now();
+    const auto start_time = begin_cursor_op("open", table_name);
     if (cursor_id_ == 0) {
+        co_await settle(/*repositioning=*/true);
+        is_dup_sorted_ = is_dup_sorted;
+        table_name_ = table_name;
         SILKRPC_DEBUG << "RemoteCursor::open_cursor opening new cursor for table: " << table_name << "\n";
         auto open_message = remote::Cursor{};
         if (is_dup_sorted) {
@@ -31,109 +85,310 @@ boost::asio::awaitable<void> RemoteCursor::open_cursor(const std::string& table_
            open_message.set_op(remote::Op::OPEN);
         }
         open_message.set_bucketname(table_name);
-        cursor_id_ = (co_await tx_rpc_.write_and_read(open_message)).cursorid();
+        if (tx_stream_ != nullptr && tx_stream_->next_cursor_id()) {
+            // The id is taken as soon as the write completes, before any other coroutine on the executor writes its OPEN
+            open_ticket_ = co_await tx_rpc_.write_multiplexed(open_message);
+            cursor_id_ = tx_stream_->take_cursor_id();
+        } else if (tx_stream_ != nullptr) {
+            // Recorded before writing, so that no other cursor takes an id until the reply tells which ones are assigned
+            tx_stream_->on_open_written();
+            const auto ticket = co_await tx_rpc_.write_multiplexed(open_message);
+            cursor_id_ = (co_await tx_rpc_.read_multiplexed(ticket)).cursorid();
+            tx_stream_->on_open_replied(cursor_id_);
+        } else {
+            cursor_id_ = (co_await tx_rpc_.call(open_message)).cursorid();
+        }
         SILKRPC_DEBUG << "RemoteCursor::open_cursor cursor: " << cursor_id_ << " for table: " << table_name << "\n";
     }
+    end_cursor_op(co_await boost::asio::this_coro::executor, start_time, "open", table_name_, 0);
     SILKRPC_DEBUG << "RemoteCursor::open_cursor [" << table_name << "] c=" << cursor_id_ << " t=" << clock_time::since(start_time) << "\n";
     co_return;
 }
 
+boost::asio::awaitable<void> RemoteCursor::confirm_open() {
+    if (!open_ticket_) {
+        co_return;
+    }
+    const auto ticket = *open_ticket_;
+    open_ticket_.reset();
+    const auto cursor_id = (co_await tx_rpc_.read_multiplexed(ticket)).cursorid();
+    if (cursor_id != cursor_id_) {
+        // The requests written so far have targeted another cursor, so their replies cannot be trusted
+        SILKRPC_ERROR << "RemoteCursor::confirm_open cursor: " << cursor_id << " expected: " << cursor_id_ << " for table: " << table_name_ << "\n";
+        tx_stream_->on_unexpected_cursor_id();
+        cursor_id_ = cursor_id;
+        throw std::runtime_error{"unexpected cursor id " + std::to_string(cursor_id) + " for table " + table_name_};
+    }
+}
+
 boost::asio::awaitable<KeyValue> RemoteCursor::seek(silkworm::ByteView key) {
-    const auto start_time = clock_time::now();
+    const auto start_time = begin_cursor_op("seek", table_name_);
+    throw_if_cancelled(co_await boost::asio::this_coro::executor);
+    co_await settle(/*repositioning=*/true);
     SILKRPC_DEBUG << "RemoteCursor::seek cursor: " << cursor_id_ << " key: " << key << "\n";
     auto seek_message = remote::Cursor{};
     seek_message.set_op(remote::Op::SEEK);
     seek_message.set_cursor(cursor_id_);
     seek_message.set_k(key.data(), key.length());
-    auto seek_pair = co_await tx_rpc_.write_and_read(seek_message);
-    const auto k = silkworm::bytes_of_string(seek_pair.k());
-    const auto v = silkworm::bytes_of_string(seek_pair.v());
+    auto seek_pair = co_await tx_rpc_.call(seek_message);
+    co_await confirm_open();
+    auto k = silkworm::bytes_of_string(seek_pair.k());
+    auto v = silkworm::bytes_of_string(seek_pair.v());
+    end_cursor_op(co_await boost::asio::this_coro::executor, start_time, "seek", table_name_, k.size() + v.size());
     SILKRPC_DEBUG << "RemoteCursor::seek k: " << k << " v: " << v << " c=" << cursor_id_ << " t=" << clock_time::since(start_time) << "\n";
-    co_return KeyValue{k, v};
+    co_return KeyValue{std::move(k), std::move(v)};
 }
 
 boost::asio::awaitable<KeyValue> RemoteCursor::seek_exact(silkworm::ByteView key) {
-    const auto start_time = clock_time::now();
+    const auto start_time = begin_cursor_op("seek_exact", table_name_);
+    throw_if_cancelled(co_await boost::asio::this_coro::executor);
+    co_await settle(/*repositioning=*/true);
     SILKRPC_DEBUG << "RemoteCursor::seek_exact cursor: " << cursor_id_ << " key: " << key << "\n";
     auto seek_message = remote::Cursor{};
     seek_message.set_op(remote::Op::SEEK_EXACT);
     seek_message.set_cursor(cursor_id_);
     seek_message.set_k(key.data(), key.length());
-    auto seek_pair = co_await tx_rpc_.write_and_read(seek_message);
-    const auto k = silkworm::bytes_of_string(seek_pair.k());
-    const auto v = silkworm::bytes_of_string(seek_pair.v());
+    auto seek_pair = co_await tx_rpc_.call(seek_message);
+    co_await confirm_open();
+    auto k = silkworm::bytes_of_string(seek_pair.k());
+    auto v = silkworm::bytes_of_string(seek_pair.v());
+    end_cursor_op(co_await boost::asio::this_coro::executor, start_time, "seek_exact", table_name_, k.size() + v.size());
     SILKRPC_DEBUG << "RemoteCursor::seek_exact k: " << k << " v: " << v << " c=" << cursor_id_ << " t=" << clock_time::since(start_time) << "\n";
-    co_return KeyValue{k, v};
+    co_return KeyValue{std::move(k), std::move(v)};
+}
+
+boost::asio::awaitable<SharedByteView> RemoteCursor::seek_exact_shared(silkworm::ByteView key) {
+    const auto start_time = begin_cursor_op("seek_exact", table_name_);
+    throw_if_cancelled(co_await boost::asio::this_coro::executor);
+    co_await settle(/*repositioning=*/true);
+    SILKRPC_DEBUG << "RemoteCursor::seek_exact_shared cursor: " << cursor_id_ << " key: " << key << "\n";
+    auto seek_message = remote::Cursor{};
+    seek_message.set_op(remote::Op::SEEK_EXACT);
+    seek_message.set_cursor(cursor_id_);
+    seek_message.set_k(key.data(), key.length());
+    // The reply is moved into the shared buffer, so the value is never copied after parsing
+    const auto seek_pair = std::make_shared<const remote::Pair>(co_await tx_rpc_.call(seek_message));
+    co_await confirm_open();
+    const auto v = silkworm::byte_view_of_string(seek_pair->v());
+    end_cursor_op(co_await boost::asio::this_coro::executor, start_time, "seek_exact", table_name_, seek_pair->k().size() + v.size());
+    SILKRPC_DEBUG << "RemoteCursor::seek_exact_shared v: " << v << " c=" << cursor_id_ << " t=" << clock_time::since(start_time) << "\n";
+    co_return SharedByteView{seek_pair, v};
+}
+
+boost::asio::awaitable<std::vector<KeyValue>> RemoteCursor::seek_exact_many(const std::vector<silkworm::Bytes>& keys) {
+    co_return co_await write_and_read_many(remote::Op::SEEK_EXACT, "seek_exact_many", keys, nullptr);
+}
+
+boost::asio::awaitable<std::vector<KeyValue>> RemoteCursor::seek_many(const std::vector<silkworm::Bytes>& keys) {
+    co_return co_await write_and_read_many(remote::Op::SEEK, "seek_many", keys, nullptr);
+}
+
+boost::asio::awaitable<std::vector<silkworm::Bytes>> RemoteCursor::seek_both_many(const std::vector<silkworm::Bytes>& keys,
+    const std::vector<silkworm::Bytes>& values) {
+    auto kv_pairs = co_await write_and_read_many(remote::Op::SEEK_BOTH, "seek_both_many", keys, &values);
+    std::vector<silkworm::Bytes> found_values;
+    found_values.reserve(kv_pairs.size());
+    for (auto& kv_pair : kv_pairs) {
+        found_values.push_back(std::move(kv_pair.value));
+    }
+    co_return found_values;
+}
+
+boost::asio::awaitable<std::vector<KeyValue>> RemoteCursor::write_and_read_many(remote::Op op, const char* op_name,
+    const std::vector<silkworm::Bytes>& keys, const std::vector<silkworm::Bytes>* values) {
+    const auto start_time = begin_cursor_op(op_name, table_name_);
+    throw_if_cancelled(co_await boost::asio::this_coro::executor);
+    co_await settle(/*repositioning=*/true);
+    SILKRPC_DEBUG << "RemoteCursor::" << op_name << " cursor: " << cursor_id_ << " keys: " << keys.size() << "\n";
+    std::vector<KeyValue> kv_pairs;
+    kv_pairs.reserve(keys.size());
+    auto seek_message = remote::Cursor{};
+    seek_message.set_op(op);
+    seek_message.set_cursor(cursor_id_);
+    std::deque<uint64_t> tickets;
+    std::size_t num_written{0};
+    std::size_t bytes{0};
+    while (kv_pairs.size() < keys.size()) {
+        // Fill the pipeline, then read the oldest reply: the replies come in the same order of the requests
+        while (num_written < keys.size() && tickets.size() < kMaxPipelinedRequests) {
+            const auto& key = keys[num_written];
+            seek_message.set_k(key.data(), key.length());
+            if (values != nullptr) {
+                const auto& value = (*values)[num_written];
+                seek_message.set_v(value.data(), value.length());
+            }
+            tickets.push_back(co_await tx_rpc_.write_multiplexed(seek_message));
+            ++num_written;
+        }
+        const auto seek_pair = co_await tx_rpc_.read_multiplexed(tickets.front());
+        tickets.pop_front();
+        kv_pairs.push_back(KeyValue{silkworm::bytes_of_string(seek_pair.k()), silkworm::bytes_of_string(seek_pair.v())});
+        bytes += kv_pairs.back().key.size() + kv_pairs.back().value.size();
+    }
+    co_await confirm_open();
+    end_cursor_op(co_await boost::asio::this_coro::executor, start_time, op_name, table_name_, bytes);
+    SILKRPC_DEBUG << "RemoteCursor::" << op_name << " keys: " << keys.size() << " c=" << cursor_id_ << " t=" << clock_time::since(start_time) << "\n";
+    co_return kv_pairs;
 }
 
 boost::asio::awaitable<KeyValue> RemoteCursor::next() {
-    const auto start_time = clock_time::now();
-    auto next_message = remote::Cursor{};
-    next_message.set_op(remote::Op::NEXT);
-    next_message.set_cursor(cursor_id_);
-    auto next_pair = co_await tx_rpc_.write_and_read(next_message);
-    const auto k = silkworm::bytes_of_string(next_pair.k());
-    const auto v = silkworm::bytes_of_string(next_pair.v());
-    SILKRPC_DEBUG << "RemoteCursor::next k: " << k << " v: " << v << " c=" << cursor_id_ << " t=" << clock_time::since(start_time) << "\n";
-    co_return KeyValue{k, v};
+    const auto kv = co_await next_view();
+    co_return KeyValue{silkworm::Bytes{kv.key}, silkworm::Bytes{kv.value}};
+}
+
+boost::asio::awaitable<KeyValueView> RemoteCursor::next_view() {
+    const auto start_time = begin_cursor_op("next", table_name_);
+    // The keys already read ahead are served anyway, just new requests to the remote are stopped by cancellation
+    if (tx_stream_ == nullptr) {
+        throw_if_cancelled(co_await boost::asio::this_coro::executor);
+        auto next_message = remote::Cursor{};
+        next_message.set_op(remote::Op::NEXT);
+        next_message.set_cursor(cursor_id_);
+        last_next_ = co_await tx_rpc_.call(next_message);
+    } else {
+        // Keep the window of keys read ahead full, but just one request is worth writing once the end of table is read:
+        // the replies to the requests of other cursors in between are kept aside by the stream
+        const auto window = end_reached_ ? 1 : read_ahead_window_;
+        if (in_flight_.size() + read_ahead_.size() < window) {
+            throw_if_cancelled(co_await boost::asio::this_coro::executor);
+            auto next_message = remote::Cursor{};
+            next_message.set_op(remote::Op::NEXT);
+            next_message.set_cursor(cursor_id_);
+            while (in_flight_.size() + read_ahead_.size() < window) {
+                in_flight_.push_back(co_await tx_rpc_.write_multiplexed(next_message));
+            }
+        }
+        read_ahead_window_ = std::min(read_ahead_window_ * 2, kMaxPipelinedRequests);
+
+        if (!read_ahead_.empty()) {
+            last_next_ = std::move(read_ahead_.front());
+            read_ahead_.pop_front();
+        } else {
+            last_next_ = co_await read_next();
+        }
+        co_await confirm_open();
+    }
+    // The returned pair refers to the reply kept as the last one, until the next operation on the cursor
+    const KeyValueView kv{silkworm::byte_view_of_string(last_next_->k()), silkworm::byte_view_of_string(last_next_->v())};
+    end_cursor_op(co_await boost::asio::this_coro::executor, start_time, "next", table_name_, kv.key.size() + kv.value.size());
+    SILKRPC_DEBUG << "RemoteCursor::next k: " << kv.key << " v: " << kv.value << " c=" << cursor_id_ << " t=" << clock_time::since(start_time) << "\n";
+    co_return kv;
 }
 
 boost::asio::awaitable<KeyValue> RemoteCursor::next_dup() {
     const auto start_time = clock_time::now();
+    throw_if_cancelled(co_await boost::asio::this_coro::executor);
+    if (tx_stream_ != nullptr) {
+        // The remote cursor is ahead of the last key returned by next if some keys have been read ahead, so bring it back
+        co_await read_in_flight();
+        const auto last_next = read_ahead_.empty() ? std::nullopt : last_next_;
+        co_await settle(/*repositioning=*/true);
+        if (last_next && !last_next->k().empty()) {
+            const auto last_key{silkworm::byte_view_of_string(last_next->k())};
+            if (is_dup_sorted_) {
+                co_await seek_both_exact(last_key, silkworm::byte_view_of_string(last_next->v()));
+            } else {
+                co_await seek_exact(last_key);
+            }
+        }
+    }
+    // The nested seeks account their own time, so just the NEXT_DUP round trip is left
+    const auto io_start_time = begin_cursor_op("next_dup", table_name_);
     auto next_message = remote::Cursor{};
     next_message.set_op(remote::Op::NEXT_DUP);
     next_message.set_cursor(cursor_id_);
-    auto next_pair = co_await tx_rpc_.write_and_read(next_message);
-    const auto k = silkworm::bytes_of_string(next_pair.k());
-    const auto v = silkworm::bytes_of_string(next_pair.v());
+    auto next_pair = co_await tx_rpc_.call(next_message);
+    co_await confirm_open();
+    auto k = silkworm::bytes_of_string(next_pair.k());
+    auto v = silkworm::bytes_of_string(next_pair.v());
+    end_cursor_op(co_await boost::asio::this_coro::executor, io_start_time, "next_dup", table_name_, k.size() + v.size());
     SILKRPC_DEBUG << "RemoteCursor::next k: " << k << " v: " << v << " c=" << cursor_id_ << " t=" << clock_time::since(start_time) << "\n";
-    co_return KeyValue{k, v};
+    co_return KeyValue{std::move(k), std::move(v)};
 }
 
 boost::asio::awaitable<silkworm::Bytes> RemoteCursor::seek_both(silkworm::ByteView key, silkworm::ByteView value) {
-    const auto start_time = clock_time::now();
+    const auto start_time = begin_cursor_op("seek_both", table_name_);
+    throw_if_cancelled(co_await boost::asio::this_coro::executor);
+    co_await settle(/*repositioning=*/true);
     SILKRPC_DEBUG << "RemoteCursor::seek_both cursor: " << cursor_id_ << " key: " << key << " subkey: " << value << "\n";
     auto seek_message = remote::Cursor{};
     seek_message.set_op(remote::Op::SEEK_BOTH);
     seek_message.set_cursor(cursor_id_);
     seek_message.set_k(key.data(), key.length());
     seek_message.set_v(value.data(), value.length());
-    auto seek_pair = co_await tx_rpc_.write_and_read(seek_message);
-    const auto k = silkworm::bytes_of_string(seek_pair.k());
-    const auto v = silkworm::bytes_of_string(seek_pair.v());
+    auto seek_pair = co_await tx_rpc_.call(seek_message);
+    co_await confirm_open();
+    auto k = silkworm::bytes_of_string(seek_pair.k());
+    auto v = silkworm::bytes_of_string(seek_pair.v());
+    end_cursor_op(co_await boost::asio::this_coro::executor, start_time, "seek_both", table_name_, k.size() + v.size());
     SILKRPC_DEBUG << "RemoteCursor::seek_both k: " << k << " v: " << v << " c=" << cursor_id_ << " t=" << clock_time::since(start_time) << "\n";
     co_return v;
 }
 
 boost::asio::awaitable<KeyValue> RemoteCursor::seek_both_exact(silkworm::ByteView key, silkworm::ByteView value) {
-    const auto start_time = clock_time::now();
+    const auto start_time = begin_cursor_op("seek_both_exact", table_name_);
+    throw_if_cancelled(co_await boost::asio::this_coro::executor);
+    co_await settle(/*repositioning=*/true);
     SILKRPC_DEBUG << "RemoteCursor::seek_both_exact cursor: " << cursor_id_ << " key: " << key << " subkey: " << value << "\n";
     auto seek_message = remote::Cursor{};
     seek_message.set_op(remote::Op::SEEK_BOTH_EXACT);
     seek_message.set_cursor(cursor_id_);
     seek_message.set_k(key.data(), key.length());
     seek_message.set_v(value.data(), value.length());
-    auto seek_pair = co_await tx_rpc_.write_and_read(seek_message);
-    const auto k = silkworm::bytes_of_string(seek_pair.k());
-    const auto v = silkworm::bytes_of_string(seek_pair.v());
+    auto seek_pair = co_await tx_rpc_.call(seek_message);
+    co_await confirm_open();
+    auto k = silkworm::bytes_of_string(seek_pair.k());
+    auto v = silkworm::bytes_of_string(seek_pair.v());
+    end_cursor_op(co_await boost::asio::this_coro::executor, start_time, "seek_both_exact", table_name_, k.size() + v.size());
     SILKRPC_DEBUG << "RemoteCursor::seek_both_exact k: " << k << " v: " << v << " c=" << cursor_id_ << " t=" << clock_time::since(start_time) << "\n";
-    co_return KeyValue{k, v};
+    co_return KeyValue{std::move(k), std::move(v)};
 }
 
 boost::asio::awaitable<void> RemoteCursor::close_cursor() {
-    const auto start_time = clock_time::now();
+    const auto start_time = begin_cursor_op("close", table_name_);
     const auto cursor_id = cursor_id_;
     if (cursor_id_ != 0) {
+        co_await settle(/*repositioning=*/true);
         SILKRPC_DEBUG << "RemoteCursor::close_cursor closing cursor: " << cursor_id_ << "\n";
         auto close_message = remote::Cursor{};
         close_message.set_op(remote::Op::CLOSE);
         close_message.set_cursor(cursor_id_);
-        co_await tx_rpc_.write_and_read(close_message);
+        co_await tx_rpc_.call(close_message);
+        co_await confirm_open();
         SILKRPC_DEBUG << "RemoteCursor::close_cursor cursor: " << cursor_id_ << "\n";
         cursor_id_ = 0;
     }
+    end_cursor_op(co_await boost::asio::this_coro::executor, start_time, "close", table_name_, 0);
     SILKRPC_DEBUG << "RemoteCursor::close_cursor c=" << cursor_id << " t=" << clock_time::since(start_time) << "\n";
     co_return;
 }
 
+boost::asio::awaitable<void> RemoteCursor::settle(bool repositioning) {
+    if (tx_stream_ == nullptr) {
+        co_return;
+    }
+    co_await read_in_flight();
+    if (repositioning) {
+        read_ahead_.clear();
+        read_ahead_window_ = 1;
+        end_reached_ = false;
+        last_next_.reset();
+    }
+}
+
+boost::asio::awaitable<void> RemoteCursor::read_in_flight() {
+    while (!in_flight_.empty()) {
+        read_ahead_.push_back(co_await read_next());
+    }
+}
+
+boost::asio::awaitable<remote::Pair> RemoteCursor::read_next() {
+    auto next_pair = co_await tx_rpc_.read_multiplexed(in_flight_.front());
+    in_flight_.pop_front();
+    if (next_pair.k().empty()) {
+        end_reached_ = true;
+    }
+    co_return next_pair;
+}
+
 } // namespace silkrpc::ethdb::kv
@@ -17,9 +17,12 @@
 #ifndef SILKRPC_ETHDB_KV_REMOTE_CURSOR_HPP_
 #define SILKRPC_ETHDB_KV_REMOTE_CURSOR_HPP_
 
+#include <deque>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <silkrpc/config.hpp>
 
@@ -35,20 +38,83 @@
 
 namespace silkrpc::ethdb::kv {
 
+//! The Tx stream shared by all the cursors of one transaction: the requests are multiplexed over the Tx RPC, so that the
+//! cursors can be used by concurrent coroutines running on the same executor and the replies to the NEXT requests written
+//! ahead by one cursor are kept aside when the replies to the requests written later by other cursors are read
+class TxStream {
+public:
+    explicit TxStream(TxRpc& tx_rpc) : tx_rpc_(tx_rpc) {}
+
+    TxRpc& rpc() noexcept { return tx_rpc_; }
+
+    //! Read the replies to the requests written ahead by any cursor, keeping them aside for such cursor
+    boost::asio::awaitable<void> settle();
+
+    //! Return the id the remote is going to assign to the next cursor opened, if known: the remote assigns increasing ids
+    //! to the cursors in the order their OPEN requests are written, so the id is known once the first one has been replied
+    //! and no other one waits for reply
+    std::optional<uint32_t> next_cursor_id() const noexcept;
+
+    //! Take the id known to be assigned to the cursor whose OPEN request has just been written w/o waiting for reply
+    uint32_t take_cursor_id() noexcept { return (*next_cursor_id_)++; }
+
+    //! Record the OPEN request about to be written to learn the id assigned by the remote from its reply
+    void on_open_written() noexcept { ++pending_opens_; }
+
+    //! Record the id assigned by the remote to the cursor opened waiting for the reply
+    void on_open_replied(uint32_t cursor_id) noexcept;
+
+    //! Stop taking the ids w/o waiting for reply, because the remote has assigned an unexpected one
+    void on_unexpected_cursor_id() noexcept { id_prediction_ = false; }
+
+private:
+    TxRpc& tx_rpc_;
+    //! The id assigned to the next cursor opened, known after the first one
+    std::optional<uint32_t> next_cursor_id_;
+    //! The number of OPEN requests waiting for the reply carrying their cursor id
+    std::size_t pending_opens_{0};
+    bool id_prediction_{true};
+};
+
 class RemoteCursor : public CursorDupSort {
 public:
+    //! The max number of requests written and not replied yet: it bounds the replies buffered by the stream flow control
+    static constexpr std::size_t kMaxPipelinedRequests{64};
+
+    //! The cursor does not read ahead, because it cannot know about the other cursors sharing the same stream
     explicit RemoteCursor(TxRpc& tx_rpc) : tx_rpc_(tx_rpc), cursor_id_{0} {}
 
+    //! The cursor reads ahead the next keys on sequential walks: the window of NEXT requests written ahead starts from one
+    //! after each repositioning and doubles at each consecutive next up to kMaxPipelinedRequests
+    explicit RemoteCursor(TxStream& tx_stream) : tx_rpc_(tx_stream.rpc()), tx_stream_(&tx_stream), cursor_id_{0} {}
+
     uint32_t cursor_id() const override { return cursor_id_; };
 
+    //! Open the remote cursor on the table: on the Tx stream, once the cursor id assigned by the remote is known the OPEN
+    //! request is just written and its reply is read along with the one to the first operation, saving one round trip
     boost::asio::awaitable<void> open_cursor(const std::string& table_name, bool is_dup_sorted) override;
 
+    //! Read the reply to the OPEN request written ahead, if any, checking the cursor id assigned by the remote
+    boost::asio::awaitable<void> confirm_open();
+
     boost::asio::awaitable<KeyValue> seek(silkworm::ByteView key) override;
 
     boost::asio::awaitable<KeyValue> seek_exact(silkworm::ByteView key) override;
 
+    //! Pipeline the seek requests over the Tx stream, keeping at most kMaxPipelinedRequests of them waiting for reply
+    boost::asio::awaitable<std::vector<KeyValue>> seek_exact_many(const std::vector<silkworm::Bytes>& keys) override;
+
+    //! Pipeline the seek requests over the Tx stream, keeping at most kMaxPipelinedRequests of them waiting for reply
+    boost::asio::awaitable<std::vector<KeyValue>> seek_many(const std::vector<silkworm::Bytes>& keys) override;
+
+    //! Return the view into the reply to the SEEK_EXACT request, which is shared w/o copying the value out of it
+    boost::asio::awaitable<SharedByteView> seek_exact_shared(silkworm::ByteView key) override;
+
     boost::asio::awaitable<KeyValue> next() override;
 
+    //! Return views into the reply to the NEXT request, which is kept until the next operation w/o copying it
+    boost::asio::awaitable<KeyValueView> next_view() override;
+
     boost::asio::awaitable<KeyValue> next_dup() override;
 
     boost::asio::awaitable<void> close_cursor() override;
@@ -57,9 +123,45 @@ public:
 
     boost::asio::awaitable<KeyValue> seek_both_exact(silkworm::ByteView key, silkworm::ByteView value) override;
 
+    //! Pipeline the seek requests over the Tx stream, keeping at most kMaxPipelinedRequests of them waiting for reply
+    boost::asio::awaitable<std::vector<silkworm::Bytes>> seek_both_many(const std::vector<silkworm::Bytes>& keys,
+        const std::vector<silkworm::Bytes>& values) override;
+
 private:
+    //! Write the requests having the specified op for each key (and value, if any), keeping at most kMaxPipelinedRequests
+    //! of them waiting for reply, and return the replies in the same order
+    boost::asio::awaitable<std::vector<KeyValue>> write_and_read_many(remote::Op op, const char* op_name,
+        const std::vector<silkworm::Bytes>& keys, const std::vector<silkworm::Bytes>* values);
+
+    //! Prepare the stream for writing a request on this cursor, dropping the keys read ahead when it is repositioned
+    boost::asio::awaitable<void> settle(bool repositioning);
+
+    //! Read the replies to the NEXT requests written ahead by this cursor, buffering them
+    boost::asio::awaitable<void> read_in_flight();
+
+    //! Read the reply to the oldest NEXT request written ahead
+    boost::asio::awaitable<remote::Pair> read_next();
+
     TxRpc& tx_rpc_;
+    TxStream* tx_stream_{nullptr};
     uint32_t cursor_id_;
+    //! The ticket of the OPEN request written ahead and not read yet, if any
+    std::optional<uint64_t> open_ticket_;
+    bool is_dup_sorted_{false};
+    //! The name of the table, just for tracing
+    std::string table_name_;
+
+    //! The replies to the NEXT requests read ahead and not consumed yet, in table order
+    std::deque<remote::Pair> read_ahead_;
+    //! The tickets of the NEXT requests written ahead and not read yet, in table order
+    std::deque<uint64_t> in_flight_;
+    //! The max number of keys read ahead at the next step
+    std::size_t read_ahead_window_{1};
+    //! Flag indicating if the end of table has been read ahead, so that no more NEXT requests are worth writing
+    bool end_reached_{false};
+    //! The reply to the last NEXT request returned by next, which the remote cursor is positioned on in absence of read
+    //! ahead: the views returned by next_view refer to it
+    std::optional<remote::Pair> last_next_;
 };
 
 } // namespace silkrpc::ethdb::kv
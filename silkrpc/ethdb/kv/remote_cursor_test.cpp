@@ -17,6 +17,8 @@
 #include "remote_cursor.hpp"
 
 #include <future>
+#include <stdexcept>
+#include <vector>
 
 #include <agrpc/test.hpp>
 #include <boost/asio/co_spawn.hpp>
@@ -69,6 +71,18 @@ struct RemoteCursorTest : test::KVTestBase {
     RemoteCursor remote_cursor_{tx_rpc_};
 };
 
+struct RemoteCursorReadAheadTest : RemoteCursorTest {
+    TxStream tx_stream_{tx_rpc_};
+    RemoteCursor read_ahead_cursor_{tx_stream_};
+};
+
+static remote::Pair make_next_pair(const std::string& key) {
+    remote::Pair next_pair;
+    next_pair.set_cursorid(3);
+    next_pair.set_k(key);
+    return next_pair;
+}
+
 TEST_CASE_METHOD(RemoteCursorTest, "RemoteCursor::open_cursor", "[silkrpc][ethdb][kv][remote_cursor]") {
     SECTION("success") {
         // Set the call expectations:
@@ -365,6 +379,149 @@ TEST_CASE_METHOD(RemoteCursorTest, "RemoteCursor::seek_exact", "[silkrpc][ethdb]
     }
 }
 
+TEST_CASE_METHOD(RemoteCursorTest, "RemoteCursor::seek_exact_shared", "[silkrpc][ethdb][kv][remote_cursor]") {
+    SECTION("success") {
+        // Set the call expectations:
+        // 1. AsyncReaderWriter<remote::Cursor, remote::Pair>::Write call to open cursor succeeds
+        Expectation open = EXPECT_CALL(reader_writer_, Write(
+                AllOf(Property(&remote::Cursor::op, Eq(remote::Op::OPEN)), Property(&remote::Cursor::bucketname, Eq("table1"))), _))
+            .WillOnce(test::write_success(grpc_context_));
+        // 2. AsyncReaderWriter<remote::Cursor, remote::Pair>::Write call to seek w/ specified cursor ID succeeds
+        Expectation seek = EXPECT_CALL(reader_writer_, Write(
+                AllOf(Property(&remote::Cursor::op, Eq(remote::Op::SEEK_EXACT)), Property(&remote::Cursor::cursor, Eq(3)),
+                    Property(&remote::Cursor::k, Eq(kPlainStateKey))), _))
+            .After(open)
+            .WillOnce(test::write_success(grpc_context_));
+        // 3. AsyncReaderWriter<remote::Cursor, remote::Pair>::Read calls succeed setting the specified cursor ID and value
+        remote::Pair open_pair;
+        open_pair.set_cursorid(3);
+        remote::Pair seek_pair;
+        seek_pair.set_cursorid(3);
+        seek_pair.set_k(kPlainStateKey);
+        seek_pair.set_v("large value");
+        EXPECT_CALL(reader_writer_, Read)
+            .WillOnce(test::read_success_with(grpc_context_, open_pair))
+            .WillOnce(test::read_success_with(grpc_context_, seek_pair));
+
+        // Execute the test preconditions: open a new cursor on specified table
+        REQUIRE_NOTHROW(spawn_and_wait(remote_cursor_.open_cursor("table1", false)));
+
+        // Execute the test: seeking a key should succeed and return the value viewed into the shared reply
+        SharedByteView value;
+        CHECK_NOTHROW(value = spawn_and_wait(remote_cursor_.seek_exact_shared(kPlainStateKeyBytes)));
+        CHECK(value.owner != nullptr);
+        CHECK(value.bytes == silkworm::bytes_of_string("large value"));
+    }
+    SECTION("failure in read") {
+        // Set the call expectations:
+        // 1. AsyncReaderWriter<remote::Cursor, remote::Pair>::Write call to open cursor succeeds
+        Expectation open = EXPECT_CALL(reader_writer_, Write(
+                AllOf(Property(&remote::Cursor::op, Eq(remote::Op::OPEN)), Property(&remote::Cursor::bucketname, Eq("table1"))), _))
+            .WillOnce(test::write_success(grpc_context_));
+        // 2. AsyncReaderWriter<remote::Cursor, remote::Pair>::Write call to seek w/ specified cursor ID succeeds
+        Expectation seek = EXPECT_CALL(reader_writer_, Write(
+                AllOf(Property(&remote::Cursor::op, Eq(remote::Op::SEEK_EXACT)), Property(&remote::Cursor::cursor, Eq(3)),
+                    Property(&remote::Cursor::k, Eq(kPlainStateKey))), _))
+            .After(open)
+            .WillOnce(test::write_success(grpc_context_));
+        // 3. AsyncReaderWriter<remote::Cursor, remote::Pair>::Read 1st call succeeds setting the specified cursor ID, 2nd fails
+        remote::Pair open_pair;
+        open_pair.set_cursorid(3);
+        EXPECT_CALL(reader_writer_, Read)
+            .WillOnce(test::read_success_with(grpc_context_, open_pair))
+            .WillOnce(test::read_failure(grpc_context_));
+        // 4. AsyncReaderWriter<remote::Cursor, remote::Pair>::Finish call succeeds w/ status cancelled
+        EXPECT_CALL(reader_writer_, Finish).WillOnce(test::finish_streaming_cancelled(grpc_context_));
+
+        // Execute the test preconditions: open a new cursor on specified table
+        REQUIRE_NOTHROW(spawn_and_wait(remote_cursor_.open_cursor("table1", false)));
+
+        // Execute the test: seeking a key should raise an exception w/ expected gRPC status code
+        CHECK_THROWS_MATCHES(spawn_and_wait(remote_cursor_.seek_exact_shared(kPlainStateKeyBytes)), boost::system::system_error,
+            test::exception_has_cancelled_grpc_status_code());
+    }
+}
+
+TEST_CASE_METHOD(RemoteCursorTest, "RemoteCursor::seek_exact_many", "[silkrpc][ethdb][kv][remote_cursor]") {
+    SECTION("no keys") {
+        // Execute the test: seeking no key should succeed w/o any call and return no pair
+        std::vector<KeyValue> kvs;
+        CHECK_NOTHROW(kvs = spawn_and_wait(remote_cursor_.seek_exact_many({})));
+        CHECK(kvs.empty());
+    }
+    SECTION("success") {
+        // Set the call expectations:
+        // 1. AsyncReaderWriter<remote::Cursor, remote::Pair>::Write call to open cursor succeeds
+        Expectation open = EXPECT_CALL(reader_writer_, Write(
+                AllOf(Property(&remote::Cursor::op, Eq(remote::Op::OPEN)), Property(&remote::Cursor::bucketname, Eq("table1"))), _))
+            .WillOnce(test::write_success(grpc_context_));
+        // 2. AsyncReaderWriter<remote::Cursor, remote::Pair>::Write calls to seek both keys are pipelined before any read
+        Expectation seek1 = EXPECT_CALL(reader_writer_, Write(
+                AllOf(Property(&remote::Cursor::op, Eq(remote::Op::SEEK_EXACT)), Property(&remote::Cursor::cursor, Eq(3)),
+                    Property(&remote::Cursor::k, Eq(kPlainStateKey))), _))
+            .After(open)
+            .WillOnce(test::write_success(grpc_context_));
+        Expectation seek2 = EXPECT_CALL(reader_writer_, Write(
+                AllOf(Property(&remote::Cursor::op, Eq(remote::Op::SEEK_EXACT)), Property(&remote::Cursor::cursor, Eq(3)),
+                    Property(&remote::Cursor::k, Eq(kAccountChangeSetKey))), _))
+            .After(seek1)
+            .WillOnce(test::write_success(grpc_context_));
+        // 3. AsyncReaderWriter<remote::Cursor, remote::Pair>::Read calls succeed returning the pairs in request order
+        remote::Pair open_pair;
+        open_pair.set_cursorid(3);
+        remote::Pair seek_pair1;
+        seek_pair1.set_k(kPlainStateKey);
+        remote::Pair seek_pair2;
+        seek_pair2.set_k(kAccountChangeSetKey);
+        seek_pair2.set_v(kAccountChangeSetValue);
+        EXPECT_CALL(reader_writer_, Read)
+            .WillOnce(test::read_success_with(grpc_context_, open_pair))
+            .WillOnce(test::read_success_with(grpc_context_, seek_pair1))
+            .WillOnce(test::read_success_with(grpc_context_, seek_pair2));
+
+        // Execute the test preconditions: open a new cursor on specified table
+        REQUIRE_NOTHROW(spawn_and_wait(remote_cursor_.open_cursor("table1", false)));
+
+        // Execute the test: seeking the keys should succeed and return the expected pairs in the same order
+        std::vector<KeyValue> kvs;
+        CHECK_NOTHROW(kvs = spawn_and_wait(remote_cursor_.seek_exact_many({kPlainStateKeyBytes, kAccountChangeSetKeyBytes})));
+        CHECK(kvs.size() == 2);
+        if (kvs.size() == 2) {
+            CHECK(kvs[0].key == kPlainStateKeyBytes);
+            CHECK(kvs[0].value == kPlainStateValueBytes);
+            CHECK(kvs[1].key == kAccountChangeSetKeyBytes);
+            CHECK(kvs[1].value == kAccountChangeSetValueBytes);
+        }
+    }
+    SECTION("failure in read") {
+        // Set the call expectations:
+        // 1. AsyncReaderWriter<remote::Cursor, remote::Pair>::Write call to open cursor succeeds
+        Expectation open = EXPECT_CALL(reader_writer_, Write(
+                AllOf(Property(&remote::Cursor::op, Eq(remote::Op::OPEN)), Property(&remote::Cursor::bucketname, Eq("table1"))), _))
+            .WillOnce(test::write_success(grpc_context_));
+        // 2. AsyncReaderWriter<remote::Cursor, remote::Pair>::Write call to seek w/ specified cursor ID succeeds
+        EXPECT_CALL(reader_writer_, Write(
+                AllOf(Property(&remote::Cursor::op, Eq(remote::Op::SEEK_EXACT)), Property(&remote::Cursor::cursor, Eq(3))), _))
+            .After(open)
+            .WillOnce(test::write_success(grpc_context_));
+        // 3. AsyncReaderWriter<remote::Cursor, remote::Pair>::Read 1st call succeeds setting the specified cursor ID, 2nd fails
+        remote::Pair open_pair;
+        open_pair.set_cursorid(3);
+        EXPECT_CALL(reader_writer_, Read)
+            .WillOnce(test::read_success_with(grpc_context_, open_pair))
+            .WillOnce(test::read_failure(grpc_context_));
+        // 4. AsyncReaderWriter<remote::Cursor, remote::Pair>::Finish call succeeds w/ status cancelled
+        EXPECT_CALL(reader_writer_, Finish).WillOnce(test::finish_streaming_cancelled(grpc_context_));
+
+        // Execute the test preconditions: open a new cursor on specified table
+        REQUIRE_NOTHROW(spawn_and_wait(remote_cursor_.open_cursor("table1", false)));
+
+        // Execute the test: seeking the keys should raise an exception w/ expected gRPC status code
+        CHECK_THROWS_MATCHES(spawn_and_wait(remote_cursor_.seek_exact_many({kPlainStateKeyBytes})), boost::system::system_error,
+            test::exception_has_cancelled_grpc_status_code());
+    }
+}
+
 TEST_CASE_METHOD(RemoteCursorTest, "RemoteCursor::next", "[silkrpc][ethdb][kv][remote_cursor]") {
     SECTION("success") {
         // Set the call expectations:
@@ -716,4 +873,213 @@ TEST_CASE_METHOD(RemoteCursorTest, "RemoteCursor::seek_both_exact", "[silkrpc][e
     }
 }
 
+TEST_CASE_METHOD(RemoteCursorReadAheadTest, "RemoteCursor::next with read ahead", "[silkrpc][ethdb][kv][remote_cursor]") {
+    // Set the call expectations:
+    // 1. AsyncReaderWriter<remote::Cursor, remote::Pair>::Write call to open cursor succeeds
+    Expectation open = EXPECT_CALL(reader_writer_, Write(
+            AllOf(Property(&remote::Cursor::op, Eq(remote::Op::OPEN)), Property(&remote::Cursor::bucketname, Eq("table1"))), _))
+        .WillOnce(test::write_success(grpc_context_));
+    // 2. AsyncReaderWriter<remote::Cursor, remote::Pair>::Write calls to seek next succeed for a window of 1, 2 and 4 keys
+    Expectation next = EXPECT_CALL(reader_writer_, Write(
+            AllOf(Property(&remote::Cursor::op, Eq(remote::Op::NEXT)), Property(&remote::Cursor::cursor, Eq(3))), _))
+        .Times(6)
+        .After(open)
+        .WillRepeatedly(test::write_success(grpc_context_));
+    // 3. AsyncReaderWriter<remote::Cursor, remote::Pair>::Write call to seek w/ specified cursor ID succeeds
+    EXPECT_CALL(reader_writer_, Write(
+            AllOf(Property(&remote::Cursor::op, Eq(remote::Op::SEEK)), Property(&remote::Cursor::cursor, Eq(3))), _))
+        .After(next)
+        .WillOnce(test::write_success(grpc_context_));
+    // 4. AsyncReaderWriter<remote::Cursor, remote::Pair>::Read calls succeed in request order
+    remote::Pair open_pair;
+    open_pair.set_cursorid(3);
+    EXPECT_CALL(reader_writer_, Read)
+        .WillOnce(test::read_success_with(grpc_context_, open_pair))
+        .WillOnce(test::read_success_with(grpc_context_, make_next_pair("k1")))
+        .WillOnce(test::read_success_with(grpc_context_, make_next_pair("k2")))
+        .WillOnce(test::read_success_with(grpc_context_, make_next_pair("k3")))
+        .WillOnce(test::read_success_with(grpc_context_, make_next_pair("k4")))
+        .WillOnce(test::read_success_with(grpc_context_, make_next_pair("k5")))
+        .WillOnce(test::read_success_with(grpc_context_, make_next_pair("k6")))
+        .WillOnce(test::read_success_with(grpc_context_, make_next_pair("k0")));
+
+    // Execute the test preconditions: open a new cursor on specified table
+    REQUIRE_NOTHROW(spawn_and_wait(read_ahead_cursor_.open_cursor("table1", false)));
+
+    // Execute the test: consecutive keys are returned in order while the window grows
+    KeyValue kv;
+    for (const auto* key : {"k1", "k2", "k3"}) {
+        CHECK_NOTHROW(kv = spawn_and_wait(read_ahead_cursor_.next()));
+        CHECK(kv.key == silkworm::bytes_of_string(key));
+    }
+
+    // Execute the test: seeking collects the replies read ahead before writing the seek request
+    CHECK_NOTHROW(kv = spawn_and_wait(read_ahead_cursor_.seek(silkworm::bytes_of_string("k0"))));
+    CHECK(kv.key == silkworm::bytes_of_string("k0"));
+}
+
+TEST_CASE_METHOD(RemoteCursorReadAheadTest, "RemoteCursor::next_view with read ahead", "[silkrpc][ethdb][kv][remote_cursor]") {
+    // Set the call expectations:
+    // 1. AsyncReaderWriter<remote::Cursor, remote::Pair>::Write call to open cursor succeeds
+    Expectation open = EXPECT_CALL(reader_writer_, Write(
+            AllOf(Property(&remote::Cursor::op, Eq(remote::Op::OPEN)), Property(&remote::Cursor::bucketname, Eq("table1"))), _))
+        .WillOnce(test::write_success(grpc_context_));
+    // 2. AsyncReaderWriter<remote::Cursor, remote::Pair>::Write calls to seek next succeed for a window of 1 and 2 keys
+    EXPECT_CALL(reader_writer_, Write(
+            AllOf(Property(&remote::Cursor::op, Eq(remote::Op::NEXT)), Property(&remote::Cursor::cursor, Eq(3))), _))
+        .Times(3)
+        .After(open)
+        .WillRepeatedly(test::write_success(grpc_context_));
+    // 3. AsyncReaderWriter<remote::Cursor, remote::Pair>::Read calls succeed in request order
+    remote::Pair open_pair;
+    open_pair.set_cursorid(3);
+    auto next_pair = make_next_pair("k2");
+    next_pair.set_v("v2");
+    EXPECT_CALL(reader_writer_, Read)
+        .WillOnce(test::read_success_with(grpc_context_, open_pair))
+        .WillOnce(test::read_success_with(grpc_context_, make_next_pair("k1")))
+        .WillOnce(test::read_success_with(grpc_context_, next_pair))
+        .WillOnce(test::read_success_with(grpc_context_, make_next_pair("k3")));
+
+    // Execute the test preconditions: open a new cursor on specified table
+    REQUIRE_NOTHROW(spawn_and_wait(read_ahead_cursor_.open_cursor("table1", false)));
+
+    // Execute the test: the views refer to the replies, both those read on demand and those read ahead
+    KeyValueView kv;
+    CHECK_NOTHROW(kv = spawn_and_wait(read_ahead_cursor_.next_view()));
+    CHECK(kv.key == silkworm::byte_view_of_string("k1"));
+    CHECK(kv.value.empty());
+    CHECK_NOTHROW(kv = spawn_and_wait(read_ahead_cursor_.next_view()));
+    CHECK(kv.key == silkworm::byte_view_of_string("k2"));
+    CHECK(kv.value == silkworm::byte_view_of_string("v2"));
+
+    // Execute the test: the key read ahead is returned as owned by next
+    KeyValue owned_kv;
+    CHECK_NOTHROW(owned_kv = spawn_and_wait(read_ahead_cursor_.next()));
+    CHECK(owned_kv.key == silkworm::bytes_of_string("k3"));
+}
+
+TEST_CASE_METHOD(RemoteCursorReadAheadTest, "RemoteCursor::open_cursor pipelined with the first seek", "[silkrpc][ethdb][kv][remote_cursor]") {
+    RemoteCursor other_cursor{tx_stream_};
+
+    // Set the call expectations:
+    // 1. AsyncReaderWriter<remote::Cursor, remote::Pair>::Write calls to open both cursors succeed
+    Expectation open = EXPECT_CALL(reader_writer_, Write(Property(&remote::Cursor::op, Eq(remote::Op::OPEN)), _))
+        .Times(2)
+        .WillRepeatedly(test::write_success(grpc_context_));
+    // 2. AsyncReaderWriter<remote::Cursor, remote::Pair>::Write call to seek w/ the cursor ID following the first one succeeds
+    EXPECT_CALL(reader_writer_, Write(
+            AllOf(Property(&remote::Cursor::op, Eq(remote::Op::SEEK)), Property(&remote::Cursor::cursor, Eq(4))), _))
+        .After(open)
+        .WillOnce(test::write_success(grpc_context_));
+
+    remote::Pair open_pair;
+    open_pair.set_cursorid(3);
+    remote::Pair other_open_pair;
+
+    SECTION("cursor ID assigned as expected") {
+        // 3. AsyncReaderWriter<remote::Cursor, remote::Pair>::Read calls succeed in request order
+        other_open_pair.set_cursorid(4);
+        EXPECT_CALL(reader_writer_, Read)
+            .WillOnce(test::read_success_with(grpc_context_, open_pair))
+            .WillOnce(test::read_success_with(grpc_context_, other_open_pair))
+            .WillOnce(test::read_success_with(grpc_context_, make_next_pair("k1")));
+
+        // Execute the test preconditions: open the first cursor waiting for its ID
+        REQUIRE_NOTHROW(spawn_and_wait(read_ahead_cursor_.open_cursor("table1", false)));
+        CHECK(read_ahead_cursor_.cursor_id() == 3);
+
+        // Execute the test: the second cursor takes the next ID w/o waiting for the reply, then seeks on it
+        CHECK_NOTHROW(spawn_and_wait(other_cursor.open_cursor("table2", false)));
+        CHECK(other_cursor.cursor_id() == 4);
+        KeyValue kv;
+        CHECK_NOTHROW(kv = spawn_and_wait(other_cursor.seek(silkworm::bytes_of_string("k1"))));
+        CHECK(kv.key == silkworm::bytes_of_string("k1"));
+    }
+
+    SECTION("unexpected cursor ID assigned") {
+        // 3. AsyncReaderWriter<remote::Cursor, remote::Pair>::Read calls succeed in request order
+        other_open_pair.set_cursorid(5);
+        EXPECT_CALL(reader_writer_, Read)
+            .WillOnce(test::read_success_with(grpc_context_, open_pair))
+            .WillOnce(test::read_success_with(grpc_context_, other_open_pair))
+            .WillOnce(test::read_success_with(grpc_context_, make_next_pair("k1")));
+
+        // Execute the test preconditions: open the first cursor waiting for its ID
+        REQUIRE_NOTHROW(spawn_and_wait(read_ahead_cursor_.open_cursor("table1", false)));
+
+        // Execute the test: the seek fails and the cursor gets the ID assigned, the next cursors waiting for theirs
+        CHECK_NOTHROW(spawn_and_wait(other_cursor.open_cursor("table2", false)));
+        CHECK_THROWS_AS(spawn_and_wait(other_cursor.seek(silkworm::bytes_of_string("k1"))), std::runtime_error);
+        CHECK(other_cursor.cursor_id() == 5);
+        CHECK(!tx_stream_.next_cursor_id());
+    }
+}
+
+TEST_CASE_METHOD(RemoteCursorReadAheadTest, "RemoteCursor::seek on concurrent cursors", "[silkrpc][ethdb][kv][remote_cursor]") {
+    RemoteCursor other_cursor{tx_stream_};
+
+    // Set the call expectations:
+    // 1. AsyncReaderWriter<remote::Cursor, remote::Pair>::Write calls to seek on both cursors succeed
+    EXPECT_CALL(reader_writer_, Write(
+            AllOf(Property(&remote::Cursor::op, Eq(remote::Op::SEEK)), Property(&remote::Cursor::k, Eq("k1"))), _))
+        .WillOnce(test::write_success(grpc_context_));
+    EXPECT_CALL(reader_writer_, Write(
+            AllOf(Property(&remote::Cursor::op, Eq(remote::Op::SEEK)), Property(&remote::Cursor::k, Eq("k2"))), _))
+        .WillOnce(test::write_success(grpc_context_));
+    // 2. AsyncReaderWriter<remote::Cursor, remote::Pair>::Read calls succeed in request order
+    EXPECT_CALL(reader_writer_, Read)
+        .WillOnce(test::read_success_with(grpc_context_, make_next_pair("k1")))
+        .WillOnce(test::read_success_with(grpc_context_, make_next_pair("k2")));
+
+    // Execute the test: the seeks spawned concurrently on the same stream get their own replies
+    const auto key1{silkworm::bytes_of_string("k1")};
+    const auto key2{silkworm::bytes_of_string("k2")};
+    auto seek1 = spawn(read_ahead_cursor_.seek(key1));
+    auto seek2 = spawn(other_cursor.seek(key2));
+    CHECK(seek1.get().key == key1);
+    CHECK(seek2.get().key == key2);
+}
+
+TEST_CASE_METHOD(RemoteCursorReadAheadTest, "RemoteCursor::next with read ahead kept aside", "[silkrpc][ethdb][kv][remote_cursor]") {
+    RemoteCursor other_cursor{tx_stream_};
+
+    // Set the call expectations:
+    // 1. AsyncReaderWriter<remote::Cursor, remote::Pair>::Write calls to seek next succeed for a window of 1 and 2 keys
+    Expectation next = EXPECT_CALL(reader_writer_, Write(Property(&remote::Cursor::op, Eq(remote::Op::NEXT)), _))
+        .Times(3)
+        .WillRepeatedly(test::write_success(grpc_context_));
+    // 2. AsyncReaderWriter<remote::Cursor, remote::Pair>::Write call to seek on the other cursor succeeds
+    EXPECT_CALL(reader_writer_, Write(Property(&remote::Cursor::op, Eq(remote::Op::SEEK)), _))
+        .After(next)
+        .WillOnce(test::write_success(grpc_context_));
+    // 3. AsyncReaderWriter<remote::Cursor, remote::Pair>::Read calls succeed in request order
+    EXPECT_CALL(reader_writer_, Read)
+        .WillOnce(test::read_success_with(grpc_context_, make_next_pair("k1")))
+        .WillOnce(test::read_success_with(grpc_context_, make_next_pair("k2")))
+        .WillOnce(test::read_success_with(grpc_context_, make_next_pair("k3")))
+        .WillOnce(test::read_success_with(grpc_context_, make_next_pair("s1")));
+
+    // Execute the test: the seek on the other cursor gets its reply, that of the NEXT written ahead is kept aside
+    KeyValue kv;
+    CHECK_NOTHROW(kv = spawn_and_wait(read_ahead_cursor_.next()));
+    CHECK(kv.key == silkworm::bytes_of_string("k1"));
+    CHECK_NOTHROW(kv = spawn_and_wait(read_ahead_cursor_.next()));
+    CHECK(kv.key == silkworm::bytes_of_string("k2"));
+    const auto seek_key{silkworm::bytes_of_string("s1")};
+    CHECK_NOTHROW(kv = spawn_and_wait(other_cursor.seek(seek_key)));
+    CHECK(kv.key == silkworm::bytes_of_string("s1"));
+    CHECK(tx_rpc_.is_reusable());
+
+    // Execute the test: the reply kept aside is returned by the next step, settling keeps aside those written meanwhile
+    EXPECT_CALL(reader_writer_, Write(Property(&remote::Cursor::op, Eq(remote::Op::NEXT)), _))
+        .WillRepeatedly(test::write_success(grpc_context_));
+    EXPECT_CALL(reader_writer_, Read)
+        .WillRepeatedly(test::read_success_with(grpc_context_, make_next_pair("")));
+    CHECK_NOTHROW(kv = spawn_and_wait(read_ahead_cursor_.next()));
+    CHECK(kv.key == silkworm::bytes_of_string("k3"));
+    CHECK_NOTHROW(spawn_and_wait(tx_stream_.settle()));
+    CHECK(tx_rpc_.is_reusable());
+}
+
 } // namespace silkrpc::ethdb::kv
@@ -16,31 +16,317 @@
 
 #include "remote_database.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <optional>
+#include <string>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+
 #include <silkrpc/common/log.hpp>
-#include <silkrpc/ethdb/kv/remote_transaction.hpp>
+#include <silkrpc/ethdb/batch_transaction.hpp>
 
 namespace silkrpc::ethdb::kv {
 
-RemoteDatabase::RemoteDatabase(agrpc::GrpcContext& grpc_context, std::shared_ptr<grpc::Channel> channel)
-    : grpc_context_(grpc_context), stub_{remote::KV::NewStub(channel)} {
-    SILKRPC_TRACE << "RemoteDatabase::ctor " << this << "\n";
+namespace {
+
+//! The latency added to the measured one when scoring the backends, so that the leased transactions count even if fast
+constexpr int64_t kMinScoredLatency{100};
+
+//! The weight of the new latency sample in the moving average, as a divisor
+constexpr int64_t kLatencyAverageDivisor{8};
+
+int64_t now_microseconds() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+//! The transaction leased from the pool, given back to the pool instead of being closed
+class RemoteDatabase::LeasedTransaction : public Transaction {
+public:
+    LeasedTransaction(RemoteDatabase& database, IdleTransaction idle_txn)
+        : database_(database), idle_txn_(std::move(idle_txn)), tx_id_(idle_txn_.view_id) {}
+
+    uint64_t tx_id() const override { return tx_id_; }
+
+    //! The leased transaction is already open
+    boost::asio::awaitable<void> open() override { co_return; }
+
+    boost::asio::awaitable<std::shared_ptr<Cursor>> cursor(const std::string& table) override {
+        co_return co_await idle_txn_.txn->cursor(table);
+    }
+
+    boost::asio::awaitable<std::shared_ptr<CursorDupSort>> cursor_dup_sort(const std::string& table) override {
+        co_return co_await idle_txn_.txn->cursor_dup_sort(table);
+    }
+
+    boost::asio::awaitable<std::shared_ptr<Cursor>> new_cursor(const std::string& table) override {
+        co_return co_await idle_txn_.txn->new_cursor(table);
+    }
+
+    boost::asio::awaitable<std::shared_ptr<CursorDupSort>> new_cursor_dup_sort(const std::string& table) override {
+        co_return co_await idle_txn_.txn->new_cursor_dup_sort(table);
+    }
+
+    boost::asio::awaitable<void> close() override {
+        if (idle_txn_.txn) {
+            co_await database_.release(std::move(idle_txn_));
+        }
+    }
+
+private:
+    RemoteDatabase& database_;
+    IdleTransaction idle_txn_;
+    const uint64_t tx_id_;
+};
+
+remote::KV::StubInterface& RemoteDatabase::Backend::next_stub() {
+    return *stubs[next_stub_index++ % stubs.size()];
+}
+
+bool RemoteDatabase::Backend::is_healthy(int64_t now) const {
+    return failure_count == 0 || now >= retry_time;
+}
+
+int64_t RemoteDatabase::Backend::score() const {
+    return (open_latency + kMinScoredLatency) * (leased_count + 1);
+}
+
+RemoteDatabase::RemoteDatabase(agrpc::GrpcContext& grpc_context, std::shared_ptr<grpc::Channel> channel, std::size_t max_idle_transactions)
+    : RemoteDatabase(grpc_context, std::vector<std::shared_ptr<grpc::Channel>>{channel}, max_idle_transactions) {
+}
+
+RemoteDatabase::RemoteDatabase(agrpc::GrpcContext& grpc_context, const std::vector<std::shared_ptr<grpc::Channel>>& channels,
+    std::size_t max_idle_transactions)
+    : RemoteDatabase(grpc_context, std::vector<std::vector<std::shared_ptr<grpc::Channel>>>{channels}, max_idle_transactions) {
 }
 
-RemoteDatabase::RemoteDatabase(agrpc::GrpcContext& grpc_context, std::unique_ptr<remote::KV::StubInterface>&& stub)
-    : grpc_context_(grpc_context), stub_(std::move(stub)) {
+RemoteDatabase::RemoteDatabase(agrpc::GrpcContext& grpc_context,
+    const std::vector<std::vector<std::shared_ptr<grpc::Channel>>>& backend_channels, std::size_t max_idle_transactions)
+    : grpc_context_(grpc_context), max_idle_transactions_(max_idle_transactions) {
+    backends_.reserve(backend_channels.size());
+    for (const auto& channels : backend_channels) {
+        auto backend = std::make_unique<Backend>();
+        backend->stubs.reserve(channels.size());
+        for (const auto& channel : channels) {
+            backend->stubs.emplace_back(remote::KV::NewStub(channel));
+        }
+        backends_.push_back(std::move(backend));
+    }
+    SILKRPC_TRACE << "RemoteDatabase::ctor " << this << " backends: " << backends_.size() << "\n";
+}
+
+RemoteDatabase::RemoteDatabase(agrpc::GrpcContext& grpc_context, std::unique_ptr<remote::KV::StubInterface>&& stub,
+    std::size_t max_idle_transactions)
+    : grpc_context_(grpc_context), max_idle_transactions_(max_idle_transactions) {
+    backends_.push_back(std::make_unique<Backend>());
+    backends_.back()->stubs.emplace_back(std::move(stub));
     SILKRPC_TRACE << "RemoteDatabase::ctor " << this << "\n";
 }
 
+RemoteDatabase::RemoteDatabase(agrpc::GrpcContext& grpc_context, std::vector<std::unique_ptr<remote::KV::StubInterface>>&& backend_stubs,
+    std::size_t max_idle_transactions)
+    : grpc_context_(grpc_context), max_idle_transactions_(max_idle_transactions) {
+    for (auto& stub : backend_stubs) {
+        backends_.push_back(std::make_unique<Backend>());
+        backends_.back()->stubs.emplace_back(std::move(stub));
+    }
+    SILKRPC_TRACE << "RemoteDatabase::ctor " << this << " backends: " << backends_.size() << "\n";
+}
+
 RemoteDatabase::~RemoteDatabase() {
     SILKRPC_TRACE << "RemoteDatabase::dtor " << this << "\n";
 }
 
 boost::asio::awaitable<std::unique_ptr<Transaction>> RemoteDatabase::begin() {
     SILKRPC_TRACE << "RemoteDatabase::begin " << this << " start\n";
-    auto txn = std::make_unique<RemoteTransaction>(*stub_, grpc_context_);
-    co_await txn->open();
-    SILKRPC_TRACE << "RemoteDatabase::begin " << this << " txn: " << txn.get() << " end\n";
+    // The requests of one batch share its transaction, so that all of them read the same view w/o leasing their own
+    if (auto batch_txn = co_await lease_batch_transaction(*this)) {
+        co_return batch_txn;
+    }
+    if (max_idle_transactions_ == 0 && backends_.size() == 1) {
+        auto idle_txn = co_await open_on_best_backend();
+        auto txn = std::move(idle_txn.txn);
+        txn->set_chain_head_cache(chain_head_cache_.get());
+        txn->set_snapshots(snapshots_.get());
+        txn->set_read_combiner(read_combiner_.get());
+        SILKRPC_TRACE << "RemoteDatabase::begin " << this << " txn: " << txn.get() << " end\n";
+        co_return txn;
+    }
+
+    // Lease the most recently used idle transaction still on the latest view, if any, closing the stale ones met before
+    std::optional<IdleTransaction> idle_txn;
+    std::vector<IdleTransaction> stale_transactions;
+    {
+        std::lock_guard lock{idle_mutex_};
+        while (!idle_transactions_.empty() && !idle_txn) {
+            auto candidate_txn = std::move(idle_transactions_.back());
+            idle_transactions_.pop_back();
+            if (candidate_txn.view_id >= latest_view_id_) {
+                idle_txn = std::move(candidate_txn);
+            } else {
+                stale_transactions.push_back(std::move(candidate_txn));
+            }
+        }
+    }
+    close_in_background(std::move(stale_transactions));
+
+    if (!idle_txn) {
+        idle_txn = co_await open_on_best_backend();
+    }
+    ++backends_[idle_txn->backend_index]->leased_count;
+    SILKRPC_TRACE << "RemoteDatabase::begin " << this << " leased txn: " << idle_txn->txn.get() << " backend: "
+                  << idle_txn->backend_index << " end\n";
+    auto leased_txn = std::make_unique<LeasedTransaction>(*this, std::move(*idle_txn));
+    leased_txn->set_chain_head_cache(chain_head_cache_.get());
+    leased_txn->set_snapshots(snapshots_.get());
+    leased_txn->set_read_combiner(read_combiner_.get());
+    co_return leased_txn;
+}
+
+void RemoteDatabase::on_new_view(uint64_t view_id) {
+    auto latest_view_id = latest_view_id_.load();
+    while (view_id > latest_view_id && !latest_view_id_.compare_exchange_weak(latest_view_id, view_id)) {
+    }
+
+    std::vector<IdleTransaction> stale_transactions;
+    {
+        std::lock_guard lock{idle_mutex_};
+        std::vector<IdleTransaction> fresh_transactions;
+        for (auto& idle_txn : idle_transactions_) {
+            if (idle_txn.view_id >= view_id) {
+                fresh_transactions.push_back(std::move(idle_txn));
+            } else {
+                stale_transactions.push_back(std::move(idle_txn));
+            }
+        }
+        idle_transactions_ = std::move(fresh_transactions);
+    }
+    SILKRPC_DEBUG << "RemoteDatabase::on_new_view view_id: " << view_id << " closing: " << stale_transactions.size() << "\n";
+    close_in_background(std::move(stale_transactions));
+}
+
+std::size_t RemoteDatabase::idle_count() const {
+    std::lock_guard lock{idle_mutex_};
+    return idle_transactions_.size();
+}
+
+bool RemoteDatabase::is_healthy(std::size_t backend_index) const {
+    return backends_.at(backend_index)->is_healthy(now_microseconds());
+}
+
+std::size_t RemoteDatabase::select_backend(const std::vector<bool>& tried) {
+    const auto now = now_microseconds();
+    // Start from a rotating index, so that the backends having the same score are picked round-robin
+    const auto first_index = next_backend_index_++;
+    std::optional<std::size_t> best_index;
+    int64_t best_score{0};
+    std::optional<std::size_t> earliest_retry_index;
+    for (std::size_t i{0}; i < backends_.size(); ++i) {
+        const auto index = (first_index + i) % backends_.size();
+        if (tried[index]) {
+            continue;
+        }
+        const auto& backend = *backends_[index];
+        if (!backend.is_healthy(now)) {
+            if (!earliest_retry_index || backend.retry_time < backends_[*earliest_retry_index]->retry_time) {
+                earliest_retry_index = index;
+            }
+            continue;
+        }
+        const auto score = backend.score();
+        if (!best_index || score < best_score) {
+            best_index = index;
+            best_score = score;
+        }
+    }
+    // When all the backends left are backing off, try the one closest to retry rather than failing straight away
+    return best_index ? *best_index : *earliest_retry_index;
+}
+
+boost::asio::awaitable<std::unique_ptr<RemoteTransaction>> RemoteDatabase::open_transaction(std::size_t backend_index) {
+    auto& backend = *backends_[backend_index];
+    const auto start_time = now_microseconds();
+    auto txn = std::make_unique<RemoteTransaction>(backend.next_stub(), grpc_context_);
+    try {
+        co_await txn->open();
+    } catch (const std::exception&) {
+        const auto failure_count = std::min(++backend.failure_count, kMaxBackoffFailures);
+        const auto backoff = std::chrono::duration_cast<std::chrono::microseconds>(kMinBackoff * (1 << (failure_count - 1)));
+        backend.retry_time = now_microseconds() + backoff.count();
+        throw;
+    }
+    const auto latency = now_microseconds() - start_time;
+    const auto average_latency = backend.open_latency.load();
+    backend.open_latency = average_latency == 0 ? latency : average_latency + (latency - average_latency) / kLatencyAverageDivisor;
+    backend.failure_count = 0;
     co_return txn;
 }
 
+boost::asio::awaitable<RemoteDatabase::IdleTransaction> RemoteDatabase::open_idle_transaction(std::size_t backend_index) {
+    auto txn = co_await open_transaction(backend_index);
+    // The transaction ids of the other backends are unrelated to the views notified by the primary one
+    const auto view_id = backend_index == 0 ? txn->tx_id() : latest_view_id_.load();
+    IdleTransaction idle_txn{backend_index, view_id, std::move(txn)};
+    co_return idle_txn;
+}
+
+boost::asio::awaitable<RemoteDatabase::IdleTransaction> RemoteDatabase::open_on_best_backend() {
+    std::vector<bool> tried(backends_.size(), false);
+    while (true) {
+        const auto backend_index = select_backend(tried);
+        tried[backend_index] = true;
+        // The duplicate goes to the next best backend not tried yet, if any, otherwise to the next channel of the same one
+        const auto open_attempt = [this, backend_index, tried](std::size_t attempt) {
+            if (attempt == 0 || std::find(tried.cbegin(), tried.cend(), false) == tried.cend()) {
+                return open_idle_transaction(backend_index);
+            }
+            return open_idle_transaction(select_backend(tried));
+        };
+        const auto discard = [this](IdleTransaction idle_txn) {
+            std::vector<IdleTransaction> txns;
+            txns.push_back(std::move(idle_txn));
+            close_in_background(std::move(txns));
+        };
+        try {
+            auto idle_txn = co_await hedged_call<IdleTransaction>(open_delay_, hedging_budget_, open_attempt, discard);
+            co_return idle_txn;
+        } catch (const std::exception& e) {
+            if (std::find(tried.cbegin(), tried.cend(), false) == tried.cend()) {
+                throw;
+            }
+            SILKRPC_WARN << "RemoteDatabase::open_on_best_backend backend: " << backend_index << " failed: " << e.what() << "\n";
+        }
+    }
+}
+
+boost::asio::awaitable<void> RemoteDatabase::release(IdleTransaction idle_txn) {
+    --backends_[idle_txn.backend_index]->leased_count;
+    co_await idle_txn.txn->settle();
+    if (idle_txn.txn->is_reusable() && idle_txn.view_id >= latest_view_id_) {
+        std::lock_guard lock{idle_mutex_};
+        if (idle_transactions_.size() < max_idle_transactions_) {
+            idle_transactions_.push_back(std::move(idle_txn));
+        }
+    }
+    if (idle_txn.txn) {
+        co_await idle_txn.txn->close();
+    }
+}
+
+void RemoteDatabase::close_in_background(std::vector<IdleTransaction> txns) {
+    for (auto& idle_txn : txns) {
+        boost::asio::co_spawn(grpc_context_, [txn = std::move(idle_txn.txn)]() -> boost::asio::awaitable<void> {
+            try {
+                co_await txn->close();
+            } catch (const std::exception& e) {
+                SILKRPC_WARN << "RemoteDatabase::close_in_background exception: " << e.what() << "\n";
+            }
+        }, boost::asio::detached);
+    }
+}
+
 } // namespace silkrpc::ethdb::kv
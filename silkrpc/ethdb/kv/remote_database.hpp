@@ -17,22 +17,54 @@
 #ifndef SILKRPC_ETHDB_KV_REMOTE_DATABASE_HPP_
 #define SILKRPC_ETHDB_KV_REMOTE_DATABASE_HPP_
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <utility>
+#include <vector>
 
 #include <agrpc/grpc_context.hpp>
 #include <grpcpp/grpcpp.h>
 
+#include <silkrpc/concurrency/hedging.hpp>
 #include <silkrpc/ethdb/database.hpp>
+#include <silkrpc/ethdb/kv/remote_transaction.hpp>
 #include <silkrpc/ethdb/transaction.hpp>
 #include <silkrpc/interfaces/remote/kv.grpc.pb.h>
 
 namespace silkrpc::ethdb::kv {
 
+//! Remote database keeping a pool of idle transactions open on the latest view: each transaction is leased by begin and
+//! given back on close, so that requests skip the transaction handshake. The transactions opened on older views are
+//! closed as soon as a new view is notified, because they would read a stale state (no pooling if max idle is zero).
+//! The transactions can be spread over several backends, i.e. Erigon nodes or read replicas following the same chain
+//! head: the first one is the primary, whose views are notified by the state changes stream, while each transaction is
+//! pinned to the backend it has been opened on. The backends are picked by their open latency and leased transactions,
+//! the failing ones skipped for an exponential backoff. The transactions opened on the other backends are labelled by
+//! the latest primary view, because their own transaction ids are unrelated to it. The opening of a new transaction
+//! slower than the usual ones is hedged, i.e. duplicated on the next best backend (or channel) within a small budget.
 class RemoteDatabase: public Database {
 public:
-    RemoteDatabase(agrpc::GrpcContext& grpc_context, std::shared_ptr<grpc::Channel> channel);
-    RemoteDatabase(agrpc::GrpcContext& grpc_context, std::unique_ptr<remote::KV::StubInterface>&& stub);
+    //! The consecutive failures after which a backend is skipped for the longest backoff
+    static constexpr uint32_t kMaxBackoffFailures{8};
+
+    //! The backoff after the first failure of a backend, doubled at each further one
+    static constexpr std::chrono::milliseconds kMinBackoff{100};
+
+    RemoteDatabase(agrpc::GrpcContext& grpc_context, std::shared_ptr<grpc::Channel> channel, std::size_t max_idle_transactions = 0);
+    //! The new transactions are spread round-robin over the channels, so that they are multiplexed on distinct connections
+    RemoteDatabase(agrpc::GrpcContext& grpc_context, const std::vector<std::shared_ptr<grpc::Channel>>& channels,
+        std::size_t max_idle_transactions = 0);
+    //! The channels of each backend, the primary one first
+    RemoteDatabase(agrpc::GrpcContext& grpc_context, const std::vector<std::vector<std::shared_ptr<grpc::Channel>>>& backend_channels,
+        std::size_t max_idle_transactions = 0);
+    RemoteDatabase(agrpc::GrpcContext& grpc_context, std::unique_ptr<remote::KV::StubInterface>&& stub, std::size_t max_idle_transactions = 0);
+    //! The stub of each backend, the primary one first
+    RemoteDatabase(agrpc::GrpcContext& grpc_context, std::vector<std::unique_ptr<remote::KV::StubInterface>>&& backend_stubs,
+        std::size_t max_idle_transactions = 0);
 
     ~RemoteDatabase();
 
@@ -41,9 +73,88 @@ public:
 
     boost::asio::awaitable<std::unique_ptr<Transaction>> begin() override;
 
+    void on_new_view(uint64_t view_id) override;
+
+    //! The number of idle transactions in the pool
+    std::size_t idle_count() const;
+
+    //! The number of backends
+    std::size_t backend_count() const noexcept { return backends_.size(); }
+
+    //! Return true if the backend at the specified index is not backing off after some failure
+    bool is_healthy(std::size_t backend_index) const;
+
+    //! The budget of the hedged transaction openings, counting them
+    const HedgingBudget& hedging_budget() const noexcept { return hedging_budget_; }
+
 private:
+    class LeasedTransaction;
+
+    //! One backend with its health and latency scores, updated by any thread opening or releasing its transactions
+    struct Backend {
+        std::vector<std::unique_ptr<remote::KV::StubInterface>> stubs;
+        std::atomic<std::size_t> next_stub_index{0};
+
+        //! The moving average of the transaction open latency in microseconds, zero if not measured yet
+        std::atomic<int64_t> open_latency{0};
+
+        //! The number of transactions currently leased
+        std::atomic<uint32_t> leased_count{0};
+
+        //! The number of consecutive open failures and the steady clock time in microseconds when to retry after them
+        std::atomic<uint32_t> failure_count{0};
+        std::atomic<int64_t> retry_time{0};
+
+        //! Return the stub for opening the next transaction, spread round-robin over the channels
+        remote::KV::StubInterface& next_stub();
+
+        bool is_healthy(int64_t now) const;
+
+        //! The lower the better, i.e. the expected latency of a new transaction given those already leased
+        int64_t score() const;
+    };
+
+    //! The idle transaction with the backend it is pinned to and the view it is labelled with
+    struct IdleTransaction {
+        std::size_t backend_index{0};
+        uint64_t view_id{0};
+        std::unique_ptr<RemoteTransaction> txn;
+    };
+
+    //! Return the index of the healthy backend having the best score not already tried, skipping none if all unhealthy
+    std::size_t select_backend(const std::vector<bool>& tried);
+
+    //! Open a new transaction on the backend, updating its scores
+    boost::asio::awaitable<std::unique_ptr<RemoteTransaction>> open_transaction(std::size_t backend_index);
+
+    //! Open a new transaction on the backend, labelling it by the view
+    boost::asio::awaitable<IdleTransaction> open_idle_transaction(std::size_t backend_index);
+
+    //! Open a new transaction on the best backend, hedged on the next best one if slow, failing over to the next ones if
+    //! it cannot be opened
+    boost::asio::awaitable<IdleTransaction> open_on_best_backend();
+
+    //! Take back the transaction at the end of its lease, closing it if it cannot be reused
+    boost::asio::awaitable<void> release(IdleTransaction idle_txn);
+
+    //! Close the transactions in background on the gRPC context
+    void close_in_background(std::vector<IdleTransaction> txns);
+
     agrpc::GrpcContext& grpc_context_;
-    std::unique_ptr<remote::KV::StubInterface> stub_;
+    std::vector<std::unique_ptr<Backend>> backends_;
+    std::atomic<std::size_t> next_backend_index_{0};
+    const std::size_t max_idle_transactions_;
+
+    //! The delay after which the opening of a new transaction is hedged and the budget bounding such hedging
+    HedgingDelay open_delay_;
+    HedgingBudget hedging_budget_;
+
+    //! The latest view notified, i.e. the lowest transaction id that can be reused
+    std::atomic<uint64_t> latest_view_id_{0};
+
+    //! The mutex protecting the idle transactions, because views are notified by other threads
+    mutable std::mutex idle_mutex_;
+    std::vector<IdleTransaction> idle_transactions_;
 };
 
 } // namespace silkrpc::ethdb::kv
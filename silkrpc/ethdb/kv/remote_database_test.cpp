@@ -16,7 +16,9 @@
 
 #include "remote_database.hpp"
 
+#include <chrono>
 #include <memory>
+#include <vector>
 
 #include <boost/system/system_error.hpp>
 #include <catch2/catch.hpp>
@@ -34,6 +36,24 @@ struct RemoteDatabaseTest : test::KVTestBase {
     RemoteDatabase remote_db_{grpc_context_, std::unique_ptr<StrictMockKVStub>{kv_stub_}};
 };
 
+struct PooledRemoteDatabaseTest : test::KVTestBase {
+    StrictMockKVStub* kv_stub_ = new StrictMockKVStub;
+    RemoteDatabase remote_db_{grpc_context_, std::unique_ptr<StrictMockKVStub>{kv_stub_}, /*max_idle_transactions=*/1};
+};
+
+struct MultiBackendRemoteDatabaseTest : test::KVTestBase {
+    StrictMockKVStub* primary_stub_ = new StrictMockKVStub;
+    StrictMockKVStub* replica_stub_ = new StrictMockKVStub;
+    RemoteDatabase remote_db_{grpc_context_, make_backend_stubs(), /*max_idle_transactions=*/1};
+
+    std::vector<std::unique_ptr<remote::KV::StubInterface>> make_backend_stubs() {
+        std::vector<std::unique_ptr<remote::KV::StubInterface>> stubs;
+        stubs.emplace_back(primary_stub_);
+        stubs.emplace_back(replica_stub_);
+        return stubs;
+    }
+};
+
 TEST_CASE_METHOD(RemoteDatabaseTest, "RemoteDatabase::begin", "[silkrpc][ethdb][kv][remote_database]") {
     using namespace testing;  // NOLINT(build/namespaces)
 
@@ -82,4 +102,81 @@ TEST_CASE_METHOD(RemoteDatabaseTest, "RemoteDatabase::begin", "[silkrpc][ethdb][
     }
 }
 
+TEST_CASE_METHOD(PooledRemoteDatabaseTest, "RemoteDatabase::begin with pooling", "[silkrpc][ethdb][kv][remote_database]") {
+    using namespace testing;  // NOLINT(build/namespaces)
+
+    // Set the call expectations:
+    // 1. remote::KV::StubInterface::PrepareAsyncTxRaw call succeeds just once
+    expect_request_async_tx(*kv_stub_, true);
+    // 2. AsyncReaderWriter<remote::Cursor, remote::Pair>::Read call succeeds setting the specified transaction ID
+    remote::Pair pair;
+    pair.set_txid(4);
+    EXPECT_CALL(reader_writer_, Read).WillOnce(test::read_success_with(grpc_context_, pair));
+
+    auto txn = spawn_and_wait(remote_db_.begin());
+    CHECK(txn->tx_id() == 4);
+    spawn_and_wait(txn->close());
+    CHECK(remote_db_.idle_count() == 1);
+
+    SECTION("transaction reused on the same view") {
+        remote_db_.on_new_view(4);
+        CHECK(remote_db_.idle_count() == 1);
+        auto reused_txn = spawn_and_wait(remote_db_.begin());
+        CHECK(reused_txn->tx_id() == 4);
+        CHECK(remote_db_.idle_count() == 0);
+        spawn_and_wait(reused_txn->close());
+        CHECK(remote_db_.idle_count() == 1);
+    }
+
+    SECTION("transaction closed on new view") {
+        // 3. AsyncReaderWriter<remote::Cursor, remote::Pair>::WritesDone call succeeds
+        EXPECT_CALL(reader_writer_, WritesDone).WillOnce(test::writes_done_success(grpc_context_));
+        // 4. AsyncReaderWriter<remote::Cursor, remote::Pair>::Finish call succeeds w/ status OK
+        EXPECT_CALL(reader_writer_, Finish).WillOnce(test::finish_streaming_ok(grpc_context_));
+
+        remote_db_.on_new_view(5);
+        CHECK(remote_db_.idle_count() == 0);
+        sleep_for(std::chrono::milliseconds(100));
+    }
+}
+
+TEST_CASE_METHOD(MultiBackendRemoteDatabaseTest, "RemoteDatabase::begin with replicas", "[silkrpc][ethdb][kv][remote_database]") {
+    using namespace testing;  // NOLINT(build/namespaces)
+
+    // Set the call expectations:
+    // 1. remote::KV::StubInterface::PrepareAsyncTxRaw call on the primary fails
+    expect_request_async_tx(*primary_stub_, false);
+    // 2. AsyncReaderWriter<remote::Cursor, remote::Pair>::Finish call on the primary succeeds w/ status cancelled
+    EXPECT_CALL(reader_writer_, Finish).WillOnce(test::finish_streaming_cancelled(grpc_context_));
+    // 3. remote::KV::StubInterface::PrepareAsyncTxRaw call on the replica succeeds
+    auto* replica_reader_writer = new StrictMockKVTxAsyncReaderWriter;
+    EXPECT_CALL(*replica_stub_, PrepareAsyncTxRaw).WillOnce(Return(replica_reader_writer));
+    EXPECT_CALL(*replica_reader_writer, StartCall).WillOnce([&](void* tag) {
+        agrpc::process_grpc_tag(grpc_context_, tag, /*ok=*/true);
+    });
+    // 4. AsyncReaderWriter<remote::Cursor, remote::Pair>::Read call on the replica succeeds setting its own transaction ID
+    remote::Pair pair;
+    pair.set_txid(42);
+    EXPECT_CALL(*replica_reader_writer, Read).WillOnce(test::read_success_with(grpc_context_, pair));
+
+    // Execute the test: RemoteDatabase::begin should fail over to the replica, labelling its transaction by the primary view
+    auto txn = spawn_and_wait(remote_db_.begin());
+    CHECK(txn->tx_id() == 0);
+    CHECK(!remote_db_.is_healthy(0));
+    CHECK(remote_db_.is_healthy(1));
+    spawn_and_wait(txn->close());
+    CHECK(remote_db_.idle_count() == 1);
+
+    SECTION("replica transaction closed on new view") {
+        // 5. AsyncReaderWriter<remote::Cursor, remote::Pair>::WritesDone call on the replica succeeds
+        EXPECT_CALL(*replica_reader_writer, WritesDone).WillOnce(test::writes_done_success(grpc_context_));
+        // 6. AsyncReaderWriter<remote::Cursor, remote::Pair>::Finish call on the replica succeeds w/ status OK
+        EXPECT_CALL(*replica_reader_writer, Finish).WillOnce(test::finish_streaming_ok(grpc_context_));
+
+        remote_db_.on_new_view(1);
+        CHECK(remote_db_.idle_count() == 0);
+        sleep_for(std::chrono::milliseconds(100));
+    }
+}
+
 } // namespace silkrpc::ethdb::kv
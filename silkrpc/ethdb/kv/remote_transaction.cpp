@@ -45,7 +45,16 @@ boost::asio::awaitable<std::shared_ptr<CursorDupSort>> RemoteTransaction::cursor
     co_return co_await get_cursor(table, true);
 }
 
+boost::asio::awaitable<std::shared_ptr<Cursor>> RemoteTransaction::new_cursor(const std::string& table) {
+    co_return co_await open_cursor(table, false);
+}
+
+boost::asio::awaitable<std::shared_ptr<CursorDupSort>> RemoteTransaction::new_cursor_dup_sort(const std::string& table) {
+    co_return co_await open_cursor(table, true);
+}
+
 boost::asio::awaitable<void> RemoteTransaction::close() {
+    co_await tx_stream_.settle();
     co_await tx_rpc_.writes_done_and_finish();
     cursors_.clear();
     tx_id_ = 0;
@@ -63,8 +72,7 @@ boost::asio::awaitable<std::shared_ptr<CursorDupSort>> RemoteTransaction::get_cu
            co_return cursor_it->second;
        }
     }
-    auto cursor = std::make_shared<RemoteCursor>(tx_rpc_);
-    co_await cursor->open_cursor(table, is_cursor_sorted);
+    auto cursor = co_await open_cursor(table, is_cursor_sorted);
     if (is_cursor_sorted) {
        dup_cursors_[table] = cursor;
     } else {
@@ -73,4 +81,10 @@ boost::asio::awaitable<std::shared_ptr<CursorDupSort>> RemoteTransaction::get_cu
     co_return cursor;
 }
 
+boost::asio::awaitable<std::shared_ptr<CursorDupSort>> RemoteTransaction::open_cursor(const std::string& table, bool is_cursor_dup_sort) {
+    auto cursor = std::make_shared<RemoteCursor>(tx_stream_);
+    co_await cursor->open_cursor(table, is_cursor_dup_sort);
+    co_return cursor;
+}
+
 } // namespace silkrpc::ethdb::kv
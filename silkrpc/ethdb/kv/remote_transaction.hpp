@@ -44,20 +44,35 @@ public:
 
     uint64_t tx_id() const override { return tx_id_; }
 
+    //! Return true if the transaction can be kept open to serve further requests
+    bool is_reusable() const noexcept { return tx_rpc_.is_reusable(); }
+
     boost::asio::awaitable<void> open() override;
 
     boost::asio::awaitable<std::shared_ptr<Cursor>> cursor(const std::string& table) override;
 
     boost::asio::awaitable<std::shared_ptr<CursorDupSort>> cursor_dup_sort(const std::string& table) override;
 
+    boost::asio::awaitable<std::shared_ptr<Cursor>> new_cursor(const std::string& table) override;
+
+    boost::asio::awaitable<std::shared_ptr<CursorDupSort>> new_cursor_dup_sort(const std::string& table) override;
+
     boost::asio::awaitable<void> close() override;
 
+    //! Read the replies to the requests written ahead by the cursors, so that the stream is ready for further requests
+    boost::asio::awaitable<void> settle() { co_await tx_stream_.settle(); }
+
 private:
     boost::asio::awaitable<std::shared_ptr<CursorDupSort>> get_cursor(const std::string& table, bool is_cursor_dup_sort);
 
+    //! Open a new cursor on the stream shared by all the cursors
+    boost::asio::awaitable<std::shared_ptr<CursorDupSort>> open_cursor(const std::string& table, bool is_cursor_dup_sort);
+
     std::map<std::string, std::shared_ptr<CursorDupSort>> cursors_;
     std::map<std::string, std::shared_ptr<CursorDupSort>> dup_cursors_;
     TxRpc tx_rpc_;
+    //! The stream shared by all the cursors, so that they can read ahead without mixing up the replies
+    TxStream tx_stream_{tx_rpc_};
     uint64_t tx_id_;
 };
 
@@ -16,11 +16,16 @@
 
 #include "state_cache.hpp"
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <exception>
+#include <utility>
 
 #include <magic_enum.hpp>
 
 #include <silkrpc/common/log.hpp>
+#include <silkrpc/common/usdt.hpp>
 #include <silkrpc/common/util.hpp>
 #include <silkrpc/core/rawdb/util.hpp>
 #include <silkrpc/ethdb/tables.hpp>
@@ -31,17 +36,393 @@
 
 namespace silkrpc::ethdb::kv {
 
+bool AbslParseFlag(absl::string_view text, EvictionPolicyType* type, std::string* error) {
+    if (text == "lru") {
+        *type = EvictionPolicyType::lru;
+        return true;
+    }
+    if (text == "w_tinylfu") {
+        *type = EvictionPolicyType::w_tinylfu;
+        return true;
+    }
+    *error = "unknown value for eviction policy";
+    return false;
+}
+
+std::string AbslUnparseFlag(EvictionPolicyType type) {
+    switch (type) {
+        case EvictionPolicyType::lru: return "lru";
+        case EvictionPolicyType::w_tinylfu: return "w_tinylfu";
+        default: return std::string{magic_enum::enum_name(type)};
+    }
+}
+
+void KeyEvictionList::push_front(const silkworm::Bytes& key) {
+    const auto [it, inserted] = entries_.try_emplace(key);
+    if (!inserted) {
+        unlink(&*it);
+    }
+    link_front(&*it);
+}
+
+void KeyEvictionList::touch(const silkworm::Bytes& key) {
+    const auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        unlink(&*it);
+        link_front(&*it);
+    }
+}
+
+void KeyEvictionList::erase(const silkworm::Bytes& key) {
+    const auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        unlink(&*it);
+        entries_.erase(it);
+    }
+}
+
+silkworm::Bytes KeyEvictionList::pop_back() {
+    Entry* oldest = tail_;
+    unlink(oldest);
+    auto node = entries_.extract(oldest->first);
+    return std::move(node.key());
+}
+
+void KeyEvictionList::clear() {
+    entries_.clear();
+    head_ = nullptr;
+    tail_ = nullptr;
+}
+
+std::vector<silkworm::Bytes> KeyEvictionList::keys() const {
+    std::vector<silkworm::Bytes> keys;
+    keys.reserve(entries_.size());
+    for (const Entry* entry = head_; entry != nullptr; entry = entry->second.next) {
+        keys.push_back(entry->first);
+    }
+    return keys;
+}
+
+void KeyEvictionList::link_front(Entry* entry) {
+    entry->second.prev = nullptr;
+    entry->second.next = head_;
+    if (head_ != nullptr) {
+        head_->second.prev = entry;
+    } else {
+        tail_ = entry;
+    }
+    head_ = entry;
+}
+
+void KeyEvictionList::unlink(Entry* entry) {
+    auto& links = entry->second;
+    if (links.prev != nullptr) {
+        links.prev->second.next = links.next;
+    } else {
+        head_ = links.next;
+    }
+    if (links.next != nullptr) {
+        links.next->second.prev = links.prev;
+    } else {
+        tail_ = links.prev;
+    }
+    links.prev = nullptr;
+    links.next = nullptr;
+}
+
+std::optional<silkworm::Bytes> LruEvictionPolicy::insert(const silkworm::Bytes& key) {
+    keys_.push_front(key);
+    if (keys_.size() > max_keys_) {
+        return keys_.pop_back();
+    }
+    return std::nullopt;
+}
+
+std::optional<silkworm::Bytes> LruEvictionPolicy::evict() {
+    if (keys_.size() == 0) {
+        return std::nullopt;
+    }
+    return keys_.pop_back();
+}
+
+FrequencySketch::FrequencySketch(std::size_t max_keys)
+    : row_mask_{std::bit_ceil(std::max<std::size_t>(max_keys, 16)) * kCountersPerKey - 1},
+      sample_size_{10 * std::max<std::size_t>(max_keys, 1)} {
+    // Two 4-bit counters per byte
+    counters_.resize(kNumRows * (row_mask_ + 1) / 2);
+}
+
+void FrequencySketch::increment(const silkworm::Bytes& key) {
+    const auto hash = BytesHash{}(key);
+    std::array<std::size_t, kNumRows> indexes{};
+    uint8_t min_count{kMaxCount};
+    for (std::size_t row{0}; row < kNumRows; ++row) {
+        indexes[row] = index_of(hash, row);
+        min_count = std::min(min_count, count_at(indexes[row]));
+    }
+    if (min_count == kMaxCount) {
+        return;
+    }
+    for (const auto index : indexes) {
+        if (count_at(index) == min_count) {
+            counters_[index / 2] += static_cast<uint8_t>(1 << (index % 2 * 4));
+        }
+    }
+
+    if (++additions_ >= sample_size_) {
+        for (auto& counts : counters_) {
+            counts = (counts >> 1) & 0x77;
+        }
+        additions_ /= 2;
+        ++reset_count_;
+    }
+}
+
+uint8_t FrequencySketch::frequency(const silkworm::Bytes& key) const {
+    const auto hash = BytesHash{}(key);
+    uint8_t min_count{kMaxCount};
+    for (std::size_t row{0}; row < kNumRows; ++row) {
+        min_count = std::min(min_count, count_at(index_of(hash, row)));
+    }
+    return min_count;
+}
+
+std::size_t FrequencySketch::index_of(std::size_t hash, std::size_t row) const {
+    // Derive one independent hash per row from the key hash by applying the SplitMix64 finalizer to a distinct seed
+    uint64_t h = static_cast<uint64_t>(hash) + (row + 1) * 0x9e3779b97f4a7c15ull;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+    h ^= h >> 31;
+    return row * (row_mask_ + 1) + (static_cast<std::size_t>(h) & row_mask_);
+}
+
+uint8_t FrequencySketch::count_at(std::size_t index) const {
+    return (counters_[index / 2] >> (index % 2 * 4)) & kMaxCount;
+}
+
+WTinyLfuEvictionPolicy::WTinyLfuEvictionPolicy(std::size_t max_keys) : sketch_{max_keys} {
+    set_max_keys(max_keys);
+}
+
+std::optional<silkworm::Bytes> WTinyLfuEvictionPolicy::insert(const silkworm::Bytes& key) {
+    sketch_.increment(key);
+    if (window_.contains(key)) {
+        window_.touch(key);
+        return std::nullopt;
+    }
+    if (probation_.contains(key) || protected_.contains(key)) {
+        promote(key);
+        return std::nullopt;
+    }
+    window_.push_front(key);
+    if (window_.size() <= window_capacity_) {
+        return std::nullopt;
+    }
+    return admit(window_.pop_back());
+}
+
+void WTinyLfuEvictionPolicy::touch(const silkworm::Bytes& key) {
+    if (window_.contains(key)) {
+        sketch_.increment(key);
+        window_.touch(key);
+    } else if (probation_.contains(key) || protected_.contains(key)) {
+        sketch_.increment(key);
+        promote(key);
+    }
+}
+
+void WTinyLfuEvictionPolicy::erase(const silkworm::Bytes& key) {
+    window_.erase(key);
+    probation_.erase(key);
+    protected_.erase(key);
+}
+
+void WTinyLfuEvictionPolicy::clear() {
+    // The access frequencies are kept, they still tell the hot keys apart after the tracked ones are gone
+    window_.clear();
+    probation_.clear();
+    protected_.clear();
+}
+
+std::optional<silkworm::Bytes> WTinyLfuEvictionPolicy::evict() {
+    // The keys on probation are the least worth keeping, then the ones never admitted into the main area
+    for (auto* segment : {&probation_, &window_, &protected_}) {
+        if (segment->size() > 0) {
+            return segment->pop_back();
+        }
+    }
+    return std::nullopt;
+}
+
+void WTinyLfuEvictionPolicy::set_max_keys(std::size_t max_keys) {
+    // The sketch keeps its size: it just gets less or more accurate than intended until restart
+    window_capacity_ = max_keys == 0 ? 0 : std::max<std::size_t>(max_keys * kWindowPercentage / 100, 1);
+    main_capacity_ = max_keys - window_capacity_;
+    protected_capacity_ = main_capacity_ * kProtectedPercentage / 100;
+}
+
+std::vector<silkworm::Bytes> WTinyLfuEvictionPolicy::keys() const {
+    auto keys = protected_.keys();
+    keys.reserve(size());
+    for (auto&& segment_keys : {window_.keys(), probation_.keys()}) {
+        keys.insert(keys.end(), segment_keys.cbegin(), segment_keys.cend());
+    }
+    return keys;
+}
+
+std::optional<silkworm::Bytes> WTinyLfuEvictionPolicy::admit(silkworm::Bytes candidate) {
+    if (probation_.size() + protected_.size() < main_capacity_) {
+        probation_.push_front(candidate);
+        return std::nullopt;
+    }
+    KeyEvictionList& victims = probation_.size() > 0 ? probation_ : protected_;
+    if (victims.size() == 0 || sketch_.frequency(candidate) <= sketch_.frequency(victims.back())) {
+        return candidate;
+    }
+    auto victim = victims.pop_back();
+    probation_.push_front(candidate);
+    return victim;
+}
+
+void WTinyLfuEvictionPolicy::promote(const silkworm::Bytes& key) {
+    if (protected_.contains(key)) {
+        protected_.touch(key);
+        return;
+    }
+    probation_.erase(key);
+    protected_.push_front(key);
+    if (protected_.size() > protected_capacity_) {
+        probation_.push_front(protected_.pop_back());
+    }
+}
+
+std::unique_ptr<EvictionPolicy> make_eviction_policy(EvictionPolicyType type, std::size_t max_keys) {
+    switch (type) {
+        case EvictionPolicyType::w_tinylfu: return std::make_unique<WTinyLfuEvictionPolicy>(max_keys);
+        default: return std::make_unique<LruEvictionPolicy>(max_keys);
+    }
+}
+
+std::shared_ptr<const silkworm::Bytes> CodeStore::find(const silkworm::Bytes& key) {
+    std::shared_ptr<const CompressedBytes> compressed_code;
+    {
+        std::scoped_lock lock{mutex_};
+        const auto it = codes_.find(key);
+        if (it == codes_.end()) {
+            return nullptr;
+        }
+        evictions_.touch(key);
+        if (it->second.code) {
+            return it->second.code;
+        }
+        compressed_code = it->second.compressed_code;
+    }
+    // Decompress without holding the lock, the compressed code being kept alive by its reference
+    return std::make_shared<const silkworm::Bytes>(compressed_code->bytes());
+}
+
+bool CodeStore::insert(const silkworm::Bytes& key, const silkworm::Bytes& code) {
+    // Compress before taking the lock, at the cost of compressing for nothing the code already present
+    std::shared_ptr<const CompressedBytes> compressed_code;
+    if (compression_threshold_ > 0 && code.size() >= compression_threshold_) {
+        compressed_code = std::make_shared<const CompressedBytes>(code, compression_threshold_);
+        if (!compressed_code->compressed()) {
+            compressed_code.reset();
+        }
+    }
+
+    std::scoped_lock lock{mutex_};
+    evictions_.push_front(key);
+    const auto [it, inserted] = codes_.try_emplace(key, Entry{});
+    if (!inserted) {
+        return false; // same hash, same code
+    }
+    if (compressed_code) {
+        it->second.compressed_code = std::move(compressed_code);
+    } else {
+        it->second.code = std::make_shared<const silkworm::Bytes>(code);
+    }
+    const auto entry_size = it->second.size_bytes(key);
+    size_bytes_ += entry_size;
+
+    // Remove the least recently used code while exceeding the budget, always keeping the one just inserted. If already
+    // exceeding before the insertion (i.e. the budget has been shrunk) stop after a few evictions once back to the previous size
+    const auto size_bytes_before = size_bytes_ - entry_size;
+    const bool shrinking = size_bytes_before > max_bytes_;
+    std::size_t num_evicted{0};
+    while (size_bytes_ > max_bytes_ && evictions_.size() > 1) {
+        if (shrinking && num_evicted >= kMaxShrinkEvictions && size_bytes_ <= size_bytes_before) {
+            break;
+        }
+        const auto oldest = evictions_.pop_back();
+        const auto oldest_it = codes_.find(oldest);
+        SILKWORM_ASSERT(oldest_it != codes_.end());
+        SILKRPC_DEBUG << "Code store resize oldest.key=" << silkworm::to_hex(oldest) << "\n";
+        size_bytes_ -= oldest_it->second.size_bytes(oldest);
+        codes_.erase(oldest_it);
+        ++evicted_count_;
+        ++num_evicted;
+    }
+    return true;
+}
+
+std::size_t CodeStore::size() const {
+    std::scoped_lock lock{mutex_};
+    return codes_.size();
+}
+
+std::size_t CodeStore::size_bytes() const {
+    std::scoped_lock lock{mutex_};
+    return size_bytes_;
+}
+
+uint64_t CodeStore::evicted_count() const {
+    std::scoped_lock lock{mutex_};
+    return evicted_count_;
+}
+
+std::vector<silkworm::Bytes> CodeStore::keys() const {
+    std::scoped_lock lock{mutex_};
+    return evictions_.keys();
+}
+
+std::size_t CodeStore::max_bytes() const {
+    std::scoped_lock lock{mutex_};
+    return max_bytes_;
+}
+
+void CodeStore::set_max_bytes(std::size_t max_bytes) {
+    std::scoped_lock lock{mutex_};
+    max_bytes_ = max_bytes;
+}
+
+boost::asio::awaitable<std::vector<std::optional<silkworm::Bytes>>> StateView::get_many(const std::vector<silkworm::Bytes>& keys) {
+    std::vector<std::optional<silkworm::Bytes>> values;
+    values.reserve(keys.size());
+    for (const auto& key : keys) {
+        values.push_back(co_await get(key));
+    }
+    co_return values;
+}
+
 CoherentStateView::CoherentStateView(Transaction& txn, CoherentStateCache* cache) : txn_(txn), cache_(cache) {}
 
 boost::asio::awaitable<std::optional<silkworm::Bytes>> CoherentStateView::get(const silkworm::Bytes& key) {
     co_return co_await cache_->get(key, txn_);
 }
 
+boost::asio::awaitable<std::vector<std::optional<silkworm::Bytes>>> CoherentStateView::get_many(const std::vector<silkworm::Bytes>& keys) {
+    co_return co_await cache_->get_many(keys, txn_);
+}
+
 boost::asio::awaitable<std::optional<silkworm::Bytes>> CoherentStateView::get_code(const silkworm::Bytes& key) {
     co_return co_await cache_->get_code(key, txn_);
 }
 
-CoherentStateCache::CoherentStateCache(CoherentCacheConfig config) : config_(config) {
+CoherentStateCache::CoherentStateCache(CoherentCacheConfig config) : config_(config),
+      state_evictions_{make_eviction_policy(config.eviction_policy, config.max_state_keys)}, absent_evictions_{config.max_absent_keys},
+      code_store_{config.max_code_bytes, config.code_compression_threshold},
+      storage_filter_{config.storage_addresses, config.max_auto_storage_addresses} {
     if (config.max_views == 0) {
         throw std::invalid_argument{"unexpected zero max_views"};
     }
@@ -62,12 +443,21 @@ std::size_t CoherentStateCache::latest_data_size() {
     return latest_state_view_->cache.size();
 }
 
-std::size_t CoherentStateCache::latest_code_size() {
+std::size_t CoherentStateCache::absent_key_count() {
     std::shared_lock read_lock{rw_mutex_};
     if (latest_state_view_ == nullptr) {
         return 0;
     }
-    return latest_state_view_->code_cache.size();
+    return latest_state_view_->absent_keys.size();
+}
+
+std::size_t CoherentStateCache::latest_code_size() {
+    return code_store_.size();
+}
+
+std::size_t CoherentStateCache::view_count() {
+    std::shared_lock read_lock{rw_mutex_};
+    return state_view_roots_.size();
 }
 
 void CoherentStateCache::on_new_block(const remote::StateChangeBatch& state_changes) {
@@ -76,34 +466,68 @@ void CoherentStateCache::on_new_block(const remote::StateChangeBatch& state_chan
         return;
     }
 
-    std::unique_lock write_lock{rw_mutex_};
+    // Track the storage of the contracts read often enough before the snapshot, so that all the changes since are applied
+    storage_filter_.on_new_block();
 
+    // The lowest block unwound by the batch, if any: the common ancestor of the abandoned and the new chain is the one before
+    std::optional<silkworm::BlockNum> unwind_block;
+    for (const auto& state_change : state_changes.changebatch()) {
+        if (state_change.direction() == remote::Direction::UNWIND) {
+            unwind_block = std::min(unwind_block.value_or(state_change.blockheight()), state_change.blockheight());
+        }
+    }
+
+    // Advance the latest view taking a snapshot of its cache: this is O(1) because the nodes are shared with the previous view
     const auto view_id = state_changes.databaseviewid();
-    CoherentStateRoot* root = advance_root(view_id);
+    CoherentStateRoot* latest_root{nullptr};
+    CoherentStateRoot next_root;
+    {
+        std::unique_lock write_lock{rw_mutex_};
+        latest_root = advance_root(view_id, unwind_block);
+        next_root.cache = latest_root->cache;
+        next_root.absent_keys = latest_root->absent_keys;
+    }
+
+    // Apply the changes to the snapshot without holding rw_mutex_, so that readers of the ready views are never blocked.
+    // The latest root is not ready yet, hence no reader can look it up meanwhile. The code goes straight into the code
+    // store instead, because it is immutable for a given hash and so it can be served to any view right away.
+    // The keys changed by the forward blocks are recorded, so that a later unwind drops them: the keys reverted by the unwound
+    // blocks need not, they have been recorded when such blocks were applied
+    CoherentStateRoot* root = &next_root;
     for (const auto& state_change : state_changes.changebatch()) {
+        std::vector<silkworm::Bytes>* changed_keys{nullptr};
+        if (state_change.direction() == remote::Direction::FORWARD) {
+            changed_keys = &changed_keys_by_block_[state_change.blockheight()];
+        }
         for (const auto& account_change : state_change.changes()) {
             switch (account_change.action()) {
                 case remote::Action::UPSERT: {
-                    process_upsert_change(root, view_id, account_change);
+                    process_upsert_change(root, view_id, account_change, changed_keys);
                     break;
                 }
                 case remote::Action::UPSERT_CODE: {
-                    process_upsert_change(root, view_id, account_change);
-                    process_code_change(root, view_id, account_change);
+                    process_upsert_change(root, view_id, account_change, changed_keys);
+                    process_code_change(account_change);
                     break;
                 }
                 case remote::Action::REMOVE: {
-                    process_delete_change(root, view_id, account_change);
+                    process_delete_change(root, view_id, account_change, changed_keys);
                     break;
                 }
                 case remote::Action::STORAGE: {
-                    if (config_.with_storage && account_change.storagechanges_size() > 0) {
-                        process_storage_change(root, view_id, account_change);
+                    if (!config_.with_storage || account_change.storagechanges_size() == 0) {
+                        break;
                     }
+                    // Skip the contracts not tracked before decoding any of their storage changes
+                    if (storage_filter_.enabled() && !storage_filter_.tracks(silkworm::rpc::address_from_H160(account_change.address()))) {
+                        storage_filter_.record_skipped_change();
+                        break;
+                    }
+                    process_storage_change(root, view_id, account_change, changed_keys);
                     break;
                 }
                 case remote::Action::CODE: {
-                    process_code_change(root, view_id, account_change);
+                    process_code_change(account_change);
                     break;
                 }
                 default: {
@@ -113,39 +537,53 @@ void CoherentStateCache::on_new_block(const remote::StateChangeBatch& state_chan
         }
     }
 
-    state_key_count_ = latest_state_view_->cache.size();
-    code_key_count_ = latest_state_view_->code_cache.size();
+    while (changed_keys_by_block_.size() > kMaxUnwindBlocks) {
+        changed_keys_by_block_.erase(changed_keys_by_block_.begin());
+    }
+
+    // Publish the updated snapshot: just a pointer swap under the exclusive lock
+    std::unique_lock write_lock{rw_mutex_};
+    latest_root->cache = std::move(next_root.cache);
+    latest_root->absent_keys = std::move(next_root.absent_keys);
 
-    root->ready = true;
+    state_key_count_.store(latest_state_view_->cache.size(), std::memory_order_relaxed);
+
+    latest_root->ready = true;
 }
 
-void CoherentStateCache::process_upsert_change(CoherentStateRoot* root, StateViewId view_id,
-                                               const remote::AccountChange& change) {
+void CoherentStateCache::process_upsert_change(CoherentStateRoot* root, StateViewId view_id, const remote::AccountChange& change,
+                                               std::vector<silkworm::Bytes>* changed_keys) {
     const auto address = silkworm::rpc::address_from_H160(change.address());
     const auto data_bytes = silkworm::bytes_of_string(change.data());
     SILKRPC_DEBUG << "CoherentStateCache::process_upsert_change address: " << address << " data: " << data_bytes << "\n";
     const silkworm::Bytes address_key{address.bytes, silkworm::kAddressLength};
+    if (changed_keys) {
+        changed_keys->push_back(address_key);
+    }
     add({address_key, data_bytes}, root, view_id);
 }
 
-void CoherentStateCache::process_code_change(CoherentStateRoot* root, StateViewId view_id, const remote::AccountChange& change) {
+void CoherentStateCache::process_code_change(const remote::AccountChange& change) {
     const auto code_bytes = silkworm::bytes_of_string(change.code());
     const ethash::hash256 code_hash{silkworm::keccak256(code_bytes)};
     const silkworm::Bytes code_hash_key{code_hash.bytes, silkworm::kHashLength};
     SILKRPC_DEBUG << "CoherentStateCache::process_code_change code_hash_key: " << code_hash_key << "\n";
-    add_code({code_hash_key, code_bytes}, root, view_id);
+    code_store_.insert(code_hash_key, code_bytes);
 }
 
-void CoherentStateCache::process_delete_change(CoherentStateRoot* root, StateViewId view_id,
-                                               const remote::AccountChange& change) {
+void CoherentStateCache::process_delete_change(CoherentStateRoot* root, StateViewId view_id, const remote::AccountChange& change,
+                                               std::vector<silkworm::Bytes>* changed_keys) {
     const auto address = silkworm::rpc::address_from_H160(change.address());
     SILKRPC_DEBUG << "CoherentStateCache::process_delete_change address: " << address << "\n";
     const silkworm::Bytes address_key{address.bytes, silkworm::kAddressLength};
+    if (changed_keys) {
+        changed_keys->push_back(address_key);
+    }
     add({address_key, {}}, root, view_id);
 }
 
-void CoherentStateCache::process_storage_change(CoherentStateRoot* root, StateViewId view_id,
-                                                const remote::AccountChange& change) {
+void CoherentStateCache::process_storage_change(CoherentStateRoot* root, StateViewId view_id, const remote::AccountChange& change,
+                                                std::vector<silkworm::Bytes>* changed_keys) {
     const auto address = silkworm::rpc::address_from_H160(change.address());
     SILKRPC_DEBUG << "CoherentStateCache::process_storage_change address=" << address << "\n";
     for (const auto& storage_change : change.storagechanges()) {
@@ -153,138 +591,276 @@ void CoherentStateCache::process_storage_change(CoherentStateRoot* root, StateVi
         const auto storage_key = composite_storage_key(address, change.incarnation(), location_hash.bytes);
         const auto value = silkworm::bytes_of_string(storage_change.data());
         SILKRPC_DEBUG << "CoherentStateCache::process_storage_change key=" << storage_key << " value=" << value << "\n";
+        if (changed_keys) {
+            changed_keys->push_back(storage_key);
+        }
         add({storage_key, value}, root, view_id);
     }
 }
 
+bool CoherentStateCache::is_cacheable(const silkworm::Bytes& key) const {
+    if (!storage_filter_.enabled() || key.size() <= silkworm::kAddressLength) {
+        return true;
+    }
+    return storage_filter_.tracks(silkworm::to_evmc_address(key));
+}
+
 bool CoherentStateCache::add(KeyValue kv, CoherentStateRoot* root, StateViewId view_id) {
-    auto [it, inserted] = root->cache.insert(kv);
-    SILKRPC_DEBUG << "Data cache kv.key=" << silkworm::to_hex(kv.key) << " inserted=" << inserted << " view=" << view_id << "\n";
-    KeyValue* replaced{nullptr};
-    if (!inserted) {
-        replaced = &*it;
-        root->cache.erase(it);
-        std::tie(it, inserted) = root->cache.insert(kv);
-        SILKWORM_ASSERT(inserted);
+    // The storage of the contracts not tracked would go stale, because their changes are skipped
+    if (!is_cacheable(kv.key)) {
+        return false;
     }
+    const bool inserted = root->cache.insert_or_assign(kv.key, kv.value);
+    SILKRPC_DEBUG << "Data cache kv.key=" << silkworm::to_hex(kv.key) << " inserted=" << inserted << " view=" << view_id << "\n";
+
+    // Any change of the key (even its deletion, cached as empty value) makes its recorded absence stale
+    const bool was_absent = !root->absent_keys.empty() && root->absent_keys.erase(kv.key) > 0;
     if (latest_state_view_id_ != view_id) {
         return inserted;
     }
-    if (replaced != nullptr) {
-        state_evictions_.remove(*replaced);
-        SILKRPC_DEBUG << "Data evictions removed replaced.key=" << silkworm::to_hex(replaced->key) << "\n";
+
+    std::scoped_lock evictions_lock{evictions_mutex_};
+    if (was_absent) {
+        absent_evictions_.erase(kv.key);
+    }
+
+    // Remove the key-value pair chosen by the eviction policy when size exceeded
+    if (const auto evicted = state_evictions_->insert(kv.key)) {
+        SILKRPC_DEBUG << "Data cache resize evicted.key=" << silkworm::to_hex(*evicted) << "\n";
+        const auto num_erased = root->cache.erase(*evicted);
+        SILKWORM_ASSERT(num_erased == 1);
+        state_evicted_count_.fetch_add(1, std::memory_order_relaxed);
     }
-    state_evictions_.push_front(kv);
 
-    // Remove longest unused key-value pair when size exceeded
-    if (state_evictions_.size() > config_.max_state_keys) {
-        const auto oldest = state_evictions_.back();
-        SILKRPC_DEBUG << "Data cache resize oldest.key=" << silkworm::to_hex(oldest.key) << "\n";
-        state_evictions_.pop_back();
-        const auto num_erased = root->cache.erase(oldest);
+    // Converge gradually to the max keys after they have been shrunk
+    for (std::size_t i{0}; i < kMaxShrinkEvictions && state_evictions_->size() > config_.max_state_keys; ++i) {
+        const auto evicted = state_evictions_->evict();
+        SILKRPC_DEBUG << "Data cache shrink evicted.key=" << silkworm::to_hex(*evicted) << "\n";
+        const auto num_erased = root->cache.erase(*evicted);
         SILKWORM_ASSERT(num_erased == 1);
+        state_evicted_count_.fetch_add(1, std::memory_order_relaxed);
     }
     return inserted;
 }
 
-bool CoherentStateCache::add_code(KeyValue kv, CoherentStateRoot* root, StateViewId view_id) {
-    auto [it, inserted] = root->code_cache.insert(kv);
-    SILKRPC_DEBUG << "Code cache kv.key=" << silkworm::to_hex(kv.key) << " inserted=" << inserted << " view=" << view_id << "\n";
-    KeyValue* replaced{nullptr};
-    if (!inserted) {
-        replaced = &*it;
-        root->code_cache.erase(it);
-        std::tie(it, inserted) = root->code_cache.insert(kv);
-        SILKWORM_ASSERT(inserted);
+void CoherentStateCache::add_absent(const silkworm::Bytes& key, CoherentStateRoot* root, StateViewId view_id) {
+    // The storage of the contracts not tracked would go stale as well, because their changes are skipped
+    if (config_.max_absent_keys == 0 || !is_cacheable(key)) {
+        return;
     }
+    root->absent_keys.insert_or_assign(key, true);
+    SILKRPC_DEBUG << "Absent key=" << silkworm::to_hex(key) << " view=" << view_id << "\n";
     if (latest_state_view_id_ != view_id) {
-        return inserted;
-    }
-    if (replaced != nullptr) {
-        code_evictions_.remove(*replaced);
-        SILKRPC_DEBUG << "Code evictions removed replaced.key=" << silkworm::to_hex(replaced->key) << "\n";
+        return;
     }
-    code_evictions_.push_front(kv);
 
-    // Remove longest unused key-value pair when size exceeded
-    if (code_evictions_.size() > config_.max_code_keys) {
-        const auto oldest = code_evictions_.back();
-        SILKRPC_DEBUG << "Code cache resize oldest.key=" << silkworm::to_hex(oldest.key) << "\n";
-        code_evictions_.pop_back();
-        const auto num_erased = root->code_cache.erase(oldest);
-        SILKWORM_ASSERT(num_erased == 1);
+    std::scoped_lock evictions_lock{evictions_mutex_};
+    if (const auto evicted = absent_evictions_.insert(key)) {
+        root->absent_keys.erase(*evicted);
     }
-    return inserted;
 }
 
 boost::asio::awaitable<std::optional<silkworm::Bytes>> CoherentStateCache::get(const silkworm::Bytes& key, Transaction& txn) {
-    std::shared_lock read_lock{rw_mutex_};
-
     const auto view_id = txn.tx_id();
-    const auto root_it = state_view_roots_.find(view_id);
-    if (root_it == state_view_roots_.end()) {
-        co_return std::nullopt;
+
+    if (const auto* local_value = find_local(view_id, key)) {
+        state_hit_count_.fetch_add(1, std::memory_order_relaxed);
+        SILKRPC_PROBE(state_cache_hit, key.data(), key.size());
+        co_return *local_value;
+    }
+
+    // The storage of the contracts not tracked is never cached, just count its reads to track the hot contracts
+    if (!is_cacheable(key)) {
+        storage_filter_.record_read(silkworm::to_evmc_address(key));
+    }
+
+    // Take a snapshot of the view cache, then search it without holding any lock
+    KeyValueMap cache;
+    AbsentKeySet absent_keys;
+    bool is_latest_view{false};
+    {
+        std::shared_lock read_lock{rw_mutex_};
+        const auto root_it = state_view_roots_.find(view_id);
+        if (root_it == state_view_roots_.end()) {
+            co_return std::nullopt;
+        }
+        cache = root_it->second->cache;
+        absent_keys = root_it->second->absent_keys;
+        is_latest_view = view_id == latest_state_view_id_;
     }
 
-    KeyValue kv{key};
-    auto& cache = root_it->second->cache;
-    const auto kv_it = cache.find(kv);
-    if (kv_it != cache.end()) {
-        ++state_hit_count_;
+    if (const auto* cached_value = cache.find(key)) {
+        state_hit_count_.fetch_add(1, std::memory_order_relaxed);
+        SILKRPC_PROBE(state_cache_hit, key.data(), key.size());
 
-        SILKRPC_DEBUG << "Hit in state cache key=" << key << " value=" << kv_it->value << "\n";
+        SILKRPC_DEBUG << "Hit in state cache key=" << key << " value=" << *cached_value << "\n";
 
-        if (view_id == latest_state_view_id_) {
-            state_evictions_.remove(kv);
-            state_evictions_.push_front(kv);
+        if (is_latest_view) {
+            std::scoped_lock evictions_lock{evictions_mutex_};
+            state_evictions_->touch(key);
         }
+        put_local(view_id, key, *cached_value);
 
-        co_return kv_it->value;
+        co_return *cached_value;
     }
 
-    ++state_miss_count_;
+    if (absent_keys.contains(key)) {
+        state_hit_count_.fetch_add(1, std::memory_order_relaxed);
+        absent_hit_count_.fetch_add(1, std::memory_order_relaxed);
+        SILKRPC_PROBE(state_cache_hit, key.data(), key.size());
+        if (is_latest_view) {
+            std::scoped_lock evictions_lock{evictions_mutex_};
+            absent_evictions_.touch(key);
+        }
+        co_return std::nullopt;
+    }
+
+    state_miss_count_.fetch_add(1, std::memory_order_relaxed);
+    SILKRPC_PROBE(state_cache_miss, key.data(), key.size());
 
     TransactionDatabase tx_database{txn};
     const auto value = co_await tx_database.get_one(db::table::kPlainState, key);
     SILKRPC_DEBUG << "Miss in state cache: lookup in PlainState key=" << key << " value=" << value << "\n";
     if (value.empty()) {
+        if (config_.max_absent_keys > 0) {
+            // The view may have been evicted while looking up the database
+            std::unique_lock write_lock{rw_mutex_};
+            const auto root_it = state_view_roots_.find(view_id);
+            if (root_it != state_view_roots_.end()) {
+                add_absent(key, root_it->second.get(), view_id);
+            }
+        }
         co_return std::nullopt;
     }
+    put_local(view_id, key, value);
 
-    read_lock.unlock();
+    // The view may have been evicted while looking up the database
     std::unique_lock write_lock{rw_mutex_};
-
-    add({key, value}, root_it->second.get(), view_id);
+    const auto root_it = state_view_roots_.find(view_id);
+    if (root_it != state_view_roots_.end()) {
+        add({key, value}, root_it->second.get(), view_id);
+    }
 
     co_return value;
 }
 
-boost::asio::awaitable<std::optional<silkworm::Bytes>> CoherentStateCache::get_code(const silkworm::Bytes& key, Transaction& txn) {
-    std::shared_lock read_lock{rw_mutex_};
-
+boost::asio::awaitable<std::vector<std::optional<silkworm::Bytes>>> CoherentStateCache::get_many(const std::vector<silkworm::Bytes>& keys,
+                                                                                                Transaction& txn) {
     const auto view_id = txn.tx_id();
-    const auto root_it = state_view_roots_.find(view_id);
-    if (root_it == state_view_roots_.end()) {
-        co_return std::nullopt;
+    std::vector<std::optional<silkworm::Bytes>> values(keys.size());
+
+    // Serve the keys found in the thread-local cache first, the shared view is searched only for the others
+    std::vector<bool> local_hits(keys.size(), false);
+    std::size_t num_local_hits{0};
+    for (std::size_t i{0}; i < keys.size(); ++i) {
+        if (const auto* local_value = find_local(view_id, keys[i])) {
+            values[i] = *local_value;
+            local_hits[i] = true;
+            ++num_local_hits;
+        }
+    }
+    if (num_local_hits == keys.size()) {
+        state_hit_count_.fetch_add(num_local_hits, std::memory_order_relaxed);
+        SILKRPC_PROBE(state_cache_get_many, keys.size(), num_local_hits);
+        co_return values;
+    }
+
+    // Take a snapshot of the view cache, then search it without holding any lock
+    KeyValueMap cache;
+    AbsentKeySet absent_keys;
+    bool is_latest_view{false};
+    {
+        std::shared_lock read_lock{rw_mutex_};
+        const auto root_it = state_view_roots_.find(view_id);
+        if (root_it == state_view_roots_.end()) {
+            co_return values;
+        }
+        cache = root_it->second->cache;
+        absent_keys = root_it->second->absent_keys;
+        is_latest_view = view_id == latest_state_view_id_;
+    }
+
+    std::vector<std::size_t> miss_indexes;
+    std::vector<silkworm::Bytes> miss_keys;
+    std::vector<std::size_t> absent_indexes;
+    for (std::size_t i{0}; i < keys.size(); ++i) {
+        if (local_hits[i]) {
+            continue;
+        }
+        if (const auto* cached_value = cache.find(keys[i])) {
+            values[i] = *cached_value;
+            put_local(view_id, keys[i], *cached_value);
+        } else if (absent_keys.contains(keys[i])) {
+            absent_indexes.push_back(i);
+        } else {
+            if (!is_cacheable(keys[i])) {
+                storage_filter_.record_read(silkworm::to_evmc_address(keys[i]));
+            }
+            miss_indexes.push_back(i);
+            miss_keys.push_back(keys[i]);
+        }
+    }
+    const auto num_hits = keys.size() - miss_keys.size();
+    state_hit_count_.fetch_add(num_hits, std::memory_order_relaxed);
+    state_miss_count_.fetch_add(miss_keys.size(), std::memory_order_relaxed);
+    SILKRPC_PROBE(state_cache_get_many, keys.size(), num_hits);
+    absent_hit_count_.fetch_add(absent_indexes.size(), std::memory_order_relaxed);
+    SILKRPC_DEBUG << "CoherentStateCache::get_many keys=" << keys.size() << " hits=" << num_hits << " local_hits=" << num_local_hits
+                  << " absent_hits=" << absent_indexes.size() << "\n";
+
+    if (is_latest_view && num_hits > num_local_hits) {
+        std::scoped_lock evictions_lock{evictions_mutex_};
+        for (std::size_t i{0}; i < keys.size(); ++i) {
+            if (values[i] && !local_hits[i]) {
+                state_evictions_->touch(keys[i]);
+            }
+        }
+        for (const auto i : absent_indexes) {
+            absent_evictions_.touch(keys[i]);
+        }
     }
 
-    KeyValue kv{key};
-    auto& code_cache = root_it->second->code_cache;
-    const auto kv_it = code_cache.find(kv);
-    if (kv_it != code_cache.end()) {
-        ++code_hit_count_;
+    if (miss_keys.empty()) {
+        co_return values;
+    }
 
-        SILKRPC_DEBUG << "Hit in code cache key=" << key << " value=" << kv_it->value << "\n";
+    // Look up all the missing keys in one pipelined round trip
+    TransactionDatabase tx_database{txn};
+    auto miss_values = co_await tx_database.get_many(db::table::kPlainState, miss_keys);
 
-        if (view_id == latest_state_view_id_) {
-            code_evictions_.remove(kv);
-            code_evictions_.push_front(kv);
+    // The view may have been evicted while looking up the database
+    std::unique_lock write_lock{rw_mutex_};
+    const auto root_it = state_view_roots_.find(view_id);
+    for (std::size_t i{0}; i < miss_values.size(); ++i) {
+        if (miss_values[i].empty()) {
+            if (root_it != state_view_roots_.end()) {
+                add_absent(miss_keys[i], root_it->second.get(), view_id);
+            }
+            continue;
         }
+        put_local(view_id, miss_keys[i], miss_values[i]);
+        if (root_it != state_view_roots_.end()) {
+            add({miss_keys[i], miss_values[i]}, root_it->second.get(), view_id);
+        }
+        values[miss_indexes[i]] = std::move(miss_values[i]);
+    }
+
+    co_return values;
+}
 
-        co_return kv_it->value;
+boost::asio::awaitable<std::optional<silkworm::Bytes>> CoherentStateCache::get_code(const silkworm::Bytes& key, Transaction& txn) {
+    // The code is the same whatever the view, so the shared store is searched without taking any view snapshot
+    if (const auto cached_value = code_store_.find(key)) {
+        code_hit_count_.fetch_add(1, std::memory_order_relaxed);
+        SILKRPC_PROBE(code_cache_hit, key.data(), key.size());
+
+        SILKRPC_DEBUG << "Hit in code cache key=" << key << " value=" << *cached_value << "\n";
+
+        co_return *cached_value;
     }
 
-    ++code_miss_count_;
+    code_miss_count_.fetch_add(1, std::memory_order_relaxed);
+    SILKRPC_PROBE(code_cache_miss, key.data(), key.size());
 
     TransactionDatabase tx_database{txn};
     const auto value = co_await tx_database.get_one(db::table::kCode, key);
@@ -293,12 +869,58 @@ boost::asio::awaitable<std::optional<silkworm::Bytes>> CoherentStateCache::get_c
         co_return std::nullopt;
     }
 
-    read_lock.unlock();
+    code_store_.insert(key, value);
+
+    co_return value;
+}
+
+HotKeys CoherentStateCache::hot_keys() {
+    auto code_keys = code_store_.keys();
+    std::scoped_lock evictions_lock{evictions_mutex_};
+    return HotKeys{state_evictions_->keys(), std::move(code_keys)};
+}
+
+std::optional<HotKeys> CoherentStateCache::take_reorg_hot_keys() {
+    std::scoped_lock evictions_lock{evictions_mutex_};
+    return std::exchange(reorg_hot_keys_, std::nullopt);
+}
+
+std::size_t CoherentStateCache::warm_up(StateViewId view_id, const std::vector<KeyValue>& state_kvs, const std::vector<KeyValue>& code_kvs) {
     std::unique_lock write_lock{rw_mutex_};
+    CoherentStateRoot* root{nullptr};
+    if (latest_state_view_ == nullptr) {
+        // No state changes received yet: the view read by warm up becomes the latest one, the next view will derive from it
+        root = get_root(view_id);
+        root->ready = true;
+        root->canonical = true;
+        latest_state_view_id_ = view_id;
+        latest_state_view_ = root;
+    } else if (view_id == latest_state_view_id_ && latest_state_view_->ready) {
+        root = latest_state_view_;
+    } else {
+        SILKRPC_DEBUG << "CoherentStateCache::warm_up view_id=" << view_id << " latest=" << latest_state_view_id_ << " skipped\n";
+        return 0;
+    }
+
+    // Add the least recently used first, so that the most recently used end up in front of the eviction lists
+    for (auto it = state_kvs.crbegin(); it != state_kvs.crend(); ++it) {
+        add(*it, root, view_id);
+    }
+    for (auto it = code_kvs.crbegin(); it != code_kvs.crend(); ++it) {
+        code_store_.insert(it->key, it->value);
+    }
 
-    add_code({key, value}, root_it->second.get(), view_id);
+    state_key_count_.store(root->cache.size(), std::memory_order_relaxed);
+    std::scoped_lock evictions_lock{evictions_mutex_};
+    state_eviction_count_.store(state_evictions_->size(), std::memory_order_relaxed);
 
-    co_return value;
+    return state_kvs.size() + code_kvs.size();
+}
+
+void CoherentStateCache::set_max_state_keys(uint32_t max_state_keys) {
+    std::scoped_lock evictions_lock{evictions_mutex_};
+    config_.max_state_keys = max_state_keys;
+    state_evictions_->set_max_keys(max_state_keys);
 }
 
 CoherentStateRoot* CoherentStateCache::get_root(StateViewId view_id) {
@@ -312,24 +934,51 @@ CoherentStateRoot* CoherentStateCache::get_root(StateViewId view_id) {
     return new_root_it->second.get();
 }
 
-CoherentStateRoot* CoherentStateCache::advance_root(StateViewId view_id) {
+CoherentStateRoot* CoherentStateCache::advance_root(StateViewId view_id, std::optional<silkworm::BlockNum> unwind_block) {
     CoherentStateRoot* root = get_root(view_id);
 
+    // The unwind is shallow enough if the keys changed by all the unwound blocks have been recorded
+    const bool shallow_unwind = unwind_block && !changed_keys_by_block_.empty() && changed_keys_by_block_.cbegin()->first <= *unwind_block;
+
     const auto previous_root_it = state_view_roots_.find(view_id - 1);
     if (previous_root_it != state_view_roots_.end() && previous_root_it->second->canonical) {
         SILKRPC_DEBUG << "CoherentStateCache::advance_root canonical view_id-1=" << (view_id - 1) << " found\n";
         root->cache = previous_root_it->second->cache;
-        root->code_cache = previous_root_it->second->code_cache;
+        root->absent_keys = previous_root_it->second->absent_keys;
+        if (unwind_block) {
+            unwind_root(root, *unwind_block);
+        }
+    } else if (shallow_unwind && latest_state_view_ != nullptr && latest_state_view_ != root && latest_state_view_->ready) {
+        // Chain reorganization back to some recorded block: the latest view holds the state of the common ancestor except for
+        // the keys changed since, hence it is reused dropping just such keys, whose values at the new chain are in the batch
+        SILKRPC_DEBUG << "CoherentStateCache::advance_root shallow unwind to block=" << *unwind_block << " from view="
+                      << latest_state_view_id_ << "\n";
+        root->cache = latest_state_view_->cache;
+        root->absent_keys = latest_state_view_->absent_keys;
+        unwind_root(root, *unwind_block);
     } else {
+        changed_keys_by_block_.clear();
         SILKRPC_DEBUG << "CoherentStateCache::advance_root canonical view_id-1=" << (view_id - 1) << " not found\n";
-        state_evictions_.clear();
-        for (const auto& kv : root->cache) {
-            state_evictions_.push_front(kv);
+        std::scoped_lock evictions_lock{evictions_mutex_};
+        if (latest_state_view_ != nullptr && latest_state_view_ != root) {
+            // Chain reorganization: keep the hot keys of the abandoned view, so that they can be read again at the new one.
+            // The code store is shared by all the views instead, hence it survives the reorganization
+            reorg_hot_keys_ = HotKeys{state_evictions_->keys(), {}};
         }
-        code_evictions_.clear();
-        for (const auto& kv : root->code_cache) {
-            code_evictions_.push_front(kv);
+        state_evictions_->clear();
+        // The keys absent at the abandoned view may exist at the new one, and no change of theirs is recorded
+        root->absent_keys = {};
+        absent_evictions_.clear();
+        std::vector<silkworm::Bytes> evicted_keys;
+        root->cache.for_each([&](const auto& key, const auto& /*value*/) {
+            if (auto evicted = state_evictions_->insert(key)) {
+                evicted_keys.push_back(std::move(*evicted));
+            }
+        });
+        for (const auto& key : evicted_keys) {
+            root->cache.erase(key);
         }
+        state_evicted_count_.fetch_add(evicted_keys.size(), std::memory_order_relaxed);
     }
     root->canonical = true;
 
@@ -338,12 +987,30 @@ CoherentStateRoot* CoherentStateCache::advance_root(StateViewId view_id) {
     latest_state_view_id_ = view_id;
     latest_state_view_ = root;
 
-    state_eviction_count_ = state_evictions_.size();
-    code_eviction_count_ = code_evictions_.size();
+    std::scoped_lock evictions_lock{evictions_mutex_};
+    state_eviction_count_.store(state_evictions_->size(), std::memory_order_relaxed);
 
     return root;
 }
 
+void CoherentStateCache::unwind_root(CoherentStateRoot* root, silkworm::BlockNum unwind_block) {
+    std::scoped_lock evictions_lock{evictions_mutex_};
+    uint64_t num_unwound{0};
+    for (auto it = changed_keys_by_block_.lower_bound(unwind_block); it != changed_keys_by_block_.end();) {
+        for (const auto& key : it->second) {
+            if (root->cache.erase(key) > 0) {
+                state_evictions_->erase(key);
+                ++num_unwound;
+            }
+            if (root->absent_keys.erase(key) > 0) {
+                absent_evictions_.erase(key);
+            }
+        }
+        it = changed_keys_by_block_.erase(it);
+    }
+    state_unwound_count_.fetch_add(num_unwound, std::memory_order_relaxed);
+}
+
 void CoherentStateCache::evict_roots(StateViewId next_view_id) {
     SILKRPC_DEBUG << "CoherentStateCache::evict_roots state_view_roots_.size()=" << state_view_roots_.size() << "\n";
     if (state_view_roots_.size() <= config_.max_views) {
@@ -355,6 +1022,8 @@ void CoherentStateCache::evict_roots(StateViewId next_view_id) {
             auto const& [view_id, _] = item;
             return view_id != next_view_id;
         });
+        // The values kept by the thread-local caches for the reused view IDs must never be served again
+        local_owner_.store(make_local_cache_owner(), std::memory_order_release);
         return;
     }
     // Erase older state views in order not to exceed max_views
@@ -366,4 +1035,24 @@ void CoherentStateCache::evict_roots(StateViewId next_view_id) {
     });
 }
 
+namespace {
+
+using LocalStateCache = LocalCache<silkworm::Bytes, silkworm::Bytes, BytesHash, kNumLocalStateKeys>;
+
+//! The cache of the thread, i.e. of the execution context running on it: no locking needed
+LocalStateCache& local_state_cache() {
+    thread_local LocalStateCache local_cache;
+    return local_cache;
+}
+
+} // namespace
+
+const silkworm::Bytes* CoherentStateCache::find_local(StateViewId view_id, const silkworm::Bytes& key) const {
+    return local_state_cache().find(local_owner_.load(std::memory_order_acquire), view_id, key);
+}
+
+void CoherentStateCache::put_local(StateViewId view_id, const silkworm::Bytes& key, const silkworm::Bytes& value) const {
+    local_state_cache().put(local_owner_.load(std::memory_order_acquire), view_id, key, value);
+}
+
 }  // namespace silkrpc::ethdb::kv
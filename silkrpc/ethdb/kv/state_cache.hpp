@@ -17,19 +17,28 @@
 #ifndef SILKRPC_ETHDB_KV_STATE_CACHE_HPP_
 #define SILKRPC_ETHDB_KV_STATE_CACHE_HPP_
 
+#include <atomic>
 #include <cstddef>
-#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include <silkrpc/config.hpp>
 
-#include <absl/container/btree_set.h>
+#include <absl/strings/string_view.h>
 #include <boost/asio/awaitable.hpp>
 
+#include <silkrpc/common/compressed_bytes.hpp>
+#include <silkrpc/common/local_cache.hpp>
+#include <silkrpc/common/persistent_map.hpp>
 #include <silkrpc/common/util.hpp>
+#include <silkrpc/ethdb/kv/storage_filter.hpp>
 #include <silkrpc/ethdb/transaction.hpp>
 #include <silkrpc/interfaces/remote/kv.pb.h>
 #include <silkworm/common/base.hpp>
@@ -42,9 +51,20 @@ public:
 
     virtual boost::asio::awaitable<std::optional<silkworm::Bytes>> get(const silkworm::Bytes& key) = 0;
 
+    //! Get the value of each key in the same order. The default implementation just calls get for each key
+    virtual boost::asio::awaitable<std::vector<std::optional<silkworm::Bytes>>> get_many(const std::vector<silkworm::Bytes>& keys);
+
     virtual boost::asio::awaitable<std::optional<silkworm::Bytes>> get_code(const silkworm::Bytes& key) = 0;
 };
 
+using StateViewId = uint64_t;
+
+//! The keys of the latest state view ordered from the most to the least recently used, persisted to warm up the cache
+struct HotKeys {
+    std::vector<silkworm::Bytes> state_keys;
+    std::vector<silkworm::Bytes> code_keys;
+};
+
 class StateCache {
 public:
     virtual std::unique_ptr<StateView> get_view(Transaction& txn) = 0;
@@ -53,6 +73,7 @@ public:
 
     virtual std::size_t latest_data_size() = 0;
     virtual std::size_t latest_code_size() = 0;
+    virtual std::size_t view_count() = 0;
 
     virtual uint64_t state_hit_count() const = 0;
     virtual uint64_t state_miss_count() const = 0;
@@ -62,26 +83,322 @@ public:
     virtual uint64_t code_miss_count() const = 0;
     virtual uint64_t code_key_count() const = 0;
     virtual uint64_t code_eviction_count() const = 0;
+    virtual uint64_t state_evicted_count() const = 0;
+    virtual uint64_t code_evicted_count() const = 0;
+
+    //! Return the keys of the latest state view, the most recently used first
+    virtual HotKeys hot_keys() = 0;
+
+    //! Return the hot keys of the state view abandoned by the latest chain reorganization, if any, just once
+    virtual std::optional<HotKeys> take_reorg_hot_keys() = 0;
+
+    //! Add the key-value pairs read at the specified view, if it is the latest one or there is no view yet.
+    //! The pairs are expected in most recently used order, return the number of pairs added
+    virtual std::size_t warm_up(StateViewId view_id, const std::vector<KeyValue>& state_kvs, const std::vector<KeyValue>& code_kvs) = 0;
+
+    //! Change the max number of state keys, the keys in excess being evicted gradually by the next state changes
+    virtual void set_max_state_keys(uint32_t max_state_keys) = 0;
+
+    //! Change the code budget in bytes, the code in excess being evicted gradually by the next code insertions
+    virtual void set_max_code_bytes(std::size_t max_code_bytes) = 0;
 };
 
+struct BytesHash {
+    std::size_t operator()(const silkworm::Bytes& bytes) const {
+        return std::hash<std::string_view>{}({reinterpret_cast<const char*>(bytes.data()), bytes.size()});
+    }
+};
+
+//! The persistent key-value map of each state view, sharing the unchanged nodes with the state view it derives from
+using KeyValueMap = PersistentHashMap<silkworm::Bytes, silkworm::Bytes, BytesHash>;
+
+//! The persistent set of the keys found absent at each state view, sharing the unchanged nodes like KeyValueMap
+using AbsentKeySet = PersistentHashMap<silkworm::Bytes, bool, BytesHash>;
+
 struct CoherentStateRoot {
-    absl::btree_set<KeyValue> cache;
-    absl::btree_set<KeyValue> code_cache;
+    KeyValueMap cache;
+    AbsentKeySet absent_keys;
     bool ready{false};
     bool canonical{false};
 };
 
-using StateViewId = uint64_t;
-
 constexpr auto kDefaultMaxViews{5ul};
 constexpr auto kDefaultMaxStateKeys{1'000'000u};
-constexpr auto kDefaultMaxCodeKeys{10'000u};
+constexpr auto kDefaultMaxCodeBytes{std::size_t{256} * 1024 * 1024};
+
+//! The number of state keys kept in the thread-local cache in front of the state views (see CoherentStateCache)
+constexpr std::size_t kNumLocalStateKeys{1024};
+
+//! The number of latest blocks whose changed keys are recorded, i.e. the deepest unwind keeping the latest view cache
+constexpr std::size_t kMaxUnwindBlocks{16};
+
+//! The policy evicting the state keys when exceeding the max state keys
+enum class EvictionPolicyType {
+    lru,       // least recently used, the cheapest but scan-sensitive
+    w_tinylfu, // least recently used filtered by access frequency, resistant to the scans of many keys
+};
+
+bool AbslParseFlag(absl::string_view text, EvictionPolicyType* type, std::string* error);
+std::string AbslUnparseFlag(EvictionPolicyType type);
 
 struct CoherentCacheConfig {
     uint64_t max_views{kDefaultMaxViews};
     bool with_storage{true};
     uint32_t max_state_keys{kDefaultMaxStateKeys};
-    uint32_t max_code_keys{kDefaultMaxCodeKeys};
+    std::size_t max_code_bytes{kDefaultMaxCodeBytes};
+    EvictionPolicyType eviction_policy{EvictionPolicyType::lru};
+    std::vector<evmc::address> storage_addresses; // the contracts whose storage is cached, all if empty and no auto ones
+    std::size_t max_auto_storage_addresses{0}; // the contracts whose storage is cached once read often (see StorageFilter)
+    uint32_t max_absent_keys{0}; // the keys found absent whose absence is cached (i.e. negative lookups), 0 means disabled
+    std::size_t code_compression_threshold{0}; // the code at least this long is kept compressed (see CodeStore), 0 means never
+};
+
+//! The keys in LRU order, most recently used first. The list is intrusive: the links are kept in the hash map entries
+//! along with the keys, so that each key is stored once and moving a key allocates nothing
+class KeyEvictionList {
+public:
+    KeyEvictionList() = default;
+
+    KeyEvictionList(const KeyEvictionList&) = delete;
+    KeyEvictionList& operator=(const KeyEvictionList&) = delete;
+
+    //! Move the key to the front, inserting it if not present
+    void push_front(const silkworm::Bytes& key);
+
+    //! Move the key to the front only if present
+    void touch(const silkworm::Bytes& key);
+
+    //! Remove the key, if present
+    void erase(const silkworm::Bytes& key);
+
+    bool contains(const silkworm::Bytes& key) const { return entries_.contains(key); }
+
+    //! Return the least recently used key, the list must not be empty
+    const silkworm::Bytes& back() const { return tail_->first; }
+
+    //! Remove and return the least recently used key
+    silkworm::Bytes pop_back();
+
+    void clear();
+
+    std::size_t size() const { return entries_.size(); }
+
+    //! Return the keys, the most recently used first
+    std::vector<silkworm::Bytes> keys() const;
+
+private:
+    struct Links;
+    using Entry = std::pair<const silkworm::Bytes, Links>;
+    struct Links {
+        Entry* prev{nullptr};
+        Entry* next{nullptr};
+    };
+
+    void link_front(Entry* entry);
+    void unlink(Entry* entry);
+
+    //! The nodes of an unordered map are never moved, so the links stay valid across rehashing
+    std::unordered_map<silkworm::Bytes, Links, BytesHash> entries_;
+    Entry* head_{nullptr};
+    Entry* tail_{nullptr};
+};
+
+//! The max number of extra evictions per insertion after shrinking the cache budget, so that the cache converges to the
+//! new budget gradually instead of evicting all the excess at once
+constexpr std::size_t kMaxShrinkEvictions{4};
+
+//! The policy choosing the keys of the latest state view to evict when exceeding the max number of keys
+class EvictionPolicy {
+public:
+    virtual ~EvictionPolicy() = default;
+
+    //! Record the insertion or the update of the key, return the key to evict to stay within the max keys, if any
+    virtual std::optional<silkworm::Bytes> insert(const silkworm::Bytes& key) = 0;
+
+    //! Record a hit of the key, if tracked
+    virtual void touch(const silkworm::Bytes& key) = 0;
+
+    //! Stop tracking the key, if tracked
+    virtual void erase(const silkworm::Bytes& key) = 0;
+
+    //! Forget all the tracked keys
+    virtual void clear() = 0;
+
+    //! Stop tracking the least worth keeping key and return it, if any
+    virtual std::optional<silkworm::Bytes> evict() = 0;
+
+    //! Change the max keys, the keys in excess (if any) being left to evict()
+    virtual void set_max_keys(std::size_t max_keys) = 0;
+
+    virtual std::size_t size() const = 0;
+
+    //! Return the tracked keys, the most worth keeping first
+    virtual std::vector<silkworm::Bytes> keys() const = 0;
+};
+
+//! Evict the least recently used key
+class LruEvictionPolicy : public EvictionPolicy {
+public:
+    explicit LruEvictionPolicy(std::size_t max_keys) : max_keys_{max_keys} {}
+
+    std::optional<silkworm::Bytes> insert(const silkworm::Bytes& key) override;
+    void touch(const silkworm::Bytes& key) override { keys_.touch(key); }
+    void erase(const silkworm::Bytes& key) override { keys_.erase(key); }
+    void clear() override { keys_.clear(); }
+    std::optional<silkworm::Bytes> evict() override;
+    void set_max_keys(std::size_t max_keys) override { max_keys_ = max_keys; }
+    std::size_t size() const override { return keys_.size(); }
+    std::vector<silkworm::Bytes> keys() const override { return keys_.keys(); }
+
+private:
+    std::size_t max_keys_;
+    KeyEvictionList keys_;
+};
+
+//! Approximate access frequency of the keys, using a count-min sketch of four rows of 4-bit counters (i.e. saturating at 15)
+//! taking 8 bytes per key. All the counters are halved once the number of recorded accesses reaches ten times the max keys,
+//! so that the old hits fade away
+class FrequencySketch {
+public:
+    static constexpr uint8_t kMaxCount{15};
+
+    explicit FrequencySketch(std::size_t max_keys);
+
+    //! Record one access of the key, incrementing only the smallest counters (i.e. conservative update)
+    void increment(const silkworm::Bytes& key);
+
+    //! Return the estimated number of accesses of the key since the last halvings
+    uint8_t frequency(const silkworm::Bytes& key) const;
+
+    //! Return the number of times the counters have been halved
+    uint64_t reset_count() const { return reset_count_; }
+
+private:
+    static constexpr std::size_t kNumRows{4};
+    static constexpr std::size_t kCountersPerKey{4};
+
+    std::size_t index_of(std::size_t hash, std::size_t row) const;
+    uint8_t count_at(std::size_t index) const;
+
+    std::vector<uint8_t> counters_;
+    std::size_t row_mask_;
+    std::size_t sample_size_;
+    std::size_t additions_{0};
+    uint64_t reset_count_{0};
+};
+
+//! Window TinyLFU: the new keys enter a small LRU window, then the keys leaving the window compete for admission into the
+//! main segmented LRU against its eviction victim, winning only if accessed more frequently. The main area is split into
+//! probation (keys seen once there) and protected (keys hit again there), so that one-off scans of many keys go through
+//! the window and probation only, without pushing out the frequently used keys
+class WTinyLfuEvictionPolicy : public EvictionPolicy {
+public:
+    //! The percentage of the max keys making up the window and the protected segment, respectively
+    static constexpr std::size_t kWindowPercentage{1};
+    static constexpr std::size_t kProtectedPercentage{80};
+
+    explicit WTinyLfuEvictionPolicy(std::size_t max_keys);
+
+    std::optional<silkworm::Bytes> insert(const silkworm::Bytes& key) override;
+    void touch(const silkworm::Bytes& key) override;
+    void erase(const silkworm::Bytes& key) override;
+    void clear() override;
+    std::optional<silkworm::Bytes> evict() override;
+    void set_max_keys(std::size_t max_keys) override;
+    std::size_t size() const override { return window_.size() + probation_.size() + protected_.size(); }
+    std::vector<silkworm::Bytes> keys() const override;
+
+    const FrequencySketch& sketch() const { return sketch_; }
+
+private:
+    //! Admit the candidate leaving the window into probation, return the key to evict if the main area is full
+    std::optional<silkworm::Bytes> admit(silkworm::Bytes candidate);
+
+    //! Record one more hit of a key tracked in the main area
+    void promote(const silkworm::Bytes& key);
+
+    std::size_t window_capacity_{0};
+    std::size_t main_capacity_{0};
+    std::size_t protected_capacity_{0};
+    FrequencySketch sketch_;
+    KeyEvictionList window_;
+    KeyEvictionList probation_;
+    KeyEvictionList protected_;
+};
+
+//! Create the eviction policy of the specified type for the max keys
+std::unique_ptr<EvictionPolicy> make_eviction_policy(EvictionPolicyType type, std::size_t max_keys);
+
+//! Store of the contract code by code hash shared by all the state views, since the code is immutable for a given hash:
+//! any view serves the code read or changed at any other view and the code survives chain reorganizations, whilst each
+//! view keeps just the account data holding the code hash. The code is stored once whatever the number of views and the
+//! store is bounded by the approximate memory footprint of the code, evicting the least recently used code first.
+//! The code at least as long as the compression threshold is kept compressed (see CompressedBytes) and accounted by its
+//! compressed size, so that the same budget holds more of the big contracts, each hit decompressing it outside the lock.
+class CodeStore {
+public:
+    //! The approximate memory overhead of each entry, i.e. the map node, the eviction list node and the reference count
+    static constexpr std::size_t kEntryOverhead{192};
+
+    explicit CodeStore(std::size_t max_bytes, std::size_t compression_threshold = 0)
+    : max_bytes_{max_bytes}, compression_threshold_{compression_threshold} {}
+
+    CodeStore(const CodeStore&) = delete;
+    CodeStore& operator=(const CodeStore&) = delete;
+
+    //! Return the code for the code hash key, if any, or nullptr otherwise, marking it as the most recently used
+    std::shared_ptr<const silkworm::Bytes> find(const silkworm::Bytes& key);
+
+    //! Insert the code as the most recently used, evicting the least recently used ones as needed to stay within budget
+    //! (the inserted code is always kept), return true if inserted or false if already present
+    bool insert(const silkworm::Bytes& key, const silkworm::Bytes& code);
+
+    std::size_t size() const;
+
+    //! Return the approximate number of bytes accounted for all the stored code
+    std::size_t size_bytes() const;
+
+    //! Return the number of code entries evicted for exceeding the budget
+    uint64_t evicted_count() const;
+
+    //! Return the code hash keys, the most recently used first
+    std::vector<silkworm::Bytes> keys() const;
+
+    std::size_t max_bytes() const;
+
+    //! Change the budget, any code in excess being evicted gradually by the next insertions (see kMaxShrinkEvictions)
+    void set_max_bytes(std::size_t max_bytes);
+
+    //! Return the approximate memory footprint of the code entry
+    static std::size_t approximate_size(const silkworm::Bytes& key, const silkworm::Bytes& code) {
+        return key.size() + code.size() + kEntryOverhead;
+    }
+
+    //! Return the approximate memory footprint of the compressed code entry
+    static std::size_t approximate_size(const silkworm::Bytes& key, const CompressedBytes& code) {
+        return key.size() + code.stored_size() + kEntryOverhead;
+    }
+
+private:
+    //! The code kept either as it is or compressed
+    struct Entry {
+        std::shared_ptr<const silkworm::Bytes> code;
+        std::shared_ptr<const CompressedBytes> compressed_code;
+
+        std::size_t size_bytes(const silkworm::Bytes& key) const {
+            return code ? approximate_size(key, *code) : approximate_size(key, *compressed_code);
+        }
+    };
+
+    const std::size_t compression_threshold_;
+
+    //! The mutex protecting all the members below
+    mutable std::mutex mutex_;
+    std::size_t max_bytes_;
+    std::unordered_map<silkworm::Bytes, Entry, BytesHash> codes_;
+    KeyEvictionList evictions_;
+    std::size_t size_bytes_{0};
+    uint64_t evicted_count_{0};
 };
 
 class CoherentStateCache;
@@ -95,6 +412,8 @@ public:
 
     boost::asio::awaitable<std::optional<silkworm::Bytes>> get(const silkworm::Bytes& key) override;
 
+    boost::asio::awaitable<std::vector<std::optional<silkworm::Bytes>>> get_many(const std::vector<silkworm::Bytes>& keys) override;
+
     boost::asio::awaitable<std::optional<silkworm::Bytes>> get_code(const silkworm::Bytes& key) override;
 
 private:
@@ -102,6 +421,9 @@ private:
     CoherentStateCache* cache_;
 };
 
+//! The state views are shared among all the execution contexts, so the values found by each thread are also kept in a small
+//! thread-local cache in front (see LocalCache), tagged with their view: the value of a key at a given view never changes,
+//! so the hot keys of the latest view are served without taking any shared lock or copying any view snapshot.
 class CoherentStateCache : public StateCache {
 public:
     explicit CoherentStateCache(CoherentCacheConfig config = {});
@@ -115,48 +437,113 @@ public:
 
     std::size_t latest_data_size() override;
     std::size_t latest_code_size() override;
+    std::size_t view_count() override;
+
+    uint64_t state_hit_count() const override { return state_hit_count_.load(std::memory_order_relaxed); }
+    uint64_t state_miss_count() const override { return state_miss_count_.load(std::memory_order_relaxed); }
+    uint64_t state_key_count() const override { return state_key_count_.load(std::memory_order_relaxed); }
+    uint64_t state_eviction_count() const override { return state_eviction_count_.load(std::memory_order_relaxed); }
+    uint64_t code_hit_count() const override { return code_hit_count_.load(std::memory_order_relaxed); }
+    uint64_t code_miss_count() const override { return code_miss_count_.load(std::memory_order_relaxed); }
+    uint64_t code_key_count() const override { return code_store_.size(); }
+    uint64_t code_eviction_count() const override { return code_store_.size(); }
+    uint64_t state_evicted_count() const override { return state_evicted_count_.load(std::memory_order_relaxed); }
+    uint64_t code_evicted_count() const override { return code_store_.evicted_count(); }
+
+    HotKeys hot_keys() override;
+    std::optional<HotKeys> take_reorg_hot_keys() override;
+    std::size_t warm_up(StateViewId view_id, const std::vector<KeyValue>& state_kvs, const std::vector<KeyValue>& code_kvs) override;
+    void set_max_state_keys(uint32_t max_state_keys) override;
+    void set_max_code_bytes(std::size_t max_code_bytes) override { code_store_.set_max_bytes(max_code_bytes); }
+
+    //! The contracts whose storage is cached, the storage changes of the others being skipped
+    const StorageFilter& storage_filter() const { return storage_filter_; }
 
-    uint64_t state_hit_count() const override { return state_hit_count_; }
-    uint64_t state_miss_count() const override { return state_miss_count_; }
-    uint64_t state_key_count() const override { return state_key_count_; }
-    uint64_t state_eviction_count() const override { return state_eviction_count_; }
-    uint64_t code_hit_count() const override { return code_hit_count_; }
-    uint64_t code_miss_count() const override { return code_miss_count_; }
-    uint64_t code_key_count() const override { return code_key_count_; }
-    uint64_t code_eviction_count() const override { return code_eviction_count_; }
+    //! The total number of keys dropped from the latest view for being changed by some unwound block
+    uint64_t state_unwound_count() const { return state_unwound_count_.load(std::memory_order_relaxed); }
+
+    //! The total number of lookups served as absent by the negative cache, without reading the database
+    uint64_t absent_hit_count() const { return absent_hit_count_.load(std::memory_order_relaxed); }
+
+    //! The number of keys known to be absent at the latest view
+    std::size_t absent_key_count();
 
 private:
     friend class CoherentStateView;
 
-    void process_upsert_change(CoherentStateRoot* root, StateViewId view_id, const remote::AccountChange& change);
-    void process_code_change(CoherentStateRoot* root, StateViewId view_id, const remote::AccountChange& change);
-    void process_delete_change(CoherentStateRoot* root, StateViewId view_id, const remote::AccountChange& change);
-    void process_storage_change(CoherentStateRoot* root, StateViewId view_id, const remote::AccountChange& change);
+    void process_upsert_change(CoherentStateRoot* root, StateViewId view_id, const remote::AccountChange& change,
+                               std::vector<silkworm::Bytes>* changed_keys);
+    void process_code_change(const remote::AccountChange& change);
+    void process_delete_change(CoherentStateRoot* root, StateViewId view_id, const remote::AccountChange& change,
+                               std::vector<silkworm::Bytes>* changed_keys);
+    void process_storage_change(CoherentStateRoot* root, StateViewId view_id, const remote::AccountChange& change,
+                                std::vector<silkworm::Bytes>* changed_keys);
     bool add(KeyValue kv, CoherentStateRoot* root, StateViewId view_id);
-    bool add_code(KeyValue kv, CoherentStateRoot* root, StateViewId view_id);
+
+    //! Record the key as absent at the view, if the negative cache is enabled: any later change of the key forgets it
+    void add_absent(const silkworm::Bytes& key, CoherentStateRoot* root, StateViewId view_id);
+
+    //! Return true if the key is an account or the storage of a tracked contract, i.e. it can be cached
+    bool is_cacheable(const silkworm::Bytes& key) const;
     boost::asio::awaitable<std::optional<silkworm::Bytes>> get(const silkworm::Bytes& key, Transaction& txn);
+    boost::asio::awaitable<std::vector<std::optional<silkworm::Bytes>>> get_many(const std::vector<silkworm::Bytes>& keys, Transaction& txn);
     boost::asio::awaitable<std::optional<silkworm::Bytes>> get_code(const silkworm::Bytes& key, Transaction& txn);
     CoherentStateRoot* get_root(StateViewId view_id);
-    CoherentStateRoot* advance_root(StateViewId view_id);
+    CoherentStateRoot* advance_root(StateViewId view_id, std::optional<silkworm::BlockNum> unwind_block);
+
+    //! Drop from the root the keys changed by the recorded blocks from the unwind block onwards, forgetting such blocks
+    void unwind_root(CoherentStateRoot* root, silkworm::BlockNum unwind_block);
     void evict_roots(StateViewId next_view_id);
 
+    //! Return the value of the key at the view in the thread-local cache, if any, or nullptr otherwise
+    const silkworm::Bytes* find_local(StateViewId view_id, const silkworm::Bytes& key) const;
+
+    //! Keep the value of the key at the view in the thread-local cache
+    void put_local(StateViewId view_id, const silkworm::Bytes& key, const silkworm::Bytes& value) const;
+
     CoherentCacheConfig config_;
 
     std::map<StateViewId, std::unique_ptr<CoherentStateRoot>> state_view_roots_;
     StateViewId latest_state_view_id_{0};
     CoherentStateRoot* latest_state_view_{nullptr};
-    std::list<KeyValue> state_evictions_;
-    std::list<KeyValue> code_evictions_;
+    std::unique_ptr<EvictionPolicy> state_evictions_;
+
+    //! The absent keys of the latest view in LRU order, so that probing many keys keeps them within max_absent_keys
+    LruEvictionPolicy absent_evictions_;
+
+    //! The code shared by all the views, having its own locking
+    CodeStore code_store_;
+
+    //! The contracts whose storage is cached, having its own locking
+    StorageFilter storage_filter_;
+
+    //! The hot keys of the latest state view before the last reorganization, waiting to be taken for warm up
+    std::optional<HotKeys> reorg_hot_keys_;
+
+    //! The keys changed by each of the last kMaxUnwindBlocks blocks applied to the latest view, so that an unwind to any
+    //! of them reuses the latest view cache dropping just such keys. Accessed only by on_new_block, hence not locked
+    std::map<silkworm::BlockNum, std::vector<silkworm::Bytes>> changed_keys_by_block_;
+
+    //! The mutex protecting the state view roots, held only to get or publish a root snapshot and never across lookups
     std::shared_mutex rw_mutex_;
 
-    uint64_t state_hit_count_{0};
-    uint64_t state_miss_count_{0};
-    uint64_t state_key_count_{0};
-    uint64_t state_eviction_count_{0};
-    uint64_t code_hit_count_{0};
-    uint64_t code_miss_count_{0};
-    uint64_t code_key_count_{0};
-    uint64_t code_eviction_count_{0};
+    //! The mutex protecting the state and absent eviction policies, acquired after rw_mutex_ when both are needed
+    std::mutex evictions_mutex_;
+
+    //! The statistics are relaxed atomics, so that hits and misses are counted without holding any lock
+    std::atomic<uint64_t> state_hit_count_{0};
+    std::atomic<uint64_t> state_miss_count_{0};
+    std::atomic<uint64_t> state_key_count_{0};
+    std::atomic<uint64_t> state_eviction_count_{0};
+    std::atomic<uint64_t> code_hit_count_{0};
+    std::atomic<uint64_t> code_miss_count_{0};
+    //! The total number of keys evicted for exceeding the max keys
+    std::atomic<uint64_t> state_evicted_count_{0};
+    std::atomic<uint64_t> state_unwound_count_{0};
+    std::atomic<uint64_t> absent_hit_count_{0};
+
+    //! The owner id tagging the values of this cache in the thread-local caches, renewed when the view IDs wrap
+    std::atomic<uint64_t> local_owner_{make_local_cache_owner()};
 };
 
 }  // namespace silkrpc::ethdb::kv
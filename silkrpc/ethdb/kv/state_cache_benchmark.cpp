@@ -0,0 +1,110 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "state_cache.hpp"
+
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/endian/conversion.hpp>
+#include <evmc/evmc.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/rpc/common/conversion.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/test/dummy_transaction.hpp>
+
+namespace silkrpc::ethdb::kv {
+
+using evmc::literals::operator""_bytes32;
+
+static constexpr uint64_t kFirstViewId{3'000'000};
+static constexpr uint64_t kFirstBlockNumber{15'000'000};
+static constexpr auto kBlockHash{0x8e38b4dbf6b11fcc3b9dee84fb7986e29ca0a02cecd8977c161ff7333329681e_bytes32};
+static const silkworm::Bytes kAccountData{*silkworm::from_hex("0f01020203e8010520f1885eda54b7a053318cd41e2093220dab15d65381b1157a3633a83bfd5c9239")};
+
+//! Return the address of the i-th account changed in the batches
+static evmc::address account_address(uint32_t i) {
+    evmc::address address{};
+    boost::endian::store_big_u32(address.bytes + sizeof(address.bytes) - sizeof(uint32_t), i);
+    return address;
+}
+
+//! The state changes of one block upserting the specified number of accounts
+static remote::StateChangeBatch make_batch(uint64_t view_id, uint64_t block_number, uint32_t num_accounts) {
+    remote::StateChangeBatch batch;
+    batch.set_databaseviewid(view_id);
+    remote::StateChange* change = batch.add_changebatch();
+    change->set_blockheight(block_number);
+    change->set_allocated_blockhash(silkworm::rpc::H256_from_bytes32(kBlockHash).release());
+    change->set_direction(remote::Direction::FORWARD);
+    for (uint32_t i{0}; i < num_accounts; ++i) {
+        remote::AccountChange* account_change = change->add_changes();
+        account_change->set_allocated_address(silkworm::rpc::H160_from_address(account_address(i)).release());
+        account_change->set_action(remote::Action::UPSERT);
+        account_change->set_incarnation(0);
+        account_change->set_data(kAccountData.data(), kAccountData.size());
+    }
+    return batch;
+}
+
+static void BM_CoherentStateCache_on_new_block(benchmark::State& state) {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    const auto num_accounts = static_cast<uint32_t>(state.range(0));
+    CoherentStateCache cache;
+    auto batch = make_batch(kFirstViewId, kFirstBlockNumber, num_accounts);
+    uint64_t block_offset{0};
+    for (auto _ : state) {
+        batch.set_databaseviewid(kFirstViewId + block_offset);
+        batch.mutable_changebatch(0)->set_blockheight(kFirstBlockNumber + block_offset);
+        ++block_offset;
+        cache.on_new_block(batch);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CoherentStateCache_on_new_block)->Arg(10)->Arg(500);
+
+//! Read the accounts all present in the latest view, i.e. the cache hit path
+static void BM_CoherentStateCache_get(benchmark::State& state) {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    constexpr uint32_t kNumAccounts{1'000};
+    CoherentStateCache cache;
+    cache.on_new_block(make_batch(kFirstViewId, kFirstBlockNumber, kNumAccounts));
+    std::vector<silkworm::Bytes> keys;
+    for (uint32_t i{0}; i < kNumAccounts; ++i) {
+        const auto address = account_address(i);
+        keys.emplace_back(address.bytes, silkworm::kAddressLength);
+    }
+    test::DummyTransaction txn{kFirstViewId, nullptr};
+    boost::asio::io_context io_context;
+    boost::asio::co_spawn(io_context, [&]() -> boost::asio::awaitable<void> {
+        const auto view = cache.get_view(txn);
+        std::size_t i{0};
+        for (auto _ : state) {
+            const auto value = co_await view->get(keys[i++ % kNumAccounts]);
+            benchmark::DoNotOptimize(value);
+        }
+    }, boost::asio::detached);
+    io_context.run();
+}
+BENCHMARK(BM_CoherentStateCache_get);
+
+} // namespace silkrpc::ethdb::kv
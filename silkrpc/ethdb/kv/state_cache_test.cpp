@@ -18,6 +18,7 @@
 
 #include <limits>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -83,22 +84,306 @@ TEST_CASE("CoherentStateRoot", "[silkrpc][ethdb][kv][state_cache]") {
     SECTION("CoherentStateRoot::CoherentStateRoot") {
         CoherentStateRoot root;
         CHECK(root.cache.empty());
-        CHECK(root.code_cache.empty());
         CHECK(!root.ready);
         CHECK(!root.canonical);
     }
 }
 
+TEST_CASE("CodeStore", "[silkrpc][ethdb][kv][state_cache]") {
+    const silkworm::Bytes key1(silkworm::kHashLength, 1);
+    const silkworm::Bytes key2(silkworm::kHashLength, 2);
+    const silkworm::Bytes key3(silkworm::kHashLength, 3);
+
+    SECTION("insert and find") {
+        CodeStore store{kDefaultMaxCodeBytes};
+        CHECK(store.find(key1) == nullptr);
+        CHECK(store.insert(key1, kTestCode1));
+        CHECK(!store.insert(key1, kTestCode1));
+        const auto code = store.find(key1);
+        CHECK(code != nullptr);
+        if (code) {
+            CHECK(*code == kTestCode1);
+        }
+        CHECK(store.size() == 1);
+        CHECK(store.size_bytes() == CodeStore::approximate_size(key1, kTestCode1));
+    }
+
+    SECTION("least recently used evicted when exceeding max bytes") {
+        CodeStore store{CodeStore::approximate_size(key1, kTestCode1) + CodeStore::approximate_size(key2, kTestCode2)};
+        CHECK(store.insert(key1, kTestCode1));
+        CHECK(store.insert(key2, kTestCode2));
+        CHECK(store.find(key1) != nullptr);
+        CHECK(store.insert(key3, kTestCode3));
+        CHECK(store.size() == 2);
+        CHECK(store.evicted_count() == 1);
+        CHECK(store.find(key2) == nullptr);
+        CHECK(store.keys() == std::vector<silkworm::Bytes>{key3, key1});
+    }
+
+    SECTION("code larger than max bytes kept alone") {
+        CodeStore store{1};
+        CHECK(store.insert(key1, kTestCode1));
+        CHECK(store.insert(key2, kTestCode2));
+        CHECK(store.size() == 1);
+        CHECK(store.find(key2) != nullptr);
+        CHECK(store.evicted_count() == 1);
+    }
+
+    SECTION("code above compression threshold kept compressed") {
+        const silkworm::Bytes big_code(4096, 0x60);
+        CodeStore store{kDefaultMaxCodeBytes, /*compression_threshold=*/1024};
+        CHECK(store.insert(key1, big_code));
+        CHECK(store.insert(key2, kTestCode1));
+        const auto code = store.find(key1);
+        REQUIRE(code != nullptr);
+        CHECK(*code == big_code);
+        const auto expected_size = CodeStore::approximate_size(key1, CompressedBytes{big_code, 1024}) +
+            CodeStore::approximate_size(key2, kTestCode1);
+        CHECK(store.size_bytes() == expected_size);
+        if (compression_available()) {
+            CHECK(store.size_bytes() < CodeStore::approximate_size(key1, big_code) + CodeStore::approximate_size(key2, kTestCode1));
+        }
+    }
+
+    SECTION("shrinking max bytes evicts gradually") {
+        const auto entry_size = CodeStore::approximate_size(key1, kTestCode1);
+        CodeStore store{8 * entry_size};
+        for (uint8_t i{0}; i < 8; ++i) {
+            CHECK(store.insert(silkworm::Bytes(silkworm::kHashLength, 10 + i), kTestCode1));
+        }
+        store.set_max_bytes(2 * entry_size);
+        CHECK(store.max_bytes() == 2 * entry_size);
+        CHECK(store.size() == 8);
+        CHECK(store.insert(key1, kTestCode1));
+        CHECK(store.size() == 8 + 1 - kMaxShrinkEvictions);
+        CHECK(store.insert(key2, kTestCode1));
+        CHECK(store.size() == 2);
+        CHECK(store.keys() == std::vector<silkworm::Bytes>{key2, key1});
+    }
+}
+
 TEST_CASE("CoherentCacheConfig", "[silkrpc][ethdb][kv][state_cache]") {
     SECTION("CoherentCacheConfig::CoherentCacheConfig") {
         CoherentCacheConfig config;
         CHECK(config.max_views == kDefaultMaxViews);
         CHECK(config.with_storage);
         CHECK(config.max_state_keys == kDefaultMaxStateKeys);
-        CHECK(config.max_code_keys == kDefaultMaxCodeKeys);
+        CHECK(config.max_code_bytes == kDefaultMaxCodeBytes);
+        CHECK(config.eviction_policy == EvictionPolicyType::lru);
+        CHECK(config.storage_addresses.empty());
+        CHECK(config.max_auto_storage_addresses == 0);
+    }
+}
+
+static silkworm::Bytes make_test_key(uint32_t index) {
+    silkworm::Bytes key(silkworm::kAddressLength, 0);
+    for (std::size_t i{0}; i < sizeof(index); ++i) {
+        key[i] = static_cast<uint8_t>(index >> (8 * i));
+    }
+    return key;
+}
+
+TEST_CASE("KeyEvictionList", "[silkrpc][ethdb][kv][state_cache]") {
+    const auto key1{make_test_key(1)};
+    const auto key2{make_test_key(2)};
+    const auto key3{make_test_key(3)};
+    KeyEvictionList list;
+
+    SECTION("push_front and touch") {
+        list.push_front(key1);
+        list.push_front(key2);
+        list.push_front(key3);
+        list.push_front(key1);
+        CHECK(list.keys() == std::vector<silkworm::Bytes>{key1, key3, key2});
+        list.touch(key2);
+        list.touch(make_test_key(4));
+        CHECK(list.keys() == std::vector<silkworm::Bytes>{key2, key1, key3});
+        CHECK(list.back() == key3);
+        CHECK(list.size() == 3);
+    }
+
+    SECTION("erase and pop_back") {
+        list.push_front(key1);
+        list.push_front(key2);
+        list.push_front(key3);
+        list.erase(key2);
+        CHECK(!list.contains(key2));
+        CHECK(list.pop_back() == key1);
+        CHECK(list.pop_back() == key3);
+        CHECK(list.size() == 0);
+        CHECK(list.keys().empty());
+        list.push_front(key2);
+        CHECK(list.keys() == std::vector<silkworm::Bytes>{key2});
+    }
+
+    SECTION("clear") {
+        list.push_front(key1);
+        list.push_front(key2);
+        list.clear();
+        CHECK(list.size() == 0);
+        list.push_front(key3);
+        CHECK(list.back() == key3);
+    }
+}
+
+TEST_CASE("LruEvictionPolicy", "[silkrpc][ethdb][kv][state_cache]") {
+    LruEvictionPolicy policy{2};
+    CHECK(!policy.insert(make_test_key(1)));
+    CHECK(!policy.insert(make_test_key(2)));
+    policy.touch(make_test_key(1));
+    CHECK(policy.insert(make_test_key(3)) == make_test_key(2));
+    CHECK(policy.keys() == std::vector<silkworm::Bytes>{make_test_key(3), make_test_key(1)});
+
+    SECTION("shrink max keys") {
+        policy.set_max_keys(1);
+        CHECK(policy.insert(make_test_key(4)) == make_test_key(1));
+        CHECK(policy.size() == 2);
+        CHECK(policy.evict() == make_test_key(3));
+        CHECK(policy.evict() == make_test_key(4));
+        CHECK(!policy.evict());
+    }
+
+    SECTION("erase") {
+        policy.erase(make_test_key(3));
+        policy.erase(make_test_key(2));
+        CHECK(policy.size() == 1);
+        CHECK(policy.keys() == std::vector<silkworm::Bytes>{make_test_key(1)});
+    }
+}
+
+TEST_CASE("FrequencySketch", "[silkrpc][ethdb][kv][state_cache]") {
+    FrequencySketch sketch{16};
+    CHECK(sketch.frequency(make_test_key(1)) == 0);
+
+    SECTION("increment") {
+        for (int i{0}; i < 5; ++i) {
+            sketch.increment(make_test_key(1));
+        }
+        CHECK(sketch.frequency(make_test_key(1)) == 5);
+    }
+
+    SECTION("saturate") {
+        for (int i{0}; i < 20; ++i) {
+            sketch.increment(make_test_key(1));
+        }
+        CHECK(sketch.frequency(make_test_key(1)) == FrequencySketch::kMaxCount);
+    }
+
+    SECTION("halve after sample size") {
+        for (int i{0}; i < 8; ++i) {
+            sketch.increment(make_test_key(1));
+        }
+        for (uint32_t i{100}; sketch.reset_count() == 0; ++i) {
+            sketch.increment(make_test_key(i));
+        }
+        CHECK(sketch.frequency(make_test_key(1)) == 4);
     }
 }
 
+TEST_CASE("WTinyLfuEvictionPolicy", "[silkrpc][ethdb][kv][state_cache]") {
+    SECTION("no eviction within max keys") {
+        WTinyLfuEvictionPolicy policy{100};
+        for (uint32_t i{0}; i < 100; ++i) {
+            CHECK(!policy.insert(make_test_key(i)));
+        }
+        CHECK(policy.size() == 100);
+        CHECK(policy.keys().size() == 100);
+    }
+
+    SECTION("update is not an insertion") {
+        WTinyLfuEvictionPolicy policy{2};
+        CHECK(!policy.insert(make_test_key(1)));
+        CHECK(!policy.insert(make_test_key(2)));
+        CHECK(!policy.insert(make_test_key(1)));
+        CHECK(policy.size() == 2);
+    }
+
+    SECTION("evict probation first") {
+        WTinyLfuEvictionPolicy policy{100};
+        for (uint32_t i{0}; i < 3; ++i) {
+            CHECK(!policy.insert(make_test_key(i)));
+        }
+        // The window holds just one key, the others have moved on probation
+        policy.set_max_keys(1);
+        CHECK(policy.evict() == make_test_key(0));
+        CHECK(policy.evict() == make_test_key(1));
+        CHECK(policy.evict() == make_test_key(2));
+        CHECK(!policy.evict());
+        CHECK(policy.insert(make_test_key(3)) == std::nullopt);
+        CHECK(policy.insert(make_test_key(4)) == make_test_key(3));
+    }
+
+    SECTION("erase from any segment") {
+        WTinyLfuEvictionPolicy policy{100};
+        for (uint32_t i{0}; i < 3; ++i) {
+            CHECK(!policy.insert(make_test_key(i)));
+        }
+        CHECK(!policy.insert(make_test_key(1))); // promoted to protected
+        policy.erase(make_test_key(0));
+        policy.erase(make_test_key(1));
+        policy.erase(make_test_key(2));
+        policy.erase(make_test_key(3));
+        CHECK(policy.size() == 0);
+        CHECK(!policy.evict());
+    }
+
+    SECTION("zero max keys") {
+        WTinyLfuEvictionPolicy policy{0};
+        CHECK(policy.insert(make_test_key(1)) == make_test_key(1));
+        CHECK(policy.size() == 0);
+    }
+
+    SECTION("frequently used keys survive a scan") {
+        constexpr std::size_t kMaxKeys{1'000};
+        constexpr uint32_t kNumHotKeys{500};
+        constexpr uint32_t kNumScanKeys{10'000};
+        for (const auto type : {EvictionPolicyType::lru, EvictionPolicyType::w_tinylfu}) {
+            auto policy = make_eviction_policy(type, kMaxKeys);
+            std::set<silkworm::Bytes> tracked_keys;
+            const auto insert = [&](const silkworm::Bytes& key) {
+                tracked_keys.insert(key);
+                if (const auto evicted = policy->insert(key)) {
+                    CHECK(tracked_keys.erase(*evicted) == 1);
+                }
+            };
+            for (uint32_t i{0}; i < kNumHotKeys; ++i) {
+                insert(make_test_key(i));
+            }
+            for (int n{0}; n < 3; ++n) {
+                for (uint32_t i{0}; i < kNumHotKeys; ++i) {
+                    policy->touch(make_test_key(i));
+                }
+            }
+            for (uint32_t i{0}; i < kNumScanKeys; ++i) {
+                insert(make_test_key(kNumHotKeys + i));
+            }
+            CHECK(policy->size() == kMaxKeys);
+            CHECK(tracked_keys.size() == kMaxKeys);
+
+            std::size_t num_hot_keys{0};
+            for (uint32_t i{0}; i < kNumHotKeys; ++i) {
+                num_hot_keys += tracked_keys.count(make_test_key(i));
+            }
+            if (type == EvictionPolicyType::lru) {
+                CHECK(num_hot_keys == 0);
+            } else {
+                // The sketch is approximate, a few scan keys may look as frequent as the hot ones
+                CHECK(num_hot_keys >= kNumHotKeys * 98 / 100);
+            }
+        }
+    }
+}
+
+TEST_CASE("EvictionPolicyType", "[silkrpc][ethdb][kv][state_cache]") {
+    std::string error;
+    EvictionPolicyType type{EvictionPolicyType::lru};
+    CHECK(AbslParseFlag("w_tinylfu", &type, &error));
+    CHECK(type == EvictionPolicyType::w_tinylfu);
+    CHECK(AbslUnparseFlag(type) == "w_tinylfu");
+    CHECK(!AbslParseFlag("lfu", &type, &error));
+    CHECK(!error.empty());
+}
+
 remote::StateChangeBatch new_batch(uint64_t view_id, silkworm::BlockNum block_height, const evmc::bytes32& block_hash,
                                    const std::vector<silkworm::Bytes>& tx_rlps, bool unwind) {
     remote::StateChangeBatch state_changes;
@@ -239,6 +524,8 @@ TEST_CASE("CoherentStateCache::CoherentStateCache", "[silkrpc][ethdb][kv][state_
         CHECK(cache.state_miss_count() == 0);
         CHECK(cache.state_key_count() == 0);
         CHECK(cache.state_eviction_count() == 0);
+        CHECK(cache.state_evicted_count() == 0);
+        CHECK(cache.view_count() == 0);
     }
 
     SECTION("wrong config") {
@@ -309,7 +596,7 @@ TEST_CASE("CoherentStateCache::get_view one view", "[silkrpc][ethdb][kv][state_c
         CHECK(cache.latest_code_size() == 1);
 
         test::MockTransaction txn;
-        EXPECT_CALL(txn, tx_id()).Times(4).WillRepeatedly(Return(kTestViewId0));
+        EXPECT_CALL(txn, tx_id()).Times(3).WillRepeatedly(Return(kTestViewId0));
 
         get_and_check_upsert(cache, txn, kTestAddress1, kTestAccountData);
 
@@ -323,7 +610,7 @@ TEST_CASE("CoherentStateCache::get_view one view", "[silkrpc][ethdb][kv][state_c
         CHECK(cache.code_hit_count() == 1);
         CHECK(cache.code_miss_count() == 0);
         CHECK(cache.code_key_count() == 1);
-        CHECK(cache.code_eviction_count() == 0);
+        CHECK(cache.code_eviction_count() == 1);
     }
 
     SECTION("single delete change batch => search hit") {
@@ -408,6 +695,75 @@ TEST_CASE("CoherentStateCache::get_view one view", "[silkrpc][ethdb][kv][state_c
         }
     }
 
+    SECTION("single storage change batch => multiple search hit and miss") {
+        auto batch = new_batch_with_storage(kTestViewId0, kTestBlockNumber, kTestBlockHash, kTestZeroTxs,
+                                            /*unwind=*/false, /*num_storage_changes=*/1);
+        cache.on_new_block(batch);
+        CHECK(cache.latest_data_size() == 1);
+
+        std::shared_ptr<test::MockCursor> mock_cursor = std::make_shared<test::MockCursor>();
+        test::DummyTransaction txn{kTestViewId0, mock_cursor};
+
+        std::unique_ptr<StateView> view = cache.get_view(txn);
+        CHECK(view != nullptr);
+        if (view) {
+            // Just the missing key is looked up in the database
+            EXPECT_CALL(*mock_cursor, seek_exact(_)).WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<KeyValue> {
+                co_return KeyValue{silkworm::Bytes{}, kTestStorageData2};
+            }));
+
+            const auto storage_key1 = composite_storage_key(kTestAddress1, kTestIncarnation, kTestHashedLocation1.bytes);
+            const auto storage_key2 = composite_storage_key(kTestAddress1, kTestIncarnation, kTestHashedLocation2.bytes);
+            auto result = boost::asio::co_spawn(pool, view->get_many({storage_key1, storage_key2}), boost::asio::use_future);
+            const auto values = result.get();
+            CHECK(values.size() == 2);
+            if (values.size() == 2) {
+                CHECK(values[0] == kTestStorageData1);
+                CHECK(values[1] == kTestStorageData2);
+            }
+            CHECK(cache.state_hit_count() == 1);
+            CHECK(cache.state_miss_count() == 1);
+            CHECK(cache.latest_data_size() == 2);
+        }
+    }
+
+    SECTION("single storage change batch => repeated multiple search in one context") {
+        auto batch = new_batch_with_storage(kTestViewId0, kTestBlockNumber, kTestBlockHash, kTestZeroTxs,
+                                            /*unwind=*/false, /*num_storage_changes=*/1);
+        cache.on_new_block(batch);
+        CHECK(cache.latest_data_size() == 1);
+
+        std::shared_ptr<test::MockCursor> mock_cursor = std::make_shared<test::MockCursor>();
+        test::DummyTransaction txn{kTestViewId0, mock_cursor};
+
+        std::unique_ptr<StateView> view = cache.get_view(txn);
+        CHECK(view != nullptr);
+        if (view) {
+            // The missing key is looked up in the database just once, then served by the cache of the context
+            EXPECT_CALL(*mock_cursor, seek_exact(_)).WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<KeyValue> {
+                co_return KeyValue{silkworm::Bytes{}, kTestStorageData2};
+            }));
+
+            const auto storage_key1 = composite_storage_key(kTestAddress1, kTestIncarnation, kTestHashedLocation1.bytes);
+            const auto storage_key2 = composite_storage_key(kTestAddress1, kTestIncarnation, kTestHashedLocation2.bytes);
+            for (int i{0}; i < 3; ++i) {
+                auto result = boost::asio::co_spawn(pool, view->get_many({storage_key1, storage_key2}), boost::asio::use_future);
+                const auto values = result.get();
+                CHECK(values.size() == 2);
+                if (values.size() == 2) {
+                    CHECK(values[0] == kTestStorageData1);
+                    CHECK(values[1] == kTestStorageData2);
+                }
+            }
+            auto result = boost::asio::co_spawn(pool, view->get(storage_key2), boost::asio::use_future);
+            CHECK(result.get() == kTestStorageData2);
+
+            CHECK(cache.state_hit_count() == 6);
+            CHECK(cache.state_miss_count() == 1);
+            CHECK(cache.latest_data_size() == 2);
+        }
+    }
+
     SECTION("double storage change batch => double search hit") {
         auto batch = new_batch_with_storage(kTestViewId0, kTestBlockNumber, kTestBlockHash, kTestZeroTxs,
                                             /*unwind=*/false, /*num_storage_changes=*/2);
@@ -448,7 +804,7 @@ TEST_CASE("CoherentStateCache::get_view one view", "[silkrpc][ethdb][kv][state_c
         CHECK(cache.latest_code_size() == 1);
 
         test::MockTransaction txn;
-        EXPECT_CALL(txn, tx_id()).Times(2).WillRepeatedly(Return(kTestViewId0));
+        EXPECT_CALL(txn, tx_id()).WillOnce(Return(kTestViewId0));
 
         std::unique_ptr<StateView> view = cache.get_view(txn);
         CHECK(view != nullptr);
@@ -464,11 +820,143 @@ TEST_CASE("CoherentStateCache::get_view one view", "[silkrpc][ethdb][kv][state_c
             CHECK(cache.code_hit_count() == 1);
             CHECK(cache.code_miss_count() == 0);
             CHECK(cache.code_key_count() == 1);
-            CHECK(cache.code_eviction_count() == 0);
+            CHECK(cache.code_eviction_count() == 1);
         }
     }
 }
 
+TEST_CASE("CoherentStateCache::on_new_block filters the storage changes", "[silkrpc][ethdb][kv][state_cache]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    boost::asio::thread_pool pool{1};
+
+    SECTION("storage change of tracked contract applied") {
+        CoherentCacheConfig config;
+        config.storage_addresses = {kTestAddress1};
+        CoherentStateCache cache{config};
+        auto batch = new_batch_with_storage(kTestViewId0, kTestBlockNumber, kTestBlockHash, kTestZeroTxs,
+                                            /*unwind=*/false, /*num_storage_changes=*/2);
+        cache.on_new_block(batch);
+        CHECK(cache.latest_data_size() == 2);
+        CHECK(cache.storage_filter().skipped_change_count() == 0);
+    }
+
+    SECTION("storage change of untracked contract skipped") {
+        CoherentCacheConfig config;
+        config.storage_addresses = {kTestAddress2};
+        CoherentStateCache cache{config};
+        auto batch = new_batch_with_storage(kTestViewId0, kTestBlockNumber, kTestBlockHash, kTestZeroTxs,
+                                            /*unwind=*/false, /*num_storage_changes=*/2);
+        cache.on_new_block(batch);
+        CHECK(cache.latest_data_size() == 0);
+        CHECK(cache.storage_filter().skipped_change_count() == 1);
+    }
+
+    SECTION("storage of untracked contract read from database and not cached") {
+        CoherentCacheConfig config;
+        config.storage_addresses = {kTestAddress2};
+        CoherentStateCache cache{config};
+        auto batch = new_batch_with_storage(kTestViewId0, kTestBlockNumber, kTestBlockHash, kTestZeroTxs,
+                                            /*unwind=*/false, /*num_storage_changes=*/1);
+        cache.on_new_block(batch);
+
+        std::shared_ptr<test::MockCursor> mock_cursor = std::make_shared<test::MockCursor>();
+        test::DummyTransaction txn{kTestViewId0, mock_cursor};
+
+        std::unique_ptr<StateView> view = cache.get_view(txn);
+        CHECK(view != nullptr);
+        if (view) {
+            EXPECT_CALL(*mock_cursor, seek_exact(_)).WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<KeyValue> {
+                co_return KeyValue{silkworm::Bytes{}, kTestStorageData1};
+            }));
+
+            const auto storage_key1 = composite_storage_key(kTestAddress1, kTestIncarnation, kTestHashedLocation1.bytes);
+            auto result = boost::asio::co_spawn(pool, view->get(storage_key1), boost::asio::use_future);
+            CHECK(result.get() == kTestStorageData1);
+            CHECK(cache.state_miss_count() == 1);
+            CHECK(cache.state_key_count() == 0);
+        }
+    }
+}
+
+TEST_CASE("CoherentStateCache::get caches the absent keys", "[silkrpc][ethdb][kv][state_cache]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    boost::asio::thread_pool pool{1};
+    const auto storage_key1 = composite_storage_key(kTestAddress1, kTestIncarnation, kTestHashedLocation1.bytes);
+    const auto storage_key2 = composite_storage_key(kTestAddress1, kTestIncarnation, kTestHashedLocation2.bytes);
+    const auto absent_lookup = []() -> boost::asio::awaitable<KeyValue> { co_return KeyValue{}; };
+
+    SECTION("disabled => absent key read again") {
+        CoherentStateCache cache;
+        cache.on_new_block(new_batch_with_upsert(kTestViewId0, kTestBlockNumber, kTestBlockHash, kTestZeroTxs, /*unwind=*/false));
+
+        std::shared_ptr<test::MockCursor> mock_cursor = std::make_shared<test::MockCursor>();
+        test::DummyTransaction txn{kTestViewId0, mock_cursor};
+        std::unique_ptr<StateView> view = cache.get_view(txn);
+        REQUIRE(view != nullptr);
+        EXPECT_CALL(*mock_cursor, seek_exact(_)).Times(2).WillRepeatedly(InvokeWithoutArgs(absent_lookup));
+        CHECK(!boost::asio::co_spawn(pool, view->get(storage_key2), boost::asio::use_future).get());
+        CHECK(!boost::asio::co_spawn(pool, view->get(storage_key2), boost::asio::use_future).get());
+        CHECK(cache.state_miss_count() == 2);
+        CHECK(cache.absent_key_count() == 0);
+        CHECK(cache.absent_hit_count() == 0);
+    }
+
+    CoherentCacheConfig config;
+    config.max_absent_keys = 1;
+    CoherentStateCache cache{config};
+    cache.on_new_block(new_batch_with_upsert(kTestViewId0, kTestBlockNumber, kTestBlockHash, kTestZeroTxs, /*unwind=*/false));
+
+    SECTION("absent key served without reading it again") {
+        std::shared_ptr<test::MockCursor> mock_cursor = std::make_shared<test::MockCursor>();
+        test::DummyTransaction txn{kTestViewId0, mock_cursor};
+        std::unique_ptr<StateView> view = cache.get_view(txn);
+        REQUIRE(view != nullptr);
+        EXPECT_CALL(*mock_cursor, seek_exact(_)).WillOnce(InvokeWithoutArgs(absent_lookup));
+        CHECK(!boost::asio::co_spawn(pool, view->get(storage_key2), boost::asio::use_future).get());
+        CHECK(cache.absent_key_count() == 1);
+        CHECK(!boost::asio::co_spawn(pool, view->get(storage_key2), boost::asio::use_future).get());
+        const auto values = boost::asio::co_spawn(pool, view->get_many({storage_key2}), boost::asio::use_future).get();
+        REQUIRE(values.size() == 1);
+        CHECK(!values[0]);
+        CHECK(cache.state_miss_count() == 1);
+        CHECK(cache.absent_hit_count() == 2);
+        CHECK(cache.latest_data_size() == 1);
+    }
+
+    SECTION("absent keys bounded by max absent keys") {
+        std::shared_ptr<test::MockCursor> mock_cursor = std::make_shared<test::MockCursor>();
+        test::DummyTransaction txn{kTestViewId0, mock_cursor};
+        std::unique_ptr<StateView> view = cache.get_view(txn);
+        REQUIRE(view != nullptr);
+        EXPECT_CALL(*mock_cursor, seek_exact(_)).Times(2).WillRepeatedly(InvokeWithoutArgs(absent_lookup));
+        const auto values = boost::asio::co_spawn(pool, view->get_many({storage_key1, storage_key2}), boost::asio::use_future).get();
+        CHECK(values == std::vector<std::optional<silkworm::Bytes>>{std::nullopt, std::nullopt});
+        CHECK(cache.absent_key_count() == 1);
+    }
+
+    SECTION("absent key forgotten when changed") {
+        std::shared_ptr<test::MockCursor> mock_cursor = std::make_shared<test::MockCursor>();
+        test::DummyTransaction txn0{kTestViewId0, mock_cursor};
+        std::unique_ptr<StateView> view0 = cache.get_view(txn0);
+        REQUIRE(view0 != nullptr);
+        EXPECT_CALL(*mock_cursor, seek_exact(_)).WillOnce(InvokeWithoutArgs(absent_lookup));
+        CHECK(!boost::asio::co_spawn(pool, view0->get(storage_key2), boost::asio::use_future).get());
+        CHECK(cache.absent_key_count() == 1);
+
+        cache.on_new_block(new_batch_with_storage(kTestViewId1, kTestBlockNumber + 1, kTestBlockHash, kTestZeroTxs,
+                                                  /*unwind=*/false, /*num_storage_changes=*/2));
+        CHECK(cache.absent_key_count() == 0);
+        test::DummyTransaction txn1{kTestViewId1, mock_cursor};
+        std::unique_ptr<StateView> view1 = cache.get_view(txn1);
+        REQUIRE(view1 != nullptr);
+        CHECK(boost::asio::co_spawn(pool, view1->get(storage_key2), boost::asio::use_future).get() == kTestStorageData2);
+
+        // The previous view still knows the key as absent
+        CHECK(!boost::asio::co_spawn(pool, view0->get(storage_key2), boost::asio::use_future).get());
+        CHECK(cache.absent_hit_count() == 1);
+    }
+}
+
 TEST_CASE("CoherentStateCache::get_view two views", "[silkrpc][ethdb][kv][state_cache]") {
     SILKRPC_LOG_VERBOSITY(LogLevel::None);
     CoherentStateCache cache;
@@ -511,26 +999,50 @@ TEST_CASE("CoherentStateCache::get_view two views", "[silkrpc][ethdb][kv][state_
         CHECK(cache.latest_code_size() == 2);
 
         test::MockTransaction txn1, txn2;
-        EXPECT_CALL(txn1, tx_id()).Times(2).WillRepeatedly(Return(kTestViewId1));
-        EXPECT_CALL(txn2, tx_id()).Times(4).WillRepeatedly(Return(kTestViewId2));
+        EXPECT_CALL(txn1, tx_id()).WillOnce(Return(kTestViewId1));
+        EXPECT_CALL(txn2, tx_id()).Times(2).WillRepeatedly(Return(kTestViewId2));
 
+        // The code is shared by all the views, whatever the view it has been changed at
         get_and_check_code(cache, txn1, kTestCode1);
+        get_and_check_code(cache, txn1, kTestCode2);
 
-        CHECK(cache.code_hit_count() == 1);
+        CHECK(cache.code_hit_count() == 2);
         CHECK(cache.code_miss_count() == 0);
         CHECK(cache.code_key_count() == 2);
-        CHECK(cache.code_eviction_count() == 1);
+        CHECK(cache.code_eviction_count() == 2);
 
         get_and_check_code(cache, txn2, kTestCode1);
         get_and_check_code(cache, txn2, kTestCode2);
 
-        CHECK(cache.code_hit_count() == 3);
+        CHECK(cache.code_hit_count() == 4);
         CHECK(cache.code_miss_count() == 0);
         CHECK(cache.code_key_count() == 2);
-        CHECK(cache.code_eviction_count() == 1);
+        CHECK(cache.code_eviction_count() == 2);
     }
 }
 
+TEST_CASE("CoherentStateCache::on_new_block keeps previous views unchanged", "[silkrpc][ethdb][kv][state_cache]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    CoherentStateCache cache;
+
+    cache.on_new_block(
+        new_batch_with_upsert(kTestViewId1, kTestBlockNumber, kTestBlockHash, kTestZeroTxs, /*unwind=*/false));
+    cache.on_new_block(
+        new_batch_with_delete(kTestViewId2, kTestBlockNumber + 1, kTestBlockHash, kTestZeroTxs, /*unwind=*/false));
+    CHECK(cache.latest_data_size() == 1);
+
+    test::MockTransaction txn1, txn2;
+    EXPECT_CALL(txn1, tx_id()).Times(2).WillRepeatedly(Return(kTestViewId1));
+    EXPECT_CALL(txn2, tx_id()).Times(2).WillRepeatedly(Return(kTestViewId2));
+
+    // The view derived from the previous one shares its unchanged entries but sees its own changes only
+    get_and_check_upsert(cache, txn1, kTestAddress1, kTestAccountData);
+    get_and_check_upsert(cache, txn2, kTestAddress1, silkworm::Bytes{});
+
+    CHECK(cache.state_hit_count() == 2);
+    CHECK(cache.state_miss_count() == 0);
+}
+
 TEST_CASE("CoherentStateCache::on_new_block exceed max views", "[silkrpc][ethdb][kv][state_cache]") {
     SILKRPC_LOG_VERBOSITY(LogLevel::None);
     const CoherentCacheConfig config;
@@ -563,7 +1075,9 @@ TEST_CASE("CoherentStateCache::on_new_block exceed max views", "[silkrpc][ethdb]
 TEST_CASE("CoherentStateCache::on_new_block exceed max keys", "[silkrpc][ethdb][kv][state_cache]") {
     SILKRPC_LOG_VERBOSITY(LogLevel::None);
     constexpr auto kMaxKeys{2u};
-    const CoherentCacheConfig config{kDefaultMaxViews, /*with_storage=*/true, kMaxKeys, kMaxKeys};
+    const silkworm::Bytes code_hash_key(silkworm::kHashLength, 0);
+    const auto kMaxCodeBytes{CodeStore::approximate_size(code_hash_key, kTestCode1) + CodeStore::approximate_size(code_hash_key, kTestCode2)};
+    const CoherentCacheConfig config{kDefaultMaxViews, /*with_storage=*/true, kMaxKeys, kMaxCodeBytes};
     CoherentStateCache cache{config};
 
     // Create as many data and code keys as the maximum allowed number
@@ -572,7 +1086,9 @@ TEST_CASE("CoherentStateCache::on_new_block exceed max keys", "[silkrpc][ethdb][
     CHECK(cache.state_key_count() == kMaxKeys);
     CHECK(cache.code_key_count() == kMaxKeys);
     CHECK(cache.state_eviction_count() == 0);
-    CHECK(cache.code_eviction_count() == 0);
+    CHECK(cache.code_eviction_count() == kMaxKeys);
+    CHECK(cache.state_evicted_count() == 0);
+    CHECK(cache.code_evicted_count() == 0);
 
     // Next incoming batch with *new keys* overflows the data and code keys
     cache.on_new_block(new_batch_with_upsert_code(kTestViewId1, kTestBlockNumber + 1, kTestBlockHash, kTestZeroTxs,
@@ -581,6 +1097,53 @@ TEST_CASE("CoherentStateCache::on_new_block exceed max keys", "[silkrpc][ethdb][
     CHECK(cache.code_key_count() == kMaxKeys);
     CHECK(cache.state_eviction_count() == kMaxKeys);
     CHECK(cache.code_eviction_count() == kMaxKeys);
+    CHECK(cache.state_evicted_count() == 2);
+    CHECK(cache.code_evicted_count() == 2);
+    CHECK(cache.view_count() == 2);
+}
+
+TEST_CASE("CoherentStateCache::on_new_block exceed max keys with W-TinyLFU", "[silkrpc][ethdb][kv][state_cache]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    constexpr auto kMaxKeys{2u};
+    CoherentCacheConfig config;
+    config.max_state_keys = kMaxKeys;
+    config.eviction_policy = EvictionPolicyType::w_tinylfu;
+    CoherentStateCache cache{config};
+
+    cache.on_new_block(new_batch_with_upsert_code(kTestViewId0, kTestBlockNumber, kTestBlockHash, kTestZeroTxs,
+                                                  /*unwind=*/false, /*num_changes=*/kMaxKeys));
+    CHECK(cache.state_key_count() == kMaxKeys);
+    CHECK(cache.state_evicted_count() == 0);
+
+    // Next incoming batch with *new keys* overflows the data keys, the new keys seen once are not admitted
+    cache.on_new_block(new_batch_with_upsert_code(kTestViewId1, kTestBlockNumber + 1, kTestBlockHash, kTestZeroTxs,
+                                                  /*unwind=*/false, /*num_changes=*/4, /*offset=*/2));
+    CHECK(cache.state_key_count() == kMaxKeys);
+    CHECK(cache.state_eviction_count() == kMaxKeys);
+    CHECK(cache.state_evicted_count() == 2);
+    CHECK(cache.view_count() == 2);
+}
+
+TEST_CASE("CoherentStateCache::set_max_state_keys", "[silkrpc][ethdb][kv][state_cache]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    CoherentCacheConfig config;
+    config.max_state_keys = 8;
+    CoherentStateCache cache{config};
+
+    cache.on_new_block(new_batch_with_upsert_code(kTestViewId0, kTestBlockNumber, kTestBlockHash, kTestZeroTxs,
+                                                  /*unwind=*/false, /*num_changes=*/8));
+    CHECK(cache.state_key_count() == 8);
+
+    // The keys in excess are evicted by the next insertions, up to kMaxShrinkEvictions more each one
+    cache.set_max_state_keys(2);
+    CHECK(cache.state_key_count() == 8);
+    cache.on_new_block(new_batch_with_upsert_code(kTestViewId1, kTestBlockNumber + 1, kTestBlockHash, kTestZeroTxs,
+                                                  /*unwind=*/false, /*num_changes=*/1, /*offset=*/8));
+    CHECK(cache.state_key_count() == 8 + 1 - 1 - kMaxShrinkEvictions);
+    cache.on_new_block(new_batch_with_upsert_code(kTestViewId2, kTestBlockNumber + 2, kTestBlockHash, kTestZeroTxs,
+                                                  /*unwind=*/false, /*num_changes=*/1, /*offset=*/9));
+    CHECK(cache.state_key_count() == 2);
+    CHECK(cache.state_evicted_count() == 8);
 }
 
 TEST_CASE("CoherentStateCache::on_new_block clear the cache on view ID wrapping", "[silkrpc][ethdb][kv][state_cache]") {
@@ -619,4 +1182,150 @@ TEST_CASE("CoherentStateCache::on_new_block clear the cache on view ID wrapping"
     }
 }
 
+TEST_CASE("CoherentStateCache::warm_up", "[silkrpc][ethdb][kv][state_cache]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    CoherentStateCache cache;
+
+    const silkworm::Bytes address_key1{kTestAddress1.bytes, silkworm::kAddressLength};
+    const silkworm::Bytes address_key2{kTestAddress2.bytes, silkworm::kAddressLength};
+    const ethash::hash256 code_hash{silkworm::keccak256(kTestCode1)};
+    const silkworm::Bytes code_hash_key{code_hash.bytes, silkworm::kHashLength};
+    const std::vector<KeyValue> state_kvs{{address_key1, kTestAccountData}, {address_key2, kTestAccountData}};
+    const std::vector<KeyValue> code_kvs{{code_hash_key, kTestCode1}};
+
+    SECTION("no view yet => warm view becomes the latest") {
+        CHECK(cache.warm_up(kTestViewId0, state_kvs, code_kvs) == 3);
+        CHECK(cache.latest_data_size() == 2);
+        CHECK(cache.latest_code_size() == 1);
+        CHECK(cache.state_key_count() == 2);
+        CHECK(cache.code_key_count() == 1);
+        CHECK(cache.view_count() == 1);
+
+        // The hot keys preserve the most recently used order
+        const auto hot_keys = cache.hot_keys();
+        CHECK(hot_keys.state_keys == std::vector<silkworm::Bytes>{address_key1, address_key2});
+        CHECK(hot_keys.code_keys == std::vector<silkworm::Bytes>{code_hash_key});
+
+        test::MockTransaction txn;
+        EXPECT_CALL(txn, tx_id()).Times(3).WillRepeatedly(Return(kTestViewId0));
+        get_and_check_upsert(cache, txn, kTestAddress1, kTestAccountData);
+        get_and_check_code(cache, txn, kTestCode1);
+        CHECK(cache.state_hit_count() == 1);
+        CHECK(cache.code_hit_count() == 1);
+    }
+
+    SECTION("next view derives from the warm view") {
+        CHECK(cache.warm_up(kTestViewId0, state_kvs, code_kvs) == 3);
+        cache.on_new_block(
+            new_batch_with_upsert(kTestViewId1, kTestBlockNumber, kTestBlockHash, kTestZeroTxs, /*unwind=*/false));
+        CHECK(cache.latest_data_size() == 2);
+        CHECK(cache.latest_code_size() == 1);
+        CHECK(!cache.take_reorg_hot_keys());
+
+        test::MockTransaction txn;
+        EXPECT_CALL(txn, tx_id()).Times(2).WillRepeatedly(Return(kTestViewId1));
+        get_and_check_upsert(cache, txn, kTestAddress2, kTestAccountData);
+    }
+
+    SECTION("stale view => skipped") {
+        cache.on_new_block(
+            new_batch_with_upsert(kTestViewId1, kTestBlockNumber, kTestBlockHash, kTestZeroTxs, /*unwind=*/false));
+        CHECK(cache.warm_up(kTestViewId0, state_kvs, code_kvs) == 0);
+        CHECK(cache.latest_data_size() == 1);
+        CHECK(cache.latest_code_size() == 0);
+    }
+
+    SECTION("latest view => added") {
+        cache.on_new_block(
+            new_batch_with_upsert(kTestViewId1, kTestBlockNumber, kTestBlockHash, kTestZeroTxs, /*unwind=*/false));
+        CHECK(cache.warm_up(kTestViewId1, {{address_key2, kTestAccountData}}, {}) == 1);
+        CHECK(cache.latest_data_size() == 2);
+        CHECK(cache.hot_keys().state_keys == std::vector<silkworm::Bytes>{address_key2, address_key1});
+    }
+}
+
+TEST_CASE("CoherentStateCache::take_reorg_hot_keys", "[silkrpc][ethdb][kv][state_cache]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    CoherentStateCache cache;
+    const silkworm::Bytes address_key1{kTestAddress1.bytes, silkworm::kAddressLength};
+
+    SECTION("no reorg => none") {
+        cache.on_new_block(
+            new_batch_with_upsert(kTestViewId0, kTestBlockNumber, kTestBlockHash, kTestZeroTxs, /*unwind=*/false));
+        cache.on_new_block(
+            new_batch_with_upsert(kTestViewId1, kTestBlockNumber + 1, kTestBlockHash, kTestZeroTxs, /*unwind=*/false));
+        CHECK(!cache.take_reorg_hot_keys());
+    }
+
+    SECTION("reorg => hot keys of the abandoned view taken once") {
+        cache.on_new_block(
+            new_batch_with_upsert(kTestViewId0, kTestBlockNumber, kTestBlockHash, kTestZeroTxs, /*unwind=*/false));
+        cache.on_new_block(
+            new_batch_with_delete(kTestViewId2, kTestBlockNumber - 1, kTestBlockHash, kTestZeroTxs, /*unwind=*/true));
+        const auto hot_keys = cache.take_reorg_hot_keys();
+        CHECK(hot_keys.has_value());
+        if (hot_keys) {
+            CHECK(hot_keys->state_keys == std::vector<silkworm::Bytes>{address_key1});
+            CHECK(hot_keys->code_keys.empty());
+        }
+        CHECK(!cache.take_reorg_hot_keys());
+    }
+}
+
+TEST_CASE("CoherentStateCache::on_new_block unwind", "[silkrpc][ethdb][kv][state_cache]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    CoherentStateCache cache;
+    const silkworm::Bytes address_key2{kTestAddress2.bytes, silkworm::kAddressLength};
+
+    // Block N changes the account, block N + 1 its storage and the account of another contract is read at N + 1
+    cache.on_new_block(new_batch_with_upsert(kTestViewId0, kTestBlockNumber, kTestBlockHash, kTestZeroTxs, /*unwind=*/false));
+    cache.on_new_block(new_batch_with_storage(kTestViewId1, kTestBlockNumber + 1, kTestBlockHash, kTestZeroTxs,
+                                              /*unwind=*/false, /*num_storage_changes=*/2));
+    CHECK(cache.warm_up(kTestViewId1, {{address_key2, kTestAccountData}}, {}) == 1);
+    CHECK(cache.latest_data_size() == 4);
+
+    SECTION("shallow unwind at next view => just the changed keys dropped") {
+        cache.on_new_block(
+            new_batch_with_delete(kTestViewId2, kTestBlockNumber + 1, kTestBlockHash, kTestZeroTxs, /*unwind=*/true));
+        CHECK(cache.latest_data_size() == 2);
+        CHECK(cache.state_unwound_count() == 2);
+        CHECK(cache.state_eviction_count() == 2);
+        CHECK(!cache.take_reorg_hot_keys());
+
+        test::MockTransaction txn;
+        EXPECT_CALL(txn, tx_id()).Times(2).WillRepeatedly(Return(kTestViewId2));
+        get_and_check_upsert(cache, txn, kTestAddress2, kTestAccountData);
+        CHECK(cache.state_hit_count() == 1);
+    }
+
+    SECTION("shallow unwind after view gap => latest view cache reused") {
+        cache.on_new_block(
+            new_batch_with_delete(kTestViewId2 + 1, kTestBlockNumber + 1, kTestBlockHash, kTestZeroTxs, /*unwind=*/true));
+        CHECK(cache.latest_data_size() == 2);
+        CHECK(cache.state_unwound_count() == 2);
+        CHECK(!cache.take_reorg_hot_keys());
+
+        test::MockTransaction txn;
+        EXPECT_CALL(txn, tx_id()).Times(2).WillRepeatedly(Return(kTestViewId2 + 1));
+        get_and_check_upsert(cache, txn, kTestAddress2, kTestAccountData);
+        CHECK(cache.state_hit_count() == 1);
+    }
+
+    SECTION("unwind of all recorded blocks after view gap => latest view cache reused") {
+        cache.on_new_block(
+            new_batch_with_delete(kTestViewId2 + 1, kTestBlockNumber, kTestBlockHash, kTestZeroTxs, /*unwind=*/true));
+        CHECK(cache.latest_data_size() == 2);
+        CHECK(cache.state_unwound_count() == 3);
+        CHECK(!cache.take_reorg_hot_keys());
+    }
+
+    SECTION("deep unwind after view gap => latest view cache dropped") {
+        cache.on_new_block(
+            new_batch_with_delete(kTestViewId2 + 1, kTestBlockNumber - 1, kTestBlockHash, kTestZeroTxs, /*unwind=*/true));
+        CHECK(cache.latest_data_size() == 1);
+        CHECK(cache.state_unwound_count() == 0);
+        CHECK(cache.take_reorg_hot_keys());
+    }
+}
+
 }  // namespace silkrpc::ethdb::kv
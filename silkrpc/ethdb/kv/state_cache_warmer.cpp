@@ -0,0 +1,212 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "state_cache_warmer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_future.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/concurrency/parallel_for.hpp>
+#include <silkrpc/ethdb/tables.hpp>
+#include <silkrpc/ethdb/transaction_database.hpp>
+
+namespace silkrpc::ethdb::kv {
+
+//! The file starts with a magic tag including the format version, then the state and code key counts each followed by its keys
+constexpr std::string_view kHotKeysMagic{"SRPCHK01"};
+
+static void write_uint(std::ofstream& output, uint64_t value, std::size_t size) {
+    for (std::size_t i{0}; i < size; ++i) {
+        output.put(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+static bool read_uint(std::ifstream& input, uint64_t& value, std::size_t size) {
+    value = 0;
+    for (std::size_t i{0}; i < size; ++i) {
+        const auto c = input.get();
+        if (c == std::ifstream::traits_type::eof()) {
+            return false;
+        }
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(c)) << (8 * i);
+    }
+    return true;
+}
+
+static void write_keys(std::ofstream& output, const std::vector<silkworm::Bytes>& keys) {
+    write_uint(output, keys.size(), sizeof(uint64_t));
+    for (const auto& key : keys) {
+        if (key.size() > std::numeric_limits<uint16_t>::max()) {
+            throw std::invalid_argument{"hot key too long: " + std::to_string(key.size())};
+        }
+        write_uint(output, key.size(), sizeof(uint16_t));
+        output.write(reinterpret_cast<const char*>(key.data()), static_cast<std::streamsize>(key.size()));
+    }
+}
+
+static bool read_keys(std::ifstream& input, std::vector<silkworm::Bytes>& keys) {
+    uint64_t num_keys{0};
+    if (!read_uint(input, num_keys, sizeof(uint64_t))) {
+        return false;
+    }
+    keys.clear();
+    for (uint64_t i{0}; i < num_keys; ++i) {
+        uint64_t key_size{0};
+        if (!read_uint(input, key_size, sizeof(uint16_t))) {
+            return false;
+        }
+        silkworm::Bytes key(key_size, '\0');
+        if (!input.read(reinterpret_cast<char*>(key.data()), static_cast<std::streamsize>(key_size))) {
+            return false;
+        }
+        keys.push_back(std::move(key));
+    }
+    return true;
+}
+
+void write_hot_keys(const std::filesystem::path& file_path, const HotKeys& hot_keys) {
+    // Write into a temporary file renamed at the end, so that an interrupted write never leaves a truncated file
+    auto tmp_file_path = file_path;
+    tmp_file_path += ".tmp";
+    {
+        std::ofstream output{tmp_file_path, std::ios::binary | std::ios::trunc};
+        if (!output) {
+            throw std::runtime_error{"cannot open hot keys file: " + tmp_file_path.string()};
+        }
+        output.write(kHotKeysMagic.data(), static_cast<std::streamsize>(kHotKeysMagic.size()));
+        write_keys(output, hot_keys.state_keys);
+        write_keys(output, hot_keys.code_keys);
+        if (!output.flush()) {
+            throw std::runtime_error{"cannot write hot keys file: " + tmp_file_path.string()};
+        }
+    }
+    std::filesystem::rename(tmp_file_path, file_path);
+}
+
+std::optional<HotKeys> read_hot_keys(const std::filesystem::path& file_path) {
+    std::ifstream input{file_path, std::ios::binary};
+    if (!input) {
+        SILKRPC_WARN << "Hot keys file not found: " << file_path << "\n";
+        return std::nullopt;
+    }
+    std::string magic(kHotKeysMagic.size(), '\0');
+    if (!input.read(magic.data(), static_cast<std::streamsize>(magic.size())) || magic != kHotKeysMagic) {
+        SILKRPC_WARN << "Hot keys file has unknown format: " << file_path << "\n";
+        return std::nullopt;
+    }
+    HotKeys hot_keys;
+    if (!read_keys(input, hot_keys.state_keys) || !read_keys(input, hot_keys.code_keys)) {
+        SILKRPC_WARN << "Hot keys file is truncated: " << file_path << "\n";
+        return std::nullopt;
+    }
+    return hot_keys;
+}
+
+StateCacheWarmer::StateCacheWarmer(Context& context, std::size_t batch_size, std::size_t max_concurrency)
+    : strand_{boost::asio::make_strand(*context.io_context())},
+      database_(*context.database()),
+      state_cache_(*context.state_cache()),
+      batch_size_(batch_size),
+      max_concurrency_(max_concurrency) {
+    if (batch_size == 0) {
+        throw std::invalid_argument{"unexpected zero batch_size"};
+    }
+}
+
+std::future<std::size_t> StateCacheWarmer::warm_up(HotKeys hot_keys) {
+    return boost::asio::co_spawn(strand_, run(std::move(hot_keys)), boost::asio::use_future);
+}
+
+void StateCacheWarmer::on_state_changes(const remote::StateChangeBatch& /*state_changes*/) {
+    auto hot_keys = state_cache_.take_reorg_hot_keys();
+    if (!hot_keys) {
+        return;
+    }
+    SILKRPC_INFO << "State cache warm up after reorg: " << hot_keys->state_keys.size() << " state keys, "
+                 << hot_keys->code_keys.size() << " code keys\n";
+    // The future is not awaited: the warm up runs in background and never throws
+    warm_up(std::move(*hot_keys));
+}
+
+boost::asio::awaitable<std::size_t> StateCacheWarmer::run(HotKeys hot_keys) {
+    // The hottest keys are read first, so that they are still in the latest view if a new block arrives meanwhile
+    std::vector<Batch> batches;
+    batches.reserve((hot_keys.state_keys.size() + hot_keys.code_keys.size()) / batch_size_ + 2);
+    for (std::size_t i{0}; i < hot_keys.state_keys.size(); i += batch_size_) {
+        batches.push_back(Batch{false, i, std::min(i + batch_size_, hot_keys.state_keys.size())});
+    }
+    for (std::size_t i{0}; i < hot_keys.code_keys.size(); i += batch_size_) {
+        batches.push_back(Batch{true, i, std::min(i + batch_size_, hot_keys.code_keys.size())});
+    }
+
+    std::size_t num_added{0};
+    try {
+        const auto executor = co_await boost::asio::this_coro::executor;
+        co_await parallel_for(executor, batches.size(), max_concurrency_, [&](std::size_t index) -> boost::asio::awaitable<void> {
+            num_added += co_await warm_up_batch(hot_keys, batches[index]);
+        });
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "StateCacheWarmer::run exception: " << e.what() << "\n";
+    }
+    SILKRPC_INFO << "State cache warm up added " << num_added << " keys\n";
+    co_return num_added;
+}
+
+boost::asio::awaitable<std::size_t> StateCacheWarmer::warm_up_batch(const HotKeys& hot_keys, const Batch& batch) {
+    const auto& keys = batch.code ? hot_keys.code_keys : hot_keys.state_keys;
+    const auto table = batch.code ? db::table::kCode : db::table::kPlainState;
+
+    std::vector<KeyValue> kvs;
+    kvs.reserve(batch.end - batch.begin);
+
+    auto tx = co_await database_.begin();
+    StateViewId view_id{0};
+    try {
+        view_id = tx->tx_id();
+        TransactionDatabase tx_database{*tx};
+        for (auto i{batch.begin}; i < batch.end; ++i) {
+            auto value = co_await tx_database.get_one(table, keys[i]);
+            // Keys deleted since the dump are just skipped, as the state cache does for missing keys
+            if (!value.empty()) {
+                kvs.push_back(KeyValue{keys[i], std::move(value)});
+            }
+        }
+    } catch (const std::exception& e) {
+        SILKRPC_WARN << "StateCacheWarmer::warm_up_batch exception: " << e.what() << "\n";
+        kvs.clear();
+    }
+    co_await tx->close();
+
+    if (kvs.empty()) {
+        co_return 0;
+    }
+    co_return batch.code ? state_cache_.warm_up(view_id, {}, kvs) : state_cache_.warm_up(view_id, kvs, {});
+}
+
+} // namespace silkrpc::ethdb::kv
@@ -0,0 +1,89 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_ETHDB_KV_STATE_CACHE_WARMER_HPP_
+#define SILKRPC_ETHDB_KV_STATE_CACHE_WARMER_HPP_
+
+#include <cstddef>
+#include <filesystem>
+#include <future>
+#include <optional>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/ethdb/database.hpp>
+#include <silkrpc/ethdb/kv/state_cache.hpp>
+#include <silkrpc/interfaces/remote/kv.pb.h>
+
+namespace silkrpc::ethdb::kv {
+
+//! The default number of keys read within the same transaction
+constexpr std::size_t kDefaultWarmUpBatchSize{1024};
+
+//! The default max number of batches read concurrently
+constexpr std::size_t kDefaultWarmUpConcurrency{8};
+
+//! Write the hot keys to the specified file, replacing its content
+void write_hot_keys(const std::filesystem::path& file_path, const HotKeys& hot_keys);
+
+//! Read the hot keys from the specified file, if present and well-formed
+std::optional<HotKeys> read_hot_keys(const std::filesystem::path& file_path);
+
+//! Prefetch the hot keys into the state cache: at startup from the keys persisted on shutdown and after each chain
+//! reorganization from the keys of the abandoned view. The keys are read in batches, each one within its own transaction
+//! and added to the cache only if its view is still the latest one.
+class StateCacheWarmer {
+public:
+    explicit StateCacheWarmer(Context& context, std::size_t batch_size = kDefaultWarmUpBatchSize,
+                              std::size_t max_concurrency = kDefaultWarmUpConcurrency);
+
+    StateCacheWarmer(const StateCacheWarmer&) = delete;
+    StateCacheWarmer& operator=(const StateCacheWarmer&) = delete;
+
+    //! Start reading the hot keys into the state cache, the returned future gives the number of keys added
+    std::future<std::size_t> warm_up(HotKeys hot_keys);
+
+    //! Start reading again the hot keys abandoned by the chain reorganization just applied to the state cache, if any
+    void on_state_changes(const remote::StateChangeBatch& state_changes);
+
+private:
+    struct Batch {
+        bool code{false};
+        std::size_t begin{0};
+        std::size_t end{0};
+    };
+
+    boost::asio::awaitable<std::size_t> run(HotKeys hot_keys);
+
+    boost::asio::awaitable<std::size_t> warm_up_batch(const HotKeys& hot_keys, const Batch& batch);
+
+    //! The strand serializing the batches, which overlap just their asynchronous reads
+    boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+
+    Database& database_;
+    StateCache& state_cache_;
+    const std::size_t batch_size_;
+    const std::size_t max_concurrency_;
+};
+
+} // namespace silkrpc::ethdb::kv
+
+#endif // SILKRPC_ETHDB_KV_STATE_CACHE_WARMER_HPP_
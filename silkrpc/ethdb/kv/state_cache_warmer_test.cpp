@@ -0,0 +1,87 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "state_cache_warmer.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <silkworm/common/util.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::ethdb::kv {
+
+static const silkworm::Bytes kTestStateKey1{*silkworm::from_hex("0f572e5295c57f15886f9b263e2f6d2d6c7b5ec6")};
+static const silkworm::Bytes kTestStateKey2{*silkworm::from_hex("0715a7794a1dc8e42615f059dd6e406a6594651a0000000000000003")};
+static const silkworm::Bytes kTestCodeKey{*silkworm::from_hex("6677907ab33937e392b9be983b30818f29d594039c9e1e7490bf7b3698888fb1")};
+
+TEST_CASE("write_hot_keys and read_hot_keys", "[silkrpc][ethdb][kv][state_cache_warmer]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    const auto file_path = std::filesystem::temp_directory_path() / "silkrpc_hot_keys_test.bin";
+    std::filesystem::remove(file_path);
+
+    SECTION("missing file") {
+        CHECK(!read_hot_keys(file_path));
+    }
+
+    SECTION("empty hot keys") {
+        write_hot_keys(file_path, HotKeys{});
+        const auto hot_keys = read_hot_keys(file_path);
+        CHECK(hot_keys.has_value());
+        if (hot_keys) {
+            CHECK(hot_keys->state_keys.empty());
+            CHECK(hot_keys->code_keys.empty());
+        }
+    }
+
+    SECTION("round trip preserves the order") {
+        write_hot_keys(file_path, HotKeys{{kTestStateKey1, kTestStateKey2}, {kTestCodeKey}});
+        CHECK(!std::filesystem::exists(file_path.string() + ".tmp"));
+        const auto hot_keys = read_hot_keys(file_path);
+        CHECK(hot_keys.has_value());
+        if (hot_keys) {
+            CHECK(hot_keys->state_keys == std::vector<silkworm::Bytes>{kTestStateKey1, kTestStateKey2});
+            CHECK(hot_keys->code_keys == std::vector<silkworm::Bytes>{kTestCodeKey});
+        }
+    }
+
+    SECTION("unknown format") {
+        std::ofstream{file_path} << "0x0f572e5295c57f15886f9b263e2f6d2d6c7b5ec6\n";
+        CHECK(!read_hot_keys(file_path));
+    }
+
+    SECTION("truncated file") {
+        write_hot_keys(file_path, HotKeys{{kTestStateKey1, kTestStateKey2}, {kTestCodeKey}});
+        std::filesystem::resize_file(file_path, std::filesystem::file_size(file_path) - 1);
+        CHECK(!read_hot_keys(file_path));
+    }
+
+    SECTION("too long key") {
+        const silkworm::Bytes long_key(std::numeric_limits<uint16_t>::max() + 1, '\0');
+        CHECK_THROWS_AS(write_hot_keys(file_path, HotKeys{{long_key}, {}}), std::invalid_argument);
+    }
+
+    std::filesystem::remove(file_path);
+    std::filesystem::remove(file_path.string() + ".tmp");
+}
+
+} // namespace silkrpc::ethdb::kv
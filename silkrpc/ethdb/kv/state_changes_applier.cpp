@@ -0,0 +1,91 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "state_changes_applier.hpp"
+
+#include <chrono>
+#include <utility>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/common/usdt.hpp>
+
+namespace silkrpc::ethdb::kv {
+
+StateChangesApplier::StateChangesApplier(StateCache* cache, std::size_t queue_capacity)
+    : cache_{cache}, queue_{queue_capacity} {
+    drained_batches_.reserve(queue_capacity);
+    applier_ = std::thread{[&]() { run(); }};
+}
+
+StateChangesApplier::~StateChangesApplier() {
+    stop();
+}
+
+bool StateChangesApplier::push(std::shared_ptr<const remote::StateChangeBatch> batch) {
+    if (!queue_.push(std::move(batch))) {
+        queue_full_count_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    queue_depth_.fetch_add(1, std::memory_order_relaxed);
+    {
+        // Synchronize with the applier checking the queue, so that the notification cannot get lost
+        std::scoped_lock lock{mutex_};
+    }
+    cv_.notify_one();
+    return true;
+}
+
+void StateChangesApplier::stop() {
+    {
+        std::scoped_lock lock{mutex_};
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    applier_.join();
+}
+
+void StateChangesApplier::run() {
+    std::unique_lock lock{mutex_};
+    while (!stopping_) {
+        cv_.wait(lock, [&]() { return stopping_ || !queue_.empty(); });
+        if (stopping_) {
+            break;
+        }
+        lock.unlock();
+        queue_.drain(drained_batches_);
+        for (auto& batch : drained_batches_) {
+            SILKRPC_PROBE(state_changes_apply_start, batch->databaseviewid(), batch->changebatch_size());
+            const auto start = std::chrono::steady_clock::now();
+            cache_->on_new_block(*batch);
+            const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+            SILKRPC_PROBE(state_changes_apply_done, batch->databaseviewid(), elapsed.count());
+            apply_latency_.observe(elapsed);
+            applied_count_.fetch_add(1, std::memory_order_relaxed);
+            queue_depth_.fetch_sub(1, std::memory_order_relaxed);
+            SILKRPC_DEBUG << "StateChangesApplier::run batch applied in " << elapsed.count() << "us\n";
+            if (applied_callback_) {
+                applied_callback_(std::move(batch));
+            }
+        }
+        drained_batches_.clear();
+        lock.lock();
+    }
+}
+
+} // namespace silkrpc::ethdb::kv
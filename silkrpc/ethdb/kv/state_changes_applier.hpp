@@ -0,0 +1,99 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_ETHDB_KV_STATE_CHANGES_APPLIER_HPP_
+#define SILKRPC_ETHDB_KV_STATE_CHANGES_APPLIER_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <silkrpc/common/latency_histogram.hpp>
+#include <silkrpc/concurrency/spsc_ring.hpp>
+#include <silkrpc/ethdb/kv/state_cache.hpp>
+#include <silkrpc/interfaces/remote/kv.pb.h>
+
+namespace silkrpc::ethdb::kv {
+
+//! The callback notified on the applier thread of each batch of state changes just applied to the state cache
+using StateChangesAppliedCallback = std::function<void(std::shared_ptr<const remote::StateChangeBatch>)>;
+
+//! Apply the batches of state changes to the state cache on a dedicated thread, so that neither the stream reading them
+//! nor its scheduler wait for the large batches to be applied. The batches go through a bounded ring having the stream
+//! as single producer: pushing into a full ring fails, so that the stream can slow down reading instead of buffering.
+//! The batches are applied in push order, each one notified to the callback right after.
+class StateChangesApplier {
+public:
+    //! The default max number of batches waiting to be applied
+    static constexpr std::size_t kDefaultQueueCapacity{64};
+
+    explicit StateChangesApplier(StateCache* cache, std::size_t queue_capacity = kDefaultQueueCapacity);
+    ~StateChangesApplier();
+
+    StateChangesApplier(const StateChangesApplier&) = delete;
+    StateChangesApplier& operator=(const StateChangesApplier&) = delete;
+
+    //! Set the callback notified of each applied batch (must be called before the first push)
+    void set_applied_callback(StateChangesAppliedCallback callback) { applied_callback_ = std::move(callback); }
+
+    //! Enqueue the batch to be applied, returning false if the queue is full (single producer only)
+    bool push(std::shared_ptr<const remote::StateChangeBatch> batch);
+
+    //! Stop the applier thread, discarding the batches not applied yet
+    void stop();
+
+    //! The number of batches waiting to be applied, including the one being applied
+    std::size_t queue_depth() const noexcept { return queue_depth_.load(std::memory_order_relaxed); }
+
+    std::size_t queue_capacity() const noexcept { return queue_.capacity(); }
+
+    uint64_t applied_count() const noexcept { return applied_count_.load(std::memory_order_relaxed); }
+
+    //! The number of pushes failed because the queue was full
+    uint64_t queue_full_count() const noexcept { return queue_full_count_.load(std::memory_order_relaxed); }
+
+    //! The time spent applying each batch to the state cache
+    const LatencyHistogram& apply_latency() const noexcept { return apply_latency_; }
+
+private:
+    void run();
+
+    StateCache* cache_;
+    SpscRing<std::shared_ptr<const remote::StateChangeBatch>> queue_;
+    StateChangesAppliedCallback applied_callback_;
+
+    std::atomic<std::size_t> queue_depth_{0};
+    std::atomic<uint64_t> applied_count_{0};
+    std::atomic<uint64_t> queue_full_count_{0};
+    LatencyHistogram apply_latency_;
+
+    std::vector<std::shared_ptr<const remote::StateChangeBatch>> drained_batches_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_{false};
+    std::thread applier_;
+};
+
+} // namespace silkrpc::ethdb::kv
+
+#endif // SILKRPC_ETHDB_KV_STATE_CHANGES_APPLIER_HPP_
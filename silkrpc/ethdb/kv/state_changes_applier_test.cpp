@@ -0,0 +1,103 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "state_changes_applier.hpp"
+
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <gmock/gmock.h>
+
+#include <silkrpc/test/mock_state_cache.hpp>
+
+namespace silkrpc::ethdb::kv {
+
+using testing::_;
+using testing::Invoke;
+
+TEST_CASE("StateChangesApplier::push", "[silkrpc][ethdb][kv][state_changes_applier]") {
+    test::MockStateCache state_cache;
+
+    SECTION("batches applied in push order and then notified") {
+        StateChangesApplier applier{&state_cache};
+        std::vector<uint64_t> applied_view_ids;
+        EXPECT_CALL(state_cache, on_new_block(_)).Times(2).WillRepeatedly(Invoke([&](const remote::StateChangeBatch& batch) {
+            applied_view_ids.push_back(batch.databaseviewid());
+        }));
+        std::promise<void> notified;
+        std::vector<uint64_t> notified_view_ids;
+        applier.set_applied_callback([&](std::shared_ptr<const remote::StateChangeBatch> batch) {
+            // The batch is applied but the next one is not yet
+            notified_view_ids.push_back(applied_view_ids.size() == batch->databaseviewid() ? batch->databaseviewid() : 0);
+            if (notified_view_ids.size() == 2) {
+                notified.set_value();
+            }
+        });
+        remote::StateChangeBatch batch1;
+        batch1.set_databaseviewid(1);
+        remote::StateChangeBatch batch2;
+        batch2.set_databaseviewid(2);
+        CHECK(applier.push(std::make_shared<const remote::StateChangeBatch>(batch1)));
+        CHECK(applier.push(std::make_shared<const remote::StateChangeBatch>(batch2)));
+        notified.get_future().wait();
+        CHECK(applied_view_ids == std::vector<uint64_t>{1, 2});
+        CHECK(notified_view_ids == std::vector<uint64_t>{1, 2});
+        CHECK(applier.applied_count() == 2);
+        CHECK(applier.queue_depth() == 0);
+        CHECK(applier.apply_latency().count() == 2);
+        CHECK(applier.queue_full_count() == 0);
+    }
+
+    SECTION("push into full queue fails") {
+        StateChangesApplier applier{&state_cache, 1};
+        std::promise<void> started;
+        std::promise<void> released;
+        auto released_future = released.get_future();
+        EXPECT_CALL(state_cache, on_new_block(_)).Times(2).WillOnce(Invoke([&](const remote::StateChangeBatch& /*batch*/) {
+            started.set_value();
+            released_future.wait();
+        })).WillOnce(Invoke([](const remote::StateChangeBatch& /*batch*/) {}));
+        std::promise<void> notified;
+        int num_notified{0};
+        applier.set_applied_callback([&](std::shared_ptr<const remote::StateChangeBatch> /*batch*/) {
+            if (++num_notified == 2) {
+                notified.set_value();
+            }
+        });
+        const auto batch = std::make_shared<const remote::StateChangeBatch>();
+        CHECK(applier.push(batch));
+        started.get_future().wait();
+        CHECK(applier.push(batch));
+        CHECK(!applier.push(batch));
+        CHECK(applier.queue_depth() == 2);
+        CHECK(applier.queue_full_count() == 1);
+        released.set_value();
+        notified.get_future().wait();
+        CHECK(applier.applied_count() == 2);
+    }
+}
+
+TEST_CASE("StateChangesApplier::stop", "[silkrpc][ethdb][kv][state_changes_applier]") {
+    test::MockStateCache state_cache;
+    StateChangesApplier applier{&state_cache};
+    applier.stop();
+    CHECK_NOTHROW(applier.stop());
+    CHECK(applier.applied_count() == 0);
+}
+
+} // namespace silkrpc::ethdb::kv
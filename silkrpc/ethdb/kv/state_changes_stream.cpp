@@ -16,9 +16,12 @@
 
 #include "state_changes_stream.hpp"
 
+#include <memory>
 #include <ostream>
+#include <utility>
 
 #include <boost/asio/experimental/as_tuple.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/asio/this_coro.hpp>
 #include <boost/asio/use_future.hpp>
 #include <boost/system/error_code.hpp>
@@ -42,8 +45,15 @@ StateChangesStream::StateChangesStream(Context& context, remote::KV::StubInterfa
     : scheduler_(*context.io_context()),
       grpc_context_(*context.grpc_context()),
       cache_(context.state_cache().get()),
+      applier_(context.state_changes_applier()),
       stub_(stub),
-      retry_timer_{scheduler_} {}
+      retry_timer_{scheduler_} {
+    if (applier_) {
+        applier_->set_applied_callback([&](std::shared_ptr<const remote::StateChangeBatch> batch) {
+            boost::asio::post(scheduler_, [&, batch = std::move(batch)]() { notify_listeners(*batch); });
+        });
+    }
+}
 
 std::future<void> StateChangesStream::open() {
     return boost::asio::co_spawn(scheduler_, run(), boost::asio::use_future);
@@ -55,6 +65,10 @@ void StateChangesStream::close() {
     SILKRPC_WARN << "Close state changes stream: cancellation emitted\n";
 }
 
+void StateChangesStream::add_listener(StateChangesListener listener) {
+    listeners_.push_back(std::move(listener));
+}
+
 boost::asio::awaitable<void> StateChangesStream::run() {
     SILKRPC_TRACE << "StateChangesStream::run state stream START\n";
 
@@ -97,7 +111,11 @@ boost::asio::awaitable<void> StateChangesStream::run() {
             std::tie(read_ec, reply) = co_await state_changes_rpc->read_on(scheduler_.get_executor(), use_nothrow_awaitable);
             if (!read_ec) {
                 SILKRPC_INFO << "State changes batch received: " << reply << "\n";
-                cache_->on_new_block(reply);
+                if (!co_await apply(std::move(reply))) {
+                    cancelled = true;
+                    SILKRPC_DEBUG << "State changes stream cancelled while waiting for the applier\n";
+                    break;
+                }
             } else {
                 if (read_ec.value() == grpc::StatusCode::CANCELLED) {
                     cancelled = true;
@@ -118,4 +136,28 @@ boost::asio::awaitable<void> StateChangesStream::run() {
     SILKRPC_TRACE << "StateChangesStream::run state stream END\n";
 }
 
+boost::asio::awaitable<bool> StateChangesStream::apply(remote::StateChangeBatch&& batch) {
+    if (!applier_) {
+        cache_->on_new_block(batch);
+        notify_listeners(batch);
+        co_return true;
+    }
+    const auto shared_batch = std::make_shared<const remote::StateChangeBatch>(std::move(batch));
+    while (!applier_->push(shared_batch)) {
+        SILKRPC_DEBUG << "State changes applier queue full, wait before retry\n";
+        retry_timer_.expires_from_now(kApplierRetryInterval);
+        const auto [ec] = co_await retry_timer_.async_wait(use_nothrow_awaitable);
+        if (ec == boost::asio::error::operation_aborted) {
+            co_return false;
+        }
+    }
+    co_return true;
+}
+
+void StateChangesStream::notify_listeners(const remote::StateChangeBatch& batch) {
+    for (const auto& listener : listeners_) {
+        listener(batch);
+    }
+}
+
 } // namespace silkrpc::ethdb::kv
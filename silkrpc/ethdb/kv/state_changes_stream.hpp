@@ -21,6 +21,7 @@
 #include <functional>
 #include <future>
 #include <memory>
+#include <vector>
 
 #include <silkrpc/config.hpp>
 
@@ -35,6 +36,7 @@
 #include <silkrpc/concurrency/context_pool.hpp>
 #include <silkrpc/ethdb/kv/rpc.hpp>
 #include <silkrpc/ethdb/kv/state_cache.hpp>
+#include <silkrpc/ethdb/kv/state_changes_applier.hpp>
 #include <silkrpc/interfaces/remote/kv.grpc.pb.h>
 
 //! Unfortunately gRPC does not define operator<< for generated data types
@@ -53,7 +55,15 @@ namespace silkrpc::ethdb::kv {
 //! The default registration interval
 constexpr boost::posix_time::milliseconds kDefaultRegistrationInterval{10'000};
 
-//! End-point of the stream of state changes coming from the node Core component
+//! The interval between successive attempts to enqueue one batch when the applier queue is full
+constexpr boost::posix_time::milliseconds kApplierRetryInterval{1};
+
+//! The callback notified of each batch of state changes after it has been applied to the state cache
+using StateChangesListener = std::function<void(const remote::StateChangeBatch&)>;
+
+//! End-point of the stream of state changes coming from the node Core component. The received batches are applied to
+//! the state cache inline or, if the context has a StateChangesApplier, on the applier thread: then the stream stops
+//! reading while the applier queue is full and the listeners are notified on the stream scheduler once applied.
 class StateChangesStream {
 public:
     //! Return the retry interval between successive registration attempts
@@ -70,10 +80,19 @@ public:
     //! Close down the stream, stopping the register-and-receive loop
     void close();
 
+    //! Add a listener notified on the stream scheduler of each received batch (must be called before open)
+    void add_listener(StateChangesListener listener);
+
     // The register-and-receive asynchronous loop
     boost::asio::awaitable<void> run();
 
 private:
+    //! Apply the batch to the state cache and notify the listeners, returning false if cancelled while waiting to do so
+    boost::asio::awaitable<bool> apply(remote::StateChangeBatch&& batch);
+
+    //! Notify the listeners of the batch already applied
+    void notify_listeners(const remote::StateChangeBatch& batch);
+
     //! The retry interval between successive registration attempts
     static boost::posix_time::milliseconds registration_interval_;
 
@@ -89,6 +108,12 @@ private:
     //! The local state cache where the received state changes will be applied
     StateCache* cache_;
 
+    //! The applier of the state changes off the stream scheduler, if any
+    std::shared_ptr<StateChangesApplier> applier_;
+
+    //! The listeners notified of the received state changes
+    std::vector<StateChangesListener> listeners_;
+
     //! The signal used to cancel the register-and-receive stream loop
     boost::asio::cancellation_signal cancellation_signal_;
 
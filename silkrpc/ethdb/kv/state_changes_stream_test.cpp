@@ -18,6 +18,7 @@
 
 #include <future>
 #include <system_error>
+#include <vector>
 
 #include <boost/asio/co_spawn.hpp>
 #include <boost/asio/use_awaitable.hpp>
@@ -167,6 +168,27 @@ TEST_CASE_METHOD(StateChangesStreamTest, "StateChangesStream::run", "[silkrpc][e
         // Execute the test: running the stream should succeed until finishes
         CHECK_NOTHROW(spawn_and_wait(stream_.run()));
     }
+    SECTION("listeners notified of each batch") {
+        std::vector<uint64_t> block_heights;
+        stream_.add_listener([&](const remote::StateChangeBatch& batch) {
+            block_heights.push_back(batch.changebatch(0).blockheight());
+        });
+        // Set the call expectations:
+        // 1. remote::KV::StubInterface::PrepareAsyncStateChangesRaw call succeeds
+        expect_request_async_statechanges(/*.ok=*/true);
+        // 2. AsyncReader<remote::StateChangeBatch>::Read 1st/2nd calls succeed, 3rd call fails
+        EXPECT_CALL(*statechanges_reader_, Read)
+            .WillOnce(test::read_success_with(grpc_context_, make_batch()))
+            .WillOnce(test::read_success_with(grpc_context_, make_batch()))
+            .WillOnce(test::read_failure(grpc_context_));
+        // 3. AsyncReader<remote::StateChangeBatch>::Finish call succeeds w/ status cancelled
+        EXPECT_CALL(*statechanges_reader_, Finish).WillOnce(test::finish_streaming_cancelled(grpc_context_));
+
+        // Execute the test: running the stream should notify the listener of both batches
+        CHECK_NOTHROW(spawn_and_wait(stream_.run()));
+        CHECK(block_heights.size() == 2);
+        CHECK(block_heights[1] == block_heights[0] + 1);
+    }
 }
 
 TEST_CASE_METHOD(StateChangesStreamTest, "StateChangesStream::close", "[silkrpc][ethdb][kv][state_changes_stream]") {
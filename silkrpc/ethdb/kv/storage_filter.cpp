@@ -0,0 +1,126 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "storage_filter.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include <silkworm/common/util.hpp>
+
+#include <silkrpc/common/hex.hpp>
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/common/util.hpp>
+
+namespace silkrpc::ethdb::kv {
+
+std::vector<evmc::address> StorageFilter::parse_addresses(const std::string& addresses) {
+    std::vector<evmc::address> parsed;
+    if (addresses.empty()) {
+        return parsed;
+    }
+    std::string_view remaining{addresses};
+    for (bool last{false}; !last;) {
+        const auto separator = remaining.find(',');
+        last = separator == std::string_view::npos;
+        const auto item = remaining.substr(0, separator);
+        remaining.remove_prefix(last ? remaining.size() : separator + 1);
+
+        const auto bytes = silkrpc::from_hex(item);
+        if (!item.starts_with("0x") || !bytes || bytes->size() != silkworm::kAddressLength) {
+            throw std::invalid_argument{"invalid address: " + std::string{item}};
+        }
+        parsed.push_back(silkworm::to_evmc_address(*bytes));
+    }
+    return parsed;
+}
+
+StorageFilter::StorageFilter(const std::vector<evmc::address>& addresses, std::size_t max_auto_addresses)
+    : enabled_{!addresses.empty() || max_auto_addresses > 0},
+      max_tracked_{addresses.size() + max_auto_addresses},
+      tracked_{std::make_shared<const AddressSet>(addresses.begin(), addresses.end())} {}
+
+bool StorageFilter::tracks(const evmc::address& address) const {
+    if (!enabled_) {
+        return true;
+    }
+    return tracked_.load(std::memory_order_acquire)->contains(address);
+}
+
+void StorageFilter::record_read(const evmc::address& address) {
+    if (!enabled_) {
+        return;
+    }
+    thread_local uint32_t read_count{0};
+    if (++read_count % kReadSampleInterval != 0) {
+        return;
+    }
+    std::scoped_lock lock{candidates_mutex_};
+    if (auto it = candidates_.find(address); it != candidates_.end()) {
+        ++it->second;
+    } else if (candidates_.size() < kMaxCandidates) {
+        candidates_.emplace(address, 1);
+    }
+}
+
+void StorageFilter::on_new_block() {
+    if (!enabled_) {
+        return;
+    }
+    const auto tracked = tracked_.load(std::memory_order_acquire);
+
+    std::vector<std::pair<uint32_t, evmc::address>> hot_candidates;
+    {
+        std::scoped_lock lock{candidates_mutex_};
+        if (tracked->size() < max_tracked_) {
+            for (const auto& [address, count] : candidates_) {
+                if (count >= kMinSampledReads && !tracked->contains(address)) {
+                    hot_candidates.emplace_back(count, address);
+                }
+            }
+        }
+        if (++block_count_ % kSampleBlocks == 0) {
+            candidates_.clear();
+        } else {
+            for (const auto& candidate : hot_candidates) {
+                candidates_.erase(candidate.second);
+            }
+        }
+    }
+    if (hot_candidates.empty()) {
+        return;
+    }
+
+    // Add the most read candidates first, up to the max number of tracked contracts
+    std::sort(hot_candidates.begin(), hot_candidates.end(), [](const auto& x, const auto& y) { return x.first > y.first; });
+    auto next_tracked = std::make_shared<AddressSet>(*tracked);
+    for (const auto& [count, address] : hot_candidates) {
+        if (next_tracked->size() == max_tracked_) {
+            break;
+        }
+        next_tracked->insert(address);
+        SILKRPC_DEBUG << "StorageFilter::on_new_block tracking storage of address=" << address << " sampled_reads=" << count << "\n";
+    }
+    tracked_.store(std::move(next_tracked), std::memory_order_release);
+}
+
+std::size_t StorageFilter::tracked_count() const {
+    return tracked_.load(std::memory_order_acquire)->size();
+}
+
+} // namespace silkrpc::ethdb::kv
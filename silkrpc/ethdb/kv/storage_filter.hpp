@@ -0,0 +1,102 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_ETHDB_KV_STORAGE_FILTER_HPP_
+#define SILKRPC_ETHDB_KV_STORAGE_FILTER_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <evmc/evmc.hpp>
+
+namespace silkrpc::ethdb::kv {
+
+//! The set of contracts whose storage is cached
+using AddressSet = std::unordered_set<evmc::address>;
+
+//! The contracts whose storage is tracked by the state cache, i.e. cached and kept up to date by applying their storage
+//! changes: the storage changes of the other contracts are skipped at each new block and their storage reads go straight
+//! to the database. The tracked contracts are the allowlist plus, if enabled, the ones added automatically for having
+//! their storage read most often. The contracts are never untracked, so that no cached storage can miss some changes.
+//! The tracked set is swapped atomically, so readers on any thread never block
+class StorageFilter {
+public:
+    //! Parse the comma-separated hex addresses, throwing std::invalid_argument if any is invalid
+    static std::vector<evmc::address> parse_addresses(const std::string& addresses);
+
+    //! The storage reads counted for the automatic tracking, one every such number on each thread
+    static constexpr uint32_t kReadSampleInterval{16};
+
+    //! The sampled reads making one contract tracked automatically, if read within kSampleBlocks blocks
+    static constexpr uint32_t kMinSampledReads{8};
+
+    //! The number of blocks after which the sampled reads are reset, so that only the recently hot contracts are added
+    static constexpr uint64_t kSampleBlocks{64};
+
+    //! The max number of candidate contracts whose sampled reads are counted at any time
+    static constexpr std::size_t kMaxCandidates{4096};
+
+    //! Track the storage of all contracts, i.e. no filtering
+    StorageFilter() = default;
+
+    //! Track the storage of the allowlist plus up to max_auto_addresses contracts read most often
+    StorageFilter(const std::vector<evmc::address>& addresses, std::size_t max_auto_addresses);
+
+    StorageFilter(const StorageFilter&) = delete;
+    StorageFilter& operator=(const StorageFilter&) = delete;
+
+    //! Return true if the storage of just some contracts is tracked
+    bool enabled() const noexcept { return enabled_; }
+
+    //! Return true if the storage of the contract is tracked
+    bool tracks(const evmc::address& address) const;
+
+    //! Record one read of the storage of the contract not tracked, sampled once every kReadSampleInterval reads
+    void record_read(const evmc::address& address);
+
+    //! Add the candidates read often enough to the tracked contracts: to be called before applying the changes of each block
+    void on_new_block();
+
+    //! Record one storage change of some block skipped because not tracked
+    void record_skipped_change() noexcept { skipped_change_count_.fetch_add(1, std::memory_order_relaxed); }
+
+    std::size_t tracked_count() const;
+
+    uint64_t skipped_change_count() const noexcept { return skipped_change_count_.load(std::memory_order_relaxed); }
+
+private:
+    bool enabled_{false};
+    std::size_t max_tracked_{0};
+    std::atomic<std::shared_ptr<const AddressSet>> tracked_{std::make_shared<const AddressSet>()};
+
+    //! The mutex protecting the candidates and the block count
+    std::mutex candidates_mutex_;
+    std::unordered_map<evmc::address, uint32_t> candidates_;
+    uint64_t block_count_{0};
+
+    std::atomic<uint64_t> skipped_change_count_{0};
+};
+
+} // namespace silkrpc::ethdb::kv
+
+#endif // SILKRPC_ETHDB_KV_STORAGE_FILTER_HPP_
@@ -0,0 +1,149 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "storage_filter.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+
+namespace silkrpc::ethdb::kv {
+
+using Catch::Matchers::Message;
+using evmc::literals::operator""_address;
+
+static const evmc::address kAddress1{0x68d7df19da3d4e5e0ce4d2a6ee1bd1de0ac6c0e7_address};
+static const evmc::address kAddress2{0xa0b86991c6218b36c1d19d4a2e9eb0ce3606eb48_address};
+static const evmc::address kAddress3{0xc02aaa39b223fe8d0a0e5c4f27ead9083c756cc2_address};
+
+//! Read the storage of the contract as many times as needed to be sampled the specified number of times
+static void sampled_reads(StorageFilter& filter, const evmc::address& address, uint32_t num_samples) {
+    for (uint32_t i{0}; i < num_samples * StorageFilter::kReadSampleInterval; ++i) {
+        filter.record_read(address);
+    }
+}
+
+TEST_CASE("StorageFilter::parse_addresses", "[silkrpc][ethdb][kv][storage_filter]") {
+    SECTION("empty") {
+        CHECK(StorageFilter::parse_addresses("").empty());
+    }
+
+    SECTION("valid") {
+        CHECK(StorageFilter::parse_addresses("0x68d7df19da3d4e5e0ce4d2a6ee1bd1de0ac6c0e7") == std::vector<evmc::address>{kAddress1});
+        CHECK(StorageFilter::parse_addresses("0x68d7df19da3d4e5e0ce4d2a6ee1bd1de0ac6c0e7,0xA0b86991c6218b36c1d19D4a2e9Eb0cE3606eB48") ==
+              std::vector<evmc::address>{kAddress1, kAddress2});
+    }
+
+    SECTION("invalid") {
+        CHECK_THROWS_MATCHES(StorageFilter::parse_addresses("68d7df19da3d4e5e0ce4d2a6ee1bd1de0ac6c0e7"), std::invalid_argument,
+                             Message("invalid address: 68d7df19da3d4e5e0ce4d2a6ee1bd1de0ac6c0e7"));
+        CHECK_THROWS_AS(StorageFilter::parse_addresses("0x68d7df19da3d4e5e0ce4d2a6ee1bd1de0ac6c0"), std::invalid_argument);
+        CHECK_THROWS_AS(StorageFilter::parse_addresses("0x68d7df19da3d4e5e0ce4d2a6ee1bd1de0ac6c0zz"), std::invalid_argument);
+        CHECK_THROWS_AS(StorageFilter::parse_addresses("0x68d7df19da3d4e5e0ce4d2a6ee1bd1de0ac6c0e7,"), std::invalid_argument);
+    }
+}
+
+TEST_CASE("StorageFilter::tracks", "[silkrpc][ethdb][kv][storage_filter]") {
+    SECTION("disabled tracks all") {
+        StorageFilter filter;
+        CHECK(!filter.enabled());
+        CHECK(filter.tracks(kAddress1));
+        CHECK(filter.tracks(kAddress2));
+        sampled_reads(filter, kAddress1, StorageFilter::kMinSampledReads);
+        filter.on_new_block();
+        CHECK(filter.tracked_count() == 0);
+    }
+
+    SECTION("allowlist") {
+        StorageFilter filter{{kAddress1}, 0};
+        CHECK(filter.enabled());
+        CHECK(filter.tracks(kAddress1));
+        CHECK(!filter.tracks(kAddress2));
+        CHECK(filter.tracked_count() == 1);
+    }
+
+    SECTION("allowlist is not extended if automatic tracking is disabled") {
+        StorageFilter filter{{kAddress1}, 0};
+        sampled_reads(filter, kAddress2, StorageFilter::kMinSampledReads);
+        filter.on_new_block();
+        CHECK(!filter.tracks(kAddress2));
+    }
+}
+
+TEST_CASE("StorageFilter::on_new_block", "[silkrpc][ethdb][kv][storage_filter]") {
+    SECTION("hot contract tracked automatically") {
+        StorageFilter filter{{}, 1};
+        CHECK(filter.enabled());
+        CHECK(!filter.tracks(kAddress2));
+        sampled_reads(filter, kAddress2, StorageFilter::kMinSampledReads);
+        CHECK(!filter.tracks(kAddress2));
+        filter.on_new_block();
+        CHECK(filter.tracks(kAddress2));
+        CHECK(filter.tracked_count() == 1);
+    }
+
+    SECTION("cold contract not tracked") {
+        StorageFilter filter{{}, 1};
+        sampled_reads(filter, kAddress2, StorageFilter::kMinSampledReads - 1);
+        filter.on_new_block();
+        CHECK(!filter.tracks(kAddress2));
+    }
+
+    SECTION("most read contracts tracked first up to the max") {
+        StorageFilter filter{{kAddress1}, 1};
+        sampled_reads(filter, kAddress2, StorageFilter::kMinSampledReads);
+        sampled_reads(filter, kAddress3, StorageFilter::kMinSampledReads + 1);
+        filter.on_new_block();
+        CHECK(filter.tracks(kAddress1));
+        CHECK(!filter.tracks(kAddress2));
+        CHECK(filter.tracks(kAddress3));
+        CHECK(filter.tracked_count() == 2);
+    }
+
+    SECTION("sampled reads reset after kSampleBlocks blocks") {
+        StorageFilter filter{{}, 1};
+        sampled_reads(filter, kAddress2, StorageFilter::kMinSampledReads - 1);
+        for (uint64_t i{0}; i < StorageFilter::kSampleBlocks; ++i) {
+            filter.on_new_block();
+        }
+        sampled_reads(filter, kAddress2, 1);
+        filter.on_new_block();
+        CHECK(!filter.tracks(kAddress2));
+    }
+
+    SECTION("tracked contracts are never untracked") {
+        StorageFilter filter{{}, 1};
+        sampled_reads(filter, kAddress2, StorageFilter::kMinSampledReads);
+        filter.on_new_block();
+        for (uint64_t i{0}; i < 2 * StorageFilter::kSampleBlocks; ++i) {
+            filter.on_new_block();
+        }
+        CHECK(filter.tracks(kAddress2));
+    }
+}
+
+TEST_CASE("StorageFilter::record_skipped_change", "[silkrpc][ethdb][kv][storage_filter]") {
+    StorageFilter filter{{kAddress1}, 0};
+    CHECK(filter.skipped_change_count() == 0);
+    filter.record_skipped_change();
+    filter.record_skipped_change();
+    CHECK(filter.skipped_change_count() == 2);
+}
+
+} // namespace silkrpc::ethdb::kv
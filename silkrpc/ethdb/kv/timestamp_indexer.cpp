@@ -0,0 +1,100 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "timestamp_indexer.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/use_future.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/core/rawdb/chain.hpp>
+#include <silkrpc/ethdb/transaction_database.hpp>
+
+namespace silkrpc::ethdb::kv {
+
+TimestampIndexer::TimestampIndexer(Context& context, std::shared_ptr<TimestampIndex> timestamp_index, uint64_t batch_size)
+    : strand_{boost::asio::make_strand(*context.io_context())},
+      database_(*context.database()),
+      timestamp_index_(std::move(timestamp_index)),
+      batch_size_(std::max<uint64_t>(batch_size, 1)) {}
+
+std::future<void> TimestampIndexer::index(uint64_t block_number) {
+    uint64_t generation{0};
+    {
+        std::lock_guard lock{mutex_};
+        generation = generation_;
+    }
+    return boost::asio::co_spawn(strand_, index_up_to(block_number, generation), boost::asio::use_future);
+}
+
+void TimestampIndexer::on_state_changes(const remote::StateChangeBatch& state_changes) {
+    for (const auto& state_change : state_changes.changebatch()) {
+        if (state_change.direction() == remote::Direction::UNWIND) {
+            std::lock_guard lock{mutex_};
+            ++generation_;
+            timestamp_index_->truncate(state_change.blockheight());
+            SILKRPC_DEBUG << "TimestampIndexer::on_state_changes unwind from block: " << state_change.blockheight() << "\n";
+        } else {
+            // The future is not awaited: the indexing runs in background and never throws
+            index(state_change.blockheight());
+        }
+    }
+}
+
+boost::asio::awaitable<void> TimestampIndexer::index_up_to(uint64_t block_number, uint64_t generation) {
+    while (timestamp_index_->size() <= block_number) {
+        const auto from_block = timestamp_index_->size();
+        const auto to_block = std::min(block_number, from_block + batch_size_ - 1);
+        SILKRPC_DEBUG << "TimestampIndexer::index_up_to from_block: " << from_block << " to_block: " << to_block << "\n";
+
+        std::vector<uint64_t> timestamps;
+        timestamps.reserve(to_block - from_block + 1);
+        bool read_ok{false};
+        auto tx = co_await database_.begin();
+        try {
+            TransactionDatabase tx_database{*tx};
+            for (auto number{from_block}; number <= to_block; ++number) {
+                const auto header = co_await core::rawdb::read_header_by_number(tx_database, number);
+                timestamps.push_back(header.timestamp);
+            }
+            read_ok = true;
+        } catch (const std::exception& e) {
+            SILKRPC_ERROR << "TimestampIndexer::index_up_to block_number: " << from_block + timestamps.size() << " exception: " << e.what() << "\n";
+        }
+        co_await tx->close(); // RAII not (yet) available with coroutines
+
+        if (!read_ok) {
+            co_return;
+        }
+        std::lock_guard lock{mutex_};
+        if (generation != generation_) {
+            SILKRPC_DEBUG << "TimestampIndexer::index_up_to block_number: " << block_number << " discarded after unwind\n";
+            co_return;
+        }
+        for (std::size_t i{0}; i < timestamps.size(); ++i) {
+            if (!timestamp_index_->append(from_block + i, timestamps[i])) {
+                SILKRPC_ERROR << "TimestampIndexer::index_up_to block_number: " << from_block + i << " not appended\n";
+                co_return;
+            }
+        }
+    }
+}
+
+} // namespace silkrpc::ethdb::kv
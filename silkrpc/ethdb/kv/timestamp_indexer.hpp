@@ -0,0 +1,74 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef SILKRPC_ETHDB_KV_TIMESTAMP_INDEXER_HPP_
+#define SILKRPC_ETHDB_KV_TIMESTAMP_INDEXER_HPP_
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <silkrpc/common/timestamp_index.hpp>
+#include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/ethdb/database.hpp>
+#include <silkrpc/interfaces/remote/kv.pb.h>
+
+namespace silkrpc::ethdb::kv {
+
+//! Build incrementally the block timestamp index from the heads announced by the state changes: the blocks missing up to
+//! each new head (all of them from genesis at first) are read in batches, each within its own transaction, whilst the
+//! unwound blocks are removed immediately. The batches read before an unwind are discarded, so that the index never
+//! contains the timestamps of non-canonical blocks.
+class TimestampIndexer {
+public:
+    //! The default number of headers read within one transaction
+    static constexpr uint64_t kDefaultBatchSize{1024};
+
+    explicit TimestampIndexer(Context& context, std::shared_ptr<TimestampIndex> timestamp_index, uint64_t batch_size = kDefaultBatchSize);
+
+    TimestampIndexer(const TimestampIndexer&) = delete;
+    TimestampIndexer& operator=(const TimestampIndexer&) = delete;
+
+    //! Start indexing the blocks up to the specified one, the returned future becomes ready when indexed or discarded
+    std::future<void> index(uint64_t block_number);
+
+    //! Remove the unwound blocks from the index and start indexing up to the new heads
+    void on_state_changes(const remote::StateChangeBatch& state_changes);
+
+private:
+    boost::asio::awaitable<void> index_up_to(uint64_t block_number, uint64_t generation);
+
+    //! The strand serializing the block indexing
+    boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+
+    Database& database_;
+    std::shared_ptr<TimestampIndex> timestamp_index_;
+    uint64_t batch_size_;
+
+    //! The mutex protecting the index updates and the generation, incremented at each unwind
+    std::mutex mutex_;
+    uint64_t generation_{0};
+};
+
+} // namespace silkrpc::ethdb::kv
+
+#endif // SILKRPC_ETHDB_KV_TIMESTAMP_INDEXER_HPP_
@@ -0,0 +1,135 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "memoized_database.hpp"
+
+#include <utility>
+
+#include <silkworm/common/endian.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::ethdb {
+
+MemoizedDatabase::MemoizedDatabase(const core::rawdb::DatabaseReader& reader, std::size_t max_bytes)
+    : reader_{reader}, max_bytes_{max_bytes} {}
+
+MemoizedDatabase::MemoizedDatabase(Transaction& tx, std::size_t max_bytes)
+    : tx_database_{std::in_place, tx}, reader_{*tx_database_}, max_bytes_{max_bytes} {}
+
+boost::asio::awaitable<KeyValue> MemoizedDatabase::get(const std::string& table, const silkworm::ByteView& key) const {
+    auto key_memo = memo_key(table, key);
+    if (const auto it = kv_pairs_.find(key_memo); it != kv_pairs_.end()) {
+        ++hit_count_;
+        co_return it->second;
+    }
+    ++miss_count_;
+    auto kv_pair = co_await reader_.get(table, key);
+    if (reserve(key_memo, kv_pair.key.size() + kv_pair.value.size())) {
+        kv_pairs_.emplace(std::move(key_memo), kv_pair);
+    }
+    co_return kv_pair;
+}
+
+boost::asio::awaitable<silkworm::Bytes> MemoizedDatabase::get_one(const std::string& table, const silkworm::ByteView& key) const {
+    const auto value = co_await get_one_shared(table, key);
+    co_return silkworm::Bytes{value.bytes};
+}
+
+boost::asio::awaitable<SharedByteView> MemoizedDatabase::get_one_shared(const std::string& table, const silkworm::ByteView& key) const {
+    auto key_memo = memo_key(table, key);
+    if (const auto it = values_.find(key_memo); it != values_.end()) {
+        ++hit_count_;
+        co_return it->second;
+    }
+    ++miss_count_;
+    auto value = co_await reader_.get_one_shared(table, key);
+    if (reserve(key_memo, value.bytes.size())) {
+        values_.emplace(std::move(key_memo), value);
+    }
+    co_return value;
+}
+
+boost::asio::awaitable<std::vector<silkworm::Bytes>> MemoizedDatabase::get_many(const std::string& table,
+                                                                              const std::vector<silkworm::Bytes>& keys) const {
+    co_return co_await reader_.get_many(table, keys);
+}
+
+boost::asio::awaitable<std::vector<KeyValue>> MemoizedDatabase::seek_many(const std::string& table,
+                                                                       const std::vector<silkworm::Bytes>& keys) const {
+    co_return co_await reader_.seek_many(table, keys);
+}
+
+boost::asio::awaitable<std::optional<silkworm::Bytes>> MemoizedDatabase::get_both_range(const std::string& table,
+    const silkworm::ByteView& key, const silkworm::ByteView& subkey) const {
+    auto key_memo = memo_key(table, key, subkey);
+    if (const auto it = range_values_.find(key_memo); it != range_values_.end()) {
+        ++hit_count_;
+        co_return it->second;
+    }
+    ++miss_count_;
+    auto value = co_await reader_.get_both_range(table, key, subkey);
+    if (reserve(key_memo, value ? value->size() : 0)) {
+        range_values_.emplace(std::move(key_memo), value);
+    }
+    co_return value;
+}
+
+boost::asio::awaitable<std::vector<std::optional<silkworm::Bytes>>> MemoizedDatabase::get_both_range_many(const std::string& table,
+    const std::vector<silkworm::Bytes>& keys, const std::vector<silkworm::Bytes>& subkeys) const {
+    co_return co_await reader_.get_both_range_many(table, keys, subkeys);
+}
+
+boost::asio::awaitable<void> MemoizedDatabase::walk(const std::string& table, const silkworm::ByteView& start_key, uint32_t fixed_bits,
+                                                    core::rawdb::Walker w) const {
+    co_await reader_.walk(table, start_key, fixed_bits, std::move(w));
+}
+
+boost::asio::awaitable<void> MemoizedDatabase::for_prefix(const std::string& table, const silkworm::ByteView& prefix,
+                                                          core::rawdb::Walker w) const {
+    co_await reader_.for_prefix(table, prefix, std::move(w));
+}
+
+std::string MemoizedDatabase::memo_key(const std::string& table, silkworm::ByteView key, std::optional<silkworm::ByteView> subkey) {
+    // The table name never contains a null character, the key length tells the key apart from the subkey
+    std::string memo_key;
+    memo_key.reserve(table.size() + 1 + sizeof(uint32_t) + key.size() + (subkey ? subkey->size() : 0));
+    memo_key.append(table);
+    memo_key.push_back('\0');
+    if (subkey) {
+        uint8_t key_size[sizeof(uint32_t)];
+        silkworm::endian::store_big_u32(key_size, static_cast<uint32_t>(key.size()));
+        memo_key.append(reinterpret_cast<const char*>(key_size), sizeof(key_size));
+    }
+    memo_key.append(reinterpret_cast<const char*>(key.data()), key.size());
+    if (subkey) {
+        memo_key.append(reinterpret_cast<const char*>(subkey->data()), subkey->size());
+    }
+    return memo_key;
+}
+
+bool MemoizedDatabase::reserve(const std::string& memo_key, std::size_t value_size) const {
+    const auto entry_size = kEntryOverhead + memo_key.size() + value_size;
+    if (size_bytes_ + entry_size > max_bytes_) {
+        SILKRPC_TRACE << "MemoizedDatabase::reserve budget exceeded size_bytes: " << size_bytes_ << " entry_size: " << entry_size << "\n";
+        return false;
+    }
+    size_bytes_ += entry_size;
+    return true;
+}
+
+} // namespace silkrpc::ethdb
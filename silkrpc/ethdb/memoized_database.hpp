@@ -0,0 +1,116 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_ETHDB_MEMOIZED_DATABASE_HPP_
+#define SILKRPC_ETHDB_MEMOIZED_DATABASE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <silkworm/common/util.hpp>
+#include <silkrpc/core/rawdb/accessors.hpp>
+#include <silkrpc/ethdb/transaction.hpp>
+#include <silkrpc/ethdb/transaction_database.hpp>
+
+namespace silkrpc::ethdb {
+
+//! Reader memoizing the point reads (i.e. get, get_one and get_both_range) of the underlying reader, so that the keys read
+//! many times by the helpers of the same request (e.g. the header, canonical hash and total difficulty of one block) are
+//! read from the database just once. The reads of one transaction see an immutable database view, hence the memoized
+//! values never go stale: the reader is meant to live as long as the request, so it needs no coherence with the new blocks.
+//! The memoized values are bounded by their approximate memory footprint, the keys read after exceeding it are not memoized.
+//! As any reader, it must be used on just one executor, hence it needs no locking
+class MemoizedDatabase : public core::rawdb::DatabaseReader {
+public:
+    //! The default memory budget in bytes
+    static constexpr std::size_t kDefaultMaxBytes{8 * 1024 * 1024};
+
+    //! The approximate memory overhead of each memoized entry, i.e. the hash map node and the value buffer header
+    static constexpr std::size_t kEntryOverhead{96};
+
+    //! Memoize the reads of the given reader, which must outlive this one
+    explicit MemoizedDatabase(const core::rawdb::DatabaseReader& reader, std::size_t max_bytes = kDefaultMaxBytes);
+
+    //! Memoize the reads of the transaction
+    explicit MemoizedDatabase(Transaction& tx, std::size_t max_bytes = kDefaultMaxBytes);
+
+    MemoizedDatabase(const MemoizedDatabase&) = delete;
+    MemoizedDatabase& operator=(const MemoizedDatabase&) = delete;
+
+    boost::asio::awaitable<KeyValue> get(const std::string& table, const silkworm::ByteView& key) const override;
+
+    boost::asio::awaitable<silkworm::Bytes> get_one(const std::string& table, const silkworm::ByteView& key) const override;
+
+    boost::asio::awaitable<SharedByteView> get_one_shared(const std::string& table, const silkworm::ByteView& key) const override;
+
+    boost::asio::awaitable<std::vector<silkworm::Bytes>> get_many(const std::string& table, const std::vector<silkworm::Bytes>& keys) const override;
+
+    boost::asio::awaitable<std::vector<KeyValue>> seek_many(const std::string& table, const std::vector<silkworm::Bytes>& keys) const override;
+
+    boost::asio::awaitable<std::optional<silkworm::Bytes>> get_both_range(const std::string& table, const silkworm::ByteView& key,
+                                                                          const silkworm::ByteView& subkey) const override;
+
+    boost::asio::awaitable<std::vector<std::optional<silkworm::Bytes>>> get_both_range_many(const std::string& table,
+        const std::vector<silkworm::Bytes>& keys, const std::vector<silkworm::Bytes>& subkeys) const override;
+
+    boost::asio::awaitable<void> walk(const std::string& table, const silkworm::ByteView& start_key, uint32_t fixed_bits,
+                                      core::rawdb::Walker w) const override;
+
+    boost::asio::awaitable<void> for_prefix(const std::string& table, const silkworm::ByteView& prefix, core::rawdb::Walker w) const override;
+
+    uint64_t view_id() const override { return reader_.view_id(); }
+
+    ChainHeadCache* chain_head_cache() const override { return reader_.chain_head_cache(); }
+
+    const snapshot::SnapshotRepository* snapshots() const override { return reader_.snapshots(); }
+
+    //! The number of point reads served by the memoized values
+    uint64_t hit_count() const { return hit_count_; }
+
+    //! The number of point reads forwarded to the underlying reader
+    uint64_t miss_count() const { return miss_count_; }
+
+    //! The approximate memory footprint of the memoized values
+    std::size_t size_bytes() const { return size_bytes_; }
+
+private:
+    //! Return the key of the memoized value of the table key (and subkey, if any)
+    static std::string memo_key(const std::string& table, silkworm::ByteView key, std::optional<silkworm::ByteView> subkey = std::nullopt);
+
+    //! Account for the memory footprint of one more memoized value, return false if exceeding the budget
+    bool reserve(const std::string& memo_key, std::size_t value_size) const;
+
+    std::optional<TransactionDatabase> tx_database_;
+    const core::rawdb::DatabaseReader& reader_;
+    std::size_t max_bytes_;
+
+    mutable std::unordered_map<std::string, KeyValue> kv_pairs_;
+    mutable std::unordered_map<std::string, SharedByteView> values_;
+    mutable std::unordered_map<std::string, std::optional<silkworm::Bytes>> range_values_;
+    mutable std::size_t size_bytes_{0};
+    mutable uint64_t hit_count_{0};
+    mutable uint64_t miss_count_{0};
+};
+
+} // namespace silkrpc::ethdb
+
+#endif  // SILKRPC_ETHDB_MEMOIZED_DATABASE_HPP_
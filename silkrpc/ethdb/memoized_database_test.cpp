@@ -0,0 +1,157 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "memoized_database.hpp"
+
+#include <optional>
+#include <string>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/use_future.hpp>
+#include <catch2/catch.hpp>
+#include <gmock/gmock.h>
+
+#include <silkrpc/ethdb/tables.hpp>
+#include <silkrpc/test/mock_database_reader.hpp>
+#include <silkworm/common/util.hpp>
+
+namespace silkrpc::ethdb {
+
+using testing::_;
+using testing::InvokeWithoutArgs;
+
+static const silkworm::Bytes kKey1{*silkworm::from_hex("0000000000000001")};
+static const silkworm::Bytes kKey2{*silkworm::from_hex("0000000000000002")};
+static const silkworm::Bytes kValue1{*silkworm::from_hex("600035600055")};
+static const silkworm::Bytes kValue2{*silkworm::from_hex("6000356000550055")};
+
+TEST_CASE("MemoizedDatabase::get_one", "[silkrpc][ethdb][memoized_database]") {
+    boost::asio::thread_pool pool{1};
+    test::MockDatabaseReader db_reader;
+
+    SECTION("same key read once") {
+        MemoizedDatabase database{db_reader};
+        EXPECT_CALL(db_reader, get_one(db::table::kHeaders, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return kValue1; }
+        ));
+        for (int i{0}; i < 3; ++i) {
+            auto result = boost::asio::co_spawn(pool, database.get_one(db::table::kHeaders, kKey1), boost::asio::use_future);
+            CHECK(result.get() == kValue1);
+        }
+        auto result = boost::asio::co_spawn(pool, database.get_one_shared(db::table::kHeaders, kKey1), boost::asio::use_future);
+        CHECK(result.get().bytes == kValue1);
+        CHECK(database.hit_count() == 3);
+        CHECK(database.miss_count() == 1);
+    }
+
+    SECTION("different keys and tables read separately") {
+        MemoizedDatabase database{db_reader};
+        EXPECT_CALL(db_reader, get_one(db::table::kHeaders, _))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> { co_return kValue1; }))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> { co_return kValue2; }));
+        EXPECT_CALL(db_reader, get_one(db::table::kCanonicalHashes, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<silkworm::Bytes> { co_return silkworm::Bytes{}; }
+        ));
+        auto result1 = boost::asio::co_spawn(pool, database.get_one(db::table::kHeaders, kKey1), boost::asio::use_future);
+        CHECK(result1.get() == kValue1);
+        auto result2 = boost::asio::co_spawn(pool, database.get_one(db::table::kHeaders, kKey2), boost::asio::use_future);
+        CHECK(result2.get() == kValue2);
+        auto result3 = boost::asio::co_spawn(pool, database.get_one(db::table::kCanonicalHashes, kKey1), boost::asio::use_future);
+        CHECK(result3.get().empty());
+        auto result4 = boost::asio::co_spawn(pool, database.get_one(db::table::kCanonicalHashes, kKey1), boost::asio::use_future);
+        CHECK(result4.get().empty());
+        CHECK(database.hit_count() == 1);
+        CHECK(database.miss_count() == 3);
+    }
+
+    SECTION("keys read after exceeding the budget not memoized") {
+        MemoizedDatabase database{db_reader, MemoizedDatabase::kEntryOverhead + 64};
+        EXPECT_CALL(db_reader, get_one(db::table::kHeaders, _))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> { co_return kValue1; }))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> { co_return kValue2; }))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<silkworm::Bytes> { co_return kValue2; }));
+        for (const auto& key : {kKey1, kKey2, kKey2, kKey1}) {
+            auto result = boost::asio::co_spawn(pool, database.get_one(db::table::kHeaders, key), boost::asio::use_future);
+            CHECK(result.get() == (key == kKey1 ? kValue1 : kValue2));
+        }
+        CHECK(database.hit_count() == 1);
+        CHECK(database.miss_count() == 3);
+        CHECK(database.size_bytes() <= MemoizedDatabase::kEntryOverhead + 64);
+    }
+}
+
+TEST_CASE("MemoizedDatabase::get", "[silkrpc][ethdb][memoized_database]") {
+    boost::asio::thread_pool pool{1};
+    test::MockDatabaseReader db_reader;
+    MemoizedDatabase database{db_reader};
+
+    EXPECT_CALL(db_reader, get(db::table::kSyncStageProgress, _)).WillOnce(InvokeWithoutArgs(
+        []() -> boost::asio::awaitable<KeyValue> { co_return KeyValue{kKey2, kValue2}; }
+    ));
+    for (int i{0}; i < 2; ++i) {
+        auto result = boost::asio::co_spawn(pool, database.get(db::table::kSyncStageProgress, kKey1), boost::asio::use_future);
+        const auto kv_pair = result.get();
+        CHECK(kv_pair.key == kKey2);
+        CHECK(kv_pair.value == kValue2);
+    }
+    CHECK(database.hit_count() == 1);
+    CHECK(database.miss_count() == 1);
+}
+
+TEST_CASE("MemoizedDatabase::get_both_range", "[silkrpc][ethdb][memoized_database]") {
+    boost::asio::thread_pool pool{1};
+    test::MockDatabaseReader db_reader;
+    MemoizedDatabase database{db_reader};
+
+    SECTION("same key and subkey read once") {
+        EXPECT_CALL(db_reader, get_both_range(db::table::kPlainState, _, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<std::optional<silkworm::Bytes>> { co_return kValue1; }
+        ));
+        for (int i{0}; i < 2; ++i) {
+            auto result = boost::asio::co_spawn(pool, database.get_both_range(db::table::kPlainState, kKey1, kKey2), boost::asio::use_future);
+            CHECK(result.get() == kValue1);
+        }
+        CHECK(database.hit_count() == 1);
+    }
+
+    SECTION("missing value memoized") {
+        EXPECT_CALL(db_reader, get_both_range(db::table::kPlainState, _, _)).WillOnce(InvokeWithoutArgs(
+            []() -> boost::asio::awaitable<std::optional<silkworm::Bytes>> { co_return std::nullopt; }
+        ));
+        for (int i{0}; i < 2; ++i) {
+            auto result = boost::asio::co_spawn(pool, database.get_both_range(db::table::kPlainState, kKey1, kKey2), boost::asio::use_future);
+            CHECK(!result.get());
+        }
+        CHECK(database.hit_count() == 1);
+    }
+
+    SECTION("key and subkey boundary told apart") {
+        const silkworm::Bytes key_and_subkey{*silkworm::from_hex("00000000000000010000000000000002")};
+        EXPECT_CALL(db_reader, get_both_range(db::table::kPlainState, _, _))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<std::optional<silkworm::Bytes>> { co_return kValue1; }))
+            .WillOnce(InvokeWithoutArgs([]() -> boost::asio::awaitable<std::optional<silkworm::Bytes>> { co_return kValue2; }));
+        auto result1 = boost::asio::co_spawn(pool, database.get_both_range(db::table::kPlainState, kKey1, kKey2), boost::asio::use_future);
+        CHECK(result1.get() == kValue1);
+        auto result2 = boost::asio::co_spawn(pool, database.get_both_range(db::table::kPlainState, key_and_subkey, silkworm::Bytes{}),
+                                             boost::asio::use_future);
+        CHECK(result2.get() == kValue2);
+        CHECK(database.hit_count() == 0);
+    }
+}
+
+} // namespace silkrpc::ethdb
@@ -0,0 +1,134 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "read_combiner.hpp"
+
+#include <type_traits>
+#include <utility>
+
+#include <boost/asio/compose.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/endian/conversion.hpp>
+
+namespace silkrpc::ethdb {
+
+boost::asio::awaitable<KeyValue> ReadCombiner::execute(uint64_t view_id, Kind kind, const std::string& table, silkworm::ByteView key,
+                                                       Read read) {
+    if (view_id == 0) {
+        co_return co_await read();
+    }
+
+    const auto flight_key = make_key(view_id, kind, table, key);
+    std::shared_ptr<Flight> flight;
+    bool leader{false};
+    {
+        std::lock_guard lock{mutex_};
+        auto& entry = flights_[flight_key];
+        if (entry) {
+            ++entry->num_combined;
+            ++combined_count_;
+        } else {
+            entry = std::make_shared<Flight>();
+            leader = true;
+        }
+        flight = entry;
+    }
+    if (!leader) {
+        co_await wait(flight);
+        if (flight->result) {
+            co_return *flight->result;
+        }
+        co_return co_await read();
+    }
+
+    std::optional<KeyValue> result;
+    std::exception_ptr exception;
+    try {
+        result = co_await read();
+    } catch (...) {
+        exception = std::current_exception();
+    }
+
+    std::vector<std::function<void()>> waiters;
+    bool combined{false};
+    {
+        std::lock_guard lock{mutex_};
+        const auto it = flights_.find(flight_key);
+        if (it != flights_.end() && it->second == flight) {
+            flights_.erase(it);
+        }
+        combined = flight->num_combined > 0;
+        flight->done = true;
+        if (combined) {
+            flight->result = result;
+        }
+        waiters.swap(flight->waiters);
+    }
+    for (const auto& waiter : waiters) {
+        waiter();
+    }
+
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+    // Nobody else can join the flight anymore, so its result is moved out unless shared
+    co_return std::move(*result);
+}
+
+std::size_t ReadCombiner::size() const {
+    std::lock_guard lock{mutex_};
+    return flights_.size();
+}
+
+uint64_t ReadCombiner::combined_count() const {
+    std::lock_guard lock{mutex_};
+    return combined_count_;
+}
+
+std::string ReadCombiner::make_key(uint64_t view_id, Kind kind, const std::string& table, silkworm::ByteView key) {
+    std::string flight_key;
+    flight_key.reserve(sizeof(view_id) + 1 + table.size() + 1 + key.size());
+    const auto view_id_be = boost::endian::native_to_big(view_id);
+    flight_key.append(reinterpret_cast<const char*>(&view_id_be), sizeof(view_id_be));
+    flight_key.push_back(static_cast<char>(kind));
+    flight_key.append(table);
+    flight_key.push_back('\0');
+    flight_key.append(reinterpret_cast<const char*>(key.data()), key.size());
+    return flight_key;
+}
+
+boost::asio::awaitable<void> ReadCombiner::wait(std::shared_ptr<Flight> flight) {
+    // The waiter is resumed on its own executor, whatever the thread completing the flight
+    const auto executor = co_await boost::asio::this_coro::executor;
+    co_await boost::asio::async_compose<decltype(boost::asio::use_awaitable), void()>(
+        [&](auto&& self) {
+            auto shared_self = std::make_shared<std::decay_t<decltype(self)>>(std::move(self));
+            auto resume = [executor, shared_self]() {
+                boost::asio::post(executor, [shared_self]() { shared_self->complete(); });
+            };
+            std::lock_guard lock{mutex_};
+            if (flight->done) {
+                resume();
+            } else {
+                flight->waiters.emplace_back(std::move(resume));
+            }
+        },
+        boost::asio::use_awaitable);
+}
+
+} // namespace silkrpc::ethdb
@@ -0,0 +1,91 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_ETHDB_READ_COMBINER_HPP_
+#define SILKRPC_ETHDB_READ_COMBINER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+
+#include <silkworm/common/base.hpp>
+#include <silkrpc/common/util.hpp>
+
+namespace silkrpc::ethdb {
+
+//! Combining of the identical point reads in flight on the transactions opened on the same database view: the first
+//! read of some key in some table (the leader) is executed on its own transaction, while the identical ones arriving
+//! before it completes just await and share its result. The database view identifies the whole state read, so nothing
+//! is ever invalidated: the reads at a new view start new flights, those in progress at older views just complete.
+//! If the leader read fails, e.g. because its own transaction breaks down, the combined ones are executed on their own.
+//! The callers can run on any executor, each one is resumed on its own.
+class ReadCombiner {
+public:
+    //! The cursor operation executing the read
+    enum class Kind : uint8_t {
+        seek = 1,
+        seek_exact = 2,
+    };
+
+    using Read = std::function<boost::asio::awaitable<KeyValue>()>;
+
+    ReadCombiner() = default;
+
+    ReadCombiner(const ReadCombiner&) = delete;
+    ReadCombiner& operator=(const ReadCombiner&) = delete;
+
+    //! Execute the read of the key in the table at the view, unless an identical one is already in flight: the reads at
+    //! the unknown view (i.e. zero) are never combined
+    boost::asio::awaitable<KeyValue> execute(uint64_t view_id, Kind kind, const std::string& table, silkworm::ByteView key, Read read);
+
+    //! The number of reads in flight
+    std::size_t size() const;
+
+    //! The number of reads which have been combined with an identical one in flight
+    uint64_t combined_count() const;
+
+private:
+    struct Flight {
+        bool done{false};
+        std::size_t num_combined{0};
+        std::optional<KeyValue> result;
+        std::vector<std::function<void()>> waiters;
+    };
+
+    static std::string make_key(uint64_t view_id, Kind kind, const std::string& table, silkworm::ByteView key);
+
+    boost::asio::awaitable<void> wait(std::shared_ptr<Flight> flight);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Flight>> flights_;
+    uint64_t combined_count_{0};
+};
+
+} // namespace silkrpc::ethdb
+
+#endif // SILKRPC_ETHDB_READ_COMBINER_HPP_
@@ -0,0 +1,130 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "read_combiner.hpp"
+
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/use_future.hpp>
+#include <catch2/catch.hpp>
+
+namespace silkrpc::ethdb {
+
+using Catch::Matchers::Message;
+using namespace std::chrono_literals; // NOLINT(build/namespaces)
+
+static const std::string kTable{"PlainState"};
+static const silkworm::Bytes kKey{0x01, 0x02, 0x03};
+
+//! Read returning the value after a short delay, counting its executions
+static ReadCombiner::Read delayed(uint8_t value, std::size_t& executions) {
+    return [&executions, value]() -> boost::asio::awaitable<KeyValue> {
+        ++executions;
+        boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor, 10ms};
+        co_await timer.async_wait(boost::asio::use_awaitable);
+        co_return KeyValue{kKey, silkworm::Bytes{value}};
+    };
+}
+
+TEST_CASE("read combiner", "[silkrpc][ethdb][read_combiner]") {
+    boost::asio::io_context io_context;
+    ReadCombiner combiner;
+    std::size_t executions{0};
+
+    auto spawn = [&](uint64_t view_id, ReadCombiner::Kind kind, const std::string& table, const silkworm::Bytes& key, ReadCombiner::Read read) {
+        return boost::asio::co_spawn(io_context, combiner.execute(view_id, kind, table, key, std::move(read)), boost::asio::use_future);
+    };
+
+    SECTION("identical concurrent reads share one execution") {
+        std::vector<std::future<KeyValue>> results;
+        for (int i{0}; i < 5; ++i) {
+            results.push_back(spawn(1, ReadCombiner::Kind::seek_exact, kTable, kKey, delayed(0x2a, executions)));
+        }
+        io_context.run();
+        for (auto& result : results) {
+            const auto kv = result.get();
+            CHECK(kv.key == kKey);
+            CHECK(kv.value == silkworm::Bytes{0x2a});
+        }
+        CHECK(executions == 1);
+        CHECK(combiner.combined_count() == 4);
+        CHECK(combiner.size() == 0);
+    }
+
+    SECTION("different views, kinds, tables and keys executed separately") {
+        auto result1 = spawn(1, ReadCombiner::Kind::seek_exact, kTable, kKey, delayed(1, executions));
+        auto result2 = spawn(2, ReadCombiner::Kind::seek_exact, kTable, kKey, delayed(2, executions));
+        auto result3 = spawn(1, ReadCombiner::Kind::seek, kTable, kKey, delayed(3, executions));
+        auto result4 = spawn(1, ReadCombiner::Kind::seek_exact, "Code", kKey, delayed(4, executions));
+        auto result5 = spawn(1, ReadCombiner::Kind::seek_exact, kTable, silkworm::Bytes{0x01, 0x02}, delayed(5, executions));
+        io_context.run();
+        CHECK(result1.get().value == silkworm::Bytes{1});
+        CHECK(result2.get().value == silkworm::Bytes{2});
+        CHECK(result3.get().value == silkworm::Bytes{3});
+        CHECK(result4.get().value == silkworm::Bytes{4});
+        CHECK(result5.get().value == silkworm::Bytes{5});
+        CHECK(executions == 5);
+        CHECK(combiner.combined_count() == 0);
+    }
+
+    SECTION("reads at the unknown view never combined") {
+        auto result1 = spawn(0, ReadCombiner::Kind::seek_exact, kTable, kKey, delayed(1, executions));
+        auto result2 = spawn(0, ReadCombiner::Kind::seek_exact, kTable, kKey, delayed(2, executions));
+        io_context.run();
+        CHECK(result1.get().value == silkworm::Bytes{1});
+        CHECK(result2.get().value == silkworm::Bytes{2});
+        CHECK(executions == 2);
+    }
+
+    SECTION("sequential reads executed separately") {
+        auto result1 = spawn(1, ReadCombiner::Kind::seek_exact, kTable, kKey, delayed(1, executions));
+        io_context.run();
+        io_context.restart();
+        auto result2 = spawn(1, ReadCombiner::Kind::seek_exact, kTable, kKey, delayed(2, executions));
+        io_context.run();
+        CHECK(result1.get().value == silkworm::Bytes{1});
+        CHECK(result2.get().value == silkworm::Bytes{2});
+        CHECK(executions == 2);
+    }
+
+    SECTION("combined reads executed on their own if the leader fails") {
+        ReadCombiner::Read failing = [&executions]() -> boost::asio::awaitable<KeyValue> {
+            ++executions;
+            boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor, 10ms};
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            throw std::runtime_error{"broken stream"};
+        };
+        auto result1 = spawn(1, ReadCombiner::Kind::seek_exact, kTable, kKey, failing);
+        auto result2 = spawn(1, ReadCombiner::Kind::seek_exact, kTable, kKey, delayed(2, executions));
+        io_context.run();
+        CHECK_THROWS_MATCHES(result1.get(), std::runtime_error, Message("broken stream"));
+        CHECK(result2.get().value == silkworm::Bytes{2});
+        CHECK(executions == 2);
+        CHECK(combiner.combined_count() == 1);
+        CHECK(combiner.size() == 0);
+    }
+}
+
+} // namespace silkrpc::ethdb
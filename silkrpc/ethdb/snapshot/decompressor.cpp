@@ -0,0 +1,241 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "decompressor.hpp"
+
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <boost/endian/conversion.hpp>
+
+namespace silkrpc::ethdb::snapshot {
+
+namespace {
+
+//! The size of the big-endian fields of the segment header
+constexpr std::size_t kFieldSize{sizeof(uint64_t)};
+
+//! The maximum depth of the Huffman codes, well beyond any depth ever produced by compressing real words
+constexpr uint64_t kMaxCodeDepth{64};
+
+//! Reader of the unsigned LEB128 varints of the segment dictionaries
+uint64_t read_varint(silkworm::ByteView data, std::size_t& position) {
+    uint64_t value{0};
+    for (unsigned shift{0}; shift < 64; shift += 7) {
+        if (position >= data.size()) {
+            throw std::runtime_error{"truncated varint in segment dictionary"};
+        }
+        const uint8_t byte = data[position++];
+        value |= uint64_t{byte & 0x7fu} << shift;
+        if ((byte & 0x80u) == 0) {
+            return value;
+        }
+    }
+    throw std::runtime_error{"overflowing varint in segment dictionary"};
+}
+
+} // namespace
+
+HuffmanTree::HuffmanTree(const std::vector<uint64_t>& depths) {
+    if (depths.empty()) {
+        return;
+    }
+    nodes_.reserve(2 * depths.size());
+    std::size_t next{0};
+    build(depths, next, 0);
+    if (next != depths.size()) {
+        throw std::runtime_error{"inconsistent code depths in segment dictionary"};
+    }
+}
+
+uint32_t HuffmanTree::build(const std::vector<uint64_t>& depths, std::size_t& next, uint64_t depth) {
+    // The tree is not complete if the symbols run out on the left branch: the right one stays missing
+    if (next == depths.size()) {
+        return kNoNode;
+    }
+    if (depths[next] < depth || depth > kMaxCodeDepth) {
+        throw std::runtime_error{"invalid code depth in segment dictionary"};
+    }
+    const auto node = static_cast<uint32_t>(nodes_.size());
+    nodes_.emplace_back();
+    if (depths[next] == depth) {
+        nodes_[node].leaf = true;
+        nodes_[node].symbol = static_cast<uint32_t>(next++);
+        return node;
+    }
+    // The codes are read least significant bit first: each bit selects the branch of the next tree level
+    const auto left = build(depths, next, depth + 1);
+    const auto right = build(depths, next, depth + 1);
+    nodes_[node].children[0] = left;
+    nodes_[node].children[1] = right;
+    return node;
+}
+
+//! Reader of the bits of the encoded words, least significant bit of each byte first
+class Decompressor::BitReader {
+public:
+    BitReader(silkworm::ByteView data, uint64_t position) : data_{data}, position_{position} {}
+
+    unsigned read_bit() {
+        if (position_ >= data_.size()) {
+            fail();
+        }
+        const unsigned bit = (data_[position_] >> bit_) & 1u;
+        if (++bit_ == CHAR_BIT) {
+            bit_ = 0;
+            ++position_;
+        }
+        return bit;
+    }
+
+    //! Skip the bits left in the current byte, if any
+    void align() {
+        if (bit_ > 0) {
+            bit_ = 0;
+            ++position_;
+        }
+    }
+
+    uint64_t position() const { return position_; }
+
+    [[noreturn]] void fail() const { throw std::runtime_error{"corrupted word at offset " + std::to_string(position_)}; }
+
+private:
+    silkworm::ByteView data_;
+    uint64_t position_;
+    unsigned bit_{0};
+};
+
+Decompressor::Decompressor(const std::filesystem::path& path) : file_{path} {
+    const auto data = file_.view();
+    auto check_size = [&](std::size_t position, std::size_t size) {
+        if (position > data.size() || size > data.size() - position) {
+            throw std::runtime_error{"truncated segment file " + path.string()};
+        }
+    };
+
+    check_size(0, 3 * kFieldSize);
+    words_count_ = boost::endian::load_big_u64(data.data());
+    empty_words_count_ = boost::endian::load_big_u64(data.data() + kFieldSize);
+
+    // The pattern dictionary holds the depth and the bytes of each pattern, which are kept as views into the mapped file
+    const std::size_t pattern_dict_size = boost::endian::load_big_u64(data.data() + 2 * kFieldSize);
+    check_size(3 * kFieldSize, pattern_dict_size);
+    const auto pattern_dict = data.substr(3 * kFieldSize, pattern_dict_size);
+    std::vector<uint64_t> pattern_depths;
+    for (std::size_t position{0}; position < pattern_dict.size();) {
+        pattern_depths.push_back(read_varint(pattern_dict, position));
+        const auto pattern_size = read_varint(pattern_dict, position);
+        if (pattern_size > pattern_dict.size() - position) {
+            throw std::runtime_error{"truncated pattern in segment file " + path.string()};
+        }
+        patterns_.push_back(pattern_dict.substr(position, pattern_size));
+        position += pattern_size;
+    }
+    pattern_tree_ = HuffmanTree{pattern_depths};
+
+    // The position dictionary holds the depth and the value of each position
+    const std::size_t position_dict_offset{3 * kFieldSize + pattern_dict_size};
+    check_size(position_dict_offset, kFieldSize);
+    const std::size_t position_dict_size = boost::endian::load_big_u64(data.data() + position_dict_offset);
+    check_size(position_dict_offset + kFieldSize, position_dict_size);
+    const auto position_dict = data.substr(position_dict_offset + kFieldSize, position_dict_size);
+    std::vector<uint64_t> position_depths;
+    for (std::size_t position{0}; position < position_dict.size();) {
+        position_depths.push_back(read_varint(position_dict, position));
+        positions_.push_back(read_varint(position_dict, position));
+    }
+    position_tree_ = HuffmanTree{position_depths};
+
+    words_ = data.substr(position_dict_offset + kFieldSize + position_dict_size);
+    if (words_count_ > 0 && position_tree_.empty()) {
+        throw std::runtime_error{"missing position dictionary in segment file " + path.string()};
+    }
+}
+
+uint64_t Decompressor::next_position(BitReader& reader) const {
+    return positions_[position_tree_.decode(reader)];
+}
+
+silkworm::ByteView Decompressor::next_pattern(BitReader& reader) const {
+    if (pattern_tree_.empty()) {
+        reader.fail();
+    }
+    return patterns_[pattern_tree_.decode(reader)];
+}
+
+uint64_t Decompressor::decode_word(uint64_t offset, silkworm::Bytes& word) const {
+    word.clear();
+    if (offset >= words_.size()) {
+        throw std::runtime_error{"word offset " + std::to_string(offset) + " out of range in " + path().string()};
+    }
+    BitReader reader{words_, offset};
+    uint64_t word_size = next_position(reader);
+    if (word_size == 0) {
+        reader.fail();
+    }
+    --word_size; // zero is the terminator, so the sizes are shifted by one
+    if (word_size == 0) {
+        reader.align();
+        return reader.position();
+    }
+    if (word_size > words_.size() * CHAR_BIT * kMaxCodeDepth) {
+        reader.fail(); // no way to encode such word in the file
+    }
+    word.resize(word_size);
+
+    // The first pass copies the patterns at their positions, each one relative to the previous one
+    uint64_t word_position{0};
+    for (auto position = next_position(reader); position != 0; position = next_position(reader)) {
+        word_position += position - 1;
+        const auto pattern = next_pattern(reader);
+        if (word_position > word_size || pattern.size() > word_size - word_position) {
+            reader.fail();
+        }
+        std::memcpy(word.data() + word_position, pattern.data(), pattern.size());
+    }
+    reader.align();
+    uint64_t raw_offset = reader.position();
+
+    // The second pass decodes the patterns again to fill the gaps between them with the raw bytes following the codes
+    auto copy_raw = [&](uint64_t from, uint64_t to) {
+        const auto size = to - from;
+        if (raw_offset > words_.size() || size > words_.size() - raw_offset) {
+            reader.fail();
+        }
+        std::memcpy(word.data() + from, words_.data() + raw_offset, size);
+        raw_offset += size;
+    };
+    reader = BitReader{words_, offset};
+    next_position(reader);
+    word_position = 0;
+    uint64_t last_uncovered{0};
+    for (auto position = next_position(reader); position != 0; position = next_position(reader)) {
+        word_position += position - 1;
+        if (word_position > last_uncovered) {
+            copy_raw(last_uncovered, word_position);
+        }
+        last_uncovered = word_position + next_pattern(reader).size();
+    }
+    if (word_size > last_uncovered) {
+        copy_raw(last_uncovered, word_size);
+    }
+    return raw_offset;
+}
+
+} // namespace silkrpc::ethdb::snapshot
@@ -0,0 +1,114 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_ETHDB_SNAPSHOT_DECOMPRESSOR_HPP_
+#define SILKRPC_ETHDB_SNAPSHOT_DECOMPRESSOR_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include <silkworm/common/base.hpp>
+
+#include <silkrpc/ethdb/snapshot/memory_mapped_file.hpp>
+
+namespace silkrpc::ethdb::snapshot {
+
+//! Canonical Huffman code of the patterns or positions of a segment file, as a binary tree walked one bit at a time
+class HuffmanTree {
+public:
+    HuffmanTree() = default;
+
+    //! Build the tree from the code lengths (i.e. depths) of the symbols in canonical order, as Erigon stores them
+    explicit HuffmanTree(const std::vector<uint64_t>& depths);
+
+    bool empty() const noexcept { return nodes_.empty(); }
+
+    //! Decode the next symbol from the bit stream, returning its index in the dictionary. The bit is read by Reader::read_bit
+    template <typename Reader>
+    std::size_t decode(Reader& reader) const {
+        uint32_t node{0};
+        while (!nodes_[node].leaf) {
+            node = nodes_[node].children[reader.read_bit()];
+            if (node == kNoNode) {
+                reader.fail();
+            }
+        }
+        return nodes_[node].symbol;
+    }
+
+private:
+    static constexpr uint32_t kNoNode{UINT32_MAX};
+
+    struct Node {
+        uint32_t children[2]{kNoNode, kNoNode};
+        uint32_t symbol{0};
+        bool leaf{false};
+    };
+
+    uint32_t build(const std::vector<uint64_t>& depths, std::size_t& next, uint64_t depth);
+
+    std::vector<Node> nodes_;
+};
+
+//! Decompressor of the words in one Erigon snapshot segment file (.seg), compressed by replacing the frequent patterns
+//! of bytes with their Huffman codes. The file is made of the word count, the empty word count, the pattern dictionary
+//! and the position dictionary, each one prefixed by its big-endian size and made of (depth, pattern or position)
+//! varint entries, followed by the words. Each word is encoded as the Huffman codes of its length plus one, of the
+//! (relative position plus one, pattern) pairs covering it and of the terminating zero position, padded to the byte,
+//! followed by the raw bytes not covered by any pattern. The decompressor is immutable, so it can be shared by any thread.
+class Decompressor {
+public:
+    //! Map the segment file and load its dictionaries, throwing std::runtime_error if it is not a valid segment file
+    explicit Decompressor(const std::filesystem::path& path);
+
+    Decompressor(const Decompressor&) = delete;
+    Decompressor& operator=(const Decompressor&) = delete;
+
+    const std::filesystem::path& path() const noexcept { return file_.path(); }
+
+    uint64_t words_count() const noexcept { return words_count_; }
+
+    uint64_t empty_words_count() const noexcept { return empty_words_count_; }
+
+    //! The size in bytes of the encoded words, i.e. the upper bound of the word offsets
+    std::size_t words_size() const noexcept { return words_.size(); }
+
+    //! Decode the word at the specified offset (relative to the first word, as stored in the index) replacing the buffer
+    //! content, returning the offset of the next word. Throw std::runtime_error if the word is corrupted
+    uint64_t decode_word(uint64_t offset, silkworm::Bytes& word) const;
+
+private:
+    class BitReader;
+
+    uint64_t next_position(BitReader& reader) const;
+
+    silkworm::ByteView next_pattern(BitReader& reader) const;
+
+    MemoryMappedFile file_;
+    uint64_t words_count_{0};
+    uint64_t empty_words_count_{0};
+    std::vector<silkworm::ByteView> patterns_;
+    HuffmanTree pattern_tree_;
+    std::vector<uint64_t> positions_;
+    HuffmanTree position_tree_;
+    silkworm::ByteView words_;
+};
+
+} // namespace silkrpc::ethdb::snapshot
+
+#endif // SILKRPC_ETHDB_SNAPSHOT_DECOMPRESSOR_HPP_
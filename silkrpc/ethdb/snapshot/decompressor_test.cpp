@@ -0,0 +1,122 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "decompressor.hpp"
+
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <silkrpc/test/snapshot_files.hpp>
+
+namespace silkrpc::ethdb::snapshot {
+
+static silkworm::Bytes bytes_of(const char* text) {
+    return silkworm::Bytes{reinterpret_cast<const uint8_t*>(text), std::char_traits<char>::length(text)};
+}
+
+TEST_CASE("HuffmanTree", "[silkrpc][ethdb][snapshot][decompressor]") {
+    SECTION("empty") {
+        CHECK(HuffmanTree{}.empty());
+        CHECK(HuffmanTree{std::vector<uint64_t>{}}.empty());
+    }
+
+    SECTION("inconsistent depths") {
+        CHECK_THROWS_AS(HuffmanTree(std::vector<uint64_t>{1, 1, 1}), std::runtime_error);
+        CHECK_THROWS_AS(HuffmanTree(std::vector<uint64_t>{2, 1, 2}), std::runtime_error);
+    }
+
+    SECTION("valid depths") {
+        CHECK_NOTHROW(HuffmanTree(std::vector<uint64_t>{1, 2, 2}));
+        CHECK_NOTHROW(HuffmanTree(std::vector<uint64_t>{2, 2, 1}));
+        CHECK_NOTHROW(HuffmanTree(std::vector<uint64_t>{0}));
+    }
+}
+
+TEST_CASE("Decompressor::decode_word", "[silkrpc][ethdb][snapshot][decompressor]") {
+    const auto path = std::filesystem::temp_directory_path() / "silkrpc_decompressor_test.seg";
+    silkworm::Bytes word;
+
+    SECTION("words w/o patterns") {
+        test::SegmentWriter writer;
+        writer.add_word(bytes_of("abc"));
+        writer.add_word({});
+        writer.add_word(bytes_of("hello"));
+        writer.add_word(bytes_of("abc"));
+        const auto offsets = writer.write(path);
+
+        Decompressor decompressor{path};
+        CHECK(decompressor.words_count() == 4);
+        CHECK(decompressor.empty_words_count() == 1);
+        uint64_t offset{0};
+        offset = decompressor.decode_word(offset, word);
+        CHECK(word == bytes_of("abc"));
+        CHECK(offset == offsets[1]);
+        offset = decompressor.decode_word(offset, word);
+        CHECK(word.empty());
+        CHECK(offset == offsets[2]);
+        offset = decompressor.decode_word(offset, word);
+        CHECK(word == bytes_of("hello"));
+        CHECK(offset == offsets[3]);
+        offset = decompressor.decode_word(offset, word);
+        CHECK(word == bytes_of("abc"));
+        CHECK(offset == decompressor.words_size());
+    }
+
+    SECTION("words with patterns") {
+        test::SegmentWriter writer{{bytes_of("hello"), bytes_of("world"), bytes_of("!")}};
+        writer.add_word(bytes_of("hello, world!"), {{0, 0}, {7, 1}, {12, 2}});
+        writer.add_word(bytes_of("say hello"), {{4, 0}});
+        writer.add_word(bytes_of("worldworld"), {{0, 1}, {5, 1}});
+        writer.add_word(bytes_of("no pattern"));
+        const auto offsets = writer.write(path);
+
+        Decompressor decompressor{path};
+        CHECK(decompressor.decode_word(offsets[0], word) == offsets[1]);
+        CHECK(word == bytes_of("hello, world!"));
+        CHECK(decompressor.decode_word(offsets[1], word) == offsets[2]);
+        CHECK(word == bytes_of("say hello"));
+        CHECK(decompressor.decode_word(offsets[2], word) == offsets[3]);
+        CHECK(word == bytes_of("worldworld"));
+        CHECK(decompressor.decode_word(offsets[3], word) == decompressor.words_size());
+        CHECK(word == bytes_of("no pattern"));
+    }
+
+    SECTION("offset out of range") {
+        test::SegmentWriter writer;
+        writer.add_word(bytes_of("abc"));
+        writer.write(path);
+
+        Decompressor decompressor{path};
+        CHECK_THROWS_AS(decompressor.decode_word(decompressor.words_size(), word), std::runtime_error);
+    }
+
+    SECTION("truncated file") {
+        test::SegmentWriter::write_file(path, silkworm::Bytes(20, 0));
+        CHECK_THROWS_AS(Decompressor{path}, std::runtime_error);
+    }
+
+    SECTION("missing file") {
+        std::filesystem::remove(path);
+        CHECK_THROWS_AS(Decompressor{path}, std::runtime_error);
+    }
+
+    std::filesystem::remove(path);
+}
+
+} // namespace silkrpc::ethdb::snapshot
@@ -0,0 +1,111 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "elias_fano.hpp"
+
+#include <bit>
+#include <climits>
+#include <stdexcept>
+#include <string>
+
+#include <boost/endian/conversion.hpp>
+
+namespace silkrpc::ethdb::snapshot {
+
+namespace {
+
+constexpr std::size_t kHeaderSize{2 * sizeof(uint64_t)};
+constexpr uint64_t kWordBits{64};
+
+//! Return the position of the set bit having the specified rank (i.e. the number of set bits preceding it) in the word
+int select64(uint64_t word, uint64_t rank) {
+    for (; rank > 0; --rank) {
+        word &= word - 1;
+    }
+    return std::countr_zero(word);
+}
+
+} // namespace
+
+EliasFanoList::EliasFanoList(silkworm::ByteView data) {
+    if (data.size() < kHeaderSize) {
+        throw std::runtime_error{"truncated Elias-Fano list header"};
+    }
+    count_ = boost::endian::load_big_u64(data.data());
+    upper_bound_ = boost::endian::load_big_u64(data.data() + sizeof(uint64_t));
+    // The upper bits hold one set bit per integer at least, so any count beyond the data size is just garbage
+    if (count_ >= (data.size() - kHeaderSize) * CHAR_BIT) {
+        throw std::runtime_error{"invalid Elias-Fano list size: " + std::to_string(count_)};
+    }
+    const uint64_t size{count_ + 1};
+    const uint64_t average_gap{upper_bound_ / size};
+    lower_bits_size_ = average_gap == 0 ? 0 : static_cast<uint64_t>(std::bit_width(average_gap) - 1);
+    lower_bits_mask_ = (uint64_t{1} << lower_bits_size_) - 1;
+
+    const uint64_t lower_words{(size * lower_bits_size_ + kWordBits - 1) / kWordBits + 1};
+    const uint64_t upper_words{(size + (upper_bound_ >> lower_bits_size_) + kWordBits - 1) / kWordBits};
+    uint64_t jump_words{(size / kSuperQ) * kSuperQSize};
+    if (size % kSuperQ != 0) {
+        jump_words += 1 + ((size % kSuperQ + kQ - 1) / kQ + 3) / 2;
+    }
+    const uint64_t total_words{lower_words + upper_words + jump_words};
+    if (total_words > (data.size() - kHeaderSize) / sizeof(uint64_t)) {
+        throw std::runtime_error{"truncated Elias-Fano list of size " + std::to_string(size)};
+    }
+    const auto words = data.substr(kHeaderSize, total_words * sizeof(uint64_t));
+    lower_bits_ = words.substr(0, lower_words * sizeof(uint64_t));
+    upper_bits_ = words.substr(lower_words * sizeof(uint64_t), upper_words * sizeof(uint64_t));
+    jump_ = words.substr((lower_words + upper_words) * sizeof(uint64_t));
+    encoded_size_ = kHeaderSize + words.size();
+}
+
+uint64_t EliasFanoList::word(silkworm::ByteView words, uint64_t index) {
+    if (index >= words.size() / sizeof(uint64_t)) {
+        throw std::runtime_error{"corrupted Elias-Fano list"};
+    }
+    return boost::endian::load_little_u64(words.data() + index * sizeof(uint64_t));
+}
+
+uint64_t EliasFanoList::get(uint64_t index) const {
+    if (index > count_) {
+        throw std::out_of_range{"Elias-Fano list index " + std::to_string(index) + " beyond size " + std::to_string(size())};
+    }
+
+    const uint64_t lower_position{index * lower_bits_size_};
+    const uint64_t lower_shift{lower_position % kWordBits};
+    uint64_t lower{word(lower_bits_, lower_position / kWordBits) >> lower_shift};
+    if (lower_shift > 0) {
+        lower |= word(lower_bits_, lower_position / kWordBits + 1) << (kWordBits - lower_shift);
+    }
+
+    // The jump table gives the position in the upper bits of the closest preceding integer having index multiple of kQ
+    const uint64_t jump_block{(index / kSuperQ) * kSuperQSize};
+    const uint64_t jump_inside_block{(index % kSuperQ) / kQ};
+    const uint64_t jump_offset{(word(jump_, jump_block + 1 + jump_inside_block / 2) >> (32 * (jump_inside_block % 2))) & UINT32_MAX};
+    const uint64_t jump{word(jump_, jump_block) + jump_offset};
+
+    uint64_t current_word{jump / kWordBits};
+    uint64_t window{word(upper_bits_, current_word) & (~uint64_t{0} << (jump % kWordBits))};
+    uint64_t rank{index % kQ};
+    for (uint64_t bit_count = std::popcount(window); bit_count <= rank; bit_count = std::popcount(window)) {
+        rank -= bit_count;
+        window = word(upper_bits_, ++current_word);
+    }
+    const uint64_t upper{current_word * kWordBits + select64(window, rank) - index};
+    return (upper << lower_bits_size_) | (lower & lower_bits_mask_);
+}
+
+} // namespace silkrpc::ethdb::snapshot
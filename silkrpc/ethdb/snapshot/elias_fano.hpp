@@ -0,0 +1,68 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_ETHDB_SNAPSHOT_ELIAS_FANO_HPP_
+#define SILKRPC_ETHDB_SNAPSHOT_ELIAS_FANO_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <silkworm/common/base.hpp>
+
+namespace silkrpc::ethdb::snapshot {
+
+//! Elias-Fano list of monotone integers as encoded by Erigon, read in place. The list is made of its big-endian size minus
+//! one and upper bound, followed by the little-endian 64-bit words of the lower bits of the integers, of their upper bits
+//! in unary and of the jump table locating the upper bits of every 256-th integer, so that any integer is found in the
+//! upper bits by scanning a few words at most.
+class EliasFanoList {
+public:
+    //! The number of integers between consecutive jump table entries
+    static constexpr uint64_t kQ{256};
+
+    //! The number of integers covered by one block of the jump table, made of the absolute position plus 64 offsets
+    static constexpr uint64_t kSuperQ{1 << 14};
+
+    //! The number of 64-bit words of one block of the jump table, holding the 32-bit offsets packed by two
+    static constexpr uint64_t kSuperQSize{1 + kSuperQ / kQ / 2};
+
+    //! Read the list at the start of the data, throwing std::runtime_error if it is truncated
+    explicit EliasFanoList(silkworm::ByteView data);
+
+    uint64_t size() const noexcept { return count_ + 1; }
+
+    //! The size in bytes of the encoded list, i.e. the offset of what follows it in the data
+    std::size_t encoded_size() const noexcept { return encoded_size_; }
+
+    //! Return the integer at the specified index, throwing std::out_of_range if beyond the size
+    uint64_t get(uint64_t index) const;
+
+private:
+    static uint64_t word(silkworm::ByteView words, uint64_t index);
+
+    uint64_t count_{0};
+    uint64_t upper_bound_{0};
+    uint64_t lower_bits_size_{0};
+    uint64_t lower_bits_mask_{0};
+    silkworm::ByteView lower_bits_;
+    silkworm::ByteView upper_bits_;
+    silkworm::ByteView jump_;
+    std::size_t encoded_size_{0};
+};
+
+} // namespace silkrpc::ethdb::snapshot
+
+#endif // SILKRPC_ETHDB_SNAPSHOT_ELIAS_FANO_HPP_
@@ -0,0 +1,72 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "elias_fano.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <silkrpc/test/snapshot_files.hpp>
+
+namespace silkrpc::ethdb::snapshot {
+
+TEST_CASE("EliasFanoList", "[silkrpc][ethdb][snapshot][elias_fano]") {
+    SECTION("single value") {
+        const auto encoded = test::encode_elias_fano({42});
+        EliasFanoList list{encoded};
+        CHECK(list.size() == 1);
+        CHECK(list.encoded_size() == encoded.size());
+        CHECK(list.get(0) == 42);
+        CHECK_THROWS_AS(list.get(1), std::out_of_range);
+    }
+
+    SECTION("repeated values") {
+        const std::vector<uint64_t> values{0, 0, 5, 5, 5, 9};
+        EliasFanoList list{test::encode_elias_fano(values)};
+        for (std::size_t i{0}; i < values.size(); ++i) {
+            CHECK(list.get(i) == values[i]);
+        }
+    }
+
+    SECTION("values spanning several jump blocks") {
+        std::vector<uint64_t> values;
+        uint64_t value{0};
+        for (uint64_t i{0}; i < 3 * EliasFanoList::kSuperQ + 100; ++i) {
+            value += 1 + (i * 7919) % 1000;
+            values.push_back(value);
+        }
+        const auto encoded = test::encode_elias_fano(values);
+        EliasFanoList list{encoded};
+        CHECK(list.size() == values.size());
+        CHECK(list.encoded_size() == encoded.size());
+        for (std::size_t i{0}; i < values.size(); ++i) {
+            if (values[i] != list.get(i)) {
+                FAIL("mismatch at index " << i);
+            }
+        }
+    }
+
+    SECTION("truncated list") {
+        auto encoded = test::encode_elias_fano({1, 2, 3});
+        encoded.resize(encoded.size() - 1);
+        CHECK_THROWS_AS(EliasFanoList{encoded}, std::runtime_error);
+        CHECK_THROWS_AS(EliasFanoList{encoded.substr(0, 8)}, std::runtime_error);
+    }
+}
+
+} // namespace silkrpc::ethdb::snapshot
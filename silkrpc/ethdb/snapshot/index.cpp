@@ -0,0 +1,77 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "index.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include <boost/endian/conversion.hpp>
+
+namespace silkrpc::ethdb::snapshot {
+
+namespace {
+
+//! The bit of the feature flags telling that the index holds the offset list
+constexpr uint8_t kEnumsFeature{0x01};
+
+} // namespace
+
+Index::Index(const std::filesystem::path& path) : file_{path} {
+    const auto data = file_.view();
+    std::size_t offset{0};
+    auto skip = [&](std::size_t size) {
+        if (size > data.size() - offset) {
+            throw std::runtime_error{"truncated index file " + path.string()};
+        }
+        offset += size;
+        return data.data() + offset - size;
+    };
+
+    base_data_id_ = boost::endian::load_big_u64(skip(sizeof(uint64_t)));
+    key_count_ = boost::endian::load_big_u64(skip(sizeof(uint64_t)));
+    const uint8_t bytes_per_record{*skip(1)};
+    if (key_count_ > data.size()) {
+        throw std::runtime_error{"invalid key count " + std::to_string(key_count_) + " in index file " + path.string()};
+    }
+
+    // The hash function parameters are skipped: the records, the bucket count, bucket size, leaf size, salt and start seeds
+    skip(key_count_ * bytes_per_record);
+    skip(sizeof(uint64_t) + 2 * sizeof(uint16_t) + sizeof(uint32_t));
+    const uint8_t start_seed_count{*skip(1)};
+    skip(start_seed_count * sizeof(uint64_t));
+
+    const uint8_t features{*skip(1)};
+    if ((features & kEnumsFeature) == 0) {
+        throw std::runtime_error{"index file " + path.string() + " built w/o enumeration"};
+    }
+    if (key_count_ > 0) {
+        offsets_.emplace(data.substr(offset));
+        if (offsets_->size() != key_count_) {
+            throw std::runtime_error{"offset count mismatch in index file " + path.string()};
+        }
+    }
+}
+
+uint64_t Index::ordinal_lookup(uint64_t ordinal) const {
+    if (ordinal >= key_count_) {
+        throw std::out_of_range{"ordinal " + std::to_string(ordinal) + " beyond key count " + std::to_string(key_count_) + " in " +
+            path().string()};
+    }
+    return offsets_->get(ordinal);
+}
+
+} // namespace silkrpc::ethdb::snapshot
@@ -0,0 +1,60 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_ETHDB_SNAPSHOT_INDEX_HPP_
+#define SILKRPC_ETHDB_SNAPSHOT_INDEX_HPP_
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+#include <silkrpc/ethdb/snapshot/elias_fano.hpp>
+#include <silkrpc/ethdb/snapshot/memory_mapped_file.hpp>
+
+namespace silkrpc::ethdb::snapshot {
+
+//! Index of the words in one Erigon snapshot segment file (.idx), built as a RecSplit minimal perfect hash function of their
+//! keys (e.g. the block hashes) plus, when built with enumeration, the Elias-Fano list of the word offsets in segment order.
+//! Just the ordinal lookup is supported: the words are looked up by their position in the segment (i.e. the block number
+//! or the transaction id minus the base data id), which needs the header fields and the offset list only.
+class Index {
+public:
+    //! Map the index file, throwing std::runtime_error if it is not a valid index file built with enumeration
+    explicit Index(const std::filesystem::path& path);
+
+    Index(const Index&) = delete;
+    Index& operator=(const Index&) = delete;
+
+    const std::filesystem::path& path() const noexcept { return file_.path(); }
+
+    //! The data id of the first word, i.e. the first block number or transaction id in the segment
+    uint64_t base_data_id() const noexcept { return base_data_id_; }
+
+    uint64_t key_count() const noexcept { return key_count_; }
+
+    //! Return the offset in the segment of the word at the specified position, throwing std::out_of_range if beyond the count
+    uint64_t ordinal_lookup(uint64_t ordinal) const;
+
+private:
+    MemoryMappedFile file_;
+    uint64_t base_data_id_{0};
+    uint64_t key_count_{0};
+    std::optional<EliasFanoList> offsets_;
+};
+
+} // namespace silkrpc::ethdb::snapshot
+
+#endif // SILKRPC_ETHDB_SNAPSHOT_INDEX_HPP_
@@ -0,0 +1,68 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "index.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <silkrpc/test/snapshot_files.hpp>
+
+namespace silkrpc::ethdb::snapshot {
+
+TEST_CASE("Index::ordinal_lookup", "[silkrpc][ethdb][snapshot][index]") {
+    const auto path = std::filesystem::temp_directory_path() / "silkrpc_index_test.idx";
+
+    SECTION("offsets by ordinal") {
+        const std::vector<uint64_t> offsets{0, 120, 250, 251, 1'024, 70'000};
+        test::write_index_file(path, 500'000, offsets);
+
+        Index index{path};
+        CHECK(index.base_data_id() == 500'000);
+        CHECK(index.key_count() == offsets.size());
+        for (std::size_t i{0}; i < offsets.size(); ++i) {
+            CHECK(index.ordinal_lookup(i) == offsets[i]);
+        }
+        CHECK_THROWS_AS(index.ordinal_lookup(offsets.size()), std::out_of_range);
+    }
+
+    SECTION("index w/o enumeration") {
+        test::write_index_file(path, 0, {0, 10});
+        auto data = [&]() {
+            std::ifstream file{path, std::ios::binary};
+            return std::string{std::istreambuf_iterator<char>{file}, {}};
+        }();
+        // The feature flags follow the header, the records, the hash function parameters and the single start seed
+        data[17 + 2 * 4 + 16 + 1 + 8] = 0;
+        std::ofstream{path, std::ios::binary | std::ios::trunc} << data;
+        CHECK_THROWS_AS(Index{path}, std::runtime_error);
+    }
+
+    SECTION("truncated file") {
+        test::SegmentWriter::write_file(path, silkworm::Bytes(16, 0));
+        CHECK_THROWS_AS(Index{path}, std::runtime_error);
+    }
+
+    std::filesystem::remove(path);
+}
+
+} // namespace silkrpc::ethdb::snapshot
@@ -0,0 +1,63 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "memory_mapped_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace silkrpc::ethdb::snapshot {
+
+MemoryMappedFile::MemoryMappedFile(const std::filesystem::path& path) : path_{path} {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        throw std::runtime_error{"cannot open " + path.string() + ": " + std::strerror(errno)};
+    }
+    struct stat file_status{};
+    if (::fstat(fd, &file_status) == -1) {
+        const int error = errno;
+        ::close(fd);
+        throw std::runtime_error{"cannot stat " + path.string() + ": " + std::strerror(error)};
+    }
+    size_ = static_cast<std::size_t>(file_status.st_size);
+    if (size_ > 0) {
+        void* address = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (address == MAP_FAILED) {
+            const int error = errno;
+            ::close(fd);
+            throw std::runtime_error{"cannot mmap " + path.string() + ": " + std::strerror(error)};
+        }
+        // The words are looked up by offset, so the read-ahead of the sequential access would be just wasted
+        ::madvise(address, size_, MADV_RANDOM);
+        address_ = static_cast<const uint8_t*>(address);
+    }
+    ::close(fd);
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+    if (address_ != nullptr) {
+        ::munmap(const_cast<uint8_t*>(address_), size_);
+    }
+}
+
+} // namespace silkrpc::ethdb::snapshot
@@ -0,0 +1,53 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_ETHDB_SNAPSHOT_MEMORY_MAPPED_FILE_HPP_
+#define SILKRPC_ETHDB_SNAPSHOT_MEMORY_MAPPED_FILE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+#include <silkworm/common/base.hpp>
+
+namespace silkrpc::ethdb::snapshot {
+
+//! Read-only memory mapping of a whole immutable file, unmapped on destruction. The pages are read on demand by the OS,
+//! so that just the parts of the file actually accessed are ever loaded and they are shared by all the readers
+class MemoryMappedFile {
+public:
+    //! Map the file at the specified path, throwing std::runtime_error if it cannot be opened or mapped
+    explicit MemoryMappedFile(const std::filesystem::path& path);
+    ~MemoryMappedFile();
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    const std::filesystem::path& path() const noexcept { return path_; }
+
+    std::size_t size() const noexcept { return size_; }
+
+    silkworm::ByteView view() const noexcept { return {address_, size_}; }
+
+private:
+    std::filesystem::path path_;
+    const uint8_t* address_{nullptr};
+    std::size_t size_{0};
+};
+
+} // namespace silkrpc::ethdb::snapshot
+
+#endif // SILKRPC_ETHDB_SNAPSHOT_MEMORY_MAPPED_FILE_HPP_
@@ -0,0 +1,305 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "repository.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+
+#include <silkworm/db/util.hpp>
+#include <silkworm/rlp/decode.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/common/util.hpp>
+
+namespace silkrpc::ethdb::snapshot {
+
+namespace {
+
+//! The number of blocks of the unit used in the segment file names
+constexpr uint64_t kFileNameBlockUnit{1'000};
+
+//! The system transactions stored by Erigon at the beginning and at the end of each block
+constexpr uint64_t kSystemTxnCount{2};
+
+//! The segment types making one complete segment range
+constexpr const char* kSegmentTypes[]{SnapshotRepository::kHeaders, SnapshotRepository::kBodies, SnapshotRepository::kTransactions};
+
+//! The word of each transaction is prefixed by the first byte of its hash and by its sender
+constexpr std::size_t kTxnWordPrefixSize{1 + silkworm::kAddressLength};
+
+evmc::bytes32 hash_of_header(silkworm::ByteView header_rlp) {
+    const auto hash{hash_of(header_rlp)};
+    return silkworm::to_bytes32(full_view(hash));
+}
+
+} // namespace
+
+std::string SegmentRange::file_name(const std::string& type, const std::string& extension) const {
+    std::ostringstream name;
+    name << "v1-" << std::setfill('0') << std::setw(6) << from_block / kFileNameBlockUnit << "-" << std::setw(6)
+         << to_block / kFileNameBlockUnit << "-" << type << extension;
+    return name.str();
+}
+
+std::optional<std::pair<SegmentRange, std::string>> SegmentRange::parse(const std::string& file_name) {
+    static const std::regex kSegmentFileName{R"(^v1-(\d{6})-(\d{6})-([a-z\-]+)\.seg$)"};
+    std::smatch match;
+    if (!std::regex_match(file_name, match, kSegmentFileName)) {
+        return std::nullopt;
+    }
+    const SegmentRange range{std::stoull(match[1]) * kFileNameBlockUnit, std::stoull(match[2]) * kFileNameBlockUnit};
+    if (range.from_block >= range.to_block) {
+        return std::nullopt;
+    }
+    return std::make_pair(range, match[3].str());
+}
+
+SnapshotRepository::SnapshotRepository(const std::filesystem::path& dir) {
+    // Collect the segment types found for each range, in order of range start and then of decreasing range end
+    auto by_range = [](const SegmentRange& lhs, const SegmentRange& rhs) {
+        return lhs.from_block < rhs.from_block || (lhs.from_block == rhs.from_block && lhs.to_block > rhs.to_block);
+    };
+    std::map<SegmentRange, std::vector<std::string>, decltype(by_range)> ranges{by_range};
+    for (const auto& entry : std::filesystem::directory_iterator{dir}) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+        const auto range_and_type = SegmentRange::parse(entry.path().filename().string());
+        if (range_and_type) {
+            ranges[range_and_type->first].push_back(range_and_type->second);
+        }
+    }
+
+    // Open the largest complete range starting at each frozen block, skipping those being merged or not indexed yet
+    for (const auto& range_and_types : ranges) {
+        const auto& range = range_and_types.first;
+        const auto& types = range_and_types.second;
+        if (range.from_block != frozen_blocks_) {
+            continue;
+        }
+        const bool complete = std::all_of(std::begin(kSegmentTypes), std::end(kSegmentTypes), [&](const char* type) {
+            return std::find(types.begin(), types.end(), type) != types.end() && std::filesystem::exists(dir / range.file_name(type, ".idx"));
+        });
+        if (!complete) {
+            SILKRPC_WARN << "SnapshotRepository: incomplete segment range " << range.from_block << "-" << range.to_block << " skipped\n";
+            continue;
+        }
+        Segment segment{range};
+        segment.headers = std::make_unique<Decompressor>(dir / range.file_name(kHeaders, ".seg"));
+        segment.headers_index = std::make_unique<Index>(dir / range.file_name(kHeaders, ".idx"));
+        segment.bodies = std::make_unique<Decompressor>(dir / range.file_name(kBodies, ".seg"));
+        segment.bodies_index = std::make_unique<Index>(dir / range.file_name(kBodies, ".idx"));
+        segment.transactions = std::make_unique<Decompressor>(dir / range.file_name(kTransactions, ".seg"));
+        segment.transactions_index = std::make_unique<Index>(dir / range.file_name(kTransactions, ".idx"));
+        if (segment.headers_index->base_data_id() != range.from_block || segment.bodies_index->base_data_id() != range.from_block ||
+            segment.transactions_index->base_data_id() != frozen_transactions_) {
+            throw std::runtime_error{"inconsistent index files for segment range " + range.file_name(kHeaders, "")};
+        }
+        frozen_blocks_ = range.to_block;
+        frozen_transactions_ = segment.transactions_index->base_data_id() + segment.transactions_index->key_count();
+        segments_.push_back(std::move(segment));
+    }
+    SILKRPC_INFO << "SnapshotRepository: " << segments_.size() << " segment ranges opened in " << dir.string()
+                 << " frozen blocks: " << frozen_blocks_ << " frozen transactions: " << frozen_transactions_ << "\n";
+}
+
+const SnapshotRepository::Segment* SnapshotRepository::find_segment(uint64_t block_number) const {
+    if (block_number >= frozen_blocks_) {
+        return nullptr;
+    }
+    const auto it = std::upper_bound(segments_.begin(), segments_.end(), block_number,
+        [](uint64_t number, const Segment& segment) { return number < segment.range.from_block; });
+    return &*std::prev(it);
+}
+
+const SnapshotRepository::Segment* SnapshotRepository::find_transaction_segment(uint64_t txn_id) const {
+    if (txn_id >= frozen_transactions_) {
+        return nullptr;
+    }
+    const auto it = std::upper_bound(segments_.begin(), segments_.end(), txn_id,
+        [](uint64_t id, const Segment& segment) { return id < segment.transactions_index->base_data_id(); });
+    return &*std::prev(it);
+}
+
+bool SnapshotRepository::read_header_word(uint64_t block_number, const evmc::bytes32* block_hash, silkworm::Bytes& word) const {
+    const auto* segment = find_segment(block_number);
+    if (segment == nullptr) {
+        return false;
+    }
+    const auto offset = segment->headers_index->ordinal_lookup(block_number - segment->range.from_block);
+    segment->headers->decode_word(offset, word);
+    if (word.size() < 2) {
+        throw std::runtime_error{"invalid header word for block " + std::to_string(block_number) + " in " + segment->headers->path().string()};
+    }
+    // The first byte of the hash tells most of the non-canonical blocks apart without hashing the header
+    if (block_hash != nullptr && (word[0] != block_hash->bytes[0] || hash_of_header(silkworm::ByteView{word}.substr(1)) != *block_hash)) {
+        return false;
+    }
+    return true;
+}
+
+bool SnapshotRepository::read_body_word(uint64_t block_number, const evmc::bytes32& block_hash, silkworm::Bytes& word) const {
+    silkworm::Bytes header_word;
+    if (!read_header_word(block_number, &block_hash, header_word)) {
+        return false;
+    }
+    const auto* segment = find_segment(block_number);
+    const auto offset = segment->bodies_index->ordinal_lookup(block_number - segment->range.from_block);
+    segment->bodies->decode_word(offset, word);
+    return true;
+}
+
+std::optional<evmc::bytes32> SnapshotRepository::read_canonical_hash(uint64_t block_number) const {
+    silkworm::Bytes word;
+    if (!read_header_word(block_number, nullptr, word)) {
+        return std::nullopt;
+    }
+    return hash_of_header(silkworm::ByteView{word}.substr(1));
+}
+
+std::optional<silkworm::Bytes> SnapshotRepository::read_header_rlp(uint64_t block_number, const evmc::bytes32& block_hash) const {
+    silkworm::Bytes word;
+    if (!read_header_word(block_number, &block_hash, word)) {
+        return std::nullopt;
+    }
+    return word.substr(1);
+}
+
+std::optional<silkworm::BlockHeader> SnapshotRepository::read_header(uint64_t block_number, const evmc::bytes32& block_hash) const {
+    silkworm::Bytes word;
+    if (!read_header_word(block_number, &block_hash, word)) {
+        return std::nullopt;
+    }
+    silkworm::ByteView header_rlp{silkworm::ByteView{word}.substr(1)};
+    silkworm::BlockHeader header;
+    if (silkworm::rlp::decode(header_rlp, header) != silkworm::DecodingResult::kOk) {
+        throw std::runtime_error{"invalid RLP decoding for frozen block header " + std::to_string(block_number)};
+    }
+    return header;
+}
+
+std::optional<silkworm::Bytes> SnapshotRepository::read_body_rlp(uint64_t block_number, const evmc::bytes32& block_hash) const {
+    silkworm::Bytes word;
+    if (!read_body_word(block_number, block_hash, word)) {
+        return std::nullopt;
+    }
+    return word;
+}
+
+bool SnapshotRepository::read_transaction_range(uint64_t block_number, const evmc::bytes32& block_hash, uint64_t& base_txn_id,
+                                                uint64_t& txn_count) const {
+    silkworm::Bytes word;
+    if (!read_body_word(block_number, block_hash, word)) {
+        return false;
+    }
+    silkworm::ByteView body_rlp{word};
+    const auto stored_body{silkworm::db::detail::decode_stored_block_body(body_rlp)};
+    if (stored_body.txn_count < kSystemTxnCount) {
+        throw std::runtime_error{"invalid transaction count for frozen block body " + std::to_string(block_number)};
+    }
+    base_txn_id = stored_body.base_txn_id + 1;
+    txn_count = stored_body.txn_count - kSystemTxnCount;
+    return true;
+}
+
+void SnapshotRepository::for_each_transaction(const Segment& segment, uint64_t base_txn_id, uint64_t txn_count,
+                                              const TransactionVisitor& visit) const {
+    if (txn_count == 0) {
+        return;
+    }
+    const auto& index = *segment.transactions_index;
+    if (base_txn_id < index.base_data_id() || base_txn_id + txn_count > index.base_data_id() + index.key_count()) {
+        throw std::runtime_error{"transactions " + std::to_string(base_txn_id) + "+" + std::to_string(txn_count) + " beyond " +
+            segment.transactions->path().string()};
+    }
+    // The words of consecutive transactions are adjacent, so just the first one is looked up
+    auto offset = index.ordinal_lookup(base_txn_id - index.base_data_id());
+    silkworm::Bytes word;
+    for (uint64_t i{0}; i < txn_count; ++i) {
+        offset = segment.transactions->decode_word(offset, word);
+        if (word.size() <= kTxnWordPrefixSize) {
+            throw std::runtime_error{"invalid transaction word for id " + std::to_string(base_txn_id + i)};
+        }
+        const silkworm::ByteView word_view{word};
+        visit(word_view.substr(1, silkworm::kAddressLength), word_view.substr(kTxnWordPrefixSize));
+    }
+}
+
+std::optional<silkworm::BlockBody> SnapshotRepository::read_body(uint64_t block_number, const evmc::bytes32& block_hash) const {
+    silkworm::Bytes word;
+    if (!read_body_word(block_number, block_hash, word)) {
+        return std::nullopt;
+    }
+    silkworm::ByteView body_rlp{word};
+    auto stored_body{silkworm::db::detail::decode_stored_block_body(body_rlp)};
+    if (stored_body.txn_count < kSystemTxnCount) {
+        throw std::runtime_error{"invalid transaction count for frozen block body " + std::to_string(block_number)};
+    }
+    auto transactions = read_transactions(stored_body.base_txn_id + 1, stored_body.txn_count - kSystemTxnCount);
+    if (!transactions) {
+        throw std::runtime_error{"missing transactions for frozen block body " + std::to_string(block_number)};
+    }
+    return silkworm::BlockBody{std::move(*transactions), std::move(stored_body.ommers)};
+}
+
+std::optional<std::vector<evmc::address>> SnapshotRepository::read_senders(uint64_t block_number, const evmc::bytes32& block_hash) const {
+    uint64_t base_txn_id{0};
+    uint64_t txn_count{0};
+    if (!read_transaction_range(block_number, block_hash, base_txn_id, txn_count)) {
+        return std::nullopt;
+    }
+    std::vector<evmc::address> senders;
+    senders.reserve(txn_count);
+    if (txn_count > 0) {
+        const auto* segment = find_transaction_segment(base_txn_id);
+        if (segment == nullptr) {
+            throw std::runtime_error{"missing transactions for frozen block body " + std::to_string(block_number)};
+        }
+        for_each_transaction(*segment, base_txn_id, txn_count, [&](silkworm::ByteView sender, silkworm::ByteView) {
+            senders.push_back(silkworm::to_evmc_address(sender));
+        });
+    }
+    return senders;
+}
+
+std::optional<std::vector<silkworm::Transaction>> SnapshotRepository::read_transactions(uint64_t base_txn_id, uint64_t txn_count) const {
+    std::vector<silkworm::Transaction> transactions;
+    if (txn_count == 0) {
+        return transactions;
+    }
+    // The transactions of one block are never split across segments, so any range spanning two of them is invalid
+    const auto* segment = find_transaction_segment(base_txn_id);
+    if (segment == nullptr || base_txn_id + txn_count > frozen_transactions_) {
+        return std::nullopt;
+    }
+    transactions.reserve(txn_count);
+    for_each_transaction(*segment, base_txn_id, txn_count, [&](silkworm::ByteView sender, silkworm::ByteView rlp) {
+        silkworm::Transaction transaction;
+        if (silkworm::rlp::decode(rlp, transaction) != silkworm::DecodingResult::kOk) {
+            throw std::runtime_error{"invalid RLP decoding for frozen transaction " + std::to_string(base_txn_id + transactions.size())};
+        }
+        transaction.from = silkworm::to_evmc_address(sender);
+        transactions.push_back(std::move(transaction));
+    });
+    return transactions;
+}
+
+} // namespace silkrpc::ethdb::snapshot
@@ -0,0 +1,134 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_ETHDB_SNAPSHOT_REPOSITORY_HPP_
+#define SILKRPC_ETHDB_SNAPSHOT_REPOSITORY_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <evmc/evmc.hpp>
+#include <silkworm/common/base.hpp>
+#include <silkworm/types/block.hpp>
+#include <silkworm/types/transaction.hpp>
+
+#include <silkrpc/ethdb/snapshot/decompressor.hpp>
+#include <silkrpc/ethdb/snapshot/index.hpp>
+
+namespace silkrpc::ethdb::snapshot {
+
+//! The block range of one set of segment files, as named by Erigon in thousands of blocks, e.g. v1-000000-000500-headers.seg
+struct SegmentRange {
+    uint64_t from_block{0};
+    uint64_t to_block{0};
+
+    //! Return the file name of the segment or index (by extension) of the specified type covering the range
+    std::string file_name(const std::string& type, const std::string& extension) const;
+
+    //! Parse the range and type of the segment file name, if it is the name of a segment file
+    static std::optional<std::pair<SegmentRange, std::string>> parse(const std::string& file_name);
+};
+
+//! Read-only repository of the frozen blocks held in the Erigon snapshot segment files (headers, bodies and transactions)
+//! of one directory, memory-mapped so that the historical blocks are read locally w/o any database round trip. Only the
+//! ranges having all the segment files with their indexes are opened and just those contiguous from the genesis make the
+//! frozen blocks: the blocks beyond are read from the database. The repository is immutable once opened, so it can be
+//! shared by any thread. The reads return nothing if the block is not frozen (or if its hash does not match the canonical
+//! one, because frozen blocks are canonical by construction) and throw std::runtime_error if the files are corrupted.
+class SnapshotRepository {
+public:
+    //! The types of the segment files read
+    static constexpr const char* kHeaders{"headers"};
+    static constexpr const char* kBodies{"bodies"};
+    static constexpr const char* kTransactions{"transactions"};
+
+    //! Open the segment files in the directory, throwing std::runtime_error if any of them is invalid
+    explicit SnapshotRepository(const std::filesystem::path& dir);
+
+    SnapshotRepository(const SnapshotRepository&) = delete;
+    SnapshotRepository& operator=(const SnapshotRepository&) = delete;
+
+    //! The number of frozen blocks, i.e. the lowest block number not held in the segments
+    uint64_t frozen_blocks() const noexcept { return frozen_blocks_; }
+
+    //! The number of frozen transactions (system ones included), i.e. the lowest transaction id not held in the segments
+    uint64_t frozen_transactions() const noexcept { return frozen_transactions_; }
+
+    std::size_t segment_count() const noexcept { return segments_.size(); }
+
+    bool is_frozen(uint64_t block_number) const noexcept { return block_number < frozen_blocks_; }
+
+    //! Return the hash of the frozen block
+    std::optional<evmc::bytes32> read_canonical_hash(uint64_t block_number) const;
+
+    std::optional<silkworm::Bytes> read_header_rlp(uint64_t block_number, const evmc::bytes32& block_hash) const;
+
+    std::optional<silkworm::BlockHeader> read_header(uint64_t block_number, const evmc::bytes32& block_hash) const;
+
+    //! Return the RLP of the stored body, i.e. the base transaction id, the transaction count and the ommers
+    std::optional<silkworm::Bytes> read_body_rlp(uint64_t block_number, const evmc::bytes32& block_hash) const;
+
+    //! Return the body with its transactions, the senders included
+    std::optional<silkworm::BlockBody> read_body(uint64_t block_number, const evmc::bytes32& block_hash) const;
+
+    std::optional<std::vector<evmc::address>> read_senders(uint64_t block_number, const evmc::bytes32& block_hash) const;
+
+    //! Return the transactions having consecutive ids, the senders included, if all of them are frozen
+    std::optional<std::vector<silkworm::Transaction>> read_transactions(uint64_t base_txn_id, uint64_t txn_count) const;
+
+private:
+    struct Segment {
+        SegmentRange range;
+        std::unique_ptr<Decompressor> headers;
+        std::unique_ptr<Index> headers_index;
+        std::unique_ptr<Decompressor> bodies;
+        std::unique_ptr<Index> bodies_index;
+        std::unique_ptr<Decompressor> transactions;
+        std::unique_ptr<Index> transactions_index;
+    };
+
+    const Segment* find_segment(uint64_t block_number) const;
+
+    const Segment* find_transaction_segment(uint64_t txn_id) const;
+
+    //! Read the header word of the frozen block, i.e. the first byte of its hash followed by its RLP, matching the hash if any
+    bool read_header_word(uint64_t block_number, const evmc::bytes32* block_hash, silkworm::Bytes& word) const;
+
+    bool read_body_word(uint64_t block_number, const evmc::bytes32& block_hash, silkworm::Bytes& word) const;
+
+    using TransactionVisitor = std::function<void(silkworm::ByteView sender, silkworm::ByteView rlp)>;
+
+    //! Visit the transactions having consecutive ids, whose words are the first byte of the hash, the sender and the RLP
+    void for_each_transaction(const Segment& segment, uint64_t base_txn_id, uint64_t txn_count, const TransactionVisitor& visit) const;
+
+    //! Read the transaction range of the stored body of the frozen block, system transactions excluded
+    bool read_transaction_range(uint64_t block_number, const evmc::bytes32& block_hash, uint64_t& base_txn_id, uint64_t& txn_count) const;
+
+    std::vector<Segment> segments_;
+    uint64_t frozen_blocks_{0};
+    uint64_t frozen_transactions_{0};
+};
+
+} // namespace silkrpc::ethdb::snapshot
+
+#endif // SILKRPC_ETHDB_SNAPSHOT_REPOSITORY_HPP_
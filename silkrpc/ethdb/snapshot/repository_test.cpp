@@ -0,0 +1,167 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "repository.hpp"
+
+#include <filesystem>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/common/util.hpp>
+#include <silkrpc/test/snapshot_files.hpp>
+
+namespace silkrpc::ethdb::snapshot {
+
+using evmc::literals::operator""_address, evmc::literals::operator""_bytes32;
+
+// Header of block https://goerli.etherscan.io/block/3529604
+static const silkworm::Bytes kHeaderRlp{*silkworm::from_hex(
+    "f9025ca08059c265f40cdb2d3b3245847c21ed154eebf299fd0ff01ee3afded43cdadc45a01dcc4de8dec75d7aab85b567b6ccd41ad312"
+    "451b948a7413f0a142fd40d49347940000000000000000000000000000000000000000a08add6cb86a4b4a4e5758ce21c8d156e4355917"
+    "d29eae7c19f56d4a38f384401da095e5f810e7a45d476d7416fbffbc931473cfdba2b90204e019067bcc6d136dc3a08c3d469c1fbce4e4"
+    "144d5e5f91a81baca60b1fb6b5bdcf691b9dc40a5bf21b35b9010004000000000000000000000000040010001000402000000000000000"
+    "00000008000020001000000001000000000080000000000010000000000800000000000000000000000000000000000000000000000000"
+    "10100000000000000000000008000008000000000000000000000000002000000000000000000000000000040000000000000010000000"
+    "00000000000000000000000000000000000000400000000000000000000000020180440020000000080000000000000000000000000000"
+    "00000000000000000000000000000000020000000000000000000000000000000000000000000000180000002000004010000880800000"
+    "0200400000000000018335db84837a12008308b89a845f7cd33db861476f65726c6920496e697469617469766520417574686f72697479"
+    "00000000001f3070be3668d4e3bdd1d08969becd5b06ab0ae4224873453d827a67b3a089ee03c69941418ac300e2c3ca9b5597c7a37959"
+    "32a7ff2f907db605a93a88c5b4a800a0000000000000000000000000000000000000000000000000000000000000000088000000000000"
+    "0000")};
+
+// Legacy transaction included in the same block
+static const silkworm::Bytes kTransactionRlp{*silkworm::from_hex(
+    "f87080843b9aca00830c350094fa365f1384e4eaf6d59f353c782af3ea42feaab988015c2a7b13fd000084d0e30db02ea06b0df7c31119"
+    "b257e7faeb391984f199c8da817b14279ac09262bdf3493599a6a00c729ce28ec0030002490d6217a8b50041495925142e70fa1b77e465"
+    "eab97c4b")};
+
+static const auto kSender{0x70a5c9d346416f901826581d423cd5b92d44ff5a_address};
+
+// Block 0 holds one transaction (id 1) between the system ones, block 1 just the system ones (ids 3 and 4)
+static const silkworm::Bytes kBody0Rlp{*silkworm::from_hex("c48003c0")};
+static const silkworm::Bytes kBody1Rlp{*silkworm::from_hex("c40302c0")};
+
+static evmc::bytes32 header_hash() {
+    return silkworm::to_bytes32(full_view(hash_of(kHeaderRlp)));
+}
+
+static void write_segment(const std::filesystem::path& path, const std::vector<silkworm::Bytes>& words, uint64_t base_data_id) {
+    test::SegmentWriter writer;
+    for (const auto& word : words) {
+        writer.add_word(word);
+    }
+    const auto offsets = writer.write(path);
+    test::write_index_file(std::filesystem::path{path}.replace_extension(".idx"), base_data_id, offsets);
+}
+
+TEST_CASE("SegmentRange", "[silkrpc][ethdb][snapshot][repository]") {
+    SECTION("file_name") {
+        const SegmentRange range{500'000, 1'000'000};
+        CHECK(range.file_name("headers", ".seg") == "v1-000500-001000-headers.seg");
+        CHECK(range.file_name("transactions", ".idx") == "v1-000500-001000-transactions.idx");
+    }
+
+    SECTION("parse") {
+        const auto range_and_type = SegmentRange::parse("v1-000500-001000-bodies.seg");
+        REQUIRE(range_and_type);
+        CHECK(range_and_type->first.from_block == 500'000);
+        CHECK(range_and_type->first.to_block == 1'000'000);
+        CHECK(range_and_type->second == "bodies");
+        CHECK(!SegmentRange::parse("v1-000500-001000-bodies.idx"));
+        CHECK(!SegmentRange::parse("v1-001000-000500-bodies.seg"));
+        CHECK(!SegmentRange::parse("v1-000500-001000-bodies.seg.torrent"));
+        CHECK(!SegmentRange::parse("000500-001000-bodies.seg"));
+    }
+}
+
+TEST_CASE("SnapshotRepository", "[silkrpc][ethdb][snapshot][repository]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    const auto dir = std::filesystem::temp_directory_path() / "silkrpc_snapshot_repository_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    const SegmentRange range{0, 1'000};
+    const auto hash = header_hash();
+    silkworm::Bytes header_word{hash.bytes[0]};
+    header_word += kHeaderRlp;
+    silkworm::Bytes transaction_word{hash.bytes[0]};
+    transaction_word += full_view(kSender);
+    transaction_word += kTransactionRlp;
+    write_segment(dir / range.file_name(SnapshotRepository::kHeaders, ".seg"), {header_word, header_word}, 0);
+    write_segment(dir / range.file_name(SnapshotRepository::kBodies, ".seg"), {kBody0Rlp, kBody1Rlp}, 0);
+    write_segment(dir / range.file_name(SnapshotRepository::kTransactions, ".seg"), {{}, transaction_word, {}, {}, {}}, 0);
+
+    // The next range is not indexed yet, so it is not frozen
+    const SegmentRange next_range{1'000, 2'000};
+    test::SegmentWriter{}.write(dir / next_range.file_name(SnapshotRepository::kHeaders, ".seg"));
+
+    SnapshotRepository repository{dir};
+    CHECK(repository.segment_count() == 1);
+    CHECK(repository.frozen_blocks() == 1'000);
+    CHECK(repository.frozen_transactions() == 5);
+    CHECK(repository.is_frozen(999));
+    CHECK(!repository.is_frozen(1'000));
+
+    SECTION("read_canonical_hash") {
+        CHECK(repository.read_canonical_hash(0) == hash);
+        CHECK(!repository.read_canonical_hash(1'000));
+    }
+
+    SECTION("read_header") {
+        const auto header = repository.read_header(0, hash);
+        REQUIRE(header);
+        CHECK(header->number == 3'529'604);
+        CHECK(repository.read_header_rlp(1, hash) == kHeaderRlp);
+        CHECK(!repository.read_header(0, 0x0000000000000000000000000000000000000000000000000000000000000001_bytes32));
+        CHECK(!repository.read_header(1'000, hash));
+    }
+
+    SECTION("read_body") {
+        const auto body = repository.read_body(0, hash);
+        REQUIRE(body);
+        REQUIRE(body->transactions.size() == 1);
+        CHECK(body->transactions[0].from == kSender);
+        CHECK(body->transactions[0].nonce == 0);
+        CHECK(body->ommers.empty());
+        CHECK(repository.read_body_rlp(1, hash) == kBody1Rlp);
+        const auto empty_body = repository.read_body(1, hash);
+        REQUIRE(empty_body);
+        CHECK(empty_body->transactions.empty());
+        CHECK(!repository.read_body(1'000, hash));
+    }
+
+    SECTION("read_senders") {
+        CHECK(repository.read_senders(0, hash) == std::vector<evmc::address>{kSender});
+        CHECK(repository.read_senders(1, hash) == std::vector<evmc::address>{});
+    }
+
+    SECTION("read_transactions") {
+        const auto transactions = repository.read_transactions(1, 1);
+        REQUIRE(transactions);
+        REQUIRE(transactions->size() == 1);
+        CHECK((*transactions)[0].from == kSender);
+        CHECK(repository.read_transactions(5, 0));
+        CHECK(!repository.read_transactions(5, 1));
+        CHECK(!repository.read_transactions(4, 2));
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+} // namespace silkrpc::ethdb::snapshot
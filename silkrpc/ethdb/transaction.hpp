@@ -25,8 +25,11 @@
 #include <boost/asio/awaitable.hpp>
 
 #include <silkworm/common/util.hpp>
+#include <silkrpc/common/chain_head_cache.hpp>
 #include <silkrpc/common/util.hpp>
 #include <silkrpc/ethdb/cursor.hpp>
+#include <silkrpc/ethdb/read_combiner.hpp>
+#include <silkrpc/ethdb/snapshot/repository.hpp>
 
 namespace silkrpc::ethdb {
 
@@ -47,7 +50,35 @@ public:
 
     virtual boost::asio::awaitable<std::shared_ptr<CursorDupSort>> cursor_dup_sort(const std::string& table) = 0;
 
+    //! Open a new cursor on the table not shared with the other users of the transaction, e.g. the concurrent requests of
+    //! one batch: by default the cursor shared by all, which is fine as long as the transaction has a single user
+    virtual boost::asio::awaitable<std::shared_ptr<Cursor>> new_cursor(const std::string& table) {
+        co_return co_await cursor(table);
+    }
+
+    //! Open a new dup-sorted cursor on the table not shared with the other users of the transaction (see new_cursor)
+    virtual boost::asio::awaitable<std::shared_ptr<CursorDupSort>> new_cursor_dup_sort(const std::string& table) {
+        co_return co_await cursor_dup_sort(table);
+    }
+
     virtual boost::asio::awaitable<void> close() = 0;
+
+    //! The cache of the chain head block numbers shared by the transactions of the same database, if any
+    ChainHeadCache* chain_head_cache() const noexcept { return chain_head_cache_; }
+    void set_chain_head_cache(ChainHeadCache* chain_head_cache) noexcept { chain_head_cache_ = chain_head_cache; }
+
+    //! The repository of the frozen blocks shared by the transactions of the same database, if any
+    const snapshot::SnapshotRepository* snapshots() const noexcept { return snapshots_; }
+    void set_snapshots(const snapshot::SnapshotRepository* snapshots) noexcept { snapshots_ = snapshots; }
+
+    //! The combiner of the identical point reads shared by the transactions of the same database, if any
+    ReadCombiner* read_combiner() const noexcept { return read_combiner_; }
+    void set_read_combiner(ReadCombiner* read_combiner) noexcept { read_combiner_ = read_combiner; }
+
+private:
+    ChainHeadCache* chain_head_cache_{nullptr};
+    const snapshot::SnapshotRepository* snapshots_{nullptr};
+    ReadCombiner* read_combiner_{nullptr};
 };
 
 } // namespace silkrpc::ethdb
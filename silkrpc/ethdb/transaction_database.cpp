@@ -18,6 +18,7 @@
 
 #include <climits>
 #include <exception>
+#include <utility>
 
 #include <silkrpc/common/log.hpp>
 #include <silkrpc/common/util.hpp>
@@ -25,17 +26,61 @@
 namespace silkrpc::ethdb {
 
 boost::asio::awaitable<KeyValue> TransactionDatabase::get(const std::string& table, const silkworm::ByteView& key) const {
-    const auto cursor = co_await tx_.cursor(table);
-    SILKRPC_TRACE << "TransactionDatabase::get cursor_id: " << cursor->cursor_id() << "\n";
-    const auto kv_pair = co_await cursor->seek(key);
-    co_return kv_pair;
+    auto read = [&]() -> boost::asio::awaitable<KeyValue> {
+        const auto cursor = co_await tx_.cursor(table);
+        SILKRPC_TRACE << "TransactionDatabase::get cursor_id: " << cursor->cursor_id() << "\n";
+        co_return co_await cursor->seek(key);
+    };
+    auto* read_combiner = tx_.read_combiner();
+    if (read_combiner == nullptr) {
+        co_return co_await read();
+    }
+    co_return co_await read_combiner->execute(tx_.tx_id(), ReadCombiner::Kind::seek, table, key, read);
 }
 
 boost::asio::awaitable<silkworm::Bytes> TransactionDatabase::get_one(const std::string& table, const silkworm::ByteView& key) const {
+    auto read = [&]() -> boost::asio::awaitable<KeyValue> {
+        const auto cursor = co_await tx_.cursor(table);
+        SILKRPC_TRACE << "TransactionDatabase::get_one cursor_id: " << cursor->cursor_id() << "\n";
+        co_return co_await cursor->seek_exact(key);
+    };
+    auto* read_combiner = tx_.read_combiner();
+    if (read_combiner == nullptr) {
+        co_return (co_await read()).value;
+    }
+    co_return (co_await read_combiner->execute(tx_.tx_id(), ReadCombiner::Kind::seek_exact, table, key, read)).value;
+}
+
+boost::asio::awaitable<SharedByteView> TransactionDatabase::get_one_shared(const std::string& table, const silkworm::ByteView& key) const {
+    const auto cursor = co_await tx_.cursor(table);
+    SILKRPC_TRACE << "TransactionDatabase::get_one_shared cursor_id: " << cursor->cursor_id() << "\n";
+    co_return co_await cursor->seek_exact_shared(key);
+}
+
+boost::asio::awaitable<std::vector<silkworm::Bytes>> TransactionDatabase::get_many(const std::string& table,
+                                                                                 const std::vector<silkworm::Bytes>& keys) const {
+    std::vector<silkworm::Bytes> values;
+    if (keys.empty()) {
+        co_return values;
+    }
+    const auto cursor = co_await tx_.cursor(table);
+    SILKRPC_TRACE << "TransactionDatabase::get_many cursor_id: " << cursor->cursor_id() << " keys: " << keys.size() << "\n";
+    auto kv_pairs = co_await cursor->seek_exact_many(keys);
+    values.reserve(kv_pairs.size());
+    for (auto& kv_pair : kv_pairs) {
+        values.push_back(std::move(kv_pair.value));
+    }
+    co_return values;
+}
+
+boost::asio::awaitable<std::vector<KeyValue>> TransactionDatabase::seek_many(const std::string& table,
+                                                                          const std::vector<silkworm::Bytes>& keys) const {
+    if (keys.empty()) {
+        co_return std::vector<KeyValue>{};
+    }
     const auto cursor = co_await tx_.cursor(table);
-    SILKRPC_TRACE << "TransactionDatabase::get_one cursor_id: " << cursor->cursor_id() << "\n";
-    const auto kv_pair = co_await cursor->seek_exact(key);
-    co_return kv_pair.value;
+    SILKRPC_TRACE << "TransactionDatabase::seek_many cursor_id: " << cursor->cursor_id() << " keys: " << keys.size() << "\n";
+    co_return co_await cursor->seek_many(keys);
 }
 
 boost::asio::awaitable<std::optional<silkworm::Bytes>> TransactionDatabase::get_both_range(const std::string& table, const silkworm::ByteView& key, const silkworm::ByteView& subkey) const {
@@ -50,6 +95,28 @@ boost::asio::awaitable<std::optional<silkworm::Bytes>> TransactionDatabase::get_
     co_return value.substr(subkey.length());
 }
 
+boost::asio::awaitable<std::vector<std::optional<silkworm::Bytes>>> TransactionDatabase::get_both_range_many(const std::string& table,
+    const std::vector<silkworm::Bytes>& keys, const std::vector<silkworm::Bytes>& subkeys) const {
+    std::vector<std::optional<silkworm::Bytes>> values;
+    if (keys.empty()) {
+        co_return values;
+    }
+    const auto cursor = co_await tx_.cursor_dup_sort(table);
+    SILKRPC_TRACE << "TransactionDatabase::get_both_range_many cursor_id: " << cursor->cursor_id() << " keys: " << keys.size() << "\n";
+    const auto found_values{co_await cursor->seek_both_many(keys, subkeys)};
+    values.reserve(found_values.size());
+    for (std::size_t i{0}; i < found_values.size(); ++i) {
+        const auto& value = found_values[i];
+        const auto& subkey = subkeys[i];
+        if (value.substr(0, subkey.size()) != subkey) {
+            values.emplace_back(std::nullopt);
+        } else {
+            values.emplace_back(value.substr(subkey.length()));
+        }
+    }
+    co_return values;
+}
+
 boost::asio::awaitable<void> TransactionDatabase::walk(const std::string& table, const silkworm::ByteView& start_key, uint32_t fixed_bits, core::rawdb::Walker w) const {
     const auto fixed_bytes = (fixed_bits + 7) / CHAR_BIT;
     SILKRPC_TRACE << "TransactionDatabase::walk fixed_bits: " << fixed_bits << " fixed_bytes: " << fixed_bytes << "\n";
@@ -63,8 +130,8 @@ boost::asio::awaitable<void> TransactionDatabase::walk(const std::string& table,
     const auto cursor = co_await tx_.cursor(table);
     SILKRPC_TRACE << "TransactionDatabase::walk cursor_id: " << cursor->cursor_id() << "\n";
     auto kv_pair = co_await cursor->seek(start_key);
-    auto k = kv_pair.key;
-    auto v = kv_pair.value;
+    auto k = std::move(kv_pair.key);
+    auto v = std::move(kv_pair.value);
     SILKRPC_TRACE << "k: " << k << " v: " << v << "\n";
     while (
         !k.empty() &&
@@ -75,9 +142,10 @@ boost::asio::awaitable<void> TransactionDatabase::walk(const std::string& table,
         if (!go_on) {
             break;
         }
-        kv_pair = co_await cursor->next();
-        k = kv_pair.key;
-        v = kv_pair.value;
+        // The key and value buffers are reused along the walk, copying the next pair w/o reallocating them
+        const auto next_kv = co_await cursor->next_view();
+        k.assign(next_kv.key);
+        v.assign(next_kv.value);
     }
 
     co_return;
@@ -87,17 +155,17 @@ boost::asio::awaitable<void> TransactionDatabase::for_prefix(const std::string&
     const auto cursor = co_await tx_.cursor(table);
     SILKRPC_TRACE << "TransactionDatabase::for_prefix cursor_id: " << cursor->cursor_id() << " prefix: " << silkworm::to_hex(prefix) << "\n";
     auto kv_pair = co_await cursor->seek(prefix);
-    auto k = kv_pair.key;
-    auto v = kv_pair.value;
+    auto k = std::move(kv_pair.key);
+    auto v = std::move(kv_pair.value);
     SILKRPC_TRACE << "TransactionDatabase::for_prefix k: " << k << " v: " << v << "\n";
     while (k.substr(0, prefix.size()) == prefix) {
         const auto go_on = w(k, v);
         if (!go_on) {
             break;
         }
-        kv_pair = co_await cursor->next();
-        k = kv_pair.key;
-        v = kv_pair.value;
+        const auto next_kv = co_await cursor->next_view();
+        k.assign(next_kv.key);
+        v.assign(next_kv.value);
         SILKRPC_TRACE << "TransactionDatabase::for_prefix k: " << k << " v: " << v << "\n";
     }
     co_return;
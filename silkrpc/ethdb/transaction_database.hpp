@@ -19,6 +19,7 @@
 
 #include <optional>
 #include <string>
+#include <vector>
 
 #include <silkworm/common/util.hpp>
 #include <silkrpc/core/rawdb/accessors.hpp>
@@ -37,12 +38,27 @@ public:
 
     boost::asio::awaitable<silkworm::Bytes> get_one(const std::string& table, const silkworm::ByteView& key) const override;
 
+    boost::asio::awaitable<SharedByteView> get_one_shared(const std::string& table, const silkworm::ByteView& key) const override;
+
+    boost::asio::awaitable<std::vector<silkworm::Bytes>> get_many(const std::string& table, const std::vector<silkworm::Bytes>& keys) const override;
+
+    boost::asio::awaitable<std::vector<KeyValue>> seek_many(const std::string& table, const std::vector<silkworm::Bytes>& keys) const override;
+
     boost::asio::awaitable<std::optional<silkworm::Bytes>> get_both_range(const std::string& table, const silkworm::ByteView& key, const silkworm::ByteView& subkey) const override;
 
+    boost::asio::awaitable<std::vector<std::optional<silkworm::Bytes>>> get_both_range_many(const std::string& table,
+        const std::vector<silkworm::Bytes>& keys, const std::vector<silkworm::Bytes>& subkeys) const override;
+
     boost::asio::awaitable<void> walk(const std::string& table, const silkworm::ByteView& start_key, uint32_t fixed_bits, core::rawdb::Walker w) const override;
 
     boost::asio::awaitable<void> for_prefix(const std::string& table, const silkworm::ByteView& prefix, core::rawdb::Walker w) const override;
 
+    uint64_t view_id() const override { return tx_.tx_id(); }
+
+    ChainHeadCache* chain_head_cache() const override { return tx_.chain_head_cache(); }
+
+    const snapshot::SnapshotRepository* snapshots() const override { return tx_.snapshots(); }
+
 private:
     Transaction& tx_;
 };
@@ -0,0 +1,79 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "filter_publisher.hpp"
+
+#include <exception>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <silkworm/rpc/common/conversion.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/core/cached_chain.hpp>
+#include <silkrpc/core/receipts.hpp>
+#include <silkrpc/ethdb/transaction_database.hpp>
+
+namespace silkrpc::filters {
+
+FilterPublisher::FilterPublisher(Context& context, FilterRegistry& registry)
+    : context_(context), registry_(registry) {}
+
+void FilterPublisher::on_state_changes(const remote::StateChangeBatch& state_changes) {
+    if (!registry_.has_filters()) {
+        return;
+    }
+    // Unwound blocks are not published: filters will get the new canonical blocks that follow
+    for (const auto& state_change : state_changes.changebatch()) {
+        if (state_change.direction() != remote::Direction::FORWARD) {
+            continue;
+        }
+        const auto block_hash = silkworm::rpc::bytes32_from_H256(state_change.blockhash());
+        boost::asio::co_spawn(*context_.io_context(), publish_block(state_change.blockheight(), block_hash), boost::asio::detached);
+    }
+}
+
+boost::asio::awaitable<void> FilterPublisher::publish_block(uint64_t block_number, evmc::bytes32 block_hash) {
+    SILKRPC_DEBUG << "FilterPublisher::publish_block block_number: " << block_number << "\n";
+
+    if (!registry_.has_log_filters()) {
+        registry_.on_new_block(block_number, block_hash, {});
+        co_return;
+    }
+
+    auto tx = co_await context_.database()->begin();
+
+    try {
+        ethdb::TransactionDatabase tx_database{*tx};
+
+        const auto block_with_hash = co_await core::read_block_by_hash(*context_.block_cache(), tx_database, block_hash);
+        const auto receipts = co_await core::get_receipts(*context_.receipt_cache(), tx_database, *block_with_hash);
+        Logs logs;
+        for (const auto& receipt : *receipts) {
+            logs.insert(logs.end(), receipt.logs.begin(), receipt.logs.end());
+        }
+        registry_.on_new_block(block_number, block_hash, logs);
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "FilterPublisher::publish_block block_number: " << block_number << " exception: " << e.what() << "\n";
+    } catch (...) {
+        SILKRPC_ERROR << "FilterPublisher::publish_block block_number: " << block_number << " unexpected exception\n";
+    }
+
+    co_await tx->close(); // RAII not (yet) available with coroutines
+}
+
+} // namespace silkrpc::filters
@@ -0,0 +1,58 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_FILTERS_FILTER_PUBLISHER_HPP_
+#define SILKRPC_FILTERS_FILTER_PUBLISHER_HPP_
+
+#include <cstdint>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <evmc/evmc.hpp>
+
+#include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/filters/filter_registry.hpp>
+#include <silkrpc/interfaces/remote/kv.pb.h>
+
+namespace silkrpc::filters {
+
+//! Publisher of the blocks announced by the state changes stream to the installed filters
+class FilterPublisher {
+  public:
+    explicit FilterPublisher(Context& context, FilterRegistry& registry);
+
+    FilterPublisher(const FilterPublisher&) = delete;
+    FilterPublisher& operator=(const FilterPublisher&) = delete;
+
+    //! Schedule the publishing of the blocks added by the batch, to be called on the context running the stream
+    void on_state_changes(const remote::StateChangeBatch& state_changes);
+
+  private:
+    //! Read the receipt logs just when there are log filters and queue the block for all the filters
+    boost::asio::awaitable<void> publish_block(uint64_t block_number, evmc::bytes32 block_hash);
+
+    //! The context used to read the published blocks
+    Context& context_;
+
+    //! The registry of the filters to feed
+    FilterRegistry& registry_;
+};
+
+} // namespace silkrpc::filters
+
+#endif // SILKRPC_FILTERS_FILTER_PUBLISHER_HPP_
@@ -0,0 +1,247 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "filter_registry.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <utility>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/json/writer.hpp>
+
+namespace silkrpc::filters {
+
+//! Check if the log matches the block range and the topics of the filter, addresses are matched by the filter groups
+static bool match_log(const Filter& filter, uint64_t block_number, const Log& log) {
+    if ((filter.from_block && block_number < *filter.from_block) || (filter.to_block && block_number > *filter.to_block)) {
+        return false;
+    }
+    if (filter.topics) {
+        const auto& topics = *filter.topics;
+        if (topics.size() > log.topics.size()) {
+            return false;
+        }
+        for (std::size_t i{0}; i < topics.size(); ++i) {
+            const auto& subtopics = topics[i];
+            // Empty rule set means wildcard
+            if (!subtopics.empty() && std::find(subtopics.begin(), subtopics.end(), log.topics[i]) == subtopics.end()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool has_addresses(const Filter& filter) {
+    return filter.addresses && !filter.addresses->empty();
+}
+
+static bool has_first_topics(const Filter& filter) {
+    return filter.topics && !filter.topics->empty() && !filter.topics->front().empty();
+}
+
+FilterRegistry::FilterRegistry(std::chrono::steady_clock::duration filter_timeout)
+    : filter_timeout_{filter_timeout}, id_generator_{std::random_device{}()} {}
+
+std::string FilterRegistry::new_log_filter(Filter filter) {
+    return add_filter(InstalledFilter{FilterKind::logs, std::move(filter), {}, {}, std::chrono::steady_clock::now()});
+}
+
+std::string FilterRegistry::new_block_filter() {
+    return add_filter(InstalledFilter{FilterKind::blocks, Filter{}, {}, {}, std::chrono::steady_clock::now()});
+}
+
+std::string FilterRegistry::add_filter(InstalledFilter filter) {
+    std::lock_guard lock{mutex_};
+
+    std::string filter_id;
+    do {
+        std::array<uint8_t, 16> id_bytes{};
+        for (std::size_t i{0}; i < id_bytes.size(); i += sizeof(uint64_t)) {
+            const auto random = id_generator_();
+            std::copy_n(reinterpret_cast<const uint8_t*>(&random), sizeof(uint64_t), id_bytes.data() + i);
+        }
+        filter_id.clear();
+        write_hex(filter_id, {id_bytes.data(), id_bytes.size()});
+    } while (filters_.contains(filter_id));
+
+    auto& installed = filters_.emplace(filter_id, std::move(filter)).first->second;
+    if (installed.kind == FilterKind::logs) {
+        index_log_filter(&installed);
+        ++log_filters_count_;
+    }
+    SILKRPC_DEBUG << "FilterRegistry::add_filter id: " << filter_id << " #filters: " << filters_.size() << "\n";
+    return filter_id;
+}
+
+void FilterRegistry::index_log_filter(InstalledFilter* filter) {
+    const auto add_to = [&](FilterGroup& group) {
+        if (std::find(group.begin(), group.end(), filter) == group.end()) {
+            group.push_back(filter);
+        }
+    };
+    if (has_addresses(filter->filter)) {
+        for (const auto& address : *filter->filter.addresses) {
+            add_to(by_address_[address]);
+        }
+    } else if (has_first_topics(filter->filter)) {
+        for (const auto& topic : filter->filter.topics->front()) {
+            add_to(by_first_topic_[topic]);
+        }
+    } else {
+        add_to(any_log_);
+    }
+}
+
+void FilterRegistry::unindex_log_filter(InstalledFilter* filter) {
+    const auto remove_from = [&](auto& groups, const auto& key) {
+        const auto it = groups.find(key);
+        if (it != groups.end()) {
+            std::erase(it->second, filter);
+            if (it->second.empty()) {
+                groups.erase(it);
+            }
+        }
+    };
+    if (has_addresses(filter->filter)) {
+        for (const auto& address : *filter->filter.addresses) {
+            remove_from(by_address_, address);
+        }
+    } else if (has_first_topics(filter->filter)) {
+        for (const auto& topic : filter->filter.topics->front()) {
+            remove_from(by_first_topic_, topic);
+        }
+    } else {
+        std::erase(any_log_, filter);
+    }
+}
+
+void FilterRegistry::remove_filter(std::map<std::string, InstalledFilter>::iterator it) {
+    if (it->second.kind == FilterKind::logs) {
+        unindex_log_filter(&it->second);
+        --log_filters_count_;
+    }
+    filters_.erase(it);
+}
+
+bool FilterRegistry::uninstall(const std::string& filter_id) {
+    std::lock_guard lock{mutex_};
+
+    const auto it = filters_.find(filter_id);
+    if (it == filters_.end()) {
+        return false;
+    }
+    remove_filter(it);
+    SILKRPC_DEBUG << "FilterRegistry::uninstall id: " << filter_id << " #filters: " << filters_.size() << "\n";
+    return true;
+}
+
+std::optional<FilterChanges> FilterRegistry::changes(const std::string& filter_id) {
+    std::lock_guard lock{mutex_};
+
+    const auto it = filters_.find(filter_id);
+    if (it == filters_.end()) {
+        return std::nullopt;
+    }
+    auto& filter = it->second;
+    filter.last_poll = std::chrono::steady_clock::now();
+    if (filter.kind == FilterKind::logs) {
+        Logs logs{std::make_move_iterator(filter.logs.begin()), std::make_move_iterator(filter.logs.end())};
+        filter.logs.clear();
+        return logs;
+    }
+    std::vector<evmc::bytes32> block_hashes{filter.block_hashes.begin(), filter.block_hashes.end()};
+    filter.block_hashes.clear();
+    return block_hashes;
+}
+
+std::size_t FilterRegistry::size() const {
+    std::lock_guard lock{mutex_};
+    return filters_.size();
+}
+
+bool FilterRegistry::has_filters() const {
+    std::lock_guard lock{mutex_};
+    return !filters_.empty();
+}
+
+bool FilterRegistry::has_log_filters() const {
+    std::lock_guard lock{mutex_};
+    return log_filters_count_ > 0;
+}
+
+void FilterRegistry::match_group(const FilterGroup& group, uint64_t block_number, const Log& log) {
+    for (auto* filter : group) {
+        if (match_log(filter->filter, block_number, log)) {
+            filter->logs.push_back(log);
+            if (filter->logs.size() > kMaxQueueSize) {
+                filter->logs.pop_front();
+            }
+        }
+    }
+}
+
+void FilterRegistry::on_new_block(uint64_t block_number, const evmc::bytes32& block_hash, const Logs& logs) {
+    {
+        std::lock_guard lock{mutex_};
+
+        for (auto& [_, filter] : filters_) {
+            if (filter.kind == FilterKind::blocks) {
+                filter.block_hashes.push_back(block_hash);
+                if (filter.block_hashes.size() > kMaxQueueSize) {
+                    filter.block_hashes.pop_front();
+                }
+            }
+        }
+
+        if (log_filters_count_ > 0) {
+            for (const auto& log : logs) {
+                if (const auto it = by_address_.find(log.address); it != by_address_.end()) {
+                    match_group(it->second, block_number, log);
+                }
+                if (!log.topics.empty()) {
+                    if (const auto it = by_first_topic_.find(log.topics.front()); it != by_first_topic_.end()) {
+                        match_group(it->second, block_number, log);
+                    }
+                }
+                match_group(any_log_, block_number, log);
+            }
+        }
+    }
+
+    expire(std::chrono::steady_clock::now());
+}
+
+std::size_t FilterRegistry::expire(std::chrono::steady_clock::time_point now) {
+    std::lock_guard lock{mutex_};
+
+    std::size_t num_expired{0};
+    for (auto it = filters_.begin(); it != filters_.end();) {
+        if (now - it->second.last_poll > filter_timeout_) {
+            SILKRPC_DEBUG << "FilterRegistry::expire id: " << it->first << "\n";
+            remove_filter(it++);
+            ++num_expired;
+        } else {
+            ++it;
+        }
+    }
+    return num_expired;
+}
+
+} // namespace silkrpc::filters
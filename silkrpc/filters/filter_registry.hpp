@@ -0,0 +1,136 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_FILTERS_FILTER_REGISTRY_HPP_
+#define SILKRPC_FILTERS_FILTER_REGISTRY_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include <evmc/evmc.hpp>
+
+#include <silkrpc/types/filter.hpp>
+#include <silkrpc/types/log.hpp>
+
+namespace silkrpc::filters {
+
+//! The kinds of filters installed by eth_newFilter and eth_newBlockFilter
+enum class FilterKind {
+    logs,
+    blocks
+};
+
+//! The changes of one filter since the last poll: the matching logs for log filters, the new block hashes for block filters
+using FilterChanges = std::variant<Logs, std::vector<evmc::bytes32>>;
+
+//! The registry of the filters installed by the clients, polled by eth_getFilterChanges and safe for concurrent use.
+//! Each filter keeps the queue of the changes since its last poll, fed by the blocks announced by the state changes
+//! stream: the logs of each new block are matched once for all the log filters together, looking up the candidate
+//! filters by log address (or by first topic, for the filters without addresses) instead of checking every filter.
+class FilterRegistry {
+  public:
+    //! The default time after which a filter not polled anymore is uninstalled
+    static constexpr std::chrono::seconds kDefaultFilterTimeout{300};
+
+    //! The maximum number of changes queued for each filter, the oldest ones are dropped when polled too slowly
+    static constexpr std::size_t kMaxQueueSize{10'000};
+
+    explicit FilterRegistry(std::chrono::steady_clock::duration filter_timeout = kDefaultFilterTimeout);
+
+    FilterRegistry(const FilterRegistry&) = delete;
+    FilterRegistry& operator=(const FilterRegistry&) = delete;
+
+    //! Install a filter of the new logs matching the addresses, topics and block range, returning its identifier
+    std::string new_log_filter(Filter filter);
+
+    //! Install a filter of the new block hashes, returning its identifier
+    std::string new_block_filter();
+
+    //! Uninstall the specified filter, returning false if unknown
+    bool uninstall(const std::string& filter_id);
+
+    //! Return the changes of the specified filter since the last poll draining its queue, or nothing if unknown
+    std::optional<FilterChanges> changes(const std::string& filter_id);
+
+    std::size_t size() const;
+
+    bool has_filters() const;
+    bool has_log_filters() const;
+
+    //! Queue the new block for the filters, matching its logs against all the log filters at once
+    void on_new_block(uint64_t block_number, const evmc::bytes32& block_hash, const Logs& logs);
+
+    //! Uninstall the filters not polled since the filter timeout before the specified time, returning their number
+    std::size_t expire(std::chrono::steady_clock::time_point now);
+
+  private:
+    struct InstalledFilter {
+        FilterKind kind;
+        Filter filter;
+        std::deque<Log> logs;
+        std::deque<evmc::bytes32> block_hashes;
+        std::chrono::steady_clock::time_point last_poll;
+    };
+
+    //! Each group holds the log filters that may match the logs having one address or first topic
+    using FilterGroup = std::vector<InstalledFilter*>;
+
+    std::string add_filter(InstalledFilter filter);
+
+    //! Add or remove the log filter from the groups of its addresses, or first topics, or to the wildcard group
+    void index_log_filter(InstalledFilter* filter);
+    void unindex_log_filter(InstalledFilter* filter);
+
+    //! Match the block logs against the candidate filters, assuming the address or first topic already matches
+    static void match_group(const FilterGroup& group, uint64_t block_number, const Log& log);
+
+    void remove_filter(std::map<std::string, InstalledFilter>::iterator it);
+
+    //! The timeout after which the filters not polled anymore are uninstalled
+    std::chrono::steady_clock::duration filter_timeout_;
+
+    //! Protect the filters from concurrent access by request handlers and publisher
+    mutable std::mutex mutex_;
+
+    //! The installed filters by identifier, never moved in memory before being uninstalled
+    std::map<std::string, InstalledFilter> filters_;
+
+    //! The log filters grouped by address, by first topic for the ones without addresses, the remaining ones
+    std::unordered_map<evmc::address, FilterGroup> by_address_;
+    std::unordered_map<evmc::bytes32, FilterGroup> by_first_topic_;
+    FilterGroup any_log_;
+
+    //! The number of installed log filters, to skip reading the block logs when nobody is listening
+    std::size_t log_filters_count_{0};
+
+    //! The generator of unpredictable filter identifiers
+    std::mt19937_64 id_generator_;
+};
+
+} // namespace silkrpc::filters
+
+#endif // SILKRPC_FILTERS_FILTER_REGISTRY_HPP_
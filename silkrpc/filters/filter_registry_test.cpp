@@ -0,0 +1,184 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "filter_registry.hpp"
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+
+namespace silkrpc::filters {
+
+using evmc::literals::operator""_address, evmc::literals::operator""_bytes32;
+
+static Log make_log(const evmc::address& address, std::vector<evmc::bytes32> topics) {
+    Log log{};
+    log.address = address;
+    log.topics = std::move(topics);
+    return log;
+}
+
+static Logs logs_of(FilterRegistry& registry, const std::string& filter_id) {
+    auto changes = registry.changes(filter_id);
+    REQUIRE(changes);
+    REQUIRE(std::holds_alternative<Logs>(*changes));
+    return std::get<Logs>(*changes);
+}
+
+TEST_CASE("FilterRegistry install and uninstall", "[silkrpc][filters][filter_registry]") {
+    FilterRegistry registry;
+    CHECK(!registry.has_filters());
+
+    const auto log_filter_id = registry.new_log_filter(Filter{});
+    const auto block_filter_id = registry.new_block_filter();
+    CHECK(log_filter_id.starts_with("0x"));
+    CHECK(log_filter_id.size() == 34);
+    CHECK(log_filter_id != block_filter_id);
+    CHECK(registry.size() == 2);
+    CHECK(registry.has_log_filters());
+
+    CHECK(registry.uninstall(log_filter_id));
+    CHECK(!registry.uninstall(log_filter_id));
+    CHECK(!registry.has_log_filters());
+    CHECK(registry.has_filters());
+    CHECK(!registry.changes(log_filter_id));
+
+    CHECK(registry.uninstall(block_filter_id));
+    CHECK(registry.size() == 0);
+}
+
+TEST_CASE("FilterRegistry block filter", "[silkrpc][filters][filter_registry]") {
+    const auto hash1{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+    const auto hash2{0x0000000000000000000000000000000000000000000000000000000000000002_bytes32};
+    FilterRegistry registry;
+    const auto filter_id = registry.new_block_filter();
+
+    registry.on_new_block(1, hash1, {});
+    registry.on_new_block(2, hash2, {});
+    auto changes = registry.changes(filter_id);
+    REQUIRE(changes);
+    CHECK(std::get<std::vector<evmc::bytes32>>(*changes) == std::vector<evmc::bytes32>{hash1, hash2});
+
+    // The queue is drained by each poll
+    changes = registry.changes(filter_id);
+    REQUIRE(changes);
+    CHECK(std::get<std::vector<evmc::bytes32>>(*changes).empty());
+}
+
+TEST_CASE("FilterRegistry log filters", "[silkrpc][filters][filter_registry]") {
+    const auto address1{0x00000000000000000000000000000000000000aa_address};
+    const auto address2{0x00000000000000000000000000000000000000bb_address};
+    const auto topic1{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+    const auto topic2{0x0000000000000000000000000000000000000000000000000000000000000002_bytes32};
+    const auto block_hash{0x00000000000000000000000000000000000000000000000000000000000000ff_bytes32};
+    const Logs logs{make_log(address1, {topic1, topic2}), make_log(address2, {topic2}), make_log(address2, {})};
+    FilterRegistry registry;
+
+    SECTION("empty filter matches any log") {
+        const auto filter_id = registry.new_log_filter(Filter{});
+        registry.on_new_block(1, block_hash, logs);
+        CHECK(logs_of(registry, filter_id).size() == 3);
+        CHECK(logs_of(registry, filter_id).empty());
+    }
+    SECTION("address") {
+        Filter filter{};
+        filter.addresses = FilterAddresses{address2, address2};
+        const auto filter_id = registry.new_log_filter(filter);
+        registry.on_new_block(1, block_hash, logs);
+        const auto matching_logs = logs_of(registry, filter_id);
+        REQUIRE(matching_logs.size() == 2);
+        CHECK(matching_logs[0].address == address2);
+        CHECK(matching_logs[1].address == address2);
+    }
+    SECTION("address and topics by position") {
+        Filter filter{};
+        filter.addresses = FilterAddresses{address1, address2};
+        filter.topics = FilterTopics{{}, {topic2}};
+        const auto filter_id = registry.new_log_filter(filter);
+        registry.on_new_block(1, block_hash, logs);
+        const auto matching_logs = logs_of(registry, filter_id);
+        REQUIRE(matching_logs.size() == 1);
+        CHECK(matching_logs[0].address == address1);
+    }
+    SECTION("first topic without addresses") {
+        Filter filter{};
+        filter.topics = FilterTopics{{topic2, topic1}};
+        const auto filter_id = registry.new_log_filter(filter);
+        registry.on_new_block(1, block_hash, logs);
+        CHECK(logs_of(registry, filter_id).size() == 2);
+    }
+    SECTION("block range") {
+        Filter filter{};
+        filter.from_block = 2;
+        filter.to_block = 3;
+        const auto filter_id = registry.new_log_filter(filter);
+        registry.on_new_block(1, block_hash, logs);
+        registry.on_new_block(2, block_hash, logs);
+        registry.on_new_block(4, block_hash, logs);
+        CHECK(logs_of(registry, filter_id).size() == 3);
+    }
+    SECTION("filters matched together") {
+        Filter filter1{};
+        filter1.addresses = FilterAddresses{address1};
+        Filter filter2{};
+        filter2.topics = FilterTopics{{topic2}};
+        const auto filter_id1 = registry.new_log_filter(filter1);
+        const auto filter_id2 = registry.new_log_filter(filter2);
+        const auto filter_id3 = registry.new_log_filter(Filter{});
+        registry.on_new_block(1, block_hash, logs);
+        CHECK(logs_of(registry, filter_id1).size() == 1);
+        CHECK(logs_of(registry, filter_id2).size() == 1);
+        CHECK(logs_of(registry, filter_id3).size() == 3);
+
+        CHECK(registry.uninstall(filter_id1));
+        registry.on_new_block(2, block_hash, logs);
+        CHECK(logs_of(registry, filter_id2).size() == 1);
+        CHECK(logs_of(registry, filter_id3).size() == 3);
+    }
+}
+
+TEST_CASE("FilterRegistry queue is bounded", "[silkrpc][filters][filter_registry]") {
+    const auto block_hash{0x00000000000000000000000000000000000000000000000000000000000000ff_bytes32};
+    FilterRegistry registry;
+    const auto filter_id = registry.new_block_filter();
+    for (uint64_t n{0}; n < FilterRegistry::kMaxQueueSize + 10; ++n) {
+        registry.on_new_block(n, block_hash, {});
+    }
+    const auto changes = registry.changes(filter_id);
+    REQUIRE(changes);
+    CHECK(std::get<std::vector<evmc::bytes32>>(*changes).size() == FilterRegistry::kMaxQueueSize);
+}
+
+TEST_CASE("FilterRegistry expire", "[silkrpc][filters][filter_registry]") {
+    FilterRegistry registry{std::chrono::seconds{10}};
+    const auto filter_id1 = registry.new_block_filter();
+    const auto filter_id2 = registry.new_log_filter(Filter{});
+    const auto now = std::chrono::steady_clock::now();
+
+    CHECK(registry.expire(now) == 0);
+    CHECK(registry.expire(now + std::chrono::seconds{60}) == 2);
+    CHECK(!registry.changes(filter_id1));
+    CHECK(!registry.changes(filter_id2));
+    CHECK(!registry.has_log_filters());
+}
+
+} // namespace silkrpc::filters
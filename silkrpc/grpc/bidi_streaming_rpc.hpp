@@ -17,18 +17,29 @@
 #ifndef SILKRPC_GRPC_BIDI_STREAMING_RPC_HPP_
 #define SILKRPC_GRPC_BIDI_STREAMING_RPC_HPP_
 
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
 #include <memory>
 #include <optional>
+#include <stdexcept>
 #include <system_error>
 #include <utility>
 
 #include <silkrpc/config.hpp>
 
 #include <agrpc/rpc.hpp>
+#include <boost/asio/awaitable.hpp>
 #include <boost/asio/bind_executor.hpp>
 #include <boost/asio/compose.hpp>
 #include <boost/asio/dispatch.hpp>
 #include <boost/asio/experimental/append.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/system/system_error.hpp>
 #include <grpcpp/grpcpp.h>
 
 #include <silkrpc/common/log.hpp>
@@ -74,7 +85,7 @@ private:
         void operator()(Op& op, bool ok, detail::ReadDoneTag) {
             SILKRPC_TRACE << "BidiStreamingRpc::ReadNext(op, ok, ReadDoneTag): " << this << " ok=" << ok << "\n";
             if (ok) {
-                op.complete({}, self_.reply_);
+                op.complete({}, std::move(self_.reply_));
             } else {
                 self_.finish(std::move(op));
             }
@@ -83,7 +94,10 @@ private:
         template<typename Op>
         void operator()(Op& op, const boost::system::error_code& ec) {
             SILKRPC_TRACE << "BidiStreamingRpc::ReadNext(op, ec): " << this << " ec=" << ec << "\n";
-            op.complete(ec, self_.reply_);
+            if (ec) {
+                self_.failed_ = true;
+            }
+            op.complete(ec, {});
         }
     };
 
@@ -108,7 +122,59 @@ private:
             if (this->self_.reader_writer_) {
                 agrpc::write(this->self_.reader_writer_, request, boost::asio::bind_executor(this->self_.grpc_context_, std::move(op)));
             } else {
-                op.complete(make_error_code(grpc::StatusCode::INTERNAL, "agrpc::write called before agrpc::request"), this->self_.reply_);
+                op.complete(make_error_code(grpc::StatusCode::INTERNAL, "agrpc::write called before agrpc::request"), {});
+            }
+        }
+
+        using ReadNext::operator();
+    };
+
+    struct Write {
+        BidiStreamingRpc& self_;
+        const Request& request;
+
+        template<typename Op>
+        void operator()(Op& op) {
+            SILKRPC_TRACE << "BidiStreamingRpc::Write::initiate " << this << "\n";
+            if (self_.reader_writer_) {
+                agrpc::write(self_.reader_writer_, request, boost::asio::bind_executor(self_.grpc_context_, std::move(op)));
+            } else {
+                op.complete(make_error_code(grpc::StatusCode::INTERNAL, "agrpc::write called before agrpc::request"));
+            }
+        }
+
+        template<typename Op>
+        void operator()(Op& op, bool ok) {
+            SILKRPC_TRACE << "BidiStreamingRpc::Write::completed " << this << " ok=" << ok << "\n";
+            if (ok) {
+                ++self_.unread_replies_;
+                op.complete({});
+            } else {
+                self_.finish(std::move(op));
+            }
+        }
+
+        template<typename Op>
+        void operator()(Op& op, const boost::system::error_code& ec) {
+            if (ec) {
+                self_.failed_ = true;
+            }
+            op.complete(ec);
+        }
+    };
+
+    struct Read : ReadNext {
+        template<typename Op>
+        void operator()(Op& op) {
+            SILKRPC_TRACE << "BidiStreamingRpc::Read::initiate " << this << "\n";
+            if (this->self_.reader_writer_) {
+                if (this->self_.unread_replies_ > 0) {
+                    --this->self_.unread_replies_;
+                }
+                agrpc::read(this->self_.reader_writer_, this->self_.reply_,
+                    boost::asio::bind_executor(this->self_.grpc_context_, boost::asio::experimental::append(std::move(op), detail::ReadDoneTag{})));
+            } else {
+                op.complete(make_error_code(grpc::StatusCode::INTERNAL, "agrpc::read called before agrpc::request"), {});
             }
         }
 
@@ -181,12 +247,94 @@ public:
 
     template<typename CompletionToken = agrpc::DefaultCompletionToken>
     auto request_and_read(CompletionToken&& token = {}) {
-        return boost::asio::async_compose<CompletionToken, void(boost::system::error_code, Reply&)>(RequestAndRead{*this}, token);
+        return boost::asio::async_compose<CompletionToken, void(boost::system::error_code, Reply)>(RequestAndRead{*this}, token);
     }
 
     template<typename CompletionToken = agrpc::DefaultCompletionToken>
     auto write_and_read(const Request& request, CompletionToken&& token = {}) {
-        return boost::asio::async_compose<CompletionToken, void(boost::system::error_code, Reply&)>(WriteAndRead{*this, request}, token);
+        return boost::asio::async_compose<CompletionToken, void(boost::system::error_code, Reply)>(WriteAndRead{*this, request}, token);
+    }
+
+    //! Write the request without waiting for its reply: use read to get the replies in the same order, so that several
+    //! requests can be pipelined. Just one write and one read can be outstanding at any time
+    template<typename CompletionToken = agrpc::DefaultCompletionToken>
+    auto write(const Request& request, CompletionToken&& token = {}) {
+        return boost::asio::async_compose<CompletionToken, void(boost::system::error_code)>(Write{*this, request}, token);
+    }
+
+    //! Read the reply of the oldest request written and not read yet: the reply is moved out of the stream, so that its
+    //! buffers can be kept by the caller w/o copying them
+    template<typename CompletionToken = agrpc::DefaultCompletionToken>
+    auto read(CompletionToken&& token = {}) {
+        return boost::asio::async_compose<CompletionToken, void(boost::system::error_code, Reply)>(Read{*this}, token);
+    }
+
+    //! Multiplexed mode: the coroutines sharing the stream can have several requests outstanding at the same time, each one
+    //! identified by the ticket returned when written. The writes are serialized, the replies are read by whichever caller
+    //! is waiting when no read is in progress and kept aside for the callers owning them, since they come in the same
+    //! order of the requests. All the callers must run on the same single-threaded executor and the multiplexed mode must
+    //! not be mixed with write and read after the stream has been requested.
+
+    //! Write the request as soon as no other write is in progress and return its ticket
+    boost::asio::awaitable<uint64_t> write_multiplexed(const Request& request) {
+        while (writing_) {
+            co_await wait_turn(write_waiters_);
+        }
+        writing_ = true;
+        const auto ticket = next_ticket_++;
+        try {
+            co_await write(request, boost::asio::use_awaitable);
+        } catch (...) {
+            writing_ = false;
+            notify_all(write_waiters_);
+            throw;
+        }
+        writing_ = false;
+        notify_one(write_waiters_);
+        co_return ticket;
+    }
+
+    //! Read the reply to the request having the specified ticket, reading and keeping aside the replies to the previous
+    //! requests if needed: the reply is moved out of the stream, so that its buffers can be kept w/o copying them
+    boost::asio::awaitable<Reply> read_multiplexed(uint64_t ticket) {
+        while (true) {
+            const auto reply_it = kept_replies_.find(ticket);
+            if (reply_it != kept_replies_.end()) {
+                auto reply = std::move(reply_it->second);
+                kept_replies_.erase(reply_it);
+                co_return reply;
+            }
+            if (ticket < next_reply_ || ticket >= next_ticket_) {
+                throw std::logic_error{"BidiStreamingRpc::read_multiplexed invalid ticket"};
+            }
+            if (reading_) {
+                co_await wait_turn(read_waiters_);
+                continue;
+            }
+            auto [read_ticket, reply] = co_await read_next_multiplexed();
+            if (read_ticket == ticket) {
+                co_return std::move(reply);
+            }
+            kept_replies_.emplace(read_ticket, std::move(reply));
+        }
+    }
+
+    //! Write the request and read its reply in multiplexed mode
+    boost::asio::awaitable<Reply> call(const Request& request) {
+        const auto ticket = co_await write_multiplexed(request);
+        co_return co_await read_multiplexed(ticket);
+    }
+
+    //! Read all the replies to the requests written in multiplexed mode, keeping them aside for their callers
+    boost::asio::awaitable<void> settle_multiplexed() {
+        while (next_reply_ < next_ticket_) {
+            if (reading_) {
+                co_await wait_turn(read_waiters_);
+                continue;
+            }
+            auto [read_ticket, reply] = co_await read_next_multiplexed();
+            kept_replies_.emplace(read_ticket, std::move(reply));
+        }
     }
 
     template<typename CompletionToken = agrpc::DefaultCompletionToken>
@@ -198,18 +346,85 @@ public:
         return grpc_context_.get_executor();
     }
 
+    //! Return true if the stream can carry further requests, i.e. it is open, it never failed and no reply is left unread
+    bool is_reusable() const noexcept {
+        return reader_writer_ && !status_ && !failed_ && unread_replies_ == 0;
+    }
+
 private:
     template<typename CompletionToken = agrpc::DefaultCompletionToken>
     auto finish(CompletionToken&& token = {}) {
         return boost::asio::async_compose<CompletionToken, void(boost::system::error_code)>(Finish{*this}, token);
     }
 
+    using Waiters = std::deque<std::shared_ptr<boost::asio::steady_timer>>;
+
+    //! Wait for the next notification to the waiters, from the operation in progress
+    static boost::asio::awaitable<void> wait_turn(Waiters& waiters) {
+        auto waiter = std::make_shared<boost::asio::steady_timer>(co_await boost::asio::this_coro::executor,
+            boost::asio::steady_timer::time_point::max());
+        waiters.push_back(waiter);
+        boost::system::error_code ec;
+        co_await waiter->async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+    }
+
+    static void notify_one(Waiters& waiters) {
+        if (!waiters.empty()) {
+            waiters.front()->cancel();
+            waiters.pop_front();
+        }
+    }
+
+    static void notify_all(Waiters& waiters) {
+        Waiters notified;
+        notified.swap(waiters);
+        for (auto& waiter : notified) {
+            waiter->cancel();
+        }
+    }
+
+    //! Read the next reply on the wire along with the ticket of its request, then let the waiting readers check theirs
+    boost::asio::awaitable<std::pair<uint64_t, Reply>> read_next_multiplexed() {
+        if (status_ || failed_) {
+            throw boost::system::system_error{make_error_code(grpc::StatusCode::INTERNAL, "BidiStreamingRpc stream failed")};
+        }
+        reading_ = true;
+        Reply reply;
+        try {
+            reply = co_await read(boost::asio::use_awaitable);
+        } catch (...) {
+            reading_ = false;
+            notify_all(read_waiters_);
+            throw;
+        }
+        const auto ticket = next_reply_++;
+        reading_ = false;
+        notify_all(read_waiters_);
+        co_return std::make_pair(ticket, std::move(reply));
+    }
+
     Stub& stub_;
     agrpc::GrpcContext& grpc_context_;
     grpc::ClientContext context_;
     std::unique_ptr<Responder<Request, Reply>> reader_writer_;
     Reply reply_;
     std::optional<grpc::Status> status_;
+    //! The number of pipelined requests written whose reply has not been read yet
+    std::size_t unread_replies_{0};
+    //! Flag indicating if any operation failed, leaving the stream in an unknown state
+    bool failed_{false};
+
+    //! The ticket of the next request written in multiplexed mode
+    uint64_t next_ticket_{0};
+    //! The ticket of the request whose reply is the next one on the wire in multiplexed mode
+    uint64_t next_reply_{0};
+    //! The replies read in multiplexed mode and not taken by their callers yet, by ticket
+    std::map<uint64_t, Reply> kept_replies_;
+    bool writing_{false};
+    bool reading_{false};
+    //! The callers waiting for the write or the read in progress to complete, in multiplexed mode
+    Waiters write_waiters_;
+    Waiters read_waiters_;
 };
 
 } // namespace silkrpc
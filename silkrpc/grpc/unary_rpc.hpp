@@ -17,6 +17,8 @@
 #ifndef SILKRPC_GRPC_UNARY_RPC_HPP_
 #define SILKRPC_GRPC_UNARY_RPC_HPP_
 
+#include <chrono>
+#include <cstddef>
 #include <memory>
 #include <system_error>
 #include <utility>
@@ -27,8 +29,10 @@
 #include <boost/asio/bind_executor.hpp>
 #include <boost/asio/compose.hpp>
 #include <boost/asio/experimental/append.hpp>
+#include <google/protobuf/arena.h>
 #include <grpcpp/grpcpp.h>
 
+#include <silkrpc/concurrency/cancellation.hpp>
 #include <silkrpc/grpc/dispatcher.hpp>
 #include <silkrpc/grpc/error.hpp>
 #include <silkrpc/grpc/util.hpp>
@@ -63,7 +67,7 @@ private:
         void operator()(Op& op) {
             SILKRPC_TRACE << "UnaryRpc::initiate " << this << "\n";
             self_.reader_ = agrpc::request(Async, self_.stub_, self_.context_, request_, self_.grpc_context_);
-            agrpc::finish(self_.reader_, self_.reply_, self_.status_, boost::asio::bind_executor(self_.grpc_context_, std::move(op)));
+            agrpc::finish(self_.reader_, *self_.reply_, self_.status_, boost::asio::bind_executor(self_.grpc_context_, std::move(op)));
         }
 
         template<typename Op>
@@ -75,39 +79,75 @@ private:
         void operator()(Op& op, detail::DoneTag) {
             SILKRPC_DEBUG << "UnaryRpc::completed " << self_.status_ << "\n";
             if (self_.status_.ok()) {
-                op.complete({}, std::move(self_.reply_));
+                op.complete({});
             } else {
-                op.complete(make_error_code(self_.status_.error_code(), self_.status_.error_message()), {});
+                op.complete(make_error_code(self_.status_.error_code(), self_.status_.error_message()));
             }
         }
     };
 
 public:
+    //! The size of the first arena block, embedded in the RPC: most replies fit in it w/o any heap allocation
+    static constexpr std::size_t kInitialArenaBlockSize{1024};
+
     explicit UnaryRpc(Stub& stub, agrpc::GrpcContext& grpc_context)
-        : stub_(stub), grpc_context_(grpc_context) {}
+        : stub_(stub), grpc_context_(grpc_context), arena_{arena_options(initial_block_)},
+          reply_{google::protobuf::Arena::CreateMessage<Reply>(&arena_)} {}
+
+    UnaryRpc(const UnaryRpc&) = delete;
+    UnaryRpc& operator=(const UnaryRpc&) = delete;
+
+    //! Bound the call by the deadline of the cancellation token, if any: it must be done before finishing the call
+    void set_deadline(const CancellationToken& token) {
+        if (const auto deadline = token.deadline()) {
+            const auto remaining = std::chrono::duration_cast<std::chrono::system_clock::duration>(*deadline - CancellationToken::Clock::now());
+            context_.set_deadline(std::chrono::system_clock::now() + remaining);
+        }
+    }
 
+    //! Make the call uncompressed whatever the compression of the channel, e.g. when both the request and the reply are
+    //! small: it must be done before finishing the call
+    void disable_compression() { context_.set_compression_algorithm(GRPC_COMPRESS_NONE); }
+
+    //! Make the call, then get the reply by reply(): it is owned by the arena of the RPC, so that the whole message tree
+    //! is freed in bulk along with it
     template<typename CompletionToken = agrpc::DefaultCompletionToken>
     auto finish(const Request& request, CompletionToken&& token = {}) {
-        return boost::asio::async_compose<CompletionToken, void(boost::system::error_code, Reply)>(
+        return boost::asio::async_compose<CompletionToken, void(boost::system::error_code)>(
             Call<detail::InlineDispatcher>{*this, request}, token);
     }
 
     template<typename Executor, typename CompletionToken = agrpc::DefaultCompletionToken>
     auto finish_on(const Executor& executor, const Request& request, CompletionToken&& token = {}) {
-        return boost::asio::async_compose<CompletionToken, void(boost::system::error_code, Reply)>(
+        return boost::asio::async_compose<CompletionToken, void(boost::system::error_code)>(
             Call<detail::ExecutorDispatcher<Executor>>{*this, request, executor}, token, executor);
     }
 
+    //! The reply of the finished call, valid as long as the RPC
+    const Reply& reply() const noexcept { return *reply_; }
+
+    //! The arena of the RPC, where the request can be built as well when it has many nested messages
+    google::protobuf::Arena* arena() noexcept { return &arena_; }
+
     auto get_executor() const noexcept {
         return grpc_context_.get_executor();
     }
 
 private:
+    static google::protobuf::ArenaOptions arena_options(char* initial_block) {
+        google::protobuf::ArenaOptions options;
+        options.initial_block = initial_block;
+        options.initial_block_size = kInitialArenaBlockSize;
+        return options;
+    }
+
     Stub& stub_;
     agrpc::GrpcContext& grpc_context_;
     grpc::ClientContext context_;
     std::unique_ptr<Reader<Reply>> reader_;
-    Reply reply_;
+    alignas(std::max_align_t) char initial_block_[kInitialArenaBlockSize];
+    google::protobuf::Arena arena_;
+    Reply* reply_;
     grpc::Status status_;
 };
 
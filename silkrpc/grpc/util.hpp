@@ -18,6 +18,8 @@
 #define SILKRPC_GRPC_UTIL_HPP_
 
 #include <ostream>
+#include <stdexcept>
+#include <string>
 
 #include <grpcpp/grpcpp.h>
 
@@ -35,4 +37,23 @@ inline std::ostream& operator<<(std::ostream& out, const grpc::Status& status) {
 
 } // namespace grpc
 
+namespace silkrpc {
+
+//! Parse the gRPC compression algorithm named "gzip" or "deflate", the empty name meaning no compression
+//! \throws std::invalid_argument if the name is unknown
+inline grpc_compression_algorithm parse_compression_algorithm(const std::string& name) {
+    if (name.empty() || name == "none") {
+        return GRPC_COMPRESS_NONE;
+    }
+    if (name == "gzip") {
+        return GRPC_COMPRESS_GZIP;
+    }
+    if (name == "deflate") {
+        return GRPC_COMPRESS_DEFLATE;
+    }
+    throw std::invalid_argument{"unknown compression algorithm: " + name};
+}
+
+} // namespace silkrpc
+
 #endif // SILKRPC_GRPC_UTIL_HPP_
@@ -27,4 +27,13 @@ TEST_CASE("print grpc::Status", "[silkrpc][grpc][util]") {
     CHECK_NOTHROW(null_stream() << grpc::Status::CANCELLED);
 }
 
+TEST_CASE("parse_compression_algorithm", "[silkrpc][grpc][util]") {
+    CHECK(parse_compression_algorithm("") == GRPC_COMPRESS_NONE);
+    CHECK(parse_compression_algorithm("none") == GRPC_COMPRESS_NONE);
+    CHECK(parse_compression_algorithm("gzip") == GRPC_COMPRESS_GZIP);
+    CHECK(parse_compression_algorithm("deflate") == GRPC_COMPRESS_DEFLATE);
+    CHECK_THROWS_AS(parse_compression_algorithm("zstd"), std::invalid_argument);
+    CHECK_THROWS_AS(parse_compression_algorithm("GZIP"), std::invalid_argument);
+}
+
 } // namespace silkrpc
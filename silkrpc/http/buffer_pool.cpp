@@ -0,0 +1,100 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "buffer_pool.hpp"
+
+#include <bit>
+#include <new>
+
+namespace silkrpc::http {
+
+BufferPool::~BufferPool() {
+    for (auto& blocks : free_blocks_) {
+        for (auto* block : blocks) {
+            ::operator delete(block);
+        }
+    }
+}
+
+std::size_t BufferPool::free_bytes() const {
+    std::scoped_lock lock{mutex_};
+    return free_bytes_;
+}
+
+std::size_t BufferPool::used_bytes() const {
+    std::scoped_lock lock{mutex_};
+    return used_bytes_;
+}
+
+std::size_t BufferPool::block_size(std::size_t size) noexcept {
+    if (size <= kMinBlockSize) {
+        return kMinBlockSize;
+    }
+    return size <= kMaxBlockSize ? std::bit_ceil(size) : size;
+}
+
+std::size_t BufferPool::size_class(std::size_t block_size) noexcept {
+    return static_cast<std::size_t>(std::countr_zero(block_size / kMinBlockSize));
+}
+
+void* BufferPool::do_allocate(std::size_t bytes, std::size_t alignment) {
+    const auto size = block_size(bytes);
+    if (size > kMaxBlockSize || alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        return ::operator new(bytes, std::align_val_t{alignment});
+    }
+    {
+        std::scoped_lock lock{mutex_};
+        used_bytes_ += size;
+        auto& blocks = free_blocks_[size_class(size)];
+        if (!blocks.empty()) {
+            void* block = blocks.back();
+            blocks.pop_back();
+            free_bytes_ -= size;
+            return block;
+        }
+    }
+    try {
+        return ::operator new(size);
+    } catch (...) {
+        std::scoped_lock lock{mutex_};
+        used_bytes_ -= size;
+        throw;
+    }
+}
+
+void BufferPool::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+    const auto size = block_size(bytes);
+    if (size > kMaxBlockSize || alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        ::operator delete(p, std::align_val_t{alignment});
+        return;
+    }
+    {
+        std::scoped_lock lock{mutex_};
+        used_bytes_ -= size;
+        if (free_bytes_ + size <= max_free_bytes_) {
+            try {
+                free_blocks_[size_class(size)].push_back(p);
+                free_bytes_ += size;
+                return;
+            } catch (const std::bad_alloc&) {
+                // Give the block back to the heap instead
+            }
+        }
+    }
+    ::operator delete(p);
+}
+
+} // namespace silkrpc::http
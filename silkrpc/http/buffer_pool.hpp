@@ -0,0 +1,112 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_HTTP_BUFFER_POOL_HPP_
+#define SILKRPC_HTTP_BUFFER_POOL_HPP_
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <silkrpc/common/constants.hpp>
+
+namespace silkrpc::http {
+
+/// Pool of the I/O buffers and arena blocks shared by the connections of one execution context, so that connections
+/// borrow memory only while serving some request and idle connections hold almost nothing. Blocks are grouped in
+/// power-of-two size classes from kMinBlockSize to kMaxBlockSize, larger blocks are allocated on the heap. At most
+/// max_free_bytes of released blocks are kept for reuse, the others are given back to the heap.
+class BufferPool : public std::pmr::memory_resource {
+public:
+    /// The smallest pooled block size, i.e. the size of the incoming buffer while reading small requests.
+    static constexpr std::size_t kMinBlockSize{kHttpIncomingBufferSize};
+
+    /// The largest pooled block size, i.e. the size of the incoming buffer while reading large requests.
+    static constexpr std::size_t kMaxBlockSize{kHttpIncomingBufferMaxSize};
+
+    /// The default memory budget of the free blocks.
+    static constexpr std::size_t kDefaultMaxFreeBytes{4 * 1024 * 1024};
+
+    /// A block borrowed from the pool, given back on destruction.
+    class Buffer {
+    public:
+        Buffer() = default;
+        Buffer(BufferPool* pool, std::size_t size) : pool_{pool}, data_{static_cast<char*>(pool->allocate(size))}, size_{size} {}
+        Buffer(Buffer&& other) noexcept
+            : pool_{std::exchange(other.pool_, nullptr)}, data_{std::exchange(other.data_, nullptr)}, size_{std::exchange(other.size_, 0)} {}
+        Buffer& operator=(Buffer&& other) noexcept {
+            std::swap(pool_, other.pool_);
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            return *this;
+        }
+        ~Buffer() {
+            if (data_ != nullptr) {
+                pool_->deallocate(data_, size_);
+            }
+        }
+
+        char* data() const noexcept { return data_; }
+        std::size_t size() const noexcept { return size_; }
+
+    private:
+        BufferPool* pool_{nullptr};
+        char* data_{nullptr};
+        std::size_t size_{0};
+    };
+
+    explicit BufferPool(std::size_t max_free_bytes = kDefaultMaxFreeBytes) : max_free_bytes_{max_free_bytes} {}
+    ~BufferPool() override;
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /// Borrow a buffer of the specified size rounded up to its size class.
+    Buffer acquire(std::size_t size) { return Buffer{this, block_size(size)}; }
+
+    /// The total size of the free blocks kept for reuse.
+    std::size_t free_bytes() const;
+
+    /// The total size of the pooled blocks currently borrowed.
+    std::size_t used_bytes() const;
+
+    /// Return the size class of the specified size, or the size itself if too large to be pooled.
+    static std::size_t block_size(std::size_t size) noexcept;
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    static constexpr std::size_t kNumSizeClasses{5};
+    static_assert((kMinBlockSize << (kNumSizeClasses - 1)) == kMaxBlockSize);
+
+    static std::size_t size_class(std::size_t block_size) noexcept;
+
+    mutable std::mutex mutex_;
+    std::array<std::vector<void*>, kNumSizeClasses> free_blocks_;
+    std::size_t free_bytes_{0};
+    std::size_t used_bytes_{0};
+    std::size_t max_free_bytes_;
+};
+
+} // namespace silkrpc::http
+
+#endif // SILKRPC_HTTP_BUFFER_POOL_HPP_
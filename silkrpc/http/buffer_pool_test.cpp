@@ -0,0 +1,99 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "buffer_pool.hpp"
+
+#include <memory_resource>
+#include <string>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc::http {
+
+TEST_CASE("BufferPool::block_size", "[silkrpc][http][buffer_pool]") {
+    CHECK(BufferPool::block_size(0) == BufferPool::kMinBlockSize);
+    CHECK(BufferPool::block_size(1) == BufferPool::kMinBlockSize);
+    CHECK(BufferPool::block_size(BufferPool::kMinBlockSize) == BufferPool::kMinBlockSize);
+    CHECK(BufferPool::block_size(BufferPool::kMinBlockSize + 1) == 2 * BufferPool::kMinBlockSize);
+    CHECK(BufferPool::block_size(BufferPool::kMaxBlockSize) == BufferPool::kMaxBlockSize);
+    CHECK(BufferPool::block_size(BufferPool::kMaxBlockSize + 1) == BufferPool::kMaxBlockSize + 1);
+}
+
+TEST_CASE("BufferPool::acquire", "[silkrpc][http][buffer_pool]") {
+    BufferPool pool;
+
+    SECTION("buffer given back on destruction") {
+        char* data{nullptr};
+        {
+            auto buffer = pool.acquire(100);
+            CHECK(buffer.size() == BufferPool::kMinBlockSize);
+            CHECK(pool.used_bytes() == BufferPool::kMinBlockSize);
+            CHECK(pool.free_bytes() == 0);
+            data = buffer.data();
+        }
+        CHECK(pool.used_bytes() == 0);
+        CHECK(pool.free_bytes() == BufferPool::kMinBlockSize);
+        auto buffer = pool.acquire(BufferPool::kMinBlockSize);
+        CHECK(buffer.data() == data);
+        CHECK(pool.free_bytes() == 0);
+    }
+
+    SECTION("size classes kept apart") {
+        { auto buffer = pool.acquire(BufferPool::kMinBlockSize); }
+        auto buffer = pool.acquire(3 * BufferPool::kMinBlockSize);
+        CHECK(buffer.size() == 4 * BufferPool::kMinBlockSize);
+        CHECK(pool.free_bytes() == BufferPool::kMinBlockSize);
+    }
+
+    SECTION("moved buffer") {
+        auto buffer1 = pool.acquire(1);
+        auto buffer2 = std::move(buffer1);
+        CHECK(buffer1.data() == nullptr);
+        CHECK(buffer2.data() != nullptr);
+        buffer1 = std::move(buffer2);
+        CHECK(buffer1.data() != nullptr);
+        CHECK(pool.used_bytes() == BufferPool::kMinBlockSize);
+    }
+
+    SECTION("too large to be pooled") {
+        { auto buffer = pool.acquire(BufferPool::kMaxBlockSize + 1); }
+        CHECK(pool.used_bytes() == 0);
+        CHECK(pool.free_bytes() == 0);
+    }
+}
+
+TEST_CASE("BufferPool max free bytes", "[silkrpc][http][buffer_pool]") {
+    BufferPool pool{BufferPool::kMinBlockSize};
+    {
+        auto buffer1 = pool.acquire(1);
+        auto buffer2 = pool.acquire(1);
+    }
+    CHECK(pool.free_bytes() == BufferPool::kMinBlockSize);
+}
+
+TEST_CASE("BufferPool as memory resource", "[silkrpc][http][buffer_pool]") {
+    BufferPool pool;
+    {
+        std::pmr::monotonic_buffer_resource arena{BufferPool::kMinBlockSize, &pool};
+        std::pmr::string s{std::string(BufferPool::kMinBlockSize / 2, 'x'), &arena};
+        CHECK(pool.used_bytes() >= BufferPool::kMinBlockSize);
+        arena.release();
+        CHECK(pool.used_bytes() == 0);
+    }
+    CHECK(pool.free_bytes() > 0);
+}
+
+} // namespace silkrpc::http
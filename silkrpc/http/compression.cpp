@@ -0,0 +1,185 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "compression.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <optional>
+#include <stdexcept>
+
+#include <zlib.h>
+
+namespace silkrpc::http {
+
+namespace {
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+bool iequals(std::string_view lhs, std::string_view rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](char l, char r) {
+        return std::tolower(static_cast<unsigned char>(l)) == std::tolower(static_cast<unsigned char>(r));
+    });
+}
+
+//! Parse the quality value of one Accept or Accept-Encoding element (e.g. "gzip;q=0.5"), 1 when missing
+double parse_quality(std::string_view parameters) {
+    while (!parameters.empty()) {
+        const auto separator = parameters.find(';');
+        const auto parameter = trim(parameters.substr(0, separator));
+        if (parameter.size() > 2 && (parameter[0] == 'q' || parameter[0] == 'Q') && parameter[1] == '=') {
+            const std::string value{parameter.substr(2)};
+            return std::strtod(value.c_str(), nullptr);
+        }
+        if (separator == std::string_view::npos) {
+            break;
+        }
+        parameters.remove_prefix(separator + 1);
+    }
+    return 1.0;
+}
+
+} // namespace
+
+std::string_view to_string(ContentEncoding encoding) {
+    switch (encoding) {
+        case ContentEncoding::gzip: return "gzip";
+        case ContentEncoding::deflate: return "deflate";
+        default: return "identity";
+    }
+}
+
+ContentEncoding negotiate_content_encoding(std::string_view accept_encoding) {
+    std::optional<double> gzip_quality, deflate_quality, any_quality;
+    while (!accept_encoding.empty()) {
+        const auto separator = accept_encoding.find(',');
+        const auto element = accept_encoding.substr(0, separator);
+        const auto parameters_start = element.find(';');
+        const auto coding = trim(element.substr(0, parameters_start));
+        const auto quality = parameters_start == std::string_view::npos ? 1.0 : parse_quality(element.substr(parameters_start + 1));
+        if (iequals(coding, "gzip") || iequals(coding, "x-gzip")) {
+            gzip_quality = quality;
+        } else if (iequals(coding, "deflate")) {
+            deflate_quality = quality;
+        } else if (coding == "*") {
+            any_quality = quality;
+        }
+        if (separator == std::string_view::npos) {
+            break;
+        }
+        accept_encoding.remove_prefix(separator + 1);
+    }
+    // The wildcard matches any coding not explicitly listed
+    const auto gzip = gzip_quality.value_or(any_quality.value_or(0));
+    const auto deflate = deflate_quality.value_or(any_quality.value_or(0));
+    if (gzip > 0 && gzip >= deflate) {
+        return ContentEncoding::gzip;
+    }
+    if (deflate > 0) {
+        return ContentEncoding::deflate;
+    }
+    return ContentEncoding::identity;
+}
+
+std::string_view to_string(ContentType type) {
+    switch (type) {
+        case ContentType::cbor: return "application/cbor";
+        default: return "application/json";
+    }
+}
+
+ContentType negotiate_content_type(std::string_view accept) {
+    std::optional<double> json_quality, cbor_quality;
+    while (!accept.empty()) {
+        const auto separator = accept.find(',');
+        const auto element = accept.substr(0, separator);
+        const auto parameters_start = element.find(';');
+        const auto media_range = trim(element.substr(0, parameters_start));
+        const auto quality = parameters_start == std::string_view::npos ? 1.0 : parse_quality(element.substr(parameters_start + 1));
+        if (iequals(media_range, "application/cbor")) {
+            cbor_quality = quality;
+        } else if (iequals(media_range, "application/json")) {
+            json_quality = quality;
+        }
+        if (separator == std::string_view::npos) {
+            break;
+        }
+        accept.remove_prefix(separator + 1);
+    }
+    if (cbor_quality && *cbor_quality > 0 && *cbor_quality >= json_quality.value_or(0)) {
+        return ContentType::cbor;
+    }
+    return ContentType::json;
+}
+
+std::string compress(const std::vector<std::string_view>& parts, ContentEncoding encoding, uint32_t level) {
+    if (encoding == ContentEncoding::identity) {
+        throw std::runtime_error{"compress: identity is not a compression coding"};
+    }
+
+    // Window bits 15 gives the zlib format used by HTTP deflate coding, adding 16 gives the gzip format
+    const int window_bits = encoding == ContentEncoding::gzip ? 15 + 16 : 15;
+    z_stream stream{};
+    if (deflateInit2(&stream, static_cast<int>(level), Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error{"compress: deflateInit2 failed"};
+    }
+
+    std::size_t input_size{0};
+    for (const auto& part : parts) {
+        input_size += part.size();
+    }
+    std::string output;
+    output.resize(deflateBound(&stream, static_cast<uLong>(input_size)));
+    stream.next_out = reinterpret_cast<Bytef*>(output.data());
+    stream.avail_out = static_cast<uInt>(output.size());
+
+    int result{Z_OK};
+    for (std::size_t i{0}; i <= parts.size() && result != Z_STREAM_END; ++i) {
+        const bool last = i == parts.size();
+        if (!last) {
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(parts[i].data()));
+            stream.avail_in = static_cast<uInt>(parts[i].size());
+        }
+        do {
+            if (stream.avail_out == 0) {
+                const auto produced = output.size();
+                output.resize(2 * produced);
+                stream.next_out = reinterpret_cast<Bytef*>(output.data() + produced);
+                stream.avail_out = static_cast<uInt>(output.size() - produced);
+            }
+            result = deflate(&stream, last ? Z_FINISH : Z_NO_FLUSH);
+            if (result == Z_STREAM_ERROR) {
+                deflateEnd(&stream);
+                throw std::runtime_error{"compress: deflate failed"};
+            }
+        } while (stream.avail_in > 0 || (last && result != Z_STREAM_END));
+    }
+    output.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    return output;
+}
+
+} // namespace silkrpc::http
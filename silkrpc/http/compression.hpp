@@ -0,0 +1,71 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_HTTP_COMPRESSION_HPP_
+#define SILKRPC_HTTP_COMPRESSION_HPP_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <silkrpc/common/constants.hpp>
+
+namespace silkrpc::http {
+
+/// The content codings supported for HTTP replies.
+enum class ContentEncoding {
+    identity,
+    gzip,
+    deflate
+};
+
+/// The content types supported for JSON RPC replies.
+enum class ContentType {
+    json,
+    cbor
+};
+
+/// The settings of HTTP reply compression.
+struct CompressionSettings {
+    /// The zlib compression level in [1, 9], zero means compression disabled.
+    uint32_t level{kDefaultHttpCompressionLevel};
+
+    /// The minimum content size in bytes for a reply to be compressed.
+    uint32_t min_size{kDefaultHttpCompressionMinSize};
+};
+
+/// Return the name of the specified content coding as used in HTTP headers.
+std::string_view to_string(ContentEncoding encoding);
+
+/// Choose the content coding for the reply given the value of Accept-Encoding request header, preferring gzip
+/// over deflate and honouring the quality values (i.e. q=0 means not acceptable).
+ContentEncoding negotiate_content_encoding(std::string_view accept_encoding);
+
+/// Return the MIME type of the specified content type as used in HTTP headers.
+std::string_view to_string(ContentType type);
+
+/// Choose the content type for the reply given the value of Accept request header: CBOR just when explicitly accepted
+/// with quality not lower than JSON, since any client accepts JSON (i.e. wildcards do not select CBOR).
+ContentType negotiate_content_type(std::string_view accept);
+
+/// Compress the concatenation of the specified parts using the given content coding and compression level.
+/// Throw std::runtime_error if compression fails.
+std::string compress(const std::vector<std::string_view>& parts, ContentEncoding encoding, uint32_t level);
+
+} // namespace silkrpc::http
+
+#endif // SILKRPC_HTTP_COMPRESSION_HPP_
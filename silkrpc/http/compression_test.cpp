@@ -0,0 +1,117 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "compression.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <zlib.h>
+
+namespace silkrpc::http {
+
+using Catch::Matchers::Message;
+
+// Decompress both zlib and gzip formats thanks to automatic header detection
+static std::string decompress(const std::string& input) {
+    z_stream stream{};
+    REQUIRE(inflateInit2(&stream, 15 + 32) == Z_OK);
+    std::string output(64 * 1024, '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_out = reinterpret_cast<Bytef*>(output.data());
+    stream.avail_out = static_cast<uInt>(output.size());
+    CHECK(inflate(&stream, Z_FINISH) == Z_STREAM_END);
+    output.resize(stream.total_out);
+    inflateEnd(&stream);
+    return output;
+}
+
+TEST_CASE("to_string", "[silkrpc][http][compression]") {
+    CHECK(to_string(ContentEncoding::identity) == "identity");
+    CHECK(to_string(ContentEncoding::gzip) == "gzip");
+    CHECK(to_string(ContentEncoding::deflate) == "deflate");
+    CHECK(to_string(ContentType::json) == "application/json");
+    CHECK(to_string(ContentType::cbor) == "application/cbor");
+}
+
+TEST_CASE("negotiate_content_encoding", "[silkrpc][http][compression]") {
+    CHECK(negotiate_content_encoding("") == ContentEncoding::identity);
+    CHECK(negotiate_content_encoding("identity") == ContentEncoding::identity);
+    CHECK(negotiate_content_encoding("br") == ContentEncoding::identity);
+    CHECK(negotiate_content_encoding("gzip") == ContentEncoding::gzip);
+    CHECK(negotiate_content_encoding("GZIP") == ContentEncoding::gzip);
+    CHECK(negotiate_content_encoding("x-gzip") == ContentEncoding::gzip);
+    CHECK(negotiate_content_encoding("deflate") == ContentEncoding::deflate);
+    CHECK(negotiate_content_encoding("gzip, deflate, br") == ContentEncoding::gzip);
+    CHECK(negotiate_content_encoding("deflate, gzip") == ContentEncoding::gzip);
+    CHECK(negotiate_content_encoding("gzip;q=0.5, deflate") == ContentEncoding::deflate);
+    CHECK(negotiate_content_encoding("gzip; q=0.8, deflate;q=0.9") == ContentEncoding::deflate);
+    CHECK(negotiate_content_encoding("gzip;q=0, deflate") == ContentEncoding::deflate);
+    CHECK(negotiate_content_encoding("gzip;q=0, deflate;q=0") == ContentEncoding::identity);
+    CHECK(negotiate_content_encoding("*") == ContentEncoding::gzip);
+    CHECK(negotiate_content_encoding("gzip;q=0, *") == ContentEncoding::deflate);
+    CHECK(negotiate_content_encoding("*;q=0") == ContentEncoding::identity);
+}
+
+TEST_CASE("negotiate_content_type", "[silkrpc][http][compression]") {
+    CHECK(negotiate_content_type("") == ContentType::json);
+    CHECK(negotiate_content_type("*/*") == ContentType::json);
+    CHECK(negotiate_content_type("application/json") == ContentType::json);
+    CHECK(negotiate_content_type("application/cbor") == ContentType::cbor);
+    CHECK(negotiate_content_type("Application/CBOR") == ContentType::cbor);
+    CHECK(negotiate_content_type("application/cbor, application/json") == ContentType::cbor);
+    CHECK(negotiate_content_type("application/json, application/cbor;q=0.5") == ContentType::json);
+    CHECK(negotiate_content_type("application/json;q=0.5, application/cbor") == ContentType::cbor);
+    CHECK(negotiate_content_type("application/cbor;q=0") == ContentType::json);
+    CHECK(negotiate_content_type("application/cbor;q=0.1, */*") == ContentType::cbor);
+}
+
+TEST_CASE("compress", "[silkrpc][http][compression]") {
+    std::string content;
+    for (int i{0}; i < 1000; ++i) {
+        content += "{\"jsonrpc\":\"2.0\",\"id\":" + std::to_string(i) + ",\"result\":\"0x0000000000000000\"}";
+    }
+
+    SECTION("gzip") {
+        const auto compressed = compress({content}, ContentEncoding::gzip, 6);
+        CHECK(compressed.size() < content.size());
+        CHECK(static_cast<uint8_t>(compressed[0]) == 0x1f);
+        CHECK(static_cast<uint8_t>(compressed[1]) == 0x8b);
+        CHECK(decompress(compressed) == content);
+    }
+    SECTION("deflate") {
+        const auto compressed = compress({content}, ContentEncoding::deflate, 1);
+        CHECK(compressed.size() < content.size());
+        CHECK(decompress(compressed) == content);
+    }
+    SECTION("multiple parts") {
+        const std::string_view view{content};
+        const auto compressed = compress({view.substr(0, 10), view.substr(10, 5000), view.substr(5010)}, ContentEncoding::gzip, 9);
+        CHECK(decompress(compressed) == content);
+    }
+    SECTION("empty content") {
+        const auto compressed = compress({}, ContentEncoding::gzip, 6);
+        CHECK(decompress(compressed).empty());
+    }
+    SECTION("identity") {
+        CHECK_THROWS_AS(compress({content}, ContentEncoding::identity, 6), std::runtime_error);
+    }
+}
+
+} // namespace silkrpc::http
@@ -22,25 +22,56 @@
 
 #include "connection.hpp"
 
+#include <algorithm>
+#include <array>
 #include <exception>
 #include <fstream>
 #include <system_error>
 #include <string_view>
+#include <tuple>
 #include <utility>
 #include <vector>
 
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/redirect_error.hpp>
 #include <boost/asio/write.hpp>
 #include <boost/asio/use_awaitable.hpp>
 #include <boost/system/error_code.hpp>
 
 #include <silkrpc/common/log.hpp>
+#include <silkrpc/common/usdt.hpp>
 #include <silkrpc/common/util.hpp>
 #include <silkrpc/ethdb/database.hpp>
 
 namespace silkrpc::http {
 
-Connection::Connection(Context& context, boost::asio::thread_pool& workers, commands::RpcApiTable& handler_table, std::optional<std::string> jwt_secret)
-        : socket_{*context.io_context()}, request_handler_{context, workers, socket_, handler_table, jwt_secret} {
+namespace {
+
+// Give back the memory grown by large requests and replies, so that it is not kept by idle connections
+void trim(Request& request, Reply& reply) {
+    if (request.content.capacity() > kConnectionMaxRetainedCapacity) {
+        request.content = std::string{};
+        request.content.reserve(kRequestContentInitialCapacity);
+    }
+    if (reply.content.capacity() > kConnectionMaxRetainedCapacity) {
+        reply.content = std::string{};
+    }
+}
+
+} // namespace
+
+Connection::Connection(Context& context, WorkerPool& workers, commands::RpcApiTable& handler_table, std::optional<std::string> jwt_secret,
+    uint32_t max_pipelined_requests, uint32_t max_batch_concurrency, CompressionSettings compression_settings,
+    ConnectionSettings connection_settings, std::shared_ptr<ConnectionManager> connection_manager)
+        : socket_{*context.io_context()},
+          buffer_pool_{context.buffer_pool() ? context.buffer_pool() : std::make_shared<BufferPool>()},
+          request_arena_{kRequestArenaInitialSize, buffer_pool_.get()},
+          request_handler_{context, workers, socket_, handler_table, jwt_secret, max_batch_concurrency, compression_settings,
+              &request_arena_},
+          tracer_{context.tracer()}, max_pipelined_requests_{max_pipelined_requests}, pipeline_event_{*context.io_context()},
+          connection_settings_{connection_settings}, connection_manager_{std::move(connection_manager)}, deadline_{*context.io_context()} {
     request_.content.reserve(kRequestContentInitialCapacity);
     request_.headers.reserve(kRequestHeadersInitialCapacity);
     request_.method.reserve(kRequestMethodInitialCapacity);
@@ -49,38 +80,92 @@ Connection::Connection(Context& context, boost::asio::thread_pool& workers, comm
 }
 
 Connection::~Connection() {
+    if (connection_manager_) {
+        connection_manager_->remove(this);
+    }
     socket_.close();
     SILKRPC_DEBUG << "Connection::~Connection socket " << &socket_ << " deleted\n";
 }
 
 boost::asio::awaitable<void> Connection::start() {
-    co_await do_read();
+    if (connection_manager_) {
+        // The idle connection chosen to make room may belong to another context, so closing it runs on its own executor
+        auto close_idle = [weak_self = weak_from_this(), executor = socket_.get_executor()]() {
+            boost::asio::post(executor, [weak_self]() {
+                if (const auto self = weak_self.lock()) {
+                    SILKRPC_DEBUG << "Connection::start socket " << &self->socket_ << " idle closed to make room\n";
+                    self->close();
+                }
+            });
+        };
+        if (!connection_manager_->add(this, std::move(close_idle))) {
+            SILKRPC_WARN << "Connection::start connection refused: max number of connections reached\n";
+            close();
+            co_return;
+        }
+    }
+#ifdef SILKRPC_HAS_NGHTTP2
+    const bool http2 = co_await starts_with_http2_preface();
+    if (!socket_.is_open()) {
+        co_return; // closed while idle
+    }
+    if (http2) {
+        co_await do_http2();
+        co_return;
+    }
+#endif
+    if (max_pipelined_requests_ > 1) {
+        co_await do_pipelined_read();
+    } else {
+        co_await do_read();
+    }
 }
 
 boost::asio::awaitable<void> Connection::do_read() {
     try {
-        SILKRPC_DEBUG << "Connection::do_read going to read...\n" << std::flush;
-        std::size_t bytes_read = co_await socket_.async_read_some(boost::asio::buffer(buffer_), boost::asio::use_awaitable);
-        SILKRPC_DEBUG << "Connection::do_read bytes_read: " << bytes_read << "\n";
-        SILKRPC_TRACE << "Connection::do_read buffer: " << std::string_view{static_cast<const char*>(buffer_.data()), bytes_read} << "\n";
-
-        RequestParser::ResultType result = request_parser_.parse(request_, buffer_.data(), buffer_.data() + bytes_read);
-
-        if (result == RequestParser::good) {
-            co_await request_handler_.handle_request(request_);
-            clean();
-        } else if (result == RequestParser::bad) {
-            reply_ = Reply::stock_reply(StatusType::bad_request);
-            co_await do_write();
-            clean();
-        } else if (result == RequestParser::processing_continue) {
-            reply_ = Reply::stock_reply(StatusType::processing_continue);
-            co_await do_write();
-            reply_.reset();
-        }
-
-        // Read next chunck (result == RequestParser::indeterminate) or next request
-        co_await do_read();
+        // Loop instead of recursing for the next request, so that coroutine frames do not pile up on long-lived connections
+        while (!max_requests_reached()) {
+            SILKRPC_DEBUG << "Connection::do_read going to read...\n" << std::flush;
+            RequestParser::ResultType result;
+            {
+                BufferPool::Buffer buffer;
+                std::size_t bytes_read = co_await read_some(buffer);
+                SILKRPC_PROBE(http_read, this, bytes_read);
+                SILKRPC_DEBUG << "Connection::do_read bytes_read: " << bytes_read << "\n";
+                if (tracer_ && read_start_ == std::chrono::steady_clock::time_point{}) {
+                    read_start_ = std::chrono::steady_clock::now();
+                }
+                SILKRPC_TRACE << "Connection::do_read buffer: " << std::string_view{buffer.data(), bytes_read} << "\n";
+
+                // The parser copies the input into the request, so the buffer goes back to the pool right away
+                result = request_parser_.parse(request_, buffer.data(), buffer.data() + bytes_read);
+            }
+
+            if (result == RequestParser::indeterminate && request_parser_.is_parsing_content()) {
+                co_await read_content(request_);
+                result = RequestParser::good;
+            }
+
+            if (result == RequestParser::good) {
+                end_request_read();
+                ++num_requests_;
+                auto request_span = start_request_span(request_, read_start_);
+                co_await request_handler_.handle_request(request_, request_span.context());
+                request_span.end();
+                clean();
+            } else if (result == RequestParser::bad) {
+                end_request_read();
+                reply_ = Reply::stock_reply(StatusType::bad_request);
+                co_await do_write();
+                clean();
+            } else if (result == RequestParser::processing_continue) {
+                reply_ = Reply::stock_reply(StatusType::processing_continue);
+                co_await do_write();
+                reply_.reset();
+            }
+            // Read next chunck (result == RequestParser::indeterminate) or next request
+        }
+        close_gracefully();
     } catch (const boost::system::system_error& se) {
         if (se.code() == boost::asio::error::eof || se.code() == boost::asio::error::connection_reset || se.code() == boost::asio::error::broken_pipe) {
             SILKRPC_DEBUG << "Connection::do_read close from client with code: " << se.code() << "\n" << std::flush;
@@ -96,16 +181,441 @@ boost::asio::awaitable<void> Connection::do_read() {
     }
 }
 
+boost::asio::awaitable<std::size_t> Connection::read_some(BufferPool::Buffer& buffer) {
+    if (!request_in_progress_) {
+        if (connection_manager_) {
+            connection_manager_->set_idle(this);
+        }
+        arm_deadline(connection_settings_.idle_timeout);
+    }
+    co_await socket_.async_wait(boost::asio::socket_base::wait_read, boost::asio::use_awaitable);
+    if (!request_in_progress_) {
+        if (connection_manager_) {
+            connection_manager_->set_busy(this);
+        }
+        request_in_progress_ = true;
+        arm_deadline(connection_settings_.read_timeout);
+    }
+    buffer = buffer_pool_->acquire(read_buffer_size_);
+    const auto bytes_read = co_await socket_.async_read_some(boost::asio::buffer(buffer.data(), buffer.size()), boost::asio::use_awaitable);
+    if (bytes_read == buffer.size()) {
+        read_buffer_size_ = std::min(read_buffer_size_ * 2, BufferPool::kMaxBlockSize);
+    } else if (bytes_read <= read_buffer_size_ / 4) {
+        read_buffer_size_ = std::max(read_buffer_size_ / 2, BufferPool::kMinBlockSize);
+    }
+    co_return bytes_read;
+}
+
+boost::asio::awaitable<void> Connection::read_content(Request& request) {
+    // Read the missing content straight into the request buffer, skipping both the incoming buffer and the parser
+    while (const auto missing_size = RequestParser::missing_content_size(request)) {
+        const auto offset = request.content.size();
+        const auto read_size = std::min(missing_size, kRequestContentMaxPreallocatedSize);
+        request.content.resize(offset + read_size);
+        const auto bytes_read = co_await boost::asio::async_read(socket_,
+            boost::asio::buffer(request.content.data() + offset, read_size), boost::asio::use_awaitable);
+        SILKRPC_DEBUG << "Connection::read_content bytes_read: " << bytes_read << "\n";
+    }
+}
+
 boost::asio::awaitable<void> Connection::do_write() {
     SILKRPC_DEBUG << "Connection::do_write reply: " << reply_.content << "\n" << std::flush;
     const auto bytes_transferred = co_await boost::asio::async_write(socket_, reply_.to_buffers(), boost::asio::use_awaitable);
     SILKRPC_TRACE << "Connection::do_write bytes_transferred: " << bytes_transferred << "\n" << std::flush;
 }
 
+boost::asio::awaitable<void> Connection::do_pipelined_read() {
+    std::exception_ptr eptr;
+    try {
+        while (!max_requests_reached()) {
+            SILKRPC_DEBUG << "Connection::do_pipelined_read going to read...\n" << std::flush;
+            BufferPool::Buffer buffer;
+            std::size_t bytes_read = co_await read_some(buffer);
+            SILKRPC_DEBUG << "Connection::do_pipelined_read bytes_read: " << bytes_read << "\n";
+            SILKRPC_TRACE << "Connection::do_pipelined_read buffer: " << std::string_view{buffer.data(), bytes_read} << "\n";
+
+            // Parse all the requests contained in the input, a request can also start here and continue in next read
+            const char* begin = buffer.data();
+            const char* end = buffer.data() + bytes_read;
+            while (begin != end) {
+                if (!parsing_request_) {
+                    parsing_request_ = make_pipelined_request();
+                }
+                RequestParser::ResultType result;
+                std::tie(result, begin) = request_parser_.parse_prefix(parsing_request_->request, begin, end);
+
+                if (result == RequestParser::good) {
+                    start_pipelined_request();
+                    // Do not exceed the max number of requests in execution
+                    co_await write_pipelined_replies(max_pipelined_requests_ - 1);
+                    // The requests beyond the limit are left unanswered, so that the client retries them on another connection
+                    if (max_requests_reached()) {
+                        parsing_request_.reset();
+                        begin = end;
+                    }
+                } else if (result == RequestParser::bad) {
+                    co_await write_pipelined_replies(0);
+                    reply_ = Reply::stock_reply(StatusType::bad_request);
+                    co_await do_write();
+                    reply_.reset();
+                    parsing_request_.reset();
+                    request_parser_.reset();
+                    // Discard the remaining input as in non-pipelining mode
+                    begin = end;
+                } else if (result == RequestParser::processing_continue) {
+                    // Interim response must not overtake the replies to previous requests
+                    co_await write_pipelined_replies(0);
+                    reply_ = Reply::stock_reply(StatusType::processing_continue);
+                    co_await do_write();
+                    reply_.reset();
+                }
+            }
+            // All the input has been parsed, so the buffer is not needed while waiting for content or replies
+            buffer = {};
+
+            // Headers are done but some content is missing: no other request can come before the end of the content
+            if (parsing_request_ && request_parser_.is_parsing_content()) {
+                co_await read_content(parsing_request_->request);
+                start_pipelined_request();
+                co_await write_pipelined_replies(max_pipelined_requests_ - 1);
+            }
+            if (!parsing_request_) {
+                end_request_read();
+            }
+
+            // Write all pending replies unless some more input is already available to be parsed and executed
+            if (socket_.available() == 0) {
+                co_await write_pipelined_replies(0);
+                // No request in execution anymore, so temporaries can be dropped all at once
+                request_arena_.release();
+            }
+        }
+        co_await write_pipelined_replies(0);
+        close_gracefully();
+    } catch (...) {
+        eptr = std::current_exception();
+    }
+
+    // Nobody is left to read the replies when the client has gone, so the pending requests stop at their next check
+    if (eptr && !pipeline_.empty()) {
+        request_handler_.cancel_requests();
+    }
+
+    // Pending requests reference this connection, so wait for their completion anyway before leaving
+    for (const auto& pipelined_request : pipeline_) {
+        co_await wait_for_completion(*pipelined_request);
+    }
+    pipeline_.clear();
+
+    if (!eptr) {
+        co_return;
+    }
+    try {
+        std::rethrow_exception(eptr);
+    } catch (const boost::system::system_error& se) {
+        if (se.code() == boost::asio::error::eof || se.code() == boost::asio::error::connection_reset || se.code() == boost::asio::error::broken_pipe) {
+            SILKRPC_DEBUG << "Connection::do_pipelined_read close from client with code: " << se.code() << "\n" << std::flush;
+        } else if (se.code() != boost::asio::error::operation_aborted) {
+            SILKRPC_ERROR << "Connection::do_pipelined_read system_error: " << se.what() << "\n" << std::flush;
+            std::rethrow_exception(std::make_exception_ptr(se));
+        } else {
+            SILKRPC_DEBUG << "Connection::do_pipelined_read operation_aborted: " << se.what() << "\n" << std::flush;
+        }
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "Connection::do_pipelined_read exception: " << e.what() << "\n" << std::flush;
+        std::rethrow_exception(std::make_exception_ptr(e));
+    }
+}
+
+void Connection::start_pipelined_request() {
+    auto pipelined_request = std::move(parsing_request_);
+    request_parser_.reset();
+    pipeline_.push_back(pipelined_request);
+    ++num_requests_;
+
+    SILKRPC_DEBUG << "Connection::start_pipelined_request #pending: " << pipeline_.size() << "\n";
+    auto& request = pipelined_request->request;
+    auto& reply = pipelined_request->reply;
+    pipelined_request->span = start_request_span(request, pipelined_request->read_start);
+    const auto trace = pipelined_request->span.context();
+    boost::asio::co_spawn(socket_.get_executor(), request_handler_.build_reply(request, reply, /*allow_streaming=*/false, trace), [&, pipelined_request](std::exception_ptr eptr) {
+        if (eptr) {
+            try {
+                std::rethrow_exception(eptr);
+            } catch (const std::exception& e) {
+                SILKRPC_ERROR << "Connection::start_pipelined_request exception: " << e.what() << "\n";
+            }
+            pipelined_request->reply = Reply::stock_reply(StatusType::internal_server_error);
+        }
+        pipelined_request->completed = true;
+        pipeline_event_.cancel();
+    });
+}
+
+boost::asio::awaitable<void> Connection::write_pipelined_replies(std::size_t max_pending) {
+    while (pipeline_.size() > max_pending) {
+        // Replies must be written in request order, so always wait for the oldest one
+        auto pipelined_request = pipeline_.front();
+        co_await wait_for_completion(*pipelined_request);
+        co_await request_handler_.do_write(pipelined_request->reply, pipelined_request->span.context());
+        pipelined_request->span.end();
+        pipeline_.pop_front();
+        // Recycle the request unless still referenced elsewhere (i.e. by the completion handler)
+        if (pipelined_request.use_count() == 1 && free_pipelined_requests_.size() < max_pipelined_requests_) {
+            pipelined_request->request.reset();
+            pipelined_request->reply.reset();
+            trim(pipelined_request->request, pipelined_request->reply);
+            pipelined_request->completed = false;
+            free_pipelined_requests_.push_back(std::move(pipelined_request));
+        }
+    }
+}
+
+std::shared_ptr<Connection::PipelinedRequest> Connection::make_pipelined_request() {
+    std::shared_ptr<PipelinedRequest> pipelined_request;
+    if (free_pipelined_requests_.empty()) {
+        pipelined_request = std::make_shared<PipelinedRequest>();
+    } else {
+        pipelined_request = std::move(free_pipelined_requests_.back());
+        free_pipelined_requests_.pop_back();
+    }
+    // The request starts within the input just read, so the read time is a close approximation
+    if (tracer_) {
+        pipelined_request->read_start = std::chrono::steady_clock::now();
+    }
+    return pipelined_request;
+}
+
+#ifdef SILKRPC_HAS_NGHTTP2
+boost::asio::awaitable<bool> Connection::starts_with_http2_preface() {
+    if (connection_manager_) {
+        connection_manager_->set_idle(this);
+    }
+    arm_deadline(connection_settings_.idle_timeout);
+    boost::system::error_code ec;
+    co_await socket_.async_wait(boost::asio::socket_base::wait_read, boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+    if (ec) {
+        co_return false;
+    }
+    // Peek at the input, so that HTTP/1.x requests are parsed as usual and HTTP/2 preface is checked by the session
+    std::array<char, Http2Session::kClientPreface.size()> preface{};
+    const auto bytes_peeked = socket_.receive(boost::asio::buffer(preface), boost::asio::socket_base::message_peek, ec);
+    co_return !ec && Http2Session::starts_with_preface({preface.data(), bytes_peeked});
+}
+
+boost::asio::awaitable<void> Connection::do_http2() {
+    SILKRPC_DEBUG << "Connection::do_http2 socket " << &socket_ << " serving HTTP/2\n";
+    Http2Session session{kHttp2MaxConcurrentStreams, [&](std::shared_ptr<Http2Stream> stream) {
+        start_http2_request(session, std::move(stream));
+    }};
+
+    // Replies must be written as soon as built, even while the next frames are awaited
+    bool reading{true};
+    bool writer_done{false};
+    boost::asio::co_spawn(socket_.get_executor(), write_http2(session, reading), [&](std::exception_ptr eptr) {
+        if (eptr) {
+            try {
+                std::rethrow_exception(eptr);
+            } catch (const std::exception& e) {
+                SILKRPC_DEBUG << "Connection::do_http2 write exception: " << e.what() << "\n";
+            }
+            close();
+        }
+        writer_done = true;
+        pipeline_event_.cancel();
+    });
+
+    std::exception_ptr eptr;
+    try {
+        bool shutting_down{false};
+        while (session.want_read()) {
+            BufferPool::Buffer buffer;
+            std::size_t bytes_read = co_await read_some(buffer);
+            SILKRPC_DEBUG << "Connection::do_http2 bytes_read: " << bytes_read << "\n";
+            session.receive(buffer.data(), bytes_read);
+            // The streams beyond the limit are refused, so that the client retries them on another connection
+            if (max_requests_reached() && !shutting_down) {
+                session.shutdown();
+                shutting_down = true;
+            }
+            update_http2_state(session);
+            pipeline_event_.cancel();
+        }
+    } catch (...) {
+        eptr = std::current_exception();
+    }
+    reading = false;
+
+    // Nobody is left to read the replies when the client has gone, so the pending requests stop at their next check
+    if (eptr && session.num_pending() > 0) {
+        request_handler_.cancel_requests();
+    }
+
+    // Pending requests and the writer reference the session, so wait for their completion anyway before leaving
+    pipeline_event_.cancel();
+    while (!writer_done || session.num_pending() > 0) {
+        pipeline_event_.expires_at(boost::asio::steady_timer::time_point::max());
+        boost::system::error_code ec;
+        co_await pipeline_event_.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+    }
+    close_gracefully();
+
+    if (!eptr) {
+        co_return;
+    }
+    try {
+        std::rethrow_exception(eptr);
+    } catch (const boost::system::system_error& se) {
+        if (se.code() == boost::asio::error::eof || se.code() == boost::asio::error::connection_reset || se.code() == boost::asio::error::broken_pipe) {
+            SILKRPC_DEBUG << "Connection::do_http2 close from client with code: " << se.code() << "\n" << std::flush;
+        } else if (se.code() != boost::asio::error::operation_aborted) {
+            SILKRPC_ERROR << "Connection::do_http2 system_error: " << se.what() << "\n" << std::flush;
+            std::rethrow_exception(std::make_exception_ptr(se));
+        } else {
+            SILKRPC_DEBUG << "Connection::do_http2 operation_aborted: " << se.what() << "\n" << std::flush;
+        }
+    } catch (const std::exception& e) {
+        // The client has broken the protocol, the GOAWAY frame telling it has already been sent by the writer
+        SILKRPC_WARN << "Connection::do_http2 exception: " << e.what() << "\n" << std::flush;
+    }
+}
+
+boost::asio::awaitable<void> Connection::write_http2(Http2Session& session, const bool& reading) {
+    std::string output;
+    while (true) {
+        output.clear();
+        if (session.send(output, kHttp2MaxWriteSize)) {
+            const auto bytes_transferred = co_await boost::asio::async_write(socket_, boost::asio::buffer(output), boost::asio::use_awaitable);
+            SILKRPC_TRACE << "Connection::write_http2 bytes_transferred: " << bytes_transferred << "\n" << std::flush;
+            continue;
+        }
+        if (session.num_pending() == 0) {
+            if (!reading) {
+                co_return;
+            }
+            // Session over (e.g. after GOAWAY) while the reader is still waiting for input: stop it
+            if (!session.want_read() && !session.want_write()) {
+                close_gracefully();
+                co_return;
+            }
+        }
+        pipeline_event_.expires_at(boost::asio::steady_timer::time_point::max());
+        boost::system::error_code ec;
+        co_await pipeline_event_.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+    }
+}
+
+void Connection::start_http2_request(Http2Session& session, std::shared_ptr<Http2Stream> stream) {
+    ++num_requests_;
+    SILKRPC_DEBUG << "Connection::start_http2_request stream " << stream->id << " #pending: " << session.num_pending() << "\n";
+    auto& request = stream->request;
+    auto& reply = stream->reply;
+    // The request has been received within the input just read, so the read time is a close approximation
+    auto span = std::make_shared<TraceSpan>(start_request_span(request, tracer_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{}));
+    const auto trace = span->context();
+    boost::asio::co_spawn(socket_.get_executor(), request_handler_.build_reply(request, reply, /*allow_streaming=*/false, trace),
+        [&, stream, span](std::exception_ptr eptr) {
+        if (eptr) {
+            try {
+                std::rethrow_exception(eptr);
+            } catch (const std::exception& e) {
+                SILKRPC_ERROR << "Connection::start_http2_request exception: " << e.what() << "\n";
+            }
+            stream->reply = Reply::stock_reply(StatusType::internal_server_error);
+        }
+        span->end();
+        session.submit_reply(stream);
+        update_http2_state(session);
+        pipeline_event_.cancel();
+    });
+}
+
+void Connection::update_http2_state(const Http2Session& session) {
+    if (session.num_pending() > 0) {
+        // Requests in execution: neither idle nor reading some request, whatever the input
+        if (connection_manager_) {
+            connection_manager_->set_busy(this);
+        }
+        request_in_progress_ = true;
+        arm_deadline(std::chrono::milliseconds{0});
+        return;
+    }
+    // No request in execution anymore, so temporaries can be dropped all at once
+    request_arena_.release();
+    request_in_progress_ = false;
+    if (connection_manager_) {
+        connection_manager_->set_idle(this);
+    }
+    arm_deadline(connection_settings_.idle_timeout);
+}
+#endif
+
+TraceSpan Connection::start_request_span(const Request& request, std::chrono::steady_clock::time_point read_start) {
+    if (!tracer_) {
+        return {};
+    }
+    TraceSpan request_span{tracer_->start_trace(), "http.request", read_start};
+    TraceSpan read_span{request_span.context(), "http.read", read_start};
+    read_span.set_attribute("bytes", request.content.size());
+    return request_span;
+}
+
+boost::asio::awaitable<void> Connection::wait_for_completion(const PipelinedRequest& pipelined_request) {
+    // All requests run on the connection executor, so no completion can happen between the check and the wait
+    while (!pipelined_request.completed) {
+        pipeline_event_.expires_at(boost::asio::steady_timer::time_point::max());
+        boost::system::error_code ec;
+        co_await pipeline_event_.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+    }
+}
+
+bool Connection::max_requests_reached() const {
+    return connection_settings_.max_requests > 0 && num_requests_ >= connection_settings_.max_requests;
+}
+
+void Connection::end_request_read() {
+    request_in_progress_ = false;
+    arm_deadline(std::chrono::milliseconds{0});
+}
+
+void Connection::arm_deadline(std::chrono::milliseconds timeout) {
+    if (timeout.count() == 0) {
+        // Moving the expiry cancels the pending wait and makes any expiration already completed look outdated
+        if (deadline_.expiry() != boost::asio::steady_timer::time_point::max()) {
+            deadline_.expires_at(boost::asio::steady_timer::time_point::max());
+        }
+        return;
+    }
+    deadline_.expires_after(timeout);
+    deadline_.async_wait([weak_self = weak_from_this()](const boost::system::error_code& ec) {
+        const auto self = weak_self.lock();
+        if (ec || !self || self->deadline_.expiry() > boost::asio::steady_timer::clock_type::now()) {
+            return;
+        }
+        SILKRPC_DEBUG << "Connection::arm_deadline socket " << &self->socket_ << " timed out\n";
+        self->close();
+    });
+}
+
+void Connection::close() {
+    boost::system::error_code ec;
+    socket_.close(ec);
+}
+
+void Connection::close_gracefully() {
+    SILKRPC_DEBUG << "Connection::close_gracefully socket " << &socket_ << " served " << num_requests_ << " requests\n";
+    boost::system::error_code ec;
+    socket_.shutdown(boost::asio::socket_base::shutdown_send, ec);
+    socket_.close(ec);
+}
+
 void Connection::clean() {
     request_.reset();
     request_parser_.reset();
     reply_.reset();
+    trim(request_, reply_);
+    request_arena_.release();
+    read_start_ = {};
 }
 
 } // namespace silkrpc::http
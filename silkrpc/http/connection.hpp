@@ -23,18 +23,31 @@
 #ifndef SILKRPC_HTTP_CONNECTION_HPP_
 #define SILKRPC_HTTP_CONNECTION_HPP_
 
-#include <array>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <vector>
 
 #include <silkrpc/config.hpp>
 
 #include <boost/asio/awaitable.hpp>
-#include <boost/asio/ip/tcp.hpp>
-#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
+#include <boost/asio/steady_timer.hpp>
 
 #include <silkrpc/commands/rpc_api_table.hpp>
 #include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/tracing.hpp>
 #include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/concurrency/worker_pool.hpp>
+#include <silkrpc/http/buffer_pool.hpp>
+#include <silkrpc/http/compression.hpp>
+#include <silkrpc/http/connection_manager.hpp>
+#ifdef SILKRPC_HAS_NGHTTP2
+#include <silkrpc/http/http2_session.hpp>
+#endif
 #include <silkrpc/http/reply.hpp>
 #include <silkrpc/http/request.hpp>
 #include <silkrpc/http/request_handler.hpp>
@@ -43,17 +56,30 @@
 namespace silkrpc::http {
 
 /// Represents a single connection from a client.
-class Connection {
+class Connection : public std::enable_shared_from_this<Connection> {
 public:
     Connection(const Connection&) = delete;
     Connection& operator=(const Connection&) = delete;
 
     /// Construct a connection running within the given execution context.
-    Connection(Context& context, boost::asio::thread_pool& workers, commands::RpcApiTable& handler_table, std::optional<std::string> jwt_secret);
+    /// When max_pipelined_requests is greater than 1, pipelined requests already received are executed concurrently
+    /// up to such limit and their replies are written back in request order (HTTP/1.1 pipelining). Stream handlers
+    /// writing directly on the socket are not used in pipelining mode, where methods fall back to their other handlers.
+    /// The elements of JSON RPC batch requests are executed concurrently up to max_batch_concurrency.
+    /// Replies are compressed according to compression_settings when accepted by the client.
+    /// The connection is closed when idle or reading a request for too long or after serving too many requests according
+    /// to connection_settings, and it is registered into connection_manager (if any) to enforce the max number of connections.
+    /// The timeouts apply only to connections owned by std::shared_ptr.
+    /// When built with nghttp2, connections starting with the HTTP/2 preface are served as HTTP/2 in cleartext (h2c), executing
+    /// the requests received on different streams concurrently.
+    Connection(Context& context, WorkerPool& workers, commands::RpcApiTable& handler_table, std::optional<std::string> jwt_secret,
+        uint32_t max_pipelined_requests = kDefaultMaxPipelinedRequests, uint32_t max_batch_concurrency = kDefaultMaxBatchConcurrency,
+        CompressionSettings compression_settings = {}, ConnectionSettings connection_settings = {},
+        std::shared_ptr<ConnectionManager> connection_manager = nullptr);
 
     ~Connection();
 
-    boost::asio::ip::tcp::socket& socket() { return socket_; }
+    boost::asio::generic::stream_protocol::socket& socket() { return socket_; }
 
     /// Start the first asynchronous operation for the connection.
     boost::asio::awaitable<void> start();
@@ -65,26 +91,136 @@ private:
     /// Perform an asynchronous read operation.
     boost::asio::awaitable<void> do_read();
 
+    /// Wait for some input, then read it into a buffer borrowed from the pool just for parsing, so that idle connections
+    /// hold no buffer. The buffer size grows while reads fill it up (i.e. for large requests) and shrinks back afterwards.
+    boost::asio::awaitable<std::size_t> read_some(BufferPool::Buffer& buffer);
+
+    /// Whether the max number of requests has been served.
+    bool max_requests_reached() const;
+
+    /// Mark the request being read as fully received, stopping its read timeout.
+    void end_request_read();
+
+    /// Close the connection when the timeout expires, replacing any previous one (zero means no timeout).
+    void arm_deadline(std::chrono::milliseconds timeout);
+
+    /// Close the socket, aborting any pending operation.
+    void close();
+
+    /// Close the socket after signalling the end of the replies to the client.
+    void close_gracefully();
+
+    /// Read the remaining content of the request being parsed, whose Content-Length is already known.
+    boost::asio::awaitable<void> read_content(Request& request);
+
     /// Perform an asynchronous write operation.
     boost::asio::awaitable<void> do_write();
 
-    /// Socket for the connection.
-    boost::asio::ip::tcp::socket socket_;
+    /// Perform asynchronous read operations parsing and executing pipelined requests.
+    boost::asio::awaitable<void> do_pipelined_read();
+
+    /// Start executing the request just parsed without waiting for its completion.
+    void start_pipelined_request();
+
+    /// Write the replies of the pending requests in order, waiting for execution if necessary, while more than max_pending remain.
+    boost::asio::awaitable<void> write_pipelined_replies(std::size_t max_pending);
+
+    /// A request received in pipelining mode together with its reply.
+    struct PipelinedRequest {
+        Request request;
+        Reply reply;
+        bool completed{false};
+        /// The time when the first bytes of the request have been read, just if tracing.
+        std::chrono::steady_clock::time_point read_start;
+        /// The span of the whole request, recording only if the request is sampled.
+        TraceSpan span;
+    };
+
+    /// Wait for the execution of the specified pipelined request to complete.
+    boost::asio::awaitable<void> wait_for_completion(const PipelinedRequest& pipelined_request);
+
+    /// Get a pipelined request ready to be parsed, recycling a previous one if possible.
+    std::shared_ptr<PipelinedRequest> make_pipelined_request();
+
+#ifdef SILKRPC_HAS_NGHTTP2
+    /// Wait for the first input and check if it is the HTTP/2 connection preface, leaving it unread.
+    boost::asio::awaitable<bool> starts_with_http2_preface();
+
+    /// Read the HTTP/2 frames feeding the session while the replies are written concurrently, until the session is over.
+    boost::asio::awaitable<void> do_http2();
+
+    /// Write the frames produced by the session whenever any, until the session is over or no more input is coming.
+    boost::asio::awaitable<void> write_http2(Http2Session& session, const bool& reading);
+
+    /// Start executing the request received on the stream without waiting for its completion.
+    void start_http2_request(Http2Session& session, std::shared_ptr<Http2Stream> stream);
+
+    /// Make the connection idle or busy depending on the requests in execution.
+    void update_http2_state(const Http2Session& session);
+#endif
+
+    /// Start the span of a request fully read, recording also its reading if sampled.
+    TraceSpan start_request_span(const Request& request, std::chrono::steady_clock::time_point read_start);
+
+    /// Socket for the connection, either TCP or Unix domain.
+    boost::asio::generic::stream_protocol::socket socket_;
+
+    /// The pool of the execution context lending the incoming buffers and the request arena blocks.
+    std::shared_ptr<BufferPool> buffer_pool_;
+
+    /// The size of the next incoming buffer borrowed from the pool.
+    std::size_t read_buffer_size_{BufferPool::kMinBlockSize};
+
+    /// The monotonic memory arena for per-request temporaries, giving its blocks back to the pool when no request is in progress.
+    std::pmr::monotonic_buffer_resource request_arena_;
 
     /// The handler used to process the incoming request.
     RequestHandler request_handler_;
 
-    /// Buffer for incoming data.
-    std::array<char, kHttpIncomingBufferSize> buffer_;
-
     /// The incoming request.
     Request request_;
 
     /// The parser for the incoming request.
     RequestParser request_parser_;
 
+    /// The time when the first bytes of the incoming request have been read, just if tracing.
+    std::chrono::steady_clock::time_point read_start_;
+
+    /// The tracer sampling the requests, if any.
+    std::shared_ptr<Tracer> tracer_;
+
     /// The reply to be sent back to the client.
     Reply reply_;
+
+    /// The maximum number of requests executing concurrently in pipelining mode.
+    uint32_t max_pipelined_requests_;
+
+    /// The requests received in pipelining mode waiting for their replies to be written, in arrival order.
+    std::deque<std::shared_ptr<PipelinedRequest>> pipeline_;
+
+    /// The request currently being parsed in pipelining mode.
+    std::shared_ptr<PipelinedRequest> parsing_request_;
+
+    /// The pipelined requests already completed ready to be reused, keeping their buffers allocated.
+    std::vector<std::shared_ptr<PipelinedRequest>> free_pipelined_requests_;
+
+    /// The timer used to signal the completion of any pipelined request (or HTTP/2 stream reply, or input).
+    boost::asio::steady_timer pipeline_event_;
+
+    /// The timeouts and the max number of requests of the connection.
+    ConnectionSettings connection_settings_;
+
+    /// The registry of the open connections, if any.
+    std::shared_ptr<ConnectionManager> connection_manager_;
+
+    /// The timer closing the connection when idle or reading a request for too long.
+    boost::asio::steady_timer deadline_;
+
+    /// Some request has started to arrive but has not been fully read yet.
+    bool request_in_progress_{false};
+
+    /// The number of requests received so far.
+    uint32_t num_requests_{0};
 };
 
 } // namespace silkrpc::http
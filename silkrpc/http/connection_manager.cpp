@@ -0,0 +1,106 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "connection_manager.hpp"
+
+#include <utility>
+
+namespace silkrpc::http {
+
+bool ConnectionManager::add(const void* connection, CloseCallback close) {
+    CloseCallback close_evicted;
+    {
+        std::scoped_lock lock{mutex_};
+        if (max_connections_ > 0 && entries_.size() - num_closing_ >= max_connections_) {
+            if (idle_.empty()) {
+                ++num_refused_;
+                return false;
+            }
+            // Closing happens asynchronously, so the evicted connection is still registered until removed
+            auto& evicted = entries_.at(idle_.front());
+            idle_.pop_front();
+            evicted.idle_position.reset();
+            evicted.closing = true;
+            close_evicted = evicted.close;
+            ++num_closing_;
+            ++num_evicted_;
+        }
+        entries_.insert_or_assign(connection, Entry{std::move(close)});
+    }
+    if (close_evicted) {
+        close_evicted();
+    }
+    return true;
+}
+
+void ConnectionManager::remove(const void* connection) {
+    std::scoped_lock lock{mutex_};
+    const auto it = entries_.find(connection);
+    if (it == entries_.end()) {
+        return;
+    }
+    if (it->second.idle_position) {
+        idle_.erase(*it->second.idle_position);
+    }
+    if (it->second.closing) {
+        --num_closing_;
+    }
+    entries_.erase(it);
+}
+
+void ConnectionManager::set_idle(const void* connection) {
+    std::scoped_lock lock{mutex_};
+    const auto it = entries_.find(connection);
+    if (it == entries_.end() || it->second.closing) {
+        return;
+    }
+    if (it->second.idle_position) {
+        idle_.erase(*it->second.idle_position);
+    }
+    it->second.idle_position = idle_.insert(idle_.end(), connection);
+}
+
+void ConnectionManager::set_busy(const void* connection) {
+    std::scoped_lock lock{mutex_};
+    const auto it = entries_.find(connection);
+    if (it == entries_.end() || !it->second.idle_position) {
+        return;
+    }
+    idle_.erase(*it->second.idle_position);
+    it->second.idle_position.reset();
+}
+
+std::size_t ConnectionManager::size() const {
+    std::scoped_lock lock{mutex_};
+    return entries_.size();
+}
+
+std::size_t ConnectionManager::idle_size() const {
+    std::scoped_lock lock{mutex_};
+    return idle_.size();
+}
+
+uint64_t ConnectionManager::num_evicted() const {
+    std::scoped_lock lock{mutex_};
+    return num_evicted_;
+}
+
+uint64_t ConnectionManager::num_refused() const {
+    std::scoped_lock lock{mutex_};
+    return num_refused_;
+}
+
+} // namespace silkrpc::http
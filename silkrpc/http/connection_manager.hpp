@@ -0,0 +1,104 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_HTTP_CONNECTION_MANAGER_HPP_
+#define SILKRPC_HTTP_CONNECTION_MANAGER_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace silkrpc::http {
+
+/// The settings limiting the lifetime of each HTTP connection, zero meaning no limit.
+struct ConnectionSettings {
+    /// The max time waiting for the next request on a keep-alive connection.
+    std::chrono::milliseconds idle_timeout{0};
+
+    /// The max time to receive a whole request (i.e. headers and content) once its first bytes have arrived.
+    std::chrono::milliseconds read_timeout{0};
+
+    /// The max number of requests served on each connection before closing it.
+    uint32_t max_requests{0};
+};
+
+/// The registry of the open HTTP connections, shared by the servers to enforce a max number of connections. When such
+/// limit is reached, the connection idle for the longest time is closed to make room for the new one, which is refused
+/// instead if every other connection is busy. Connections are identified by address and closed by their own callback,
+/// which must be safe to call from any thread. Thread-safe.
+class ConnectionManager {
+public:
+    /// The callback closing one connection.
+    using CloseCallback = std::function<void()>;
+
+    /// Construct the registry allowing the specified max number of connections, zero meaning no limit.
+    explicit ConnectionManager(uint32_t max_connections = 0) : max_connections_{max_connections} {}
+
+    ConnectionManager(const ConnectionManager&) = delete;
+    ConnectionManager& operator=(const ConnectionManager&) = delete;
+
+    /// Register the new connection, closing the least recently idle one if the limit is reached.
+    /// \return false if the limit is reached and no other connection is idle, so that the new one must be refused
+    bool add(const void* connection, CloseCallback close);
+
+    /// Unregister the connection, if registered.
+    void remove(const void* connection);
+
+    /// Mark the connection as idle, i.e. waiting for its next request.
+    void set_idle(const void* connection);
+
+    /// Mark the connection as busy, i.e. serving some request.
+    void set_busy(const void* connection);
+
+    /// The number of connections registered.
+    std::size_t size() const;
+
+    /// The number of connections registered and idle.
+    std::size_t idle_size() const;
+
+    /// The number of idle connections closed to make room for the new ones.
+    uint64_t num_evicted() const;
+
+    /// The number of new connections refused.
+    uint64_t num_refused() const;
+
+private:
+    struct Entry {
+        CloseCallback close;
+        std::optional<std::list<const void*>::iterator> idle_position;
+        bool closing{false};
+    };
+
+    uint32_t max_connections_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<const void*, Entry> entries_;
+    /// The idle connections, the least recently idle one first.
+    std::list<const void*> idle_;
+    /// The connections already asked to close, still registered until removed.
+    std::size_t num_closing_{0};
+    uint64_t num_evicted_{0};
+    uint64_t num_refused_{0};
+};
+
+} // namespace silkrpc::http
+
+#endif // SILKRPC_HTTP_CONNECTION_MANAGER_HPP_
@@ -0,0 +1,83 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "connection_manager.hpp"
+
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc::http {
+
+TEST_CASE("ConnectionManager without limit", "[silkrpc][http][connection_manager]") {
+    ConnectionManager manager;
+    int c1{0}, c2{0};
+    CHECK(manager.add(&c1, []() {}));
+    CHECK(manager.add(&c2, []() {}));
+    CHECK(manager.size() == 2);
+    manager.set_idle(&c1);
+    CHECK(manager.idle_size() == 1);
+    manager.set_busy(&c1);
+    CHECK(manager.idle_size() == 0);
+    manager.remove(&c1);
+    manager.remove(&c1);
+    CHECK(manager.size() == 1);
+}
+
+TEST_CASE("ConnectionManager with limit", "[silkrpc][http][connection_manager]") {
+    ConnectionManager manager{2};
+    std::vector<int> closed;
+    int c1{0}, c2{0}, c3{0}, c4{0};
+    REQUIRE(manager.add(&c1, [&]() { closed.push_back(1); }));
+    REQUIRE(manager.add(&c2, [&]() { closed.push_back(2); }));
+
+    SECTION("refused when all busy") {
+        CHECK(!manager.add(&c3, []() {}));
+        CHECK(manager.num_refused() == 1);
+        CHECK(manager.size() == 2);
+        CHECK(closed.empty());
+    }
+
+    SECTION("least recently idle evicted") {
+        manager.set_idle(&c2);
+        manager.set_idle(&c1);
+        CHECK(manager.add(&c3, []() {}));
+        CHECK(closed == std::vector<int>{2});
+        CHECK(manager.num_evicted() == 1);
+        CHECK(manager.idle_size() == 1);
+        // The evicted connection is still registered but does not count anymore
+        CHECK(manager.size() == 3);
+        manager.set_idle(&c2);
+        CHECK(manager.idle_size() == 1);
+        CHECK(manager.add(&c4, []() {}));
+        CHECK(closed == std::vector<int>{2, 1});
+        manager.remove(&c2);
+        manager.remove(&c1);
+        CHECK(manager.size() == 2);
+        CHECK(!manager.add(&c1, []() {}));
+    }
+
+    SECTION("idle again moves to the back") {
+        manager.set_idle(&c1);
+        manager.set_idle(&c2);
+        manager.set_busy(&c1);
+        manager.set_idle(&c1);
+        CHECK(manager.add(&c3, []() {}));
+        CHECK(closed == std::vector<int>{2});
+    }
+}
+
+} // namespace silkrpc::http
@@ -16,7 +16,6 @@
 
 #include "connection.hpp"
 
-#include <boost/asio/thread_pool.hpp>
 #include <catch2/catch.hpp>
 #include <grpcpp/grpcpp.h>
 
@@ -34,7 +33,7 @@ TEST_CASE("connection creation", "[silkrpc][http][connection]") {
     SECTION("field initialization") {
         ContextPool context_pool{1, create_channel};
         context_pool.start();
-        boost::asio::thread_pool workers;
+        WorkerPool workers{1};
         // Uncommenting the following lines you got stuck into llvm-cov problem:
         // error: cmd/unit_test: Failed to load coverage: Malformed coverage data
         /*
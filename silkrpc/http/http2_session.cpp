@@ -0,0 +1,271 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "http2_session.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <nghttp2/nghttp2.h>
+
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::http {
+
+namespace {
+
+// HTTP/2 names are lowercase, whereas the request handler expects HTTP/1.1 usual capitalization (e.g. Authorization)
+std::string canonical_header_name(std::string_view name) {
+    std::string canonical{name};
+    bool word_start{true};
+    for (auto& c : canonical) {
+        c = static_cast<char>(word_start ? std::toupper(static_cast<unsigned char>(c)) : c);
+        word_start = c == '-';
+    }
+    return canonical;
+}
+
+std::string lowercase_header_name(std::string_view name) {
+    std::string lowercase{name};
+    std::transform(lowercase.begin(), lowercase.end(), lowercase.begin(), [](unsigned char c) { return std::tolower(c); });
+    return lowercase;
+}
+
+// Connection-specific headers are forbidden in HTTP/2 (RFC 7540 8.1.2.2)
+bool is_connection_specific(std::string_view lowercase_name) {
+    return lowercase_name == "connection" || lowercase_name == "keep-alive" || lowercase_name == "proxy-connection" ||
+        lowercase_name == "transfer-encoding" || lowercase_name == "upgrade";
+}
+
+nghttp2_nv make_nv(const std::string& name, const std::string& value) {
+    return {
+        const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(name.data())),
+        const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(value.data())),
+        name.size(),
+        value.size(),
+        NGHTTP2_NV_FLAG_NONE
+    };
+}
+
+ssize_t read_reply_content(nghttp2_session* /*session*/, int32_t /*stream_id*/, uint8_t* buf, std::size_t length,
+                           uint32_t* data_flags, nghttp2_data_source* source, void* /*user_data*/) {
+    auto* stream = static_cast<Http2Stream*>(source->ptr);
+    const auto& reply = stream->reply;
+    std::size_t copied{0};
+    while (copied < length && stream->send_part <= reply.content_chunks.size()) {
+        const auto& part = stream->send_part == 0 ? reply.content : reply.content_chunks[stream->send_part - 1];
+        const auto size = std::min(length - copied, part.size() - stream->send_offset);
+        std::memcpy(buf + copied, part.data() + stream->send_offset, size);
+        copied += size;
+        stream->send_offset += size;
+        if (stream->send_offset == part.size()) {
+            ++stream->send_part;
+            stream->send_offset = 0;
+        }
+    }
+    if (stream->send_part > reply.content_chunks.size()) {
+        *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+    }
+    return static_cast<ssize_t>(copied);
+}
+
+} // namespace
+
+struct Http2SessionCallbacks {
+    static int on_begin_headers(nghttp2_session* /*session*/, const nghttp2_frame* frame, void* user_data) {
+        if (frame->hd.type != NGHTTP2_HEADERS || frame->headers.cat != NGHTTP2_HCAT_REQUEST) {
+            return 0;
+        }
+        auto* self = static_cast<Http2Session*>(user_data);
+        auto stream = std::make_shared<Http2Stream>();
+        stream->id = frame->hd.stream_id;
+        stream->request.http_version_major = 2;
+        stream->request.http_version_minor = 0;
+        stream->request.headers.reserve(kRequestHeadersInitialCapacity);
+        self->streams_.emplace(stream->id, std::move(stream));
+        return 0;
+    }
+
+    static int on_header(nghttp2_session* /*session*/, const nghttp2_frame* frame, const uint8_t* name, std::size_t name_length,
+                         const uint8_t* value, std::size_t value_length, uint8_t /*flags*/, void* user_data) {
+        auto* self = static_cast<Http2Session*>(user_data);
+        const auto it = self->streams_.find(frame->hd.stream_id);
+        if (frame->hd.type != NGHTTP2_HEADERS || frame->headers.cat != NGHTTP2_HCAT_REQUEST || it == self->streams_.end()) {
+            return 0; // trailers are ignored
+        }
+        auto& request = it->second->request;
+        const std::string_view header_name{reinterpret_cast<const char*>(name), name_length};
+        const std::string_view header_value{reinterpret_cast<const char*>(value), value_length};
+        if (header_name == ":method") {
+            request.method = header_value;
+        } else if (header_name == ":path") {
+            request.uri = header_value;
+        } else if (header_name == ":authority") {
+            request.headers.emplace_back(Header{"Host", std::string{header_value}});
+        } else if (!header_name.starts_with(':')) {
+            request.headers.emplace_back(Header{canonical_header_name(header_name), std::string{header_value}});
+            if (header_name == "content-length") {
+                // Already validated by nghttp2 against the actual content
+                const auto content_length = std::strtoull(request.headers.back().value.c_str(), nullptr, 10);
+                request.content.reserve(std::min<std::size_t>(content_length, kRequestContentMaxPreallocatedSize));
+            }
+        }
+        return 0;
+    }
+
+    static int on_data_chunk_recv(nghttp2_session* /*session*/, uint8_t /*flags*/, int32_t stream_id, const uint8_t* data,
+                                  std::size_t length, void* user_data) {
+        auto* self = static_cast<Http2Session*>(user_data);
+        if (const auto it = self->streams_.find(stream_id); it != self->streams_.end()) {
+            it->second->request.content.append(reinterpret_cast<const char*>(data), length);
+        }
+        return 0;
+    }
+
+    static int on_frame_recv(nghttp2_session* /*session*/, const nghttp2_frame* frame, void* user_data) {
+        if ((frame->hd.type != NGHTTP2_HEADERS && frame->hd.type != NGHTTP2_DATA) || !(frame->hd.flags & NGHTTP2_FLAG_END_STREAM)) {
+            return 0;
+        }
+        auto* self = static_cast<Http2Session*>(user_data);
+        const auto it = self->streams_.find(frame->hd.stream_id);
+        if (it == self->streams_.end()) {
+            return 0;
+        }
+        auto& request = it->second->request;
+        request.content_length = static_cast<uint32_t>(request.content.size());
+        ++self->num_pending_;
+        ++self->num_requests_;
+        try {
+            self->on_request_(it->second);
+        } catch (const std::exception& e) {
+            SILKRPC_ERROR << "Http2Session::on_frame_recv exception: " << e.what() << "\n";
+            return NGHTTP2_ERR_CALLBACK_FAILURE;
+        }
+        return 0;
+    }
+
+    static int on_stream_close(nghttp2_session* /*session*/, int32_t stream_id, uint32_t error_code, void* user_data) {
+        auto* self = static_cast<Http2Session*>(user_data);
+        if (const auto it = self->streams_.find(stream_id); it != self->streams_.end()) {
+            SILKRPC_DEBUG << "Http2Session::on_stream_close stream " << stream_id << " error_code: " << error_code << "\n";
+            it->second->closed = true;
+            self->streams_.erase(it);
+        }
+        return 0;
+    }
+};
+
+Http2Session::Http2Session(uint32_t max_concurrent_streams, RequestCallback on_request) : on_request_{std::move(on_request)} {
+    nghttp2_session_callbacks* callbacks{nullptr};
+    if (nghttp2_session_callbacks_new(&callbacks) != 0) {
+        throw std::runtime_error{"Http2Session: cannot allocate callbacks"};
+    }
+    nghttp2_session_callbacks_set_on_begin_headers_callback(callbacks, Http2SessionCallbacks::on_begin_headers);
+    nghttp2_session_callbacks_set_on_header_callback(callbacks, Http2SessionCallbacks::on_header);
+    nghttp2_session_callbacks_set_on_data_chunk_recv_callback(callbacks, Http2SessionCallbacks::on_data_chunk_recv);
+    nghttp2_session_callbacks_set_on_frame_recv_callback(callbacks, Http2SessionCallbacks::on_frame_recv);
+    nghttp2_session_callbacks_set_on_stream_close_callback(callbacks, Http2SessionCallbacks::on_stream_close);
+    const auto rv = nghttp2_session_server_new(&session_, callbacks, this);
+    nghttp2_session_callbacks_del(callbacks);
+    if (rv != 0) {
+        throw std::runtime_error{std::string{"Http2Session: "} + nghttp2_strerror(rv)};
+    }
+
+    const std::array<nghttp2_settings_entry, 1> settings{{{NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS, max_concurrent_streams}}};
+    nghttp2_submit_settings(session_, NGHTTP2_FLAG_NONE, settings.data(), settings.size());
+}
+
+Http2Session::~Http2Session() {
+    nghttp2_session_del(session_);
+}
+
+void Http2Session::receive(const char* data, std::size_t size) {
+    const auto rv = nghttp2_session_mem_recv(session_, reinterpret_cast<const uint8_t*>(data), size);
+    if (rv < 0) {
+        throw std::runtime_error{std::string{"Http2Session::receive: "} + nghttp2_strerror(static_cast<int>(rv))};
+    }
+}
+
+bool Http2Session::send(std::string& output, std::size_t max_size) {
+    const auto initial_size = output.size();
+    while (output.size() <= max_size) {
+        const uint8_t* data{nullptr};
+        const auto size = nghttp2_session_mem_send(session_, &data);
+        if (size < 0) {
+            throw std::runtime_error{std::string{"Http2Session::send: "} + nghttp2_strerror(static_cast<int>(size))};
+        }
+        if (size == 0) {
+            break;
+        }
+        output.append(reinterpret_cast<const char*>(data), static_cast<std::size_t>(size));
+    }
+    return output.size() > initial_size;
+}
+
+void Http2Session::submit_reply(const std::shared_ptr<Http2Stream>& stream) {
+    --num_pending_;
+    if (stream->closed) {
+        SILKRPC_DEBUG << "Http2Session::submit_reply stream " << stream->id << " already closed\n";
+        return;
+    }
+    const auto& reply = stream->reply;
+    std::vector<std::string> names;
+    names.reserve(reply.headers.size());
+    std::vector<nghttp2_nv> nva;
+    nva.reserve(reply.headers.size() + 1);
+    static const std::string kStatus{":status"};
+    const auto status = std::to_string(static_cast<int>(reply.status));
+    nva.push_back(make_nv(kStatus, status));
+    for (const auto& header : reply.headers) {
+        names.push_back(lowercase_header_name(header.name));
+        if (!is_connection_specific(names.back())) {
+            nva.push_back(make_nv(names.back(), header.value));
+        }
+    }
+
+    // Header blocks are copied by nghttp2, whereas the content is read from the stream kept alive until closed
+    nghttp2_data_provider data_provider{};
+    data_provider.source.ptr = stream.get();
+    data_provider.read_callback = read_reply_content;
+    stream->send_part = 0;
+    stream->send_offset = 0;
+    const auto rv = nghttp2_submit_response(session_, stream->id, nva.data(), nva.size(),
+        reply.content_length() > 0 ? &data_provider : nullptr);
+    if (rv != 0) {
+        SILKRPC_ERROR << "Http2Session::submit_reply stream " << stream->id << " error: " << nghttp2_strerror(rv) << "\n";
+    }
+}
+
+void Http2Session::shutdown() {
+    nghttp2_submit_goaway(session_, NGHTTP2_FLAG_NONE, nghttp2_session_get_last_proc_stream_id(session_), NGHTTP2_NO_ERROR, nullptr, 0);
+}
+
+bool Http2Session::want_read() const {
+    return nghttp2_session_want_read(session_) != 0;
+}
+
+bool Http2Session::want_write() const {
+    return nghttp2_session_want_write(session_) != 0;
+}
+
+} // namespace silkrpc::http
@@ -0,0 +1,113 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_HTTP_HTTP2_SESSION_HPP_
+#define SILKRPC_HTTP_HTTP2_SESSION_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <silkrpc/http/reply.hpp>
+#include <silkrpc/http/request.hpp>
+
+struct nghttp2_session;
+
+namespace silkrpc::http {
+
+/// A request received on one HTTP/2 stream together with its reply.
+struct Http2Stream {
+    /// The identifier of the stream within the session.
+    int32_t id{0};
+
+    Request request;
+    Reply reply;
+
+    /// The stream has been closed by either endpoint, so no reply can be sent on it anymore.
+    bool closed{false};
+
+    /// The position of the reply content still to be sent: index of the part (0 is content, then chunks) and offset.
+    std::size_t send_part{0};
+    std::size_t send_offset{0};
+};
+
+/// Server side of one HTTP/2 connection in cleartext with prior knowledge (h2c), i.e. framing, HPACK header compression
+/// and flow control provided by nghttp2. The session does no I/O: the input read from the socket is fed by receive, the
+/// frames to be written are taken by send. Each request fully received is given to the callback as a new stream, whose
+/// reply is submitted when built: requests on different streams can execute and complete in any order.
+class Http2Session {
+public:
+    /// The connection preface sent first by HTTP/2 clients.
+    static constexpr std::string_view kClientPreface{"PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"};
+
+    using RequestCallback = std::function<void(std::shared_ptr<Http2Stream>)>;
+
+    /// Construct a session allowing the client to open up to max_concurrent_streams streams at once.
+    Http2Session(uint32_t max_concurrent_streams, RequestCallback on_request);
+    ~Http2Session();
+
+    Http2Session(const Http2Session&) = delete;
+    Http2Session& operator=(const Http2Session&) = delete;
+
+    /// Whether the input starts with the HTTP/2 connection preface.
+    static bool starts_with_preface(std::string_view input) { return input.substr(0, kClientPreface.size()) == kClientPreface; }
+
+    /// Process the input received from the client, giving each request fully received to the callback. Throws
+    /// std::runtime_error on protocol errors, in which case the GOAWAY frame explaining them is still to be sent.
+    void receive(const char* data, std::size_t size);
+
+    /// Append the frames ready to be sent to the output, stopping once max_size is exceeded. Return false if none.
+    bool send(std::string& output, std::size_t max_size);
+
+    /// Submit the reply of the stream, unless the stream has been closed in the meantime (e.g. reset by the client).
+    void submit_reply(const std::shared_ptr<Http2Stream>& stream);
+
+    /// Refuse any new stream, letting the ones already received complete (i.e. graceful GOAWAY).
+    void shutdown();
+
+    /// Whether the session still expects input from the client.
+    bool want_read() const;
+
+    /// Whether the session has frames to be sent to the client.
+    bool want_write() const;
+
+    /// The number of requests given to the callback whose replies have not been submitted yet.
+    std::size_t num_pending() const { return num_pending_; }
+
+    /// The number of requests received so far.
+    uint64_t num_requests() const { return num_requests_; }
+
+private:
+    friend struct Http2SessionCallbacks;
+
+    nghttp2_session* session_{nullptr};
+
+    RequestCallback on_request_;
+
+    /// The streams open, i.e. receiving the request or sending the reply.
+    std::unordered_map<int32_t, std::shared_ptr<Http2Stream>> streams_;
+
+    std::size_t num_pending_{0};
+    uint64_t num_requests_{0};
+};
+
+} // namespace silkrpc::http
+
+#endif // SILKRPC_HTTP_HTTP2_SESSION_HPP_
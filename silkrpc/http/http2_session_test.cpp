@@ -0,0 +1,252 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "http2_session.hpp"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <nghttp2/nghttp2.h>
+
+namespace silkrpc::http {
+
+namespace {
+
+// Minimal HTTP/2 client collecting the responses received on each stream
+class TestClient {
+public:
+    struct Response {
+        std::map<std::string, std::string> headers;
+        std::string content;
+        bool completed{false};
+    };
+
+    TestClient() {
+        nghttp2_session_callbacks* callbacks{nullptr};
+        nghttp2_session_callbacks_new(&callbacks);
+        nghttp2_session_callbacks_set_on_header_callback(callbacks, [](nghttp2_session*, const nghttp2_frame* frame, const uint8_t* name,
+            std::size_t name_length, const uint8_t* value, std::size_t value_length, uint8_t, void* user_data) {
+            auto& response = static_cast<TestClient*>(user_data)->responses[frame->hd.stream_id];
+            response.headers[std::string(reinterpret_cast<const char*>(name), name_length)] = std::string(reinterpret_cast<const char*>(value), value_length);
+            return 0;
+        });
+        nghttp2_session_callbacks_set_on_data_chunk_recv_callback(callbacks, [](nghttp2_session*, uint8_t, int32_t stream_id,
+            const uint8_t* data, std::size_t length, void* user_data) {
+            static_cast<TestClient*>(user_data)->responses[stream_id].content.append(reinterpret_cast<const char*>(data), length);
+            return 0;
+        });
+        nghttp2_session_callbacks_set_on_stream_close_callback(callbacks, [](nghttp2_session*, int32_t stream_id, uint32_t, void* user_data) {
+            static_cast<TestClient*>(user_data)->responses[stream_id].completed = true;
+            return 0;
+        });
+        nghttp2_session_client_new(&session_, callbacks, this);
+        nghttp2_session_callbacks_del(callbacks);
+        nghttp2_submit_settings(session_, NGHTTP2_FLAG_NONE, nullptr, 0);
+    }
+
+    ~TestClient() { nghttp2_session_del(session_); }
+
+    int32_t post(const std::string& path, const std::string& content, const std::string& authorization = {}) {
+        contents_.push_back(std::make_unique<std::string>(content));
+        const auto content_length = std::to_string(content.size());
+        std::vector<nghttp2_nv> nva{
+            nv(":method", "POST"), nv(":scheme", "http"), nv(":authority", "localhost"), nv(":path", path),
+            nv("content-type", "application/json"), nv("content-length", content_length)};
+        if (!authorization.empty()) {
+            nva.push_back(nv("authorization", authorization));
+        }
+        nghttp2_data_provider data_provider{};
+        data_provider.source.ptr = contents_.back().get();
+        data_provider.read_callback = [](nghttp2_session*, int32_t, uint8_t* buf, std::size_t length, uint32_t* data_flags,
+            nghttp2_data_source* source, void*) -> ssize_t {
+            auto* data = static_cast<std::string*>(source->ptr);
+            const auto size = std::min(length, data->size());
+            std::copy_n(data->data(), size, buf);
+            data->erase(0, size);
+            if (data->empty()) {
+                *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+            }
+            return static_cast<ssize_t>(size);
+        };
+        return nghttp2_submit_request(session_, nullptr, nva.data(), nva.size(), &data_provider, nullptr);
+    }
+
+    void reset(int32_t stream_id) { nghttp2_submit_rst_stream(session_, NGHTTP2_FLAG_NONE, stream_id, NGHTTP2_CANCEL); }
+
+    std::string output() {
+        std::string output;
+        const uint8_t* data{nullptr};
+        for (auto size = nghttp2_session_mem_send(session_, &data); size > 0; size = nghttp2_session_mem_send(session_, &data)) {
+            output.append(reinterpret_cast<const char*>(data), static_cast<std::size_t>(size));
+        }
+        return output;
+    }
+
+    void receive(const std::string& input) {
+        REQUIRE(nghttp2_session_mem_recv(session_, reinterpret_cast<const uint8_t*>(input.data()), input.size()) == static_cast<ssize_t>(input.size()));
+    }
+
+    std::map<int32_t, Response> responses;
+
+private:
+    static nghttp2_nv nv(std::string_view name, std::string_view value) {
+        return {const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(name.data())), const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(value.data())),
+            name.size(), value.size(), NGHTTP2_NV_FLAG_NONE};
+    }
+
+    nghttp2_session* session_{nullptr};
+    std::vector<std::unique_ptr<std::string>> contents_;
+};
+
+// Exchange the frames pending on both sides until none is left
+void exchange(TestClient& client, Http2Session& server) {
+    std::string server_output;
+    for (auto client_output = client.output(); !client_output.empty() || server.want_write(); client_output = client.output()) {
+        server.receive(client_output.data(), client_output.size());
+        server_output.clear();
+        server.send(server_output, 64 * 1024);
+        client.receive(server_output);
+    }
+}
+
+void set_reply(Http2Stream& stream, const std::string& content, std::vector<std::string> chunks = {}) {
+    stream.reply.status = StatusType::ok;
+    stream.reply.content = content;
+    stream.reply.content_chunks = std::move(chunks);
+    stream.reply.headers = {{"Content-Length", std::to_string(stream.reply.content_length())}, {"Content-Type", "application/json"},
+        {"Connection", "keep-alive"}};
+}
+
+} // namespace
+
+TEST_CASE("Http2Session::starts_with_preface", "[silkrpc][http][http2_session]") {
+    CHECK(Http2Session::starts_with_preface("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"));
+    CHECK(Http2Session::starts_with_preface("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n\x00\x00"));
+    CHECK(!Http2Session::starts_with_preface("PRI * HTTP/2.0\r\n"));
+    CHECK(!Http2Session::starts_with_preface("POST / HTTP/1.1\r\nHost: localhost\r\n\r\n"));
+}
+
+TEST_CASE("Http2Session serves one request", "[silkrpc][http][http2_session]") {
+    std::vector<std::shared_ptr<Http2Stream>> streams;
+    Http2Session server{16, [&](auto stream) { streams.push_back(std::move(stream)); }};
+    TestClient client;
+    const auto stream_id = client.post("/", R"({"jsonrpc":"2.0","id":1,"method":"eth_blockNumber","params":[]})", "Bearer token");
+    exchange(client, server);
+
+    REQUIRE(streams.size() == 1);
+    const auto& request = streams[0]->request;
+    CHECK(request.method == "POST");
+    CHECK(request.uri == "/");
+    CHECK(request.http_version_major == 2);
+    CHECK(request.content == R"({"jsonrpc":"2.0","id":1,"method":"eth_blockNumber","params":[]})");
+    CHECK(request.content_length == request.content.size());
+    CHECK(std::find(request.headers.begin(), request.headers.end(), Header{"Authorization", "Bearer token"}) != request.headers.end());
+    CHECK(std::find(request.headers.begin(), request.headers.end(), Header{"Content-Type", "application/json"}) != request.headers.end());
+    CHECK(std::find(request.headers.begin(), request.headers.end(), Header{"Host", "localhost"}) != request.headers.end());
+    CHECK(server.num_pending() == 1);
+
+    set_reply(*streams[0], R"({"jsonrpc":"2.0","id":1,)", {R"("result":"0x10")", "}"});
+    server.submit_reply(streams[0]);
+    exchange(client, server);
+    CHECK(server.num_pending() == 0);
+    CHECK(server.num_requests() == 1);
+
+    const auto& response = client.responses[stream_id];
+    CHECK(response.completed);
+    CHECK(response.headers.at(":status") == "200");
+    CHECK(response.headers.at("content-type") == "application/json");
+    CHECK(response.headers.count("connection") == 0);
+    CHECK(response.content == R"({"jsonrpc":"2.0","id":1,"result":"0x10"})");
+}
+
+TEST_CASE("Http2Session serves concurrent requests out of order", "[silkrpc][http][http2_session]") {
+    std::vector<std::shared_ptr<Http2Stream>> streams;
+    Http2Session server{16, [&](auto stream) { streams.push_back(std::move(stream)); }};
+    TestClient client;
+    const auto id1 = client.post("/", "1");
+    const auto id2 = client.post("/", "2");
+    const auto id3 = client.post("/", std::string(100 * 1024, 'x'));
+    exchange(client, server);
+    REQUIRE(streams.size() == 3);
+    CHECK(server.num_pending() == 3);
+
+    set_reply(*streams[2], std::string(200 * 1024, 'y'));
+    server.submit_reply(streams[2]);
+    set_reply(*streams[1], "two");
+    server.submit_reply(streams[1]);
+    exchange(client, server);
+    CHECK(client.responses[id2].completed);
+    CHECK(client.responses[id2].content == "two");
+    CHECK(client.responses[id3].completed);
+    CHECK(client.responses[id3].content.size() == 200 * 1024);
+    CHECK(!client.responses[id1].completed);
+
+    set_reply(*streams[0], "one");
+    server.submit_reply(streams[0]);
+    exchange(client, server);
+    CHECK(client.responses[id1].content == "one");
+    CHECK(server.num_pending() == 0);
+}
+
+TEST_CASE("Http2Session drops the reply of a reset stream", "[silkrpc][http][http2_session]") {
+    std::vector<std::shared_ptr<Http2Stream>> streams;
+    Http2Session server{16, [&](auto stream) { streams.push_back(std::move(stream)); }};
+    TestClient client;
+    const auto stream_id = client.post("/", "{}");
+    exchange(client, server);
+    REQUIRE(streams.size() == 1);
+
+    client.reset(stream_id);
+    exchange(client, server);
+    CHECK(streams[0]->closed);
+    set_reply(*streams[0], "dropped");
+    server.submit_reply(streams[0]);
+    exchange(client, server);
+    CHECK(server.num_pending() == 0);
+    CHECK(client.responses[stream_id].content.empty());
+}
+
+TEST_CASE("Http2Session stops reading after shutdown", "[silkrpc][http][http2_session]") {
+    std::vector<std::shared_ptr<Http2Stream>> streams;
+    Http2Session server{16, [&](auto stream) { streams.push_back(std::move(stream)); }};
+    TestClient client;
+    const auto stream_id = client.post("/", "{}");
+    exchange(client, server);
+    REQUIRE(streams.size() == 1);
+
+    server.shutdown();
+    exchange(client, server);
+    set_reply(*streams[0], "last");
+    server.submit_reply(streams[0]);
+    exchange(client, server);
+    CHECK(client.responses[stream_id].content == "last");
+    CHECK(!server.want_read());
+    CHECK(!server.want_write());
+}
+
+TEST_CASE("Http2Session rejects invalid input", "[silkrpc][http][http2_session]") {
+    Http2Session server{16, [](auto) {}};
+    const std::string input{"POST / HTTP/1.1\r\nHost: localhost\r\n\r\n"};
+    CHECK_THROWS_AS(server.receive(input.data(), input.size()), std::runtime_error);
+}
+
+} // namespace silkrpc::http
@@ -0,0 +1,78 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "jwt_verifier.hpp"
+
+#include <algorithm>
+#include <exception>
+
+#include <boost/system/system_error.hpp>
+#include <jwt-cpp/jwt.h>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::http {
+
+struct JwtVerifier::Impl {
+    explicit Impl(const std::string& secret) { verifier.allow_algorithm(jwt::algorithm::hs256{secret}); }
+
+    decltype(jwt::verify()) verifier{jwt::verify()};
+};
+
+JwtVerifier::JwtVerifier(const std::string& secret, std::chrono::milliseconds trusted_for)
+    : impl_{std::make_unique<Impl>(secret)}, trusted_for_{trusted_for} {}
+
+JwtVerifier::~JwtVerifier() = default;
+
+std::optional<std::string> JwtVerifier::verify(const std::string& token) {
+    const auto now = std::chrono::steady_clock::now();
+    if (!trusted_token_.empty() && token == trusted_token_ && now < trusted_until_) {
+        return std::nullopt;
+    }
+    trusted_token_.clear();
+    trusted_subject_.clear();
+
+    try {
+        // Parse token
+        auto decoded_token = jwt::decode(token);
+        if (!decoded_token.has_issued_at()) {
+            SILKRPC_ERROR << "JWT iat (Issued At) not defined: \n";
+            return "iat(Issued At) not defined";
+        }
+        // Validate token
+        SILKRPC_TRACE << "jwt client token: " << token << "\n";
+        impl_->verifier.verify(decoded_token);
+
+        // Trust the token for a short time, never beyond its expiration if any
+        auto trusted_for = std::chrono::duration_cast<std::chrono::steady_clock::duration>(trusted_for_);
+        if (decoded_token.has_expires_at()) {
+            const auto time_to_expiry = decoded_token.get_expires_at() - std::chrono::system_clock::now();
+            trusted_for = std::min(trusted_for, std::chrono::duration_cast<std::chrono::steady_clock::duration>(time_to_expiry));
+        }
+        trusted_token_ = token;
+        trusted_subject_ = decoded_token.has_subject() ? decoded_token.get_subject() : std::string{};
+        trusted_until_ = now + trusted_for;
+    } catch (const boost::system::system_error& se) {
+        SILKRPC_ERROR << "JWT invalid token: " << se.what() << "\n";
+        return "invalid token";
+    } catch (const std::exception& se) {
+        SILKRPC_ERROR << "JWT invalid token: " << se.what() << "\n";
+        return "invalid token";
+    }
+    return std::nullopt;
+}
+
+} // namespace silkrpc::http
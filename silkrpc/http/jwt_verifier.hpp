@@ -0,0 +1,62 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_HTTP_JWT_VERIFIER_HPP_
+#define SILKRPC_HTTP_JWT_VERIFIER_HPP_
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace silkrpc::http {
+
+//! Verifier of the JWT tokens signed with HS256 by the shared secret, set up once and remembering the last token verified
+//! for a short time, so that the requests authenticated by the same token (e.g. the Engine API calls of the consensus
+//! client on one connection) skip decoding and verifying it again. Not thread-safe: meant to be owned by one connection.
+class JwtVerifier {
+public:
+    //! The default time a verified token is trusted without verifying it again
+    static constexpr std::chrono::milliseconds kDefaultTrustedFor{5'000};
+
+    explicit JwtVerifier(const std::string& secret, std::chrono::milliseconds trusted_for = kDefaultTrustedFor);
+    ~JwtVerifier();
+
+    JwtVerifier(const JwtVerifier&) = delete;
+    JwtVerifier& operator=(const JwtVerifier&) = delete;
+
+    //! Return the error if the token is not valid, nothing otherwise
+    std::optional<std::string> verify(const std::string& token);
+
+    //! The subject (i.e. sub claim) of the last token verified, empty if none or not valid
+    const std::string& subject() const noexcept { return trusted_subject_; }
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+
+    //! The time a verified token is trusted without verifying it again
+    std::chrono::milliseconds trusted_for_;
+
+    //! The last token verified along with its subject and the time until it is trusted
+    std::string trusted_token_;
+    std::string trusted_subject_;
+    std::chrono::steady_clock::time_point trusted_until_;
+};
+
+} // namespace silkrpc::http
+
+#endif // SILKRPC_HTTP_JWT_VERIFIER_HPP_
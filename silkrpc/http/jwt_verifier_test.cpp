@@ -0,0 +1,89 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "jwt_verifier.hpp"
+
+#include <chrono>
+#include <string>
+
+#include <catch2/catch.hpp>
+#include <jwt-cpp/jwt.h>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::http {
+
+static const std::string kSecret{"2a64a2a4d0d6e2713c226cd6c1bd11a4c42c52a1f8a1dd5ed6cbff4fc8b8510f"};
+
+static std::string make_token(const std::string& secret, std::chrono::system_clock::time_point issued_at = std::chrono::system_clock::now()) {
+    return jwt::create().set_issued_at(issued_at).sign(jwt::algorithm::hs256{secret});
+}
+
+TEST_CASE("JwtVerifier::verify", "[silkrpc][http][jwt_verifier]") {
+    SILKRPC_LOG_STREAMS(null_stream(), null_stream());
+
+    SECTION("valid token") {
+        JwtVerifier verifier{kSecret};
+        const auto token = make_token(kSecret);
+        CHECK(!verifier.verify(token));
+        CHECK(!verifier.verify(token));
+    }
+
+    SECTION("token signed by another secret") {
+        JwtVerifier verifier{kSecret};
+        CHECK(verifier.verify(make_token("another secret")) == "invalid token");
+    }
+
+    SECTION("malformed token") {
+        JwtVerifier verifier{kSecret};
+        CHECK(verifier.verify("not a token") == "invalid token");
+    }
+
+    SECTION("token without issued at") {
+        JwtVerifier verifier{kSecret};
+        const auto token = jwt::create().sign(jwt::algorithm::hs256{kSecret});
+        CHECK(verifier.verify(token) == "iat(Issued At) not defined");
+    }
+
+    SECTION("trusted token not trusted after another token") {
+        JwtVerifier verifier{kSecret};
+        const auto token = make_token(kSecret);
+        CHECK(!verifier.verify(token));
+        CHECK(verifier.verify(make_token("another secret")) == "invalid token");
+        CHECK(!verifier.verify(token));
+    }
+
+    SECTION("subject of the verified token") {
+        JwtVerifier verifier{kSecret};
+        CHECK(verifier.subject().empty());
+        const auto token = jwt::create().set_issued_at(std::chrono::system_clock::now()).set_subject("tenant").sign(jwt::algorithm::hs256{kSecret});
+        CHECK(!verifier.verify(token));
+        CHECK(verifier.subject() == "tenant");
+        CHECK(!verifier.verify(make_token(kSecret)));
+        CHECK(verifier.subject().empty());
+        CHECK(verifier.verify(token.substr(1)) == "invalid token");
+        CHECK(verifier.subject().empty());
+    }
+
+    SECTION("expired trust") {
+        JwtVerifier verifier{kSecret, std::chrono::milliseconds{0}};
+        const auto token = make_token(kSecret);
+        CHECK(!verifier.verify(token));
+        CHECK(!verifier.verify(token));
+    }
+}
+
+} // namespace silkrpc::http
@@ -41,6 +41,7 @@ constexpr const char* k_eth_chainId{"eth_chainId"};
 constexpr const char* k_eth_protocolVersion{"eth_protocolVersion"};
 constexpr const char* k_eth_syncing{"eth_syncing"};
 constexpr const char* k_eth_gasPrice{"eth_gasPrice"};
+constexpr const char* k_eth_feeHistory{"eth_feeHistory"};
 constexpr const char* k_eth_getUncleByBlockHashAndIndex{"eth_getUncleByBlockHashAndIndex"};
 constexpr const char* k_eth_getUncleByBlockNumberAndIndex{"eth_getUncleByBlockNumberAndIndex"};
 constexpr const char* k_eth_getUncleCountByBlockHash{"eth_getUncleCountByBlockHash"};
@@ -59,6 +60,7 @@ constexpr const char* k_eth_getTransactionCount{"eth_getTransactionCount"};
 constexpr const char* k_eth_getStorageAt{"eth_getStorageAt"};
 constexpr const char* k_eth_call{"eth_call"};
 constexpr const char* k_eth_callBundle{"eth_callBundle"};
+constexpr const char* k_eth_callMany{"eth_callMany"};
 constexpr const char* k_eth_createAccessList{"eth_createAccessList"};
 constexpr const char* k_eth_newFilter{"eth_newFilter"};
 constexpr const char* k_eth_newBlockFilter{"eth_newBlockFilter"};
@@ -108,6 +110,7 @@ constexpr const char* k_erigon_getHeaderByHash{"erigon_getHeaderByHash"};
 constexpr const char* k_erigon_getHeaderByNumber{"erigon_getHeaderByNumber"};
 constexpr const char* k_erigon_getLogsByHash{"erigon_getLogsByHash"};
 constexpr const char* k_erigon_forks{"erigon_forks"};
+constexpr const char* k_erigon_getAccounts{"erigon_getAccounts"};
 constexpr const char* k_erigon_watchTheBurn{"erigon_watchTheBurn"};
 constexpr const char* k_erigon_blockNumber{"erigon_blockNumber"};
 
@@ -119,6 +122,13 @@ constexpr const char* k_engine_newPayloadV1{"engine_newPayloadV1"};
 constexpr const char* k_engine_forkchoiceUpdatedV1{"engine_forkchoiceUpdatedV1"};
 constexpr const char* k_engine_exchangeTransitionConfiguration{"engine_exchangeTransitionConfigurationV1"};
 
+constexpr const char* k_ots_getApiLevel{"ots_getApiLevel"};
+constexpr const char* k_ots_getBlockDetails{"ots_getBlockDetails"};
+constexpr const char* k_ots_getBlockDetailsByHash{"ots_getBlockDetailsByHash"};
+constexpr const char* k_ots_getContractCreator{"ots_getContractCreator"};
+constexpr const char* k_ots_searchTransactionsBefore{"ots_searchTransactionsBefore"};
+constexpr const char* k_ots_searchTransactionsAfter{"ots_searchTransactionsAfter"};
+
 constexpr const char* k_txpool_status{"txpool_status"};
 constexpr const char* k_txpool_content{"txpool_content"};
 
@@ -0,0 +1,273 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "metrics.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <silkrpc/common/allocator.hpp>
+
+namespace silkrpc::http {
+
+template <typename T>
+using Samples = std::initializer_list<std::pair<std::string_view, T>>;
+
+template <typename T>
+static void write_metric(std::string& content, std::string_view name, std::string_view type, std::string_view help, Samples<T> samples) {
+    content.append("# HELP ").append(name).append(" ").append(help).append("\n");
+    content.append("# TYPE ").append(name).append(" ").append(type).append("\n");
+    for (const auto& [labels, value] : samples) {
+        content.append(name).append(labels).append(" ").append(std::to_string(value)).append("\n");
+    }
+}
+
+static double hit_ratio(uint64_t hits, uint64_t misses) {
+    return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+}
+
+std::string make_metrics_content(ethdb::kv::StateCache& state_cache, const BlockCache& block_cache, const ReceiptCache& receipt_cache) {
+    constexpr std::string_view kStateLabel{"{cache=\"state\"}"};
+    constexpr std::string_view kCodeLabel{"{cache=\"code\"}"};
+
+    const auto state_hits = state_cache.state_hit_count();
+    const auto state_misses = state_cache.state_miss_count();
+    const auto code_hits = state_cache.code_hit_count();
+    const auto code_misses = state_cache.code_miss_count();
+
+    std::string content;
+    content.reserve(2048);
+    write_metric<uint64_t>(content, "silkrpc_state_cache_hits_total", "counter", "Number of lookups found in the state cache.",
+        {{kStateLabel, state_hits}, {kCodeLabel, code_hits}});
+    write_metric<uint64_t>(content, "silkrpc_state_cache_misses_total", "counter", "Number of lookups not found in the state cache.",
+        {{kStateLabel, state_misses}, {kCodeLabel, code_misses}});
+    write_metric<double>(content, "silkrpc_state_cache_hit_ratio", "gauge", "Ratio of lookups found in the state cache since startup.",
+        {{kStateLabel, hit_ratio(state_hits, state_misses)}, {kCodeLabel, hit_ratio(code_hits, code_misses)}});
+    write_metric<uint64_t>(content, "silkrpc_state_cache_keys", "gauge", "Number of keys in the latest state view.",
+        {{kStateLabel, state_cache.state_key_count()}, {kCodeLabel, state_cache.code_key_count()}});
+    write_metric<uint64_t>(content, "silkrpc_state_cache_evictions_total", "counter", "Number of keys evicted for exceeding the max keys.",
+        {{kStateLabel, state_cache.state_evicted_count()}, {kCodeLabel, state_cache.code_evicted_count()}});
+    write_metric<uint64_t>(content, "silkrpc_state_cache_views", "gauge", "Number of state views kept in the state cache.",
+        {{"", state_cache.view_count()}});
+    write_metric<uint64_t>(content, "silkrpc_block_cache_entries", "gauge", "Number of blocks in the block cache.",
+        {{"", block_cache.size()}});
+    write_metric<uint64_t>(content, "silkrpc_block_cache_bytes", "gauge", "Approximate size in bytes of the blocks in the block cache.",
+        {{"", block_cache.size_bytes()}});
+    write_metric<uint64_t>(content, "silkrpc_receipt_cache_entries", "gauge", "Number of block receipts in the receipt cache.",
+        {{"", receipt_cache.size()}});
+    write_metric<uint64_t>(content, "silkrpc_receipt_cache_bytes", "gauge", "Approximate size in bytes of the receipts in the receipt cache.",
+        {{"", receipt_cache.size_bytes()}});
+    return content;
+}
+
+std::string make_worker_metrics_content(const WorkerPool& workers) {
+    constexpr std::string_view kShortCallLabel{"{class=\"short_call\"}"};
+    constexpr std::string_view kLongRunningLabel{"{class=\"long_running\"}"};
+
+    const auto to_seconds = [](std::chrono::microseconds wait) { return static_cast<double>(wait.count()) / 1'000'000; };
+
+    std::string content;
+    content.reserve(512);
+    write_metric<uint64_t>(content, "silkrpc_worker_threads", "gauge", "Number of worker threads executing each workload class.",
+        {{kShortCallLabel, workers.size(WorkloadClass::short_call)}, {kLongRunningLabel, workers.size(WorkloadClass::long_running)}});
+    write_metric<double>(content, "silkrpc_worker_queue_wait_seconds", "gauge", "Time waited in the worker queue by the latest probe task.",
+        {{kShortCallLabel, to_seconds(workers.queue_wait(WorkloadClass::short_call))},
+         {kLongRunningLabel, to_seconds(workers.queue_wait(WorkloadClass::long_running))}});
+    return content;
+}
+
+std::string make_context_metrics_content(const ContextLoad& serving_load, const ContextLoad* streaming_load) {
+    constexpr std::string_view kServingLabel{"{context=\"serving\"}"};
+    constexpr std::string_view kStreamingLabel{"{context=\"streaming\"}"};
+    constexpr std::string_view kInFlightName{"silkrpc_context_requests_in_flight"};
+    constexpr std::string_view kInFlightHelp{"Number of requests in flight on the execution context."};
+    constexpr std::string_view kQueueLatencyName{"silkrpc_context_queue_latency_seconds"};
+    constexpr std::string_view kQueueLatencyHelp{"Average time waited in the execution context queue by the probe handlers."};
+
+    const auto to_seconds = [](std::chrono::microseconds latency) { return static_cast<double>(latency.count()) / 1'000'000; };
+
+    std::string content;
+    content.reserve(768);
+    if (streaming_load) {
+        write_metric<uint64_t>(content, kInFlightName, "gauge", kInFlightHelp,
+            {{kServingLabel, serving_load.in_flight_requests()}, {kStreamingLabel, streaming_load->in_flight_requests()}});
+        write_metric<double>(content, kQueueLatencyName, "gauge", kQueueLatencyHelp,
+            {{kServingLabel, to_seconds(serving_load.queue_latency())}, {kStreamingLabel, to_seconds(streaming_load->queue_latency())}});
+    } else {
+        write_metric<uint64_t>(content, kInFlightName, "gauge", kInFlightHelp, {{kServingLabel, serving_load.in_flight_requests()}});
+        write_metric<double>(content, kQueueLatencyName, "gauge", kQueueLatencyHelp, {{kServingLabel, to_seconds(serving_load.queue_latency())}});
+    }
+    return content;
+}
+
+//! Append the samples of the histogram having the specified comma-separated labels, if any
+static void append_histogram(std::string& content, std::string_view name, const std::string& labels, const LatencyHistogram& histogram) {
+    const auto to_seconds = [](uint64_t microseconds) { return std::to_string(static_cast<double>(microseconds) / 1'000'000); };
+    const auto bucket_prefix = labels.empty() ? std::string{"{"} : "{" + labels + ",";
+    const auto total_labels = labels.empty() ? std::string{} : "{" + labels + "}";
+    for (std::size_t i{0}; i < LatencyHistogram::kBucketBounds.size(); ++i) {
+        content.append(name).append("_bucket").append(bucket_prefix).append("le=\"").append(to_seconds(LatencyHistogram::kBucketBounds[i]));
+        content.append("\"} ").append(std::to_string(histogram.cumulative_count(i))).append("\n");
+    }
+    const auto count = std::to_string(histogram.count());
+    content.append(name).append("_bucket").append(bucket_prefix).append("le=\"+Inf\"} ").append(count).append("\n");
+    content.append(name).append("_sum").append(total_labels).append(" ");
+    content.append(to_seconds(static_cast<uint64_t>(histogram.sum().count()))).append("\n");
+    content.append(name).append("_count").append(total_labels).append(" ").append(count).append("\n");
+}
+
+std::string make_latency_metrics_content(const MethodLatencies& method_latencies) {
+    constexpr std::string_view kName{"silkrpc_method_latency_seconds"};
+    constexpr std::string_view kPhaseName{"silkrpc_method_phase_seconds"};
+    constexpr std::string_view kWriteName{"silkrpc_reply_write_seconds"};
+    constexpr std::string_view kCpuName{"silkrpc_method_cpu_seconds"};
+    constexpr std::string_view kAllocatedName{"silkrpc_method_allocated_bytes_total"};
+
+    std::string phase_content;
+    std::string cpu_content;
+    std::string allocated_content;
+    std::string content;
+    content.append("# HELP ").append(kName).append(" Latency of the timed methods.\n");
+    content.append("# TYPE ").append(kName).append(" histogram\n");
+    method_latencies.for_each([&](const std::string& method, const MethodLatencies::Histograms& histograms) {
+        append_histogram(content, kName, "method=\"" + method + "\"", histograms.total);
+        for (std::size_t i{0}; i < kNumRequestPhases; ++i) {
+            const auto labels = "method=\"" + method + "\",phase=\"" + std::string{to_string(static_cast<RequestPhase>(i))} + "\"";
+            append_histogram(phase_content, kPhaseName, labels, histograms.phases[i]);
+        }
+        if (method_latencies.costs_accounted()) {
+            append_histogram(cpu_content, kCpuName, "method=\"" + method + "\"", histograms.cpu_time);
+            allocated_content.append(kAllocatedName).append("{method=\"").append(method).append("\"} ");
+            allocated_content.append(std::to_string(histograms.allocated_bytes.load(std::memory_order_relaxed))).append("\n");
+        }
+    });
+    content.append("# HELP ").append(kPhaseName).append(" Time spent by the timed methods in each phase.\n");
+    content.append("# TYPE ").append(kPhaseName).append(" histogram\n");
+    content.append(phase_content);
+    content.append("# HELP ").append(kWriteName).append(" Time spent writing the replies to the socket.\n");
+    content.append("# TYPE ").append(kWriteName).append(" histogram\n");
+    append_histogram(content, kWriteName, "", method_latencies.write_latency());
+    if (method_latencies.costs_accounted()) {
+        content.append("# HELP ").append(kCpuName).append(" Thread CPU time consumed by the timed methods, on the I/O contexts and the workers.\n");
+        content.append("# TYPE ").append(kCpuName).append(" histogram\n");
+        content.append(cpu_content);
+        content.append("# HELP ").append(kAllocatedName).append(" Bytes allocated by the timed methods.\n");
+        content.append("# TYPE ").append(kAllocatedName).append(" counter\n");
+        content.append(allocated_content);
+    }
+    return content;
+}
+
+std::string make_admission_metrics_content(const AdmissionControl& admission_control) {
+    std::string in_flight_samples;
+    std::string rejected_samples;
+    admission_control.for_each([&](const std::string& name, std::size_t in_flight, uint64_t rejected) {
+        const auto labels = "{limit=\"" + name + "\"} ";
+        in_flight_samples.append("silkrpc_admission_in_flight").append(labels).append(std::to_string(in_flight)).append("\n");
+        rejected_samples.append("silkrpc_admission_rejected_total").append(labels).append(std::to_string(rejected)).append("\n");
+    });
+
+    std::string content;
+    content.append("# HELP silkrpc_admission_in_flight Number of admitted requests in flight for each limit.\n");
+    content.append("# TYPE silkrpc_admission_in_flight gauge\n");
+    content.append(in_flight_samples);
+    content.append("# HELP silkrpc_admission_rejected_total Number of requests rejected for exceeding each limit.\n");
+    content.append("# TYPE silkrpc_admission_rejected_total counter\n");
+    content.append(rejected_samples);
+    return content;
+}
+
+std::string make_rate_limiter_metrics_content(const RateLimiter& rate_limiter) {
+    std::string content;
+    write_metric<uint64_t>(content, "silkrpc_rate_limited_requests_total", "counter", "Number of requests rejected for exceeding the client rate.",
+        {{"", rate_limiter.rejected_count()}});
+    write_metric<uint64_t>(content, "silkrpc_rate_limiter_untracked_total", "counter", "Number of requests let through finding no free bucket.",
+        {{"", rate_limiter.untracked_count()}});
+    return content;
+}
+
+std::string make_disk_cache_metrics_content(const DiskCache& disk_cache) {
+    std::string content;
+    write_metric<uint64_t>(content, "silkrpc_disk_cache_entries", "gauge", "Number of blocks and receipts in the disk cache.",
+        {{"", disk_cache.size()}});
+    write_metric<uint64_t>(content, "silkrpc_disk_cache_bytes", "gauge", "Size in bytes of the disk cache segments.",
+        {{"", disk_cache.size_bytes()}});
+    write_metric<uint64_t>(content, "silkrpc_disk_cache_segments", "gauge", "Number of disk cache segments.",
+        {{"", disk_cache.segment_count()}});
+    write_metric<uint64_t>(content, "silkrpc_disk_cache_hits_total", "counter", "Number of lookups found in the disk cache.",
+        {{"", disk_cache.hit_count()}});
+    write_metric<uint64_t>(content, "silkrpc_disk_cache_misses_total", "counter", "Number of lookups not found in the disk cache.",
+        {{"", disk_cache.miss_count()}});
+    write_metric<uint64_t>(content, "silkrpc_disk_cache_evicted_total", "counter", "Number of values evicted by deleting their segment.",
+        {{"", disk_cache.evicted_count()}});
+    return content;
+}
+
+std::string make_state_changes_metrics_content(const ethdb::kv::StateChangesApplier& applier) {
+    constexpr std::string_view kApplyName{"silkrpc_state_changes_apply_seconds"};
+
+    std::string content;
+    content.reserve(2048);
+    write_metric<uint64_t>(content, "silkrpc_state_changes_queue_depth", "gauge", "Number of state change batches waiting to be applied.",
+        {{"", applier.queue_depth()}});
+    write_metric<uint64_t>(content, "silkrpc_state_changes_applied_total", "counter", "Number of state change batches applied to the state cache.",
+        {{"", applier.applied_count()}});
+    write_metric<uint64_t>(content, "silkrpc_state_changes_queue_full_total", "counter", "Number of state change batches delayed by the full queue.",
+        {{"", applier.queue_full_count()}});
+    content.append("# HELP ").append(kApplyName).append(" Time spent applying each state change batch to the state cache.\n");
+    content.append("# TYPE ").append(kApplyName).append(" histogram\n");
+    append_histogram(content, kApplyName, "", applier.apply_latency());
+    return content;
+}
+
+std::string make_allocator_metrics_content() {
+    constexpr std::string_view kThreadsName{"silkrpc_allocator_heap_threads"};
+    constexpr std::string_view kHeapBytesName{"silkrpc_allocator_heap_allocated_bytes"};
+
+    const auto stats = allocator_stats();
+    const auto allocator_label = "{allocator=\"" + std::string{allocator_name()} + "\"}";
+
+    std::string content;
+    content.reserve(1024);
+    write_metric<uint64_t>(content, "silkrpc_allocator_allocated_bytes", "gauge", "Bytes in use allocated by the memory allocator.",
+        {{allocator_label, stats.allocated_bytes}});
+    write_metric<uint64_t>(content, "silkrpc_allocator_resident_bytes", "gauge", "Bytes of physical memory held by the memory allocator.",
+        {{allocator_label, stats.resident_bytes}});
+    write_metric<uint64_t>(content, "silkrpc_allocator_mapped_bytes", "gauge", "Bytes of virtual memory mapped by the memory allocator.",
+        {{allocator_label, stats.mapped_bytes}});
+
+    const auto heaps = heap_stats();
+    std::string heap_bytes_content;
+    content.append("# HELP ").append(kThreadsName).append(" Number of threads allocating from each heap.\n");
+    content.append("# TYPE ").append(kThreadsName).append(" gauge\n");
+    for (const auto& heap : heaps) {
+        const auto heap_label = "{heap=\"" + heap.name + "\"} ";
+        content.append(kThreadsName).append(heap_label).append(std::to_string(heap.thread_count)).append("\n");
+        heap_bytes_content.append(kHeapBytesName).append(heap_label).append(std::to_string(heap.allocated_bytes)).append("\n");
+    }
+    if (heap_stats_supported()) {
+        content.append("# HELP ").append(kHeapBytesName).append(" Bytes in use allocated from each heap.\n");
+        content.append("# TYPE ").append(kHeapBytesName).append(" gauge\n");
+        content.append(heap_bytes_content);
+    }
+    return content;
+}
+
+} // namespace silkrpc::http
@@ -0,0 +1,68 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_HTTP_METRICS_HPP_
+#define SILKRPC_HTTP_METRICS_HPP_
+
+#include <string>
+
+#include <silkrpc/common/block_cache.hpp>
+#include <silkrpc/common/disk_cache.hpp>
+#include <silkrpc/common/latency_histogram.hpp>
+#include <silkrpc/common/receipt_cache.hpp>
+#include <silkrpc/concurrency/admission_control.hpp>
+#include <silkrpc/concurrency/context_load.hpp>
+#include <silkrpc/concurrency/rate_limiter.hpp>
+#include <silkrpc/concurrency/worker_pool.hpp>
+#include <silkrpc/ethdb/kv/state_cache.hpp>
+#include <silkrpc/ethdb/kv/state_changes_applier.hpp>
+
+namespace silkrpc::http {
+
+//! The content type of the Prometheus text exposition format
+constexpr const char* kMetricsContentType{"text/plain; version=0.0.4"};
+
+//! Render the cache metrics in the Prometheus text exposition format
+std::string make_metrics_content(ethdb::kv::StateCache& state_cache, const BlockCache& block_cache, const ReceiptCache& receipt_cache);
+
+//! Render the worker pool metrics in the Prometheus text exposition format
+std::string make_worker_metrics_content(const WorkerPool& workers);
+
+//! Render the load of the context serving the scrape and of the one dedicated to the streams, if any, in the Prometheus
+//! text exposition format
+std::string make_context_metrics_content(const ContextLoad& serving_load, const ContextLoad* streaming_load);
+
+//! Render the latency histograms of the timed methods in the Prometheus text exposition format
+std::string make_latency_metrics_content(const MethodLatencies& method_latencies);
+
+//! Render the admission control metrics in the Prometheus text exposition format
+std::string make_admission_metrics_content(const AdmissionControl& admission_control);
+
+//! Render the per-client rate limiter metrics in the Prometheus text exposition format
+std::string make_rate_limiter_metrics_content(const RateLimiter& rate_limiter);
+
+//! Render the on-disk cache tier metrics in the Prometheus text exposition format
+std::string make_disk_cache_metrics_content(const DiskCache& disk_cache);
+
+//! Render the state changes applier metrics in the Prometheus text exposition format
+std::string make_state_changes_metrics_content(const ethdb::kv::StateChangesApplier& applier);
+
+//! Render the memory allocator statistics, process-wide and for each heap, in the Prometheus text exposition format
+std::string make_allocator_metrics_content();
+
+} // namespace silkrpc::http
+
+#endif // SILKRPC_HTTP_METRICS_HPP_
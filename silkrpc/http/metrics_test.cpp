@@ -0,0 +1,217 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "metrics.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#include <catch2/catch.hpp>
+#include <gmock/gmock.h>
+
+#include <silkrpc/common/allocator.hpp>
+#include <silkrpc/test/mock_state_cache.hpp>
+
+namespace silkrpc::http {
+
+using testing::Return;
+
+TEST_CASE("make_metrics_content", "[silkrpc][http][metrics]") {
+    BlockCache block_cache;
+    ReceiptCache receipt_cache;
+
+    SECTION("empty caches") {
+        ethdb::kv::CoherentStateCache state_cache;
+        const auto content = make_metrics_content(state_cache, block_cache, receipt_cache);
+        CHECK(content.find("# TYPE silkrpc_state_cache_hits_total counter\n") != std::string::npos);
+        CHECK(content.find("silkrpc_state_cache_hits_total{cache=\"state\"} 0\n") != std::string::npos);
+        CHECK(content.find("silkrpc_state_cache_hit_ratio{cache=\"code\"} 0.000000\n") != std::string::npos);
+        CHECK(content.find("silkrpc_state_cache_views 0\n") != std::string::npos);
+        CHECK(content.find("silkrpc_block_cache_entries 0\n") != std::string::npos);
+        CHECK(content.find("silkrpc_receipt_cache_bytes 0\n") != std::string::npos);
+    }
+
+    SECTION("state cache counters") {
+        test::MockStateCache state_cache;
+        EXPECT_CALL(state_cache, state_hit_count()).WillOnce(Return(3));
+        EXPECT_CALL(state_cache, state_miss_count()).WillOnce(Return(1));
+        EXPECT_CALL(state_cache, code_hit_count()).WillOnce(Return(0));
+        EXPECT_CALL(state_cache, code_miss_count()).WillOnce(Return(2));
+        EXPECT_CALL(state_cache, state_key_count()).WillOnce(Return(10));
+        EXPECT_CALL(state_cache, code_key_count()).WillOnce(Return(5));
+        EXPECT_CALL(state_cache, state_evicted_count()).WillOnce(Return(7));
+        EXPECT_CALL(state_cache, code_evicted_count()).WillOnce(Return(0));
+        EXPECT_CALL(state_cache, view_count()).WillOnce(Return(4));
+
+        const auto content = make_metrics_content(state_cache, block_cache, receipt_cache);
+        CHECK(content.find("silkrpc_state_cache_hits_total{cache=\"state\"} 3\n") != std::string::npos);
+        CHECK(content.find("silkrpc_state_cache_misses_total{cache=\"code\"} 2\n") != std::string::npos);
+        CHECK(content.find("silkrpc_state_cache_hit_ratio{cache=\"state\"} 0.750000\n") != std::string::npos);
+        CHECK(content.find("silkrpc_state_cache_hit_ratio{cache=\"code\"} 0.000000\n") != std::string::npos);
+        CHECK(content.find("silkrpc_state_cache_keys{cache=\"state\"} 10\n") != std::string::npos);
+        CHECK(content.find("silkrpc_state_cache_evictions_total{cache=\"state\"} 7\n") != std::string::npos);
+        CHECK(content.find("silkrpc_state_cache_views 4\n") != std::string::npos);
+    }
+}
+
+TEST_CASE("make_worker_metrics_content", "[silkrpc][http][metrics]") {
+    WorkerPool workers{2, 1};
+    const auto content = make_worker_metrics_content(workers);
+    CHECK(content.find("# TYPE silkrpc_worker_threads gauge\n") != std::string::npos);
+    CHECK(content.find("silkrpc_worker_threads{class=\"short_call\"} 2\n") != std::string::npos);
+    CHECK(content.find("silkrpc_worker_threads{class=\"long_running\"} 1\n") != std::string::npos);
+    CHECK(content.find("silkrpc_worker_queue_wait_seconds{class=\"short_call\"} 0.000000\n") != std::string::npos);
+}
+
+TEST_CASE("make_context_metrics_content", "[silkrpc][http][metrics]") {
+    ContextLoad serving_load;
+    const auto request = serving_load.track_request();
+
+    SECTION("serving context only") {
+        const auto content = make_context_metrics_content(serving_load, nullptr);
+        CHECK(content.find("# TYPE silkrpc_context_requests_in_flight gauge\n") != std::string::npos);
+        CHECK(content.find("silkrpc_context_requests_in_flight{context=\"serving\"} 1\n") != std::string::npos);
+        CHECK(content.find("silkrpc_context_queue_latency_seconds{context=\"serving\"} 0.000000\n") != std::string::npos);
+        CHECK(content.find("streaming") == std::string::npos);
+    }
+
+    SECTION("serving and streaming contexts") {
+        ContextLoad streaming_load;
+        streaming_load.add_queue_latency(std::chrono::microseconds{8000});
+        const auto content = make_context_metrics_content(serving_load, &streaming_load);
+        CHECK(content.find("silkrpc_context_requests_in_flight{context=\"streaming\"} 0\n") != std::string::npos);
+        CHECK(content.find("silkrpc_context_queue_latency_seconds{context=\"streaming\"} 0.001000\n") != std::string::npos);
+    }
+}
+
+TEST_CASE("make_latency_metrics_content", "[silkrpc][http][metrics]") {
+    MethodLatencies method_latencies;
+
+    SECTION("no timed methods") {
+        const auto content = make_latency_metrics_content(method_latencies);
+        CHECK(content.starts_with("# HELP silkrpc_method_latency_seconds Latency of the timed methods.\n"
+                                  "# TYPE silkrpc_method_latency_seconds histogram\n"
+                                  "# HELP silkrpc_method_phase_seconds Time spent by the timed methods in each phase.\n"
+                                  "# TYPE silkrpc_method_phase_seconds histogram\n"
+                                  "# HELP silkrpc_reply_write_seconds Time spent writing the replies to the socket.\n"));
+        CHECK(content.find("silkrpc_reply_write_seconds_bucket{le=\"+Inf\"} 0\n") != std::string::npos);
+        CHECK(content.find("silkrpc_reply_write_seconds_count 0\n") != std::string::npos);
+    }
+
+    SECTION("timed method") {
+        method_latencies.observe("engine_newPayloadV1", std::chrono::microseconds{200});
+        method_latencies.observe("engine_newPayloadV1", std::chrono::milliseconds{20});
+        const auto content = make_latency_metrics_content(method_latencies);
+        CHECK(content.find("silkrpc_method_latency_seconds_bucket{method=\"engine_newPayloadV1\",le=\"0.000100\"} 0\n") != std::string::npos);
+        CHECK(content.find("silkrpc_method_latency_seconds_bucket{method=\"engine_newPayloadV1\",le=\"0.000250\"} 1\n") != std::string::npos);
+        CHECK(content.find("silkrpc_method_latency_seconds_bucket{method=\"engine_newPayloadV1\",le=\"0.025000\"} 2\n") != std::string::npos);
+        CHECK(content.find("silkrpc_method_latency_seconds_bucket{method=\"engine_newPayloadV1\",le=\"+Inf\"} 2\n") != std::string::npos);
+        CHECK(content.find("silkrpc_method_latency_seconds_sum{method=\"engine_newPayloadV1\"} 0.020200\n") != std::string::npos);
+        CHECK(content.find("silkrpc_method_latency_seconds_count{method=\"engine_newPayloadV1\"} 2\n") != std::string::npos);
+    }
+
+    SECTION("timed method with phases") {
+        RequestProfile profile;
+        profile.add(RequestPhase::backend_io, std::chrono::microseconds{300});
+        method_latencies.observe("eth_call", std::chrono::milliseconds{1}, profile);
+        method_latencies.observe_write(std::chrono::microseconds{20});
+        const auto content = make_latency_metrics_content(method_latencies);
+        CHECK(content.find("silkrpc_method_phase_seconds_bucket{method=\"eth_call\",phase=\"backend_io\",le=\"0.000250\"} 0\n") != std::string::npos);
+        CHECK(content.find("silkrpc_method_phase_seconds_bucket{method=\"eth_call\",phase=\"backend_io\",le=\"0.000500\"} 1\n") != std::string::npos);
+        CHECK(content.find("silkrpc_method_phase_seconds_sum{method=\"eth_call\",phase=\"backend_io\"} 0.000300\n") != std::string::npos);
+        CHECK(content.find("silkrpc_method_phase_seconds_sum{method=\"eth_call\",phase=\"evm\"} 0.000000\n") != std::string::npos);
+        CHECK(content.find("silkrpc_reply_write_seconds_bucket{le=\"0.000025\"} 1\n") != std::string::npos);
+        CHECK(content.find("silkrpc_reply_write_seconds_sum 0.000020\n") != std::string::npos);
+        CHECK(content.find("silkrpc_method_cpu_seconds") == std::string::npos);
+    }
+
+    SECTION("timed method with costs") {
+        method_latencies.set_costs_accounted(true);
+        RequestProfile profile;
+        profile.set_costs_accounted(true);
+        profile.add_cost(std::chrono::microseconds{400}, 4096);
+        method_latencies.observe("eth_call", std::chrono::milliseconds{1}, profile);
+        const auto content = make_latency_metrics_content(method_latencies);
+        CHECK(content.find("# TYPE silkrpc_method_cpu_seconds histogram\n") != std::string::npos);
+        CHECK(content.find("silkrpc_method_cpu_seconds_bucket{method=\"eth_call\",le=\"0.000500\"} 1\n") != std::string::npos);
+        CHECK(content.find("silkrpc_method_cpu_seconds_sum{method=\"eth_call\"} 0.000400\n") != std::string::npos);
+        CHECK(content.find("# TYPE silkrpc_method_allocated_bytes_total counter\n") != std::string::npos);
+        CHECK(content.find("silkrpc_method_allocated_bytes_total{method=\"eth_call\"} 4096\n") != std::string::npos);
+    }
+}
+
+TEST_CASE("make_admission_metrics_content", "[silkrpc][http][metrics]") {
+    AdmissionControl admission_control{{{"debug", 8}, {"trace", 4}}, std::chrono::milliseconds{0}};
+    const auto content = make_admission_metrics_content(admission_control);
+    CHECK(content.find("# TYPE silkrpc_admission_in_flight gauge\n") != std::string::npos);
+    CHECK(content.find("silkrpc_admission_in_flight{limit=\"debug\"} 0\n") != std::string::npos);
+    CHECK(content.find("silkrpc_admission_rejected_total{limit=\"trace\"} 0\n") != std::string::npos);
+}
+
+TEST_CASE("make_rate_limiter_metrics_content", "[silkrpc][http][metrics]") {
+    RateLimiter rate_limiter{1};
+    const auto now = RateLimiter::Clock::now();
+    CHECK(rate_limiter.try_acquire(1, 1, now));
+    CHECK(!rate_limiter.try_acquire(1, 1, now));
+    const auto content = make_rate_limiter_metrics_content(rate_limiter);
+    CHECK(content.find("# TYPE silkrpc_rate_limited_requests_total counter\n") != std::string::npos);
+    CHECK(content.find("silkrpc_rate_limited_requests_total 1\n") != std::string::npos);
+    CHECK(content.find("silkrpc_rate_limiter_untracked_total 0\n") != std::string::npos);
+}
+
+TEST_CASE("make_disk_cache_metrics_content", "[silkrpc][http][metrics]") {
+    const auto dir = std::filesystem::temp_directory_path() / "silkrpc_metrics_disk_cache_test";
+    std::filesystem::remove_all(dir);
+    {
+        DiskCache disk_cache{dir};
+        disk_cache.put(DiskCache::Kind::block, evmc::bytes32{}, silkworm::Bytes(10, 0x01));
+        CHECK(disk_cache.get(DiskCache::Kind::block, evmc::bytes32{}));
+        const auto content = make_disk_cache_metrics_content(disk_cache);
+        CHECK(content.find("# TYPE silkrpc_disk_cache_entries gauge\n") != std::string::npos);
+        CHECK(content.find("silkrpc_disk_cache_entries 1\n") != std::string::npos);
+        CHECK(content.find("silkrpc_disk_cache_segments 1\n") != std::string::npos);
+        CHECK(content.find("silkrpc_disk_cache_hits_total 1\n") != std::string::npos);
+        CHECK(content.find("silkrpc_disk_cache_misses_total 0\n") != std::string::npos);
+    }
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("make_state_changes_metrics_content", "[silkrpc][http][metrics]") {
+    ethdb::kv::CoherentStateCache state_cache;
+    ethdb::kv::StateChangesApplier applier{&state_cache};
+    const auto content = make_state_changes_metrics_content(applier);
+    CHECK(content.find("# TYPE silkrpc_state_changes_queue_depth gauge\n") != std::string::npos);
+    CHECK(content.find("silkrpc_state_changes_queue_depth 0\n") != std::string::npos);
+    CHECK(content.find("silkrpc_state_changes_applied_total 0\n") != std::string::npos);
+    CHECK(content.find("silkrpc_state_changes_queue_full_total 0\n") != std::string::npos);
+    CHECK(content.find("# TYPE silkrpc_state_changes_apply_seconds histogram\n") != std::string::npos);
+    CHECK(content.find("silkrpc_state_changes_apply_seconds_count 0\n") != std::string::npos);
+}
+
+TEST_CASE("make_allocator_metrics_content", "[silkrpc][http][metrics]") {
+    std::thread{[]() { bind_thread_heap("metrics_test"); }}.join();
+    const auto content = make_allocator_metrics_content();
+    const auto allocator_label = "{allocator=\"" + std::string{allocator_name()} + "\"}";
+    CHECK(content.find("# TYPE silkrpc_allocator_allocated_bytes gauge\n") != std::string::npos);
+    CHECK(content.find("silkrpc_allocator_resident_bytes" + allocator_label + " ") != std::string::npos);
+    CHECK(content.find("# TYPE silkrpc_allocator_heap_threads gauge\n") != std::string::npos);
+    CHECK(content.find("silkrpc_allocator_heap_threads{heap=\"metrics_test\"} 1\n") != std::string::npos);
+    CHECK((content.find("silkrpc_allocator_heap_allocated_bytes{heap=\"metrics_test\"} ") != std::string::npos) == heap_stats_supported());
+}
+
+} // namespace silkrpc::http
@@ -0,0 +1,227 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "peer_client.hpp"
+
+#include <array>
+#include <string_view>
+#include <utility>
+
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/system/system_error.hpp>
+#include <silkworm/common/util.hpp>
+
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/http/methods.hpp>
+
+namespace silkrpc::http {
+
+namespace {
+
+//! The methods whose first parameter is the hash of the block they are scoped to
+constexpr std::array kBlockHashMethods{
+    method::k_eth_getBlockByHash,
+    method::k_eth_getBlockTransactionCountByHash,
+    method::k_eth_getTransactionByBlockHashAndIndex,
+    method::k_eth_getRawTransactionByBlockHashAndIndex,
+    method::k_eth_getUncleByBlockHashAndIndex,
+    method::k_eth_getUncleCountByBlockHash,
+    method::k_debug_traceBlockByHash,
+    method::k_debug_storageRangeAt,
+    method::k_erigon_getHeaderByHash,
+    method::k_erigon_getLogsByHash,
+};
+
+//! The methods whose first parameter is the address of the account they are scoped to
+constexpr std::array kAddressMethods{
+    method::k_eth_getBalance,
+    method::k_eth_getCode,
+    method::k_eth_getTransactionCount,
+    method::k_eth_getStorageAt,
+    method::k_eth_getProof,
+    method::k_parity_listStorageKeys,
+};
+
+template <std::size_t N>
+bool contains(const std::array<const char*, N>& methods, std::string_view method) {
+    for (const auto* m : methods) {
+        if (method == m) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+std::optional<silkworm::Bytes> peer_routing_key(const nlohmann::json& request_json) {
+    const auto method_it = request_json.find("method");
+    if (method_it == request_json.end() || !method_it->is_string()) {
+        return std::nullopt;
+    }
+    const auto& method = method_it->get_ref<const std::string&>();
+    std::size_t key_size{0};
+    if (contains(kBlockHashMethods, method)) {
+        key_size = silkworm::kHashLength;
+    } else if (contains(kAddressMethods, method)) {
+        key_size = silkworm::kAddressLength;
+    } else {
+        return std::nullopt;
+    }
+
+    // Any malformed request is served locally, so that the usual error is returned
+    const auto params_it = request_json.find("params");
+    if (params_it == request_json.end() || !params_it->is_array() || params_it->empty() || !(*params_it)[0].is_string()) {
+        return std::nullopt;
+    }
+    auto key = silkworm::from_hex((*params_it)[0].get_ref<const std::string&>());
+    if (!key || key->size() != key_size) {
+        return std::nullopt;
+    }
+    return key;
+}
+
+PeerClient::PeerClient(boost::asio::io_context& io_context, std::shared_ptr<const PeerRing> ring, std::chrono::milliseconds timeout)
+    : io_context_{io_context}, ring_{std::move(ring)}, timeout_{timeout}, idle_streams_(ring_->peers().size()) {}
+
+std::optional<std::size_t> PeerClient::remote_owner_of(const nlohmann::json& request_json) const {
+    const auto key = peer_routing_key(request_json);
+    if (!key) {
+        return std::nullopt;
+    }
+    const auto owner = ring_->owner_of(*key);
+    if (owner == ring_->self_index()) {
+        return std::nullopt;
+    }
+    return owner;
+}
+
+boost::asio::awaitable<std::optional<std::string>> PeerClient::forward(std::size_t peer, const std::string& content) {
+    const auto& endpoint = ring_->peers()[peer];
+    auto stream = take_idle(peer);
+    const bool reused = stream != nullptr;
+
+    // An idle connection may have been closed by the peer meanwhile, so just then the request is sent again on a new one
+    for (int attempt{0}; attempt < 2; ++attempt) {
+        std::optional<std::string> reply;
+        bool keep_alive{false};
+        bool failed{false};
+        try {
+            if (!stream) {
+                stream = co_await connect(endpoint);
+            }
+            reply = co_await exchange(*stream, endpoint, content, keep_alive);
+        } catch (const boost::system::system_error& se) {
+            SILKRPC_DEBUG << "PeerClient::forward peer " << endpoint.to_string() << " attempt " << attempt << " error: " << se.what() << "\n";
+            failed = true;
+        }
+        if (failed) {
+            stream.reset();
+            if (reused && attempt == 0) {
+                continue;
+            }
+            break;
+        }
+        if (keep_alive) {
+            put_idle(peer, std::move(stream));
+        }
+        if (reply) {
+            forwarded_count_.fetch_add(1, std::memory_order_relaxed);
+            co_return reply;
+        }
+        break;
+    }
+
+    failed_count_.fetch_add(1, std::memory_order_relaxed);
+    SILKRPC_WARN << "PeerClient::forward peer " << endpoint.to_string() << " failed, request served locally\n";
+    co_return std::nullopt;
+}
+
+std::size_t PeerClient::idle_connection_count(std::size_t peer) const {
+    std::scoped_lock lock{idle_mutex_};
+    return idle_streams_[peer].size();
+}
+
+boost::asio::awaitable<std::unique_ptr<PeerClient::Stream>> PeerClient::connect(const PeerEndpoint& endpoint) {
+    boost::asio::ip::tcp::resolver resolver{io_context_};
+    const auto endpoints = co_await resolver.async_resolve(endpoint.host, endpoint.port, boost::asio::use_awaitable);
+    auto stream = std::make_unique<Stream>(io_context_);
+    stream->expires_after(timeout_);
+    co_await stream->async_connect(endpoints, boost::asio::use_awaitable);
+    stream->socket().set_option(boost::asio::ip::tcp::no_delay{true});
+    co_return stream;
+}
+
+boost::asio::awaitable<std::optional<std::string>> PeerClient::exchange(Stream& stream, const PeerEndpoint& endpoint, const std::string& content,
+                                                                        bool& keep_alive) {
+    namespace beast_http = boost::beast::http;
+
+    beast_http::request<beast_http::string_body> request{beast_http::verb::post, "/", 11};
+    request.set(beast_http::field::host, endpoint.host);
+    request.set(beast_http::field::content_type, "application/json");
+    request.set(kForwardedRequestHeader, "1");
+    request.keep_alive(true);
+    request.body() = content;
+    request.prepare_payload();
+
+    stream.expires_after(timeout_);
+    co_await beast_http::async_write(stream, request, boost::asio::use_awaitable);
+
+    boost::beast::flat_buffer buffer;
+    beast_http::response<beast_http::string_body> response;
+    co_await beast_http::async_read(stream, buffer, response, boost::asio::use_awaitable);
+    stream.expires_never();
+
+    keep_alive = response.keep_alive();
+    if (response.result() != beast_http::status::ok) {
+        SILKRPC_DEBUG << "PeerClient::exchange peer " << endpoint.to_string() << " status: " << response.result_int() << "\n";
+        co_return std::nullopt;
+    }
+
+    // The reply of a single request is terminated by a new line, added back by the caller like for the local replies
+    auto& body = response.body();
+    if (!body.empty() && body.back() == '\n') {
+        body.pop_back();
+    }
+    co_return std::move(body);
+}
+
+std::unique_ptr<PeerClient::Stream> PeerClient::take_idle(std::size_t peer) {
+    std::scoped_lock lock{idle_mutex_};
+    auto& idle_streams = idle_streams_[peer];
+    if (idle_streams.empty()) {
+        return nullptr;
+    }
+    auto stream = std::move(idle_streams.back());
+    idle_streams.pop_back();
+    return stream;
+}
+
+void PeerClient::put_idle(std::size_t peer, std::unique_ptr<Stream> stream) {
+    std::scoped_lock lock{idle_mutex_};
+    auto& idle_streams = idle_streams_[peer];
+    if (idle_streams.size() < kMaxIdleConnections) {
+        idle_streams.push_back(std::move(stream));
+    }
+}
+
+} // namespace silkrpc::http
@@ -0,0 +1,105 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_HTTP_PEER_CLIENT_HPP_
+#define SILKRPC_HTTP_PEER_CLIENT_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <nlohmann/json.hpp>
+#include <silkworm/common/base.hpp>
+
+#include <silkrpc/common/peer_ring.hpp>
+
+namespace silkrpc::http {
+
+//! Return the routing key of the request scoped to one block (i.e. its hash) or one account (i.e. its address), if any
+std::optional<silkworm::Bytes> peer_routing_key(const nlohmann::json& request_json);
+
+//! Client forwarding the JSON requests owned by other replicas (see PeerRing) to them over HTTP/1.1, keeping a few idle
+//! keep-alive connections per peer, so that forwarding costs one round trip on an already open connection. The forwarded
+//! requests carry kForwardedRequestHeader and are always served by the receiving replica, so that they never bounce
+//! around even if the replicas disagree on the peers. Any failure is reported to the caller, who serves the request
+//! locally instead: a replica being down just makes its share of the keys served cold by the others.
+class PeerClient {
+public:
+    //! The default max time to wait for the reply of a peer
+    static constexpr std::chrono::milliseconds kDefaultTimeout{5'000};
+
+    //! The max number of idle connections kept open to each peer
+    static constexpr std::size_t kMaxIdleConnections{8};
+
+    PeerClient(boost::asio::io_context& io_context, std::shared_ptr<const PeerRing> ring, std::chrono::milliseconds timeout = kDefaultTimeout);
+
+    PeerClient(const PeerClient&) = delete;
+    PeerClient& operator=(const PeerClient&) = delete;
+
+    const PeerRing& ring() const noexcept { return *ring_; }
+
+    //! Return the index of the peer owning the request, if any and not the local replica
+    std::optional<std::size_t> remote_owner_of(const nlohmann::json& request_json) const;
+
+    //! Forward the request content to the peer, return the reply content or nothing if the peer cannot serve it
+    boost::asio::awaitable<std::optional<std::string>> forward(std::size_t peer, const std::string& content);
+
+    //! The number of the idle connections to the peer
+    std::size_t idle_connection_count(std::size_t peer) const;
+
+    uint64_t forwarded_count() const { return forwarded_count_.load(std::memory_order_relaxed); }
+    uint64_t failed_count() const { return failed_count_.load(std::memory_order_relaxed); }
+
+private:
+    using Stream = boost::beast::tcp_stream;
+
+    boost::asio::awaitable<std::unique_ptr<Stream>> connect(const PeerEndpoint& endpoint);
+
+    //! Send the request on the stream and read the reply, return the reply if successful and if the stream can be reused
+    boost::asio::awaitable<std::optional<std::string>> exchange(Stream& stream, const PeerEndpoint& endpoint, const std::string& content,
+                                                                bool& keep_alive);
+
+    std::unique_ptr<Stream> take_idle(std::size_t peer);
+    void put_idle(std::size_t peer, std::unique_ptr<Stream> stream);
+
+    boost::asio::io_context& io_context_;
+    std::shared_ptr<const PeerRing> ring_;
+    std::chrono::milliseconds timeout_;
+
+    //! The mutex protecting the idle connections, because the context may be run by many threads (see WaitMode)
+    mutable std::mutex idle_mutex_;
+    std::vector<std::vector<std::unique_ptr<Stream>>> idle_streams_;
+
+    std::atomic<uint64_t> forwarded_count_{0};
+    std::atomic<uint64_t> failed_count_{0};
+};
+
+} // namespace silkrpc::http
+
+#endif // SILKRPC_HTTP_PEER_CLIENT_HPP_
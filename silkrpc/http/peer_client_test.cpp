@@ -0,0 +1,149 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "peer_client.hpp"
+
+#include <string>
+#include <thread>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/use_future.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+#include <catch2/catch.hpp>
+
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::http {
+
+namespace beast_http = boost::beast::http;
+
+static const std::string kBlockHash{"0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c"};
+static const std::string kAddress{"0x0715a7794a1dc8e42615f059dd6e406a6594651a"};
+
+static nlohmann::json make_request(const std::string& method, const nlohmann::json& params) {
+    return nlohmann::json{{"jsonrpc", "2.0"}, {"id", 1}, {"method", method}, {"params", params}};
+}
+
+TEST_CASE("peer_routing_key", "[silkrpc][http][peer_client]") {
+    SECTION("block hash") {
+        const auto key = peer_routing_key(make_request("eth_getBlockByHash", {kBlockHash, false}));
+        REQUIRE(key);
+        CHECK(key->size() == 32);
+        CHECK((*key)[0] == 0x37);
+    }
+
+    SECTION("address") {
+        const auto key = peer_routing_key(make_request("eth_getBalance", {kAddress, "latest"}));
+        REQUIRE(key);
+        CHECK(key->size() == 20);
+        CHECK((*key)[0] == 0x07);
+    }
+
+    SECTION("unscoped method") {
+        CHECK(!peer_routing_key(R"({"jsonrpc":"2.0","id":1,"method":"eth_blockNumber","params":[]})"_json));
+        CHECK(!peer_routing_key(R"({"jsonrpc":"2.0","id":1,"method":"eth_getBlockByNumber","params":["0x1",false]})"_json));
+    }
+
+    SECTION("malformed request") {
+        CHECK(!peer_routing_key(R"({"jsonrpc":"2.0","id":1,"params":[]})"_json));
+        CHECK(!peer_routing_key(R"({"jsonrpc":"2.0","id":1,"method":"eth_getBalance"})"_json));
+        CHECK(!peer_routing_key(R"({"jsonrpc":"2.0","id":1,"method":"eth_getBalance","params":[]})"_json));
+        CHECK(!peer_routing_key(R"({"jsonrpc":"2.0","id":1,"method":"eth_getBalance","params":[1,"latest"]})"_json));
+        CHECK(!peer_routing_key(R"({"jsonrpc":"2.0","id":1,"method":"eth_getBalance","params":["0x0715","latest"]})"_json));
+        CHECK(!peer_routing_key(make_request("eth_getBlockByHash", {kAddress, false})));
+    }
+}
+
+//! Serve the specified number of requests on one connection, replying with their body and the forwarded header value
+static boost::asio::awaitable<void> serve(boost::asio::ip::tcp::acceptor& acceptor, int num_requests) {
+    auto socket = co_await acceptor.async_accept(boost::asio::use_awaitable);
+    boost::beast::flat_buffer buffer;
+    for (int i{0}; i < num_requests; ++i) {
+        beast_http::request<beast_http::string_body> request;
+        co_await beast_http::async_read(socket, buffer, request, boost::asio::use_awaitable);
+        beast_http::response<beast_http::string_body> response{beast_http::status::ok, 11};
+        response.keep_alive(true);
+        response.body() = std::string{request[kForwardedRequestHeader]} + " " + request.body() + "\n";
+        response.prepare_payload();
+        co_await beast_http::async_write(socket, response, boost::asio::use_awaitable);
+    }
+}
+
+TEST_CASE("PeerClient::forward", "[silkrpc][http][peer_client]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    boost::asio::io_context io_context;
+    auto work = boost::asio::make_work_guard(io_context);
+    boost::asio::ip::tcp::acceptor acceptor{io_context, {boost::asio::ip::make_address("127.0.0.1"), 0}};
+    const auto port = std::to_string(acceptor.local_endpoint().port());
+    const std::vector<PeerEndpoint> peers{{"127.0.0.1", "1"}, {"127.0.0.1", port}};
+    PeerClient client{io_context, std::make_shared<PeerRing>(peers, peers[0])};
+    std::thread io_thread{[&]() { io_context.run(); }};
+
+    SECTION("reply served by peer on reused connection") {
+        boost::asio::co_spawn(io_context, serve(acceptor, 2), boost::asio::detached);
+        auto reply1 = boost::asio::co_spawn(io_context, client.forward(1, "{}"), boost::asio::use_future);
+        CHECK(reply1.get() == "1 {}");
+        CHECK(client.idle_connection_count(1) == 1);
+
+        auto reply2 = boost::asio::co_spawn(io_context, client.forward(1, "[]"), boost::asio::use_future);
+        CHECK(reply2.get() == "1 []");
+        CHECK(client.forwarded_count() == 2);
+        CHECK(client.failed_count() == 0);
+    }
+
+    SECTION("peer failure reported") {
+        boost::asio::post(io_context, boost::asio::use_future([&]() { acceptor.close(); })).get();
+        auto reply = boost::asio::co_spawn(io_context, client.forward(1, "{}"), boost::asio::use_future);
+        CHECK(!reply.get());
+        CHECK(client.forwarded_count() == 0);
+        CHECK(client.failed_count() == 1);
+        CHECK(client.idle_connection_count(1) == 0);
+    }
+
+    work.reset();
+    io_thread.join();
+}
+
+TEST_CASE("PeerClient::remote_owner_of", "[silkrpc][http][peer_client]") {
+    boost::asio::io_context io_context;
+    const std::vector<PeerEndpoint> peers{{"rpc1", "8545"}, {"rpc2", "8545"}};
+    const auto ring = std::make_shared<PeerRing>(peers, peers[0]);
+    PeerClient client{io_context, ring};
+
+    CHECK(!client.remote_owner_of(R"({"jsonrpc":"2.0","id":1,"method":"eth_blockNumber","params":[]})"_json));
+    for (uint8_t n{0}; n < 16; ++n) {
+        std::string address{kAddress};
+        address[2] = "0123456789abcdef"[n];
+        const auto request_json = make_request("eth_getCode", {address, "latest"});
+        const auto owner = ring->owner_of(*peer_routing_key(request_json));
+        if (owner == 0) {
+            CHECK(!client.remote_owner_of(request_json));
+        } else {
+            CHECK(client.remote_owner_of(request_json) == owner);
+        }
+    }
+}
+
+} // namespace silkrpc::http
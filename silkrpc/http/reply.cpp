@@ -34,6 +34,7 @@ const std::string bad_request = "HTTP/1.1 400 Bad Request\r\n";
 const std::string unauthorized = "HTTP/1.1 401 Unauthorized\r\n";                   // NOLINT(runtime/string)
 const std::string forbidden = "HTTP/1.1 403 Forbidden\r\n";                         // NOLINT(runtime/string)
 const std::string not_found = "HTTP/1.1 404 Not Found\r\n";                         // NOLINT(runtime/string)
+const std::string too_many_requests = "HTTP/1.1 429 Too Many Requests\r\n";         // NOLINT(runtime/string)
 const std::string internal_server_error = "HTTP/1.1 500 Internal Server Error\r\n"; // NOLINT(runtime/string)
 const std::string not_implemented = "HTTP/1.1 501 Not Implemented\r\n";             // NOLINT(runtime/string)
 const std::string bad_gateway = "HTTP/1.1 502 Bad Gateway\r\n";                     // NOLINT(runtime/string)
@@ -76,6 +77,8 @@ boost::asio::const_buffer to_buffer(StatusType status) {
             return boost::asio::buffer(status_strings::forbidden);
         case StatusType::not_found:
             return boost::asio::buffer(status_strings::not_found);
+        case StatusType::too_many_requests:
+            return boost::asio::buffer(status_strings::too_many_requests);
         case StatusType::internal_server_error:
             return boost::asio::buffer(status_strings::internal_server_error);
         case StatusType::not_implemented:
@@ -105,9 +108,17 @@ std::vector<boost::asio::const_buffer> to_buffers(const std::vector<Header>& hea
     return buffers;
 }
 
+std::size_t Reply::content_length() const {
+    std::size_t length = content.size();
+    for (const auto& chunk : content_chunks) {
+        length += chunk.size();
+    }
+    return length;
+}
+
 std::vector<boost::asio::const_buffer> Reply::to_buffers() const {
     std::vector<boost::asio::const_buffer> buffers;
-    buffers.reserve(1 + headers.size()*4 + 2);
+    buffers.reserve(1 + headers.size()*4 + 2 + content_chunks.size());
     buffers.push_back(to_buffer(status));
 
     const auto headers_buf = http::to_buffers(headers);
@@ -115,6 +126,9 @@ std::vector<boost::asio::const_buffer> Reply::to_buffers() const {
 
     buffers.push_back(boost::asio::buffer(misc_strings::crlf));
     buffers.push_back(boost::asio::buffer(content));
+    for (const auto& chunk : content_chunks) {
+        buffers.push_back(boost::asio::buffer(chunk));
+    }
 
     SILKRPC_TRACE << "Reply::to_buffers buffers: " << buffers << "\n";
     return buffers;
@@ -179,6 +193,11 @@ const char not_found[] =
     "<head><title>Not Found</title></head>"
     "<body><h1>404 Not Found</h1></body>"
     "</html>";
+const char too_many_requests[] =
+    "<html>"
+    "<head><title>Too Many Requests</title></head>"
+    "<body><h1>429 Too Many Requests</h1></body>"
+    "</html>";
 const char internal_server_error[] =
     "<html>"
     "<head><title>Internal Server Error</title></head>"
@@ -228,6 +247,8 @@ std::string to_string(StatusType status) {
             return forbidden;
         case StatusType::not_found:
             return not_found;
+        case StatusType::too_many_requests:
+            return too_many_requests;
         case StatusType::internal_server_error:
             return internal_server_error;
         case StatusType::not_implemented:
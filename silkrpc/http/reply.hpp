@@ -34,6 +34,7 @@ enum StatusType {
     unauthorized = 401,
     forbidden = 403,
     not_found = 404,
+    too_many_requests = 429,
     internal_server_error = 500,
     not_implemented = 501,
     bad_gateway = 502,
@@ -54,6 +55,16 @@ struct Reply {
     /// The content to be sent in the reply.
     std::string content;
 
+    /// The content chunks to be sent in the reply after content. They are gathered at write time, so that large
+    /// replies made of many parts (e.g. JSON RPC batches) are never concatenated into one single string.
+    std::vector<std::string> content_chunks;
+
+    /// The reply has already been written while being built (e.g. by a stream handler), so nothing is left to send.
+    bool streamed{false};
+
+    /// Get the total size of the content to be sent in the reply (i.e. content plus all chunks).
+    std::size_t content_length() const;
+
     /// Convert the reply into a vector of buffers. The buffers do not own the
     /// underlying memory blocks, therefore the reply object must remain valid and
     /// not be changed until the write operation has completed.
@@ -66,6 +77,8 @@ struct Reply {
     void reset() {
         headers.resize(0);
         content.resize(0);
+        content_chunks.resize(0);
+        streamed = false;
     }
 };
 
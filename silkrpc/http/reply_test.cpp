@@ -111,6 +111,11 @@ TEST_CASE("StatusType to_buffer", "[silkrpc][http][reply]") {
         std::string result(static_cast<const char*>(buffer.data()), buffer.size());
         CHECK(result == "HTTP/1.1 404 Not Found\r\n");
     }
+    SECTION("too_many_requests") {
+        auto buffer = to_buffer(StatusType::too_many_requests);
+        std::string result(static_cast<const char*>(buffer.data()), buffer.size());
+        CHECK(result == "HTTP/1.1 429 Too Many Requests\r\n");
+    }
     SECTION("internal_server_error") {
         auto buffer = to_buffer(StatusType::internal_server_error);
         std::string result(static_cast<const char*>(buffer.data()), buffer.size());
@@ -169,6 +174,39 @@ TEST_CASE("Reply", "[silkrpc][http][reply]") {
         CHECK(buffers.size() == 7);
         CHECK(result == "HTTP/1.1 200 OK\r\nAccept: */*\r\n\r\n{\"json\": \"2.0\"}");
     }
+    SECTION("check content_length") {
+        CHECK(reply.content_length() == reply.content.size());
+    }
+}
+
+TEST_CASE("Reply with content chunks", "[silkrpc][http][reply]") {
+    Reply reply{
+        StatusType::ok,
+        std::vector<Header>{{"Accept", "*/*"}},
+        "[",
+        {"{\"id\":1},", "{\"id\":2}]"}
+    };
+
+    SECTION("check content_length") {
+        CHECK(reply.content_length() == 19);
+    }
+    SECTION("check to_buffers") {
+        auto buffers = reply.to_buffers();
+
+        std::string result;
+        for (const auto buffer : buffers) {
+            result += std::string(static_cast<const char*>(buffer.data()), buffer.size());
+        }
+
+        CHECK(buffers.size() == 9);
+        CHECK(result == "HTTP/1.1 200 OK\r\nAccept: */*\r\n\r\n[{\"id\":1},{\"id\":2}]");
+    }
+    SECTION("check reset method") {
+        reply.reset();
+        CHECK(reply.content.empty());
+        CHECK(reply.content_chunks.empty());
+        CHECK(reply.content_length() == 0);
+    }
 }
 
 TEST_CASE("Reply stock_reply", "[silkrpc][http][reply]") {
@@ -232,6 +270,11 @@ TEST_CASE("Reply stock_reply", "[silkrpc][http][reply]") {
         CHECK(result.status == StatusType::not_found);
         CHECK(result.content == "<html><head><title>Not Found</title></head><body><h1>404 Not Found</h1></body></html>");
     }
+    SECTION("too_many_requests") {
+        auto result = Reply::stock_reply(StatusType::too_many_requests);
+        CHECK(result.status == StatusType::too_many_requests);
+        CHECK(result.content == "<html><head><title>Too Many Requests</title></head><body><h1>429 Too Many Requests</h1></body></html>");
+    }
     SECTION("internal_server_error") {
         auto result = Reply::stock_reply(StatusType::internal_server_error);
         CHECK(result.status == StatusType::internal_server_error);
@@ -22,31 +22,253 @@
 
 #include "request_handler.hpp"
 
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <exception>
 #include <iostream>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
-#include <jwt-cpp/jwt.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
 #include <boost/asio/write.hpp>
 #include <nlohmann/json.hpp>
+#include <silkworm/common/base.hpp>
 
 #include <silkrpc/common/clock_time.hpp>
 #include <silkrpc/common/log.hpp>
+#include <silkrpc/common/request_recorder.hpp>
+#include <silkrpc/common/sampling_profiler.hpp>
+#include <silkrpc/common/usdt.hpp>
+#include <silkrpc/concurrency/parallel_for.hpp>
+#include <silkrpc/core/blocks.hpp>
+#include <silkrpc/ethdb/kv/batch_prefetcher.hpp>
 #include <silkrpc/http/header.hpp>
+#include <silkrpc/http/metrics.hpp>
+#include <silkrpc/json/cbor_transcoder.hpp>
 
 namespace silkrpc::http {
 
-boost::asio::awaitable<void> RequestHandler::handle_request(const http::Request& request) {
+//! Serialize the specified JSON value appending its text to the output string, without any intermediate string
+static void dump_into(const nlohmann::json& value, std::string& output) {
+    nlohmann::detail::serializer<nlohmann::json> serializer{
+        nlohmann::detail::output_adapter<char>(output), /*ichar=*/' ', nlohmann::json::error_handler_t::replace};
+    serializer.dump(value, /*pretty_print=*/false, /*ensure_ascii=*/false, /*indent_step=*/0);
+}
+
+//! The request id used for computing the replies shared by identical requests
+static constexpr uint32_t kCoalescedRequestId{0};
+
+//! Copy the reply content computed for the normalized request id into the output, replacing it with the given request id
+static void copy_with_request_id(const std::string& content, const nlohmann::json& request_id, std::string& output) {
+    // All the replies start with the id, because they are written either by sorted keys or by the JSON writer
+    static const std::string kNormalizedPrefix{"{\"id\":" + std::to_string(kCoalescedRequestId)};
+    if (content.starts_with(kNormalizedPrefix) && content.size() > kNormalizedPrefix.size() && content[kNormalizedPrefix.size()] == ',') {
+        output.append("{\"id\":");
+        dump_into(request_id, output);
+        output.append(content, kNormalizedPrefix.size());
+        return;
+    }
+    auto reply_json = nlohmann::json::parse(content);
+    reply_json["id"] = request_id;
+    dump_into(reply_json, output);
+}
+
+//! Return the canonical key of the request, because the parameters are serialized without whitespaces and with sorted object keys
+static std::string make_request_key(const nlohmann::json& request_json, const std::string& method) {
+    std::string key{method};
+    key.push_back('\n');
+    dump_into(request_json.contains("params") ? request_json["params"] : nlohmann::json{}, key);
+    return key;
+}
+
+//! Return the block the request is pinned to by its first parameter, if any: a block or transaction hash pins the request
+//! to a block whose number is unknown, whilst any block tag apart from the earliest one follows the chain head instead
+static std::optional<uint64_t> pinned_block_number(const nlohmann::json& request_json) {
+    if (!request_json.contains("params") || !request_json["params"].is_array() || request_json["params"].empty()) {
+        return std::nullopt;
+    }
+    const auto& block_id = request_json["params"][0];
+    if (block_id.is_number_unsigned()) {
+        return block_id.get<uint64_t>();
+    }
+    if (!block_id.is_string()) {
+        return std::nullopt;
+    }
+    const auto& id = block_id.get_ref<const std::string&>();
+    if (id == core::kEarliestBlockId) {
+        return core::kEarliestBlockNumber;
+    }
+    if (!id.starts_with("0x")) {
+        return std::nullopt;
+    }
+    if (id.size() == 2 + 2 * silkworm::kHashLength) {
+        return ReplyCache::kUnknownBlock;
+    }
+    uint64_t block_number{0};
+    const auto [end, ec] = std::from_chars(id.data() + 2, id.data() + id.size(), block_number, 16);
+    if (ec != std::errc{} || end != id.data() + id.size()) {
+        return std::nullopt;
+    }
+    return block_number;
+}
+
+//! Return the deadline requested by the client through the timeout header in milliseconds, if any and valid
+static std::optional<CancellationToken::Clock::time_point> requested_deadline(const http::Request& request) {
+    const auto it = std::find_if(request.headers.begin(), request.headers.end(), [](const Header& h) {
+        return boost::iequals(h.name, kRequestTimeoutHeader);
+    });
+    if (it == request.headers.end()) {
+        return std::nullopt;
+    }
+    uint64_t timeout{0};
+    const auto [end, ec] = std::from_chars(it->value.data(), it->value.data() + it->value.size(), timeout);
+    if (ec != std::errc{} || end != it->value.data() + it->value.size() || timeout == 0) {
+        return std::nullopt;
+    }
+    return CancellationToken::Clock::now() + std::chrono::milliseconds{timeout};
+}
+
+//! The profiling duration used when the profile request has no valid seconds parameter
+static constexpr std::chrono::seconds kDefaultProfileDuration{10};
+
+//! Return the profiling duration requested by the seconds query parameter of the profile URI, capped to the max one
+static std::chrono::seconds requested_profile_duration(std::string_view uri) {
+    static constexpr std::string_view kSecondsParameter{"seconds="};
+    const auto query = uri.find('?');
+    if (query == std::string_view::npos) {
+        return kDefaultProfileDuration;
+    }
+    const auto parameter = uri.find(kSecondsParameter, query);
+    if (parameter == std::string_view::npos || (uri[parameter - 1] != '?' && uri[parameter - 1] != '&')) {
+        return kDefaultProfileDuration;
+    }
+    const auto value = uri.substr(parameter + kSecondsParameter.size());
+    uint64_t seconds{0};
+    const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), seconds);
+    if (ec != std::errc{} || (end != value.data() + value.size() && *end != '&') || seconds == 0) {
+        return kDefaultProfileDuration;
+    }
+    return std::min(std::chrono::seconds{seconds}, SamplingProfiler::kMaxDuration);
+}
+
+//! Log the request slower than the threshold along with the time spent in each phase and its costs, if accounted
+static void log_slow_request(const std::string& method, std::chrono::microseconds latency, const RequestProfile& profile) {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    std::string phases;
+    for (std::size_t i{0}; i < kNumRequestPhases; ++i) {
+        const auto phase = static_cast<RequestPhase>(i);
+        phases.append(" ").append(to_string(phase)).append(": ");
+        phases.append(std::to_string(duration_cast<microseconds>(profile.elapsed(phase)).count())).append("us");
+    }
+    if (profile.costs_accounted()) {
+        phases.append(" cpu: ").append(std::to_string(duration_cast<microseconds>(profile.cpu_time()).count())).append("us");
+        phases.append(" allocated: ").append(std::to_string(profile.allocated_bytes())).append("B");
+    }
+    SILKRPC_WARN << "slow request method: " << method << " latency: " << latency.count() << "us" << phases << "\n";
+}
+
+//! Return true if the request has been forwarded by another replica
+static bool is_forwarded(const http::Request& request) {
+    return std::any_of(request.headers.begin(), request.headers.end(), [](const Header& h) {
+        return boost::iequals(h.name, kForwardedRequestHeader);
+    });
+}
+
+//! Return true if the reply computed for the normalized request id can be cached, i.e. it has some non-null result
+static bool is_cacheable_reply(const std::string& content) {
+    static const std::string kResultPrefix{"{\"id\":" + std::to_string(kCoalescedRequestId) + ",\"jsonrpc\":\"2.0\",\"result\":"};
+    return content.starts_with(kResultPrefix) && content.compare(kResultPrefix.size(), std::string::npos, "null}") != 0;
+}
+
+boost::asio::awaitable<void> RequestHandler::handle_request(const http::Request& request, TraceContext trace) {
     auto start = clock_time::now();
 
-    http::Reply reply;
+    // Reuse the reply buffers across the requests on this connection
+    reply_.reset();
+    co_await build_reply(request, reply_, /*allow_streaming=*/true, trace);
+    co_await do_write(reply_, trace);
+
+    SILKRPC_INFO << "handle_request t=" << clock_time::since(start) << "ns\n";
+}
+
+boost::asio::awaitable<void> RequestHandler::build_reply(const http::Request& request, http::Reply& reply, bool allow_streaming,
+    TraceContext trace) {
+    const bool is_metrics_request = request.method == "GET" && request.uri == kMetricsUri;
+    const bool is_profile_request = request.method == "GET" && context_.sampling_profiler() && request.uri.starts_with(kProfileUri) &&
+        (request.uri.size() == std::strlen(kProfileUri) || request.uri[std::strlen(kProfileUri)] == '?');
+    if (is_metrics_request || is_profile_request) {
+        // On the JWT-protected port the metrics and the profiles require the same authorization as the JSON RPC requests
+        const auto error = co_await is_request_authorized(request);
+        if (error.has_value()) {
+            reply.status = http::StatusType::unauthorized;
+            reply.content = error.value() + "\n";
+            reply.headers.reserve(2);
+            reply.headers.emplace_back(http::Header{"Content-Length", std::to_string(reply.content.size())});
+            reply.headers.emplace_back(http::Header{"Content-Type", "text/plain"});
+        } else if (is_metrics_request) {
+            build_metrics_reply(reply);
+        } else {
+            co_await build_profile_reply(request, reply);
+        }
+        co_return;
+    }
+
+    // Count the request in flight on this context until replied, so that the new connections go to less loaded ones
+    const auto in_flight = context_.load()->track_request();
+
+    const auto& recorder = context_.request_recorder();
+    if (!recorder || request.content.empty() || !recorder->sample()) {
+        co_await build_reply_content(request, reply, allow_streaming, trace);
+        co_return;
+    }
+
+    const auto received = RequestRecorder::Clock::now();
+    co_await build_reply_content(request, reply, allow_streaming, trace);
+    recorder->record(received, request.content, reply.streamed ? 0 : reply.content_length(), RequestRecorder::Clock::now() - received);
+}
+
+boost::asio::awaitable<void> RequestHandler::build_reply_content(const http::Request& request, http::Reply& reply, bool allow_streaming,
+    TraceContext trace) {
+    auto content_type{ContentType::json};
     if (request.content.empty()) {
         reply.content = "";
         reply.status = http::StatusType::no_content;
     } else {
         SILKRPC_DEBUG << "handle_request content: " << request.content << "\n";
 
+        // Binary replies cannot be streamed, because the JSON text is transcoded only once complete
+        const auto accept_it = std::find_if(request.headers.begin(), request.headers.end(), [&](const Header& h){
+            return boost::iequals(h.name, "Accept");
+        });
+        content_type = accept_it != request.headers.end() ? negotiate_content_type(accept_it->value) : ContentType::json;
+
+        const auto parse_start = std::chrono::steady_clock::now();
         const auto request_json = nlohmann::json::parse(request.content);
+        const auto parse_elapsed = std::chrono::steady_clock::now() - parse_start;
+
+        // All the requests in the HTTP request share the client deadline, if any, and are cancelled with the connection
+        const RequestScope scope{
+            CancellationToken{requested_deadline(request), connection_token_},
+            request_json.is_array() && !request_json.empty() ? parse_elapsed / request_json.size() : parse_elapsed,
+            trace,
+            is_forwarded(request)
+        };
 
         if (request_json.is_object()) {
             if (!request_json.contains("id")) {
@@ -54,51 +276,328 @@ boost::asio::awaitable<void> RequestHandler::handle_request(const http::Request&
                 reply.status = http::StatusType::ok;
             } else {
                 const auto request_id = request_json["id"].get<uint32_t>();
-                const auto error = co_await is_request_authorized(request_id, request);
+                const auto error = co_await is_request_authorized(request);
                 if (error.has_value()) {
                     reply.content = make_json_error(request_id, 403, error.value()).dump() + "\n";
                     reply.status = http::StatusType::unauthorized;
                 } else {
-                    co_await handle_request(request_json, reply);
+                    // Chunked content requires HTTP/1.1 at least
+                    const bool chunked_supported = request.http_version_major > 1 || (request.http_version_major == 1 && request.http_version_minor >= 1);
+                    co_await handle_request(request_json, scope, reply, allow_streaming && chunked_supported && content_type == ContentType::json);
+                    if (reply.streamed) {
+                        co_return;
+                    }
                     reply.content += "\n";
                 }
             }
        } else {
-            std::string batch_reply_content = "[";
-            bool first_element = true;
-            for (auto& item : request_json.items()) {
-                const auto item_json = item.value();
+            // Check all batch elements in request order, then execute the valid ones concurrently
+            struct BatchElement {
+                const nlohmann::json& request_json;
+                http::Reply reply{};
+                bool executed{false};
+            };
+            std::pmr::vector<BatchElement> batch_elements{arena_};
+            batch_elements.reserve(request_json.size());
+            std::pmr::vector<std::size_t> executed_indexes{arena_};
+            executed_indexes.reserve(request_json.size());
+            // The authorization is the same for all the elements, so it is checked once when the first one needs it
+            std::optional<std::optional<std::string>> authorization_error;
+            for (const auto& item_json : request_json) {
+                auto& element = batch_elements.emplace_back(BatchElement{item_json});
                 if (!item_json.contains("id")) {
-                    reply.content = "\n";
-                    reply.status = http::StatusType::ok;
+                    element.reply.status = http::StatusType::ok;
                 } else {
-                    auto request_id = item_json["id"].get<uint32_t>();
-                    const auto error = co_await is_request_authorized(request_id, request);
-                    if (error.has_value()) {
-                        reply.content = make_json_error(request_id, 403, error.value()).dump() + "\n";
-                        reply.status = http::StatusType::unauthorized;
+                    if (!authorization_error) {
+                        authorization_error = co_await is_request_authorized(request);
+                    }
+                    if (authorization_error->has_value()) {
+                        element.reply.status = http::StatusType::unauthorized;
                     } else {
-                        if (first_element) {
-                            first_element =  false;
-                        } else {
-                            batch_reply_content += ",";
+                        element.reply.status = http::StatusType::ok;
+                        element.executed = true;
+                        executed_indexes.push_back(batch_elements.size() - 1);
+                    }
+                }
+            }
+
+            // Elements calling the same method having a batch handler are grouped into one task, executed at once
+            struct BatchTask {
+                std::optional<commands::RpcApiTable::HandleBatch> batch_handler;
+                std::vector<std::size_t> indexes;
+            };
+            std::pmr::vector<BatchTask> tasks{arena_};
+            tasks.reserve(executed_indexes.size());
+            std::map<std::string, std::size_t> task_by_method;
+            for (const auto index : executed_indexes) {
+                const auto& item_json = batch_elements[index].request_json;
+                std::optional<commands::RpcApiTable::HandleBatch> batch_handler;
+                if (item_json.contains("method") && item_json["method"].is_string()) {
+                    const auto& method = item_json["method"].get_ref<const std::string&>();
+                    batch_handler = rpc_api_table_.find_batch_handler(method);
+                    if (batch_handler) {
+                        const auto [task_it, inserted] = task_by_method.emplace(method, tasks.size());
+                        if (!inserted) {
+                            tasks[task_it->second].indexes.push_back(index);
+                            continue;
                         }
-                        co_await handle_request(item_json, reply);
-                        batch_reply_content += reply.content;
                     }
                 }
-           }
-           batch_reply_content += "]\n";
-           reply.content = batch_reply_content;
+                tasks.push_back(BatchTask{batch_handler, {index}});
+            }
+
+            // The blocks, transactions and accounts referenced across the batch are loaded at once before the handlers run
+            if (context_.database() && context_.block_cache()) {
+                ethdb::kv::BatchPrefetchPlan prefetch_plan;
+                for (const auto index : executed_indexes) {
+                    prefetch_plan.add(batch_elements[index].request_json);
+                }
+                if (prefetch_plan.size() >= ethdb::kv::kMinBatchPrefetchSize) {
+                    ethdb::kv::BatchPrefetcher prefetcher{context_};
+                    co_await prefetcher.prefetch(prefetch_plan);
+                }
+            }
+
+            // The elements share one transaction, so that all of them (the grouped ones included) read the same database
+            // view w/o opening their own: if it cannot be opened, each element opens its own as usual
+            std::optional<ethdb::BatchTransaction> batch_transaction;
+            if (context_.database() && executed_indexes.size() >= ethdb::kMinBatchTransactionSize) {
+                batch_transaction.emplace(*context_.database());
+                try {
+                    co_await batch_transaction->open();
+                } catch (const std::exception& e) {
+                    SILKRPC_WARN << "batch transaction not opened: " << e.what() << "\n";
+                    batch_transaction.reset();
+                }
+            }
+            RequestScope batch_scope{scope};
+            batch_scope.batch_transaction = batch_transaction ? &*batch_transaction : nullptr;
+
+            std::exception_ptr batch_exception;
+            try {
+                co_await parallel_for(socket_.get_executor(), tasks.size(), max_batch_concurrency_,
+                    [&](std::size_t task_index) -> boost::asio::awaitable<void> {
+                        const auto& task = tasks[task_index];
+                        if (!task.batch_handler || task.indexes.size() == 1) {
+                            for (const auto index : task.indexes) {
+                                auto& element = batch_elements[index];
+                                co_await handle_request(element.request_json, batch_scope, element.reply);
+                            }
+                            co_return;
+                        }
+                        std::vector<const nlohmann::json*> requests;
+                        std::vector<http::Reply*> replies;
+                        requests.reserve(task.indexes.size());
+                        replies.reserve(task.indexes.size());
+                        for (const auto index : task.indexes) {
+                            requests.push_back(&batch_elements[index].request_json);
+                            replies.push_back(&batch_elements[index].reply);
+                        }
+                        co_await handle_batch_requests(task.batch_handler.value(), requests, batch_scope, replies);
+                    });
+            } catch (...) {
+                batch_exception = std::current_exception();
+            }
+            if (batch_transaction) {
+                try {
+                    co_await batch_transaction->close();
+                } catch (const std::exception& e) {
+                    SILKRPC_WARN << "batch transaction not closed: " << e.what() << "\n";
+                }
+            }
+            if (batch_exception) {
+                std::rethrow_exception(batch_exception);
+            }
+
+            // Element replies are moved into content chunks, so that they will be gathered just when writing
+            reply.content = "[";
+            reply.content_chunks.reserve(2 * executed_indexes.size());
+            for (auto& element : batch_elements) {
+                reply.status = element.reply.status;
+                if (!element.executed) {
+                    continue;
+                }
+                if (!reply.content_chunks.empty()) {
+                    reply.content_chunks.emplace_back(",");
+                }
+                reply.content_chunks.push_back(std::move(element.reply.content));
+            }
+            reply.content_chunks.emplace_back("]\n");
        }
     }
 
-    co_await do_write(reply);
+    if (content_type == ContentType::cbor) {
+        co_await encode_cbor_reply(reply);
+    }
+    if (compression_settings_.level > 0) {
+        co_await compress_reply(request, reply);
+    }
+}
 
-    SILKRPC_INFO << "handle_request t=" << clock_time::since(start) << "ns\n";
+void RequestHandler::build_metrics_reply(http::Reply& reply) {
+    reply.content = make_metrics_content(*context_.state_cache(), *context_.block_cache(), *context_.receipt_cache());
+    reply.content.append(make_worker_metrics_content(workers_));
+    reply.content.append(make_context_metrics_content(*context_.load(), context_.streaming_load().get()));
+    reply.content.append(make_allocator_metrics_content());
+    if (context_.method_latencies()) {
+        reply.content.append(make_latency_metrics_content(*context_.method_latencies()));
+    }
+    if (context_.admission_control()) {
+        reply.content.append(make_admission_metrics_content(*context_.admission_control()));
+    }
+    if (context_.rate_limiter()) {
+        reply.content.append(make_rate_limiter_metrics_content(*context_.rate_limiter()));
+    }
+    if (context_.block_cache()->disk_cache()) {
+        reply.content.append(make_disk_cache_metrics_content(*context_.block_cache()->disk_cache()));
+    }
+    if (context_.state_changes_applier()) {
+        reply.content.append(make_state_changes_metrics_content(*context_.state_changes_applier()));
+    }
+    // Measure the queue wait again for the next scrape, so that the reported one is never older than the scrape interval
+    workers_.probe_queue_wait();
+    reply.status = http::StatusType::ok;
+    reply.headers.reserve(2);
+    reply.headers.emplace_back(http::Header{"Content-Length", std::to_string(reply.content.size())});
+    reply.headers.emplace_back(http::Header{"Content-Type", kMetricsContentType});
+}
+
+boost::asio::awaitable<void> RequestHandler::build_profile_reply(const http::Request& request, http::Reply& reply) {
+    auto& profiler = *context_.sampling_profiler();
+    if (!profiler.start()) {
+        reply.status = http::StatusType::service_unavailable;
+        reply.content = "profiling already running\n";
+    } else {
+        // Stop profiling even if the wait fails, otherwise no other profiling could ever start
+        boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor, requested_profile_duration(request.uri)};
+        std::exception_ptr eptr;
+        try {
+            co_await timer.async_wait(boost::asio::use_awaitable);
+        } catch (...) {
+            eptr = std::current_exception();
+        }
+        reply.content = profiler.stop();
+        if (eptr) {
+            std::rethrow_exception(eptr);
+        }
+        reply.status = http::StatusType::ok;
+    }
+    reply.headers.reserve(2);
+    reply.headers.emplace_back(http::Header{"Content-Length", std::to_string(reply.content.size())});
+    reply.headers.emplace_back(http::Header{"Content-Type", "text/plain"});
+}
+
+boost::asio::awaitable<void> RequestHandler::compress_reply(const http::Request& request, http::Reply& reply) {
+    const auto content_length = reply.content_length();
+    if (content_length == 0 || content_length < compression_settings_.min_size) {
+        co_return;
+    }
+    const auto it = std::find_if(request.headers.begin(), request.headers.end(), [&](const Header& h){
+        return boost::iequals(h.name, "Accept-Encoding");
+    });
+    if (it == request.headers.end()) {
+        co_return;
+    }
+    const auto encoding = negotiate_content_encoding(it->value);
+    if (encoding == ContentEncoding::identity) {
+        co_return;
+    }
+
+    std::vector<std::string_view> parts;
+    parts.reserve(1 + reply.content_chunks.size());
+    parts.emplace_back(reply.content);
+    for (const auto& chunk : reply.content_chunks) {
+        parts.emplace_back(chunk);
+    }
+
+    // Compression is CPU-bound, so run it on the worker pool not to block the I/O context
+    const auto level = compression_settings_.level;
+    auto compressed = co_await boost::asio::async_compose<decltype(boost::asio::use_awaitable), void(std::optional<std::string>)>(
+        [&](auto&& self) {
+            boost::asio::post(workers_.pool(WorkloadClass::short_call), [&, self = std::move(self)]() mutable {
+                std::optional<std::string> output;
+                try {
+                    output = compress(parts, encoding, level);
+                } catch (const std::exception& e) {
+                    SILKRPC_ERROR << "RequestHandler::compress_reply exception: " << e.what() << "\n";
+                }
+                boost::asio::post(socket_.get_executor(), [output = std::move(output), self = std::move(self)]() mutable {
+                    self.complete(std::move(output));
+                });
+            });
+        },
+        boost::asio::use_awaitable);
+    if (!compressed) {
+        co_return;
+    }
+    SILKRPC_DEBUG << "RequestHandler::compress_reply " << to_string(encoding) << " from " << content_length << " to " << compressed->size() << "\n";
+
+    // Keep the content type of the transcoded reply, if any
+    const auto type_it = std::find_if(reply.headers.begin(), reply.headers.end(), [&](const Header& h){
+        return boost::iequals(h.name, "Content-Type");
+    });
+    const std::string content_type = type_it != reply.headers.end() ? type_it->value : std::string{to_string(ContentType::json)};
+    const bool transcoded = content_type != to_string(ContentType::json);
+
+    reply.content = std::move(*compressed);
+    reply.content_chunks.clear();
+    reply.headers.clear();
+    reply.headers.reserve(4);
+    reply.headers.emplace_back(http::Header{"Content-Length", std::to_string(reply.content.size())});
+    reply.headers.emplace_back(http::Header{"Content-Type", content_type});
+    reply.headers.emplace_back(http::Header{"Content-Encoding", std::string{to_string(encoding)}});
+    reply.headers.emplace_back(http::Header{"Vary", transcoded ? "Accept, Accept-Encoding" : "Accept-Encoding"});
 }
 
-boost::asio::awaitable<void> RequestHandler::handle_request(const nlohmann::json& request_json, http::Reply& reply) {
+boost::asio::awaitable<void> RequestHandler::encode_cbor_reply(http::Reply& reply) {
+    if (reply.streamed || reply.content_length() == 0) {
+        co_return;
+    }
+
+    std::vector<std::string_view> parts;
+    parts.reserve(1 + reply.content_chunks.size());
+    parts.emplace_back(reply.content);
+    for (const auto& chunk : reply.content_chunks) {
+        parts.emplace_back(chunk);
+    }
+
+    // Transcoding is CPU-bound as compression is, so run it on the worker pool not to block the I/O context
+    auto encoded = co_await boost::asio::async_compose<decltype(boost::asio::use_awaitable), void(std::optional<std::string>)>(
+        [&](auto&& self) {
+            boost::asio::post(workers_.pool(WorkloadClass::short_call), [&, self = std::move(self)]() mutable {
+                std::optional<std::string> output;
+                try {
+                    std::string cbor;
+                    if (json::transcode_to_cbor(parts, cbor)) {
+                        output = std::move(cbor);
+                    }
+                } catch (const std::exception& e) {
+                    SILKRPC_ERROR << "RequestHandler::encode_cbor_reply exception: " << e.what() << "\n";
+                }
+                boost::asio::post(socket_.get_executor(), [output = std::move(output), self = std::move(self)]() mutable {
+                    self.complete(std::move(output));
+                });
+            });
+        },
+        boost::asio::use_awaitable);
+    if (!encoded) {
+        // Replies having no JSON value (e.g. to notifications) are left as they are
+        co_return;
+    }
+    SILKRPC_DEBUG << "RequestHandler::encode_cbor_reply from " << reply.content_length() << " to " << encoded->size() << "\n";
+
+    reply.content = std::move(*encoded);
+    reply.content_chunks.clear();
+    reply.headers.clear();
+    reply.headers.reserve(3);
+    reply.headers.emplace_back(http::Header{"Content-Length", std::to_string(reply.content.size())});
+    reply.headers.emplace_back(http::Header{"Content-Type", std::string{to_string(ContentType::cbor)}});
+    reply.headers.emplace_back(http::Header{"Vary", "Accept"});
+}
+
+boost::asio::awaitable<void> RequestHandler::handle_request(const nlohmann::json& request_json, const RequestScope& scope,
+    http::Reply& reply, bool allow_streaming) {
+    const auto start = std::chrono::steady_clock::now();
     auto request_id = request_json["id"].get<uint32_t>();
     if (!request_json.contains("method")) {
         reply.content = make_json_error(request_id, -32600, "invalid request").dump();
@@ -106,48 +605,324 @@ boost::asio::awaitable<void> RequestHandler::handle_request(const nlohmann::json
         co_return;
     }
 
-    const auto method = request_json["method"].get<std::string>();
+    const auto& method = request_json["method"].get_ref<const std::string&>();
     if (method.size() == 0) {
         reply.content = make_json_error(request_id, -32600, "invalid request").dump();
         reply.status = http::StatusType::bad_request;
         co_return;
     }
-    const auto json_handler_opt = rpc_api_table_.find_json_handler(method);
-    if (json_handler_opt) {
-        const auto json_handler = json_handler_opt.value();
+
+    // Each client spends tokens weighing the method cost, so that a few heavy callers cannot starve all the others. The
+    // requests forwarded by a peer replica have already been charged there
+    if (context_.rate_limiter() && !scope.forwarded) {
+        const auto* entry = rpc_api_table_.find_method(method);
+        const auto weight = commands::RpcApiTable::weight_of(entry ? entry->cost : commands::RpcApiTable::MethodCost::light);
+        if (!context_.rate_limiter()->try_acquire(client_key(), weight)) {
+            reply.content = make_json_error(request_id, kLimitExceededErrorCode, "rate limit exceeded").dump();
+            reply.status = http::StatusType::too_many_requests;
+            co_return;
+        }
+    }
+
+    // The requests owned by another replica are served there, so that each replica caches a distinct shard of the hot set
+    if (context_.peer_client() && !scope.forwarded) {
+        if (co_await forward_request(request_json, reply)) {
+            co_return;
+        }
+    }
+
+    SILKRPC_PROBE(request_start, method.c_str(), request_id);
+    RequestProfile profile;
+    profile.set_method(method);
+    profile.set_costs_accounted(context_.method_latencies() && context_.method_latencies()->costs_accounted());
+    profile.add(RequestPhase::parse, scope.parse_elapsed);
+
+    TraceSpan dispatch_span{scope.trace, "rpc.dispatch"};
+    dispatch_span.set_attribute("method", method);
+
+    // Expensive methods over their concurrency limit are shed fast, so that the others keep their usual latency
+    std::optional<AdmissionControl::Ticket> admission_ticket;
+    if (context_.admission_control()) {
+        admission_ticket = co_await context_.admission_control()->admit(method);
+        profile.add(RequestPhase::queue, std::chrono::steady_clock::now() - start);
+        if (!admission_ticket) {
+            reply.content = make_json_error(request_id, kLimitExceededErrorCode, "limit exceeded for method " + method).dump();
+            reply.status = http::StatusType::service_unavailable;
+            co_return;
+        }
+    }
+
+    // The default timeout of the method, if any, can just shorten the client deadline
+    const auto timeout = context_.request_timeouts() ? context_.request_timeouts()->find(method) : std::nullopt;
+    const auto token = timeout ? CancellationToken{CancellationToken::Clock::now() + *timeout, scope.token} : scope.token;
+
+    // The last resumption of the request may have completed it inline, so its work scope is still open on this thread
+    try {
+        co_await dispatch_request(request_json, method, token, profile, dispatch_span.context(), scope.batch_transaction, reply, allow_streaming);
+    } catch (...) {
+        RequestWorkScope::end_current(profile);
+        throw;
+    }
+    RequestWorkScope::end_current(profile);
+    dispatch_span.end();
+    SILKRPC_PROBE(request_done, method.c_str(), request_id, static_cast<int>(reply.status));
+
+    // The unknown methods are not timed, so that the histograms cannot grow unbounded
+    if (context_.method_latencies() && reply.status != http::StatusType::not_implemented) {
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start + scope.parse_elapsed);
+        context_.method_latencies()->observe(method, latency, profile);
+        const auto slow_request_threshold = context_.method_latencies()->slow_request_threshold();
+        if (slow_request_threshold.count() > 0 && latency >= slow_request_threshold) {
+            log_slow_request(method, latency, profile);
+        }
+    }
+}
+
+boost::asio::awaitable<void> RequestHandler::handle_batch_requests(commands::RpcApiTable::HandleBatch batch_handler,
+    const std::vector<const nlohmann::json*>& requests_json, const RequestScope& scope, const std::vector<http::Reply*>& replies) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto& method = (*requests_json.front())["method"].get_ref<const std::string&>();
+
+    // Each request is charged as if sent alone, so that grouping many of them in one batch costs the same tokens
+    std::vector<std::size_t> indexes;
+    indexes.reserve(requests_json.size());
+    const auto* entry = rpc_api_table_.find_method(method);
+    const auto weight = commands::RpcApiTable::weight_of(entry ? entry->cost : commands::RpcApiTable::MethodCost::light);
+    for (std::size_t i{0}; i < requests_json.size(); ++i) {
+        if (context_.rate_limiter() && !scope.forwarded && !context_.rate_limiter()->try_acquire(client_key(), weight)) {
+            const auto request_id = (*requests_json[i])["id"].get<uint32_t>();
+            replies[i]->content = make_json_error(request_id, kLimitExceededErrorCode, "rate limit exceeded").dump();
+            replies[i]->status = http::StatusType::too_many_requests;
+            continue;
+        }
+        indexes.push_back(i);
+    }
+
+    // The group is profiled as a whole, so its parse time is the share of all its requests
+    RequestProfile profile;
+    profile.set_method(method);
+    profile.set_costs_accounted(context_.method_latencies() && context_.method_latencies()->costs_accounted());
+    profile.add(RequestPhase::parse, scope.parse_elapsed * requests_json.size());
+
+    TraceSpan dispatch_span{scope.trace, "rpc.dispatch"};
+    dispatch_span.set_attribute("method", method);
+    dispatch_span.set_attribute("batch_size", static_cast<uint64_t>(indexes.size()));
+
+    // Each request takes its own slot, so that the method limit bounds the grouped requests as well. Once one is rejected
+    // the following ones are rejected too, because they would just wait for the slots held by the group itself
+    std::vector<AdmissionControl::Ticket> admission_tickets;
+    if (context_.admission_control() && !indexes.empty()) {
+        admission_tickets.reserve(indexes.size());
+        std::size_t num_admitted{0};
+        for (; num_admitted < indexes.size(); ++num_admitted) {
+            auto admission_ticket = co_await context_.admission_control()->admit(method);
+            if (!admission_ticket) {
+                break;
+            }
+            admission_tickets.push_back(std::move(*admission_ticket));
+        }
+        for (std::size_t i{num_admitted}; i < indexes.size(); ++i) {
+            auto& reply = *replies[indexes[i]];
+            const auto request_id = (*requests_json[indexes[i]])["id"].get<uint32_t>();
+            reply.content = make_json_error(request_id, kLimitExceededErrorCode, "limit exceeded for method " + method).dump();
+            reply.status = http::StatusType::service_unavailable;
+        }
+        indexes.resize(num_admitted);
+        profile.add(RequestPhase::queue, std::chrono::steady_clock::now() - start);
+    }
+    if (indexes.empty()) {
+        co_return;
+    }
+
+    // The group runs on its own request executor like a single request, so that it can be cancelled or timed out
+    const auto timeout = context_.request_timeouts() ? context_.request_timeouts()->find(method) : std::nullopt;
+    const auto token = timeout ? CancellationToken{CancellationToken::Clock::now() + *timeout, scope.token} : scope.token;
+
+    std::vector<const nlohmann::json*> admitted_json;
+    admitted_json.reserve(indexes.size());
+    for (const auto index : indexes) {
+        admitted_json.push_back(requests_json[index]);
+    }
+    std::vector<nlohmann::json> replies_json;
+    std::optional<std::string> error;
+    try {
+        co_await run_on_request_executor(token, profile, dispatch_span.context(), scope.batch_transaction,
+            (rpc_api_.*batch_handler)(admitted_json, replies_json));
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << " processing " << method << " requests: " << indexes.size() << "\n";
+        error = e.what();
+    } catch (...) {
+        SILKRPC_ERROR << "unexpected exception processing " << method << " requests: " << indexes.size() << "\n";
+        error = "unexpected exception";
+    }
+    RequestWorkScope::end_current(profile);
+    dispatch_span.end();
+
+    for (std::size_t i{0}; i < indexes.size(); ++i) {
+        auto& reply = *replies[indexes[i]];
+        if (error) {
+            const auto request_id = (*requests_json[indexes[i]])["id"].get<uint32_t>();
+            reply.content = make_json_error(request_id, 100, *error).dump();
+            reply.status = http::StatusType::internal_server_error;
+            continue;
+        }
+        reply.content.clear();
+        dump_into(replies_json[i], reply.content);
+        reply.status = http::StatusType::ok;
+    }
+
+    // Each request is counted with the latency of the whole group, whose phases and costs are accounted just once
+    if (context_.method_latencies()) {
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start + scope.parse_elapsed);
+        context_.method_latencies()->observe(method, latency, profile);
+        for (std::size_t i{1}; i < indexes.size(); ++i) {
+            context_.method_latencies()->observe(method, latency);
+        }
+        const auto slow_request_threshold = context_.method_latencies()->slow_request_threshold();
+        if (slow_request_threshold.count() > 0 && latency >= slow_request_threshold) {
+            log_slow_request(method, latency, profile);
+        }
+    }
+}
+
+boost::asio::awaitable<bool> RequestHandler::forward_request(const nlohmann::json& request_json, http::Reply& reply) {
+    auto& peer_client = *context_.peer_client();
+    const auto owner = peer_client.remote_owner_of(request_json);
+    if (!owner) {
+        co_return false;
+    }
+    auto content = co_await peer_client.forward(*owner, request_json.dump());
+    if (!content) {
+        co_return false;
+    }
+    reply.content = std::move(*content);
+    reply.status = http::StatusType::ok;
+    co_return true;
+}
+
+boost::asio::awaitable<void> RequestHandler::dispatch_request(const nlohmann::json& request_json, const std::string& method,
+    const CancellationToken& token, RequestProfile& profile, TraceContext trace, ethdb::BatchTransaction* batch_transaction,
+    http::Reply& reply, bool allow_streaming) {
+    const auto* method_entry = rpc_api_table_.find_method(method);
+
+    // Cached replies take precedence even over streaming, because computing them once is worth buffering the result
+    if (context_.reply_cache() && method_entry && method_entry->cacheable) {
+        const auto block_number = pinned_block_number(request_json);
+        if (block_number) {
+            co_await handle_cached_request(request_json, method, *block_number, reply);
+            co_return;
+        }
+    }
+
+    // Stream handlers take precedence when allowed, otherwise the method falls back to its other handlers (if any)
+    if (allow_streaming && method_entry && method_entry->stream_handler) {
+        co_await run_on_request_executor(token, profile, trace, batch_transaction,
+            handle_request(*method_entry->stream_handler, request_json, reply));
+        co_return;
+    }
+
+    if (context_.single_flight() && method_entry && method_entry->coalescible) {
+        co_await handle_coalesced_request(request_json, method, reply);
+        co_return;
+    }
+
+    // The cached and coalesced replies are shared with other requests, so just the private ones can be cancelled
+    co_await run_on_request_executor(token, profile, trace, batch_transaction, handle_method_request(request_json, method, reply));
+}
+
+boost::asio::awaitable<void> RequestHandler::run_on_request_executor(const CancellationToken& token, RequestProfile& profile, TraceContext trace,
+    ethdb::BatchTransaction* batch_transaction, boost::asio::awaitable<void> handling) {
+    const RequestExecutor executor{socket_.get_executor(), token, &profile, trace, batch_transaction};
+    co_await boost::asio::co_spawn(executor, std::move(handling), boost::asio::use_awaitable);
+}
+
+boost::asio::awaitable<void> RequestHandler::handle_method_request(const nlohmann::json& request_json, const std::string& method, http::Reply& reply) {
+    const auto* method_entry = rpc_api_table_.find_method(method);
+    if (method_entry && method_entry->json_handler) {
+        const auto json_handler = method_entry->json_handler.value();
 
         nlohmann::json reply_json;
         co_await (rpc_api_.*json_handler)(request_json, reply_json);
 
-        reply.content = reply_json.dump(
-            /*indent=*/-1, /*indent_char=*/' ', /*ensure_ascii=*/false, nlohmann::json::error_handler_t::replace);
+        const auto serialization_start = std::chrono::steady_clock::now();
+        reply.content.clear();
+        dump_into(reply_json, reply.content);
         reply.status = http::StatusType::ok;
+        if (auto* profile = request_profile_of(co_await boost::asio::this_coro::executor)) {
+            profile->add(RequestPhase::serialization, std::chrono::steady_clock::now() - serialization_start);
+        }
         co_return;
     }
 
-    const auto stream_handler_opt = rpc_api_table_.find_stream_handler(method);
-    if (stream_handler_opt) {
-        const auto stream_handler = stream_handler_opt.value();
+    if (method_entry && method_entry->text_handler) {
+        const auto text_handler = method_entry->text_handler.value();
 
-        json::Stream stream(socket_);
-        co_await (rpc_api_.*stream_handler)(request_json, stream);
+        reply.content.clear();
+        co_await (rpc_api_.*text_handler)(request_json, reply.content);
+        reply.status = http::StatusType::ok;
         co_return;
     }
 
+    const auto request_id = request_json["id"].get<uint32_t>();
     reply.content = make_json_error(request_id, -32601, "the method " + method + " does not exist/is not available").dump();
     reply.status = http::StatusType::not_implemented;
 
     co_return;
 }
 
+boost::asio::awaitable<std::string> RequestHandler::handle_normalized_request(const nlohmann::json& request_json, const std::string& method) {
+    auto normalized_request_json = request_json;
+    normalized_request_json["id"] = kCoalescedRequestId;
+    http::Reply normalized_reply;
+    co_await handle_method_request(normalized_request_json, method, normalized_reply);
+    co_return std::move(normalized_reply.content);
+}
+
+boost::asio::awaitable<void> RequestHandler::handle_coalesced_request(const nlohmann::json& request_json, const std::string& method, http::Reply& reply) {
+    // The reply is computed for the normalized request id, then each identical request gets its own id back
+    const auto content = co_await context_.single_flight()->execute(make_request_key(request_json, method), [&]() {
+        return handle_normalized_request(request_json, method);
+    });
+
+    reply.content.clear();
+    copy_with_request_id(*content, request_json["id"], reply.content);
+    reply.status = http::StatusType::ok;
+}
+
+boost::asio::awaitable<void> RequestHandler::handle_cached_request(const nlohmann::json& request_json, const std::string& method,
+    uint64_t block_number, http::Reply& reply) {
+    auto& reply_cache = *context_.reply_cache();
+    auto key = make_request_key(request_json, method);
+
+    auto content = reply_cache.find(key);
+    if (!content) {
+        // The generation must be taken before computing the reply, so that any unwind in the meantime prevents storing it
+        const auto generation = reply_cache.generation();
+        if (context_.single_flight() && rpc_api_table_.is_coalescible(method)) {
+            content = co_await context_.single_flight()->execute(key, [&]() {
+                return handle_normalized_request(request_json, method);
+            });
+        } else {
+            content = std::make_shared<const std::string>(co_await handle_normalized_request(request_json, method));
+        }
+        if (is_cacheable_reply(*content)) {
+            reply_cache.store(key, content, block_number, generation);
+        }
+    }
+
+    reply.content.clear();
+    copy_with_request_id(*content, request_json["id"], reply.content);
+    reply.status = http::StatusType::ok;
+}
+
 boost::asio::awaitable<void> RequestHandler::handle_request(silkrpc::commands::RpcApiTable::HandleMethod handler, const nlohmann::json& request_json, http::Reply& reply) {
     auto request_id = request_json["id"].get<uint32_t>();
     try {
         nlohmann::json reply_json;
         co_await (rpc_api_.*handler)(request_json, reply_json);
 
-        reply.content = reply_json.dump(
-            /*indent=*/-1, /*indent_char=*/' ', /*ensure_ascii=*/false, nlohmann::json::error_handler_t::replace);
+        reply.content.clear();
+        dump_into(reply_json, reply.content);
         reply.status = http::StatusType::ok;
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << "\n";
@@ -163,23 +938,32 @@ boost::asio::awaitable<void> RequestHandler::handle_request(silkrpc::commands::R
 }
 
 boost::asio::awaitable<void> RequestHandler::handle_request(silkrpc::commands::RpcApiTable::HandleStream handler, const nlohmann::json& request_json, http::Reply& reply) {
-    auto request_id = request_json["id"].get<uint32_t>();
-    try {
-        json::Stream stream(socket_);
+    // From now on the reply is on the socket, so it cannot be replaced by any error reply
+    reply.streamed = true;
+    co_await write_headers();
 
-        co_await write_headers();
+    json::Stream stream(socket_);
+    std::exception_ptr eptr;
+    try {
         co_await (rpc_api_.*handler)(request_json, stream);
+        co_await stream.write("\n");
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << "\n";
+        eptr = std::current_exception();
     } catch (...) {
         SILKRPC_ERROR << "unexpected exception\n";
+        eptr = std::current_exception();
     }
 
-    co_return;
+    // The connection is unusable if the socket has failed, otherwise terminate the content even if incomplete
+    if (stream.failed()) {
+        std::rethrow_exception(eptr);
+    }
+    co_await stream.close();
 }
 
-boost::asio::awaitable<std::optional<std::string>> RequestHandler::is_request_authorized(uint32_t request_id, const http::Request& request) {
-    if (!jwt_secret_.has_value()) {
+boost::asio::awaitable<std::optional<std::string>> RequestHandler::is_request_authorized(const http::Request& request) {
+    if (!jwt_verifier_) {
         co_return std::nullopt;
     }
 
@@ -199,39 +983,54 @@ boost::asio::awaitable<std::optional<std::string>> RequestHandler::is_request_au
         SILKRPC_ERROR << "JWT client request without token\n";
         co_return "missing token";
     }
-    try {
-        // Parse token
-        auto decoded_client_token = jwt::decode(client_token);
-        if (decoded_client_token.has_issued_at() == 0) {
-            SILKRPC_ERROR << "JWT iat (Issued At) not defined: \n";
-            co_return "iat(Issued At) not defined";
-        }
-        // Validate token
-        auto verifier = jwt::verify().allow_algorithm(jwt::algorithm::hs256{*jwt_secret_});
 
-        SILKRPC_TRACE << "jwt client token: " << client_token << " jwt_secret: " << *jwt_secret_ << "\n";
-        verifier.verify(decoded_client_token);
-    } catch (const boost::system::system_error& se) {
-        SILKRPC_ERROR << "JWT invalid token: " << se.what() << "\n";
-        co_return "invalid token";
-    } catch (const std::exception& se) {
-        SILKRPC_ERROR << "JWT invalid token: " << se.what() << "\n";
-        co_return "invalid token";
-    }
+    co_return jwt_verifier_->verify(client_token);
+}
 
-    co_return std::nullopt;
+uint64_t RequestHandler::client_key() {
+    if (jwt_verifier_ && !jwt_verifier_->subject().empty()) {
+        return RateLimiter::client_key_of("sub:" + jwt_verifier_->subject());
+    }
+    if (remote_client_key_ == 0) {
+        // The remote port changes with every connection, so only the address identifies the client
+        std::string_view address{"local"};
+        boost::system::error_code error;
+        const auto endpoint = socket_.remote_endpoint(error);
+        if (!error && endpoint.data()->sa_family == AF_INET) {
+            const auto* ipv4 = reinterpret_cast<const sockaddr_in*>(endpoint.data());
+            address = {reinterpret_cast<const char*>(&ipv4->sin_addr), sizeof(ipv4->sin_addr)};
+        } else if (!error && endpoint.data()->sa_family == AF_INET6) {
+            const auto* ipv6 = reinterpret_cast<const sockaddr_in6*>(endpoint.data());
+            address = {reinterpret_cast<const char*>(&ipv6->sin6_addr), sizeof(ipv6->sin6_addr)};
+        }
+        remote_client_key_ = RateLimiter::client_key_of(address);
+    }
+    return remote_client_key_;
 }
 
-boost::asio::awaitable<void> RequestHandler::do_write(Reply &reply) {
+boost::asio::awaitable<void> RequestHandler::do_write(Reply &reply, TraceContext trace) {
+    if (reply.streamed) {
+        co_return;
+    }
     try {
         SILKRPC_DEBUG << "RequestHandler::do_write reply: " << reply.content << "\n" << std::flush;
 
-        reply.headers.reserve(2);
-        reply.headers.emplace_back(http::Header{"Content-Length", std::to_string(reply.content.size())});
-        reply.headers.emplace_back(http::Header{"Content-Type", "application/json"});
+        // Stock replies come with their own headers
+        if (reply.headers.empty()) {
+            reply.headers.reserve(2);
+            reply.headers.emplace_back(http::Header{"Content-Length", std::to_string(reply.content_length())});
+            reply.headers.emplace_back(http::Header{"Content-Type", "application/json"});
+        }
 
+        const auto start = std::chrono::steady_clock::now();
+        TraceSpan write_span{trace, "http.write", start};
         const auto bytes_transferred = co_await boost::asio::async_write(socket_, reply.to_buffers(), boost::asio::use_awaitable);
+        write_span.set_attribute("bytes", bytes_transferred);
         SILKRPC_TRACE << "RequestHandler::do_write bytes_transferred: " << bytes_transferred << "\n" << std::flush;
+        if (context_.method_latencies()) {
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            context_.method_latencies()->observe_write(std::chrono::duration_cast<std::chrono::microseconds>(elapsed));
+        }
     } catch (const boost::system::system_error& se) {
         std::rethrow_exception(std::make_exception_ptr(se));
     } catch (const std::exception& e) {
@@ -243,10 +1042,15 @@ boost::asio::awaitable<void> RequestHandler::write_headers() {
     try {
         std::vector<http::Header> headers;
         headers.reserve(2);
-        headers.emplace_back(http::Header{"Content-Length", 0});
+        headers.emplace_back(http::Header{"Transfer-Encoding", "chunked"});
         headers.emplace_back(http::Header{"Content-Type", "application/json"});
 
-        const auto bytes_transferred = co_await boost::asio::async_write(socket_, http::to_buffers(headers), boost::asio::use_awaitable);
+        static const std::string kHeadersEnd{"\r\n"};
+        auto buffers = http::to_buffers(headers);
+        buffers.insert(buffers.begin(), http::to_buffer(http::StatusType::ok));
+        buffers.push_back(boost::asio::buffer(kHeadersEnd));
+        const auto bytes_transferred = co_await boost::asio::async_write(socket_, buffers, boost::asio::use_awaitable);
+        SILKRPC_TRACE << "RequestHandler::write_headers bytes_transferred: " << bytes_transferred << "\n";
     } catch (const boost::system::system_error& se) {
         std::rethrow_exception(std::make_exception_ptr(se));
     } catch (const std::exception& e) {
@@ -17,19 +17,27 @@
 #ifndef SILKRPC_HTTP_REQUEST_HANDLER_HPP_
 #define SILKRPC_HTTP_REQUEST_HANDLER_HPP_
 
+#include <chrono>
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <string>
+#include <vector>
 
 #include <silkrpc/config.hpp>
 
 #include <boost/asio/awaitable.hpp>
-#include <boost/asio/ip/tcp.hpp>
-#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
 
+#include <silkrpc/common/constants.hpp>
 #include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/concurrency/request_executor.hpp>
+#include <silkrpc/concurrency/worker_pool.hpp>
 #include <silkrpc/commands/rpc_api.hpp>
 #include <silkrpc/commands/rpc_api_table.hpp>
+#include <silkrpc/ethdb/batch_transaction.hpp>
+#include <silkrpc/http/compression.hpp>
+#include <silkrpc/http/jwt_verifier.hpp>
 #include <silkrpc/http/reply.hpp>
 #include <silkrpc/http/request.hpp>
 
@@ -37,30 +45,130 @@ namespace silkrpc::http {
 
 class RequestHandler {
 public:
-    RequestHandler(Context& context, boost::asio::thread_pool& workers,
-        boost::asio::ip::tcp::socket& socket, const commands::RpcApiTable& rpc_api_table,
-        std::optional<std::string> jwt_secret)
-        : rpc_api_{context, workers}, socket_{socket}, rpc_api_table_(rpc_api_table), jwt_secret_(jwt_secret)  {}
+    RequestHandler(Context& context, WorkerPool& workers,
+        boost::asio::generic::stream_protocol::socket& socket, const commands::RpcApiTable& rpc_api_table,
+        std::optional<std::string> jwt_secret, uint32_t max_batch_concurrency = kDefaultMaxBatchConcurrency,
+        CompressionSettings compression_settings = {}, std::pmr::memory_resource* arena = std::pmr::get_default_resource())
+        : context_{context}, rpc_api_{context, workers}, workers_{workers}, socket_{socket}, rpc_api_table_(rpc_api_table),
+          jwt_verifier_(jwt_secret ? std::make_unique<JwtVerifier>(*jwt_secret) : nullptr), max_batch_concurrency_(max_batch_concurrency), compression_settings_(compression_settings), arena_(arena) {}
 
     RequestHandler(const RequestHandler&) = delete;
     RequestHandler& operator=(const RequestHandler&) = delete;
 
-    boost::asio::awaitable<void> handle_request(const http::Request& request);
+    //! Build the reply for the specified request and write it, recording the spans as children of the trace context
+    boost::asio::awaitable<void> handle_request(const http::Request& request, TraceContext trace = {});
 
-private:
-    boost::asio::awaitable<std::optional<std::string>> is_request_authorized(uint32_t request_id, const http::Request& request);
+    //! Build the reply for the specified request without sending it, so that the caller can decide when to write it.
+    //! When streaming is allowed, methods having a stream handler write their reply directly on the socket as chunked
+    //! content instead: in such case the reply is marked as streamed and there is nothing left to write.
+    boost::asio::awaitable<void> build_reply(const http::Request& request, http::Reply& reply, bool allow_streaming = false,
+        TraceContext trace = {});
+
+    boost::asio::awaitable<void> do_write(http::Reply& reply, TraceContext trace = {});
 
-    boost::asio::awaitable<void> handle_request(const nlohmann::json& request_json, http::Reply& reply);
+    //! Cancel all the requests in flight on this connection, e.g. because the client has disconnected
+    void cancel_requests() noexcept { connection_token_.cancel(); }
+
+private:
+    //! The state shared by all the JSON requests in one HTTP request
+    struct RequestScope {
+        //! The token of the HTTP request, parent of the token of each JSON request
+        CancellationToken token;
+        //! The share of the HTTP content parsing time attributed to each JSON request
+        std::chrono::nanoseconds parse_elapsed{0};
+        //! The trace of the HTTP request, empty if not sampled
+        TraceContext trace;
+        //! Flag indicating if the HTTP request has been forwarded by another replica, hence it must be served here
+        bool forwarded{false};
+        //! The transaction shared by the JSON requests of the batch, if any
+        ethdb::BatchTransaction* batch_transaction{nullptr};
+    };
+
+    //! Build the reply content for the specified non-metrics request, compressing it if enabled
+    boost::asio::awaitable<void> build_reply_content(const http::Request& request, http::Reply& reply, bool allow_streaming,
+        TraceContext trace);
+
+    boost::asio::awaitable<std::optional<std::string>> is_request_authorized(const http::Request& request);
+
+    boost::asio::awaitable<void> handle_request(const nlohmann::json& request_json, const RequestScope& scope, http::Reply& reply,
+        bool allow_streaming = false);
+    boost::asio::awaitable<void> handle_method_request(const nlohmann::json& request_json, const std::string& method, http::Reply& reply);
+
+    //! Handle the requests calling the same method at once through its batch handler: each request is charged by the rate
+    //! limiter and admitted like a single one, the refused ones get their error reply. The batch handler runs on the request
+    //! executor of the group, so that it reads through the scope batch transaction as the other requests of the batch
+    boost::asio::awaitable<void> handle_batch_requests(commands::RpcApiTable::HandleBatch batch_handler,
+        const std::vector<const nlohmann::json*>& requests_json, const RequestScope& scope, const std::vector<http::Reply*>& replies);
+
+    //! Forward the request to the replica owning it, if any and not this one, return true if the reply has been received
+    boost::asio::awaitable<bool> forward_request(const nlohmann::json& request_json, http::Reply& reply);
+
+    //! Dispatch the request having a valid method to the cached, streamed, coalesced or plain handling
+    boost::asio::awaitable<void> dispatch_request(const nlohmann::json& request_json, const std::string& method,
+        const CancellationToken& token, RequestProfile& profile, TraceContext trace, ethdb::BatchTransaction* batch_transaction,
+        http::Reply& reply, bool allow_streaming);
+
+    //! Run the request handling on an executor carrying its token, profile, trace context and batch transaction, so that the
+    //! operations of the request can check the token, account their time, record their spans and share the transaction
+    boost::asio::awaitable<void> run_on_request_executor(const CancellationToken& token, RequestProfile& profile, TraceContext trace,
+        ethdb::BatchTransaction* batch_transaction, boost::asio::awaitable<void> handling);
+
+    //! Handle the request sharing the reply of any identical request in flight, or computing it for all the identical ones
+    boost::asio::awaitable<void> handle_coalesced_request(const nlohmann::json& request_json, const std::string& method, http::Reply& reply);
+
+    //! Handle the request pinned to the specified block serving the cached reply, or computing it and caching it if successful
+    boost::asio::awaitable<void> handle_cached_request(const nlohmann::json& request_json, const std::string& method,
+        uint64_t block_number, http::Reply& reply);
+
+    //! Compute the reply content for the request as if its id were the normalized one, so that it can be shared
+    boost::asio::awaitable<std::string> handle_normalized_request(const nlohmann::json& request_json, const std::string& method);
     boost::asio::awaitable<void> handle_request(silkrpc::commands::RpcApiTable::HandleMethod handler, const nlohmann::json& request_json, http::Reply& reply);
     boost::asio::awaitable<void> handle_request(silkrpc::commands::RpcApiTable::HandleStream handler, const nlohmann::json& request_json, http::Reply& reply);
 
-    boost::asio::awaitable<void> do_write(http::Reply& reply);
+    //! The key of the client charged by the rate limiter: the subject of the JWT token if any, the remote address otherwise
+    uint64_t client_key();
+
+    //! Write the status line and the headers of a reply having chunked content
     boost::asio::awaitable<void> write_headers();
 
+    //! Build the reply for the metrics scrape request
+    void build_metrics_reply(http::Reply& reply);
+
+    //! Build the reply for the profile request, profiling all the threads for the requested duration
+    boost::asio::awaitable<void> build_profile_reply(const http::Request& request, http::Reply& reply);
+
+    //! Compress the reply content on the worker pool if big enough and accepted by the client
+    boost::asio::awaitable<void> compress_reply(const http::Request& request, http::Reply& reply);
+
+    //! Transcode the JSON reply content into CBOR on the worker pool, leaving the reply untouched if not a JSON value
+    boost::asio::awaitable<void> encode_cbor_reply(http::Reply& reply);
+
+    Context& context_;
     commands::RpcApi rpc_api_;
-    boost::asio::ip::tcp::socket& socket_;
+    WorkerPool& workers_;
+    boost::asio::generic::stream_protocol::socket& socket_;
     const commands::RpcApiTable& rpc_api_table_;
-    const std::optional<std::string> jwt_secret_;
+
+    //! The verifier of the JWT tokens authorizing the requests on this connection, if authentication is enabled
+    std::unique_ptr<JwtVerifier> jwt_verifier_;
+
+    //! The rate limiter key of the remote address of this connection, computed on first use
+    uint64_t remote_client_key_{0};
+
+    //! The max number of batch elements executed concurrently (1 means sequential execution)
+    const uint32_t max_batch_concurrency_;
+
+    //! The settings for compressing the replies
+    const CompressionSettings compression_settings_;
+
+    //! The memory resource for the temporaries living until the request is done, released all at once by the owner
+    std::pmr::memory_resource* arena_;
+
+    //! The reply reused for all the non-pipelined requests, so that its buffers are allocated once per connection
+    http::Reply reply_;
+
+    //! The ancestor of the tokens of all the requests on this connection
+    CancellationToken connection_token_{std::nullopt};
 };
 
 } // namespace silkrpc::http
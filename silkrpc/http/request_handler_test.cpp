@@ -16,21 +16,38 @@
 
 #include "request_handler.hpp"
 
+#include <chrono>
 #include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
 #include <thread>
 #include <vector>
 
 #include <boost/asio/co_spawn.hpp>
-#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
+#include <boost/asio/this_coro.hpp>
 #include <boost/asio/use_future.hpp>
 #include <catch2/catch.hpp>
+#include <jwt-cpp/jwt.h>
+#include <nlohmann/json.hpp>
 #include <silkworm/common/util.hpp>
 
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/latency_histogram.hpp>
 #include <silkrpc/common/log.hpp>
+#include <silkrpc/common/sampling_profiler.hpp>
+#include <silkrpc/concurrency/admission_control.hpp>
+#include <silkrpc/concurrency/cancellation.hpp>
 #include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/concurrency/rate_limiter.hpp>
+#include <silkrpc/concurrency/request_executor.hpp>
+#include <silkrpc/concurrency/worker_pool.hpp>
+#include <silkrpc/ethdb/batch_transaction.hpp>
 #include <silkrpc/http/request.hpp>
 #include <silkrpc/http/reply.hpp>
 #include <silkrpc/http/header.hpp>
+#include <silkrpc/test/context_test_base.hpp>
 
 namespace silkrpc::http {
 
@@ -51,7 +68,7 @@ TEST_CASE("check handle_request  empty content ", "[silkrpc][handle_request]") {
 /*
     ContextPool cp{1, []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); }};
     auto context_pool_thread = std::thread([&]() { cp.run(); });
-    boost::asio::thread_pool workers{1};
+    WorkerPool workers{1};
     try {
         silkrpc::http::RequestHandler h{cp.next_context(), workers};
         auto result{boost::asio::co_spawn(cp.next_io_context(), h.handle_request(req, reply), boost::asio::use_future)};
@@ -87,7 +104,7 @@ TEST_CASE("check handle_request no method", "[silkrpc][handle_request]") {
 /*
     ContextPool cp{1, []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); }};
     auto context_pool_thread = std::thread([&]() { cp.run(); });
-    boost::asio::thread_pool workers{1};
+    WorkerPool workers{1};
 
     try {
         silkrpc::http::RequestHandler h{cp.next_context(), workers};
@@ -123,7 +140,7 @@ TEST_CASE("check handle_request invalid method", "[silkrpc][handle_request]") {
 /*
     ContextPool cp{1, []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); }};
     auto context_pool_thread = std::thread([&]() { cp.run(); });
-    boost::asio::thread_pool workers{1};
+    WorkerPool workers{1};
 
     try {
         silkrpc::http::RequestHandler h{cp.next_context(), workers};
@@ -159,7 +176,7 @@ TEST_CASE("check handle_request method return failed", "[silkrpc][handle_request
 /*
     ContextPool cp{1, []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); }};
     auto context_pool_thread = std::thread([&]() { cp.run(); });
-    boost::asio::thread_pool workers{1};
+    WorkerPool workers{1};
 
     silkrpc::http::RequestHandler h{cp.next_context(), workers};
     try {
@@ -181,5 +198,180 @@ TEST_CASE("check handle_request method return failed", "[silkrpc][handle_request
 */
 }
 
+//! Transaction whose cursors fail every read, so that the handlers reply with some error without any backend
+class FailingTransaction : public ethdb::Transaction {
+public:
+    explicit FailingTransaction(uint64_t tx_id) : tx_id_{tx_id} {}
+
+    uint64_t tx_id() const override { return tx_id_; }
+
+    boost::asio::awaitable<void> open() override { co_return; }
+
+    boost::asio::awaitable<std::shared_ptr<ethdb::Cursor>> cursor(const std::string& table) override {
+        throw std::runtime_error{"no cursor on " + table};
+        co_return nullptr;
+    }
+
+    boost::asio::awaitable<std::shared_ptr<ethdb::CursorDupSort>> cursor_dup_sort(const std::string& table) override {
+        throw std::runtime_error{"no cursor on " + table};
+        co_return nullptr;
+    }
+
+    boost::asio::awaitable<void> close() override { co_return; }
+
+private:
+    uint64_t tx_id_;
+};
+
+//! Database counting the transactions begun on it and the ones leased from the batch transaction
+class FailingDatabase : public ethdb::Database {
+public:
+    boost::asio::awaitable<std::unique_ptr<ethdb::Transaction>> begin() override {
+        const auto executor = co_await boost::asio::this_coro::executor;
+        if (cancellation_token_of(executor).deadline()) {
+            ++num_with_deadline;
+        }
+        if (request_profile_of(executor)) {
+            ++num_profiled;
+        }
+        if (auto batch_txn = co_await ethdb::lease_batch_transaction(*this)) {
+            ++num_leased;
+            co_return batch_txn;
+        }
+        ++num_begun;
+        co_return std::make_unique<FailingTransaction>(num_begun);
+    }
+
+    int num_begun{0};
+    int num_leased{0};
+    int num_with_deadline{0};
+    int num_profiled{0};
+};
+
+class RequestHandlerTest : public test::ContextTestBase {
+public:
+    RequestHandlerTest() {
+        auto database = std::make_unique<FailingDatabase>();
+        database_ = database.get();
+        context_.database() = std::move(database);
+    }
+
+    //! Handle the batch content returning the element replies in request order
+    nlohmann::json handle_batch(const std::string& content) {
+        Request request{"POST", "/", 1, 1, {}, static_cast<uint32_t>(content.size()), content};
+        Reply reply;
+        spawn_and_wait(handler_.build_reply(request, reply));
+        std::string reply_content{reply.content};
+        for (const auto& chunk : reply.content_chunks) {
+            reply_content += chunk;
+        }
+        return nlohmann::json::parse(reply_content);
+    }
+
+    FailingDatabase* database_{nullptr};
+    WorkerPool workers_{1};
+    boost::asio::generic::stream_protocol::socket socket_{io_context_};
+    commands::RpcApiTable rpc_api_table_{kEthApiNamespace};
+    RequestHandler handler_{context_, workers_, socket_, rpc_api_table_, std::nullopt};
+};
+
+static const std::string kGetBalanceRequests{
+    R"({"jsonrpc":"2.0","id":1,"method":"eth_getBalance","params":["0x0715a7794a1dc8e42615f059dd6e406a6594651a","0x1"]},)"
+    R"({"jsonrpc":"2.0","id":2,"method":"eth_getBalance","params":["0x0715a7794a1dc8e42615f059dd6e406a6594651a","0x1"]},)"
+    R"({"jsonrpc":"2.0","id":3,"method":"eth_getBalance","params":["0x0715a7794a1dc8e42615f059dd6e406a6594651a","0x1"]})"
+};
+
+TEST_CASE_METHOD(RequestHandlerTest, "RequestHandler charges each grouped request", "[silkrpc][http][request_handler]") {
+    context_.rate_limiter() = std::make_shared<RateLimiter>(/*rate=*/1, /*burst=*/1);
+
+    const auto replies = handle_batch("[" + kGetBalanceRequests + "]");
+    REQUIRE(replies.size() == 3);
+    CHECK(replies[0]["id"] == 1);
+    CHECK(replies[0]["error"]["code"] != kLimitExceededErrorCode);
+    CHECK(replies[1]["id"] == 2);
+    CHECK(replies[1]["error"]["code"] == kLimitExceededErrorCode);
+    CHECK(replies[2]["id"] == 3);
+    CHECK(replies[2]["error"]["code"] == kLimitExceededErrorCode);
+    CHECK(context_.rate_limiter()->rejected_count() == 2);
+}
+
+TEST_CASE_METHOD(RequestHandlerTest, "RequestHandler admits each grouped request", "[silkrpc][http][request_handler]") {
+    context_.admission_control() = std::make_shared<AdmissionControl>(AdmissionControl::Limits{{"eth_getBalance", 2}},
+        /*queue_budget=*/std::chrono::milliseconds{0});
+
+    const auto replies = handle_batch("[" + kGetBalanceRequests + "]");
+    REQUIRE(replies.size() == 3);
+    CHECK(replies[0]["error"]["code"] != kLimitExceededErrorCode);
+    CHECK(replies[1]["error"]["code"] != kLimitExceededErrorCode);
+    CHECK(replies[2]["id"] == 3);
+    CHECK(replies[2]["error"]["code"] == kLimitExceededErrorCode);
+    CHECK(replies[2]["error"]["message"] == "limit exceeded for method eth_getBalance");
+    CHECK(context_.admission_control()->rejected_count() == 1);
+    context_.admission_control()->for_each([](const std::string&, std::size_t in_flight, uint64_t) {
+        CHECK(in_flight == 0);
+    });
+}
+
+TEST_CASE_METHOD(RequestHandlerTest, "RequestHandler runs the grouped requests on the request executor", "[silkrpc][http][request_handler]") {
+    context_.request_timeouts() = std::make_shared<RequestTimeouts>(RequestTimeouts::parse_timeouts("eth_getBalance=60000"));
+
+    const auto replies = handle_batch("[" + kGetBalanceRequests + "]");
+    REQUIRE(replies.size() == 3);
+    CHECK(database_->num_with_deadline == 1);
+    CHECK(database_->num_profiled == 1);
+}
+
+TEST_CASE_METHOD(RequestHandlerTest, "RequestHandler records the grouped requests in the method latencies", "[silkrpc][http][request_handler]") {
+    context_.method_latencies() = std::make_shared<MethodLatencies>();
+
+    const auto replies = handle_batch("[" + kGetBalanceRequests + "]");
+    REQUIRE(replies.size() == 3);
+    uint64_t count{0};
+    context_.method_latencies()->for_each([&](const std::string& method, const MethodLatencies::Histograms& histograms) {
+        if (method == "eth_getBalance") {
+            count = histograms.total.count();
+        }
+    });
+    CHECK(count == 3);
+}
+
+TEST_CASE_METHOD(RequestHandlerTest, "RequestHandler shares the batch transaction with the grouped requests", "[silkrpc][http][request_handler]") {
+    const auto replies = handle_batch("[" + kGetBalanceRequests + R"(,{"jsonrpc":"2.0","id":4,"method":"eth_blockNumber","params":[]}])");
+    REQUIRE(replies.size() == 4);
+    CHECK(replies[3]["id"] == 4);
+    // Just the batch transaction is begun, the group of eth_getBalance and eth_blockNumber lease it
+    CHECK(database_->num_begun == 1);
+    CHECK(database_->num_leased == 2);
+}
+
+TEST_CASE_METHOD(RequestHandlerTest, "RequestHandler authorizes the debug endpoints on the JWT port", "[silkrpc][http][request_handler]") {
+    const std::string secret{"2a64a2a4d0d6e2713c226cd6c1bd11a4c42c52a1f8a1dd5ed6cbff4fc8b8510f"};
+    RequestHandler jwt_handler{context_, workers_, socket_, rpc_api_table_, secret};
+    context_.sampling_profiler() = std::make_shared<SamplingProfiler>();
+
+    SECTION("metrics without token") {
+        Request request{"GET", kMetricsUri, 1, 1, {}, 0, ""};
+        Reply reply;
+        spawn_and_wait(jwt_handler.build_reply(request, reply));
+        CHECK(reply.status == StatusType::unauthorized);
+    }
+
+    SECTION("metrics with token") {
+        const auto token = jwt::create().set_issued_at(std::chrono::system_clock::now()).sign(jwt::algorithm::hs256{secret});
+        Request request{"GET", kMetricsUri, 1, 1, {{"Authorization", "Bearer " + token}}, 0, ""};
+        Reply reply;
+        spawn_and_wait(jwt_handler.build_reply(request, reply));
+        CHECK(reply.status == StatusType::ok);
+    }
+
+    SECTION("profile without token") {
+        Request request{"GET", std::string{kProfileUri} + "?seconds=1", 1, 1, {}, 0, ""};
+        Reply reply;
+        spawn_and_wait(jwt_handler.build_reply(request, reply));
+        CHECK(reply.status == StatusType::unauthorized);
+        CHECK(!SamplingProfiler::active());
+    }
+}
+
 } // namespace silkrpc::http
 
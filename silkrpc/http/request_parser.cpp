@@ -24,6 +24,8 @@
 
 #include <algorithm>
 
+#include <silkrpc/common/constants.hpp>
+
 namespace silkrpc::http {
 
 RequestParser::RequestParser() : state_(method_start) {
@@ -221,6 +223,8 @@ RequestParser::ResultType RequestParser::consume(Request& req, char input) {
                 if (req.content_length == 0) {
                     return good;
                 }
+                // Allocate the content buffer once, bounded in case of bogus Content-Length
+                req.content.reserve(std::min<std::size_t>(req.content_length, kRequestContentMaxPreallocatedSize));
                 // Look for Expect header to handle continuation request
                 const auto it = std::find_if(req.headers.begin(), req.headers.end(), [&](const Header& h){
                     return h == kExpectRequestHeader;
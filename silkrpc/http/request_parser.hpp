@@ -23,6 +23,9 @@
 #ifndef SILKRPC_HTTP_REQUEST_PARSER_HPP_
 #define SILKRPC_HTTP_REQUEST_PARSER_HPP_
 
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
 #include <tuple>
 
 #include "request.hpp"
@@ -47,14 +50,39 @@ public:
     /// has been consumed.
     template <typename InputIterator>
     ResultType parse(Request& req, InputIterator begin, InputIterator end) {
+        const auto [result, _] = parse_prefix(req, begin, end);
+        return result;
+    }
+
+    /// Parse some data stopping at the end of the first complete request. The enum return value is the same
+    /// as parse, the InputIterator return value points past the last consumed character so that any following
+    /// (i.e. pipelined) request already present in the input can be parsed by another call.
+    template <typename InputIterator>
+    std::tuple<ResultType, InputIterator> parse_prefix(Request& req, InputIterator begin, InputIterator end) {
         while (begin != end) {
+            if (state_ == content_start) {
+                // Append the content in bulk instead of char by char, the Content-Length is already known here
+                const auto available = static_cast<std::size_t>(std::distance(begin, end));
+                const auto count = std::min<std::size_t>(missing_content_size(req), available);
+                req.content.append(begin, std::next(begin, count));
+                std::advance(begin, count);
+                return {missing_content_size(req) == 0 ? good : indeterminate, begin};
+            }
             ResultType result = consume(req, *begin++);
             if (result == good || result == bad || result == processing_continue) {
-                return result;
+                return {result, begin};
             }
         }
 
-        return indeterminate;
+        return {indeterminate, begin};
+    }
+
+    /// Check if the headers have been parsed and the parser is now expecting some content.
+    bool is_parsing_content() const { return state_ == content_start; }
+
+    /// Get the number of content bytes still expected for the request, according to its Content-Length.
+    static std::size_t missing_content_size(const Request& req) {
+        return req.content.size() < req.content_length ? req.content_length - req.content.size() : 0;
     }
 
 private:
@@ -0,0 +1,75 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "request_parser.hpp"
+
+#include <algorithm>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+namespace silkrpc::http {
+
+static const std::string kRequestHeaders{
+    "POST / HTTP/1.1\r\n"
+    "Host: localhost:8545\r\n"
+    "User-Agent: Go-http-client/1.1\r\n"
+    "Accept: */*\r\n"
+    "Content-Type: application/json\r\n"
+    "Content-Length: "};
+
+static std::string make_request(std::size_t content_size) {
+    std::string content{R"({"jsonrpc":"2.0","id":1,"method":"eth_call","params":[{"data":"0x)"};
+    content.append(content_size > content.size() + 16 ? content_size - content.size() - 16 : 0, '0');
+    content.append(R"("},"latest"]})");
+    return kRequestHeaders + std::to_string(content.size()) + "\r\n\r\n" + content;
+}
+
+static void BM_RequestParser_parse(benchmark::State& state) {
+    const auto request = make_request(static_cast<std::size_t>(state.range(0)));
+    RequestParser parser;
+    Request req;
+    for (auto _ : state) {
+        parser.reset();
+        req.reset();
+        const auto result = parser.parse(req, request.data(), request.data() + request.size());
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * request.size()));
+}
+BENCHMARK(BM_RequestParser_parse)->Arg(128)->Arg(4 * 1024)->Arg(64 * 1024);
+
+//! The request received in small TCP segments, so that the parser is called many times for the same request
+static void BM_RequestParser_parse_segmented(benchmark::State& state) {
+    const auto request = make_request(4 * 1024);
+    const auto segment_size = static_cast<std::size_t>(state.range(0));
+    RequestParser parser;
+    Request req;
+    for (auto _ : state) {
+        parser.reset();
+        req.reset();
+        for (std::size_t offset{0}; offset < request.size(); offset += segment_size) {
+            const auto end = std::min(offset + segment_size, request.size());
+            const auto result = parser.parse(req, request.data() + offset, request.data() + end);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * request.size()));
+}
+BENCHMARK(BM_RequestParser_parse_segmented)->Arg(64)->Arg(1460);
+
+} // namespace silkrpc::http
@@ -141,6 +141,67 @@ TEST_CASE("parse", "[silkrpc][http][request_parser]") {
     }
 }
 
+TEST_CASE("parse_prefix", "[silkrpc][http][request_parser]") {
+    SECTION("pipelined requests") {
+        const std::string s{
+            "POST / HTTP/1.1\r\nContent-Length: 15\r\n\r\n{\"json\": \"2.0\"}"
+            "POST / HTTP/1.1\r\nContent-Length: 2\r\n\r\n{}"
+            "POST / HTTP/1.1\r\nContent-Length: 2\r\n"
+        };
+        silkrpc::http::RequestParser parser;
+        silkrpc::http::Request req1;
+        const auto [result1, end1] = parser.parse_prefix(req1, s.data(), s.data() + s.size());
+        CHECK(result1 == RequestParser::good);
+        CHECK(req1.content == "{\"json\": \"2.0\"}");
+        parser.reset();
+        silkrpc::http::Request req2;
+        const auto [result2, end2] = parser.parse_prefix(req2, end1, s.data() + s.size());
+        CHECK(result2 == RequestParser::good);
+        CHECK(req2.content == "{}");
+        parser.reset();
+        silkrpc::http::Request req3;
+        const auto [result3, end3] = parser.parse_prefix(req3, end2, s.data() + s.size());
+        CHECK(result3 == RequestParser::indeterminate);
+        CHECK(end3 == s.data() + s.size());
+    }
+}
+
+TEST_CASE("parse content", "[silkrpc][http][request_parser]") {
+    const std::string headers{"POST / HTTP/1.1\r\nContent-Length: 15\r\n\r\n"};
+    const std::string content{"{\"json\": \"2.0\"}"};
+    silkrpc::http::RequestParser parser;
+    silkrpc::http::Request req;
+
+    SECTION("content split across inputs") {
+        const auto result1{parser.parse(req, headers.data(), headers.data() + headers.size())};
+        CHECK(result1 == RequestParser::indeterminate);
+        CHECK(parser.is_parsing_content());
+        CHECK(RequestParser::missing_content_size(req) == 15);
+        CHECK(req.content.capacity() >= 15);
+        const auto result2{parser.parse(req, content.data(), content.data() + 6)};
+        CHECK(result2 == RequestParser::indeterminate);
+        CHECK(RequestParser::missing_content_size(req) == 9);
+        const auto result3{parser.parse(req, content.data() + 6, content.data() + content.size())};
+        CHECK(result3 == RequestParser::good);
+        CHECK(RequestParser::missing_content_size(req) == 0);
+        CHECK(req.content == content);
+    }
+
+    SECTION("content read outside the parser") {
+        const auto result{parser.parse(req, headers.data(), headers.data() + headers.size())};
+        CHECK(result == RequestParser::indeterminate);
+        CHECK(parser.is_parsing_content());
+        req.content = content;
+        CHECK(RequestParser::missing_content_size(req) == 0);
+    }
+
+    SECTION("headers not completed") {
+        const auto result{parser.parse(req, headers.data(), headers.data() + headers.size() - 2)};
+        CHECK(result == RequestParser::indeterminate);
+        CHECK(!parser.is_parsing_content());
+    }
+}
+
 TEST_CASE("reset", "[silkrpc][http][request_parser]") {
     silkrpc::http::RequestParser parser;
 
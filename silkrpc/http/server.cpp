@@ -22,13 +22,17 @@
 
 #include "server.hpp"
 
+#include <cstdio>
 #include <cstring>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <utility>
 
 #include <boost/asio/co_spawn.hpp>
 #include <boost/asio/dispatch.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
 #include <boost/asio/use_awaitable.hpp>
 
 #include <silkrpc/common/constants.hpp>
@@ -50,11 +54,49 @@ std::tuple<std::string, std::string> Server::parse_endpoint(const std::string& t
     return {host, port};
 }
 
-Server::Server(const std::string& end_point, const std::string& api_spec, Context& context, boost::asio::thread_pool& workers, std::optional<std::string> jwt_secret)
-: context_(context), workers_(workers), acceptor_{*context.io_context()}, handler_table_{api_spec}, jwt_secret_(jwt_secret) {
+Server::Server(const std::string& end_point, const std::string& api_spec, Context& context, WorkerPool& workers, std::optional<std::string> jwt_secret,
+    uint32_t max_pipelined_requests, uint32_t max_batch_concurrency, CompressionSettings compression_settings,
+    ConnectionSettings connection_settings, std::shared_ptr<ConnectionManager> connection_manager)
+: context_(context), workers_(workers), acceptor_{*context.io_context()}, handler_table_{api_spec}, jwt_secret_(jwt_secret),
+  max_pipelined_requests_(max_pipelined_requests), max_batch_concurrency_(max_batch_concurrency),
+  compression_settings_(compression_settings), connection_settings_(connection_settings),
+  connection_manager_(std::move(connection_manager)) {
+    open(end_point);
+}
+
+Server::Server(const std::string& end_point, const std::string& api_spec, ContextPool& context_pool, WorkerPool& workers, std::optional<std::string> jwt_secret,
+    uint32_t max_pipelined_requests, uint32_t max_batch_concurrency, CompressionSettings compression_settings,
+    ConnectionSettings connection_settings, std::shared_ptr<ConnectionManager> connection_manager)
+: Server(end_point, api_spec, context_pool.next_context(), workers, jwt_secret, max_pipelined_requests, max_batch_concurrency, compression_settings,
+    connection_settings, std::move(connection_manager)) {
+    context_pool_ = &context_pool;
+}
+
+Server::~Server() {
+    if (!unix_socket_path_.empty()) {
+        std::remove(unix_socket_path_.c_str());
+    }
+}
+
+void Server::open(const std::string& end_point) {
+    if (end_point.rfind(kUnixSocketPrefix, 0) == 0) {
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+        unix_socket_path_ = end_point.substr(std::strlen(kUnixSocketPrefix));
+
+        // Remove any stale socket file left behind by a previous run, otherwise bind fails with address in use.
+        std::remove(unix_socket_path_.c_str());
+        const boost::asio::local::stream_protocol::endpoint endpoint{unix_socket_path_};
+        acceptor_.open(endpoint.protocol());
+        acceptor_.bind(endpoint);
+#else
+        throw std::runtime_error{"Unix domain sockets not supported on this platform: " + end_point};
+#endif
+        return;
+    }
+
     const auto [host, port] = parse_endpoint(end_point);
 
-    // Open the acceptor with the option to reuse the address (i.e. SO_REUSEADDR).
+    // Open the acceptor with the option to reuse the address (i.e. SO_REUSEADDR) and port (i.e. SO_REUSEPORT).
     boost::asio::ip::tcp::resolver resolver{acceptor_.get_executor()};
     boost::asio::ip::tcp::endpoint endpoint = *resolver.resolve(host, port).begin();
     acceptor_.open(endpoint.protocol());
@@ -74,18 +116,22 @@ boost::asio::awaitable<void> Server::run() {
 
     try {
         while (acceptor_.is_open()) {
-            auto io_context = context_.io_context();
+            auto& connection_context = context_pool_ ? context_pool_->next_context() : context_;
+            auto io_context = connection_context.io_context();
 
             SILKRPC_DEBUG << "Server::run accepting using io_context " << io_context << "...\n" << std::flush;
 
-            auto new_connection = std::make_shared<Connection>(context_, workers_, handler_table_, jwt_secret_);
+            auto new_connection = std::make_shared<Connection>(connection_context, workers_, handler_table_, jwt_secret_, max_pipelined_requests_,
+                max_batch_concurrency_, compression_settings_, connection_settings_, connection_manager_);
             co_await acceptor_.async_accept(new_connection->socket(), boost::asio::use_awaitable);
             if (!acceptor_.is_open()) {
                 SILKRPC_TRACE << "Server::run returning...\n";
                 co_return;
             }
 
-            new_connection->socket().set_option(boost::asio::ip::tcp::socket::keep_alive(true));
+            if (unix_socket_path_.empty()) {
+                new_connection->socket().set_option(boost::asio::ip::tcp::socket::keep_alive(true));
+            }
 
             SILKRPC_TRACE << "Server::run starting connection for socket: " << &new_connection->socket() << "\n";
             auto new_connection_starter = [=]() -> boost::asio::awaitable<void> { co_await new_connection->start(); };
@@ -23,6 +23,7 @@
 #ifndef SILKRPC_HTTP_SERVER_HPP_
 #define SILKRPC_HTTP_SERVER_HPP_
 
+#include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -30,10 +31,14 @@
 #include <silkrpc/config.hpp>
 
 #include <boost/asio/awaitable.hpp>
-#include <boost/asio/ip/tcp.hpp>
-#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/basic_socket_acceptor.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
 
+#include <silkrpc/common/constants.hpp>
 #include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/concurrency/worker_pool.hpp>
+#include <silkrpc/http/compression.hpp>
+#include <silkrpc/http/connection_manager.hpp>
 #include <silkrpc/http/request_handler.hpp>
 
 #include <silkrpc/commands/rpc_api_table.hpp>
@@ -41,21 +46,42 @@
 namespace silkrpc::http {
 
 /// The top-level class of the HTTP server.
+/// The end-point is either a TCP end-point <address>:<port> or a Unix domain socket path prefixed by kUnixSocketPrefix.
+/// TCP servers are meant to be created once per context on the same end-point: each one has its own acceptor with
+/// SO_REUSEPORT, so that the kernel load-balances the incoming connections among the contexts.
 class Server {
 public:
     Server(const Server&) = delete;
     Server& operator=(const Server&) = delete;
 
-    // Construct the server to listen on the specified local TCP end-point
-    explicit Server(const std::string& end_point, const std::string& api_spec, Context& context, boost::asio::thread_pool& workers, std::optional<std::string> jwt_secret);
+    // Construct the server to listen on the specified local end-point, serving all connections within the given context
+    explicit Server(const std::string& end_point, const std::string& api_spec, Context& context, WorkerPool& workers, std::optional<std::string> jwt_secret,
+        uint32_t max_pipelined_requests = kDefaultMaxPipelinedRequests, uint32_t max_batch_concurrency = kDefaultMaxBatchConcurrency,
+        CompressionSettings compression_settings = {}, ConnectionSettings connection_settings = {},
+        std::shared_ptr<ConnectionManager> connection_manager = nullptr);
+
+    // Construct the server to listen on the specified local end-point, spreading the connections over the context pool
+    // [useful for Unix domain sockets, whose acceptors cannot be load-balanced by the kernel]
+    explicit Server(const std::string& end_point, const std::string& api_spec, ContextPool& context_pool, WorkerPool& workers, std::optional<std::string> jwt_secret,
+        uint32_t max_pipelined_requests = kDefaultMaxPipelinedRequests, uint32_t max_batch_concurrency = kDefaultMaxBatchConcurrency,
+        CompressionSettings compression_settings = {}, ConnectionSettings connection_settings = {},
+        std::shared_ptr<ConnectionManager> connection_manager = nullptr);
+
+    ~Server();
 
     void start();
 
     void stop();
 
+    // The repository of API request handlers, reloadable while running
+    commands::RpcApiTable& handler_table() noexcept { return handler_table_; }
+
 private:
     static std::tuple<std::string, std::string> parse_endpoint(const std::string& tcp_end_point);
 
+    // Open and bind the acceptor on the specified end-point
+    void open(const std::string& end_point);
+
     boost::asio::awaitable<void> run();
 
     // The repository of API request handlers
@@ -64,11 +90,32 @@ private:
     // The context used to perform asynchronous operations
     Context& context_;
 
-    // The acceptor used to listen for incoming TCP connections
-    boost::asio::ip::tcp::acceptor acceptor_;
+    // The pool of contexts where connections are spread, if any (otherwise connections use context_)
+    ContextPool* context_pool_{nullptr};
+
+    // The acceptor used to listen for incoming TCP or Unix domain socket connections
+    boost::asio::basic_socket_acceptor<boost::asio::generic::stream_protocol> acceptor_;
+
+    // The path of Unix domain socket, empty for TCP end-points
+    std::string unix_socket_path_;
 
-    boost::asio::thread_pool& workers_;
+    WorkerPool& workers_;
     std::optional<std::string> jwt_secret_;
+
+    // The max number of pipelined requests executed concurrently on each connection
+    uint32_t max_pipelined_requests_;
+
+    // The max number of batch elements executed concurrently on each request
+    uint32_t max_batch_concurrency_;
+
+    // The settings for compressing the replies on each connection
+    CompressionSettings compression_settings_;
+
+    // The timeouts and the max number of requests of each connection
+    ConnectionSettings connection_settings_;
+
+    // The registry of the open connections shared with the other servers, if any
+    std::shared_ptr<ConnectionManager> connection_manager_;
 };
 
 } // namespace silkrpc::http
@@ -0,0 +1,327 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "cbor_transcoder.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace silkrpc::json {
+
+namespace {
+
+constexpr uint8_t kCborUnsigned{0};
+constexpr uint8_t kCborNegative{1};
+constexpr uint8_t kCborBytes{2};
+constexpr uint8_t kCborText{3};
+constexpr uint8_t kCborTag{6};
+constexpr uint64_t kCborTagBignum{2};
+constexpr uint8_t kCborIndefiniteArray{0x9f};
+constexpr uint8_t kCborIndefiniteMap{0xbf};
+constexpr uint8_t kCborBreak{0xff};
+constexpr uint8_t kCborFalse{0xf4};
+constexpr uint8_t kCborTrue{0xf5};
+constexpr uint8_t kCborNull{0xf6};
+constexpr uint8_t kCborDouble{0xfb};
+
+//! The max number of hex digits of the quantities given as unsigned integers
+constexpr std::size_t kMaxQuantityDigits{16};
+
+//! The type of the JSON RPC fields, as given by the Ethereum JSON RPC specification
+enum class FieldType {
+    kText,
+    kQuantity,
+    kData,
+};
+
+FieldType field_type(std::string_view field) {
+    static const std::unordered_map<std::string_view, FieldType> kFieldTypes{
+        {"balance", FieldType::kQuantity},
+        {"baseFeePerGas", FieldType::kQuantity},
+        {"blockNumber", FieldType::kQuantity},
+        {"chainId", FieldType::kQuantity},
+        {"cumulativeGasUsed", FieldType::kQuantity},
+        {"currentBlock", FieldType::kQuantity},
+        {"difficulty", FieldType::kQuantity},
+        {"effectiveGasPrice", FieldType::kQuantity},
+        {"gas", FieldType::kQuantity},
+        {"gasLimit", FieldType::kQuantity},
+        {"gasPrice", FieldType::kQuantity},
+        {"gasUsed", FieldType::kQuantity},
+        {"highestBlock", FieldType::kQuantity},
+        {"logIndex", FieldType::kQuantity},
+        {"maxFeePerGas", FieldType::kQuantity},
+        {"maxPriorityFeePerGas", FieldType::kQuantity},
+        {"nonce", FieldType::kQuantity},
+        {"number", FieldType::kQuantity},
+        {"oldestBlock", FieldType::kQuantity},
+        {"r", FieldType::kQuantity},
+        {"reward", FieldType::kQuantity},
+        {"s", FieldType::kQuantity},
+        {"size", FieldType::kQuantity},
+        {"startingBlock", FieldType::kQuantity},
+        {"status", FieldType::kQuantity},
+        {"timestamp", FieldType::kQuantity},
+        {"totalDifficulty", FieldType::kQuantity},
+        {"transactionIndex", FieldType::kQuantity},
+        {"type", FieldType::kQuantity},
+        {"v", FieldType::kQuantity},
+        {"value", FieldType::kQuantity},
+        {"yParity", FieldType::kQuantity},
+        {"accountProof", FieldType::kData},
+        {"address", FieldType::kData},
+        {"blockHash", FieldType::kData},
+        {"code", FieldType::kData},
+        {"codeHash", FieldType::kData},
+        {"contractAddress", FieldType::kData},
+        {"data", FieldType::kData},
+        {"extraData", FieldType::kData},
+        {"from", FieldType::kData},
+        {"hash", FieldType::kData},
+        {"init", FieldType::kData},
+        {"input", FieldType::kData},
+        {"key", FieldType::kData},
+        {"logsBloom", FieldType::kData},
+        {"miner", FieldType::kData},
+        {"mixHash", FieldType::kData},
+        {"output", FieldType::kData},
+        {"parentHash", FieldType::kData},
+        {"proof", FieldType::kData},
+        {"receiptsRoot", FieldType::kData},
+        {"root", FieldType::kData},
+        {"sha3Uncles", FieldType::kData},
+        {"stateRoot", FieldType::kData},
+        {"storageHash", FieldType::kData},
+        {"storageKeys", FieldType::kData},
+        {"to", FieldType::kData},
+        {"topics", FieldType::kData},
+        {"transactionHash", FieldType::kData},
+        {"transactions", FieldType::kData},
+        {"transactionsRoot", FieldType::kData},
+        {"uncles", FieldType::kData},
+    };
+    const auto it = kFieldTypes.find(field);
+    return it != kFieldTypes.end() ? it->second : FieldType::kText;
+}
+
+int hex_digit(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+//! SAX handler of nlohmann::json writing the CBOR items as the JSON values are parsed
+class CborSaxWriter {
+  public:
+    using number_integer_t = nlohmann::json::number_integer_t;
+    using number_unsigned_t = nlohmann::json::number_unsigned_t;
+    using number_float_t = nlohmann::json::number_float_t;
+    using string_t = nlohmann::json::string_t;
+    using binary_t = nlohmann::json::binary_t;
+
+    explicit CborSaxWriter(std::string& out) : out_(out) {}
+
+    bool null() { return write_byte(kCborNull); }
+
+    bool boolean(bool value) { return write_byte(value ? kCborTrue : kCborFalse); }
+
+    bool number_integer(number_integer_t value) {
+        if (value >= 0) {
+            write_head(kCborUnsigned, static_cast<uint64_t>(value));
+        } else {
+            write_head(kCborNegative, static_cast<uint64_t>(-(value + 1)));
+        }
+        return true;
+    }
+
+    bool number_unsigned(number_unsigned_t value) {
+        write_head(kCborUnsigned, value);
+        return true;
+    }
+
+    bool number_float(number_float_t value, const string_t& /*text*/) {
+        write_byte(kCborDouble);
+        const auto bits = std::bit_cast<uint64_t>(static_cast<double>(value));
+        for (int shift{56}; shift >= 0; shift -= 8) {
+            out_.push_back(static_cast<char>((bits >> shift) & 0xff));
+        }
+        return true;
+    }
+
+    bool string(string_t& value) {
+        if (!write_hex(value)) {
+            write_text(value);
+        }
+        return true;
+    }
+
+    bool binary(binary_t& value) {
+        write_head(kCborBytes, value.size());
+        out_.append(reinterpret_cast<const char*>(value.data()), value.size());
+        return true;
+    }
+
+    bool start_object(std::size_t /*num_elements*/) {
+        fields_.emplace_back();
+        return write_byte(kCborIndefiniteMap);
+    }
+
+    bool key(string_t& value) {
+        fields_.back() = value;
+        write_text(value);
+        return true;
+    }
+
+    bool end_object() {
+        fields_.pop_back();
+        return write_byte(kCborBreak);
+    }
+
+    bool start_array(std::size_t /*num_elements*/) {
+        fields_.emplace_back(current_field());
+        return write_byte(kCborIndefiniteArray);
+    }
+
+    bool end_array() {
+        fields_.pop_back();
+        return write_byte(kCborBreak);
+    }
+
+    bool parse_error(std::size_t /*position*/, const std::string& /*last_token*/, const nlohmann::detail::exception& /*ex*/) {
+        return false;
+    }
+
+  private:
+    bool write_byte(uint8_t byte) {
+        out_.push_back(static_cast<char>(byte));
+        return true;
+    }
+
+    void write_head(uint8_t major, uint64_t argument) {
+        const auto initial = static_cast<uint8_t>(major << 5);
+        if (argument < 24) {
+            write_byte(initial | static_cast<uint8_t>(argument));
+            return;
+        }
+        std::size_t size{8};
+        uint8_t info{27};
+        if (argument <= UINT8_MAX) {
+            size = 1, info = 24;
+        } else if (argument <= UINT16_MAX) {
+            size = 2, info = 25;
+        } else if (argument <= UINT32_MAX) {
+            size = 4, info = 26;
+        }
+        write_byte(initial | info);
+        for (auto i{size}; i > 0; --i) {
+            out_.push_back(static_cast<char>((argument >> (8 * (i - 1))) & 0xff));
+        }
+    }
+
+    void write_text(const string_t& value) {
+        write_head(kCborText, value.size());
+        out_.append(value);
+    }
+
+    //! Return the current field, i.e. the key of the innermost object whose values (or array elements) are being parsed
+    std::string_view current_field() const { return fields_.empty() ? std::string_view{} : std::string_view{fields_.back()}; }
+
+    //! Write the hex string with 0x prefix as given by the type of the current field, returning false if it has no binary
+    //! form (i.e. not a QUANTITY nor DATA field or not a hex string)
+    bool write_hex(const string_t& value) {
+        const auto type = field_type(current_field());
+        if (type == FieldType::kText || value.size() < 2 || value[0] != '0' || value[1] != 'x') {
+            return false;
+        }
+        std::string_view digits{value.data() + 2, value.size() - 2};
+        for (const auto c : digits) {
+            if (hex_digit(c) < 0) {
+                return false;
+            }
+        }
+        if (type == FieldType::kQuantity) {
+            if (digits.empty()) {
+                return false;
+            }
+            const auto first_significant = digits.find_first_not_of('0');
+            digits.remove_prefix(first_significant == std::string_view::npos ? digits.size() : first_significant);
+            if (digits.size() <= kMaxQuantityDigits) {
+                uint64_t quantity{0};
+                for (const auto c : digits) {
+                    quantity = (quantity << 4) | static_cast<uint64_t>(hex_digit(c));
+                }
+                write_head(kCborUnsigned, quantity);
+                return true;
+            }
+            write_head(kCborTag, kCborTagBignum);
+        }
+        write_bytes(digits);
+        return true;
+    }
+
+    //! Write the hex digits as byte string, padded with a leading zero digit if odd-length
+    void write_bytes(std::string_view digits) {
+        const auto odd = digits.size() % 2;
+        write_head(kCborBytes, (digits.size() + odd) / 2);
+        std::size_t i{0};
+        if (odd) {
+            out_.push_back(static_cast<char>(hex_digit(digits[0])));
+            i = 1;
+        }
+        for (; i < digits.size(); i += 2) {
+            out_.push_back(static_cast<char>((hex_digit(digits[i]) << 4) | hex_digit(digits[i + 1])));
+        }
+    }
+
+    std::string& out_;
+    //! The field of each open container: the last key for objects, the enclosing field for arrays
+    std::vector<std::string> fields_;
+};
+
+} // namespace
+
+bool transcode_to_cbor(const std::vector<std::string_view>& parts, std::string& out) {
+    CborSaxWriter writer{out};
+    if (parts.size() == 1) {
+        return nlohmann::json::sax_parse(parts[0].begin(), parts[0].end(), &writer);
+    }
+    std::string text;
+    std::size_t size{0};
+    for (const auto& part : parts) {
+        size += part.size();
+    }
+    text.reserve(size);
+    for (const auto& part : parts) {
+        text.append(part);
+    }
+    return nlohmann::json::sax_parse(text, &writer);
+}
+
+} // namespace silkrpc::json
@@ -0,0 +1,43 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_JSON_CBOR_TRANSCODER_HPP_
+#define SILKRPC_JSON_CBOR_TRANSCODER_HPP_
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Transcoder of the JSON RPC replies into CBOR (RFC 8949), the compact binary format consumed by the clients asking for
+// application/cbor. The hex strings with 0x prefix are given in binary form according to the type of their field in the
+// Ethereum JSON RPC specification, whatever their value:
+// - the QUANTITY fields (e.g. blockNumber, gas, nonce, value) become unsigned integers, or bignums beyond 64 bits
+// - the DATA fields (e.g. hashes, addresses, input, data, logsBloom) become byte strings, padded with a leading zero digit
+//   if odd-length
+// while any other string (e.g. id, result, error messages) is kept as text. The elements of an array have the type of
+// the field holding it (e.g. topics). Objects and arrays are given with indefinite length, since the text is transcoded
+// in one pass without knowing their size in advance.
+
+namespace silkrpc::json {
+
+//! Append to the output the CBOR encoding of the JSON text made of the concatenation of the parts, returning false
+//! (leaving the output unspecified) if the text is not well-formed
+bool transcode_to_cbor(const std::vector<std::string_view>& parts, std::string& out);
+
+} // namespace silkrpc::json
+
+#endif  // SILKRPC_JSON_CBOR_TRANSCODER_HPP_
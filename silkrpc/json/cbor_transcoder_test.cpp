@@ -0,0 +1,123 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "cbor_transcoder.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <nlohmann/json.hpp>
+
+namespace silkrpc::json {
+
+static nlohmann::json transcode(const std::vector<std::string_view>& parts) {
+    std::string cbor;
+    REQUIRE(transcode_to_cbor(parts, cbor));
+    return nlohmann::json::from_cbor(cbor);
+}
+
+static nlohmann::json binary(const std::vector<std::uint8_t>& bytes) {
+    return nlohmann::json::binary(bytes);
+}
+
+TEST_CASE("transcode_to_cbor plain values", "[silkrpc][json][cbor_transcoder]") {
+    CHECK(transcode({"null"}) == nullptr);
+    CHECK(transcode({"true"}) == true);
+    CHECK(transcode({"false"}) == false);
+    CHECK(transcode({"0"}) == 0);
+    CHECK(transcode({"23"}) == 23);
+    CHECK(transcode({"24"}) == 24);
+    CHECK(transcode({"65536"}) == 65536);
+    CHECK(transcode({"18446744073709551615"}) == UINT64_MAX);
+    CHECK(transcode({"-32000"}) == -32000);
+    CHECK(transcode({"0.5"}) == 0.5);
+    CHECK(transcode({"\"2.0\""}) == "2.0");
+    CHECK(transcode({"\"0xzz\""}) == "0xzz");
+    CHECK(transcode({"\"\""}) == "");
+}
+
+static nlohmann::json field(const std::string& name, const std::string& value) {
+    const auto json = transcode({R"({")" + name + R"(":")" + value + R"("})"});
+    REQUIRE(json.contains(name));
+    return json[name];
+}
+
+TEST_CASE("transcode_to_cbor hex strings", "[silkrpc][json][cbor_transcoder]") {
+    SECTION("quantities") {
+        CHECK(field("blockNumber", "0x0") == 0);
+        CHECK(field("gas", "0x1f") == 0x1f);
+        CHECK(field("nonce", "0x01") == 1);
+        CHECK(field("value", "0xffffffffffffffff") == UINT64_MAX);
+        CHECK(field("baseFeePerGas", "0x") == "0x");
+        CHECK(field("status", "ok") == "ok");
+    }
+
+    SECTION("larger quantities") {
+        // nlohmann::json does not decode the bignum tag (2), so just check the encoding
+        std::string cbor;
+        REQUIRE(transcode_to_cbor({R"({"value":"0x010000000000000000"})"}, cbor));
+        CHECK(cbor == std::string{"\xbf\x65value\xc2\x49\x01\x00\x00\x00\x00\x00\x00\x00\x00\xff", 19});
+    }
+
+    SECTION("data") {
+        CHECK(field("input", "0xa9059cbb") == binary({0xa9, 0x05, 0x9c, 0xbb}));
+        CHECK(field("data", "0x1") == binary({0x01}));
+        CHECK(field("data", "0x01") == binary({0x01}));
+        CHECK(field("data", "0x") == binary({}));
+        CHECK(field("hash", "0x00ff") == binary({0x00, 0xff}));
+        CHECK(field("address", "0x0AbC") == binary({0x0a, 0xbc}));
+    }
+
+    SECTION("other fields") {
+        CHECK(field("id", "0x1") == "0x1");
+        CHECK(field("result", "0x0a") == "0x0a");
+        CHECK(transcode({"\"0x1\""}) == "0x1");
+    }
+
+    SECTION("arrays") {
+        const auto json = transcode({R"({"topics":["0x01","0x02"],"reward":[["0x0a"]],"uncles":[]})"});
+        CHECK(json["topics"] == nlohmann::json{binary({0x01}), binary({0x02})});
+        CHECK(json["reward"] == nlohmann::json{{10}});
+        CHECK(json["uncles"] == nlohmann::json::array());
+    }
+}
+
+TEST_CASE("transcode_to_cbor replies", "[silkrpc][json][cbor_transcoder]") {
+    SECTION("single reply") {
+        const auto json = transcode({R"({"id":1,"jsonrpc":"2.0","result":{"blockNumber":"0x10","topics":["0x00ff"]}})" "\n"});
+        CHECK(json == nlohmann::json{{"id", 1}, {"jsonrpc", "2.0"}, {"result", {{"blockNumber", 16}, {"topics", {binary({0x00, 0xff})}}}}});
+    }
+
+    SECTION("batch reply in parts") {
+        const auto json = transcode({"[", R"({"id":"0x1","result":"0x1"})", ",", R"({"id":2,"error":{"code":-32000,"message":"x"}})", "]\n"});
+        REQUIRE(json.is_array());
+        REQUIRE(json.size() == 2);
+        CHECK(json[0] == nlohmann::json{{"id", "0x1"}, {"result", "0x1"}});
+        CHECK(json[1] == nlohmann::json{{"id", 2}, {"error", {{"code", -32000}, {"message", "x"}}}});
+    }
+
+    SECTION("malformed") {
+        std::string cbor;
+        CHECK(!transcode_to_cbor({"\n"}, cbor));
+        CHECK(!transcode_to_cbor({"{\"id\":"}, cbor));
+        CHECK(!transcode_to_cbor({"[1", "2"}, cbor));
+    }
+}
+
+} // namespace silkrpc::json
@@ -0,0 +1,67 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "projection.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace silkrpc {
+
+namespace {
+
+constexpr std::string_view kTransactionsPrefix{"transactions."};
+
+template <std::size_t N>
+FieldMask bit_of(const std::array<std::string_view, N>& field_names, std::string_view name, std::string_view full_name) {
+    const auto name_it = std::find(field_names.cbegin(), field_names.cend(), name);
+    if (name_it == field_names.cend()) {
+        throw std::invalid_argument{"unknown field: " + std::string{full_name}};
+    }
+    return FieldMask{1} << (name_it - field_names.cbegin());
+}
+
+} // namespace
+
+FieldProjection make_block_projection(const std::vector<std::string>& names) {
+    FieldProjection projection{0, 0};
+    bool all_transaction_fields{false};
+    for (const std::string_view name : names) {
+        if (name.starts_with(kTransactionsPrefix)) {
+            projection.transaction_fields |= bit_of(kTransactionFieldNames, name.substr(kTransactionsPrefix.size()), name);
+            projection.fields |= FieldMask{1} << block_field::transactions;
+        } else {
+            const auto bit = bit_of(kBlockFieldNames, name, name);
+            all_transaction_fields |= bit == FieldMask{1} << block_field::transactions;
+            projection.fields |= bit;
+        }
+    }
+    if (all_transaction_fields) {
+        projection.transaction_fields = kAllFields;
+    }
+    return projection;
+}
+
+FieldProjection make_receipt_projection(const std::vector<std::string>& names) {
+    FieldProjection projection{0, kAllFields};
+    for (const std::string_view name : names) {
+        projection.fields |= bit_of(kReceiptFieldNames, name, name);
+    }
+    return projection;
+}
+
+} // namespace silkrpc
@@ -0,0 +1,99 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_JSON_PROJECTION_HPP_
+#define SILKRPC_JSON_PROJECTION_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Field projections selecting which fields of the block and receipt JSON objects are written by the typed writers.
+// Each field is identified by its index in the list of names of its object, which follows the lexicographic order they
+// are written in.
+
+namespace silkrpc {
+
+//! The bitmask of the written fields of one JSON object, having the bit at the index of each selected field set
+using FieldMask = uint32_t;
+
+constexpr FieldMask kAllFields{std::numeric_limits<FieldMask>::max()};
+
+constexpr bool is_selected(FieldMask mask, std::size_t field) noexcept { return ((mask >> field) & 1u) != 0; }
+
+namespace block_field {
+enum : std::size_t {
+    base_fee_per_gas, difficulty, extra_data, gas_limit, gas_used, hash, logs_bloom, miner, mix_hash, nonce, number,
+    parent_hash, receipts_root, sha3_uncles, size, state_root, timestamp, total_difficulty, transactions,
+    transactions_root, uncles, count
+};
+} // namespace block_field
+
+namespace transaction_field {
+enum : std::size_t {
+    access_list, block_hash, block_number, chain_id, from, gas, gas_price, hash, input, max_fee_per_gas,
+    max_priority_fee_per_gas, nonce, r, s, to, transaction_index, type, v, value, count
+};
+} // namespace transaction_field
+
+namespace receipt_field {
+enum : std::size_t {
+    block_hash, block_number, contract_address, cumulative_gas_used, effective_gas_price, from, gas_used, logs,
+    logs_bloom, status, to, transaction_hash, transaction_index, type, count
+};
+} // namespace receipt_field
+
+constexpr std::array<std::string_view, block_field::count> kBlockFieldNames{
+    "baseFeePerGas", "difficulty", "extraData", "gasLimit", "gasUsed", "hash", "logsBloom", "miner", "mixHash", "nonce",
+    "number", "parentHash", "receiptsRoot", "sha3Uncles", "size", "stateRoot", "timestamp", "totalDifficulty",
+    "transactions", "transactionsRoot", "uncles"
+};
+
+constexpr std::array<std::string_view, transaction_field::count> kTransactionFieldNames{
+    "accessList", "blockHash", "blockNumber", "chainId", "from", "gas", "gasPrice", "hash", "input", "maxFeePerGas",
+    "maxPriorityFeePerGas", "nonce", "r", "s", "to", "transactionIndex", "type", "v", "value"
+};
+
+constexpr std::array<std::string_view, receipt_field::count> kReceiptFieldNames{
+    "blockHash", "blockNumber", "contractAddress", "cumulativeGasUsed", "effectiveGasPrice", "from", "gasUsed", "logs",
+    "logsBloom", "status", "to", "transactionHash", "transactionIndex", "type"
+};
+
+//! The fields written of the block or receipt objects, plus those of the full transactions nested in the blocks
+struct FieldProjection {
+    FieldMask fields{kAllFields};
+    FieldMask transaction_fields{kAllFields};
+
+    bool is_full() const noexcept { return fields == kAllFields && transaction_fields == kAllFields; }
+};
+
+//! Make the projection of the blocks on the named fields, where "transactions.<name>" selects one field of the full
+//! transactions (and the transactions themselves), while "transactions" alone selects all of them.
+//! \throws std::invalid_argument if any field is unknown
+FieldProjection make_block_projection(const std::vector<std::string>& names);
+
+//! Make the projection of the receipts on the named fields
+//! \throws std::invalid_argument if any field is unknown
+FieldProjection make_receipt_projection(const std::vector<std::string>& names);
+
+} // namespace silkrpc
+
+#endif  // SILKRPC_JSON_PROJECTION_HPP_
@@ -0,0 +1,83 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "projection.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+TEST_CASE("field names follow the lexicographic order", "[silkrpc][json][projection]") {
+    CHECK(std::is_sorted(kBlockFieldNames.cbegin(), kBlockFieldNames.cend()));
+    CHECK(std::is_sorted(kTransactionFieldNames.cbegin(), kTransactionFieldNames.cend()));
+    CHECK(std::is_sorted(kReceiptFieldNames.cbegin(), kReceiptFieldNames.cend()));
+}
+
+TEST_CASE("make_block_projection", "[silkrpc][json][projection]") {
+    SECTION("default projection is full") {
+        CHECK(FieldProjection{}.is_full());
+    }
+    SECTION("no fields") {
+        const auto projection = make_block_projection({});
+        CHECK(projection.fields == 0);
+        CHECK(projection.transaction_fields == 0);
+        CHECK(!projection.is_full());
+    }
+    SECTION("block fields only") {
+        const auto projection = make_block_projection({"hash", "number"});
+        CHECK(is_selected(projection.fields, block_field::hash));
+        CHECK(is_selected(projection.fields, block_field::number));
+        CHECK(!is_selected(projection.fields, block_field::size));
+        CHECK(!is_selected(projection.fields, block_field::transactions));
+    }
+    SECTION("transaction fields select the transactions") {
+        const auto projection = make_block_projection({"transactions.hash", "transactions.from"});
+        CHECK(is_selected(projection.fields, block_field::transactions));
+        CHECK(!is_selected(projection.fields, block_field::hash));
+        CHECK(is_selected(projection.transaction_fields, transaction_field::hash));
+        CHECK(is_selected(projection.transaction_fields, transaction_field::from));
+        CHECK(!is_selected(projection.transaction_fields, transaction_field::input));
+    }
+    SECTION("transactions select all their fields") {
+        const auto projection = make_block_projection({"transactions.hash", "transactions"});
+        CHECK(is_selected(projection.fields, block_field::transactions));
+        CHECK(projection.transaction_fields == kAllFields);
+    }
+    SECTION("unknown fields") {
+        CHECK_THROWS_AS(make_block_projection({"hash", "foo"}), std::invalid_argument);
+        CHECK_THROWS_AS(make_block_projection({"transactions.foo"}), std::invalid_argument);
+        CHECK_THROWS_AS(make_block_projection({"transactions."}), std::invalid_argument);
+    }
+}
+
+TEST_CASE("make_receipt_projection", "[silkrpc][json][projection]") {
+    SECTION("receipt fields") {
+        const auto projection = make_receipt_projection({"status", "gasUsed"});
+        CHECK(is_selected(projection.fields, receipt_field::status));
+        CHECK(is_selected(projection.fields, receipt_field::gas_used));
+        CHECK(!is_selected(projection.fields, receipt_field::logs));
+    }
+    SECTION("unknown fields") {
+        CHECK_THROWS_AS(make_receipt_projection({"number"}), std::invalid_argument);
+        CHECK_THROWS_AS(make_receipt_projection({"transactions.hash"}), std::invalid_argument);
+    }
+}
+
+} // namespace silkrpc
@@ -1,27 +1,151 @@
 /*
-    Copyright 2022 The Silkrpc Authors
+   Copyright 2022 The Silkrpc Authors
 
-    Licensed under the Apache License, Version 2.0 (the "License");
-    you may not use this file except in compliance with the License.
-    You may obtain a copy of the License at
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
 
-        http://www.apache.org/licenses/LICENSE-2.0
+       http://www.apache.org/licenses/LICENSE-2.0
 
-    Unless required by applicable law or agreed to in writing, software
-    distributed under the License is distributed on an "AS IS" BASIS,
-    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
-    See the License for the specific language governing permissions and
-    limitations under the License.
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
 */
 
 #include "stream.hpp"
 
+#include <array>
+#include <charconv>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/write.hpp>
+
 namespace json {
+
+static constexpr std::string_view kChunkSeparator{"\r\n"};
+static constexpr std::string_view kLastChunk{"0\r\n\r\n"};
+
 boost::asio::awaitable<void> Stream::flush() {
-    co_return;
+    if (buffer_.empty()) {
+        co_return;
+    }
+    co_await write_chunk(buffer_);
+    buffer_.clear();
+}
+
+boost::asio::awaitable<void> Stream::close() {
+    if (closed_) {
+        co_return;
+    }
+    co_await flush();
+    closed_ = true;
+    co_await write_chunk({});
+}
+
+boost::asio::awaitable<void> Stream::write(std::string_view text) {
+    buffer_ += text;
+    bytes_written_ += text.size();
+    co_await flush_if_needed();
 }
 
 boost::asio::awaitable<void> Stream::write_json(const nlohmann::json& json) {
-    co_return;
+    co_await write(json.dump());
+}
+
+boost::asio::awaitable<void> Stream::open_object() {
+    begin_value();
+    has_items_.push_back(false);
+    co_await write("{");
+}
+
+boost::asio::awaitable<void> Stream::close_object() {
+    has_items_.pop_back();
+    co_await write("}");
+}
+
+boost::asio::awaitable<void> Stream::open_array() {
+    begin_value();
+    has_items_.push_back(false);
+    co_await write("[");
+}
+
+boost::asio::awaitable<void> Stream::close_array() {
+    has_items_.pop_back();
+    co_await write("]");
 }
+
+boost::asio::awaitable<void> Stream::write_field(std::string_view name) {
+    begin_value();
+    field_pending_ = true;
+    buffer_ += '"';
+    buffer_ += name;
+    buffer_ += "\":";
+    bytes_written_ += name.size() + 3;
+    co_await flush_if_needed();
+}
+
+boost::asio::awaitable<void> Stream::write_field(std::string_view name, const nlohmann::json& value) {
+    co_await write_field(name);
+    begin_value();
+    co_await write_json(value);
+}
+
+boost::asio::awaitable<void> Stream::write_entry(const nlohmann::json& value) {
+    begin_value();
+    co_await write_json(value);
+}
+
+void Stream::begin_value() {
+    if (field_pending_) {
+        field_pending_ = false;
+        return;
+    }
+    if (has_items_.empty()) {
+        return;
+    }
+    if (has_items_.back()) {
+        buffer_ += ',';
+        ++bytes_written_;
+    }
+    has_items_.back() = true;
+}
+
+boost::asio::awaitable<void> Stream::flush_if_needed() {
+    if (buffer_.size() >= flush_threshold_) {
+        co_await flush();
+    }
+}
+
+boost::asio::awaitable<void> Stream::write_chunk(std::string_view data) {
+    if (failed_) {
+        throw std::logic_error{"json::Stream::write_chunk stream failed"};
+    }
+
+    std::vector<boost::asio::const_buffer> buffers;
+    std::array<char, 2 * sizeof(std::size_t)> chunk_size{};
+    if (data.empty()) {
+        buffers.push_back(boost::asio::buffer(kLastChunk));
+    } else {
+        // Each chunk is made of its size in hex, CRLF, the data and CRLF again
+        const auto [end, ec] = std::to_chars(chunk_size.data(), chunk_size.data() + chunk_size.size(), data.size(), 16);
+        buffers.reserve(4);
+        buffers.push_back(boost::asio::buffer(chunk_size.data(), static_cast<std::size_t>(end - chunk_size.data())));
+        buffers.push_back(boost::asio::buffer(kChunkSeparator));
+        buffers.push_back(boost::asio::buffer(data));
+        buffers.push_back(boost::asio::buffer(kChunkSeparator));
+    }
+
+    try {
+        co_await boost::asio::async_write(socket_, buffers, boost::asio::use_awaitable);
+    } catch (...) {
+        failed_ = true;
+        throw;
+    }
+}
+
 } // namespace json
@@ -17,21 +17,112 @@
 #ifndef SILKRPC_JSON_STREAM_HPP_
 #define SILKRPC_JSON_STREAM_HPP_
 
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <silkrpc/config.hpp>
+
 #include <boost/asio/awaitable.hpp>
-#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
 
 #include <nlohmann/json.hpp>
 
+#include <silkrpc/json/writer.hpp>
+
 namespace json {
+
+//! Stream of JSON text written on the socket as HTTP/1.1 chunked content: the text is buffered and written as one chunk
+//! whenever the buffer exceeds the flush threshold, so that memory stays bounded whatever the total size of the content.
+//! The content can be written either as raw text or incrementally by the structural primitives, which open and close the
+//! objects and arrays and insert the separators between their fields and entries: the two must not be mixed within the
+//! same object or array.
 class Stream {
 public:
-    explicit Stream(boost::asio::ip::tcp::socket& socket) : socket_(socket) {}
+    //! The default size in bytes of the buffered text triggering a write
+    static constexpr std::size_t kDefaultFlushThreshold{64 * 1024};
+
+    explicit Stream(boost::asio::generic::stream_protocol::socket& socket, std::size_t flush_threshold = kDefaultFlushThreshold)
+    : socket_(socket), flush_threshold_(flush_threshold) {
+        buffer_.reserve(flush_threshold);
+    }
 
+    //! Write the buffered text as one chunk, if any
     boost::asio::awaitable<void> flush();
+
+    //! Flush the buffered text and write the last chunk terminating the content: nothing can be written afterwards
+    boost::asio::awaitable<void> close();
+
+    boost::asio::awaitable<void> write(std::string_view text);
     boost::asio::awaitable<void> write_json(const nlohmann::json& json);
 
+    //! Write the value using its typed JSON writer (see silkrpc/json/writer.hpp)
+    template <typename T>
+    boost::asio::awaitable<void> write_value(const T& value) {
+        const auto size = buffer_.size();
+        silkrpc::write_json(buffer_, value);
+        bytes_written_ += buffer_.size() - size;
+        co_await flush_if_needed();
+    }
+
+    boost::asio::awaitable<void> open_object();
+    boost::asio::awaitable<void> close_object();
+    boost::asio::awaitable<void> open_array();
+    boost::asio::awaitable<void> close_array();
+
+    //! Write the name of the next field in the current object, whose value must follow: the name is written as is
+    boost::asio::awaitable<void> write_field(std::string_view name);
+
+    boost::asio::awaitable<void> write_field(std::string_view name, const nlohmann::json& value);
+
+    //! Write the field in the current object using the typed JSON writer of its value (see silkrpc/json/writer.hpp)
+    template <typename T> requires requires(std::string& out, const T& value) { silkrpc::write_json(out, value); }
+    boost::asio::awaitable<void> write_field(std::string_view name, const T& value) {
+        co_await write_field(name);
+        begin_value();
+        co_await write_value(value);
+    }
+
+    //! Write the next entry in the current array
+    boost::asio::awaitable<void> write_entry(const nlohmann::json& value);
+
+    //! Write the next entry in the current array using its typed JSON writer (see silkrpc/json/writer.hpp)
+    template <typename T> requires requires(std::string& out, const T& value) { silkrpc::write_json(out, value); }
+    boost::asio::awaitable<void> write_entry(const T& value) {
+        begin_value();
+        co_await write_value(value);
+    }
+
+    //! The total size in bytes of the JSON text written so far, buffered or not
+    std::size_t bytes_written() const { return bytes_written_; }
+
+    //! Whether the last write on the socket failed, so nothing else can be written
+    bool failed() const { return failed_; }
+
+    bool closed() const { return closed_; }
+
 private:
-    boost::asio::ip::tcp::socket& socket_;
+    //! Insert the separator from the previous field or entry in the current object or array, if needed
+    void begin_value();
+
+    boost::asio::awaitable<void> flush_if_needed();
+
+    boost::asio::awaitable<void> write_chunk(std::string_view data);
+
+    boost::asio::generic::stream_protocol::socket& socket_;
+    const std::size_t flush_threshold_;
+    std::string buffer_;
+    std::size_t bytes_written_{0};
+
+    //! Flags indicating if each object or array currently open has already some fields or entries, innermost last
+    std::vector<bool> has_items_;
+
+    //! Flag indicating that a field name has been written and its value is expected
+    bool field_pending_{false};
+
+    bool failed_{false};
+    bool closed_{false};
 };
 
 } // namespace json
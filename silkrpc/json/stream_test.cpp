@@ -0,0 +1,174 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "stream.hpp"
+
+#include <string>
+#include <utility>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/connect_pair.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/use_future.hpp>
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+
+namespace json {
+
+class StreamTest {
+public:
+    StreamTest() : socket_{io_context_}, peer_{io_context_} {
+        boost::asio::local::stream_protocol::socket socket{io_context_};
+        boost::asio::local::connect_pair(socket, peer_);
+        socket_ = boost::asio::generic::stream_protocol::socket{std::move(socket)};
+    }
+
+    template <typename F>
+    void run(F&& f) {
+        auto result = boost::asio::co_spawn(io_context_, std::forward<F>(f), boost::asio::use_future);
+        io_context_.run();
+        io_context_.restart();
+        result.get();
+    }
+
+    //! Read all the bytes written so far on the socket
+    std::string received() {
+        std::string data(peer_.available(), '\0');
+        boost::asio::read(peer_, boost::asio::buffer(data));
+        return data;
+    }
+
+    boost::asio::generic::stream_protocol::socket& socket() { return socket_; }
+
+private:
+    boost::asio::io_context io_context_;
+    boost::asio::generic::stream_protocol::socket socket_;
+    boost::asio::local::stream_protocol::socket peer_;
+};
+
+TEST_CASE("json::Stream", "[silkrpc][json][stream]") {
+    StreamTest test;
+
+    SECTION("empty content") {
+        Stream stream{test.socket()};
+        test.run([&]() -> boost::asio::awaitable<void> { co_await stream.close(); });
+        CHECK(test.received() == "0\r\n\r\n");
+        CHECK(stream.closed());
+        CHECK(stream.bytes_written() == 0);
+    }
+
+    SECTION("text buffered until close") {
+        Stream stream{test.socket()};
+        const nlohmann::json json{{"result", 2}};
+        test.run([&]() -> boost::asio::awaitable<void> {
+            co_await stream.write("{\"id\":1,");
+            co_await stream.write_json(json);
+        });
+        CHECK(test.received().empty());
+        test.run([&]() -> boost::asio::awaitable<void> { co_await stream.close(); });
+        CHECK(test.received() == "14\r\n{\"id\":1,{\"result\":2}\r\n0\r\n\r\n");
+        CHECK(stream.bytes_written() == 20);
+    }
+
+    SECTION("chunk written when flush threshold exceeded") {
+        Stream stream{test.socket(), /*flush_threshold=*/4};
+        test.run([&]() -> boost::asio::awaitable<void> {
+            co_await stream.write("ab");
+            co_await stream.write("cde");
+            co_await stream.write("f");
+        });
+        CHECK(test.received() == "5\r\nabcde\r\n");
+        test.run([&]() -> boost::asio::awaitable<void> { co_await stream.close(); });
+        CHECK(test.received() == "1\r\nf\r\n0\r\n\r\n");
+        CHECK(stream.bytes_written() == 6);
+    }
+
+    SECTION("explicit flush") {
+        Stream stream{test.socket()};
+        test.run([&]() -> boost::asio::awaitable<void> {
+            co_await stream.flush();
+            co_await stream.write("[]");
+            co_await stream.flush();
+        });
+        CHECK(test.received() == "2\r\n[]\r\n");
+    }
+
+    SECTION("close is idempotent") {
+        Stream stream{test.socket()};
+        test.run([&]() -> boost::asio::awaitable<void> {
+            co_await stream.close();
+            co_await stream.close();
+        });
+        CHECK(test.received() == "0\r\n\r\n");
+    }
+
+    SECTION("structural primitives") {
+        Stream stream{test.socket()};
+        const nlohmann::json entry{{"a", 1}};
+        test.run([&]() -> boost::asio::awaitable<void> {
+            co_await stream.open_object();
+            co_await stream.write_field("id", 1);
+            co_await stream.write_field("jsonrpc", "2.0");
+            co_await stream.write_field("result");
+            co_await stream.open_array();
+            co_await stream.write_entry(entry);
+            co_await stream.open_array();
+            co_await stream.close_array();
+            co_await stream.write_entry(evmc::address{});
+            co_await stream.open_object();
+            co_await stream.write_field("b");
+            co_await stream.open_object();
+            co_await stream.close_object();
+            co_await stream.write_field("c", evmc::bytes32{});
+            co_await stream.close_object();
+            co_await stream.close_array();
+            co_await stream.close_object();
+            co_await stream.close();
+        });
+        const std::string expected{"{\"id\":1,\"jsonrpc\":\"2.0\",\"result\":[{\"a\":1},[],\"0x0000000000000000000000000000000000000000\",{\"b\":{},"
+            "\"c\":\"0x0000000000000000000000000000000000000000000000000000000000000000\"}]}"};
+        CHECK(test.received() == "ad\r\n" + expected + "\r\n0\r\n\r\n");
+        CHECK(stream.bytes_written() == expected.size());
+    }
+
+    SECTION("structural primitives flushed when threshold exceeded") {
+        Stream stream{test.socket(), /*flush_threshold=*/8};
+        test.run([&]() -> boost::asio::awaitable<void> {
+            co_await stream.open_array();
+            for (int i{0}; i < 5; ++i) {
+                co_await stream.write_entry(i * 1000);
+            }
+            co_await stream.close_array();
+        });
+        CHECK(test.received() == "c\r\n[0,1000,2000\r\na\r\n,3000,4000\r\n");
+        test.run([&]() -> boost::asio::awaitable<void> { co_await stream.close(); });
+        CHECK(test.received() == "1\r\n]\r\n0\r\n\r\n");
+    }
+
+    SECTION("write failure") {
+        Stream stream{test.socket()};
+        test.socket().close();
+        CHECK_THROWS(test.run([&]() -> boost::asio::awaitable<void> {
+            co_await stream.write("[]");
+            co_await stream.close();
+        }));
+        CHECK(stream.failed());
+    }
+}
+
+} // namespace json
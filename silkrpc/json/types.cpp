@@ -17,13 +17,17 @@
 #include "types.hpp"
 
 #include <algorithm>
+#include <bit>
 #include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
 #include <utility>
 
-#include <boost/endian/conversion.hpp>
 #include <intx/intx.hpp>
 #include <silkworm/common/util.hpp>
 
+#include <silkrpc/common/hex.hpp>
 #include <silkrpc/common/log.hpp>
 #include <silkrpc/common/util.hpp>
 #include <silkworm/common/endian.hpp>
@@ -33,44 +37,27 @@ namespace silkrpc {
 using evmc::literals::operator""_address;
 
 std::string to_hex_no_leading_zeros(silkworm::ByteView bytes) {
-    static const char* kHexDigits{"0123456789abcdef"};
-
-    std::string out{};
-
-    if (bytes.length() == 0) {
-       out.reserve(1);
-       out.push_back('0');
-       return out;
+    const auto first_nonzero = std::find_if(bytes.cbegin(), bytes.cend(), [](uint8_t b) { return b != 0; });
+    if (first_nonzero == bytes.cend()) {
+        return "0";
     }
-
-    out.reserve(2 * bytes.length());
-
-    bool found_nonzero{false};
-    for (size_t i{0}; i < bytes.length(); ++i) {
-        uint8_t x{bytes[i]};
-        char lo{kHexDigits[x & 0x0f]};
-        char hi{kHexDigits[x >> 4]};
-        if (!found_nonzero && hi != '0') {
-            found_nonzero = true;
-        }
-        if (found_nonzero) {
-            out.push_back(hi);
-        }
-        if (!found_nonzero && lo != '0') {
-            found_nonzero = true;
-        }
-        if (found_nonzero || i == bytes.length() - 1) {
-            out.push_back(lo);
-        }
+    auto out = silkrpc::to_hex(bytes.substr(static_cast<std::size_t>(first_nonzero - bytes.cbegin())));
+    if (out[0] == '0') {
+        out.erase(0, 1);
     }
-
     return out;
 }
 
 std::string to_hex_no_leading_zeros(uint64_t number) {
-    silkworm::Bytes number_bytes(8, '\0');
-    boost::endian::store_big_u64(&number_bytes[0], number);
-    return to_hex_no_leading_zeros(number_bytes);
+    static const char* kHexDigits{"0123456789abcdef"};
+
+    const auto num_digits = number == 0 ? 1 : (std::bit_width(number) + 3) / 4;
+    std::string out(static_cast<std::size_t>(num_digits), '0');
+    for (auto i{num_digits}; i > 0; --i) {
+        out[static_cast<std::size_t>(i - 1)] = kHexDigits[number & 0x0f];
+        number >>= 4;
+    }
+    return out;
 }
 
 std::string to_quantity(silkworm::ByteView bytes) {
@@ -93,20 +80,20 @@ std::string to_quantity(intx::uint256 number) {
 namespace evmc {
 
 void to_json(nlohmann::json& json, const address& addr) {
-    json = "0x" + silkworm::to_hex(addr);
+    json = silkrpc::to_hex(addr, /*with_prefix=*/true);
 }
 
 void from_json(const nlohmann::json& json, address& addr) {
-    const auto address_bytes = silkworm::from_hex(json.get<std::string>());
+    const auto address_bytes = silkrpc::from_hex(json.get<std::string>());
     addr = silkworm::to_evmc_address(address_bytes.value_or(silkworm::Bytes{}));
 }
 
 void to_json(nlohmann::json& json, const bytes32& b32) {
-    json = "0x" + silkworm::to_hex(b32);
+    json = silkrpc::to_hex(b32, /*with_prefix=*/true);
 }
 
 void from_json(const nlohmann::json& json, bytes32& b32) {
-    const auto b32_bytes = silkworm::from_hex(json.get<std::string>());
+    const auto b32_bytes = silkrpc::from_hex(json.get<std::string>());
     b32 = silkworm::to_bytes32(b32_bytes.value_or(silkworm::Bytes{}));
 }
 
@@ -132,15 +119,15 @@ void to_json(nlohmann::json& json, const BlockHeader& header) {
     json["number"] = block_number;
     json["hash"] = silkrpc::to_quantity(header.hash());
     json["parentHash"] = header.parent_hash;
-    json["nonce"] = "0x" + silkworm::to_hex({header.nonce.data(), header.nonce.size()});
+    json["nonce"] = silkrpc::to_hex({header.nonce.data(), header.nonce.size()}, /*with_prefix=*/true);
     json["sha3Uncles"] = header.ommers_hash;
-    json["logsBloom"] = "0x" + silkworm::to_hex(silkrpc::full_view(header.logs_bloom));
+    json["logsBloom"] = silkrpc::to_hex(silkrpc::full_view(header.logs_bloom), /*with_prefix=*/true);
     json["transactionsRoot"] = header.transactions_root;
     json["stateRoot"] = header.state_root;
     json["receiptsRoot"] = header.receipts_root;
     json["miner"] = header.beneficiary;
     json["difficulty"] = silkrpc::to_quantity(silkworm::endian::to_big_compact(header.difficulty));
-    json["extraData"] = "0x" + silkworm::to_hex(header.extra_data);
+    json["extraData"] = silkrpc::to_hex(header.extra_data, /*with_prefix=*/true);
     json["mixHash"]= header.mix_hash;
     json["gasLimit"] = silkrpc::to_quantity(header.gas_limit);
     json["gasUsed"] = silkrpc::to_quantity(header.gas_used);
@@ -167,7 +154,7 @@ void to_json(nlohmann::json& json, const Transaction& transaction) {
     json["gas"] = silkrpc::to_quantity(transaction.gas_limit);
     auto ethash_hash{hash_of_transaction(transaction)};
     json["hash"] = silkworm::to_bytes32({ethash_hash.bytes, silkworm::kHashLength});
-    json["input"] = "0x" + silkworm::to_hex(transaction.data);
+    json["input"] = silkrpc::to_hex(transaction.data, /*with_prefix=*/true);
     json["nonce"] = silkrpc::to_quantity(transaction.nonce);
     if (transaction.to) {
         json["to"] =  transaction.to.value();
@@ -218,7 +205,7 @@ void to_json(nlohmann::json& json, const struct TxPoolStatusInfo& status_info) {
 }
 
 void to_json(nlohmann::json& json, const Rlp& rlp) {
-    json = "0x" + silkworm::to_hex(rlp.buffer);
+    json = silkrpc::to_hex(rlp.buffer, /*with_prefix=*/true);
 }
 
 void to_json(nlohmann::json& json, const struct CallBundleTxInfo& tx_info) {
@@ -249,16 +236,16 @@ void to_json(nlohmann::json& json, const Block& b) {
     json["number"] = block_number;
     json["hash"] = b.hash;
     json["parentHash"] = b.block.header.parent_hash;
-    json["nonce"] = "0x" + silkworm::to_hex({b.block.header.nonce.data(), b.block.header.nonce.size()});
+    json["nonce"] = silkrpc::to_hex({b.block.header.nonce.data(), b.block.header.nonce.size()}, /*with_prefix=*/true);
     json["sha3Uncles"] = b.block.header.ommers_hash;
-    json["logsBloom"] = "0x" + silkworm::to_hex(full_view(b.block.header.logs_bloom));
+    json["logsBloom"] = silkrpc::to_hex(full_view(b.block.header.logs_bloom), /*with_prefix=*/true);
     json["transactionsRoot"] = b.block.header.transactions_root;
     json["stateRoot"] = b.block.header.state_root;
     json["receiptsRoot"] = b.block.header.receipts_root;
     json["miner"] = b.block.header.beneficiary;
     json["difficulty"] = silkrpc::to_quantity(silkworm::endian::to_big_compact(b.block.header.difficulty));
     json["totalDifficulty"] = silkrpc::to_quantity(silkworm::endian::to_big_compact(b.total_difficulty));
-    json["extraData"] = "0x" + silkworm::to_hex(b.block.header.extra_data);
+    json["extraData"] = silkrpc::to_hex(b.block.header.extra_data, /*with_prefix=*/true);
     json["mixHash"]= b.block.header.mix_hash;
     json["size"] = silkrpc::to_quantity(b.get_block_size());
     json["gasLimit"] = silkrpc::to_quantity(b.block.header.gas_limit);
@@ -276,6 +263,8 @@ void to_json(nlohmann::json& json, const Block& b) {
             json_txn["blockNumber"] = block_number;
             json_txn["gasPrice"] = silkrpc::to_quantity(b.block.transactions[i].effective_gas_price(b.block.header.base_fee_per_gas.value_or(0)));
         }
+    } else if (b.hashes) {
+        json["transactions"] = b.hashes->transaction_hashes;
     } else {
         std::vector<evmc::bytes32> transaction_hashes;
         transaction_hashes.reserve(b.block.transactions.size());
@@ -287,13 +276,17 @@ void to_json(nlohmann::json& json, const Block& b) {
         }
         json["transactions"] = transaction_hashes;
     }
-    std::vector<evmc::bytes32> ommer_hashes;
-    ommer_hashes.reserve(b.block.ommers.size());
-    for (auto i{0}; i < b.block.ommers.size(); i++) {
-        ommer_hashes.emplace(ommer_hashes.end(), std::move(b.block.ommers[i].hash()));
-        SILKRPC_DEBUG << "ommer_hashes[" << i << "]: " << silkworm::to_hex({ommer_hashes[i].bytes, silkworm::kHashLength}) << "\n";
+    if (b.hashes) {
+        json["uncles"] = b.hashes->ommer_hashes;
+    } else {
+        std::vector<evmc::bytes32> ommer_hashes;
+        ommer_hashes.reserve(b.block.ommers.size());
+        for (auto i{0}; i < b.block.ommers.size(); i++) {
+            ommer_hashes.emplace(ommer_hashes.end(), std::move(b.block.ommers[i].hash()));
+            SILKRPC_DEBUG << "ommer_hashes[" << i << "]: " << silkworm::to_hex({ommer_hashes[i].bytes, silkworm::kHashLength}) << "\n";
+        }
+        json["uncles"] = ommer_hashes;
     }
-    json["uncles"] = ommer_hashes;
 }
 
 void to_json(nlohmann::json& json, const Transaction& transaction) {
@@ -345,17 +338,61 @@ void from_json(const nlohmann::json& json, Call& call) {
     }
     if (json.count("data") != 0) {
         const auto json_data = json.at("data").get<std::string>();
-        call.data = silkworm::from_hex(json_data);
+        call.data = silkrpc::from_hex(json_data);
     }
     if (json.count("accessList") != 0) {
        call.access_list = json.at("accessList").get<AccessList>();
     }
 }
 
+static std::map<evmc::bytes32, evmc::bytes32> storage_from_json(const nlohmann::json& json) {
+    std::map<evmc::bytes32, evmc::bytes32> storage;
+    for (const auto& [location, value] : json.items()) {
+        storage.insert_or_assign(nlohmann::json(location).get<evmc::bytes32>(), value.get<evmc::bytes32>());
+    }
+    return storage;
+}
+
+void from_json(const nlohmann::json& json, AccountOverrides& overrides) {
+    if (json.count("state") != 0 && json.count("stateDiff") != 0) {
+        throw std::invalid_argument{"both state and stateDiff overridden"};
+    }
+    if (json.count("balance") != 0) {
+        overrides.balance = json.at("balance").get<intx::uint256>();
+    }
+    if (json.count("nonce") != 0) {
+        const auto json_nonce = json.at("nonce");
+        if (json_nonce.is_string()) {
+            overrides.nonce = std::stoul(json_nonce.get<std::string>(), 0, 16);
+        } else {
+            overrides.nonce = json_nonce.get<uint64_t>();
+        }
+    }
+    if (json.count("code") != 0) {
+        const auto code = silkrpc::from_hex(json.at("code").get<std::string>());
+        if (!code) {
+            throw std::invalid_argument{"invalid code override: " + json.at("code").dump()};
+        }
+        overrides.code = *code;
+    }
+    if (json.count("state") != 0) {
+        overrides.state = storage_from_json(json.at("state"));
+    }
+    if (json.count("stateDiff") != 0) {
+        overrides.state_diff = storage_from_json(json.at("stateDiff"));
+    }
+}
+
+void from_json(const nlohmann::json& json, StateOverrides& overrides) {
+    for (const auto& [address, account_overrides] : json.items()) {
+        overrides.insert_or_assign(nlohmann::json(address).get<evmc::address>(), account_overrides.get<AccountOverrides>());
+    }
+}
+
 void to_json(nlohmann::json& json, const Log& log) {
     json["address"] = log.address;
     json["topics"] = log.topics;
-    json["data"] = "0x" + silkworm::to_hex(log.data);
+    json["data"] = silkrpc::to_hex(log.data, /*with_prefix=*/true);
     json["blockNumber"] = silkrpc::to_quantity(log.block_number);
     json["blockHash"] = log.block_hash;
     json["transactionHash"] = log.tx_hash;
@@ -416,7 +453,7 @@ void to_json(nlohmann::json& json, const Receipt& receipt) {
         json["contractAddress"] = nlohmann::json{};
     }
     json["logs"] = receipt.logs;
-    json["logsBloom"] = "0x" + silkworm::to_hex(full_view(receipt.bloom));
+    json["logsBloom"] = silkrpc::to_hex(full_view(receipt.bloom), /*with_prefix=*/true);
     json["status"] = silkrpc::to_quantity(receipt.success ? 1 : 0);
 }
 
@@ -518,19 +555,19 @@ void from_json(const nlohmann::json& json, Filter& filter) {
 void to_json(nlohmann::json& json, const ExecutionPayload& execution_payload) {
     nlohmann::json transaction_list;
     for (const auto& transaction : execution_payload.transactions) {
-        transaction_list.push_back("0x" + silkworm::to_hex(transaction));
+        transaction_list.push_back(silkrpc::to_hex(transaction, /*with_prefix=*/true));
     }
     json["parentHash"] = execution_payload.parent_hash;
     json["feeRecipient"] = execution_payload.suggested_fee_recipient;
     json["stateRoot"] = execution_payload.state_root;
     json["receiptsRoot"] = execution_payload.receipts_root;
-    json["logsBloom"] = "0x" + silkworm::to_hex(execution_payload.logs_bloom);
+    json["logsBloom"] = silkrpc::to_hex(full_view(execution_payload.logs_bloom), /*with_prefix=*/true);
     json["prevRandao"] = execution_payload.prev_randao;
     json["blockNumber"] = silkrpc::to_quantity(execution_payload.number);
     json["gasLimit"] = silkrpc::to_quantity(execution_payload.gas_limit);
     json["gasUsed"] = silkrpc::to_quantity(execution_payload.gas_used);
     json["timestamp"] = silkrpc::to_quantity(execution_payload.timestamp);
-    json["extraData"] = "0x" + silkworm::to_hex(execution_payload.extra_data);
+    json["extraData"] = silkrpc::to_hex(execution_payload.extra_data, /*with_prefix=*/true);
     json["baseFeePerGas"] = silkrpc::to_quantity(execution_payload.base_fee);
     json["blockHash"] = execution_payload.block_hash;
     json["transactions"] = transaction_list;
@@ -540,14 +577,14 @@ void from_json(const nlohmann::json& json, ExecutionPayload& execution_payload)
     // Parse logs bloom
     silkworm::Bloom logs_bloom;
     std::memcpy(&logs_bloom[0],
-                silkworm::from_hex(json.at("logsBloom").get<std::string>())->data(),
+                silkrpc::from_hex(json.at("logsBloom").get<std::string>())->data(),
                 silkworm::kBloomByteLength
     );
     // Parse transactions
     std::vector<silkworm::Bytes> transactions;
     for (const auto& hex_transaction : json.at("transactions")) {
         transactions.push_back(
-            *silkworm::from_hex(hex_transaction.get<std::string>())
+            *silkrpc::from_hex(hex_transaction.get<std::string>())
         );
     }
 
@@ -564,7 +601,7 @@ void from_json(const nlohmann::json& json, ExecutionPayload& execution_payload)
         .prev_randao = json.at("prevRandao").get<evmc::bytes32>(),
         .base_fee = json.at("baseFeePerGas").get<intx::uint256>(),
         .logs_bloom = logs_bloom,
-        .extra_data = *silkworm::from_hex(json.at("extraData").get<std::string>()),
+        .extra_data = *silkrpc::from_hex(json.at("extraData").get<std::string>()),
         .transactions = transactions
     };
 }
@@ -678,13 +715,13 @@ void to_json(nlohmann::json& json, const Error& error) {
 }
 
 void to_json(nlohmann::json& json, const RevertError& error) {
-    json = {{"code", error.code}, {"message", error.message}, {"data", "0x" + silkworm::to_hex(error.data)}};
+    json = {{"code", error.code}, {"message", error.message}, {"data", silkrpc::to_hex(error.data, /*with_prefix=*/true)}};
 }
 
 void to_json(nlohmann::json& json, const std::set<evmc::address>& addresses) {
     json = nlohmann::json::array();
     for (const auto& address : addresses) {
-        json.push_back("0x" + silkworm::to_hex(address));
+        json.push_back(silkrpc::to_hex(address, /*with_prefix=*/true));
     }
 }
 
@@ -88,6 +88,9 @@ void to_json(nlohmann::json& json, const Transaction& transaction);
 
 void from_json(const nlohmann::json& json, Call& call);
 
+void from_json(const nlohmann::json& json, AccountOverrides& overrides);
+void from_json(const nlohmann::json& json, StateOverrides& overrides);
+
 void to_json(nlohmann::json& json, const Log& log);
 void from_json(const nlohmann::json& json, Log& log);
 
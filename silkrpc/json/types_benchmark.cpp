@@ -0,0 +1,155 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "types.hpp"
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <evmc/evmc.hpp>
+#include <intx/intx.hpp>
+#include <nlohmann/json.hpp>
+#include <silkworm/common/util.hpp>
+
+#include <silkrpc/json/writer.hpp>
+#include <silkrpc/types/block.hpp>
+#include <silkrpc/types/log.hpp>
+#include <silkrpc/types/receipt.hpp>
+
+namespace silkrpc {
+
+using evmc::literals::operator""_address, evmc::literals::operator""_bytes32;
+
+static silkrpc::Block make_block(std::size_t num_transactions, bool full_tx) {
+    silkrpc::Block block;
+    block.hash = 0xc9e65d063911aa583e17bbb7070893482203217caf6d9fbb50265c72e7bf73e5_bytes32;
+    block.total_difficulty = intx::uint256{0x4e33ae};
+    block.full_tx = full_tx;
+    block.block.header.number = 15'000'000;
+    block.block.header.gas_limit = 30'000'000;
+    block.block.header.gas_used = 29'000'000;
+    block.block.header.timestamp = 1'655'000'000;
+    block.block.header.base_fee_per_gas = 10'000'000'000;
+    block.block.transactions.resize(num_transactions);
+    for (std::size_t i{0}; i < num_transactions; ++i) {
+        auto& transaction = block.block.transactions[i];
+        transaction.type = silkworm::Transaction::Type::kEip1559;
+        transaction.nonce = i;
+        transaction.max_priority_fee_per_gas = 2'000'000'000;
+        transaction.max_fee_per_gas = 30'000'000'000;
+        transaction.gas_limit = 100'000;
+        transaction.to = 0x0715a7794a1dc8e42615f059dd6e406a6594651a_address;
+        transaction.value = intx::uint256{1'000'000'000'000'000'000};
+        transaction.data = *silkworm::from_hex("a9059cbb000000000000000000000000e5ef458d37212a06e3f59d40c454e768150f74740000000000000000000000000000000000000000000000000000000005f5e100");
+        transaction.chain_id = 1;
+        transaction.r = intx::from_string<intx::uint256>("0x52f8f61201b2b11a78d6e866abc9c3db2ae8631fa656bfe5cb53668255367afb");
+        transaction.s = intx::from_string<intx::uint256>("0x52f8f61201b2b11a78d6e866abc9c3db2ae8631fa656bfe5cb53668255367afb");
+        transaction.from = 0x0f572e5295c57f15886f9b263e2f6d2d6c7b5ec6_address;
+    }
+    return block;
+}
+
+static Log make_log(uint32_t index) {
+    Log log;
+    log.address = 0xea674fdde714fd979de3edf0f56aa9716b898ec8_address;
+    log.topics = {
+        0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef_bytes32,
+        0x0000000000000000000000000f572e5295c57f15886f9b263e2f6d2d6c7b5ec6_bytes32,
+        0x000000000000000000000000e5ef458d37212a06e3f59d40c454e768150f7474_bytes32,
+    };
+    log.data = *silkworm::from_hex("0000000000000000000000000000000000000000000000000000000005f5e100");
+    log.block_number = 15'000'000;
+    log.tx_hash = 0x8e38b4dbf6b11fcc3b9dee84fb7986e29ca0a02cecd8977c161ff7333329681e_bytes32;
+    log.tx_index = index;
+    log.block_hash = 0xc9e65d063911aa583e17bbb7070893482203217caf6d9fbb50265c72e7bf73e5_bytes32;
+    log.index = index;
+    return log;
+}
+
+static void BM_to_json_block(benchmark::State& state) {
+    const auto block = make_block(static_cast<std::size_t>(state.range(0)), /*full_tx=*/state.range(1) != 0);
+    for (auto _ : state) {
+        nlohmann::json json = block;
+        benchmark::DoNotOptimize(json);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_to_json_block)->Args({200, 0})->Args({200, 1});
+
+static void BM_to_json_logs(benchmark::State& state) {
+    Logs logs;
+    for (int64_t i{0}; i < state.range(0); ++i) {
+        logs.push_back(make_log(static_cast<uint32_t>(i)));
+    }
+    for (auto _ : state) {
+        nlohmann::json json = logs;
+        benchmark::DoNotOptimize(json);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_to_json_logs)->Arg(1)->Arg(1'000);
+
+static void BM_to_json_receipt(benchmark::State& state) {
+    Receipt receipt;
+    receipt.success = true;
+    receipt.cumulative_gas_used = 3'611'403;
+    receipt.gas_used = 51'000;
+    receipt.block_number = 15'000'000;
+    receipt.to = 0x0715a7794a1dc8e42615f059dd6e406a6594651a_address;
+    receipt.from = 0x0f572e5295c57f15886f9b263e2f6d2d6c7b5ec6_address;
+    receipt.type = 2;
+    for (uint32_t i{0}; i < 4; ++i) {
+        receipt.logs.push_back(make_log(i));
+    }
+    receipt.bloom = bloom_from_logs(receipt.logs);
+    for (auto _ : state) {
+        nlohmann::json json = receipt;
+        benchmark::DoNotOptimize(json);
+    }
+}
+BENCHMARK(BM_to_json_receipt);
+
+static void BM_to_quantity(benchmark::State& state) {
+    const intx::uint256 number{intx::from_string<intx::uint256>("0x1fffd310ac743f371de3b9f7f9cb56c0b28ad43601b4ab949f53faa07bd2c804")};
+    for (auto _ : state) {
+        auto quantity = to_quantity(number);
+        benchmark::DoNotOptimize(quantity);
+    }
+}
+BENCHMARK(BM_to_quantity);
+
+static void BM_json_dump_block(benchmark::State& state) {
+    const nlohmann::json json = make_block(200, /*full_tx=*/true);
+    for (auto _ : state) {
+        auto content = json.dump();
+        benchmark::DoNotOptimize(content);
+    }
+}
+BENCHMARK(BM_json_dump_block);
+
+static void BM_write_json_block(benchmark::State& state) {
+    const auto block = make_block(static_cast<std::size_t>(state.range(0)), /*full_tx=*/state.range(1) != 0);
+    for (auto _ : state) {
+        std::string content;
+        write_json(content, block);
+        benchmark::DoNotOptimize(content);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_write_json_block)->Args({200, 0})->Args({200, 1});
+
+} // namespace silkrpc
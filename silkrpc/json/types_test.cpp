@@ -16,7 +16,9 @@
 
 #include "types.hpp"
 
+#include <map>
 #include <optional>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -1372,6 +1374,46 @@ TEST_CASE("deserialize full call", "[silkrpc::json][from_json]") {
     CHECK(c2.nonce == intx::uint256{1});
 }
 
+TEST_CASE("deserialize state overrides", "[silkrpc::json][from_json]") {
+    auto j1 = R"({
+        "0x52c24586c31cff0485a6208bb63859290fba5bce": {
+            "balance": "0x10C388C00",
+            "nonce": "0x2",
+            "code": "0x6001600055"
+        },
+        "0x0715a7794a1dc8e42615f059dd6e406a6594651a": {
+            "stateDiff": {
+                "0x0000000000000000000000000000000000000000000000000000000000000001": "0x000000000000000000000000000000000000000000000000000000000000002a"
+            }
+        },
+        "0x62c24586c31cff0485a6208bb63859290fba5bce": {
+            "state": {}
+        }
+    })"_json;
+    const auto overrides = j1.get<StateOverrides>();
+    CHECK(overrides.size() == 3);
+    const auto& o1 = overrides.at(0x52c24586c31cff0485a6208bb63859290fba5bce_address);
+    CHECK(o1.balance == intx::uint256{4499999744});
+    CHECK(o1.nonce == 2);
+    CHECK(o1.code == silkworm::from_hex("0x6001600055"));
+    CHECK(o1.state == std::nullopt);
+    CHECK(o1.state_diff.empty());
+    const auto& o2 = overrides.at(0x0715a7794a1dc8e42615f059dd6e406a6594651a_address);
+    CHECK(o2.balance == std::nullopt);
+    CHECK(o2.nonce == std::nullopt);
+    CHECK(o2.code == std::nullopt);
+    CHECK(o2.state_diff.size() == 1);
+    CHECK(o2.state_diff.at(0x0000000000000000000000000000000000000000000000000000000000000001_bytes32) ==
+        0x000000000000000000000000000000000000000000000000000000000000002a_bytes32);
+    const auto& o3 = overrides.at(0x62c24586c31cff0485a6208bb63859290fba5bce_address);
+    CHECK(o3.state == std::map<evmc::bytes32, evmc::bytes32>{});
+
+    auto j2 = R"({
+        "0x52c24586c31cff0485a6208bb63859290fba5bce": {"state": {}, "stateDiff": {}}
+    })"_json;
+    CHECK_THROWS_AS(j2.get<StateOverrides>(), std::invalid_argument);
+}
+
 TEST_CASE("deserialize block_number_or_hash", "[silkrpc::json][from_json]") {
     SECTION("as hash") {
         auto json = R"("0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c")"_json;
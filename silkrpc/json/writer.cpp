@@ -0,0 +1,474 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "writer.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include <silkrpc/common/hex.hpp>
+#include <silkrpc/common/util.hpp>
+#include <silkrpc/json/types.hpp>
+
+namespace silkrpc {
+
+namespace {
+
+// The field names are literals including the separator, the quotes and the colon, so that each one is a single copy
+inline void write_hex_field(std::string& out, std::string_view name, silkworm::ByteView bytes) {
+    out += name;
+    out.push_back('"');
+    write_hex(out, bytes);
+    out.push_back('"');
+}
+
+inline void write_quantity_field(std::string& out, std::string_view name, uint64_t number) {
+    out += name;
+    out.push_back('"');
+    write_quantity(out, number);
+    out.push_back('"');
+}
+
+inline void write_quantity_field(std::string& out, std::string_view name, const intx::uint256& number) {
+    out += name;
+    out.push_back('"');
+    write_quantity(out, number);
+    out.push_back('"');
+}
+
+template <typename T>
+void write_array(std::string& out, const std::vector<T>& values) {
+    out.push_back('[');
+    for (std::size_t i{0}; i < values.size(); ++i) {
+        if (i > 0) {
+            out.push_back(',');
+        }
+        write_json(out, values[i]);
+    }
+    out.push_back(']');
+}
+
+//! Close the object written from the specified offset, having each field preceded by the separator: the separator of the
+//! first field becomes the opening brace, so that any field can be left out by the projection
+inline void close_object(std::string& out, std::size_t offset) {
+    if (out.size() == offset) {
+        out += "{}";
+        return;
+    }
+    out[offset] = '{';
+    out.push_back('}');
+}
+
+//! Write the selected fields of the transaction placed in its block: the fields are interleaved, because written in
+//! lexicographic order as the fields of nlohmann::json objects. The transaction hash is computed unless memoized
+void write_transaction(std::string& out, const silkworm::Transaction& transaction, const evmc::bytes32* block_hash, uint64_t block_number,
+                       uint64_t transaction_index, const intx::uint256& gas_price, const evmc::bytes32* transaction_hash = nullptr,
+                       FieldMask fields = kAllFields) {
+    const auto selected = [fields](std::size_t field) { return is_selected(fields, field); };
+    if (!transaction.from && selected(transaction_field::from)) {
+        // Same as to_json, which recovers the sender on the spot
+        (const_cast<silkworm::Transaction&>(transaction)).recover_sender();
+    }
+    const bool typed = transaction.type != silkworm::Transaction::Type::kLegacy;
+    const auto offset = out.size();
+    if (typed && selected(transaction_field::access_list)) {
+        out += ",\"accessList\":";
+        write_array(out, transaction.access_list);
+    }
+    if (selected(transaction_field::block_hash)) {
+        out += ",\"blockHash\":";
+        if (block_hash) {
+            write_json(out, *block_hash);
+        } else {
+            out += "null";
+        }
+    }
+    if (selected(transaction_field::block_number)) {
+        if (block_hash) {
+            write_quantity_field(out, ",\"blockNumber\":", block_number);
+        } else {
+            out += ",\"blockNumber\":null";
+        }
+    }
+    if ((typed || transaction.chain_id) && selected(transaction_field::chain_id)) {
+        write_quantity_field(out, ",\"chainId\":", *transaction.chain_id);
+    }
+    if (transaction.from && selected(transaction_field::from)) {
+        out += ",\"from\":";
+        write_json(out, *transaction.from);
+    }
+    if (selected(transaction_field::gas)) {
+        write_quantity_field(out, ",\"gas\":", transaction.gas_limit);
+    }
+    if (selected(transaction_field::gas_price)) {
+        write_quantity_field(out, ",\"gasPrice\":", gas_price);
+    }
+    if (selected(transaction_field::hash)) {
+        if (transaction_hash) {
+            out += ",\"hash\":";
+            write_json(out, *transaction_hash);
+        } else {
+            const auto hash{hash_of_transaction(transaction)};
+            write_hex_field(out, ",\"hash\":", full_view(hash));
+        }
+    }
+    if (selected(transaction_field::input)) {
+        write_hex_field(out, ",\"input\":", transaction.data);
+    }
+    if (transaction.type == silkworm::Transaction::Type::kEip1559) {
+        if (selected(transaction_field::max_fee_per_gas)) {
+            write_quantity_field(out, ",\"maxFeePerGas\":", transaction.max_fee_per_gas);
+        }
+        if (selected(transaction_field::max_priority_fee_per_gas)) {
+            write_quantity_field(out, ",\"maxPriorityFeePerGas\":", transaction.max_priority_fee_per_gas);
+        }
+    }
+    if (selected(transaction_field::nonce)) {
+        write_quantity_field(out, ",\"nonce\":", transaction.nonce);
+    }
+    if (selected(transaction_field::r)) {
+        write_quantity_field(out, ",\"r\":", transaction.r);
+    }
+    if (selected(transaction_field::s)) {
+        write_quantity_field(out, ",\"s\":", transaction.s);
+    }
+    if (selected(transaction_field::to)) {
+        out += ",\"to\":";
+        if (transaction.to) {
+            write_json(out, *transaction.to);
+        } else {
+            out += "null";
+        }
+    }
+    if (selected(transaction_field::transaction_index)) {
+        if (block_hash) {
+            write_quantity_field(out, ",\"transactionIndex\":", transaction_index);
+        } else {
+            out += ",\"transactionIndex\":null";
+        }
+    }
+    if (selected(transaction_field::type)) {
+        write_quantity_field(out, ",\"type\":", static_cast<uint64_t>(transaction.type));
+    }
+    if (selected(transaction_field::v)) {
+        if (typed) {
+            write_quantity_field(out, ",\"v\":", static_cast<uint64_t>(transaction.odd_y_parity));
+        } else {
+            write_quantity_field(out, ",\"v\":", transaction.v());
+        }
+    }
+    if (selected(transaction_field::value)) {
+        write_quantity_field(out, ",\"value\":", transaction.value);
+    }
+    close_object(out, offset);
+}
+
+} // namespace
+
+void write_hex(std::string& out, silkworm::ByteView bytes) {
+    const auto offset = out.size();
+    out.resize(offset + 2 + 2 * bytes.size());
+    char* dest = out.data() + offset;
+    dest[0] = '0';
+    dest[1] = 'x';
+    hex::encode(bytes, dest + 2);
+}
+
+void write_quantity(std::string& out, uint64_t number) {
+    constexpr const char* kHexDigits{"0123456789abcdef"};
+    out += "0x";
+    if (number == 0) {
+        out.push_back('0');
+        return;
+    }
+    const int num_digits = (64 - std::countl_zero(number) + 3) / 4;
+    for (int shift = 4 * (num_digits - 1); shift >= 0; shift -= 4) {
+        out.push_back(kHexDigits[(number >> shift) & 0x0f]);
+    }
+}
+
+void write_quantity(std::string& out, const intx::uint256& number) {
+    const auto bytes{intx::be::store<evmc::bytes32>(number)};
+    const auto first_nonzero = std::find_if(std::cbegin(bytes.bytes), std::cend(bytes.bytes), [](uint8_t b) { return b != 0; });
+    if (first_nonzero == std::cend(bytes.bytes)) {
+        out += "0x0";
+        return;
+    }
+    // Encode from the first non-zero byte, dropping its leading zero digit if any
+    const auto offset = out.size();
+    const silkworm::ByteView significant_bytes{first_nonzero, static_cast<std::size_t>(std::cend(bytes.bytes) - first_nonzero)};
+    write_hex(out, significant_bytes);
+    if (out[offset + 2] == '0') {
+        out.erase(offset + 2, 1);
+    }
+}
+
+void write_json(std::string& out, const evmc::address& address) {
+    out.push_back('"');
+    write_hex(out, full_view(address));
+    out.push_back('"');
+}
+
+void write_json(std::string& out, const evmc::bytes32& b32) {
+    out.push_back('"');
+    write_hex(out, full_view(b32));
+    out.push_back('"');
+}
+
+// Fields are written in lexicographic order, the same used by nlohmann::json objects
+void write_json(std::string& out, const Log& log) {
+    out += "{\"address\":";
+    write_json(out, log.address);
+    out += ",\"blockHash\":";
+    write_json(out, log.block_hash);
+    write_quantity_field(out, ",\"blockNumber\":", log.block_number);
+    write_hex_field(out, ",\"data\":", log.data);
+    write_quantity_field(out, ",\"logIndex\":", log.index);
+    out += log.removed ? ",\"removed\":true" : ",\"removed\":false";
+    out += ",\"topics\":[";
+    for (std::size_t i{0}; i < log.topics.size(); ++i) {
+        if (i > 0) {
+            out.push_back(',');
+        }
+        write_json(out, log.topics[i]);
+    }
+    out += "],\"transactionHash\":";
+    write_json(out, log.tx_hash);
+    write_quantity_field(out, ",\"transactionIndex\":", log.tx_index);
+    out.push_back('}');
+}
+
+void write_json(std::string& out, const Logs& logs) {
+    out.push_back('[');
+    for (std::size_t i{0}; i < logs.size(); ++i) {
+        if (i > 0) {
+            out.push_back(',');
+        }
+        write_json(out, logs[i]);
+    }
+    out.push_back(']');
+}
+
+void write_json(std::string& out, const Receipt& receipt) {
+    write_json(out, receipt, FieldProjection{});
+}
+
+void write_json(std::string& out, const Receipts& receipts) {
+    write_json(out, receipts, FieldProjection{});
+}
+
+// Fields are written in lexicographic order, the same used by nlohmann::json objects
+void write_json(std::string& out, const Receipt& receipt, const FieldProjection& projection) {
+    const auto selected = [&projection](std::size_t field) { return is_selected(projection.fields, field); };
+    const auto offset = out.size();
+    if (selected(receipt_field::block_hash)) {
+        out += ",\"blockHash\":";
+        write_json(out, receipt.block_hash);
+    }
+    if (selected(receipt_field::block_number)) {
+        write_quantity_field(out, ",\"blockNumber\":", receipt.block_number);
+    }
+    if (selected(receipt_field::contract_address)) {
+        out += ",\"contractAddress\":";
+        if (receipt.contract_address) {
+            write_json(out, receipt.contract_address);
+        } else {
+            out += "null";
+        }
+    }
+    if (selected(receipt_field::cumulative_gas_used)) {
+        write_quantity_field(out, ",\"cumulativeGasUsed\":", receipt.cumulative_gas_used);
+    }
+    if (selected(receipt_field::effective_gas_price)) {
+        write_quantity_field(out, ",\"effectiveGasPrice\":", receipt.effective_gas_price);
+    }
+    if (selected(receipt_field::from)) {
+        out += ",\"from\":";
+        write_json(out, receipt.from.value_or(evmc::address{}));
+    }
+    if (selected(receipt_field::gas_used)) {
+        write_quantity_field(out, ",\"gasUsed\":", receipt.gas_used);
+    }
+    if (selected(receipt_field::logs)) {
+        out += ",\"logs\":";
+        write_json(out, receipt.logs);
+    }
+    if (selected(receipt_field::logs_bloom)) {
+        write_hex_field(out, ",\"logsBloom\":", full_view(receipt.bloom));
+    }
+    if (selected(receipt_field::status)) {
+        write_quantity_field(out, ",\"status\":", receipt.success ? 1 : 0);
+    }
+    if (selected(receipt_field::to)) {
+        out += ",\"to\":";
+        write_json(out, receipt.to.value_or(evmc::address{}));
+    }
+    if (selected(receipt_field::transaction_hash)) {
+        out += ",\"transactionHash\":";
+        write_json(out, receipt.tx_hash);
+    }
+    if (selected(receipt_field::transaction_index)) {
+        write_quantity_field(out, ",\"transactionIndex\":", receipt.tx_index);
+    }
+    if (selected(receipt_field::type)) {
+        write_quantity_field(out, ",\"type\":", receipt.type ? receipt.type.value() : 0);
+    }
+    close_object(out, offset);
+}
+
+void write_json(std::string& out, const Receipts& receipts, const FieldProjection& projection) {
+    out.push_back('[');
+    for (std::size_t i{0}; i < receipts.size(); ++i) {
+        if (i > 0) {
+            out.push_back(',');
+        }
+        write_json(out, receipts[i], projection);
+    }
+    out.push_back(']');
+}
+
+void write_json(std::string& out, const silkworm::AccessListEntry& entry) {
+    out += "{\"address\":";
+    write_json(out, entry.account);
+    out += ",\"storageKeys\":";
+    write_array(out, entry.storage_keys);
+    out.push_back('}');
+}
+
+void write_json(std::string& out, const Transaction& transaction) {
+    const auto* block_hash = transaction.queued_in_pool ? nullptr : &transaction.block_hash;
+    write_transaction(out, transaction, block_hash, transaction.block_number, transaction.transaction_index, transaction.effective_gas_price());
+}
+
+void write_json(std::string& out, const Block& block) {
+    write_json(out, block, FieldProjection{});
+}
+
+// Fields are written in lexicographic order, the same used by nlohmann::json objects
+void write_json(std::string& out, const Block& block, const FieldProjection& projection) {
+    const auto selected = [&projection](std::size_t field) { return is_selected(projection.fields, field); };
+    const auto& header = block.block.header;
+    const auto offset = out.size();
+    if (header.base_fee_per_gas && selected(block_field::base_fee_per_gas)) {
+        write_quantity_field(out, ",\"baseFeePerGas\":", *header.base_fee_per_gas);
+    }
+    if (selected(block_field::difficulty)) {
+        write_quantity_field(out, ",\"difficulty\":", header.difficulty);
+    }
+    if (selected(block_field::extra_data)) {
+        write_hex_field(out, ",\"extraData\":", header.extra_data);
+    }
+    if (selected(block_field::gas_limit)) {
+        write_quantity_field(out, ",\"gasLimit\":", header.gas_limit);
+    }
+    if (selected(block_field::gas_used)) {
+        write_quantity_field(out, ",\"gasUsed\":", header.gas_used);
+    }
+    if (selected(block_field::hash)) {
+        out += ",\"hash\":";
+        write_json(out, block.hash);
+    }
+    if (selected(block_field::logs_bloom)) {
+        write_hex_field(out, ",\"logsBloom\":", full_view(header.logs_bloom));
+    }
+    if (selected(block_field::miner)) {
+        out += ",\"miner\":";
+        write_json(out, header.beneficiary);
+    }
+    if (selected(block_field::mix_hash)) {
+        out += ",\"mixHash\":";
+        write_json(out, header.mix_hash);
+    }
+    if (selected(block_field::nonce)) {
+        write_hex_field(out, ",\"nonce\":", silkworm::ByteView{header.nonce.data(), header.nonce.size()});
+    }
+    if (selected(block_field::number)) {
+        write_quantity_field(out, ",\"number\":", header.number);
+    }
+    if (selected(block_field::parent_hash)) {
+        out += ",\"parentHash\":";
+        write_json(out, header.parent_hash);
+    }
+    if (selected(block_field::receipts_root)) {
+        out += ",\"receiptsRoot\":";
+        write_json(out, header.receipts_root);
+    }
+    if (selected(block_field::sha3_uncles)) {
+        out += ",\"sha3Uncles\":";
+        write_json(out, header.ommers_hash);
+    }
+    if (selected(block_field::size)) {
+        write_quantity_field(out, ",\"size\":", block.get_block_size());
+    }
+    if (selected(block_field::state_root)) {
+        out += ",\"stateRoot\":";
+        write_json(out, header.state_root);
+    }
+    if (selected(block_field::timestamp)) {
+        write_quantity_field(out, ",\"timestamp\":", header.timestamp);
+    }
+    if (selected(block_field::total_difficulty)) {
+        write_quantity_field(out, ",\"totalDifficulty\":", block.total_difficulty);
+    }
+    if (selected(block_field::transactions)) {
+        out += ",\"transactions\":[";
+        const auto& transactions = block.block.transactions;
+        for (std::size_t i{0}; i < transactions.size(); ++i) {
+            if (i > 0) {
+                out.push_back(',');
+            }
+            if (block.full_tx) {
+                const auto gas_price = transactions[i].effective_gas_price(header.base_fee_per_gas.value_or(0));
+                const auto* transaction_hash = block.hashes ? &block.hashes->transaction_hashes[i] : nullptr;
+                write_transaction(out, transactions[i], &block.hash, header.number, i, gas_price, transaction_hash, projection.transaction_fields);
+            } else if (block.hashes) {
+                write_json(out, block.hashes->transaction_hashes[i]);
+            } else {
+                const auto hash{hash_of_transaction(transactions[i])};
+                out.push_back('"');
+                write_hex(out, full_view(hash));
+                out.push_back('"');
+            }
+        }
+        out.push_back(']');
+    }
+    if (selected(block_field::transactions_root)) {
+        out += ",\"transactionsRoot\":";
+        write_json(out, header.transactions_root);
+    }
+    if (selected(block_field::uncles)) {
+        out += ",\"uncles\":[";
+        for (std::size_t i{0}; i < block.block.ommers.size(); ++i) {
+            if (i > 0) {
+                out.push_back(',');
+            }
+            write_json(out, block.hashes ? block.hashes->ommer_hashes[i] : block.block.ommers[i].hash());
+        }
+        out.push_back(']');
+    }
+    close_object(out, offset);
+}
+
+void write_raw_json_content(std::string& out, uint32_t id, std::string_view result_json) {
+    out.reserve(out.size() + result_json.size() + 40);
+    out += "{\"id\":";
+    out += std::to_string(id);
+    out += ",\"jsonrpc\":\"2.0\",\"result\":";
+    out += result_json;
+    out.push_back('}');
+}
+
+} // namespace silkrpc
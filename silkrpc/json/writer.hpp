@@ -0,0 +1,95 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_JSON_WRITER_HPP_
+#define SILKRPC_JSON_WRITER_HPP_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <evmc/evmc.hpp>
+#include <intx/intx.hpp>
+#include <silkworm/common/base.hpp>
+
+#include <silkrpc/json/projection.hpp>
+#include <silkrpc/types/block.hpp>
+#include <silkrpc/types/log.hpp>
+#include <silkrpc/types/receipt.hpp>
+#include <silkrpc/types/transaction.hpp>
+
+// Typed JSON writers appending the JSON text straight into an output string, without building any nlohmann::json
+// value. The output is byte-for-byte identical to the dump() of the corresponding to_json serialization.
+
+namespace silkrpc {
+
+//! Append the bytes as hex string with 0x prefix (e.g. "0x00ff")
+void write_hex(std::string& out, silkworm::ByteView bytes);
+
+//! Append the number as hex quantity with 0x prefix and no leading zeros (e.g. "0x1f")
+void write_quantity(std::string& out, uint64_t number);
+void write_quantity(std::string& out, const intx::uint256& number);
+
+void write_json(std::string& out, const evmc::address& address);
+void write_json(std::string& out, const evmc::bytes32& b32);
+
+void write_json(std::string& out, const Log& log);
+void write_json(std::string& out, const Logs& logs);
+
+void write_json(std::string& out, const Receipt& receipt);
+void write_json(std::string& out, const Receipts& receipts);
+
+//! Write the receipts projected on the selected fields
+void write_json(std::string& out, const Receipt& receipt, const FieldProjection& projection);
+void write_json(std::string& out, const Receipts& receipts, const FieldProjection& projection);
+
+void write_json(std::string& out, const silkworm::AccessListEntry& entry);
+
+//! Write the transaction recovering its sender if missing, same as its to_json serialization
+void write_json(std::string& out, const Transaction& transaction);
+
+//! Write the block with either its full transactions or their hashes only, same as its to_json serialization
+void write_json(std::string& out, const Block& block);
+
+//! Write the block projected on the selected fields, its full transactions (if any) on the selected transaction fields
+void write_json(std::string& out, const Block& block, const FieldProjection& projection);
+
+//! Append the JSON RPC reply content having the specified result, same as make_json_content(id, result).dump()
+template <typename T>
+void write_json_content(std::string& out, uint32_t id, const T& result) {
+    out += "{\"id\":";
+    out += std::to_string(id);
+    out += ",\"jsonrpc\":\"2.0\",\"result\":";
+    write_json(out, result);
+    out.push_back('}');
+}
+
+//! Append the JSON RPC reply content having the specified result projected on the selected fields
+template <typename T>
+void write_json_content(std::string& out, uint32_t id, const T& result, const FieldProjection& projection) {
+    out += "{\"id\":";
+    out += std::to_string(id);
+    out += ",\"jsonrpc\":\"2.0\",\"result\":";
+    write_json(out, result, projection);
+    out.push_back('}');
+}
+
+//! Append the JSON RPC reply content having the specified result already serialized as JSON text
+void write_raw_json_content(std::string& out, uint32_t id, std::string_view result_json);
+
+} // namespace silkrpc
+
+#endif  // SILKRPC_JSON_WRITER_HPP_
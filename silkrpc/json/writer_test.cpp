@@ -0,0 +1,326 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "writer.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+#include <nlohmann/json.hpp>
+#include <silkworm/common/util.hpp>
+
+#include <silkrpc/json/types.hpp>
+
+namespace silkrpc {
+
+using evmc::literals::operator""_address, evmc::literals::operator""_bytes32;
+
+// The to_json serialization is the reference for all the typed writers
+template <typename T>
+static std::string reference_dump(const T& value) {
+    const nlohmann::json json = value;
+    return json.dump();
+}
+
+template <typename T>
+static std::string write(const T& value) {
+    std::string out;
+    write_json(out, value);
+    return out;
+}
+
+TEST_CASE("write_hex", "[silkrpc][json][writer]") {
+    SECTION("empty bytes") {
+        std::string out;
+        write_hex(out, silkworm::Bytes{});
+        CHECK(out == "0x");
+    }
+    SECTION("all byte values") {
+        silkworm::Bytes bytes(256, 0);
+        for (std::size_t i{0}; i < bytes.size(); ++i) {
+            bytes[i] = static_cast<uint8_t>(i);
+        }
+        std::string out{"prefix"};
+        write_hex(out, bytes);
+        CHECK(out == "prefix0x" + silkworm::to_hex(bytes));
+    }
+}
+
+TEST_CASE("write_quantity", "[silkrpc][json][writer]") {
+    for (uint64_t number : {0ull, 1ull, 0xfull, 0x10ull, 4206337ull, 0xffffffffull, 0x8000000000000000ull, 0xffffffffffffffffull}) {
+        std::string out;
+        write_quantity(out, number);
+        CHECK(out == to_quantity(number));
+    }
+    for (intx::uint256 number : {intx::uint256{0}, intx::uint256{2000000000}, intx::uint256{1} << 200}) {
+        std::string out;
+        write_quantity(out, number);
+        CHECK(out == to_quantity(number));
+    }
+}
+
+TEST_CASE("write address and bytes32", "[silkrpc][json][writer]") {
+    CHECK(write(evmc::address{}) == reference_dump(evmc::address{}));
+    CHECK(write(0x0715a7794a1dc8e42615f059dd6e406a6594651a_address) == reference_dump(0x0715a7794a1dc8e42615f059dd6e406a6594651a_address));
+    CHECK(write(evmc::bytes32{}) == reference_dump(evmc::bytes32{}));
+    const auto hash{0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32};
+    CHECK(write(hash) == reference_dump(hash));
+}
+
+TEST_CASE("write Log", "[silkrpc][json][writer]") {
+    SECTION("empty log") {
+        Log log{{}, {}, {}};
+        CHECK(write(log) == reference_dump(log));
+    }
+    SECTION("full log") {
+        Log log{
+            0xea674fdde714fd979de3edf0f56aa9716b898ec8_address,
+            {
+                0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef_bytes32,
+                0x000000000000000000000000d9e1459a7a482635700cbc20bbaf52d495ab9c96_bytes32,
+            },
+            *silkworm::from_hex("0x00000000000000000000000000000000000000000000000000000000000003e8"),
+            4206337,
+            0xb02a3b0ee16c858afaa34bcd6770b3c20ee56aa2f75858733eb0e927b5b7126f_bytes32,
+            3,
+            0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32,
+            17,
+            true
+        };
+        CHECK(write(log) == reference_dump(log));
+        const Logs logs{log, Log{}, log};
+        CHECK(write(logs) == reference_dump(logs));
+    }
+    SECTION("empty logs") {
+        CHECK(write(Logs{}) == reference_dump(Logs{}));
+    }
+}
+
+TEST_CASE("write Receipt", "[silkrpc][json][writer]") {
+    SECTION("empty receipt") {
+        Receipt receipt{};
+        CHECK(write(receipt) == reference_dump(receipt));
+    }
+    SECTION("full receipt") {
+        Receipt receipt{
+            true,
+            454647,
+            silkworm::Bloom{},
+            Logs{Log{0xea674fdde714fd979de3edf0f56aa9716b898ec8_address, {}, *silkworm::from_hex("0x01ff")}},
+            0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32,
+            0x0715a7794a1dc8e42615f059dd6e406a6594651a_address,
+            10,
+            0xb02a3b0ee16c858afaa34bcd6770b3c20ee56aa2f75858733eb0e927b5b7126f_bytes32,
+            5000000,
+            3,
+            0x22ea9f6b28db76a7162054c05ed812deb2f519cd_address,
+            0x22ea9f6b28db76a7162054c05ed812deb2f519cd_address,
+            1,
+            2000000000
+        };
+        receipt.bloom[7] = 0xab;
+        CHECK(write(receipt) == reference_dump(receipt));
+        const Receipts receipts{receipt, Receipt{}};
+        CHECK(write(receipts) == reference_dump(receipts));
+    }
+}
+
+static silkworm::Transaction make_transaction(silkworm::Transaction::Type type) {
+    silkworm::Transaction transaction;
+    transaction.type = type;
+    transaction.nonce = 7;
+    transaction.max_priority_fee_per_gas = 2'000'000'000;
+    transaction.max_fee_per_gas = 30'000'000'000;
+    transaction.gas_limit = 100'000;
+    transaction.to = 0x0715a7794a1dc8e42615f059dd6e406a6594651a_address;
+    transaction.value = intx::uint256{1'000'000'000'000'000'000};
+    transaction.data = *silkworm::from_hex("a9059cbb000000000000000000000000e5ef458d37212a06e3f59d40c454e768150f7474");
+    transaction.chain_id = 1;
+    transaction.odd_y_parity = true;
+    transaction.r = intx::from_string<intx::uint256>("0x52f8f61201b2b11a78d6e866abc9c3db2ae8631fa656bfe5cb53668255367afb");
+    transaction.s = intx::from_string<intx::uint256>("0x0c2b3d4f61201b2b11a78d6e866abc9c3db2ae8631fa656bfe5cb53668255367");
+    transaction.from = 0x0f572e5295c57f15886f9b263e2f6d2d6c7b5ec6_address;
+    if (type != silkworm::Transaction::Type::kLegacy) {
+        transaction.access_list = {
+            {0xea674fdde714fd979de3edf0f56aa9716b898ec8_address, {0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32}},
+            {0x22ea9f6b28db76a7162054c05ed812deb2f519cd_address, {}},
+        };
+    }
+    return transaction;
+}
+
+TEST_CASE("write Transaction", "[silkrpc][json][writer]") {
+    for (const auto type : {silkworm::Transaction::Type::kLegacy, silkworm::Transaction::Type::kEip2930, silkworm::Transaction::Type::kEip1559}) {
+        Transaction transaction{make_transaction(type)};
+        transaction.block_hash = 0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32;
+        transaction.block_number = 4206337;
+        transaction.block_base_fee_per_gas = 7;
+        transaction.transaction_index = 3;
+        CHECK(write(transaction) == reference_dump(transaction));
+
+        transaction.queued_in_pool = true;
+        CHECK(write(transaction) == reference_dump(transaction));
+    }
+    SECTION("legacy transaction without chain id nor recipient") {
+        Transaction transaction{make_transaction(silkworm::Transaction::Type::kLegacy)};
+        transaction.chain_id = std::nullopt;
+        transaction.to = std::nullopt;
+        CHECK(write(transaction) == reference_dump(transaction));
+    }
+}
+
+TEST_CASE("write Block", "[silkrpc][json][writer]") {
+    Block block;
+    block.hash = 0xc9e65d063911aa583e17bbb7070893482203217caf6d9fbb50265c72e7bf73e5_bytes32;
+    block.total_difficulty = intx::uint256{0x4e33ae};
+    block.block.header.number = 15'000'000;
+    block.block.header.difficulty = 0;
+    block.block.header.gas_limit = 30'000'000;
+    block.block.header.gas_used = 29'000'000;
+    block.block.header.timestamp = 1'655'000'000;
+    block.block.header.extra_data = *silkworm::from_hex("0x0102");
+    block.block.header.logs_bloom[3] = 0x80;
+    SECTION("empty block") {
+        CHECK(write(block) == reference_dump(block));
+        block.full_tx = true;
+        CHECK(write(block) == reference_dump(block));
+    }
+    block.block.header.base_fee_per_gas = 10'000'000'000;
+    block.block.transactions = {
+        make_transaction(silkworm::Transaction::Type::kLegacy),
+        make_transaction(silkworm::Transaction::Type::kEip2930),
+        make_transaction(silkworm::Transaction::Type::kEip1559),
+    };
+    block.block.ommers.resize(2);
+    block.block.ommers[1].number = 14'999'999;
+    SECTION("block with transaction hashes") {
+        CHECK(write(block) == reference_dump(block));
+    }
+    SECTION("block with full transactions") {
+        block.full_tx = true;
+        CHECK(write(block) == reference_dump(block));
+    }
+    SECTION("block with memoized hashes") {
+        const auto unmemoized_json = write(block);
+        block.full_tx = true;
+        const auto unmemoized_full_json = write(block);
+        block.hashes = std::make_shared<const BlockHashes>(make_block_hashes(block.block));
+        CHECK(write(block) == unmemoized_full_json);
+        CHECK(write(block) == reference_dump(block));
+        block.full_tx = false;
+        CHECK(write(block) == unmemoized_json);
+        CHECK(write(block) == reference_dump(block));
+    }
+}
+
+// The to_json serialization keeping just the selected fields is the reference for the projected writers
+static std::string reference_projection(nlohmann::json json, const std::vector<std::string>& fields,
+                                        const std::vector<std::string>& transaction_fields = {}) {
+    const auto keep = [](nlohmann::json& object, const std::vector<std::string>& names) {
+        for (auto it = object.begin(); it != object.end();) {
+            it = std::find(names.cbegin(), names.cend(), it.key()) == names.cend() ? object.erase(it) : std::next(it);
+        }
+    };
+    keep(json, fields);
+    if (json.contains("transactions") && !transaction_fields.empty()) {
+        for (auto& transaction : json["transactions"]) {
+            keep(transaction, transaction_fields);
+        }
+    }
+    return json.dump();
+}
+
+template <typename T>
+static std::string write(const T& value, const FieldProjection& projection) {
+    std::string out;
+    write_json(out, value, projection);
+    return out;
+}
+
+TEST_CASE("write projected Block", "[silkrpc][json][writer]") {
+    Block block;
+    block.hash = 0xc9e65d063911aa583e17bbb7070893482203217caf6d9fbb50265c72e7bf73e5_bytes32;
+    block.block.header.number = 15'000'000;
+    block.block.header.base_fee_per_gas = 10'000'000'000;
+    block.block.transactions = {
+        make_transaction(silkworm::Transaction::Type::kLegacy),
+        make_transaction(silkworm::Transaction::Type::kEip1559),
+    };
+    block.full_tx = true;
+    SECTION("full projection") {
+        CHECK(write(block, FieldProjection{}) == reference_dump(block));
+    }
+    SECTION("no fields") {
+        CHECK(write(block, make_block_projection({})) == "{}");
+    }
+    SECTION("block fields") {
+        CHECK(write(block, make_block_projection({"number", "hash"})) ==
+            "{\"hash\":\"0xc9e65d063911aa583e17bbb7070893482203217caf6d9fbb50265c72e7bf73e5\",\"number\":\"0xe4e1c0\"}");
+        CHECK(write(block, make_block_projection({"baseFeePerGas", "uncles"})) == reference_projection(block, {"baseFeePerGas", "uncles"}));
+    }
+    SECTION("transaction fields") {
+        const std::vector<std::string> transaction_fields{"from", "hash", "to", "value"};
+        const auto projection = make_block_projection({"number", "transactions.from", "transactions.hash", "transactions.to", "transactions.value"});
+        CHECK(write(block, projection) == reference_projection(block, {"number", "transactions"}, transaction_fields));
+        block.full_tx = false;
+        CHECK(write(block, projection) == reference_projection(block, {"number", "transactions"}));
+    }
+    SECTION("all transaction fields") {
+        CHECK(write(block, make_block_projection({"transactions"})) == reference_projection(block, {"transactions"}));
+    }
+}
+
+TEST_CASE("write projected Receipt", "[silkrpc][json][writer]") {
+    Receipt receipt{};
+    receipt.success = true;
+    receipt.gas_used = 21'000;
+    receipt.logs = Logs{Log{}};
+    SECTION("full projection") {
+        CHECK(write(receipt, FieldProjection{}) == reference_dump(receipt));
+    }
+    SECTION("receipt fields") {
+        CHECK(write(receipt, make_receipt_projection({"status", "gasUsed"})) == "{\"gasUsed\":\"0x5208\",\"status\":\"0x1\"}");
+        const Receipts receipts{receipt, Receipt{}};
+        const std::vector<std::string> fields{"contractAddress", "logs", "type"};
+        const auto projected_json = write(receipts, make_receipt_projection(fields));
+        CHECK(projected_json == "[" + reference_projection(receipts[0], fields) + "," + reference_projection(receipts[1], fields) + "]");
+    }
+}
+
+TEST_CASE("write_json_content", "[silkrpc][json][writer]") {
+    const Logs logs{Log{}};
+    std::string out;
+    write_json_content(out, 123, logs);
+    CHECK(out == make_json_content(123, logs).dump());
+
+    const Receipt receipt{};
+    std::string projected_out;
+    write_json_content(projected_out, 123, receipt, make_receipt_projection({"status"}));
+    CHECK(projected_out == "{\"id\":123,\"jsonrpc\":\"2.0\",\"result\":{\"status\":\"0x0\"}}");
+}
+
+TEST_CASE("write_raw_json_content", "[silkrpc][json][writer]") {
+    const Logs logs{Log{}};
+    std::string out;
+    write_raw_json_content(out, 123, nlohmann::json(logs).dump());
+    CHECK(out == make_json_content(123, logs).dump());
+}
+
+} // namespace silkrpc
@@ -27,9 +27,13 @@ std::ostream& operator<<(std::ostream& out, const ProtocolVersion& v) {
 }
 
 template<typename StubInterface>
-ProtocolVersionResult wait_for_protocol_check(const std::unique_ptr<StubInterface>& stub, const ProtocolVersion& version, const std::string& name) {
+ProtocolVersionResult wait_for_protocol_check(const std::unique_ptr<StubInterface>& stub, const ProtocolVersion& version, const std::string& name,
+                                              const ProtocolCheckDeadline& deadline) {
     grpc::ClientContext context;
     context.set_wait_for_ready(true);
+    if (deadline) {
+        context.set_deadline(*deadline);
+    }
 
     types::VersionReply version_reply;
     const auto status = stub->Version(&context, google::protobuf::Empty{}, &version_reply);
@@ -56,40 +60,40 @@ struct NewStubFactory final {
     }
 };
 
-ProtocolVersionResult wait_for_kv_protocol_check(const std::unique_ptr<::remote::KV::StubInterface>& stub) {
-    return wait_for_protocol_check(stub, KV_SERVICE_API_VERSION, "KV");
+ProtocolVersionResult wait_for_kv_protocol_check(const std::unique_ptr<::remote::KV::StubInterface>& stub, const ProtocolCheckDeadline& deadline) {
+    return wait_for_protocol_check(stub, KV_SERVICE_API_VERSION, "KV", deadline);
 }
 
-ProtocolVersionResult wait_for_kv_protocol_check(const std::shared_ptr<grpc::Channel>& channel) {
+ProtocolVersionResult wait_for_kv_protocol_check(const std::shared_ptr<grpc::Channel>& channel, const ProtocolCheckDeadline& deadline) {
     NewStubFactory<::remote::KV::NewStub, ::remote::KV::StubInterface> new_stub_factory;
-    return wait_for_protocol_check(new_stub_factory(channel), KV_SERVICE_API_VERSION, "KV");
+    return wait_for_protocol_check(new_stub_factory(channel), KV_SERVICE_API_VERSION, "KV", deadline);
 }
 
-ProtocolVersionResult wait_for_ethbackend_protocol_check(const std::unique_ptr<::remote::ETHBACKEND::StubInterface>& stub) {
-    return wait_for_protocol_check(stub, ETHBACKEND_SERVICE_API_VERSION, "ETHBACKEND");
+ProtocolVersionResult wait_for_ethbackend_protocol_check(const std::unique_ptr<::remote::ETHBACKEND::StubInterface>& stub, const ProtocolCheckDeadline& deadline) {
+    return wait_for_protocol_check(stub, ETHBACKEND_SERVICE_API_VERSION, "ETHBACKEND", deadline);
 }
 
-ProtocolVersionResult wait_for_ethbackend_protocol_check(const std::shared_ptr<grpc::Channel>& channel) {
+ProtocolVersionResult wait_for_ethbackend_protocol_check(const std::shared_ptr<grpc::Channel>& channel, const ProtocolCheckDeadline& deadline) {
     NewStubFactory<::remote::ETHBACKEND::NewStub, ::remote::ETHBACKEND::StubInterface> new_stub_factory;
-    return wait_for_protocol_check(new_stub_factory(channel), ETHBACKEND_SERVICE_API_VERSION, "ETHBACKEND");
+    return wait_for_protocol_check(new_stub_factory(channel), ETHBACKEND_SERVICE_API_VERSION, "ETHBACKEND", deadline);
 }
 
-ProtocolVersionResult wait_for_mining_protocol_check(const std::unique_ptr<::txpool::Mining::StubInterface>& stub) {
-    return wait_for_protocol_check(stub, MINING_SERVICE_API_VERSION, "MINING");
+ProtocolVersionResult wait_for_mining_protocol_check(const std::unique_ptr<::txpool::Mining::StubInterface>& stub, const ProtocolCheckDeadline& deadline) {
+    return wait_for_protocol_check(stub, MINING_SERVICE_API_VERSION, "MINING", deadline);
 }
 
-ProtocolVersionResult wait_for_mining_protocol_check(const std::shared_ptr<grpc::Channel>& channel) {
+ProtocolVersionResult wait_for_mining_protocol_check(const std::shared_ptr<grpc::Channel>& channel, const ProtocolCheckDeadline& deadline) {
     NewStubFactory<::txpool::Mining::NewStub, ::txpool::Mining::StubInterface> new_stub_factory;
-    return wait_for_protocol_check(new_stub_factory(channel), MINING_SERVICE_API_VERSION, "MINING");
+    return wait_for_protocol_check(new_stub_factory(channel), MINING_SERVICE_API_VERSION, "MINING", deadline);
 }
 
-ProtocolVersionResult wait_for_txpool_protocol_check(const std::unique_ptr<::txpool::Txpool::StubInterface>& stub) {
-    return wait_for_protocol_check(stub, TXPOOL_SERVICE_API_VERSION, "TXPOOL");
+ProtocolVersionResult wait_for_txpool_protocol_check(const std::unique_ptr<::txpool::Txpool::StubInterface>& stub, const ProtocolCheckDeadline& deadline) {
+    return wait_for_protocol_check(stub, TXPOOL_SERVICE_API_VERSION, "TXPOOL", deadline);
 }
 
-ProtocolVersionResult wait_for_txpool_protocol_check(const std::shared_ptr<grpc::Channel>& channel) {
+ProtocolVersionResult wait_for_txpool_protocol_check(const std::shared_ptr<grpc::Channel>& channel, const ProtocolCheckDeadline& deadline) {
     NewStubFactory<::txpool::Txpool::NewStub, ::txpool::Txpool::StubInterface> new_stub_factory;
-    return wait_for_protocol_check(new_stub_factory(channel), TXPOOL_SERVICE_API_VERSION, "TXPOOL");
+    return wait_for_protocol_check(new_stub_factory(channel), TXPOOL_SERVICE_API_VERSION, "TXPOOL", deadline);
 }
 
 } // namespace silkrpc
@@ -17,8 +17,10 @@
 #ifndef SILKRPC_PROTOCOL_VERSION_HPP_
 #define SILKRPC_PROTOCOL_VERSION_HPP_
 
+#include <chrono>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <string>
 
 #include <grpcpp/grpcpp.h>
@@ -49,17 +51,20 @@ struct ProtocolVersionResult {
     std::string result;
 };
 
-ProtocolVersionResult wait_for_kv_protocol_check(const std::unique_ptr<::remote::KV::StubInterface>& stub);
-ProtocolVersionResult wait_for_kv_protocol_check(const std::shared_ptr<grpc::Channel>& channel);
+//! The deadline of the protocol checks, waiting for the server to be ready until then (no deadline means forever)
+using ProtocolCheckDeadline = std::optional<std::chrono::system_clock::time_point>;
 
-ProtocolVersionResult wait_for_ethbackend_protocol_check(const std::unique_ptr<::remote::ETHBACKEND::StubInterface>& stub);
-ProtocolVersionResult wait_for_ethbackend_protocol_check(const std::shared_ptr<grpc::Channel>& channel);
+ProtocolVersionResult wait_for_kv_protocol_check(const std::unique_ptr<::remote::KV::StubInterface>& stub, const ProtocolCheckDeadline& deadline = std::nullopt);
+ProtocolVersionResult wait_for_kv_protocol_check(const std::shared_ptr<grpc::Channel>& channel, const ProtocolCheckDeadline& deadline = std::nullopt);
 
-ProtocolVersionResult wait_for_mining_protocol_check(const std::unique_ptr<::txpool::Mining::StubInterface>& stub);
-ProtocolVersionResult wait_for_mining_protocol_check(const std::shared_ptr<grpc::Channel>& channel);
+ProtocolVersionResult wait_for_ethbackend_protocol_check(const std::unique_ptr<::remote::ETHBACKEND::StubInterface>& stub, const ProtocolCheckDeadline& deadline = std::nullopt);
+ProtocolVersionResult wait_for_ethbackend_protocol_check(const std::shared_ptr<grpc::Channel>& channel, const ProtocolCheckDeadline& deadline = std::nullopt);
 
-ProtocolVersionResult wait_for_txpool_protocol_check(const std::unique_ptr<::txpool::Txpool::StubInterface>& stub);
-ProtocolVersionResult wait_for_txpool_protocol_check(const std::shared_ptr<grpc::Channel>& channel);
+ProtocolVersionResult wait_for_mining_protocol_check(const std::unique_ptr<::txpool::Mining::StubInterface>& stub, const ProtocolCheckDeadline& deadline = std::nullopt);
+ProtocolVersionResult wait_for_mining_protocol_check(const std::shared_ptr<grpc::Channel>& channel, const ProtocolCheckDeadline& deadline = std::nullopt);
+
+ProtocolVersionResult wait_for_txpool_protocol_check(const std::unique_ptr<::txpool::Txpool::StubInterface>& stub, const ProtocolCheckDeadline& deadline = std::nullopt);
+ProtocolVersionResult wait_for_txpool_protocol_check(const std::shared_ptr<grpc::Channel>& channel, const ProtocolCheckDeadline& deadline = std::nullopt);
 
 } // namespace silkrpc
 
@@ -16,7 +16,9 @@
 
 #include "context_test_base.hpp"
 
+#include <silkrpc/common/access_history.hpp>
 #include <silkrpc/common/block_cache.hpp>
+#include <silkrpc/common/receipt_cache.hpp>
 #include <silkrpc/common/log.hpp>
 #include <silkrpc/ethdb/kv/state_cache.hpp>
 
@@ -28,7 +30,8 @@ ContextTestBase::ContextTestBase()
           return true;
       }()},
       context_{[]() { return grpc::CreateChannel("localhost:12345", grpc::InsecureChannelCredentials()); },
-               std::make_shared<BlockCache>(), std::make_shared<ethdb::kv::CoherentStateCache>()},
+               std::make_shared<BlockCache>(), std::make_shared<ReceiptCache>(), std::make_shared<ethdb::kv::CoherentStateCache>(),
+               std::make_shared<AccessHistory>()},
       io_context_{*context_.io_context()},
       grpc_context_{*context_.grpc_context()},
       context_thread_{[&]() { context_.execute_loop(); }} {
@@ -20,6 +20,8 @@
 #include <memory>
 #include <string>
 
+#include <silkrpc/config.hpp>
+
 #include <boost/asio/awaitable.hpp>
 
 #include <silkrpc/common/util.hpp>
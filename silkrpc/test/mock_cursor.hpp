@@ -19,6 +19,8 @@
 
 #include <string>
 
+#include <silkrpc/config.hpp>
+
 #include <boost/asio/awaitable.hpp>
 #include <gmock/gmock.h>
 #include <silkworm/common/base.hpp>
@@ -20,6 +20,9 @@
 #include <cstddef>
 #include <memory>
 #include <optional>
+#include <vector>
+
+#include <silkrpc/config.hpp>
 
 #include <boost/asio/awaitable.hpp>
 #include <gmock/gmock.h>
@@ -43,6 +46,7 @@ class MockStateCache : public ethdb::kv::StateCache {
     MOCK_METHOD((void), on_new_block, (const remote::StateChangeBatch&), (override));
     MOCK_METHOD((std::size_t), latest_data_size, (), (override));
     MOCK_METHOD((std::size_t), latest_code_size, (), (override));
+    MOCK_METHOD((std::size_t), view_count, (), (override));
     MOCK_METHOD((uint64_t), state_hit_count, (), (const));
     MOCK_METHOD((uint64_t), state_miss_count, (), (const));
     MOCK_METHOD((uint64_t), state_key_count, (), (const));
@@ -51,6 +55,13 @@ class MockStateCache : public ethdb::kv::StateCache {
     MOCK_METHOD((uint64_t), code_miss_count, (), (const));
     MOCK_METHOD((uint64_t), code_key_count, (), (const));
     MOCK_METHOD((uint64_t), code_eviction_count, (), (const));
+    MOCK_METHOD((uint64_t), state_evicted_count, (), (const));
+    MOCK_METHOD((uint64_t), code_evicted_count, (), (const));
+    MOCK_METHOD((ethdb::kv::HotKeys), hot_keys, (), (override));
+    MOCK_METHOD((std::optional<ethdb::kv::HotKeys>), take_reorg_hot_keys, (), (override));
+    MOCK_METHOD((std::size_t), warm_up, (ethdb::kv::StateViewId, const std::vector<KeyValue>&, const std::vector<KeyValue>&), (override));
+    MOCK_METHOD((void), set_max_state_keys, (uint32_t), (override));
+    MOCK_METHOD((void), set_max_code_bytes, (std::size_t), (override));
 };
 
 }  // namespace silkrpc::test
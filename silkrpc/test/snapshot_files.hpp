@@ -0,0 +1,288 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_TEST_SNAPSHOT_FILES_HPP_
+#define SILKRPC_TEST_SNAPSHOT_FILES_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <boost/endian/conversion.hpp>
+
+#include <silkworm/common/base.hpp>
+
+namespace silkrpc::test {
+
+//! Writer of the test segment files in the format read by ethdb::snapshot::Decompressor, i.e. the Erigon compressed words
+class SegmentWriter {
+public:
+    //! One pattern replacing the bytes of the word at the specified position
+    struct Match {
+        uint64_t position{0};
+        std::size_t pattern{0};
+    };
+
+    //! The patterns are given the Huffman codes of a complete binary tree, in order
+    explicit SegmentWriter(std::vector<silkworm::Bytes> patterns = {}) : patterns_{std::move(patterns)} {}
+
+    //! Add the word covered by the patterns matched in increasing position, returning its index
+    std::size_t add_word(silkworm::Bytes word, std::vector<Match> matches = {}) {
+        words_.push_back({std::move(word), std::move(matches)});
+        return words_.size() - 1;
+    }
+
+    //! Write the segment file, returning the offset of each word
+    std::vector<uint64_t> write(const std::filesystem::path& path) const {
+        // The positions are the word sizes and the relative pattern positions, all shifted by one, plus the terminator
+        std::vector<uint64_t> positions{0};
+        for (const auto& [word, matches] : words_) {
+            positions.push_back(word.size() + 1);
+            uint64_t previous{0};
+            for (const auto& match : matches) {
+                positions.push_back(match.position - previous + 1);
+                previous = match.position;
+            }
+        }
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+        const auto position_codes = assign_codes(positions.size());
+        std::map<uint64_t, std::size_t> position_symbols;
+        for (std::size_t i{0}; i < positions.size(); ++i) {
+            position_symbols[positions[i]] = i;
+        }
+        const auto pattern_codes = assign_codes(patterns_.size());
+
+        silkworm::Bytes data;
+        std::vector<uint64_t> offsets;
+        uint64_t empty_words{0};
+        for (const auto& [word, matches] : words_) {
+            offsets.push_back(data.size());
+            empty_words += word.empty() ? 1 : 0;
+            BitWriter writer{data};
+            writer.write(position_codes[position_symbols[word.size() + 1]]);
+            uint64_t previous{0};
+            std::vector<bool> covered(word.size(), false);
+            for (const auto& match : matches) {
+                writer.write(position_codes[position_symbols[match.position - previous + 1]]);
+                writer.write(pattern_codes[match.pattern]);
+                previous = match.position;
+                for (std::size_t i{0}; i < patterns_[match.pattern].size(); ++i) {
+                    covered[match.position + i] = true;
+                }
+            }
+            if (!word.empty()) {
+                writer.write(position_codes[position_symbols[0]]);
+            }
+            for (std::size_t i{0}; i < word.size(); ++i) {
+                if (!covered[i]) {
+                    data.push_back(word[i]);
+                }
+            }
+        }
+
+        silkworm::Bytes file;
+        append_u64(file, words_.size());
+        append_u64(file, empty_words);
+        silkworm::Bytes dictionary;
+        for (std::size_t i{0}; i < patterns_.size(); ++i) {
+            append_varint(dictionary, pattern_codes[i].second);
+            append_varint(dictionary, patterns_[i].size());
+            dictionary += patterns_[i];
+        }
+        append_u64(file, dictionary.size());
+        file += dictionary;
+        dictionary.clear();
+        for (std::size_t i{0}; i < positions.size(); ++i) {
+            append_varint(dictionary, position_codes[i].second);
+            append_varint(dictionary, positions[i]);
+        }
+        append_u64(file, dictionary.size());
+        file += dictionary;
+        file += data;
+        write_file(path, file);
+        return offsets;
+    }
+
+    static void append_u64(silkworm::Bytes& bytes, uint64_t value) {
+        bytes.resize(bytes.size() + sizeof(uint64_t));
+        boost::endian::store_big_u64(bytes.data() + bytes.size() - sizeof(uint64_t), value);
+    }
+
+    static void write_file(const std::filesystem::path& path, const silkworm::Bytes& bytes) {
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+
+private:
+    //! The code bits (least significant first) and the depth of each symbol
+    using Code = std::pair<uint64_t, uint64_t>;
+
+    class BitWriter {
+    public:
+        explicit BitWriter(silkworm::Bytes& bytes) : bytes_{bytes} {}
+
+        void write(const Code& code) {
+            for (uint64_t i{0}; i < code.second; ++i) {
+                if (bit_ == 0) {
+                    bytes_.push_back(0);
+                }
+                bytes_.back() |= static_cast<uint8_t>(((code.first >> i) & 1) << bit_);
+                bit_ = (bit_ + 1) % 8;
+            }
+        }
+
+    private:
+        silkworm::Bytes& bytes_;
+        unsigned bit_{0};
+    };
+
+    //! Assign the codes of a complete binary tree having the shallower leaves first, as Erigon walks the depths
+    static std::vector<Code> assign_codes(std::size_t count) {
+        std::vector<Code> codes;
+        if (count == 0) {
+            return codes;
+        }
+        uint64_t depth{0};
+        while ((uint64_t{1} << depth) < count) {
+            ++depth;
+        }
+        const uint64_t shallow_count{(uint64_t{1} << depth) - count};
+        std::vector<uint64_t> depths(count, depth);
+        std::fill(depths.begin(), depths.begin() + static_cast<std::ptrdiff_t>(shallow_count), depth - 1);
+        std::size_t next{0};
+        assign(depths, next, 0, 0, codes);
+        return codes;
+    }
+
+    static void assign(const std::vector<uint64_t>& depths, std::size_t& next, uint64_t code, uint64_t depth, std::vector<Code>& codes) {
+        if (next == depths.size()) {
+            return;
+        }
+        if (depths[next] == depth) {
+            codes.emplace_back(code, depth);
+            ++next;
+            return;
+        }
+        assign(depths, next, code, depth + 1, codes);
+        assign(depths, next, code | (uint64_t{1} << depth), depth + 1, codes);
+    }
+
+    static void append_varint(silkworm::Bytes& bytes, uint64_t value) {
+        while (value >= 0x80) {
+            bytes.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back(static_cast<uint8_t>(value));
+    }
+
+    std::vector<silkworm::Bytes> patterns_;
+    std::vector<std::pair<silkworm::Bytes, std::vector<Match>>> words_;
+};
+
+//! Encode the non-empty monotone list of integers in the Elias-Fano format read by ethdb::snapshot::EliasFanoList, i.e.
+//! as by the Erigon eliasfano32 package
+inline silkworm::Bytes encode_elias_fano(const std::vector<uint64_t>& values) {
+    if (values.empty()) {
+        throw std::invalid_argument{"empty Elias-Fano list"};
+    }
+    silkworm::Bytes list;
+    constexpr uint64_t kQ{256};
+    constexpr uint64_t kSuperQ{1 << 14};
+    constexpr uint64_t kSuperQSize{1 + kSuperQ / kQ / 2};
+    const uint64_t count{values.size()};
+    const uint64_t upper_bound{values.back() + 1};
+    const uint64_t average_gap{upper_bound / count};
+    uint64_t l{0};
+    while ((average_gap >> (l + 1)) != 0) {
+        ++l;
+    }
+    const uint64_t lower_words{(count * l + 63) / 64 + 1};
+    const uint64_t upper_words{(count + (upper_bound >> l) + 63) / 64};
+    uint64_t jump_words{(count / kSuperQ) * kSuperQSize};
+    if (count % kSuperQ != 0) {
+        jump_words += 1 + ((count % kSuperQ + kQ - 1) / kQ + 3) / 2;
+    }
+    std::vector<uint64_t> words(lower_words + upper_words + jump_words, 0);
+    uint64_t* lower_bits = words.data();
+    uint64_t* upper_bits = lower_bits + lower_words;
+    uint64_t* jump = upper_bits + upper_words;
+    for (uint64_t i{0}; i < count; ++i) {
+        const uint64_t lower{values[i] & ((uint64_t{1} << l) - 1)};
+        for (uint64_t b{0}; b < l; ++b) {
+            const uint64_t position{i * l + b};
+            lower_bits[position / 64] |= ((lower >> b) & 1) << (position % 64);
+        }
+        const uint64_t upper_position{(values[i] >> l) + i};
+        upper_bits[upper_position / 64] |= uint64_t{1} << (upper_position % 64);
+    }
+    for (uint64_t i{0}, c{0}, last_super_q{0}; i < upper_words; ++i) {
+        for (uint64_t b{0}; b < 64; ++b) {
+            if ((upper_bits[i] & (uint64_t{1} << b)) == 0) {
+                continue;
+            }
+            if (c % kSuperQ == 0) {
+                last_super_q = i * 64 + b;
+                jump[(c / kSuperQ) * kSuperQSize] = last_super_q;
+            }
+            if (c % kQ == 0) {
+                const uint64_t offset{i * 64 + b - last_super_q};
+                const uint64_t inside{(c % kSuperQ) / kQ};
+                jump[(c / kSuperQ) * kSuperQSize + 1 + inside / 2] |= offset << (32 * (inside % 2));
+            }
+            ++c;
+        }
+    }
+    SegmentWriter::append_u64(list, count - 1);
+    SegmentWriter::append_u64(list, upper_bound);
+    for (const auto word : words) {
+        list.resize(list.size() + sizeof(uint64_t));
+        boost::endian::store_little_u64(list.data() + list.size() - sizeof(uint64_t), word);
+    }
+    return list;
+}
+
+//! Write the test index file in the format read by ethdb::snapshot::Index, i.e. the Erigon RecSplit index built with
+//! enumeration: the hash function itself is left empty, since just the offset list is read
+inline void write_index_file(const std::filesystem::path& path, uint64_t base_data_id, const std::vector<uint64_t>& offsets) {
+    if (offsets.empty()) {
+        throw std::invalid_argument{"empty index file"};
+    }
+    silkworm::Bytes file;
+    SegmentWriter::append_u64(file, base_data_id);
+    SegmentWriter::append_u64(file, offsets.size());
+    constexpr uint8_t kBytesPerRecord{4};
+    file.push_back(kBytesPerRecord);
+    file.append(offsets.size() * kBytesPerRecord, 0);
+    SegmentWriter::append_u64(file, 1); // bucket count
+    file.append({0x07, 0xd0, 0x00, 0x08}); // bucket size and leaf size
+    file.append({0x00, 0x00, 0x00, 0x00}); // salt
+    file.push_back(1); // one start seed
+    SegmentWriter::append_u64(file, 0x106393c187cae21a);
+    file.push_back(1); // enumeration
+
+    file += encode_elias_fano(offsets);
+    SegmentWriter::write_file(path, file);
+}
+
+} // namespace silkrpc::test
+
+#endif // SILKRPC_TEST_SNAPSHOT_FILES_HPP_
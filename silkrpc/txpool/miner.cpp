@@ -37,7 +37,9 @@ boost::asio::awaitable<WorkResult> Miner::get_work() {
     const auto start_time = clock_time::now();
     SILKRPC_DEBUG << "Miner::get_work\n";
     UnaryRpc<&::txpool::Mining::StubInterface::AsyncGetWork> get_work_rpc{*stub_, grpc_context_};
-    const auto reply = co_await get_work_rpc.finish_on(executor_, ::txpool::GetWorkRequest{});
+    get_work_rpc.disable_compression();
+    co_await get_work_rpc.finish_on(executor_, ::txpool::GetWorkRequest{});
+    const auto& reply = get_work_rpc.reply();
     const auto header_hash = silkworm::bytes32_from_hex(reply.headerhash());
     SILKRPC_DEBUG << "Miner::get_work header_hash=" << header_hash << "\n";
     const auto seed_hash = silkworm::bytes32_from_hex(reply.seedhash());
@@ -59,7 +61,9 @@ boost::asio::awaitable<bool> Miner::submit_work(const silkworm::Bytes& block_non
     submit_work_request.set_powhash(pow_hash.bytes, silkworm::kHashLength);
     submit_work_request.set_digest(digest.bytes, silkworm::kHashLength);
     UnaryRpc<&::txpool::Mining::StubInterface::AsyncSubmitWork> submit_work_rpc{*stub_, grpc_context_};
-    const auto reply = co_await submit_work_rpc.finish_on(executor_, submit_work_request);
+    submit_work_rpc.disable_compression();
+    co_await submit_work_rpc.finish_on(executor_, submit_work_request);
+    const auto& reply = submit_work_rpc.reply();
     const auto ok = reply.ok();
     SILKRPC_DEBUG << "Miner::submit_work ok=" << std::boolalpha << ok << " t=" << clock_time::since(start_time) << "\n";
     co_return ok;
@@ -72,7 +76,9 @@ boost::asio::awaitable<bool> Miner::submit_hash_rate(const intx::uint256& rate,
     submit_hashrate_request.set_rate(uint64_t(rate));
     submit_hashrate_request.set_id(id.bytes, silkworm::kHashLength);
     UnaryRpc<&::txpool::Mining::StubInterface::AsyncSubmitHashRate> submit_hash_rate_rpc{*stub_, grpc_context_};
-    const auto reply = co_await submit_hash_rate_rpc.finish_on(executor_, submit_hashrate_request);
+    submit_hash_rate_rpc.disable_compression();
+    co_await submit_hash_rate_rpc.finish_on(executor_, submit_hashrate_request);
+    const auto& reply = submit_hash_rate_rpc.reply();
     const auto ok = reply.ok();
     SILKRPC_DEBUG << "Miner::submit_hash_rate ok=" << std::boolalpha << ok << " t=" << clock_time::since(start_time) << "\n";
     co_return ok;
@@ -82,7 +88,9 @@ boost::asio::awaitable<uint64_t> Miner::get_hash_rate() {
     const auto start_time = clock_time::now();
     SILKRPC_DEBUG << "Miner::hash_rate\n";
     UnaryRpc<&::txpool::Mining::StubInterface::AsyncHashRate> get_hash_rate_rpc{*stub_, grpc_context_};
-    const auto reply = co_await get_hash_rate_rpc.finish_on(executor_, ::txpool::HashRateRequest{});
+    get_hash_rate_rpc.disable_compression();
+    co_await get_hash_rate_rpc.finish_on(executor_, ::txpool::HashRateRequest{});
+    const auto& reply = get_hash_rate_rpc.reply();
     const auto hashrate = reply.hashrate();
     SILKRPC_DEBUG << "Miner::hash_rate hashrate=" << hashrate << " t=" << clock_time::since(start_time) << "\n";
     co_return hashrate;
@@ -92,7 +100,9 @@ boost::asio::awaitable<MiningResult> Miner::get_mining() {
     const auto start_time = clock_time::now();
     SILKRPC_DEBUG << "Miner::get_mining\n";
     UnaryRpc<&::txpool::Mining::StubInterface::AsyncMining> get_mining_rpc{*stub_, grpc_context_};
-    const auto reply = co_await get_mining_rpc.finish_on(executor_, ::txpool::MiningRequest{});
+    get_mining_rpc.disable_compression();
+    co_await get_mining_rpc.finish_on(executor_, ::txpool::MiningRequest{});
+    const auto& reply = get_mining_rpc.reply();
     const auto enabled = reply.enabled();
     SILKRPC_DEBUG << "Miner::get_mining enabled=" << std::boolalpha << enabled << "\n";
     const auto running = reply.running();
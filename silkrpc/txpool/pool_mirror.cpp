@@ -0,0 +1,161 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "pool_mirror.hpp"
+
+#include <cstring>
+#include <limits>
+
+#include <silkworm/common/util.hpp>
+#include <silkworm/types/transaction.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::txpool {
+
+std::optional<std::pair<evmc::bytes32, PoolMirror::PooledTransaction>> PoolMirror::decode(TransactionInfo info, bool recover_sender) {
+    silkworm::ByteView encoded_tx{info.rlp};
+    silkworm::Transaction transaction;
+    const auto result = silkworm::rlp::decode_transaction(encoded_tx, transaction, silkworm::rlp::Eip2718Wrapping::kBoth);
+    if (result != silkworm::DecodingResult::kOk) {
+        return std::nullopt;
+    }
+    if (recover_sender) {
+        transaction.recover_sender();
+        if (!transaction.from) {
+            return std::nullopt;
+        }
+        info.sender = *transaction.from;
+    }
+    const auto hash{silkworm::keccak256(info.rlp)};
+    evmc::bytes32 tx_hash;
+    std::memcpy(tx_hash.bytes, hash.bytes, sizeof(tx_hash.bytes));
+    const auto nonce = transaction.nonce;
+    return std::make_pair(tx_hash, PooledTransaction{std::move(info), nonce, 0});
+}
+
+void PoolMirror::insert(const evmc::bytes32& tx_hash, PooledTransaction transaction) {
+    auto& slot_hash = by_sender_nonce_[{transaction.info.sender, transaction.nonce}];
+    if (slot_hash != tx_hash) {
+        by_hash_.erase(slot_hash); // replaced by the new transaction, e.g. at higher price
+        slot_hash = tx_hash;
+    }
+    by_hash_.insert_or_assign(tx_hash, std::move(transaction));
+}
+
+uint64_t PoolMirror::sequence() const {
+    std::lock_guard lock{mutex_};
+    return sequence_;
+}
+
+void PoolMirror::reconcile(const TransactionsInPool& transactions, uint64_t read_sequence) {
+    std::unordered_map<evmc::bytes32, PooledTransaction> added;
+    std::size_t num_invalid{0};
+
+    std::lock_guard lock{mutex_};
+
+    // The transactions added after the pool content has been read may be missing from it
+    for (auto& [tx_hash, transaction] : by_hash_) {
+        if (transaction.sequence > read_sequence) {
+            added.emplace(tx_hash, std::move(transaction));
+        }
+    }
+    by_hash_.clear();
+    by_sender_nonce_.clear();
+
+    ++sequence_;
+    for (const auto& info : transactions) {
+        auto decoded = decode(info, /*recover_sender=*/false);
+        if (!decoded) {
+            ++num_invalid;
+            continue;
+        }
+        decoded->second.sequence = sequence_;
+        insert(decoded->first, std::move(decoded->second));
+    }
+    for (auto& [tx_hash, transaction] : added) {
+        if (!by_hash_.contains(tx_hash)) {
+            insert(tx_hash, std::move(transaction));
+        }
+    }
+    snapshot_.reset();
+    synced_ = true;
+
+    SILKRPC_DEBUG << "PoolMirror::reconcile #transactions: " << by_hash_.size() << " #kept: " << added.size()
+                  << " #invalid: " << num_invalid << "\n";
+}
+
+bool PoolMirror::add(silkworm::ByteView rlp_tx) {
+    auto decoded = decode(TransactionInfo{PENDING, evmc::address{}, silkworm::Bytes{rlp_tx}}, /*recover_sender=*/true);
+    if (!decoded) {
+        SILKRPC_WARN << "PoolMirror::add invalid transaction: " << silkworm::to_hex(rlp_tx) << "\n";
+        return false;
+    }
+
+    std::lock_guard lock{mutex_};
+
+    if (by_hash_.size() >= kMaxTransactions && !by_hash_.contains(decoded->first)) {
+        return true;
+    }
+    decoded->second.sequence = ++sequence_;
+    insert(decoded->first, std::move(decoded->second));
+    snapshot_.reset();
+    return true;
+}
+
+bool PoolMirror::synced() const {
+    std::lock_guard lock{mutex_};
+    return synced_;
+}
+
+std::size_t PoolMirror::size() const {
+    std::lock_guard lock{mutex_};
+    return by_hash_.size();
+}
+
+std::optional<silkworm::Bytes> PoolMirror::get_transaction(const evmc::bytes32& tx_hash) const {
+    std::lock_guard lock{mutex_};
+    const auto it = by_hash_.find(tx_hash);
+    if (it == by_hash_.end()) {
+        return std::nullopt;
+    }
+    return it->second.info.rlp;
+}
+
+std::optional<uint64_t> PoolMirror::nonce(const evmc::address& sender) const {
+    std::lock_guard lock{mutex_};
+    auto it = by_sender_nonce_.upper_bound({sender, std::numeric_limits<uint64_t>::max()});
+    if (it == by_sender_nonce_.begin() || (--it)->first.first != sender) {
+        return std::nullopt;
+    }
+    return it->first.second;
+}
+
+std::shared_ptr<const TransactionsInPool> PoolMirror::transactions() {
+    std::lock_guard lock{mutex_};
+    if (!snapshot_) {
+        auto snapshot = std::make_shared<TransactionsInPool>();
+        snapshot->reserve(by_sender_nonce_.size());
+        for (const auto& [_, tx_hash] : by_sender_nonce_) {
+            snapshot->push_back(by_hash_.at(tx_hash).info);
+        }
+        snapshot_ = std::move(snapshot);
+    }
+    return snapshot_;
+}
+
+} // namespace silkrpc::txpool
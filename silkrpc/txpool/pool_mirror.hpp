@@ -0,0 +1,107 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_TXPOOL_POOL_MIRROR_HPP_
+#define SILKRPC_TXPOOL_POOL_MIRROR_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+#include <evmc/evmc.hpp>
+#include <silkworm/common/base.hpp>
+
+#include <silkrpc/txpool/transaction_pool.hpp>
+
+namespace silkrpc::txpool {
+
+//! In-process mirror of the remote transaction pool, indexed by transaction hash and by (sender, nonce) so that the pool
+//! lookups do not need any round trip. It is fed by the transactions announced by the OnAdd stream, which are always
+//! pending ones, and periodically reconciled with the whole pool content, which also drops the mined or evicted ones.
+//! The mirror is safe for concurrent use and it is authoritative just after the first reconciliation.
+class PoolMirror {
+  public:
+    //! The maximum number of mirrored transactions, the added ones beyond it are ignored until the next reconciliation
+    static constexpr std::size_t kMaxTransactions{100'000};
+
+    PoolMirror() = default;
+
+    PoolMirror(const PoolMirror&) = delete;
+    PoolMirror& operator=(const PoolMirror&) = delete;
+
+    //! The sequence number of the last change, to be taken before reading the pool content to reconcile with
+    uint64_t sequence() const;
+
+    //! Replace the mirrored transactions with the pool content read since the sequence number, keeping the ones added later
+    void reconcile(const TransactionsInPool& transactions, uint64_t read_sequence);
+
+    //! Add the pending transaction encoded in RLP, returning false if it cannot be decoded or its sender recovered
+    bool add(silkworm::ByteView rlp_tx);
+
+    //! Check if the mirror has been reconciled at least once, i.e. if its lookups can replace the remote ones
+    bool synced() const;
+
+    std::size_t size() const;
+
+    //! Return the RLP encoding of the transaction with the specified hash, if mirrored
+    std::optional<silkworm::Bytes> get_transaction(const evmc::bytes32& tx_hash) const;
+
+    //! Return the highest nonce of the transactions of the specified sender, if any is mirrored
+    std::optional<uint64_t> nonce(const evmc::address& sender) const;
+
+    //! Return the snapshot of the mirrored transactions in (sender, nonce) order, shared until the next change
+    std::shared_ptr<const TransactionsInPool> transactions();
+
+  private:
+    struct PooledTransaction {
+        TransactionInfo info;
+        uint64_t nonce{0};
+        uint64_t sequence{0};
+    };
+
+    //! Decode the hash and the nonce of the transaction, recovering its sender as well if requested
+    static std::optional<std::pair<evmc::bytes32, PooledTransaction>> decode(TransactionInfo info, bool recover_sender);
+
+    //! Insert the transaction replacing any other one having the same sender and nonce
+    void insert(const evmc::bytes32& tx_hash, PooledTransaction transaction);
+
+    //! Protect the mirrored transactions from concurrent access by request handlers and updater
+    mutable std::mutex mutex_;
+
+    //! The mirrored transactions by hash
+    std::unordered_map<evmc::bytes32, PooledTransaction> by_hash_;
+
+    //! The hash of the mirrored transactions by sender and nonce
+    std::map<std::pair<evmc::address, uint64_t>, evmc::bytes32> by_sender_nonce_;
+
+    //! The snapshot of the mirrored transactions built on demand, reset at each change
+    std::shared_ptr<const TransactionsInPool> snapshot_;
+
+    //! The sequence number of the last change
+    uint64_t sequence_{0};
+
+    bool synced_{false};
+};
+
+} // namespace silkrpc::txpool
+
+#endif // SILKRPC_TXPOOL_POOL_MIRROR_HPP_
@@ -0,0 +1,142 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "pool_mirror.hpp"
+
+#include <cstring>
+
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/types/transaction.hpp>
+
+namespace silkrpc::txpool {
+
+using evmc::literals::operator""_address, evmc::literals::operator""_bytes32;
+
+static const evmc::address kSender1{0x00000000000000000000000000000000000000aa_address};
+static const evmc::address kSender2{0x00000000000000000000000000000000000000bb_address};
+
+//! The signed raw transaction 0x4f85816f12361224a8ee15a4bd643faf3b59beba85f4942c2d0c7e19ea0ad46b on Goerli, having nonce 25
+static const silkworm::Bytes kSignedTransaction{*silkworm::from_hex(
+    "0x02f8ad05198302a5b28302a5b282b640948efe26d6839108e831d3a37ca503ea4f136a8e7380b844395093510000000000000000000000"
+    "00d179c5bed30cade4e62d53dd89240745fb4c0cc20000000000000000000000000000000000000000000000001bc16d674ec80000c080a0"
+    "471cd0902900e7c9e1fb065c75c7516103c602c46010e0b8bb1fedead6eda570a01e47dff22e5f312176cee6bc5bc4430e2c2be3f3ec45c7"
+    "e37b953f27b62e8f53")};
+static const evmc::bytes32 kSignedTransactionHash{0x4f85816f12361224a8ee15a4bd643faf3b59beba85f4942c2d0c7e19ea0ad46b_bytes32};
+
+static TransactionInfo make_transaction(TransactionType type, const evmc::address& sender, uint64_t nonce, uint64_t gas_limit = 21'000) {
+    silkworm::Transaction txn{};
+    txn.nonce = nonce;
+    txn.gas_limit = gas_limit;
+    txn.r = 1;
+    txn.s = 1;
+    TransactionInfo info{type, sender, {}};
+    silkworm::rlp::encode(info.rlp, txn, /*for_signing=*/false, /*wrap_eip2718_into_string=*/false);
+    return info;
+}
+
+static evmc::bytes32 hash_of(const TransactionInfo& info) {
+    const auto hash{silkworm::keccak256(info.rlp)};
+    evmc::bytes32 tx_hash;
+    std::memcpy(tx_hash.bytes, hash.bytes, sizeof(tx_hash.bytes));
+    return tx_hash;
+}
+
+TEST_CASE("PoolMirror empty", "[silkrpc][txpool][pool_mirror]") {
+    PoolMirror mirror;
+    CHECK(!mirror.synced());
+    CHECK(mirror.size() == 0);
+    CHECK(!mirror.get_transaction(kSignedTransactionHash));
+    CHECK(!mirror.nonce(kSender1));
+    CHECK(mirror.transactions()->empty());
+}
+
+TEST_CASE("PoolMirror reconcile", "[silkrpc][txpool][pool_mirror]") {
+    const auto tx1 = make_transaction(PENDING, kSender1, 1);
+    const auto tx2 = make_transaction(QUEUED, kSender1, 3);
+    const auto tx3 = make_transaction(BASE_FEE, kSender2, 0);
+    PoolMirror mirror;
+    mirror.reconcile({tx2, tx1, tx3, TransactionInfo{PENDING, kSender2, {0x08, 0x04}}}, mirror.sequence());
+
+    CHECK(mirror.synced());
+    CHECK(mirror.size() == 3);
+    CHECK(mirror.get_transaction(hash_of(tx1)) == tx1.rlp);
+    CHECK(mirror.get_transaction(hash_of(tx3)) == tx3.rlp);
+    CHECK(mirror.nonce(kSender1) == 3);
+    CHECK(mirror.nonce(kSender2) == 0);
+    CHECK(!mirror.nonce(0x00000000000000000000000000000000000000cc_address));
+
+    SECTION("snapshot in sender and nonce order") {
+        const auto snapshot = mirror.transactions();
+        REQUIRE(snapshot->size() == 3);
+        CHECK((*snapshot)[0].rlp == tx1.rlp);
+        CHECK((*snapshot)[1].rlp == tx2.rlp);
+        CHECK((*snapshot)[1].transaction_type == QUEUED);
+        CHECK((*snapshot)[2].rlp == tx3.rlp);
+        CHECK((*snapshot)[2].sender == kSender2);
+        CHECK(mirror.transactions() == snapshot);
+    }
+    SECTION("mined transactions are dropped") {
+        mirror.reconcile({tx2}, mirror.sequence());
+        CHECK(mirror.size() == 1);
+        CHECK(!mirror.get_transaction(hash_of(tx1)));
+        CHECK(mirror.nonce(kSender1) == 3);
+        CHECK(!mirror.nonce(kSender2));
+    }
+    SECTION("replaced transaction") {
+        const auto replacement = make_transaction(PENDING, kSender1, 1, 42'000);
+        mirror.reconcile({replacement, tx2, tx3}, mirror.sequence());
+        CHECK(mirror.size() == 3);
+        CHECK(!mirror.get_transaction(hash_of(tx1)));
+        CHECK(mirror.get_transaction(hash_of(replacement)) == replacement.rlp);
+    }
+}
+
+TEST_CASE("PoolMirror add", "[silkrpc][txpool][pool_mirror]") {
+    PoolMirror mirror;
+
+    SECTION("signed transaction") {
+        CHECK(mirror.add(kSignedTransaction));
+        CHECK(mirror.size() == 1);
+        CHECK(mirror.get_transaction(kSignedTransactionHash) == kSignedTransaction);
+        const auto snapshot = mirror.transactions();
+        REQUIRE(snapshot->size() == 1);
+        CHECK((*snapshot)[0].transaction_type == PENDING);
+        CHECK((*snapshot)[0].sender != evmc::address{});
+        CHECK(mirror.nonce((*snapshot)[0].sender) == 25);
+    }
+    SECTION("invalid transaction") {
+        CHECK(!mirror.add(silkworm::Bytes{0x08, 0x04}));
+        CHECK(mirror.size() == 0);
+    }
+    SECTION("added while reading the content to reconcile with") {
+        const auto tx1 = make_transaction(PENDING, kSender1, 1);
+        const auto read_sequence = mirror.sequence();
+        CHECK(mirror.add(kSignedTransaction));
+        mirror.reconcile({tx1}, read_sequence);
+        CHECK(mirror.size() == 2);
+        CHECK(mirror.get_transaction(kSignedTransactionHash));
+
+        // Dropped by the next reconciliation if not in the pool anymore
+        mirror.reconcile({tx1}, mirror.sequence());
+        CHECK(mirror.size() == 1);
+        CHECK(!mirror.get_transaction(kSignedTransactionHash));
+    }
+}
+
+} // namespace silkrpc::txpool
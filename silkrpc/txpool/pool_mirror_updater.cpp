@@ -0,0 +1,138 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "pool_mirror_updater.hpp"
+
+#include <exception>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/experimental/as_tuple.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::txpool {
+
+//! Define Asio coroutine-based completion token using error codes instead of exceptions for errors
+constexpr auto use_nothrow_awaitable = boost::asio::experimental::as_tuple(boost::asio::use_awaitable);
+
+PoolMirrorUpdater::PoolMirrorUpdater(Context& context, std::shared_ptr<grpc::Channel> channel, std::shared_ptr<PoolMirror> mirror,
+    std::chrono::milliseconds reconcile_interval)
+    : scheduler_(*context.io_context()),
+      grpc_context_(*context.grpc_context()),
+      stub_(::txpool::Txpool::NewStub(channel, grpc::StubOptions())),
+      remote_pool_(scheduler_, channel, grpc_context_),
+      mirror_(std::move(mirror)),
+      reconcile_interval_(reconcile_interval),
+      reconcile_timer_{scheduler_},
+      retry_timer_{scheduler_} {}
+
+void PoolMirrorUpdater::open() {
+    boost::asio::co_spawn(scheduler_, receive_added_transactions(), boost::asio::detached);
+    boost::asio::co_spawn(scheduler_, reconcile_periodically(), boost::asio::detached);
+}
+
+void PoolMirrorUpdater::close() {
+    boost::asio::post(scheduler_, [&]() {
+        closed_ = true;
+        reconcile_timer_.cancel();
+        retry_timer_.cancel();
+        if (on_add_rpc_) {
+            on_add_rpc_->cancel();
+        }
+        SILKRPC_DEBUG << "Pool mirror updater closed\n";
+    });
+}
+
+void PoolMirrorUpdater::on_state_changes(const remote::StateChangeBatch& state_changes) {
+    if (state_changes.changebatch_size() > 0) {
+        reconcile_requested_ = true;
+        reconcile_timer_.cancel();
+    }
+}
+
+boost::asio::awaitable<void> PoolMirrorUpdater::receive_added_transactions() {
+    SILKRPC_TRACE << "PoolMirrorUpdater::receive_added_transactions START\n";
+
+    while (!closed_) {
+        on_add_rpc_ = std::make_shared<OnAddRpc>(*stub_, grpc_context_);
+
+        const auto [req_ec] = co_await on_add_rpc_->request_on(scheduler_.get_executor(), ::txpool::OnAddRequest{}, use_nothrow_awaitable);
+        if (!req_ec) {
+            SILKRPC_INFO << "Txpool OnAdd stream opened\n";
+            std::error_code read_ec;
+            ::txpool::OnAddReply reply;
+            while (!read_ec) {
+                std::tie(read_ec, reply) = co_await on_add_rpc_->read_on(scheduler_.get_executor(), use_nothrow_awaitable);
+                if (!read_ec) {
+                    for (const auto& rlp_tx : reply.rpltxs()) {
+                        mirror_->add(silkworm::ByteView{reinterpret_cast<const uint8_t*>(rlp_tx.data()), rlp_tx.size()});
+                    }
+                }
+            }
+            if (!closed_) {
+                SILKRPC_WARN << "Txpool OnAdd stream read error [" << read_ec.message() << "], schedule reopen\n";
+            }
+        } else if (!closed_) {
+            SILKRPC_WARN << "Txpool OnAdd stream request error [" << req_ec.message() << "], schedule reopen\n";
+        }
+        if (closed_) {
+            break;
+        }
+
+        // The transactions added meanwhile are picked up by the next reconciliation
+        retry_timer_.expires_after(kRetryInterval);
+        co_await retry_timer_.async_wait(use_nothrow_awaitable);
+    }
+    on_add_rpc_.reset();
+
+    SILKRPC_TRACE << "PoolMirrorUpdater::receive_added_transactions END\n";
+}
+
+boost::asio::awaitable<void> PoolMirrorUpdater::reconcile_periodically() {
+    SILKRPC_TRACE << "PoolMirrorUpdater::reconcile_periodically START\n";
+
+    while (!closed_) {
+        reconcile_requested_ = false;
+        try {
+            const auto read_sequence = mirror_->sequence();
+            const auto transactions = co_await remote_pool_.get_transactions();
+            mirror_->reconcile(transactions, read_sequence);
+        } catch (const std::exception& e) {
+            SILKRPC_WARN << "Pool mirror reconciliation failed: " << e.what() << "\n";
+        }
+        if (closed_) {
+            break;
+        }
+        if (reconcile_requested_) {
+            continue; // a new block came while reading the pool content
+        }
+
+        // Cancelled at each new block to reconcile right away, the mined transactions leaving the pool
+        reconcile_timer_.expires_after(reconcile_interval_);
+        co_await reconcile_timer_.async_wait(use_nothrow_awaitable);
+    }
+
+    SILKRPC_TRACE << "PoolMirrorUpdater::reconcile_periodically END\n";
+}
+
+} // namespace silkrpc::txpool
@@ -0,0 +1,110 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_TXPOOL_POOL_MIRROR_UPDATER_HPP_
+#define SILKRPC_TXPOOL_POOL_MIRROR_UPDATER_HPP_
+
+#include <chrono>
+#include <memory>
+
+#include <silkrpc/config.hpp>
+
+#include <agrpc/grpc_context.hpp>
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <grpcpp/grpcpp.h>
+
+#include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/grpc/server_streaming_rpc.hpp>
+#include <silkrpc/interfaces/remote/kv.pb.h>
+#include <silkrpc/interfaces/txpool/txpool.grpc.pb.h>
+#include <silkrpc/txpool/pool_mirror.hpp>
+#include <silkrpc/txpool/transaction_pool.hpp>
+
+namespace silkrpc::txpool {
+
+using OnAddRpc = ServerStreamingRpc<&::txpool::Txpool::StubInterface::PrepareAsyncOnAdd>;
+
+//! Updater of the pool mirror, adding the transactions announced by the OnAdd stream of the remote pool and reconciling
+//! the mirror with the whole pool content periodically and at each new block, when mined transactions leave the pool
+class PoolMirrorUpdater {
+  public:
+    //! The default interval between successive reconciliations, if no new block comes first
+    static constexpr std::chrono::milliseconds kDefaultReconcileInterval{5'000};
+
+    //! The retry interval between successive attempts to open the OnAdd stream
+    static constexpr std::chrono::milliseconds kRetryInterval{10'000};
+
+    explicit PoolMirrorUpdater(Context& context, std::shared_ptr<grpc::Channel> channel, std::shared_ptr<PoolMirror> mirror,
+        std::chrono::milliseconds reconcile_interval = kDefaultReconcileInterval);
+
+    PoolMirrorUpdater(const PoolMirrorUpdater&) = delete;
+    PoolMirrorUpdater& operator=(const PoolMirrorUpdater&) = delete;
+
+    //! Start receiving the added transactions and reconciling the mirror
+    void open();
+
+    //! Stop receiving the added transactions and reconciling the mirror
+    void close();
+
+    //! Reconcile the mirror right away after a new block, to be called on the context running the updater
+    void on_state_changes(const remote::StateChangeBatch& state_changes);
+
+  private:
+    //! The open-and-receive asynchronous loop of the OnAdd stream
+    boost::asio::awaitable<void> receive_added_transactions();
+
+    //! The read-and-reconcile asynchronous loop of the whole pool content
+    boost::asio::awaitable<void> reconcile_periodically();
+
+    //! Asio execution scheduler running the updater loops
+    boost::asio::io_context& scheduler_;
+
+    //! gRPC execution scheduler running the updater loops
+    agrpc::GrpcContext& grpc_context_;
+
+    //! The gRPC stub for the remote pool, used by the OnAdd stream
+    std::unique_ptr<::txpool::Txpool::StubInterface> stub_;
+
+    //! The remote pool reading the whole pool content
+    TransactionPool remote_pool_;
+
+    //! The mirror to update
+    std::shared_ptr<PoolMirror> mirror_;
+
+    //! The interval between successive reconciliations
+    std::chrono::milliseconds reconcile_interval_;
+
+    //! The timer waiting for the next reconciliation, cancelled to anticipate it
+    boost::asio::steady_timer reconcile_timer_;
+
+    //! The timer to schedule retries for stream opening
+    boost::asio::steady_timer retry_timer_;
+
+    //! The current OnAdd call, to be cancelled when closing
+    std::shared_ptr<OnAddRpc> on_add_rpc_;
+
+    //! Flag indicating that a new block came after the last reconciliation started
+    bool reconcile_requested_{false};
+
+    bool closed_{false};
+};
+
+} // namespace silkrpc::txpool
+
+#endif // SILKRPC_TXPOOL_POOL_MIRROR_UPDATER_HPP_
@@ -16,13 +16,24 @@
 
 #include "transaction_pool.hpp"
 
+#include <algorithm>
+#include <type_traits>
+
+#include <boost/asio/compose.hpp>
+#include <boost/asio/experimental/as_tuple.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/this_coro.hpp>
 #include <boost/endian/conversion.hpp>
 
 #include <silkrpc/common/clock_time.hpp>
 #include <silkrpc/grpc/unary_rpc.hpp>
+#include <silkrpc/txpool/pool_mirror.hpp>
 
 namespace silkrpc::txpool {
 
+//! Define Asio coroutine-based completion token using error codes instead of exceptions for errors
+constexpr auto use_nothrow_awaitable = boost::asio::experimental::as_tuple(boost::asio::use_awaitable);
+
 TransactionPool::TransactionPool(boost::asio::io_context& context, std::shared_ptr<grpc::Channel> channel, agrpc::GrpcContext& grpc_context)
     : TransactionPool(context.get_executor(), ::txpool::Txpool::NewStub(channel, grpc::StubOptions()), grpc_context) {}
 
@@ -36,44 +47,159 @@ TransactionPool::~TransactionPool() {
 }
 
 boost::asio::awaitable<OperationResult> TransactionPool::add_transaction(const silkworm::ByteView& rlp_tx) {
-    const auto start_time = clock_time::now();
     SILKRPC_DEBUG << "TransactionPool::add_transaction rlp_tx=" << silkworm::to_hex(rlp_tx) << "\n";
+    std::shared_ptr<AddBatch> batch;
+    std::size_t index{0};
+    bool leader{false};
+    bool wait_window{false};
+    {
+        std::lock_guard lock{add_mutex_};
+        if (!open_batch_) {
+            open_batch_ = std::make_shared<AddBatch>(executor_);
+            leader = true;
+        }
+        batch = open_batch_;
+        index = batch->rlp_txs.size();
+        batch->rlp_txs.emplace_back(rlp_tx);
+        if (batch->rlp_txs.size() >= max_add_batch_size_) {
+            // The full batch is closed to the new transactions and its leader does not need to wait anymore
+            batch->closed = true;
+            open_batch_.reset();
+            if (!leader) {
+                boost::asio::post(executor_, [batch]() { batch->timer.cancel(); });
+            }
+        } else if (leader) {
+            batch->timer.expires_after(add_batch_window_);
+            wait_window = true;
+        }
+    }
+    if (!leader) {
+        co_await wait(batch);
+        if (batch->exception) {
+            std::rethrow_exception(batch->exception);
+        }
+        co_return batch->results[index];
+    }
+
+    if (wait_window) {
+        co_await batch->timer.async_wait(use_nothrow_awaitable);
+        std::lock_guard lock{add_mutex_};
+        if (open_batch_ == batch) {
+            open_batch_.reset();
+        }
+        batch->closed = true;
+    }
+
+    std::vector<OperationResult> results;
+    std::exception_ptr exception;
+    try {
+        results = co_await add_transactions(batch->rlp_txs);
+    } catch (...) {
+        exception = std::current_exception();
+    }
+
+    std::vector<std::function<void()>> waiters;
+    {
+        std::lock_guard lock{add_mutex_};
+        batch->done = true;
+        batch->results = results;
+        batch->exception = exception;
+        waiters.swap(batch->waiters);
+    }
+    for (const auto& waiter : waiters) {
+        waiter();
+    }
+
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+    co_return results[0];
+}
+
+void TransactionPool::set_add_batching(std::chrono::microseconds window, std::size_t max_size) {
+    add_batch_window_ = window;
+    max_add_batch_size_ = std::max(max_size, std::size_t{1});
+}
+
+boost::asio::awaitable<void> TransactionPool::wait(std::shared_ptr<AddBatch> batch) {
+    // The waiter is resumed on its own executor, whatever the thread completing the batch
+    const auto executor = co_await boost::asio::this_coro::executor;
+    co_await boost::asio::async_compose<decltype(boost::asio::use_awaitable), void()>(
+        [&](auto&& self) {
+            auto shared_self = std::make_shared<std::decay_t<decltype(self)>>(std::move(self));
+            auto resume = [executor, shared_self]() {
+                boost::asio::post(executor, [shared_self]() { shared_self->complete(); });
+            };
+            std::lock_guard lock{add_mutex_};
+            if (batch->done) {
+                resume();
+            } else {
+                batch->waiters.emplace_back(std::move(resume));
+            }
+        },
+        boost::asio::use_awaitable);
+}
+
+boost::asio::awaitable<std::vector<OperationResult>> TransactionPool::add_transactions(const std::vector<silkworm::Bytes>& rlp_txs) {
+    const auto start_time = clock_time::now();
+    SILKRPC_DEBUG << "TransactionPool::add_transactions #rlp_txs=" << rlp_txs.size() << "\n";
     ::txpool::AddRequest request;
-    request.add_rlptxs(rlp_tx.data(), rlp_tx.size());
+    for (const auto& rlp_tx : rlp_txs) {
+        request.add_rlptxs(rlp_tx.data(), rlp_tx.size());
+    }
     UnaryRpc<&::txpool::Txpool::StubInterface::AsyncAdd> add_transaction_rpc{*stub_, grpc_context_};
-    const auto reply = co_await add_transaction_rpc.finish_on(executor_, request);
+    co_await add_transaction_rpc.finish_on(executor_, request);
+    const auto& reply = add_transaction_rpc.reply();
     const auto imported_size = reply.imported_size();
     const auto errors_size = reply.errors_size();
-    SILKRPC_DEBUG << "TransactionPool::add_transaction imported_size=" << imported_size << " errors_size=" << errors_size << "\n";
-    OperationResult result;
-    if (imported_size == 1) {
-        const auto import_result = reply.imported(0);
-        SILKRPC_DEBUG << "TransactionPool::add_transaction import_result=" << import_result << "\n";
+    SILKRPC_DEBUG << "TransactionPool::add_transactions imported_size=" << imported_size << " errors_size=" << errors_size << "\n";
+    std::vector<OperationResult> results(rlp_txs.size());
+    if (static_cast<std::size_t>(imported_size) != rlp_txs.size()) {
+        for (auto& result : results) {
+            result.success = false;
+            result.error_descr = "unexpected imported size";
+        }
+        SILKRPC_WARN << "TransactionPool::add_transactions unexpected imported_size=" << imported_size << "\n";
+        co_return results;
+    }
+    for (int i{0}; i < imported_size; ++i) {
+        auto& result = results[static_cast<std::size_t>(i)];
+        const auto import_result = reply.imported(i);
+        SILKRPC_DEBUG << "TransactionPool::add_transactions import_result=" << import_result << "\n";
         if (import_result != ::txpool::ImportResult::SUCCESS) {
             result.success = false;
-            if (errors_size >= 1) {
-                const auto import_error = reply.errors(0);
+            // The errors are positional, the successful transactions having empty ones
+            if (errors_size > i && !reply.errors(i).empty()) {
+                const auto import_error = reply.errors(i);
                 result.error_descr = import_error;
-                SILKRPC_WARN << "TransactionPool::add_transaction import_result=" << import_result << " error=" << import_error << "\n";
+                SILKRPC_WARN << "TransactionPool::add_transactions import_result=" << import_result << " error=" << import_error << "\n";
             } else {
                 result.error_descr = "no specific error";
-                SILKRPC_WARN << "TransactionPool::add_transaction import_result=" << import_result << ", no error received\n";
+                SILKRPC_WARN << "TransactionPool::add_transactions import_result=" << import_result << ", no error received\n";
             }
         } else {
             result.success = true;
+            // Make the transaction visible to the mirror lookups right away, without waiting for the OnAdd stream
+            if (mirror_) {
+                mirror_->add(rlp_txs[static_cast<std::size_t>(i)]);
+            }
         }
-    } else {
-        result.success = false;
-        result.error_descr = "unexpected imported size";
-        SILKRPC_WARN << "TransactionPool::add_transaction unexpected imported_size=" << imported_size << "\n";
     }
-    SILKRPC_DEBUG << "TransactionPool::add_transaction t=" << clock_time::since(start_time) << "\n";
-    co_return result;
+    SILKRPC_DEBUG << "TransactionPool::add_transactions t=" << clock_time::since(start_time) << "\n";
+    co_return results;
 }
 
 boost::asio::awaitable<std::optional<silkworm::Bytes>> TransactionPool::get_transaction(const evmc::bytes32& tx_hash) {
     const auto start_time = clock_time::now();
     SILKRPC_DEBUG << "TransactionPool::get_transaction tx_hash=" << tx_hash << "\n";
+    if (const auto mirror = synced_mirror()) {
+        // A miss may be a transaction just added and not yet mirrored, so the remote pool is asked anyway
+        auto rlp_tx = mirror->get_transaction(tx_hash);
+        if (rlp_tx) {
+            SILKRPC_DEBUG << "TransactionPool::get_transaction mirrored t=" << clock_time::since(start_time) << "\n";
+            co_return rlp_tx;
+        }
+    }
     auto hi = new ::types::H128{};
     auto lo = new ::types::H128{};
     hi->set_hi(evmc::load64be(tx_hash.bytes + 0));
@@ -85,7 +211,8 @@ boost::asio::awaitable<std::optional<silkworm::Bytes>> TransactionPool::get_tran
     hash_h256->set_allocated_hi(hi);  // take ownership
     hash_h256->set_allocated_lo(lo);  // take ownership
     UnaryRpc<&::txpool::Txpool::StubInterface::AsyncTransactions> get_transactions_rpc{*stub_, grpc_context_};
-    const auto reply = co_await get_transactions_rpc.finish_on(executor_, request);
+    co_await get_transactions_rpc.finish_on(executor_, request);
+    const auto& reply = get_transactions_rpc.reply();
     const auto rlptxs_size = reply.rlptxs_size();
     SILKRPC_DEBUG << "TransactionPool::get_transaction rlptxs_size=" << rlptxs_size << "\n";
     if (rlptxs_size == 1) {
@@ -102,10 +229,15 @@ boost::asio::awaitable<std::optional<silkworm::Bytes>> TransactionPool::get_tran
 boost::asio::awaitable<std::optional<uint64_t>> TransactionPool::nonce(const evmc::address& address) {
     const auto start_time = clock_time::now();
     SILKRPC_DEBUG << "TransactionPool::nonce address=" << address << "\n";
+    if (const auto mirror = synced_mirror()) {
+        co_return mirror->nonce(address);
+    }
     ::txpool::NonceRequest request;
     request.set_allocated_address(H160_from_address(address));
     UnaryRpc<&::txpool::Txpool::StubInterface::AsyncNonce> nonce_rpc{*stub_, grpc_context_};
-    const auto reply = co_await nonce_rpc.finish_on(executor_, request);
+    nonce_rpc.disable_compression();
+    co_await nonce_rpc.finish_on(executor_, request);
+    const auto& reply = nonce_rpc.reply();
     SILKRPC_DEBUG << "TransactionPool::nonce found:" << reply.found() << " nonce: " << reply.nonce() <<
                         " t=" << clock_time::since(start_time) << "\n";
     co_return reply.found() ? std::optional<uint64_t>{reply.nonce()} : std::nullopt;
@@ -116,7 +248,9 @@ boost::asio::awaitable<StatusInfo> TransactionPool::get_status() {
     SILKRPC_DEBUG << "TransactionPool::get_status\n";
     ::txpool::StatusRequest request;
     UnaryRpc<&::txpool::Txpool::StubInterface::AsyncStatus> status_rpc{*stub_, grpc_context_};
-    const auto reply = co_await status_rpc.finish_on(executor_, request);
+    status_rpc.disable_compression();
+    co_await status_rpc.finish_on(executor_, request);
+    const auto& reply = status_rpc.reply();
     StatusInfo status_info{
         .queued_count = reply.queuedcount(),
         .pending_count = reply.pendingcount(),
@@ -129,9 +263,13 @@ boost::asio::awaitable<StatusInfo> TransactionPool::get_status() {
 boost::asio::awaitable<TransactionsInPool> TransactionPool::get_transactions() {
     const auto start_time = clock_time::now();
     SILKRPC_DEBUG << "TransactionPool::get_transactions\n";
+    if (const auto mirror = synced_mirror()) {
+        co_return *mirror->transactions();
+    }
     ::txpool::AllRequest request;
     UnaryRpc<&::txpool::Txpool::StubInterface::AsyncAll> all_rpc{*stub_, grpc_context_};
-    const auto reply = co_await all_rpc.finish_on(executor_, request);
+    co_await all_rpc.finish_on(executor_, request);
+    const auto& reply = all_rpc.reply();
     TransactionsInPool transactions_in_pool;
     const auto txs_size = reply.txs_size();
     for (int i = 0; i < txs_size; i++) {
@@ -153,6 +291,17 @@ boost::asio::awaitable<TransactionsInPool> TransactionPool::get_transactions() {
     co_return transactions_in_pool;
 }
 
+boost::asio::awaitable<std::shared_ptr<const TransactionsInPool>> TransactionPool::get_transactions_snapshot() {
+    if (const auto mirror = synced_mirror()) {
+        co_return mirror->transactions();
+    }
+    co_return std::make_shared<const TransactionsInPool>(co_await get_transactions());
+}
+
+PoolMirror* TransactionPool::synced_mirror() const {
+    return mirror_ && mirror_->synced() ? mirror_.get() : nullptr;
+}
+
 evmc::address TransactionPool::address_from_H160(const types::H160& h160) {
     uint64_t hi_hi = h160.hi().hi();
     uint64_t hi_lo = h160.hi().lo();
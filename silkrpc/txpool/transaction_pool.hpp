@@ -17,7 +17,12 @@
 #ifndef SILKRPC_TXPOOL_TRANSACTION_POOL_HPP_
 #define SILKRPC_TXPOOL_TRANSACTION_POOL_HPP_
 
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <utility>
@@ -27,6 +32,7 @@
 
 #include <agrpc/grpc_context.hpp>
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/asio/use_awaitable.hpp>
 #include <evmc/evmc.hpp>
 #include <grpcpp/grpcpp.h>
@@ -65,8 +71,16 @@ struct TransactionInfo {
 
 using TransactionsInPool = std::vector<TransactionInfo>;
 
+class PoolMirror;
+
 class TransactionPool final {
 public:
+    //! The default window gathering the concurrent transactions to add into one single call
+    static constexpr std::chrono::microseconds kDefaultAddBatchWindow{1'000};
+
+    //! The default maximum number of transactions added by one single call
+    static constexpr std::size_t kDefaultMaxAddBatchSize{64};
+
     explicit TransactionPool(boost::asio::io_context& context, std::shared_ptr<grpc::Channel> channel, agrpc::GrpcContext& grpc_context);
 
     explicit TransactionPool(boost::asio::io_context::executor_type executor, std::unique_ptr<::txpool::Txpool::StubInterface> stub,
@@ -74,8 +88,12 @@ public:
 
     ~TransactionPool();
 
+    //! Add the transaction along with the ones added concurrently within the batch window, in one single call
     boost::asio::awaitable<OperationResult> add_transaction(const silkworm::ByteView& rlp_tx);
 
+    //! Set the window and the maximum size of the add batches, a size of one disables batching
+    void set_add_batching(std::chrono::microseconds window, std::size_t max_size);
+
     boost::asio::awaitable<std::optional<silkworm::Bytes>> get_transaction(const evmc::bytes32& tx_hash);
 
     boost::asio::awaitable<std::optional<uint64_t>> nonce(const evmc::address& address);
@@ -84,7 +102,35 @@ public:
 
     boost::asio::awaitable<TransactionsInPool> get_transactions();
 
+    //! Return the pool content shared by all the callers until the pool changes, if mirrored, or read just for this call
+    boost::asio::awaitable<std::shared_ptr<const TransactionsInPool>> get_transactions_snapshot();
+
+    //! Serve the lookups from the local mirror of the pool once it is synced, instead of the remote pool
+    void set_mirror(std::shared_ptr<PoolMirror> mirror) { mirror_ = std::move(mirror); }
+
 private:
+    //! The transactions gathered to be added in one single call, whose leader makes the call for them all
+    struct AddBatch {
+        explicit AddBatch(boost::asio::io_context::executor_type executor) : timer{executor} {}
+
+        std::vector<silkworm::Bytes> rlp_txs;
+        boost::asio::steady_timer timer;
+        bool closed{false};
+        bool done{false};
+        std::vector<OperationResult> results;
+        std::exception_ptr exception;
+        std::vector<std::function<void()>> waiters;
+    };
+
+    //! Add the transactions in one single call, returning the result for each of them
+    boost::asio::awaitable<std::vector<OperationResult>> add_transactions(const std::vector<silkworm::Bytes>& rlp_txs);
+
+    //! Wait for the leader of the batch to complete the call
+    boost::asio::awaitable<void> wait(std::shared_ptr<AddBatch> batch);
+
+    //! Return the mirror of the pool if it can replace the remote lookups, nullptr otherwise
+    PoolMirror* synced_mirror() const;
+
     evmc::address address_from_H160(const types::H160& h160);
     types::H160* H160_from_address(const evmc::address& address);
     types::H128* H128_from_bytes(const uint8_t* bytes);
@@ -92,6 +138,13 @@ private:
     boost::asio::io_context::executor_type executor_;
     std::unique_ptr<::txpool::Txpool::StubInterface> stub_;
     agrpc::GrpcContext& grpc_context_;
+    std::shared_ptr<PoolMirror> mirror_;
+    std::chrono::microseconds add_batch_window_{kDefaultAddBatchWindow};
+    std::size_t max_add_batch_size_{kDefaultMaxAddBatchSize};
+
+    //! Protect the batch open to the new transactions from concurrent access
+    std::mutex add_mutex_;
+    std::shared_ptr<AddBatch> open_batch_;
 };
 
 } // namespace silkrpc::txpool
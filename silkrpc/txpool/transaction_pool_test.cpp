@@ -16,6 +16,7 @@
 
 #include "transaction_pool.hpp"
 
+#include <chrono>
 #include <string>
 #include <utility>
 
@@ -123,6 +124,44 @@ TEST_CASE_METHOD(TransactionPoolTest, "TransactionPool::add_transaction", "[silk
     }
 }
 
+TEST_CASE_METHOD(TransactionPoolTest, "TransactionPool::add_transaction batched", "[silkrpc][txpool][transaction_pool]") {
+    test::StrictMockAsyncResponseReader<::txpool::AddReply> reader;
+    EXPECT_CALL(*stub_, AsyncAddRaw).WillOnce([&](auto*, const ::txpool::AddRequest& request, auto*) {
+        CHECK(request.rlptxs_size() == 2);
+        return &reader;
+    });
+    const silkworm::Bytes tx_rlp1{0x00, 0x01};
+    const silkworm::Bytes tx_rlp2{0x00, 0x02};
+    const silkworm::ByteView tx_view1{tx_rlp1};
+    const silkworm::ByteView tx_view2{tx_rlp2};
+
+    TransactionPool tx_pool{io_context_.get_executor(), std::move(stub_), grpc_context_};
+    tx_pool.set_add_batching(std::chrono::seconds{10}, 2);
+
+    SECTION("one call for the whole batch and results fanned out") {
+        ::txpool::AddReply response;
+        response.add_imported(::txpool::ImportResult::SUCCESS);
+        response.add_imported(::txpool::ImportResult::ALREADY_EXISTS);
+        response.add_errors("");
+        response.add_errors("already known");
+        EXPECT_CALL(reader, Finish).WillOnce(test::finish_with(grpc_context_, std::move(response)));
+        auto result1 = spawn(tx_pool.add_transaction(tx_view1));
+        auto result2 = spawn(tx_pool.add_transaction(tx_view2));
+        CHECK(result1.get().success);
+        const auto result = result2.get();
+        CHECK(!result.success);
+        CHECK(result.error_descr == "already known");
+    }
+
+    SECTION("error for the whole batch") {
+        EXPECT_CALL(reader, Finish).WillOnce(test::finish_cancelled(grpc_context_));
+        auto result1 = spawn(tx_pool.add_transaction(tx_view1));
+        auto result2 = spawn(tx_pool.add_transaction(tx_view2));
+        CHECK_THROWS_AS(result1.get(), boost::system::system_error);
+        CHECK_THROWS_AS(result2.get(), boost::system::system_error);
+    }
+}
+
 TEST_CASE_METHOD(TransactionPoolTest, "TransactionPool::get_transaction", "[silkrpc][txpool][transaction_pool]") {
     test::StrictMockAsyncResponseReader<::txpool::TransactionsReply> reader;
     EXPECT_CALL(*stub_, AsyncTransactionsRaw).WillOnce(testing::Return(&reader));
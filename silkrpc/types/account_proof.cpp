@@ -0,0 +1,65 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "account_proof.hpp"
+
+#include <string>
+
+#include <silkworm/common/util.hpp>
+
+#include <silkrpc/common/util.hpp>
+#include <silkrpc/json/types.hpp>
+
+namespace silkrpc {
+
+namespace {
+
+nlohmann::json to_json_nodes(const ProofNodes& nodes) {
+    nlohmann::json json = nlohmann::json::array();
+    for (const auto& node : nodes) {
+        json.push_back("0x" + silkworm::to_hex(node));
+    }
+    return json;
+}
+
+} // namespace
+
+std::ostream& operator<<(std::ostream& out, const AccountProof& proof) {
+    out << "address: " << proof.address
+        << " account_proof: " << proof.account_proof.size()
+        << " storage_hash: 0x" << proof.storage_hash
+        << " storage_proofs: " << proof.storage_proofs.size();
+    return out;
+}
+
+void to_json(nlohmann::json& json, const StorageProof& proof) {
+    json["key"] = proof.key;
+    json["value"] = proof.value.empty() ? "0x0" : to_quantity(proof.value);
+    json["proof"] = to_json_nodes(proof.proof);
+}
+
+void to_json(nlohmann::json& json, const AccountProof& proof) {
+    json["address"] = proof.address;
+    json["accountProof"] = to_json_nodes(proof.account_proof);
+    json["balance"] = to_quantity(proof.balance);
+    json["codeHash"] = proof.code_hash;
+    json["nonce"] = to_quantity(proof.nonce);
+    json["storageHash"] = proof.storage_hash;
+    json["storageProof"] = proof.storage_proofs;
+}
+
+} // namespace silkrpc
@@ -0,0 +1,60 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef SILKRPC_TYPES_ACCOUNT_PROOF_HPP_
+#define SILKRPC_TYPES_ACCOUNT_PROOF_HPP_
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include <evmc/evmc.hpp>
+#include <intx/intx.hpp>
+#include <nlohmann/json.hpp>
+#include <silkworm/common/base.hpp>
+
+namespace silkrpc {
+
+//! The RLP-encoded trie nodes from the root down to the leaf proving the value of some key (or its absence)
+using ProofNodes = std::vector<silkworm::Bytes>;
+
+struct StorageProof {
+    evmc::bytes32 key{};
+    //! The storage value w/o leading zeros, empty if missing
+    silkworm::Bytes value;
+    ProofNodes proof;
+};
+
+//! The account and storage proofs returned by eth_getProof, as specified by EIP-1186
+struct AccountProof {
+    evmc::address address{};
+    ProofNodes account_proof;
+    intx::uint256 balance{0};
+    evmc::bytes32 code_hash{};
+    uint64_t nonce{0};
+    evmc::bytes32 storage_hash{};
+    std::vector<StorageProof> storage_proofs;
+};
+
+std::ostream& operator<<(std::ostream& out, const AccountProof& proof);
+
+void to_json(nlohmann::json& json, const StorageProof& proof);
+void to_json(nlohmann::json& json, const AccountProof& proof);
+
+} // namespace silkrpc
+
+#endif  // SILKRPC_TYPES_ACCOUNT_PROOF_HPP_
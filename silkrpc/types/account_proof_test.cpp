@@ -0,0 +1,101 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "account_proof.hpp"
+
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+#include <nlohmann/json.hpp>
+#include <silkworm/common/util.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc {
+
+using evmc::literals::operator""_address;
+using evmc::literals::operator""_bytes32;
+
+TEST_CASE("Empty AccountProof", "[silkrpc][types][account_proof]") {
+    AccountProof proof;
+    proof.address = 0x7F0d15C7FAae65896648C8273B6d7E43f58Fa842_address;
+    proof.code_hash = 0xc5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470_bytes32;
+    proof.storage_hash = 0x56e81f171bcc55a6ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421_bytes32;
+
+    SECTION("print") {
+        CHECK_NOTHROW(null_stream() << proof);
+    }
+
+    SECTION("json") {
+        nlohmann::json json = proof;
+
+        CHECK(json == R"({
+            "address": "0x7f0d15c7faae65896648c8273b6d7e43f58fa842",
+            "accountProof": [],
+            "balance": "0x0",
+            "codeHash": "0xc5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470",
+            "nonce": "0x0",
+            "storageHash": "0x56e81f171bcc55a6ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421",
+            "storageProof": []
+        })"_json);
+    }
+}
+
+TEST_CASE("Filled AccountProof", "[silkrpc][types][account_proof]") {
+    AccountProof proof;
+    proof.address = 0x7F0d15C7FAae65896648C8273B6d7E43f58Fa842_address;
+    proof.account_proof = {*silkworm::from_hex("f871a0"), *silkworm::from_hex("f8518080")};
+    proof.balance = intx::uint256{1'000'000'000};
+    proof.code_hash = 0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32;
+    proof.nonce = 12;
+    proof.storage_hash = 0xb10e2d527612073b26eecdfd717e6a320cf44b4afac2b0732d9fcbe2b7fa0cf6_bytes32;
+    proof.storage_proofs = {
+        StorageProof{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32, *silkworm::from_hex("0badc0de"),
+                     {*silkworm::from_hex("e2a0")}},
+        StorageProof{0x0000000000000000000000000000000000000000000000000000000000000002_bytes32, {}, {}},
+    };
+
+    SECTION("print") {
+        CHECK_NOTHROW(null_stream() << proof);
+    }
+
+    SECTION("json") {
+        nlohmann::json json = proof;
+
+        CHECK(json == R"({
+            "address": "0x7f0d15c7faae65896648c8273b6d7e43f58fa842",
+            "accountProof": ["0xf871a0", "0xf8518080"],
+            "balance": "0x3b9aca00",
+            "codeHash": "0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c",
+            "nonce": "0xc",
+            "storageHash": "0xb10e2d527612073b26eecdfd717e6a320cf44b4afac2b0732d9fcbe2b7fa0cf6",
+            "storageProof": [
+                {
+                    "key": "0x0000000000000000000000000000000000000000000000000000000000000001",
+                    "value": "0xbadc0de",
+                    "proof": ["0xe2a0"]
+                },
+                {
+                    "key": "0x0000000000000000000000000000000000000000000000000000000000000002",
+                    "value": "0x0",
+                    "proof": []
+                }
+            ]
+        })"_json);
+    }
+}
+
+} // namespace silkrpc
@@ -26,6 +26,15 @@
 
 namespace silkrpc {
 
+BlockHashes make_block_hashes(const silkworm::Block& block) {
+    BlockHashes hashes{hashes_of_transactions(block.transactions), {}};
+    hashes.ommer_hashes.reserve(block.ommers.size());
+    for (const auto& ommer : block.ommers) {
+        hashes.ommer_hashes.emplace_back(ommer.hash());
+    }
+    return hashes;
+}
+
 std::ostream& operator<<(std::ostream& out, const Block& b) {
     out << "parent_hash: " << b.block.header.parent_hash;
     out << " ommers_hash: " << b.block.header.ommers_hash;
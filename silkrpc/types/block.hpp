@@ -21,7 +21,9 @@
 #include <memory>
 #include <string>
 #include <variant>
+#include <vector>
 
+#include <evmc/evmc.hpp>
 #include <intx/intx.hpp>
 
 #include <silkworm/common/base.hpp>
@@ -29,10 +31,22 @@
 
 namespace silkrpc {
 
+//! The hashes of the transactions and of the ommers of a block, in block order
+struct BlockHashes {
+    std::vector<evmc::bytes32> transaction_hashes;
+    std::vector<evmc::bytes32> ommer_hashes;
+};
+
+//! Compute the hashes of the transactions and of the ommers of the block
+BlockHashes make_block_hashes(const silkworm::Block& block);
+
 struct Block : public silkworm::BlockWithHash {
     intx::uint256 total_difficulty{0};
     bool full_tx{false};
 
+    //! The memoized hashes of the block, if any: they are computed when serializing otherwise
+    std::shared_ptr<const BlockHashes> hashes;
+
     [[nodiscard]] uint64_t get_block_size() const;
 };
 
@@ -18,6 +18,7 @@
 #define SILKRPC_TYPES_CALL_HPP_
 
 #include <iostream>
+#include <map>
 #include <optional>
 #include <vector>
 
@@ -79,6 +80,21 @@ struct Call {
 
 std::ostream& operator<<(std::ostream& out, const Call& call);
 
+//! The overrides of one account applied before executing a call, any field not set being the one in the chain state
+struct AccountOverrides {
+    std::optional<intx::uint256> balance;
+    std::optional<uint64_t> nonce;
+    std::optional<silkworm::Bytes> code;
+
+    //! The storage replacing the whole account storage, i.e. any location not here reads as zero
+    std::optional<std::map<evmc::bytes32, evmc::bytes32>> state;
+
+    //! The storage locations patched over the account storage
+    std::map<evmc::bytes32, evmc::bytes32> state_diff;
+};
+
+using StateOverrides = std::map<evmc::address, AccountOverrides>;
+
 } // namespace silkrpc
 
 #endif  // SILKRPC_TYPES_CALL_HPP_
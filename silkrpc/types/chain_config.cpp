@@ -16,10 +16,48 @@
 
 #include "chain_config.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
 #include <silkrpc/common/util.hpp>
 
 namespace silkrpc {
 
+ParsedChainConfig::ParsedChainConfig(ChainConfig config, const evmc::bytes32& config_data_hash)
+    : chain_config{std::move(config)}, data_hash{config_data_hash} {
+    try {
+        silkworm_config = silkworm::ChainConfig::from_json(chain_config.config);
+    } catch (const nlohmann::json::exception&) {
+        // Any field having the wrong type makes the config invalid for the EVM, yet still readable as JSON
+    }
+    if (!silkworm_config) {
+        return;
+    }
+
+    // The fork at index i activates the revision i + 1 and the highest revision activated wins, whatever the block order
+    const auto& evmc_fork_blocks = silkworm_config->evmc_fork_blocks;
+    for (std::size_t i{0}; i < evmc_fork_blocks.size(); ++i) {
+        if (evmc_fork_blocks[i]) {
+            fork_revisions.emplace_back(*evmc_fork_blocks[i], static_cast<evmc_revision>(i + 1));
+            if (*evmc_fork_blocks[i]) {
+                fork_blocks.push_back(*evmc_fork_blocks[i]);
+            }
+        }
+    }
+    std::stable_sort(fork_revisions.begin(), fork_revisions.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    for (std::size_t i{1}; i < fork_revisions.size(); ++i) {
+        fork_revisions[i].second = std::max(fork_revisions[i].second, fork_revisions[i - 1].second);
+    }
+}
+
+evmc_revision ParsedChainConfig::revision(uint64_t block_number) const noexcept {
+    const auto it = std::upper_bound(fork_revisions.begin(), fork_revisions.end(), block_number, [](uint64_t number, const auto& fork) {
+        return number < fork.first;
+    });
+    return it == fork_revisions.begin() ? EVMC_FRONTIER : std::prev(it)->second;
+}
+
 std::ostream& operator<<(std::ostream& out, const ChainConfig& chain_config) {
     out << "genesis: " << chain_config.genesis_hash << " "
         << "config: " << chain_config.config.dump();
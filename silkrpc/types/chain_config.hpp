@@ -17,8 +17,11 @@
 #ifndef SILKRPC_TYPES_CHAIN_CONFIG_HPP_
 #define SILKRPC_TYPES_CHAIN_CONFIG_HPP_
 
+#include <cstdint>
 #include <stdexcept>
 #include <iostream>
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include <evmc/evmc.hpp>
@@ -32,6 +35,29 @@ struct ChainConfig {
     nlohmann::json config;
 };
 
+//! The chain config along with its parsed forms, parsed once when read and immutable afterwards so that it can be shared
+struct ParsedChainConfig {
+    ChainConfig chain_config;
+
+    //! The hash of the stored config data, telling if the config has changed w/o parsing it again
+    evmc::bytes32 data_hash{};
+
+    //! The config as used by the EVM, if valid
+    std::optional<silkworm::ChainConfig> silkworm_config;
+
+    //! The fork table, i.e. the blocks activating the EVM revisions in ascending order, each one along with the revision
+    //! in effect from there on (empty if the config is invalid)
+    std::vector<std::pair<uint64_t, evmc_revision>> fork_revisions;
+
+    //! The fork blocks in config order, skipping the forks in block 0 (i.e. the genesis ruleset)
+    std::vector<uint64_t> fork_blocks;
+
+    explicit ParsedChainConfig(ChainConfig config, const evmc::bytes32& config_data_hash = {});
+
+    //! Return the EVM revision in effect at the block, looking up the fork table as silkworm::ChainConfig::revision does
+    evmc_revision revision(uint64_t block_number) const noexcept;
+};
+
 struct Forks {
     const evmc::bytes32& genesis_hash;
     std::vector<uint64_t> block_numbers;
@@ -47,6 +73,13 @@ struct Forks {
             }
         }
     }
+
+    explicit Forks(const ParsedChainConfig& chain_config)
+    : genesis_hash(chain_config.chain_config.genesis_hash), block_numbers(chain_config.fork_blocks) {
+        if (!chain_config.silkworm_config) {
+            throw std::system_error{std::make_error_code(std::errc::invalid_argument), "Chain config missing"};
+        }
+    }
 };
 
 std::ostream& operator<<(std::ostream& out, const ChainConfig& chain_config);
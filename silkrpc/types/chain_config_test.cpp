@@ -75,5 +75,91 @@ TEST_CASE("create forks from chain config", "[silkrpc][types][chain_config]") {
     CHECK(forks.block_numbers[8] == 12'965'000);
 }
 
+TEST_CASE("parse empty chain config", "[silkrpc][types][chain_config]") {
+    ParsedChainConfig parsed_chain_config{ChainConfig{}};
+    CHECK(!parsed_chain_config.silkworm_config);
+}
+
+TEST_CASE("parse chain config", "[silkrpc][types][chain_config]") {
+    ParsedChainConfig parsed_chain_config{ChainConfig{
+        0xd4e56740f876aef8c010b86a40d5f56745a118d0906a34e69aec8c0db1cb8fa3_bytes32,
+        R"({
+            "byzantiumBlock":4370000,
+            "chainId":1,
+            "ethash":{},
+            "homesteadBlock":1150000
+        })"_json
+    }};
+    CHECK(parsed_chain_config.chain_config.genesis_hash == 0xd4e56740f876aef8c010b86a40d5f56745a118d0906a34e69aec8c0db1cb8fa3_bytes32);
+    CHECK(parsed_chain_config.silkworm_config);
+    if (parsed_chain_config.silkworm_config) {
+        CHECK(parsed_chain_config.silkworm_config->chain_id == 1);
+    }
+}
+
+TEST_CASE("parsed chain config fork table", "[silkrpc][types][chain_config]") {
+    ParsedChainConfig parsed_chain_config{ChainConfig{
+        0xd4e56740f876aef8c010b86a40d5f56745a118d0906a34e69aec8c0db1cb8fa3_bytes32,
+        R"({
+            "berlinBlock":12244000,
+            "byzantiumBlock":4370000,
+            "chainId":1,
+            "constantinopleBlock":7280000,
+            "daoForkBlock":1920000,
+            "eip150Block":2463000,
+            "eip155Block":2675000,
+            "ethash":{},
+            "homesteadBlock":1150000,
+            "istanbulBlock":9069000,
+            "londonBlock":12965000,
+            "muirGlacierBlock":9200000,
+            "petersburgBlock":7280000
+        })"_json
+    }, 0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+    REQUIRE(parsed_chain_config.silkworm_config);
+    CHECK(parsed_chain_config.data_hash == 0x0000000000000000000000000000000000000000000000000000000000000001_bytes32);
+
+    SECTION("revision") {
+        CHECK(parsed_chain_config.revision(0) == EVMC_FRONTIER);
+        CHECK(parsed_chain_config.revision(1'149'999) == EVMC_FRONTIER);
+        CHECK(parsed_chain_config.revision(1'150'000) == EVMC_HOMESTEAD);
+        CHECK(parsed_chain_config.revision(7'280'000) == EVMC_PETERSBURG);
+        CHECK(parsed_chain_config.revision(12'964'999) == EVMC_BERLIN);
+        CHECK(parsed_chain_config.revision(12'965'000) == EVMC_LONDON);
+        CHECK(parsed_chain_config.revision(UINT64_MAX) == EVMC_LONDON);
+        for (const uint64_t block_number : {0ul, 1'920'000ul, 2'463'000ul, 2'675'000ul, 4'370'000ul, 9'069'000ul, 12'244'000ul}) {
+            CHECK(parsed_chain_config.revision(block_number) == parsed_chain_config.silkworm_config->revision(block_number));
+        }
+    }
+
+    SECTION("forks") {
+        Forks forks{parsed_chain_config};
+        CHECK(forks.genesis_hash == 0xd4e56740f876aef8c010b86a40d5f56745a118d0906a34e69aec8c0db1cb8fa3_bytes32);
+        CHECK(forks.block_numbers == Forks{parsed_chain_config.chain_config}.block_numbers);
+    }
+}
+
+TEST_CASE("parsed chain config w/ forks at genesis", "[silkrpc][types][chain_config]") {
+    ParsedChainConfig parsed_chain_config{ChainConfig{
+        0xd4e56740f876aef8c010b86a40d5f56745a118d0906a34e69aec8c0db1cb8fa3_bytes32,
+        R"({
+            "byzantiumBlock":0,
+            "chainId":5,
+            "homesteadBlock":0,
+            "londonBlock":100
+        })"_json
+    }};
+    CHECK(parsed_chain_config.revision(0) == EVMC_BYZANTIUM);
+    CHECK(parsed_chain_config.revision(100) == EVMC_LONDON);
+    CHECK(parsed_chain_config.fork_blocks == std::vector<uint64_t>{100});
+}
+
+TEST_CASE("parsed empty chain config has no fork table", "[silkrpc][types][chain_config]") {
+    ParsedChainConfig parsed_chain_config{ChainConfig{}};
+    CHECK(parsed_chain_config.fork_revisions.empty());
+    CHECK(parsed_chain_config.revision(100) == EVMC_FRONTIER);
+    CHECK_THROWS_AS(Forks{parsed_chain_config}, std::system_error);
+}
+
 } // namespace silkrpc
 
@@ -39,4 +39,13 @@ std::ostream& operator<<(std::ostream& out, const Log& log) {
     return out;
 }
 
+void view_of(const Log& log, LogView& view) {
+    view.address = silkworm::ByteView{log.address.bytes, sizeof(log.address.bytes)};
+    view.topics.clear();
+    for (const auto& topic : log.topics) {
+        view.topics.emplace_back(topic.bytes, sizeof(topic.bytes));
+    }
+    view.data = log.data;
+}
+
 } // namespace silkrpc
@@ -43,6 +43,16 @@ struct Log {
 
 typedef std::vector<Log> Logs;
 
+//! Non-owning view of the raw fields of a log, referring either to its encoded bytes or to a Log
+struct LogView {
+    silkworm::ByteView address;
+    std::vector<silkworm::ByteView> topics;
+    silkworm::ByteView data;
+};
+
+//! Set the view to refer to the raw fields of the log
+void view_of(const Log& log, LogView& view);
+
 std::ostream& operator<<(std::ostream& out, const Log& log);
 
 } // namespace silkrpc
@@ -37,4 +37,19 @@ TEST_CASE("print empty log", "[silkrpc][types][log]") {
     CHECK_NOTHROW(null_stream() << l);
 }
 
+TEST_CASE("view log", "[silkrpc][types][log]") {
+    Log l{};
+    l.address.bytes[0] = 0x01;
+    l.topics.resize(2);
+    l.topics[1].bytes[31] = 0x02;
+    l.data = silkworm::Bytes{0x03, 0x04};
+    LogView view{};
+    view.topics.resize(5);
+    view_of(l, view);
+    CHECK(view.address == silkworm::ByteView{l.address.bytes, sizeof(l.address.bytes)});
+    CHECK(view.topics.size() == 2);
+    CHECK(view.topics[1] == silkworm::ByteView{l.topics[1].bytes, sizeof(l.topics[1].bytes)});
+    CHECK(view.data == l.data);
+}
+
 } // namespace silkrpc
@@ -0,0 +1,260 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "connection.hpp"
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <utility>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/websocket/error.hpp>
+#include <boost/system/system_error.hpp>
+
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/http/methods.hpp>
+#include <silkrpc/json/types.hpp>
+
+namespace silkrpc::ws {
+
+Connection::Connection(Context& context, WorkerPool& workers, commands::RpcApiTable& handler_table, SubscriptionRegistry& registry)
+    : rpc_api_{context, workers}, handler_table_{handler_table}, registry_{registry}, ws_{*context.io_context()} {
+    SILKRPC_DEBUG << "ws::Connection::Connection socket " << &socket() << " created\n";
+}
+
+Connection::~Connection() {
+    unsubscribe_all();
+    socket().close();
+    SILKRPC_DEBUG << "ws::Connection::~Connection socket " << &socket() << " deleted\n";
+}
+
+boost::asio::awaitable<void> Connection::start() {
+    try {
+        co_await ws_.async_accept(boost::asio::use_awaitable);
+        ws_.text(true);
+        co_await do_read();
+    } catch (const boost::system::system_error& se) {
+        if (se.code() == boost::beast::websocket::error::closed || se.code() == boost::asio::error::eof ||
+            se.code() == boost::asio::error::operation_aborted) {
+            SILKRPC_DEBUG << "ws::Connection::start close: " << se.what() << "\n";
+        } else {
+            SILKRPC_ERROR << "ws::Connection::start system_error: " << se.what() << "\n";
+        }
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "ws::Connection::start exception: " << e.what() << "\n";
+    }
+
+    // Stop the notifications as soon as the client has gone, not when the last pending write completes
+    unsubscribe_all();
+}
+
+boost::asio::awaitable<void> Connection::do_read() {
+    while (true) {
+        buffer_.clear();
+        co_await ws_.async_read(buffer_, boost::asio::use_awaitable);
+        const auto message = boost::beast::buffers_to_string(buffer_.data());
+        SILKRPC_DEBUG << "ws::Connection::do_read message: " << message << "\n";
+
+        std::string reply;
+        co_await handle_message(message, reply);
+        if (!reply.empty()) {
+            send(OutgoingMessage{std::move(reply), {}});
+        }
+    }
+}
+
+boost::asio::awaitable<void> Connection::handle_message(const std::string& message, std::string& reply) {
+    const auto request_json = nlohmann::json::parse(message, /*cb=*/nullptr, /*allow_exceptions=*/false);
+    if (request_json.is_discarded()) {
+        auto error_json = make_json_error(0, -32700, "parse error");
+        error_json["id"] = nullptr;
+        reply = error_json.dump();
+        co_return;
+    }
+
+    if (request_json.is_object()) {
+        co_await handle_request(request_json, reply);
+        co_return;
+    }
+
+    reply = "[";
+    for (const auto& item_json : request_json) {
+        std::string item_reply;
+        co_await handle_request(item_json, item_reply);
+        if (item_reply.empty()) {
+            continue;
+        }
+        if (reply.size() > 1) {
+            reply.push_back(',');
+        }
+        reply += item_reply;
+    }
+    reply.push_back(']');
+}
+
+boost::asio::awaitable<void> Connection::handle_request(const nlohmann::json& request_json, std::string& reply) {
+    // Requests without identifier are JSON RPC notifications not requiring any reply
+    if (!request_json.is_object() || !request_json.contains("id")) {
+        co_return;
+    }
+    const auto request_id = request_json["id"].get<uint32_t>();
+    if (!request_json.contains("method") || !request_json["method"].is_string()) {
+        reply = make_json_error(request_id, -32600, "invalid request").dump();
+        co_return;
+    }
+
+    const auto& method = request_json["method"].get_ref<const std::string&>();
+    try {
+        if (method == http::method::k_eth_subscribe) {
+            handle_subscribe(request_json, reply);
+            co_return;
+        }
+        if (method == http::method::k_eth_unsubscribe) {
+            handle_unsubscribe(request_json, reply);
+            co_return;
+        }
+
+        const auto* method_entry = handler_table_.find_method(method);
+        if (method_entry && method_entry->json_handler) {
+            nlohmann::json reply_json;
+            co_await (rpc_api_.*method_entry->json_handler.value())(request_json, reply_json);
+            reply = reply_json.dump(/*indent=*/-1, /*indent_char=*/' ', /*ensure_ascii=*/false, nlohmann::json::error_handler_t::replace);
+            co_return;
+        }
+
+        if (method_entry && method_entry->text_handler) {
+            co_await (rpc_api_.*method_entry->text_handler.value())(request_json, reply);
+            co_return;
+        }
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "ws::Connection::handle_request exception: " << e.what() << "\n";
+        reply = make_json_error(request_id, 100, e.what()).dump();
+        co_return;
+    }
+
+    reply = make_json_error(request_id, -32601, "the method " + method + " does not exist/is not available").dump();
+}
+
+void Connection::handle_subscribe(const nlohmann::json& request_json, std::string& reply) {
+    const auto request_id = request_json["id"].get<uint32_t>();
+    const auto& params = request_json["params"];
+    if (!params.is_array() || params.empty() || params.size() > 2 || !params[0].is_string()) {
+        reply = make_json_error(request_id, -32602, "invalid eth_subscribe params: " + params.dump()).dump();
+        return;
+    }
+
+    const auto kind = params[0].get<std::string>();
+    std::string subscription_id;
+    if (kind == "newHeads" && params.size() == 1) {
+        subscription_id = registry_.subscribe_new_heads(make_notifier());
+    } else if (kind == "logs") {
+        auto filter = params.size() == 2 ? params[1].get<Filter>() : Filter{};
+        subscription_id = registry_.subscribe_logs(std::move(filter), make_notifier());
+    } else {
+        reply = make_json_error(request_id, -32602, "unsupported eth_subscribe subscription: " + params.dump()).dump();
+        return;
+    }
+    subscription_ids_.push_back(subscription_id);
+
+    reply = make_json_content(request_id, subscription_id).dump();
+}
+
+void Connection::handle_unsubscribe(const nlohmann::json& request_json, std::string& reply) {
+    const auto request_id = request_json["id"].get<uint32_t>();
+    const auto& params = request_json["params"];
+    if (!params.is_array() || params.size() != 1 || !params[0].is_string()) {
+        reply = make_json_error(request_id, -32602, "invalid eth_unsubscribe params: " + params.dump()).dump();
+        return;
+    }
+
+    // Only the subscriptions made on this connection can be cancelled
+    const auto subscription_id = params[0].get<std::string>();
+    const auto it = std::find(subscription_ids_.begin(), subscription_ids_.end(), subscription_id);
+    bool unsubscribed{false};
+    if (it != subscription_ids_.end()) {
+        subscription_ids_.erase(it);
+        unsubscribed = registry_.unsubscribe(subscription_id);
+    }
+
+    reply = make_json_content(request_id, unsubscribed).dump();
+}
+
+SubscriptionNotifier Connection::make_notifier() {
+    return [weak_self = weak_from_this(), executor = ws_.get_executor()](SubscriptionNotification notification) {
+        boost::asio::post(executor, [weak_self, notification = std::move(notification)]() mutable {
+            const auto self = weak_self.lock();
+            if (!self) {
+                return;
+            }
+            // Slow consumers lose the notifications exceeding the limit instead of growing the queue unbounded
+            if (self->outgoing_.size() >= kWebSocketMaxPendingNotifications) {
+                SILKRPC_WARN << "ws::Connection notification dropped for socket " << &self->socket() << ": too many pending messages\n";
+                return;
+            }
+            self->send(OutgoingMessage{{}, std::move(notification)});
+        });
+    };
+}
+
+void Connection::send(OutgoingMessage message) {
+    outgoing_.push_back(std::move(message));
+    if (!writing_) {
+        writing_ = true;
+        boost::asio::co_spawn(ws_.get_executor(), [self = shared_from_this()]() { return self->do_write(); }, boost::asio::detached);
+    }
+}
+
+boost::asio::awaitable<void> Connection::do_write() {
+    try {
+        while (!outgoing_.empty()) {
+            // The message is popped only after the write completes, because the buffers must stay valid meanwhile
+            const auto& message = outgoing_.front();
+            std::size_t bytes_transferred{0};
+            if (message.notification.result) {
+                // The notification is written in one frame straight from the parts shared with the other subscribers
+                const std::array<boost::asio::const_buffer, 3> buffers{
+                    boost::asio::buffer(kSubscriptionNotificationHeader),
+                    boost::asio::buffer(*message.notification.result),
+                    boost::asio::buffer(*message.notification.trailer)};
+                bytes_transferred = co_await ws_.async_write(buffers, boost::asio::use_awaitable);
+            } else {
+                bytes_transferred = co_await ws_.async_write(boost::asio::buffer(message.reply), boost::asio::use_awaitable);
+            }
+            SILKRPC_TRACE << "ws::Connection::do_write bytes_transferred: " << bytes_transferred << "\n";
+            outgoing_.pop_front();
+        }
+    } catch (const boost::system::system_error& se) {
+        SILKRPC_DEBUG << "ws::Connection::do_write system_error: " << se.what() << "\n";
+        outgoing_.clear();
+    }
+    writing_ = false;
+}
+
+void Connection::unsubscribe_all() {
+    for (const auto& subscription_id : subscription_ids_) {
+        registry_.unsubscribe(subscription_id);
+    }
+    subscription_ids_.clear();
+}
+
+} // namespace silkrpc::ws
@@ -0,0 +1,115 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_WS_CONNECTION_HPP_
+#define SILKRPC_WS_CONNECTION_HPP_
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/websocket/stream.hpp>
+#include <nlohmann/json.hpp>
+
+#include <silkrpc/commands/rpc_api.hpp>
+#include <silkrpc/commands/rpc_api_table.hpp>
+#include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/concurrency/worker_pool.hpp>
+#include <silkrpc/ws/subscription_registry.hpp>
+
+namespace silkrpc::ws {
+
+//! A single WebSocket connection from a client, carrying JSON RPC requests and eth_subscription notifications.
+//! Requests are executed in arrival order, while notifications are pushed as soon as published. Stream handlers
+//! writing directly on the socket are not available over WebSocket.
+class Connection : public std::enable_shared_from_this<Connection> {
+  public:
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    //! Construct a connection running within the given execution context, not yet accepted
+    Connection(Context& context, WorkerPool& workers, commands::RpcApiTable& handler_table, SubscriptionRegistry& registry);
+
+    ~Connection();
+
+    boost::asio::ip::tcp::socket& socket() { return ws_.next_layer(); }
+
+    //! Perform the WebSocket handshake and serve the requests until the connection is closed
+    boost::asio::awaitable<void> start();
+
+  private:
+    //! A message waiting to be written: either a reply owned by the connection or a notification sharing its parts
+    struct OutgoingMessage {
+        std::string reply;
+        SubscriptionNotification notification;
+    };
+
+    //! Read and handle the incoming messages until the connection is closed
+    boost::asio::awaitable<void> do_read();
+
+    //! Handle one incoming message, either a single request or a batch
+    boost::asio::awaitable<void> handle_message(const std::string& message, std::string& reply);
+
+    //! Handle one JSON RPC request, dispatching eth_subscribe/eth_unsubscribe natively
+    boost::asio::awaitable<void> handle_request(const nlohmann::json& request_json, std::string& reply);
+
+    void handle_subscribe(const nlohmann::json& request_json, std::string& reply);
+    void handle_unsubscribe(const nlohmann::json& request_json, std::string& reply);
+
+    //! Build the notifier pushing the notifications to this connection, if still alive
+    SubscriptionNotifier make_notifier();
+
+    //! Queue the message for writing, starting the write loop if idle
+    void send(OutgoingMessage message);
+
+    //! Write the queued messages one at a time, as required by WebSocket stream, gathering the notification parts
+    boost::asio::awaitable<void> do_write();
+
+    //! Remove all the subscriptions made on this connection
+    void unsubscribe_all();
+
+    commands::RpcApi rpc_api_;
+
+    commands::RpcApiTable& handler_table_;
+
+    //! The registry where subscriptions are made
+    SubscriptionRegistry& registry_;
+
+    //! The WebSocket stream over the TCP socket
+    boost::beast::websocket::stream<boost::asio::ip::tcp::socket> ws_;
+
+    //! Buffer for incoming messages
+    boost::beast::flat_buffer buffer_;
+
+    //! The messages waiting to be written, either replies or notifications
+    std::deque<OutgoingMessage> outgoing_;
+
+    //! Flag indicating if the write loop is running
+    bool writing_{false};
+
+    //! The active subscriptions made on this connection
+    std::vector<std::string> subscription_ids_;
+};
+
+} // namespace silkrpc::ws
+
+#endif // SILKRPC_WS_CONNECTION_HPP_
@@ -0,0 +1,46 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "connection.hpp"
+
+#include <memory>
+
+#include <catch2/catch.hpp>
+#include <grpcpp/grpcpp.h>
+
+#include <silkrpc/commands/rpc_api_table.hpp>
+
+namespace silkrpc::ws {
+
+TEST_CASE("ws connection creation", "[silkrpc][ws][connection]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+
+    ChannelFactory create_channel = []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); };
+
+    SECTION("field initialization") {
+        ContextPool context_pool{1, create_channel};
+        WorkerPool workers{1};
+        commands::RpcApiTable handler_table{""};
+        SubscriptionRegistry registry;
+        std::shared_ptr<Connection> connection;
+        CHECK_NOTHROW(connection = std::make_shared<Connection>(context_pool.next_context(), workers, handler_table, registry));
+        CHECK(!connection->socket().is_open());
+        CHECK_NOTHROW(connection.reset());
+        CHECK(registry.size() == 0);
+    }
+}
+
+} // namespace silkrpc::ws
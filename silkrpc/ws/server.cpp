@@ -0,0 +1,103 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "server.hpp"
+
+#include <memory>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/ws/connection.hpp>
+
+namespace silkrpc::ws {
+#ifdef WIN32
+using reuse_port = boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEADDR>;
+#else
+using reuse_port = boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+#endif
+
+std::tuple<std::string, std::string> Server::parse_endpoint(const std::string& tcp_end_point) {
+    const auto host = tcp_end_point.substr(0, tcp_end_point.find(kAddressPortSeparator));
+    const auto port = tcp_end_point.substr(tcp_end_point.find(kAddressPortSeparator) + 1, std::string::npos);
+    return {host, port};
+}
+
+Server::Server(const std::string& end_point, const std::string& api_spec, Context& context, WorkerPool& workers,
+    SubscriptionRegistry& registry)
+: handler_table_{api_spec}, context_(context), acceptor_{*context.io_context()}, workers_(workers), registry_(registry) {
+    const auto [host, port] = parse_endpoint(end_point);
+
+    // Open the acceptor with the option to reuse the address (i.e. SO_REUSEADDR) and port (i.e. SO_REUSEPORT).
+    boost::asio::ip::tcp::resolver resolver{acceptor_.get_executor()};
+    boost::asio::ip::tcp::endpoint endpoint = *resolver.resolve(host, port).begin();
+    acceptor_.open(endpoint.protocol());
+    acceptor_.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+    acceptor_.set_option(reuse_port(true));
+    acceptor_.bind(endpoint);
+}
+
+void Server::start() {
+    boost::asio::co_spawn(acceptor_.get_executor(), run(), [&](std::exception_ptr eptr) {
+        if (eptr) std::rethrow_exception(eptr);
+    });
+}
+
+boost::asio::awaitable<void> Server::run() {
+    acceptor_.listen();
+
+    try {
+        while (acceptor_.is_open()) {
+            SILKRPC_DEBUG << "ws::Server::run accepting using io_context " << context_.io_context() << "...\n" << std::flush;
+
+            auto new_connection = std::make_shared<Connection>(context_, workers_, handler_table_, registry_);
+            co_await acceptor_.async_accept(new_connection->socket(), boost::asio::use_awaitable);
+            if (!acceptor_.is_open()) {
+                SILKRPC_TRACE << "ws::Server::run returning...\n";
+                co_return;
+            }
+
+            new_connection->socket().set_option(boost::asio::ip::tcp::socket::keep_alive(true));
+            new_connection->socket().set_option(boost::asio::ip::tcp::no_delay(true));
+
+            SILKRPC_TRACE << "ws::Server::run starting connection for socket: " << &new_connection->socket() << "\n";
+            auto new_connection_starter = [=]() -> boost::asio::awaitable<void> { co_await new_connection->start(); };
+
+            boost::asio::co_spawn(*context_.io_context(), new_connection_starter, [&](std::exception_ptr eptr) {
+                if (eptr) std::rethrow_exception(eptr);
+            });
+        }
+    } catch (const boost::system::system_error& se) {
+        if (se.code() != boost::asio::error::operation_aborted) {
+            SILKRPC_ERROR << "ws::Server::run system_error: " << se.what() << "\n" << std::flush;
+            std::rethrow_exception(std::make_exception_ptr(se));
+        } else {
+            SILKRPC_DEBUG << "ws::Server::run operation_aborted: " << se.what() << "\n" << std::flush;
+        }
+    }
+    SILKRPC_DEBUG << "ws::Server::run exiting...\n" << std::flush;
+}
+
+void Server::stop() {
+    // The server is stopped by cancelling all outstanding asynchronous operations.
+    SILKRPC_DEBUG << "ws::Server::stop started...\n";
+    acceptor_.close();
+    SILKRPC_DEBUG << "ws::Server::stop completed\n" << std::flush;
+}
+
+} // namespace silkrpc::ws
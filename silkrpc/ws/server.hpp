@@ -0,0 +1,74 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_WS_SERVER_HPP_
+#define SILKRPC_WS_SERVER_HPP_
+
+#include <string>
+#include <tuple>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <silkrpc/commands/rpc_api_table.hpp>
+#include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/concurrency/worker_pool.hpp>
+#include <silkrpc/ws/subscription_registry.hpp>
+
+namespace silkrpc::ws {
+
+//! The top-level class of the WebSocket server, one for each context all listening on the same end-point.
+class Server {
+  public:
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    //! Construct the server to listen on the specified local TCP end-point, making subscriptions in the given registry
+    explicit Server(const std::string& end_point, const std::string& api_spec, Context& context, WorkerPool& workers,
+        SubscriptionRegistry& registry);
+
+    void start();
+
+    void stop();
+
+    //! The repository of API request handlers, reloadable while running
+    commands::RpcApiTable& handler_table() noexcept { return handler_table_; }
+
+  private:
+    static std::tuple<std::string, std::string> parse_endpoint(const std::string& tcp_end_point);
+
+    boost::asio::awaitable<void> run();
+
+    //! The repository of API request handlers
+    commands::RpcApiTable handler_table_;
+
+    //! The context used to perform asynchronous operations
+    Context& context_;
+
+    //! The acceptor used to listen for incoming TCP connections
+    boost::asio::ip::tcp::acceptor acceptor_;
+
+    WorkerPool& workers_;
+
+    //! The registry of subscriptions shared by all the servers
+    SubscriptionRegistry& registry_;
+};
+
+} // namespace silkrpc::ws
+
+#endif // SILKRPC_WS_SERVER_HPP_
@@ -0,0 +1,57 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_WS_SUBSCRIPTION_PUBLISHER_HPP_
+#define SILKRPC_WS_SUBSCRIPTION_PUBLISHER_HPP_
+
+#include <cstdint>
+
+#include <silkrpc/config.hpp>
+
+#include <boost/asio/awaitable.hpp>
+#include <evmc/evmc.hpp>
+
+#include <silkrpc/concurrency/context_pool.hpp>
+#include <silkrpc/interfaces/remote/kv.pb.h>
+#include <silkrpc/ws/subscription_registry.hpp>
+
+namespace silkrpc::ws {
+
+//! Publisher of the new heads and logs notifications for the blocks announced by the state changes stream
+class SubscriptionPublisher {
+  public:
+    explicit SubscriptionPublisher(Context& context, SubscriptionRegistry& registry);
+
+    SubscriptionPublisher(const SubscriptionPublisher&) = delete;
+    SubscriptionPublisher& operator=(const SubscriptionPublisher&) = delete;
+
+    //! Schedule the publishing of the blocks added by the batch, to be called on the context running the stream
+    void on_state_changes(const remote::StateChangeBatch& state_changes);
+
+  private:
+    //! Read the block header and the receipt logs just when there are subscribers and notify them
+    boost::asio::awaitable<void> publish_block(uint64_t block_number, evmc::bytes32 block_hash);
+
+    //! The context used to read the published blocks
+    Context& context_;
+
+    //! The registry of the subscriptions to notify
+    SubscriptionRegistry& registry_;
+};
+
+} // namespace silkrpc::ws
+
+#endif // SILKRPC_WS_SUBSCRIPTION_PUBLISHER_HPP_
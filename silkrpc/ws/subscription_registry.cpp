@@ -0,0 +1,190 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "subscription_registry.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/json/writer.hpp>
+
+namespace silkrpc::ws {
+
+std::string SubscriptionNotification::to_string() const {
+    std::string notification;
+    notification.reserve(size());
+    notification += kSubscriptionNotificationHeader;
+    notification += *result;
+    notification += *trailer;
+    return notification;
+}
+
+std::string make_subscription_trailer(std::string_view subscription_id) {
+    std::string trailer;
+    trailer.reserve(20 + subscription_id.size());
+    trailer += ",\"subscription\":\"";
+    trailer += subscription_id;
+    trailer += "\"}}";
+    return trailer;
+}
+
+std::string make_subscription_notification(std::string_view subscription_id, std::string_view result) {
+    std::string notification;
+    notification.reserve(kSubscriptionNotificationHeader.size() + result.size() + 20 + subscription_id.size());
+    notification += kSubscriptionNotificationHeader;
+    notification += result;
+    notification += make_subscription_trailer(subscription_id);
+    return notification;
+}
+
+bool match_log(const Filter& filter, const Log& log) {
+    if (filter.addresses && !filter.addresses->empty()) {
+        const auto& addresses = *filter.addresses;
+        if (std::find(addresses.begin(), addresses.end(), log.address) == addresses.end()) {
+            return false;
+        }
+    }
+    if (filter.topics) {
+        const auto& topics = *filter.topics;
+        if (topics.size() > log.topics.size()) {
+            return false;
+        }
+        for (std::size_t i{0}; i < topics.size(); ++i) {
+            const auto& subtopics = topics[i];
+            // Empty rule set means wildcard
+            if (!subtopics.empty() && std::find(subtopics.begin(), subtopics.end(), log.topics[i]) == subtopics.end()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+SubscriptionRegistry::SubscriptionRegistry() : id_generator_{std::random_device{}()} {}
+
+std::string SubscriptionRegistry::subscribe_new_heads(SubscriptionNotifier notifier) {
+    return add_subscription(Subscription{SubscriptionKind::new_heads, Filter{}, std::move(notifier), nullptr});
+}
+
+std::string SubscriptionRegistry::subscribe_logs(Filter filter, SubscriptionNotifier notifier) {
+    // An empty list of addresses matches any log here, so the matcher is prepared as if there were no addresses at all
+    Filter matcher_filter{filter};
+    if (matcher_filter.addresses && matcher_filter.addresses->empty()) {
+        matcher_filter.addresses.reset();
+    }
+    core::LogFilterMatcher matcher{matcher_filter};
+    return add_subscription(Subscription{SubscriptionKind::logs, std::move(filter), std::move(notifier), nullptr, std::move(matcher)});
+}
+
+std::string SubscriptionRegistry::add_subscription(Subscription subscription) {
+    std::lock_guard lock{mutex_};
+
+    std::string subscription_id;
+    do {
+        std::array<uint8_t, 16> id_bytes{};
+        for (std::size_t i{0}; i < id_bytes.size(); i += sizeof(uint64_t)) {
+            const auto random = id_generator_();
+            std::copy_n(reinterpret_cast<const uint8_t*>(&random), sizeof(uint64_t), id_bytes.data() + i);
+        }
+        subscription_id.clear();
+        write_hex(subscription_id, {id_bytes.data(), id_bytes.size()});
+    } while (subscriptions_.contains(subscription_id));
+
+    subscription.trailer = std::make_shared<const std::string>(make_subscription_trailer(subscription_id));
+    if (subscription.kind == SubscriptionKind::new_heads) {
+        ++new_heads_count_;
+    } else {
+        ++logs_count_;
+    }
+    subscriptions_.emplace(subscription_id, std::move(subscription));
+    SILKRPC_DEBUG << "SubscriptionRegistry::add_subscription id: " << subscription_id << " #subscriptions: " << subscriptions_.size() << "\n";
+    return subscription_id;
+}
+
+bool SubscriptionRegistry::unsubscribe(const std::string& subscription_id) {
+    std::lock_guard lock{mutex_};
+
+    const auto it = subscriptions_.find(subscription_id);
+    if (it == subscriptions_.end()) {
+        return false;
+    }
+    if (it->second.kind == SubscriptionKind::new_heads) {
+        --new_heads_count_;
+    } else {
+        --logs_count_;
+    }
+    subscriptions_.erase(it);
+    SILKRPC_DEBUG << "SubscriptionRegistry::unsubscribe id: " << subscription_id << " #subscriptions: " << subscriptions_.size() << "\n";
+    return true;
+}
+
+std::size_t SubscriptionRegistry::size() const {
+    std::lock_guard lock{mutex_};
+    return subscriptions_.size();
+}
+
+bool SubscriptionRegistry::has_new_heads_subscriptions() const {
+    std::lock_guard lock{mutex_};
+    return new_heads_count_ > 0;
+}
+
+bool SubscriptionRegistry::has_logs_subscriptions() const {
+    std::lock_guard lock{mutex_};
+    return logs_count_ > 0;
+}
+
+void SubscriptionRegistry::notify_new_head(std::string header_json) {
+    const auto result = std::make_shared<const std::string>(std::move(header_json));
+
+    std::lock_guard lock{mutex_};
+    for (const auto& [_, subscription] : subscriptions_) {
+        if (subscription.kind == SubscriptionKind::new_heads) {
+            subscription.notifier(SubscriptionNotification{result, subscription.trailer});
+        }
+    }
+}
+
+void SubscriptionRegistry::notify_logs(const Logs& logs) {
+    if (logs.empty()) {
+        return;
+    }
+
+    // Serialize each log just once whatever the number of matching subscriptions
+    std::vector<std::shared_ptr<const std::string>> logs_json;
+    logs_json.reserve(logs.size());
+    for (const auto& log : logs) {
+        std::string log_json;
+        write_json(log_json, log);
+        logs_json.push_back(std::make_shared<const std::string>(std::move(log_json)));
+    }
+
+    std::lock_guard lock{mutex_};
+    for (const auto& [_, subscription] : subscriptions_) {
+        if (subscription.kind != SubscriptionKind::logs) {
+            continue;
+        }
+        for (std::size_t i{0}; i < logs.size(); ++i) {
+            if (subscription.matcher->match(logs[i])) {
+                subscription.notifier(SubscriptionNotification{logs_json[i], subscription.trailer});
+            }
+        }
+    }
+}
+
+} // namespace silkrpc::ws
@@ -0,0 +1,132 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_WS_SUBSCRIPTION_REGISTRY_HPP_
+#define SILKRPC_WS_SUBSCRIPTION_REGISTRY_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include <silkrpc/core/log_filter_matcher.hpp>
+#include <silkrpc/types/filter.hpp>
+#include <silkrpc/types/log.hpp>
+
+namespace silkrpc::ws {
+
+//! The kinds of eth_subscribe subscriptions
+enum class SubscriptionKind {
+    new_heads,
+    logs
+};
+
+//! The constant header opening every eth_subscription notification, up to its result
+constexpr std::string_view kSubscriptionNotificationHeader{"{\"jsonrpc\":\"2.0\",\"method\":\"eth_subscription\",\"params\":{\"result\":"};
+
+//! One eth_subscription notification split in the parts to be written with scatter-gather I/O after the constant header:
+//! the serialized event is shared by all the notified subscriptions and the trailer is built once per subscription, so
+//! that notifying one more subscriber costs neither serialization nor copy
+struct SubscriptionNotification {
+    //! The serialized event result, shared by all the subscriptions notified of the event
+    std::shared_ptr<const std::string> result;
+
+    //! The trailer carrying the subscription identifier and closing the notification
+    std::shared_ptr<const std::string> trailer;
+
+    //! The size in bytes of the notification text
+    std::size_t size() const { return kSubscriptionNotificationHeader.size() + result->size() + trailer->size(); }
+
+    //! Build the notification text joining all the parts
+    std::string to_string() const;
+};
+
+//! The callback delivering the eth_subscription notifications of one subscription. It is invoked on the thread
+//! publishing the event, so it must just hand the notification over to the subscriber execution context.
+using SubscriptionNotifier = std::function<void(SubscriptionNotification notification)>;
+
+//! Build the trailer closing the eth_subscription notifications of the specified subscription
+std::string make_subscription_trailer(std::string_view subscription_id);
+
+//! Build the eth_subscription notification text for the specified subscription carrying the serialized result
+std::string make_subscription_notification(std::string_view subscription_id, std::string_view result);
+
+//! Check if the log matches the addresses and topics of the filter, block range in filter is ignored
+bool match_log(const Filter& filter, const Log& log);
+
+//! The registry of active subscriptions, shared by all the WebSocket connections and safe for concurrent use
+class SubscriptionRegistry {
+  public:
+    SubscriptionRegistry();
+
+    SubscriptionRegistry(const SubscriptionRegistry&) = delete;
+    SubscriptionRegistry& operator=(const SubscriptionRegistry&) = delete;
+
+    //! Add a subscription to new block headers, returning the subscription identifier
+    std::string subscribe_new_heads(SubscriptionNotifier notifier);
+
+    //! Add a subscription to new logs matching the filter, returning the subscription identifier
+    std::string subscribe_logs(Filter filter, SubscriptionNotifier notifier);
+
+    //! Remove the specified subscription, returning false if unknown
+    bool unsubscribe(const std::string& subscription_id);
+
+    std::size_t size() const;
+
+    bool has_new_heads_subscriptions() const;
+    bool has_logs_subscriptions() const;
+
+    //! Notify all the new heads subscriptions of the specified serialized block header, shared by all the notifications
+    void notify_new_head(std::string header_json);
+
+    //! Notify each logs subscription of the logs matching its filter, one notification per log: each log is serialized
+    //! once and shared by all the notifications
+    void notify_logs(const Logs& logs);
+
+  private:
+    struct Subscription {
+        SubscriptionKind kind;
+        Filter filter;
+        SubscriptionNotifier notifier;
+        std::shared_ptr<const std::string> trailer;
+        //! The matcher of the filter of a logs subscription, prepared once for all the new blocks
+        std::optional<core::LogFilterMatcher> matcher{};
+    };
+
+    std::string add_subscription(Subscription subscription);
+
+    //! Protect the subscriptions from concurrent access by connections and publisher
+    mutable std::mutex mutex_;
+
+    //! The active subscriptions by identifier
+    std::map<std::string, Subscription> subscriptions_;
+
+    //! The number of active subscriptions for each kind, to skip the publishing work when nobody is listening
+    std::size_t new_heads_count_{0};
+    std::size_t logs_count_{0};
+
+    //! The generator of unpredictable subscription identifiers
+    std::mt19937_64 id_generator_;
+};
+
+} // namespace silkrpc::ws
+
+#endif // SILKRPC_WS_SUBSCRIPTION_REGISTRY_HPP_
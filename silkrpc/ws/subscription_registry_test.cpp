@@ -0,0 +1,167 @@
+/*
+   Copyright 2022 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "subscription_registry.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+#include <nlohmann/json.hpp>
+
+#include <silkrpc/json/types.hpp>
+
+namespace silkrpc::ws {
+
+using evmc::literals::operator""_address, evmc::literals::operator""_bytes32;
+
+static Log make_log(const evmc::address& address, std::vector<evmc::bytes32> topics) {
+    Log log{};
+    log.address = address;
+    log.topics = std::move(topics);
+    return log;
+}
+
+TEST_CASE("make_subscription_notification", "[silkrpc][ws][subscription_registry]") {
+    const auto notification = make_subscription_notification("0x1234", "{\"number\":\"0x1\"}");
+    CHECK(nlohmann::json::parse(notification) == R"({
+        "jsonrpc":"2.0",
+        "method":"eth_subscription",
+        "params":{"subscription":"0x1234","result":{"number":"0x1"}}
+    })"_json);
+}
+
+TEST_CASE("SubscriptionNotification", "[silkrpc][ws][subscription_registry]") {
+    const SubscriptionNotification notification{std::make_shared<const std::string>("{\"number\":\"0x1\"}"),
+        std::make_shared<const std::string>(make_subscription_trailer("0x1234"))};
+    CHECK(notification.to_string() == make_subscription_notification("0x1234", "{\"number\":\"0x1\"}"));
+    CHECK(notification.size() == notification.to_string().size());
+}
+
+TEST_CASE("match_log", "[silkrpc][ws][subscription_registry]") {
+    const auto address1{0x00000000000000000000000000000000000000aa_address};
+    const auto address2{0x00000000000000000000000000000000000000bb_address};
+    const auto topic1{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+    const auto topic2{0x0000000000000000000000000000000000000000000000000000000000000002_bytes32};
+    const auto log = make_log(address1, {topic1, topic2});
+
+    SECTION("empty filter matches any log") {
+        CHECK(match_log(Filter{}, log));
+    }
+    SECTION("address") {
+        Filter filter{};
+        filter.addresses = FilterAddresses{address2, address1};
+        CHECK(match_log(filter, log));
+        filter.addresses = FilterAddresses{address2};
+        CHECK(!match_log(filter, log));
+    }
+    SECTION("topics by position") {
+        Filter filter{};
+        filter.topics = FilterTopics{{}, {topic2}};
+        CHECK(match_log(filter, log));
+        filter.topics = FilterTopics{{topic2}};
+        CHECK(!match_log(filter, log));
+        filter.topics = FilterTopics{{topic2, topic1}};
+        CHECK(match_log(filter, log));
+    }
+    SECTION("more topics than log") {
+        Filter filter{};
+        filter.topics = FilterTopics{{}, {}, {}};
+        CHECK(!match_log(filter, log));
+    }
+}
+
+TEST_CASE("SubscriptionRegistry", "[silkrpc][ws][subscription_registry]") {
+    SubscriptionRegistry registry;
+
+    SECTION("subscribe/unsubscribe") {
+        CHECK(registry.size() == 0);
+        CHECK(!registry.has_new_heads_subscriptions());
+        CHECK(!registry.has_logs_subscriptions());
+        const auto id1 = registry.subscribe_new_heads([](SubscriptionNotification) {});
+        const auto id2 = registry.subscribe_logs(Filter{}, [](SubscriptionNotification) {});
+        CHECK(id1.size() == 34);
+        CHECK(id1.substr(0, 2) == "0x");
+        CHECK(id1 != id2);
+        CHECK(registry.size() == 2);
+        CHECK(registry.has_new_heads_subscriptions());
+        CHECK(registry.has_logs_subscriptions());
+        CHECK(registry.unsubscribe(id1));
+        CHECK(!registry.unsubscribe(id1));
+        CHECK(!registry.has_new_heads_subscriptions());
+        CHECK(registry.unsubscribe(id2));
+        CHECK(registry.size() == 0);
+    }
+
+    SECTION("notify new head") {
+        std::vector<SubscriptionNotification> notifications;
+        const auto id = registry.subscribe_new_heads([&](SubscriptionNotification n) { notifications.push_back(std::move(n)); });
+        registry.subscribe_logs(Filter{}, [&](SubscriptionNotification n) { notifications.push_back(std::move(n)); });
+        registry.notify_new_head("{\"number\":\"0x2\"}");
+        REQUIRE(notifications.size() == 1);
+        const auto notification_json = nlohmann::json::parse(notifications[0].to_string());
+        CHECK(notification_json["params"]["subscription"] == id);
+        CHECK(notification_json["params"]["result"]["number"] == "0x2");
+    }
+
+    SECTION("notify logs") {
+        const auto address1{0x00000000000000000000000000000000000000aa_address};
+        const auto address2{0x00000000000000000000000000000000000000bb_address};
+        std::vector<SubscriptionNotification> all_notifications, filtered_notifications;
+        registry.subscribe_new_heads([&](SubscriptionNotification n) { all_notifications.push_back(std::move(n)); });
+        registry.subscribe_logs(Filter{}, [&](SubscriptionNotification n) { all_notifications.push_back(std::move(n)); });
+        Filter filter{};
+        filter.addresses = FilterAddresses{address2};
+        const auto filtered_id = registry.subscribe_logs(filter, [&](SubscriptionNotification n) { filtered_notifications.push_back(std::move(n)); });
+
+        const Logs logs{make_log(address1, {}), make_log(address2, {})};
+        registry.notify_logs(logs);
+        CHECK(all_notifications.size() == 2);
+        REQUIRE(filtered_notifications.size() == 1);
+        const auto notification_json = nlohmann::json::parse(filtered_notifications[0].to_string());
+        CHECK(notification_json["params"]["subscription"] == filtered_id);
+        CHECK(notification_json["params"]["result"] == nlohmann::json(logs[1]));
+    }
+
+    SECTION("notifications share the serialized event") {
+        std::vector<SubscriptionNotification> notifications;
+        const auto id1 = registry.subscribe_new_heads([&](SubscriptionNotification n) { notifications.push_back(std::move(n)); });
+        const auto id2 = registry.subscribe_new_heads([&](SubscriptionNotification n) { notifications.push_back(std::move(n)); });
+        registry.notify_new_head("{\"number\":\"0x3\"}");
+        REQUIRE(notifications.size() == 2);
+        CHECK(notifications[0].result == notifications[1].result);
+        CHECK(notifications[0].trailer != notifications[1].trailer);
+        for (const auto& notification : notifications) {
+            const auto text = notification.to_string();
+            CHECK(text.size() == notification.size());
+            const auto notification_json = nlohmann::json::parse(text);
+            CHECK((notification_json["params"]["subscription"] == id1 || notification_json["params"]["subscription"] == id2));
+            CHECK(notification_json["params"]["result"]["number"] == "0x3");
+        }
+    }
+
+    SECTION("no notification after unsubscribe") {
+        std::size_t notified{0};
+        const auto id = registry.subscribe_new_heads([&](SubscriptionNotification) { ++notified; });
+        registry.unsubscribe(id);
+        registry.notify_new_head("{}");
+        CHECK(notified == 0);
+    }
+}
+
+} // namespace silkrpc::ws